@@ -27,11 +27,11 @@
 #include "platform/FileUtils.h"
 #include "base/Utils.h"
 #include "base/Log.h"
-
-#include <condition_variable>
-#include <queue>
-#include <thread>
-#include <mutex>
+#include "base/MemoryPressure.h"
+#include "base/ThreadPool.h"
+#include "base/Scheduler.h"
+#include "base/memory/MemTracker.h"
+#include "platform/Application.h"
 
 #if CC_PLATFORM == CC_PLATFORM_ANDROID
 #include "audio/android/AudioEngine-inl.h"
@@ -47,7 +47,11 @@
 #include "audio/tizen/AudioEngine-tizen.h"
 #endif
 
+#include <algorithm>
+#include <cmath>
+
 #define TIME_DELAY_PRECISION 0.0001
+#define VOICE_UPDATE_INTERVAL 0.05f
 
 #ifdef ERROR
 #undef ERROR
@@ -57,21 +61,30 @@ using namespace cc;
 
 const int AudioEngine::INVALID_AUDIO_ID = -1;
 const float AudioEngine::TIME_UNKNOWN = -1.0f;
+const unsigned int AudioProfile::DEFAULT_STREAMING_THRESHOLD = 1048576;
 
 //audio file path,audio IDs
 std::unordered_map<std::string,std::list<int>> AudioEngine::_audioPathIDMap;
 //profileName,ProfileHelper
 std::unordered_map<std::string, AudioEngine::ProfileHelper> AudioEngine::_audioPathProfileHelperMap;
 unsigned int AudioEngine::_maxInstances = MAX_AUDIOINSTANCES;
+unsigned int AudioEngine::_maxVirtualInstances = MAX_AUDIOINSTANCES * 2;
+unsigned int AudioEngine::_cacheBudget = 0;
+bool AudioEngine::_isCacheCompressionEnabled = false;
 AudioEngine::ProfileHelper* AudioEngine::_defaultProfileHelper = nullptr;
 std::unordered_map<int, AudioEngine::AudioInfo> AudioEngine::_audioIDInfoMap;
 AudioEngineImpl* AudioEngine::_audioEngineImpl = nullptr;
 
+std::unordered_map<int, int> AudioEngine::_voiceIDMap;
+int AudioEngine::_audioIDIndex = 0;
+int AudioEngine::_voiceIDIndex = 0;
+bool AudioEngine::_isVoiceUpdateScheduled = false;
+
 uint32_t AudioEngine::_onPauseListenerID = 0;
+uint32_t AudioEngine::_memoryPressureHandlerID = 0;
 uint32_t AudioEngine::_onResumeListenerID = 0;
 std::vector<int> AudioEngine::_breakAudioID;
 
-AudioEngine::AudioEngineThreadPool* AudioEngine::s_threadPool = nullptr;
 bool AudioEngine::_isEnabled = true;
 
 AudioEngine::AudioInfo::AudioInfo()
@@ -81,6 +94,10 @@ AudioEngine::AudioInfo::AudioInfo()
 , loop(false)
 , duration(TIME_UNKNOWN)
 , state(AudioState::INITIALIZING)
+, voiceID(INVALID_AUDIO_ID)
+, isVoiceStarted(false)
+, isSeekPending(false)
+, virtualTime(0.0f)
 {
 
 }
@@ -89,80 +106,17 @@ AudioEngine::AudioInfo::~AudioInfo()
 {
 }
 
-class AudioEngine::AudioEngineThreadPool
-{
-public:
-    AudioEngineThreadPool(int threads = 4)
-        : _stop(false)
-    {
-        for (int index = 0; index < threads; ++index)
-        {
-            _workers.emplace_back(std::thread(std::bind(&AudioEngineThreadPool::threadFunc, this)));
-        }
-    }
-
-    void addTask(const std::function<void()> &task){
-        std::unique_lock<std::mutex> lk(_queueMutex);
-        _taskQueue.emplace(task);
-        _taskCondition.notify_one();
-    }
-
-    ~AudioEngineThreadPool()
-    {
-        {
-            std::unique_lock<std::mutex> lk(_queueMutex);
-            _stop = true;
-            _taskCondition.notify_all();
-        }
-
-        for (auto&& worker : _workers) {
-            worker.join();
-        }
-    }
-
-private:
-    void threadFunc()
-    {
-        while (true) {
-            std::function<void()> task = nullptr;
-            {
-                std::unique_lock<std::mutex> lk(_queueMutex);
-                if (_stop)
-                {
-                    break;
-                }
-                if (!_taskQueue.empty())
-                {
-                    task = std::move(_taskQueue.front());
-                    _taskQueue.pop();
-                }
-                else
-                {
-                    _taskCondition.wait(lk);
-                    continue;
-                }
-            }
-
-            task();
-        }
-    }
-
-    std::vector<std::thread>  _workers;
-    std::queue< std::function<void()> > _taskQueue;
-
-    std::mutex _queueMutex;
-    std::condition_variable _taskCondition;
-    bool _stop;
-};
-
 void AudioEngine::end()
 {
     stopAll();
 
-    if (s_threadPool)
+    // the tasks which already run check whether their cache is destroyed
+    ThreadPool::getDefaultThreadPool()->stopTasksByType(ThreadPool::TaskType::AUDIO);
+
+    if (_isVoiceUpdateScheduled)
     {
-        delete s_threadPool;
-        s_threadPool = nullptr;
+        Application::getInstance()->getScheduler()->unschedule("AudioEngineVoices", &_voiceIDMap);
+        _isVoiceUpdateScheduled = false;
     }
 
     delete _audioEngineImpl;
@@ -182,34 +136,52 @@ void AudioEngine::end()
         EventDispatcher::removeCustomEventListener(EVENT_COME_TO_FOREGROUND, _onResumeListenerID);
         _onResumeListenerID = 0;
     }
+
+    if (_memoryPressureHandlerID != 0)
+    {
+        MemoryPressure::removeHandler(_memoryPressureHandlerID);
+        _memoryPressureHandlerID = 0;
+    }
 }
 
-bool AudioEngine::lazyInit()
+bool AudioEngine::initImpl()
 {
     if (_audioEngineImpl == nullptr)
     {
-        _audioEngineImpl = new (std::nothrow) AudioEngineImpl();
-        if(!_audioEngineImpl ||  !_audioEngineImpl->init() ){
-            delete _audioEngineImpl;
-            _audioEngineImpl = nullptr;
-           return false;
+        auto *audioEngineImpl = new (std::nothrow) AudioEngineImpl();
+        if(!audioEngineImpl ||  !audioEngineImpl->init() ){
+            delete audioEngineImpl;
+            return false;
         }
-        _onPauseListenerID = EventDispatcher::addCustomEventListener(EVENT_COME_TO_BACKGROUND, AudioEngine::onEnterBackground);
-        _onResumeListenerID = EventDispatcher::addCustomEventListener(EVENT_COME_TO_FOREGROUND, AudioEngine::onEnterForeground);
+        _audioEngineImpl = audioEngineImpl;
     }
 
-#if (CC_PLATFORM != CC_PLATFORM_ANDROID)
-    if (_audioEngineImpl && s_threadPool == nullptr)
+    return true;
+}
+
+bool AudioEngine::lazyInit()
+{
+    if (!initImpl())
     {
-        s_threadPool = new (std::nothrow) AudioEngineThreadPool();
+        return false;
+    }
+
+    // the engine may have been created by a boot task, what's left is done on the cocos thread
+    if (_memoryPressureHandlerID == 0)
+    {
+        _audioEngineImpl->setCacheBudget(_cacheBudget);
+        _audioEngineImpl->setCacheCompressionEnabled(_isCacheCompressionEnabled);
+        _onPauseListenerID = EventDispatcher::addCustomEventListener(EVENT_COME_TO_BACKGROUND, AudioEngine::onEnterBackground);
+        _onResumeListenerID = EventDispatcher::addCustomEventListener(EVENT_COME_TO_FOREGROUND, AudioEngine::onEnterForeground);
+        _memoryPressureHandlerID = MemoryPressure::addHandler("AudioEngine", MemoryPressureLevel::LOW, AudioEngine::onMemoryPressure);
     }
-#endif
 
     return true;
 }
 
 int AudioEngine::play2d(const std::string& filePath, bool loop, float volume, const AudioProfile *profile)
 {
+    CC_MEM_MODULE_SCOPE(AUDIO);
     int ret = AudioEngine::INVALID_AUDIO_ID;
 
     do {
@@ -233,7 +205,7 @@ int AudioEngine::play2d(const std::string& filePath, bool loop, float volume, co
             profileHelper->profile = *profile;
         }
         
-        if (_audioIDInfoMap.size() >= _maxInstances) {
+        if (_audioIDInfoMap.size() >= _maxInstances + _maxVirtualInstances) {
             CC_LOG_INFO("Fail to play %s cause by limited max instance of AudioEngine",filePath.c_str());
             break;
         }
@@ -260,23 +232,62 @@ int AudioEngine::play2d(const std::string& filePath, bool loop, float volume, co
             volume = 1.0f;
         }
         
-        ret = _audioEngineImpl->play2d(filePath, loop, volume);
-        if (ret != INVALID_AUDIO_ID)
+        int audioID = _audioIDIndex++;
+        _audioPathIDMap[filePath].push_back(audioID);
+        auto it = _audioPathIDMap.find(filePath);
+
+        auto& audioRef = _audioIDInfoMap[audioID];
+        audioRef.volume = volume;
+        audioRef.loop = loop;
+        audioRef.filePath = &it->first;
+        audioRef.profileHelper = profileHelper;
+        if (profileHelper) {
+            profileHelper->audioIDs.push_back(audioID);
+        }
+
+        // Make room by the least audible voice which is less audible than the new audio
+        AudioInfo* leastAudible = nullptr;
+        unsigned int voiceCount = 0;
+        for (auto&& info : _audioIDInfoMap)
+        {
+            if (info.second.voiceID == INVALID_AUDIO_ID)
+                continue;
+            ++voiceCount;
+            if (!leastAudible || isMoreAudible(*leastAudible, info.second))
+                leastAudible = &info.second;
+        }
+        if (voiceCount >= _maxInstances && _maxVirtualInstances > 0 && leastAudible && isMoreAudible(audioRef, *leastAudible))
         {
-            _audioPathIDMap[filePath].push_back(ret);
-            auto it = _audioPathIDMap.find(filePath);
-            
-            auto& audioRef = _audioIDInfoMap[ret];
-            audioRef.volume = volume;
-            audioRef.loop = loop;
-            audioRef.filePath = &it->first;
-
-            if (profileHelper) {
-                profileHelper->lastPlayTime = std::chrono::high_resolution_clock::now();
-                profileHelper->audioIDs.push_back(ret);
+            virtualizeVoice(*leastAudible);
+            --voiceCount;
+        }
+
+        if (voiceCount < _maxInstances)
+        {
+            if (!playVoice(audioID, audioRef))
+            {
+                // not a voice shortage but the audio or the platform failed
+                remove(audioID);
+                break;
             }
-            audioRef.profileHelper = profileHelper;
         }
+        else if (_maxVirtualInstances > 0)
+        {
+            audioRef.state = AudioState::PLAYING;
+            setVirtualTime(audioRef, 0.0f);
+            scheduleVoiceUpdate();
+        }
+        else
+        {
+            CC_LOG_INFO("Fail to play %s cause by limited max instance of AudioEngine",filePath.c_str());
+            remove(audioID);
+            break;
+        }
+
+        if (profileHelper) {
+            profileHelper->lastPlayTime = std::chrono::high_resolution_clock::now();
+        }
+        ret = audioID;
     } while (0);
 
     return ret;
@@ -286,7 +297,13 @@ void AudioEngine::setLoop(int audioID, bool loop)
 {
     auto it = _audioIDInfoMap.find(audioID);
     if (it != _audioIDInfoMap.end() && it->second.loop != loop){
-        _audioEngineImpl->setLoop(audioID, loop);
+        if (it->second.voiceID != INVALID_AUDIO_ID) {
+            _audioEngineImpl->setLoop(it->second.voiceID, loop);
+        }
+        else {
+            // keep the time a looping audio wrapped to
+            setVirtualTime(it->second, getVirtualTime(it->second));
+        }
         it->second.loop = loop;
     }
 }
@@ -303,7 +320,9 @@ void AudioEngine::setVolume(int audioID, float volume)
         }
 
         if (it->second.volume != volume){
-            _audioEngineImpl->setVolume(audioID, volume);
+            if (it->second.voiceID != INVALID_AUDIO_ID) {
+                _audioEngineImpl->setVolume(it->second.voiceID, volume);
+            }
             it->second.volume = volume;
         }
     }
@@ -313,7 +332,10 @@ void AudioEngine::pause(int audioID)
 {
     auto it = _audioIDInfoMap.find(audioID);
     if (it != _audioIDInfoMap.end() && it->second.state == AudioState::PLAYING){
-        _audioEngineImpl->pause(audioID);
+        if (it->second.voiceID != INVALID_AUDIO_ID) {
+            _audioEngineImpl->pause(it->second.voiceID);
+        }
+        setVirtualTime(it->second, getVirtualTime(it->second));
         it->second.state = AudioState::PAUSED;
     }
 }
@@ -325,7 +347,10 @@ void AudioEngine::pauseAll()
     {
         if (it->second.state == AudioState::PLAYING)
         {
-            _audioEngineImpl->pause(it->first);
+            if (it->second.voiceID != INVALID_AUDIO_ID) {
+                _audioEngineImpl->pause(it->second.voiceID);
+            }
+            setVirtualTime(it->second, getVirtualTime(it->second));
             it->second.state = AudioState::PAUSED;
         }
     }
@@ -335,7 +360,10 @@ void AudioEngine::resume(int audioID)
 {
     auto it = _audioIDInfoMap.find(audioID);
     if (it != _audioIDInfoMap.end() && it->second.state == AudioState::PAUSED){
-        _audioEngineImpl->resume(audioID);
+        if (it->second.voiceID != INVALID_AUDIO_ID) {
+            _audioEngineImpl->resume(it->second.voiceID);
+        }
+        it->second.virtualTimeStamp = std::chrono::high_resolution_clock::now();
         it->second.state = AudioState::PLAYING;
     }
 }
@@ -347,7 +375,10 @@ void AudioEngine::resumeAll()
     {
         if (it->second.state == AudioState::PAUSED)
         {
-            _audioEngineImpl->resume(it->first);
+            if (it->second.voiceID != INVALID_AUDIO_ID) {
+                _audioEngineImpl->resume(it->second.voiceID);
+            }
+            it->second.virtualTimeStamp = std::chrono::high_resolution_clock::now();
             it->second.state = AudioState::PLAYING;
         }
     }
@@ -359,7 +390,11 @@ void AudioEngine::onEnterBackground(const CustomEvent &event) {
     {
         if (it->second.state == AudioState::PLAYING)
         {
-            _audioEngineImpl->pause(it->first);
+            if (it->second.voiceID != INVALID_AUDIO_ID) {
+                _audioEngineImpl->pause(it->second.voiceID);
+            }
+            // the time of a virtual audio stops with the voices
+            setVirtualTime(it->second, getVirtualTime(it->second));
             _breakAudioID.push_back(it->first);
         }
     }
@@ -374,7 +409,13 @@ void AudioEngine::onEnterBackground(const CustomEvent &event) {
 void AudioEngine::onEnterForeground(const CustomEvent &event) {
     auto itEnd = _breakAudioID.end();
     for (auto it = _breakAudioID.begin(); it != itEnd; ++it) {
-        _audioEngineImpl->resume(*it);
+        auto infoIt = _audioIDInfoMap.find(*it);
+        if (infoIt == _audioIDInfoMap.end())
+            continue;
+        if (infoIt->second.voiceID != INVALID_AUDIO_ID) {
+            _audioEngineImpl->resume(infoIt->second.voiceID);
+        }
+        infoIt->second.virtualTimeStamp = std::chrono::high_resolution_clock::now();
     }
     _breakAudioID.clear();
     
@@ -389,7 +430,9 @@ void AudioEngine::stop(int audioID)
 {
     auto it = _audioIDInfoMap.find(audioID);
     if (it != _audioIDInfoMap.end()){
-        _audioEngineImpl->stop(audioID);
+        if (it->second.voiceID != INVALID_AUDIO_ID) {
+            _audioEngineImpl->stop(it->second.voiceID);
+        }
 
         remove(audioID);
     }
@@ -403,10 +446,34 @@ void AudioEngine::remove(int audioID)
             it->second.profileHelper->audioIDs.remove(audioID);
         }
         _audioPathIDMap[*it->second.filePath].remove(audioID);
+        if (it->second.voiceID != INVALID_AUDIO_ID) {
+            _voiceIDMap.erase(it->second.voiceID);
+        }
         _audioIDInfoMap.erase(audioID);
     }
 }
 
+void AudioEngine::removeVoice(int voiceID)
+{
+    // a voice which was taken from its audio by virtualizeVoice isn't mapped anymore
+    auto it = _voiceIDMap.find(voiceID);
+    if (it != _voiceIDMap.end()){
+        remove(it->second);
+    }
+}
+
+void AudioEngine::setVoiceState(int voiceID, AudioState state)
+{
+    auto it = _voiceIDMap.find(voiceID);
+    if (it != _voiceIDMap.end()){
+        auto& info = _audioIDInfoMap[it->second];
+        info.isVoiceStarted = true;
+        if (info.state == AudioState::INITIALIZING) {
+            info.state = state;
+        }
+    }
+}
+
 void AudioEngine::stopAll()
 {
     if(!_audioEngineImpl){
@@ -422,6 +489,7 @@ void AudioEngine::stopAll()
     }
     _audioPathIDMap.clear();
     _audioIDInfoMap.clear();
+    _voiceIDMap.clear();
 }
 
 void AudioEngine::uncache(const std::string &filePath)
@@ -436,15 +504,23 @@ void AudioEngine::uncache(const std::string &filePath)
         
         for (int audioID : copiedIDs)
         {
-            _audioEngineImpl->stop(audioID);
-            
             auto itInfo = _audioIDInfoMap.find(audioID);
             if (itInfo != _audioIDInfoMap.end())
+            {
+                if (itInfo->second.voiceID != INVALID_AUDIO_ID)
+                {
+                    _audioEngineImpl->stop(itInfo->second.voiceID);
+                }
+
+                itInfo = _audioIDInfoMap.find(audioID);
+            }
+            if (itInfo != _audioIDInfoMap.end())
             {
                 if (itInfo->second.profileHelper)
                 {
                     itInfo->second.profileHelper->audioIDs.remove(audioID);
                 }
+                _voiceIDMap.erase(itInfo->second.voiceID);
                 _audioIDInfoMap.erase(audioID);
             }
         }
@@ -473,7 +549,10 @@ float AudioEngine::getDuration(int audioID)
     {
         if (it->second.duration == TIME_UNKNOWN)
         {
-            it->second.duration = _audioEngineImpl->getDuration(audioID);
+            if (it->second.voiceID != INVALID_AUDIO_ID)
+                it->second.duration = _audioEngineImpl->getDuration(it->second.voiceID);
+            else
+                it->second.duration = _audioEngineImpl->getDurationFromFile(*it->second.filePath);
         }
         return it->second.duration;
     }
@@ -497,7 +576,11 @@ bool AudioEngine::setCurrentTime(int audioID, float time)
 {
     auto it = _audioIDInfoMap.find(audioID);
     if (it != _audioIDInfoMap.end() && it->second.state != AudioState::INITIALIZING) {
-        return _audioEngineImpl->setCurrentTime(audioID, time);
+        if (it->second.voiceID != INVALID_AUDIO_ID && !it->second.isSeekPending) {
+            return _audioEngineImpl->setCurrentTime(it->second.voiceID, time);
+        }
+        setVirtualTime(it->second, time);
+        return true;
     }
 
     return false;
@@ -507,7 +590,10 @@ float AudioEngine::getCurrentTime(int audioID)
 {
     auto it = _audioIDInfoMap.find(audioID);
     if (it != _audioIDInfoMap.end() && it->second.state != AudioState::INITIALIZING) {
-        return _audioEngineImpl->getCurrentTime(audioID);
+        if (it->second.voiceID != INVALID_AUDIO_ID && !it->second.isSeekPending) {
+            return _audioEngineImpl->getCurrentTime(it->second.voiceID);
+        }
+        return getVirtualTime(it->second);
     }
     return 0.0f;
 }
@@ -516,7 +602,17 @@ void AudioEngine::setFinishCallback(int audioID, const std::function<void (int,
 {
     auto it = _audioIDInfoMap.find(audioID);
     if (it != _audioIDInfoMap.end()){
-        _audioEngineImpl->setFinishCallback(audioID, callback);
+        it->second.finishCallback = callback;
+        if (it->second.voiceID != INVALID_AUDIO_ID && callback) {
+            // the platform calls back with the id of the voice
+            std::string filePath = *it->second.filePath;
+            _audioEngineImpl->setFinishCallback(it->second.voiceID, [audioID, filePath, callback](int, const std::string&){
+                callback(audioID, filePath);
+            });
+        }
+        else if (it->second.voiceID != INVALID_AUDIO_ID) {
+            _audioEngineImpl->setFinishCallback(it->second.voiceID, nullptr);
+        }
     }
 }
 
@@ -530,6 +626,300 @@ bool AudioEngine::setMaxAudioInstance(int maxInstances)
     return false;
 }
 
+void AudioEngine::setCacheBudget(unsigned int budgetInBytes)
+{
+    _cacheBudget = budgetInBytes;
+    if (_audioEngineImpl)
+    {
+        _audioEngineImpl->setCacheBudget(budgetInBytes);
+    }
+}
+
+void AudioEngine::onMemoryPressure(MemoryPressureLevel level)
+{
+    if (!_audioEngineImpl)
+        return;
+
+    // a budget below the cache size evicts the least recently used data which isn't playing, 1 evicts all of it
+    const unsigned int size = _audioEngineImpl->getCacheSize();
+    const unsigned int target = level == MemoryPressureLevel::CRITICAL ? 1 : std::max(size / 2, 1u);
+    if (size > target && (_cacheBudget == 0 || _cacheBudget > target))
+    {
+        _audioEngineImpl->setCacheBudget(target);
+        _audioEngineImpl->setCacheBudget(_cacheBudget);
+    }
+}
+
+unsigned int AudioEngine::getCacheSize()
+{
+    if (_audioEngineImpl)
+    {
+        return _audioEngineImpl->getCacheSize();
+    }
+    return 0;
+}
+
+std::string AudioEngine::getMixerStats(bool reset)
+{
+#if CC_PLATFORM == CC_PLATFORM_ANDROID
+    if (_audioEngineImpl)
+    {
+        return _audioEngineImpl->getMixerStats(reset);
+    }
+#endif
+    return "";
+}
+
+#if CC_USE_BENCHMARK
+std::string AudioEngine::runMixerBenchmark(bool isLoopbackEnabled)
+{
+#if CC_PLATFORM == CC_PLATFORM_ANDROID
+    if (lazyInit())
+    {
+        return _audioEngineImpl->runMixerBenchmark(isLoopbackEnabled);
+    }
+#endif
+    return "";
+}
+#endif
+
+void AudioEngine::setCacheCompressionEnabled(bool isEnabled)
+{
+    _isCacheCompressionEnabled = isEnabled;
+    if (_audioEngineImpl)
+    {
+        _audioEngineImpl->setCacheCompressionEnabled(isEnabled);
+    }
+}
+
+void AudioEngine::setMaxVirtualAudioInstance(int maxInstances)
+{
+    _maxVirtualInstances = maxInstances > 0 ? maxInstances : 0;
+}
+
+bool AudioEngine::isVirtual(int audioID)
+{
+    auto it = _audioIDInfoMap.find(audioID);
+    return it != _audioIDInfoMap.end() && it->second.voiceID == INVALID_AUDIO_ID;
+}
+
+bool AudioEngine::playVoice(int audioID, AudioInfo& info)
+{
+    int voiceID = _voiceIDIndex++;
+    // the platform may report the state of the voice before play2d returns
+    _voiceIDMap[voiceID] = audioID;
+    info.voiceID = voiceID;
+    info.isVoiceStarted = false;
+
+    unsigned int streamingThreshold = info.profileHelper ? info.profileHelper->profile.streamingThreshold : AudioProfile::DEFAULT_STREAMING_THRESHOLD;
+    if (_audioEngineImpl->play2d(voiceID, *info.filePath, info.loop, info.volume, streamingThreshold) == INVALID_AUDIO_ID)
+    {
+        _voiceIDMap.erase(voiceID);
+        info.voiceID = INVALID_AUDIO_ID;
+        return false;
+    }
+
+    if (info.finishCallback)
+    {
+        auto callback = info.finishCallback;
+        std::string filePath = *info.filePath;
+        _audioEngineImpl->setFinishCallback(voiceID, [audioID, filePath, callback](int, const std::string&){
+            callback(audioID, filePath);
+        });
+    }
+    return true;
+}
+
+void AudioEngine::virtualizeVoice(AudioInfo& info)
+{
+    int voiceID = info.voiceID;
+    float time = info.isSeekPending || !info.isVoiceStarted ? getVirtualTime(info) : _audioEngineImpl->getCurrentTime(voiceID);
+    if (info.duration == TIME_UNKNOWN && info.isVoiceStarted)
+    {
+        info.duration = _audioEngineImpl->getDuration(voiceID);
+    }
+
+    _voiceIDMap.erase(voiceID);
+    info.voiceID = INVALID_AUDIO_ID;
+    info.isSeekPending = false;
+    if (info.state == AudioState::INITIALIZING)
+    {
+        info.state = AudioState::PLAYING;
+    }
+    setVirtualTime(info, time);
+    scheduleVoiceUpdate();
+
+    // the platform may remove other finished voices from _audioIDInfoMap in stop
+    _audioEngineImpl->stop(voiceID);
+}
+
+bool AudioEngine::isMoreAudible(const AudioInfo& info, const AudioInfo& other)
+{
+    int priority = info.profileHelper ? info.profileHelper->profile.priority : 0;
+    int otherPriority = other.profileHelper ? other.profileHelper->profile.priority : 0;
+    if (priority != otherPriority)
+    {
+        return priority > otherPriority;
+    }
+    // paused audio isn't heard
+    float volume = info.state == AudioState::PAUSED ? 0.0f : info.volume;
+    float otherVolume = other.state == AudioState::PAUSED ? 0.0f : other.volume;
+    return volume > otherVolume;
+}
+
+float AudioEngine::getVirtualTime(const AudioInfo& info)
+{
+    float time = info.virtualTime;
+    if (info.state == AudioState::PLAYING)
+    {
+        auto elapsed = std::chrono::high_resolution_clock::now() - info.virtualTimeStamp;
+        time += std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() / 1000000.0f;
+    }
+    if (info.duration > 0.0f)
+    {
+        time = info.loop ? fmodf(time, info.duration) : std::min(time, info.duration);
+    }
+    return time;
+}
+
+void AudioEngine::setVirtualTime(AudioInfo& info, float time)
+{
+    info.virtualTime = time;
+    info.virtualTimeStamp = std::chrono::high_resolution_clock::now();
+}
+
+void AudioEngine::finishVirtual(int audioID)
+{
+    auto it = _audioIDInfoMap.find(audioID);
+    auto callback = it->second.finishCallback;
+    std::string filePath = *it->second.filePath;
+    remove(audioID);
+    if (callback)
+    {
+        callback(audioID, filePath);
+    }
+}
+
+void AudioEngine::scheduleVoiceUpdate()
+{
+    if (!_isVoiceUpdateScheduled)
+    {
+        Application::getInstance()->getScheduler()->schedule(AudioEngine::updateVoices, &_voiceIDMap, VOICE_UPDATE_INTERVAL, false, "AudioEngineVoices");
+        _isVoiceUpdateScheduled = true;
+    }
+}
+
+// Finishes the virtual audio, seeks the voices given to virtual audio once they play,
+// and gives the voices to the most audible audio.
+void AudioEngine::updateVoices(float dt)
+{
+    std::vector<int> audioIDs;
+    audioIDs.reserve(_audioIDInfoMap.size());
+    for (auto&& info : _audioIDInfoMap)
+    {
+        audioIDs.push_back(info.first);
+    }
+
+    bool isVirtualLeft = false;
+    for (int audioID : audioIDs)
+    {
+        auto it = _audioIDInfoMap.find(audioID);
+        if (it == _audioIDInfoMap.end())
+            continue;
+        auto& info = it->second;
+
+        if (info.voiceID == INVALID_AUDIO_ID)
+        {
+            if (info.duration == TIME_UNKNOWN)
+            {
+                float duration = _audioEngineImpl->getDurationFromFile(*info.filePath);
+                if (duration > 0.0f)
+                    info.duration = duration;
+            }
+            if (!info.loop && info.state == AudioState::PLAYING && info.duration > 0.0f && getVirtualTime(info) >= info.duration)
+            {
+                finishVirtual(audioID);
+                continue;
+            }
+            isVirtualLeft = true;
+        }
+        else if (info.isSeekPending)
+        {
+            if (info.isVoiceStarted)
+            {
+                info.isSeekPending = false;
+                int voiceID = info.voiceID;
+                bool isPaused = info.state == AudioState::PAUSED;
+                _audioEngineImpl->setCurrentTime(voiceID, getVirtualTime(info));
+                if (isPaused)
+                    _audioEngineImpl->pause(voiceID);
+            }
+            else
+            {
+                isVirtualLeft = true;
+            }
+        }
+    }
+
+    for (unsigned int i = 0; i < _maxInstances; ++i)
+    {
+        int mostAudibleID = INVALID_AUDIO_ID;
+        AudioInfo* mostAudible = nullptr;
+        AudioInfo* leastAudible = nullptr;
+        unsigned int voiceCount = 0;
+        for (auto&& info : _audioIDInfoMap)
+        {
+            if (info.second.voiceID != INVALID_AUDIO_ID)
+            {
+                ++voiceCount;
+                if (!info.second.isSeekPending && (!leastAudible || isMoreAudible(*leastAudible, info.second)))
+                    leastAudible = &info.second;
+            }
+            else if (info.second.state == AudioState::PLAYING && (!mostAudible || isMoreAudible(info.second, *mostAudible)))
+            {
+                mostAudible = &info.second;
+                mostAudibleID = info.first;
+            }
+        }
+        if (!mostAudible)
+            break;
+
+        if (voiceCount >= _maxInstances)
+        {
+            if (!leastAudible || !isMoreAudible(*mostAudible, *leastAudible))
+                break;
+            virtualizeVoice(*leastAudible);
+            auto it = _audioIDInfoMap.find(mostAudibleID);
+            if (it == _audioIDInfoMap.end())
+                continue;
+            mostAudible = &it->second;
+        }
+
+        float time = getVirtualTime(*mostAudible);
+        if (!playVoice(mostAudibleID, *mostAudible))
+        {
+            CC_LOG_INFO("Fail to play virtual audio %s", mostAudible->filePath->c_str());
+            remove(mostAudibleID);
+            continue;
+        }
+        setVirtualTime(*mostAudible, time);
+        mostAudible->isSeekPending = time > 0.0f;
+        isVirtualLeft = isVirtualLeft || mostAudible->isSeekPending;
+    }
+
+    if (!isVirtualLeft)
+    {
+        isVirtualLeft = std::any_of(_audioIDInfoMap.begin(), _audioIDInfoMap.end(), [](const std::pair<const int, AudioInfo>& info) {
+            return info.second.voiceID == INVALID_AUDIO_ID || info.second.isSeekPending;
+        });
+    }
+    if (!isVirtualLeft && _isVoiceUpdateScheduled)
+    {
+        Application::getInstance()->getScheduler()->unschedule("AudioEngineVoices", &_voiceIDMap);
+        _isVoiceUpdateScheduled = false;
+    }
+}
+
 bool AudioEngine::isLoop(int audioID)
 {
     auto tmpIterator = _audioIDInfoMap.find(audioID);
@@ -600,7 +990,10 @@ void AudioEngine::preload(const std::string& filePath, std::function<void(bool i
 {
     if (!isEnabled())
     {
-        callback(false);
+        if (callback)
+        {
+            callback(false);
+        }
         return;
     }
     
@@ -616,7 +1009,39 @@ void AudioEngine::preload(const std::string& filePath, std::function<void(bool i
             return;
         }
 
-        _audioEngineImpl->preload(filePath, callback);
+        _audioEngineImpl->preload(filePath, callback, getDefaultProfile()->streamingThreshold);
+    }
+}
+
+void AudioEngine::preloadBatch(const std::vector<std::string>& filePaths,
+                               const std::function<void(unsigned int finishedCount, unsigned int totalCount, unsigned int failedCount)>& progressCallback)
+{
+    const auto totalCount = static_cast<unsigned int>(filePaths.size());
+    if (totalCount == 0)
+    {
+        if (progressCallback)
+        {
+            progressCallback(0, 0, 0);
+        }
+        return;
+    }
+
+    // The load callbacks are invoked in Cocos thread, the counters need no lock
+    auto finishedCount = std::make_shared<unsigned int>(0);
+    auto failedCount = std::make_shared<unsigned int>(0);
+    for (const auto& filePath : filePaths)
+    {
+        preload(filePath, [=](bool isSuccess){
+            ++*finishedCount;
+            if (!isSuccess)
+            {
+                ++*failedCount;
+            }
+            if (progressCallback)
+            {
+                progressCallback(*finishedCount, totalCount, *failedCount);
+            }
+        });
     }
 }
 
@@ -624,9 +1049,9 @@ void AudioEngine::addTask(const std::function<void()>& task)
 {
     lazyInit();
 
-    if (_audioEngineImpl && s_threadPool)
+    if (_audioEngineImpl)
     {
-        s_threadPool->addTask(task);
+        ThreadPool::getDefaultThreadPool()->pushTask([task](int /*threadId*/){ task(); }, ThreadPool::TaskType::AUDIO);
     }
 }
 
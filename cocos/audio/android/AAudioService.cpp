@@ -0,0 +1,578 @@
+/****************************************************************************
+Copyright (c) 2016 Chukong Technologies Inc.
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#define LOG_TAG "AAudioService"
+
+#include "audio/android/AAudioService.h"
+#include "audio/android/AudioMixerController.h"
+#include "audio/android/cutils/log.h"
+
+#include <dlfcn.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <string.h>
+#include <vector>
+
+namespace cc { 
+
+namespace {
+
+// The AAudio entries used by the service, resolved from libaaudio.so since they are only declared
+// by the NDK headers when building for API level 26.
+struct AAudioLibrary
+{
+    aaudio_result_t (*createStreamBuilder)(AAudioStreamBuilder** builder);
+    const char* (*convertResultToText)(aaudio_result_t result);
+
+    void (*builderSetPerformanceMode)(AAudioStreamBuilder* builder, aaudio_performance_mode_t mode);
+    void (*builderSetSharingMode)(AAudioStreamBuilder* builder, aaudio_sharing_mode_t sharingMode);
+    void (*builderSetFormat)(AAudioStreamBuilder* builder, aaudio_format_t format);
+    void (*builderSetChannelCount)(AAudioStreamBuilder* builder, int32_t channelCount);
+    void (*builderSetSampleRate)(AAudioStreamBuilder* builder, int32_t sampleRate);
+    void (*builderSetDataCallback)(AAudioStreamBuilder* builder, AAudioStream_dataCallback callback, void* userData);
+    void (*builderSetErrorCallback)(AAudioStreamBuilder* builder, AAudioStream_errorCallback callback, void* userData);
+    void (*builderSetDirection)(AAudioStreamBuilder* builder, aaudio_direction_t direction);
+    aaudio_result_t (*builderOpenStream)(AAudioStreamBuilder* builder, AAudioStream** stream);
+    aaudio_result_t (*builderDelete)(AAudioStreamBuilder* builder);
+
+    aaudio_result_t (*streamRequestStart)(AAudioStream* stream);
+    aaudio_result_t (*streamRequestPause)(AAudioStream* stream);
+    aaudio_result_t (*streamClose)(AAudioStream* stream);
+    aaudio_result_t (*streamSetBufferSizeInFrames)(AAudioStream* stream, int32_t numFrames);
+    int32_t (*streamGetFramesPerBurst)(AAudioStream* stream);
+    int32_t (*streamGetSampleRate)(AAudioStream* stream);
+    aaudio_format_t (*streamGetFormat)(AAudioStream* stream);
+    aaudio_sharing_mode_t (*streamGetSharingMode)(AAudioStream* stream);
+    aaudio_performance_mode_t (*streamGetPerformanceMode)(AAudioStream* stream);
+    aaudio_result_t (*streamRead)(AAudioStream* stream, void* buffer, int32_t numFrames, int64_t timeoutNanoseconds);
+    int32_t (*streamGetXRunCount)(AAudioStream* stream);
+    aaudio_result_t (*streamGetTimestamp)(AAudioStream* stream, clockid_t clockid, int64_t* framePosition, int64_t* timeNanoseconds);
+    int64_t (*streamGetFramesWritten)(AAudioStream* stream);
+    int32_t (*streamGetBufferCapacityInFrames)(AAudioStream* stream);
+
+    bool isLoaded;
+};
+
+template <typename T>
+bool loadSymbol(void* handle, const char* name, T& symbol)
+{
+    symbol = reinterpret_cast<T>(dlsym(handle, name));
+    if (symbol == nullptr)
+    {
+        ALOGE("Symbol %s isn't found in libaaudio.so", name);
+        return false;
+    }
+    return true;
+}
+
+AAudioLibrary loadLibrary()
+{
+    AAudioLibrary lib;
+    memset(&lib, 0, sizeof(lib));
+
+    void* handle = dlopen("libaaudio.so", RTLD_NOW);
+    if (handle == nullptr)
+    {
+        ALOGW("libaaudio.so isn't available: %s", dlerror());
+        return lib;
+    }
+
+    // The library is kept loaded for the lifetime of the process.
+    lib.isLoaded = loadSymbol(handle, "AAudio_createStreamBuilder", lib.createStreamBuilder)
+        && loadSymbol(handle, "AAudio_convertResultToText", lib.convertResultToText)
+        && loadSymbol(handle, "AAudioStreamBuilder_setPerformanceMode", lib.builderSetPerformanceMode)
+        && loadSymbol(handle, "AAudioStreamBuilder_setSharingMode", lib.builderSetSharingMode)
+        && loadSymbol(handle, "AAudioStreamBuilder_setFormat", lib.builderSetFormat)
+        && loadSymbol(handle, "AAudioStreamBuilder_setChannelCount", lib.builderSetChannelCount)
+        && loadSymbol(handle, "AAudioStreamBuilder_setSampleRate", lib.builderSetSampleRate)
+        && loadSymbol(handle, "AAudioStreamBuilder_setDataCallback", lib.builderSetDataCallback)
+        && loadSymbol(handle, "AAudioStreamBuilder_setErrorCallback", lib.builderSetErrorCallback)
+        && loadSymbol(handle, "AAudioStreamBuilder_setDirection", lib.builderSetDirection)
+        && loadSymbol(handle, "AAudioStreamBuilder_openStream", lib.builderOpenStream)
+        && loadSymbol(handle, "AAudioStreamBuilder_delete", lib.builderDelete)
+        && loadSymbol(handle, "AAudioStream_requestStart", lib.streamRequestStart)
+        && loadSymbol(handle, "AAudioStream_requestPause", lib.streamRequestPause)
+        && loadSymbol(handle, "AAudioStream_close", lib.streamClose)
+        && loadSymbol(handle, "AAudioStream_setBufferSizeInFrames", lib.streamSetBufferSizeInFrames)
+        && loadSymbol(handle, "AAudioStream_getFramesPerBurst", lib.streamGetFramesPerBurst)
+        && loadSymbol(handle, "AAudioStream_getSampleRate", lib.streamGetSampleRate)
+        && loadSymbol(handle, "AAudioStream_getFormat", lib.streamGetFormat)
+        && loadSymbol(handle, "AAudioStream_getSharingMode", lib.streamGetSharingMode)
+        && loadSymbol(handle, "AAudioStream_getPerformanceMode", lib.streamGetPerformanceMode)
+        && loadSymbol(handle, "AAudioStream_read", lib.streamRead)
+        && loadSymbol(handle, "AAudioStream_getXRunCount", lib.streamGetXRunCount)
+        && loadSymbol(handle, "AAudioStream_getTimestamp", lib.streamGetTimestamp)
+        && loadSymbol(handle, "AAudioStream_getFramesWritten", lib.streamGetFramesWritten)
+        && loadSymbol(handle, "AAudioStream_getBufferCapacityInFrames", lib.streamGetBufferCapacityInFrames);
+    return lib;
+}
+
+const AAudioLibrary& getLibrary()
+{
+    static const AAudioLibrary __library = loadLibrary();
+    return __library;
+}
+
+int64_t nowInNanoseconds()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+// The pulse of the loopback test, a 1kHz tone loud enough to be told from the noise of the room
+#define LOOPBACK_PULSE_FREQUENCY (1000.0f)
+#define LOOPBACK_PULSE_AMPLITUDE (0.8f)
+#define LOOPBACK_PULSE_MS (10)
+// Played after the streams had time to settle
+#define LOOPBACK_PULSE_DELAY_MS (300)
+#define LOOPBACK_THRESHOLD (0.2f)
+
+// The state of the loopback test, all of it used by the output callback only but isDone
+struct Loopback
+{
+    AAudioStream* input;
+    std::vector<float> inputBuffer;
+    int sampleRate;
+    int64_t pulseStartFrame;
+    int64_t pulseEndFrame;
+    int64_t outputFrames;
+    int64_t inputFrames;
+    int64_t detectedFrame;
+    bool isInputDrained;
+    std::atomic<bool> isDone;
+};
+
+aaudio_data_callback_result_t loopbackCallback(AAudioStream* stream, void* userData, void* audioData, int32_t numFrames)
+{
+    auto loopback = static_cast<Loopback*>(userData);
+    const AAudioLibrary& lib = getLibrary();
+
+    // What the input recorded before the output ran is dropped, the frames of both are counted from here on
+    if (!loopback->isInputDrained)
+    {
+        while (lib.streamRead(loopback->input, loopback->inputBuffer.data(), (int32_t) loopback->inputBuffer.size(), 0) > 0)
+        {
+        }
+        loopback->isInputDrained = true;
+    }
+
+    const int32_t framesToRead = std::min(numFrames, (int32_t) loopback->inputBuffer.size());
+    const aaudio_result_t framesRead = lib.streamRead(loopback->input, loopback->inputBuffer.data(), framesToRead, 0);
+    for (int32_t i = 0; i < framesRead && loopback->detectedFrame < 0; ++i)
+    {
+        if (loopback->inputFrames + i > loopback->pulseStartFrame && fabsf(loopback->inputBuffer[i]) > LOOPBACK_THRESHOLD)
+        {
+            loopback->detectedFrame = loopback->inputFrames + i;
+        }
+    }
+    if (framesRead > 0)
+    {
+        loopback->inputFrames += framesRead;
+    }
+
+    auto out = static_cast<float*>(audioData);
+    for (int32_t i = 0; i < numFrames; ++i)
+    {
+        const int64_t frame = loopback->outputFrames + i;
+        out[i] = 0.0f;
+        if (frame >= loopback->pulseStartFrame && frame < loopback->pulseEndFrame)
+        {
+            const float t = (float) (frame - loopback->pulseStartFrame) / loopback->sampleRate;
+            out[i] = LOOPBACK_PULSE_AMPLITUDE * sinf(2.0f * (float) M_PI * LOOPBACK_PULSE_FREQUENCY * t);
+        }
+    }
+    loopback->outputFrames += numFrames;
+
+    if (loopback->detectedFrame >= 0)
+    {
+        loopback->isDone = true;
+        return AAUDIO_CALLBACK_RESULT_STOP;
+    }
+    return AAUDIO_CALLBACK_RESULT_CONTINUE;
+}
+
+AAudioStream* openLoopbackStream(aaudio_direction_t direction, int sampleRate, Loopback* loopback)
+{
+    const AAudioLibrary& lib = getLibrary();
+    AAudioStreamBuilder* builder = nullptr;
+    if (lib.createStreamBuilder(&builder) != AAUDIO_OK)
+    {
+        return nullptr;
+    }
+
+    lib.builderSetDirection(builder, direction);
+    lib.builderSetPerformanceMode(builder, AAUDIO_PERFORMANCE_MODE_LOW_LATENCY);
+    lib.builderSetFormat(builder, AAUDIO_FORMAT_PCM_FLOAT);
+    lib.builderSetChannelCount(builder, 1);
+    lib.builderSetSampleRate(builder, sampleRate);
+    if (direction == AAUDIO_DIRECTION_OUTPUT)
+    {
+        lib.builderSetDataCallback(builder, loopbackCallback, loopback);
+    }
+
+    AAudioStream* stream = nullptr;
+    aaudio_result_t r = lib.builderOpenStream(builder, &stream);
+    lib.builderDelete(builder);
+    if (r != AAUDIO_OK)
+    {
+        ALOGW("Loopback %s stream couldn't be opened: %s", direction == AAUDIO_DIRECTION_INPUT ? "input" : "output",
+              lib.convertResultToText(r));
+        return nullptr;
+    }
+
+    if (lib.streamGetSampleRate(stream) != sampleRate)
+    {
+        ALOGW("Loopback stream opened with sample rate %d instead of %d", lib.streamGetSampleRate(stream), sampleRate);
+        lib.streamClose(stream);
+        return nullptr;
+    }
+    return stream;
+}
+
+} // namespace {
+
+#define AAUDIO_RETURN_VAL_IF_FAILED(r, rval, ...) \
+    if (r != AAUDIO_OK) \
+    { \
+        ALOGE(__VA_ARGS__); \
+        ALOGE("AAudio error: %s", getLibrary().convertResultToText(r)); \
+        return rval; \
+    }
+
+// Bursts queued ahead of the device, one more than the burst being played absorbs the jitter of the callback
+#define AAUDIO_BUFFER_SIZE_IN_BURSTS (2)
+
+bool AAudioService::isSupported()
+{
+    return getLibrary().isLoaded;
+}
+
+AAudioService::AAudioService()
+        : _stream(nullptr), _numChannels(0), _sampleRate(0), _bytesPerFrame(0),
+          _controller(nullptr), _readOffset(0), _closedXRunCount(0), _isPaused(false), _isRestarting(false), _isDestroyed(false)
+{
+}
+
+AAudioService::~AAudioService()
+{
+    ALOGV("~AAudioService() (%p)", this);
+    {
+        std::lock_guard<std::mutex> lk(_streamMutex);
+        _isDestroyed = true;
+    }
+
+    if (_restartThread.joinable())
+    {
+        _restartThread.join();
+    }
+
+    // Closing waits for the callbacks in flight, the lock isn't held for an error callback may be waiting on it.
+    closeStream();
+    ALOGV("~AAudioService() end");
+}
+
+bool AAudioService::init(AudioMixerController* controller, int numChannels, int sampleRate)
+{
+    _controller = controller;
+    _numChannels = numChannels;
+    _sampleRate = sampleRate;
+    _bytesPerFrame = numChannels * (controller->isFloatOutput() ? sizeof(float) : sizeof(int16_t));
+    _readOffset = controller->current()->size;
+
+    std::lock_guard<std::mutex> lk(_streamMutex);
+    if (!openStream())
+    {
+        return false;
+    }
+
+    aaudio_result_t r = getLibrary().streamRequestStart(_stream);
+    AAUDIO_RETURN_VAL_IF_FAILED(r, false, "AAudioService::init, requestStart failed");
+    return true;
+}
+
+bool AAudioService::openStream()
+{
+    const AAudioLibrary& lib = getLibrary();
+    const aaudio_format_t format = _controller->isFloatOutput() ? AAUDIO_FORMAT_PCM_FLOAT : AAUDIO_FORMAT_PCM_I16;
+
+    AAudioStreamBuilder* builder = nullptr;
+    aaudio_result_t r = lib.createStreamBuilder(&builder);
+    AAUDIO_RETURN_VAL_IF_FAILED(r, false, "AAudio_createStreamBuilder failed");
+
+    // AAudio opens a shared stream when the exclusive one isn't available.
+    lib.builderSetPerformanceMode(builder, AAUDIO_PERFORMANCE_MODE_LOW_LATENCY);
+    lib.builderSetSharingMode(builder, AAUDIO_SHARING_MODE_EXCLUSIVE);
+    lib.builderSetFormat(builder, format);
+    lib.builderSetChannelCount(builder, _numChannels);
+    lib.builderSetSampleRate(builder, _sampleRate);
+    lib.builderSetDataCallback(builder, dataCallback, this);
+    lib.builderSetErrorCallback(builder, errorCallback, this);
+
+    AAudioStream* stream = nullptr;
+    r = lib.builderOpenStream(builder, &stream);
+    lib.builderDelete(builder);
+    AAUDIO_RETURN_VAL_IF_FAILED(r, false, "AAudioStreamBuilder_openStream failed");
+
+    if (lib.streamGetFormat(stream) != format || lib.streamGetSampleRate(stream) != _sampleRate)
+    {
+        ALOGE("AAudio stream opened with format %d, sample rate %d, but format %d, sample rate %d was asked",
+              lib.streamGetFormat(stream), lib.streamGetSampleRate(stream), format, _sampleRate);
+        lib.streamClose(stream);
+        return false;
+    }
+
+    const int32_t framesPerBurst = lib.streamGetFramesPerBurst(stream);
+    if (framesPerBurst > 0)
+    {
+        lib.streamSetBufferSizeInFrames(stream, framesPerBurst * AAUDIO_BUFFER_SIZE_IN_BURSTS);
+    }
+
+    ALOGI("AAudio stream opened, sharing mode: %s, performance mode: %d, frames per burst: %d",
+          lib.streamGetSharingMode(stream) == AAUDIO_SHARING_MODE_EXCLUSIVE ? "exclusive" : "shared",
+          lib.streamGetPerformanceMode(stream), framesPerBurst);
+    _stream = stream;
+    return true;
+}
+
+void AAudioService::closeStream()
+{
+    if (_stream != nullptr)
+    {
+        getLibrary().streamClose(_stream);
+        _stream = nullptr;
+    }
+}
+
+// A disconnected stream, e.g. when the headphones are plugged out, is reopened on the new device.
+// AAudio doesn't allow that from its own callback thread, so it is done on _restartThread.
+void AAudioService::restartStream()
+{
+    AAudioStream* oldStream = nullptr;
+    {
+        std::lock_guard<std::mutex> lk(_streamMutex);
+        oldStream = _stream;
+        _stream = nullptr;
+        if (oldStream != nullptr)
+        {
+            _closedXRunCount += getLibrary().streamGetXRunCount(oldStream);
+        }
+    }
+
+    if (oldStream != nullptr)
+    {
+        getLibrary().streamClose(oldStream);
+    }
+
+    std::lock_guard<std::mutex> lk(_streamMutex);
+    _isRestarting = false;
+    if (_isDestroyed || !openStream())
+    {
+        return;
+    }
+
+    if (!_isPaused)
+    {
+        aaudio_result_t r = getLibrary().streamRequestStart(_stream);
+        AAUDIO_RETURN_VAL_IF_FAILED(r, , "AAudioService::restartStream, requestStart failed");
+    }
+}
+
+aaudio_data_callback_result_t AAudioService::onAudioReady(void* audioData, int32_t numFrames)
+{
+    auto out = static_cast<uint8_t*>(audioData);
+    size_t remaining = numFrames * _bytesPerFrame;
+    auto current = _controller->current();
+
+    // The buffers AAudio asks for are bursts of the device, which needn't have the size of the mixing buffer,
+    // the part of a mixed buffer which doesn't fit is copied by the next callback.
+    while (remaining > 0)
+    {
+        if (_readOffset >= current->size)
+        {
+            if (!_controller->hasPlayingTacks() || _controller->isPaused())
+            {
+                memset(out, 0, remaining);
+                break;
+            }
+
+            _controller->mixOneFrame();
+            _readOffset = 0;
+        }
+
+        const size_t bytes = std::min(remaining, current->size - _readOffset);
+        memcpy(out, static_cast<const uint8_t*>(current->buf) + _readOffset, bytes);
+        _readOffset += bytes;
+        out += bytes;
+        remaining -= bytes;
+    }
+
+    return AAUDIO_CALLBACK_RESULT_CONTINUE;
+}
+
+void AAudioService::onError(aaudio_result_t error)
+{
+    ALOGW("AAudio stream error: %s", getLibrary().convertResultToText(error));
+    if (error != AAUDIO_ERROR_DISCONNECTED)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lk(_streamMutex);
+    if (_isDestroyed || _isRestarting)
+    {
+        return;
+    }
+
+    // A restart holds the lock until it returns, the last one has finished by now
+    _isRestarting = true;
+    if (_restartThread.joinable())
+    {
+        _restartThread.join();
+    }
+    _restartThread = std::thread(&AAudioService::restartStream, this);
+}
+
+aaudio_data_callback_result_t AAudioService::dataCallback(AAudioStream* stream, void* userData, void* audioData, int32_t numFrames)
+{
+    return static_cast<AAudioService*>(userData)->onAudioReady(audioData, numFrames);
+}
+
+void AAudioService::errorCallback(AAudioStream* stream, void* userData, aaudio_result_t error)
+{
+    static_cast<AAudioService*>(userData)->onError(error);
+}
+
+int32_t AAudioService::getXRunCount()
+{
+    std::lock_guard<std::mutex> lk(_streamMutex);
+    return _closedXRunCount + (_stream != nullptr ? getLibrary().streamGetXRunCount(_stream) : 0);
+}
+
+float AAudioService::getOutputLatency()
+{
+    std::lock_guard<std::mutex> lk(_streamMutex);
+    if (_stream == nullptr)
+    {
+        return -1.0f;
+    }
+
+    const AAudioLibrary& lib = getLibrary();
+    int64_t framePosition = 0;
+    int64_t timeNanoseconds = 0;
+    if (lib.streamGetTimestamp(_stream, CLOCK_MONOTONIC, &framePosition, &timeNanoseconds) != AAUDIO_OK)
+    {
+        return -1.0f;
+    }
+
+    // The frame presented at timeNanoseconds is framePosition, the last one written is presented that many frames later
+    const int64_t framesWritten = lib.streamGetFramesWritten(_stream);
+    const int64_t writtenPresentationTime = timeNanoseconds + (framesWritten - framePosition) * 1000000000 / _sampleRate;
+    return std::max(writtenPresentationTime - nowInNanoseconds(), (int64_t) 0) / 1000000.0f;
+}
+
+float AAudioService::measureRoundTripLatency(int sampleRate, int timeoutMs)
+{
+    if (!isSupported())
+    {
+        return -1.0f;
+    }
+
+    const AAudioLibrary& lib = getLibrary();
+    Loopback loopback;
+    loopback.input = openLoopbackStream(AAUDIO_DIRECTION_INPUT, sampleRate, &loopback);
+    if (loopback.input == nullptr)
+    {
+        return -1.0f;
+    }
+
+    loopback.inputBuffer.resize(std::max(lib.streamGetBufferCapacityInFrames(loopback.input), sampleRate / 10));
+    loopback.sampleRate = sampleRate;
+    loopback.pulseStartFrame = (int64_t) sampleRate * LOOPBACK_PULSE_DELAY_MS / 1000;
+    loopback.pulseEndFrame = loopback.pulseStartFrame + (int64_t) sampleRate * LOOPBACK_PULSE_MS / 1000;
+    loopback.outputFrames = 0;
+    loopback.inputFrames = 0;
+    loopback.detectedFrame = -1;
+    loopback.isInputDrained = false;
+    loopback.isDone = false;
+
+    AAudioStream* output = openLoopbackStream(AAUDIO_DIRECTION_OUTPUT, sampleRate, &loopback);
+    if (output == nullptr)
+    {
+        lib.streamClose(loopback.input);
+        return -1.0f;
+    }
+
+    float latency = -1.0f;
+    if (lib.streamRequestStart(loopback.input) == AAUDIO_OK && lib.streamRequestStart(output) == AAUDIO_OK)
+    {
+        const int64_t deadline = nowInNanoseconds() + (int64_t) (timeoutMs + LOOPBACK_PULSE_DELAY_MS) * 1000000;
+        while (!loopback.isDone && nowInNanoseconds() < deadline)
+        {
+            usleep(5000);
+        }
+    }
+
+    // Closing waits for the callback in flight, only then its state is read
+    lib.streamClose(output);
+    lib.streamClose(loopback.input);
+    if (loopback.detectedFrame >= 0)
+    {
+        latency = (loopback.detectedFrame - loopback.pulseStartFrame) * 1000.0f / sampleRate;
+        ALOGI("Round trip latency: %.2fms", latency);
+    }
+    else
+    {
+        ALOGW("The loopback pulse wasn't heard within %dms", timeoutMs);
+    }
+    return latency;
+}
+
+void AAudioService::pause()
+{
+    std::lock_guard<std::mutex> lk(_streamMutex);
+    _isPaused = true;
+    if (_stream != nullptr)
+    {
+        aaudio_result_t r = getLibrary().streamRequestPause(_stream);
+        AAUDIO_RETURN_VAL_IF_FAILED(r, , "AAudioService::pause failed");
+    }
+}
+
+void AAudioService::resume()
+{
+    std::lock_guard<std::mutex> lk(_streamMutex);
+    _isPaused = false;
+    if (_stream != nullptr)
+    {
+        aaudio_result_t r = getLibrary().streamRequestStart(_stream);
+        AAUDIO_RETURN_VAL_IF_FAILED(r, , "AAudioService::resume failed");
+    }
+}
+
+} // namespace cc { 
@@ -0,0 +1,106 @@
+/****************************************************************************
+Copyright (c) 2016 Chukong Technologies Inc.
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#pragma once
+
+#include <aaudio/AAudio.h>
+
+#include <mutex>
+#include <thread>
+
+namespace cc { 
+
+class AudioMixerController;
+
+// Plays the mix of AudioMixerController through an AAudio stream, Android 8.0 and later.
+// The stream asks for the low latency performance mode and the exclusive sharing mode, its data callback
+// runs on the high priority thread of AAudio and copies the mixing buffer into the buffers it is handed,
+// whatever their size is. libaaudio.so is loaded at runtime, so the same library still runs on devices
+// which only have OpenSL ES, PcmAudioService is used on those.
+class AAudioService
+{
+public:
+    static bool isSupported();
+
+    inline int getChannelCount() const
+    { return _numChannels; };
+
+    inline int getSampleRate() const
+    { return _sampleRate; };
+
+    // Underruns reported by AAudio since the service started, over the streams it reopened
+    int32_t getXRunCount();
+
+    // Milliseconds from a frame being handed to the stream to it being presented, from the timestamp of the stream.
+    // -1 while the stream hasn't presented frames yet.
+    float getOutputLatency();
+
+    // Plays a pulse through a mono stream and listens for it on the microphone, on a stream of its own, which
+    // needs the RECORD_AUDIO permission. Returns the round trip time in milliseconds, or -1 when an input stream
+    // can't be opened or the pulse isn't heard within timeoutMs. The input is read from the output callback, so both
+    // count frames in step, the result is accurate to a burst.
+    static float measureRoundTripLatency(int sampleRate, int timeoutMs = 2000);
+
+private:
+    AAudioService();
+
+    virtual ~AAudioService();
+
+    bool init(AudioMixerController* controller, int numChannels, int sampleRate);
+
+    bool openStream();
+    void closeStream();
+    void restartStream();
+
+    aaudio_data_callback_result_t onAudioReady(void* audioData, int32_t numFrames);
+    void onError(aaudio_result_t error);
+
+    void pause();
+    void resume();
+
+    static aaudio_data_callback_result_t dataCallback(AAudioStream* stream, void* userData, void* audioData, int32_t numFrames);
+    static void errorCallback(AAudioStream* stream, void* userData, aaudio_result_t error);
+
+private:
+    AAudioStream* _stream;
+    std::mutex _streamMutex;
+    std::thread _restartThread;
+
+    int _numChannels;
+    int _sampleRate;
+    int _bytesPerFrame;
+
+    AudioMixerController* _controller;
+    size_t _readOffset; // bytes of the mixing buffer already copied to the stream
+    int32_t _closedXRunCount; // of the streams closed by restarts
+
+    bool _isPaused;
+    bool _isRestarting;
+    bool _isDestroyed;
+
+    friend class AudioPlayerProvider;
+};
+
+} // namespace cc { 
@@ -91,6 +91,22 @@ bool AudioDecoder::init(const std::string &url, int sampleRate)
     return true;
 }
 
+bool AudioDecoder::openStream()
+{
+    ALOGW("Streaming decode of (%s) isn't supported!", _url.c_str());
+    return false;
+}
+
+int AudioDecoder::readFrames(void* buffer, int numFrames)
+{
+    return 0;
+}
+
+bool AudioDecoder::seekToFrame(int frame)
+{
+    return false;
+}
+
 bool AudioDecoder::start()
 {
     auto oldTime = clockNow();
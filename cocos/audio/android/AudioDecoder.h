@@ -27,7 +27,7 @@ THE SOFTWARE.
 
 #include "audio/android/OpenSLHelper.h"
 #include "audio/android/PcmData.h"
-#include "base/Data.h"
+#include "platform/FileUtils.h"
 
 namespace cc { 
 
@@ -44,6 +44,14 @@ public:
     inline PcmData getResult()
     { return _result; };
 
+    // Streaming decode, used instead of start() by the tracks of files above the streaming threshold.
+    // openStream() fills the header of getResult() without pcm data, readFrames() decodes the next
+    // frames of the source as interleaved int16 and returns how many, 0 at the end of the source.
+    // The pcm data keeps the sample rate and channel count of the source, the mixer converts them.
+    virtual bool openStream();
+    virtual int readFrames(void* buffer, int numFrames);
+    virtual bool seekToFrame(int frame);
+
 protected:
     virtual bool decodeToPcm() = 0;
     bool resample();
@@ -57,7 +65,7 @@ protected:
     std::string _url;
     PcmData _result;
     int _sampleRate;
-    Data _fileData;
+    MappedFile _fileData;
     size_t _fileCurrPos;
 };
 
@@ -32,18 +32,19 @@ THE SOFTWARE.
 namespace cc { 
 
 AudioDecoderMp3::AudioDecoderMp3()
+        : _streamDecoder(nullptr)
 {
     ALOGV("Create AudioDecoderMp3");
 }
 
 AudioDecoderMp3::~AudioDecoderMp3()
 {
-
+    delete _streamDecoder;
 }
 
 bool AudioDecoderMp3::decodeToPcm()
 {
-    _fileData = FileUtils::getInstance()->getDataFromFile(_url);
+    _fileData = FileUtils::getInstance()->mapFile(_url);
     if (_fileData.isNull())
     {
         return false;
@@ -80,4 +81,51 @@ bool AudioDecoderMp3::decodeToPcm()
     return false;
 }
 
-} // namespace cc { 
\ No newline at end of file
+bool AudioDecoderMp3::openStream()
+{
+    _fileData = FileUtils::getInstance()->mapFile(_url);
+    if (_fileData.isNull())
+    {
+        return false;
+    }
+
+    // Mp3Reader keeps the pointer of its callbacks
+    static mp3_callbacks __streamCallbacks = {
+        AudioDecoder::fileRead,
+        AudioDecoder::fileSeek,
+        AudioDecoder::fileClose,
+        AudioDecoder::fileTell
+    };
+
+    _fileCurrPos = 0;
+    _streamDecoder = new (std::nothrow) Mp3Decoder();
+    if (_streamDecoder == nullptr || !_streamDecoder->init(&__streamCallbacks, this) || _streamDecoder->getNumChannels() > 2)
+    {
+        ALOGE("Couldn't stream (%s)", _url.c_str());
+        return false;
+    }
+
+    const int numChannels = _streamDecoder->getNumChannels();
+    const int sampleRate = _streamDecoder->getSampleRate();
+    _result.numChannels = numChannels;
+    _result.sampleRate = sampleRate;
+    _result.bitsPerSample = SL_PCMSAMPLEFORMAT_FIXED_16;
+    _result.containerSize = SL_PCMSAMPLEFORMAT_FIXED_16;
+    _result.channelMask = numChannels == 1 ? SL_SPEAKER_FRONT_CENTER : (SL_SPEAKER_FRONT_LEFT | SL_SPEAKER_FRONT_RIGHT);
+    _result.endianness = SL_BYTEORDER_LITTLEENDIAN;
+    _result.numFrames = _streamDecoder->getNumFrames();
+    _result.duration = 1.0f * _result.numFrames / sampleRate;
+    return true;
+}
+
+int AudioDecoderMp3::readFrames(void* buffer, int numFrames)
+{
+    return _streamDecoder->read((int16_t*)buffer, numFrames);
+}
+
+bool AudioDecoderMp3::seekToFrame(int frame)
+{
+    return _streamDecoder->seek(frame);
+}
+
+} // namespace cc {
@@ -27,6 +27,8 @@ THE SOFTWARE.
 
 #include "audio/android/AudioDecoder.h"
 
+class Mp3Decoder;
+
 namespace cc { 
 
 class AudioDecoderMp3 : public AudioDecoder
@@ -37,6 +39,12 @@ protected:
 
     virtual bool decodeToPcm() override;
 
+    virtual bool openStream() override;
+    virtual int readFrames(void* buffer, int numFrames) override;
+    virtual bool seekToFrame(int frame) override;
+
+    Mp3Decoder* _streamDecoder;
+
     friend class AudioDecoderProvider;
 };
 
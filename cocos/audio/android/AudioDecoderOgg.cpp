@@ -31,13 +31,17 @@ THE SOFTWARE.
 namespace cc { 
 
 AudioDecoderOgg::AudioDecoderOgg()
+        : _isStreamOpened(false)
 {
     ALOGV("Create AudioDecoderOgg");
 }
 
 AudioDecoderOgg::~AudioDecoderOgg()
 {
-
+    if (_isStreamOpened)
+    {
+        ov_clear(&_vf);
+    }
 }
 
 int AudioDecoderOgg::fseek64Wrap(void* datasource, ogg_int64_t off, int whence)
@@ -47,7 +51,7 @@ int AudioDecoderOgg::fseek64Wrap(void* datasource, ogg_int64_t off, int whence)
 
 bool AudioDecoderOgg::decodeToPcm()
 {
-    _fileData = FileUtils::getInstance()->getDataFromFile(_url);
+    _fileData = FileUtils::getInstance()->mapFile(_url);
     if (_fileData.isNull())
     {
         return false;
@@ -110,4 +114,73 @@ bool AudioDecoderOgg::decodeToPcm()
     return (curPos > 0);
 }
 
-} // namespace cc { 
\ No newline at end of file
+bool AudioDecoderOgg::openStream()
+{
+    _fileData = FileUtils::getInstance()->mapFile(_url);
+    if (_fileData.isNull())
+    {
+        return false;
+    }
+
+    ov_callbacks callbacks;
+    callbacks.read_func = AudioDecoder::fileRead;
+    callbacks.seek_func = AudioDecoderOgg::fseek64Wrap;
+    callbacks.close_func = AudioDecoder::fileClose;
+    callbacks.tell_func = AudioDecoder::fileTell;
+
+    _fileCurrPos = 0;
+
+    int ret = ov_open_callbacks(this, &_vf, NULL, 0, callbacks);
+    if (ret != 0)
+    {
+        ALOGE("Open file error, file: %s, ov_open_callbacks return %d", _url.c_str(), ret);
+        return false;
+    }
+    _isStreamOpened = true;
+
+    auto vi = ov_info(&_vf, -1);
+    uint32_t pcmSamples = (uint32_t) ov_pcm_total(&_vf, -1);
+    if (vi->channels > 2 || pcmSamples == 0)
+    {
+        ALOGE("Couldn't stream (%s), channels: %d, frames: %u", _url.c_str(), vi->channels, pcmSamples);
+        return false;
+    }
+
+    _result.numChannels = vi->channels;
+    _result.sampleRate = vi->rate;
+    _result.bitsPerSample = SL_PCMSAMPLEFORMAT_FIXED_16;
+    _result.containerSize = SL_PCMSAMPLEFORMAT_FIXED_16;
+    _result.channelMask = vi->channels == 1 ? SL_SPEAKER_FRONT_CENTER : (SL_SPEAKER_FRONT_LEFT | SL_SPEAKER_FRONT_RIGHT);
+    _result.endianness = SL_BYTEORDER_LITTLEENDIAN;
+    _result.numFrames = pcmSamples;
+    _result.duration = 1.0f * pcmSamples / vi->rate;
+    return true;
+}
+
+int AudioDecoderOgg::readFrames(void* buffer, int numFrames)
+{
+    const int frameSize = _result.numChannels * sizeof(short);
+    const int totalBytes = numFrames * frameSize;
+    int currentSection = 0;
+    int curPos = 0;
+    while (curPos < totalBytes)
+    {
+        long readBytes = ov_read(&_vf, (char*)buffer + curPos, totalBytes - curPos, &currentSection);
+        if (readBytes <= 0)
+        {
+            ALOGV_IF(readBytes < 0, "ov_read returns %ld, url: %s", readBytes, _url.c_str());
+            break;
+        }
+        curPos += readBytes;
+    }
+    return curPos / frameSize;
+}
+
+bool AudioDecoderOgg::seekToFrame(int frame)
+{
+    int ret = ov_pcm_seek(&_vf, frame);
+    ALOGE_IF(ret != 0, "ov_pcm_seek (%s) to %d failed: %d", _url.c_str(), frame, ret);
+    return ret == 0;
+}
+
+} // namespace cc {
@@ -40,6 +40,13 @@ protected:
     static int fseek64Wrap(void* datasource, ogg_int64_t off, int whence);
     virtual bool decodeToPcm() override;
 
+    virtual bool openStream() override;
+    virtual int readFrames(void* buffer, int numFrames) override;
+    virtual bool seekToFrame(int frame) override;
+
+    OggVorbis_File _vf;
+    bool _isStreamOpened;
+
     friend class AudioDecoderProvider;
 };
 
@@ -30,17 +30,22 @@ THE SOFTWARE.
 #include "platform/FileUtils.h"
 
 #include <assert.h>
+#include <algorithm>
 
 namespace cc { 
 
 AudioDecoderWav::AudioDecoderWav()
+        : _streamHandle(nullptr), _streamFrame(0)
 {
     ALOGV("Create AudioDecoderWav");
 }
 
 AudioDecoderWav::~AudioDecoderWav()
 {
-
+    if (_streamHandle != nullptr)
+    {
+        sf_close(_streamHandle);
+    }
 }
 
 void* AudioDecoderWav::onWavOpen(const char* path, void* user)
@@ -60,26 +65,18 @@ int AudioDecoderWav::onWavClose(void* datasource)
 
 bool AudioDecoderWav::decodeToPcm()
 {
-    _fileData = FileUtils::getInstance()->getDataFromFile(_url);
+    _fileData = FileUtils::getInstance()->mapFile(_url);
     if (_fileData.isNull())
     {
         return false;
     }
 
     SF_INFO info;
-
-    snd_callbacks cb;
-    cb.open = onWavOpen;
-    cb.read = AudioDecoder::fileRead;
-    cb.seek = onWavSeek;
-    cb.close = onWavClose;
-    cb.tell = AudioDecoder::fileTell;
-
     SNDFILE* handle = NULL;
     bool ret = false;
     do
     {
-        handle = sf_open_read(_url.c_str(), &info, &cb, this);
+        handle = openFile(&info);
         if (handle == nullptr)
             break;
 
@@ -112,4 +109,90 @@ bool AudioDecoderWav::decodeToPcm()
     return ret;
 }
 
-} // namespace cc { 
\ No newline at end of file
+SNDFILE* AudioDecoderWav::openFile(SF_INFO* info)
+{
+    snd_callbacks cb;
+    cb.open = onWavOpen;
+    cb.read = AudioDecoder::fileRead;
+    cb.seek = onWavSeek;
+    cb.close = onWavClose;
+    cb.tell = AudioDecoder::fileTell;
+
+    _fileCurrPos = 0;
+    return sf_open_read(_url.c_str(), info, &cb, this);
+}
+
+bool AudioDecoderWav::openStream()
+{
+    _fileData = FileUtils::getInstance()->mapFile(_url);
+    if (_fileData.isNull())
+    {
+        return false;
+    }
+
+    SF_INFO info;
+    _streamHandle = openFile(&info);
+    if (_streamHandle == nullptr || info.frames == 0 || info.channels > 2)
+    {
+        ALOGE("Couldn't stream (%s)", _url.c_str());
+        return false;
+    }
+
+    _streamFrame = 0;
+    _result.numChannels = info.channels;
+    _result.sampleRate = info.samplerate;
+    _result.bitsPerSample = SL_PCMSAMPLEFORMAT_FIXED_16;
+    _result.containerSize = SL_PCMSAMPLEFORMAT_FIXED_16;
+    _result.channelMask = _result.numChannels == 1 ? SL_SPEAKER_FRONT_CENTER : (SL_SPEAKER_FRONT_LEFT | SL_SPEAKER_FRONT_RIGHT);
+    _result.endianness = SL_BYTEORDER_LITTLEENDIAN;
+    _result.numFrames = info.frames;
+    _result.duration = 1.0f * info.frames / _result.sampleRate;
+    return true;
+}
+
+int AudioDecoderWav::readFrames(void* buffer, int numFrames)
+{
+    if (_streamHandle == nullptr)
+    {
+        return 0;
+    }
+
+    sf_count_t frames = sf_readf_short(_streamHandle, (short*)buffer, numFrames);
+    if (frames < 0)
+    {
+        return 0;
+    }
+    _streamFrame += frames;
+    return frames;
+}
+
+// tinysndfile only reads forwards, a seek backwards opens the file again and the frames before
+// the target are read into a scratch buffer, which is a copy of the mapped file for pcm.
+bool AudioDecoderWav::seekToFrame(int frame)
+{
+    if (frame < _streamFrame)
+    {
+        sf_close(_streamHandle);
+        SF_INFO info;
+        _streamHandle = openFile(&info);
+        _streamFrame = 0;
+        if (_streamHandle == nullptr)
+        {
+            ALOGE("Reopen (%s) failed!", _url.c_str());
+            return false;
+        }
+    }
+
+    short scratch[1024];
+    const int scratchFrames = 1024 / _result.numChannels;
+    while (_streamFrame < frame)
+    {
+        if (readFrames(scratch, std::min(scratchFrames, frame - _streamFrame)) <= 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace cc {
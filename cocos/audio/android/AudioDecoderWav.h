@@ -26,6 +26,7 @@ THE SOFTWARE.
 #pragma once
 
 #include "audio/android/AudioDecoder.h"
+#include "audio/android/tinysndfile.h"
 
 namespace cc { 
 
@@ -37,10 +38,19 @@ protected:
 
     virtual bool decodeToPcm() override;
 
+    virtual bool openStream() override;
+    virtual int readFrames(void* buffer, int numFrames) override;
+    virtual bool seekToFrame(int frame) override;
+
+    SNDFILE* openFile(SF_INFO* info);
+
     static void* onWavOpen(const char* path, void* user);
     static int onWavSeek(void* datasource, long offset, int whence);
     static int onWavClose(void* datasource);
 
+    SNDFILE* _streamHandle;
+    int _streamFrame;
+
     friend class AudioDecoderProvider;
 };
 
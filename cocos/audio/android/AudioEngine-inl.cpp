@@ -49,6 +49,9 @@
 #include "audio/android/IAudioPlayer.h"
 #include "audio/android/ICallerThreadUtils.h"
 #include "audio/android/AudioPlayerProvider.h"
+#if CC_USE_BENCHMARK
+#include "audio/android/AudioMixerBenchmark.h"
+#endif
 #include "audio/android/cutils/log.h"
 #include "audio/android/UrlAudioPlayer.h"
 
@@ -128,7 +131,6 @@ AudioEngineImpl::AudioEngineImpl()
     , _engineEngine(nullptr)
     , _outputMixObject(nullptr)
     , _audioPlayerProvider(nullptr)
-    , _audioIDIndex(0)
     , _lazyInitLoop(true)
 {
     __callerThreadUtils.setCallerThreadId(std::this_thread::get_id());
@@ -199,9 +201,11 @@ void AudioEngineImpl::setAudioFocusForAllPlayers(bool isFocus)
     }
 }
 
-int AudioEngineImpl::play2d(const std::string &filePath ,bool loop ,float volume)
+int AudioEngineImpl::play2d(int audioID, const std::string &filePath ,bool loop ,float volume, unsigned int streamingThreshold)
 {
     ALOGV("play2d, _audioPlayers.size=%d", (int)_audioPlayers.size());
+    // the engine may have been created on a boot thread, the player callbacks belong to the thread playing
+    __callerThreadUtils.setCallerThreadId(std::this_thread::get_id());
     auto audioId = AudioEngine::INVALID_AUDIO_ID;
 
     do
@@ -211,9 +215,9 @@ int AudioEngineImpl::play2d(const std::string &filePath ,bool loop ,float volume
 
         auto fullPath = FileUtils::getInstance()->fullPathForFilename(filePath);
 
-        audioId = _audioIDIndex++;
+        audioId = audioID;
 
-        auto player = _audioPlayerProvider->getAudioPlayer(fullPath);
+        auto player = _audioPlayerProvider->getAudioPlayer(fullPath, streamingThreshold);
         if (player != nullptr)
         {
             player->setId(audioId);
@@ -231,7 +235,7 @@ int AudioEngineImpl::play2d(const std::string &filePath ,bool loop ,float volume
 
                 ALOGV("Removing player id=%d, state:%d", id, (int)state);
 
-                AudioEngine::remove(id);
+                AudioEngine::removeVoice(id);
                 if (_audioPlayers.find(id) != _audioPlayers.end())
                 {
                     _audioPlayers.erase(id);
@@ -262,7 +266,7 @@ int AudioEngineImpl::play2d(const std::string &filePath ,bool loop ,float volume
             return AudioEngine::INVALID_AUDIO_ID;
         }
 
-        AudioEngine::_audioIDInfoMap[audioId].state = AudioEngine::AudioState::PLAYING;
+        AudioEngine::setVoiceState(audioId, AudioEngine::AudioState::PLAYING);
 
     } while (0);
 
@@ -391,7 +395,7 @@ void AudioEngineImpl::setFinishCallback(int audioID, const std::function<void (i
     _callbackMap[audioID] = callback;
 }
 
-void AudioEngineImpl::preload(const std::string& filePath, const std::function<void(bool)>& callback)
+void AudioEngineImpl::preload(const std::string& filePath, const std::function<void(bool)>& callback, unsigned int streamingThreshold)
 {
     if (_audioPlayerProvider != nullptr)
     {
@@ -401,7 +405,7 @@ void AudioEngineImpl::preload(const std::string& filePath, const std::function<v
             {
                 callback(succeed);
             }
-        });
+        }, streamingThreshold);
     }
     else
     {
@@ -429,6 +433,51 @@ void AudioEngineImpl::uncacheAll()
     }
 }
 
+void AudioEngineImpl::setCacheBudget(unsigned int budgetInBytes)
+{
+    if (_audioPlayerProvider != nullptr)
+    {
+        _audioPlayerProvider->setPcmCacheBudget(budgetInBytes);
+    }
+}
+
+unsigned int AudioEngineImpl::getCacheSize()
+{
+    if (_audioPlayerProvider != nullptr)
+    {
+        return (unsigned int)_audioPlayerProvider->getPcmCacheSize();
+    }
+    return 0;
+}
+
+std::string AudioEngineImpl::getMixerStats(bool reset)
+{
+    if (_audioPlayerProvider != nullptr)
+    {
+        return _audioPlayerProvider->getMixerStats(reset);
+    }
+    return "";
+}
+
+#if CC_USE_BENCHMARK
+std::string AudioEngineImpl::runMixerBenchmark(bool isLoopbackEnabled)
+{
+    AudioMixerBenchmarkInfo info;
+    info.sampleRate = outputSampleRate;
+    info.bufferSizeInFrames = bufferSizeInFrames;
+    info.isLoopbackEnabled = isLoopbackEnabled;
+    return AudioMixerBenchmark::run(info);
+}
+#endif
+
+void AudioEngineImpl::setCacheCompressionEnabled(bool isEnabled)
+{
+    if (_audioPlayerProvider != nullptr)
+    {
+        _audioPlayerProvider->setPcmCacheCompressionEnabled(isEnabled);
+    }
+}
+
 void AudioEngineImpl::onPause()
 {
     if (_audioPlayerProvider != nullptr)
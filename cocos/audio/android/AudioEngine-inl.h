@@ -56,7 +56,8 @@ public:
     ~AudioEngineImpl();
 
     bool init();
-    int play2d(const std::string &fileFullPath ,bool loop ,float volume);
+    // audioID is chosen by AudioEngine, the voice is reported to AudioEngine by it
+    int play2d(int audioID, const std::string &fileFullPath ,bool loop ,float volume, unsigned int streamingThreshold);
     void setVolume(int audioID,float volume);
     void setLoop(int audioID, bool loop);
     void pause(int audioID);
@@ -71,7 +72,16 @@ public:
 
     void uncache(const std::string& filePath);
     void uncacheAll();
-    void preload(const std::string& filePath, const std::function<void(bool)>& callback);
+    void preload(const std::string& filePath, const std::function<void(bool)>& callback, unsigned int streamingThreshold);
+
+    void setCacheBudget(unsigned int budgetInBytes);
+    unsigned int getCacheSize();
+    void setCacheCompressionEnabled(bool isEnabled);
+
+    std::string getMixerStats(bool reset);
+#if CC_USE_BENCHMARK
+    std::string runMixerBenchmark(bool isLoopbackEnabled);
+#endif
 
     void onResume();
     void onPause();
@@ -94,8 +104,6 @@ private:
 
     AudioPlayerProvider* _audioPlayerProvider;
 
-    int _audioIDIndex;
-    
     bool _lazyInitLoop;
 };
 
@@ -30,6 +30,28 @@
 #include "audio/android/AudioMixerOps.h"
 #include "audio/android/AudioMixer.h"
 
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MIXER_USE_NEON 1
+#else
+#define MIXER_USE_NEON 0
+#endif
+
+#if !MIXER_USE_NEON && defined(__SSE2__)
+#include <emmintrin.h>
+#define MIXER_USE_SSE2 1
+#else
+#define MIXER_USE_SSE2 0
+#endif
+
+// the ramps need the 32 bit multiply of SSE4.1, x86_64 Android devices have it
+#if MIXER_USE_SSE2 && defined(__SSE4_1__)
+#include <smmintrin.h>
+#define MIXER_USE_SSE4_1 1
+#else
+#define MIXER_USE_SSE4_1 0
+#endif
+
 // The FCC_2 macro refers to the Fixed Channel Count of 2 for the legacy integer mixer.
 #ifndef FCC_2
 #define FCC_2 2
@@ -1108,6 +1130,246 @@ void AudioMixer::track__nop(track_t* t __unused, int32_t* out __unused,
 {
 }
 
+// ----------------------------------------------------------------------------
+
+// SIMD kernels of the legacy stereo mixer. Each one mixes whole groups of 4 frames, advances
+// the pointers past them and returns the frames left to the scalar loop of the caller.
+// The integer results are bit exact with the scalar code, including the wrap of the ramps.
+
+#if MIXER_USE_NEON
+
+static inline void mulAdd8(int32_t *out, int16x8_t in, int16x4_t vol)
+{
+    vst1q_s32(out, vmlal_s16(vld1q_s32(out), vget_low_s16(in), vol));
+    vst1q_s32(out + 4, vmlal_s16(vld1q_s32(out + 4), vget_high_s16(in), vol));
+}
+
+// in is 2 stereo frames, vol holds (vl, vr) of both frames in Q16.16
+static inline void rampMulAdd4(int32_t *out, int32x4_t in, int32x4_t &vol, int32x4_t inc)
+{
+    vst1q_s32(out, vmlaq_s32(vld1q_s32(out), vshrq_n_s32(vol, 16), in));
+    vol = vaddq_s32(vol, inc);
+}
+
+// Q4.27 to the int16_t the scalar code truncates to
+static inline int16x8_t narrowQ4_27(const int32_t *in)
+{
+    return vcombine_s16(vmovn_s32(vshrq_n_s32(vld1q_s32(in), 12)),
+            vmovn_s32(vshrq_n_s32(vld1q_s32(in + 4), 12)));
+}
+
+#elif MIXER_USE_SSE2
+
+static inline void mulAdd8(int32_t *out, __m128i in, __m128i vol)
+{
+    const __m128i lo = _mm_mullo_epi16(in, vol);
+    const __m128i hi = _mm_mulhi_epi16(in, vol);
+    __m128i *o = reinterpret_cast<__m128i *>(out);
+    _mm_storeu_si128(o, _mm_add_epi32(_mm_loadu_si128(o), _mm_unpacklo_epi16(lo, hi)));
+    _mm_storeu_si128(o + 1, _mm_add_epi32(_mm_loadu_si128(o + 1), _mm_unpackhi_epi16(lo, hi)));
+}
+
+static inline __m128i narrowQ4_27(const int32_t *in)
+{
+    const __m128i *i = reinterpret_cast<const __m128i *>(in);
+    // sign extend the low 16 bits so the saturating pack truncates like the scalar cast
+    const __m128i a = _mm_srai_epi32(_mm_slli_epi32(_mm_srai_epi32(_mm_loadu_si128(i), 12), 16), 16);
+    const __m128i b = _mm_srai_epi32(_mm_slli_epi32(_mm_srai_epi32(_mm_loadu_si128(i + 1), 12), 16), 16);
+    return _mm_packs_epi32(a, b);
+}
+
+#if MIXER_USE_SSE4_1
+static inline void rampMulAdd4(int32_t *out, __m128i in, __m128i &vol, __m128i inc)
+{
+    __m128i *o = reinterpret_cast<__m128i *>(out);
+    _mm_storeu_si128(o, _mm_add_epi32(_mm_loadu_si128(o), _mm_mullo_epi32(_mm_srai_epi32(vol, 16), in)));
+    vol = _mm_add_epi32(vol, inc);
+}
+#endif
+
+#endif
+
+// out += in * v, int16_t stereo in, Q4.12 gains
+static inline size_t mixStereo16(int32_t *&out, const int16_t *&in, size_t frameCount,
+        int16_t vl, int16_t vr)
+{
+#if MIXER_USE_NEON
+    const int16_t volumes[4] = {vl, vr, vl, vr};
+    const int16x4_t vol = vld1_s16(volumes);
+    for (; frameCount >= 4; frameCount -= 4, in += 8, out += 8) {
+        mulAdd8(out, vld1q_s16(in), vol);
+    }
+#elif MIXER_USE_SSE2
+    const __m128i vol = _mm_setr_epi16(vl, vr, vl, vr, vl, vr, vl, vr);
+    for (; frameCount >= 4; frameCount -= 4, in += 8, out += 8) {
+        mulAdd8(out, _mm_loadu_si128(reinterpret_cast<const __m128i *>(in)), vol);
+    }
+#endif
+    return frameCount;
+}
+
+// out += in * v, int16_t mono in expanded to stereo, Q4.12 gains
+static inline size_t mixMono16(int32_t *&out, const int16_t *&in, size_t frameCount,
+        int16_t vl, int16_t vr)
+{
+#if MIXER_USE_NEON
+    const int16_t volumes[4] = {vl, vr, vl, vr};
+    const int16x4_t vol = vld1_s16(volumes);
+    for (; frameCount >= 4; frameCount -= 4, in += 4, out += 8) {
+        const int16x4_t s = vld1_s16(in);
+        const int16x4x2_t lr = vzip_s16(s, s);
+        mulAdd8(out, vcombine_s16(lr.val[0], lr.val[1]), vol);
+    }
+#elif MIXER_USE_SSE2
+    const __m128i vol = _mm_setr_epi16(vl, vr, vl, vr, vl, vr, vl, vr);
+    for (; frameCount >= 4; frameCount -= 4, in += 4, out += 8) {
+        const __m128i s = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(in));
+        mulAdd8(out, _mm_unpacklo_epi16(s, s), vol);
+    }
+#endif
+    return frameCount;
+}
+
+// out += int16_t(temp >> 12) * v, Q4.27 stereo temp of the resampler, Q4.12 gains
+static inline size_t mixStereoQ4_27(int32_t *&out, const int32_t *&temp, size_t frameCount,
+        int16_t vl, int16_t vr)
+{
+#if MIXER_USE_NEON
+    const int16_t volumes[4] = {vl, vr, vl, vr};
+    const int16x4_t vol = vld1_s16(volumes);
+    for (; frameCount >= 4; frameCount -= 4, temp += 8, out += 8) {
+        mulAdd8(out, narrowQ4_27(temp), vol);
+    }
+#elif MIXER_USE_SSE2
+    const __m128i vol = _mm_setr_epi16(vl, vr, vl, vr, vl, vr, vl, vr);
+    for (; frameCount >= 4; frameCount -= 4, temp += 8, out += 8) {
+        mulAdd8(out, narrowQ4_27(temp), vol);
+    }
+#endif
+    return frameCount;
+}
+
+#if MIXER_USE_NEON || MIXER_USE_SSE4_1
+#if MIXER_USE_NEON
+typedef int32x4_t simd_s32_t;
+#else
+typedef __m128i simd_s32_t;
+#endif
+
+// 4 frames of the ramp input as int32_t, l r l r of frames 0, 1 and of frames 2, 3
+struct RampInput {
+    simd_s32_t frames01;
+    simd_s32_t frames23;
+};
+
+static inline RampInput loadStereo16(const int16_t *in)
+{
+    RampInput r;
+#if MIXER_USE_NEON
+    const int16x8_t s = vld1q_s16(in);
+    r.frames01 = vmovl_s16(vget_low_s16(s));
+    r.frames23 = vmovl_s16(vget_high_s16(s));
+#else
+    const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+    r.frames01 = _mm_cvtepi16_epi32(s);
+    r.frames23 = _mm_cvtepi16_epi32(_mm_srli_si128(s, 8));
+#endif
+    return r;
+}
+
+static inline RampInput loadMono16(const int16_t *in)
+{
+    RampInput r;
+#if MIXER_USE_NEON
+    const int16x4_t s = vld1_s16(in);
+    const int16x4x2_t lr = vzip_s16(s, s);
+    r.frames01 = vmovl_s16(lr.val[0]);
+    r.frames23 = vmovl_s16(lr.val[1]);
+#else
+    const __m128i s = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(in));
+    const __m128i lr = _mm_unpacklo_epi16(s, s);
+    r.frames01 = _mm_cvtepi16_epi32(lr);
+    r.frames23 = _mm_cvtepi16_epi32(_mm_srli_si128(lr, 8));
+#endif
+    return r;
+}
+
+static inline RampInput loadStereoQ4_27(const int32_t *in)
+{
+    RampInput r;
+#if MIXER_USE_NEON
+    r.frames01 = vshrq_n_s32(vld1q_s32(in), 12);
+    r.frames23 = vshrq_n_s32(vld1q_s32(in + 4), 12);
+#else
+    r.frames01 = _mm_srai_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in)), 12);
+    r.frames23 = _mm_srai_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 4)), 12);
+#endif
+    return r;
+}
+
+// out += (v >> 16) * in while the Q16.16 gains v ramp by inc per frame, in has IN_CHANNELS
+template <int IN_CHANNELS, typename TI, RampInput (*LOAD)(const TI *)>
+static inline size_t rampStereo(int32_t *&out, const TI *&in, size_t frameCount,
+        int32_t &vl, int32_t &vr, int32_t vlInc, int32_t vrInc)
+{
+    if (frameCount < 4) return frameCount;
+    const int32_t volumes[4] = {vl, vr, (int32_t)((uint32_t)vl + vlInc), (int32_t)((uint32_t)vr + vrInc)};
+    const int32_t vlInc2 = (int32_t)((uint32_t)vlInc * 2);
+    const int32_t vrInc2 = (int32_t)((uint32_t)vrInc * 2);
+    const int32_t incs[4] = {vlInc2, vrInc2, vlInc2, vrInc2};
+#if MIXER_USE_NEON
+    int32x4_t vol = vld1q_s32(volumes);
+    const int32x4_t inc = vld1q_s32(incs);
+#else
+    __m128i vol = _mm_loadu_si128(reinterpret_cast<const __m128i *>(volumes));
+    const __m128i inc = _mm_loadu_si128(reinterpret_cast<const __m128i *>(incs));
+#endif
+    for (; frameCount >= 4; frameCount -= 4, in += 4 * IN_CHANNELS, out += 8) {
+        const RampInput s = LOAD(in);
+        rampMulAdd4(out, s.frames01, vol, inc);
+        rampMulAdd4(out + 4, s.frames23, vol, inc);
+    }
+#if MIXER_USE_NEON
+    vl = vgetq_lane_s32(vol, 0);
+    vr = vgetq_lane_s32(vol, 1);
+#else
+    vl = _mm_cvtsi128_si32(vol);
+    vr = _mm_extract_epi32(vol, 1);
+#endif
+    return frameCount;
+}
+#endif
+
+static inline size_t rampStereo16(int32_t *&out, const int16_t *&in, size_t frameCount,
+        int32_t &vl, int32_t &vr, int32_t vlInc, int32_t vrInc)
+{
+#if MIXER_USE_NEON || MIXER_USE_SSE4_1
+    return rampStereo<2, int16_t, loadStereo16>(out, in, frameCount, vl, vr, vlInc, vrInc);
+#else
+    return frameCount;
+#endif
+}
+
+static inline size_t rampMono16(int32_t *&out, const int16_t *&in, size_t frameCount,
+        int32_t &vl, int32_t &vr, int32_t vlInc, int32_t vrInc)
+{
+#if MIXER_USE_NEON || MIXER_USE_SSE4_1
+    return rampStereo<1, int16_t, loadMono16>(out, in, frameCount, vl, vr, vlInc, vrInc);
+#else
+    return frameCount;
+#endif
+}
+
+static inline size_t rampStereoQ4_27(int32_t *&out, const int32_t *&temp, size_t frameCount,
+        int32_t &vl, int32_t &vr, int32_t vlInc, int32_t vrInc)
+{
+#if MIXER_USE_NEON || MIXER_USE_SSE4_1
+    return rampStereo<2, int32_t, loadStereoQ4_27>(out, temp, frameCount, vl, vr, vlInc, vrInc);
+#else
+    return frameCount;
+#endif
+}
+
 void AudioMixer::volumeRampStereo(track_t* t, int32_t* out, size_t frameCount, int32_t* temp,
         int32_t* aux)
 {
@@ -1139,12 +1401,14 @@ void AudioMixer::volumeRampStereo(track_t* t, int32_t* out, size_t frameCount, i
         } while (--frameCount);
         t->prevAuxLevel = va;
     } else {
-        do {
-            *out++ += (vl >> 16) * (*temp++ >> 12);
-            *out++ += (vr >> 16) * (*temp++ >> 12);
+        const int32_t *in = temp;
+        frameCount = rampStereoQ4_27(out, in, frameCount, vl, vr, vlInc, vrInc);
+        while (frameCount--) {
+            *out++ += (vl >> 16) * (*in++ >> 12);
+            *out++ += (vr >> 16) * (*in++ >> 12);
             vl += vlInc;
             vr += vrInc;
-        } while (--frameCount);
+        }
     }
     t->prevVolume[0] = vl;
     t->prevVolume[1] = vr;
@@ -1170,13 +1434,15 @@ void AudioMixer::volumeStereo(track_t* t, int32_t* out, size_t frameCount, int32
             aux++;
         } while (--frameCount);
     } else {
-        do {
-            int16_t l = (int16_t)(*temp++ >> 12);
-            int16_t r = (int16_t)(*temp++ >> 12);
+        const int32_t *in = temp;
+        frameCount = mixStereoQ4_27(out, in, frameCount, vl, vr);
+        while (frameCount--) {
+            int16_t l = (int16_t)(*in++ >> 12);
+            int16_t r = (int16_t)(*in++ >> 12);
             out[0] = mulAdd(l, vl, out[0]);
             out[1] = mulAdd(r, vr, out[1]);
             out += 2;
-        } while (--frameCount);
+        }
     }
 }
 
@@ -1245,12 +1511,13 @@ void AudioMixer::track__16BitsStereo(track_t* t, int32_t* out, size_t frameCount
             //        t, vlInc/65536.0f, vl/65536.0f, t->volume[0],
             //        (vl + vlInc*frameCount)/65536.0f, frameCount);
 
-            do {
+            frameCount = rampStereo16(out, in, frameCount, vl, vr, vlInc, vrInc);
+            while (frameCount--) {
                 *out++ += (vl >> 16) * (int32_t) *in++;
                 *out++ += (vr >> 16) * (int32_t) *in++;
                 vl += vlInc;
                 vr += vrInc;
-            } while (--frameCount);
+            }
 
             t->prevVolume[0] = vl;
             t->prevVolume[1] = vr;
@@ -1260,13 +1527,14 @@ void AudioMixer::track__16BitsStereo(track_t* t, int32_t* out, size_t frameCount
         // constant gain
         else {
             const uint32_t vrl = t->volumeRL;
-            do {
+            frameCount = mixStereo16(out, in, frameCount, t->volume[0], t->volume[1]);
+            while (frameCount--) {
                 uint32_t rl = *reinterpret_cast<const uint32_t *>(in);
                 in += 2;
                 out[0] = mulAddRL(1, rl, vrl, out[0]);
                 out[1] = mulAddRL(0, rl, vrl, out[1]);
                 out += 2;
-            } while (--frameCount);
+            }
         }
     }
     t->in = in;
@@ -1333,13 +1601,14 @@ void AudioMixer::track__16BitsMono(track_t* t, int32_t* out, size_t frameCount,
             //         t, vlInc/65536.0f, vl/65536.0f, t->volume[0],
             //         (vl + vlInc*frameCount)/65536.0f, frameCount);
 
-            do {
+            frameCount = rampMono16(out, in, frameCount, vl, vr, vlInc, vrInc);
+            while (frameCount--) {
                 int32_t l = *in++;
                 *out++ += (vl >> 16) * l;
                 *out++ += (vr >> 16) * l;
                 vl += vlInc;
                 vr += vrInc;
-            } while (--frameCount);
+            }
 
             t->prevVolume[0] = vl;
             t->prevVolume[1] = vr;
@@ -1349,12 +1618,13 @@ void AudioMixer::track__16BitsMono(track_t* t, int32_t* out, size_t frameCount,
         else {
             const int16_t vl = t->volume[0];
             const int16_t vr = t->volume[1];
-            do {
+            frameCount = mixMono16(out, in, frameCount, vl, vr);
+            while (frameCount--) {
                 int16_t l = *in++;
                 out[0] = mulAdd(l, vl, out[0]);
                 out[1] = mulAdd(l, vr, out[1]);
                 out += 2;
-            } while (--frameCount);
+            }
         }
     }
     t->in = in;
@@ -0,0 +1,159 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#define LOG_TAG "AudioMixerBenchmark"
+
+#include "audio/android/AudioMixerBenchmark.h"
+#include "audio/android/AAudioService.h"
+#include "audio/android/AudioMixerController.h"
+#include "audio/android/Track.h"
+#include "audio/android/cutils/log.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+namespace cc {
+
+namespace {
+
+// A second of a stereo 16 bit sine, a different tone per track so their sums don't cancel
+PcmData createTone(int sampleRate, int index)
+{
+    PcmData data;
+    data.numChannels = 2;
+    data.sampleRate = sampleRate;
+    data.bitsPerSample = 16;
+    data.containerSize = 16;
+    data.channelMask = 3;
+    data.endianness = 0;
+    data.numFrames = sampleRate;
+    data.duration = 1.0f;
+    data.pcmBuffer = std::make_shared<std::vector<char>>(sampleRate * 2 * sizeof(int16_t));
+
+    auto samples = reinterpret_cast<int16_t*>(data.pcmBuffer->data());
+    const float frequency = 220.0f + 55.0f * index;
+    for (int i = 0; i < sampleRate; ++i)
+    {
+        const auto sample = (int16_t) (8000.0f * sinf(2.0f * (float) M_PI * frequency * i / sampleRate));
+        samples[i * 2] = sample;
+        samples[i * 2 + 1] = sample;
+    }
+    return data;
+}
+
+void runCase(const AudioMixerBenchmarkInfo &info, bool isFloatOutput, int trackSampleRate, int trackCount, std::string &json)
+{
+    AudioMixerController controller(info.bufferSizeInFrames, info.sampleRate, 2, isFloatOutput);
+    if (!controller.init())
+    {
+        return;
+    }
+
+    // more tracks than AudioMixer::MAX_NUM_TRACKS are dropped by the controller
+    std::vector<std::unique_ptr<Track>> tracks;
+    for (int i = 0; i < trackCount; ++i)
+    {
+        tracks.emplace_back(new Track(createTone(trackSampleRate, i)));
+        Track* track = tracks.back().get();
+        track->onStateChanged = [](Track::State) {};
+        track->setLoop(true);
+        track->setVolume(0.5f);
+        track->setState(Track::State::PLAYING);
+        controller.addTrack(track);
+    }
+
+    const int warmup = std::max(info.buffers / 10, 1);
+    std::vector<double> samples;
+    samples.reserve(info.buffers);
+    for (int i = 0; i < warmup + info.buffers; ++i)
+    {
+        const auto begin = std::chrono::steady_clock::now();
+        controller.mixOneFrame();
+        const auto end = std::chrono::steady_clock::now();
+        if (i >= warmup)
+        {
+            samples.push_back(std::chrono::duration<double, std::micro>(end - begin).count());
+        }
+    }
+
+    const double budget = (double) info.bufferSizeInFrames * 1000000 / info.sampleRate;
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (const auto sample : samples)
+    {
+        sum += sample;
+    }
+    const auto count = samples.size();
+    const auto lateBuffers = samples.end() - std::upper_bound(samples.begin(), samples.end(), budget);
+
+    char buf[512];
+    snprintf(buf, sizeof(buf),
+             "%s{\"name\":\"%s.%dHz.%dtracks\",\"buffers\":%u,\"meanUs\":%.3f,\"medianUs\":%.3f,\"p95Us\":%.3f,"
+             "\"maxUs\":%.3f,\"lateBuffers\":%d,\"load\":%.4f}",
+             json.back() == '[' ? "" : ",", isFloatOutput ? "float" : "int16", trackSampleRate, trackCount,
+             (unsigned int) count, sum / count, samples[count / 2], samples[std::min(count - 1, count * 95 / 100)],
+             samples.back(), (int) lateBuffers, sum / count / budget);
+    json += buf;
+    ALOGI("%s", buf + (buf[0] == ',' ? 1 : 0));
+}
+
+} // namespace {
+
+std::string AudioMixerBenchmark::run(const AudioMixerBenchmarkInfo &info)
+{
+    char buf[256];
+    snprintf(buf, sizeof(buf), "{\"schema\":1,\"sampleRate\":%d,\"bufferSizeInFrames\":%d,\"budgetUs\":%.3f,",
+             info.sampleRate, info.bufferSizeInFrames, (double) info.bufferSizeInFrames * 1000000 / info.sampleRate);
+    std::string json = buf;
+
+    const float roundTrip = info.isLoopbackEnabled ? AAudioService::measureRoundTripLatency(info.sampleRate) : -1.0f;
+    if (roundTrip >= 0.0f)
+    {
+        snprintf(buf, sizeof(buf), "\"roundTripMs\":%.2f,", roundTrip);
+        json += buf;
+    }
+    else
+    {
+        json += "\"roundTripMs\":null,";
+    }
+
+    json += "\"results\":[";
+    for (const bool isFloatOutput : {false, true})
+    {
+        for (const int trackSampleRate : info.trackSampleRates)
+        {
+            for (const int trackCount : info.trackCounts)
+            {
+                runCase(info, isFloatOutput, trackSampleRate, trackCount, json);
+            }
+        }
+    }
+    json += "]}\n";
+    return json;
+}
+
+} // namespace cc
@@ -0,0 +1,53 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace cc {
+
+struct AudioMixerBenchmarkInfo
+{
+    int sampleRate = 48000; // of the output, the device's one to measure what it plays
+    int bufferSizeInFrames = 192;
+    std::vector<int> trackSampleRates = {22050, 44100, 48000}; // the ones unlike the output's are resampled
+    std::vector<int> trackCounts = {1, 8, 16, 32};
+    int buffers = 500; // mixed per case, after a warmup of a tenth of them
+    bool isLoopbackEnabled = false; // needs the RECORD_AUDIO permission, see AAudioService::measureRoundTripLatency
+};
+
+// Mixes looping synthetic tracks through AudioMixerController on the calling thread, for every track count,
+// track sample rate and both the int16 and float output, and times every buffer. A buffer which takes longer
+// to mix than it plays is counted late, the output would underrun on it unless it had others queued. The round
+// trip latency of the device is measured with a loopback when it is enabled and AAudio is available.
+// The results are one JSON document, the timings in microseconds per buffer.
+class AudioMixerBenchmark
+{
+public:
+    static std::string run(const AudioMixerBenchmarkInfo &info);
+};
+
+} // namespace cc
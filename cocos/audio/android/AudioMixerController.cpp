@@ -34,17 +34,24 @@ THE SOFTWARE.
 
 namespace cc { 
 
-AudioMixerController::AudioMixerController(int bufferSizeInFrames, int sampleRate, int channelCount)
+AudioMixerController::AudioMixerController(int bufferSizeInFrames, int sampleRate, int channelCount, bool isFloatOutput)
         : _bufferSizeInFrames(bufferSizeInFrames)
         , _sampleRate(sampleRate)
         , _channelCount(channelCount)
+        , _isFloatOutput(isFloatOutput)
         , _mixer(nullptr)
         , _isPaused(false)
         , _isMixingFrame(false)
+        , _bufferDurationUs((uint32_t) ((int64_t) bufferSizeInFrames * 1000000 / sampleRate))
+        , _statsBuffers(0)
+        , _statsLateBuffers(0)
+        , _statsMixTimeTotalUs(0)
+        , _statsMixTimeMaxUs(0)
+        , _statsMaxActiveTracks(0)
 {
     ALOGV("In the constructor of AudioMixerController!");
 
-    _mixingBuffer.size = (size_t) bufferSizeInFrames * 2 * channelCount;
+    _mixingBuffer.size = (size_t) bufferSizeInFrames * (isFloatOutput ? sizeof(float) : sizeof(int16_t)) * channelCount;
     // Don't use posix_memalign since it was added from API 16, it will crash on Android 2.3
     // Therefore, for a workaround, we uses memalign here.
     _mixingBuffer.buf = memalign(32, _mixingBuffer.size);
@@ -103,7 +110,8 @@ void AudioMixerController::initTrack(Track* track, std::vector<Track*>& tracksTo
         return;
 
     uint32_t channelMask = audio_channel_out_mask_from_count(2);
-    int32_t name = _mixer->getTrackName(channelMask, AUDIO_FORMAT_PCM_16_BIT,
+    uint32_t trackChannelMask = audio_channel_out_mask_from_count(track->getChannelCount());
+    int32_t name = _mixer->getTrackName(trackChannelMask, AUDIO_FORMAT_PCM_16_BIT,
                                         AUDIO_SESSION_OUTPUT_MIX);
     if (name < 0)
     {
@@ -120,7 +128,7 @@ void AudioMixerController::initTrack(Track* track, std::vector<Track*>& tracksTo
                 name,
                 AudioMixer::TRACK,
                 AudioMixer::MIXER_FORMAT,
-                (void *) (uintptr_t) AUDIO_FORMAT_PCM_16_BIT);
+                (void *) (uintptr_t) (_isFloatOutput ? AUDIO_FORMAT_PCM_FLOAT : AUDIO_FORMAT_PCM_16_BIT));
         _mixer->setParameter(
                 name,
                 AudioMixer::TRACK,
@@ -135,7 +143,17 @@ void AudioMixerController::initTrack(Track* track, std::vector<Track*>& tracksTo
                 name,
                 AudioMixer::TRACK,
                 AudioMixer::CHANNEL_MASK,
-                (void *) (uintptr_t) channelMask);
+                (void *) (uintptr_t) trackChannelMask);
+
+        // Cached pcm data is resampled when it's decoded, streamed one is resampled by the mixer
+        if (track->getSampleRate() != _sampleRate)
+        {
+            _mixer->setParameter(
+                    name,
+                    AudioMixer::RESAMPLE,
+                    AudioMixer::SAMPLE_RATE,
+                    (void *) (uintptr_t) track->getSampleRate());
+        }
 
         track->setName(name);
         _mixer->enable(name);
@@ -275,6 +293,7 @@ void AudioMixerController::mixOneFrame()
     }
 
     bool hasAvailableTracks = _activeTracks.size() - tracksToRemove.size() > 0;
+    const auto activeTracks = (uint32_t) (_activeTracks.size() - tracksToRemove.size());
 
     if (hasAvailableTracks)
     {
@@ -304,8 +323,23 @@ void AudioMixerController::mixOneFrame()
     _activeTracksMutex.unlock();
 
     auto mixEnd = clockNow();
-    float mixInterval = intervalInMS(mixStart, mixEnd);
-    ALOGV_IF(mixInterval > 1.0f, "Mix a frame waste: %fms", mixInterval);
+    const auto mixTimeUs = (uint32_t) std::chrono::duration_cast<std::chrono::microseconds>(mixEnd - mixStart).count();
+    ALOGV_IF(mixTimeUs > 1000, "Mix a frame waste: %fms", mixTimeUs / 1000.0f);
+
+    _statsBuffers.fetch_add(1, std::memory_order_relaxed);
+    _statsMixTimeTotalUs.fetch_add(mixTimeUs, std::memory_order_relaxed);
+    if (mixTimeUs > _bufferDurationUs)
+    {
+        _statsLateBuffers.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (mixTimeUs > _statsMixTimeMaxUs.load(std::memory_order_relaxed))
+    {
+        _statsMixTimeMaxUs.store(mixTimeUs, std::memory_order_relaxed);
+    }
+    if (activeTracks > _statsMaxActiveTracks.load(std::memory_order_relaxed))
+    {
+        _statsMaxActiveTracks.store(activeTracks, std::memory_order_relaxed);
+    }
 
     _isMixingFrame = false;
 }
@@ -329,6 +363,27 @@ void AudioMixerController::resume()
     _isPaused = false;
 }
 
+AudioMixerController::Stats AudioMixerController::getStats() const
+{
+    Stats stats;
+    stats.buffers = _statsBuffers.load(std::memory_order_relaxed);
+    stats.lateBuffers = _statsLateBuffers.load(std::memory_order_relaxed);
+    stats.mixTimeTotalUs = _statsMixTimeTotalUs.load(std::memory_order_relaxed);
+    stats.mixTimeMaxUs = _statsMixTimeMaxUs.load(std::memory_order_relaxed);
+    stats.maxActiveTracks = _statsMaxActiveTracks.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// A buffer being mixed meanwhile may be counted partly, which doesn't matter to the figures
+void AudioMixerController::resetStats()
+{
+    _statsBuffers = 0;
+    _statsLateBuffers = 0;
+    _statsMixTimeTotalUs = 0;
+    _statsMixTimeMaxUs = 0;
+    _statsMaxActiveTracks = 0;
+}
+
 bool AudioMixerController::hasPlayingTacks()
 {
     std::lock_guard<std::mutex> lk (_activeTracksMutex);
@@ -48,7 +48,18 @@ public:
         size_t size;
     };
 
-    AudioMixerController(int bufferSizeInFrames, int sampleRate, int channelCount);
+    // Counters of the buffers mixed since the last resetStats, kept by mixOneFrame
+    struct Stats
+    {
+        uint32_t buffers;
+        uint32_t lateBuffers; // took longer to mix than they play, the output underruns unless it has others queued
+        uint64_t mixTimeTotalUs;
+        uint32_t mixTimeMaxUs;
+        uint32_t maxActiveTracks;
+    };
+
+    // The mixing buffer holds int16_t samples, or float ones when isFloatOutput is true
+    AudioMixerController(int bufferSizeInFrames, int sampleRate, int channelCount, bool isFloatOutput = false);
 
     ~AudioMixerController();
 
@@ -64,6 +75,12 @@ public:
     void mixOneFrame();
 
     inline OutputBuffer* current() { return &_mixingBuffer; }
+    inline bool isFloatOutput() const { return _isFloatOutput; }
+    inline int getBufferSizeInFrames() const { return _bufferSizeInFrames; }
+    inline int getSampleRate() const { return _sampleRate; }
+
+    Stats getStats() const;
+    void resetStats();
 
 private:
     void destroy();
@@ -73,6 +90,7 @@ private:
     int _bufferSizeInFrames;
     int _sampleRate;
     int _channelCount;
+    bool _isFloatOutput;
 
     AudioMixer* _mixer;
 
@@ -83,6 +101,14 @@ private:
 
     std::atomic_bool _isPaused;
     std::atomic_bool _isMixingFrame;
+
+    // written by the mixing thread only, read by any
+    uint32_t _bufferDurationUs;
+    std::atomic<uint32_t> _statsBuffers;
+    std::atomic<uint32_t> _statsLateBuffers;
+    std::atomic<uint64_t> _statsMixTimeTotalUs;
+    std::atomic<uint32_t> _statsMixTimeMaxUs;
+    std::atomic<uint32_t> _statsMaxActiveTracks;
 };
 
 } // namespace cc { 
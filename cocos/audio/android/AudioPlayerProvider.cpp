@@ -32,9 +32,12 @@ THE SOFTWARE.
 #include "audio/android/AudioDecoder.h"
 #include "audio/android/AudioDecoderProvider.h"
 #include "audio/android/AudioMixerController.h"
+#include "audio/android/ImaAdpcm.h"
+#include "audio/android/AAudioService.h"
 #include "audio/android/PcmAudioService.h"
 #include "audio/android/ICallerThreadUtils.h"
 #include "audio/android/utils/Utils.h"
+#include "audio/include/AudioEngine.h"
 
 #include <sys/system_properties.h>
 #include <stdlib.h>
@@ -83,16 +86,46 @@ AudioPlayerProvider::AudioPlayerProvider(SLEngineItf engineItf, SLObjectItf outp
         : _engineItf(engineItf), _outputMixObject(outputMixObject),
           _deviceSampleRate(deviceSampleRate), _bufferSizeInFrames(bufferSizeInFrames),
           _fdGetterCallback(fdGetterCallback), _callerThreadUtils(callerThreadUtils),
-          _pcmAudioService(nullptr), _mixController(nullptr),
+          _pcmCacheSize(0), _pcmCacheBudget(0), _isPcmCacheCompressionEnabled(false),
+          _aaudioService(nullptr), _pcmAudioService(nullptr), _mixController(nullptr),
           _threadPool(ThreadPool::newCachedThreadPool(1, 8, 5, 2, 2))
 {
     ALOGI("deviceSampleRate: %d, bufferSizeInFrames: %d", _deviceSampleRate, _bufferSizeInFrames);
-    if (getSystemAPILevel() >= 17)
+    // AAudio has the low latency path of Android 8.0 and later, OpenSL ES is used when its stream can't be opened.
+    if (getSystemAPILevel() >= 26 && AAudioService::isSupported())
     {
-        _mixController = new (std::nothrow) AudioMixerController(_bufferSizeInFrames, _deviceSampleRate, 2);
+        _mixController = new (std::nothrow) AudioMixerController(_bufferSizeInFrames, _deviceSampleRate, 2, true);
         _mixController->init();
-        _pcmAudioService = new (std::nothrow) PcmAudioService(engineItf, outputMixObject);
-        _pcmAudioService->init(_mixController, 2, deviceSampleRate, bufferSizeInFrames * 2);
+        _aaudioService = new (std::nothrow) AAudioService();
+        if (!_aaudioService->init(_mixController, 2, deviceSampleRate))
+        {
+            ALOGW("AAudio stream isn't available, fall back to OpenSL ES");
+            SL_SAFE_DELETE(_aaudioService);
+            SL_SAFE_DELETE(_mixController);
+        }
+    }
+
+    if (_mixController == nullptr && getSystemAPILevel() >= 17)
+    {
+        // OpenSL ES queues float PCM from Android 5.0 on, the mixer then skips the clamp to int16
+        // and the sums of many tracks keep their headroom. If the device refuses it, int16 is used.
+        bool isFloatOutput = getSystemAPILevel() >= 21;
+        for (;;)
+        {
+            _mixController = new (std::nothrow) AudioMixerController(_bufferSizeInFrames, _deviceSampleRate, 2, isFloatOutput);
+            _mixController->init();
+            _pcmAudioService = new (std::nothrow) PcmAudioService(engineItf, outputMixObject);
+            const int bytesPerSample = isFloatOutput ? sizeof(float) : sizeof(int16_t);
+            if (_pcmAudioService->init(_mixController, 2, deviceSampleRate, bufferSizeInFrames * bytesPerSample) || !isFloatOutput)
+            {
+                break;
+            }
+
+            ALOGW("Float PCM output isn't supported, fall back to int16");
+            SL_SAFE_DELETE(_pcmAudioService);
+            SL_SAFE_DELETE(_mixController);
+            isFloatOutput = false;
+        }
     }
 
     ALOG_ASSERT(callerThreadUtils != nullptr, "Caller thread utils parameter should not be nullptr!");
@@ -103,12 +136,13 @@ AudioPlayerProvider::~AudioPlayerProvider()
     ALOGV("~AudioPlayerProvider()");
     UrlAudioPlayer::stopAll();
 
+    SL_SAFE_DELETE(_aaudioService);
     SL_SAFE_DELETE(_pcmAudioService);
     SL_SAFE_DELETE(_mixController);
     SL_SAFE_DELETE(_threadPool);
 }
 
-IAudioPlayer *AudioPlayerProvider::getAudioPlayer(const std::string &audioFilePath)
+IAudioPlayer *AudioPlayerProvider::getAudioPlayer(const std::string &audioFilePath, unsigned int streamingThreshold)
 {
     // Pcm data decoding by OpenSLES API only supports in API level 17 and later.
     if (getSystemAPILevel() < 17)
@@ -123,12 +157,12 @@ IAudioPlayer *AudioPlayerProvider::getAudioPlayer(const std::string &audioFilePa
     }
 
     IAudioPlayer *player = nullptr;
+    PcmData cachedData;
 
     _pcmCacheMutex.lock();
-    auto iter = _pcmCache.find(audioFilePath);
-    if (iter != _pcmCache.end())
+    if (findPcmCache(audioFilePath, &cachedData))
     {// Found pcm cache means it was used to be a PcmAudioService
-        PcmData pcmData = iter->second;
+        PcmData pcmData = cachedData;
         _pcmCacheMutex.unlock();
         player = obtainPcmAudioPlayer(audioFilePath, pcmData);
         ALOGV_IF(player == nullptr, "%s, %d: player is nullptr, path: %s", __FUNCTION__, __LINE__, audioFilePath.c_str());
@@ -136,13 +170,13 @@ IAudioPlayer *AudioPlayerProvider::getAudioPlayer(const std::string &audioFilePa
     else
     {
         _pcmCacheMutex.unlock();
-        // Check audio file size to determine to use a PcmAudioService or UrlAudioPlayer,
-        // generally PcmAudioService is used for playing short audio like game effects while
-        // playing background music uses UrlAudioPlayer
+        // Check audio file size to determine whether to decode it into the pcm cache or to stream it,
+        // generally short audio like game effects is cached while background music is streamed by
+        // a StreamTrack of the mixer, or an UrlAudioPlayer if the file can't be decoded by the mixer.
         AudioFileInfo info = getFileInfo(audioFilePath);
         if (info.isValid())
         {
-            if (isSmallFile(info))
+            if (isSmallFile(info, streamingThreshold))
             {
                 // Put an empty lambda to preloadEffect since we only want the future object to get PcmData
                 auto pcmData = std::make_shared<PcmData>();
@@ -162,7 +196,7 @@ IAudioPlayer *AudioPlayerProvider::getAudioPlayer(const std::string &audioFilePa
                     *isSucceed = succeed;
                     *isPreloadFinished = true;
                     ALOGV("FileInfo (%p), Set isSucceed flag: %d, path: %s", infoPtr, succeed, url.c_str());
-                }, true);
+                }, true, streamingThreshold);
 
                 if (!*isReturnFromCache && !*isPreloadFinished)
                 {
@@ -192,7 +226,11 @@ IAudioPlayer *AudioPlayerProvider::getAudioPlayer(const std::string &audioFilePa
             }
             else
             {
-                player = createUrlAudioPlayer(info);
+                player = createStreamAudioPlayer(info);
+                if (player == nullptr)
+                {
+                    player = createUrlAudioPlayer(info);
+                }
                 ALOGV_IF(player == nullptr, "%s, %d: player is nullptr, path: %s", __FUNCTION__, __LINE__, audioFilePath.c_str());
             }
         }
@@ -206,7 +244,7 @@ IAudioPlayer *AudioPlayerProvider::getAudioPlayer(const std::string &audioFilePa
     return player;
 }
 
-void AudioPlayerProvider::preloadEffect(const std::string &audioFilePath, const PreloadCallback& cb)
+void AudioPlayerProvider::preloadEffect(const std::string &audioFilePath, const PreloadCallback& cb, unsigned int streamingThreshold)
 {
     // Pcm data decoding by OpenSLES API only supports in API level 17 and later.
     if (getSystemAPILevel() < 17)
@@ -216,13 +254,13 @@ void AudioPlayerProvider::preloadEffect(const std::string &audioFilePath, const
         return;
     }
 
+    PcmData cachedData;
     _pcmCacheMutex.lock();
-    auto&& iter = _pcmCache.find(audioFilePath);
-    if (iter != _pcmCache.end())
+    if (findPcmCache(audioFilePath, &cachedData))
     {
         ALOGV("preload return from cache: (%s)", audioFilePath.c_str());
         _pcmCacheMutex.unlock();
-        cb(true, iter->second);
+        cb(true, cachedData);
         return;
     }
     _pcmCacheMutex.unlock();
@@ -234,11 +272,11 @@ void AudioPlayerProvider::preloadEffect(const std::string &audioFilePath, const
             cb(succeed, data);
         });
 
-    }, false);
+    }, false, streamingThreshold);
 }
 
 // Used internally
-void AudioPlayerProvider::preloadEffect(const AudioFileInfo &info, const PreloadCallback& cb, bool isPreloadInPlay2d)
+void AudioPlayerProvider::preloadEffect(const AudioFileInfo &info, const PreloadCallback& cb, bool isPreloadInPlay2d, unsigned int streamingThreshold)
 {
     PcmData pcmData;
 
@@ -248,18 +286,17 @@ void AudioPlayerProvider::preloadEffect(const AudioFileInfo &info, const Preload
         return;
     }
 
-    if (isSmallFile(info))
+    if (isSmallFile(info, streamingThreshold))
     {
         std::string audioFilePath = info.url;
 
         // 1. First time check, if it wasn't in the cache, goto 2 step
         _pcmCacheMutex.lock();
-        auto&& iter = _pcmCache.find(audioFilePath);
-        if (iter != _pcmCache.end())
+        if (findPcmCache(audioFilePath, &pcmData))
         {
             ALOGV("1. Return pcm data from cache, url: %s", info.url.c_str());
             _pcmCacheMutex.unlock();
-            cb(true, iter->second);
+            cb(true, pcmData);
             return;
         }
         _pcmCacheMutex.unlock();
@@ -283,12 +320,11 @@ void AudioPlayerProvider::preloadEffect(const AudioFileInfo &info, const Preload
             // 3. Check it in cache again. If it has been removed from map just now, the file is in
             // the cache absolutely.
             _pcmCacheMutex.lock();
-            auto&& iter = _pcmCache.find(audioFilePath);
-            if (iter != _pcmCache.end())
+            if (findPcmCache(audioFilePath, &pcmData))
             {
                 ALOGV("2. Return pcm data from cache, url: %s", info.url.c_str());
                 _pcmCacheMutex.unlock();
-                cb(true, iter->second);
+                cb(true, pcmData);
                 return;
             }
             _pcmCacheMutex.unlock();
@@ -310,7 +346,7 @@ void AudioPlayerProvider::preloadEffect(const AudioFileInfo &info, const Preload
             {
                 d = decoder->getResult();
                 std::lock_guard<std::mutex> lk(_pcmCacheMutex);
-                _pcmCache.insert(std::make_pair(audioFilePath, d));
+                addPcmCache(audioFilePath, d);
             }
             else
             {
@@ -405,11 +441,11 @@ AudioPlayerProvider::AudioFileInfo AudioPlayerProvider::getFileInfo(
     return info;
 }
 
-bool AudioPlayerProvider::isSmallFile(const AudioFileInfo &info)
+// The indicators are the compressed sizes of about AudioProfile::DEFAULT_STREAMING_THRESHOLD bytes of pcm data,
+// they are scaled by the streaming threshold of the profile.
+bool AudioPlayerProvider::isSmallFile(const AudioFileInfo &info, unsigned int streamingThreshold)
 {
-    //REFINE: If file size is smaller than 100k, we think it's a small file. This value should be set by developers.
     AudioFileInfo &audioFileInfo = const_cast<AudioFileInfo &>(info);
-    size_t judgeCount = sizeof(__audioFileIndicator) / sizeof(__audioFileIndicator[0]);
     size_t pos = audioFileInfo.url.rfind(".");
     std::string extension;
     if (pos != std::string::npos)
@@ -421,14 +457,9 @@ bool AudioPlayerProvider::isSmallFile(const AudioFileInfo &info)
                                  return judge.extension == extension;
                              });
 
-    if (iter != std::end(__audioFileIndicator))
-    {
-//        ALOGV("isSmallFile: found: %s: ", iter->extension.c_str());
-        return info.length < iter->smallSizeIndicator;
-    }
-
-//    ALOGV("isSmallFile: not found return default value");
-    return info.length < __audioFileIndicator[0].smallSizeIndicator;
+    int smallSizeIndicator = iter != std::end(__audioFileIndicator) ? iter->smallSizeIndicator : __audioFileIndicator[0].smallSizeIndicator;
+    double scale = (double) streamingThreshold / AudioProfile::DEFAULT_STREAMING_THRESHOLD;
+    return info.length < smallSizeIndicator * scale;
 }
 
 float AudioPlayerProvider::getDurationFromFile(const std::string &filePath)
@@ -436,7 +467,7 @@ float AudioPlayerProvider::getDurationFromFile(const std::string &filePath)
     std::lock_guard<std::mutex> lk(_pcmCacheMutex);
     auto iter = _pcmCache.find(filePath);
     if (iter != _pcmCache.end()){
-        return iter->second.duration;
+        return iter->second.pcmData.duration;
     }
     return 0;
 }
@@ -448,7 +479,7 @@ void AudioPlayerProvider::clearPcmCache(const std::string &audioFilePath)
     if (iter != _pcmCache.end())
     {
         ALOGV("clear pcm cache: (%s)", audioFilePath.c_str());
-        _pcmCache.erase(iter);
+        removePcmCache(iter);
     }
     else
     {
@@ -460,6 +491,117 @@ void AudioPlayerProvider::clearAllPcmCaches()
 {
     std::lock_guard<std::mutex> lk(_pcmCacheMutex);
     _pcmCache.clear();
+    _pcmCacheLru.clear();
+    _pcmCacheSize = 0;
+}
+
+void AudioPlayerProvider::setPcmCacheBudget(size_t budgetInBytes)
+{
+    std::lock_guard<std::mutex> lk(_pcmCacheMutex);
+    _pcmCacheBudget = budgetInBytes;
+    evictPcmCaches();
+}
+
+size_t AudioPlayerProvider::getPcmCacheSize()
+{
+    std::lock_guard<std::mutex> lk(_pcmCacheMutex);
+    return _pcmCacheSize;
+}
+
+void AudioPlayerProvider::setPcmCacheCompressionEnabled(bool isEnabled)
+{
+    std::lock_guard<std::mutex> lk(_pcmCacheMutex);
+    _isPcmCacheCompressionEnabled = isEnabled;
+}
+
+bool AudioPlayerProvider::findPcmCache(const std::string &audioFilePath, PcmData *pcmData)
+{
+    auto iter = _pcmCache.find(audioFilePath);
+    if (iter == _pcmCache.end())
+    {
+        return false;
+    }
+
+    PcmCacheItem &item = iter->second;
+    _pcmCacheLru.splice(_pcmCacheLru.begin(), _pcmCacheLru, item.lruIter);
+
+    *pcmData = item.pcmData;
+    if (!item.compressedData.empty())
+    {
+        // Players of the same audio share the decoded pcm while any of them is alive
+        auto buffer = item.decodedBuffer.lock();
+        if (buffer == nullptr)
+        {
+            size_t sampleCount = (size_t) item.pcmData.numFrames * item.pcmData.numChannels;
+            buffer = std::make_shared<std::vector<char>>(sampleCount * sizeof(int16_t));
+            ImaAdpcm::decode(item.compressedData.data(), sampleCount, item.pcmData.numChannels, (int16_t*) buffer->data());
+            item.decodedBuffer = buffer;
+        }
+        pcmData->pcmBuffer = buffer;
+    }
+    return true;
+}
+
+void AudioPlayerProvider::addPcmCache(const std::string &audioFilePath, const PcmData &pcmData)
+{
+    auto iter = _pcmCache.find(audioFilePath);
+    if (iter != _pcmCache.end())
+    {
+        removePcmCache(iter);
+    }
+
+    PcmCacheItem item;
+    item.pcmData = pcmData;
+    item.size = pcmData.pcmBuffer != nullptr ? pcmData.pcmBuffer->size() : 0;
+    if (_isPcmCacheCompressionEnabled && pcmData.bitsPerSample == 16 && item.size > 0)
+    {
+        size_t sampleCount = (size_t) pcmData.numFrames * pcmData.numChannels;
+        ImaAdpcm::encode((const int16_t*) pcmData.pcmBuffer->data(), std::min(sampleCount, item.size / sizeof(int16_t)),
+                         pcmData.numChannels, item.compressedData);
+        item.compressedData.resize(ImaAdpcm::getEncodedSize(sampleCount), 0);
+        item.decodedBuffer = pcmData.pcmBuffer;
+        item.pcmData.pcmBuffer = nullptr;
+        item.size = item.compressedData.size();
+        ALOGV("compress pcm cache (%s): %d -> %d bytes", audioFilePath.c_str(), (int) pcmData.pcmBuffer->size(), (int) item.size);
+    }
+
+    _pcmCacheLru.push_front(audioFilePath);
+    item.lruIter = _pcmCacheLru.begin();
+    _pcmCacheSize += item.size;
+    _pcmCache.insert(std::make_pair(audioFilePath, std::move(item)));
+
+    evictPcmCaches();
+}
+
+void AudioPlayerProvider::removePcmCache(std::unordered_map<std::string, PcmCacheItem>::iterator iter)
+{
+    _pcmCacheSize -= iter->second.size;
+    _pcmCacheLru.erase(iter->second.lruIter);
+    _pcmCache.erase(iter);
+}
+
+void AudioPlayerProvider::evictPcmCaches()
+{
+    if (_pcmCacheBudget == 0)
+    {
+        return;
+    }
+
+    // The players hold the pcm buffer in their tracks, so a shared buffer is being played
+    auto lruIter = _pcmCacheLru.end();
+    while (_pcmCacheSize > _pcmCacheBudget && lruIter != _pcmCacheLru.begin())
+    {
+        --lruIter;
+        auto iter = _pcmCache.find(*lruIter);
+        const PcmCacheItem &item = iter->second;
+        bool isInUse = item.compressedData.empty() ? item.pcmData.pcmBuffer.use_count() > 1 : !item.decodedBuffer.expired();
+        if (!isInUse)
+        {
+            ALOGV("evict pcm cache: (%s), %d bytes", lruIter->c_str(), (int) item.size);
+            ++lruIter;
+            removePcmCache(iter);
+        }
+    }
 }
 
 PcmAudioPlayer *AudioPlayerProvider::obtainPcmAudioPlayer(const std::string &url,
@@ -481,6 +623,33 @@ PcmAudioPlayer *AudioPlayerProvider::obtainPcmAudioPlayer(const std::string &url
     return pcmPlayer;
 }
 
+PcmAudioPlayer *AudioPlayerProvider::createStreamAudioPlayer(const AudioFileInfo &info)
+{
+    if (_mixController == nullptr)
+    {
+        return nullptr;
+    }
+
+    auto decoder = AudioDecoderProvider::createAudioDecoder(_engineItf, info.url, _bufferSizeInFrames, _deviceSampleRate, _fdGetterCallback);
+    if (decoder == nullptr || !decoder->openStream())
+    {
+        ALOGV("Couldn't stream (%s) by the mixer", info.url.c_str());
+        AudioDecoderProvider::destroyAudioDecoder(&decoder);
+        return nullptr;
+    }
+
+    PcmAudioPlayer *pcmPlayer = new(std::nothrow) PcmAudioPlayer(_mixController, _callerThreadUtils);
+    if (pcmPlayer != nullptr)
+    {
+        pcmPlayer->prepareStream(info.url, decoder);
+    }
+    else
+    {
+        AudioDecoderProvider::destroyAudioDecoder(&decoder);
+    }
+    return pcmPlayer;
+}
+
 UrlAudioPlayer *AudioPlayerProvider::createUrlAudioPlayer(
         const AudioPlayerProvider::AudioFileInfo &info)
 {
@@ -507,6 +676,11 @@ void AudioPlayerProvider::pause()
         _mixController->pause();
     }
 
+    if (_aaudioService != nullptr)
+    {
+        _aaudioService->pause();
+    }
+
     if (_pcmAudioService != nullptr)
     {
         _pcmAudioService->pause();
@@ -520,10 +694,43 @@ void AudioPlayerProvider::resume()
         _mixController->resume();
     }
 
+    if (_aaudioService != nullptr)
+    {
+        _aaudioService->resume();
+    }
+
     if (_pcmAudioService != nullptr)
     {
         _pcmAudioService->resume();
     }
 }
 
+std::string AudioPlayerProvider::getMixerStats(bool reset)
+{
+    if (_mixController == nullptr)
+    {
+        return "{\"backend\":\"none\"}";
+    }
+
+    const auto stats = _mixController->getStats();
+    if (reset)
+    {
+        _mixController->resetStats();
+    }
+
+    const int32_t xruns = _aaudioService != nullptr ? _aaudioService->getXRunCount() : -1;
+    const float outputLatency = _aaudioService != nullptr ? _aaudioService->getOutputLatency() : -1.0f;
+    char buf[512];
+    snprintf(buf, sizeof(buf),
+             "{\"backend\":\"%s\",\"sampleRate\":%d,\"bufferSizeInFrames\":%d,\"floatOutput\":%s,\"buffers\":%u,"
+             "\"lateBuffers\":%u,\"budgetUs\":%d,\"meanMixUs\":%.1f,\"maxMixUs\":%u,\"maxActiveTracks\":%u,"
+             "\"underruns\":%d,\"outputLatencyMs\":%.2f}",
+             _aaudioService != nullptr ? "aaudio" : "opensles", _deviceSampleRate, _bufferSizeInFrames,
+             _mixController->isFloatOutput() ? "true" : "false", stats.buffers, stats.lateBuffers,
+             (int) ((int64_t) _bufferSizeInFrames * 1000000 / _deviceSampleRate),
+             stats.buffers > 0 ? (double) stats.mixTimeTotalUs / stats.buffers : 0.0, stats.mixTimeMaxUs,
+             stats.maxActiveTracks, xruns, outputLatency);
+    return buf;
+}
+
 } // namespace cc { 
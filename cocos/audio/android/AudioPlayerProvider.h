@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "audio/android/OpenSLHelper.h"
 #include "audio/android/PcmData.h"
 
+#include <list>
 #include <unordered_map>
 #include <memory>
 #include <condition_variable>
@@ -37,6 +38,7 @@ namespace cc {
 // Manage PcmAudioPlayer& UrlAudioPlayer
 
 class PcmAudioPlayer;
+class AAudioService;
 class PcmAudioService;
 class UrlAudioPlayer;
 class AudioMixerController;
@@ -53,20 +55,33 @@ public:
 
     virtual ~AudioPlayerProvider();
 
-    IAudioPlayer *getAudioPlayer(const std::string &audioFilePath);
+    // Files decoding to more pcm bytes than streamingThreshold are streamed, see AudioProfile::streamingThreshold
+    IAudioPlayer *getAudioPlayer(const std::string &audioFilePath, unsigned int streamingThreshold);
 
     typedef std::function<void(bool/* succeed */, PcmData /* data */)> PreloadCallback;
-    void preloadEffect(const std::string &audioFilePath, const PreloadCallback& cb);
+    void preloadEffect(const std::string &audioFilePath, const PreloadCallback& cb, unsigned int streamingThreshold);
 
     float getDurationFromFile(const std::string &filePath);
     void clearPcmCache(const std::string &audioFilePath);
 
     void clearAllPcmCaches();
 
+    // The budget of the pcm cache in bytes, 0 means unlimited. While the cache is over the budget,
+    // the least recently used pcm data which isn't played is removed from it.
+    void setPcmCacheBudget(size_t budgetInBytes);
+    size_t getPcmCacheSize();
+
+    // Pcm data added to the cache afterwards is compressed into IMA ADPCM
+    void setPcmCacheCompressionEnabled(bool isEnabled);
+
     void pause();
 
     void resume();
 
+    // The counters of the mixer and the output as JSON, see AudioMixerController::Stats. Underruns are those AAudio
+    // reports and -1 with OpenSL ES, which doesn't, its late buffers are the ones to look at. reset starts the counters anew.
+    std::string getMixerStats(bool reset);
+
 private:
 
     struct AudioFileInfo
@@ -90,11 +105,28 @@ private:
 
     UrlAudioPlayer *createUrlAudioPlayer(const AudioFileInfo &info);
 
-    void preloadEffect(const AudioFileInfo &info, const PreloadCallback& cb, bool isPreloadInPlay2d);
+    PcmAudioPlayer *createStreamAudioPlayer(const AudioFileInfo &info);
+
+    void preloadEffect(const AudioFileInfo &info, const PreloadCallback& cb, bool isPreloadInPlay2d, unsigned int streamingThreshold);
 
     AudioFileInfo getFileInfo(const std::string &audioFilePath);
 
-    bool isSmallFile(const AudioFileInfo &info);
+    bool isSmallFile(const AudioFileInfo &info, unsigned int streamingThreshold);
+
+    struct PcmCacheItem
+    {
+        PcmData pcmData; // pcmBuffer is nullptr while the data is compressed
+        std::vector<uint8_t> compressedData;
+        std::weak_ptr<std::vector<char>> decodedBuffer; // shared by the players of the compressed data
+        std::list<std::string>::iterator lruIter;
+        size_t size;
+    };
+
+    // The pcm cache functions are called with _pcmCacheMutex locked
+    bool findPcmCache(const std::string &audioFilePath, PcmData *pcmData);
+    void addPcmCache(const std::string &audioFilePath, const PcmData &pcmData);
+    void removePcmCache(std::unordered_map<std::string, PcmCacheItem>::iterator iter);
+    void evictPcmCaches();
 
 private:
     SLEngineItf _engineItf;
@@ -104,7 +136,11 @@ private:
     FdGetterCallback _fdGetterCallback;
     ICallerThreadUtils* _callerThreadUtils;
 
-    std::unordered_map<std::string, PcmData> _pcmCache;
+    std::unordered_map<std::string, PcmCacheItem> _pcmCache;
+    std::list<std::string> _pcmCacheLru; // the most recently used one first
+    size_t _pcmCacheSize;
+    size_t _pcmCacheBudget;
+    bool _isPcmCacheCompressionEnabled;
     std::mutex _pcmCacheMutex;
 
     struct PreloadCallbackParam
@@ -119,6 +155,7 @@ private:
     std::mutex _preloadWaitMutex;
     std::condition_variable _preloadWaitCond;
 
+    AAudioService* _aaudioService;
     PcmAudioService* _pcmAudioService;
     AudioMixerController *_mixController;
 
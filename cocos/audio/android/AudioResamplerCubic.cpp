@@ -24,9 +24,30 @@
 #include "audio/android/AudioResampler.h"
 #include "audio/android/AudioResamplerCubic.h"
 
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define CUBIC_USE_NEON 1
+#else
+#define CUBIC_USE_NEON 0
+#endif
+
 namespace cc { 
 // ----------------------------------------------------------------------------
 
+#if CUBIC_USE_NEON
+static inline int32x2_t makePair(int32_t l, int32_t r) {
+    const int32_t v[2] = {l, r};
+    return vld1_s32(v);
+}
+
+static inline void storePair(int32x2_t v, int32_t* l, int32_t* r) {
+    int32_t lr[2];
+    vst1_s32(lr, v);
+    *l = lr[0];
+    *r = lr[1];
+}
+#endif
+
 void AudioResamplerCubic::init() {
     memset(&left, 0, sizeof(state));
     memset(&right, 0, sizeof(state));
@@ -74,6 +95,72 @@ size_t AudioResamplerCubic::resampleStereo16(int32_t* out, size_t outFrameCount,
     }
     int16_t *in = mBuffer.i16;
 
+#if CUBIC_USE_NEON
+    {
+        // interp() and advance() of the left and right channel in the 2 lanes of each vector,
+        // the integer results are the ones of the scalar code
+        int32x2_t a = makePair(left.a, right.a);
+        int32x2_t b = makePair(left.b, right.b);
+        int32x2_t c = makePair(left.c, right.c);
+        int32x2_t y0 = makePair(left.y0, right.y0);
+        int32x2_t y1 = makePair(left.y1, right.y1);
+        int32x2_t y2 = makePair(left.y2, right.y2);
+        int32x2_t y3 = makePair(left.y3, right.y3);
+        const int32x2_t vol = makePair(vl, vr);
+
+        while (outputIndex < outputSampleCount) {
+            const int32_t x = phaseFraction >> kPreInterpShift;
+            int32x2_t sample = vadd_s32(vshr_n_s32(vmul_n_s32(a, x), 14), b);
+            sample = vadd_s32(vshr_n_s32(vmul_n_s32(sample, x), 14), c);
+            sample = vadd_s32(vshr_n_s32(vmul_n_s32(sample, x), 14), y1);
+            vst1_s32(out + outputIndex, vmla_s32(vld1_s32(out + outputIndex), vol, sample));
+            outputIndex += 2;
+
+            // increment phase
+            phaseFraction += phaseIncrement;
+            uint32_t indexIncrement = (phaseFraction >> kNumPhaseBits);
+            phaseFraction &= kPhaseMask;
+
+            // time to fetch another sample
+            while (indexIncrement--) {
+
+                inputIndex++;
+                if (inputIndex == mBuffer.frameCount) {
+                    inputIndex = 0;
+                    provider->releaseBuffer(&mBuffer);
+                    mBuffer.frameCount = inFrameCount;
+                    provider->getNextBuffer(&mBuffer,
+                                            calculateOutputPTS(outputIndex / 2));
+                    if (mBuffer.raw == NULL) {
+                        goto save_neon_state;
+                    }
+                    in = mBuffer.i16;
+                }
+
+                // advance sample state
+                y0 = y1;
+                y1 = y2;
+                y2 = y3;
+                y3 = makePair(in[inputIndex*2], in[inputIndex*2+1]);
+                a = vshr_n_s32(vadd_s32(vsub_s32(vmul_n_s32(vsub_s32(y1, y2), 3), y0), y3), 1);
+                b = vsub_s32(vadd_s32(vshl_n_s32(y2, 1), y0),
+                        vshr_n_s32(vadd_s32(vmul_n_s32(y1, 5), y3), 1));
+                c = vshr_n_s32(vsub_s32(y2, y0), 1);
+            }
+        }
+
+save_neon_state:
+        storePair(a, &left.a, &right.a);
+        storePair(b, &left.b, &right.b);
+        storePair(c, &left.c, &right.c);
+        storePair(y0, &left.y0, &right.y0);
+        storePair(y1, &left.y1, &right.y1);
+        storePair(y2, &left.y2, &right.y2);
+        storePair(y3, &left.y3, &right.y3);
+        goto save_state;
+    }
+#endif
+
     while (outputIndex < outputSampleCount) {
         int32_t sample;
         int32_t x;
@@ -0,0 +1,134 @@
+/****************************************************************************
+Copyright (c) 2016 Chukong Technologies Inc.
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "audio/android/ImaAdpcm.h"
+
+#include <algorithm>
+
+namespace cc { 
+
+namespace {
+
+const int MAX_CHANNEL_COUNT = 8;
+
+const int16_t STEP_TABLE[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+const int8_t INDEX_TABLE[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+struct ChannelState
+{
+    int predictor = 0;
+    int index = 0;
+};
+
+// Updates the state by a nibble the way the decoder does, and returns the decoded sample
+inline int16_t expandNibble(ChannelState& state, uint8_t nibble)
+{
+    int step = STEP_TABLE[state.index];
+    int diff = step >> 3;
+    if (nibble & 4) diff += step;
+    if (nibble & 2) diff += step >> 1;
+    if (nibble & 1) diff += step >> 2;
+
+    state.predictor += (nibble & 8) ? -diff : diff;
+    state.predictor = std::min(32767, std::max(-32768, state.predictor));
+    state.index = std::min(88, std::max(0, state.index + INDEX_TABLE[nibble]));
+    return (int16_t) state.predictor;
+}
+
+inline uint8_t compressSample(ChannelState& state, int16_t sample)
+{
+    int step = STEP_TABLE[state.index];
+    int diff = sample - state.predictor;
+    uint8_t nibble = 0;
+    if (diff < 0)
+    {
+        nibble = 8;
+        diff = -diff;
+    }
+    if (diff >= step)
+    {
+        nibble |= 4;
+        diff -= step;
+    }
+    step >>= 1;
+    if (diff >= step)
+    {
+        nibble |= 2;
+        diff -= step;
+    }
+    step >>= 1;
+    if (diff >= step)
+    {
+        nibble |= 1;
+    }
+    expandNibble(state, nibble);
+    return nibble;
+}
+
+} // namespace {
+
+void ImaAdpcm::encode(const int16_t* samples, size_t sampleCount, int channelCount, std::vector<uint8_t>& out)
+{
+    ChannelState states[MAX_CHANNEL_COUNT];
+    channelCount = std::min(std::max(channelCount, 1), MAX_CHANNEL_COUNT);
+
+    out.assign(getEncodedSize(sampleCount), 0);
+    int channel = 0;
+    for (size_t i = 0; i < sampleCount; ++i)
+    {
+        uint8_t nibble = compressSample(states[channel], samples[i]);
+        out[i >> 1] |= (i & 1) ? (nibble << 4) : nibble;
+        if (++channel == channelCount)
+            channel = 0;
+    }
+}
+
+void ImaAdpcm::decode(const uint8_t* data, size_t sampleCount, int channelCount, int16_t* out)
+{
+    ChannelState states[MAX_CHANNEL_COUNT];
+    channelCount = std::min(std::max(channelCount, 1), MAX_CHANNEL_COUNT);
+
+    int channel = 0;
+    for (size_t i = 0; i < sampleCount; ++i)
+    {
+        uint8_t nibble = (i & 1) ? (data[i >> 1] >> 4) : (data[i >> 1] & 0x0f);
+        out[i] = expandNibble(states[channel], nibble);
+        if (++channel == channelCount)
+            channel = 0;
+    }
+}
+
+} // namespace cc { 
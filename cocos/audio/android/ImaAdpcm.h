@@ -0,0 +1,48 @@
+/****************************************************************************
+Copyright (c) 2016 Chukong Technologies Inc.
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+namespace cc { 
+
+// IMA ADPCM of interleaved 16 bit pcm samples, 4 bits per sample, two samples a byte in the order of the pcm.
+// Every channel has a predictor and a step index of its own, which start at 0 so the data has no header.
+// It keeps the pcm cache at a quarter of its size, the data is decoded when it is played.
+class ImaAdpcm
+{
+public:
+    static size_t getEncodedSize(size_t sampleCount) { return (sampleCount + 1) / 2; }
+
+    static void encode(const int16_t* samples, size_t sampleCount, int channelCount, std::vector<uint8_t>& out);
+
+    // 'out' has room for sampleCount samples
+    static void decode(const uint8_t* data, size_t sampleCount, int channelCount, int16_t* out);
+};
+
+} // namespace cc { 
@@ -29,6 +29,8 @@ THE SOFTWARE.
 #include "audio/android/PcmAudioPlayer.h"
 #include "audio/android/AudioMixerController.h"
 #include "audio/android/ICallerThreadUtils.h"
+#include "audio/android/AudioDecoder.h"
+#include "audio/android/StreamTrack.h"
 
 namespace cc { 
 
@@ -50,10 +52,20 @@ PcmAudioPlayer::~PcmAudioPlayer()
 
 bool PcmAudioPlayer::prepare(const std::string &url, const PcmData &decResult)
 {
-    _url = url;
     _decResult = decResult;
+    return prepareTrack(url, new (std::nothrow) Track(_decResult));
+}
 
-    _track = new (std::nothrow) Track(_decResult);
+bool PcmAudioPlayer::prepareStream(const std::string &url, AudioDecoder* decoder)
+{
+    _decResult = decoder->getResult();
+    return prepareTrack(url, new (std::nothrow) StreamTrack(decoder));
+}
+
+bool PcmAudioPlayer::prepareTrack(const std::string &url, Track* track)
+{
+    _url = url;
+    _track = track;
 
     std::thread::id callerThreadId = _callerThreadUtils->getCallerThreadId();
 
@@ -33,6 +33,7 @@ namespace cc {
 
 class ICallerThreadUtils;
 class AudioMixerController;
+class AudioDecoder;
 
 class PcmAudioPlayer : public IAudioPlayer
 {
@@ -40,6 +41,9 @@ public:
 
     bool prepare(const std::string &url, const PcmData &decResult);
 
+    // Plays a StreamTrack decoding while it plays, which takes the ownership of the decoder
+    bool prepareStream(const std::string &url, AudioDecoder* decoder);
+
     // Override Functions Begin
     virtual int getId() const override { return _id; };
 
@@ -83,6 +87,8 @@ private:
     PcmAudioPlayer(AudioMixerController * controller, ICallerThreadUtils* callerThreadUtils);
     virtual ~PcmAudioPlayer();
 
+    bool prepareTrack(const std::string &url, Track* track);
+
 private:
     int _id;
     std::string _url;
@@ -64,7 +64,7 @@ bool PcmAudioService::enqueue()
     {
         if (_controller->isPaused())
         {
-            SLresult r = (*_bufferQueueItf)->Enqueue(_bufferQueueItf, __silenceData.data(), __silenceData.size());
+            SLresult r = (*_bufferQueueItf)->Enqueue(_bufferQueueItf, __silenceData.data(), _numChannels * _bufferSizeInBytes);
             SL_RETURN_VAL_IF_FAILED(r, false, "enqueue silent data failed!");
         }
         else
@@ -79,7 +79,7 @@ bool PcmAudioService::enqueue()
     }
     else
     {
-        SLresult r = (*_bufferQueueItf)->Enqueue(_bufferQueueItf, __silenceData.data(), __silenceData.size());
+        SLresult r = (*_bufferQueueItf)->Enqueue(_bufferQueueItf, __silenceData.data(), _numChannels * _bufferSizeInBytes);
         SL_RETURN_VAL_IF_FAILED(r, false, "enqueue silent data failed!");
     }
 
@@ -117,11 +117,27 @@ bool PcmAudioService::init(AudioMixerController* controller, int numChannels, in
             SL_BYTEORDER_LITTLEENDIAN
     };
 
+    // the float samples of the mixer are queued as they are
+    SLAndroidDataFormat_PCM_EX formatPcmFloat = {
+            SL_ANDROID_DATAFORMAT_PCM_EX,
+            (SLuint32) numChannels,
+            (SLuint32) sampleRate * 1000,
+            SL_PCMSAMPLEFORMAT_FIXED_32,
+            SL_PCMSAMPLEFORMAT_FIXED_32,
+            channelMask,
+            SL_BYTEORDER_LITTLEENDIAN,
+            SL_ANDROID_PCM_REPRESENTATION_FLOAT
+    };
+
     SLDataLocator_AndroidSimpleBufferQueue locBufQueue = {
             SL_DATALOCATOR_ANDROIDSIMPLEBUFFERQUEUE,
             AUDIO_PLAYER_BUFFER_COUNT
     };
     SLDataSource source = {&locBufQueue, &formatPcm};
+    if (controller->isFloatOutput())
+    {
+        source.pFormat = &formatPcmFloat;
+    }
 
     SLDataLocator_OutputMix locOutmix = {
             SL_DATALOCATOR_OUTPUTMIX,
@@ -164,12 +180,12 @@ bool PcmAudioService::init(AudioMixerController* controller, int numChannels, in
                                              this);
     SL_RETURN_VAL_IF_FAILED(r, false, "_bufferQueueItf RegisterCallback failed");
 
-    if (__silenceData.empty())
+    if (__silenceData.size() < (size_t) (_numChannels * _bufferSizeInBytes))
     {
         __silenceData.resize(_numChannels * _bufferSizeInBytes, 0x00);
     }
 
-    r = (*_bufferQueueItf)->Enqueue(_bufferQueueItf, __silenceData.data(), __silenceData.size());
+    r = (*_bufferQueueItf)->Enqueue(_bufferQueueItf, __silenceData.data(), _numChannels * _bufferSizeInBytes);
     SL_RETURN_VAL_IF_FAILED(r, false, "_bufferQueueItf Enqueue failed");
 
     r = (*_playItf)->SetPlayState(_playItf, SL_PLAYSTATE_PLAYING);
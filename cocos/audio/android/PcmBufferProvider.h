@@ -39,7 +39,7 @@ public:
     bool init(const void *addr, size_t frames, size_t frameSize);
     virtual status_t getNextBuffer(Buffer *buffer, int64_t pts = kInvalidPTS) override ;
     virtual void releaseBuffer(Buffer *buffer) override ;
-    void reset();
+    virtual void reset();
 
 protected:
     const void *_addr;      // base address
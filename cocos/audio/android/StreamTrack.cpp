@@ -0,0 +1,240 @@
+/****************************************************************************
+Copyright (c) 2016 Chukong Technologies Inc.
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#define LOG_TAG "StreamTrack"
+
+#include "audio/android/cutils/log.h"
+#include "audio/android/StreamTrack.h"
+#include "audio/android/AudioDecoder.h"
+#include "audio/android/AudioDecoderProvider.h"
+
+#include <algorithm>
+
+namespace cc { 
+
+// A buffer holds 100ms of the source, the ring decodes 400ms ahead of the mixer
+#define STREAM_BUFFER_DURATION_IN_MS (100)
+
+const uint32_t StreamTrack::BUFFER_COUNT;
+
+StreamTrack::StreamTrack(AudioDecoder* decoder)
+        : Track(decoder->getResult())
+        , _decoder(decoder)
+        , _bufferSizeInFrames(0)
+        , _readCount(0)
+        , _writeCount(0)
+        , _readOffset(0)
+        , _generation(0)
+        , _seekFrame(0)
+        , _isEndOfStream(false)
+        , _positionFrame(0)
+        , _isDestroyed(false)
+{
+    _bufferSizeInFrames = std::max(1, getSampleRate() * STREAM_BUFFER_DURATION_IN_MS / 1000);
+    for (auto&& streamBuffer : _buffers)
+    {
+        streamBuffer.data.resize(_bufferSizeInFrames * _frameSize);
+        streamBuffer.numFrames = 0;
+        streamBuffer.startFrame = 0;
+        streamBuffer.generation = 0;
+    }
+
+    _decodeThread = std::thread(&StreamTrack::decodeThread, this);
+}
+
+StreamTrack::~StreamTrack()
+{
+    {
+        std::lock_guard<std::mutex> lk(_decodeMutex);
+        _isDestroyed = true;
+    }
+    _decodeCond.notify_one();
+    _decodeThread.join();
+
+    AudioDecoderProvider::destroyAudioDecoder(&_decoder);
+}
+
+void StreamTrack::decodeThread()
+{
+    uint32_t generation = _generation;
+    size_t nextFrame = 0;
+    bool isDecodeOver = false;
+
+    std::unique_lock<std::mutex> lk(_decodeMutex);
+    while (!_isDestroyed)
+    {
+        if (generation != _generation)
+        {
+            generation = _generation;
+            nextFrame = _seekFrame;
+            lk.unlock();
+            bool isSeekSucceed = _decoder->seekToFrame(nextFrame);
+            ALOGE_IF(!isSeekSucceed, "Seek to frame %d failed!", (int) nextFrame);
+            lk.lock();
+            isDecodeOver = !isSeekSucceed;
+            _isEndOfStream = isDecodeOver && generation == _generation;
+            continue;
+        }
+
+        if (isDecodeOver || _writeCount - _readCount >= BUFFER_COUNT)
+        {
+            _decodeCond.wait(lk);
+            continue;
+        }
+
+        // The slot isn't read by the mixer until _writeCount moves past it, decoding doesn't hold the lock
+        StreamBuffer& streamBuffer = _buffers[_writeCount % BUFFER_COUNT];
+        lk.unlock();
+        size_t frames = decode(streamBuffer);
+        if (frames == 0 && isLoop())
+        {
+            _decoder->seekToFrame(0);
+            nextFrame = 0;
+            frames = decode(streamBuffer);
+        }
+        lk.lock();
+
+        if (generation != _generation)
+        {
+            continue;
+        }
+
+        if (frames == 0)
+        {
+            isDecodeOver = true;
+            _isEndOfStream = true;
+            continue;
+        }
+
+        streamBuffer.numFrames = frames;
+        streamBuffer.startFrame = nextFrame;
+        streamBuffer.generation = generation;
+        nextFrame += frames;
+        ++_writeCount;
+    }
+}
+
+size_t StreamTrack::decode(StreamBuffer &streamBuffer)
+{
+    size_t frames = 0;
+    while (frames < _bufferSizeInFrames)
+    {
+        int readFrames = _decoder->readFrames(streamBuffer.data.data() + frames * _frameSize, _bufferSizeInFrames - frames);
+        if (readFrames <= 0)
+        {
+            break;
+        }
+        frames += readFrames;
+    }
+    return frames;
+}
+
+void StreamTrack::dropBuffer()
+{
+    _readOffset = 0;
+    {
+        std::lock_guard<std::mutex> lk(_decodeMutex);
+        ++_readCount;
+    }
+    _decodeCond.notify_one();
+}
+
+// Runs in the mixing thread. An underrun returns no frames, the mixer plays silence then.
+status_t StreamTrack::getNextBuffer(Buffer *buffer, int64_t pts/* = kInvalidPTS*/)
+{
+    (void) pts;
+    while (_readCount != _writeCount)
+    {
+        StreamBuffer& streamBuffer = _buffers[_readCount % BUFFER_COUNT];
+        if (streamBuffer.generation != _generation || _readOffset >= streamBuffer.numFrames)
+        {
+            dropBuffer();
+            continue;
+        }
+
+        buffer->frameCount = std::min(buffer->frameCount, streamBuffer.numFrames - _readOffset);
+        buffer->raw = streamBuffer.data.data() + _readOffset * _frameSize;
+        _unrel = buffer->frameCount;
+        return NO_ERROR;
+    }
+
+    ALOGV_IF(!_isEndOfStream, "StreamTrack (%p) underrun", this);
+    buffer->frameCount = 0;
+    buffer->raw = nullptr;
+    _unrel = 0;
+    return NOT_ENOUGH_DATA;
+}
+
+void StreamTrack::releaseBuffer(Buffer *buffer)
+{
+    if (_unrel > 0 && _readCount != _writeCount)
+    {
+        _readOffset += std::min(buffer->frameCount, _unrel);
+        _unrel = 0;
+
+        const StreamBuffer& streamBuffer = _buffers[_readCount % BUFFER_COUNT];
+        if (streamBuffer.generation == _generation)
+        {
+            _positionFrame = streamBuffer.startFrame + _readOffset;
+        }
+        if (_readOffset >= streamBuffer.numFrames)
+        {
+            dropBuffer();
+        }
+    }
+    buffer->frameCount = 0;
+    buffer->raw = nullptr;
+}
+
+void StreamTrack::reset()
+{
+    setPosition(0.0f);
+}
+
+bool StreamTrack::isPlayOver() const
+{
+    return getState() == State::PLAYING && _isEndOfStream && _readCount == _writeCount;
+}
+
+bool StreamTrack::setPosition(float pos)
+{
+    size_t frame = std::min((size_t) std::max(0, (int) (pos * getSampleRate())), _numFrames);
+    {
+        std::lock_guard<std::mutex> lk(_decodeMutex);
+        _seekFrame = frame;
+        _positionFrame = frame;
+        _isEndOfStream = false;
+        ++_generation;
+    }
+    _decodeCond.notify_one();
+    return true;
+}
+
+float StreamTrack::getPosition() const
+{
+    return 1.0f * _positionFrame / getSampleRate();
+}
+
+} // namespace cc { 
@@ -0,0 +1,89 @@
+/****************************************************************************
+Copyright (c) 2016 Chukong Technologies Inc.
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#pragma once
+
+#include "audio/android/Track.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+namespace cc { 
+
+class AudioDecoder;
+
+// A track of a file above the streaming threshold of its profile, which is decoded while it plays.
+// A thread of its own decodes the next buffers of a small ring while the mixer reads the others,
+// looping and seeking are done by that thread too, so the mixing thread never waits for the decoder.
+class StreamTrack : public Track
+{
+public:
+    // Takes the ownership of the decoder, whose stream must be opened
+    StreamTrack(AudioDecoder* decoder);
+    virtual ~StreamTrack();
+
+    virtual status_t getNextBuffer(Buffer *buffer, int64_t pts = kInvalidPTS) override;
+    virtual void releaseBuffer(Buffer *buffer) override;
+    virtual void reset() override;
+
+    virtual bool isPlayOver() const override;
+    virtual bool setPosition(float pos) override;
+    virtual float getPosition() const override;
+
+private:
+    struct StreamBuffer
+    {
+        std::vector<char> data;
+        size_t numFrames;
+        size_t startFrame; // frame of the source the buffer begins with
+        uint32_t generation; // of the seeks, buffers decoded before the last seek are dropped
+    };
+
+    void decodeThread();
+    size_t decode(StreamBuffer &streamBuffer);
+    void dropBuffer();
+
+    AudioDecoder* _decoder;
+    size_t _bufferSizeInFrames;
+
+    static const uint32_t BUFFER_COUNT = 4;
+    StreamBuffer _buffers[BUFFER_COUNT];
+    std::atomic<uint32_t> _readCount; // buffers given to the mixer or dropped
+    std::atomic<uint32_t> _writeCount; // buffers decoded
+    size_t _readOffset; // frames of the buffer being read already released
+
+    std::mutex _decodeMutex;
+    std::condition_variable _decodeCond;
+    std::thread _decodeThread;
+    std::atomic<uint32_t> _generation;
+    size_t _seekFrame;
+    std::atomic_bool _isEndOfStream;
+    std::atomic<size_t> _positionFrame;
+    bool _isDestroyed;
+};
+
+} // namespace cc { 
@@ -56,7 +56,7 @@ public:
 
     inline State getPrevState() const { return _prevState; };
 
-    inline bool isPlayOver() const { return _state == State::PLAYING && _nextFrame >= _numFrames;};
+    virtual bool isPlayOver() const { return _state == State::PLAYING && _nextFrame >= _numFrames;};
     inline void setName(int name) { _name = name; };
     inline int getName() const { return _name; };
 
@@ -65,8 +65,12 @@ public:
 
     void setAudioFocus(bool isFocus);
 
-    bool setPosition(float pos);
-    float getPosition() const;
+    virtual bool setPosition(float pos);
+    virtual float getPosition() const;
+
+    // The format of the pcm data given to the mixer, which resamples and upmixes it
+    inline int getChannelCount() const { return _pcmData.numChannels; };
+    inline int getSampleRate() const { return _pcmData.sampleRate; };
 
     virtual gain_minifloat_packed_t getVolumeLR() override ;
 
@@ -18,10 +18,38 @@
 #include "audio/android/audio_utils/include/audio_utils/primitives.h"
 #include "audio/android/audio_utils/private/private.h"
 
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define PRIMITIVES_USE_NEON 1
+#else
+#define PRIMITIVES_USE_NEON 0
+#endif
+
+#if !PRIMITIVES_USE_NEON && defined(__SSE2__)
+#include <emmintrin.h>
+#define PRIMITIVES_USE_SSE2 1
+#else
+#define PRIMITIVES_USE_SSE2 0
+#endif
+
 void ditherAndClamp(int32_t* out, const int32_t *sums, size_t c)
 {
-    size_t i;
-    for (i=0 ; i<c ; i++) {
+    size_t i = 0;
+    /* the saturating narrow is clamp16 of 4 frames, stored as the same l r pairs */
+#if PRIMITIVES_USE_NEON
+    for (; i + 4 <= c; i += 4, sums += 8, out += 4) {
+        const int16x4_t lo = vqmovn_s32(vshrq_n_s32(vld1q_s32(sums), 12));
+        const int16x4_t hi = vqmovn_s32(vshrq_n_s32(vld1q_s32(sums + 4), 12));
+        vst1q_s16((int16_t *)out, vcombine_s16(lo, hi));
+    }
+#elif PRIMITIVES_USE_SSE2
+    for (; i + 4 <= c; i += 4, sums += 8, out += 4) {
+        const __m128i lo = _mm_srai_epi32(_mm_loadu_si128((const __m128i *)sums), 12);
+        const __m128i hi = _mm_srai_epi32(_mm_loadu_si128((const __m128i *)(sums + 4)), 12);
+        _mm_storeu_si128((__m128i *)out, _mm_packs_epi32(lo, hi));
+    }
+#endif
+    for (; i<c ; i++) {
         int32_t l = *sums++;
         int32_t r = *sums++;
         int32_t nl = l >> 12;
@@ -71,6 +99,19 @@ void memcpy_to_i16_from_float(int16_t *dst, const float *src, size_t count)
 
 void memcpy_to_float_from_q4_27(float *dst, const int32_t *src, size_t count)
 {
+#if PRIMITIVES_USE_NEON || PRIMITIVES_USE_SSE2
+    /* int to float rounds like the scalar conversion, the power of two scale is exact */
+    const float scale = 1. / (float)(1UL << 27);
+#endif
+#if PRIMITIVES_USE_NEON
+    for (; count >= 4; count -= 4, src += 4, dst += 4) {
+        vst1q_f32(dst, vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(src)), scale));
+    }
+#elif PRIMITIVES_USE_SSE2
+    for (; count >= 4; count -= 4, src += 4, dst += 4) {
+        _mm_storeu_ps(dst, _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)src)), _mm_set1_ps(scale)));
+    }
+#endif
     while (count--) {
         *dst++ = float_from_q4_27(*src++);
     }
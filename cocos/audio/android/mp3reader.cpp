@@ -538,3 +538,125 @@ int decodeMP3(mp3_callbacks* cb, void* source, std::vector<char>& pcmBuffer, int
 
     return retVal;
 }
+
+Mp3Decoder::Mp3Decoder()
+    : mCallback(NULL), mSource(NULL), mConfig(NULL), mDecoderBuf(NULL), mInputBuf(NULL), mOutputBuf(NULL),
+      mOutputFrames(0), mOutputPos(0), mSampleRate(0), mNumChannels(0), mNumFrames(0), mSamplesPerFrame(0) {
+}
+
+Mp3Decoder::~Mp3Decoder() {
+    delete static_cast<tPVMP3DecoderExternal*>(mConfig);
+    free(mDecoderBuf);
+    free(mInputBuf);
+    free(mOutputBuf);
+}
+
+bool Mp3Decoder::init(mp3_callbacks *callback, void* source) {
+    mCallback = callback;
+    mSource = source;
+
+    tPVMP3DecoderExternal *config = new tPVMP3DecoderExternal();
+    config->equalizerType = flat;
+    config->crcEnabled = false;
+    mConfig = config;
+    mDecoderBuf = malloc(pvmp3_decoderMemRequirements());
+    mInputBuf = static_cast<uint8_t*>(malloc(kInputBufferSize));
+    mOutputBuf = static_cast<int16_t*>(malloc(kOutputBufferSize));
+
+    if (!mReader.init(callback, source)) {
+        ALOGE("mp3Reader.init: Encountered error reading\n");
+        return false;
+    }
+    mSampleRate = mReader.getSampleRate();
+    mNumChannels = mReader.getNumChannels();
+    // Layer III frames have 1152 samples for MPEG 1 and 576 for MPEG 2 and 2.5, which have the rates below 32kHz
+    mSamplesPerFrame = mSampleRate >= 32000 ? 1152 : 576;
+
+    uint32_t bytesRead;
+    mNumFrames = 0;
+    while (mReader.getFrame(mInputBuf, &bytesRead)) {
+        mNumFrames += mSamplesPerFrame;
+    }
+    return mNumFrames > 0 && restart();
+}
+
+bool Mp3Decoder::restart() {
+    mOutputFrames = 0;
+    mOutputPos = 0;
+    pvmp3_InitDecoder(static_cast<tPVMP3DecoderExternal*>(mConfig), mDecoderBuf);
+    return mReader.init(mCallback, mSource);
+}
+
+bool Mp3Decoder::decodeFrame() {
+    mOutputFrames = 0;
+    mOutputPos = 0;
+
+    uint32_t bytesRead;
+    if (!mReader.getFrame(mInputBuf, &bytesRead)) {
+        return false;
+    }
+
+    tPVMP3DecoderExternal *config = static_cast<tPVMP3DecoderExternal*>(mConfig);
+    config->inputBufferCurrentLength = bytesRead;
+    config->inputBufferMaxLength = 0;
+    config->inputBufferUsedLength = 0;
+    config->pInputBuffer = mInputBuf;
+    config->pOutputBuffer = mOutputBuf;
+    config->outputFrameSize = kOutputBufferSize / sizeof(int16_t);
+
+    ERROR_CODE decoderErr = pvmp3_framedecoder(config, mDecoderBuf);
+    if (decoderErr != NO_DECODING_ERROR) {
+        ALOGE("Decoder encountered error=%d", decoderErr);
+        return false;
+    }
+    mOutputFrames = config->outputFrameSize / mNumChannels;
+    return true;
+}
+
+int Mp3Decoder::read(int16_t *buffer, int numFrames) {
+    int readFrames = 0;
+    while (readFrames < numFrames) {
+        if (mOutputPos >= mOutputFrames && !decodeFrame()) {
+            break;
+        }
+        int frames = numFrames - readFrames;
+        if (frames > mOutputFrames - mOutputPos) {
+            frames = mOutputFrames - mOutputPos;
+        }
+        memcpy(buffer + readFrames * mNumChannels, mOutputBuf + mOutputPos * mNumChannels,
+               frames * mNumChannels * sizeof(int16_t));
+        mOutputPos += frames;
+        readFrames += frames;
+    }
+    return readFrames;
+}
+
+// The frames before the target are skipped without decoding but the last one, since the main data
+// of a frame may begin in the bit reservoir of the previous frames.
+bool Mp3Decoder::seek(int frame) {
+    if (!restart()) {
+        return false;
+    }
+
+    uint32_t bytesRead;
+    const int skipFrames = frame / mSamplesPerFrame;
+    for (int i = 0; i < skipFrames - 1; ++i) {
+        if (!mReader.getFrame(mInputBuf, &bytesRead)) {
+            return false;
+        }
+    }
+    if (skipFrames > 0) {
+        decodeFrame();
+        mOutputFrames = 0;
+        mOutputPos = 0;
+    }
+
+    const int offset = frame - skipFrames * mSamplesPerFrame;
+    if (offset > 0) {
+        if (!decodeFrame()) {
+            return false;
+        }
+        mOutputPos = offset < mOutputFrames ? offset : mOutputFrames;
+    }
+    return true;
+}
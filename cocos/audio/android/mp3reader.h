@@ -57,5 +57,37 @@ private:
 
 int decodeMP3(mp3_callbacks* cb, void* source, std::vector<char>& pcmBuffer, int* numChannels, int* sampleRate, int* numFrames);
 
+// Decodes the frames of an MP3 on demand for streaming, decodeMP3 decodes the whole source at once.
+class Mp3Decoder {
+public:
+    Mp3Decoder();
+    ~Mp3Decoder();
+    // Scans the frame headers of the source for its length, nothing is decoded
+    bool init(mp3_callbacks *callback, void* source);
+    // Reads interleaved pcm frames, returns how many, 0 at the end of the source
+    int read(int16_t *buffer, int numFrames);
+    bool seek(int frame);
+    uint32_t getSampleRate() const { return mSampleRate; }
+    uint32_t getNumChannels() const { return mNumChannels; }
+    int getNumFrames() const { return mNumFrames; }
+private:
+    bool restart();
+    bool decodeFrame();
+
+    mp3_callbacks *mCallback;
+    void *mSource;
+    Mp3Reader mReader;
+    void *mConfig;      // tPVMP3DecoderExternal
+    void *mDecoderBuf;
+    uint8_t *mInputBuf;
+    int16_t *mOutputBuf;
+    int mOutputFrames;  // pcm frames decoded into mOutputBuf
+    int mOutputPos;     // pcm frames of mOutputBuf already read
+    uint32_t mSampleRate;
+    uint32_t mNumChannels;
+    int mNumFrames;
+    int mSamplesPerFrame;
+};
+
 
 #endif /* MP3READER_H_ */
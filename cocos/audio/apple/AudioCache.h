@@ -75,18 +75,26 @@ protected:
     uint32_t _framesRead;
 
     /*Cache related stuff;
-     * Cache pcm data when sizeInBytes less than PCMDATA_CACHEMAXSIZE
+     * Cache pcm data when sizeInBytes isn't greater than _streamingThreshold
      */
     ALuint _alBufferId;
     char* _pcmData;
 
     /*Queue buffer related stuff
-     *  Streaming in openal when sizeInBytes greater then PCMDATA_CACHEMAXSIZE
+     *  Streaming in openal when sizeInBytes greater than _streamingThreshold
      */
     char* _queBuffers[QUEUEBUFFER_NUM];
     ALsizei _queBufferSize[QUEUEBUFFER_NUM];
     uint32_t _queBufferFrames;
 
+    // AudioProfile::streamingThreshold of the profile which loaded the cache
+    uint32_t _streamingThreshold;
+
+    // Bytes of _pcmData once it's ready, a streaming cache has none
+    uint32_t _pcmDataSize;
+    // AudioEngineImpl::_cacheUseIndex when the cache was last played or preloaded
+    uint32_t _lastUseIndex;
+
     std::mutex _playCallbackMutex;
     std::vector< std::function<void()> > _playCallbacks;
 
@@ -42,6 +42,8 @@
 #include "base/Scheduler.h"
 #include "base/Utils.h"
 
+#include <algorithm>
+
 using namespace cc;
 
 static ALCdevice* s_ALDevice = nullptr;
@@ -238,7 +240,8 @@ ALvoid AudioEngineImpl::myAlSourceNotificationCallback(ALuint sid, ALuint notifi
 
 AudioEngineImpl::AudioEngineImpl()
 : _lazyInitLoop(true)
-, _currentAudioID(0)
+, _cacheBudget(0)
+, _cacheUseIndex(0)
 {
     s_instance = this;
 }
@@ -365,7 +368,7 @@ bool AudioEngineImpl::init()
     return ret;
 }
 
-AudioCache* AudioEngineImpl::preload(const std::string& filePath, std::function<void(bool)> callback)
+AudioCache* AudioEngineImpl::preload(const std::string& filePath, std::function<void(bool)> callback, unsigned int streamingThreshold)
 {
     AudioCache* audioCache = nullptr;
 
@@ -373,6 +376,7 @@ AudioCache* AudioEngineImpl::preload(const std::string& filePath, std::function<
     if (it == _audioCaches.end()) {
         audioCache = &_audioCaches[filePath];
         audioCache->_fileFullPath = FileUtils::getInstance()->fullPathForFilename(filePath);
+        audioCache->_streamingThreshold = streamingThreshold;
         unsigned int cacheId = audioCache->_id;
         auto isCacheDestroyed = audioCache->_isDestroyed;
         AudioEngine::addTask([audioCache, cacheId, isCacheDestroyed](){
@@ -389,6 +393,9 @@ AudioCache* AudioEngineImpl::preload(const std::string& filePath, std::function<
         audioCache = &it->second;
     }
 
+    audioCache->_lastUseIndex = ++_cacheUseIndex;
+    _evictCaches(audioCache);
+
     if (audioCache && callback)
     {
         audioCache->addLoadCallback(callback);
@@ -396,7 +403,7 @@ AudioCache* AudioEngineImpl::preload(const std::string& filePath, std::function<
     return audioCache;
 }
 
-int AudioEngineImpl::play2d(const std::string &filePath ,bool loop ,float volume)
+int AudioEngineImpl::play2d(int audioID, const std::string &filePath ,bool loop ,float volume, unsigned int streamingThreshold)
 {
     if (s_ALDevice == nullptr) {
         return AudioEngine::INVALID_AUDIO_ID;
@@ -417,7 +424,7 @@ int AudioEngineImpl::play2d(const std::string &filePath ,bool loop ,float volume
     player->_loop = loop;
     player->_volume = volume;
 
-    auto audioCache = preload(filePath, nullptr);
+    auto audioCache = preload(filePath, nullptr, streamingThreshold);
     if (audioCache == nullptr) {
         delete player;
         return AudioEngine::INVALID_AUDIO_ID;
@@ -425,10 +432,10 @@ int AudioEngineImpl::play2d(const std::string &filePath ,bool loop ,float volume
 
     player->setCache(audioCache);
     _threadMutex.lock();
-    _audioPlayers[_currentAudioID] = player;
+    _audioPlayers[audioID] = player;
     _threadMutex.unlock();
 
-    audioCache->addPlayCallback(std::bind(&AudioEngineImpl::_play2d,this,audioCache,_currentAudioID));
+    audioCache->addPlayCallback(std::bind(&AudioEngineImpl::_play2d,this,audioCache,audioID));
 
     if (_lazyInitLoop) {
         _lazyInitLoop = false;
@@ -438,7 +445,7 @@ int AudioEngineImpl::play2d(const std::string &filePath ,bool loop ,float volume
         }
     }
 
-    return _currentAudioID++;
+    return audioID;
 }
 
 void AudioEngineImpl::_play2d(AudioCache *cache, int audioID)
@@ -452,9 +459,7 @@ void AudioEngineImpl::_play2d(AudioCache *cache, int audioID)
             if(auto sche = _scheduler.lock()){
                 sche->performFunctionInCocosThread([audioID](){
 
-                    if (AudioEngine::_audioIDInfoMap.find(audioID) != AudioEngine::_audioIDInfoMap.end()) {
-                        AudioEngine::_audioIDInfoMap[audioID].state = AudioEngine::AudioState::PLAYING;
-                    }
+                    AudioEngine::setVoiceState(audioID, AudioEngine::AudioState::PLAYING);
                 });
             }
         }
@@ -603,7 +608,7 @@ float AudioEngineImpl::getDurationFromFile(const std::string &filePath)
 {
     auto it = _audioCaches.find(filePath);
     if (it == _audioCaches.end()) {
-        this->preload(filePath, nullptr);
+        this->preload(filePath, nullptr, AudioProfile::DEFAULT_STREAMING_THRESHOLD);
         return AudioEngine::TIME_UNKNOWN;
     }
 
@@ -695,7 +700,7 @@ void AudioEngineImpl::update(float dt)
 
         if (player->_removeByAudioEngine)
         {
-            AudioEngine::remove(audioID);
+            AudioEngine::removeVoice(audioID);
             _threadMutex.lock();
             it = _audioPlayers.erase(it);
             _threadMutex.unlock();
@@ -706,11 +711,10 @@ void AudioEngineImpl::update(float dt)
 
             std::string filePath;
             if (player->_finishCallbak) {
-                auto& audioInfo = AudioEngine::_audioIDInfoMap[audioID];
-                filePath = *audioInfo.filePath;
+                filePath = player->_audioCache->_fileFullPath;
             }
 
-            AudioEngine::remove(audioID);
+            AudioEngine::removeVoice(audioID);
             _threadMutex.lock();
             it = _audioPlayers.erase(it);
             _threadMutex.unlock();
@@ -750,6 +754,61 @@ void AudioEngineImpl::uncacheAll()
     _audioCaches.clear();
 }
 
+void AudioEngineImpl::setCacheBudget(unsigned int budgetInBytes)
+{
+    _cacheBudget = budgetInBytes;
+    _evictCaches(nullptr);
+}
+
+unsigned int AudioEngineImpl::getCacheSize()
+{
+    unsigned int size = 0;
+    for (auto&& cache : _audioCaches)
+    {
+        size += cache.second._pcmDataSize;
+    }
+    return size;
+}
+
+// Uncaches the least recently used pcm data which is loaded and not referenced by any player
+void AudioEngineImpl::_evictCaches(const AudioCache *usingCache)
+{
+    if (_cacheBudget == 0)
+    {
+        return;
+    }
+
+    unsigned int size = getCacheSize();
+    while (size > _cacheBudget)
+    {
+        auto evictIt = _audioCaches.end();
+        for (auto it = _audioCaches.begin(); it != _audioCaches.end(); ++it)
+        {
+            AudioCache& cache = it->second;
+            if (&cache == usingCache || cache._pcmDataSize == 0 || !cache._isLoadingFinished)
+                continue;
+            if (evictIt != _audioCaches.end() && evictIt->second._lastUseIndex <= cache._lastUseIndex)
+                continue;
+
+            std::lock_guard<std::mutex> lk(_threadMutex);
+            bool isInUse = std::any_of(_audioPlayers.begin(), _audioPlayers.end(), [&cache](const std::pair<const int, AudioPlayer*>& player) {
+                return player.second->_audioCache == &cache;
+            });
+            if (!isInUse)
+            {
+                evictIt = it;
+            }
+        }
+
+        if (evictIt == _audioCaches.end())
+            break;
+
+        ALOGV("evict audio cache: %s, %u bytes", evictIt->first.c_str(), evictIt->second._pcmDataSize);
+        size -= evictIt->second._pcmDataSize;
+        _audioCaches.erase(evictIt);
+    }
+}
+
 bool AudioEngineImpl::_checkAudioIdValid(int audioID) {
     return _audioPlayers.find(audioID) != _audioPlayers.end();
 }
@@ -27,6 +27,7 @@
 
 
 #include "base/Macros.h"
+#include "base/MemoryPressure.h"
 #include "audio/include/Export.h"
 
 #include "bindings/event/EventDispatcher.h"
@@ -37,6 +38,7 @@
 #include <string>
 #include <unordered_map>
 #include <chrono>
+#include <vector>
 
 #ifdef ERROR
 #undef ERROR
@@ -64,6 +66,17 @@ public:
     
     /* Minimum delay in between sounds */
     double minDelay;
+
+    /* Audio decoding to more pcm bytes than the threshold is streamed from a few small buffers
+     * while it plays instead of being decoded into the cache. The profile which first plays or
+     * preloads a file decides it. */
+    unsigned int streamingThreshold;
+
+    /* When the real audio instances run out, audio of a higher priority keeps playing
+     * while the audio of a lower one becomes virtual, see AudioEngine::setMaxVirtualAudioInstance. */
+    int priority;
+
+    static const unsigned int DEFAULT_STREAMING_THRESHOLD;
     
     /**
      * Default constructor
@@ -73,6 +86,8 @@ public:
     AudioProfile()
     : maxInstances(0)
     , minDelay(0.0)
+    , streamingThreshold(DEFAULT_STREAMING_THRESHOLD)
+    , priority(0)
     {
         
     }
@@ -107,6 +122,12 @@ public:
 
     static bool lazyInit();
 
+    /**
+     * Creates the platform audio engine, the slow part of lazyInit(), on the calling thread.
+     * Boot tasks run it off the cocos thread, nothing else may use AudioEngine until it returned.
+     */
+    static bool initImpl();
+
     /**
      * Release objects relating to AudioEngine.
      *
@@ -257,6 +278,77 @@ public:
      * @param maxInstances The maximum number of simultaneous audio instance.
      */
     static bool setMaxAudioInstance(int maxInstances);
+
+    /**
+     * Gets the maximum number of virtual audio instance of AudioEngine.
+     */
+    static int getMaxVirtualAudioInstance() {return _maxVirtualInstances;}
+
+    /**
+     * Sets the maximum number of virtual audio instance for AudioEngine.
+     * Once the simultaneous audio instances are all playing, the least audible audio becomes virtual:
+     * it keeps its time, state and callbacks without being decoded or mixed, and plays again
+     * from its current time when an instance is free or it's more audible than a playing one.
+     * The audibility is the priority of the profile, then the volume, so games attenuating
+     * the audio by distance through the volume get the nearest audio played.
+     *
+     * @param maxInstances The maximum number of virtual audio instance, 0 makes the audio fail to play instead.
+     */
+    static void setMaxVirtualAudioInstance(int maxInstances);
+
+    /**
+     * Checks whether an audio instance is virtual.
+     *
+     * @param audioID An audioID returned by the play2d function.
+     */
+    static bool isVirtual(int audioID);
+
+    /**
+     * Sets the memory budget of the decoded audio data cached by AudioEngine.
+     * When the cache grows over the budget, the least recently used audio data which isn't playing is uncached.
+     *
+     * @param budgetInBytes The budget in bytes, 0 means unlimited, which is the default.
+     */
+    static void setCacheBudget(unsigned int budgetInBytes);
+
+    /**
+     * Gets the memory budget of the decoded audio data cached by AudioEngine.
+     */
+    static unsigned int getCacheBudget() {return _cacheBudget;}
+
+    /**
+     * Gets the bytes of the audio data cached by AudioEngine.
+     */
+    static unsigned int getCacheSize();
+
+    /**
+     * Whether to keep the cached audio data compressed as IMA ADPCM, a quarter of the pcm size,
+     * decoding it when the audio plays. The compression is lossy and only applies to android for now.
+     */
+    static void setCacheCompressionEnabled(bool isEnabled);
+
+    /**
+     * Check whether the cached audio data is compressed.
+     */
+    static bool isCacheCompressionEnabled() {return _isCacheCompressionEnabled;}
+
+    /**
+     * Gets the mixing times, late buffers, underruns and output latency of the android mixer as JSON.
+     * Returns an empty string on the other platforms, which don't mix in the engine.
+     *
+     * @param reset Whether the counters start anew afterwards.
+     */
+    static std::string getMixerStats(bool reset = false);
+
+#if CC_USE_BENCHMARK
+    /**
+     * Mixes synthetic tracks at the output format of the device and times every buffer, see AudioMixerBenchmark.
+     * It takes a few seconds on the calling thread. Android only, returns an empty string on the other platforms.
+     *
+     * @param isLoopbackEnabled Whether to measure the round trip latency too, which needs the RECORD_AUDIO permission.
+     */
+    static std::string runMixerBenchmark(bool isLoopbackEnabled);
+#endif
     
     /** 
      * Uncache the audio data from internal buffer.
@@ -303,6 +395,15 @@ public:
      */
     static void preload(const std::string& filePath, std::function<void(bool isSuccess)> callback);
 
+    /**
+     * Preload audio files, the files are decoded in parallel by the threads of the platform.
+     * @param filePaths The file paths of the audios.
+     * @param progressCallback A callback which will be called in Cocos thread once a file is loaded,
+     * with the count of the finished files, the count of all files, and the count of the failed ones.
+     */
+    static void preloadBatch(const std::vector<std::string>& filePaths,
+                             const std::function<void(unsigned int finishedCount, unsigned int totalCount, unsigned int failedCount)>& progressCallback);
+
     /**
      * Gets playing audio count.
      */
@@ -321,6 +422,10 @@ public:
 protected:
     static void addTask(const std::function<void()>& task);
     static void remove(int audioID);
+
+    // The platform implementations play voices, an audio instance has one while it isn't virtual
+    static void removeVoice(int voiceID);
+    static void setVoiceState(int voiceID, AudioState state);
     
     struct ProfileHelper
     {
@@ -346,6 +451,17 @@ protected:
         float duration;
         AudioState state;
 
+        // the id of the platform player, INVALID_AUDIO_ID while the audio is virtual
+        int voiceID;
+        // set by the platform once the voice plays
+        bool isVoiceStarted;
+        // a virtual audio which got a voice seeks it to the virtual time once it plays
+        bool isSeekPending;
+        // the time at virtualTimeStamp while the audio is virtual or seeking
+        float virtualTime;
+        std::chrono::high_resolution_clock::time_point virtualTimeStamp;
+        std::function<void(int, const std::string&)> finishCallback;
+
         AudioInfo();
         ~AudioInfo();
     private:
@@ -365,23 +481,43 @@ protected:
     static std::unordered_map<std::string, ProfileHelper> _audioPathProfileHelperMap;
     
     static unsigned int _maxInstances;
+
+    static unsigned int _maxVirtualInstances;
+
+    static unsigned int _cacheBudget;
+
+    static bool _isCacheCompressionEnabled;
     
     static ProfileHelper* _defaultProfileHelper;
     
     static AudioEngineImpl* _audioEngineImpl;
 
-    class AudioEngineThreadPool;
-    static AudioEngineThreadPool* s_threadPool;
-    
     static bool _isEnabled;
     
 private:
+    static bool playVoice(int audioID, AudioInfo& info);
+    static void virtualizeVoice(AudioInfo& info);
+    static bool isMoreAudible(const AudioInfo& info, const AudioInfo& other);
+    static float getVirtualTime(const AudioInfo& info);
+    static void setVirtualTime(AudioInfo& info, float time);
+    static void finishVirtual(int audioID);
+    static void scheduleVoiceUpdate();
+    static void updateVoices(float dt);
+
+    //voiceID,audioID
+    static std::unordered_map<int, int> _voiceIDMap;
+    static int _audioIDIndex;
+    static int _voiceIDIndex;
+    static bool _isVoiceUpdateScheduled;
+
     static uint32_t _onPauseListenerID;
     static uint32_t _onResumeListenerID;
+    static uint32_t _memoryPressureHandlerID;
     static std::vector<int> _breakAudioID;
     
     static void onEnterBackground(const CustomEvent&);
     static void onEnterForeground(const CustomEvent&);
+    static void onMemoryPressure(MemoryPressureLevel level);
     
     friend class AudioEngineImpl;
 };
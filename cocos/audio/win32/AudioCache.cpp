@@ -36,6 +36,7 @@
 
 #include "audio/win32/AudioDecoderManager.h"
 #include "audio/win32/AudioDecoder.h"
+#include "audio/include/AudioEngine.h"
 
 #define VERY_VERY_VERBOSE_LOGGING
 #ifdef VERY_VERY_VERBOSE_LOGGING
@@ -49,7 +50,6 @@ unsigned int __idIndex = 0;
 }
 
 #define INVALID_AL_BUFFER_ID 0xFFFFFFFF
-#define PCMDATA_CACHEMAXSIZE 1048576
 
 using namespace cc;
 
@@ -61,6 +61,9 @@ AudioCache::AudioCache()
 , _alBufferId(INVALID_AL_BUFFER_ID)
 , _pcmData(nullptr)
 , _queBufferFrames(0)
+, _streamingThreshold(AudioProfile::DEFAULT_STREAMING_THRESHOLD)
+, _pcmDataSize(0)
+, _lastUseIndex(0)
 , _state(State::INITIAL)
 , _isDestroyed(std::make_shared<bool>(false))
 , _id(++__idIndex)
@@ -151,7 +154,7 @@ void AudioCache::readDataTask(unsigned int selfId)
         _duration = 1.0f * totalFrames / sampleRate;
         _totalFrames = totalFrames;
 
-        if (dataSize <= PCMDATA_CACHEMAXSIZE)
+        if (dataSize <= _streamingThreshold)
         {
             uint32_t framesRead = 0;
             const uint32_t framesToReadOnce = std::min(totalFrames, static_cast<uint32_t>(sampleRate * QUEUEBUFFER_TIME_STEP * QUEUEBUFFER_NUM));
@@ -244,6 +247,7 @@ void AudioCache::readDataTask(unsigned int selfId)
 
             alBufferData(_alBufferId, _format, _pcmData, (ALsizei)dataSize, (ALsizei)sampleRate);
 
+            _pcmDataSize = dataSize;
             _state = State::READY;
         }
         else
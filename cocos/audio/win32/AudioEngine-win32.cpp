@@ -44,6 +44,7 @@
 #include "audio/win32/AudioDecoderManager.h"
 
 #include <windows.h>
+#include <algorithm>
 
 // log, CC_LOG_DEBUG aren't threadsafe, since we uses sub threads for parsing pcm data, threadsafe log output
 // is needed. Define the following macros (ALOGV, ALOGD, ALOGI, ALOGW, ALOGE) for threadsafe log output.
@@ -111,7 +112,8 @@ static ALCcontext *s_ALContext = nullptr;
 
 AudioEngineImpl::AudioEngineImpl()
 : _lazyInitLoop(true)
-, _currentAudioID(0)
+, _cacheBudget(0)
+, _cacheUseIndex(0)
 {
 
 }
@@ -173,7 +175,7 @@ bool AudioEngineImpl::init()
     return ret;
 }
 
-AudioCache* AudioEngineImpl::preload(const std::string& filePath, std::function<void(bool)> callback)
+AudioCache* AudioEngineImpl::preload(const std::string& filePath, std::function<void(bool)> callback, unsigned int streamingThreshold)
 {
     AudioCache* audioCache = nullptr;
 
@@ -181,6 +183,7 @@ AudioCache* AudioEngineImpl::preload(const std::string& filePath, std::function<
     if (it == _audioCaches.end()) {
         audioCache = &_audioCaches[filePath];
         audioCache->_fileFullPath = FileUtils::getInstance()->fullPathForFilename(filePath);
+        audioCache->_streamingThreshold = streamingThreshold;
         unsigned int cacheId = audioCache->_id;
         auto isCacheDestroyed = audioCache->_isDestroyed;
         AudioEngine::addTask([audioCache, cacheId, isCacheDestroyed](){
@@ -197,6 +200,9 @@ AudioCache* AudioEngineImpl::preload(const std::string& filePath, std::function<
         audioCache = &it->second;
     }
 
+    audioCache->_lastUseIndex = ++_cacheUseIndex;
+    _evictCaches(audioCache);
+
     if (audioCache && callback)
     {
         audioCache->addLoadCallback(callback);
@@ -204,7 +210,7 @@ AudioCache* AudioEngineImpl::preload(const std::string& filePath, std::function<
     return audioCache;
 }
 
-int AudioEngineImpl::play2d(const std::string &filePath ,bool loop ,float volume)
+int AudioEngineImpl::play2d(int audioID, const std::string &filePath ,bool loop ,float volume, unsigned int streamingThreshold)
 {
     if (s_ALDevice == nullptr) {
         return AudioEngine::INVALID_AUDIO_ID;
@@ -233,7 +239,7 @@ int AudioEngineImpl::play2d(const std::string &filePath ,bool loop ,float volume
     player->_loop = loop;
     player->_volume = volume;
 
-    auto audioCache = preload(filePath, nullptr);
+    auto audioCache = preload(filePath, nullptr, streamingThreshold);
     if (audioCache == nullptr) {
         delete player;
         return AudioEngine::INVALID_AUDIO_ID;
@@ -241,12 +247,12 @@ int AudioEngineImpl::play2d(const std::string &filePath ,bool loop ,float volume
 
     player->setCache(audioCache);
     _threadMutex.lock();
-    _audioPlayers[_currentAudioID] = player;
+    _audioPlayers[audioID] = player;
     _threadMutex.unlock();
 
     _alSourceUsed[alSource] = true;
 
-    audioCache->addPlayCallback(std::bind(&AudioEngineImpl::_play2d,this,audioCache,_currentAudioID));
+    audioCache->addPlayCallback(std::bind(&AudioEngineImpl::_play2d,this,audioCache,audioID));
 
     if (_lazyInitLoop) {
         _lazyInitLoop = false;
@@ -256,7 +262,7 @@ int AudioEngineImpl::play2d(const std::string &filePath ,bool loop ,float volume
         }
     }
 
-    return _currentAudioID++;
+    return audioID;
 }
 
 void AudioEngineImpl::_play2d(AudioCache *cache, int audioID)
@@ -271,9 +277,7 @@ void AudioEngineImpl::_play2d(AudioCache *cache, int audioID)
             {
                 sche->performFunctionInCocosThread([audioID]() {
 
-                    if (AudioEngine::_audioIDInfoMap.find(audioID) != AudioEngine::_audioIDInfoMap.end()) {
-                        AudioEngine::_audioIDInfoMap[audioID].state = AudioEngine::AudioState::PLAYING;
-                    }
+                    AudioEngine::setVoiceState(audioID, AudioEngine::AudioState::PLAYING);
                 });
             }
         }
@@ -419,7 +423,7 @@ float AudioEngineImpl::getDurationFromFile(const std::string &filePath)
 {
     auto it = _audioCaches.find(filePath);
     if (it == _audioCaches.end()) {
-        this->preload(filePath, nullptr);
+        this->preload(filePath, nullptr, AudioProfile::DEFAULT_STREAMING_THRESHOLD);
         return AudioEngine::TIME_UNKNOWN;
     }
 
@@ -511,7 +515,7 @@ void AudioEngineImpl::update(float dt)
 
         if (player->_removeByAudioEngine)
         {
-            AudioEngine::remove(audioID);
+            AudioEngine::removeVoice(audioID);
             _threadMutex.lock();
             it = _audioPlayers.erase(it);
             _threadMutex.unlock();
@@ -522,11 +526,10 @@ void AudioEngineImpl::update(float dt)
 
             std::string filePath;
             if (player->_finishCallbak) {
-                auto& audioInfo = AudioEngine::_audioIDInfoMap[audioID];
-                filePath = *audioInfo.filePath;
+                filePath = player->_audioCache->_fileFullPath;
             }
 
-            AudioEngine::remove(audioID);
+            AudioEngine::removeVoice(audioID);
             
             _threadMutex.lock();
             it = _audioPlayers.erase(it);
@@ -562,6 +565,61 @@ void AudioEngineImpl::uncacheAll()
     _audioCaches.clear();
 }
 
+void AudioEngineImpl::setCacheBudget(unsigned int budgetInBytes)
+{
+    _cacheBudget = budgetInBytes;
+    _evictCaches(nullptr);
+}
+
+unsigned int AudioEngineImpl::getCacheSize()
+{
+    unsigned int size = 0;
+    for (auto&& cache : _audioCaches)
+    {
+        size += cache.second._pcmDataSize;
+    }
+    return size;
+}
+
+// Uncaches the least recently used pcm data which is loaded and not referenced by any player
+void AudioEngineImpl::_evictCaches(const AudioCache *usingCache)
+{
+    if (_cacheBudget == 0)
+    {
+        return;
+    }
+
+    unsigned int size = getCacheSize();
+    while (size > _cacheBudget)
+    {
+        auto evictIt = _audioCaches.end();
+        for (auto it = _audioCaches.begin(); it != _audioCaches.end(); ++it)
+        {
+            AudioCache& cache = it->second;
+            if (&cache == usingCache || cache._pcmDataSize == 0 || !cache._isLoadingFinished)
+                continue;
+            if (evictIt != _audioCaches.end() && evictIt->second._lastUseIndex <= cache._lastUseIndex)
+                continue;
+
+            std::lock_guard<std::mutex> lk(_threadMutex);
+            bool isInUse = std::any_of(_audioPlayers.begin(), _audioPlayers.end(), [&cache](const std::pair<const int, AudioPlayer*>& player) {
+                return player.second->_audioCache == &cache;
+            });
+            if (!isInUse)
+            {
+                evictIt = it;
+            }
+        }
+
+        if (evictIt == _audioCaches.end())
+            break;
+
+        ALOGV("evict audio cache: %s, %u bytes", evictIt->first.c_str(), evictIt->second._pcmDataSize);
+        size -= evictIt->second._pcmDataSize;
+        _audioCaches.erase(evictIt);
+    }
+}
+
 bool AudioEngineImpl::_checkAudioIdValid(int audioID) {
     return _audioPlayers.find(audioID) != _audioPlayers.end();
 }
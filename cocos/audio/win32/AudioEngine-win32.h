@@ -48,7 +48,8 @@ public:
     ~AudioEngineImpl();
 
     bool init();
-    int play2d(const std::string &fileFullPath ,bool loop ,float volume);
+    // audioID is chosen by AudioEngine, the voice is reported to AudioEngine by it
+    int play2d(int audioID, const std::string &fileFullPath ,bool loop ,float volume, unsigned int streamingThreshold);
     void setVolume(int audioID,float volume);
     void setLoop(int audioID, bool loop);
     bool pause(int audioID);
@@ -63,12 +64,18 @@ public:
 
     void uncache(const std::string& filePath);
     void uncacheAll();
-    AudioCache* preload(const std::string& filePath, std::function<void(bool)> callback);
+    AudioCache* preload(const std::string& filePath, std::function<void(bool)> callback, unsigned int streamingThreshold);
+
+    void setCacheBudget(unsigned int budgetInBytes);
+    unsigned int getCacheSize();
+    // The pcm data is kept by OpenAL as it is, so the caches aren't compressed
+    void setCacheCompressionEnabled(bool isEnabled) {}
     void update(float dt);
 
 private:
     bool _checkAudioIdValid(int audioID);
     void _play2d(AudioCache *cache, int audioID);
+    void _evictCaches(const AudioCache *usingCache);
 
     ALuint _alSources[MAX_AUDIOINSTANCES];
 
@@ -77,6 +84,8 @@ private:
 
     //filePath,bufferInfo
     std::unordered_map<std::string, AudioCache> _audioCaches;
+    unsigned int _cacheBudget;
+    uint32_t _cacheUseIndex;
 
     //audioID,AudioInfo
     std::unordered_map<int, AudioPlayer*>  _audioPlayers;
@@ -84,7 +93,6 @@ private:
 
     bool _lazyInitLoop;
 
-    int _currentAudioID;
     std::weak_ptr<Scheduler> _scheduler;
 };
 }
@@ -35,6 +35,7 @@ AutoreleasePool::AutoreleasePool()
 #endif
 {
     _managedObjectArray.reserve(150);
+    _releasingObjectArray.reserve(150);
     PoolManager::getInstance()->push(this);
 }
 
@@ -45,6 +46,7 @@ AutoreleasePool::AutoreleasePool(const std::string &name)
 #endif
 {
     _managedObjectArray.reserve(150);
+    _releasingObjectArray.reserve(150);
     PoolManager::getInstance()->push(this);
 }
 
@@ -66,12 +68,17 @@ void AutoreleasePool::clear()
 #if defined(CC_DEBUG) && (CC_DEBUG > 0)
     _isClearing = true;
 #endif
-    std::vector<Ref*> releasings;
-    releasings.swap(_managedObjectArray);
-    for (const auto &obj : releasings)
+    // objects autoreleased while clearing go to the emptied array, they wait for the next clear
+    _releasingObjectArray.swap(_managedObjectArray);
+    for (const auto &obj : _releasingObjectArray)
     {
-        obj->release();
+        // most objects are still retained elsewhere, only the last reference takes the full release
+        if (obj->_referenceCount > 1)
+            --obj->_referenceCount;
+        else
+            obj->release();
     }
+    _releasingObjectArray.clear();
 #if defined(CC_DEBUG) && (CC_DEBUG > 0)
     _isClearing = false;
 #endif
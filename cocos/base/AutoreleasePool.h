@@ -134,6 +134,8 @@ private:
      * is in the pool.
      */
     std::vector<Ref*> _managedObjectArray;
+    // The objects being released by clear, kept to reuse its capacity.
+    std::vector<Ref*> _releasingObjectArray;
     std::string _name;
 
 #if defined(CC_DEBUG) && (CC_DEBUG > 0)
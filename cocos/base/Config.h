@@ -98,6 +98,20 @@ THE SOFTWARE.
 #define CC_USE_WEBP  1
 #endif // CC_USE_WEBP
 
+/** Support KTX2 files supercompressed with Basis Universal or not, which are transcoded at load time.
+ * Needs the basisu transcoder of the external libraries, enable it with USE_BASISU.
+ */
+#ifndef CC_USE_BASISU
+#define CC_USE_BASISU  0
+#endif // CC_USE_BASISU
+
+/** Support LZ4 and zstd compression in ZipUtils or not.
+ * Needs lz4 and zstd of the external libraries, enable it with USE_FAST_COMPRESSION.
+ */
+#ifndef CC_USE_FAST_COMPRESSION
+#define CC_USE_FAST_COMPRESSION  0
+#endif // CC_USE_FAST_COMPRESSION
+
 /** Support EditBox
  */
 #ifndef CC_USE_EDITBOX
@@ -116,4 +130,44 @@ THE SOFTWARE.
 # define CC_ENABLE_PREMULTIPLIED_ALPHA 1
 #endif
 
+/** @def CC_USE_FRAME_STATS
+ * If enabled, the renderer counts culled models, draw calls, state binds and uploads per frame,
+ * see cc::FrameStats. Define it as 0 to remove the counting from release builds.
+ */
+#ifndef CC_USE_FRAME_STATS
+#define CC_USE_FRAME_STATS 1
+#endif
+
+/** @def CC_USE_PROFILER
+ * If enabled, CC_PROFILE_ZONE records CPU zones into cc::Profiler captures,
+ * which export to Chrome trace JSON. Define it as 0 to remove the zones.
+ */
+#ifndef CC_USE_PROFILER
+#define CC_USE_PROFILER 1
+#endif
+
+/** @def CC_USE_MEMORY_SAMPLING
+ * If enabled, the engine allocators count allocations per pool and sample the call stacks of every Nth one,
+ * see cc::MemSampler. Meant for release builds with profiling, the USE_MEMORY_SAMPLING option of CMake.
+ */
+#ifndef CC_USE_MEMORY_SAMPLING
+#define CC_USE_MEMORY_SAMPLING 0
+#endif
+
+/** @def CC_USE_TRACY
+ * If enabled, CC_PROFILE_ZONE streams zones to the Tracy profiler instead.
+ * Tracy is not shipped, its client sources have to be added to the build.
+ */
+#ifndef CC_USE_TRACY
+#define CC_USE_TRACY 0
+#endif
+
+/** @def CC_USE_BENCHMARK
+ * If enabled, the engine is built with cc::gfx::DeviceBenchmark and jsb.runGFXBenchmark, next to the benchmark
+ * executables. The USE_BENCHMARK option of CMake.
+ */
+#ifndef CC_USE_BENCHMARK
+#define CC_USE_BENCHMARK 0
+#endif
+
 #endif // __CCCONFIG_H__
@@ -0,0 +1,33 @@
+#include "FrameStats.h"
+
+namespace cc {
+
+namespace {
+const char *STAT_NAMES[] = {
+    "culledModels",
+    "visibleModels",
+    "queuedPasses",
+    "drawCalls",
+    "pipelineStateBinds",
+    "descriptorSetBinds",
+    "bufferUploadBytes",
+    "instancedMerges",
+    "batchedMerges",
+};
+static_assert(sizeof(STAT_NAMES) / sizeof(STAT_NAMES[0]) == static_cast<size_t>(FrameStat::COUNT), "every frame stat needs a name");
+} // namespace
+
+std::atomic<uint32_t> FrameStats::_current[FrameStats::COUNT] = {};
+uint32_t FrameStats::_last[FrameStats::COUNT] = {};
+
+const char *FrameStats::getName(FrameStat stat) {
+    return stat < FrameStat::COUNT ? STAT_NAMES[static_cast<uint8_t>(stat)] : "";
+}
+
+void FrameStats::endFrame() {
+    for (uint8_t i = 0; i < COUNT; ++i) {
+        _last[i] = _current[i].exchange(0, std::memory_order_relaxed);
+    }
+}
+
+} // namespace cc
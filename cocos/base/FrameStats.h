@@ -0,0 +1,50 @@
+#pragma once
+
+#include "base/Config.h"
+#include "base/Macros.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace cc {
+
+enum class FrameStat : uint8_t {
+    CULLED_MODELS,         // models rejected by frustum, occlusion or LOD culling
+    VISIBLE_MODELS,        // models which passed culling
+    QUEUED_PASSES,         // sub-model passes sorted into the render queues
+    DRAW_CALLS,            // draws recorded into any command buffer
+    PIPELINE_STATE_BINDS,
+    DESCRIPTOR_SET_BINDS,
+    BUFFER_UPLOAD_BYTES,   // bytes written through Buffer::update and CommandBuffer::updateBuffer
+    INSTANCED_MERGES,      // sub-models drawn by instanced draws
+    BATCHED_MERGES,        // sub-models drawn by merged vertex buffer batches
+    COUNT,
+};
+
+// Per-frame counters of the renderer. They are written from the culling and recording threads,
+// the values of the last finished frame are read while the next one accumulates.
+// Building with CC_USE_FRAME_STATS 0 removes the counting.
+class CC_DLL FrameStats {
+public:
+    static CC_INLINE void add(FrameStat stat, uint32_t value) {
+        _current[static_cast<uint8_t>(stat)].fetch_add(value, std::memory_order_relaxed);
+    }
+    static CC_INLINE uint32_t get(FrameStat stat) { return _last[static_cast<uint8_t>(stat)]; }
+    static const char *getName(FrameStat stat);
+
+    // Publishes the counts of the frame and starts the next one.
+    static void endFrame();
+
+private:
+    static constexpr uint8_t COUNT = static_cast<uint8_t>(FrameStat::COUNT);
+    static std::atomic<uint32_t> _current[COUNT];
+    static uint32_t _last[COUNT];
+};
+
+} // namespace cc
+
+#if CC_USE_FRAME_STATS
+    #define CC_FRAME_STAT_ADD(stat, value) cc::FrameStats::add(cc::FrameStat::stat, static_cast<uint32_t>(value))
+#else
+    #define CC_FRAME_STAT_ADD(stat, value)
+#endif
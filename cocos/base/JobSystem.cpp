@@ -0,0 +1,217 @@
+#include "base/JobSystem.h"
+#include "base/ThreadConfig.h"
+
+#include <cstdlib>
+
+namespace cc {
+
+namespace {
+
+struct ThreadIndex {
+    const JobSystem *system = nullptr;
+    int32_t index = -1;
+};
+thread_local ThreadIndex tThreadIndex;
+
+// Pre-C++17 operator new ignores the alignment of over-aligned types, the original pointer is kept before the block.
+void *allocateAligned(size_t size, size_t alignment) {
+    void *memory = std::malloc(size + alignment + sizeof(void *));
+    if (!memory) return nullptr;
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(memory) + sizeof(void *) + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    reinterpret_cast<void **>(aligned)[-1] = memory;
+    return reinterpret_cast<void *>(aligned);
+}
+
+void freeAligned(void *ptr) {
+    if (ptr) std::free(reinterpret_cast<void **>(ptr)[-1]);
+}
+
+} // namespace
+
+bool WorkStealingQueue::push(Job *job) {
+    const int64_t bottom = _bottom.load(std::memory_order_relaxed);
+    const int64_t top = _top.load(std::memory_order_acquire);
+    if (bottom - top >= CAPACITY) return false;
+
+    _jobs[bottom & MASK].store(job, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _bottom.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+}
+
+Job *WorkStealingQueue::pop() {
+    const int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+    _bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = _top.load(std::memory_order_relaxed);
+
+    if (top > bottom) { // empty
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Job *job = _jobs[bottom & MASK].load(std::memory_order_relaxed);
+    if (top == bottom) { // the last job, a thief may take it at the same time
+        if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            job = nullptr;
+        }
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+Job *WorkStealingQueue::steal() {
+    int64_t top = _top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = _bottom.load(std::memory_order_acquire);
+    if (top >= bottom) return nullptr;
+
+    Job *job = _jobs[top & MASK].load(std::memory_order_relaxed);
+    if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr; // lost to the owner or another thief
+    }
+    return job;
+}
+
+JobSystem *JobSystem::_instance = nullptr;
+
+JobSystem *JobSystem::getInstance() {
+    if (!_instance) _instance = new JobSystem();
+    return _instance;
+}
+
+void JobSystem::destroyInstance() {
+    delete _instance;
+    _instance = nullptr;
+}
+
+JobSystem::JobSystem(uint32_t workerCount) {
+    if (!workerCount) workerCount = ThreadConfig::getThreadCount(ThreadLane::CPU);
+
+    _threadData.resize(workerCount + 1);
+    for (auto &data : _threadData) {
+        data.queue = ::new (allocateAligned(sizeof(WorkStealingQueue), alignof(WorkStealingQueue))) WorkStealingQueue();
+        data.jobs = static_cast<Job *>(allocateAligned(sizeof(Job) * MAX_JOB_COUNT, alignof(Job)));
+        for (uint32_t i = 0; i < MAX_JOB_COUNT; ++i) {
+            ::new (data.jobs + i) Job();
+        }
+    }
+
+    tThreadIndex = {this, 0};
+    _threads.reserve(workerCount);
+    for (uint32_t i = 1; i <= workerCount; ++i) {
+        _threads.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _isRunning.store(false);
+    }
+    _sleepCondition.notify_all();
+    for (auto &thread : _threads) {
+        thread.join();
+    }
+
+    for (auto &data : _threadData) {
+        for (uint32_t i = 0; i < MAX_JOB_COUNT; ++i) {
+            Job *job = data.jobs + i;
+            if (job->_destroy && !job->isFinished()) job->_destroy(job);
+            job->~Job();
+        }
+        freeAligned(data.jobs);
+        data.queue->~WorkStealingQueue();
+        freeAligned(data.queue);
+    }
+    if (tThreadIndex.system == this) tThreadIndex = {};
+}
+
+int32_t JobSystem::getThreadIndex() const {
+    return tThreadIndex.system == this ? tThreadIndex.index : -1;
+}
+
+Job *JobSystem::allocateJob() {
+    const int32_t index = getThreadIndex();
+    CCASSERT(index >= 0, "jobs have to be created on the thread of the job system or inside a job");
+
+    ThreadData &data = _threadData[index];
+    Job *job = data.jobs + (data.allocatedJobs++ & (MAX_JOB_COUNT - 1));
+    CCASSERT(job->isFinished(), "too many jobs in flight on one thread");
+    return job;
+}
+
+void JobSystem::run(Job *job) {
+    const int32_t index = getThreadIndex();
+    CCASSERT(index >= 0, "jobs have to be run on the thread of the job system or inside a job");
+
+    _queuedJobs.fetch_add(1);
+    if (!_threadData[index].queue->push(job)) {
+        _queuedJobs.fetch_sub(1);
+        execute(job);
+        return;
+    }
+
+    if (_sleepingWorkers.load() > 0) {
+        // taking the lock makes sure a worker about to sleep sees the job
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _sleepCondition.notify_one();
+    }
+}
+
+void JobSystem::wait(const Job *job) {
+    while (!job->isFinished()) {
+        if (Job *next = getJob()) {
+            execute(next);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+Job *JobSystem::getJob() {
+    const int32_t index = getThreadIndex();
+    const auto threadCount = static_cast<int32_t>(_threadData.size());
+
+    Job *job = index >= 0 ? _threadData[index].queue->pop() : nullptr;
+    // steal from the next threads first, the thieves spread over the queues
+    for (int32_t i = 1; !job && i <= threadCount; ++i) {
+        const int32_t victim = (index + i + threadCount) % threadCount;
+        if (victim != index) job = _threadData[victim].queue->steal();
+    }
+
+    if (job) _queuedJobs.fetch_sub(1);
+    return job;
+}
+
+void JobSystem::execute(Job *job) {
+    job->_invoke(job);
+    finish(job);
+}
+
+void JobSystem::finish(Job *job) {
+    Job *parent = job->_parent;
+    if (job->_unfinishedJobs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        if (job->_destroy) job->_destroy(job);
+        if (parent) finish(parent);
+    }
+}
+
+void JobSystem::workerLoop(uint32_t index) {
+    tThreadIndex = {this, static_cast<int32_t>(index)};
+    ThreadConfig::applyToCurrentThread(ThreadLane::CPU);
+
+    while (_isRunning.load(std::memory_order_relaxed)) {
+        if (Job *job = getJob()) {
+            execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _sleepingWorkers.fetch_add(1);
+        _sleepCondition.wait(lock, [this]() { return _queuedJobs.load() > 0 || !_isRunning.load(); });
+        _sleepingWorkers.fetch_sub(1);
+    }
+}
+
+} // namespace cc
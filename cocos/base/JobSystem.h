@@ -0,0 +1,175 @@
+#pragma once
+
+#include "base/Config.h"
+#include "base/Macros.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cc {
+
+class JobSystem;
+
+// A unit of work in the JobSystem. The closure lives inside the job, a job never allocates.
+// A job is finished once its closure ran and all its children are finished.
+class alignas(64) Job {
+public:
+    static constexpr size_t SIZE = 128;
+    static constexpr size_t PAYLOAD_SIZE = 96; // what the header leaves of SIZE
+
+    CC_INLINE bool isFinished() const { return _unfinishedJobs.load(std::memory_order_acquire) <= 0; }
+
+private:
+    friend class JobSystem;
+
+    using InvokeFunc = void (*)(Job *);
+
+    InvokeFunc _invoke = nullptr;
+    InvokeFunc _destroy = nullptr; // runs once the job and its children are finished
+    Job *_parent = nullptr;
+    std::atomic<int32_t> _unfinishedJobs{0};
+    typename std::aligned_storage<PAYLOAD_SIZE, alignof(std::max_align_t)>::type _payload;
+};
+static_assert(sizeof(Job) == Job::SIZE, "a job has to fill a cache line pair exactly");
+
+// Chase-Lev deque of one worker. The owner pushes and pops at the bottom, the other workers steal from the top.
+class WorkStealingQueue {
+public:
+    static constexpr int64_t CAPACITY = 4096;
+
+    bool push(Job *job);
+    Job *pop();
+    Job *steal();
+
+private:
+    static constexpr int64_t MASK = CAPACITY - 1;
+    static_assert((CAPACITY & MASK) == 0, "the capacity of a queue has to be a power of two");
+
+    alignas(64) std::atomic<int64_t> _top{0};
+    alignas(64) std::atomic<int64_t> _bottom{0};
+    std::atomic<Job *> _jobs[CAPACITY];
+};
+
+/**
+ * Runs short compute jobs on the worker threads of the CPU lane of ThreadConfig and the thread which creates it.
+ * Culling, skinning, particle updates and decoding are split into jobs which the workers steal from each other,
+ * blocking or long-running work such as network and file IO belongs to ThreadPool instead.
+ *
+ * Jobs are created and run from the thread which created the system or from inside other jobs. A thread keeps
+ * at most MAX_JOB_COUNT jobs in flight, job memory is recycled in creation order.
+ */
+class CC_DLL JobSystem {
+public:
+    static constexpr uint32_t MAX_JOB_COUNT = 1024;
+
+    static JobSystem *getInstance();
+    static void destroyInstance();
+
+    // 0 takes the thread count of the CPU lane.
+    explicit JobSystem(uint32_t workerCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    template <class F>
+    CC_INLINE Job *createJob(F &&f) { return createJobImpl<false>(nullptr, std::forward<F>(f)); }
+
+    // The parent is not finished before the child, create every child before running the parent.
+    template <class F>
+    CC_INLINE Job *createChildJob(Job *parent, F &&f) { return createJobImpl<false>(parent, std::forward<F>(f)); }
+
+    // Queues the job on the calling thread, executing it right away if the queue is full.
+    void run(Job *job);
+
+    // Executes other jobs until the job is finished.
+    void wait(const Job *job);
+
+    /**
+     * Calls f(begin, end) over [0, count) split into ranges of at most grainSize elements.
+     * @return The job finished with the last range, it is already running.
+     */
+    template <class F>
+    Job *parallelFor(uint32_t count, uint32_t grainSize, const F &f);
+
+    // Number of threads executing jobs, including the one which created the system.
+    CC_INLINE uint32_t getThreadCount() const { return static_cast<uint32_t>(_threadData.size()); }
+
+private:
+    template <bool WITH_JOB, class F>
+    Job *createJobImpl(Job *parent, F &&f);
+
+    template <bool WITH_JOB, class F>
+    static CC_INLINE typename std::enable_if<WITH_JOB>::type call(F &f, Job *job) { f(job); }
+    template <bool WITH_JOB, class F>
+    static CC_INLINE typename std::enable_if<!WITH_JOB>::type call(F &f, Job * /*job*/) { f(); }
+
+    Job *allocateJob();
+    Job *getJob();
+    void execute(Job *job);
+    void finish(Job *job);
+    void workerLoop(uint32_t index);
+
+    // touched by its own thread only, except the queue
+    struct ThreadData {
+        WorkStealingQueue *queue = nullptr;
+        Job *jobs = nullptr; // MAX_JOB_COUNT
+        uint32_t allocatedJobs = 0;
+    };
+
+    int32_t getThreadIndex() const;
+
+    std::vector<ThreadData> _threadData; // the thread which created the system comes first
+    std::vector<std::thread> _threads;
+
+    std::atomic<int32_t> _queuedJobs{0};
+    std::atomic<int32_t> _sleepingWorkers{0};
+    std::atomic<bool> _isRunning{true};
+    std::mutex _sleepMutex;
+    std::condition_variable _sleepCondition;
+
+    static JobSystem *_instance;
+};
+
+template <bool WITH_JOB, class F>
+Job *JobSystem::createJobImpl(Job *parent, F &&f) {
+    using Closure = typename std::decay<F>::type;
+    static_assert(sizeof(Closure) <= Job::PAYLOAD_SIZE, "the captures of a job exceed its payload, capture a pointer instead");
+    static_assert(alignof(Closure) <= alignof(std::max_align_t), "the captures of a job are over-aligned");
+
+    Job *job = allocateJob();
+    ::new (&job->_payload) Closure(std::forward<F>(f));
+    job->_invoke = [](Job *self) { call<WITH_JOB>(*reinterpret_cast<Closure *>(&self->_payload), self); };
+    job->_destroy = std::is_trivially_destructible<Closure>::value
+                        ? nullptr
+                        : static_cast<Job::InvokeFunc>([](Job *self) { reinterpret_cast<Closure *>(&self->_payload)->~Closure(); });
+    job->_parent = parent;
+    job->_unfinishedJobs.store(1, std::memory_order_relaxed);
+    if (parent) parent->_unfinishedJobs.fetch_add(1, std::memory_order_relaxed);
+    return job;
+}
+
+template <class F>
+Job *JobSystem::parallelFor(uint32_t count, uint32_t grainSize, const F &f) {
+    grainSize = grainSize ? grainSize : 1;
+    // the closure of the root stays alive until all ranges are finished, the ranges refer to it
+    Job *root = createJobImpl<true>(nullptr, [this, count, grainSize, f](Job *self) {
+        const F *func = &f;
+        for (uint32_t begin = 0; begin < count; begin += grainSize) {
+            const uint32_t end = begin + grainSize < count ? begin + grainSize : count;
+            run(createChildJob(self, [func, begin, end]() { (*func)(begin, end); }));
+        }
+    });
+    run(root);
+    return root;
+}
+
+} // namespace cc
@@ -0,0 +1,98 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/MemoryPressure.h"
+#include "base/Log.h"
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace cc {
+
+namespace {
+struct HandlerEntry {
+    uint32_t id = 0;
+    std::string name;
+    MemoryPressureLevel tier = MemoryPressureLevel::MODERATE;
+    MemoryPressure::Handler handler;
+};
+
+std::mutex handlersMutex;
+std::vector<HandlerEntry> handlers; // sorted by tier, in the order of registration within one
+uint32_t lastHandlerID = 0;
+
+const char *getLevelName(MemoryPressureLevel level) {
+    switch (level) {
+        case MemoryPressureLevel::MODERATE: return "moderate";
+        case MemoryPressureLevel::LOW: return "low";
+        default: return "critical";
+    }
+}
+} // namespace
+
+uint32_t MemoryPressure::addHandler(const char *name, MemoryPressureLevel tier, const Handler &handler) {
+    std::lock_guard<std::mutex> lock(handlersMutex);
+    HandlerEntry entry;
+    entry.id = ++lastHandlerID;
+    entry.name = name;
+    entry.tier = tier;
+    entry.handler = handler;
+    auto iter = std::upper_bound(handlers.begin(), handlers.end(), tier, [](MemoryPressureLevel t, const HandlerEntry &e) { return t < e.tier; });
+    handlers.insert(iter, std::move(entry));
+    return lastHandlerID;
+}
+
+void MemoryPressure::removeHandler(uint32_t handlerID) {
+    std::lock_guard<std::mutex> lock(handlersMutex);
+    auto iter = std::find_if(handlers.begin(), handlers.end(), [handlerID](const HandlerEntry &e) { return e.id == handlerID; });
+    if (iter != handlers.end()) handlers.erase(iter);
+}
+
+void MemoryPressure::notify(MemoryPressureLevel level) {
+    // handlers may remove themselves or others, the ones removed meanwhile are skipped
+    std::vector<uint32_t> ids;
+    {
+        std::lock_guard<std::mutex> lock(handlersMutex);
+        for (const auto &entry : handlers) {
+            if (entry.tier > level) break;
+            ids.push_back(entry.id);
+        }
+    }
+
+    CC_LOG_INFO("MemoryPressure: %s, %u handlers", getLevelName(level), static_cast<uint32_t>(ids.size()));
+    for (auto id : ids) {
+        HandlerEntry entry;
+        {
+            std::lock_guard<std::mutex> lock(handlersMutex);
+            auto iter = std::find_if(handlers.begin(), handlers.end(), [id](const HandlerEntry &e) { return e.id == id; });
+            if (iter == handlers.end()) continue;
+            entry = *iter;
+        }
+        CC_LOG_DEBUG("MemoryPressure: releasing %s", entry.name.c_str());
+        entry.handler(level);
+    }
+}
+
+} // namespace cc
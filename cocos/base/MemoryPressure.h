@@ -0,0 +1,57 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "base/Macros.h"
+#include <cstdint>
+#include <functional>
+
+namespace cc {
+
+// How hard the system is asking for memory back, the levels are also the tiers handlers register at.
+enum class MemoryPressureLevel : uint8_t {
+    MODERATE, // pooled objects and free lists nothing refers to, cheap to build again
+    LOW,      // caches reloaded or rebuilt on demand, costs some loading or hitches later
+    CRITICAL, // everything which can be recreated at all, the process is about to be killed
+};
+
+/**
+ * Central registry the engine caches give memory back through when the system runs low.
+ * A notification runs the handlers of its own tier and of the tiers below it, lower tiers first, so a moderate
+ * warning only empties pools while a critical one also drops caches and collects the script heap.
+ * Handlers get the level of the notification to scale what they release. Notifications arrive on the cocos thread.
+ */
+class CC_DLL MemoryPressure {
+public:
+    using Handler = std::function<void(MemoryPressureLevel level)>;
+
+    // Returns the id to remove the handler with, name is used in the log.
+    static uint32_t addHandler(const char *name, MemoryPressureLevel tier, const Handler &handler);
+    static void removeHandler(uint32_t handlerID);
+
+    static void notify(MemoryPressureLevel level);
+};
+
+} // namespace cc
@@ -0,0 +1,208 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace cc {
+
+namespace {
+struct ZoneEvent {
+    const char *name;
+    uint64_t begin;
+    uint64_t end;
+};
+
+// Only the owning thread writes a buffer. It restarts the buffer when it records the first zone
+// of a new capture, and publishes every zone through the count, which the exporter reads it up to.
+struct ThreadBuffer {
+    uint32_t threadIndex = 0;
+    std::atomic<uint32_t> capture{0};
+    std::atomic<uint32_t> count{0};
+    uint32_t dropped = 0;
+    ZoneEvent events[Profiler::EVENTS_PER_THREAD];
+    // allocated with the first zone recorded while the ring is enabled, the head only grows
+    std::atomic<ZoneEvent *> ring{nullptr};
+    std::atomic<uint32_t> ringHead{0};
+    // zones begun by beginZone, ended in reverse order
+    std::vector<std::pair<const char *, uint64_t>> openZones;
+};
+
+std::mutex bufferMutex;
+// buffers of exited threads are kept, their zones are still exported
+std::vector<ThreadBuffer *> buffers;
+thread_local ThreadBuffer *threadBuffer = nullptr;
+
+// slots behind the tail of a ring which getRingZones leaves out
+constexpr uint32_t RING_SLACK_EVENTS = 256;
+
+std::atomic<uint32_t> currentCapture{0};
+uint64_t captureBegin = 0;
+
+std::mutex nameMutex;
+std::unordered_set<std::string> names;
+
+ThreadBuffer *getThreadBuffer() {
+    if (!threadBuffer) {
+        threadBuffer = new ThreadBuffer();
+        std::lock_guard<std::mutex> lock(bufferMutex);
+        threadBuffer->threadIndex = static_cast<uint32_t>(buffers.size());
+        buffers.push_back(threadBuffer);
+    }
+    return threadBuffer;
+}
+
+void appendEscaped(std::string &out, const char *str) {
+    for (; *str; ++str) {
+        const char c = *str;
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) >= 0x20) {
+            out += c;
+        }
+    }
+}
+} // namespace
+
+std::atomic<bool> Profiler::_isCapturing{false};
+std::atomic<bool> Profiler::_isRingEnabled{false};
+std::atomic<bool> Profiler::_isRecording{false};
+
+uint64_t Profiler::now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void Profiler::beginCapture() {
+    if (isCapturing()) return;
+    captureBegin = now();
+    currentCapture.fetch_add(1, std::memory_order_release);
+    _isCapturing.store(true, std::memory_order_release);
+    updateRecording();
+}
+
+void Profiler::endCapture() {
+    _isCapturing.store(false, std::memory_order_release);
+    updateRecording();
+}
+
+void Profiler::setRingEnabled(bool enabled) {
+    _isRingEnabled.store(enabled, std::memory_order_release);
+    updateRecording();
+}
+
+void Profiler::updateRecording() {
+    _isRecording.store(isCapturing() || _isRingEnabled.load(std::memory_order_relaxed), std::memory_order_release);
+}
+
+void Profiler::record(const char *name, uint64_t begin, uint64_t end) {
+    auto *buffer = getThreadBuffer();
+    if (_isRingEnabled.load(std::memory_order_relaxed)) {
+        auto *ring = buffer->ring.load(std::memory_order_relaxed);
+        if (!ring) {
+            ring = new ZoneEvent[RING_EVENTS_PER_THREAD];
+            buffer->ring.store(ring, std::memory_order_release);
+        }
+        const uint32_t head = buffer->ringHead.load(std::memory_order_relaxed);
+        ring[head & (RING_EVENTS_PER_THREAD - 1)] = {name, begin, end};
+        buffer->ringHead.store(head + 1, std::memory_order_release);
+    }
+    if (!isCapturing()) return;
+
+    const auto capture = currentCapture.load(std::memory_order_acquire);
+    uint32_t count = buffer->count.load(std::memory_order_relaxed);
+    if (buffer->capture.load(std::memory_order_relaxed) != capture) {
+        count = 0;
+        buffer->dropped = 0;
+        buffer->count.store(0, std::memory_order_relaxed);
+        buffer->capture.store(capture, std::memory_order_release);
+    }
+    if (count == EVENTS_PER_THREAD) {
+        ++buffer->dropped;
+        return;
+    }
+    buffer->events[count] = {name, begin, end};
+    buffer->count.store(count + 1, std::memory_order_release);
+}
+
+const char *Profiler::intern(const std::string &name) {
+    std::lock_guard<std::mutex> lock(nameMutex);
+    return names.insert(name).first->c_str();
+}
+
+void Profiler::beginZone(const char *name) {
+    getThreadBuffer()->openZones.emplace_back(name, isRecording() ? now() : 0);
+}
+
+void Profiler::endZone() {
+    auto &openZones = getThreadBuffer()->openZones;
+    if (openZones.empty()) return;
+    const auto zone = openZones.back();
+    openZones.pop_back();
+    if (zone.second) record(zone.first, zone.second, now());
+}
+
+void Profiler::getRingZones(uint64_t since, std::vector<RingZone> *zones) {
+    std::lock_guard<std::mutex> lock(bufferMutex);
+    for (const auto *buffer : buffers) {
+        const auto *ring = buffer->ring.load(std::memory_order_acquire);
+        if (!ring) continue;
+        const uint32_t head  = buffer->ringHead.load(std::memory_order_acquire);
+        const uint32_t count = std::min(head, RING_EVENTS_PER_THREAD - RING_SLACK_EVENTS);
+        for (uint32_t i = head - count; i != head; ++i) {
+            const auto &event = ring[i & (RING_EVENTS_PER_THREAD - 1)];
+            if (event.end > since) zones->push_back({event.name, buffer->threadIndex, event.begin, event.end});
+        }
+    }
+}
+
+uint32_t Profiler::getDroppedZoneCount() {
+    const auto capture = currentCapture.load(std::memory_order_acquire);
+    uint32_t dropped = 0;
+    std::lock_guard<std::mutex> lock(bufferMutex);
+    for (const auto *buffer : buffers) {
+        if (buffer->capture.load(std::memory_order_acquire) == capture) dropped += buffer->dropped;
+    }
+    return dropped;
+}
+
+std::string Profiler::getChromeTrace() {
+    const auto capture = currentCapture.load(std::memory_order_acquire);
+    std::string trace = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    char number[64];
+    bool isFirst = true;
+
+    std::lock_guard<std::mutex> lock(bufferMutex);
+    for (const auto *buffer : buffers) {
+        if (buffer->capture.load(std::memory_order_acquire) != capture) continue;
+        const auto count = buffer->count.load(std::memory_order_acquire);
+        for (uint32_t i = 0; i < count; ++i) {
+            const auto &event = buffer->events[i];
+            // zones begun before the capture are clipped to its start
+            const uint64_t begin = std::max(event.begin, captureBegin);
+            if (!isFirst) trace += ',';
+            isFirst = false;
+            trace += "{\"ph\":\"X\",\"pid\":0,\"name\":\"";
+            appendEscaped(trace, event.name);
+            snprintf(number, sizeof(number), "\",\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", buffer->threadIndex,
+                     (begin - captureBegin) * 1e-3, (event.end > begin ? event.end - begin : 0) * 1e-3);
+            trace += number;
+        }
+    }
+    trace += "]}";
+    return trace;
+}
+
+bool Profiler::saveChromeTrace(const std::string &path) {
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file) return false;
+    const auto trace = getChromeTrace();
+    const bool isWritten = fwrite(trace.data(), 1, trace.size(), file) == trace.size();
+    fclose(file);
+    return isWritten;
+}
+
+} // namespace cc
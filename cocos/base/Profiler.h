@@ -0,0 +1,92 @@
+#pragma once
+
+#include "base/Config.h"
+#include "base/Macros.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if CC_USE_TRACY
+    #include "Tracy.hpp"
+#endif
+
+namespace cc {
+
+// CPU zones recorded while a capture runs. Every thread writes its zones into a buffer of its own
+// without locks, zones of a full buffer are dropped. The main thread begins and ends captures and
+// exports them once ended, to Chrome trace event JSON for chrome://tracing or Perfetto.
+// The zone macros stream to Tracy instead in builds with CC_USE_TRACY, captures stay empty then.
+// With the ring enabled every thread also keeps its latest zones in a ring of its own, captured or not,
+// for SpikeDetector to read back after a hitch.
+class CC_DLL Profiler {
+public:
+    static constexpr uint32_t EVENTS_PER_THREAD      = 1 << 15;
+    static constexpr uint32_t RING_EVENTS_PER_THREAD = 1 << 12;
+
+    struct RingZone {
+        const char *name;
+        uint32_t threadIndex;
+        uint64_t begin;
+        uint64_t end;
+    };
+
+    static void beginCapture();
+    static void endCapture();
+    static CC_INLINE bool isCapturing() { return _isCapturing.load(std::memory_order_relaxed); }
+    // whether zones are timed at all, by a capture or the ring
+    static CC_INLINE bool isRecording() { return _isRecording.load(std::memory_order_relaxed); }
+
+    static void setRingEnabled(bool enabled);
+    // Appends the zones of the rings which ended after the time. The oldest slots of every ring are left out,
+    // their threads may be overwriting them meanwhile.
+    static void getRingZones(uint64_t since, std::vector<RingZone> *zones);
+
+    static std::string getChromeTrace();
+    static bool saveChromeTrace(const std::string &path);
+    static uint32_t getDroppedZoneCount();
+
+    // Names have to outlive the capture, intern the ones which are not literals.
+    static const char *intern(const std::string &name);
+    // For zones which don't end in the scope they begin in, such as the ones of scripts.
+    static void beginZone(const char *name);
+    static void endZone();
+
+    static uint64_t now();
+    static void record(const char *name, uint64_t begin, uint64_t end);
+
+private:
+    static void updateRecording();
+
+    static std::atomic<bool> _isCapturing;
+    static std::atomic<bool> _isRingEnabled;
+    static std::atomic<bool> _isRecording;
+};
+
+class ProfilerZone {
+public:
+    explicit CC_INLINE ProfilerZone(const char *name) : _name(name) {
+        if (Profiler::isRecording()) _begin = Profiler::now();
+    }
+    CC_INLINE ~ProfilerZone() {
+        if (_begin) Profiler::record(_name, _begin, Profiler::now());
+    }
+
+private:
+    const char *_name = nullptr;
+    uint64_t _begin = 0;
+};
+
+} // namespace cc
+
+#define CC_PROFILE_CONCAT_(a, b) a##b
+#define CC_PROFILE_CONCAT(a, b)  CC_PROFILE_CONCAT_(a, b)
+
+#if CC_USE_TRACY
+    #define CC_PROFILE_ZONE(name) ZoneScopedN(name)
+#elif CC_USE_PROFILER
+    #define CC_PROFILE_ZONE(name) cc::ProfilerZone CC_PROFILE_CONCAT(ccProfilerZone, __LINE__)(name)
+#else
+    #define CC_PROFILE_ZONE(name)
+#endif
@@ -27,46 +27,276 @@ THE SOFTWARE.
 ****************************************************************************/
 #include "base/Scheduler.h"
 #include "base/Macros.h"
-#include "base/utlist.h"
-#include "base/Array.h"
+#include "base/Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <memory>
+#include <unordered_map>
 
 #define CC_REPEAT_FOREVER (UINT_MAX -1)
 
 namespace cc {
 
-// data structures
+namespace {
+
+constexpr double TICKS_PER_SECOND = 1000.0;
+constexpr uint32_t SLOT_BITS = 6;
+constexpr uint32_t SLOT_COUNT = 1u << SLOT_BITS;
+constexpr uint32_t SLOT_MASK = SLOT_COUNT - 1;
+// 2^24 ticks, about 4.6 hours, later timers wait in the last level and cascade again
+constexpr uint32_t LEVEL_COUNT = 4;
+constexpr uint32_t TIMER_CHUNK_SIZE = 64;
 
-// A list double-linked list used for "updates with priority"
-typedef struct _listEntry
+enum class TimerState : uint8_t
 {
-    struct _listEntry   *prev, *next;
-    ccSchedulerFunc     callback;
-    void                *target;
-    int                 priority;
-    bool                paused;
-    bool                markedForDeletion; // selector will no longer be called and entry will be removed at end of the next tick
-} tListEntry;
+    PENDING,   // starts with the next update
+    FRAME,     // interval 0, triggers every update
+    WHEEL,
+    PAUSED,    // its target is paused, the time left is kept
+    FIRING,
+    CANCELLED, // freed once the update is done
+};
+
+// Circular list, a link alone is the sentinel of a list
+struct TimerLink
+{
+    TimerLink *prev = this;
+    TimerLink *next = this;
+
+    TimerLink() = default;
+    TimerLink(const TimerLink&) = delete;
+    TimerLink& operator=(const TimerLink&) = delete;
+
+    inline bool isEmpty() const { return next == this; }
+
+    inline void unlink()
+    {
+        prev->next = next;
+        next->prev = prev;
+        prev = next = this;
+    }
+
+    inline void pushBack(TimerLink *link)
+    {
+        link->prev = prev;
+        link->next = this;
+        prev->next = link;
+        prev = link;
+    }
+
+    // moves all the links of the list to the back of another
+    inline void spliceTo(TimerLink &list)
+    {
+        if (isEmpty()) return;
+        next->prev = list.prev;
+        prev->next = &list;
+        list.prev->next = next;
+        list.prev = prev;
+        prev = next = this;
+    }
+};
+
+// interned key and the number of timers using it
+typedef std::pair<const std::string, uint32_t> KeyEntry;
+
+} // namespace
+
+struct SchedulerPerformNode
+{
+    std::atomic<SchedulerPerformNode*> next{nullptr};
+    SchedulerPerformNode *freeNext = nullptr;
+    uint64_t sequence = 0;
+    std::function<void()> function;
+};
+
+namespace {
+
+// Nodes performed by any scheduler, a producer takes the whole stack into its thread cache at once,
+// so popping never races with another pop.
+std::atomic<SchedulerPerformNode*> freePerformNodes{nullptr};
+
+void releasePerformNodes(SchedulerPerformNode *first, SchedulerPerformNode *last)
+{
+    SchedulerPerformNode *head = freePerformNodes.load(std::memory_order_relaxed);
+    do
+    {
+        last->freeNext = head;
+    } while (!freePerformNodes.compare_exchange_weak(head, first, std::memory_order_release, std::memory_order_relaxed));
+}
+
+struct PerformNodeCache
+{
+    SchedulerPerformNode *nodes = nullptr;
+
+    ~PerformNodeCache()
+    {
+        if (!nodes)
+            return;
+        SchedulerPerformNode *last = nodes;
+        while (last->freeNext)
+            last = last->freeNext;
+        releasePerformNodes(nodes, last);
+    }
+
+    SchedulerPerformNode* acquire()
+    {
+        if (!nodes)
+            nodes = freePerformNodes.exchange(nullptr, std::memory_order_acquire);
+        if (!nodes)
+            return new (std::nothrow) SchedulerPerformNode();
+
+        SchedulerPerformNode *node = nodes;
+        nodes = node->freeNext;
+        node->freeNext = nullptr;
+        return node;
+    }
+};
+thread_local PerformNodeCache performNodeCache;
 
-typedef struct _hashUpdateEntry
+} // namespace
+
+struct Scheduler::TimerEntry : TimerLink
+{
+    TargetEntry *target = nullptr;
+    KeyEntry *key = nullptr;
+    ccSchedulerFunc callback;
+    double dueTime = 0.0;   // on the clock of the scheduler
+    double lastTime = 0.0;  // start or last trigger, a changed interval counts from there
+    double remaining = 0.0; // left until due while the target is paused
+    uint64_t activatedUpdate = 0;
+    float interval = 0.f;
+    float delay = 0.f;
+    unsigned int repeat = 0; // 0 = once, 1 is 2 x executed
+    unsigned int timesExecuted = 0;
+    bool useDelay = false;
+    TimerState state = TimerState::PENDING;
+};
+
+struct Scheduler::TargetEntry
 {
-    tListEntry          **list;        // Which list does it belong to ?
-    tListEntry          *entry;        // entry in the list
-    void                *target;
-    ccSchedulerFunc     callback;
-    UT_hash_handle      hh;
-} tHashUpdateEntry;
+    void *target = nullptr;
+    bool paused = false;
+    std::vector<TimerEntry*> timers;
+    UT_hash_handle hh;
+};
 
-// Hash Element used for "selectors with interval"
-typedef struct _hashSelectorEntry
+struct Scheduler::TimerWheel
 {
-    ccArray             *timers;
-    void                *target;
-    int                 timerIndex;
-    Timer               *currentTimer;
-    bool                currentTimerSalvaged;
-    bool                paused;
-    UT_hash_handle      hh;
-} tHashTimerEntry;
+    TimerLink slots[LEVEL_COUNT][SLOT_COUNT];
+    TimerLink frameTimers;
+    TimerLink pendingTimers;
+    TimerLink cancelledTimers;
+    TimerLink freeTimers;
+
+    std::vector<std::unique_ptr<TimerEntry[]>> timerChunks;
+    std::vector<TargetEntry*> freeTargets;
+    std::unordered_map<std::string, uint32_t> keys;
+    TargetEntry *targets = nullptr; // uthash of the targets with timers
+
+    double time = 0.0;
+    uint64_t tick = 0;       // the tick being expired, or the last one expired
+    uint64_t targetTick = 0; // the tick of time
+    uint64_t updateCount = 0;
+    uint32_t wheelTimerCount = 0;
+    bool isUpdating = false;
+
+    ~TimerWheel()
+    {
+        for (auto *target : freeTargets)
+            delete target;
+    }
+
+    TimerEntry* allocTimer()
+    {
+        if (freeTimers.isEmpty())
+        {
+            timerChunks.emplace_back(new TimerEntry[TIMER_CHUNK_SIZE]);
+            TimerEntry *chunk = timerChunks.back().get();
+            for (uint32_t i = 0; i < TIMER_CHUNK_SIZE; ++i)
+                freeTimers.pushBack(chunk + i);
+        }
+        auto *timer = static_cast<TimerEntry*>(freeTimers.next);
+        timer->unlink();
+        return timer;
+    }
+
+    void freeTimer(TimerEntry *timer)
+    {
+        if (--timer->key->second == 0)
+            keys.erase(keys.find(timer->key->first));
+        timer->key = nullptr;
+        timer->target = nullptr;
+        timer->callback = nullptr; // releases the captures now
+        freeTimers.pushBack(timer);
+    }
+
+    TargetEntry* allocTarget(void *target, bool paused)
+    {
+        TargetEntry *entry = nullptr;
+        if (freeTargets.empty())
+        {
+            entry = new (std::nothrow) TargetEntry();
+        }
+        else
+        {
+            entry = freeTargets.back();
+            freeTargets.pop_back();
+        }
+        entry->target = target;
+        entry->paused = paused;
+        HASH_ADD_PTR(targets, target, entry);
+        return entry;
+    }
+
+    void freeTarget(TargetEntry *entry)
+    {
+        HASH_DEL(targets, entry);
+        entry->timers.clear();
+        freeTargets.push_back(entry);
+    }
+
+    void insert(TimerEntry *timer)
+    {
+        auto dueTick = static_cast<uint64_t>(std::floor(std::max(timer->dueTime, 0.0) * TICKS_PER_SECOND));
+        // what is already due expires with the last tick of the update
+        dueTick = std::max(dueTick, targetTick);
+
+        const uint64_t delta = dueTick - tick;
+        uint32_t level = 0;
+        while (level < LEVEL_COUNT - 1 && delta >= (1ULL << (SLOT_BITS * (level + 1))))
+            ++level;
+        if (delta >= (1ULL << (SLOT_BITS * LEVEL_COUNT)))
+            dueTick = tick + (1ULL << (SLOT_BITS * LEVEL_COUNT)) - 1;
+
+        slots[level][(dueTick >> (SLOT_BITS * level)) & SLOT_MASK].pushBack(timer);
+        timer->state = TimerState::WHEEL;
+        ++wheelTimerCount;
+    }
+
+    void remove(TimerEntry *timer)
+    {
+        if (timer->state == TimerState::WHEEL)
+            --wheelTimerCount;
+        timer->unlink();
+    }
+
+    // moves the timers of a slot to the lower levels
+    void cascade(uint32_t level, uint32_t index)
+    {
+        TimerLink list;
+        slots[level][index].spliceTo(list);
+        while (!list.isEmpty())
+        {
+            auto *timer = static_cast<TimerEntry*>(list.next);
+            timer->unlink();
+            --wheelTimerCount;
+            insert(timer);
+        }
+    }
+};
 
 // implementation Timer
 
@@ -173,21 +403,114 @@ void TimerTargetCallback::cancel()
 // implementation of Scheduler
 
 Scheduler::Scheduler()
+: _wheel(new TimerWheel())
+, _performStub(new SchedulerPerformNode())
 {
-    // I don't expect to have more than 30 functions to all per frame
-    _functionsToPerform.reserve(30);
+    _performHead.store(_performStub, std::memory_order_relaxed);
+    _performTail = _performStub;
 }
 
 Scheduler::~Scheduler(void)
 {
     unscheduleAll();
+    delete _wheel;
+
+    removeAllFunctionsToBePerformedInCocosThread();
+    performFunctions();
+    delete _performStub;
+}
+
+Scheduler::TargetEntry* Scheduler::findTarget(void *target) const
+{
+    TargetEntry *entry = nullptr;
+    HASH_FIND_PTR(_wheel->targets, &target, entry);
+    return entry;
+}
+
+void Scheduler::removeTargetIfEmpty(TargetEntry *target)
+{
+    if (!target->timers.empty())
+        return;
+
+    if (target == _currentTarget)
+    {
+        _currentTargetSalvaged = true;
+        _currentTarget = nullptr;
+    }
+    _wheel->freeTarget(target);
+}
+
+Scheduler::TimerEntry* Scheduler::findTimer(TargetEntry *target, const std::string& key) const
+{
+    // a key no timer uses isn't interned
+    auto iter = _wheel->keys.find(key);
+    if (iter == _wheel->keys.end())
+        return nullptr;
+
+    for (auto *timer : target->timers)
+    {
+        if (timer->key == &*iter)
+            return timer;
+    }
+    return nullptr;
+}
+
+void Scheduler::cancelTimer(TimerEntry *timer)
+{
+    auto &timers = timer->target->timers;
+    timers.erase(std::find(timers.begin(), timers.end(), timer));
+
+    _wheel->remove(timer);
+    timer->state = TimerState::CANCELLED;
+    // a timer cancelled by a callback may be the one running
+    if (_wheel->isUpdating)
+        _wheel->cancelledTimers.pushBack(timer);
+    else
+        _wheel->freeTimer(timer);
+}
+
+void Scheduler::scheduleNext(TimerEntry *timer)
+{
+    if (!timer->useDelay && timer->interval <= 0)
+    {
+        timer->activatedUpdate = _wheel->updateCount;
+        timer->state = TimerState::FRAME;
+        _wheel->frameTimers.pushBack(timer);
+    }
+    else
+    {
+        _wheel->insert(timer);
+    }
 }
 
-void Scheduler::removeHashElement(_hashSelectorEntry *element)
+void Scheduler::setTimerInterval(TimerEntry *timer, float interval)
 {
-    ccArrayFree(element->timers);
-    HASH_DEL(_hashForTimers, element);
-    free(element);
+    const float oldInterval = timer->interval;
+    timer->interval = interval;
+    if (timer->useDelay)
+        return;
+
+    switch (timer->state)
+    {
+        case TimerState::WHEEL:
+            _wheel->remove(timer);
+            timer->dueTime = timer->lastTime + interval;
+            scheduleNext(timer);
+            break;
+        case TimerState::FRAME:
+            if (interval > 0)
+            {
+                timer->unlink();
+                timer->lastTime = _wheel->time;
+                timer->dueTime = _wheel->time + interval;
+                _wheel->insert(timer);
+            }
+            break;
+        case TimerState::PAUSED:
+            timer->remaining = std::max(timer->remaining + interval - oldInterval, 0.0);
+            break;
+        default: break; // the pending timer starts with it, the firing one picks it up
+    }
 }
 
 void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, bool paused, const std::string& key)
@@ -200,48 +523,38 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
     CCASSERT(target, "Argument target must be non-nullptr");
     CCASSERT(!key.empty(), "key should not be empty!");
 
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-
+    TargetEntry *element = findTarget(target);
     if (! element)
     {
-        element = (tHashTimerEntry *)calloc(sizeof(*element), 1);
-        element->target = target;
-
-        HASH_ADD_PTR(_hashForTimers, target, element);
-
         // Is this the 1st element ? Then set the pause level to all the selectors of this target
-        element->paused = paused;
+        element = _wheel->allocTarget(target, paused);
     }
     else
     {
         CCASSERT(element->paused == paused, "element's paused should be paused!");
-    }
 
-    if (element->timers == nullptr)
-    {
-        element->timers = ccArrayNew(10);
-    }
-    else
-    {
-        for (int i = 0; i < element->timers->num; ++i)
+        TimerEntry *timer = findTimer(element, key);
+        if (timer)
         {
-            TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers->arr[i]);
-
-            if (timer && key == timer->getKey())
-            {
-                CC_LOG_DEBUG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", timer->getInterval(), interval);
-                timer->setInterval(interval);
-                return;
-            }
+            CC_LOG_DEBUG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", timer->interval, interval);
+            setTimerInterval(timer, interval);
+            return;
         }
-        ccArrayEnsureExtraCapacity(element->timers, 1);
     }
 
-    TimerTargetCallback *timer = new (std::nothrow) TimerTargetCallback();
-    timer->initWithCallback(this, callback, target, key, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
-    timer->release();
+    TimerEntry *timer = _wheel->allocTimer();
+    timer->key = &*_wheel->keys.emplace(key, 0).first;
+    ++timer->key->second;
+    timer->target = element;
+    timer->callback = callback;
+    timer->interval = interval;
+    timer->delay = delay;
+    timer->useDelay = delay > 0.0f;
+    timer->repeat = repeat;
+    timer->timesExecuted = 0;
+    timer->state = TimerState::PENDING;
+    _wheel->pendingTimers.pushBack(timer);
+    element->timers.push_back(timer);
 }
 
 void Scheduler::unschedule(const std::string &key, void *target)
@@ -252,48 +565,14 @@ void Scheduler::unschedule(const std::string &key, void *target)
         return;
     }
 
-    //CCASSERT(target);
-    //CCASSERT(selector);
-
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-
+    TargetEntry *element = findTarget(target);
     if (element)
     {
-        for (int i = 0; i < element->timers->num; ++i)
+        TimerEntry *timer = findTimer(element, key);
+        if (timer)
         {
-            TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers->arr[i]);
-
-            if (timer && key == timer->getKey())
-            {
-                if (timer == element->currentTimer && (! element->currentTimerSalvaged))
-                {
-                    element->currentTimer->retain();
-                    element->currentTimerSalvaged = true;
-                }
-
-                ccArrayRemoveObjectAtIndex(element->timers, i, true);
-
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
-
-                if (element->timers->num == 0)
-                {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
-                }
-
-                return;
-            }
+            cancelTimer(timer);
+            removeTargetIfEmpty(element);
         }
     }
 }
@@ -303,45 +582,17 @@ bool Scheduler::isScheduled(const std::string& key, void *target)
     CCASSERT(!key.empty(), "Argument key must not be empty");
     CCASSERT(target, "Argument target must be non-nullptr");
 
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-
-    if (!element)
-    {
-        return false;
-    }
-
-    if (element->timers == nullptr)
-    {
-        return false;
-    }
-    else
-    {
-        for (int i = 0; i < element->timers->num; ++i)
-        {
-            TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers->arr[i]);
-
-            if (timer && key == timer->getKey())
-            {
-                return true;
-            }
-        }
-
-        return false;
-    }
-
-    return false;  // should never get here
+    TargetEntry *element = findTarget(target);
+    return element && findTimer(element, key);
 }
 
 void Scheduler::unscheduleAll()
 {
-    for (tHashTimerEntry *element = _hashForTimers, *nextElement = nullptr; element != nullptr;)
+    TargetEntry *element = nullptr;
+    TargetEntry *nextElement = nullptr;
+    HASH_ITER(hh, _wheel->targets, element, nextElement)
     {
-        // element may be removed in unscheduleAllSelectorsForTarget
-        nextElement = (tHashTimerEntry *)element->hh.next;
         unscheduleAllForTarget(element->target);
-        
-        element = nextElement;
     }
 }
 
@@ -353,28 +604,14 @@ void Scheduler::unscheduleAllForTarget(void *target)
         return;
     }
 
-    // Custom Selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-
+    TargetEntry *element = findTarget(target);
     if (element)
     {
-        if (ccArrayContainsObject(element->timers, element->currentTimer)
-            && (! element->currentTimerSalvaged))
+        while (!element->timers.empty())
         {
-            element->currentTimer->retain();
-            element->currentTimerSalvaged = true;
-        }
-        ccArrayRemoveAllObjects(element->timers);
-
-        if (_currentTarget == element)
-        {
-            _currentTargetSalvaged = true;
-        }
-        else
-        {
-            removeHashElement(element);
+            cancelTimer(element->timers.back());
         }
+        removeTargetIfEmpty(element);
     }
 }
 
@@ -382,12 +619,19 @@ void Scheduler::resumeTarget(void *target)
 {
     CCASSERT(target != nullptr, "target can't be nullptr!");
 
-    // custom selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    TargetEntry *element = findTarget(target);
+    if (element && element->paused)
     {
         element->paused = false;
+        for (auto *timer : element->timers)
+        {
+            if (timer->state == TimerState::PAUSED)
+            {
+                timer->dueTime = _wheel->time + timer->remaining;
+                timer->lastTime = timer->dueTime - (timer->useDelay ? timer->delay : timer->interval);
+                scheduleNext(timer);
+            }
+        }
     }
 }
 
@@ -395,12 +639,20 @@ void Scheduler::pauseTarget(void *target)
 {
     CCASSERT(target != nullptr, "target can't be nullptr!");
 
-    // custom selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    TargetEntry *element = findTarget(target);
+    if (element && !element->paused)
     {
         element->paused = true;
+        // the timers triggering every frame and the pending ones are skipped while it's paused
+        for (auto *timer : element->timers)
+        {
+            if (timer->state == TimerState::WHEEL)
+            {
+                _wheel->remove(timer);
+                timer->remaining = timer->dueTime - _wheel->time;
+                timer->state = TimerState::PAUSED;
+            }
+        }
     }
 }
 
@@ -408,29 +660,25 @@ bool Scheduler::isTargetPaused(void *target)
 {
     CCASSERT( target != nullptr, "target must be non nil" );
 
-    // Custom selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    if( element )
-    {
-        return element->paused;
-    }
-
-    return false;  // should never get here
+    TargetEntry *element = findTarget(target);
+    return element && element->paused;
 }
 
 std::set<void*> Scheduler::pauseAllTargets()
 {
     std::set<void*> idsWithSelectors;
-    
+
     // Custom Selectors
-    for(tHashTimerEntry *element = _hashForTimers; element != nullptr;
-        element = (tHashTimerEntry*)element->hh.next)
+    for (TargetEntry *element = _wheel->targets; element != nullptr;
+        element = (TargetEntry*)element->hh.next)
     {
-        element->paused = true;
         idsWithSelectors.insert(element->target);
     }
-    
+    for (auto *target : idsWithSelectors)
+    {
+        pauseTarget(target);
+    }
+
     return idsWithSelectors;
 }
 
@@ -443,81 +691,259 @@ void Scheduler::resumeTargets(const std::set<void*>& targetsToResume)
 
 void Scheduler::performFunctionInCocosThread(const std::function<void ()> &function)
 {
-    _performMutex.lock();
-    _functionsToPerform.push_back(function);
-    _performMutex.unlock();
+    SchedulerPerformNode *node = performNodeCache.acquire();
+    node->function = function;
+    node->sequence = _performSequence.fetch_add(1, std::memory_order_relaxed);
+    node->next.store(nullptr, std::memory_order_relaxed);
+
+    SchedulerPerformNode *prev = _performHead.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
 }
 
 void Scheduler::removeAllFunctionsToBePerformedInCocosThread()
 {
-    std::unique_lock<std::mutex> lock(_performMutex);
-    _functionsToPerform.clear();
+    // the queue is only popped by the cocos thread, the removed functions are skipped there
+    _performDiscardedSequence.store(_performSequence.load(std::memory_order_relaxed), std::memory_order_relaxed);
 }
 
-// main loop
-void Scheduler::update(float dt)
+// Vyukov's intrusive queue, returns nullptr while it's empty or a producer is in the middle of a push
+SchedulerPerformNode* Scheduler::popFunctionToPerform()
 {
-    _updateHashLocked = true;
+    SchedulerPerformNode *tail = _performTail;
+    SchedulerPerformNode *next = tail->next.load(std::memory_order_acquire);
+    if (tail == _performStub)
+    {
+        if (!next)
+            return nullptr;
+        _performTail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if (next)
+    {
+        _performTail = next;
+        return tail;
+    }
+    if (tail != _performHead.load(std::memory_order_acquire))
+        return nullptr;
 
-    // Iterate over all the custom selectors
-    for (tHashTimerEntry *elt = _hashForTimers; elt != nullptr; )
+    // the stub takes the place of the last node
+    _performStub->next.store(nullptr, std::memory_order_relaxed);
+    SchedulerPerformNode *prev = _performHead.exchange(_performStub, std::memory_order_acq_rel);
+    prev->next.store(_performStub, std::memory_order_release);
+
+    next = tail->next.load(std::memory_order_acquire);
+    if (next)
     {
-        _currentTarget = elt;
-        _currentTargetSalvaged = false;
+        _performTail = next;
+        return tail;
+    }
+    return nullptr;
+}
 
-        if (! _currentTarget->paused)
+void Scheduler::performFunctions()
+{
+    typedef std::chrono::steady_clock Clock;
+    const auto deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(_performTimeBudget));
+    // what the functions post runs with the next update
+    const uint64_t lastSequence = _performSequence.load(std::memory_order_relaxed);
+    bool hasPerformed = false;
+
+    SchedulerPerformNode *freeFirst = nullptr;
+    SchedulerPerformNode *freeLast = nullptr;
+    while (true)
+    {
+        SchedulerPerformNode *node = _performPostponed ? _performPostponed : popFunctionToPerform();
+        _performPostponed = nullptr;
+        if (!node)
+            break;
+
+        if (node->sequence >= _performDiscardedSequence.load(std::memory_order_relaxed))
         {
-            // The 'timers' array may change while inside this loop
-            for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex))
+            if (node->sequence >= lastSequence || (hasPerformed && _performTimeBudget > 0 && Clock::now() >= deadline))
             {
-                elt->currentTimer = (Timer*)(elt->timers->arr[elt->timerIndex]);
-                elt->currentTimerSalvaged = false;
+                _performPostponed = node;
+                break;
+            }
+            node->function();
+            hasPerformed = true;
+        }
+
+        node->function = nullptr;
+        node->freeNext = freeFirst;
+        freeFirst = node;
+        if (!freeLast)
+            freeLast = node;
+    }
 
-                elt->currentTimer->update(dt);
+    if (freeFirst)
+        releasePerformNodes(freeFirst, freeLast);
+}
 
-                if (elt->currentTimerSalvaged)
-                {
-                    // The currentTimer told the remove itself. To prevent the timer from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    elt->currentTimer->release();
-                }
+bool Scheduler::triggerTimer(TimerEntry *timer, float dt)
+{
+    _currentTarget = timer->target;
+    _currentTargetSalvaged = false;
+    timer->callback(dt);
+    _currentTarget = nullptr;
 
-                elt->currentTimer = nullptr;
-            }
+    if (timer->state == TimerState::CANCELLED)
+        return false;
+
+    timer->timesExecuted += 1;
+    if (timer->repeat != CC_REPEAT_FOREVER && timer->timesExecuted > timer->repeat)
+    {    //unschedule timer
+        TargetEntry *target = timer->target;
+        cancelTimer(timer);
+        removeTargetIfEmpty(target);
+        return false;
+    }
+    return true;
+}
+
+// Timers start with the first update after they were scheduled, which doesn't trigger them yet.
+void Scheduler::activatePendingTimers()
+{
+    TimerLink list;
+    TimerLink paused;
+    _wheel->pendingTimers.spliceTo(list);
+    while (!list.isEmpty())
+    {
+        auto *timer = static_cast<TimerEntry*>(list.next);
+        timer->unlink();
+        if (timer->target->paused)
+        {
+            paused.pushBack(timer);
+            continue;
         }
 
-        // elt, at this moment, is still valid
-        // so it is safe to ask this here (issue #490)
-        elt = (tHashTimerEntry *)elt->hh.next;
+        timer->lastTime = _wheel->time;
+        timer->dueTime = _wheel->time + (timer->useDelay ? timer->delay : timer->interval);
+        scheduleNext(timer);
+        timer->activatedUpdate = _wheel->updateCount;
+    }
+    paused.spliceTo(_wheel->pendingTimers);
+}
+
+void Scheduler::updateFrameTimers(float dt)
+{
+    TimerLink list;
+    _wheel->frameTimers.spliceTo(list);
+    while (!list.isEmpty())
+    {
+        auto *timer = static_cast<TimerEntry*>(list.next);
+        timer->unlink();
+        _wheel->frameTimers.pushBack(timer);
+
+        if (!timer->target->paused && timer->activatedUpdate != _wheel->updateCount)
+            triggerTimer(timer, dt);
+    }
+}
+
+void Scheduler::fireDueTimer(TimerEntry *timer)
+{
+    timer->state = TimerState::FIRING;
+    while (true)
+    {
+        timer->lastTime = timer->dueTime;
+        if (!triggerTimer(timer, timer->useDelay ? timer->delay : timer->interval))
+            return;
+        timer->useDelay = false;
+
+        // if interval == 0, should trigger once every frame
+        if (timer->interval <= 0 || timer->target->paused)
+            break;
+
+        timer->dueTime = timer->lastTime + timer->interval;
+        if (timer->dueTime > _wheel->time)
+            break;
+    }
+
+    if (timer->target->paused)
+    {
+        timer->dueTime = timer->lastTime + timer->interval;
+        timer->remaining = std::max(timer->dueTime - _wheel->time, 0.0);
+        timer->state = TimerState::PAUSED;
+    }
+    else
+    {
+        scheduleNext(timer);
+    }
+}
 
-        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (_currentTargetSalvaged && _currentTarget->timers->num == 0)
+void Scheduler::expireSlot(uint32_t level, uint32_t index, bool isPartial)
+{
+    TimerLink list;
+    TimerLink notDue;
+    _wheel->slots[level][index].spliceTo(list);
+    while (!list.isEmpty())
+    {
+        auto *timer = static_cast<TimerEntry*>(list.next);
+        timer->unlink();
+        // the last tick of the update is only partly elapsed
+        if (isPartial && timer->dueTime > _wheel->time)
         {
-            removeHashElement(_currentTarget);
+            notDue.pushBack(timer);
+            continue;
         }
+
+        --_wheel->wheelTimerCount;
+        fireDueTimer(timer);
     }
+    notDue.spliceTo(_wheel->slots[level][index]);
+}
 
-    _updateHashLocked = false;
-    _currentTarget = nullptr;
+void Scheduler::updateWheel()
+{
+    TimerWheel &wheel = *_wheel;
+    wheel.targetTick = static_cast<uint64_t>(std::floor(wheel.time * TICKS_PER_SECOND));
 
-    //
-    // Functions allocated from another thread
-    //
+    for (uint64_t tick = wheel.tick; tick <= wheel.targetTick; ++tick)
+    {
+        if (wheel.wheelTimerCount == 0)
+            break;
 
-    // Testing size is faster than locking / unlocking.
-    // And almost never there will be functions scheduled to be called.
-    if( !_functionsToPerform.empty() ) {
-        _performMutex.lock();
-        // fixed #4123: Save the callback functions, they must be invoked after '_performMutex.unlock()', otherwise if new functions are added in callback, it will cause thread deadlock.
-        auto temp = _functionsToPerform;
-        _functionsToPerform.clear();
-        _performMutex.unlock();
-        for( const auto &function : temp ) {
-            function();
+        wheel.tick = tick;
+        if ((tick & SLOT_MASK) == 0)
+        {
+            for (uint32_t level = 1; level < LEVEL_COUNT; ++level)
+            {
+                const auto index = static_cast<uint32_t>((tick >> (SLOT_BITS * level)) & SLOT_MASK);
+                wheel.cascade(level, index);
+                if (index != 0)
+                    break;
+            }
         }
+        expireSlot(0, static_cast<uint32_t>(tick & SLOT_MASK), tick == wheel.targetTick);
+    }
+    wheel.tick = wheel.targetTick;
+}
 
+// main loop
+void Scheduler::update(float dt)
+{
+    CC_PROFILE_ZONE("Scheduler::update");
+    TimerWheel &wheel = *_wheel;
+    wheel.time += dt;
+    ++wheel.updateCount;
+    wheel.isUpdating = true;
+
+    activatePendingTimers();
+    updateFrameTimers(dt);
+    updateWheel();
+
+    wheel.isUpdating = false;
+    while (!wheel.cancelledTimers.isEmpty())
+    {
+        auto *timer = static_cast<TimerEntry*>(wheel.cancelledTimers.next);
+        timer->unlink();
+        wheel.freeTimer(timer);
     }
+
+    //
+    // Functions allocated from another thread
+    //
+    performFunctions();
 }
 
 }
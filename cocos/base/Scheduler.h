@@ -27,9 +27,12 @@ THE SOFTWARE.
 ****************************************************************************/
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <mutex>
 #include <set>
+#include <string>
 
 #include "base/Ref.h"
 #include "base/Vector.h"
@@ -38,12 +41,17 @@ THE SOFTWARE.
 namespace cc {
 
 class Scheduler;
+struct SchedulerPerformNode;
 
 typedef std::function<void(float)> ccSchedulerFunc;
 
 /**
  * @cond
  */
+/**
+ * @deprecated The scheduler keeps its callbacks in a timer wheel and no longer creates timers.
+ * Timer is kept for code that drives its own timers, use Scheduler::schedule instead.
+ */
 class CC_DLL Timer : public Ref
 {
 public:
@@ -75,10 +83,13 @@ protected:
     float _interval = 0.f;
 };
 
+/**
+ * @deprecated Use Scheduler::schedule instead, cancel() unschedules the key from the scheduler.
+ */
 class CC_DLL TimerTargetCallback final : public Timer
 {
 public:
-    TimerTargetCallback();
+    CC_DEPRECATED_ATTRIBUTE TimerTargetCallback();
 
     // Initializes a timer with a target, a lambda and an interval in seconds, repeat in number of times to repeat, delay in seconds.
     bool initWithCallback(Scheduler* scheduler, const ccSchedulerFunc& callback, void *target, const std::string& key, float seconds, unsigned int repeat, float delay);
@@ -104,10 +115,6 @@ protected:
  * @{
  */
 
-struct _listEntry;
-struct _hashSelectorEntry;
-struct _hashUpdateEntry;
-
 /** @brief Scheduler is responsible for triggering the scheduled callbacks.
 You should not use system timer for your game logic. Instead, use this class.
 
@@ -118,6 +125,9 @@ There are 2 different types of callbacks (selectors):
 
 The 'custom selectors' should be avoided when possible. It is faster, and consumes less memory to use the 'update selector'.
 
+Timers with an interval wait in a hierarchical timer wheel of millisecond ticks, an update only touches the timers
+which are due. Timers and targets come from pools, keys are interned.
+
 */
 class CC_DLL Scheduler final
 {
@@ -285,25 +295,51 @@ public:
      * @js NA
      */
     void removeAllFunctionsToBePerformedInCocosThread();
-    
-    bool isCurrentTargetSalvaged () const { return _currentTargetSalvaged; };
 
-private:
-    void removeHashElement(struct _hashSelectorEntry *element);
-    void removeUpdateFromHash(struct _listEntry *entry);
+    /**
+     * Sets how long an update may spend on the functions of performFunctionInCocosThread, the rest waits for the
+     * next update. At least one function runs per update, 0 runs all of them.
+     * @param seconds The budget in seconds, 5 ms by default.
+     * @js NA
+     */
+    inline void setPerformFunctionsTimeBudget(float seconds) { _performTimeBudget = seconds; }
+    inline float getPerformFunctionsTimeBudget() const { return _performTimeBudget; }
 
-    // update specific
+    bool isCurrentTargetSalvaged () const { return _currentTargetSalvaged; };
 
-    // Used for "selectors with interval"
-    struct _hashSelectorEntry *_hashForTimers = nullptr;
-    struct _hashSelectorEntry *_currentTarget = nullptr;
+private:
+    struct TimerEntry;
+    struct TargetEntry;
+    struct TimerWheel;
+
+    TargetEntry *findTarget(void *target) const;
+    void removeTargetIfEmpty(TargetEntry *target);
+    TimerEntry *findTimer(TargetEntry *target, const std::string &key) const;
+    void cancelTimer(TimerEntry *timer);
+    void setTimerInterval(TimerEntry *timer, float interval);
+    void activatePendingTimers();
+    void updateFrameTimers(float dt);
+    void updateWheel();
+    void expireSlot(uint32_t level, uint32_t index, bool isPartial);
+    void fireDueTimer(TimerEntry *timer);
+    bool triggerTimer(TimerEntry *timer, float dt);
+    void scheduleNext(TimerEntry *timer);
+
+    SchedulerPerformNode *popFunctionToPerform();
+    void performFunctions();
+
+    TimerWheel *_wheel = nullptr;
+    TargetEntry *_currentTarget = nullptr; // target of the timer being triggered
     bool _currentTargetSalvaged = false;
-    // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
-    bool _updateHashLocked = false;
 
-    // Used for "perform Function"
-    std::vector<std::function<void()>> _functionsToPerform;
-    std::mutex _performMutex;
+    // Used for "perform Function", an intrusive queue with many producers and the cocos thread as consumer
+    std::atomic<SchedulerPerformNode*> _performHead{nullptr}; // pushed last
+    SchedulerPerformNode *_performTail = nullptr;             // popped next
+    SchedulerPerformNode *_performStub = nullptr;
+    SchedulerPerformNode *_performPostponed = nullptr;        // popped, but performed with the next update
+    std::atomic<uint64_t> _performSequence{0};
+    std::atomic<uint64_t> _performDiscardedSequence{0}; // functions before it were removed
+    float _performTimeBudget = 0.005f;
 };
 
 // end of base group
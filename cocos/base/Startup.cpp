@@ -0,0 +1,135 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/Startup.h"
+#include "base/Log.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace cc {
+
+namespace {
+
+struct Task {
+    std::string name;
+    std::thread thread;
+};
+
+const std::chrono::steady_clock::time_point BOOT_TIME = std::chrono::steady_clock::now();
+
+std::atomic<bool> isBootFinished{false};
+
+std::mutex phasesMutex;
+std::vector<Startup::PhaseRecord> phases;
+
+// only touched by the thread booting the engine
+std::vector<Task> tasks;
+
+float toMs(std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration<float, std::milli>(duration).count();
+}
+
+} // namespace
+
+Startup::Phase::Phase(const char *name, bool isAsync)
+: _isAsync(isAsync) {
+    if (isBootFinished.load(std::memory_order_relaxed)) return;
+    _name  = name;
+    _begin = std::chrono::steady_clock::now();
+}
+
+Startup::Phase::~Phase() {
+    if (!_name) return;
+
+    PhaseRecord record;
+    record.name       = _name;
+    record.beginMs    = toMs(_begin - BOOT_TIME);
+    record.durationMs = toMs(std::chrono::steady_clock::now() - _begin);
+    record.isAsync    = _isAsync;
+
+    std::lock_guard<std::mutex> lock(phasesMutex);
+    if (!isBootFinished.load(std::memory_order_relaxed)) phases.push_back(std::move(record));
+}
+
+void Startup::runAsync(const char *name, const std::function<void()> &task) {
+    if (isBootFinished) {
+        // nothing waits for the first frame anymore
+        task();
+        return;
+    }
+    tasks.push_back({name, std::thread([name, task]() {
+                         Phase phase(name, true);
+                         task();
+                     })});
+}
+
+void Startup::wait(const char *name) {
+    auto iter = std::find_if(tasks.begin(), tasks.end(), [name](const Task &task) { return task.name == name; });
+    if (iter == tasks.end()) return;
+
+    {
+        CC_STARTUP_PHASE("Wait");
+        iter->thread.join();
+    }
+    tasks.erase(iter);
+}
+
+void Startup::waitAll() {
+    if (tasks.empty()) return;
+
+    {
+        CC_STARTUP_PHASE("Wait");
+        for (auto &task : tasks) task.thread.join();
+    }
+    tasks.clear();
+}
+
+void Startup::finish() {
+    if (isBootFinished) return;
+    waitAll();
+
+    const float totalMs = toMs(std::chrono::steady_clock::now() - BOOT_TIME);
+    std::lock_guard<std::mutex> lock(phasesMutex);
+    isBootFinished = true;
+
+    std::vector<PhaseRecord> sorted = phases;
+    std::stable_sort(sorted.begin(), sorted.end(), [](const PhaseRecord &a, const PhaseRecord &b) { return a.beginMs < b.beginMs; });
+    CC_LOG_INFO("Startup: first frame after %.1f ms", totalMs);
+    for (const auto &phase : sorted) {
+        CC_LOG_INFO("Startup: %8.1f ms %8.1f ms %s%s", phase.beginMs, phase.durationMs, phase.name.c_str(), phase.isAsync ? " (async)" : "");
+    }
+}
+
+bool Startup::isFinished() {
+    return isBootFinished;
+}
+
+std::vector<Startup::PhaseRecord> Startup::getPhases() {
+    std::lock_guard<std::mutex> lock(phasesMutex);
+    return phases;
+}
+
+} // namespace cc
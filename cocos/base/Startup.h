@@ -0,0 +1,83 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "base/Macros.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace cc {
+
+/**
+ * Boot phase timing and the boot tasks which don't depend on each other.
+ * Phases are timed from the load of the engine library and logged together once the first frame was presented,
+ * later phases of the same names, such as the ones of a restart, are not recorded.
+ * Tasks run on threads of their own while the cocos thread goes on with the phases bound to it, such as the script
+ * engine and the device, and are joined at the latest before the first frame.
+ */
+class CC_DLL Startup {
+public:
+    struct PhaseRecord {
+        std::string name;
+        float beginMs = 0.F; // since the load of the engine library
+        float durationMs = 0.F;
+        bool isAsync = false;
+    };
+
+    // Times a phase of the calling thread until it goes out of scope.
+    class CC_DLL Phase {
+    public:
+        explicit Phase(const char *name, bool isAsync = false);
+        ~Phase();
+
+    private:
+        const char *_name = nullptr; // nullptr once the boot finished
+        bool _isAsync = false;
+        std::chrono::steady_clock::time_point _begin;
+    };
+
+    // Runs a task on a thread of its own, timed as a phase of the same name.
+    static void runAsync(const char *name, const std::function<void()> &task);
+    // Waits for the task of that name, returns at once if it finished or never ran.
+    static void wait(const char *name);
+    static void waitAll();
+
+    // Joins the tasks left and logs the phases, called once the first frame was presented. Later calls do nothing.
+    static void finish();
+    static bool isFinished();
+
+    // the phases ended so far, in the order they ended
+    static std::vector<PhaseRecord> getPhases();
+};
+
+} // namespace cc
+
+#define CC_STARTUP_CONCAT_(a, b) a##b
+#define CC_STARTUP_CONCAT(a, b)  CC_STARTUP_CONCAT_(a, b)
+
+#define CC_STARTUP_PHASE(name) cc::Startup::Phase CC_STARTUP_CONCAT(ccStartupPhase, __LINE__)(name)
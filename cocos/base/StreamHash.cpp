@@ -0,0 +1,189 @@
+#include "base/StreamHash.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace cc {
+namespace {
+const char *const HEX_DIGITS = "0123456789abcdef";
+
+// the platforms are little endian
+CC_INLINE uint32_t read32(const uint8_t *p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+CC_INLINE uint64_t read64(const uint8_t *p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+CC_INLINE uint32_t rotl32(uint32_t x, int r) { return (x << r) | (x >> (32 - r)); }
+CC_INLINE uint64_t rotl64(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+// RFC 1321
+const uint32_t MD5_K[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391,
+};
+const int MD5_SHIFTS[16] = {7, 12, 17, 22, 5, 9, 14, 20, 4, 11, 16, 23, 6, 10, 15, 21};
+
+// XXH64 of xxHash by Yann Collet
+const uint64_t XXH_PRIME64_1 = 0x9E3779B185EBCA87ULL;
+const uint64_t XXH_PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t XXH_PRIME64_3 = 0x165667B19E3779F9ULL;
+const uint64_t XXH_PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+const uint64_t XXH_PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+CC_INLINE uint64_t xxhRound(uint64_t acc, uint64_t input) {
+    acc += input * XXH_PRIME64_2;
+    return rotl64(acc, 31) * XXH_PRIME64_1;
+}
+
+CC_INLINE uint64_t xxhMergeRound(uint64_t acc, uint64_t value) {
+    acc ^= xxhRound(0, value);
+    return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+} // namespace
+
+StreamHash *StreamHash::create(const std::string &algorithm) {
+    if (algorithm == "md5") return new (std::nothrow) MD5Hash();
+    if (algorithm == "xxh64") return new (std::nothrow) XXH64Hash();
+    return nullptr;
+}
+
+bool StreamHash::isSupported(const std::string &algorithm) {
+    return algorithm == "md5" || algorithm == "xxh64";
+}
+
+MD5Hash::MD5Hash() : _state{0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476} {}
+
+void MD5Hash::transform(const uint8_t *block) {
+    uint32_t a = _state[0], b = _state[1], c = _state[2], d = _state[3];
+    for (int i = 0; i < 64; ++i) {
+        uint32_t f;
+        int g;
+        if (i < 16) {
+            f = (b & c) | (~b & d);
+            g = i;
+        } else if (i < 32) {
+            f = (d & b) | (~d & c);
+            g = (5 * i + 1) & 15;
+        } else if (i < 48) {
+            f = b ^ c ^ d;
+            g = (3 * i + 5) & 15;
+        } else {
+            f = c ^ (b | ~d);
+            g = (7 * i) & 15;
+        }
+        const uint32_t rotated = rotl32(a + f + MD5_K[i] + read32(block + g * 4), MD5_SHIFTS[(i >> 4) * 4 + (i & 3)]);
+        a = d;
+        d = c;
+        c = b;
+        b += rotated;
+    }
+    _state[0] += a;
+    _state[1] += b;
+    _state[2] += c;
+    _state[3] += d;
+}
+
+void MD5Hash::update(const void *data, size_t len) {
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    size_t used = static_cast<size_t>(_length & 63);
+    _length += len;
+    if (used) {
+        const size_t count = std::min(len, 64 - used);
+        memcpy(_block + used, bytes, count);
+        bytes += count;
+        len -= count;
+        if (used + count < 64) return;
+        transform(_block);
+    }
+    for (; len >= 64; bytes += 64, len -= 64) transform(bytes);
+    if (len) memcpy(_block, bytes, len);
+}
+
+std::string MD5Hash::hexDigest() {
+    uint8_t padding[72] = {0x80};
+    const uint64_t bits = _length * 8;
+    const size_t used = static_cast<size_t>(_length & 63);
+    const size_t padLength = (used < 56 ? 56 : 120) - used;
+    memcpy(padding + padLength, &bits, sizeof(bits));
+    update(padding, padLength + sizeof(bits));
+
+    std::string digest(32, '0');
+    const auto *bytes = reinterpret_cast<const uint8_t *>(_state);
+    for (int i = 0; i < 16; ++i) {
+        digest[i * 2] = HEX_DIGITS[bytes[i] >> 4];
+        digest[i * 2 + 1] = HEX_DIGITS[bytes[i] & 15];
+    }
+    return digest;
+}
+
+XXH64Hash::XXH64Hash() : _acc{XXH_PRIME64_1 + XXH_PRIME64_2, XXH_PRIME64_2, 0, 0 - XXH_PRIME64_1} {}
+
+void XXH64Hash::update(const void *data, size_t len) {
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    size_t used = static_cast<size_t>(_length & 31);
+    _length += len;
+    const auto consume = [this](const uint8_t *stripe) {
+        for (int i = 0; i < 4; ++i) _acc[i] = xxhRound(_acc[i], read64(stripe + i * 8));
+    };
+    if (used) {
+        const size_t count = std::min(len, 32 - used);
+        memcpy(_stripe + used, bytes, count);
+        bytes += count;
+        len -= count;
+        if (used + count < 32) return;
+        consume(_stripe);
+    }
+    for (; len >= 32; bytes += 32, len -= 32) consume(bytes);
+    if (len) memcpy(_stripe, bytes, len);
+}
+
+uint64_t XXH64Hash::digest() const {
+    uint64_t h;
+    if (_length >= 32) {
+        h = rotl64(_acc[0], 1) + rotl64(_acc[1], 7) + rotl64(_acc[2], 12) + rotl64(_acc[3], 18);
+        for (uint64_t acc : _acc) h = xxhMergeRound(h, acc);
+    } else {
+        h = _acc[2] + XXH_PRIME64_5; // the seed
+    }
+    h += _length;
+
+    const uint8_t *p = _stripe;
+    size_t remain = static_cast<size_t>(_length & 31);
+    for (; remain >= 8; p += 8, remain -= 8) h = rotl64(h ^ xxhRound(0, read64(p)), 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+    if (remain >= 4) {
+        h = rotl64(h ^ (read32(p) * XXH_PRIME64_1), 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+        p += 4;
+        remain -= 4;
+    }
+    for (; remain; ++p, --remain) h = rotl64(h ^ (*p * XXH_PRIME64_5), 11) * XXH_PRIME64_1;
+
+    h ^= h >> 33;
+    h *= XXH_PRIME64_2;
+    h ^= h >> 29;
+    h *= XXH_PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+std::string XXH64Hash::hexDigest() {
+    uint64_t h = digest();
+    std::string hex(16, '0');
+    for (int i = 15; i >= 0; --i, h >>= 4) hex[i] = HEX_DIGITS[h & 15];
+    return hex;
+}
+
+} // namespace cc
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "base/Macros.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace cc {
+
+// A digest computed from data arriving in pieces, e.g. a file while it's downloaded.
+class CC_DLL StreamHash {
+public:
+    // "md5" or "xxh64" (XXH64 with seed 0), nullptr for an unknown algorithm
+    static StreamHash *create(const std::string &algorithm);
+    static bool isSupported(const std::string &algorithm);
+
+    virtual ~StreamHash() = default;
+
+    virtual void update(const void *data, size_t len) = 0;
+    // The lowercase hex digest of the data so far, the hash can't be updated after.
+    virtual std::string hexDigest() = 0;
+};
+
+class CC_DLL MD5Hash final : public StreamHash {
+public:
+    MD5Hash();
+
+    void update(const void *data, size_t len) override;
+    std::string hexDigest() override;
+
+private:
+    void transform(const uint8_t *block);
+
+    uint32_t _state[4];
+    uint64_t _length = 0;
+    uint8_t _block[64];
+};
+
+class CC_DLL XXH64Hash final : public StreamHash {
+public:
+    XXH64Hash();
+
+    void update(const void *data, size_t len) override;
+    std::string hexDigest() override;
+    // The digest as a number, hexDigest() is its big endian hex.
+    uint64_t digest() const;
+
+private:
+    uint64_t _acc[4];
+    uint64_t _length = 0;
+    uint8_t _stripe[32];
+};
+
+} // namespace cc
@@ -0,0 +1,218 @@
+#include "base/ThreadConfig.h"
+#include "base/Log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+#if CC_PLATFORM == CC_PLATFORM_ANDROID
+    #include <sched.h>
+    #include <sys/resource.h>
+    #include <unistd.h>
+#elif CC_PLATFORM == CC_PLATFORM_MAC_IOS || CC_PLATFORM == CC_PLATFORM_MAC_OSX
+    #include <pthread.h>
+#elif CC_PLATFORM == CC_PLATFORM_WINDOWS
+    #include <windows.h>
+#endif
+
+namespace cc {
+
+namespace {
+
+uint32_t getCoreCount() {
+    const uint32_t count = std::thread::hardware_concurrency();
+    return std::min(std::max(count, 1u), 64u);
+}
+
+uint32_t countBits(uint64_t mask) {
+    uint32_t count = 0;
+    for (; mask; mask &= mask - 1) ++count;
+    return count;
+}
+
+struct CoreMasks {
+    uint64_t all = 0;
+    uint64_t big = 0;
+    uint64_t little = 0;
+};
+
+// Cores with the highest maximum frequency are big, the others little.
+CoreMasks detectCoreMasks() {
+    CoreMasks masks;
+    const uint32_t coreCount = getCoreCount();
+    masks.all = coreCount == 64 ? ~0ULL : (1ULL << coreCount) - 1;
+    masks.big = masks.little = masks.all;
+
+#if CC_PLATFORM == CC_PLATFORM_ANDROID
+    uint32_t frequencies[64] = {0};
+    uint32_t maxFrequency = 0;
+    uint32_t minFrequency = ~0u;
+    for (uint32_t i = 0; i < coreCount; ++i) {
+        char path[96];
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cpufreq/cpuinfo_max_freq", i);
+        FILE *file = fopen(path, "r");
+        if (!file) return masks; // offline cores hide theirs, treat the device as homogeneous
+        if (fscanf(file, "%u", &frequencies[i]) != 1) frequencies[i] = 0;
+        fclose(file);
+        maxFrequency = std::max(maxFrequency, frequencies[i]);
+        minFrequency = std::min(minFrequency, frequencies[i]);
+    }
+    if (!maxFrequency || maxFrequency == minFrequency) return masks;
+
+    masks.big = masks.little = 0;
+    for (uint32_t i = 0; i < coreCount; ++i) {
+        (frequencies[i] == maxFrequency ? masks.big : masks.little) |= 1ULL << i;
+    }
+#endif
+    return masks;
+}
+
+const CoreMasks &getCoreMasks() {
+    static CoreMasks masks = detectCoreMasks();
+    return masks;
+}
+
+#if CC_PLATFORM == CC_PLATFORM_ANDROID
+struct LaneThreads {
+    std::mutex mutex;
+    std::vector<int32_t> ids[static_cast<uint8_t>(ThreadLane::COUNT)];
+    std::atomic<uint32_t> generation{0};
+};
+
+// never destroyed, threads may still exit while the statics go at shutdown
+LaneThreads &getLaneThreads() {
+    static auto *threads = new LaneThreads();
+    return *threads;
+}
+
+// Takes the calling thread out of its lane again when it exits.
+struct LaneThread {
+    ThreadLane lane = ThreadLane::COUNT;
+
+    ~LaneThread() { setLane(ThreadLane::COUNT); }
+
+    void setLane(ThreadLane newLane) {
+        if (newLane == lane) return;
+        LaneThreads &threads = getLaneThreads();
+        std::lock_guard<std::mutex> lock(threads.mutex);
+        const int32_t id = gettid();
+        if (lane != ThreadLane::COUNT) {
+            auto &ids = threads.ids[static_cast<uint8_t>(lane)];
+            ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+        }
+        if (newLane != ThreadLane::COUNT) {
+            threads.ids[static_cast<uint8_t>(newLane)].push_back(id);
+        }
+        lane = newLane;
+        threads.generation.fetch_add(1);
+    }
+};
+
+thread_local LaneThread tLaneThread;
+#endif
+
+ThreadLaneConfig getDefaultConfig(ThreadLane lane) {
+    ThreadLaneConfig config;
+    if (lane == ThreadLane::CPU) {
+        config.priority = ThreadPriority::NORMAL;
+        config.affinity = CoreAffinity::BIG;
+    } else {
+        config.priority = ThreadPriority::LOW;
+        config.affinity = CoreAffinity::LITTLE;
+    }
+    return config;
+}
+
+} // namespace
+
+ThreadLaneConfig ThreadConfig::_configs[] = {
+    getDefaultConfig(ThreadLane::CPU),
+    getDefaultConfig(ThreadLane::IO),
+};
+
+void ThreadConfig::setLaneConfig(ThreadLane lane, const ThreadLaneConfig &config) {
+    _configs[static_cast<uint8_t>(lane)] = config;
+}
+
+const ThreadLaneConfig &ThreadConfig::getLaneConfig(ThreadLane lane) {
+    return _configs[static_cast<uint8_t>(lane)];
+}
+
+uint32_t ThreadConfig::getThreadCount(ThreadLane lane) {
+    const ThreadLaneConfig &config = getLaneConfig(lane);
+    if (config.threadCount) return config.threadCount;
+
+    const uint32_t coreCount = countBits(getCoreMask(config.affinity));
+    if (lane == ThreadLane::CPU) {
+        // the main and the render thread keep a core each, the main thread executes jobs too
+        return coreCount > 2 ? coreCount - 2 : 1;
+    }
+    // IO threads block most of the time, a few are enough
+    return std::min(std::max(coreCount, 2u), 4u);
+}
+
+uint64_t ThreadConfig::getCoreMask(CoreAffinity affinity) {
+    const CoreMasks &masks = getCoreMasks();
+    switch (affinity) {
+        case CoreAffinity::BIG: return masks.big;
+        case CoreAffinity::LITTLE: return masks.little;
+        default: return masks.all;
+    }
+}
+
+void ThreadConfig::applyToCurrentThread(ThreadLane lane) {
+    const ThreadLaneConfig &config = getLaneConfig(lane);
+
+#if CC_PLATFORM == CC_PLATFORM_ANDROID
+    tLaneThread.setLane(lane);
+
+    static const int NICE_VALUES[] = {10, 0, -4}; // background, default, display in android.os.Process terms
+    if (setpriority(PRIO_PROCESS, gettid(), NICE_VALUES[static_cast<uint8_t>(config.priority)]) != 0) {
+        CC_LOG_DEBUG("ThreadConfig: setting the priority of thread %d failed.", gettid());
+    }
+
+    const uint64_t mask = getCoreMask(config.affinity);
+    if (mask != getCoreMask(CoreAffinity::ANY)) {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        for (uint32_t i = 0; i < 64; ++i) {
+            if (mask & (1ULL << i)) CPU_SET(i, &cpuSet);
+        }
+        if (sched_setaffinity(gettid(), sizeof(cpuSet), &cpuSet) != 0) {
+            CC_LOG_DEBUG("ThreadConfig: pinning thread %d failed.", gettid());
+        }
+    }
+#elif CC_PLATFORM == CC_PLATFORM_MAC_IOS || CC_PLATFORM == CC_PLATFORM_MAC_OSX
+    // the scheduler places threads on the performance or the efficiency cores by their quality of service
+    static const qos_class_t QOS_CLASSES[] = {QOS_CLASS_UTILITY, QOS_CLASS_DEFAULT, QOS_CLASS_USER_INITIATED};
+    pthread_set_qos_class_self_np(QOS_CLASSES[static_cast<uint8_t>(config.priority)], 0);
+#elif CC_PLATFORM == CC_PLATFORM_WINDOWS
+    static const int PRIORITIES[] = {THREAD_PRIORITY_BELOW_NORMAL, THREAD_PRIORITY_NORMAL, THREAD_PRIORITY_ABOVE_NORMAL};
+    SetThreadPriority(GetCurrentThread(), PRIORITIES[static_cast<uint8_t>(config.priority)]);
+#else
+    CC_UNUSED_PARAM(config);
+#endif
+}
+
+std::vector<int32_t> ThreadConfig::getThreadIds(ThreadLane lane) {
+#if CC_PLATFORM == CC_PLATFORM_ANDROID
+    LaneThreads &threads = getLaneThreads();
+    std::lock_guard<std::mutex> lock(threads.mutex);
+    return threads.ids[static_cast<uint8_t>(lane)];
+#else
+    CC_UNUSED_PARAM(lane);
+    return {};
+#endif
+}
+
+uint32_t ThreadConfig::getThreadGeneration() {
+#if CC_PLATFORM == CC_PLATFORM_ANDROID
+    return getLaneThreads().generation.load();
+#else
+    return 0;
+#endif
+}
+
+} // namespace cc
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "base/Config.h"
+#include "base/Macros.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace cc {
+
+// The kinds of background threads. CPU runs the compute jobs of JobSystem, IO runs the blocking tasks of the
+// default ThreadPool: file and network access, audio decoding and the tasks of AsyncTaskPool.
+enum class ThreadLane : uint8_t {
+    CPU,
+    IO,
+    COUNT,
+};
+
+enum class ThreadPriority : uint8_t {
+    LOW,
+    NORMAL,
+    HIGH,
+};
+
+// Cores to keep the threads of a lane on, BIG and LITTLE only differ on heterogeneous Android devices.
+enum class CoreAffinity : uint8_t {
+    ANY,
+    BIG,
+    LITTLE,
+};
+
+struct ThreadLaneConfig {
+    uint32_t threadCount = 0; // 0 derives it from the core count
+    ThreadPriority priority = ThreadPriority::NORMAL;
+    CoreAffinity affinity = CoreAffinity::ANY;
+};
+
+/**
+ * Thread counts, priorities and core affinities of the background lanes. The configuration is read when the threads
+ * of a lane start, set it before JobSystem and the default ThreadPool are first used.
+ */
+class CC_DLL ThreadConfig {
+public:
+    static void setLaneConfig(ThreadLane lane, const ThreadLaneConfig &config);
+    static const ThreadLaneConfig &getLaneConfig(ThreadLane lane);
+
+    // The thread count of the lane, resolved against the cores it's allowed on.
+    static uint32_t getThreadCount(ThreadLane lane);
+
+    // Applies the priority and the affinity of the lane to the calling thread, what the platform doesn't support is ignored.
+    static void applyToCurrentThread(ThreadLane lane);
+
+    // Kernel ids of the running threads which applied the lane, for the performance hint sessions. Android only,
+    // empty elsewhere.
+    static std::vector<int32_t> getThreadIds(ThreadLane lane);
+    // Changes whenever such a thread starts or exits.
+    static uint32_t getThreadGeneration();
+
+    // Masks of the big and the little cores, both hold every core on homogeneous devices and other platforms.
+    static uint64_t getCoreMask(CoreAffinity affinity);
+
+private:
+    static ThreadLaneConfig _configs[static_cast<uint8_t>(ThreadLane::COUNT)];
+};
+
+} // namespace cc
@@ -26,6 +26,7 @@
  ****************************************************************************/
 
 #include "base/ThreadPool.h"
+#include "base/ThreadConfig.h"
 #include "platform/StdC.h"
 #include <memory>
 #include <chrono>
@@ -42,7 +43,6 @@
 
 namespace cc {
 
-#define DEFAULT_THREAD_POOL_MIN_NUM (4)
 #define DEFAULT_THREAD_POOL_MAX_NUM (20)
 
 #define DEFAULT_SHRINK_INTERVAL (5.0f)
@@ -55,7 +55,8 @@ ThreadPool *ThreadPool::getDefaultThreadPool()
 {
     if (__defaultThreadPool == nullptr)
     {
-        __defaultThreadPool = newCachedThreadPool(DEFAULT_THREAD_POOL_MIN_NUM,
+        // idle threads shrink back to the count of the IO lane
+        __defaultThreadPool = newCachedThreadPool(static_cast<int>(ThreadConfig::getThreadCount(ThreadLane::IO)),
                                                   DEFAULT_THREAD_POOL_MAX_NUM,
                                                   DEFAULT_SHRINK_INTERVAL, DEFAULT_SHRINK_STEP,
                                                   DEFAULT_STRETCH_STEP);
@@ -84,9 +85,9 @@ ThreadPool *ThreadPool::newCachedThreadPool(int minThreadNum, int maxThreadNum,
     return pool;
 }
 
-ThreadPool *ThreadPool::newFixedThreadPool(int threadNum)
+ThreadPool *ThreadPool::newFixedThreadPool(int threadNum, ThreadLane lane)
 {
-    ThreadPool *pool = new(std::nothrow) ThreadPool(threadNum, threadNum);
+    ThreadPool *pool = new(std::nothrow) ThreadPool(threadNum, threadNum, lane);
     if (pool != nullptr)
     {
         pool->setFixedSize(true);
@@ -104,11 +105,11 @@ ThreadPool *ThreadPool::newSingleThreadPool()
     return pool;
 }
 
-ThreadPool::ThreadPool(int minNum, int maxNum)
+ThreadPool::ThreadPool(int minNum, int maxNum, ThreadLane lane)
         : _isDone(false), _isStop(false), _idleThreadNum(0), _minThreadNum(minNum),
           _maxThreadNum(maxNum), _initedThreadNum(0), _shrinkInterval(DEFAULT_SHRINK_INTERVAL),
           _shrinkStep(DEFAULT_SHRINK_STEP), _stretchStep(DEFAULT_STRETCH_STEP),
-          _isFixedSize(false)
+          _isFixedSize(false), _lane(lane)
 {
     init();
 }
@@ -395,6 +396,7 @@ void ThreadPool::setThread(int tid)
             _abortFlags[tid]); // a copy of the shared ptr to the flag
     auto f = [this, tid, abort_ptr/* a copy of the shared ptr to the abort */]() {
         std::atomic<bool>& abort = *abort_ptr;
+        ThreadConfig::applyToCurrentThread(_lane);
         Task task;
         bool isPop = _taskQueue.pop(task);
         while (true)
@@ -26,6 +26,7 @@
  ****************************************************************************/
 #pragma once
 
+#include "base/ThreadConfig.h"
 #include "base/Utils.h"
 
 #include <functional>
@@ -45,6 +46,10 @@ namespace cc {
  * @{
  */
 
+/*
+ * Runs blocking tasks, its threads take the priority and the affinity of the IO lane of ThreadConfig.
+ * Short compute work goes to JobSystem instead, or to a fixed pool on the CPU lane.
+ */
 class CC_DLL ThreadPool
 {
 public:
@@ -76,10 +81,10 @@ public:
                                            int shrinkStep, int stretchStep);
 
     /*
-     * Creates a thread pool with fixed thread count
+     * Creates a thread pool with fixed thread count, its threads take the priority and the affinity of the lane
      * @note The return value has to be delete while it doesn't needed
      */
-    static ThreadPool *newFixedThreadPool(int threadNum);
+    static ThreadPool *newFixedThreadPool(int threadNum, ThreadLane lane = ThreadLane::IO);
 
     /*
      * Creates a thread pool with only one thread in the pool, it could be used to execute multiply tasks serially in just one thread.
@@ -128,7 +133,7 @@ public:
     bool tryShrinkPool();
 
 private:
-    ThreadPool(int minNum, int maxNum);
+    ThreadPool(int minNum, int maxNum, ThreadLane lane = ThreadLane::IO);
 
     ThreadPool(const ThreadPool&);
 
@@ -229,6 +234,7 @@ private:
     int _shrinkStep;
     int _stretchStep;
     bool _isFixedSize;
+    ThreadLane _lane;
 };
 
 // end of base group
@@ -31,6 +31,12 @@
 #include <stdarg.h>
 #include <stdlib.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && (defined(__arm64__) || defined(__aarch64__))
+#include <arm_neon.h>
+#endif
+
 namespace cc {
 
 namespace StringUtils {
@@ -218,9 +224,112 @@ CC_DLL void UTF8LooseFix(const std::string &in, std::string &out)
 }
 
 
+namespace {
+
+// Widens the ASCII bytes the text starts with, returns how many there are.
+size_t widenASCII(const UTF8* src, size_t length, UTF16* dst)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= length; i += 16)
+    {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        if (_mm_movemask_epi8(bytes))
+            break;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi8(bytes, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpackhi_epi8(bytes, zero));
+    }
+#elif defined(__ARM_NEON) && (defined(__arm64__) || defined(__aarch64__))
+    for (; i + 16 <= length; i += 16)
+    {
+        const uint8x16_t bytes = vld1q_u8(src + i);
+        if (vmaxvq_u8(bytes) >= 0x80)
+            break;
+        vst1q_u16(dst + i, vmovl_u8(vget_low_u8(bytes)));
+        vst1q_u16(dst + i + 8, vmovl_high_u8(bytes));
+    }
+#endif
+    for (; i < length && src[i] < 0x80; ++i)
+        dst[i] = src[i];
+    return i;
+}
+
+// Narrows the ASCII code units the text starts with, returns how many there are.
+size_t narrowASCII(const UTF16* src, size_t length, UTF8* dst)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i nonASCII = _mm_set1_epi16(static_cast<short>(0xFF80));
+    for (; i + 16 <= length; i += 16)
+    {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+        const __m128i high = _mm_and_si128(_mm_or_si128(lo, hi), nonASCII);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xFFFF)
+            break;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+    }
+#elif defined(__ARM_NEON) && (defined(__arm64__) || defined(__aarch64__))
+    for (; i + 16 <= length; i += 16)
+    {
+        const uint16x8_t lo = vld1q_u16(src + i);
+        const uint16x8_t hi = vld1q_u16(src + i + 8);
+        if (vmaxvq_u16(vorrq_u16(lo, hi)) >= 0x80)
+            break;
+        vst1q_u8(dst + i, vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+    }
+#endif
+    for (; i < length && src[i] < 0x80; ++i)
+        dst[i] = static_cast<UTF8>(src[i]);
+    return i;
+}
+
+} // namespace
+
+// The runs of ASCII are copied 16 characters a time, the strict conversion of ConvertUTF validates the others a run
+// at a time. An ASCII element is never part of another character, so a run ends at the first one.
 bool UTF8ToUTF16(const std::string& utf8, std::u16string& outUtf16)
 {
-    return utfConvert(utf8, outUtf16, ConvertUTF8toUTF16);
+    const size_t length = utf8.length();
+    if (!length)
+    {
+        outUtf16.clear();
+        return true;
+    }
+
+    // a byte makes one code unit at most
+    std::u16string working(length, 0);
+    const UTF8* src = reinterpret_cast<const UTF8*>(utf8.data());
+    UTF16* dst = reinterpret_cast<UTF16*>(&working[0]);
+    UTF16* const dstEnd = dst + length;
+    size_t in = 0;
+    size_t out = 0;
+    while (true)
+    {
+        const size_t count = widenASCII(src + in, length - in, dst + out);
+        in += count;
+        out += count;
+        if (in == length)
+            break;
+
+        size_t end = in + 1;
+        while (end < length && src[end] >= 0x80)
+            ++end;
+        const UTF8* inBegin = src + in;
+        UTF16* outBegin = dst + out;
+        if (ConvertUTF8toUTF16(&inBegin, src + end, &outBegin, dstEnd, strictConversion) != conversionOK)
+            return false;
+        in = end;
+        out = outBegin - dst;
+        if (in == length)
+            break;
+    }
+
+    working.resize(out);
+    outUtf16 = std::move(working);
+    return true;
 }
 
 bool UTF8ToUTF32(const std::string& utf8, std::u32string& outUtf32)
@@ -230,7 +339,44 @@ bool UTF8ToUTF32(const std::string& utf8, std::u32string& outUtf32)
 
 bool UTF16ToUTF8(const std::u16string& utf16, std::string& outUtf8)
 {
-    return utfConvert(utf16, outUtf8, ConvertUTF16toUTF8);
+    const size_t length = utf16.length();
+    if (!length)
+    {
+        outUtf8.clear();
+        return true;
+    }
+
+    // a code unit makes three bytes at most, a surrogate pair four
+    std::string working(length * 3, 0);
+    const UTF16* src = reinterpret_cast<const UTF16*>(utf16.data());
+    UTF8* dst = reinterpret_cast<UTF8*>(&working[0]);
+    UTF8* const dstEnd = dst + working.length();
+    size_t in = 0;
+    size_t out = 0;
+    while (true)
+    {
+        const size_t count = narrowASCII(src + in, length - in, dst + out);
+        in += count;
+        out += count;
+        if (in == length)
+            break;
+
+        size_t end = in + 1;
+        while (end < length && src[end] >= 0x80)
+            ++end;
+        const UTF16* inBegin = src + in;
+        UTF8* outBegin = dst + out;
+        if (ConvertUTF16toUTF8(&inBegin, src + end, &outBegin, dstEnd, strictConversion) != conversionOK)
+            return false;
+        in = end;
+        out = outBegin - dst;
+        if (in == length)
+            break;
+    }
+
+    working.resize(out);
+    outUtf8 = std::move(working);
+    return true;
 }
     
 bool UTF16ToUTF32(const std::u16string& utf16, std::u32string& outUtf32)
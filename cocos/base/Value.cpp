@@ -32,6 +32,7 @@
 #include <float.h>
 #include <stdlib.h>
 #include <memory.h>
+#include <string.h>
 
 
 namespace cc {
@@ -85,20 +86,23 @@ Value::Value(bool v)
 }
 
 Value::Value(const char* v)
-: _type(Type::STRING)
+: _type(Type::NONE)
 {
-    _field.strVal = new (std::nothrow) std::string();
-    if (v)
-    {
-        *_field.strVal = v;
-    }
+    setString(v ? v : "", v ? strlen(v) : 0);
+    _type = Type::STRING;
 }
 
 Value::Value(const std::string& v)
-: _type(Type::STRING)
+: _type(Type::NONE)
+{
+    setString(v.data(), v.size());
+    _type = Type::STRING;
+}
+
+Value::Value(std::string&& v)
+: _type(Type::NONE)
 {
-    _field.strVal = new (std::nothrow) std::string();
-    *_field.strVal = v;
+    *this = std::move(v);
 }
 
 Value::Value(const ValueVector& v)
@@ -185,11 +189,7 @@ Value& Value::operator= (const Value& other)
                 _field.boolVal = other._field.boolVal;
                 break;
             case Type::STRING:
-                if (_field.strVal == nullptr)
-                {
-                    _field.strVal = new std::string();
-                }
-                *_field.strVal = *other._field.strVal;
+                setString(other.getStringData(), other.getStringLength());
                 break;
             case Type::VECTOR:
                 if (_field.vectorVal == nullptr)
@@ -245,7 +245,8 @@ Value& Value::operator= (Value&& other)
                 _field.boolVal = other._field.boolVal;
                 break;
             case Type::STRING:
-                _field.strVal = other._field.strVal;
+                _field = other._field;
+                _isShortString = other._isShortString;
                 break;
             case Type::VECTOR:
                 _field.vectorVal = other._field.vectorVal;
@@ -263,6 +264,7 @@ Value& Value::operator= (Value&& other)
 
         memset(&other._field, 0, sizeof(other._field));
         other._type = Type::NONE;
+        other._isShortString = false;
     }
 
     return *this;
@@ -313,14 +315,30 @@ Value& Value::operator= (bool v)
 Value& Value::operator= (const char* v)
 {
     reset(Type::STRING);
-    *_field.strVal = v ? v : "";
+    setString(v ? v : "", v ? strlen(v) : 0);
     return *this;
 }
 
 Value& Value::operator= (const std::string& v)
 {
     reset(Type::STRING);
-    *_field.strVal = v;
+    setString(v.data(), v.size());
+    return *this;
+}
+
+Value& Value::operator= (std::string&& v)
+{
+    if (v.size() <= SHORT_STRING_CAPACITY)
+    {
+        reset(Type::STRING);
+        setString(v.data(), v.size());
+    }
+    else
+    {
+        clear();
+        _field.strVal = new (std::nothrow) std::string(std::move(v));
+        _type = Type::STRING;
+    }
     return *this;
 }
 
@@ -391,7 +409,7 @@ bool Value::operator== (const Value& v) const
         case Type::INTEGER: return v._field.intVal      == this->_field.intVal;
         case Type::UNSIGNED:return v._field.unsignedVal == this->_field.unsignedVal;
         case Type::BOOLEAN: return v._field.boolVal     == this->_field.boolVal;
-        case Type::STRING:  return *v._field.strVal     == *this->_field.strVal;
+        case Type::STRING:  return v.getStringLength() == this->getStringLength() && memcmp(v.getStringData(), this->getStringData(), this->getStringLength()) == 0;
         case Type::FLOAT:   return std::abs(v._field.floatVal  - this->_field.floatVal)  <= FLT_EPSILON;
         case Type::DOUBLE:  return std::abs(v._field.doubleVal - this->_field.doubleVal) <= DBL_EPSILON;
         case Type::VECTOR:
@@ -466,7 +484,7 @@ unsigned char Value::asByte() const
 
     if (_type == Type::STRING)
     {
-        return static_cast<unsigned char>(atoi(_field.strVal->c_str()));
+        return static_cast<unsigned char>(atoi(getStringData()));
     }
 
     if (_type == Type::FLOAT)
@@ -508,7 +526,7 @@ int Value::asInt() const
 
     if (_type == Type::STRING)
     {
-        return atoi(_field.strVal->c_str());
+        return atoi(getStringData());
     }
 
     if (_type == Type::FLOAT)
@@ -552,7 +570,7 @@ unsigned int Value::asUnsignedInt() const
     if (_type == Type::STRING)
     {
         // NOTE: strtoul is required (need to augment on unsupported platforms)
-        return static_cast<unsigned int>(strtoul(_field.strVal->c_str(), nullptr, 10));
+        return static_cast<unsigned int>(strtoul(getStringData(), nullptr, 10));
     }
 
     if (_type == Type::FLOAT)
@@ -588,7 +606,7 @@ float Value::asFloat() const
 
     if (_type == Type::STRING)
     {
-        return utils::atof(_field.strVal->c_str());
+        return utils::atof(getStringData());
     }
 
     if (_type == Type::INTEGER)
@@ -629,7 +647,7 @@ double Value::asDouble() const
 
     if (_type == Type::STRING)
     {
-        return static_cast<double>(utils::atof(_field.strVal->c_str()));
+        return static_cast<double>(utils::atof(getStringData()));
     }
 
     if (_type == Type::INTEGER)
@@ -670,7 +688,7 @@ bool Value::asBool() const
 
     if (_type == Type::STRING)
     {
-        return (*_field.strVal == "0" || *_field.strVal == "false") ? false : true;
+        return (strcmp(getStringData(), "0") == 0 || strcmp(getStringData(), "false") == 0) ? false : true;
     }
 
     if (_type == Type::INTEGER)
@@ -702,7 +720,7 @@ std::string Value::asString() const
 
     if (_type == Type::STRING)
     {
-        return *_field.strVal;
+        return _isShortString ? std::string(_field.shortStrVal) : *_field.strVal;
     }
 
     std::stringstream ret;
@@ -889,7 +907,11 @@ void Value::clear()
             _field.boolVal = false;
             break;
         case Type::STRING:
-            CC_SAFE_DELETE(_field.strVal);
+            if (!_isShortString)
+            {
+                CC_SAFE_DELETE(_field.strVal);
+            }
+            _isShortString = false;
             break;
         case Type::VECTOR:
             CC_SAFE_DELETE(_field.vectorVal);
@@ -918,7 +940,8 @@ void Value::reset(Type type)
     switch (type)
     {
         case Type::STRING:
-            _field.strVal = new (std::nothrow) std::string();
+            _field.shortStrVal[0] = '\0';
+            _isShortString = true;
             break;
         case Type::VECTOR:
             _field.vectorVal = new (std::nothrow) ValueVector();
@@ -936,5 +959,39 @@ void Value::reset(Type type)
     _type = type;
 }
 
+void Value::setString(const char* data, size_t length)
+{
+    // a short string is null terminated, one holding nulls of its own keeps its length in a String
+    const bool isShort = length <= SHORT_STRING_CAPACITY && memchr(data, '\0', length) == nullptr;
+    if (isShort)
+    {
+        if (_type == Type::STRING && !_isShortString)
+        {
+            CC_SAFE_DELETE(_field.strVal);
+        }
+        memmove(_field.shortStrVal, data, length);
+        _field.shortStrVal[length] = '\0';
+    }
+    else if (_type == Type::STRING && !_isShortString)
+    {
+        _field.strVal->assign(data, length);
+    }
+    else
+    {
+        _field.strVal = new (std::nothrow) std::string(data, length);
+    }
+    _isShortString = isShort;
+}
+
+const char* Value::getStringData() const
+{
+    return _isShortString ? _field.shortStrVal : _field.strVal->c_str();
+}
+
+size_t Value::getStringLength() const
+{
+    return _isShortString ? strlen(_field.shortStrVal) : _field.strVal->size();
+}
+
 }
 
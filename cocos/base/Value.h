@@ -73,6 +73,8 @@ public:
 
     /** Create a Value by a string. */
     explicit Value(const String &v);
+    /** Create a Value by a string. It will use std::move internally. */
+    explicit Value(String &&v);
 
     /** Create a Value by a ValueVector object. */
     explicit Value(const ValueVector &v);
@@ -118,6 +120,8 @@ public:
     Value &operator=(const char *v);
     /** Assignment operator, assign from string to Value. */
     Value &operator=(const String &v);
+    /** Assignment operator, assign from string to Value. It will use std::move internally. */
+    Value &operator=(String &&v);
 
     /** Assignment operator, assign from ValueVector to Value. */
     Value &operator=(const ValueVector &v);
@@ -212,8 +216,14 @@ public:
     String getDescription() const;
 
 private:
+    // Strings up to this length are stored in the Value itself instead of a String of their own.
+    static constexpr size_t SHORT_STRING_CAPACITY = 15;
+
     void clear();
     void reset(Type type);
+    void setString(const char *data, size_t length);
+    const char *getStringData() const;
+    size_t getStringLength() const;
 
     union {
         unsigned char byteVal;
@@ -224,12 +234,14 @@ private:
         bool boolVal;
 
         String *strVal;
+        char shortStrVal[SHORT_STRING_CAPACITY + 1];
         ValueVector *vectorVal;
         ValueMap *mapVal;
         ValueMapIntKey *intKeyMapVal;
     } _field;
 
     Type _type;
+    bool _isShortString = false;
 };
 
 } // namespace cc
@@ -37,8 +37,14 @@
 #include <assert.h>
 #include <stdlib.h>
 
+#if CC_USE_FAST_COMPRESSION
+#include "lz4frame.h"
+#include "zstd.h"
+#endif
+
 #include "base/Data.h"
 #include "platform/FileUtils.h"
+#include <algorithm>
 #include <map>
 
 // IDEA: Other platforms should use upstream minizip like mingw-w64
@@ -500,10 +506,23 @@ void ZipUtils::setPvrEncryptionKey(unsigned int keyPart1, unsigned int keyPart2,
 
 static const std::string emptyFilename("");
 
+// records of the zip format, see APPNOTE.TXT
+static const uint32_t ZIP_LOCAL_SIGNATURE = 0x04034b50;
+static const uint32_t ZIP_CENTRAL_SIGNATURE = 0x02014b50;
+static const uint32_t ZIP_END_SIGNATURE = 0x06054b50;
+static const uint32_t ZIP_LOCAL_SIZE = 30;
+static const uint32_t ZIP_CENTRAL_SIZE = 46;
+static const uint32_t ZIP_END_SIZE = 22;
+static const uint16_t ZIP_STORED = 0;
+
 struct ZipEntryInfo
 {
     unz_file_pos pos;
     uLong uncompressed_size;
+    // only set for entries of a mapped archive
+    uLong compressed_size;
+    uLong local_header_offset;
+    uint16_t method;
 };
 
 class ZipFilePrivate
@@ -511,11 +530,83 @@ class ZipFilePrivate
 public:
     unzFile zipFile;
 
+    // the archive, read without minizip once its central directory is indexed
+    MappedFile mappedFile;
+    bool isIndexed = false;
+
     // std::unordered_map is faster if available on the platform
     typedef std::unordered_map<std::string, struct ZipEntryInfo> FileListContainer;
     FileListContainer fileList;
 };
 
+static inline uint16_t readZipUInt16(const unsigned char *p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t readZipUInt32(const unsigned char *p)
+{
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// the compressed data of an entry in the mapped archive, behind its local header
+static const unsigned char *getMappedEntryData(const ZipFilePrivate *data, const ZipEntryInfo &entry)
+{
+    const unsigned char *bytes = data->mappedFile.getBytes();
+    const uLong size = static_cast<uLong>(data->mappedFile.getSize());
+    if (entry.local_header_offset + ZIP_LOCAL_SIZE > size)
+        return nullptr;
+
+    const unsigned char *header = bytes + entry.local_header_offset;
+    if (readZipUInt32(header) != ZIP_LOCAL_SIGNATURE)
+        return nullptr;
+
+    const uLong offset = entry.local_header_offset + ZIP_LOCAL_SIZE + readZipUInt16(header + 26) + readZipUInt16(header + 28);
+    if (offset + entry.compressed_size > size)
+        return nullptr;
+    return bytes + offset;
+}
+
+// Inflates a raw deflate stream. Without a callback the output buffer has to hold the whole file,
+// otherwise it is handed to the callback whenever it is full.
+static bool inflateZipEntry(const unsigned char *in, uLong inSize, unsigned char *out, uLong outSize, const ZipFile::ChunkCallback &callback)
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+        return false;
+
+    stream.next_in = const_cast<Bytef *>(in);
+    stream.avail_in = static_cast<uInt>(inSize);
+    bool succeeded = true;
+    int err = Z_OK;
+    while (err != Z_STREAM_END)
+    {
+        stream.next_out = out;
+        stream.avail_out = static_cast<uInt>(outSize);
+        err = inflate(&stream, callback ? Z_NO_FLUSH : Z_FINISH);
+        if (err != Z_OK && err != Z_STREAM_END)
+        {
+            succeeded = false;
+            break;
+        }
+
+        const uLong produced = outSize - stream.avail_out;
+        if (!callback)
+        {
+            succeeded = err == Z_STREAM_END && produced == outSize;
+            break;
+        }
+        if (produced && !callback(out, static_cast<ssize_t>(produced)))
+        {
+            succeeded = false;
+            break;
+        }
+    }
+    inflateEnd(&stream);
+    return succeeded;
+}
+
 ZipFile *ZipFile::createWithBuffer(const void* buffer, uLong size)
 {
     ZipFile *zip = new (std::nothrow) ZipFile();
@@ -537,6 +628,7 @@ ZipFile::ZipFile(const std::string &zipFile, const std::string &filter)
 : _data(new ZipFilePrivate)
 {
     _data->zipFile = unzOpen(FileUtils::getInstance()->getSuitableFOpen(zipFile).c_str());
+    _data->mappedFile = FileUtils::getInstance()->mapFile(zipFile);
     setFilter(filter);
 }
 
@@ -556,6 +648,8 @@ bool ZipFile::setFilter(const std::string &filter)
     do
     {
         CC_BREAK_IF(!_data);
+        if (indexMappedArchive(filter))
+            return true;
         CC_BREAK_IF(!_data->zipFile);
 
         // clear existing file list
@@ -596,6 +690,79 @@ bool ZipFile::setFilter(const std::string &filter)
     return ret;
 }
 
+bool ZipFile::indexMappedArchive(const std::string &filter)
+{
+    _data->isIndexed = false;
+    const unsigned char *bytes = _data->mappedFile.getBytes();
+    const uLong size = static_cast<uLong>(_data->mappedFile.getSize());
+    if (!bytes || size < ZIP_END_SIZE)
+        return false;
+
+    // the end of central directory record is only followed by a comment of at most 64KB
+    const unsigned char *end = nullptr;
+    const uLong lowest = size > ZIP_END_SIZE + 0xFFFF ? size - ZIP_END_SIZE - 0xFFFF : 0;
+    for (uLong offset = size - ZIP_END_SIZE + 1; offset-- > lowest;)
+    {
+        if (readZipUInt32(bytes + offset) == ZIP_END_SIGNATURE)
+        {
+            end = bytes + offset;
+            break;
+        }
+    }
+    if (!end)
+        return false;
+
+    // zip64 archives are left to minizip
+    const uint16_t count = readZipUInt16(end + 10);
+    const uint32_t directorySize = readZipUInt32(end + 12);
+    const uint32_t directoryOffset = readZipUInt32(end + 16);
+    if (count == 0xFFFF || directoryOffset == 0xFFFFFFFF || static_cast<uLong>(directoryOffset) + directorySize > size)
+        return false;
+
+    ZipFilePrivate::FileListContainer fileList;
+    fileList.reserve(count);
+    const unsigned char *record = bytes + directoryOffset;
+    const unsigned char *directoryEnd = record + directorySize;
+    for (uint16_t i = 0; i < count; ++i)
+    {
+        if (record + ZIP_CENTRAL_SIZE > directoryEnd || readZipUInt32(record) != ZIP_CENTRAL_SIGNATURE)
+            return false;
+
+        const uint16_t flags = readZipUInt16(record + 8);
+        const uint16_t method = readZipUInt16(record + 10);
+        const uint32_t compressedSize = readZipUInt32(record + 20);
+        const uint32_t uncompressedSize = readZipUInt32(record + 24);
+        const uint16_t nameLength = readZipUInt16(record + 28);
+        const uint32_t recordSize = ZIP_CENTRAL_SIZE + nameLength + readZipUInt16(record + 30) + readZipUInt16(record + 32);
+        const uint32_t localHeaderOffset = readZipUInt32(record + 42);
+        if (record + recordSize > directoryEnd)
+            return false;
+        // encrypted, zip64 and entries compressed other than by deflate need minizip
+        if ((flags & 1) || (method != ZIP_STORED && method != Z_DEFLATED) ||
+            compressedSize == 0xFFFFFFFF || uncompressedSize == 0xFFFFFFFF || localHeaderOffset == 0xFFFFFFFF ||
+            (method == ZIP_STORED && compressedSize != uncompressedSize))
+            return false;
+
+        std::string currentFileName(reinterpret_cast<const char *>(record + ZIP_CENTRAL_SIZE), nameLength);
+        // cache info about filtered files only (like 'assets/')
+        if (filter.empty() || currentFileName.compare(0, filter.length(), filter) == 0)
+        {
+            ZipEntryInfo entry;
+            memset(&entry, 0, sizeof(entry));
+            entry.uncompressed_size = uncompressedSize;
+            entry.compressed_size = compressedSize;
+            entry.local_header_offset = localHeaderOffset;
+            entry.method = method;
+            fileList[currentFileName] = entry;
+        }
+        record += recordSize;
+    }
+
+    _data->fileList.swap(fileList);
+    _data->isIndexed = true;
+    return true;
+}
+
 bool ZipFile::fileExists(const std::string &fileName) const
 {
     bool ret = false;
@@ -617,7 +784,6 @@ unsigned char *ZipFile::getFileData(const std::string &fileName, ssize_t *size)
 
     do
     {
-        CC_BREAK_IF(!_data->zipFile);
         CC_BREAK_IF(fileName.empty());
 
         ZipFilePrivate::FileListContainer::const_iterator it = _data->fileList.find(fileName);
@@ -625,6 +791,31 @@ unsigned char *ZipFile::getFileData(const std::string &fileName, ssize_t *size)
 
         ZipEntryInfo fileInfo = it->second;
 
+        if (_data->isIndexed)
+        {
+            const unsigned char *data = getMappedEntryData(_data, fileInfo);
+            CC_BREAK_IF(!data);
+
+            buffer = (unsigned char*)malloc(fileInfo.uncompressed_size ? fileInfo.uncompressed_size : 1);
+            CC_BREAK_IF(!buffer);
+            if (fileInfo.method == ZIP_STORED)
+            {
+                memcpy(buffer, data, fileInfo.uncompressed_size);
+            }
+            else if (!inflateZipEntry(data, fileInfo.compressed_size, buffer, fileInfo.uncompressed_size, nullptr))
+            {
+                free(buffer);
+                buffer = nullptr;
+                break;
+            }
+            if (size)
+            {
+                *size = fileInfo.uncompressed_size;
+            }
+            break;
+        }
+
+        CC_BREAK_IF(!_data->zipFile);
         int nRet = unzGoToFilePos(_data->zipFile, &fileInfo.pos);
         CC_BREAK_IF(UNZ_OK != nRet);
 
@@ -650,7 +841,6 @@ bool ZipFile::getFileData(const std::string &fileName, ResizableBuffer* buffer)
     bool res = false;
     do
     {
-        CC_BREAK_IF(!_data->zipFile);
         CC_BREAK_IF(fileName.empty());
 
         ZipFilePrivate::FileListContainer::const_iterator it = _data->fileList.find(fileName);
@@ -658,6 +848,31 @@ bool ZipFile::getFileData(const std::string &fileName, ResizableBuffer* buffer)
 
         ZipEntryInfo fileInfo = it->second;
 
+        if (_data->isIndexed)
+        {
+            // inflated straight into the buffer of the caller
+            const unsigned char *data = getMappedEntryData(_data, fileInfo);
+            CC_BREAK_IF(!data);
+
+            buffer->resize(fileInfo.uncompressed_size);
+            unsigned char *out = static_cast<unsigned char*>(buffer->buffer());
+            if (!fileInfo.uncompressed_size)
+            {
+                res = true;
+            }
+            else if (fileInfo.method == ZIP_STORED)
+            {
+                memcpy(out, data, fileInfo.uncompressed_size);
+                res = true;
+            }
+            else
+            {
+                res = inflateZipEntry(data, fileInfo.compressed_size, out, fileInfo.uncompressed_size, nullptr);
+            }
+            break;
+        }
+
+        CC_BREAK_IF(!_data->zipFile);
         int nRet = unzGoToFilePos(_data->zipFile, &fileInfo.pos);
         CC_BREAK_IF(UNZ_OK != nRet);
 
@@ -674,6 +889,69 @@ bool ZipFile::getFileData(const std::string &fileName, ResizableBuffer* buffer)
     return res;
 }
 
+MappedFile ZipFile::mapFile(const std::string &fileName)
+{
+    auto it = _data->fileList.find(fileName);
+    if (it == _data->fileList.end() || !it->second.uncompressed_size)
+        return MappedFile();
+
+    if (_data->isIndexed && it->second.method == ZIP_STORED)
+    {
+        const unsigned char *data = getMappedEntryData(_data, it->second);
+        if (!data)
+            return MappedFile();
+        return MappedFile(data, static_cast<ssize_t>(it->second.uncompressed_size), nullptr);
+    }
+
+    ssize_t size = 0;
+    unsigned char *buffer = getFileData(fileName, &size);
+    if (!buffer)
+        return MappedFile();
+    return MappedFile(buffer, size, [buffer]() { free(buffer); });
+}
+
+bool ZipFile::readFileChunks(const std::string &fileName, unsigned char *chunk, ssize_t chunkSize, const ChunkCallback &callback)
+{
+    auto it = _data->fileList.find(fileName);
+    if (it == _data->fileList.end() || !chunk || chunkSize <= 0 || !callback)
+        return false;
+
+    ZipEntryInfo fileInfo = it->second;
+    if (_data->isIndexed)
+    {
+        const unsigned char *data = getMappedEntryData(_data, fileInfo);
+        if (!data)
+            return false;
+        if (fileInfo.method != ZIP_STORED)
+            return inflateZipEntry(data, fileInfo.compressed_size, chunk, static_cast<uLong>(chunkSize), callback);
+
+        // stored chunks point into the archive
+        for (uLong offset = 0; offset < fileInfo.uncompressed_size; offset += chunkSize)
+        {
+            const uLong size = std::min(static_cast<uLong>(chunkSize), fileInfo.uncompressed_size - offset);
+            if (!callback(data + offset, static_cast<ssize_t>(size)))
+                return false;
+        }
+        return true;
+    }
+
+    if (!_data->zipFile || unzGoToFilePos(_data->zipFile, &fileInfo.pos) != UNZ_OK || unzOpenCurrentFile(_data->zipFile) != UNZ_OK)
+        return false;
+
+    bool succeeded = true;
+    int size = 0;
+    while ((size = unzReadCurrentFile(_data->zipFile, chunk, static_cast<unsigned int>(chunkSize))) > 0)
+    {
+        if (!callback(chunk, size))
+        {
+            succeeded = false;
+            break;
+        }
+    }
+    unzCloseCurrentFile(_data->zipFile);
+    return succeeded && size == 0;
+}
+
 std::string ZipFile::getFirstFilename()
 {
     if (unzGoToFirstFile(_data->zipFile) != UNZ_OK) return emptyFilename;
@@ -715,4 +993,285 @@ bool ZipFile::initWithBuffer(const void *buffer, uLong size)
     return true;
 }
 
+#if CC_USE_FAST_COMPRESSION
+
+// --------------------- LZ4 and zstd ---------------------
+
+namespace {
+// output grows by this much while decompressing frames which don't record their size
+constexpr size_t DECOMPRESS_CHUNK_SIZE = 64 * 1024;
+
+Data toData(const std::vector<unsigned char> &bytes)
+{
+    Data data;
+    if (!bytes.empty()) data.copy(bytes.data(), static_cast<ssize_t>(bytes.size()));
+    return data;
+}
+
+LZ4F_preferences_t lz4Preferences(int level, size_t contentSize)
+{
+    LZ4F_preferences_t preferences;
+    memset(&preferences, 0, sizeof(preferences));
+    preferences.compressionLevel = level;
+    preferences.frameInfo.contentSize = contentSize;
+    return preferences;
+}
+
+ZSTD_CCtx *createZstdCompressContext(int level, const Data *dictionary, int workers)
+{
+    ZSTD_CCtx *context = ZSTD_createCCtx();
+    if (!context) return nullptr;
+    ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, level);
+    // fails without ZSTD_MULTITHREAD, which compresses on the calling thread
+    if (workers > 0) ZSTD_CCtx_setParameter(context, ZSTD_c_nbWorkers, workers);
+    if (dictionary && !dictionary->isNull() &&
+        ZSTD_isError(ZSTD_CCtx_loadDictionary(context, dictionary->getBytes(), dictionary->getSize()))) {
+        ZSTD_freeCCtx(context);
+        return nullptr;
+    }
+    return context;
+}
+
+ZSTD_DCtx *createZstdDecompressContext(const Data *dictionary)
+{
+    ZSTD_DCtx *context = ZSTD_createDCtx();
+    if (!context) return nullptr;
+    if (dictionary && !dictionary->isNull() &&
+        ZSTD_isError(ZSTD_DCtx_loadDictionary(context, dictionary->getBytes(), dictionary->getSize()))) {
+        ZSTD_freeDCtx(context);
+        return nullptr;
+    }
+    return context;
+}
+} // namespace
+
+Data ZipUtils::compressLZ4(const unsigned char *in, ssize_t inLength, int level)
+{
+    Data ret;
+    if (!in || inLength < 0) return ret;
+
+    LZ4F_preferences_t preferences = lz4Preferences(level, static_cast<size_t>(inLength));
+    size_t bound = LZ4F_compressFrameBound(inLength, &preferences);
+    auto *out = static_cast<unsigned char *>(malloc(bound));
+    if (!out) return ret;
+
+    size_t outLength = LZ4F_compressFrame(out, bound, in, inLength, &preferences);
+    if (LZ4F_isError(outLength)) {
+        CC_LOG_DEBUG("ZipUtils: LZ4 compression failed: %s", LZ4F_getErrorName(outLength));
+        free(out);
+        return ret;
+    }
+    ret.fastSet(out, static_cast<ssize_t>(outLength));
+    return ret;
+}
+
+Data ZipUtils::decompressLZ4(const unsigned char *in, ssize_t inLength)
+{
+    std::vector<unsigned char> out;
+    DecompressStream stream(CompressionCodec::LZ4);
+    if (!in || !stream.update(in, inLength, out) || !stream.isFinished()) return Data();
+    return toData(out);
+}
+
+Data ZipUtils::compressZstd(const unsigned char *in, ssize_t inLength, int level, const Data *dictionary, int workers)
+{
+    Data ret;
+    if (!in || inLength < 0) return ret;
+
+    ZSTD_CCtx *context = createZstdCompressContext(level, dictionary, workers);
+    if (!context) return ret;
+
+    size_t bound = ZSTD_compressBound(inLength);
+    auto *out = static_cast<unsigned char *>(malloc(bound));
+    size_t outLength = out ? ZSTD_compress2(context, out, bound, in, inLength) : 0;
+    ZSTD_freeCCtx(context);
+    if (!out || ZSTD_isError(outLength)) {
+        if (out) CC_LOG_DEBUG("ZipUtils: zstd compression failed: %s", ZSTD_getErrorName(outLength));
+        free(out);
+        return ret;
+    }
+    ret.fastSet(out, static_cast<ssize_t>(outLength));
+    return ret;
+}
+
+Data ZipUtils::decompressZstd(const unsigned char *in, ssize_t inLength, const Data *dictionary)
+{
+    Data ret;
+    if (!in || inLength <= 0) return ret;
+
+    unsigned long long contentSize = ZSTD_getFrameContentSize(in, inLength);
+    if (contentSize == ZSTD_CONTENTSIZE_ERROR) return ret;
+    if (contentSize == ZSTD_CONTENTSIZE_UNKNOWN) {
+        // written by a stream
+        std::vector<unsigned char> out;
+        DecompressStream stream(CompressionCodec::ZSTD, dictionary);
+        if (!stream.update(in, inLength, out) || !stream.isFinished()) return ret;
+        return toData(out);
+    }
+
+    ZSTD_DCtx *context = createZstdDecompressContext(dictionary);
+    if (!context) return ret;
+    auto *out = static_cast<unsigned char *>(malloc(contentSize > 0 ? contentSize : 1));
+    size_t outLength = out ? ZSTD_decompressDCtx(context, out, contentSize, in, inLength) : 0;
+    ZSTD_freeDCtx(context);
+    if (!out || ZSTD_isError(outLength)) {
+        if (out) CC_LOG_DEBUG("ZipUtils: zstd decompression failed: %s", ZSTD_getErrorName(outLength));
+        free(out);
+        return ret;
+    }
+    ret.fastSet(out, static_cast<ssize_t>(outLength));
+    return ret;
+}
+
+CompressStream::CompressStream(CompressionCodec codec, int level, const Data *dictionary, int workers)
+: _codec(codec),
+  _level(level)
+{
+    if (_codec == CompressionCodec::LZ4) {
+        LZ4F_cctx *context = nullptr;
+        if (!LZ4F_isError(LZ4F_createCompressionContext(&context, LZ4F_VERSION))) _context = context;
+    } else {
+        _context = createZstdCompressContext(level, dictionary, workers);
+    }
+}
+
+CompressStream::~CompressStream()
+{
+    if (!_context) return;
+    if (_codec == CompressionCodec::LZ4) {
+        LZ4F_freeCompressionContext(static_cast<LZ4F_cctx *>(_context));
+    } else {
+        ZSTD_freeCCtx(static_cast<ZSTD_CCtx *>(_context));
+    }
+}
+
+bool CompressStream::update(const unsigned char *in, ssize_t inLength, std::vector<unsigned char> &out)
+{
+    if (!_context || inLength < 0) return false;
+
+    if (_codec == CompressionCodec::LZ4) {
+        auto *context = static_cast<LZ4F_cctx *>(_context);
+        LZ4F_preferences_t preferences = lz4Preferences(_level, 0);
+        size_t offset = out.size();
+        out.resize(offset + LZ4F_HEADER_SIZE_MAX + LZ4F_compressBound(inLength, &preferences));
+        if (!_isStarted) {
+            size_t headerLength = LZ4F_compressBegin(context, out.data() + offset, LZ4F_HEADER_SIZE_MAX, &preferences);
+            if (LZ4F_isError(headerLength)) return false;
+            offset += headerLength;
+            _isStarted = true;
+        }
+        size_t written = LZ4F_compressUpdate(context, out.data() + offset, out.size() - offset, in, inLength, nullptr);
+        if (LZ4F_isError(written)) return false;
+        out.resize(offset + written);
+        return true;
+    }
+
+    auto *context = static_cast<ZSTD_CCtx *>(_context);
+    ZSTD_inBuffer input = {in, static_cast<size_t>(inLength), 0};
+    while (input.pos < input.size) {
+        size_t offset = out.size();
+        out.resize(offset + ZSTD_CStreamOutSize());
+        ZSTD_outBuffer output = {out.data() + offset, out.size() - offset, 0};
+        size_t result = ZSTD_compressStream2(context, &output, &input, ZSTD_e_continue);
+        out.resize(offset + output.pos);
+        if (ZSTD_isError(result)) return false;
+    }
+    _isStarted = true;
+    return true;
+}
+
+bool CompressStream::finish(std::vector<unsigned char> &out)
+{
+    if (!_context) return false;
+
+    if (_codec == CompressionCodec::LZ4) {
+        if (!_isStarted && !update(nullptr, 0, out)) return false;
+        auto *context = static_cast<LZ4F_cctx *>(_context);
+        LZ4F_preferences_t preferences = lz4Preferences(_level, 0);
+        size_t offset = out.size();
+        out.resize(offset + LZ4F_compressBound(0, &preferences));
+        size_t written = LZ4F_compressEnd(context, out.data() + offset, out.size() - offset, nullptr);
+        if (LZ4F_isError(written)) return false;
+        out.resize(offset + written);
+        return true;
+    }
+
+    auto *context = static_cast<ZSTD_CCtx *>(_context);
+    ZSTD_inBuffer input = {nullptr, 0, 0};
+    size_t remaining = 0;
+    do {
+        size_t offset = out.size();
+        out.resize(offset + ZSTD_CStreamOutSize());
+        ZSTD_outBuffer output = {out.data() + offset, out.size() - offset, 0};
+        remaining = ZSTD_compressStream2(context, &output, &input, ZSTD_e_end);
+        out.resize(offset + output.pos);
+        if (ZSTD_isError(remaining)) return false;
+    } while (remaining > 0);
+    return true;
+}
+
+DecompressStream::DecompressStream(CompressionCodec codec, const Data *dictionary)
+: _codec(codec)
+{
+    if (_codec == CompressionCodec::LZ4) {
+        LZ4F_dctx *context = nullptr;
+        if (!LZ4F_isError(LZ4F_createDecompressionContext(&context, LZ4F_VERSION))) _context = context;
+    } else {
+        _context = createZstdDecompressContext(dictionary);
+    }
+}
+
+DecompressStream::~DecompressStream()
+{
+    if (!_context) return;
+    if (_codec == CompressionCodec::LZ4) {
+        LZ4F_freeDecompressionContext(static_cast<LZ4F_dctx *>(_context));
+    } else {
+        ZSTD_freeDCtx(static_cast<ZSTD_DCtx *>(_context));
+    }
+}
+
+bool DecompressStream::update(const unsigned char *in, ssize_t inLength, std::vector<unsigned char> &out)
+{
+    if (!_context || inLength < 0) return false;
+
+    // loops while there is input left or the last chunk of output was filled, decoders hold back what doesn't fit
+    size_t consumed = 0;
+    bool isOutputFull = false;
+    while (!_isFinished && (consumed < static_cast<size_t>(inLength) || isOutputFull)) {
+        size_t offset = out.size();
+        out.resize(offset + DECOMPRESS_CHUNK_SIZE);
+
+        size_t written = 0;
+        size_t result = 0;
+        if (_codec == CompressionCodec::LZ4) {
+            size_t srcLength = inLength - consumed;
+            written = DECOMPRESS_CHUNK_SIZE;
+            result = LZ4F_decompress(static_cast<LZ4F_dctx *>(_context), out.data() + offset, &written, in + consumed, &srcLength, nullptr);
+            if (LZ4F_isError(result)) {
+                out.resize(offset);
+                return false;
+            }
+            consumed += srcLength;
+        } else {
+            ZSTD_inBuffer input = {in + consumed, inLength - consumed, 0};
+            ZSTD_outBuffer output = {out.data() + offset, DECOMPRESS_CHUNK_SIZE, 0};
+            result = ZSTD_decompressStream(static_cast<ZSTD_DCtx *>(_context), &output, &input);
+            if (ZSTD_isError(result)) {
+                out.resize(offset);
+                return false;
+            }
+            consumed += input.pos;
+            written = output.pos;
+        }
+
+        out.resize(offset + written);
+        isOutputFull = written == DECOMPRESS_CHUNK_SIZE;
+        _isFinished = result == 0;
+    }
+    return true;
+}
+
+#endif // CC_USE_FAST_COMPRESSION
+
 }
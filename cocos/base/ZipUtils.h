@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "base/Macros.h"
 #include "platform/FileUtils.h"
 #include <string>
+#include <vector>
 
 #if (CC_PLATFORM == CC_PLATFORM_ANDROID)
 #include "platform/android/FileUtils-android.h"
@@ -196,6 +197,42 @@ typedef struct unz_file_info_s unz_file_info;
          */
         static void setPvrEncryptionKey(unsigned int keyPart1, unsigned int keyPart2, unsigned int keyPart3, unsigned int keyPart4);
 
+#if CC_USE_FAST_COMPRESSION
+        /**
+         * Compresses into an LZ4 frame, which decodes several times faster than zlib.
+         *
+         * @param level 0 for the fast mode, 1 to 12 for the high compression mode.
+         * @return The frame, empty on failure.
+         */
+        static Data compressLZ4(const unsigned char *in, ssize_t inLength, int level = 0);
+
+        /**
+         * Decompresses an LZ4 frame.
+         *
+         * @return The decompressed data, empty on failure.
+         */
+        static Data decompressLZ4(const unsigned char *in, ssize_t inLength);
+
+        /**
+         * Compresses into a zstd frame.
+         *
+         * @param level 1 to 22, 0 for the default level of zstd.
+         * @param dictionary A dictionary trained on samples of the data with zstd --train, or nullptr. Small payloads
+         *        of a known shape compress much better with one, the same one has to decompress them.
+         * @param workers The number of threads compressing the data, for large saves. 0 compresses on the calling
+         *        thread, as does any number when zstd is built without ZSTD_MULTITHREAD.
+         * @return The frame, empty on failure.
+         */
+        static Data compressZstd(const unsigned char *in, ssize_t inLength, int level = 0, const Data *dictionary = nullptr, int workers = 0);
+
+        /**
+         * Decompresses a zstd frame, with the dictionary it was compressed with.
+         *
+         * @return The decompressed data, empty on failure.
+         */
+        static Data decompressZstd(const unsigned char *in, ssize_t inLength, const Data *dictionary = nullptr);
+#endif // CC_USE_FAST_COMPRESSION
+
     private:
         static int inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigned char **out, ssize_t *outLength, ssize_t outLengthHint);
         static inline void decodeEncodedPvr (unsigned int *data, ssize_t len);
@@ -206,6 +243,57 @@ typedef struct unz_file_info_s unz_file_info;
         static bool s_bEncryptionKeyIsValid;
     };
 
+#if CC_USE_FAST_COMPRESSION
+    enum class CompressionCodec {
+        LZ4,
+        ZSTD,
+    };
+
+    /**
+     * Compresses data arriving in pieces into one LZ4 or zstd frame, such as a save written as it is serialized or
+     * a payload sent as it is produced. The parameters are the ones of ZipUtils::compressLZ4 and compressZstd,
+     * dictionaries and workers only apply to zstd.
+     */
+    class CC_DLL CompressStream
+    {
+    public:
+        explicit CompressStream(CompressionCodec codec, int level = 0, const Data *dictionary = nullptr, int workers = 0);
+        ~CompressStream();
+
+        /** Appends the compressed bytes of in available so far to out. */
+        bool update(const unsigned char *in, ssize_t inLength, std::vector<unsigned char> &out);
+        /** Appends the rest of the frame to out, the stream can't be updated afterwards. */
+        bool finish(std::vector<unsigned char> &out);
+
+    private:
+        CompressionCodec _codec;
+        int _level = 0;
+        void *_context = nullptr;
+        bool _isStarted = false;
+    };
+
+    /**
+     * Decompresses an LZ4 or zstd frame arriving in pieces, such as a download, with the dictionary of zstd
+     * frames compressed with one.
+     */
+    class CC_DLL DecompressStream
+    {
+    public:
+        explicit DecompressStream(CompressionCodec codec, const Data *dictionary = nullptr);
+        ~DecompressStream();
+
+        /** Appends the bytes decompressed from in to out, false on corrupted data. */
+        bool update(const unsigned char *in, ssize_t inLength, std::vector<unsigned char> &out);
+        /** Whether the end of the frame was decompressed. */
+        bool isFinished() const { return _isFinished; }
+
+    private:
+        CompressionCodec _codec;
+        void *_context = nullptr;
+        bool _isFinished = false;
+    };
+#endif // CC_USE_FAST_COMPRESSION
+
     // forward declaration
     class ZipFilePrivate;
     struct unz_file_info_s;
@@ -216,6 +304,11 @@ typedef struct unz_file_info_s unz_file_info;
     * It will cache the file list of a particular zip file with positions inside an archive,
     * so it would be much faster to read some particular files or to check their existence.
     *
+    * Archives opened from a file are mapped and their central directory is indexed by name, files are read
+    * straight out of the mapping without minizip, which also makes reads safe from several threads.
+    * Stored files are not copied at all with mapFile. Archives which can't be mapped, use zip64 or
+    * hold encrypted files are read through minizip.
+    *
     * @since v2.0.5
     */
     class CC_DLL ZipFile
@@ -273,6 +366,28 @@ typedef struct unz_file_info_s unz_file_info;
         */
         bool getFileData(const std::string &fileName, ResizableBuffer* buffer);
 
+        /**
+        * Maps a file of the zip file.
+        * Stored files point into the mapped archive and stay valid as long as the ZipFile lives,
+        * compressed ones are inflated into a buffer the view owns.
+        * @param fileName File name
+        * @return The view of the file, null if the file doesn't exist, can't be read or is empty.
+        */
+        MappedFile mapFile(const std::string &fileName);
+
+        /** Receives a chunk of a file, returns false to stop reading. */
+        typedef std::function<bool(const unsigned char *data, ssize_t size)> ChunkCallback;
+
+        /**
+        * Inflates a file chunk by chunk into a buffer of the caller, without holding the whole file in memory.
+        * @param fileName File name
+        * @param chunk The buffer every chunk is inflated into before it is handed to the callback.
+        * @param chunkSize The size of the buffer.
+        * @param callback Receives the chunks in order.
+        * @return True if the whole file was read.
+        */
+        bool readFileChunks(const std::string &fileName, unsigned char *chunk, ssize_t chunkSize, const ChunkCallback &callback);
+
         std::string getFirstFilename();
         std::string getNextFilename();
 
@@ -284,6 +399,7 @@ typedef struct unz_file_info_s unz_file_info;
 
         bool initWithBuffer(const void *buffer, unsigned long size);
         int getCurrentFileInfo(std::string *filename, unz_file_info *info);
+        bool indexMappedArchive(const std::string &filter);
 
         /** Internal data like zip file pointer / file list array and so on */
         ZipFilePrivate *_data;
@@ -72,3 +72,204 @@ etc2_uint32 etc2_pkm_get_format(const uint8_t* pHeader) {
     return readBEUint16(pHeader + ETC2_PKM_FORMAT_OFFSET);
 }
 
+
+// Block decoding, for devices which can't sample ETC textures.
+
+static const int kModifierTable[8][4] = {
+    { 2, 8, -2, -8 },
+    { 5, 17, -5, -17 },
+    { 9, 29, -9, -29 },
+    { 13, 42, -13, -42 },
+    { 18, 60, -18, -60 },
+    { 24, 80, -24, -80 },
+    { 33, 106, -33, -106 },
+    { 47, 183, -47, -183 }
+};
+
+static const int kDistanceTable[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
+
+static const int kAlphaModifierTable[16][8] = {
+    { -3, -6, -9, -15, 2, 5, 8, 14 },
+    { -3, -7, -10, -13, 2, 6, 9, 12 },
+    { -2, -5, -8, -13, 1, 4, 7, 12 },
+    { -2, -4, -6, -13, 1, 3, 5, 12 },
+    { -3, -6, -8, -12, 2, 5, 7, 11 },
+    { -3, -7, -9, -11, 2, 6, 8, 10 },
+    { -4, -7, -8, -11, 3, 6, 7, 10 },
+    { -3, -5, -8, -11, 2, 4, 7, 10 },
+    { -2, -6, -8, -10, 1, 5, 7, 9 },
+    { -2, -5, -8, -10, 1, 4, 7, 9 },
+    { -2, -4, -8, -10, 1, 3, 7, 9 },
+    { -2, -5, -7, -10, 1, 4, 6, 9 },
+    { -3, -4, -7, -10, 2, 3, 6, 9 },
+    { -1, -2, -3, -10, 0, 1, 2, 9 },
+    { -4, -6, -8, -9, 3, 5, 7, 8 },
+    { -3, -5, -7, -9, 2, 4, 6, 8 }
+};
+
+static inline etc2_byte clamp255(int value) {
+    return static_cast<etc2_byte>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+// bits [high, high - count) of the block, bit 63 being the first bit of its first byte
+static inline etc2_uint32 getBits(uint64_t block, int high, int count) {
+    return static_cast<etc2_uint32>((block >> (high - count + 1)) & ((1u << count) - 1));
+}
+
+static inline int extend4(etc2_uint32 value) { return static_cast<int>(value << 4 | value); }
+static inline int extend5(etc2_uint32 value) { return static_cast<int>(value << 3 | value >> 2); }
+static inline int extend6(etc2_uint32 value) { return static_cast<int>(value << 2 | value >> 4); }
+static inline int extend7(etc2_uint32 value) { return static_cast<int>(value << 1 | value >> 6); }
+
+static inline void writePixel(etc2_byte* pOut, int x, int y, int r, int g, int b) {
+    etc2_byte* pixel = pOut + (y * 4 + x) * 4;
+    pixel[0] = clamp255(r);
+    pixel[1] = clamp255(g);
+    pixel[2] = clamp255(b);
+    pixel[3] = 255;
+}
+
+// T and H blocks pick one of four paint colors per pixel
+static void decodePaintColors(uint64_t block, const int colors[4][3], etc2_byte* pOut) {
+    for (int i = 0; i < 16; ++i) {
+        // the indices go down the columns
+        const int x = i >> 2, y = i & 3;
+        const etc2_uint32 index = getBits(block, 16 + i, 1) << 1 | getBits(block, i, 1);
+        writePixel(pOut, x, y, colors[index][0], colors[index][1], colors[index][2]);
+    }
+}
+
+void etc2_decode_rgb_block(const etc2_byte* pIn, etc2_byte* pOut) {
+    uint64_t block = 0;
+    for (int i = 0; i < 8; ++i) {
+        block = block << 8 | pIn[i];
+    }
+
+    int base[2][3];
+    if (!getBits(block, 33, 1)) {
+        // individual mode, two 444 colors
+        for (int c = 0; c < 3; ++c) {
+            base[0][c] = extend4(getBits(block, 63 - c * 8, 4));
+            base[1][c] = extend4(getBits(block, 59 - c * 8, 4));
+        }
+    } else {
+        int first[3], second[3];
+        for (int c = 0; c < 3; ++c) {
+            first[c] = static_cast<int>(getBits(block, 63 - c * 8, 5));
+            const int delta = static_cast<int>(getBits(block, 58 - c * 8, 3));
+            second[c] = first[c] + (delta >= 4 ? delta - 8 : delta);
+        }
+
+        if (second[0] < 0 || second[0] > 31) {
+            // T mode
+            int colors[4][3];
+            const int c1[3] = { extend4(getBits(block, 60, 2) << 2 | getBits(block, 57, 2)), extend4(getBits(block, 55, 4)), extend4(getBits(block, 51, 4)) };
+            const int c2[3] = { extend4(getBits(block, 47, 4)), extend4(getBits(block, 43, 4)), extend4(getBits(block, 39, 4)) };
+            const int distance = kDistanceTable[getBits(block, 35, 2) << 1 | getBits(block, 32, 1)];
+            for (int c = 0; c < 3; ++c) {
+                colors[0][c] = c1[c];
+                colors[1][c] = c2[c] + distance;
+                colors[2][c] = c2[c];
+                colors[3][c] = c2[c] - distance;
+            }
+            decodePaintColors(block, colors, pOut);
+            return;
+        }
+        if (second[1] < 0 || second[1] > 31) {
+            // H mode, the order of the two colors holds the lowest bit of the distance
+            int colors[4][3];
+            const etc2_uint32 r1 = getBits(block, 62, 4), g1 = getBits(block, 58, 3) << 1 | getBits(block, 52, 1), b1 = getBits(block, 51, 1) << 3 | getBits(block, 49, 3);
+            const etc2_uint32 r2 = getBits(block, 46, 4), g2 = getBits(block, 42, 4), b2 = getBits(block, 38, 4);
+            const etc2_uint32 order = (r1 << 8 | g1 << 4 | b1) >= (r2 << 8 | g2 << 4 | b2) ? 1 : 0;
+            const int distance = kDistanceTable[getBits(block, 34, 1) << 2 | getBits(block, 32, 1) << 1 | order];
+            const int c1[3] = { extend4(r1), extend4(g1), extend4(b1) };
+            const int c2[3] = { extend4(r2), extend4(g2), extend4(b2) };
+            for (int c = 0; c < 3; ++c) {
+                colors[0][c] = c1[c] + distance;
+                colors[1][c] = c1[c] - distance;
+                colors[2][c] = c2[c] + distance;
+                colors[3][c] = c2[c] - distance;
+            }
+            decodePaintColors(block, colors, pOut);
+            return;
+        }
+        if (second[2] < 0 || second[2] > 31) {
+            // planar mode, a gradient through the origin, horizontal and vertical colors
+            const int o[3] = { extend6(getBits(block, 62, 6)), extend7(getBits(block, 56, 1) << 6 | getBits(block, 54, 6)),
+                               extend6(getBits(block, 48, 1) << 5 | getBits(block, 44, 2) << 3 | getBits(block, 41, 3)) };
+            const int h[3] = { extend6(getBits(block, 38, 5) << 1 | getBits(block, 32, 1)), extend7(getBits(block, 31, 7)), extend6(getBits(block, 24, 6)) };
+            const int v[3] = { extend6(getBits(block, 18, 6)), extend7(getBits(block, 12, 7)), extend6(getBits(block, 5, 6)) };
+            for (int y = 0; y < 4; ++y) {
+                for (int x = 0; x < 4; ++x) {
+                    int color[3];
+                    for (int c = 0; c < 3; ++c) {
+                        color[c] = (x * (h[c] - o[c]) + y * (v[c] - o[c]) + 4 * o[c] + 2) >> 2;
+                    }
+                    writePixel(pOut, x, y, color[0], color[1], color[2]);
+                }
+            }
+            return;
+        }
+
+        // differential mode, a 555 color and a 333 delta
+        for (int c = 0; c < 3; ++c) {
+            base[0][c] = extend5(static_cast<etc2_uint32>(first[c]));
+            base[1][c] = extend5(static_cast<etc2_uint32>(second[c]));
+        }
+    }
+
+    const int* modifiers[2] = { kModifierTable[getBits(block, 39, 3)], kModifierTable[getBits(block, 36, 3)] };
+    const bool isFlipped = getBits(block, 32, 1) != 0;
+    for (int i = 0; i < 16; ++i) {
+        const int x = i >> 2, y = i & 3;
+        const int subblock = isFlipped ? (y >> 1) : (x >> 1);
+        const int modifier = modifiers[subblock][getBits(block, 16 + i, 1) << 1 | getBits(block, i, 1)];
+        writePixel(pOut, x, y, base[subblock][0] + modifier, base[subblock][1] + modifier, base[subblock][2] + modifier);
+    }
+}
+
+void etc2_decode_rgba_block(const etc2_byte* pIn, etc2_byte* pOut) {
+    // the EAC alpha block comes first
+    etc2_decode_rgb_block(pIn + 8, pOut);
+
+    const int base = pIn[0];
+    const int multiplier = pIn[1] >> 4;
+    const int* modifiers = kAlphaModifierTable[pIn[1] & 0xF];
+    uint64_t indices = 0;
+    for (int i = 2; i < 8; ++i) {
+        indices = indices << 8 | pIn[i];
+    }
+    for (int i = 0; i < 16; ++i) {
+        const int x = i >> 2, y = i & 3;
+        const int index = static_cast<int>(indices >> (45 - i * 3) & 7);
+        pOut[(y * 4 + x) * 4 + 3] = clamp255(base + modifiers[index] * multiplier);
+    }
+}
+
+void etc2_decode_image_rows(const etc2_byte* pIn, etc2_bool hasAlpha, etc2_uint32 width, etc2_uint32 height,
+                            etc2_uint32 firstBlockRow, etc2_uint32 lastBlockRow, etc2_byte* pOut, etc2_uint32 channels) {
+    const etc2_uint32 blockSize = hasAlpha ? 16 : 8;
+    const etc2_uint32 blocksPerRow = (width + 3) / 4;
+    etc2_byte pixels[64];
+    for (etc2_uint32 blockY = firstBlockRow; blockY < lastBlockRow; ++blockY) {
+        for (etc2_uint32 blockX = 0; blockX < blocksPerRow; ++blockX) {
+            const etc2_byte* block = pIn + (blockY * blocksPerRow + blockX) * blockSize;
+            if (hasAlpha) {
+                etc2_decode_rgba_block(block, pixels);
+            } else {
+                etc2_decode_rgb_block(block, pixels);
+            }
+
+            // the blocks on the right and bottom edges may hang over the image
+            const etc2_uint32 columns = width - blockX * 4 < 4 ? width - blockX * 4 : 4;
+            const etc2_uint32 rows = height - blockY * 4 < 4 ? height - blockY * 4 : 4;
+            for (etc2_uint32 y = 0; y < rows; ++y) {
+                etc2_byte* dst = pOut + ((blockY * 4 + y) * width + blockX * 4) * channels;
+                const etc2_byte* src = pixels + y * 16;
+                for (etc2_uint32 x = 0; x < columns; ++x) {
+                    memcpy(dst + x * channels, src + x * 4, channels);
+                }
+            }
+        }
+    }
+}
@@ -67,6 +67,20 @@ etc2_uint32 etc2_pkm_get_height(const etc2_byte* pHeader);
 
 etc2_uint32 etc2_pkm_get_format(const etc2_byte* pHeader);
 
+// Decode a 8 bytes ETC1 or ETC2 RGB8 block to 4x4 RGBA8 pixels, alpha is 255
+
+void etc2_decode_rgb_block(const etc2_byte* pIn, etc2_byte* pOut);
+
+// Decode a 16 bytes ETC2 RGBA8 block, EAC alpha then RGB, to 4x4 RGBA8 pixels
+
+void etc2_decode_rgba_block(const etc2_byte* pIn, etc2_byte* pOut);
+
+// Decode the block rows [firstBlockRow, lastBlockRow) of a level into tightly packed pixels of 3 or 4 channels,
+// ranges of rows may be decoded on different threads
+
+void etc2_decode_image_rows(const etc2_byte* pIn, etc2_bool hasAlpha, etc2_uint32 width, etc2_uint32 height,
+                            etc2_uint32 firstBlockRow, etc2_uint32 lastBlockRow, etc2_byte* pOut, etc2_uint32 channels);
+
 #ifdef __cplusplus
 }
 #endif
@@ -2,6 +2,7 @@
 #define CC_CORE_ALLOCATED_OBJ_H_
 
 #include "../Macros.h"
+#include <new>
 
 // Anything that has done a #define new <blah> will screw operator new definitions up
 // so undefine
@@ -35,6 +36,15 @@ public:
         return Alloc::AllocateBytes(sz, file, line, func);
     }
 
+    /// nothrow operator new, the policies return nullptr on failure
+    void *operator new(size_t sz, const std::nothrow_t &) noexcept {
+        return Alloc::AllocateBytes(sz);
+    }
+
+    void *operator new[](size_t sz, const std::nothrow_t &) noexcept {
+        return Alloc::AllocateBytes(sz);
+    }
+
     /// placement operator new
     void *operator new(size_t sz, void *ptr) {
         (void)sz;
@@ -65,10 +75,19 @@ public:
         Alloc::DeallocateBytes(ptr);
     }
 
+    // only called if a constructor throws after nothrow 'new'
+    void operator delete(void *ptr, const std::nothrow_t &) {
+        Alloc::DeallocateBytes(ptr);
+    }
+
     void operator delete[](void *ptr) {
         Alloc::DeallocateBytes(ptr);
     }
 
+    void operator delete[](void *ptr, const std::nothrow_t &) {
+        Alloc::DeallocateBytes(ptr);
+    }
+
     void operator delete[](void *ptr, const char *, int, const char *) {
         Alloc::DeallocateBytes(ptr);
     }
@@ -0,0 +1,111 @@
+#include "FrameAlloc.h"
+#include "base/Log.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace cc {
+
+FrameArena::FrameArena(size_t chunkSize)
+: _chunkSize(chunkSize) {
+}
+
+FrameArena::~FrameArena() {
+    for (auto &chunk : _chunks) {
+        free(chunk.data);
+    }
+}
+
+void *FrameArena::allocate(size_t size, size_t alignment) {
+    const size_t paddedSize = size + alignment - 1;
+    while (true) {
+        const uint64_t state = _state.fetch_add(paddedSize, std::memory_order_acquire);
+        const auto index = static_cast<uint32_t>(state >> OFFSET_BITS);
+        const size_t offset = static_cast<size_t>(state & OFFSET_MASK);
+
+        const Chunk &chunk = _chunks[index];
+        if (offset + paddedSize <= chunk.size) {
+            const uintptr_t address = reinterpret_cast<uintptr_t>(chunk.data + offset);
+            return reinterpret_cast<void *>((address + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1));
+        }
+        if (!grow(index, paddedSize)) {
+            return nullptr;
+        }
+    }
+}
+
+// Moves on to a new chunk, unless another thread already did.
+bool FrameArena::grow(uint32_t index, size_t size) {
+    std::lock_guard<std::mutex> lock(_growMutex);
+    if ((_state.load(std::memory_order_relaxed) >> OFFSET_BITS) != index) {
+        return true;
+    }
+
+    // the first chunk is only allocated on first use
+    const uint32_t next = _chunks[index].data ? index + 1 : index;
+    if (next >= MAX_CHUNK_COUNT) {
+        CC_LOG_ERROR("FrameArena: out of chunks, %u bytes requested.", static_cast<uint32_t>(size));
+        return false;
+    }
+
+    Chunk &chunk = _chunks[next];
+    if (chunk.size < size) {
+        free(chunk.data);
+        // doubling the chunks keeps their count low when a frame needs much more than the usual
+        chunk.size = std::max(_chunkSize << std::min(next, 10u), size);
+        chunk.data = static_cast<uint8_t *>(malloc(chunk.size));
+        if (!chunk.data) {
+            chunk.size = 0;
+            return false;
+        }
+    }
+    _state.store(static_cast<uint64_t>(next) << OFFSET_BITS, std::memory_order_release);
+    return true;
+}
+
+void FrameArena::reset() {
+    const auto index = static_cast<uint32_t>(_state.load(std::memory_order_relaxed) >> OFFSET_BITS);
+    if (index > 0) {
+        size_t size = 0;
+        for (uint32_t i = 0; i <= index; ++i) {
+            size += _chunks[i].size;
+        }
+        for (auto &chunk : _chunks) {
+            free(chunk.data);
+            chunk = Chunk();
+        }
+        _chunks[0].size = size;
+        _chunks[0].data = static_cast<uint8_t *>(malloc(size));
+        if (!_chunks[0].data) _chunks[0].size = 0;
+    }
+    _state.store(0, std::memory_order_relaxed);
+}
+
+size_t FrameArena::getUsedBytes() const {
+    const uint64_t state = _state.load(std::memory_order_relaxed);
+    const auto index = static_cast<uint32_t>(state >> OFFSET_BITS);
+    size_t size = std::min(static_cast<size_t>(state & OFFSET_MASK), _chunks[index].size);
+    for (uint32_t i = 0; i < index; ++i) {
+        size += _chunks[i].size;
+    }
+    return size;
+}
+
+size_t FrameArena::getReservedBytes() const {
+    size_t size = 0;
+    for (const auto &chunk : _chunks) {
+        size += chunk.size;
+    }
+    return size;
+}
+
+FrameArena FrameAllocator::_arenas[2];
+std::atomic<uint32_t> FrameAllocator::_current{0};
+
+void FrameAllocator::endFrame() {
+    const uint32_t next = _current.load(std::memory_order_relaxed) ^ 1u;
+    _arenas[next].reset();
+    _current.store(next, std::memory_order_relaxed);
+}
+
+} // namespace cc
@@ -0,0 +1,91 @@
+#ifndef CC_CORE_FRAME_ALLOC_H_
+#define CC_CORE_FRAME_ALLOC_H_
+
+#include "base/Macros.h"
+#include "StlAlloc.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace cc {
+
+/** Linear allocator over a few chunks, the allocations are only released all at once by reset.
+    Allocating is thread safe and lock free while the current chunk has room left, resetting is not.
+*/
+class CC_DLL FrameArena {
+public:
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 256 * 1024;
+
+    explicit FrameArena(size_t chunkSize = DEFAULT_CHUNK_SIZE);
+    ~FrameArena();
+
+    FrameArena(const FrameArena &) = delete;
+    FrameArena &operator=(const FrameArena &) = delete;
+
+    void *allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    // Releases all allocations. The chunks of a frame which needed several are merged into one, so the next fits.
+    void reset();
+
+    size_t getUsedBytes() const;
+    size_t getReservedBytes() const;
+
+private:
+    static constexpr uint32_t MAX_CHUNK_COUNT = 32;
+    static constexpr uint32_t OFFSET_BITS = 48;
+    static constexpr uint64_t OFFSET_MASK = (1ULL << OFFSET_BITS) - 1;
+
+    struct Chunk {
+        uint8_t *data = nullptr;
+        size_t size = 0;
+    };
+
+    bool grow(uint32_t index, size_t size);
+
+    size_t _chunkSize = DEFAULT_CHUNK_SIZE;
+    Chunk _chunks[MAX_CHUNK_COUNT];
+    std::atomic<uint64_t> _state{0}; // index of the current chunk above OFFSET_BITS, offset into it below
+    std::mutex _growMutex;
+};
+
+/** Double-buffered frame arenas. What is allocated during a frame stays valid until the end of the next frame,
+    endFrame is called by the pipeline once a frame is submitted.
+*/
+class CC_DLL FrameAllocator {
+public:
+    static CC_INLINE void *allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        return _arenas[_current.load(std::memory_order_relaxed)].allocate(size, alignment);
+    }
+
+    // Resets the arena of the frame before, which takes the allocations of the next frame.
+    static void endFrame();
+
+    static CC_INLINE FrameArena &getArena(uint32_t index) { return _arenas[index]; }
+
+private:
+    static FrameArena _arenas[2];
+    static std::atomic<uint32_t> _current;
+};
+
+/** Allocation policy for SA, deallocating is a no-op as the memory returns with the frame arena.
+    Containers using it must not outlive the frame after the one they fill.
+*/
+class CC_DLL FrameAllocPolicy {
+public:
+    static CC_INLINE void *AllocateBytes(size_t count, const char * = nullptr, int = 0, const char * = nullptr) {
+        return FrameAllocator::allocate(count);
+    }
+
+    static CC_INLINE void DeallocateBytes(void *) {}
+};
+
+// Temporary containers of a frame, such as render object, light and dynamic offset lists built while rendering.
+template <typename T>
+using FrameVector = std::vector<T, SA<T, FrameAllocPolicy>>;
+
+} // namespace cc
+
+#endif // CC_CORE_FRAME_ALLOC_H_
@@ -6,6 +6,271 @@
     #include <android/log.h>
 #endif
 
+#if CC_USE_MEMORY_SAMPLING
+
+    #if (CC_PLATFORM == CC_PLATFORM_WINDOWS)
+        #ifndef WIN32_LEAN_AND_MEAN
+            #define WIN32_LEAN_AND_MEAN
+        #endif
+        #include <Windows.h>
+    #elif (CC_PLATFORM == CC_PLATFORM_ANDROID)
+        #include <dlfcn.h>
+        #include <unwind.h>
+    #else
+        #include <dlfcn.h>
+        #include <execinfo.h>
+    #endif
+
+    #include <cstring>
+
+namespace cc {
+
+namespace {
+
+constexpr uint32_t MAX_STACK_DEPTH = 16;
+constexpr uint32_t SKIPPED_FRAMES = 2; // captureStack and MemSampler::sample
+
+const char *MODULE_NAMES[] = {"general", "script", "renderer", "middleware", "audio", "network"};
+const char *POOL_NAMES[] = {"heap", "objectPool"};
+static_assert(sizeof(MODULE_NAMES) / sizeof(MODULE_NAMES[0]) == static_cast<uint8_t>(MemModule::COUNT), "a memory module has no name");
+static_assert(sizeof(POOL_NAMES) / sizeof(POOL_NAMES[0]) == static_cast<uint8_t>(MemPool::COUNT), "a memory pool has no name");
+
+struct SampledStack {
+    void *frames[MAX_STACK_DEPTH];
+    uint32_t depth = 0;
+    MemModule module = MemModule::GENERAL;
+    MemPool pool = MemPool::HEAP;
+    uint64_t liveCount = 0;
+    uint64_t liveBytes = 0;
+    uint64_t totalCount = 0;
+    uint64_t totalBytes = 0;
+};
+
+struct SampledAlloc {
+    uint64_t stackHash;
+    size_t size;
+    uint32_t interval; // the interval when sampled, the number of allocations it stands for
+};
+
+// The containers allocate through the global operator new, never through the sampled allocators.
+struct SamplerState {
+    std::mutex mutex;
+    std::unordered_map<uint64_t, SampledStack> stacks; // by hash of the frames, module and pool
+    std::unordered_map<void *, SampledAlloc> allocs;
+};
+
+SamplerState *getSamplerState() {
+    static SamplerState *state = new SamplerState(); // never destroyed, frees come in until exit
+    return state;
+}
+
+thread_local MemModule currentModule = MemModule::GENERAL;
+
+    #if (CC_PLATFORM == CC_PLATFORM_ANDROID)
+struct UnwindState {
+    void **frames;
+    uint32_t depth;
+    uint32_t skipped;
+};
+
+_Unwind_Reason_Code unwindCallback(struct _Unwind_Context *context, void *arg) {
+    auto *state = static_cast<UnwindState *>(arg);
+    const uintptr_t pc = _Unwind_GetIP(context);
+    if (!pc) return _URC_END_OF_STACK;
+    if (state->skipped < SKIPPED_FRAMES) {
+        ++state->skipped;
+        return _URC_NO_REASON;
+    }
+    state->frames[state->depth++] = reinterpret_cast<void *>(pc);
+    return state->depth < MAX_STACK_DEPTH ? _URC_NO_REASON : _URC_END_OF_STACK;
+}
+    #endif
+
+uint32_t captureStack(void **frames) {
+    #if (CC_PLATFORM == CC_PLATFORM_WINDOWS)
+    return CaptureStackBackTrace(SKIPPED_FRAMES, MAX_STACK_DEPTH, frames, nullptr);
+    #elif (CC_PLATFORM == CC_PLATFORM_ANDROID)
+    UnwindState state = {frames, 0, 0};
+    _Unwind_Backtrace(unwindCallback, &state);
+    return state.depth;
+    #else
+    void *buffer[MAX_STACK_DEPTH + SKIPPED_FRAMES];
+    const int count = backtrace(buffer, MAX_STACK_DEPTH + SKIPPED_FRAMES);
+    uint32_t depth = 0;
+    for (int i = SKIPPED_FRAMES; i < count; ++i) frames[depth++] = buffer[i];
+    return depth;
+    #endif
+}
+
+// FNV-1a over the frames, module and pool
+uint64_t hashStack(void *const *frames, uint32_t depth, MemModule module, MemPool pool) {
+    uint64_t hash = 14695981039346656037ULL;
+    const auto mix = [&hash](uint64_t value) {
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    };
+    for (uint32_t i = 0; i < depth; ++i) mix(reinterpret_cast<uintptr_t>(frames[i]));
+    mix(static_cast<uint64_t>(module) << 8 | static_cast<uint64_t>(pool));
+    return hash;
+}
+
+void describeFrame(void *frame, std::string *text) {
+    char buffer[320];
+    #if (CC_PLATFORM == CC_PLATFORM_WINDOWS)
+    snprintf(buffer, sizeof(buffer), "    %p\n", frame);
+    #else
+    // symbols of stripped libraries are resolved offline from the library and the offset
+    Dl_info info;
+    if (dladdr(frame, &info) && info.dli_fname) {
+        const char *library = strrchr(info.dli_fname, '/');
+        library = library ? library + 1 : info.dli_fname;
+        const auto offset = reinterpret_cast<uintptr_t>(frame) - reinterpret_cast<uintptr_t>(info.dli_fbase);
+        snprintf(buffer, sizeof(buffer), "    %s+0x%zx %s\n", library, static_cast<size_t>(offset), info.dli_sname ? info.dli_sname : "");
+    } else {
+        snprintf(buffer, sizeof(buffer), "    %p\n", frame);
+    }
+    #endif
+    *text += buffer;
+}
+
+} // namespace
+
+MemSampler::PoolCounters MemSampler::_poolCounters[static_cast<uint8_t>(MemPool::COUNT)];
+std::atomic<uint32_t> MemSampler::_sampleInterval{DEFAULT_SAMPLE_INTERVAL};
+std::atomic<uint16_t> MemSampler::_sampledFilter[FILTER_SIZE];
+
+void MemSampler::setSampleInterval(uint32_t interval) {
+    _sampleInterval.store(interval ? interval : 1, std::memory_order_relaxed);
+}
+
+void MemSampler::setCurrentModule(MemModule module) {
+    currentModule = module;
+}
+
+MemModule MemSampler::getCurrentModule() {
+    return currentModule;
+}
+
+void MemSampler::sample(void *ptr, size_t size, MemPool pool) {
+    void *frames[MAX_STACK_DEPTH];
+    const uint32_t depth = captureStack(frames);
+    const MemModule module = currentModule;
+    const uint64_t hash = hashStack(frames, depth, module, pool);
+    const uint32_t interval = _sampleInterval.load(std::memory_order_relaxed);
+
+    SamplerState *state = getSamplerState();
+    std::lock_guard<std::mutex> lock(state->mutex);
+    auto result = state->allocs.emplace(ptr, SampledAlloc{hash, size, interval});
+    if (!result.second) return; // freed by an allocator the sampler doesn't see
+
+    SampledStack &stack = state->stacks[hash];
+    if (!stack.depth) {
+        memcpy(stack.frames, frames, depth * sizeof(void *));
+        stack.depth = depth;
+        stack.module = module;
+        stack.pool = pool;
+    }
+    stack.liveCount += interval;
+    stack.liveBytes += size * interval;
+    stack.totalCount += interval;
+    stack.totalBytes += size * interval;
+
+    auto &filter = _sampledFilter[getFilterIndex(ptr)];
+    if (filter.load(std::memory_order_relaxed) < UINT16_MAX) filter.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MemSampler::unsample(void *ptr) {
+    SamplerState *state = getSamplerState();
+    std::lock_guard<std::mutex> lock(state->mutex);
+    auto iter = state->allocs.find(ptr);
+    if (iter == state->allocs.end()) return;
+
+    SampledStack &stack = state->stacks[iter->second.stackHash];
+    stack.liveCount -= iter->second.interval;
+    stack.liveBytes -= iter->second.size * iter->second.interval;
+    state->allocs.erase(iter);
+
+    // a saturated bucket stays set, its frees keep taking the lookup
+    auto &filter = _sampledFilter[getFilterIndex(ptr)];
+    if (filter.load(std::memory_order_relaxed) < UINT16_MAX) filter.fetch_sub(1, std::memory_order_relaxed);
+}
+
+std::string MemSampler::getReport(uint32_t topCount) {
+    std::string text;
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "Allocation sampling, 1 in %u allocations:\n", getSampleInterval());
+    text += buffer;
+
+    for (uint8_t i = 0; i < static_cast<uint8_t>(MemPool::COUNT); ++i) {
+        const PoolCounters &counters = _poolCounters[i];
+        snprintf(buffer, sizeof(buffer), "  pool %s: %llu allocations of %llu KB, %llu frees\n", POOL_NAMES[i],
+                 static_cast<unsigned long long>(counters.allocCount.load(std::memory_order_relaxed)),
+                 static_cast<unsigned long long>(counters.allocBytes.load(std::memory_order_relaxed) / 1024),
+                 static_cast<unsigned long long>(counters.freeCount.load(std::memory_order_relaxed)));
+        text += buffer;
+    }
+
+    std::vector<SampledStack> stacks;
+    {
+        SamplerState *state = getSamplerState();
+        std::lock_guard<std::mutex> lock(state->mutex);
+        stacks.reserve(state->stacks.size());
+        for (const auto &pair : state->stacks) stacks.push_back(pair.second);
+    }
+
+    struct Totals {
+        uint64_t liveCount = 0;
+        uint64_t liveBytes = 0;
+        uint64_t totalBytes = 0;
+    } modules[static_cast<uint8_t>(MemModule::COUNT)];
+    for (const auto &stack : stacks) {
+        Totals &totals = modules[static_cast<uint8_t>(stack.module)];
+        totals.liveCount += stack.liveCount;
+        totals.liveBytes += stack.liveBytes;
+        totals.totalBytes += stack.totalBytes;
+    }
+    for (uint8_t i = 0; i < static_cast<uint8_t>(MemModule::COUNT); ++i) {
+        if (!modules[i].totalBytes) continue;
+        snprintf(buffer, sizeof(buffer), "  module %s: ~%llu KB live in ~%llu allocations, ~%llu KB allocated\n", MODULE_NAMES[i],
+                 static_cast<unsigned long long>(modules[i].liveBytes / 1024), static_cast<unsigned long long>(modules[i].liveCount),
+                 static_cast<unsigned long long>(modules[i].totalBytes / 1024));
+        text += buffer;
+    }
+
+    const size_t count = std::min(stacks.size(), static_cast<size_t>(topCount));
+    std::partial_sort(stacks.begin(), stacks.begin() + count, stacks.end(), [](const SampledStack &a, const SampledStack &b) {
+        return a.liveBytes > b.liveBytes;
+    });
+    text += "Top allocators by live bytes:\n";
+    for (size_t i = 0; i < count; ++i) {
+        const SampledStack &stack = stacks[i];
+        if (!stack.liveBytes) break;
+        snprintf(buffer, sizeof(buffer), "#%zu ~%llu KB live in ~%llu allocations, ~%llu KB allocated [%s/%s]\n", i + 1,
+                 static_cast<unsigned long long>(stack.liveBytes / 1024), static_cast<unsigned long long>(stack.liveCount),
+                 static_cast<unsigned long long>(stack.totalBytes / 1024), MODULE_NAMES[static_cast<uint8_t>(stack.module)],
+                 POOL_NAMES[static_cast<uint8_t>(stack.pool)]);
+        text += buffer;
+        for (uint32_t j = 0; j < stack.depth; ++j) describeFrame(stack.frames[j], &text);
+    }
+    return text;
+}
+
+void MemSampler::dumpReport(uint32_t topCount) {
+    // line by line, the system logs truncate long messages
+    const std::string text = getReport(topCount);
+    size_t begin = 0;
+    while (begin < text.size()) {
+        size_t end = text.find('\n', begin);
+        if (end == std::string::npos) end = text.size();
+        CC_LOG_INFO("%.*s", static_cast<int>(end - begin), text.c_str() + begin);
+        begin = end + 1;
+    }
+}
+
+} // namespace cc
+
+#endif // CC_USE_MEMORY_SAMPLING
+
 #ifdef CC_MEMORY_TRACKER
 
 extern "C" {
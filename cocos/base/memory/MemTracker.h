@@ -1,6 +1,117 @@
 #ifndef CC_CORE_MEM_TRACKER_H_
 #define CC_CORE_MEM_TRACKER_H_
 
+#include "base/Config.h"
+#include "base/Macros.h"
+
+#if CC_USE_MEMORY_SAMPLING
+
+    #include <atomic>
+    #include <cstddef>
+    #include <cstdint>
+    #include <string>
+
+namespace cc {
+
+// Where sampled allocations are attributed to, set per thread by MemModuleScope.
+enum class MemModule : uint8_t {
+    GENERAL,
+    SCRIPT,
+    RENDERER,
+    MIDDLEWARE,
+    AUDIO,
+    NETWORK,
+    COUNT,
+};
+
+// The allocator serving an allocation.
+enum class MemPool : uint8_t {
+    HEAP,        // the allocation policies of MemDef.h, cc::Object and CC_MALLOC
+    OBJECT_POOL, // ObjectPool
+    COUNT,
+};
+
+/** Sampling allocation tracker for release builds with profiling. Every allocation of the engine allocators
+    bumps a counter of its pool, every Nth one also records the hash of its call stack, its size and the module
+    of the thread. Totals per module and the top allocators are estimated from the samples, each standing
+    for N allocations. Frees are matched against the live samples through a counting filter, most frees
+    only read one atomic.
+*/
+class CC_DLL MemSampler {
+public:
+    static constexpr uint32_t DEFAULT_SAMPLE_INTERVAL = 1024;
+
+    static CC_INLINE void recordAlloc(void *ptr, size_t size, MemPool pool) {
+        if (!ptr) return;
+        PoolCounters &counters = _poolCounters[static_cast<uint8_t>(pool)];
+        const uint64_t index = counters.allocCount.fetch_add(1, std::memory_order_relaxed);
+        counters.allocBytes.fetch_add(size, std::memory_order_relaxed);
+        if (index % _sampleInterval.load(std::memory_order_relaxed) == 0) sample(ptr, size, pool);
+    }
+
+    static CC_INLINE void recordFree(void *ptr, MemPool pool) {
+        if (!ptr) return;
+        _poolCounters[static_cast<uint8_t>(pool)].freeCount.fetch_add(1, std::memory_order_relaxed);
+        if (_sampledFilter[getFilterIndex(ptr)].load(std::memory_order_relaxed)) unsample(ptr);
+    }
+
+    // 1 samples every allocation, only a new interval affects the estimates of later samples.
+    static void setSampleInterval(uint32_t interval);
+    static CC_INLINE uint32_t getSampleInterval() { return _sampleInterval.load(std::memory_order_relaxed); }
+
+    static void setCurrentModule(MemModule module);
+    static MemModule getCurrentModule();
+
+    // Pool counters, module totals and the call stacks holding the most live bytes.
+    static std::string getReport(uint32_t topCount = 20);
+    static void dumpReport(uint32_t topCount = 20);
+
+private:
+    struct PoolCounters {
+        std::atomic<uint64_t> allocCount{0};
+        std::atomic<uint64_t> allocBytes{0};
+        std::atomic<uint64_t> freeCount{0};
+    };
+
+    static constexpr uint32_t FILTER_SIZE = 16384;
+
+    static CC_INLINE uint32_t getFilterIndex(const void *ptr) {
+        const auto address = reinterpret_cast<uintptr_t>(ptr) >> 4;
+        return static_cast<uint32_t>((address ^ (address >> 14)) & (FILTER_SIZE - 1));
+    }
+
+    static void sample(void *ptr, size_t size, MemPool pool);
+    static void unsample(void *ptr);
+
+    static PoolCounters _poolCounters[static_cast<uint8_t>(MemPool::COUNT)];
+    static std::atomic<uint32_t> _sampleInterval;
+    static std::atomic<uint16_t> _sampledFilter[FILTER_SIZE]; // live samples per address bucket
+};
+
+// Attributes the allocations of the calling thread to a module while alive.
+class CC_DLL MemModuleScope {
+public:
+    explicit MemModuleScope(MemModule module)
+    : _previous(MemSampler::getCurrentModule()) { MemSampler::setCurrentModule(module); }
+    ~MemModuleScope() { MemSampler::setCurrentModule(_previous); }
+
+private:
+    MemModule _previous;
+};
+
+} // namespace cc
+
+    #define CC_MEM_MODULE_SCOPE(module)                   cc::MemModuleScope CC_MEM_MODULE_SCOPE_NAME(__LINE__)(cc::MemModule::module)
+    #define CC_MEM_MODULE_SCOPE_NAME(line)                CC_MEM_MODULE_SCOPE_CONCAT(ccMemModuleScope, line)
+    #define CC_MEM_MODULE_SCOPE_CONCAT(prefix, line)      prefix##line
+    #define CC_MEM_SAMPLE_ALLOC(ptr, size, pool)          cc::MemSampler::recordAlloc(ptr, size, cc::MemPool::pool)
+    #define CC_MEM_SAMPLE_FREE(ptr, pool)                 cc::MemSampler::recordFree(ptr, cc::MemPool::pool)
+#else
+    #define CC_MEM_MODULE_SCOPE(module)
+    #define CC_MEM_SAMPLE_ALLOC(ptr, size, pool)
+    #define CC_MEM_SAMPLE_FREE(ptr, pool)
+#endif // CC_USE_MEMORY_SAMPLING
+
 #ifdef CC_MEMORY_TRACKER
 
 namespace cc {
@@ -60,6 +171,6 @@ private:
 
 } // namespace cc
 
-#endif
+#endif // CC_MEMORY_TRACKER
 
 #endif // CC_CORE_MEM_TRACKER_H_
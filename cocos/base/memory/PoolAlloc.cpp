@@ -0,0 +1,239 @@
+#include "PoolAlloc.h"
+#include "MemTracker.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+#if defined(__GNUC__)
+    #include <cxxabi.h>
+#endif
+
+namespace cc {
+
+namespace {
+
+// Every block starts with a header holding its size class, keeping the object aligned to max_align_t.
+constexpr size_t HEADER_SIZE = 16;
+constexpr uint32_t MALLOC_CLASS = ObjectPool::CLASS_COUNT;
+constexpr size_t SLAB_SIZE = 64 * 1024;
+constexpr uint32_t BATCH_SIZE = 32;           // blocks moved between a thread cache and the shared list at once
+constexpr uint32_t MAX_CACHED = BATCH_SIZE * 2; // per class and thread
+
+static_assert(HEADER_SIZE >= alignof(std::max_align_t), "the header has to keep objects aligned");
+
+struct FreeBlock {
+    FreeBlock *next;
+};
+
+struct Header {
+    uint32_t sizeClass;
+};
+
+CC_INLINE size_t getBlockSize(uint32_t sizeClass) {
+    return HEADER_SIZE + (sizeClass + 1) * ObjectPool::GRANULARITY;
+}
+
+struct Batch {
+    FreeBlock *head; // linked through the blocks
+    uint32_t count;
+};
+
+struct SharedClass {
+    std::mutex mutex;
+    std::vector<Batch> batches;
+};
+
+struct SharedPools {
+    SharedClass classes[ObjectPool::CLASS_COUNT];
+    std::atomic<size_t> reservedBytes{0};
+
+    std::mutex typeMutex;
+    std::vector<std::unique_ptr<ObjectPool::TypeStats>> types;
+};
+
+// never destroyed, thread caches flush into it on exit
+SharedPools *getSharedPools() {
+    static SharedPools *pools = new SharedPools();
+    return pools;
+}
+
+// Carves a batch of blocks out of a new slab.
+FreeBlock *allocateBatch(uint32_t sizeClass, uint32_t *count) {
+    SharedPools *pools = getSharedPools();
+    SharedClass &shared = pools->classes[sizeClass];
+    {
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        if (!shared.batches.empty()) {
+            const Batch batch = shared.batches.back();
+            shared.batches.pop_back();
+            *count = batch.count;
+            return batch.head;
+        }
+    }
+
+    const size_t blockSize = getBlockSize(sizeClass);
+    const auto blockCount = static_cast<uint32_t>(SLAB_SIZE / blockSize);
+    auto *slab = static_cast<uint8_t *>(malloc(blockCount * blockSize));
+    if (!slab) return nullptr;
+    pools->reservedBytes.fetch_add(blockCount * blockSize, std::memory_order_relaxed);
+
+    FreeBlock *head = nullptr;
+    for (uint32_t i = blockCount; i > 0; --i) {
+        auto *block = reinterpret_cast<FreeBlock *>(slab + (i - 1) * blockSize);
+        block->next = head;
+        head = block;
+    }
+    *count = blockCount;
+    return head;
+}
+
+// Trivially destructible, so it stays usable while other thread_local and static objects are destroyed.
+struct ThreadCache {
+    FreeBlock *lists[ObjectPool::CLASS_COUNT];
+    uint32_t counts[ObjectPool::CLASS_COUNT];
+
+    CC_INLINE void *allocate(uint32_t sizeClass) {
+        if (!lists[sizeClass]) {
+            lists[sizeClass] = allocateBatch(sizeClass, &counts[sizeClass]);
+            if (!lists[sizeClass]) return nullptr;
+        }
+        FreeBlock *block = lists[sizeClass];
+        lists[sizeClass] = block->next;
+        --counts[sizeClass];
+        return block;
+    }
+
+    CC_INLINE void deallocate(void *ptr, uint32_t sizeClass) {
+        auto *block = static_cast<FreeBlock *>(ptr);
+        block->next = lists[sizeClass];
+        lists[sizeClass] = block;
+        if (++counts[sizeClass] > MAX_CACHED) release(sizeClass, BATCH_SIZE);
+    }
+
+    // Hands the first count blocks of the cache to the shared list.
+    void release(uint32_t sizeClass, uint32_t count) {
+        FreeBlock *head = lists[sizeClass];
+        FreeBlock *last = head;
+        for (uint32_t i = 1; i < count; ++i) last = last->next;
+        lists[sizeClass] = last->next;
+        last->next = nullptr;
+        counts[sizeClass] -= count;
+
+        SharedClass &shared = getSharedPools()->classes[sizeClass];
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        shared.batches.push_back({head, count});
+    }
+
+    void flush() {
+        for (uint32_t i = 0; i < ObjectPool::CLASS_COUNT; ++i) {
+            if (counts[i]) release(i, counts[i]);
+        }
+    }
+};
+
+thread_local ThreadCache threadCache;
+
+// Returns the cached blocks of an exiting thread.
+struct ThreadCacheFlusher {
+    ~ThreadCacheFlusher() { threadCache.flush(); }
+};
+
+thread_local ThreadCacheFlusher threadCacheFlusher;
+
+} // namespace
+
+void *ObjectPool::allocate(size_t size) {
+    const uint32_t sizeClass = size ? static_cast<uint32_t>((size - 1) / GRANULARITY) : 0;
+    uint8_t *block = nullptr;
+    if (sizeClass < CLASS_COUNT) {
+        (void)&threadCacheFlusher; // constructs it on the first allocation of the thread
+        block = static_cast<uint8_t *>(threadCache.allocate(sizeClass));
+    } else {
+        block = static_cast<uint8_t *>(malloc(HEADER_SIZE + size));
+    }
+    if (!block) return nullptr;
+
+    reinterpret_cast<Header *>(block)->sizeClass = sizeClass < CLASS_COUNT ? sizeClass : MALLOC_CLASS;
+    CC_MEM_SAMPLE_ALLOC(block + HEADER_SIZE, size, OBJECT_POOL);
+    return block + HEADER_SIZE;
+}
+
+void *ObjectPool::reallocate(void *ptr, size_t size) {
+    if (!ptr) return allocate(size);
+
+    uint8_t *block = static_cast<uint8_t *>(ptr) - HEADER_SIZE;
+    const uint32_t sizeClass = reinterpret_cast<Header *>(block)->sizeClass;
+    const uint32_t newClass = size ? static_cast<uint32_t>((size - 1) / GRANULARITY) : 0;
+    if (sizeClass == MALLOC_CLASS && newClass >= CLASS_COUNT) {
+        CC_MEM_SAMPLE_FREE(ptr, OBJECT_POOL);
+        block = static_cast<uint8_t *>(realloc(block, HEADER_SIZE + size));
+        if (!block) return nullptr;
+        CC_MEM_SAMPLE_ALLOC(block + HEADER_SIZE, size, OBJECT_POOL);
+        return block + HEADER_SIZE;
+    }
+    if (sizeClass == newClass) return ptr;
+
+    // the size of a malloc block isn't kept, it only moves into a class when shrinking
+    void *result = allocate(size);
+    if (!result) return nullptr;
+    const size_t oldSize = sizeClass == MALLOC_CLASS ? size : (sizeClass + 1) * GRANULARITY;
+    memcpy(result, ptr, std::min(oldSize, size));
+    deallocate(ptr);
+    return result;
+}
+
+void ObjectPool::deallocate(void *ptr) {
+    if (!ptr) return;
+    CC_MEM_SAMPLE_FREE(ptr, OBJECT_POOL);
+
+    uint8_t *block = static_cast<uint8_t *>(ptr) - HEADER_SIZE;
+    const uint32_t sizeClass = reinterpret_cast<Header *>(block)->sizeClass;
+    if (sizeClass == MALLOC_CLASS) {
+        free(block);
+    } else {
+        threadCache.deallocate(block, sizeClass);
+    }
+}
+
+ObjectPool::TypeStats *ObjectPool::registerType(const char *name) {
+    SharedPools *pools = getSharedPools();
+    std::lock_guard<std::mutex> lock(pools->typeMutex);
+    pools->types.emplace_back(new TypeStats(name));
+    return pools->types.back().get();
+}
+
+void ObjectPool::getTypeReports(std::vector<TypeReport> *reports) {
+    SharedPools *pools = getSharedPools();
+    std::lock_guard<std::mutex> lock(pools->typeMutex);
+    reports->clear();
+    reports->reserve(pools->types.size());
+    for (const auto &stats : pools->types) {
+        reports->push_back({stats->name, stats->liveCount.load(std::memory_order_relaxed), stats->allocationCount.load(std::memory_order_relaxed)});
+    }
+}
+
+size_t ObjectPool::getReservedBytes() {
+    return getSharedPools()->reservedBytes.load(std::memory_order_relaxed);
+}
+
+namespace detail {
+
+std::string getPoolTypeName(const char *mangledName) {
+#if defined(__GNUC__)
+    int status = 0;
+    char *name = abi::__cxa_demangle(mangledName, nullptr, nullptr, &status);
+    if (status == 0 && name) {
+        std::string result(name);
+        free(name);
+        return result;
+    }
+#endif
+    return mangledName;
+}
+
+} // namespace detail
+
+} // namespace cc
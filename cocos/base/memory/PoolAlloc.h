@@ -0,0 +1,90 @@
+#ifndef CC_CORE_POOL_ALLOC_H_
+#define CC_CORE_POOL_ALLOC_H_
+
+#include "base/Macros.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace cc {
+
+/** Size-class pools for small engine objects. Every thread keeps a cache of free blocks per class, which
+    exchanges batches with the shared lists of the class, so allocating and freeing take no lock most of the time.
+    Blocks freed on another thread than the one allocating them join the cache of the freeing thread.
+    Sizes above MAX_SIZE go to malloc. Pooled memory is kept for reuse, it is never returned to the system.
+*/
+class CC_DLL ObjectPool {
+public:
+    static constexpr size_t GRANULARITY = 16;
+    static constexpr uint32_t CLASS_COUNT = 32;
+    static constexpr size_t MAX_SIZE = GRANULARITY * CLASS_COUNT;
+
+    // Allocations of one type, see PoolAllocPolicy. A type derived from a pooled one is counted with its base.
+    struct TypeStats {
+        std::string name;
+        std::atomic<uint32_t> liveCount{0};
+        std::atomic<uint64_t> allocationCount{0}; // since start
+
+        explicit TypeStats(const char *typeName)
+        : name(typeName) {}
+    };
+
+    struct TypeReport {
+        std::string name;
+        uint32_t liveCount;
+        uint64_t allocationCount;
+    };
+
+    static void *allocate(size_t size);
+    // Keeps the block when size stays in its class, like realloc a null ptr allocates.
+    static void *reallocate(void *ptr, size_t size);
+    static void deallocate(void *ptr);
+
+    // Registers the stats of a type once, the returned stats live until exit.
+    static TypeStats *registerType(const char *name);
+
+    static void getTypeReports(std::vector<TypeReport> *reports);
+    // Memory of the size-class pools, blocks in use or free.
+    static size_t getReservedBytes();
+};
+
+/** Allocation policy for AllocatedObject, allocates from ObjectPool and counts the objects of T.
+    class Texture2D : public cc::Ref, public cc::AllocatedObject<cc::PoolAllocPolicy<Texture2D>>
+*/
+template <class T>
+class PoolAllocPolicy {
+public:
+    static CC_INLINE void *AllocateBytes(size_t count, const char * = nullptr, int = 0, const char * = nullptr) {
+        ObjectPool::TypeStats *stats = getStats();
+        stats->liveCount.fetch_add(1, std::memory_order_relaxed);
+        stats->allocationCount.fetch_add(1, std::memory_order_relaxed);
+        return ObjectPool::allocate(count);
+    }
+
+    static CC_INLINE void DeallocateBytes(void *ptr) {
+        if (!ptr) return;
+        getStats()->liveCount.fetch_sub(1, std::memory_order_relaxed);
+        ObjectPool::deallocate(ptr);
+    }
+
+private:
+    static ObjectPool::TypeStats *getStats();
+};
+
+namespace detail {
+CC_DLL std::string getPoolTypeName(const char *mangledName);
+}
+
+template <class T>
+ObjectPool::TypeStats *PoolAllocPolicy<T>::getStats() {
+    static ObjectPool::TypeStats *stats = ObjectPool::registerType(detail::getPoolTypeName(typeid(T).name()).c_str());
+    return stats;
+}
+
+} // namespace cc
+
+#endif // CC_CORE_POOL_ALLOC_H_
@@ -4,6 +4,7 @@
 #if (CC_MEMORY_ALLOCATOR == CC_MEMORY_ALLOCATOR_STD)
 
 #include "base/Macros.h"
+#include "MemTracker.h"
 #include <limits>
 #include <stdlib.h>
 
@@ -29,6 +30,7 @@ public:
     #ifdef CC_MEMORY_TRACKER
         MemTracker::Instance()->RecordAlloc(ptr, count, file, line, func);
     #endif
+        CC_MEM_SAMPLE_ALLOC(ptr, count, HEAP);
         return ptr;
     }
 
@@ -72,7 +74,10 @@ public:
             }
         }
     #else
-        return realloc(ptr, count);
+        CC_MEM_SAMPLE_FREE(ptr, HEAP);
+        void *nptr = realloc(ptr, count);
+        CC_MEM_SAMPLE_ALLOC(nptr, count, HEAP);
+        return nptr;
     #endif
     }
 
@@ -80,6 +85,7 @@ public:
     #ifdef CC_MEMORY_TRACKER
         MemTracker::Instance()->RecordFree(ptr);
     #endif
+        CC_MEM_SAMPLE_FREE(ptr, HEAP);
         free(ptr);
     }
 
@@ -106,6 +112,7 @@ public:
     #ifdef CC_MEMORY_TRACKER
         MemTracker::Instance()->RecordAlloc(ptr, count, file, line, func);
     #endif
+        CC_MEM_SAMPLE_ALLOC(ptr, count, HEAP);
         return ptr;
     }
 
@@ -113,6 +120,7 @@ public:
     #ifdef CC_MEMORY_TRACKER
         MemTracker::Instance()->RecordFree(ptr);
     #endif
+        CC_MEM_SAMPLE_FREE(ptr, HEAP);
 
     #ifdef _MSC_VER
         _aligned_free(ptr);
@@ -92,6 +92,58 @@ static bool js_audio_AudioProfile_set_minDelay(se::State& s)
 }
 SE_BIND_PROP_SET(js_audio_AudioProfile_set_minDelay)
 
+static bool js_audio_AudioProfile_get_streamingThreshold(se::State& s)
+{
+    cc::AudioProfile* cobj = SE_THIS_OBJECT<cc::AudioProfile>(s);
+    SE_PRECONDITION2(cobj, false, "js_audio_AudioProfile_get_streamingThreshold : Invalid Native Object");
+
+    CC_UNUSED bool ok = true;
+    se::Value jsret;
+    ok &= nativevalue_to_se(cobj->streamingThreshold, jsret, s.thisObject() /*ctx*/);
+    s.rval() = jsret;
+    return true;
+}
+SE_BIND_PROP_GET(js_audio_AudioProfile_get_streamingThreshold)
+
+static bool js_audio_AudioProfile_set_streamingThreshold(se::State& s)
+{
+    const auto& args = s.args();
+    cc::AudioProfile* cobj = SE_THIS_OBJECT<cc::AudioProfile>(s);
+    SE_PRECONDITION2(cobj, false, "js_audio_AudioProfile_set_streamingThreshold : Invalid Native Object");
+
+    CC_UNUSED bool ok = true;
+    ok &= sevalue_to_native(args[0], &cobj->streamingThreshold, s.thisObject());
+    SE_PRECONDITION2(ok, false, "js_audio_AudioProfile_set_streamingThreshold : Error processing new value");
+    return true;
+}
+SE_BIND_PROP_SET(js_audio_AudioProfile_set_streamingThreshold)
+
+static bool js_audio_AudioProfile_get_priority(se::State& s)
+{
+    cc::AudioProfile* cobj = SE_THIS_OBJECT<cc::AudioProfile>(s);
+    SE_PRECONDITION2(cobj, false, "js_audio_AudioProfile_get_priority : Invalid Native Object");
+
+    CC_UNUSED bool ok = true;
+    se::Value jsret;
+    ok &= nativevalue_to_se(cobj->priority, jsret, s.thisObject() /*ctx*/);
+    s.rval() = jsret;
+    return true;
+}
+SE_BIND_PROP_GET(js_audio_AudioProfile_get_priority)
+
+static bool js_audio_AudioProfile_set_priority(se::State& s)
+{
+    const auto& args = s.args();
+    cc::AudioProfile* cobj = SE_THIS_OBJECT<cc::AudioProfile>(s);
+    SE_PRECONDITION2(cobj, false, "js_audio_AudioProfile_set_priority : Invalid Native Object");
+
+    CC_UNUSED bool ok = true;
+    ok &= sevalue_to_native(args[0], &cobj->priority, s.thisObject());
+    SE_PRECONDITION2(ok, false, "js_audio_AudioProfile_set_priority : Error processing new value");
+    return true;
+}
+SE_BIND_PROP_SET(js_audio_AudioProfile_set_priority)
+
 SE_DECLARE_FINALIZE_FUNC(js_cc_AudioProfile_finalize)
 
 static bool js_audio_AudioProfile_constructor(se::State& s) // constructor.c
@@ -126,6 +178,8 @@ bool js_register_audio_AudioProfile(se::Object* obj)
     cls->defineProperty("name", _SE(js_audio_AudioProfile_get_name), _SE(js_audio_AudioProfile_set_name));
     cls->defineProperty("maxInstances", _SE(js_audio_AudioProfile_get_maxInstances), _SE(js_audio_AudioProfile_set_maxInstances));
     cls->defineProperty("minDelay", _SE(js_audio_AudioProfile_get_minDelay), _SE(js_audio_AudioProfile_set_minDelay));
+    cls->defineProperty("streamingThreshold", _SE(js_audio_AudioProfile_get_streamingThreshold), _SE(js_audio_AudioProfile_set_streamingThreshold));
+    cls->defineProperty("priority", _SE(js_audio_AudioProfile_get_priority), _SE(js_audio_AudioProfile_set_priority));
     cls->defineFinalizeFunction(_SE(js_cc_AudioProfile_finalize));
     cls->install();
     JSBClassType::registerClass<cc::AudioProfile>(cls);
@@ -358,6 +412,140 @@ static bool js_audio_AudioEngine_setMaxAudioInstance(se::State& s)
 }
 SE_BIND_FUNC(js_audio_AudioEngine_setMaxAudioInstance)
 
+static bool js_audio_AudioEngine_getMaxVirtualAudioInstance(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        int result = cc::AudioEngine::getMaxVirtualAudioInstance();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_audio_AudioEngine_getMaxVirtualAudioInstance : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_audio_AudioEngine_getMaxVirtualAudioInstance)
+
+static bool js_audio_AudioEngine_setMaxVirtualAudioInstance(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<int, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, nullptr);
+        SE_PRECONDITION2(ok, false, "js_audio_AudioEngine_setMaxVirtualAudioInstance : Error processing arguments");
+        cc::AudioEngine::setMaxVirtualAudioInstance(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_audio_AudioEngine_setMaxVirtualAudioInstance)
+
+static bool js_audio_AudioEngine_isVirtual(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<int, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, nullptr);
+        SE_PRECONDITION2(ok, false, "js_audio_AudioEngine_isVirtual : Error processing arguments");
+        bool result = cc::AudioEngine::isVirtual(arg0.value());
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_audio_AudioEngine_isVirtual : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_audio_AudioEngine_isVirtual)
+
+static bool js_audio_AudioEngine_setCacheBudget(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<unsigned int, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, nullptr);
+        SE_PRECONDITION2(ok, false, "js_audio_AudioEngine_setCacheBudget : Error processing arguments");
+        cc::AudioEngine::setCacheBudget(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_audio_AudioEngine_setCacheBudget)
+
+static bool js_audio_AudioEngine_getCacheBudget(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        unsigned int result = cc::AudioEngine::getCacheBudget();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_audio_AudioEngine_getCacheBudget : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_audio_AudioEngine_getCacheBudget)
+
+static bool js_audio_AudioEngine_getCacheSize(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        unsigned int result = cc::AudioEngine::getCacheSize();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_audio_AudioEngine_getCacheSize : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_audio_AudioEngine_getCacheSize)
+
+static bool js_audio_AudioEngine_setCacheCompressionEnabled(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<bool, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, nullptr);
+        SE_PRECONDITION2(ok, false, "js_audio_AudioEngine_setCacheCompressionEnabled : Error processing arguments");
+        cc::AudioEngine::setCacheCompressionEnabled(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_audio_AudioEngine_setCacheCompressionEnabled)
+
+static bool js_audio_AudioEngine_isCacheCompressionEnabled(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cc::AudioEngine::isCacheCompressionEnabled();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_audio_AudioEngine_isCacheCompressionEnabled : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_audio_AudioEngine_isCacheCompressionEnabled)
+
 static bool js_audio_AudioEngine_isLoop(se::State& s)
 {
     const auto& args = s.args();
@@ -482,6 +670,60 @@ static bool js_audio_AudioEngine_preload(se::State& s)
 }
 SE_BIND_FUNC(js_audio_AudioEngine_preload)
 
+static bool js_audio_AudioEngine_preloadBatch(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 2) {
+        HolderType<std::vector<std::string>, true> arg0 = {};
+        HolderType<std::function<void (unsigned int, unsigned int, unsigned int)>, true> arg1 = {};
+        ok &= sevalue_to_native(args[0], &arg0, nullptr);
+        do {
+            if (args[1].isObject() && args[1].toObject()->isFunction())
+            {
+                se::Value jsThis(s.thisObject());
+                se::Value jsFunc(args[1]);
+                jsFunc.toObject()->root();
+                auto lambda = [=](unsigned int larg0, unsigned int larg1, unsigned int larg2) -> void {
+                    se::ScriptEngine::getInstance()->clearException();
+                    se::AutoHandleScope hs;
+        
+                    CC_UNUSED bool ok = true;
+                    se::ValueArray args;
+                    args.resize(3);
+                    ok &= nativevalue_to_se(larg0, args[0], nullptr /*ctx*/);
+                    ok &= nativevalue_to_se(larg1, args[1], nullptr /*ctx*/);
+                    ok &= nativevalue_to_se(larg2, args[2], nullptr /*ctx*/);
+                    se::Value rval;
+                    se::Object* thisObj = jsThis.isObject() ? jsThis.toObject() : nullptr;
+                    se::Object* funcObj = jsFunc.toObject();
+                    bool succeed = funcObj->call(args, thisObj, &rval);
+                    if (!succeed) {
+                        se::ScriptEngine::getInstance()->clearException();
+                    }
+                    // the last progress of the batch
+                    if (larg0 == larg1) {
+                        funcObj->unroot();
+                    }
+                };
+                arg1.data = lambda;
+            }
+            else
+            {
+                arg1.data = nullptr;
+            }
+        } while(false)
+        ;
+        SE_PRECONDITION2(ok, false, "js_audio_AudioEngine_preloadBatch : Error processing arguments");
+        cc::AudioEngine::preloadBatch(arg0.value(), arg1.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 2);
+    return false;
+}
+SE_BIND_FUNC(js_audio_AudioEngine_preloadBatch)
+
 static bool js_audio_AudioEngine_setEnabled(se::State& s)
 {
     const auto& args = s.args();
@@ -781,11 +1023,20 @@ bool js_register_audio_AudioEngine(se::Object* obj)
     cls->defineStaticFunction("getDurationFromFile", _SE(js_audio_AudioEngine_getDurationFromFile));
     cls->defineStaticFunction("getCurrentTime", _SE(js_audio_AudioEngine_getCurrentTime));
     cls->defineStaticFunction("setMaxAudioInstance", _SE(js_audio_AudioEngine_setMaxAudioInstance));
+    cls->defineStaticFunction("getMaxVirtualAudioInstance", _SE(js_audio_AudioEngine_getMaxVirtualAudioInstance));
+    cls->defineStaticFunction("setMaxVirtualAudioInstance", _SE(js_audio_AudioEngine_setMaxVirtualAudioInstance));
+    cls->defineStaticFunction("isVirtual", _SE(js_audio_AudioEngine_isVirtual));
+    cls->defineStaticFunction("setCacheBudget", _SE(js_audio_AudioEngine_setCacheBudget));
+    cls->defineStaticFunction("getCacheBudget", _SE(js_audio_AudioEngine_getCacheBudget));
+    cls->defineStaticFunction("getCacheSize", _SE(js_audio_AudioEngine_getCacheSize));
+    cls->defineStaticFunction("setCacheCompressionEnabled", _SE(js_audio_AudioEngine_setCacheCompressionEnabled));
+    cls->defineStaticFunction("isCacheCompressionEnabled", _SE(js_audio_AudioEngine_isCacheCompressionEnabled));
     cls->defineStaticFunction("isLoop", _SE(js_audio_AudioEngine_isLoop));
     cls->defineStaticFunction("pauseAll", _SE(js_audio_AudioEngine_pauseAll));
     cls->defineStaticFunction("uncacheAll", _SE(js_audio_AudioEngine_uncacheAll));
     cls->defineStaticFunction("setVolume", _SE(js_audio_AudioEngine_setVolume));
     cls->defineStaticFunction("preload", _SE(js_audio_AudioEngine_preload));
+    cls->defineStaticFunction("preloadBatch", _SE(js_audio_AudioEngine_preloadBatch));
     cls->defineStaticFunction("setEnabled", _SE(js_audio_AudioEngine_setEnabled));
     cls->defineStaticFunction("play2d", _SE(js_audio_AudioEngine_play2d));
     cls->defineStaticFunction("getState", _SE(js_audio_AudioEngine_getState));
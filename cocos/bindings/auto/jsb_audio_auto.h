@@ -35,11 +35,20 @@ SE_DECLARE_FUNC(js_audio_AudioEngine_isEnabled);
 SE_DECLARE_FUNC(js_audio_AudioEngine_getDurationFromFile);
 SE_DECLARE_FUNC(js_audio_AudioEngine_getCurrentTime);
 SE_DECLARE_FUNC(js_audio_AudioEngine_setMaxAudioInstance);
+SE_DECLARE_FUNC(js_audio_AudioEngine_getMaxVirtualAudioInstance);
+SE_DECLARE_FUNC(js_audio_AudioEngine_setMaxVirtualAudioInstance);
+SE_DECLARE_FUNC(js_audio_AudioEngine_isVirtual);
+SE_DECLARE_FUNC(js_audio_AudioEngine_setCacheBudget);
+SE_DECLARE_FUNC(js_audio_AudioEngine_getCacheBudget);
+SE_DECLARE_FUNC(js_audio_AudioEngine_getCacheSize);
+SE_DECLARE_FUNC(js_audio_AudioEngine_setCacheCompressionEnabled);
+SE_DECLARE_FUNC(js_audio_AudioEngine_isCacheCompressionEnabled);
 SE_DECLARE_FUNC(js_audio_AudioEngine_isLoop);
 SE_DECLARE_FUNC(js_audio_AudioEngine_pauseAll);
 SE_DECLARE_FUNC(js_audio_AudioEngine_uncacheAll);
 SE_DECLARE_FUNC(js_audio_AudioEngine_setVolume);
 SE_DECLARE_FUNC(js_audio_AudioEngine_preload);
+SE_DECLARE_FUNC(js_audio_AudioEngine_preloadBatch);
 SE_DECLARE_FUNC(js_audio_AudioEngine_setEnabled);
 SE_DECLARE_FUNC(js_audio_AudioEngine_play2d);
 SE_DECLARE_FUNC(js_audio_AudioEngine_getState);
@@ -968,6 +968,41 @@ static bool js_engine_Device_getBatteryLevel(se::State& s)
 }
 SE_BIND_FUNC(js_engine_Device_getBatteryLevel)
 
+static bool js_engine_Device_getThermalState(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        int result = (int)cc::Device::getThermalState();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_engine_Device_getThermalState : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_engine_Device_getThermalState)
+
+static bool js_engine_Device_getThermalHeadroom(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<int, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, nullptr);
+        SE_PRECONDITION2(ok, false, "js_engine_Device_getThermalHeadroom : Error processing arguments");
+        float result = cc::Device::getThermalHeadroom(arg0.value());
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_engine_Device_getThermalHeadroom : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_engine_Device_getThermalHeadroom)
+
 static bool js_engine_Device_getDeviceOrientation(se::State& s)
 {
     const auto& args = s.args();
@@ -1046,6 +1081,8 @@ bool js_register_engine_Device(se::Object* obj)
     cls->defineStaticFunction("setKeepScreenOn", _SE(js_engine_Device_setKeepScreenOn));
     cls->defineStaticFunction("getNetworkType", _SE(js_engine_Device_getNetworkType));
     cls->defineStaticFunction("getBatteryLevel", _SE(js_engine_Device_getBatteryLevel));
+    cls->defineStaticFunction("getThermalState", _SE(js_engine_Device_getThermalState));
+    cls->defineStaticFunction("getThermalHeadroom", _SE(js_engine_Device_getThermalHeadroom));
     cls->defineStaticFunction("getDeviceOrientation", _SE(js_engine_Device_getDeviceOrientation));
     cls->defineStaticFunction("getDPI", _SE(js_engine_Device_getDPI));
     cls->defineStaticFunction("getSafeAreaEdge", _SE(js_engine_Device_getSafeAreaEdge));
@@ -3,6 +3,7 @@
 #include "cocos/bindings/manual/jsb_global.h"
 #include "editor-support/middleware-adapter.h"
 #include "editor-support/MiddlewareManager.h"
+#include "editor-support/ParticleEmitter.h"
 #include "editor-support/SharedBufferManager.h"
 
 #ifndef JSB_ALLOC
@@ -355,6 +356,255 @@ bool js_register_editor_support_SharedBufferManager(se::Object* obj)
     return true;
 }
 
+se::Object* __jsb_cc_middleware_ParticleEmitter_proto = nullptr;
+se::Class* __jsb_cc_middleware_ParticleEmitter_class = nullptr;
+
+static bool js_editor_support_ParticleEmitter_clearInstancedModel(se::State& s)
+{
+    cc::middleware::ParticleEmitter* cobj = SE_THIS_OBJECT<cc::middleware::ParticleEmitter>(s);
+    SE_PRECONDITION2(cobj, false, "js_editor_support_ParticleEmitter_clearInstancedModel : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        cobj->clearInstancedModel();
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_editor_support_ParticleEmitter_clearInstancedModel)
+
+static bool js_editor_support_ParticleEmitter_getMaxParticles(se::State& s)
+{
+    cc::middleware::ParticleEmitter* cobj = SE_THIS_OBJECT<cc::middleware::ParticleEmitter>(s);
+    SE_PRECONDITION2(cobj, false, "js_editor_support_ParticleEmitter_getMaxParticles : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        unsigned int result = cobj->getMaxParticles();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_editor_support_ParticleEmitter_getMaxParticles : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_editor_support_ParticleEmitter_getMaxParticles)
+
+static bool js_editor_support_ParticleEmitter_getParamsBuffer(se::State& s)
+{
+    cc::middleware::ParticleEmitter* cobj = SE_THIS_OBJECT<cc::middleware::ParticleEmitter>(s);
+    SE_PRECONDITION2(cobj, false, "js_editor_support_ParticleEmitter_getParamsBuffer : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        se_object_ptr result = cobj->getParamsBuffer();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_editor_support_ParticleEmitter_getParamsBuffer : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_editor_support_ParticleEmitter_getParamsBuffer)
+
+static bool js_editor_support_ParticleEmitter_getParticleCount(se::State& s)
+{
+    cc::middleware::ParticleEmitter* cobj = SE_THIS_OBJECT<cc::middleware::ParticleEmitter>(s);
+    SE_PRECONDITION2(cobj, false, "js_editor_support_ParticleEmitter_getParticleCount : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        unsigned int result = cobj->getParticleCount();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_editor_support_ParticleEmitter_getParticleCount : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_editor_support_ParticleEmitter_getParticleCount)
+
+static bool js_editor_support_ParticleEmitter_getSharedBufferOffset(se::State& s)
+{
+    cc::middleware::ParticleEmitter* cobj = SE_THIS_OBJECT<cc::middleware::ParticleEmitter>(s);
+    SE_PRECONDITION2(cobj, false, "js_editor_support_ParticleEmitter_getSharedBufferOffset : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        se_object_ptr result = cobj->getSharedBufferOffset();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_editor_support_ParticleEmitter_getSharedBufferOffset : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_editor_support_ParticleEmitter_getSharedBufferOffset)
+
+static bool js_editor_support_ParticleEmitter_isInstanced(se::State& s)
+{
+    cc::middleware::ParticleEmitter* cobj = SE_THIS_OBJECT<cc::middleware::ParticleEmitter>(s);
+    SE_PRECONDITION2(cobj, false, "js_editor_support_ParticleEmitter_isInstanced : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isInstanced();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_editor_support_ParticleEmitter_isInstanced : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_editor_support_ParticleEmitter_isInstanced)
+
+static bool js_editor_support_ParticleEmitter_onDisable(se::State& s)
+{
+    cc::middleware::ParticleEmitter* cobj = SE_THIS_OBJECT<cc::middleware::ParticleEmitter>(s);
+    SE_PRECONDITION2(cobj, false, "js_editor_support_ParticleEmitter_onDisable : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        cobj->onDisable();
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_editor_support_ParticleEmitter_onDisable)
+
+static bool js_editor_support_ParticleEmitter_onEnable(se::State& s)
+{
+    cc::middleware::ParticleEmitter* cobj = SE_THIS_OBJECT<cc::middleware::ParticleEmitter>(s);
+    SE_PRECONDITION2(cobj, false, "js_editor_support_ParticleEmitter_onEnable : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        cobj->onEnable();
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_editor_support_ParticleEmitter_onEnable)
+
+static bool js_editor_support_ParticleEmitter_reset(se::State& s)
+{
+    cc::middleware::ParticleEmitter* cobj = SE_THIS_OBJECT<cc::middleware::ParticleEmitter>(s);
+    SE_PRECONDITION2(cobj, false, "js_editor_support_ParticleEmitter_reset : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        cobj->reset();
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_editor_support_ParticleEmitter_reset)
+
+static bool js_editor_support_ParticleEmitter_setInstancedModel(se::State& s)
+{
+    cc::middleware::ParticleEmitter* cobj = SE_THIS_OBJECT<cc::middleware::ParticleEmitter>(s);
+    SE_PRECONDITION2(cobj, false, "js_editor_support_ParticleEmitter_setInstancedModel : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<unsigned int, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_editor_support_ParticleEmitter_setInstancedModel : Error processing arguments");
+        cobj->setInstancedModel(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_editor_support_ParticleEmitter_setInstancedModel)
+
+static bool js_editor_support_ParticleEmitter_setMaxParticles(se::State& s)
+{
+    cc::middleware::ParticleEmitter* cobj = SE_THIS_OBJECT<cc::middleware::ParticleEmitter>(s);
+    SE_PRECONDITION2(cobj, false, "js_editor_support_ParticleEmitter_setMaxParticles : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<unsigned int, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_editor_support_ParticleEmitter_setMaxParticles : Error processing arguments");
+        cobj->setMaxParticles(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_editor_support_ParticleEmitter_setMaxParticles)
+
+SE_DECLARE_FINALIZE_FUNC(js_cc_middleware_ParticleEmitter_finalize)
+
+static bool js_editor_support_ParticleEmitter_constructor(se::State& s) // constructor.c
+{
+    CC_UNUSED bool ok = true;
+    const auto& args = s.args();
+    unsigned int arg0 = 0;
+    ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+    SE_PRECONDITION2(ok, false, "js_editor_support_ParticleEmitter_constructor : Error processing arguments");
+    cc::middleware::ParticleEmitter* cobj = JSB_ALLOC(cc::middleware::ParticleEmitter, arg0);
+    s.thisObject()->setPrivateData(cobj);
+    se::NonRefNativePtrCreatedByCtorMap::emplace(cobj);
+    return true;
+}
+SE_BIND_CTOR(js_editor_support_ParticleEmitter_constructor, __jsb_cc_middleware_ParticleEmitter_class, js_cc_middleware_ParticleEmitter_finalize)
+
+
+
+
+static bool js_cc_middleware_ParticleEmitter_finalize(se::State& s)
+{
+    auto iter = se::NonRefNativePtrCreatedByCtorMap::find(SE_THIS_OBJECT<cc::middleware::ParticleEmitter>(s));
+    if (iter != se::NonRefNativePtrCreatedByCtorMap::end())
+    {
+        se::NonRefNativePtrCreatedByCtorMap::erase(iter);
+        cc::middleware::ParticleEmitter* cobj = SE_THIS_OBJECT<cc::middleware::ParticleEmitter>(s);
+        JSB_FREE(cobj);
+    }
+    return true;
+}
+SE_BIND_FINALIZE_FUNC(js_cc_middleware_ParticleEmitter_finalize)
+
+bool js_register_editor_support_ParticleEmitter(se::Object* obj)
+{
+    auto cls = se::Class::create("ParticleEmitter", obj, nullptr, _SE(js_editor_support_ParticleEmitter_constructor));
+
+    cls->defineFunction("clearInstancedModel", _SE(js_editor_support_ParticleEmitter_clearInstancedModel));
+    cls->defineFunction("getMaxParticles", _SE(js_editor_support_ParticleEmitter_getMaxParticles));
+    cls->defineFunction("getParamsBuffer", _SE(js_editor_support_ParticleEmitter_getParamsBuffer));
+    cls->defineFunction("getParticleCount", _SE(js_editor_support_ParticleEmitter_getParticleCount));
+    cls->defineFunction("getSharedBufferOffset", _SE(js_editor_support_ParticleEmitter_getSharedBufferOffset));
+    cls->defineFunction("isInstanced", _SE(js_editor_support_ParticleEmitter_isInstanced));
+    cls->defineFunction("onDisable", _SE(js_editor_support_ParticleEmitter_onDisable));
+    cls->defineFunction("onEnable", _SE(js_editor_support_ParticleEmitter_onEnable));
+    cls->defineFunction("reset", _SE(js_editor_support_ParticleEmitter_reset));
+    cls->defineFunction("setInstancedModel", _SE(js_editor_support_ParticleEmitter_setInstancedModel));
+    cls->defineFunction("setMaxParticles", _SE(js_editor_support_ParticleEmitter_setMaxParticles));
+    cls->defineFinalizeFunction(_SE(js_cc_middleware_ParticleEmitter_finalize));
+    cls->install();
+    JSBClassType::registerClass<cc::middleware::ParticleEmitter>(cls);
+
+    __jsb_cc_middleware_ParticleEmitter_proto = cls->getProto();
+    __jsb_cc_middleware_ParticleEmitter_class = cls;
+
+    se::ScriptEngine::getInstance()->clearException();
+    return true;
+}
+
 se::Object* __jsb_cc_middleware_MiddlewareManager_proto = nullptr;
 se::Class* __jsb_cc_middleware_MiddlewareManager_class = nullptr;
 
@@ -397,6 +647,52 @@ static bool js_editor_support_MiddlewareManager_getBufferCount(se::State& s)
 }
 SE_BIND_FUNC(js_editor_support_MiddlewareManager_getBufferCount)
 
+static bool js_editor_support_MiddlewareManager_getGFXIndexBuffer(se::State& s)
+{
+    cc::middleware::MiddlewareManager* cobj = SE_THIS_OBJECT<cc::middleware::MiddlewareManager>(s);
+    SE_PRECONDITION2(cobj, false, "js_editor_support_MiddlewareManager_getGFXIndexBuffer : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 2) {
+        HolderType<int, false> arg0 = {};
+        HolderType<int, false> arg1 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        ok &= sevalue_to_native(args[1], &arg1, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_editor_support_MiddlewareManager_getGFXIndexBuffer : Error processing arguments");
+        cc::gfx::Buffer* result = cobj->getGFXIndexBuffer(arg0.value(), arg1.value());
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_editor_support_MiddlewareManager_getGFXIndexBuffer : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 2);
+    return false;
+}
+SE_BIND_FUNC(js_editor_support_MiddlewareManager_getGFXIndexBuffer)
+
+static bool js_editor_support_MiddlewareManager_getGFXVertexBuffer(se::State& s)
+{
+    cc::middleware::MiddlewareManager* cobj = SE_THIS_OBJECT<cc::middleware::MiddlewareManager>(s);
+    SE_PRECONDITION2(cobj, false, "js_editor_support_MiddlewareManager_getGFXVertexBuffer : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 2) {
+        HolderType<int, false> arg0 = {};
+        HolderType<int, false> arg1 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        ok &= sevalue_to_native(args[1], &arg1, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_editor_support_MiddlewareManager_getGFXVertexBuffer : Error processing arguments");
+        cc::gfx::Buffer* result = cobj->getGFXVertexBuffer(arg0.value(), arg1.value());
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_editor_support_MiddlewareManager_getGFXVertexBuffer : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 2);
+    return false;
+}
+SE_BIND_FUNC(js_editor_support_MiddlewareManager_getGFXVertexBuffer)
+
 static bool js_editor_support_MiddlewareManager_getIBTypedArray(se::State& s)
 {
     cc::middleware::MiddlewareManager* cobj = SE_THIS_OBJECT<cc::middleware::MiddlewareManager>(s);
@@ -443,6 +739,29 @@ static bool js_editor_support_MiddlewareManager_getIBTypedArrayLength(se::State&
 }
 SE_BIND_FUNC(js_editor_support_MiddlewareManager_getIBTypedArrayLength)
 
+static bool js_editor_support_MiddlewareManager_getInputAssembler(se::State& s)
+{
+    cc::middleware::MiddlewareManager* cobj = SE_THIS_OBJECT<cc::middleware::MiddlewareManager>(s);
+    SE_PRECONDITION2(cobj, false, "js_editor_support_MiddlewareManager_getInputAssembler : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 2) {
+        HolderType<int, false> arg0 = {};
+        HolderType<int, false> arg1 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        ok &= sevalue_to_native(args[1], &arg1, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_editor_support_MiddlewareManager_getInputAssembler : Error processing arguments");
+        cc::gfx::InputAssembler* result = cobj->getInputAssembler(arg0.value(), arg1.value());
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_editor_support_MiddlewareManager_getInputAssembler : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 2);
+    return false;
+}
+SE_BIND_FUNC(js_editor_support_MiddlewareManager_getInputAssembler)
+
 static bool js_editor_support_MiddlewareManager_getRenderInfoMgr(se::State& s)
 {
     cc::middleware::MiddlewareManager* cobj = SE_THIS_OBJECT<cc::middleware::MiddlewareManager>(s);
@@ -507,6 +826,24 @@ static bool js_editor_support_MiddlewareManager_getVBTypedArrayLength(se::State&
 }
 SE_BIND_FUNC(js_editor_support_MiddlewareManager_getVBTypedArrayLength)
 
+static bool js_editor_support_MiddlewareManager_isNativeBuffersEnabled(se::State& s)
+{
+    cc::middleware::MiddlewareManager* cobj = SE_THIS_OBJECT<cc::middleware::MiddlewareManager>(s);
+    SE_PRECONDITION2(cobj, false, "js_editor_support_MiddlewareManager_isNativeBuffersEnabled : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isNativeBuffersEnabled();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_editor_support_MiddlewareManager_isNativeBuffersEnabled : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_editor_support_MiddlewareManager_isNativeBuffersEnabled)
+
 static bool js_editor_support_MiddlewareManager_render(se::State& s)
 {
     cc::middleware::MiddlewareManager* cobj = SE_THIS_OBJECT<cc::middleware::MiddlewareManager>(s);
@@ -526,6 +863,25 @@ static bool js_editor_support_MiddlewareManager_render(se::State& s)
 }
 SE_BIND_FUNC(js_editor_support_MiddlewareManager_render)
 
+static bool js_editor_support_MiddlewareManager_setNativeBuffersEnabled(se::State& s)
+{
+    cc::middleware::MiddlewareManager* cobj = SE_THIS_OBJECT<cc::middleware::MiddlewareManager>(s);
+    SE_PRECONDITION2(cobj, false, "js_editor_support_MiddlewareManager_setNativeBuffersEnabled : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<bool, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_editor_support_MiddlewareManager_setNativeBuffersEnabled : Error processing arguments");
+        cobj->setNativeBuffersEnabled(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_editor_support_MiddlewareManager_setNativeBuffersEnabled)
+
 static bool js_editor_support_MiddlewareManager_update(se::State& s)
 {
     cc::middleware::MiddlewareManager* cobj = SE_THIS_OBJECT<cc::middleware::MiddlewareManager>(s);
@@ -623,12 +979,17 @@ bool js_register_editor_support_MiddlewareManager(se::Object* obj)
 
     cls->defineFunction("getAttachInfoMgr", _SE(js_editor_support_MiddlewareManager_getAttachInfoMgr));
     cls->defineFunction("getBufferCount", _SE(js_editor_support_MiddlewareManager_getBufferCount));
+    cls->defineFunction("getGFXIndexBuffer", _SE(js_editor_support_MiddlewareManager_getGFXIndexBuffer));
+    cls->defineFunction("getGFXVertexBuffer", _SE(js_editor_support_MiddlewareManager_getGFXVertexBuffer));
     cls->defineFunction("getIBTypedArray", _SE(js_editor_support_MiddlewareManager_getIBTypedArray));
     cls->defineFunction("getIBTypedArrayLength", _SE(js_editor_support_MiddlewareManager_getIBTypedArrayLength));
+    cls->defineFunction("getInputAssembler", _SE(js_editor_support_MiddlewareManager_getInputAssembler));
     cls->defineFunction("getRenderInfoMgr", _SE(js_editor_support_MiddlewareManager_getRenderInfoMgr));
     cls->defineFunction("getVBTypedArray", _SE(js_editor_support_MiddlewareManager_getVBTypedArray));
     cls->defineFunction("getVBTypedArrayLength", _SE(js_editor_support_MiddlewareManager_getVBTypedArrayLength));
+    cls->defineFunction("isNativeBuffersEnabled", _SE(js_editor_support_MiddlewareManager_isNativeBuffersEnabled));
     cls->defineFunction("render", _SE(js_editor_support_MiddlewareManager_render));
+    cls->defineFunction("setNativeBuffersEnabled", _SE(js_editor_support_MiddlewareManager_setNativeBuffersEnabled));
     cls->defineFunction("update", _SE(js_editor_support_MiddlewareManager_update));
     cls->defineStaticFunction("destroyInstance", _SE(js_editor_support_MiddlewareManager_destroyInstance));
     cls->defineStaticFunction("generateModuleID", _SE(js_editor_support_MiddlewareManager_generateModuleID));
@@ -657,6 +1018,7 @@ bool register_all_editor_support(se::Object* obj)
     se::Object* ns = nsVal.toObject();
 
     js_register_editor_support_MiddlewareManager(ns);
+    js_register_editor_support_ParticleEmitter(ns);
     js_register_editor_support_SharedBufferManager(ns);
     js_register_editor_support_Texture2D(ns);
     return true;
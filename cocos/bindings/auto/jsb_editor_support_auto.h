@@ -3,8 +3,10 @@
 #include <type_traits>
 #include "cocos/bindings/jswrapper/SeApi.h"
 #include "cocos/bindings/manual/jsb_conversions.h"
+#include "cocos/bindings/auto/jsb_gfx_auto.h"
 #include "cocos/editor-support/middleware-adapter.h"
 #include "cocos/editor-support/MiddlewareManager.h"
+#include "cocos/editor-support/ParticleEmitter.h"
 #include "cocos/editor-support/SharedBufferManager.h"
 
 extern se::Object* __jsb_cc_middleware_Texture2D_proto;
@@ -44,15 +46,39 @@ bool register_all_editor_support(se::Object* obj);
 JSB_REGISTER_OBJECT_TYPE(cc::middleware::MiddlewareManager);
 SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_getAttachInfoMgr);
 SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_getBufferCount);
+SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_getGFXIndexBuffer);
+SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_getGFXVertexBuffer);
 SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_getIBTypedArray);
 SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_getIBTypedArrayLength);
+SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_getInputAssembler);
 SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_getRenderInfoMgr);
 SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_getVBTypedArray);
 SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_getVBTypedArrayLength);
+SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_isNativeBuffersEnabled);
 SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_render);
+SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_setNativeBuffersEnabled);
 SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_update);
 SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_destroyInstance);
 SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_generateModuleID);
 SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_getInstance);
 SE_DECLARE_FUNC(js_editor_support_MiddlewareManager_MiddlewareManager);
 
+extern se::Object* __jsb_cc_middleware_ParticleEmitter_proto;
+extern se::Class* __jsb_cc_middleware_ParticleEmitter_class;
+
+bool js_register_cc_middleware_ParticleEmitter(se::Object* obj);
+bool register_all_editor_support(se::Object* obj);
+
+JSB_REGISTER_OBJECT_TYPE(cc::middleware::ParticleEmitter);
+SE_DECLARE_FUNC(js_editor_support_ParticleEmitter_clearInstancedModel);
+SE_DECLARE_FUNC(js_editor_support_ParticleEmitter_getMaxParticles);
+SE_DECLARE_FUNC(js_editor_support_ParticleEmitter_getParamsBuffer);
+SE_DECLARE_FUNC(js_editor_support_ParticleEmitter_getParticleCount);
+SE_DECLARE_FUNC(js_editor_support_ParticleEmitter_getSharedBufferOffset);
+SE_DECLARE_FUNC(js_editor_support_ParticleEmitter_isInstanced);
+SE_DECLARE_FUNC(js_editor_support_ParticleEmitter_onDisable);
+SE_DECLARE_FUNC(js_editor_support_ParticleEmitter_onEnable);
+SE_DECLARE_FUNC(js_editor_support_ParticleEmitter_reset);
+SE_DECLARE_FUNC(js_editor_support_ParticleEmitter_setInstancedModel);
+SE_DECLARE_FUNC(js_editor_support_ParticleEmitter_setMaxParticles);
+SE_DECLARE_FUNC(js_editor_support_ParticleEmitter_ParticleEmitter);
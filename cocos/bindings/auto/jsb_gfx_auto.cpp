@@ -301,15 +301,15 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::Offset * to, se::Object *
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("x", &field);
+    json->getProperty("x", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->x), ctx);
     }
-    json->getProperty("y", &field);
+    json->getProperty("y", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->y), ctx);
     }
-    json->getProperty("z", &field);
+    json->getProperty("z", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->z), ctx);
     }
@@ -531,19 +531,19 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::Rect * to, se::Object *ct
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("x", &field);
+    json->getProperty("x", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->x), ctx);
     }
-    json->getProperty("y", &field);
+    json->getProperty("y", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->y), ctx);
     }
-    json->getProperty("width", &field);
+    json->getProperty("width", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->width), ctx);
     }
-    json->getProperty("height", &field);
+    json->getProperty("height", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->height), ctx);
     }
@@ -743,15 +743,15 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::Extent * to, se::Object *
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("width", &field);
+    json->getProperty("width", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->width), ctx);
     }
-    json->getProperty("height", &field);
+    json->getProperty("height", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->height), ctx);
     }
-    json->getProperty("depth", &field);
+    json->getProperty("depth", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->depth), ctx);
     }
@@ -947,15 +947,15 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::TextureSubres * to, se::O
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("mipLevel", &field);
+    json->getProperty("mipLevel", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->mipLevel), ctx);
     }
-    json->getProperty("baseArrayLayer", &field);
+    json->getProperty("baseArrayLayer", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->baseArrayLayer), ctx);
     }
-    json->getProperty("layerCount", &field);
+    json->getProperty("layerCount", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->layerCount), ctx);
     }
@@ -1203,23 +1203,23 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::BufferTextureCopy * to, s
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("buffStride", &field);
+    json->getProperty("buffStride", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->buffStride), ctx);
     }
-    json->getProperty("buffTexHeight", &field);
+    json->getProperty("buffTexHeight", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->buffTexHeight), ctx);
     }
-    json->getProperty("texOffset", &field);
+    json->getProperty("texOffset", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->texOffset), ctx);
     }
-    json->getProperty("texExtent", &field);
+    json->getProperty("texExtent", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->texExtent), ctx);
     }
-    json->getProperty("texSubres", &field);
+    json->getProperty("texSubres", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->texSubres), ctx);
     }
@@ -1449,19 +1449,19 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::Color * to, se::Object *c
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("x", &field);
+    json->getProperty("x", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->x), ctx);
     }
-    json->getProperty("y", &field);
+    json->getProperty("y", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->y), ctx);
     }
-    json->getProperty("z", &field);
+    json->getProperty("z", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->z), ctx);
     }
-    json->getProperty("w", &field);
+    json->getProperty("w", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->w), ctx);
     }
@@ -1661,15 +1661,15 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::BindingMappingInfo * to,
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("bufferOffsets", &field);
+    json->getProperty("bufferOffsets", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->bufferOffsets), ctx);
     }
-    json->getProperty("samplerOffsets", &field);
+    json->getProperty("samplerOffsets", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->samplerOffsets), ctx);
     }
-    json->getProperty("flexibleSet", &field);
+    json->getProperty("flexibleSet", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->flexibleSet), ctx);
     }
@@ -1956,6 +1956,32 @@ static bool js_gfx_DeviceInfo_set_bindingMappingInfo(se::State& s)
 }
 SE_BIND_PROP_SET(js_gfx_DeviceInfo_set_bindingMappingInfo)
 
+static bool js_gfx_DeviceInfo_get_multithreaded(se::State& s)
+{
+    cc::gfx::DeviceInfo* cobj = SE_THIS_OBJECT<cc::gfx::DeviceInfo>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_DeviceInfo_get_multithreaded : Invalid Native Object");
+
+    CC_UNUSED bool ok = true;
+    se::Value jsret;
+    ok &= nativevalue_to_se(cobj->multithreaded, jsret, s.thisObject() /*ctx*/);
+    s.rval() = jsret;
+    return true;
+}
+SE_BIND_PROP_GET(js_gfx_DeviceInfo_get_multithreaded)
+
+static bool js_gfx_DeviceInfo_set_multithreaded(se::State& s)
+{
+    const auto& args = s.args();
+    cc::gfx::DeviceInfo* cobj = SE_THIS_OBJECT<cc::gfx::DeviceInfo>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_DeviceInfo_set_multithreaded : Invalid Native Object");
+
+    CC_UNUSED bool ok = true;
+    ok &= sevalue_to_native(args[0], &cobj->multithreaded, s.thisObject());
+    SE_PRECONDITION2(ok, false, "js_gfx_DeviceInfo_set_multithreaded : Error processing new value");
+    return true;
+}
+SE_BIND_PROP_SET(js_gfx_DeviceInfo_set_multithreaded)
+
 
 template<>
 bool sevalue_to_native(const se::Value &from, cc::gfx::DeviceInfo * to, se::Object *ctx)
@@ -1969,34 +1995,38 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::DeviceInfo * to, se::Obje
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("windowHandle", &field);
+    json->getProperty("windowHandle", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->windowHandle), ctx);
     }
-    json->getProperty("width", &field);
+    json->getProperty("width", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->width), ctx);
     }
-    json->getProperty("height", &field);
+    json->getProperty("height", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->height), ctx);
     }
-    json->getProperty("nativeWidth", &field);
+    json->getProperty("nativeWidth", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->nativeWidth), ctx);
     }
-    json->getProperty("nativeHeight", &field);
+    json->getProperty("nativeHeight", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->nativeHeight), ctx);
     }
-    json->getProperty("sharedCtx", &field);
+    json->getProperty("sharedCtx", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->sharedCtx), ctx);
     }
-    json->getProperty("bindingMappingInfo", &field);
+    json->getProperty("bindingMappingInfo", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->bindingMappingInfo), ctx);
     }
+    json->getProperty("multithreaded", &field, true);
+    if(!field.isNullOrUndefined()) {
+        ok &= sevalue_to_native(field, &(to->multithreaded), ctx);
+    }
     return ok;
 }
 
@@ -2056,6 +2086,9 @@ static bool js_gfx_DeviceInfo_constructor(se::State& s)
         if (argc > 6 && !args[6].isUndefined()) {
             ok &= sevalue_to_native(args[6], &(cobj->bindingMappingInfo), nullptr);
         }
+        if (argc > 7 && !args[7].isUndefined()) {
+            ok &= sevalue_to_native(args[7], &(cobj->multithreaded), nullptr);
+        }
 
         if(!ok) {
             JSB_FREE(cobj);
@@ -2100,6 +2133,7 @@ bool js_register_gfx_DeviceInfo(se::Object* obj)
     cls->defineProperty("nativeHeight", _SE(js_gfx_DeviceInfo_get_nativeHeight), _SE(js_gfx_DeviceInfo_set_nativeHeight));
     cls->defineProperty("sharedCtx", _SE(js_gfx_DeviceInfo_get_sharedCtx), _SE(js_gfx_DeviceInfo_set_sharedCtx));
     cls->defineProperty("bindingMappingInfo", _SE(js_gfx_DeviceInfo_get_bindingMappingInfo), _SE(js_gfx_DeviceInfo_set_bindingMappingInfo));
+    cls->defineProperty("multithreaded", _SE(js_gfx_DeviceInfo_get_multithreaded), _SE(js_gfx_DeviceInfo_set_multithreaded));
     cls->defineFinalizeFunction(_SE(js_cc_gfx_DeviceInfo_finalize));
     cls->install();
     JSBClassType::registerClass<cc::gfx::DeviceInfo>(cls);
@@ -2205,15 +2239,15 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::ContextInfo * to, se::Obj
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("windowHandle", &field);
+    json->getProperty("windowHandle", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->windowHandle), ctx);
     }
-    json->getProperty("sharedCtx", &field);
+    json->getProperty("sharedCtx", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->sharedCtx), ctx);
     }
-    json->getProperty("vsyncMode", &field);
+    json->getProperty("vsyncMode", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->vsyncMode), ctx);
     }
@@ -2461,23 +2495,23 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::BufferInfo * to, se::Obje
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("usage", &field);
+    json->getProperty("usage", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->usage), ctx);
     }
-    json->getProperty("memUsage", &field);
+    json->getProperty("memUsage", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->memUsage), ctx);
     }
-    json->getProperty("size", &field);
+    json->getProperty("size", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->size), ctx);
     }
-    json->getProperty("stride", &field);
+    json->getProperty("stride", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stride), ctx);
     }
-    json->getProperty("flags", &field);
+    json->getProperty("flags", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->flags), ctx);
     }
@@ -2681,15 +2715,15 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::BufferViewInfo * to, se::
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("buffer", &field);
+    json->getProperty("buffer", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->buffer), ctx);
     }
-    json->getProperty("offset", &field);
+    json->getProperty("offset", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->offset), ctx);
     }
-    json->getProperty("range", &field);
+    json->getProperty("range", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->range), ctx);
     }
@@ -3067,43 +3101,43 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::TextureInfo * to, se::Obj
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("type", &field);
+    json->getProperty("type", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->type), ctx);
     }
-    json->getProperty("usage", &field);
+    json->getProperty("usage", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->usage), ctx);
     }
-    json->getProperty("format", &field);
+    json->getProperty("format", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->format), ctx);
     }
-    json->getProperty("width", &field);
+    json->getProperty("width", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->width), ctx);
     }
-    json->getProperty("height", &field);
+    json->getProperty("height", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->height), ctx);
     }
-    json->getProperty("flags", &field);
+    json->getProperty("flags", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->flags), ctx);
     }
-    json->getProperty("layerCount", &field);
+    json->getProperty("layerCount", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->layerCount), ctx);
     }
-    json->getProperty("levelCount", &field);
+    json->getProperty("levelCount", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->levelCount), ctx);
     }
-    json->getProperty("samples", &field);
+    json->getProperty("samples", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->samples), ctx);
     }
-    json->getProperty("depth", &field);
+    json->getProperty("depth", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->depth), ctx);
     }
@@ -3431,31 +3465,31 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::TextureViewInfo * to, se:
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("texture", &field);
+    json->getProperty("texture", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->texture), ctx);
     }
-    json->getProperty("type", &field);
+    json->getProperty("type", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->type), ctx);
     }
-    json->getProperty("format", &field);
+    json->getProperty("format", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->format), ctx);
     }
-    json->getProperty("baseLevel", &field);
+    json->getProperty("baseLevel", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->baseLevel), ctx);
     }
-    json->getProperty("levelCount", &field);
+    json->getProperty("levelCount", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->levelCount), ctx);
     }
-    json->getProperty("baseLayer", &field);
+    json->getProperty("baseLayer", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->baseLayer), ctx);
     }
-    json->getProperty("layerCount", &field);
+    json->getProperty("layerCount", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->layerCount), ctx);
     }
@@ -3901,51 +3935,51 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::SamplerInfo * to, se::Obj
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("minFilter", &field);
+    json->getProperty("minFilter", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->minFilter), ctx);
     }
-    json->getProperty("magFilter", &field);
+    json->getProperty("magFilter", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->magFilter), ctx);
     }
-    json->getProperty("mipFilter", &field);
+    json->getProperty("mipFilter", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->mipFilter), ctx);
     }
-    json->getProperty("addressU", &field);
+    json->getProperty("addressU", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->addressU), ctx);
     }
-    json->getProperty("addressV", &field);
+    json->getProperty("addressV", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->addressV), ctx);
     }
-    json->getProperty("addressW", &field);
+    json->getProperty("addressW", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->addressW), ctx);
     }
-    json->getProperty("maxAnisotropy", &field);
+    json->getProperty("maxAnisotropy", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->maxAnisotropy), ctx);
     }
-    json->getProperty("cmpFunc", &field);
+    json->getProperty("cmpFunc", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->cmpFunc), ctx);
     }
-    json->getProperty("borderColor", &field);
+    json->getProperty("borderColor", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->borderColor), ctx);
     }
-    json->getProperty("minLOD", &field);
+    json->getProperty("minLOD", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->minLOD), ctx);
     }
-    json->getProperty("maxLOD", &field);
+    json->getProperty("maxLOD", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->maxLOD), ctx);
     }
-    json->getProperty("mipLODBias", &field);
+    json->getProperty("mipLODBias", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->mipLODBias), ctx);
     }
@@ -4151,11 +4185,11 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::ShaderMacro * to, se::Obj
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("macro", &field);
+    json->getProperty("macro", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->macro), ctx);
     }
-    json->getProperty("value", &field);
+    json->getProperty("value", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->value), ctx);
     }
@@ -4347,15 +4381,15 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::Uniform * to, se::Object
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("name", &field);
+    json->getProperty("name", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->name), ctx);
     }
-    json->getProperty("type", &field);
+    json->getProperty("type", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->type), ctx);
     }
-    json->getProperty("count", &field);
+    json->getProperty("count", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->count), ctx);
     }
@@ -4603,23 +4637,23 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::UniformBlock * to, se::Ob
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("set", &field);
+    json->getProperty("set", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->set), ctx);
     }
-    json->getProperty("binding", &field);
+    json->getProperty("binding", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->binding), ctx);
     }
-    json->getProperty("name", &field);
+    json->getProperty("name", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->name), ctx);
     }
-    json->getProperty("members", &field);
+    json->getProperty("members", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->members), ctx);
     }
-    json->getProperty("count", &field);
+    json->getProperty("count", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->count), ctx);
     }
@@ -4875,23 +4909,23 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::UniformSampler * to, se::
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("set", &field);
+    json->getProperty("set", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->set), ctx);
     }
-    json->getProperty("binding", &field);
+    json->getProperty("binding", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->binding), ctx);
     }
-    json->getProperty("name", &field);
+    json->getProperty("name", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->name), ctx);
     }
-    json->getProperty("type", &field);
+    json->getProperty("type", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->type), ctx);
     }
-    json->getProperty("count", &field);
+    json->getProperty("count", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->count), ctx);
     }
@@ -5069,11 +5103,11 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::ShaderStage * to, se::Obj
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("stage", &field);
+    json->getProperty("stage", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stage), ctx);
     }
-    json->getProperty("source", &field);
+    json->getProperty("source", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->source), ctx);
     }
@@ -5343,27 +5377,27 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::Attribute * to, se::Objec
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("name", &field);
+    json->getProperty("name", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->name), ctx);
     }
-    json->getProperty("format", &field);
+    json->getProperty("format", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->format), ctx);
     }
-    json->getProperty("isNormalized", &field);
+    json->getProperty("isNormalized", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->isNormalized), ctx);
     }
-    json->getProperty("stream", &field);
+    json->getProperty("stream", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stream), ctx);
     }
-    json->getProperty("isInstanced", &field);
+    json->getProperty("isInstanced", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->isInstanced), ctx);
     }
-    json->getProperty("location", &field);
+    json->getProperty("location", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->location), ctx);
     }
@@ -5623,23 +5657,23 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::ShaderInfo * to, se::Obje
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("name", &field);
+    json->getProperty("name", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->name), ctx);
     }
-    json->getProperty("stages", &field);
+    json->getProperty("stages", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stages), ctx);
     }
-    json->getProperty("attributes", &field);
+    json->getProperty("attributes", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->attributes), ctx);
     }
-    json->getProperty("blocks", &field);
+    json->getProperty("blocks", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->blocks), ctx);
     }
-    json->getProperty("samplers", &field);
+    json->getProperty("samplers", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->samplers), ctx);
     }
@@ -5869,19 +5903,19 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::InputAssemblerInfo * to,
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("attributes", &field);
+    json->getProperty("attributes", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->attributes), ctx);
     }
-    json->getProperty("vertexBuffers", &field);
+    json->getProperty("vertexBuffers", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->vertexBuffers), ctx);
     }
-    json->getProperty("indexBuffer", &field);
+    json->getProperty("indexBuffer", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->indexBuffer), ctx);
     }
-    json->getProperty("indirectBuffer", &field);
+    json->getProperty("indirectBuffer", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->indirectBuffer), ctx);
     }
@@ -6159,27 +6193,27 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::ColorAttachment * to, se:
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("format", &field);
+    json->getProperty("format", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->format), ctx);
     }
-    json->getProperty("sampleCount", &field);
+    json->getProperty("sampleCount", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->sampleCount), ctx);
     }
-    json->getProperty("loadOp", &field);
+    json->getProperty("loadOp", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->loadOp), ctx);
     }
-    json->getProperty("storeOp", &field);
+    json->getProperty("storeOp", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->storeOp), ctx);
     }
-    json->getProperty("beginLayout", &field);
+    json->getProperty("beginLayout", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->beginLayout), ctx);
     }
-    json->getProperty("endLayout", &field);
+    json->getProperty("endLayout", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->endLayout), ctx);
     }
@@ -6517,35 +6551,35 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::DepthStencilAttachment *
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("format", &field);
+    json->getProperty("format", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->format), ctx);
     }
-    json->getProperty("sampleCount", &field);
+    json->getProperty("sampleCount", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->sampleCount), ctx);
     }
-    json->getProperty("depthLoadOp", &field);
+    json->getProperty("depthLoadOp", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->depthLoadOp), ctx);
     }
-    json->getProperty("depthStoreOp", &field);
+    json->getProperty("depthStoreOp", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->depthStoreOp), ctx);
     }
-    json->getProperty("stencilLoadOp", &field);
+    json->getProperty("stencilLoadOp", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stencilLoadOp), ctx);
     }
-    json->getProperty("stencilStoreOp", &field);
+    json->getProperty("stencilStoreOp", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stencilStoreOp), ctx);
     }
-    json->getProperty("beginLayout", &field);
+    json->getProperty("beginLayout", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->beginLayout), ctx);
     }
-    json->getProperty("endLayout", &field);
+    json->getProperty("endLayout", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->endLayout), ctx);
     }
@@ -6839,27 +6873,27 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::SubPassInfo * to, se::Obj
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("bindPoint", &field);
+    json->getProperty("bindPoint", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->bindPoint), ctx);
     }
-    json->getProperty("inputs", &field);
+    json->getProperty("inputs", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->inputs), ctx);
     }
-    json->getProperty("colors", &field);
+    json->getProperty("colors", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->colors), ctx);
     }
-    json->getProperty("resolves", &field);
+    json->getProperty("resolves", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->resolves), ctx);
     }
-    json->getProperty("depthStencil", &field);
+    json->getProperty("depthStencil", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->depthStencil), ctx);
     }
-    json->getProperty("preserves", &field);
+    json->getProperty("preserves", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->preserves), ctx);
     }
@@ -7067,15 +7101,15 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::RenderPassInfo * to, se::
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("colorAttachments", &field);
+    json->getProperty("colorAttachments", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->colorAttachments), ctx);
     }
-    json->getProperty("depthStencilAttachment", &field);
+    json->getProperty("depthStencilAttachment", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->depthStencilAttachment), ctx);
     }
-    json->getProperty("subPasses", &field);
+    json->getProperty("subPasses", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->subPasses), ctx);
     }
@@ -7323,23 +7357,23 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::FramebufferInfo * to, se:
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("renderPass", &field);
+    json->getProperty("renderPass", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->renderPass), ctx);
     }
-    json->getProperty("colorTextures", &field);
+    json->getProperty("colorTextures", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->colorTextures), ctx);
     }
-    json->getProperty("depthStencilTexture", &field);
+    json->getProperty("depthStencilTexture", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->depthStencilTexture), ctx);
     }
-    json->getProperty("colorMipmapLevels", &field);
+    json->getProperty("colorMipmapLevels", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->colorMipmapLevels), ctx);
     }
-    json->getProperty("depthStencilMipmapLevel", &field);
+    json->getProperty("depthStencilMipmapLevel", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->depthStencilMipmapLevel), ctx);
     }
@@ -7595,23 +7629,23 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::DescriptorSetLayoutBindin
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("binding", &field);
+    json->getProperty("binding", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->binding), ctx);
     }
-    json->getProperty("descriptorType", &field);
+    json->getProperty("descriptorType", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->descriptorType), ctx);
     }
-    json->getProperty("count", &field);
+    json->getProperty("count", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->count), ctx);
     }
-    json->getProperty("stageFlags", &field);
+    json->getProperty("stageFlags", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stageFlags), ctx);
     }
-    json->getProperty("immutableSamplers", &field);
+    json->getProperty("immutableSamplers", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->immutableSamplers), ctx);
     }
@@ -7763,7 +7797,7 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::DescriptorSetLayoutInfo *
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("bindings", &field);
+    json->getProperty("bindings", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->bindings), ctx);
     }
@@ -7882,7 +7916,7 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::DescriptorSetInfo * to, s
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("layout", &field);
+    json->getProperty("layout", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->layout), ctx);
     }
@@ -8001,7 +8035,7 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::PipelineLayoutInfo * to,
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("setLayouts", &field);
+    json->getProperty("setLayouts", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->setLayouts), ctx);
     }
@@ -8120,7 +8154,7 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::InputState * to, se::Obje
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("attributes", &field);
+    json->getProperty("attributes", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->attributes), ctx);
     }
@@ -8525,51 +8559,51 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::RasterizerState * to, se:
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("isDiscard", &field);
+    json->getProperty("isDiscard", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->isDiscard), ctx);
     }
-    json->getProperty("polygonMode", &field);
+    json->getProperty("polygonMode", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->polygonMode), ctx);
     }
-    json->getProperty("shadeModel", &field);
+    json->getProperty("shadeModel", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->shadeModel), ctx);
     }
-    json->getProperty("cullMode", &field);
+    json->getProperty("cullMode", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->cullMode), ctx);
     }
-    json->getProperty("isFrontFaceCCW", &field);
+    json->getProperty("isFrontFaceCCW", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->isFrontFaceCCW), ctx);
     }
-    json->getProperty("depthBiasEnabled", &field);
+    json->getProperty("depthBiasEnabled", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->depthBiasEnabled), ctx);
     }
-    json->getProperty("depthBias", &field);
+    json->getProperty("depthBias", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->depthBias), ctx);
     }
-    json->getProperty("depthBiasClamp", &field);
+    json->getProperty("depthBiasClamp", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->depthBiasClamp), ctx);
     }
-    json->getProperty("depthBiasSlop", &field);
+    json->getProperty("depthBiasSlop", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->depthBiasSlop), ctx);
     }
-    json->getProperty("isDepthClip", &field);
+    json->getProperty("isDepthClip", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->isDepthClip), ctx);
     }
-    json->getProperty("isMultisample", &field);
+    json->getProperty("isMultisample", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->isMultisample), ctx);
     }
-    json->getProperty("lineWidth", &field);
+    json->getProperty("lineWidth", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->lineWidth), ctx);
     }
@@ -9217,79 +9251,79 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::DepthStencilState * to, s
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("depthTest", &field);
+    json->getProperty("depthTest", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->depthTest), ctx);
     }
-    json->getProperty("depthWrite", &field);
+    json->getProperty("depthWrite", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->depthWrite), ctx);
     }
-    json->getProperty("depthFunc", &field);
+    json->getProperty("depthFunc", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->depthFunc), ctx);
     }
-    json->getProperty("stencilTestFront", &field);
+    json->getProperty("stencilTestFront", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stencilTestFront), ctx);
     }
-    json->getProperty("stencilFuncFront", &field);
+    json->getProperty("stencilFuncFront", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stencilFuncFront), ctx);
     }
-    json->getProperty("stencilReadMaskFront", &field);
+    json->getProperty("stencilReadMaskFront", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stencilReadMaskFront), ctx);
     }
-    json->getProperty("stencilWriteMaskFront", &field);
+    json->getProperty("stencilWriteMaskFront", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stencilWriteMaskFront), ctx);
     }
-    json->getProperty("stencilFailOpFront", &field);
+    json->getProperty("stencilFailOpFront", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stencilFailOpFront), ctx);
     }
-    json->getProperty("stencilZFailOpFront", &field);
+    json->getProperty("stencilZFailOpFront", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stencilZFailOpFront), ctx);
     }
-    json->getProperty("stencilPassOpFront", &field);
+    json->getProperty("stencilPassOpFront", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stencilPassOpFront), ctx);
     }
-    json->getProperty("stencilRefFront", &field);
+    json->getProperty("stencilRefFront", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stencilRefFront), ctx);
     }
-    json->getProperty("stencilTestBack", &field);
+    json->getProperty("stencilTestBack", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stencilTestBack), ctx);
     }
-    json->getProperty("stencilFuncBack", &field);
+    json->getProperty("stencilFuncBack", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stencilFuncBack), ctx);
     }
-    json->getProperty("stencilReadMaskBack", &field);
+    json->getProperty("stencilReadMaskBack", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stencilReadMaskBack), ctx);
     }
-    json->getProperty("stencilWriteMaskBack", &field);
+    json->getProperty("stencilWriteMaskBack", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stencilWriteMaskBack), ctx);
     }
-    json->getProperty("stencilFailOpBack", &field);
+    json->getProperty("stencilFailOpBack", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stencilFailOpBack), ctx);
     }
-    json->getProperty("stencilZFailOpBack", &field);
+    json->getProperty("stencilZFailOpBack", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stencilZFailOpBack), ctx);
     }
-    json->getProperty("stencilPassOpBack", &field);
+    json->getProperty("stencilPassOpBack", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stencilPassOpBack), ctx);
     }
-    json->getProperty("stencilRefBack", &field);
+    json->getProperty("stencilRefBack", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stencilRefBack), ctx);
     }
@@ -9679,35 +9713,35 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::BlendTarget * to, se::Obj
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("blend", &field);
+    json->getProperty("blend", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->blend), ctx);
     }
-    json->getProperty("blendSrc", &field);
+    json->getProperty("blendSrc", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->blendSrc), ctx);
     }
-    json->getProperty("blendDst", &field);
+    json->getProperty("blendDst", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->blendDst), ctx);
     }
-    json->getProperty("blendEq", &field);
+    json->getProperty("blendEq", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->blendEq), ctx);
     }
-    json->getProperty("blendSrcAlpha", &field);
+    json->getProperty("blendSrcAlpha", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->blendSrcAlpha), ctx);
     }
-    json->getProperty("blendDstAlpha", &field);
+    json->getProperty("blendDstAlpha", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->blendDstAlpha), ctx);
     }
-    json->getProperty("blendAlphaEq", &field);
+    json->getProperty("blendAlphaEq", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->blendAlphaEq), ctx);
     }
-    json->getProperty("blendColorMask", &field);
+    json->getProperty("blendColorMask", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->blendColorMask), ctx);
     }
@@ -9949,19 +9983,19 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::BlendState * to, se::Obje
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("isA2C", &field);
+    json->getProperty("isA2C", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->isA2C), ctx);
     }
-    json->getProperty("isIndepend", &field);
+    json->getProperty("isIndepend", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->isIndepend), ctx);
     }
-    json->getProperty("blendColor", &field);
+    json->getProperty("blendColor", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->blendColor), ctx);
     }
-    json->getProperty("targets", &field);
+    json->getProperty("targets", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->targets), ctx);
     }
@@ -10317,39 +10351,39 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::PipelineStateInfo * to, s
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("shader", &field);
+    json->getProperty("shader", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->shader), ctx);
     }
-    json->getProperty("pipelineLayout", &field);
+    json->getProperty("pipelineLayout", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->pipelineLayout), ctx);
     }
-    json->getProperty("renderPass", &field);
+    json->getProperty("renderPass", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->renderPass), ctx);
     }
-    json->getProperty("inputState", &field);
+    json->getProperty("inputState", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->inputState), ctx);
     }
-    json->getProperty("rasterizerState", &field);
+    json->getProperty("rasterizerState", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->rasterizerState), ctx);
     }
-    json->getProperty("depthStencilState", &field);
+    json->getProperty("depthStencilState", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->depthStencilState), ctx);
     }
-    json->getProperty("blendState", &field);
+    json->getProperty("blendState", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->blendState), ctx);
     }
-    json->getProperty("primitive", &field);
+    json->getProperty("primitive", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->primitive), ctx);
     }
-    json->getProperty("dynamicStates", &field);
+    json->getProperty("dynamicStates", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->dynamicStates), ctx);
     }
@@ -10699,35 +10733,35 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::FormatInfo * to, se::Obje
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("name", &field);
+    json->getProperty("name", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->name), ctx);
     }
-    json->getProperty("size", &field);
+    json->getProperty("size", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->size), ctx);
     }
-    json->getProperty("count", &field);
+    json->getProperty("count", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->count), ctx);
     }
-    json->getProperty("type", &field);
+    json->getProperty("type", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->type), ctx);
     }
-    json->getProperty("hasAlpha", &field);
+    json->getProperty("hasAlpha", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->hasAlpha), ctx);
     }
-    json->getProperty("hasDepth", &field);
+    json->getProperty("hasDepth", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->hasDepth), ctx);
     }
-    json->getProperty("hasStencil", &field);
+    json->getProperty("hasStencil", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->hasStencil), ctx);
     }
-    json->getProperty("isCompressed", &field);
+    json->getProperty("isCompressed", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->isCompressed), ctx);
     }
@@ -10917,11 +10951,11 @@ bool sevalue_to_native(const se::Value &from, cc::gfx::MemoryStatus * to, se::Ob
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("bufferSize", &field);
+    json->getProperty("bufferSize", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->bufferSize), ctx);
     }
-    json->getProperty("textureSize", &field);
+    json->getProperty("textureSize", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->textureSize), ctx);
     }
@@ -11946,6 +11980,51 @@ static bool js_gfx_Device_getShaderIdGen(se::State& s)
 }
 SE_BIND_PROP_GET(js_gfx_Device_getShaderIdGen)
 
+static bool js_gfx_Device_getSharedDescriptorSet(se::State& s)
+{
+    cc::gfx::Device* cobj = SE_THIS_OBJECT<cc::gfx::Device>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_Device_getSharedDescriptorSet : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 4) {
+        HolderType<cc::gfx::DescriptorSetLayout*, false> arg0 = {};
+        HolderType<std::vector<cc::gfx::Buffer *>, true> arg1 = {};
+        HolderType<std::vector<cc::gfx::Texture *>, true> arg2 = {};
+        HolderType<std::vector<cc::gfx::Sampler *>, true> arg3 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        ok &= sevalue_to_native(args[1], &arg1, s.thisObject());
+        ok &= sevalue_to_native(args[2], &arg2, s.thisObject());
+        ok &= sevalue_to_native(args[3], &arg3, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_gfx_Device_getSharedDescriptorSet : Error processing arguments");
+        cc::gfx::DescriptorSet* result = cobj->getSharedDescriptorSet(arg0.value(), arg1.value(), arg2.value(), arg3.value());
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_Device_getSharedDescriptorSet : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 4);
+    return false;
+}
+SE_BIND_FUNC(js_gfx_Device_getSharedDescriptorSet)
+
+static bool js_gfx_Device_getSharedDescriptorSetCount(se::State& s)
+{
+    cc::gfx::Device* cobj = SE_THIS_OBJECT<cc::gfx::Device>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_Device_getSharedDescriptorSetCount : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        unsigned int result = cobj->getSharedDescriptorSetCount();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_Device_getSharedDescriptorSetCount : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_gfx_Device_getSharedDescriptorSetCount)
+
 static bool js_gfx_Device_getStencilBits(se::State& s)
 {
     cc::gfx::Device* cobj = SE_THIS_OBJECT<cc::gfx::Device>(s);
@@ -12111,6 +12190,25 @@ static bool js_gfx_Device_present(se::State& s)
 }
 SE_BIND_FUNC(js_gfx_Device_present)
 
+static bool js_gfx_Device_releaseSharedDescriptorSet(se::State& s)
+{
+    cc::gfx::Device* cobj = SE_THIS_OBJECT<cc::gfx::Device>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_Device_releaseSharedDescriptorSet : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<cc::gfx::DescriptorSet*, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_gfx_Device_releaseSharedDescriptorSet : Error processing arguments");
+        cobj->releaseSharedDescriptorSet(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_gfx_Device_releaseSharedDescriptorSet)
+
 static bool js_gfx_Device_resize(se::State& s)
 {
     cc::gfx::Device* cobj = SE_THIS_OBJECT<cc::gfx::Device>(s);
@@ -12131,6 +12229,18 @@ static bool js_gfx_Device_resize(se::State& s)
     return false;
 }
 SE_BIND_FUNC(js_gfx_Device_resize)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_gfx_Device_resize_fast(v8::Local<v8::Object> receiver, uint32_t arg0, uint32_t arg1, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::gfx::Device>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->resize(arg0, arg1);
+}
+SE_BIND_FAST_FUNC(js_gfx_Device_resize_fast)
+#endif
 
 
 
@@ -12189,11 +12299,18 @@ bool js_register_gfx_Device(se::Object* obj)
     cls->defineFunction("defineMacro", _SE(js_gfx_Device_defineMacro));
     cls->defineFunction("destroy", _SE(js_gfx_Device_destroy));
     cls->defineFunction("genShaderId", _SE(js_gfx_Device_genShaderId));
+    cls->defineFunction("getSharedDescriptorSet", _SE(js_gfx_Device_getSharedDescriptorSet));
+    cls->defineFunction("getSharedDescriptorSetCount", _SE(js_gfx_Device_getSharedDescriptorSetCount));
     cls->defineFunction("getUboOffsetAlignment", _SE(js_gfx_Device_getUboOffsetAlignment));
     cls->defineFunction("hasFeature", _SE(js_gfx_Device_hasFeature));
     cls->defineFunction("initialize", _SE(js_gfx_Device_initialize));
     cls->defineFunction("present", _SE(js_gfx_Device_present));
+    cls->defineFunction("releaseSharedDescriptorSet", _SE(js_gfx_Device_releaseSharedDescriptorSet));
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("resize", _SE(js_gfx_Device_resize), _SE_FAST(js_gfx_Device_resize_fast));
+#else
     cls->defineFunction("resize", _SE(js_gfx_Device_resize));
+#endif
     cls->install();
     JSBClassType::registerClass<cc::gfx::Device>(cls);
 
@@ -12541,6 +12658,18 @@ static bool js_gfx_Buffer_resize(se::State& s)
     return false;
 }
 SE_BIND_FUNC(js_gfx_Buffer_resize)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_gfx_Buffer_resize_fast(v8::Local<v8::Object> receiver, uint32_t arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::gfx::Buffer>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->resize(arg0);
+}
+SE_BIND_FAST_FUNC(js_gfx_Buffer_resize_fast)
+#endif
 
 SE_DECLARE_FINALIZE_FUNC(js_cc_gfx_Buffer_finalize)
 
@@ -12580,7 +12709,11 @@ bool js_register_gfx_Buffer(se::Object* obj)
     cls->defineProperty("usage", _SE(js_gfx_Buffer_getUsage), nullptr);
     cls->defineProperty("size", _SE(js_gfx_Buffer_getSize), nullptr);
     cls->defineFunction("destroy", _SE(js_gfx_Buffer_destroy));
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("resize", _SE(js_gfx_Buffer_resize), _SE_FAST(js_gfx_Buffer_resize_fast));
+#else
     cls->defineFunction("resize", _SE(js_gfx_Buffer_resize));
+#endif
     cls->defineFinalizeFunction(_SE(js_cc_gfx_Buffer_finalize));
     cls->install();
     JSBClassType::registerClass<cc::gfx::Buffer>(cls);
@@ -12864,6 +12997,18 @@ static bool js_gfx_Texture_resize(se::State& s)
     return false;
 }
 SE_BIND_FUNC(js_gfx_Texture_resize)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_gfx_Texture_resize_fast(v8::Local<v8::Object> receiver, uint32_t arg0, uint32_t arg1, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::gfx::Texture>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->resize(arg0, arg1);
+}
+SE_BIND_FAST_FUNC(js_gfx_Texture_resize_fast)
+#endif
 
 SE_DECLARE_FINALIZE_FUNC(js_cc_gfx_Texture_finalize)
 
@@ -12910,7 +13055,11 @@ bool js_register_gfx_Texture(se::Object* obj)
     cls->defineProperty("size", _SE(js_gfx_Texture_getSize), nullptr);
     cls->defineFunction("destroy", _SE(js_gfx_Texture_destroy));
     cls->defineFunction("isTextureView", _SE(js_gfx_Texture_isTextureView));
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("resize", _SE(js_gfx_Texture_resize), _SE_FAST(js_gfx_Texture_resize_fast));
+#else
     cls->defineFunction("resize", _SE(js_gfx_Texture_resize));
+#endif
     cls->defineFinalizeFunction(_SE(js_cc_gfx_Texture_finalize));
     cls->install();
     JSBClassType::registerClass<cc::gfx::Texture>(cls);
@@ -13012,6 +13161,16 @@ static bool js_gfx_Sampler_getBorderColor(se::State& s)
 }
 SE_BIND_PROP_GET(js_gfx_Sampler_getBorderColor)
 
+static bool js_gfx_Sampler_getBorderColor_toBuffer(se::State& s)
+{
+    cc::gfx::Sampler* cobj = SE_THIS_OBJECT<cc::gfx::Sampler>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_Sampler_getBorderColor_toBuffer : Invalid Native Object");
+    CC_UNUSED bool ok = nativevalue_to_buffer(cobj->getBorderColor(), s.args(), 0);
+    SE_PRECONDITION2(ok, false, "js_gfx_Sampler_getBorderColor_toBuffer : Error processing arguments");
+    return true;
+}
+SE_BIND_FUNC(js_gfx_Sampler_getBorderColor_toBuffer)
+
 static bool js_gfx_Sampler_getCmpFunc(se::State& s)
 {
     cc::gfx::Sampler* cobj = SE_THIS_OBJECT<cc::gfx::Sampler>(s);
@@ -13209,6 +13368,7 @@ bool js_register_gfx_Sampler(se::Object* obj)
     auto cls = se::Class::create("Sampler", obj, __jsb_cc_gfx_GFXObject_proto, _SE(js_gfx_Sampler_constructor));
 
     cls->defineProperty("borderColor", _SE(js_gfx_Sampler_getBorderColor), nullptr);
+    cls->defineFunction("getBorderColorToBuffer", _SE(js_gfx_Sampler_getBorderColor_toBuffer));
     cls->defineProperty("mipFilter", _SE(js_gfx_Sampler_getMipFilter), nullptr);
     cls->defineProperty("minFilter", _SE(js_gfx_Sampler_getMinFilter), nullptr);
     cls->defineProperty("maxLOD", _SE(js_gfx_Sampler_getMaxLOD), nullptr);
@@ -15473,6 +15633,18 @@ static bool js_gfx_CommandBuffer_setDepthBias(se::State& s)
     return false;
 }
 SE_BIND_FUNC(js_gfx_CommandBuffer_setDepthBias)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_gfx_CommandBuffer_setDepthBias_fast(v8::Local<v8::Object> receiver, float arg0, float arg1, float arg2, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::gfx::CommandBuffer>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setDepthBias(arg0, arg1, arg2);
+}
+SE_BIND_FAST_FUNC(js_gfx_CommandBuffer_setDepthBias_fast)
+#endif
 
 static bool js_gfx_CommandBuffer_setDepthBound(se::State& s)
 {
@@ -15494,6 +15666,18 @@ static bool js_gfx_CommandBuffer_setDepthBound(se::State& s)
     return false;
 }
 SE_BIND_FUNC(js_gfx_CommandBuffer_setDepthBound)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_gfx_CommandBuffer_setDepthBound_fast(v8::Local<v8::Object> receiver, float arg0, float arg1, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::gfx::CommandBuffer>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setDepthBound(arg0, arg1);
+}
+SE_BIND_FAST_FUNC(js_gfx_CommandBuffer_setDepthBound_fast)
+#endif
 
 static bool js_gfx_CommandBuffer_setLineWidth(se::State& s)
 {
@@ -15513,6 +15697,18 @@ static bool js_gfx_CommandBuffer_setLineWidth(se::State& s)
     return false;
 }
 SE_BIND_FUNC(js_gfx_CommandBuffer_setLineWidth)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_gfx_CommandBuffer_setLineWidth_fast(v8::Local<v8::Object> receiver, float arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::gfx::CommandBuffer>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setLineWidth(arg0);
+}
+SE_BIND_FAST_FUNC(js_gfx_CommandBuffer_setLineWidth_fast)
+#endif
 
 static bool js_gfx_CommandBuffer_setScissor(se::State& s)
 {
@@ -15643,9 +15839,21 @@ bool js_register_gfx_CommandBuffer(se::Object* obj)
     cls->defineFunction("getType", _SE(js_gfx_CommandBuffer_getType));
     cls->defineFunction("initialize", _SE(js_gfx_CommandBuffer_initialize));
     cls->defineFunction("setBlendConstants", _SE(js_gfx_CommandBuffer_setBlendConstants));
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setDepthBias", _SE(js_gfx_CommandBuffer_setDepthBias), _SE_FAST(js_gfx_CommandBuffer_setDepthBias_fast));
+#else
     cls->defineFunction("setDepthBias", _SE(js_gfx_CommandBuffer_setDepthBias));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setDepthBound", _SE(js_gfx_CommandBuffer_setDepthBound), _SE_FAST(js_gfx_CommandBuffer_setDepthBound_fast));
+#else
     cls->defineFunction("setDepthBound", _SE(js_gfx_CommandBuffer_setDepthBound));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setLineWidth", _SE(js_gfx_CommandBuffer_setLineWidth), _SE_FAST(js_gfx_CommandBuffer_setLineWidth_fast));
+#else
     cls->defineFunction("setLineWidth", _SE(js_gfx_CommandBuffer_setLineWidth));
+#endif
     cls->defineFunction("setScissor", _SE(js_gfx_CommandBuffer_setScissor));
     cls->defineFunction("setStencilCompareMask", _SE(js_gfx_CommandBuffer_setStencilCompareMask));
     cls->defineFunction("setStencilWriteMask", _SE(js_gfx_CommandBuffer_setStencilWriteMask));
@@ -15700,6 +15908,24 @@ static bool js_gfx_Fence_initialize(se::State& s)
 }
 SE_BIND_FUNC(js_gfx_Fence_initialize)
 
+static bool js_gfx_Fence_isSignaled(se::State& s)
+{
+    cc::gfx::Fence* cobj = SE_THIS_OBJECT<cc::gfx::Fence>(s);
+    SE_PRECONDITION2(cobj, false, "js_gfx_Fence_isSignaled : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isSignaled();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_gfx_Fence_isSignaled : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_gfx_Fence_isSignaled)
+
 static bool js_gfx_Fence_reset(se::State& s)
 {
     cc::gfx::Fence* cobj = SE_THIS_OBJECT<cc::gfx::Fence>(s);
@@ -15763,6 +15989,7 @@ bool js_register_gfx_Fence(se::Object* obj)
 
     cls->defineFunction("destroy", _SE(js_gfx_Fence_destroy));
     cls->defineFunction("initialize", _SE(js_gfx_Fence_initialize));
+    cls->defineFunction("isSignaled", _SE(js_gfx_Fence_isSignaled));
     cls->defineFunction("reset", _SE(js_gfx_Fence_reset));
     cls->defineFunction("wait", _SE(js_gfx_Fence_wait));
     cls->defineFinalizeFunction(_SE(js_cc_gfx_Fence_finalize));
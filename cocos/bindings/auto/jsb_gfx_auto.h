@@ -428,10 +428,13 @@ SE_DECLARE_FUNC(js_gfx_Device_createShader);
 SE_DECLARE_FUNC(js_gfx_Device_defineMacro);
 SE_DECLARE_FUNC(js_gfx_Device_destroy);
 SE_DECLARE_FUNC(js_gfx_Device_genShaderId);
+SE_DECLARE_FUNC(js_gfx_Device_getSharedDescriptorSet);
+SE_DECLARE_FUNC(js_gfx_Device_getSharedDescriptorSetCount);
 SE_DECLARE_FUNC(js_gfx_Device_getUboOffsetAlignment);
 SE_DECLARE_FUNC(js_gfx_Device_hasFeature);
 SE_DECLARE_FUNC(js_gfx_Device_initialize);
 SE_DECLARE_FUNC(js_gfx_Device_present);
+SE_DECLARE_FUNC(js_gfx_Device_releaseSharedDescriptorSet);
 SE_DECLARE_FUNC(js_gfx_Device_resize);
 
 extern se::Object* __jsb_cc_gfx_Context_proto;
@@ -626,6 +629,7 @@ bool register_all_gfx(se::Object* obj);
 JSB_REGISTER_OBJECT_TYPE(cc::gfx::Fence);
 SE_DECLARE_FUNC(js_gfx_Fence_destroy);
 SE_DECLARE_FUNC(js_gfx_Fence_initialize);
+SE_DECLARE_FUNC(js_gfx_Fence_isSignaled);
 SE_DECLARE_FUNC(js_gfx_Fence_reset);
 SE_DECLARE_FUNC(js_gfx_Fence_wait);
 SE_DECLARE_FUNC(js_gfx_Fence_Fence);
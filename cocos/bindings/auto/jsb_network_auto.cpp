@@ -149,15 +149,15 @@ bool sevalue_to_native(const se::Value &from, cc::network::DownloaderHints * to,
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("countOfMaxProcessingTasks", &field);
+    json->getProperty("countOfMaxProcessingTasks", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->countOfMaxProcessingTasks), ctx);
     }
-    json->getProperty("timeoutInSeconds", &field);
+    json->getProperty("timeoutInSeconds", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->timeoutInSeconds), ctx);
     }
-    json->getProperty("tempFileNameSuffix", &field);
+    json->getProperty("tempFileNameSuffix", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->tempFileNameSuffix), ctx);
     }
@@ -4,6 +4,9 @@
 #include "renderer/pipeline/forward/ForwardPipeline.h"
 #include "renderer/pipeline/forward/ForwardFlow.h"
 #include "renderer/pipeline/forward/ForwardStage.h"
+#include "renderer/pipeline/deferred/DeferredPipeline.h"
+#include "renderer/pipeline/deferred/DeferredFlow.h"
+#include "renderer/pipeline/deferred/DeferredStage.h"
 #include "renderer/pipeline/shadow/ShadowFlow.h"
 #include "renderer/pipeline/shadow/ShadowStage.h"
 #include "renderer/pipeline/RenderPipeline.h"
@@ -116,15 +119,15 @@ bool sevalue_to_native(const se::Value &from, cc::pipeline::RenderQueueDesc * to
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("isTransparent", &field);
+    json->getProperty("isTransparent", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->isTransparent), ctx);
     }
-    json->getProperty("sortMode", &field);
+    json->getProperty("sortMode", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->sortMode), ctx);
     }
-    json->getProperty("stages", &field);
+    json->getProperty("stages", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stages), ctx);
     }
@@ -678,59 +681,59 @@ bool sevalue_to_native(const se::Value &from, cc::pipeline::Light * to, se::Obje
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("useColorTemperature", &field);
+    json->getProperty("useColorTemperature", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->useColorTemperature), ctx);
     }
-    json->getProperty("luminance", &field);
+    json->getProperty("luminance", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->luminance), ctx);
     }
-    json->getProperty("nodeID", &field);
+    json->getProperty("nodeID", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->nodeID), ctx);
     }
-    json->getProperty("range", &field);
+    json->getProperty("range", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->range), ctx);
     }
-    json->getProperty("lightType", &field);
+    json->getProperty("lightType", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->lightType), ctx);
     }
-    json->getProperty("aabbID", &field);
+    json->getProperty("aabbID", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->aabbID), ctx);
     }
-    json->getProperty("frustumID", &field);
+    json->getProperty("frustumID", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->frustumID), ctx);
     }
-    json->getProperty("size", &field);
+    json->getProperty("size", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->size), ctx);
     }
-    json->getProperty("spotAngle", &field);
+    json->getProperty("spotAngle", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->spotAngle), ctx);
     }
-    json->getProperty("aspect", &field);
+    json->getProperty("aspect", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->aspect), ctx);
     }
-    json->getProperty("direction", &field);
+    json->getProperty("direction", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->direction), ctx);
     }
-    json->getProperty("color", &field);
+    json->getProperty("color", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->color), ctx);
     }
-    json->getProperty("colorTemperatureRGB", &field);
+    json->getProperty("colorTemperatureRGB", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->colorTemperatureRGB), ctx);
     }
-    json->getProperty("position", &field);
+    json->getProperty("position", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->position), ctx);
     }
@@ -1352,51 +1355,51 @@ bool sevalue_to_native(const se::Value &from, cc::pipeline::PassView * to, se::O
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("priority", &field);
+    json->getProperty("priority", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->priority), ctx);
     }
-    json->getProperty("stage", &field);
+    json->getProperty("stage", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stage), ctx);
     }
-    json->getProperty("phase", &field);
+    json->getProperty("phase", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->phase), ctx);
     }
-    json->getProperty("batchingScheme", &field);
+    json->getProperty("batchingScheme", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->batchingScheme), ctx);
     }
-    json->getProperty("primitive", &field);
+    json->getProperty("primitive", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->primitive), ctx);
     }
-    json->getProperty("dynamicState", &field);
+    json->getProperty("dynamicState", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->dynamicState), ctx);
     }
-    json->getProperty("hash", &field);
+    json->getProperty("hash", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->hash), ctx);
     }
-    json->getProperty("rasterizerStateID", &field);
+    json->getProperty("rasterizerStateID", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->rasterizerStateID), ctx);
     }
-    json->getProperty("depthStencilStateID", &field);
+    json->getProperty("depthStencilStateID", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->depthStencilStateID), ctx);
     }
-    json->getProperty("blendStateID", &field);
+    json->getProperty("blendStateID", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->blendStateID), ctx);
     }
-    json->getProperty("descriptorSetID", &field);
+    json->getProperty("descriptorSetID", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->descriptorSetID), ctx);
     }
-    json->getProperty("pipelineLayoutID", &field);
+    json->getProperty("pipelineLayoutID", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->pipelineLayoutID), ctx);
     }
@@ -1654,15 +1657,15 @@ bool sevalue_to_native(const se::Value &from, cc::pipeline::RenderWindow * to, s
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("hasOnScreenAttachments", &field);
+    json->getProperty("hasOnScreenAttachments", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->hasOnScreenAttachments), ctx);
     }
-    json->getProperty("hasOffScreenAttachments", &field);
+    json->getProperty("hasOffScreenAttachments", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->hasOffScreenAttachments), ctx);
     }
-    json->getProperty("framebufferID", &field);
+    json->getProperty("framebufferID", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->framebufferID), ctx);
     }
@@ -1833,11 +1836,11 @@ bool sevalue_to_native(const se::Value &from, cc::pipeline::RenderPipelineInfo *
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("tag", &field);
+    json->getProperty("tag", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->tag), ctx);
     }
-    json->getProperty("flows", &field);
+    json->getProperty("flows", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->flows), ctx);
     }
@@ -2028,6 +2031,24 @@ static bool js_pipeline_RenderPipeline_initialize(se::State& s)
 }
 SE_BIND_FUNC(js_pipeline_RenderPipeline_initialize)
 
+static bool js_pipeline_RenderPipeline_isGPUTimingEnabled(se::State& s)
+{
+    cc::pipeline::RenderPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::RenderPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_RenderPipeline_isGPUTimingEnabled : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isGPUTimingEnabled();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_RenderPipeline_isGPUTimingEnabled : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_RenderPipeline_isGPUTimingEnabled)
+
 static bool js_pipeline_RenderPipeline_render(se::State& s)
 {
     cc::pipeline::RenderPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::RenderPipeline>(s);
@@ -2047,6 +2068,37 @@ static bool js_pipeline_RenderPipeline_render(se::State& s)
 }
 SE_BIND_FUNC(js_pipeline_RenderPipeline_render)
 
+static bool js_pipeline_RenderPipeline_setGPUTimingEnabled(se::State& s)
+{
+    cc::pipeline::RenderPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::RenderPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_RenderPipeline_setGPUTimingEnabled : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<bool, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_RenderPipeline_setGPUTimingEnabled : Error processing arguments");
+        cobj->setGPUTimingEnabled(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_RenderPipeline_setGPUTimingEnabled)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_RenderPipeline_setGPUTimingEnabled_fast(v8::Local<v8::Object> receiver, bool arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::RenderPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setGPUTimingEnabled(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_RenderPipeline_setGPUTimingEnabled_fast)
+#endif
+
 static bool js_pipeline_RenderPipeline_setValue(se::State& s)
 {
     cc::pipeline::RenderPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::RenderPipeline>(s);
@@ -2096,7 +2148,13 @@ bool js_register_pipeline_RenderPipeline(se::Object* obj)
     cls->defineFunction("activate", _SE(js_pipeline_RenderPipeline_activate));
     cls->defineFunction("destroy", _SE(js_pipeline_RenderPipeline_destroy));
     cls->defineFunction("initialize", _SE(js_pipeline_RenderPipeline_initialize));
+    cls->defineFunction("isGPUTimingEnabled", _SE(js_pipeline_RenderPipeline_isGPUTimingEnabled));
     cls->defineFunction("render", _SE(js_pipeline_RenderPipeline_render));
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setGPUTimingEnabled", _SE(js_pipeline_RenderPipeline_setGPUTimingEnabled), _SE_FAST(js_pipeline_RenderPipeline_setGPUTimingEnabled_fast));
+#else
+    cls->defineFunction("setGPUTimingEnabled", _SE(js_pipeline_RenderPipeline_setGPUTimingEnabled));
+#endif
     cls->defineFunction("setValue", _SE(js_pipeline_RenderPipeline_setValue));
     cls->defineStaticFunction("getInstance", _SE(js_pipeline_RenderPipeline_getInstance));
     cls->install();
@@ -2112,6 +2170,254 @@ bool js_register_pipeline_RenderPipeline(se::Object* obj)
 se::Object* __jsb_cc_pipeline_ForwardPipeline_proto = nullptr;
 se::Class* __jsb_cc_pipeline_ForwardPipeline_class = nullptr;
 
+static bool js_pipeline_ForwardPipeline_addStreamingTexture(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_addStreamingTexture : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 4) {
+        HolderType<cc::gfx::Texture*, false> arg0 = {};
+        HolderType<unsigned int, false> arg1 = {};
+        HolderType<unsigned int, false> arg2 = {};
+        HolderType<std::vector<std::string>, true> arg3 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        ok &= sevalue_to_native(args[1], &arg1, s.thisObject());
+        ok &= sevalue_to_native(args[2], &arg2, s.thisObject());
+        ok &= sevalue_to_native(args[3], &arg3, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_addStreamingTexture : Error processing arguments");
+        bool result = cobj->addStreamingTexture(arg0.value(), arg1.value(), arg2.value(), arg3.value());
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_addStreamingTexture : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 4);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_addStreamingTexture)
+
+static bool js_pipeline_ForwardPipeline_buildStaticBatches(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_buildStaticBatches : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 2) {
+        HolderType<std::vector<unsigned int>, true> arg0 = {};
+        HolderType<std::vector<float>, true> arg1 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        ok &= sevalue_to_native(args[1], &arg1, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_buildStaticBatches : Error processing arguments");
+        cobj->buildStaticBatches(arg0.value(), arg1.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 2);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_buildStaticBatches)
+
+static bool js_pipeline_ForwardPipeline_clearStaticBatches(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_clearStaticBatches : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        cobj->clearStaticBatches();
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_clearStaticBatches)
+
+static bool js_pipeline_ForwardPipeline_destroyScene(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_destroyScene : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<unsigned int, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_destroyScene : Error processing arguments");
+        cobj->destroyScene(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_destroyScene)
+
+static bool js_pipeline_ForwardPipeline_getCameraOverdraw(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_getCameraOverdraw : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<unsigned int, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_getCameraOverdraw : Error processing arguments");
+        float result = cobj->getCameraOverdraw(arg0.value());
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_getCameraOverdraw : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_getCameraOverdraw)
+
+static bool js_pipeline_ForwardPipeline_getDepthPrepassOverdrawThreshold(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_getDepthPrepassOverdrawThreshold : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        float result = cobj->getDepthPrepassOverdrawThreshold();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_getDepthPrepassOverdrawThreshold : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_getDepthPrepassOverdrawThreshold)
+
+static bool js_pipeline_ForwardPipeline_getDynamicResolutionScale(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_getDynamicResolutionScale : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        float result = cobj->getDynamicResolutionScale();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_getDynamicResolutionScale : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_getDynamicResolutionScale)
+
+static bool js_pipeline_ForwardPipeline_getDynamicResolutionTargetTime(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_getDynamicResolutionTargetTime : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        float result = cobj->getDynamicResolutionTargetTime();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_getDynamicResolutionTargetTime : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_getDynamicResolutionTargetTime)
+
+static bool js_pipeline_ForwardPipeline_getLODHysteresis(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_getLODHysteresis : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        float result = cobj->getLODHysteresis();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_getLODHysteresis : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_getLODHysteresis)
+
+static bool js_pipeline_ForwardPipeline_getOcclusionQueryMinRadius(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_getOcclusionQueryMinRadius : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        float result = cobj->getOcclusionQueryMinRadius();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_getOcclusionQueryMinRadius : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_getOcclusionQueryMinRadius)
+
+static bool js_pipeline_ForwardPipeline_getOcclusionQueryReprojectionDistance(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_getOcclusionQueryReprojectionDistance : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        float result = cobj->getOcclusionQueryReprojectionDistance();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_getOcclusionQueryReprojectionDistance : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_getOcclusionQueryReprojectionDistance)
+
+static bool js_pipeline_ForwardPipeline_getShadowCascadeCount(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_getShadowCascadeCount : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        unsigned int result = cobj->getShadowCascadeCount();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_getShadowCascadeCount : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_getShadowCascadeCount)
+
+static bool js_pipeline_ForwardPipeline_getShadowCascadeDistance(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_getShadowCascadeDistance : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        float result = cobj->getShadowCascadeDistance();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_getShadowCascadeDistance : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_getShadowCascadeDistance)
+
 static bool js_pipeline_ForwardPipeline_getSphere(se::State& s)
 {
     cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
@@ -2125,67 +2431,1119 @@ static bool js_pipeline_ForwardPipeline_getSphere(se::State& s)
         SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_getSphere : Error processing arguments");
         return true;
     }
-    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_getSphere)
+
+static bool js_pipeline_ForwardPipeline_getTextureStreamingBudget(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_getTextureStreamingBudget : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        unsigned int result = cobj->getTextureStreamingBudget();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_getTextureStreamingBudget : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_getTextureStreamingBudget)
+
+static bool js_pipeline_ForwardPipeline_getTextureStreamingResidentSize(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_getTextureStreamingResidentSize : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        unsigned int result = cobj->getTextureStreamingResidentSize();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_getTextureStreamingResidentSize : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_getTextureStreamingResidentSize)
+
+static bool js_pipeline_ForwardPipeline_isClusteredLighting(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_isClusteredLighting : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isClusteredLighting();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_isClusteredLighting : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_isClusteredLighting)
+
+static bool js_pipeline_ForwardPipeline_isDynamicResolution(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_isDynamicResolution : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isDynamicResolution();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_isDynamicResolution : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_isDynamicResolution)
+
+static bool js_pipeline_ForwardPipeline_isMultiViewCulling(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_isMultiViewCulling : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isMultiViewCulling();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_isMultiViewCulling : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_isMultiViewCulling)
+
+static bool js_pipeline_ForwardPipeline_isOcclusionQueries(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_isOcclusionQueries : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isOcclusionQueries();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_isOcclusionQueries : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_isOcclusionQueries)
+
+static bool js_pipeline_ForwardPipeline_isPackedCulling(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_isPackedCulling : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isPackedCulling();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_isPackedCulling : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_isPackedCulling)
+
+static bool js_pipeline_ForwardPipeline_isParallelCulling(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_isParallelCulling : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isParallelCulling();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_isParallelCulling : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_isParallelCulling)
+
+static bool js_pipeline_ForwardPipeline_isParallelRecording(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_isParallelRecording : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isParallelRecording();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_isParallelRecording : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_isParallelRecording)
+
+static bool js_pipeline_ForwardPipeline_isRadixSort(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_isRadixSort : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isRadixSort();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_isRadixSort : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_isRadixSort)
+
+static bool js_pipeline_ForwardPipeline_isShadowMapCache(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_isShadowMapCache : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isShadowMapCache();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_isShadowMapCache : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_isShadowMapCache)
+
+static bool js_pipeline_ForwardPipeline_isSpatialIndex(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_isSpatialIndex : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isSpatialIndex();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_isSpatialIndex : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_isSpatialIndex)
+
+static bool js_pipeline_ForwardPipeline_isTextureStreaming(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_isTextureStreaming : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isTextureStreaming();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_isTextureStreaming : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_isTextureStreaming)
+
+static bool js_pipeline_ForwardPipeline_removeStreamingTexture(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_removeStreamingTexture : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<cc::gfx::Texture*, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_removeStreamingTexture : Error processing arguments");
+        cobj->removeStreamingTexture(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_removeStreamingTexture)
+
+static bool js_pipeline_ForwardPipeline_requestCameraUpdate(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_requestCameraUpdate : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<unsigned int, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_requestCameraUpdate : Error processing arguments");
+        cobj->requestCameraUpdate(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_requestCameraUpdate)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_requestCameraUpdate_fast(v8::Local<v8::Object> receiver, uint32_t arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->requestCameraUpdate(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_requestCameraUpdate_fast)
+#endif
+
+static bool js_pipeline_ForwardPipeline_setAmbient(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setAmbient : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<unsigned int, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setAmbient : Error processing arguments");
+        cobj->setAmbient(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setAmbient)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setAmbient_fast(v8::Local<v8::Object> receiver, uint32_t arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setAmbient(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setAmbient_fast)
+#endif
+
+static bool js_pipeline_ForwardPipeline_setCameraUpdatePolicy(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setCameraUpdatePolicy : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 3) {
+        HolderType<unsigned int, false> arg0 = {};
+        HolderType<unsigned int, false> arg1 = {};
+        HolderType<unsigned int, false> arg2 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        ok &= sevalue_to_native(args[1], &arg1, s.thisObject());
+        ok &= sevalue_to_native(args[2], &arg2, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setCameraUpdatePolicy : Error processing arguments");
+        cobj->setCameraUpdatePolicy(arg0.value(), arg1.value(), arg2.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 3);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setCameraUpdatePolicy)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setCameraUpdatePolicy_fast(v8::Local<v8::Object> receiver, uint32_t arg0, uint32_t arg1, uint32_t arg2, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setCameraUpdatePolicy(arg0, arg1, arg2);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setCameraUpdatePolicy_fast)
+#endif
+
+static bool js_pipeline_ForwardPipeline_setClusteredLighting(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setClusteredLighting : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<bool, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setClusteredLighting : Error processing arguments");
+        cobj->setClusteredLighting(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setClusteredLighting)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setClusteredLighting_fast(v8::Local<v8::Object> receiver, bool arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setClusteredLighting(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setClusteredLighting_fast)
+#endif
+
+static bool js_pipeline_ForwardPipeline_setDepthPrepassMode(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setDepthPrepassMode : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 2) {
+        HolderType<unsigned int, false> arg0 = {};
+        HolderType<unsigned int, false> arg1 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        ok &= sevalue_to_native(args[1], &arg1, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setDepthPrepassMode : Error processing arguments");
+        cobj->setDepthPrepassMode(arg0.value(), arg1.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 2);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setDepthPrepassMode)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setDepthPrepassMode_fast(v8::Local<v8::Object> receiver, uint32_t arg0, uint32_t arg1, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setDepthPrepassMode(arg0, arg1);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setDepthPrepassMode_fast)
+#endif
+
+static bool js_pipeline_ForwardPipeline_setDepthPrepassOverdrawThreshold(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setDepthPrepassOverdrawThreshold : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<float, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setDepthPrepassOverdrawThreshold : Error processing arguments");
+        cobj->setDepthPrepassOverdrawThreshold(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setDepthPrepassOverdrawThreshold)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setDepthPrepassOverdrawThreshold_fast(v8::Local<v8::Object> receiver, float arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setDepthPrepassOverdrawThreshold(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setDepthPrepassOverdrawThreshold_fast)
+#endif
+
+static bool js_pipeline_ForwardPipeline_setDynamicResolution(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setDynamicResolution : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<bool, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setDynamicResolution : Error processing arguments");
+        cobj->setDynamicResolution(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setDynamicResolution)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setDynamicResolution_fast(v8::Local<v8::Object> receiver, bool arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setDynamicResolution(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setDynamicResolution_fast)
+#endif
+
+static bool js_pipeline_ForwardPipeline_setDynamicResolutionScaleRange(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setDynamicResolutionScaleRange : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 2) {
+        HolderType<float, false> arg0 = {};
+        HolderType<float, false> arg1 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        ok &= sevalue_to_native(args[1], &arg1, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setDynamicResolutionScaleRange : Error processing arguments");
+        cobj->setDynamicResolutionScaleRange(arg0.value(), arg1.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 2);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setDynamicResolutionScaleRange)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setDynamicResolutionScaleRange_fast(v8::Local<v8::Object> receiver, float arg0, float arg1, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setDynamicResolutionScaleRange(arg0, arg1);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setDynamicResolutionScaleRange_fast)
+#endif
+
+static bool js_pipeline_ForwardPipeline_setDynamicResolutionSharpness(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setDynamicResolutionSharpness : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<float, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setDynamicResolutionSharpness : Error processing arguments");
+        cobj->setDynamicResolutionSharpness(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setDynamicResolutionSharpness)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setDynamicResolutionSharpness_fast(v8::Local<v8::Object> receiver, float arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setDynamicResolutionSharpness(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setDynamicResolutionSharpness_fast)
+#endif
+
+static bool js_pipeline_ForwardPipeline_setDynamicResolutionTargetTime(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setDynamicResolutionTargetTime : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<float, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setDynamicResolutionTargetTime : Error processing arguments");
+        cobj->setDynamicResolutionTargetTime(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setDynamicResolutionTargetTime)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setDynamicResolutionTargetTime_fast(v8::Local<v8::Object> receiver, float arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setDynamicResolutionTargetTime(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setDynamicResolutionTargetTime_fast)
+#endif
+
+static bool js_pipeline_ForwardPipeline_setFog(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setFog : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<unsigned int, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setFog : Error processing arguments");
+        cobj->setFog(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setFog)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setFog_fast(v8::Local<v8::Object> receiver, uint32_t arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setFog(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setFog_fast)
+#endif
+
+static bool js_pipeline_ForwardPipeline_setLODGroup(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setLODGroup : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 4) {
+        HolderType<unsigned int, false> arg0 = {};
+        HolderType<std::vector<float>, true> arg1 = {};
+        HolderType<std::vector<unsigned int>, true> arg2 = {};
+        HolderType<std::vector<unsigned int>, true> arg3 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        ok &= sevalue_to_native(args[1], &arg1, s.thisObject());
+        ok &= sevalue_to_native(args[2], &arg2, s.thisObject());
+        ok &= sevalue_to_native(args[3], &arg3, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setLODGroup : Error processing arguments");
+        cobj->setLODGroup(arg0.value(), arg1.value(), arg2.value(), arg3.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 4);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setLODGroup)
+
+static bool js_pipeline_ForwardPipeline_setLODHysteresis(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setLODHysteresis : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<float, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setLODHysteresis : Error processing arguments");
+        cobj->setLODHysteresis(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setLODHysteresis)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setLODHysteresis_fast(v8::Local<v8::Object> receiver, float arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setLODHysteresis(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setLODHysteresis_fast)
+#endif
+
+static bool js_pipeline_ForwardPipeline_setMultiViewCulling(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setMultiViewCulling : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<bool, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setMultiViewCulling : Error processing arguments");
+        cobj->setMultiViewCulling(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setMultiViewCulling)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setMultiViewCulling_fast(v8::Local<v8::Object> receiver, bool arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setMultiViewCulling(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setMultiViewCulling_fast)
+#endif
+
+static bool js_pipeline_ForwardPipeline_setOccluder(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setOccluder : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 3) {
+        HolderType<unsigned int, false> arg0 = {};
+        HolderType<std::vector<float>, true> arg1 = {};
+        HolderType<std::vector<unsigned int>, true> arg2 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        ok &= sevalue_to_native(args[1], &arg1, s.thisObject());
+        ok &= sevalue_to_native(args[2], &arg2, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setOccluder : Error processing arguments");
+        cobj->setOccluder(arg0.value(), arg1.value(), arg2.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 3);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setOccluder)
+
+static bool js_pipeline_ForwardPipeline_setOcclusionBufferSize(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setOcclusionBufferSize : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 3) {
+        HolderType<unsigned int, false> arg0 = {};
+        HolderType<unsigned int, false> arg1 = {};
+        HolderType<unsigned int, false> arg2 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        ok &= sevalue_to_native(args[1], &arg1, s.thisObject());
+        ok &= sevalue_to_native(args[2], &arg2, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setOcclusionBufferSize : Error processing arguments");
+        cobj->setOcclusionBufferSize(arg0.value(), arg1.value(), arg2.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 3);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setOcclusionBufferSize)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setOcclusionBufferSize_fast(v8::Local<v8::Object> receiver, uint32_t arg0, uint32_t arg1, uint32_t arg2, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setOcclusionBufferSize(arg0, arg1, arg2);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setOcclusionBufferSize_fast)
+#endif
+
+static bool js_pipeline_ForwardPipeline_setOcclusionCulling(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setOcclusionCulling : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 2) {
+        HolderType<unsigned int, false> arg0 = {};
+        HolderType<bool, false> arg1 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        ok &= sevalue_to_native(args[1], &arg1, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setOcclusionCulling : Error processing arguments");
+        cobj->setOcclusionCulling(arg0.value(), arg1.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 2);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setOcclusionCulling)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setOcclusionCulling_fast(v8::Local<v8::Object> receiver, uint32_t arg0, bool arg1, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setOcclusionCulling(arg0, arg1);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setOcclusionCulling_fast)
+#endif
+
+static bool js_pipeline_ForwardPipeline_setOcclusionQueries(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setOcclusionQueries : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<bool, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setOcclusionQueries : Error processing arguments");
+        cobj->setOcclusionQueries(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setOcclusionQueries)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setOcclusionQueries_fast(v8::Local<v8::Object> receiver, bool arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setOcclusionQueries(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setOcclusionQueries_fast)
+#endif
+
+static bool js_pipeline_ForwardPipeline_setOcclusionQueryMinRadius(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setOcclusionQueryMinRadius : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<float, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setOcclusionQueryMinRadius : Error processing arguments");
+        cobj->setOcclusionQueryMinRadius(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setOcclusionQueryMinRadius)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setOcclusionQueryMinRadius_fast(v8::Local<v8::Object> receiver, float arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setOcclusionQueryMinRadius(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setOcclusionQueryMinRadius_fast)
+#endif
+
+static bool js_pipeline_ForwardPipeline_setOcclusionQueryReprojectionDistance(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setOcclusionQueryReprojectionDistance : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<float, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setOcclusionQueryReprojectionDistance : Error processing arguments");
+        cobj->setOcclusionQueryReprojectionDistance(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setOcclusionQueryReprojectionDistance)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setOcclusionQueryReprojectionDistance_fast(v8::Local<v8::Object> receiver, float arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setOcclusionQueryReprojectionDistance(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setOcclusionQueryReprojectionDistance_fast)
+#endif
+
+static bool js_pipeline_ForwardPipeline_setPackedCulling(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setPackedCulling : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<bool, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setPackedCulling : Error processing arguments");
+        cobj->setPackedCulling(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setPackedCulling)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setPackedCulling_fast(v8::Local<v8::Object> receiver, bool arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setPackedCulling(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setPackedCulling_fast)
+#endif
+
+static bool js_pipeline_ForwardPipeline_setParallelCulling(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setParallelCulling : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<bool, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setParallelCulling : Error processing arguments");
+        cobj->setParallelCulling(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setParallelCulling)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setParallelCulling_fast(v8::Local<v8::Object> receiver, bool arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setParallelCulling(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setParallelCulling_fast)
+#endif
+
+static bool js_pipeline_ForwardPipeline_setParallelRecording(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setParallelRecording : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<bool, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setParallelRecording : Error processing arguments");
+        cobj->setParallelRecording(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setParallelRecording)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setParallelRecording_fast(v8::Local<v8::Object> receiver, bool arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setParallelRecording(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setParallelRecording_fast)
+#endif
+
+static bool js_pipeline_ForwardPipeline_setRadixSort(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setRadixSort : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<bool, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setRadixSort : Error processing arguments");
+        cobj->setRadixSort(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setRadixSort)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setRadixSort_fast(v8::Local<v8::Object> receiver, bool arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setRadixSort(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setRadixSort_fast)
+#endif
+
+static bool js_pipeline_ForwardPipeline_setRenderObjects(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setRenderObjects : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<std::vector<cc::pipeline::RenderObject>, true> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setRenderObjects : Error processing arguments");
+        cobj->setRenderObjects(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
     return false;
 }
-SE_BIND_FUNC(js_pipeline_ForwardPipeline_getSphere)
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setRenderObjects)
 
-static bool js_pipeline_ForwardPipeline_setAmbient(se::State& s)
+static bool js_pipeline_ForwardPipeline_setShadowCascadeCount(se::State& s)
 {
     cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
-    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setAmbient : Invalid Native Object");
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setShadowCascadeCount : Invalid Native Object");
     const auto& args = s.args();
     size_t argc = args.size();
     CC_UNUSED bool ok = true;
     if (argc == 1) {
         HolderType<unsigned int, false> arg0 = {};
         ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
-        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setAmbient : Error processing arguments");
-        cobj->setAmbient(arg0.value());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setShadowCascadeCount : Error processing arguments");
+        cobj->setShadowCascadeCount(arg0.value());
         return true;
     }
     SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
     return false;
 }
-SE_BIND_FUNC(js_pipeline_ForwardPipeline_setAmbient)
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setShadowCascadeCount)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setShadowCascadeCount_fast(v8::Local<v8::Object> receiver, uint32_t arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setShadowCascadeCount(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setShadowCascadeCount_fast)
+#endif
 
-static bool js_pipeline_ForwardPipeline_setFog(se::State& s)
+static bool js_pipeline_ForwardPipeline_setShadowCascadeDistance(se::State& s)
 {
     cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
-    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setFog : Invalid Native Object");
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setShadowCascadeDistance : Invalid Native Object");
     const auto& args = s.args();
     size_t argc = args.size();
     CC_UNUSED bool ok = true;
     if (argc == 1) {
-        HolderType<unsigned int, false> arg0 = {};
+        HolderType<float, false> arg0 = {};
         ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
-        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setFog : Error processing arguments");
-        cobj->setFog(arg0.value());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setShadowCascadeDistance : Error processing arguments");
+        cobj->setShadowCascadeDistance(arg0.value());
         return true;
     }
     SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
     return false;
 }
-SE_BIND_FUNC(js_pipeline_ForwardPipeline_setFog)
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setShadowCascadeDistance)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setShadowCascadeDistance_fast(v8::Local<v8::Object> receiver, float arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setShadowCascadeDistance(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setShadowCascadeDistance_fast)
+#endif
 
-static bool js_pipeline_ForwardPipeline_setRenderObjects(se::State& s)
+static bool js_pipeline_ForwardPipeline_setShadowMapCache(se::State& s)
 {
     cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
-    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setRenderObjects : Invalid Native Object");
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setShadowMapCache : Invalid Native Object");
     const auto& args = s.args();
     size_t argc = args.size();
     CC_UNUSED bool ok = true;
     if (argc == 1) {
-        HolderType<std::vector<cc::pipeline::RenderObject>, true> arg0 = {};
+        HolderType<bool, false> arg0 = {};
         ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
-        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setRenderObjects : Error processing arguments");
-        cobj->setRenderObjects(arg0.value());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setShadowMapCache : Error processing arguments");
+        cobj->setShadowMapCache(arg0.value());
         return true;
     }
     SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
     return false;
 }
-SE_BIND_FUNC(js_pipeline_ForwardPipeline_setRenderObjects)
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setShadowMapCache)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setShadowMapCache_fast(v8::Local<v8::Object> receiver, bool arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setShadowMapCache(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setShadowMapCache_fast)
+#endif
 
 static bool js_pipeline_ForwardPipeline_setShadows(se::State& s)
 {
@@ -2205,6 +3563,18 @@ static bool js_pipeline_ForwardPipeline_setShadows(se::State& s)
     return false;
 }
 SE_BIND_FUNC(js_pipeline_ForwardPipeline_setShadows)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setShadows_fast(v8::Local<v8::Object> receiver, uint32_t arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setShadows(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setShadows_fast)
+#endif
 
 static bool js_pipeline_ForwardPipeline_setSkybox(se::State& s)
 {
@@ -2224,6 +3594,111 @@ static bool js_pipeline_ForwardPipeline_setSkybox(se::State& s)
     return false;
 }
 SE_BIND_FUNC(js_pipeline_ForwardPipeline_setSkybox)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setSkybox_fast(v8::Local<v8::Object> receiver, uint32_t arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setSkybox(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setSkybox_fast)
+#endif
+
+static bool js_pipeline_ForwardPipeline_setSpatialIndex(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setSpatialIndex : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<bool, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setSpatialIndex : Error processing arguments");
+        cobj->setSpatialIndex(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setSpatialIndex)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setSpatialIndex_fast(v8::Local<v8::Object> receiver, bool arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setSpatialIndex(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setSpatialIndex_fast)
+#endif
+
+static bool js_pipeline_ForwardPipeline_setTextureStreaming(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setTextureStreaming : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<bool, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setTextureStreaming : Error processing arguments");
+        cobj->setTextureStreaming(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setTextureStreaming)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setTextureStreaming_fast(v8::Local<v8::Object> receiver, bool arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setTextureStreaming(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setTextureStreaming_fast)
+#endif
+
+static bool js_pipeline_ForwardPipeline_setTextureStreamingBudget(se::State& s)
+{
+    cc::pipeline::ForwardPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::ForwardPipeline>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_ForwardPipeline_setTextureStreamingBudget : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<unsigned int, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_pipeline_ForwardPipeline_setTextureStreamingBudget : Error processing arguments");
+        cobj->setTextureStreamingBudget(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_ForwardPipeline_setTextureStreamingBudget)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_ForwardPipeline_setTextureStreamingBudget_fast(v8::Local<v8::Object> receiver, uint32_t arg0, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::ForwardPipeline>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setTextureStreamingBudget(arg0);
+}
+SE_BIND_FAST_FUNC(js_pipeline_ForwardPipeline_setTextureStreamingBudget_fast)
+#endif
 
 SE_DECLARE_FINALIZE_FUNC(js_cc_pipeline_ForwardPipeline_finalize)
 
@@ -2257,12 +3732,187 @@ bool js_register_pipeline_ForwardPipeline(se::Object* obj)
 {
     auto cls = se::Class::create("ForwardPipeline", obj, __jsb_cc_pipeline_RenderPipeline_proto, _SE(js_pipeline_ForwardPipeline_constructor));
 
+    cls->defineFunction("addStreamingTexture", _SE(js_pipeline_ForwardPipeline_addStreamingTexture));
+    cls->defineFunction("buildStaticBatches", _SE(js_pipeline_ForwardPipeline_buildStaticBatches));
+    cls->defineFunction("clearStaticBatches", _SE(js_pipeline_ForwardPipeline_clearStaticBatches));
+    cls->defineFunction("destroyScene", _SE(js_pipeline_ForwardPipeline_destroyScene));
+    cls->defineFunction("getCameraOverdraw", _SE(js_pipeline_ForwardPipeline_getCameraOverdraw));
+    cls->defineFunction("getDepthPrepassOverdrawThreshold", _SE(js_pipeline_ForwardPipeline_getDepthPrepassOverdrawThreshold));
+    cls->defineFunction("getDynamicResolutionScale", _SE(js_pipeline_ForwardPipeline_getDynamicResolutionScale));
+    cls->defineFunction("getDynamicResolutionTargetTime", _SE(js_pipeline_ForwardPipeline_getDynamicResolutionTargetTime));
+    cls->defineFunction("getLODHysteresis", _SE(js_pipeline_ForwardPipeline_getLODHysteresis));
+    cls->defineFunction("getOcclusionQueryMinRadius", _SE(js_pipeline_ForwardPipeline_getOcclusionQueryMinRadius));
+    cls->defineFunction("getOcclusionQueryReprojectionDistance", _SE(js_pipeline_ForwardPipeline_getOcclusionQueryReprojectionDistance));
+    cls->defineFunction("getShadowCascadeCount", _SE(js_pipeline_ForwardPipeline_getShadowCascadeCount));
+    cls->defineFunction("getShadowCascadeDistance", _SE(js_pipeline_ForwardPipeline_getShadowCascadeDistance));
     cls->defineFunction("getSphere", _SE(js_pipeline_ForwardPipeline_getSphere));
+    cls->defineFunction("getTextureStreamingBudget", _SE(js_pipeline_ForwardPipeline_getTextureStreamingBudget));
+    cls->defineFunction("getTextureStreamingResidentSize", _SE(js_pipeline_ForwardPipeline_getTextureStreamingResidentSize));
+    cls->defineFunction("isClusteredLighting", _SE(js_pipeline_ForwardPipeline_isClusteredLighting));
+    cls->defineFunction("isDynamicResolution", _SE(js_pipeline_ForwardPipeline_isDynamicResolution));
+    cls->defineFunction("isMultiViewCulling", _SE(js_pipeline_ForwardPipeline_isMultiViewCulling));
+    cls->defineFunction("isOcclusionQueries", _SE(js_pipeline_ForwardPipeline_isOcclusionQueries));
+    cls->defineFunction("isPackedCulling", _SE(js_pipeline_ForwardPipeline_isPackedCulling));
+    cls->defineFunction("isParallelCulling", _SE(js_pipeline_ForwardPipeline_isParallelCulling));
+    cls->defineFunction("isParallelRecording", _SE(js_pipeline_ForwardPipeline_isParallelRecording));
+    cls->defineFunction("isRadixSort", _SE(js_pipeline_ForwardPipeline_isRadixSort));
+    cls->defineFunction("isShadowMapCache", _SE(js_pipeline_ForwardPipeline_isShadowMapCache));
+    cls->defineFunction("isSpatialIndex", _SE(js_pipeline_ForwardPipeline_isSpatialIndex));
+    cls->defineFunction("isTextureStreaming", _SE(js_pipeline_ForwardPipeline_isTextureStreaming));
+    cls->defineFunction("removeStreamingTexture", _SE(js_pipeline_ForwardPipeline_removeStreamingTexture));
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("requestCameraUpdate", _SE(js_pipeline_ForwardPipeline_requestCameraUpdate), _SE_FAST(js_pipeline_ForwardPipeline_requestCameraUpdate_fast));
+#else
+    cls->defineFunction("requestCameraUpdate", _SE(js_pipeline_ForwardPipeline_requestCameraUpdate));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setAmbient", _SE(js_pipeline_ForwardPipeline_setAmbient), _SE_FAST(js_pipeline_ForwardPipeline_setAmbient_fast));
+#else
     cls->defineFunction("setAmbient", _SE(js_pipeline_ForwardPipeline_setAmbient));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setCameraUpdatePolicy", _SE(js_pipeline_ForwardPipeline_setCameraUpdatePolicy), _SE_FAST(js_pipeline_ForwardPipeline_setCameraUpdatePolicy_fast));
+#else
+    cls->defineFunction("setCameraUpdatePolicy", _SE(js_pipeline_ForwardPipeline_setCameraUpdatePolicy));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setClusteredLighting", _SE(js_pipeline_ForwardPipeline_setClusteredLighting), _SE_FAST(js_pipeline_ForwardPipeline_setClusteredLighting_fast));
+#else
+    cls->defineFunction("setClusteredLighting", _SE(js_pipeline_ForwardPipeline_setClusteredLighting));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setDepthPrepassMode", _SE(js_pipeline_ForwardPipeline_setDepthPrepassMode), _SE_FAST(js_pipeline_ForwardPipeline_setDepthPrepassMode_fast));
+#else
+    cls->defineFunction("setDepthPrepassMode", _SE(js_pipeline_ForwardPipeline_setDepthPrepassMode));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setDepthPrepassOverdrawThreshold", _SE(js_pipeline_ForwardPipeline_setDepthPrepassOverdrawThreshold), _SE_FAST(js_pipeline_ForwardPipeline_setDepthPrepassOverdrawThreshold_fast));
+#else
+    cls->defineFunction("setDepthPrepassOverdrawThreshold", _SE(js_pipeline_ForwardPipeline_setDepthPrepassOverdrawThreshold));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setDynamicResolution", _SE(js_pipeline_ForwardPipeline_setDynamicResolution), _SE_FAST(js_pipeline_ForwardPipeline_setDynamicResolution_fast));
+#else
+    cls->defineFunction("setDynamicResolution", _SE(js_pipeline_ForwardPipeline_setDynamicResolution));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setDynamicResolutionScaleRange", _SE(js_pipeline_ForwardPipeline_setDynamicResolutionScaleRange), _SE_FAST(js_pipeline_ForwardPipeline_setDynamicResolutionScaleRange_fast));
+#else
+    cls->defineFunction("setDynamicResolutionScaleRange", _SE(js_pipeline_ForwardPipeline_setDynamicResolutionScaleRange));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setDynamicResolutionSharpness", _SE(js_pipeline_ForwardPipeline_setDynamicResolutionSharpness), _SE_FAST(js_pipeline_ForwardPipeline_setDynamicResolutionSharpness_fast));
+#else
+    cls->defineFunction("setDynamicResolutionSharpness", _SE(js_pipeline_ForwardPipeline_setDynamicResolutionSharpness));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setDynamicResolutionTargetTime", _SE(js_pipeline_ForwardPipeline_setDynamicResolutionTargetTime), _SE_FAST(js_pipeline_ForwardPipeline_setDynamicResolutionTargetTime_fast));
+#else
+    cls->defineFunction("setDynamicResolutionTargetTime", _SE(js_pipeline_ForwardPipeline_setDynamicResolutionTargetTime));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setFog", _SE(js_pipeline_ForwardPipeline_setFog), _SE_FAST(js_pipeline_ForwardPipeline_setFog_fast));
+#else
     cls->defineFunction("setFog", _SE(js_pipeline_ForwardPipeline_setFog));
+#endif
+    cls->defineFunction("setLODGroup", _SE(js_pipeline_ForwardPipeline_setLODGroup));
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setLODHysteresis", _SE(js_pipeline_ForwardPipeline_setLODHysteresis), _SE_FAST(js_pipeline_ForwardPipeline_setLODHysteresis_fast));
+#else
+    cls->defineFunction("setLODHysteresis", _SE(js_pipeline_ForwardPipeline_setLODHysteresis));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setMultiViewCulling", _SE(js_pipeline_ForwardPipeline_setMultiViewCulling), _SE_FAST(js_pipeline_ForwardPipeline_setMultiViewCulling_fast));
+#else
+    cls->defineFunction("setMultiViewCulling", _SE(js_pipeline_ForwardPipeline_setMultiViewCulling));
+#endif
+    cls->defineFunction("setOccluder", _SE(js_pipeline_ForwardPipeline_setOccluder));
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setOcclusionBufferSize", _SE(js_pipeline_ForwardPipeline_setOcclusionBufferSize), _SE_FAST(js_pipeline_ForwardPipeline_setOcclusionBufferSize_fast));
+#else
+    cls->defineFunction("setOcclusionBufferSize", _SE(js_pipeline_ForwardPipeline_setOcclusionBufferSize));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setOcclusionCulling", _SE(js_pipeline_ForwardPipeline_setOcclusionCulling), _SE_FAST(js_pipeline_ForwardPipeline_setOcclusionCulling_fast));
+#else
+    cls->defineFunction("setOcclusionCulling", _SE(js_pipeline_ForwardPipeline_setOcclusionCulling));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setOcclusionQueries", _SE(js_pipeline_ForwardPipeline_setOcclusionQueries), _SE_FAST(js_pipeline_ForwardPipeline_setOcclusionQueries_fast));
+#else
+    cls->defineFunction("setOcclusionQueries", _SE(js_pipeline_ForwardPipeline_setOcclusionQueries));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setOcclusionQueryMinRadius", _SE(js_pipeline_ForwardPipeline_setOcclusionQueryMinRadius), _SE_FAST(js_pipeline_ForwardPipeline_setOcclusionQueryMinRadius_fast));
+#else
+    cls->defineFunction("setOcclusionQueryMinRadius", _SE(js_pipeline_ForwardPipeline_setOcclusionQueryMinRadius));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setOcclusionQueryReprojectionDistance", _SE(js_pipeline_ForwardPipeline_setOcclusionQueryReprojectionDistance), _SE_FAST(js_pipeline_ForwardPipeline_setOcclusionQueryReprojectionDistance_fast));
+#else
+    cls->defineFunction("setOcclusionQueryReprojectionDistance", _SE(js_pipeline_ForwardPipeline_setOcclusionQueryReprojectionDistance));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setPackedCulling", _SE(js_pipeline_ForwardPipeline_setPackedCulling), _SE_FAST(js_pipeline_ForwardPipeline_setPackedCulling_fast));
+#else
+    cls->defineFunction("setPackedCulling", _SE(js_pipeline_ForwardPipeline_setPackedCulling));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setParallelCulling", _SE(js_pipeline_ForwardPipeline_setParallelCulling), _SE_FAST(js_pipeline_ForwardPipeline_setParallelCulling_fast));
+#else
+    cls->defineFunction("setParallelCulling", _SE(js_pipeline_ForwardPipeline_setParallelCulling));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setParallelRecording", _SE(js_pipeline_ForwardPipeline_setParallelRecording), _SE_FAST(js_pipeline_ForwardPipeline_setParallelRecording_fast));
+#else
+    cls->defineFunction("setParallelRecording", _SE(js_pipeline_ForwardPipeline_setParallelRecording));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setRadixSort", _SE(js_pipeline_ForwardPipeline_setRadixSort), _SE_FAST(js_pipeline_ForwardPipeline_setRadixSort_fast));
+#else
+    cls->defineFunction("setRadixSort", _SE(js_pipeline_ForwardPipeline_setRadixSort));
+#endif
     cls->defineFunction("setRenderObjects", _SE(js_pipeline_ForwardPipeline_setRenderObjects));
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setShadowCascadeCount", _SE(js_pipeline_ForwardPipeline_setShadowCascadeCount), _SE_FAST(js_pipeline_ForwardPipeline_setShadowCascadeCount_fast));
+#else
+    cls->defineFunction("setShadowCascadeCount", _SE(js_pipeline_ForwardPipeline_setShadowCascadeCount));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setShadowCascadeDistance", _SE(js_pipeline_ForwardPipeline_setShadowCascadeDistance), _SE_FAST(js_pipeline_ForwardPipeline_setShadowCascadeDistance_fast));
+#else
+    cls->defineFunction("setShadowCascadeDistance", _SE(js_pipeline_ForwardPipeline_setShadowCascadeDistance));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setShadowMapCache", _SE(js_pipeline_ForwardPipeline_setShadowMapCache), _SE_FAST(js_pipeline_ForwardPipeline_setShadowMapCache_fast));
+#else
+    cls->defineFunction("setShadowMapCache", _SE(js_pipeline_ForwardPipeline_setShadowMapCache));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setShadows", _SE(js_pipeline_ForwardPipeline_setShadows), _SE_FAST(js_pipeline_ForwardPipeline_setShadows_fast));
+#else
     cls->defineFunction("setShadows", _SE(js_pipeline_ForwardPipeline_setShadows));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setSkybox", _SE(js_pipeline_ForwardPipeline_setSkybox), _SE_FAST(js_pipeline_ForwardPipeline_setSkybox_fast));
+#else
     cls->defineFunction("setSkybox", _SE(js_pipeline_ForwardPipeline_setSkybox));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setSpatialIndex", _SE(js_pipeline_ForwardPipeline_setSpatialIndex), _SE_FAST(js_pipeline_ForwardPipeline_setSpatialIndex_fast));
+#else
+    cls->defineFunction("setSpatialIndex", _SE(js_pipeline_ForwardPipeline_setSpatialIndex));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setTextureStreaming", _SE(js_pipeline_ForwardPipeline_setTextureStreaming), _SE_FAST(js_pipeline_ForwardPipeline_setTextureStreaming_fast));
+#else
+    cls->defineFunction("setTextureStreaming", _SE(js_pipeline_ForwardPipeline_setTextureStreaming));
+#endif
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setTextureStreamingBudget", _SE(js_pipeline_ForwardPipeline_setTextureStreamingBudget), _SE_FAST(js_pipeline_ForwardPipeline_setTextureStreamingBudget_fast));
+#else
+    cls->defineFunction("setTextureStreamingBudget", _SE(js_pipeline_ForwardPipeline_setTextureStreamingBudget));
+#endif
     cls->defineFinalizeFunction(_SE(js_cc_pipeline_ForwardPipeline_finalize));
     cls->install();
     JSBClassType::registerClass<cc::pipeline::ForwardPipeline>(cls);
@@ -2394,19 +4044,19 @@ bool sevalue_to_native(const se::Value &from, cc::pipeline::RenderFlowInfo * to,
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("name", &field);
+    json->getProperty("name", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->name), ctx);
     }
-    json->getProperty("priority", &field);
+    json->getProperty("priority", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->priority), ctx);
     }
-    json->getProperty("tag", &field);
+    json->getProperty("tag", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->tag), ctx);
     }
-    json->getProperty("stages", &field);
+    json->getProperty("stages", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->stages), ctx);
     }
@@ -2776,19 +4426,19 @@ bool sevalue_to_native(const se::Value &from, cc::pipeline::RenderStageInfo * to
     }
     se::Value field;
     bool ok = true;
-    json->getProperty("name", &field);
+    json->getProperty("name", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->name), ctx);
     }
-    json->getProperty("priority", &field);
+    json->getProperty("priority", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->priority), ctx);
     }
-    json->getProperty("tag", &field);
+    json->getProperty("tag", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->tag), ctx);
     }
-    json->getProperty("renderQueues", &field);
+    json->getProperty("renderQueues", &field, true);
     if(!field.isNullOrUndefined()) {
         ok &= sevalue_to_native(field, &(to->renderQueues), ctx);
     }
@@ -2918,6 +4568,24 @@ static bool js_pipeline_RenderStage_activate(se::State& s)
 }
 SE_BIND_FUNC(js_pipeline_RenderStage_activate)
 
+static bool js_pipeline_RenderStage_getGPUTime(se::State& s)
+{
+    cc::pipeline::RenderStage* cobj = SE_THIS_OBJECT<cc::pipeline::RenderStage>(s);
+    SE_PRECONDITION2(cobj, false, "js_pipeline_RenderStage_getGPUTime : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        float result = cobj->getGPUTime();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_RenderStage_getGPUTime : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_RenderStage_getGPUTime)
+
 static bool js_pipeline_RenderStage_getTag(se::State& s)
 {
     cc::pipeline::RenderStage* cobj = SE_THIS_OBJECT<cc::pipeline::RenderStage>(s);
@@ -2965,6 +4633,7 @@ bool js_register_pipeline_RenderStage(se::Object* obj)
     auto cls = se::Class::create("RenderStage", obj, nullptr, nullptr);
 
     cls->defineFunction("activate", _SE(js_pipeline_RenderStage_activate));
+    cls->defineFunction("getGPUTime", _SE(js_pipeline_RenderStage_getGPUTime));
     cls->defineFunction("getTag", _SE(js_pipeline_RenderStage_getTag));
     cls->defineFunction("initialize", _SE(js_pipeline_RenderStage_initialize));
     cls->install();
@@ -3246,6 +4915,18 @@ static bool js_pipeline_InstancedBuffer_setDynamicOffset(se::State& s)
     return false;
 }
 SE_BIND_FUNC(js_pipeline_InstancedBuffer_setDynamicOffset)
+#if SE_ENABLE_FAST_API_CALLS
+static void js_pipeline_InstancedBuffer_setDynamicOffset_fast(v8::Local<v8::Object> receiver, uint32_t arg0, uint32_t arg1, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<cc::pipeline::InstancedBuffer>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->setDynamicOffset(arg0, arg1);
+}
+SE_BIND_FAST_FUNC(js_pipeline_InstancedBuffer_setDynamicOffset_fast)
+#endif
 
 static bool js_pipeline_InstancedBuffer_get(se::State& s)
 {
@@ -3319,7 +5000,11 @@ bool js_register_pipeline_InstancedBuffer(se::Object* obj)
     auto cls = se::Class::create("InstancedBuffer", obj, nullptr, _SE(js_pipeline_InstancedBuffer_constructor));
 
     cls->defineFunction("destroy", _SE(js_pipeline_InstancedBuffer_destroy));
+#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("setDynamicOffset", _SE(js_pipeline_InstancedBuffer_setDynamicOffset), _SE_FAST(js_pipeline_InstancedBuffer_setDynamicOffset_fast));
+#else
     cls->defineFunction("setDynamicOffset", _SE(js_pipeline_InstancedBuffer_setDynamicOffset));
+#endif
     cls->defineStaticFunction("get", _SE(js_pipeline_InstancedBuffer_get));
     cls->defineFinalizeFunction(_SE(js_cc_pipeline_InstancedBuffer_finalize));
     cls->install();
@@ -3332,6 +5017,178 @@ bool js_register_pipeline_InstancedBuffer(se::Object* obj)
     return true;
 }
 
+se::Object* __jsb_cc_pipeline_DeferredPipeline_proto = nullptr;
+se::Class* __jsb_cc_pipeline_DeferredPipeline_class = nullptr;
+
+SE_DECLARE_FINALIZE_FUNC(js_cc_pipeline_DeferredPipeline_finalize)
+
+static bool js_pipeline_DeferredPipeline_constructor(se::State& s) // constructor.c
+{
+    cc::pipeline::DeferredPipeline* cobj = JSB_ALLOC(cc::pipeline::DeferredPipeline);
+    s.thisObject()->setPrivateData(cobj);
+    se::NonRefNativePtrCreatedByCtorMap::emplace(cobj);
+    return true;
+}
+SE_BIND_CTOR(js_pipeline_DeferredPipeline_constructor, __jsb_cc_pipeline_DeferredPipeline_class, js_cc_pipeline_DeferredPipeline_finalize)
+
+
+
+extern se::Object* __jsb_cc_pipeline_ForwardPipeline_proto;
+
+static bool js_cc_pipeline_DeferredPipeline_finalize(se::State& s)
+{
+    auto iter = se::NonRefNativePtrCreatedByCtorMap::find(SE_THIS_OBJECT<cc::pipeline::DeferredPipeline>(s));
+    if (iter != se::NonRefNativePtrCreatedByCtorMap::end())
+    {
+        se::NonRefNativePtrCreatedByCtorMap::erase(iter);
+        cc::pipeline::DeferredPipeline* cobj = SE_THIS_OBJECT<cc::pipeline::DeferredPipeline>(s);
+        JSB_FREE(cobj);
+    }
+    return true;
+}
+SE_BIND_FINALIZE_FUNC(js_cc_pipeline_DeferredPipeline_finalize)
+
+bool js_register_pipeline_DeferredPipeline(se::Object* obj)
+{
+    auto cls = se::Class::create("DeferredPipeline", obj, __jsb_cc_pipeline_ForwardPipeline_proto, _SE(js_pipeline_DeferredPipeline_constructor));
+
+    cls->defineFinalizeFunction(_SE(js_cc_pipeline_DeferredPipeline_finalize));
+    cls->install();
+    JSBClassType::registerClass<cc::pipeline::DeferredPipeline>(cls);
+
+    __jsb_cc_pipeline_DeferredPipeline_proto = cls->getProto();
+    __jsb_cc_pipeline_DeferredPipeline_class = cls;
+
+    se::ScriptEngine::getInstance()->clearException();
+    return true;
+}
+
+se::Object* __jsb_cc_pipeline_DeferredFlow_proto = nullptr;
+se::Class* __jsb_cc_pipeline_DeferredFlow_class = nullptr;
+
+static bool js_pipeline_DeferredFlow_getInitializeInfo(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        const cc::pipeline::RenderFlowInfo& result = cc::pipeline::DeferredFlow::getInitializeInfo();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_DeferredFlow_getInitializeInfo : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_DeferredFlow_getInitializeInfo)
+
+SE_DECLARE_FINALIZE_FUNC(js_cc_pipeline_DeferredFlow_finalize)
+
+static bool js_pipeline_DeferredFlow_constructor(se::State& s) // constructor.c
+{
+    cc::pipeline::DeferredFlow* cobj = JSB_ALLOC(cc::pipeline::DeferredFlow);
+    s.thisObject()->setPrivateData(cobj);
+    se::NonRefNativePtrCreatedByCtorMap::emplace(cobj);
+    return true;
+}
+SE_BIND_CTOR(js_pipeline_DeferredFlow_constructor, __jsb_cc_pipeline_DeferredFlow_class, js_cc_pipeline_DeferredFlow_finalize)
+
+
+
+extern se::Object* __jsb_cc_pipeline_RenderFlow_proto;
+
+static bool js_cc_pipeline_DeferredFlow_finalize(se::State& s)
+{
+    auto iter = se::NonRefNativePtrCreatedByCtorMap::find(SE_THIS_OBJECT<cc::pipeline::DeferredFlow>(s));
+    if (iter != se::NonRefNativePtrCreatedByCtorMap::end())
+    {
+        se::NonRefNativePtrCreatedByCtorMap::erase(iter);
+        cc::pipeline::DeferredFlow* cobj = SE_THIS_OBJECT<cc::pipeline::DeferredFlow>(s);
+        JSB_FREE(cobj);
+    }
+    return true;
+}
+SE_BIND_FINALIZE_FUNC(js_cc_pipeline_DeferredFlow_finalize)
+
+bool js_register_pipeline_DeferredFlow(se::Object* obj)
+{
+    auto cls = se::Class::create("DeferredFlow", obj, __jsb_cc_pipeline_RenderFlow_proto, _SE(js_pipeline_DeferredFlow_constructor));
+
+    cls->defineStaticFunction("getInitializeInfo", _SE(js_pipeline_DeferredFlow_getInitializeInfo));
+    cls->defineFinalizeFunction(_SE(js_cc_pipeline_DeferredFlow_finalize));
+    cls->install();
+    JSBClassType::registerClass<cc::pipeline::DeferredFlow>(cls);
+
+    __jsb_cc_pipeline_DeferredFlow_proto = cls->getProto();
+    __jsb_cc_pipeline_DeferredFlow_class = cls;
+
+    se::ScriptEngine::getInstance()->clearException();
+    return true;
+}
+
+se::Object* __jsb_cc_pipeline_DeferredStage_proto = nullptr;
+se::Class* __jsb_cc_pipeline_DeferredStage_class = nullptr;
+
+static bool js_pipeline_DeferredStage_getInitializeInfo(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        const cc::pipeline::RenderStageInfo& result = cc::pipeline::DeferredStage::getInitializeInfo();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_pipeline_DeferredStage_getInitializeInfo : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_pipeline_DeferredStage_getInitializeInfo)
+
+SE_DECLARE_FINALIZE_FUNC(js_cc_pipeline_DeferredStage_finalize)
+
+static bool js_pipeline_DeferredStage_constructor(se::State& s) // constructor.c
+{
+    cc::pipeline::DeferredStage* cobj = JSB_ALLOC(cc::pipeline::DeferredStage);
+    s.thisObject()->setPrivateData(cobj);
+    se::NonRefNativePtrCreatedByCtorMap::emplace(cobj);
+    return true;
+}
+SE_BIND_CTOR(js_pipeline_DeferredStage_constructor, __jsb_cc_pipeline_DeferredStage_class, js_cc_pipeline_DeferredStage_finalize)
+
+
+
+extern se::Object* __jsb_cc_pipeline_RenderStage_proto;
+
+static bool js_cc_pipeline_DeferredStage_finalize(se::State& s)
+{
+    auto iter = se::NonRefNativePtrCreatedByCtorMap::find(SE_THIS_OBJECT<cc::pipeline::DeferredStage>(s));
+    if (iter != se::NonRefNativePtrCreatedByCtorMap::end())
+    {
+        se::NonRefNativePtrCreatedByCtorMap::erase(iter);
+        cc::pipeline::DeferredStage* cobj = SE_THIS_OBJECT<cc::pipeline::DeferredStage>(s);
+        JSB_FREE(cobj);
+    }
+    return true;
+}
+SE_BIND_FINALIZE_FUNC(js_cc_pipeline_DeferredStage_finalize)
+
+bool js_register_pipeline_DeferredStage(se::Object* obj)
+{
+    auto cls = se::Class::create("DeferredStage", obj, __jsb_cc_pipeline_RenderStage_proto, _SE(js_pipeline_DeferredStage_constructor));
+
+    cls->defineStaticFunction("getInitializeInfo", _SE(js_pipeline_DeferredStage_getInitializeInfo));
+    cls->defineFinalizeFunction(_SE(js_cc_pipeline_DeferredStage_finalize));
+    cls->install();
+    JSBClassType::registerClass<cc::pipeline::DeferredStage>(cls);
+
+    __jsb_cc_pipeline_DeferredStage_proto = cls->getProto();
+    __jsb_cc_pipeline_DeferredStage_class = cls;
+
+    se::ScriptEngine::getInstance()->clearException();
+    return true;
+}
+
 bool register_all_pipeline(se::Object* obj)
 {
     // Get the ns
@@ -3350,13 +5207,16 @@ bool register_all_pipeline(se::Object* obj)
     js_register_pipeline_RenderStageInfo(ns);
     js_register_pipeline_RenderPipeline(ns);
     js_register_pipeline_ForwardPipeline(ns);
+    js_register_pipeline_DeferredPipeline(ns);
     js_register_pipeline_RenderPipelineInfo(ns);
     js_register_pipeline_Light(ns);
     js_register_pipeline_RenderStage(ns);
     js_register_pipeline_ForwardStage(ns);
+    js_register_pipeline_DeferredStage(ns);
     js_register_pipeline_ShadowStage(ns);
     js_register_pipeline_RenderFlowInfo(ns);
     js_register_pipeline_ForwardFlow(ns);
+    js_register_pipeline_DeferredFlow(ns);
     js_register_pipeline_InstancedBuffer(ns);
     js_register_pipeline_RenderWindow(ns);
     js_register_pipeline_ShadowFlow(ns);
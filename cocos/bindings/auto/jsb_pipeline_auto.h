@@ -7,6 +7,9 @@
 #include "cocos/renderer/pipeline/forward/ForwardPipeline.h"
 #include "cocos/renderer/pipeline/forward/ForwardFlow.h"
 #include "cocos/renderer/pipeline/forward/ForwardStage.h"
+#include "cocos/renderer/pipeline/deferred/DeferredPipeline.h"
+#include "cocos/renderer/pipeline/deferred/DeferredFlow.h"
+#include "cocos/renderer/pipeline/deferred/DeferredStage.h"
 #include "cocos/renderer/pipeline/shadow/ShadowFlow.h"
 #include "cocos/renderer/pipeline/shadow/ShadowStage.h"
 #include "cocos/renderer/pipeline/RenderPipeline.h"
@@ -89,7 +92,9 @@ JSB_REGISTER_OBJECT_TYPE(cc::pipeline::RenderPipeline);
 SE_DECLARE_FUNC(js_pipeline_RenderPipeline_activate);
 SE_DECLARE_FUNC(js_pipeline_RenderPipeline_destroy);
 SE_DECLARE_FUNC(js_pipeline_RenderPipeline_initialize);
+SE_DECLARE_FUNC(js_pipeline_RenderPipeline_isGPUTimingEnabled);
 SE_DECLARE_FUNC(js_pipeline_RenderPipeline_render);
+SE_DECLARE_FUNC(js_pipeline_RenderPipeline_setGPUTimingEnabled);
 SE_DECLARE_FUNC(js_pipeline_RenderPipeline_setValue);
 SE_DECLARE_FUNC(js_pipeline_RenderPipeline_getInstance);
 
@@ -100,12 +105,66 @@ bool js_register_cc_pipeline_ForwardPipeline(se::Object* obj);
 bool register_all_pipeline(se::Object* obj);
 
 JSB_REGISTER_OBJECT_TYPE(cc::pipeline::ForwardPipeline);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_addStreamingTexture);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_buildStaticBatches);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_clearStaticBatches);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_getCameraOverdraw);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_getDepthPrepassOverdrawThreshold);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_getDynamicResolutionScale);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_getDynamicResolutionTargetTime);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_getLODHysteresis);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_getOcclusionQueryMinRadius);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_getOcclusionQueryReprojectionDistance);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_getShadowCascadeCount);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_getShadowCascadeDistance);
 SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_getSphere);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_getTextureStreamingBudget);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_getTextureStreamingResidentSize);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_isClusteredLighting);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_isDynamicResolution);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_isMultiViewCulling);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_isOcclusionQueries);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_isPackedCulling);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_isParallelCulling);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_isParallelRecording);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_isRadixSort);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_isShadowMapCache);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_isSpatialIndex);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_isTextureStreaming);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_removeStreamingTexture);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_requestCameraUpdate);
 SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setAmbient);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setCameraUpdatePolicy);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setClusteredLighting);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setDepthPrepassMode);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setDepthPrepassOverdrawThreshold);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setDynamicResolution);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setDynamicResolutionScaleRange);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setDynamicResolutionSharpness);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setDynamicResolutionTargetTime);
 SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setFog);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setLODGroup);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setLODHysteresis);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setMultiViewCulling);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setOccluder);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setOcclusionBufferSize);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setOcclusionCulling);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setOcclusionQueries);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setOcclusionQueryMinRadius);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setOcclusionQueryReprojectionDistance);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setPackedCulling);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setParallelCulling);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setParallelRecording);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setRadixSort);
 SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setRenderObjects);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setShadowCascadeCount);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setShadowCascadeDistance);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setShadowMapCache);
 SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setShadows);
 SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setSkybox);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setSpatialIndex);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setTextureStreaming);
+SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_setTextureStreamingBudget);
 SE_DECLARE_FUNC(js_pipeline_ForwardPipeline_ForwardPipeline);
 
 extern se::Object* __jsb_cc_pipeline_RenderFlowInfo_proto;
@@ -157,6 +216,7 @@ bool register_all_pipeline(se::Object* obj);
 
 JSB_REGISTER_OBJECT_TYPE(cc::pipeline::RenderStage);
 SE_DECLARE_FUNC(js_pipeline_RenderStage_activate);
+SE_DECLARE_FUNC(js_pipeline_RenderStage_getGPUTime);
 SE_DECLARE_FUNC(js_pipeline_RenderStage_getTag);
 SE_DECLARE_FUNC(js_pipeline_RenderStage_initialize);
 
@@ -204,3 +264,31 @@ SE_DECLARE_FUNC(js_pipeline_InstancedBuffer_setDynamicOffset);
 SE_DECLARE_FUNC(js_pipeline_InstancedBuffer_get);
 SE_DECLARE_FUNC(js_pipeline_InstancedBuffer_InstancedBuffer);
 
+extern se::Object* __jsb_cc_pipeline_DeferredPipeline_proto;
+extern se::Class* __jsb_cc_pipeline_DeferredPipeline_class;
+
+bool js_register_cc_pipeline_DeferredPipeline(se::Object* obj);
+bool register_all_pipeline(se::Object* obj);
+
+JSB_REGISTER_OBJECT_TYPE(cc::pipeline::DeferredPipeline);
+SE_DECLARE_FUNC(js_pipeline_DeferredPipeline_DeferredPipeline);
+
+extern se::Object* __jsb_cc_pipeline_DeferredFlow_proto;
+extern se::Class* __jsb_cc_pipeline_DeferredFlow_class;
+
+bool js_register_cc_pipeline_DeferredFlow(se::Object* obj);
+bool register_all_pipeline(se::Object* obj);
+
+JSB_REGISTER_OBJECT_TYPE(cc::pipeline::DeferredFlow);
+SE_DECLARE_FUNC(js_pipeline_DeferredFlow_getInitializeInfo);
+SE_DECLARE_FUNC(js_pipeline_DeferredFlow_DeferredFlow);
+
+extern se::Object* __jsb_cc_pipeline_DeferredStage_proto;
+extern se::Class* __jsb_cc_pipeline_DeferredStage_class;
+
+bool js_register_cc_pipeline_DeferredStage(se::Object* obj);
+bool register_all_pipeline(se::Object* obj);
+
+JSB_REGISTER_OBJECT_TYPE(cc::pipeline::DeferredStage);
+SE_DECLARE_FUNC(js_pipeline_DeferredStage_getInitializeInfo);
+SE_DECLARE_FUNC(js_pipeline_DeferredStage_DeferredStage);
@@ -13268,6 +13268,25 @@ static bool js_spine_SkeletonRenderer_setBatchEnabled(se::State& s)
 }
 SE_BIND_FUNC(js_spine_SkeletonRenderer_setBatchEnabled)
 
+static bool js_spine_SkeletonRenderer_setBatchKey(se::State& s)
+{
+    spine::SkeletonRenderer* cobj = SE_THIS_OBJECT<spine::SkeletonRenderer>(s);
+    SE_PRECONDITION2(cobj, false, "js_spine_SkeletonRenderer_setBatchKey : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<unsigned int, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_spine_SkeletonRenderer_setBatchKey : Error processing arguments");
+        cobj->setBatchKey(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_spine_SkeletonRenderer_setBatchKey)
+
 static bool js_spine_SkeletonRenderer_setBonesToSetupPose(se::State& s)
 {
     spine::SkeletonRenderer* cobj = SE_THIS_OBJECT<spine::SkeletonRenderer>(s);
@@ -13740,6 +13759,7 @@ bool js_register_spine_SkeletonRenderer(se::Object* obj)
     cls->defineFunction("setAttachEnabled", _SE(js_spine_SkeletonRenderer_setAttachEnabled));
     cls->defineFunction("setAttachment", _SE(js_spine_SkeletonRenderer_setAttachment));
     cls->defineFunction("setBatchEnabled", _SE(js_spine_SkeletonRenderer_setBatchEnabled));
+    cls->defineFunction("setBatchKey", _SE(js_spine_SkeletonRenderer_setBatchKey));
     cls->defineFunction("setBonesToSetupPose", _SE(js_spine_SkeletonRenderer_setBonesToSetupPose));
     cls->defineFunction("setColor", _SE(js_spine_SkeletonRenderer_setColor));
     cls->defineFunction("setDebugBonesEnabled", _SE(js_spine_SkeletonRenderer_setDebugBonesEnabled));
@@ -14042,6 +14062,25 @@ static bool js_spine_SkeletonAnimation_setCompleteListener(se::State& s)
 }
 SE_BIND_FUNC(js_spine_SkeletonAnimation_setCompleteListener)
 
+static bool js_spine_SkeletonAnimation_setCulled(se::State& s)
+{
+    spine::SkeletonAnimation* cobj = SE_THIS_OBJECT<spine::SkeletonAnimation>(s);
+    SE_PRECONDITION2(cobj, false, "js_spine_SkeletonAnimation_setCulled : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<bool, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_spine_SkeletonAnimation_setCulled : Error processing arguments");
+        cobj->setCulled(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_spine_SkeletonAnimation_setCulled)
+
 static bool js_spine_SkeletonAnimation_setDisposeListener(se::State& s)
 {
     spine::SkeletonAnimation* cobj = SE_THIS_OBJECT<spine::SkeletonAnimation>(s);
@@ -14649,6 +14688,25 @@ static bool js_spine_SkeletonAnimation_setTrackStartListener(se::State& s)
 }
 SE_BIND_FUNC(js_spine_SkeletonAnimation_setTrackStartListener)
 
+static bool js_spine_SkeletonAnimation_setUpdateInterval(se::State& s)
+{
+    spine::SkeletonAnimation* cobj = SE_THIS_OBJECT<spine::SkeletonAnimation>(s);
+    SE_PRECONDITION2(cobj, false, "js_spine_SkeletonAnimation_setUpdateInterval : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<unsigned int, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_spine_SkeletonAnimation_setUpdateInterval : Error processing arguments");
+        cobj->setUpdateInterval(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_spine_SkeletonAnimation_setUpdateInterval)
+
 static bool js_spine_SkeletonAnimation_createWithBinaryFile(se::State& s)
 {
     const auto& args = s.args();
@@ -14805,6 +14863,7 @@ bool js_register_spine_SkeletonAnimation(se::Object* obj)
     cls->defineFunction("setAnimation", _SE(js_spine_SkeletonAnimation_setAnimation));
     cls->defineFunction("setAnimationStateData", _SE(js_spine_SkeletonAnimation_setAnimationStateData));
     cls->defineFunction("setCompleteListenerNative", _SE(js_spine_SkeletonAnimation_setCompleteListener));
+    cls->defineFunction("setCulled", _SE(js_spine_SkeletonAnimation_setCulled));
     cls->defineFunction("setDisposeListener", _SE(js_spine_SkeletonAnimation_setDisposeListener));
     cls->defineFunction("setEmptyAnimation", _SE(js_spine_SkeletonAnimation_setEmptyAnimation));
     cls->defineFunction("setEmptyAnimations", _SE(js_spine_SkeletonAnimation_setEmptyAnimations));
@@ -14819,6 +14878,7 @@ bool js_register_spine_SkeletonAnimation(se::Object* obj)
     cls->defineFunction("setTrackEventListener", _SE(js_spine_SkeletonAnimation_setTrackEventListener));
     cls->defineFunction("setTrackInterruptListener", _SE(js_spine_SkeletonAnimation_setTrackInterruptListener));
     cls->defineFunction("setTrackStartListener", _SE(js_spine_SkeletonAnimation_setTrackStartListener));
+    cls->defineFunction("setUpdateInterval", _SE(js_spine_SkeletonAnimation_setUpdateInterval));
     cls->defineFunction("ctor", _SE(js_spine_SkeletonAnimation_ctor));
     cls->defineStaticFunction("createWithBinaryFile", _SE(js_spine_SkeletonAnimation_createWithBinaryFile));
     cls->defineStaticFunction("create", _SE(js_spine_SkeletonAnimation_create));
@@ -14871,6 +14931,25 @@ static bool js_spine_SkeletonCacheAnimation_addAnimation(se::State& s)
 }
 SE_BIND_FUNC(js_spine_SkeletonCacheAnimation_addAnimation)
 
+static bool js_spine_SkeletonCacheAnimation_bakeAnimationCache(se::State& s)
+{
+    spine::SkeletonCacheAnimation* cobj = SE_THIS_OBJECT<spine::SkeletonCacheAnimation>(s);
+    SE_PRECONDITION2(cobj, false, "js_spine_SkeletonCacheAnimation_bakeAnimationCache : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<std::string, true> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_spine_SkeletonCacheAnimation_bakeAnimationCache : Error processing arguments");
+        cobj->bakeAnimationCache(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_spine_SkeletonCacheAnimation_bakeAnimationCache)
+
 static bool js_spine_SkeletonCacheAnimation_beginSchedule(se::State& s)
 {
     spine::SkeletonCacheAnimation* cobj = SE_THIS_OBJECT<spine::SkeletonCacheAnimation>(s);
@@ -15195,6 +15274,25 @@ static bool js_spine_SkeletonCacheAnimation_setAttachment(se::State& s)
 }
 SE_BIND_FUNC(js_spine_SkeletonCacheAnimation_setAttachment)
 
+static bool js_spine_SkeletonCacheAnimation_setBackgroundBakeEnabled(se::State& s)
+{
+    spine::SkeletonCacheAnimation* cobj = SE_THIS_OBJECT<spine::SkeletonCacheAnimation>(s);
+    SE_PRECONDITION2(cobj, false, "js_spine_SkeletonCacheAnimation_setBackgroundBakeEnabled : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<bool, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_spine_SkeletonCacheAnimation_setBackgroundBakeEnabled : Error processing arguments");
+        cobj->setBackgroundBakeEnabled(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_spine_SkeletonCacheAnimation_setBackgroundBakeEnabled)
+
 static bool js_spine_SkeletonCacheAnimation_setBatchEnabled(se::State& s)
 {
     spine::SkeletonCacheAnimation* cobj = SE_THIS_OBJECT<spine::SkeletonCacheAnimation>(s);
@@ -15214,6 +15312,25 @@ static bool js_spine_SkeletonCacheAnimation_setBatchEnabled(se::State& s)
 }
 SE_BIND_FUNC(js_spine_SkeletonCacheAnimation_setBatchEnabled)
 
+static bool js_spine_SkeletonCacheAnimation_setBatchKey(se::State& s)
+{
+    spine::SkeletonCacheAnimation* cobj = SE_THIS_OBJECT<spine::SkeletonCacheAnimation>(s);
+    SE_PRECONDITION2(cobj, false, "js_spine_SkeletonCacheAnimation_setBatchKey : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<unsigned int, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_spine_SkeletonCacheAnimation_setBatchKey : Error processing arguments");
+        cobj->setBatchKey(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_spine_SkeletonCacheAnimation_setBatchKey)
+
 static bool js_spine_SkeletonCacheAnimation_setBonesToSetupPose(se::State& s)
 {
     spine::SkeletonCacheAnimation* cobj = SE_THIS_OBJECT<spine::SkeletonCacheAnimation>(s);
@@ -15620,6 +15737,7 @@ bool js_register_spine_SkeletonCacheAnimation(se::Object* obj)
     auto cls = se::Class::create("SkeletonCacheAnimation", obj, nullptr, _SE(js_spine_SkeletonCacheAnimation_constructor));
 
     cls->defineFunction("addAnimation", _SE(js_spine_SkeletonCacheAnimation_addAnimation));
+    cls->defineFunction("bakeAnimationCache", _SE(js_spine_SkeletonCacheAnimation_bakeAnimationCache));
     cls->defineFunction("beginSchedule", _SE(js_spine_SkeletonCacheAnimation_beginSchedule));
     cls->defineFunction("findAnimation", _SE(js_spine_SkeletonCacheAnimation_findAnimation));
     cls->defineFunction("findBone", _SE(js_spine_SkeletonCacheAnimation_findBone));
@@ -15636,7 +15754,9 @@ bool js_register_spine_SkeletonCacheAnimation(se::Object* obj)
     cls->defineFunction("setAnimation", _SE(js_spine_SkeletonCacheAnimation_setAnimation));
     cls->defineFunction("setAttachEnabled", _SE(js_spine_SkeletonCacheAnimation_setAttachEnabled));
     cls->defineFunction("setAttachment", _SE(js_spine_SkeletonCacheAnimation_setAttachment));
+    cls->defineFunction("setBackgroundBakeEnabled", _SE(js_spine_SkeletonCacheAnimation_setBackgroundBakeEnabled));
     cls->defineFunction("setBatchEnabled", _SE(js_spine_SkeletonCacheAnimation_setBatchEnabled));
+    cls->defineFunction("setBatchKey", _SE(js_spine_SkeletonCacheAnimation_setBatchKey));
     cls->defineFunction("setBonesToSetupPose", _SE(js_spine_SkeletonCacheAnimation_setBonesToSetupPose));
     cls->defineFunction("setColor", _SE(js_spine_SkeletonCacheAnimation_setColor));
     cls->defineFunction("setCompleteListener", _SE(js_spine_SkeletonCacheAnimation_setCompleteListener));
@@ -15687,6 +15807,60 @@ static bool js_spine_SkeletonCacheMgr_buildSkeletonCache(se::State& s)
 }
 SE_BIND_FUNC(js_spine_SkeletonCacheMgr_buildSkeletonCache)
 
+static bool js_spine_SkeletonCacheMgr_getFrameRate(se::State& s)
+{
+    spine::SkeletonCacheMgr* cobj = SE_THIS_OBJECT<spine::SkeletonCacheMgr>(s);
+    SE_PRECONDITION2(cobj, false, "js_spine_SkeletonCacheMgr_getFrameRate : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        float result = cobj->getFrameRate();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_spine_SkeletonCacheMgr_getFrameRate : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_spine_SkeletonCacheMgr_getFrameRate)
+
+static bool js_spine_SkeletonCacheMgr_getMemoryBudget(se::State& s)
+{
+    spine::SkeletonCacheMgr* cobj = SE_THIS_OBJECT<spine::SkeletonCacheMgr>(s);
+    SE_PRECONDITION2(cobj, false, "js_spine_SkeletonCacheMgr_getMemoryBudget : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        size_t result = cobj->getMemoryBudget();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_spine_SkeletonCacheMgr_getMemoryBudget : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_spine_SkeletonCacheMgr_getMemoryBudget)
+
+static bool js_spine_SkeletonCacheMgr_getMemoryUsage(se::State& s)
+{
+    spine::SkeletonCacheMgr* cobj = SE_THIS_OBJECT<spine::SkeletonCacheMgr>(s);
+    SE_PRECONDITION2(cobj, false, "js_spine_SkeletonCacheMgr_getMemoryUsage : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        size_t result = cobj->getMemoryUsage();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_spine_SkeletonCacheMgr_getMemoryUsage : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_spine_SkeletonCacheMgr_getMemoryUsage)
+
 static bool js_spine_SkeletonCacheMgr_removeSkeletonCache(se::State& s)
 {
     spine::SkeletonCacheMgr* cobj = SE_THIS_OBJECT<spine::SkeletonCacheMgr>(s);
@@ -15706,6 +15880,44 @@ static bool js_spine_SkeletonCacheMgr_removeSkeletonCache(se::State& s)
 }
 SE_BIND_FUNC(js_spine_SkeletonCacheMgr_removeSkeletonCache)
 
+static bool js_spine_SkeletonCacheMgr_setFrameRate(se::State& s)
+{
+    spine::SkeletonCacheMgr* cobj = SE_THIS_OBJECT<spine::SkeletonCacheMgr>(s);
+    SE_PRECONDITION2(cobj, false, "js_spine_SkeletonCacheMgr_setFrameRate : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<float, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_spine_SkeletonCacheMgr_setFrameRate : Error processing arguments");
+        cobj->setFrameRate(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_spine_SkeletonCacheMgr_setFrameRate)
+
+static bool js_spine_SkeletonCacheMgr_setMemoryBudget(se::State& s)
+{
+    spine::SkeletonCacheMgr* cobj = SE_THIS_OBJECT<spine::SkeletonCacheMgr>(s);
+    SE_PRECONDITION2(cobj, false, "js_spine_SkeletonCacheMgr_setMemoryBudget : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<size_t, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_spine_SkeletonCacheMgr_setMemoryBudget : Error processing arguments");
+        cobj->setMemoryBudget(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_spine_SkeletonCacheMgr_setMemoryBudget)
+
 static bool js_spine_SkeletonCacheMgr_destroyInstance(se::State& s)
 {
     const auto& args = s.args();
@@ -15755,7 +15967,12 @@ bool js_register_spine_SkeletonCacheMgr(se::Object* obj)
     auto cls = se::Class::create("SkeletonCacheMgr", obj, nullptr, nullptr);
 
     cls->defineFunction("buildSkeletonCache", _SE(js_spine_SkeletonCacheMgr_buildSkeletonCache));
+    cls->defineFunction("getFrameRate", _SE(js_spine_SkeletonCacheMgr_getFrameRate));
+    cls->defineFunction("getMemoryBudget", _SE(js_spine_SkeletonCacheMgr_getMemoryBudget));
+    cls->defineFunction("getMemoryUsage", _SE(js_spine_SkeletonCacheMgr_getMemoryUsage));
     cls->defineFunction("removeSkeletonCache", _SE(js_spine_SkeletonCacheMgr_removeSkeletonCache));
+    cls->defineFunction("setFrameRate", _SE(js_spine_SkeletonCacheMgr_setFrameRate));
+    cls->defineFunction("setMemoryBudget", _SE(js_spine_SkeletonCacheMgr_setMemoryBudget));
     cls->defineStaticFunction("destroyInstance", _SE(js_spine_SkeletonCacheMgr_destroyInstance));
     cls->defineStaticFunction("getInstance", _SE(js_spine_SkeletonCacheMgr_getInstance));
     cls->defineFinalizeFunction(_SE(js_spine_SkeletonCacheMgr_finalize));
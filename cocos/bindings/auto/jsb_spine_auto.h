@@ -1031,6 +1031,7 @@ SE_DECLARE_FUNC(js_spine_SkeletonRenderer_render);
 SE_DECLARE_FUNC(js_spine_SkeletonRenderer_setAttachEnabled);
 SE_DECLARE_FUNC(js_spine_SkeletonRenderer_setAttachment);
 SE_DECLARE_FUNC(js_spine_SkeletonRenderer_setBatchEnabled);
+SE_DECLARE_FUNC(js_spine_SkeletonRenderer_setBatchKey);
 SE_DECLARE_FUNC(js_spine_SkeletonRenderer_setBonesToSetupPose);
 SE_DECLARE_FUNC(js_spine_SkeletonRenderer_setColor);
 SE_DECLARE_FUNC(js_spine_SkeletonRenderer_setDebugBonesEnabled);
@@ -1066,6 +1067,7 @@ SE_DECLARE_FUNC(js_spine_SkeletonAnimation_getState);
 SE_DECLARE_FUNC(js_spine_SkeletonAnimation_setAnimation);
 SE_DECLARE_FUNC(js_spine_SkeletonAnimation_setAnimationStateData);
 SE_DECLARE_FUNC(js_spine_SkeletonAnimation_setCompleteListener);
+SE_DECLARE_FUNC(js_spine_SkeletonAnimation_setCulled);
 SE_DECLARE_FUNC(js_spine_SkeletonAnimation_setDisposeListener);
 SE_DECLARE_FUNC(js_spine_SkeletonAnimation_setEmptyAnimation);
 SE_DECLARE_FUNC(js_spine_SkeletonAnimation_setEmptyAnimations);
@@ -1080,6 +1082,7 @@ SE_DECLARE_FUNC(js_spine_SkeletonAnimation_setTrackEndListener);
 SE_DECLARE_FUNC(js_spine_SkeletonAnimation_setTrackEventListener);
 SE_DECLARE_FUNC(js_spine_SkeletonAnimation_setTrackInterruptListener);
 SE_DECLARE_FUNC(js_spine_SkeletonAnimation_setTrackStartListener);
+SE_DECLARE_FUNC(js_spine_SkeletonAnimation_setUpdateInterval);
 SE_DECLARE_FUNC(js_spine_SkeletonAnimation_createWithBinaryFile);
 SE_DECLARE_FUNC(js_spine_SkeletonAnimation_create);
 SE_DECLARE_FUNC(js_spine_SkeletonAnimation_createWithJsonFile);
@@ -1094,6 +1097,7 @@ bool register_all_spine(se::Object* obj);
 
 JSB_REGISTER_OBJECT_TYPE(spine::SkeletonCacheAnimation);
 SE_DECLARE_FUNC(js_spine_SkeletonCacheAnimation_addAnimation);
+SE_DECLARE_FUNC(js_spine_SkeletonCacheAnimation_bakeAnimationCache);
 SE_DECLARE_FUNC(js_spine_SkeletonCacheAnimation_beginSchedule);
 SE_DECLARE_FUNC(js_spine_SkeletonCacheAnimation_findAnimation);
 SE_DECLARE_FUNC(js_spine_SkeletonCacheAnimation_findBone);
@@ -1110,7 +1114,9 @@ SE_DECLARE_FUNC(js_spine_SkeletonCacheAnimation_paused);
 SE_DECLARE_FUNC(js_spine_SkeletonCacheAnimation_setAnimation);
 SE_DECLARE_FUNC(js_spine_SkeletonCacheAnimation_setAttachEnabled);
 SE_DECLARE_FUNC(js_spine_SkeletonCacheAnimation_setAttachment);
+SE_DECLARE_FUNC(js_spine_SkeletonCacheAnimation_setBackgroundBakeEnabled);
 SE_DECLARE_FUNC(js_spine_SkeletonCacheAnimation_setBatchEnabled);
+SE_DECLARE_FUNC(js_spine_SkeletonCacheAnimation_setBatchKey);
 SE_DECLARE_FUNC(js_spine_SkeletonCacheAnimation_setBonesToSetupPose);
 SE_DECLARE_FUNC(js_spine_SkeletonCacheAnimation_setColor);
 SE_DECLARE_FUNC(js_spine_SkeletonCacheAnimation_setCompleteListener);
@@ -1136,7 +1142,12 @@ bool register_all_spine(se::Object* obj);
 
 JSB_REGISTER_OBJECT_TYPE(spine::SkeletonCacheMgr);
 SE_DECLARE_FUNC(js_spine_SkeletonCacheMgr_buildSkeletonCache);
+SE_DECLARE_FUNC(js_spine_SkeletonCacheMgr_getFrameRate);
+SE_DECLARE_FUNC(js_spine_SkeletonCacheMgr_getMemoryBudget);
+SE_DECLARE_FUNC(js_spine_SkeletonCacheMgr_getMemoryUsage);
 SE_DECLARE_FUNC(js_spine_SkeletonCacheMgr_removeSkeletonCache);
+SE_DECLARE_FUNC(js_spine_SkeletonCacheMgr_setFrameRate);
+SE_DECLARE_FUNC(js_spine_SkeletonCacheMgr_setMemoryBudget);
 SE_DECLARE_FUNC(js_spine_SkeletonCacheMgr_destroyInstance);
 SE_DECLARE_FUNC(js_spine_SkeletonCacheMgr_getInstance);
 
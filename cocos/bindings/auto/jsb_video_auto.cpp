@@ -3,6 +3,7 @@
 #include "cocos/bindings/manual/jsb_conversions.h"
 #include "cocos/bindings/manual/jsb_global.h"
 #include "ui/videoplayer/VideoPlayer.h"
+#include "cocos/bindings/auto/jsb_gfx_auto.h"
 
 #ifndef JSB_ALLOC
 #define JSB_ALLOC(kls, ...) new (std::nothrow) kls(__VA_ARGS__)
@@ -96,6 +97,24 @@ static bool js_video_VideoPlayer_duration(se::State& s)
 }
 SE_BIND_FUNC(js_video_VideoPlayer_duration)
 
+static bool js_video_VideoPlayer_getFrameTexture(se::State& s)
+{
+    cc::VideoPlayer* cobj = SE_THIS_OBJECT<cc::VideoPlayer>(s);
+    SE_PRECONDITION2(cobj, false, "js_video_VideoPlayer_getFrameTexture : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        cc::gfx::Texture* result = cobj->getFrameTexture();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_video_VideoPlayer_getFrameTexture : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_video_VideoPlayer_getFrameTexture)
+
 static bool js_video_VideoPlayer_isKeepAspectRatioEnabled(se::State& s)
 {
     cc::VideoPlayer* cobj = SE_THIS_OBJECT<cc::VideoPlayer>(s);
@@ -114,6 +133,24 @@ static bool js_video_VideoPlayer_isKeepAspectRatioEnabled(se::State& s)
 }
 SE_BIND_FUNC(js_video_VideoPlayer_isKeepAspectRatioEnabled)
 
+static bool js_video_VideoPlayer_isRenderToTextureEnabled(se::State& s)
+{
+    cc::VideoPlayer* cobj = SE_THIS_OBJECT<cc::VideoPlayer>(s);
+    SE_PRECONDITION2(cobj, false, "js_video_VideoPlayer_isRenderToTextureEnabled : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isRenderToTextureEnabled();
+        ok &= nativevalue_to_se(result, s.rval(), nullptr /*ctx*/);
+        SE_PRECONDITION2(ok, false, "js_video_VideoPlayer_isRenderToTextureEnabled : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_video_VideoPlayer_isRenderToTextureEnabled)
+
 static bool js_video_VideoPlayer_onPlayEvent(se::State& s)
 {
     cc::VideoPlayer* cobj = SE_THIS_OBJECT<cc::VideoPlayer>(s);
@@ -245,6 +282,25 @@ static bool js_video_VideoPlayer_setKeepAspectRatioEnabled(se::State& s)
 }
 SE_BIND_FUNC(js_video_VideoPlayer_setKeepAspectRatioEnabled)
 
+static bool js_video_VideoPlayer_setRenderToTextureEnabled(se::State& s)
+{
+    cc::VideoPlayer* cobj = SE_THIS_OBJECT<cc::VideoPlayer>(s);
+    SE_PRECONDITION2(cobj, false, "js_video_VideoPlayer_setRenderToTextureEnabled : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        HolderType<bool, false> arg0 = {};
+        ok &= sevalue_to_native(args[0], &arg0, s.thisObject());
+        SE_PRECONDITION2(ok, false, "js_video_VideoPlayer_setRenderToTextureEnabled : Error processing arguments");
+        cobj->setRenderToTextureEnabled(arg0.value());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_video_VideoPlayer_setRenderToTextureEnabled)
+
 static bool js_video_VideoPlayer_setURL(se::State& s)
 {
     cc::VideoPlayer* cobj = SE_THIS_OBJECT<cc::VideoPlayer>(s);
@@ -338,7 +394,9 @@ bool js_register_video_VideoPlayer(se::Object* obj)
     cls->defineFunction("addEventListener", _SE(js_video_VideoPlayer_addEventListener));
     cls->defineFunction("currentTime", _SE(js_video_VideoPlayer_currentTime));
     cls->defineFunction("duration", _SE(js_video_VideoPlayer_duration));
+    cls->defineFunction("getFrameTexture", _SE(js_video_VideoPlayer_getFrameTexture));
     cls->defineFunction("isKeepAspectRatioEnabled", _SE(js_video_VideoPlayer_isKeepAspectRatioEnabled));
+    cls->defineFunction("isRenderToTextureEnabled", _SE(js_video_VideoPlayer_isRenderToTextureEnabled));
     cls->defineFunction("onPlayEvent", _SE(js_video_VideoPlayer_onPlayEvent));
     cls->defineFunction("pause", _SE(js_video_VideoPlayer_pause));
     cls->defineFunction("play", _SE(js_video_VideoPlayer_play));
@@ -346,6 +404,7 @@ bool js_register_video_VideoPlayer(se::Object* obj)
     cls->defineFunction("setFrame", _SE(js_video_VideoPlayer_setFrame));
     cls->defineFunction("setFullScreenEnabled", _SE(js_video_VideoPlayer_setFullScreenEnabled));
     cls->defineFunction("setKeepAspectRatioEnabled", _SE(js_video_VideoPlayer_setKeepAspectRatioEnabled));
+    cls->defineFunction("setRenderToTextureEnabled", _SE(js_video_VideoPlayer_setRenderToTextureEnabled));
     cls->defineFunction("setURL", _SE(js_video_VideoPlayer_setURL));
     cls->defineFunction("setVisible", _SE(js_video_VideoPlayer_setVisible));
     cls->defineFunction("stop", _SE(js_video_VideoPlayer_stop));
@@ -16,7 +16,9 @@ JSB_REGISTER_OBJECT_TYPE(cc::VideoPlayer);
 SE_DECLARE_FUNC(js_video_VideoPlayer_addEventListener);
 SE_DECLARE_FUNC(js_video_VideoPlayer_currentTime);
 SE_DECLARE_FUNC(js_video_VideoPlayer_duration);
+SE_DECLARE_FUNC(js_video_VideoPlayer_getFrameTexture);
 SE_DECLARE_FUNC(js_video_VideoPlayer_isKeepAspectRatioEnabled);
+SE_DECLARE_FUNC(js_video_VideoPlayer_isRenderToTextureEnabled);
 SE_DECLARE_FUNC(js_video_VideoPlayer_onPlayEvent);
 SE_DECLARE_FUNC(js_video_VideoPlayer_pause);
 SE_DECLARE_FUNC(js_video_VideoPlayer_play);
@@ -24,6 +26,7 @@ SE_DECLARE_FUNC(js_video_VideoPlayer_seekTo);
 SE_DECLARE_FUNC(js_video_VideoPlayer_setFrame);
 SE_DECLARE_FUNC(js_video_VideoPlayer_setFullScreenEnabled);
 SE_DECLARE_FUNC(js_video_VideoPlayer_setKeepAspectRatioEnabled);
+SE_DECLARE_FUNC(js_video_VideoPlayer_setRenderToTextureEnabled);
 SE_DECLARE_FUNC(js_video_VideoPlayer_setURL);
 SE_DECLARE_FUNC(js_video_VideoPlayer_setVisible);
 SE_DECLARE_FUNC(js_video_VideoPlayer_stop);
@@ -4,38 +4,53 @@
 
 namespace se {
 
-cc::map<PoolType, BufferAllocator *> BufferAllocator::_pools;
+BufferAllocator *BufferAllocator::_pools[POOL_TYPE_COUNT] = {nullptr};
+size_t BufferAllocator::_totalBytes = 0;
 
 BufferAllocator::BufferAllocator(PoolType type)
 : _type(type) {
-    BufferAllocator::_pools[_type] = this;
+    BufferAllocator::_pools[static_cast<uint>(_type)] = this;
 }
 
 BufferAllocator::~BufferAllocator() {
-    for (auto buffer : _buffers) {
-        buffer.second->decRef();
+    for (auto &buffer : _buffers) {
+        if (buffer.obj) {
+            buffer.obj->decRef();
+            _totalBytes -= buffer.size;
+        }
     }
     _buffers.clear();
-    BufferAllocator::_pools.erase(_type);
+    BufferAllocator::_pools[static_cast<uint>(_type)] = nullptr;
 }
 
 Object *BufferAllocator::alloc(uint index, uint bytes) {
-    if (_buffers.count(index)) {
-        Object *oldObj = _buffers[index];
-        oldObj->decRef();
+    if (index >= _buffers.size()) {
+        _buffers.resize(index + 1);
+    }
+
+    auto &buffer = _buffers[index];
+    if (buffer.obj) {
+        buffer.obj->decRef();
+        _totalBytes -= buffer.size;
     }
     Object *obj = Object::createArrayBufferObject(nullptr, bytes);
     obj->incRef();
-    _buffers[index] = obj;
+
+    size_t len = 0;
+    buffer.obj = obj;
+    obj->getArrayBufferData(&buffer.data, &len);
+    buffer.size = static_cast<uint>(len);
+    _totalBytes += buffer.size;
 
     return obj;
 }
 
 void BufferAllocator::free(uint index) {
-    if (_buffers.count(index)) {
-        Object *oldObj = _buffers[index];
-        oldObj->decRef();
-        _buffers.erase(index);
+    if (index < _buffers.size() && _buffers[index].obj) {
+        auto &buffer = _buffers[index];
+        buffer.obj->decRef();
+        _totalBytes -= buffer.size;
+        buffer = Buffer();
     }
 }
 
@@ -20,21 +20,19 @@ public:
     template <class T>
     static T *getBuffer(PoolType type, uint index, uint *size) {
         index &= _bufferMask;
-        if (BufferAllocator::_pools.count(type) != 0) {
-            const auto pool = BufferAllocator::_pools[type];
-            if (pool->_buffers.count(index) != 0) {
-                T *ret = nullptr; size_t len;
-                pool->_buffers[index]->getArrayBufferData((uint8_t **)&ret, &len);
-                *size = (uint)len;
-                return ret;
-            } else {
-                return nullptr;
-            }
+        const auto pool = BufferAllocator::_pools[static_cast<uint>(type)];
+        if (pool && index < pool->_buffers.size()) {
+            const auto &buffer = pool->_buffers[index];
+            *size = buffer.size;
+            return reinterpret_cast<T *>(buffer.data);
         } else {
             return nullptr;
         }
     }
 
+    // bytes of the array buffers of all allocators, the chunks of the buffer pools included
+    CC_INLINE static size_t getTotalBytes() { return _totalBytes; }
+
     BufferAllocator(PoolType type);
     ~BufferAllocator();
 
@@ -42,10 +40,18 @@ public:
     void free(uint index);
 
 private:
-    static cc::map<PoolType, BufferAllocator *> _pools;
+    // the backing store of an array buffer never moves, so its data pointer is cached at allocation
+    struct Buffer {
+        Object *obj = nullptr;
+        uint8_t *data = nullptr;
+        uint size = 0;
+    };
+
+    static BufferAllocator *_pools[POOL_TYPE_COUNT];
+    static size_t _totalBytes;
     static constexpr uint _bufferMask = ~(1 << 30);
 
-    cc::map<uint, Object *> _buffers;
+    cc::vector<Buffer> _buffers;
     PoolType _type = PoolType::UNKNOWN;
 };
 
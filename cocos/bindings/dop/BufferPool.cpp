@@ -26,34 +26,90 @@ THE SOFTWARE.
 #include "base/Macros.h"
 #include "base/memory/Memory.h"
 
+#include <cstring>
+
 using namespace se;
 
-cc::map<PoolType, BufferPool *> BufferPool::_poolMap;
+BufferPool *BufferPool::_pools[POOL_TYPE_COUNT] = {nullptr};
 
 BufferPool::BufferPool(PoolType type, uint entryBits, uint bytesPerEntry)
 : _allocator(type), _entryBits(entryBits), _bytesPerEntry(bytesPerEntry), _type(type) {
-    CCASSERT(BufferPool::_poolMap.count(type) == 0, "The type of pool is already exist");
+    CCASSERT(BufferPool::_pools[static_cast<uint>(type)] == nullptr, "The type of pool is already exist");
 
     _entriesPerChunk = 1 << entryBits;
     _entryMask = _entriesPerChunk - 1;
     _chunkMask = 0xffffffff & ~(_entryMask | _poolFlag);
 
     _bytesPerChunk = _bytesPerEntry * _entriesPerChunk;
+    _wordsPerChunk = (_entriesPerChunk + 31) >> 5;
 
-    BufferPool::_poolMap[type] = this;
+    BufferPool::_pools[static_cast<uint>(type)] = this;
 }
 
 BufferPool::~BufferPool() {
-    BufferPool::_poolMap.erase(_type);
+    BufferPool::_pools[static_cast<uint>(_type)] = nullptr;
+}
+
+void BufferPool::clearAllDirty() {
+    for (auto *pool : _pools) {
+        if (pool) pool->clearDirty();
+    }
 }
 
 Object *BufferPool::allocateNewChunk() {
-    Object *jsObj = _allocator.alloc((uint)_chunks.size(), _bytesPerChunk);
+    // array buffers come zeroed, a new chunk starts clean
+    Object *jsObj = _allocator.alloc((uint)_chunks.size(), _bytesPerChunk + (_wordsPerChunk + 1) * sizeof(uint32_t));
 
     uint8_t *realPtr = nullptr;
     size_t len = 0;
     jsObj->getArrayBufferData(&realPtr, &len);
     _chunks.push_back(realPtr);
+    _liveWords.resize(_chunks.size() * _wordsPerChunk, 0);
 
     return jsObj;
 }
+
+void BufferPool::free(uint id) {
+    const uint chunk = (_chunkMask & id) >> _entryBits;
+    const uint entry = _entryMask & id;
+    if (chunk >= _chunks.size()) return;
+
+    const uint32_t bit = 1u << (entry & 31);
+    getDirtyWords(chunk)[1 + (entry >> 5)] &= ~bit;
+    auto &live = _liveWords[chunk * _wordsPerChunk + (entry >> 5)];
+    if (live & bit) {
+        live &= ~bit;
+        _isLiveListDirty = true;
+    }
+}
+
+void BufferPool::clearDirty() {
+    syncLiveEntries();
+    for (uint chunk = 0; chunk < _chunks.size(); ++chunk) {
+        uint32_t *words = getDirtyWords(chunk);
+        if (!words[0]) continue;
+        memset(words, 0, (_wordsPerChunk + 1) * sizeof(uint32_t));
+    }
+}
+
+void BufferPool::syncLiveEntries() {
+    for (uint chunk = 0; chunk < _chunks.size(); ++chunk) {
+        const uint32_t *words = getDirtyWords(chunk);
+        if (!words[0]) continue;
+        uint32_t *live = &_liveWords[chunk * _wordsPerChunk];
+        for (uint i = 0; i < _wordsPerChunk; ++i) {
+            if (words[i + 1] & ~live[i]) {
+                live[i] |= words[i + 1];
+                _isLiveListDirty = true;
+            }
+        }
+    }
+    if (!_isLiveListDirty) return;
+
+    // freed entries drop out, the ids stay sorted so the entries are visited in memory order
+    _liveIDs.clear();
+    for (uint chunk = 0; chunk < _chunks.size(); ++chunk) {
+        forEachBit(&_liveWords[chunk * _wordsPerChunk], chunk, [this](uint id) { _liveIDs.push_back(id); });
+    }
+    _isLiveListDirty = false;
+}
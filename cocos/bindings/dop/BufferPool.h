@@ -32,14 +32,23 @@ THE SOFTWARE.
 #include "cocos/base/memory/StlAlloc.h"
 #include "cocos/bindings/jswrapper/Object.h"
 
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
 namespace se {
 
+// Each chunk ends with its dirty words, one bit an entry, which the script side sets as it writes the entry:
+//     dirty = new Uint32Array(chunk, bytesPerEntry << entryBits); dirty[0] = 1; dirty[1 + (entry >> 5)] |= 1 << (entry & 31);
+// word 0 flags the chunk so clean chunks are skipped whole. The bits are cleared once the frame is rendered, consumers
+// reading the pool in between can go through the entries written this frame only.
 class CC_DLL BufferPool final : public cc::Object {
 public:
     using Chunk = uint8_t *;
 
-    CC_INLINE static const cc::map<PoolType, BufferPool *> &getPoolMap() { return BufferPool::_poolMap; }
+    CC_INLINE static BufferPool *getPool(PoolType type) { return BufferPool::_pools[static_cast<uint>(type)]; }
     CC_INLINE static const uint getPoolFlag() { return _poolFlag; }
+    static void clearAllDirty();
 
     BufferPool(PoolType type, uint entryBits, uint bytesPerEntry);
     ~BufferPool();
@@ -54,8 +63,66 @@ public:
 
     Object *allocateNewChunk();
 
+    CC_INLINE bool isDirty(uint id) const {
+        const uint chunk = (_chunkMask & id) >> _entryBits;
+        const uint entry = _entryMask & id;
+        return chunk < _chunks.size() && (getDirtyWords(chunk)[1 + (entry >> 5)] & (1u << (entry & 31)));
+    }
+
+    CC_INLINE bool hasDirty() const {
+        for (uint chunk = 0; chunk < _chunks.size(); ++chunk) {
+            if (getDirtyWords(chunk)[0]) return true;
+        }
+        return false;
+    }
+
+    // fn(id) for the entries written since the last clearDirty(), in the order of their ids
+    template <class Fn>
+    void forEachDirty(Fn &&fn) const {
+        for (uint chunk = 0; chunk < _chunks.size(); ++chunk) {
+            const uint32_t *words = getDirtyWords(chunk);
+            if (!words[0]) continue;
+            forEachBit(words + 1, chunk, fn);
+        }
+    }
+
+    // fn(id) for the entries written since they were allocated, walking a dense id list rather than the chunks
+    template <class Fn>
+    void forEachEntry(Fn &&fn) {
+        syncLiveEntries();
+        for (const uint id : _liveIDs) fn(id);
+    }
+
+    // the script side released the entry, it leaves the dirty and live sets until it is written again
+    void free(uint id);
+    void clearDirty();
+
 private:
-    static cc::map<PoolType, BufferPool *> _poolMap;
+    CC_INLINE uint32_t *getDirtyWords(uint chunk) const { return reinterpret_cast<uint32_t *>(_chunks[chunk] + _bytesPerChunk); }
+
+    template <class Fn>
+    void forEachBit(const uint32_t *words, uint chunk, Fn &&fn) const {
+        for (uint i = 0; i < _wordsPerChunk; ++i) {
+            for (uint32_t bits = words[i]; bits; bits &= bits - 1) {
+                fn((chunk << _entryBits) | (i << 5) | countTrailingZeros(bits));
+            }
+        }
+    }
+
+    static CC_INLINE uint countTrailingZeros(uint32_t bits) {
+#if defined(_MSC_VER)
+        unsigned long index = 0;
+        _BitScanForward(&index, bits);
+        return static_cast<uint>(index);
+#else
+        return static_cast<uint>(__builtin_ctz(bits));
+#endif
+    }
+
+    // folds the dirty bits into the live ones and rebuilds the id list when the set changed
+    void syncLiveEntries();
+
+    static BufferPool *_pools[POOL_TYPE_COUNT];
     static constexpr uint _poolFlag = 1 << 30;
 
     BufferAllocator _allocator;
@@ -66,7 +133,12 @@ private:
     uint _bytesPerChunk = 0;
     uint _entriesPerChunk = 0;
     uint _bytesPerEntry = 0;
+    uint _wordsPerChunk = 0; // entry words of the dirty bits, after the chunk flag
     PoolType _type = PoolType::UNKNOWN;
+
+    cc::vector<uint32_t> _liveWords; // _wordsPerChunk a chunk, no chunk flag
+    cc::vector<uint> _liveIDs;
+    bool _isLiveListDirty = false;
 };
 
 } // namespace se
@@ -26,19 +26,57 @@ THE SOFTWARE.
 
 using namespace se;
 
-cc::map<PoolType, ObjectPool *> ObjectPool::_poolMap;
+ObjectPool *ObjectPool::_pools[POOL_TYPE_COUNT] = {nullptr};
+bool ObjectPool::_isScriptLocked = false;
 
 ObjectPool::ObjectPool(PoolType type, Object *jsArr)
 : _type(type), _jsArr(jsArr) {
     CCASSERT(jsArr->isArray(), "ObjectPool: It must be initialized with a JavaScript array");
-    CCASSERT(ObjectPool::_poolMap.count(type) == 0, "This type of ObjectPool already exists.");
+    CCASSERT(ObjectPool::_pools[static_cast<uint>(type)] == nullptr, "This type of ObjectPool already exists.");
 
     _jsArr->incRef();
     _indexMask = 0xffffffff & ~_poolFlag;
-    ObjectPool::_poolMap.emplace(type, this);
+    ObjectPool::_pools[static_cast<uint>(type)] = this;
 }
 
 ObjectPool::~ObjectPool() {
     _jsArr->decRef();
-    ObjectPool::_poolMap.erase(_type);
+    ObjectPool::_pools[static_cast<uint>(_type)] = nullptr;
+}
+
+void ObjectPool::bind(uint id, Object *jsObj) {
+    id = _indexMask & id;
+    if (id >= _nativeObjects.size()) {
+        _nativeObjects.resize(id + 1, nullptr);
+    }
+    _nativeObjects[id] = jsObj ? jsObj->getPrivateData() : nullptr;
+}
+
+void ObjectPool::unbind(uint id) {
+    id = _indexMask & id;
+    if (id < _nativeObjects.size()) {
+        _nativeObjects[id] = nullptr;
+    }
+}
+
+bool ObjectPool::resolve(uint id) {
+    id = _indexMask & id;
+    if (id < _nativeObjects.size() && _nativeObjects[id]) return true;
+    if (id < _resolvedObjects.size() && _resolvedObjects[id]) return true;
+
+    se::Value jsEntry;
+    if (!_jsArr->getArrayElement(id, &jsEntry) || !jsEntry.isObject()) return false;
+    void *entry = jsEntry.toObject()->getPrivateData();
+    if (!entry) return false;
+    if (id >= _resolvedObjects.size()) {
+        _resolvedObjects.resize(id + 1, nullptr);
+    }
+    _resolvedObjects[id] = entry;
+    return true;
+}
+
+void ObjectPool::clearResolved() {
+    for (auto *pool : _pools) {
+        if (pool) pool->_resolvedObjects.clear();
+    }
 }
@@ -35,14 +35,38 @@ namespace se {
 
 class CC_DLL ObjectPool final : public cc::Object {
 public:
-    CC_INLINE static const cc::map<PoolType, ObjectPool *> &getPoolMap() { return ObjectPool::_poolMap; }
+    CC_INLINE static ObjectPool *getPool(PoolType type) { return ObjectPool::_pools[static_cast<uint>(type)]; }
     
     ObjectPool(PoolType type, Object *jsArr);
     ~ObjectPool();
 
+    // Mirrors the native object of a script pool entry, the script side calls this
+    // whenever it writes an entry so lookups can skip the script engine.
+    void bind(uint id, Object *jsObj);
+    void unbind(uint id);
+
+    // For threads that can't enter the script engine: while locked, lookups only see the entries bound and
+    // those resolved beforehand on the script thread, the others return nullptr. The script side writes no
+    // entry meanwhile.
+    CC_INLINE static void setScriptLocked(bool locked) { _isScriptLocked = locked; }
+    // Keeps the native object of an entry that isn't bound for the lookups while locked, one script call per
+    // entry until clearResolved(). Returns false if the entry holds no object.
+    bool resolve(uint id);
+    // The script side may have written the entries since, they are resolved again.
+    static void clearResolved();
+
     template <class Type>
     Type *getTypedObject(uint id) const {
         id = _indexMask & id;
+        if (id < _nativeObjects.size() && _nativeObjects[id]) {
+            return static_cast<Type *>(_nativeObjects[id]);
+        }
+        if (_isScriptLocked) {
+            CCASSERT(id < _resolvedObjects.size() && _resolvedObjects[id], "ObjectPool: The entry was not resolved before locking");
+            return id < _resolvedObjects.size() ? static_cast<Type *>(_resolvedObjects[id]) : nullptr;
+        }
+
+        // fall back to the script array for entries that were never bound
         bool ok = true;
 #ifdef CC_DEBUG
         uint len = 0;
@@ -60,10 +84,13 @@ public:
     }
 
 private:
-    static cc::map<PoolType, ObjectPool *> _poolMap;
+    static ObjectPool *_pools[POOL_TYPE_COUNT];
+    static bool _isScriptLocked;
     
     PoolType _type = PoolType::SHADER;
     Object *_jsArr = nullptr;
+    cc::vector<void *> _nativeObjects;
+    cc::vector<void *> _resolvedObjects;
     uint _poolFlag = 1 << 29;
     uint _indexMask = 0;
 };
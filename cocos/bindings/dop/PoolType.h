@@ -35,6 +35,8 @@ enum class PoolType {
     BLEND_TARGET,
     BLEND_STATE,
     UI_BATCH,
+    SKINNING,
+    MORPH,
 
     // array
     SUB_MODEL_ARRAY = 200,
@@ -45,9 +47,16 @@ enum class PoolType {
     LIGHT_ARRAY,
     BLEND_TARGET_ARRAY,
     UI_BATCH_ARRAY,
+    NODE_ARRAY,
 
     // raw buffer
     RAW_BUFFER = 300,
+    TRANSFORM,  // streams of the native TransformSystem
+    NAVIGATION, // streams of the native NavigationSystem
+    TWEEN,      // streams of the native TweenSystem
     UNKNOWN
 };
+
+// Pools are registered in flat arrays indexed by their type.
+constexpr unsigned int POOL_TYPE_COUNT = static_cast<unsigned int>(PoolType::UNKNOWN) + 1;
 }
@@ -23,19 +23,118 @@
  ****************************************************************************/
 #include "EventDispatcher.h"
 
+#include <algorithm>
+
 #include "cocos/bindings/jswrapper/SeApi.h"
 #include "cocos/bindings/manual/jsb_global.h"
 #include "cocos/bindings/event/CustomEventTypes.h"
+#include "cocos/base/Profiler.h"
 
 namespace {
+// a queue holding more events than this is delivered without waiting for the tick
+const size_t MAX_QUEUED_TOUCH_EVENTS = 256;
+
+struct QueuedTouchEvent {
+    cc::TouchEvent::Type type;
+    uint32_t firstTouch;
+    uint32_t touchCount;
+};
+
+// the touches of all queued events are stored back to back, both vectors keep their capacity between frames
+struct TouchEventQueue {
+    std::vector<QueuedTouchEvent> events;
+    std::vector<cc::TouchInfo> touches;
+
+    void clear() {
+        events.clear();
+        touches.clear();
+    }
+};
+
 se::Value _tickVal;
+TouchEventQueue _touchEventQueue;
+TouchEventQueue _dispatchingTouchEvents;
 std::vector<se::Object *> _jsTouchObjPool;
 se::Object *_jsTouchObjArray = nullptr;
+std::vector<se::Object *> _jsTouchEventObjPool;
+se::Object *_jsTouchEventObjArray = nullptr;
 se::Object *_jsMouseEventObj = nullptr;
 se::Object *_jsKeyboardEventObj = nullptr;
 se::Object *_jsResizeEventObj = nullptr;
 se::Object* _jsOrientationEventObj = nullptr;
 bool _inited = false;
+
+const char *getTouchEventType(cc::TouchEvent::Type type) {
+    switch (type) {
+        case cc::TouchEvent::Type::BEGAN:
+            return "touchstart";
+        case cc::TouchEvent::Type::MOVED:
+            return "touchmove";
+        case cc::TouchEvent::Type::ENDED:
+            return "touchend";
+        case cc::TouchEvent::Type::CANCELLED:
+            return "touchcancel";
+        default:
+            assert(false);
+            return nullptr;
+    }
+}
+
+const char *getTouchEventFunctionName(cc::TouchEvent::Type type) {
+    switch (type) {
+        case cc::TouchEvent::Type::BEGAN:
+            return "onTouchStart";
+        case cc::TouchEvent::Type::MOVED:
+            return "onTouchMove";
+        case cc::TouchEvent::Type::ENDED:
+            return "onTouchEnd";
+        case cc::TouchEvent::Type::CANCELLED:
+            return "onTouchCancel";
+        default:
+            assert(false);
+            return nullptr;
+    }
+}
+
+void unrootObjects(std::vector<se::Object *> &objects) {
+    for (auto *obj : objects) {
+        obj->unroot();
+        obj->decRef();
+    }
+    objects.clear();
+}
+
+// Fills the array with touch objects of the pool, starting at poolIndex which is advanced past them.
+void fillTouchArray(se::Object *array, const cc::TouchInfo *touches, uint32_t touchCount, size_t &poolIndex) {
+    while (_jsTouchObjPool.size() < poolIndex + touchCount) {
+        se::Object *touchObj = se::Object::createPlainObject();
+        touchObj->root();
+        _jsTouchObjPool.push_back(touchObj);
+    }
+
+    array->setProperty("length", se::Value(touchCount));
+    for (uint32_t i = 0; i < touchCount; ++i) {
+        const auto &touch = touches[i];
+        se::Object *jsTouch = _jsTouchObjPool[poolIndex++];
+        jsTouch->setProperty("identifier", se::Value(touch.index));
+        jsTouch->setProperty("clientX", se::Value(touch.x));
+        jsTouch->setProperty("clientY", se::Value(touch.y));
+        jsTouch->setProperty("pageX", se::Value(touch.x));
+        jsTouch->setProperty("pageY", se::Value(touch.y));
+        array->setArrayElement(i, se::Value(jsTouch));
+    }
+}
+
+se::Object *getTouchEventObj(size_t index) {
+    while (_jsTouchEventObjPool.size() <= index) {
+        se::Object *eventObj = se::Object::createPlainObject();
+        se::HandleObject touches(se::Object::createArrayObject(0));
+        eventObj->setProperty("touches", se::Value(touches));
+        eventObj->root();
+        _jsTouchEventObjPool.push_back(eventObj);
+    }
+    return _jsTouchEventObjPool[index];
+}
 } // namespace
 
 namespace cc {
@@ -49,11 +148,10 @@ void EventDispatcher::init() {
 }
 
 void EventDispatcher::destroy() {
-    for (auto touchObj : _jsTouchObjPool) {
-        touchObj->unroot();
-        touchObj->decRef();
-    }
-    _jsTouchObjPool.clear();
+    _touchEventQueue.clear();
+    _dispatchingTouchEvents.clear();
+    unrootObjects(_jsTouchObjPool);
+    unrootObjects(_jsTouchEventObjPool);
 
     if (_jsTouchObjArray != nullptr) {
         _jsTouchObjArray->unroot();
@@ -61,6 +159,12 @@ void EventDispatcher::destroy() {
         _jsTouchObjArray = nullptr;
     }
 
+    if (_jsTouchEventObjArray != nullptr) {
+        _jsTouchEventObjArray->unroot();
+        _jsTouchEventObjArray->decRef();
+        _jsTouchEventObjArray = nullptr;
+    }
+
     if (_jsMouseEventObj != nullptr) {
         _jsMouseEventObj->unroot();
         _jsMouseEventObj->decRef();
@@ -83,56 +187,92 @@ void EventDispatcher::destroy() {
 }
 
 void EventDispatcher::dispatchTouchEvent(const struct TouchEvent &touchEvent) {
-    se::AutoHandleScope scope;
-    if (!_jsTouchObjArray) {
-        _jsTouchObjArray = se::Object::createArrayObject(0);
-        _jsTouchObjArray->root();
+    auto &events = _touchEventQueue.events;
+    auto &touches = _touchEventQueue.touches;
+
+    if (touchEvent.type == TouchEvent::Type::MOVED && !events.empty() && events.back().type == TouchEvent::Type::MOVED) {
+        // the last event owns the tail of the touches, so new touch ids can simply be appended to it
+        auto &last = events.back();
+        for (const auto &touch : touchEvent.touches) {
+            auto begin = touches.begin() + last.firstTouch;
+            auto iter = std::find_if(begin, touches.end(), [&](const TouchInfo &queued) { return queued.index == touch.index; });
+            if (iter != touches.end()) {
+                *iter = touch;
+            } else {
+                touches.push_back(touch);
+                ++last.touchCount;
+            }
+        }
+        return;
     }
 
-    _jsTouchObjArray->setProperty("length", se::Value(touchEvent.touches.size()));
+    events.push_back({touchEvent.type, static_cast<uint32_t>(touches.size()), static_cast<uint32_t>(touchEvent.touches.size())});
+    touches.insert(touches.end(), touchEvent.touches.begin(), touchEvent.touches.end());
 
-    while (_jsTouchObjPool.size() < touchEvent.touches.size()) {
-        se::Object *touchObj = se::Object::createPlainObject();
-        touchObj->root();
-        _jsTouchObjPool.push_back(touchObj);
+    if (events.size() >= MAX_QUEUED_TOUCH_EVENTS) {
+        flushTouchEvents();
     }
+}
 
-    uint32_t touchIndex = 0;
-    int poolIndex = 0;
-    for (const auto &touch : touchEvent.touches) {
-        se::Object *jsTouch = _jsTouchObjPool.at(poolIndex++);
-        jsTouch->setProperty("identifier", se::Value(touch.index));
-        jsTouch->setProperty("clientX", se::Value(touch.x));
-        jsTouch->setProperty("clientY", se::Value(touch.y));
-        jsTouch->setProperty("pageX", se::Value(touch.x));
-        jsTouch->setProperty("pageY", se::Value(touch.y));
+void EventDispatcher::flushTouchEvents() {
+    if (_touchEventQueue.events.empty())
+        return;
 
-        _jsTouchObjArray->setArrayElement(touchIndex, se::Value(jsTouch));
-        ++touchIndex;
-    }
+    // handlers may queue further events, those wait for the next flush
+    std::swap(_touchEventQueue, _dispatchingTouchEvents);
+    _touchEventQueue.clear();
 
-    const char *eventName = nullptr;
-    switch (touchEvent.type) {
-        case TouchEvent::Type::BEGAN:
-            eventName = "onTouchStart";
-            break;
-        case TouchEvent::Type::MOVED:
-            eventName = "onTouchMove";
-            break;
-        case TouchEvent::Type::ENDED:
-            eventName = "onTouchEnd";
-            break;
-        case TouchEvent::Type::CANCELLED:
-            eventName = "onTouchCancel";
-            break;
-        default:
-            assert(false);
-            break;
+    if (!se::ScriptEngine::getInstance()->isValid()) {
+        _dispatchingTouchEvents.clear();
+        return;
     }
 
-    se::ValueArray args;
-    args.push_back(se::Value(_jsTouchObjArray));
-    EventDispatcher::doDispatchEvent(nullptr, eventName, args);
+    se::AutoHandleScope scope;
+    assert(_inited);
+
+    const auto &events = _dispatchingTouchEvents.events;
+    const TouchInfo *touches = _dispatchingTouchEvents.touches.data();
+    size_t poolIndex = 0;
+
+    se::Value func;
+    __jsbObj->getProperty("onTouchEvents", &func);
+    if (func.isObject() && func.toObject()->isFunction()) {
+        if (!_jsTouchEventObjArray) {
+            _jsTouchEventObjArray = se::Object::createArrayObject(0);
+            _jsTouchEventObjArray->root();
+        }
+
+        _jsTouchEventObjArray->setProperty("length", se::Value(static_cast<uint32_t>(events.size())));
+        se::Value touchesVal;
+        for (size_t i = 0; i < events.size(); ++i) {
+            const auto &event = events[i];
+            se::Object *eventObj = getTouchEventObj(i);
+            eventObj->setProperty("type", se::Value(getTouchEventType(event.type)));
+            eventObj->getProperty("touches", &touchesVal);
+            fillTouchArray(touchesVal.toObject(), touches + event.firstTouch, event.touchCount, poolIndex);
+            _jsTouchEventObjArray->setArrayElement(static_cast<uint32_t>(i), se::Value(eventObj));
+        }
+
+        se::PooledValueArray args(1);
+        args.get().push_back(se::Value(_jsTouchEventObjArray));
+        func.toObject()->call(args.get(), nullptr);
+    } else {
+        if (!_jsTouchObjArray) {
+            _jsTouchObjArray = se::Object::createArrayObject(0);
+            _jsTouchObjArray->root();
+        }
+
+        for (const auto &event : events) {
+            // each handler gets the array on its own, so the touch objects can be reused
+            poolIndex = 0;
+            fillTouchArray(_jsTouchObjArray, touches + event.firstTouch, event.touchCount, poolIndex);
+
+            se::PooledValueArray args(1);
+            args.get().push_back(se::Value(_jsTouchObjArray));
+            EventDispatcher::doDispatchEvent(nullptr, getTouchEventFunctionName(event.type), args.get());
+        }
+    }
+    _dispatchingTouchEvents.clear();
 }
 
 void EventDispatcher::dispatchMouseEvent(const struct MouseEvent &mouseEvent) {
@@ -181,9 +321,9 @@ void EventDispatcher::dispatchMouseEvent(const struct MouseEvent &mouseEvent) {
             break;
     }
 
-    se::ValueArray args;
-    args.push_back(se::Value(_jsMouseEventObj));
-    EventDispatcher::doDispatchEvent(eventName, jsFunctionName, args);
+    se::PooledValueArray args(1);
+    args.get().push_back(se::Value(_jsMouseEventObj));
+    EventDispatcher::doDispatchEvent(eventName, jsFunctionName, args.get());
 }
 
 void EventDispatcher::dispatchKeyboardEvent(const struct KeyboardEvent &keyboardEvent) {
@@ -213,15 +353,18 @@ void EventDispatcher::dispatchKeyboardEvent(const struct KeyboardEvent &keyboard
     _jsKeyboardEventObj->setProperty("shiftKey", se::Value(keyboardEvent.shiftKeyActive));
     _jsKeyboardEventObj->setProperty("repeat", se::Value(keyboardEvent.action == KeyboardEvent::Action::REPEAT));
     _jsKeyboardEventObj->setProperty("keyCode", se::Value(keyboardEvent.key));
-    se::ValueArray args;
-    args.push_back(se::Value(_jsKeyboardEventObj));
-    EventDispatcher::doDispatchEvent(nullptr, eventName, args);
+    se::PooledValueArray args(1);
+    args.get().push_back(se::Value(_jsKeyboardEventObj));
+    EventDispatcher::doDispatchEvent(nullptr, eventName, args.get());
 }
 
 void EventDispatcher::dispatchTickEvent(float dt) {
+    CC_PROFILE_ZONE("gameTick");
     if (!se::ScriptEngine::getInstance()->isValid())
         return;
 
+    flushTouchEvents();
+
     se::AutoHandleScope scope;
     if (_tickVal.isUndefined()) {
         se::ScriptEngine::getInstance()->getGlobalObject()->getProperty("gameTick", &_tickVal);
@@ -230,11 +373,17 @@ void EventDispatcher::dispatchTickEvent(float dt) {
     static std::chrono::steady_clock::time_point prevTime;
     prevTime = std::chrono::steady_clock::now();
 
-    se::ValueArray args;
+    se::PooledValueArray args(1);
     long long milliSeconds = std::chrono::duration_cast<std::chrono::milliseconds>(prevTime - se::ScriptEngine::getInstance()->getStartTime()).count();
-    args.push_back(se::Value((double)milliSeconds));
+    args.get().push_back(se::Value((double)milliSeconds));
+
+    _tickVal.toObject()->call(args.get(), nullptr);
+}
 
-    _tickVal.toObject()->call(args, nullptr);
+void EventDispatcher::dispatchIdleEvent(double idleTimeInSeconds) {
+#if SCRIPT_ENGINE_TYPE == SCRIPT_ENGINE_V8
+    se::ScriptEngine::getInstance()->performIdleTasks(idleTimeInSeconds);
+#endif
 }
 
 void EventDispatcher::dispatchResizeEvent(int width, int height) {
@@ -168,10 +168,17 @@ public:
     static void init();
     static void destroy();
 
+    // Touch events are queued and handed to the script once per frame, before the tick. Moves following a move
+    // are folded into it, so that only the latest position of each touch is delivered.
     static void dispatchTouchEvent(const struct TouchEvent &touchEvent);
+    // Delivers the queued touch events now. If `jsb.onTouchEvents` is defined all of them go to it in one call,
+    // as an array of {type, touches}, otherwise each goes to its own handler as before.
+    static void flushTouchEvents();
     static void dispatchMouseEvent(const struct MouseEvent &mouseEvent);
     static void dispatchKeyboardEvent(const struct KeyboardEvent &keyboardEvent);
     static void dispatchTickEvent(float dt);
+    // Hands the time left in the frame after the tick to the script engine.
+    static void dispatchIdleEvent(double idleTimeInSeconds);
     static void dispatchResizeEvent(int width, int height);
     static void dispatchOrientationChangeEvent(int orientation);
     static void dispatchEnterBackgroundEvent();
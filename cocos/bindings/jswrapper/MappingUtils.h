@@ -24,17 +24,158 @@
  ****************************************************************************/
 #pragma once
 
-#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
 
 namespace se {
 
     class Object;
 
+    // Open addressing table keyed by native pointers, probing linearly from a Fibonacci hash of the pointer.
+    // Erased entries leave a tombstone until the table is rebuilt by an insertion, so erasing never moves
+    // other entries and iterators stay valid while the table is erased from during a traversal.
+    template <typename T>
+    class PointerMap
+    {
+    public:
+        using value_type = std::pair<void*, T>;
+
+        class iterator
+        {
+        public:
+            iterator() = default;
+            iterator(value_type* slot, value_type* end) : _slot(slot), _end(end) { skipFreeSlots(); }
+
+            value_type& operator*() const { return *_slot; }
+            value_type* operator->() const { return _slot; }
+            iterator& operator++() { ++_slot; skipFreeSlots(); return *this; }
+            bool operator==(const iterator& other) const { return _slot == other._slot; }
+            bool operator!=(const iterator& other) const { return _slot != other._slot; }
+
+        private:
+            void skipFreeSlots() { while (_slot != _end && isFree(_slot->first)) ++_slot; }
+
+            value_type* _slot = nullptr;
+            value_type* _end = nullptr;
+        };
+        using const_iterator = iterator;
+
+        PointerMap() { rehash(MIN_CAPACITY); }
+
+        iterator begin() const { return iterator(slots(), slots() + _slots.size()); }
+        iterator end() const { return iterator(slots() + _slots.size(), slots() + _slots.size()); }
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+
+        iterator find(void* key) const
+        {
+            for (size_t i = indexOf(key);; i = (i + 1) & (_slots.size() - 1))
+            {
+                void* slotKey = _slots[i].first;
+                if (slotKey == key) return iterator(slots() + i, slots() + _slots.size());
+                if (slotKey == EMPTY) return end();
+            }
+        }
+
+        // Keeps the value of a key already in the table, as std::unordered_map::emplace does.
+        bool emplace(void* key, T value)
+        {
+            if (isFree(key)) return false;
+            if ((_size + _tombstones + 1) * 2 > _slots.size())
+            {
+                size_t capacity = MIN_CAPACITY;
+                while (capacity < (_size + 1) * 4) capacity <<= 1;
+                rehash(capacity);
+            }
+
+            value_type* tombstone = nullptr;
+            for (size_t i = indexOf(key);; i = (i + 1) & (_slots.size() - 1))
+            {
+                value_type& slot = _slots[i];
+                if (slot.first == key) return false;
+                if (slot.first == TOMBSTONE && !tombstone) tombstone = &slot;
+                if (slot.first == EMPTY)
+                {
+                    value_type* target = tombstone ? tombstone : &slot;
+                    if (tombstone) --_tombstones;
+                    target->first = key;
+                    target->second = std::move(value);
+                    ++_size;
+                    return true;
+                }
+            }
+        }
+
+        iterator erase(iterator iter)
+        {
+            iter->first = TOMBSTONE;
+            iter->second = T();
+            --_size;
+            ++_tombstones;
+            return ++iter;
+        }
+
+        size_t erase(void* key)
+        {
+            iterator iter = find(key);
+            if (iter == end()) return 0;
+            erase(iter);
+            return 1;
+        }
+
+        void clear()
+        {
+            for (auto& slot : _slots) slot = value_type(EMPTY, T());
+            _size = 0;
+            _tombstones = 0;
+        }
+
+    private:
+        static constexpr size_t MIN_CAPACITY = 64;
+        static void* const EMPTY;
+        static void* const TOMBSTONE;
+
+        static bool isFree(void* key) { return key == EMPTY || key == TOMBSTONE; }
+        value_type* slots() const { return const_cast<value_type*>(_slots.data()); }
+
+        size_t indexOf(void* key) const
+        {
+            // the top bits of the product are the best mixed ones
+            return static_cast<size_t>((static_cast<uint64_t>(reinterpret_cast<uintptr_t>(key)) * 11400714819323198485ULL) >> _shift);
+        }
+
+        void rehash(size_t capacity)
+        {
+            std::vector<value_type> slots(capacity, value_type(EMPTY, T()));
+            _slots.swap(slots);
+            _shift = 64;
+            for (size_t i = capacity; i > 1; i >>= 1) --_shift;
+            _size = 0;
+            _tombstones = 0;
+            for (auto& slot : slots)
+            {
+                if (!isFree(slot.first)) emplace(slot.first, std::move(slot.second));
+            }
+        }
+
+        std::vector<value_type> _slots;
+        size_t _size = 0;
+        size_t _tombstones = 0;
+        uint32_t _shift = 64;
+    };
+
+    template <typename T>
+    void* const PointerMap<T>::EMPTY = nullptr;
+    template <typename T>
+    void* const PointerMap<T>::TOMBSTONE = reinterpret_cast<void*>(1);
+
     class NativePtrToObjectMap
     {
     public:
         // key: native ptr, value: se::Object
-        using Map = std::unordered_map<void*, Object*>;
+        using Map = PointerMap<Object*>;
 
         static bool init();
         static void destroy();
@@ -61,7 +202,7 @@ namespace se {
     {
     public:
         // key: native ptr, value: non-ref object created by ctor
-        using Map = std::unordered_map<void*, bool>;
+        using Map = PointerMap<bool>;
 
         static bool init();
         static void destroy();
@@ -28,6 +28,23 @@
 namespace se {
 
 ValueArray EmptyValueArray;
+ValueArrayPool gValueArrayPool;
+
+ValueArray &ValueArrayPool::get(uint32_t argc) {
+    if (_depth == _arrays.size()) {
+        _arrays.push_back(new ValueArray());
+        _arrays.back()->reserve(MIN_ARRAY_CAPACITY);
+    }
+    ValueArray *array = _arrays[_depth++];
+    array->reserve(argc);
+    return *array;
+}
+
+void ValueArrayPool::release() {
+    assert(_depth > 0);
+    // the values release their objects right away, as they did with arrays on the stack
+    _arrays[--_depth]->clear();
+}
 
 Value Value::Null = Value(Type::Null);
 Value Value::Undefined = Value(Type::Undefined);
@@ -24,6 +24,7 @@
  ****************************************************************************/
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -427,6 +428,43 @@ private:
 using ValueArray = std::vector<Value>;
 extern ValueArray EmptyValueArray;
 
+/**
+ *  Reuses the argument arrays of native callbacks, so that calls don't allocate them anew.
+ *  Nested callbacks take the next array of the pool, they are released in the reverse order.
+ *  @note Used on the JS thread only.
+ */
+class ValueArrayPool final {
+public:
+    static const uint32_t MIN_ARRAY_CAPACITY = 10;
+
+    // Returns an empty array with room for argc values, they are appended.
+    ValueArray &get(uint32_t argc);
+    // Clears the array taken last.
+    void release();
+
+private:
+    std::vector<ValueArray *> _arrays;
+    uint32_t _depth = 0;
+};
+
+extern ValueArrayPool gValueArrayPool;
+
+/**
+ *  Holds an array of the pool while in scope.
+ */
+class PooledValueArray final {
+public:
+    explicit PooledValueArray(uint32_t argc) : _array(gValueArrayPool.get(argc)) {}
+    ~PooledValueArray() { gValueArrayPool.release(); }
+    PooledValueArray(const PooledValueArray &) = delete;
+    PooledValueArray &operator=(const PooledValueArray &) = delete;
+
+    ValueArray &get() { return _array; }
+
+private:
+    ValueArray &_array;
+};
+
 } // namespace se
 
 typedef se::Object *se_object_ptr;
@@ -31,6 +31,7 @@
 #include "Utils.h"
 #include "../State.h"
 #include "../MappingUtils.h"
+#include "base/Profiler.h"
 
 namespace se {
 
@@ -531,6 +532,7 @@ namespace se {
 
     void ScriptEngine::mainLoopUpdate()
     {
+        CC_PROFILE_ZONE("ScriptEngine::mainLoopUpdate");
         //IDEA:
     }
 
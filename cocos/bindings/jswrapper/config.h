@@ -45,6 +45,15 @@
 
 #define SE_LOG_TO_JS_ENV 0 // print log to JavaScript environment, for example DevTools
 
+// Binds the fast variants of simple generated functions as V8 fast API calls, their slow callbacks stay the fallback.
+// Needs a V8 whose v8::CFunction takes the receiver as v8::Local<v8::Object> and offers FastApiCallbackOptions::fallback.
+#if SCRIPT_ENGINE_TYPE != SCRIPT_ENGINE_V8
+#undef SE_ENABLE_FAST_API_CALLS
+#define SE_ENABLE_FAST_API_CALLS 0
+#elif !defined(SE_ENABLE_FAST_API_CALLS)
+#define SE_ENABLE_FAST_API_CALLS 0
+#endif
+
 #if !defined(ANDROID_INSTANT) && defined(USE_V8_DEBUGGER) && USE_V8_DEBUGGER > 0
 #define SE_ENABLE_INSPECTOR 1
 #define SE_DEBUG 2
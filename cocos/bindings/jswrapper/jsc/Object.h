@@ -133,6 +133,16 @@ namespace se {
          */
         bool getProperty(const char* name, Value* value);
 
+        /**
+         *  @brief Gets a property from an object, with the option to cache the engine's key of the property name.
+         *  @param[in] name A utf-8 string containing the property's name.
+         *  @param[out] value The property's value if object has the property, otherwise the undefined value.
+         *  @param[in] cachePropertyName Whether the key of the name is cached by its address and reused by the next calls, for hot
+         *             lookups of a few names such as the fields of math types. Meant for string literals.
+         *  @return true if object has the property, otherwise false.
+         */
+        bool getProperty(const char* name, Value* value, bool /*cachePropertyName*/) { return getProperty(name, value); } // the key isn't cached by this engine
+
         /**
          *  @brief Sets a property to an object.
          *  @param[in] name A utf-8 string containing the property's name.
@@ -31,6 +31,7 @@
 #include "Utils.h"
 #include "../State.h"
 #include "../MappingUtils.h"
+#include "base/Profiler.h"
 #include "PlatformUtils.h"
 
 #import "EJConvertTypedArray.h"
@@ -686,6 +687,7 @@ namespace se {
 
     void ScriptEngine::mainLoopUpdate()
     {
+        CC_PROFILE_ZONE("ScriptEngine::mainLoopUpdate");
         // empty implementation
     }
 
@@ -30,6 +30,7 @@
 #include "Class.h"
 #include "Utils.h"
 #include "../MappingUtils.h"
+#include "base/Profiler.h"
 #include "../State.h"
 
 // for debug socket
@@ -1231,6 +1232,7 @@ namespace se {
 
     void ScriptEngine::mainLoopUpdate()
     {
+        CC_PROFILE_ZONE("ScriptEngine::mainLoopUpdate");
         std::string message;
         size_t messageCount = 0;
         while (true)
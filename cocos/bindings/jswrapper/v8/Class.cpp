@@ -171,6 +171,19 @@ namespace se {
         return true;
     }
 
+#if SE_ENABLE_FAST_API_CALLS
+    bool Class::defineFunction(const char *name, v8::FunctionCallback func, const v8::CFunction* fastFunc)
+    {
+        v8::MaybeLocal<v8::String> jsName =  v8::String::NewFromUtf8(__isolate, name, v8::NewStringType::kNormal);
+        if (jsName.IsEmpty())
+            return false;
+        v8::Local<v8::FunctionTemplate> funcTemplate = v8::FunctionTemplate::New(__isolate, func, v8::Local<v8::Value>(), v8::Local<v8::Signature>(), 0,
+                                                                                 v8::ConstructorBehavior::kThrow, v8::SideEffectType::kHasSideEffect, fastFunc);
+        _ctorTemplate.Get(__isolate)->PrototypeTemplate()->Set(jsName.ToLocalChecked(), funcTemplate);
+        return true;
+    }
+#endif
+
     bool Class::defineProperty(const char *name, v8::AccessorNameGetterCallback getter, v8::AccessorNameSetterCallback setter)
     {
         v8::MaybeLocal<v8::String> jsName =  v8::String::NewFromUtf8(__isolate, name, v8::NewStringType::kNormal);
@@ -59,6 +59,17 @@ namespace se {
          */
         bool defineFunction(const char *name, v8::FunctionCallback func);
 
+#if SE_ENABLE_FAST_API_CALLS
+        /**
+         *  @brief Defines a member function with a callback and a fast variant which optimized code calls directly.
+         *  @param[in] name A null-terminated UTF8 string containing the function name.
+         *  @param[in] func A callback to invoke when the fast variant can't be used or asks for the fallback.
+         *  @param[in] fastFunc The fast variant, it has to live as long as the class.
+         *  @return true if succeed, otherwise false.
+         */
+        bool defineFunction(const char *name, v8::FunctionCallback func, const v8::CFunction* fastFunc);
+#endif
+
         /**
          *  @brief Defines a property with accessor callbacks. Each objects created by class will have this property.
          *  @param[in] name A null-terminated UTF8 string containing the property name.
@@ -61,7 +61,8 @@ bool cmp(std::pair<std::string, int> &a, std::pair<std::string, int> &b) {
 
 std::vector<std::pair<std::string, int>> pairs;
 
-void recordJSBInvoke(const std::string &funcName) {
+// takes the literal of the macros, so that calls don't build a std::string when nothing is recorded
+inline void recordJSBInvoke(const char *funcName) {
     #if defined(CC_DEBUG) & defined(RECORD_JSB_INVOKING)
     ++__jsbInvocationCount;
     ++__jsbFunctionInvokedRecords[funcName];
@@ -116,8 +117,8 @@ void printJSBInvoke() {
             v8::Isolate *_isolate = _v8args.GetIsolate();                                                 \
             v8::HandleScope _hs(_isolate);                                                                \
             SE_UNUSED unsigned argc = (unsigned)_v8args.Length();                                         \
-            se::ValueArray args;                                                                          \
-            args.reserve(10);                                                                             \
+            se::PooledValueArray _pooledArgs(argc);                                                       \
+            se::ValueArray &args = _pooledArgs.get();                                                     \
             se::internal::jsToSeArgs(_v8args, &args);                                                     \
             void *nativeThisObject = se::internal::getPrivate(_isolate, _v8args.This());                  \
             se::State state(nativeThisObject, args);                                                      \
@@ -128,6 +129,14 @@ void printJSBInvoke() {
             se::internal::setReturnValue(state.rval(), _v8args);                                          \
         }
 
+#if SE_ENABLE_FAST_API_CALLS
+    // The fast variant of a function takes the receiver, its scalar arguments and the callback options.
+    #define _SE_FAST(name) (&name##FastRegistry)
+
+    #define SE_BIND_FAST_FUNC(funcName) \
+        const v8::CFunction funcName##FastRegistry = v8::CFunction::Make(funcName);
+#endif
+
     #define SE_BIND_FINALIZE_FUNC(funcName)                                                               \
         void funcName##Registry(void *nativeThisObject) {                                                 \
             recordJSBInvoke(#funcName);                                                                   \
@@ -153,8 +162,8 @@ void printJSBInvoke() {
             v8::Isolate *_isolate = _v8args.GetIsolate();                                                 \
             v8::HandleScope _hs(_isolate);                                                                \
             bool ret = true;                                                                              \
-            se::ValueArray args;                                                                          \
-            args.reserve(10);                                                                             \
+            se::PooledValueArray _pooledArgs((uint32_t)_v8args.Length());                                 \
+            se::ValueArray &args = _pooledArgs.get();                                                     \
             se::internal::jsToSeArgs(_v8args, &args);                                                     \
             se::Object *thisObject = se::Object::_createJSObject(cls, _v8args.This());                    \
             thisObject->_setFinalizeCallback(_SE(finalizeCb));                                            \
@@ -165,7 +174,7 @@ void printJSBInvoke() {
             }                                                                                             \
             se::Value _property;                                                                          \
             bool _found = false;                                                                          \
-            _found = thisObject->getProperty("_ctor", &_property);                                        \
+            _found = thisObject->getProperty("_ctor", &_property, true);                                  \
             if (_found) _property.toObject()->call(args, thisObject);                                     \
         }
 
@@ -195,8 +204,8 @@ void printJSBInvoke() {
             void *nativeThisObject = se::internal::getPrivate(_isolate, _v8args.This());                                                     \
             se::Value data;                                                                                                                  \
             se::internal::jsToSeValue(_isolate, _value, &data);                                                                              \
-            se::ValueArray args;                                                                                                             \
-            args.reserve(10);                                                                                                                \
+            se::PooledValueArray _pooledArgs(1);                                                                                             \
+            se::ValueArray &args = _pooledArgs.get();                                                                                        \
             args.push_back(std::move(data));                                                                                                 \
             se::State state(nativeThisObject, args);                                                                                         \
             ret = funcName(state);                                                                                                           \
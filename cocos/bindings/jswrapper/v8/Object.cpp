@@ -30,7 +30,9 @@
 #include "ScriptEngine.h"
 #include "../MappingUtils.h"
 
+#include <cstring>
 #include <memory>
+#include <string>
 #include <unordered_map>
 
 namespace se {
@@ -41,6 +43,81 @@ namespace se {
     namespace {
         v8::Isolate* __isolate = nullptr;
         uint32_t _nativeObjectId = 0;
+
+        // Free list threaded through the released objects, refilled a slab at a time. The slabs are kept
+        // for the next objects, as the number of live objects stays close to its peak during a run.
+        class ObjectPool
+        {
+        public:
+            void* allocate()
+            {
+                if (_freeList == nullptr)
+                    refill();
+                FreeSlot* slot = _freeList;
+                _freeList = slot->next;
+                ++_liveCount;
+                return slot;
+            }
+
+            void deallocate(void* ptr)
+            {
+                push(ptr);
+                --_liveCount;
+            }
+
+            size_t getLiveCount() const { return _liveCount; }
+            size_t getReservedBytes() const { return _slabCount * sizeof(Object) * OBJECTS_PER_SLAB; }
+
+        private:
+            struct FreeSlot
+            {
+                FreeSlot* next;
+            };
+            static constexpr size_t OBJECTS_PER_SLAB = 256;
+
+            void push(void* ptr)
+            {
+                auto* slot = static_cast<FreeSlot*>(ptr);
+                slot->next = _freeList;
+                _freeList = slot;
+            }
+
+            void refill()
+            {
+                auto* slab = static_cast<uint8_t*>(::operator new(sizeof(Object) * OBJECTS_PER_SLAB));
+                for (size_t i = OBJECTS_PER_SLAB; i > 0; --i)
+                    push(slab + (i - 1) * sizeof(Object));
+                ++_slabCount;
+            }
+
+            FreeSlot* _freeList = nullptr;
+            size_t _liveCount = 0;
+            size_t _slabCount = 0;
+        };
+        ObjectPool __objectPool;
+
+        struct CachedPropertyName
+        {
+            std::string name;
+            v8::Eternal<v8::String> key;
+        };
+        // Internalized property names of the isolate, keyed by the address of the name passed in.
+        std::unordered_map<const char*, CachedPropertyName> __cachedPropertyNames;
+
+        v8::Local<v8::String> getCachedPropertyName(const char* name)
+        {
+            auto& cached = __cachedPropertyNames[name];
+            // the address may be reused by another name if it isn't a literal
+            if (cached.key.IsEmpty() || cached.name != name)
+            {
+                v8::MaybeLocal<v8::String> key = v8::String::NewFromUtf8(__isolate, name, v8::NewStringType::kInternalized);
+                if (key.IsEmpty())
+                    return v8::Local<v8::String>();
+                cached.name = name;
+                cached.key.Set(__isolate, key.ToLocalChecked());
+            }
+            return cached.key.Get(__isolate);
+        }
     }
 
     Object::Object()
@@ -52,6 +129,28 @@ namespace se {
     {
     }
 
+    void* Object::operator new(size_t size)
+    {
+        assert(size == sizeof(Object));
+        return __objectPool.allocate();
+    }
+
+    void Object::operator delete(void* ptr)
+    {
+        if (ptr != nullptr)
+            __objectPool.deallocate(ptr);
+    }
+
+    size_t Object::getLiveCount()
+    {
+        return __objectPool.getLiveCount();
+    }
+
+    size_t Object::getReservedBytes()
+    {
+        return __objectPool.getReservedBytes();
+    }
+
     Object::~Object()
     {
         if (_rootCount > 0)
@@ -97,6 +196,8 @@ namespace se {
     void Object::setIsolate(v8::Isolate* isolate)
     {
         __isolate = isolate;
+        // eternal handles belong to the isolate they were created in
+        __cachedPropertyNames.clear();
     }
 
     void Object::setup()
@@ -248,32 +349,69 @@ namespace se {
         }else{
             memset(jsobj->GetBackingStore()->Data(), 0, byteLength);
         }
-        
+
+        return _createTypedArray(type, jsobj, 0, byteLength);
+    }
+
+    Object* Object::createExternalArrayBufferObject(void* contents, size_t byteLength, BufferContentsFreeFunc freeFunc, void* freeUserData)
+    {
+        std::shared_ptr<v8::BackingStore> backingStore = v8::ArrayBuffer::NewBackingStore(contents, byteLength, freeFunc ? freeFunc : v8::BackingStore::EmptyDeleter, freeUserData);
+        v8::Local<v8::ArrayBuffer> jsobj = v8::ArrayBuffer::New(__isolate, std::move(backingStore));
+        Object* obj = Object::_createJSObject(nullptr, jsobj);
+        return obj;
+    }
+
+    Object* Object::createTypedArrayWithBuffer(TypedArrayType type, const Object* obj, size_t offset, size_t byteLength)
+    {
+        if (type == TypedArrayType::NONE || type == TypedArrayType::UINT8_CLAMPED)
+        {
+            SE_LOGE("Doesn't support to create typed array of type %d with Object::createTypedArrayWithBuffer API!", (int)type);
+            return nullptr;
+        }
+
+        if (obj == nullptr || !obj->isArrayBuffer())
+        {
+            SE_LOGE("Object::createTypedArrayWithBuffer needs an array buffer object!");
+            return nullptr;
+        }
+
+        v8::Local<v8::ArrayBuffer> jsobj = v8::Local<v8::ArrayBuffer>::Cast(obj->_getJSObject());
+        if (offset + byteLength > jsobj->ByteLength())
+        {
+            SE_LOGE("Object::createTypedArrayWithBuffer: range [%u, %u) is out of the array buffer!", (unsigned)offset, (unsigned)(offset + byteLength));
+            return nullptr;
+        }
+
+        return _createTypedArray(type, jsobj, offset, byteLength);
+    }
+
+    Object* Object::_createTypedArray(TypedArrayType type, v8::Local<v8::ArrayBuffer> jsobj, size_t offset, size_t byteLength)
+    {
         v8::Local<v8::Object> arr;
         switch (type) {
             case TypedArrayType::INT8:
-                arr = v8::Int8Array::New(jsobj, 0, byteLength);
+                arr = v8::Int8Array::New(jsobj, offset, byteLength);
                 break;
             case TypedArrayType::INT16:
-                arr = v8::Int16Array::New(jsobj, 0, byteLength / 2);
+                arr = v8::Int16Array::New(jsobj, offset, byteLength / 2);
                 break;
             case TypedArrayType::INT32:
-                arr = v8::Int32Array::New(jsobj, 0, byteLength / 4);
+                arr = v8::Int32Array::New(jsobj, offset, byteLength / 4);
                 break;
             case TypedArrayType::UINT8:
-                arr = v8::Uint8Array::New(jsobj, 0, byteLength);
+                arr = v8::Uint8Array::New(jsobj, offset, byteLength);
                 break;
             case TypedArrayType::UINT16:
-                arr = v8::Uint16Array::New(jsobj, 0, byteLength / 2);
+                arr = v8::Uint16Array::New(jsobj, offset, byteLength / 2);
                 break;
             case TypedArrayType::UINT32:
-                arr = v8::Uint32Array::New(jsobj, 0, byteLength / 4);
+                arr = v8::Uint32Array::New(jsobj, offset, byteLength / 4);
                 break;
             case TypedArrayType::FLOAT32:
-                arr = v8::Float32Array::New(jsobj, 0, byteLength / 4);
+                arr = v8::Float32Array::New(jsobj, offset, byteLength / 4);
                 break;
             case TypedArrayType::FLOAT64:
-                arr = v8::Float64Array::New(jsobj, 0, byteLength / 8);
+                arr = v8::Float64Array::New(jsobj, offset, byteLength / 8);
                 break;
             default:
                 assert(false); // Should never go here.
@@ -304,6 +442,76 @@ namespace se {
         return Object::_createJSObject(nullptr, jsobj);
     }
 
+    namespace {
+    // A one byte string over native memory, which is released once the engine disposes the string.
+    class ExternalOneByteString : public v8::String::ExternalOneByteStringResource
+    {
+    public:
+        ExternalOneByteString(const char* data, size_t length, Object::BufferContentsFreeFunc freeFunc, void* freeUserData)
+        : _data(data), _length(length), _freeFunc(freeFunc), _freeUserData(freeUserData)
+        {
+        }
+        ~ExternalOneByteString() override
+        {
+            _freeFunc(const_cast<char*>(_data), _length, _freeUserData);
+        }
+        const char* data() const override { return _data; }
+        size_t length() const override { return _length; }
+
+    private:
+        const char* _data;
+        size_t _length;
+        Object::BufferContentsFreeFunc _freeFunc;
+        void* _freeUserData;
+    };
+
+    bool isASCII(const char* data, size_t length)
+    {
+        size_t i = 0;
+        uint64_t bits = 0;
+        for (; i + 8 <= length; i += 8)
+        {
+            uint64_t word;
+            memcpy(&word, data + i, sizeof(word));
+            bits |= word;
+        }
+        for (; i < length; ++i)
+            bits |= static_cast<unsigned char>(data[i]);
+        return (bits & 0x8080808080808080ULL) == 0;
+    }
+    } // namespace
+
+    bool Object::parseJSON(const char* json, size_t length, Value* ret, BufferContentsFreeFunc freeFunc, void* freeUserData)
+    {
+        assert(ret != nullptr);
+        if (length > static_cast<size_t>(v8::String::kMaxLength))
+        {
+            if (freeFunc) freeFunc(const_cast<char*>(json), length, freeUserData);
+            return false;
+        }
+
+        v8::MaybeLocal<v8::String> str;
+        if (freeFunc && isASCII(json, length))
+        {
+            str = v8::String::NewExternalOneByte(__isolate, new ExternalOneByteString(json, length, freeFunc, freeUserData));
+        }
+        else
+        {
+            str = v8::String::NewFromUtf8(__isolate, json, v8::NewStringType::kNormal, static_cast<int>(length));
+            if (freeFunc) freeFunc(const_cast<char*>(json), length, freeUserData);
+        }
+        if (str.IsEmpty())
+            return false;
+
+        v8::TryCatch tryCatch(__isolate);
+        v8::MaybeLocal<v8::Value> parsed = v8::JSON::Parse(__isolate->GetCurrentContext(), str.ToLocalChecked());
+        if (parsed.IsEmpty())
+            return false;
+
+        internal::jsToSeValue(__isolate, parsed.ToLocalChecked(), ret);
+        return true;
+    }
+
     bool Object::init(Class* cls, v8::Local<v8::Object> obj)
     {
         _cls = cls;
@@ -360,6 +568,43 @@ namespace se {
         return true;
     }
 
+    bool Object::getProperty(const char *name, Value *data, bool cachePropertyName)
+    {
+        if (!cachePropertyName)
+            return getProperty(name, data);
+
+        assert(data != nullptr);
+        data->setUndefined();
+
+        v8::HandleScope handle_scope(__isolate);
+
+        if (_obj.persistent().IsEmpty())
+        {
+            return false;
+        }
+
+        v8::Local<v8::String> key = getCachedPropertyName(name);
+        if (key.IsEmpty())
+            return false;
+
+        // a single lookup for the properties which exist, as they do in most cases
+        v8::Local<v8::Context> context = __isolate->GetCurrentContext();
+        v8::Local<v8::Object> obj = _obj.handle(__isolate);
+        v8::MaybeLocal<v8::Value> result = obj->Get(context, key);
+        if (result.IsEmpty())
+            return false;
+
+        v8::Local<v8::Value> value = result.ToLocalChecked();
+        if (value->IsUndefined())
+        {
+            v8::Maybe<bool> maybeExist = obj->Has(context, key);
+            return maybeExist.IsJust() && maybeExist.FromJust();
+        }
+
+        internal::jsToSeValue(__isolate, value, data);
+        return true;
+    }
+
     bool Object::deleteProperty(const char *name)
     {
 
@@ -539,11 +784,21 @@ namespace se {
             SE_LOGD("Function object is released!\n");
             return false;
         }
-        size_t argc = 0;
-        std::vector<v8::Local<v8::Value>> argv;
-        argv.reserve(10);
-        argc = args.size();
-        internal::seToJsArgs(__isolate, args, &argv);
+        // the arguments of typical calls stay on the stack
+        static const size_t MAX_STACK_ARGC = 8;
+        const size_t argc = args.size();
+        v8::Local<v8::Value> stackArgv[MAX_STACK_ARGC];
+        std::vector<v8::Local<v8::Value>> heapArgv;
+        v8::Local<v8::Value>* argv = stackArgv;
+        if (argc > MAX_STACK_ARGC)
+        {
+            heapArgv.resize(argc);
+            argv = heapArgv.data();
+        }
+        for (size_t i = 0; i < argc; ++i)
+        {
+            internal::seToJsValue(__isolate, args[i], &argv[i]);
+        }
 
         v8::Local<v8::Object> thiz = v8::Local<v8::Object>::Cast(v8::Undefined(__isolate));
         if (thisObject != nullptr)
@@ -566,7 +821,7 @@ namespace se {
         }
 
         v8::Local<v8::Context> context = se::ScriptEngine::getInstance()->_getContext();
-        v8::MaybeLocal<v8::Value> result = _obj.handle(__isolate)->CallAsFunction(context, thiz, (int)argc, argv.data());
+        v8::MaybeLocal<v8::Value> result = _obj.handle(__isolate)->CallAsFunction(context, thiz, (int)argc, argv);
 
         if (!result.IsEmpty())
         {
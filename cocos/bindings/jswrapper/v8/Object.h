@@ -108,6 +108,30 @@ namespace se {
          */
         static Object* createArrayBufferObject(void* bytes, size_t byteLength);
 
+        using BufferContentsFreeFunc = void (*)(void* contents, size_t byteLength, void* userData);
+
+        /**
+         *  @brief Creates a JavaScript Array Buffer object over an existing pointer without copying it.
+         *  @param[in] contents A pointer to the memory to be used as the backing store of the Array Buffer object.
+         *  @param[in] byteLength The number of bytes pointed to by the parameter contents.
+         *  @param[in] freeFunc Called with contents once the engine releases the backing store, may be called on any thread, nullptr to keep the memory.
+         *  @param[in] freeUserData The user data passed to freeFunc.
+         *  @return A Array Buffer Object whose backing store is contents, or nullptr if there is an error.
+         *  @note The return value (non-null) has to be released manually.
+         */
+        static Object* createExternalArrayBufferObject(void* contents, size_t byteLength, BufferContentsFreeFunc freeFunc, void* freeUserData = nullptr);
+
+        /**
+         *  @brief Creates a JavaScript Typed Array Object viewing a range of an Array Buffer object.
+         *  @param[in] type The format of typed array.
+         *  @param[in] obj The Array Buffer object.
+         *  @param[in] offset The byte offset of the view into the Array Buffer.
+         *  @param[in] byteLength The number of bytes viewed.
+         *  @return A JavaScript Typed Array Object sharing the backing store of obj, or nullptr if there is an error.
+         *  @note The return value (non-null) has to be released manually.
+         */
+        static Object* createTypedArrayWithBuffer(TypedArrayType type, const Object* obj, size_t offset, size_t byteLength);
+
         /**
          *  @brief Creates a JavaScript Object from a JSON formatted string.
          *  @param[in] jsonStr The utf-8 string containing the JSON string to be parsed.
@@ -116,6 +140,18 @@ namespace se {
          */
         static Object* createJSONObject(const std::string& jsonStr);
 
+        /**
+         *  @brief Parses JSON text straight from a UTF-8 buffer into any JSON value.
+         *  @param[in] json The utf-8 JSON text, without a terminating null.
+         *  @param[in] length The number of bytes of the JSON text.
+         *  @param[out] ret The parsed value.
+         *  @param[in] freeFunc Called with json once the engine doesn't need it anymore, nullptr to copy it. ASCII text is parsed without a copy then, on any thread
+         *  and possibly only once a garbage collection released the source string.
+         *  @param[in] freeUserData The user data passed to freeFunc.
+         *  @return true if the text is valid JSON, a syntax error isn't thrown to JavaScript.
+         */
+        static bool parseJSON(const char* json, size_t length, Value* ret, BufferContentsFreeFunc freeFunc = nullptr, void* freeUserData = nullptr);
+
         /**
          *  @brief Creates a JavaScript Native Binding Object from an existing se::Class instance.
          *  @param[in] cls The se::Class instance which stores native callback informations.
@@ -132,6 +168,16 @@ namespace se {
          */
         static Object* getObjectWithPtr(void* ptr);
 
+        /**
+         *  @brief Gets the number of se::Object instances alive.
+         */
+        static size_t getLiveCount();
+
+        /**
+         *  @brief Gets the bytes reserved by the pool the se::Object instances are allocated from.
+         */
+        static size_t getReservedBytes();
+
         /**
          *  @brief Gets a property from an object.
          *  @param[in] name A utf-8 string containing the property's name.
@@ -140,6 +186,16 @@ namespace se {
          */
         bool getProperty(const char *name, Value* value);
 
+        /**
+         *  @brief Gets a property from an object, with the option to cache the engine's key of the property name.
+         *  @param[in] name A utf-8 string containing the property's name.
+         *  @param[out] value The property's value if object has the property, otherwise the undefined value.
+         *  @param[in] cachePropertyName Whether the key of the name is cached by its address and reused by the next calls, for hot
+         *             lookups of a few names such as the fields of math types. Meant for string literals.
+         *  @return true if object has the property, otherwise false.
+         */
+        bool getProperty(const char *name, Value* value, bool cachePropertyName);
+
         /**
          *  @brief Sets a property to an object.
          *  @param[in] name A utf-8 string containing the property's name.
@@ -370,6 +426,7 @@ namespace se {
 
         // Private API used in wrapper
         static Object* _createJSObject(Class* cls, v8::Local<v8::Object> obj);
+        static Object* _createTypedArray(TypedArrayType type, v8::Local<v8::ArrayBuffer> jsobj, size_t offset, size_t byteLength);
         v8::Local<v8::Object> _getJSObject() const;
         ObjectWrap& _getWrap();
         Class* _getClass() const;
@@ -391,6 +448,10 @@ namespace se {
         Object();
         virtual ~Object();
 
+        // Objects come from slabs of a pool, they are created and released on the JS thread only.
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr);
+
         bool init(Class* cls, v8::Local<v8::Object> obj);
 
         Class* _cls;
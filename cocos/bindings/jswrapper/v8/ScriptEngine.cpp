@@ -32,7 +32,11 @@
 #include "Utils.h"
 #include "../State.h"
 #include "../MappingUtils.h"
+#include "base/MemoryPressure.h"
+#include "base/Profiler.h"
+#include "base/Startup.h"
 #include "platform/FileUtils.h"
+#include "platform/SpikeDetector.h"
 
 #include <sstream>
 
@@ -42,6 +46,8 @@
 #include "debugger/node.h"
 #endif
 
+#include <algorithm>
+#include <memory>
 #include <sstream>
 
 #define EXPOSE_GC "__jsb_gc__"
@@ -77,6 +83,49 @@ namespace se {
             ScriptEngine::getInstance()->garbageCollect();
         }
 
+        // Scripts smaller than this compile faster than their code cache is read.
+        const ssize_t CODE_CACHE_MIN_SCRIPT_SIZE = 4 * 1024;
+        const uint32_t CODE_CACHE_MAGIC = 0x43435643; // "CCVC"
+
+        // Precedes the code cache V8 created for a script, which is only consumed for the same source
+        // and by the same engine. V8 itself only compares the length of the source.
+        struct CodeCacheHeader
+        {
+            uint32_t magic;
+            uint32_t versionTag; // v8::ScriptCompiler::CachedDataVersionTag(), covers the version and the flags of the engine
+            uint64_t sourceHash;
+            uint64_t sourceLength;
+        };
+
+        uint64_t hashCodeCacheKey(const char* data, size_t length)
+        {
+            // FNV-1a, stable across launches unlike std::hash
+            uint64_t hash = 14695981039346656037ULL;
+            for (size_t i = 0; i < length; ++i)
+            {
+                hash ^= static_cast<uint8_t>(data[i]);
+                hash *= 1099511628211ULL;
+            }
+            return hash;
+        }
+
+        const uint32_t STARTUP_SNAPSHOT_MAGIC = 0x43435353; // "CCSS"
+
+        // Precedes the startup snapshot blob, V8 aborts on blobs of another version or other flags.
+        struct StartupSnapshotHeader
+        {
+            uint32_t magic;
+            uint32_t versionTag;
+        };
+
+        // One cache file per script path, so that updated scripts replace their stale cache.
+        std::string getCodeCachePath(const char* fileName)
+        {
+            char name[32] = {0};
+            snprintf(name, sizeof(name), "%016llx.cache", static_cast<unsigned long long>(hashCodeCacheKey(fileName, strlen(fileName))));
+            return cc::FileUtils::getInstance()->getWritablePath() + "v8-code-cache/" + name;
+        }
+
         std::string stackTraceToString(v8::Local<v8::StackTrace> stack)
         {
             std::string stackStr;
@@ -390,6 +439,7 @@ namespace se {
     , _isInCleanup(false)
     , _isErrorHandleWorking(false)
     {
+        CC_STARTUP_PHASE("ScriptEnginePlatform");
         _platform = v8::platform::NewDefaultPlatform().release();
         v8::V8::InitializePlatform(_platform);
 
@@ -398,6 +448,9 @@ namespace se {
         flags.append(" --expose-gc-as=" EXPOSE_GC);
         flags.append(" --no-flush-bytecode --no-lazy"); // for bytecode support
         // flags.append(" --trace-gc"); // v8 trace gc
+#if SE_ENABLE_FAST_API_CALLS
+        flags.append(" --turbo-fast-api-calls");
+#endif
 #if (CC_PLATFORM == CC_PLATFORM_MAC_IOS)
         flags.append(" --jitless");
 #endif
@@ -421,6 +474,7 @@ namespace se {
     bool ScriptEngine::init()
     {
         cleanup();
+        CC_STARTUP_PHASE("ScriptEngineIsolate");
         SE_LOGD("Initializing V8, version: %s\n", v8::V8::GetVersion());
         ++_vmId;
 
@@ -433,6 +487,15 @@ namespace se {
         _beforeInitHookArray.clear();
         v8::Isolate::CreateParams create_params;
         create_params.array_buffer_allocator = v8::ArrayBuffer::Allocator::NewDefaultAllocator();
+        if (_maxOldGenerationBytes > 0)
+            create_params.constraints.set_max_old_generation_size_in_bytes(_maxOldGenerationBytes);
+        if (_maxYoungGenerationBytes > 0)
+            create_params.constraints.set_max_young_generation_size_in_bytes(_maxYoungGenerationBytes);
+        if (loadStartupSnapshot())
+        {
+            // the default context is deserialized from the snapshot, with its scripts already run
+            create_params.snapshot_blob = &_startupSnapshot;
+        }
         _isolate = v8::Isolate::New(create_params);
         v8::HandleScope hs(_isolate);
         _isolate->Enter();
@@ -443,6 +506,18 @@ namespace se {
         _isolate->SetOOMErrorHandler(onOOMErrorCallback);
         _isolate->AddMessageListener(onMessageCallback);
         _isolate->SetPromiseRejectCallback(onPromiseRejectCallback);
+        _isolate->AddGCPrologueCallback(onGCPrologueCallback);
+        _isolate->AddGCEpilogueCallback(onGCEpilogueCallback);
+        resetGCStats();
+        // collected after the native caches let go of their script objects, they sit in lower tiers
+        _memoryPressureHandlerID = cc::MemoryPressure::addHandler("ScriptEngine", cc::MemoryPressureLevel::LOW, [this](cc::MemoryPressureLevel level) {
+            if (!_isValid || _isInCleanup || _isGarbageCollecting)
+                return;
+            if (level == cc::MemoryPressureLevel::CRITICAL)
+                _isolate->LowMemoryNotification();
+            else
+                _isolate->MemoryPressureNotification(v8::MemoryPressureLevel::kModerate);
+        });
 
         _context.Reset(_isolate, v8::Context::New(_isolate));
         _context.Get(_isolate)->Enter();
@@ -517,6 +592,8 @@ namespace se {
 
         SE_LOGD("ScriptEngine::cleanup begin ...\n");
         _isInCleanup = true;
+        cc::MemoryPressure::removeHandler(_memoryPressureHandlerID);
+        _memoryPressureHandlerID = 0;
 
         {
             AutoHandleScope hs;
@@ -559,6 +636,9 @@ namespace se {
             _isolate->Exit();
         }
         _isolate->Dispose();
+        // the isolate reads the blob until it is disposed
+        _startupSnapshotData.clear();
+        _startupSnapshotData.shrink_to_fit();
 
         _isolate = nullptr;
         _globalObj = nullptr;
@@ -638,6 +718,7 @@ namespace se {
         bool ok = false;
         _startTime = std::chrono::steady_clock::now();
 
+        CC_STARTUP_PHASE("BindingRegistration");
         for (auto cb : _registerCallbackArray)
         {
             ok = cb(_globalObj);
@@ -692,6 +773,11 @@ namespace se {
     }
 
     bool ScriptEngine::evalString(const char* script, ssize_t length/* = -1 */, Value* ret/* = nullptr */, const char* fileName/* = nullptr */)
+    {
+        return evalString(script, length, ret, fileName, false);
+    }
+
+    bool ScriptEngine::evalString(const char* script, ssize_t length, Value* ret, const char* fileName, bool useCodeCache)
     {
         if(_engineThreadId != std::this_thread::get_id())
         {
@@ -727,8 +813,7 @@ namespace se {
         // It is needed, or will crash if invoked from non C++ context, such as invoked from objective-c context(for example, handler of UIKit).
         v8::HandleScope handle_scope(_isolate);
 
-        std::string scriptStr(script, length);
-        v8::MaybeLocal<v8::String> source = v8::String::NewFromUtf8(_isolate, scriptStr.c_str(), v8::NewStringType::kNormal);
+        v8::MaybeLocal<v8::String> source = v8::String::NewFromUtf8(_isolate, script, v8::NewStringType::kNormal, (int)length);
         if (source.IsEmpty())
             return false;
 
@@ -737,7 +822,45 @@ namespace se {
             return false;
 
         v8::ScriptOrigin origin(originStr.ToLocalChecked());
-        v8::MaybeLocal<v8::Script> maybeScript = v8::Script::Compile(_context.Get(_isolate), source.ToLocalChecked(), &origin);
+        v8::MaybeLocal<v8::Script> maybeScript;
+
+        std::string cachePath;
+        uint64_t sourceHash = 0;
+        bool isCacheMissing = false;
+        v8::Local<v8::UnboundScript> unboundScript;
+        if (useCodeCache && _isCodeCacheEnabled && length >= CODE_CACHE_MIN_SCRIPT_SIZE)
+        {
+            cachePath = getCodeCachePath(fileName);
+            sourceHash = hashCodeCacheKey(script, length);
+
+            cc::Data cacheData;
+            v8::ScriptCompiler::CachedData* cachedData = nullptr;
+            if (readCodeCache(cachePath, sourceHash, length, &cacheData))
+            {
+                cachedData = new v8::ScriptCompiler::CachedData(cacheData.getBytes() + sizeof(CodeCacheHeader),
+                                                                (int)(cacheData.getSize() - sizeof(CodeCacheHeader)),
+                                                                v8::ScriptCompiler::CachedData::BufferNotOwned);
+            }
+
+            // the source owns the cached data, which doesn't own the buffer
+            v8::ScriptCompiler::Source compilerSource(source.ToLocalChecked(), origin, cachedData);
+            v8::MaybeLocal<v8::UnboundScript> maybeUnboundScript = v8::ScriptCompiler::CompileUnboundScript(_isolate, &compilerSource,
+                cachedData ? v8::ScriptCompiler::kConsumeCodeCache : v8::ScriptCompiler::kNoCompileOptions);
+            if (!maybeUnboundScript.IsEmpty())
+            {
+                // a rejected cache is compiled from the source, and regenerated after the run
+                isCacheMissing = !cachedData || compilerSource.GetCachedData()->rejected;
+                if (cachedData && isCacheMissing)
+                    SE_LOGD("ScriptEngine::evalString code cache of %s rejected, it will be regenerated\n", fileName);
+
+                unboundScript = maybeUnboundScript.ToLocalChecked();
+                maybeScript = unboundScript->BindToCurrentContext();
+            }
+        }
+        else
+        {
+            maybeScript = v8::Script::Compile(_context.Get(_isolate), source.ToLocalChecked(), &origin);
+        }
 
         bool success = false;
 
@@ -771,9 +894,156 @@ namespace se {
         {
             SE_LOGE("ScriptEngine::evalString script %s, failed!\n", fileName);
         }
+        else if (isCacheMissing)
+        {
+            // created after the run, so that functions compiled while it ran are included too
+            saveCodeCache(unboundScript, cachePath, sourceHash, length);
+        }
+        return success;
+    }
+
+    bool ScriptEngine::loadStartupSnapshot()
+    {
+        _startupSnapshotData.clear();
+        if (_startupSnapshotPath.empty())
+            return false;
+
+        auto fu = cc::FileUtils::getInstance();
+        if (!fu->isFileExist(_startupSnapshotPath) || fu->getContents(_startupSnapshotPath, &_startupSnapshotData) != cc::FileUtils::Status::OK
+            || _startupSnapshotData.size() <= sizeof(StartupSnapshotHeader))
+        {
+            SE_LOGE("ScriptEngine::init failed to read startup snapshot %s\n", _startupSnapshotPath.c_str());
+            _startupSnapshotData.clear();
+            return false;
+        }
+
+        StartupSnapshotHeader header;
+        memcpy(&header, _startupSnapshotData.data(), sizeof(header));
+        if (header.magic != STARTUP_SNAPSHOT_MAGIC || header.versionTag != v8::ScriptCompiler::CachedDataVersionTag())
+        {
+            SE_LOGE("ScriptEngine::init startup snapshot %s was created by another engine, ignored\n", _startupSnapshotPath.c_str());
+            _startupSnapshotData.clear();
+            return false;
+        }
+
+        _startupSnapshot.data = _startupSnapshotData.data() + sizeof(header);
+        _startupSnapshot.raw_size = (int)(_startupSnapshotData.size() - sizeof(header));
+        return true;
+    }
+
+    bool ScriptEngine::createStartupSnapshot(const std::vector<std::string>& scriptPaths, const std::string& outputPath)
+    {
+        bool success = true;
+        v8::StartupData blob = {nullptr, 0};
+        {
+            // an isolate of its own, without any native function the snapshot would have to reference
+            v8::SnapshotCreator creator;
+            v8::Isolate* isolate = creator.GetIsolate();
+            {
+                v8::Isolate::Scope isolateScope(isolate);
+                v8::HandleScope handleScope(isolate);
+                v8::Local<v8::Context> context = v8::Context::New(isolate);
+                v8::Context::Scope contextScope(context);
+
+                for (const auto& path : scriptPaths)
+                {
+                    std::string script = _fileOperationDelegate.isValid() ? _fileOperationDelegate.onGetStringFromFile(path) : cc::FileUtils::getInstance()->getStringFromFile(path);
+                    v8::TryCatch tryCatch(isolate);
+                    v8::MaybeLocal<v8::String> source = v8::String::NewFromUtf8(isolate, script.c_str(), v8::NewStringType::kNormal, (int)script.length());
+                    v8::MaybeLocal<v8::String> originStr = v8::String::NewFromUtf8(isolate, path.c_str(), v8::NewStringType::kNormal);
+                    if (script.empty() || source.IsEmpty() || originStr.IsEmpty())
+                    {
+                        SE_LOGE("ScriptEngine::createStartupSnapshot failed to read %s\n", path.c_str());
+                        success = false;
+                        break;
+                    }
+
+                    v8::ScriptOrigin origin(originStr.ToLocalChecked());
+                    v8::MaybeLocal<v8::Script> maybeScript = v8::Script::Compile(context, source.ToLocalChecked(), &origin);
+                    if (maybeScript.IsEmpty() || maybeScript.ToLocalChecked()->Run(context).IsEmpty())
+                    {
+                        if (tryCatch.HasCaught())
+                        {
+                            v8::String::Utf8Value exception(isolate, tryCatch.Exception());
+                            SE_LOGE("ScriptEngine::createStartupSnapshot %s: %s\n", path.c_str(), *exception ? *exception : "unknown error");
+                        }
+                        SE_LOGE("ScriptEngine::createStartupSnapshot failed to run %s\n", path.c_str());
+                        success = false;
+                        break;
+                    }
+                }
+                creator.SetDefaultContext(context);
+            }
+            // the blob is created even on failure, the creator must not be destroyed without
+            blob = creator.CreateBlob(v8::SnapshotCreator::FunctionCodeHandling::kKeep);
+        }
+
+        if (success && (!blob.data || blob.raw_size <= 0))
+        {
+            SE_LOGE("ScriptEngine::createStartupSnapshot failed to create the blob\n");
+            success = false;
+        }
+
+        if (success)
+        {
+            StartupSnapshotHeader header;
+            header.magic = STARTUP_SNAPSHOT_MAGIC;
+            header.versionTag = v8::ScriptCompiler::CachedDataVersionTag();
+
+            const size_t size = sizeof(header) + blob.raw_size;
+            auto* bytes = static_cast<unsigned char*>(malloc(size));
+            memcpy(bytes, &header, sizeof(header));
+            memcpy(bytes + sizeof(header), blob.data, blob.raw_size);
+            cc::Data data;
+            data.fastSet(bytes, size);
+
+            success = cc::FileUtils::getInstance()->writeDataToFile(data, outputPath);
+            if (!success)
+                SE_LOGE("ScriptEngine::createStartupSnapshot failed to write %s\n", outputPath.c_str());
+        }
+        delete[] blob.data;
         return success;
     }
 
+    bool ScriptEngine::readCodeCache(const std::string& cachePath, uint64_t sourceHash, ssize_t length, cc::Data* data)
+    {
+        auto fu = cc::FileUtils::getInstance();
+        if (!fu->isFileExist(cachePath) || fu->getContents(cachePath, data) != cc::FileUtils::Status::OK || data->getSize() <= (ssize_t)sizeof(CodeCacheHeader))
+            return false;
+
+        CodeCacheHeader header;
+        memcpy(&header, data->getBytes(), sizeof(header));
+        return header.magic == CODE_CACHE_MAGIC
+            && header.versionTag == v8::ScriptCompiler::CachedDataVersionTag()
+            && header.sourceHash == sourceHash
+            && header.sourceLength == static_cast<uint64_t>(length);
+    }
+
+    void ScriptEngine::saveCodeCache(v8::Local<v8::UnboundScript> unboundScript, const std::string& cachePath, uint64_t sourceHash, ssize_t length)
+    {
+        std::unique_ptr<v8::ScriptCompiler::CachedData> cachedData(v8::ScriptCompiler::CreateCodeCache(unboundScript));
+        if (!cachedData || cachedData->length <= 0)
+            return;
+
+        CodeCacheHeader header;
+        header.magic = CODE_CACHE_MAGIC;
+        header.versionTag = v8::ScriptCompiler::CachedDataVersionTag();
+        header.sourceHash = sourceHash;
+        header.sourceLength = static_cast<uint64_t>(length);
+
+        const size_t size = sizeof(header) + cachedData->length;
+        auto* bytes = static_cast<unsigned char*>(malloc(size));
+        memcpy(bytes, &header, sizeof(header));
+        memcpy(bytes + sizeof(header), cachedData->data, cachedData->length);
+        cc::Data data;
+        data.fastSet(bytes, size);
+
+        auto fu = cc::FileUtils::getInstance();
+        const std::string dir = cachePath.substr(0, cachePath.rfind('/') + 1);
+        if ((!fu->isDirectoryExist(dir) && !fu->createDirectory(dir)) || !fu->writeDataToFile(data, cachePath))
+            SE_LOGE("ScriptEngine::saveCodeCache failed to write %s\n", cachePath.c_str());
+    }
+
     std::string ScriptEngine::getCurrentStackTrace()
     {
         if (!_isValid)
@@ -958,15 +1228,20 @@ namespace se {
             return runByteCodeFile(path, ret);
         }
 
-        std::string scriptBuffer = _fileOperationDelegate.onGetStringFromFile(path);
-
-        if (!scriptBuffer.empty())
-        {
-            return evalString(scriptBuffer.c_str(), scriptBuffer.length(), ret, path.c_str());
-        }
+        // the script is compiled straight from the buffer of the delegate
+        bool isEmpty = true;
+        bool succeeded = false;
+        _fileOperationDelegate.onGetDataFromFile(path, [&](const uint8_t* data, size_t dataLen) {
+            if (data && dataLen)
+            {
+                isEmpty = false;
+                succeeded = evalString(reinterpret_cast<const char*>(data), dataLen, ret, path.c_str(), true);
+            }
+        });
 
-        SE_LOGE("ScriptEngine::runScript script %s, buffer is empty!\n", path.c_str());
-        return false;
+        if (isEmpty)
+            SE_LOGE("ScriptEngine::runScript script %s, buffer is empty!\n", path.c_str());
+        return succeeded;
     }
 
     void ScriptEngine::clearException()
@@ -1003,9 +1278,49 @@ namespace se {
 
     void ScriptEngine::mainLoopUpdate()
     {
+        CC_PROFILE_ZONE("ScriptEngine::mainLoopUpdate");
         // empty implementation
     }
 
+    void ScriptEngine::performIdleTasks(double idleTimeInSeconds)
+    {
+        // shorter idle times would be eaten up by the notification itself
+        const double kMinIdleTimeInSeconds = 0.001;
+        if (!_isValid || _isInCleanup || idleTimeInSeconds < kMinIdleTimeInSeconds)
+            return;
+
+        CC_PROFILE_ZONE("ScriptEngine::performIdleTasks");
+        _isolate->IdleNotificationDeadline(_platform->MonotonicallyIncreasingTime() + idleTimeInSeconds);
+    }
+
+    void ScriptEngine::setHeapLimits(size_t maxOldGenerationBytes, size_t maxYoungGenerationBytes)
+    {
+        _maxOldGenerationBytes = maxOldGenerationBytes;
+        _maxYoungGenerationBytes = maxYoungGenerationBytes;
+    }
+
+    void ScriptEngine::onGCPrologueCallback(v8::Isolate* isolate, v8::GCType type, v8::GCCallbackFlags flags)
+    {
+        ScriptEngine* thiz = getInstance();
+        thiz->_gcStartTime = thiz->_platform->MonotonicallyIncreasingTime();
+    }
+
+    void ScriptEngine::onGCEpilogueCallback(v8::Isolate* isolate, v8::GCType type, v8::GCCallbackFlags flags)
+    {
+        ScriptEngine* thiz = getInstance();
+        const double pause = (thiz->_platform->MonotonicallyIncreasingTime() - thiz->_gcStartTime) * 1000.0;
+
+        GCStats& stats = thiz->_gcStats;
+        ++stats.count;
+        if (type == v8::kGCTypeMarkSweepCompact)
+            ++stats.majorCount;
+        stats.lastPause = pause;
+        stats.maxPause = std::max(stats.maxPause, pause);
+        stats.totalPause += pause;
+
+        cc::SpikeDetector::recordEvent(type == v8::kGCTypeMarkSweepCompact ? cc::SpikeEventType::MAJOR_GC : cc::SpikeEventType::MINOR_GC, static_cast<float>(pause));
+    }
+
 } // namespace se {
 
 #endif // #if SCRIPT_ENGINE_TYPE == SCRIPT_ENGINE_V8
@@ -33,6 +33,10 @@
 
 #include <thread>
 
+namespace cc {
+    class Data;
+}
+
 #if SE_ENABLE_INSPECTOR
 namespace node {
     namespace inspector {
@@ -170,6 +174,31 @@ namespace se {
          */
         bool saveByteCodeToFile(const std::string& scriptPath, const std::string& outputPath);
 
+        /**
+         *  @brief Sets the startup snapshot the context is deserialized from by the next init, pass an empty path to create the context from scratch.
+         *  @param[in] path The path of a snapshot written by createStartupSnapshot with the same engine.
+         *  @note A snapshot created by another version or with other flags of the engine is ignored.
+         */
+        void setStartupSnapshot(const std::string& path) { _startupSnapshotPath = path; }
+        const std::string& getStartupSnapshot() const { return _startupSnapshotPath; }
+
+        /**
+         *  @brief Runs scripts in a fresh context and saves the initialized context as a startup snapshot.
+         *  @param[in] scriptPaths The scripts to run, in order. They must be plain JavaScript, functions and objects of the native bindings
+         *             don't exist in the snapshot context and the native bindings are still registered on top of the deserialized context.
+         *  @param[in] outputPath The location where the snapshot should be written to.
+         *  @return true if succeed, otherwise false.
+         */
+        bool createStartupSnapshot(const std::vector<std::string>& scriptPaths, const std::string& outputPath);
+
+        /**
+         *  @brief Enables the code cache of the scripts run from files, enabled by default.
+         *  @note The cache of a script is written to the writable path after its first successful run and consumed on later launches,
+         *        as long as neither the script nor the version of the engine changed.
+         */
+        void setCodeCacheEnabled(bool enabled) { _isCodeCacheEnabled = enabled; }
+        bool isCodeCacheEnabled() const { return _isCodeCacheEnabled; }
+
         /**
          * @brief Grab a snapshot of the current JavaScript execution stack.
          * @return current stack trace string
@@ -239,6 +268,35 @@ namespace se {
          */
         void garbageCollect();
 
+        /**
+         *  @brief Lets V8 spend the idle time left in a frame on incremental garbage collection work.
+         *  @param[in] idleTimeInSeconds The time until the next frame is due, too short a time is skipped.
+         */
+        void performIdleTasks(double idleTimeInSeconds);
+
+        /**
+         *  @brief Sets the limits of the JavaScript heap, taking effect from the next init.
+         *  @param[in] maxOldGenerationBytes The limit of the old generation, 0 keeps the default of V8.
+         *  @param[in] maxYoungGenerationBytes The limit of the young generation, 0 keeps the default of V8.
+         */
+        void setHeapLimits(size_t maxOldGenerationBytes, size_t maxYoungGenerationBytes);
+
+        // Pauses of the garbage collections since init or the last reset, in milliseconds.
+        struct GCStats
+        {
+            uint32_t count = 0;
+            uint32_t majorCount = 0; // mark-compact collections
+            double lastPause = 0;
+            double maxPause = 0;
+            double totalPause = 0;
+        };
+
+        /**
+         *  @brief Gets the pause statistics of the garbage collections, to correlate them with frame hitches.
+         */
+        const GCStats& getGCStats() const { return _gcStats; }
+        void resetGCStats() { _gcStats = GCStats(); }
+
         /**
          *  @brief Tests whether script engine is being cleaned up.
          *  @return true if it's in cleaning up, otherwise false.
@@ -315,6 +373,8 @@ namespace se {
         static void onOOMErrorCallback(const char* location, bool is_heap_oom);
         static void onMessageCallback(v8::Local<v8::Message> message, v8::Local<v8::Value> data);
         static void onPromiseRejectCallback(v8::PromiseRejectMessage msg);
+        static void onGCPrologueCallback(v8::Isolate* isolate, v8::GCType type, v8::GCCallbackFlags flags);
+        static void onGCEpilogueCallback(v8::Isolate* isolate, v8::GCType type, v8::GCCallbackFlags flags);
 
 
         /**
@@ -326,6 +386,11 @@ namespace se {
         bool runByteCodeFile(const std::string &path_bc, Value* ret/* = nullptr */);
         void callExceptionCallback(const char*, const char*, const char*);
 
+        bool loadStartupSnapshot();
+        bool evalString(const char* scriptStr, ssize_t length, Value* rval, const char* fileName, bool useCodeCache);
+        bool readCodeCache(const std::string& cachePath, uint64_t sourceHash, ssize_t length, cc::Data* data);
+        void saveCodeCache(v8::Local<v8::UnboundScript> unboundScript, const std::string& cachePath, uint64_t sourceHash, ssize_t length);
+
         std::chrono::steady_clock::time_point _startTime;
         std::vector<RegisterCallback> _registerCallbackArray;
         std::vector<std::function<void()>> _beforeInitHookArray;
@@ -335,6 +400,10 @@ namespace se {
 
         v8::Persistent<v8::Context> _context;
 
+        std::string _startupSnapshotPath;
+        std::vector<char> _startupSnapshotData;
+        v8::StartupData _startupSnapshot = {nullptr, 0};
+
         v8::Platform* _platform;
         v8::Isolate* _isolate;
         v8::HandleScope* _handleScope;
@@ -363,6 +432,13 @@ namespace se {
         bool _isGarbageCollecting;
         bool _isInCleanup;
         bool _isErrorHandleWorking;
+        bool _isCodeCacheEnabled = true;
+
+        uint32_t _memoryPressureHandlerID = 0;
+        size_t _maxOldGenerationBytes = 0;
+        size_t _maxYoungGenerationBytes = 0;
+        double _gcStartTime = 0;
+        GCStats _gcStats;
     };
 
 } // namespace se {
@@ -40,9 +40,9 @@ namespace se {
             v8::Isolate* isolate = v8args.GetIsolate();
             for (int i = 0; i < v8args.Length(); i++)
             {
-                Value v;
-                jsToSeValue(isolate, v8args[i], &v);
-                outArr->push_back(v);
+                // converted in place, without the copy retaining the object once more
+                outArr->emplace_back();
+                jsToSeValue(isolate, v8args[i], &outArr->back());
             }
         }
 
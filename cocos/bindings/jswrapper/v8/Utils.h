@@ -55,6 +55,16 @@ namespace se {
         void* getPrivate(v8::Isolate* isolate, v8::Local<v8::Value> value);
         void clearPrivate(v8::Isolate* isolate, ObjectWrap& wrap);
 
+#if SE_ENABLE_FAST_API_CALLS
+        // The native object of a fast call receiver. Pure JS subclasses keep it in a property the fast path can't
+        // look up, they get nullptr and take the fallback.
+        template <typename T>
+        inline T* getFastCallPrivate(v8::Local<v8::Object> receiver)
+        {
+            return receiver->InternalFieldCount() > 0 ? static_cast<T*>(ObjectWrap::unwrap(receiver)) : nullptr;
+        }
+#endif
+
     } // namespace internal {
 } // namespace se {
 
@@ -0,0 +1,327 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "Worker.h"
+
+#if SCRIPT_ENGINE_TYPE == SCRIPT_ENGINE_V8
+
+#include "platform/FileUtils.h"
+
+namespace se {
+
+    namespace {
+
+        // Shared by the isolates of all workers. Backing stores moved between isolates keep the allocator
+        // they come from, so it has to outlive every worker.
+        std::shared_ptr<v8::ArrayBuffer::Allocator> getWorkerAllocator()
+        {
+            static std::shared_ptr<v8::ArrayBuffer::Allocator> allocator(v8::ArrayBuffer::Allocator::NewDefaultAllocator());
+            return allocator;
+        }
+
+        v8::Local<v8::String> newString(v8::Isolate* isolate, const char* str, int length = -1)
+        {
+            return v8::String::NewFromUtf8(isolate, str, v8::NewStringType::kNormal, length).ToLocalChecked();
+        }
+
+        Worker* getWorker(const v8::FunctionCallbackInfo<v8::Value>& info)
+        {
+            return static_cast<Worker*>(info.Data().As<v8::External>()->Value());
+        }
+
+        // FileUtils caches the resolved paths, resolving on the worker thread would race with the engine
+        std::string resolveWorkerPath(const std::string& basePath, const std::string& path)
+        {
+            if (cc::FileUtils::getInstance()->isAbsolutePath(path))
+                return path;
+            const size_t pos = basePath.find_last_of("/\\");
+            return pos == std::string::npos ? path : basePath.substr(0, pos + 1) + path;
+        }
+
+    } // namespace
+
+    Worker::Worker(const std::string& path)
+    : _path(cc::FileUtils::getInstance()->fullPathForFilename(path))
+    {
+        _thread = std::thread(&Worker::run, this);
+    }
+
+    Worker::~Worker()
+    {
+        terminate();
+        if (_thread.joinable())
+            _thread.join();
+    }
+
+    void Worker::postMessage(Message&& message)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_isRunning)
+            return;
+        _inbox.push_back(std::move(message));
+        _condition.notify_one();
+    }
+
+    bool Worker::takeMessage(Message* message)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_outbox.empty())
+            return false;
+        *message = std::move(_outbox.front());
+        _outbox.pop_front();
+        return true;
+    }
+
+    void Worker::terminate()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isTerminated = true;
+        _isRunning = false;
+        _inbox.clear();
+        _outbox.clear();
+        if (_isolate != nullptr)
+            _isolate->TerminateExecution();
+        _condition.notify_one();
+    }
+
+    void Worker::postToMain(Message&& message)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_isTerminated)
+            _outbox.push_back(std::move(message));
+    }
+
+    bool Worker::toMessage(v8::Isolate* isolate, v8::Local<v8::Value> value, Message* message)
+    {
+        v8::Local<v8::Context> context = isolate->GetCurrentContext();
+        if (value->IsString())
+        {
+            message->type = Message::Type::STRING;
+            message->text = *v8::String::Utf8Value(isolate, value);
+            return true;
+        }
+        if (value->IsArrayBuffer())
+        {
+            v8::Local<v8::ArrayBuffer> arrayBuffer = value.As<v8::ArrayBuffer>();
+            if (!arrayBuffer->IsDetachable())
+                return false;
+            message->type = Message::Type::ARRAY_BUFFER;
+            message->buffer = arrayBuffer->GetBackingStore();
+            arrayBuffer->Detach();
+            return true;
+        }
+        if (value->IsArrayBufferView())
+        {
+            v8::Local<v8::ArrayBufferView> view = value.As<v8::ArrayBufferView>();
+            std::unique_ptr<v8::BackingStore> copy = v8::ArrayBuffer::NewBackingStore(isolate, view->ByteLength());
+            view->CopyContents(copy->Data(), copy->ByteLength());
+            message->type = Message::Type::ARRAY_BUFFER;
+            message->buffer = std::move(copy);
+            return true;
+        }
+
+        v8::Local<v8::String> json;
+        if (!v8::JSON::Stringify(context, value).ToLocal(&json))
+            return false;
+        message->type = Message::Type::JSON;
+        message->text = *v8::String::Utf8Value(isolate, json);
+        return true;
+    }
+
+    v8::MaybeLocal<v8::Value> Worker::fromMessage(v8::Isolate* isolate, Message& message)
+    {
+        switch (message.type)
+        {
+            case Message::Type::ARRAY_BUFFER:
+                return v8::ArrayBuffer::New(isolate, std::move(message.buffer));
+            case Message::Type::JSON:
+                return v8::JSON::Parse(isolate->GetCurrentContext(), newString(isolate, message.text.c_str(), (int)message.text.length()));
+            default:
+                return newString(isolate, message.text.c_str(), (int)message.text.length());
+        }
+    }
+
+    void Worker::onPostMessage(const v8::FunctionCallbackInfo<v8::Value>& info)
+    {
+        v8::Isolate* isolate = info.GetIsolate();
+        Message message;
+        if (info.Length() < 1 || !toMessage(isolate, info[0], &message))
+        {
+            if (!isolate->IsExecutionTerminating())
+                isolate->ThrowException(v8::Exception::TypeError(newString(isolate, "postMessage: the value can't be passed to the engine")));
+            return;
+        }
+        getWorker(info)->postToMain(std::move(message));
+    }
+
+    void Worker::onClose(const v8::FunctionCallbackInfo<v8::Value>& info)
+    {
+        // the script runs to its end, no message is dispatched afterwards
+        getWorker(info)->_isRunning = false;
+    }
+
+    void Worker::onImportScripts(const v8::FunctionCallbackInfo<v8::Value>& info)
+    {
+        Worker* worker = getWorker(info);
+        for (int i = 0; i < info.Length(); ++i)
+        {
+            const std::string path = resolveWorkerPath(worker->_path, *v8::String::Utf8Value(info.GetIsolate(), info[i]));
+            // an exception thrown by the script is passed on to the caller
+            if (!worker->runScript(info.GetIsolate(), path))
+                return;
+        }
+    }
+
+    void Worker::onLog(const v8::FunctionCallbackInfo<v8::Value>& info)
+    {
+        std::string text;
+        for (int i = 0; i < info.Length(); ++i)
+        {
+            if (i > 0)
+                text += " ";
+            text += *v8::String::Utf8Value(info.GetIsolate(), info[i]);
+        }
+        SE_LOGD("[Worker] %s\n", text.c_str());
+    }
+
+    bool Worker::runScript(v8::Isolate* isolate, const std::string& path)
+    {
+        const std::string source = cc::FileUtils::getInstance()->getStringFromFile(path);
+        if (source.empty())
+        {
+            const std::string error = "Worker: can't read " + path;
+            isolate->ThrowException(v8::Exception::Error(newString(isolate, error.c_str())));
+            return false;
+        }
+
+        v8::Local<v8::Context> context = isolate->GetCurrentContext();
+        v8::ScriptOrigin origin(newString(isolate, path.c_str()));
+        v8::Local<v8::Script> script;
+        if (!v8::Script::Compile(context, newString(isolate, source.c_str(), (int)source.length()), &origin).ToLocal(&script))
+            return false;
+        return !script->Run(context).IsEmpty();
+    }
+
+    void Worker::reportException(v8::Isolate* isolate, const v8::TryCatch& tryCatch)
+    {
+        if (!tryCatch.HasCaught() || tryCatch.HasTerminated())
+            return;
+
+        v8::Local<v8::Context> context = isolate->GetCurrentContext();
+        Message message;
+        message.type = Message::Type::EXCEPTION;
+        message.text = *v8::String::Utf8Value(isolate, tryCatch.Exception());
+        v8::Local<v8::Value> stack;
+        if (tryCatch.StackTrace(context).ToLocal(&stack) && stack->IsString())
+            message.text = *v8::String::Utf8Value(isolate, stack);
+        SE_LOGE("[Worker] %s: %s\n", _path.c_str(), message.text.c_str());
+        postToMain(std::move(message));
+    }
+
+    void Worker::dispatchMessage(v8::Isolate* isolate, Message& message)
+    {
+        v8::Local<v8::Context> context = isolate->GetCurrentContext();
+        v8::TryCatch tryCatch(isolate);
+
+        v8::Local<v8::Value> onMessage;
+        if (!context->Global()->Get(context, newString(isolate, "onmessage")).ToLocal(&onMessage) || !onMessage->IsFunction())
+            return;
+
+        v8::Local<v8::Value> data;
+        if (!fromMessage(isolate, message).ToLocal(&data))
+        {
+            reportException(isolate, tryCatch);
+            return;
+        }
+        v8::Local<v8::Object> event = v8::Object::New(isolate);
+        event->Set(context, newString(isolate, "data"), data).Check();
+
+        v8::Local<v8::Value> argv[] = {event};
+        if (onMessage.As<v8::Function>()->Call(context, context->Global(), 1, argv).IsEmpty())
+            reportException(isolate, tryCatch);
+    }
+
+    void Worker::run()
+    {
+        v8::Isolate::CreateParams createParams;
+        createParams.array_buffer_allocator_shared = getWorkerAllocator();
+        v8::Isolate* isolate = v8::Isolate::New(createParams);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _isolate = isolate;
+            if (_isTerminated)
+                isolate->TerminateExecution();
+        }
+
+        {
+            v8::Isolate::Scope isolateScope(isolate);
+            v8::HandleScope handleScope(isolate);
+
+            v8::Local<v8::External> self = v8::External::New(isolate, this);
+            v8::Local<v8::ObjectTemplate> globalTemplate = v8::ObjectTemplate::New(isolate);
+            globalTemplate->Set(newString(isolate, "postMessage"), v8::FunctionTemplate::New(isolate, onPostMessage, self));
+            globalTemplate->Set(newString(isolate, "close"), v8::FunctionTemplate::New(isolate, onClose, self));
+            globalTemplate->Set(newString(isolate, "importScripts"), v8::FunctionTemplate::New(isolate, onImportScripts, self));
+            v8::Local<v8::ObjectTemplate> consoleTemplate = v8::ObjectTemplate::New(isolate);
+            consoleTemplate->Set(newString(isolate, "log"), v8::FunctionTemplate::New(isolate, onLog, self));
+            globalTemplate->Set(newString(isolate, "console"), consoleTemplate);
+
+            v8::Local<v8::Context> context = v8::Context::New(isolate, nullptr, globalTemplate);
+            v8::Context::Scope contextScope(context);
+            context->Global()->Set(context, newString(isolate, "self"), context->Global()).Check();
+
+            {
+                v8::TryCatch tryCatch(isolate);
+                if (!runScript(isolate, _path))
+                    reportException(isolate, tryCatch);
+            }
+
+            while (_isRunning)
+            {
+                Message message;
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _condition.wait(lock, [this]() { return _isTerminated || !_isRunning || !_inbox.empty(); });
+                    if (_isTerminated || !_isRunning)
+                        break;
+                    message = std::move(_inbox.front());
+                    _inbox.pop_front();
+                }
+
+                v8::HandleScope messageScope(isolate);
+                dispatchMessage(isolate, message);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _isolate = nullptr;
+            _isRunning = false;
+            _inbox.clear();
+        }
+        isolate->Dispose();
+    }
+
+} // namespace se {
+
+#endif // #if SCRIPT_ENGINE_TYPE == SCRIPT_ENGINE_V8
@@ -0,0 +1,132 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#pragma once
+
+#include "../config.h"
+
+#if SCRIPT_ENGINE_TYPE == SCRIPT_ENGINE_V8
+
+#include "Base.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace se {
+
+    /**
+     * A script run on a thread of its own, in an isolate sharing nothing with the one of ScriptEngine.
+     * Its global scope only offers postMessage, close, importScripts and console.log, no engine bindings.
+     * Messages are strings, ArrayBuffers, and anything else JSON can represent. An ArrayBuffer is moved to
+     * the receiver without a copy, it is detached in the sender, typed arrays pass a copy of their bytes.
+     */
+    class Worker final
+    {
+    public:
+        struct Message
+        {
+            enum class Type
+            {
+                STRING,
+                JSON,
+                ARRAY_BUFFER,
+                EXCEPTION, // thrown in the worker, text holds its description
+            };
+
+            Type type = Type::STRING;
+            std::string text;
+            std::shared_ptr<v8::BackingStore> buffer;
+        };
+
+        /**
+         *  @brief Starts running the script at the path on a new thread.
+         */
+        explicit Worker(const std::string& path);
+        /**
+         *  @brief Terminates the worker, waiting for its thread to exit.
+         */
+        ~Worker();
+
+        /**
+         *  @brief Queues a message for the onmessage handler of the worker.
+         */
+        void postMessage(Message&& message);
+
+        /**
+         *  @brief Takes the oldest message posted by the worker, never blocks.
+         *  @return false if there is no message.
+         */
+        bool takeMessage(Message* message);
+
+        /**
+         *  @brief Stops the worker, the running script is interrupted and the pending messages are dropped.
+         */
+        void terminate();
+
+        /**
+         *  @brief Tests whether the worker can still receive messages, false once it closed or was terminated.
+         */
+        bool isRunning() const { return _isRunning; }
+
+        /**
+         *  @brief Converts a value of an isolate into a message, detaching ArrayBuffers.
+         *  @return false if the value can't be passed.
+         */
+        static bool toMessage(v8::Isolate* isolate, v8::Local<v8::Value> value, Message* message);
+        /**
+         *  @brief Converts a message into a value of an isolate, ArrayBuffers take over the backing store.
+         */
+        static v8::MaybeLocal<v8::Value> fromMessage(v8::Isolate* isolate, Message& message);
+
+    private:
+        static void onPostMessage(const v8::FunctionCallbackInfo<v8::Value>& info);
+        static void onClose(const v8::FunctionCallbackInfo<v8::Value>& info);
+        static void onImportScripts(const v8::FunctionCallbackInfo<v8::Value>& info);
+        static void onLog(const v8::FunctionCallbackInfo<v8::Value>& info);
+
+        void run();
+        bool runScript(v8::Isolate* isolate, const std::string& path);
+        void reportException(v8::Isolate* isolate, const v8::TryCatch& tryCatch);
+        void dispatchMessage(v8::Isolate* isolate, Message& message);
+        void postToMain(Message&& message);
+
+        std::string _path; // full path, resolved on the thread of ScriptEngine
+        std::thread _thread;
+
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        std::deque<Message> _inbox;  // messages to the worker
+        std::deque<Message> _outbox; // messages of the worker
+        v8::Isolate* _isolate = nullptr;
+
+        std::atomic<bool> _isRunning{true};
+        bool _isTerminated = false;
+    };
+
+} // namespace se {
+
+#endif // #if SCRIPT_ENGINE_TYPE == SCRIPT_ENGINE_V8
@@ -41,6 +41,9 @@
 #define ORG_JAVABRIDGE_CLASS_NAME com_cocos_lib_CocosJavascriptJavaBridge
 #endif
 #define JNI_JSJAVABRIDGE(FUNC) JNI_METHOD1(ORG_JAVABRIDGE_CLASS_NAME,FUNC)
+#ifndef JCLS_JAVABRIDGE
+#define JCLS_JAVABRIDGE "com/cocos/lib/CocosJavascriptJavaBridge"
+#endif
 
 extern "C" {
 
@@ -88,7 +91,8 @@ public:
         BOOLEAN,
         STRING,
         VECTOR,
-        FUNCTION
+        FUNCTION,
+        BYTE_BUFFER
     };
 
     typedef std::vector<ValueType> ValueTypes;
@@ -187,6 +191,10 @@ JavaScriptJavaBridge::CallInfo::~CallInfo()
     {
         delete m_ret.stringValue;
     }
+    if (m_env && m_classID)
+    {
+        m_env->DeleteLocalRef(m_classID);
+    }
 }
 
 bool JavaScriptJavaBridge::CallInfo::execute()
@@ -358,6 +366,11 @@ JavaScriptJavaBridge::ValueType JavaScriptJavaBridge::CallInfo::checkType(const
                 *pos = pos2;
                 return ValueType::VECTOR;
             }
+            else if (t.compare("Ljava/nio/ByteBuffer;") == 0)
+            {
+                *pos = pos2;
+                return ValueType::BYTE_BUFFER;
+            }
             else
             {
                 m_error = JSJ_ERR_TYPE_NOT_SUPPORT;
@@ -396,24 +409,10 @@ bool JavaScriptJavaBridge::CallInfo::getMethodInfo()
             m_error = JSJ_ERR_VM_FAILURE;
             return false;
     }
-    jstring _jstrClassName = m_env->NewStringUTF(m_className.c_str());
-    m_classID = (jclass) m_env->CallObjectMethod(cc::JniHelper::classloader,
-                                                 cc::JniHelper::loadclassMethod_methodID,
-                                                 _jstrClassName);
-
-    if (NULL == m_classID) {
-        SE_LOGD("Classloader failed to find class of %s", m_className.c_str());
-        m_env->DeleteLocalRef(_jstrClassName);
-        m_env->ExceptionClear();
-        m_error = JSJ_ERR_CLASS_NOT_FOUND;
-        return false;
-    }
-
-    m_env->DeleteLocalRef(_jstrClassName);
-    m_methodID = m_env->GetStaticMethodID(m_classID, m_methodName.c_str(), m_methodSig.c_str());
-    if (!m_methodID)
+    // the class and the method are looked up once and cached by JniHelper
+    cc::JniMethodInfo methodInfo;
+    if (!cc::JniHelper::getStaticMethodInfo(methodInfo, m_className.c_str(), m_methodName.c_str(), m_methodSig.c_str()))
     {
-        m_env->ExceptionClear();
         SE_LOGD("Failed to find method id of %s.%s %s",
              m_className.c_str(),
              m_methodName.c_str(),
@@ -421,6 +420,8 @@ bool JavaScriptJavaBridge::CallInfo::getMethodInfo()
         m_error = JSJ_ERR_METHOD_NOT_FOUND;
         return false;
     }
+    m_classID = methodInfo.classID;
+    m_methodID = methodInfo.methodID;
 
     return true;
 }
@@ -573,6 +574,26 @@ static bool JavaScriptJavaBridge_callStaticMethod(se::State& s)
 
                         break;
                     }
+                    case JavaScriptJavaBridge::ValueType::BYTE_BUFFER:
+                    {
+                        // a direct buffer over the memory of an ArrayBuffer or a typed array, valid during the call
+                        const auto &arg = args[index];
+                        jargs[i].l = nullptr;
+                        if (arg.isObject())
+                        {
+                            uint8_t *data = nullptr;
+                            size_t length = 0;
+                            se::Object *obj = arg.toObject();
+                            bool hasData = obj->isTypedArray() ? obj->getTypedArrayData(&data, &length)
+                                                               : obj->isArrayBuffer() && obj->getArrayBufferData(&data, &length);
+                            if (hasData && data)
+                            {
+                                jargs[i].l = call.getEnv()->NewDirectByteBuffer(data, static_cast<jlong>(length));
+                                toReleaseObjects.push_back(jargs[i].l);
+                            }
+                        }
+                        break;
+                    }
                     default:
                         SE_REPORT_ERROR("Unsupport type of parameter %d", i);
                         break;
@@ -603,12 +624,77 @@ static bool JavaScriptJavaBridge_callStaticMethod(se::State& s)
 }
 SE_BIND_FUNC(JavaScriptJavaBridge_callStaticMethod)
 
+// callStaticMethodBatch([className, methodName, argument, ...]) calls every static void method(String) in the one
+// transition of CocosJavascriptJavaBridge.dispatchBatch(), for the messages of analytics and ads SDKs that don't
+// return anything. Returns how many of the methods were called.
+static bool JavaScriptJavaBridge_callStaticMethodBatch(se::State& s)
+{
+    const auto& args = s.args();
+    if (args.size() != 1 || !args[0].isObject() || !args[0].toObject()->isArray())
+    {
+        SE_REPORT_ERROR("wrong arguments, was expecting an array of class name, method name and argument triples");
+        return false;
+    }
+
+    se::Object *messages = args[0].toObject();
+    uint32_t length = 0;
+    messages->getArrayLength(&length);
+    if (length % 3 != 0)
+    {
+        SE_REPORT_ERROR("the length of the batch %u isn't a multiple of 3", length);
+        return false;
+    }
+    if (!length)
+    {
+        s.rval().setInt32(0);
+        return true;
+    }
+
+    cc::JniMethodInfo t;
+    if (!cc::JniHelper::getStaticMethodInfo(t, JCLS_JAVABRIDGE, "dispatchBatch", "([Ljava/lang/String;)I"))
+    {
+        SE_REPORT_ERROR("CocosJavascriptJavaBridge.dispatchBatch isn't found");
+        return false;
+    }
+
+    static jclass stringClass = (jclass)t.env->NewGlobalRef(t.env->FindClass("java/lang/String"));
+    jobjectArray array = t.env->NewObjectArray(static_cast<jsize>(length), stringClass, nullptr);
+    se::Value message;
+    std::string str;
+    for (uint32_t i = 0; i < length; ++i)
+    {
+        messages->getArrayElement(i, &message);
+        if (message.isNullOrUndefined())
+            continue;
+        seval_to_std_string(message, &str);
+        // deleted a string at a time, a batch may hold more of them than the local reference table
+        jstring jstr = cc::StringUtils::newStringUTFJNI(t.env, str);
+        t.env->SetObjectArrayElement(array, static_cast<jsize>(i), jstr);
+        t.env->DeleteLocalRef(jstr);
+    }
+
+    jint called = t.env->CallStaticIntMethod(t.classID, t.methodID, array);
+    if (t.env->ExceptionCheck() == JNI_TRUE)
+    {
+        t.env->ExceptionDescribe();
+        t.env->ExceptionClear();
+        called = 0;
+    }
+    t.env->DeleteLocalRef(array);
+    t.env->DeleteLocalRef(t.classID);
+
+    s.rval().setInt32(called);
+    return true;
+}
+SE_BIND_FUNC(JavaScriptJavaBridge_callStaticMethodBatch)
+
 bool register_javascript_java_bridge(se::Object* obj)
 {
     se::Class* cls = se::Class::create("JavascriptJavaBridge", obj, nullptr, _SE(JavaScriptJavaBridge_constructor));
     cls->defineFinalizeFunction(_SE(JavaScriptJavaBridge_finalize));
 
     cls->defineFunction("callStaticMethod", _SE(JavaScriptJavaBridge_callStaticMethod));
+    cls->defineFunction("callStaticMethodBatch", _SE(JavaScriptJavaBridge_callStaticMethodBatch));
 
     cls->install();
     __jsb_JavaScriptJavaBridge_class = cls;
@@ -31,6 +31,7 @@
 #include "cocos/bindings/auto/jsb_cocos_auto.h"
 
 #include "storage/local-storage/LocalStorage.h"
+#include "base/Profiler.h"
 #include "cocos2d.h"
 
 using namespace cc;
@@ -332,8 +333,13 @@ static bool register_sys_localStorage(se::Object *obj) {
     localStorageObj->defineProperty("length", _SE(JSB_localStorage_getLength), nullptr);
 
     std::string strFilePath = cc::FileUtils::getInstance()->getWritablePath();
+#if CC_USE_LOCAL_STORAGE_LOG
+    strFilePath += "/jsb.kv";
+    localStorageInit(strFilePath, LocalStorageEngine::LOG);
+#else
     strFilePath += "/jsb.sqlite";
     localStorageInit(strFilePath);
+#endif
 
     se::ScriptEngine::getInstance()->addBeforeCleanupHook([]() {
         localStorageFree();
@@ -687,6 +693,70 @@ static bool register_filetuils_ext(se::Object *obj) {
     return true;
 }
 
+static bool js_profiler_beginCapture(se::State &s) {
+    cc::Profiler::beginCapture();
+    return true;
+}
+SE_BIND_FUNC(js_profiler_beginCapture)
+
+static bool js_profiler_endCapture(se::State &s) {
+    cc::Profiler::endCapture();
+    return true;
+}
+SE_BIND_FUNC(js_profiler_endCapture)
+
+static bool js_profiler_getChromeTrace(se::State &s) {
+    s.rval().setString(cc::Profiler::getChromeTrace());
+    return true;
+}
+SE_BIND_FUNC(js_profiler_getChromeTrace)
+
+static bool js_profiler_saveChromeTrace(se::State &s) {
+    const auto &args = s.args();
+    if (args.size() != 1 || !args[0].isString()) {
+        SE_REPORT_ERROR("saveChromeTrace: expected a path, got %d arguments", (int)args.size());
+        return false;
+    }
+    s.rval().setBoolean(cc::Profiler::saveChromeTrace(args[0].toString()));
+    return true;
+}
+SE_BIND_FUNC(js_profiler_saveChromeTrace)
+
+static bool js_profiler_beginZone(se::State &s) {
+    const auto &args = s.args();
+    if (args.size() != 1 || !args[0].isString()) {
+        SE_REPORT_ERROR("beginZone: expected a zone name, got %d arguments", (int)args.size());
+        return false;
+    }
+    cc::Profiler::beginZone(cc::Profiler::intern(args[0].toString()));
+    return true;
+}
+SE_BIND_FUNC(js_profiler_beginZone)
+
+static bool js_profiler_endZone(se::State &s) {
+    cc::Profiler::endZone();
+    return true;
+}
+SE_BIND_FUNC(js_profiler_endZone)
+
+static bool register_profiler(se::Object *obj) {
+    se::Value jsb;
+    if (!obj->getProperty("jsb", &jsb)) {
+        jsb.setObject(se::Object::createPlainObject());
+        obj->setProperty("jsb", jsb);
+    }
+    se::HandleObject profiler(se::Object::createPlainObject());
+    profiler->defineFunction("beginCapture", _SE(js_profiler_beginCapture));
+    profiler->defineFunction("endCapture", _SE(js_profiler_endCapture));
+    profiler->defineFunction("getChromeTrace", _SE(js_profiler_getChromeTrace));
+    profiler->defineFunction("saveChromeTrace", _SE(js_profiler_saveChromeTrace));
+    profiler->defineFunction("beginZone", _SE(js_profiler_beginZone));
+    profiler->defineFunction("endZone", _SE(js_profiler_endZone));
+    jsb.toObject()->setProperty("profiler", se::Value(profiler));
+
+    return true;
+}
+
 static bool register_se_setExceptionCallback(se::Object *obj) {
     se::Value jsb;
     if (!obj->getProperty("jsb", &jsb)) {
@@ -706,5 +776,6 @@ bool register_all_cocos_manual(se::Object *obj) {
     register_canvas_context2d(obj);
     register_filetuils_ext(obj);
     register_se_setExceptionCallback(obj);
+    register_profiler(obj);
     return true;
 }
@@ -27,6 +27,7 @@
 #include "base/TypeDef.h"
 #include "math/Math.h"
 #include "renderer/core/gfx/GFXDef.h"
+#include <cstring>
 #include <sstream>
 #include <regex>
 
@@ -210,18 +211,48 @@ bool seval_to_std_string(const se::Value &v, std::string *ret) {
     return true;
 }
 
+namespace {
+// Math types passed as Float32Array, e.g. the views of a shared buffer, are copied without a single lookup.
+bool copyFloat32Array(se::Object *obj, float *out, size_t count) {
+    if (!obj->isTypedArray() || obj->getTypedArrayType() != se::Object::TypedArrayType::FLOAT32) {
+        return false;
+    }
+    uint8_t *ptr = nullptr;
+    size_t length = 0;
+    obj->getTypedArrayData(&ptr, &length);
+    if (length < count * sizeof(float)) {
+        return false;
+    }
+    memcpy(out, ptr, count * sizeof(float));
+    return true;
+}
+
+// Reads numeric fields through property keys cached by the engine.
+bool getNumberProperties(se::Object *obj, const char *const *names, size_t count, float *out) {
+    se::Value tmp;
+    for (size_t i = 0; i < count; ++i) {
+        if (!obj->getProperty(names[i], &tmp, true) || !tmp.isNumber()) {
+            return false;
+        }
+        out[i] = tmp.toFloat();
+    }
+    return true;
+}
+
+const char *const VEC_NAMES[] = {"x", "y", "z", "w"};
+const char *const SIZE_NAMES[] = {"width", "height"};
+const char *const MAT_NAMES[] = {"m00", "m01", "m02", "m03", "m04", "m05", "m06", "m07", "m08", "m09", "m10", "m11", "m12", "m13", "m14", "m15"};
+} // namespace
+
 bool seval_to_Vec2(const se::Value &v, cc::Vec2 *pt) {
     assert(pt != nullptr);
     SE_PRECONDITION2(v.isObject(), false, "Convert parameter to Vec2 failed!");
     se::Object *obj = v.toObject();
-    se::Value x;
-    se::Value y;
-    bool ok = obj->getProperty("x", &x);
-    SE_PRECONDITION3(ok && x.isNumber(), false, *pt = cc::Vec2::ZERO);
-    ok = obj->getProperty("y", &y);
-    SE_PRECONDITION3(ok && y.isNumber(), false, *pt = cc::Vec2::ZERO);
-    pt->x = x.toFloat();
-    pt->y = y.toFloat();
+    float values[2];
+    bool ok = copyFloat32Array(obj, values, 2) || getNumberProperties(obj, VEC_NAMES, 2, values);
+    SE_PRECONDITION3(ok, false, *pt = cc::Vec2::ZERO);
+    pt->x = values[0];
+    pt->y = values[1];
     return true;
 }
 
@@ -229,55 +260,41 @@ bool seval_to_Vec3(const se::Value &v, cc::Vec3 *pt) {
     assert(pt != nullptr);
     SE_PRECONDITION2(v.isObject(), false, "Convert parameter to Vec3 failed!");
     se::Object *obj = v.toObject();
-    se::Value x;
-    se::Value y;
-    se::Value z;
-    bool ok = obj->getProperty("x", &x);
-    SE_PRECONDITION3(ok && x.isNumber(), false, *pt = cc::Vec3::ZERO);
-    ok = obj->getProperty("y", &y);
-    SE_PRECONDITION3(ok && y.isNumber(), false, *pt = cc::Vec3::ZERO);
-    ok = obj->getProperty("z", &z);
-    SE_PRECONDITION3(ok && z.isNumber(), false, *pt = cc::Vec3::ZERO);
-    pt->x = x.toFloat();
-    pt->y = y.toFloat();
-    pt->z = z.toFloat();
+    float values[3];
+    bool ok = copyFloat32Array(obj, values, 3) || getNumberProperties(obj, VEC_NAMES, 3, values);
+    SE_PRECONDITION3(ok, false, *pt = cc::Vec3::ZERO);
+    pt->x = values[0];
+    pt->y = values[1];
+    pt->z = values[2];
     return true;
 }
 
 bool seval_to_Vec4(const se::Value &v, cc::Vec4 *pt) {
     assert(pt != nullptr);
     SE_PRECONDITION2(v.isObject(), false, "Convert parameter to Vec4 failed!");
-    pt->x = pt->y = pt->z = pt->w = 0.0f;
     se::Object *obj = v.toObject();
-    se::Value x;
-    se::Value y;
-    se::Value z;
-    se::Value w;
-    bool ok = obj->getProperty("x", &x);
-    SE_PRECONDITION3(ok && x.isNumber(), false, *pt = cc::Vec4::ZERO);
-    ok = obj->getProperty("y", &y);
-    SE_PRECONDITION3(ok && y.isNumber(), false, *pt = cc::Vec4::ZERO);
-    ok = obj->getProperty("z", &z);
-    SE_PRECONDITION3(ok && z.isNumber(), false, *pt = cc::Vec4::ZERO);
-    ok = obj->getProperty("w", &w);
-    SE_PRECONDITION3(ok && w.isNumber(), false, *pt = cc::Vec4::ZERO);
-    pt->x = x.toFloat();
-    pt->y = y.toFloat();
-    pt->z = z.toFloat();
-    pt->w = w.toFloat();
+    float values[4];
+    bool ok = copyFloat32Array(obj, values, 4) || getNumberProperties(obj, VEC_NAMES, 4, values);
+    SE_PRECONDITION3(ok, false, *pt = cc::Vec4::ZERO);
+    pt->x = values[0];
+    pt->y = values[1];
+    pt->z = values[2];
+    pt->w = values[3];
     return true;
 }
 
 bool seval_to_mat(const se::Value &v, int length, float *out) {
     assert(out != nullptr);
     SE_PRECONDITION2(v.isObject(), false, "Convert parameter to Matrix failed!");
+    SE_PRECONDITION2(length >= 0 && length <= 16, false, "Convert parameter to Matrix failed!");
     se::Object *obj = v.toObject();
+    if (copyFloat32Array(obj, out, length)) {
+        return true;
+    }
 
     se::Value tmp;
-    char propName[3] = {0};
     for (int i = 0; i < length; ++i) {
-        snprintf(propName, 3, "m%2d", i);
-        obj->getProperty(propName, &tmp);
+        obj->getProperty(MAT_NAMES[i], &tmp, true);
         *(out + i) = tmp.toFloat();
     }
 
@@ -291,25 +308,12 @@ bool seval_to_Mat4(const se::Value &v, cc::Mat4 *mat) {
 
     if (obj->isTypedArray()) {
         // typed array
-        SE_PRECONDITION2(obj->isTypedArray(), false, "Convert parameter to Matrix4 failed!");
-
-        size_t length = 0;
-        uint8_t *ptr = nullptr;
-        obj->getTypedArrayData(&ptr, &length);
-
-        memcpy(mat->m, ptr, length);
+        SE_PRECONDITION3(copyFloat32Array(obj, mat->m, 16), false, *mat = cc::Mat4::IDENTITY);
     } else {
         bool ok = false;
         se::Value tmp;
-        std::string prefix = "m";
         for (uint32_t i = 0; i < 16; ++i) {
-            std::string name;
-            if (i < 10) {
-                name = prefix + "0" + std::to_string(i);
-            } else {
-                name = prefix + std::to_string(i);
-            }
-            ok = obj->getProperty(name.c_str(), &tmp);
+            ok = obj->getProperty(MAT_NAMES[i], &tmp, true);
             SE_PRECONDITION3(ok, false, *mat = cc::Mat4::IDENTITY);
 
             if (tmp.isNumber()) {
@@ -363,15 +367,11 @@ bool seval_to_Size(const se::Value &v, cc::Size *size) {
     assert(size != nullptr);
     SE_PRECONDITION2(v.isObject(), false, "Convert parameter to Size failed!");
     se::Object *obj = v.toObject();
-    se::Value width;
-    se::Value height;
-
-    bool ok = obj->getProperty("width", &width);
-    SE_PRECONDITION3(ok && width.isNumber(), false, *size = cc::Size::ZERO);
-    ok = obj->getProperty("height", &height);
-    SE_PRECONDITION3(ok && height.isNumber(), false, *size = cc::Size::ZERO);
-    size->width = width.toFloat();
-    size->height = height.toFloat();
+    float values[2];
+    bool ok = getNumberProperties(obj, SIZE_NAMES, 2, values);
+    SE_PRECONDITION3(ok, false, *size = cc::Size::ZERO);
+    size->width = values[0];
+    size->height = values[1];
     return true;
 }
 
@@ -655,10 +655,19 @@ bool seval_to_std_vector_float(const se::Value &v, std::vector<float> *ret) {
     assert(ret != nullptr);
     SE_PRECONDITION2(v.isObject(), false, "Convert parameter to vector of float failed!");
     se::Object *obj = v.toObject();
+    if (obj->isTypedArray() && obj->getTypedArrayType() == se::Object::TypedArrayType::FLOAT32) {
+        uint8_t *ptr = nullptr;
+        size_t length = 0;
+        obj->getTypedArrayData(&ptr, &length);
+        const auto *data = reinterpret_cast<const float *>(ptr);
+        ret->assign(data, data + length / sizeof(float));
+        return true;
+    }
     SE_PRECONDITION2(obj->isArray(), false, "Convert parameter to vector of float failed!");
     uint32_t len = 0;
     if (obj->getArrayLength(&len)) {
         se::Value value;
+        ret->reserve(len);
         for (uint32_t i = 0; i < len; ++i) {
             SE_PRECONDITION3(obj->getArrayElement(i, &value) && value.isNumber(), false, ret->clear());
             ret->push_back(value.toFloat());
@@ -735,7 +744,7 @@ bool seval_to_Data(const se::Value &v, cc::Data *ret) {
 }
 
 bool seval_to_DownloaderHints(const se::Value &v, cc::network::DownloaderHints *ret) {
-    static cc::network::DownloaderHints ZERO = {0, 0, ""};
+    static cc::network::DownloaderHints ZERO = {0, 0, "", 0, 0};
     assert(ret != nullptr);
     SE_PRECONDITION2(v.isObject(), false, "Convert parameter to DownloaderHints failed!");
     se::Value tmp;
@@ -754,6 +763,10 @@ bool seval_to_DownloaderHints(const se::Value &v, cc::network::DownloaderHints *
     SE_PRECONDITION3(ok && tmp.isString(), false, *ret = ZERO);
     ret->tempFileNameSuffix = tmp.toString();
 
+    // optional
+    ret->countOfMaxChunksPerTask = obj->getProperty("countOfMaxChunksPerTask", &tmp) && tmp.isNumber() ? tmp.toUint32() : 0;
+    ret->maxBytesPerSecond = obj->getProperty("maxBytesPerSecond", &tmp) && tmp.isNumber() ? tmp.toUint32() : 0;
+
     return ok;
 }
 
@@ -1204,6 +1217,36 @@ bool DownloadTask_to_seval(const cc::network::DownloadTask &v, se::Value *ret) {
 
 ////////////////// custom types
 
+template<>
+bool sevalue_to_native(const se::Value &from, cc::Vec2 *to, se::Object *)
+{
+    return seval_to_Vec2(from, to);
+}
+
+template<>
+bool sevalue_to_native(const se::Value &from, cc::Vec3 *to, se::Object *)
+{
+    return seval_to_Vec3(from, to);
+}
+
+template<>
+bool sevalue_to_native(const se::Value &from, cc::Vec4 *to, se::Object *)
+{
+    return seval_to_Vec4(from, to);
+}
+
+template<>
+bool sevalue_to_native(const se::Value &from, cc::Mat4 *to, se::Object *)
+{
+    return seval_to_Mat4(from, to);
+}
+
+template<>
+bool sevalue_to_native(const se::Value &from, cc::Size *to, se::Object *)
+{
+    return seval_to_Size(from, to);
+}
+
 template<>
 bool nativevalue_to_se(const cc::Data& from, se::Value& to, se::Object*)
 {
@@ -1253,6 +1296,99 @@ bool nativevalue_to_se(const cc::Rect& from, se::Value& to, se::Object*) {
 	return Rect_to_seval(from, &to);
 }
 
+namespace {
+se::Object *__structResultBuffer = nullptr;
+uint8_t *__structResultData = nullptr;
+
+// the typed array passed at index, the shared buffer when there is none
+uint8_t *getStructResultData(const se::ValueArray &args, size_t index, size_t byteLength) {
+    assert(byteLength <= STRUCT_RESULT_BUFFER_SIZE);
+    if (index < args.size() && args[index].isObject() && args[index].toObject()->isTypedArray()) {
+        uint8_t *data = nullptr;
+        size_t length = 0;
+        if (!args[index].toObject()->getTypedArrayData(&data, &length) || length < byteLength) return nullptr;
+        return data;
+    }
+    get_struct_result_buffer();
+    return __structResultData;
+}
+
+template <typename T>
+void writeStructField(uint8_t *&data, T field) {
+    static_assert(sizeof(T) == 4, "struct result fields take 4 bytes");
+    memcpy(data, &field, sizeof(field));
+    data += sizeof(field);
+}
+
+template <typename... Fields>
+bool writeStructResult(const se::ValueArray &args, size_t index, Fields... fields) {
+    uint8_t *data = getStructResultData(args, index, sizeof...(Fields) * 4);
+    if (!data) return false;
+    int expand[] = {(writeStructField(data, fields), 0)...};
+    (void)expand;
+    return true;
+}
+} // namespace
+
+se::Object *get_struct_result_buffer() {
+    if (!__structResultBuffer) {
+        __structResultBuffer = se::Object::createArrayBufferObject(nullptr, STRUCT_RESULT_BUFFER_SIZE);
+        __structResultBuffer->root();
+        size_t length = 0;
+        __structResultBuffer->getArrayBufferData(&__structResultData, &length);
+    }
+    return __structResultBuffer;
+}
+
+void release_struct_result_buffer() {
+    if (__structResultBuffer) {
+        __structResultBuffer->unroot();
+        __structResultBuffer->decRef();
+        __structResultBuffer = nullptr;
+        __structResultData = nullptr;
+    }
+}
+
+bool nativevalue_to_buffer(const cc::gfx::Color &from, const se::ValueArray &args, size_t index) {
+    return writeStructResult(args, index, from.x, from.y, from.z, from.w);
+}
+
+bool nativevalue_to_buffer(const cc::gfx::Rect &from, const se::ValueArray &args, size_t index) {
+    return writeStructResult(args, index, from.x, from.y, from.width, from.height);
+}
+
+bool nativevalue_to_buffer(const cc::gfx::Viewport &from, const se::ValueArray &args, size_t index) {
+    return writeStructResult(args, index, from.left, from.top, from.width, from.height, from.minDepth, from.maxDepth);
+}
+
+bool nativevalue_to_buffer(const cc::gfx::Offset &from, const se::ValueArray &args, size_t index) {
+    return writeStructResult(args, index, from.x, from.y, from.z);
+}
+
+bool nativevalue_to_buffer(const cc::gfx::Extent &from, const se::ValueArray &args, size_t index) {
+    return writeStructResult(args, index, from.width, from.height, from.depth);
+}
+
+bool nativevalue_to_buffer(const cc::Vec2 &from, const se::ValueArray &args, size_t index) {
+    return writeStructResult(args, index, from.x, from.y);
+}
+
+bool nativevalue_to_buffer(const cc::Vec3 &from, const se::ValueArray &args, size_t index) {
+    return writeStructResult(args, index, from.x, from.y, from.z);
+}
+
+bool nativevalue_to_buffer(const cc::Vec4 &from, const se::ValueArray &args, size_t index) {
+    return writeStructResult(args, index, from.x, from.y, from.z, from.w);
+}
+
+bool nativevalue_to_buffer(const cc::Size &from, const se::ValueArray &args, size_t index) {
+    return writeStructResult(args, index, from.width, from.height);
+}
+
+bool nativevalue_to_buffer(const cc::Rect &from, const se::ValueArray &args, size_t index) {
+    return writeStructResult(args, index, from.origin.x, from.origin.y, from.size.width, from.size.height);
+}
+
 #if USE_SPINE
 
 template <>
@@ -996,6 +996,22 @@ inline bool sevalue_to_native(const se::Value &from, void * to, se::Object *)
     return false;
 }
 
+// math types, from Float32Arrays or fields read with cached property keys
+template<>
+bool sevalue_to_native(const se::Value &from, cc::Vec2 *to, se::Object *);
+
+template<>
+bool sevalue_to_native(const se::Value &from, cc::Vec3 *to, se::Object *);
+
+template<>
+bool sevalue_to_native(const se::Value &from, cc::Vec4 *to, se::Object *);
+
+template<>
+bool sevalue_to_native(const se::Value &from, cc::Mat4 *to, se::Object *);
+
+template<>
+bool sevalue_to_native(const se::Value &from, cc::Size *to, se::Object *);
+
 
 ////////////////// pointer types
 
@@ -1573,6 +1589,26 @@ bool nativevalue_to_se(const cc::Rect& from, se::Value& to, se::Object*);
 #pragma clang diagnostic pop
 #endif
 
+// Struct results of the functions listed in structs_returned_in_buffer of the tojs ini files are also bound to
+// <function>ToBuffer, which writes them into a typed array instead of creating an object per call: the one passed
+// as the argument, otherwise jsb.structResultBuffer, an ArrayBuffer of STRUCT_RESULT_BUFFER_SIZE bytes shared by
+// all of them. Fields take 4 bytes each in declaration order, floats read through a Float32Array view, signed and
+// unsigned integers through Int32Array and Uint32Array ones. Scripts copy the values out before the next call.
+constexpr size_t STRUCT_RESULT_BUFFER_SIZE = 64;
+se::Object *get_struct_result_buffer();
+void release_struct_result_buffer();
+
+bool nativevalue_to_buffer(const cc::gfx::Color &from, const se::ValueArray &args, size_t index);
+bool nativevalue_to_buffer(const cc::gfx::Rect &from, const se::ValueArray &args, size_t index);
+bool nativevalue_to_buffer(const cc::gfx::Viewport &from, const se::ValueArray &args, size_t index);
+bool nativevalue_to_buffer(const cc::gfx::Offset &from, const se::ValueArray &args, size_t index);
+bool nativevalue_to_buffer(const cc::gfx::Extent &from, const se::ValueArray &args, size_t index);
+bool nativevalue_to_buffer(const cc::Vec2 &from, const se::ValueArray &args, size_t index);
+bool nativevalue_to_buffer(const cc::Vec3 &from, const se::ValueArray &args, size_t index);
+bool nativevalue_to_buffer(const cc::Vec4 &from, const se::ValueArray &args, size_t index);
+bool nativevalue_to_buffer(const cc::Size &from, const se::ValueArray &args, size_t index);
+bool nativevalue_to_buffer(const cc::Rect &from, const se::ValueArray &args, size_t index);
+
 // Spine conversions
 #if USE_SPINE
 
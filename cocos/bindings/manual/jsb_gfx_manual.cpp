@@ -3,6 +3,7 @@
 #include "bindings/jswrapper/SeApi.h"
 #include "bindings/manual/jsb_conversions.h"
 #include "bindings/manual/jsb_global.h"
+#include "renderer/core/gfx/GFXCommandStream.h"
 
 #if !(defined(CC_USE_GLES2) || defined(CC_USE_GLES3) || defined(CC_USE_VULKAN) || defined(CC_USE_METAL))
     #error "gfx backend is not defined!"
@@ -480,6 +481,54 @@ static bool js_gfx_InputAssembler_extractDrawInfo(se::State &s) {
 }
 SE_BIND_FUNC(js_gfx_InputAssembler_extractDrawInfo)
 
+static bool js_gfx_replayCommandStream(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 3) {
+        uint8_t *data = nullptr;
+        size_t dataLength = 0;
+        SE_PRECONDITION2(args[0].isObject(), false, "js_gfx_replayCommandStream : stream must be an ArrayBuffer or a typed array");
+        se::Object *stream = args[0].toObject();
+        if (stream->isArrayBuffer()) {
+            ok = stream->getArrayBufferData(&data, &dataLength);
+        } else if (stream->isTypedArray()) {
+            ok = stream->getTypedArrayData(&data, &dataLength);
+        } else {
+            ok = false;
+        }
+        SE_PRECONDITION2(ok, false, "js_gfx_replayCommandStream : stream must be an ArrayBuffer or a typed array");
+
+        uint wordCount = 0;
+        ok &= seval_to_uint32(args[1], (uint32_t *)&wordCount);
+        SE_PRECONDITION2(ok && wordCount <= dataLength / sizeof(uint), false, "js_gfx_replayCommandStream : word count exceeds the stream");
+
+        // resolved on every replay, so an object destroyed in between is never replayed
+        static cc::vector<cc::gfx::GFXObject *> objects;
+        objects.clear();
+        if (args[2].isObject() && args[2].toObject()->isArray()) {
+            se::Object *objectArray = args[2].toObject();
+            uint32_t length = 0;
+            objectArray->getArrayLength(&length);
+            objects.resize(length, nullptr);
+
+            se::Value value;
+            for (uint32_t i = 0; i < length; ++i) {
+                if (objectArray->getArrayElement(i, &value) && value.isObject()) {
+                    objects[i] = static_cast<cc::gfx::GFXObject *>(value.toObject()->getPrivateData());
+                }
+            }
+        }
+
+        bool result = cc::gfx::CommandStream::replay(reinterpret_cast<const uint *>(data), wordCount, objects.data(), static_cast<uint>(objects.size()));
+        s.rval().setBoolean(result);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 3);
+    return false;
+}
+SE_BIND_FUNC(js_gfx_replayCommandStream)
+
 bool register_all_gfx_manual(se::Object *obj) {
     __jsb_cc_gfx_Device_proto->defineFunction("copyBuffersToTexture", _SE(js_gfx_Device_copyBuffersToTexture));
     __jsb_cc_gfx_Device_proto->defineFunction("copyTexImagesToTexture", _SE(js_gfx_Device_copyTexImagesToTexture));
@@ -507,6 +556,8 @@ bool register_all_gfx_manual(se::Object *obj) {
     }
     se::Object *ns = nsVal.toObject();
 
+    ns->defineFunction("replayCommandStream", _SE(js_gfx_replayCommandStream));
+
 //    js_register_gfx_SubPass(ns);
 
 #ifdef CC_USE_VULKAN
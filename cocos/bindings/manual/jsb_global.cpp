@@ -28,10 +28,18 @@
 #include "xxtea/xxtea.h"
 
 #include "base/Scheduler.h"
+#include "base/Startup.h"
 #include "base/ThreadPool.h"
+#include "base/ZipUtils.h"
 #include "network/HttpClient.h"
 #include "platform/Application.h"
 #include "renderer/core/Core.h"
+#if CC_USE_BENCHMARK
+#include "renderer/benchmark/DeviceBenchmark.h"
+#endif
+#if USE_AUDIO
+#include "audio/include/AudioEngine.h"
+#endif
 #include "ui/edit-box/EditBox.h"
 
 #if CC_PLATFORM == CC_PLATFORM_ANDROID
@@ -40,6 +48,8 @@
 
 #include <regex>
 #include <chrono>
+#include <future>
+#include <mutex>
 #include <sstream>
 
 using namespace cc;
@@ -118,96 +128,129 @@ static std::string removeFileExt(const std::string& filePath)
     return filePath;
 }
 
-void jsb_init_file_operation_delegate()
+// The size of the inflated data, from the trailer of a gzip stream with one member.
+static ssize_t getGZipSize(const uint8_t* data, size_t dataLen)
 {
-    static se::ScriptEngine::FileOperationDelegate delegate;
-    if (!delegate.isValid())
-    {
-        delegate.onGetDataFromFile = [](const std::string& path, const std::function<void(const uint8_t*, size_t)>& readCallback) -> void{
-            assert(!path.empty());
-
-            Data fileData;
-
-            std::string byteCodePath = removeFileExt(path) + BYTE_CODE_FILE_EXT;
-            if (FileUtils::getInstance()->isFileExist(byteCodePath)) {
-                fileData = FileUtils::getInstance()->getDataFromFile(byteCodePath);
+    if (dataLen < 18)
+        return 0;
+    const uint8_t* trailer = data + dataLen - 4;
+    const uint32_t size = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) | (static_cast<uint32_t>(trailer[3]) << 24);
+    // a corrupted trailer only costs reallocations
+    return size / 1024 <= dataLen ? static_cast<ssize_t>(size) : 0;
+}
 
-                size_t dataLen = 0;
-                uint8_t* data = xxtea_decrypt((unsigned char*)fileData.getBytes(), (uint32_t)fileData.getSize(), (unsigned char*)xxteaKey.c_str(), (uint32_t)xxteaKey.size(), (uint32_t*)&dataLen);
+// Reads a script as the engine runs it, decrypted and inflated. Plain scripts stay mapped,
+// encrypted ones are decrypted into one buffer and inflated into a second of the exact size.
+// Safe to call from any thread.
+static std::shared_ptr<MappedFile> decodeScriptFile(const std::string& path)
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::string byteCodePath = removeFileExt(path) + BYTE_CODE_FILE_EXT;
+    if (!fileUtils->isFileExist(byteCodePath))
+        return std::make_shared<MappedFile>(fileUtils->mapFile(path));
+
+    MappedFile fileData = fileUtils->mapFile(byteCodePath);
+    uint32_t dataLen = 0;
+    uint8_t* data = xxtea_decrypt((unsigned char*)fileData.getBytes(), (uint32_t)fileData.getSize(), (unsigned char*)xxteaKey.c_str(), (uint32_t)xxteaKey.size(), &dataLen);
+    fileData.reset();
+
+    if (data == nullptr) {
+        SE_REPORT_ERROR("Can't decrypt code for %s", byteCodePath.c_str());
+        return nullptr;
+    }
 
-                if (data == nullptr) {
-                    SE_REPORT_ERROR("Can't decrypt code for %s", byteCodePath.c_str());
-                    return;
-                }
+    if (ZipUtils::isGZipBuffer(data, dataLen)) {
+        ssize_t sizeHint = getGZipSize(data, dataLen);
+        uint8_t* unpackedData = nullptr;
+        ssize_t unpackedLen = ZipUtils::inflateMemoryWithHint(data, dataLen, &unpackedData, sizeHint > 0 ? sizeHint : 256 * 1024);
+        free(data);
 
-                if (ZipUtils::isGZipBuffer(data,dataLen)) {
-                    uint8_t* unpackedData;
-                    ssize_t unpackedLen = ZipUtils::inflateMemory(data, dataLen,&unpackedData);
+        if (unpackedData == nullptr) {
+            SE_REPORT_ERROR("Can't decrypt code for %s", byteCodePath.c_str());
+            return nullptr;
+        }
+        return std::make_shared<MappedFile>(unpackedData, unpackedLen, [unpackedData]() { free(unpackedData); });
+    }
 
-                    if (unpackedData == nullptr) {
-                        SE_REPORT_ERROR("Can't decrypt code for %s", byteCodePath.c_str());
-                        return;
-                    }
+    return std::make_shared<MappedFile>(data, dataLen, [data]() { free(data); });
+}
 
-                    readCallback(unpackedData, unpackedLen);
-                    free(data);
-                    free(unpackedData);
-                }
-                else {
-                    readCallback(data, dataLen);
-                    free(data);
-                }
+// scripts decoded ahead of their run, by jsb_prefetch_scripts
+static ThreadPool* __scriptThreadPool = nullptr;
+static std::mutex __prefetchedScriptsMutex;
+static std::unordered_map<std::string, std::shared_future<std::shared_ptr<MappedFile>>> __prefetchedScripts;
 
-                return;
-            }
+void jsb_prefetch_scripts(const std::vector<std::string>& paths)
+{
+    if (!__scriptThreadPool)
+        __scriptThreadPool = ThreadPool::newFixedThreadPool(2);
 
-            fileData = FileUtils::getInstance()->getDataFromFile(path);
-            readCallback(fileData.getBytes(), fileData.getSize());
-        };
+    std::lock_guard<std::mutex> lock(__prefetchedScriptsMutex);
+    for (const auto& path : paths)
+    {
+        if (path.empty() || __prefetchedScripts.count(path))
+            continue;
 
-        delegate.onGetStringFromFile = [](const std::string& path) -> std::string{
-            assert(!path.empty());
+        auto promise = std::make_shared<std::promise<std::shared_ptr<MappedFile>>>();
+        __prefetchedScripts.emplace(path, promise->get_future().share());
+        __scriptThreadPool->pushTask([path, promise](int /*threadId*/) {
+            promise->set_value(decodeScriptFile(path));
+        });
+    }
+}
 
-            std::string byteCodePath = removeFileExt(path) + BYTE_CODE_FILE_EXT;
-            if (FileUtils::getInstance()->isFileExist(byteCodePath)) {
-                Data fileData = FileUtils::getInstance()->getDataFromFile(byteCodePath);
+// a prefetched script is handed out once, waiting for it if it is still being decoded
+static std::shared_ptr<MappedFile> getScriptFile(const std::string& path)
+{
+    std::shared_future<std::shared_ptr<MappedFile>> prefetched;
+    {
+        std::lock_guard<std::mutex> lock(__prefetchedScriptsMutex);
+        auto iter = __prefetchedScripts.find(path);
+        if (iter != __prefetchedScripts.end())
+        {
+            prefetched = iter->second;
+            __prefetchedScripts.erase(iter);
+        }
+    }
+    return prefetched.valid() ? prefetched.get() : decodeScriptFile(path);
+}
 
-                uint32_t dataLen;
-                uint8_t* data = xxtea_decrypt((uint8_t*)fileData.getBytes(), (uint32_t)fileData.getSize(), (uint8_t*)xxteaKey.c_str(), (uint32_t)xxteaKey.size(), &dataLen);
+static void clearPrefetchedScripts()
+{
+    // waits for the running decodes
+    delete __scriptThreadPool;
+    __scriptThreadPool = nullptr;
 
-                if (data == nullptr) {
-                    SE_REPORT_ERROR("Can't decrypt code for %s", byteCodePath.c_str());
-                    return "";
-                }
+    std::lock_guard<std::mutex> lock(__prefetchedScriptsMutex);
+    __prefetchedScripts.clear();
+}
 
-                if (ZipUtils::isGZipBuffer(data,dataLen)) {
-                    uint8_t* unpackedData;
-                    ssize_t unpackedLen = ZipUtils::inflateMemory(data, dataLen,&unpackedData);
-                    if (unpackedData == nullptr) {
-                        SE_REPORT_ERROR("Can't decrypt code for %s", byteCodePath.c_str());
-                        return "";
-                    }
+void jsb_init_file_operation_delegate()
+{
+    static se::ScriptEngine::FileOperationDelegate delegate;
+    if (!delegate.isValid())
+    {
+        delegate.onGetDataFromFile = [](const std::string& path, const std::function<void(const uint8_t*, size_t)>& readCallback) -> void{
+            assert(!path.empty());
 
-                    std::string ret(reinterpret_cast<const char*>(unpackedData), unpackedLen);
-                    free(unpackedData);
-                    free(data);
+            // the script is handed over without another copy
+            auto fileData = getScriptFile(path);
+            if (fileData)
+                readCallback(fileData->getBytes(), fileData->getSize());
+        };
 
-                    return ret;
-                }
-                else {
-                    std::string ret(reinterpret_cast<const char*>(data), dataLen);
-                    free(data);
-                    return ret;
-                }
-            }
+        delegate.onGetStringFromFile = [](const std::string& path) -> std::string{
+            assert(!path.empty());
 
-            if (FileUtils::getInstance()->isFileExist(path)) {
-                return FileUtils::getInstance()->getStringFromFile(path);
-            }
-            else {
+            if (!FileUtils::getInstance()->isFileExist(removeFileExt(path) + BYTE_CODE_FILE_EXT) && !FileUtils::getInstance()->isFileExist(path)) {
                 SE_LOGE("ScriptEngine::onGetStringFromFile %s not found, possible missing file.\n", path.c_str());
+                return "";
             }
-            return "";
+
+            auto fileData = getScriptFile(path);
+            if (!fileData || fileData->isNull())
+                return "";
+            return std::string(reinterpret_cast<const char*>(fileData->getBytes()), fileData->getSize());
         };
 
         delegate.onGetFullPath = [](const std::string& path) -> std::string{
@@ -427,6 +470,7 @@ namespace {
 
 bool jsb_run_script(const std::string& filePath, se::Value* rval/* = nullptr */)
 {
+    CC_STARTUP_PHASE("RunScript");
     se::AutoHandleScope hs;
     return se::ScriptEngine::getInstance()->runScript(filePath, rval);
 }
@@ -443,6 +487,29 @@ static bool jsc_garbageCollect(se::State& s)
 }
 SE_BIND_FUNC(jsc_garbageCollect)
 
+#if SCRIPT_ENGINE_TYPE == SCRIPT_ENGINE_V8
+static bool jsc_getGCStats(se::State& s)
+{
+    const auto& stats = se::ScriptEngine::getInstance()->getGCStats();
+    se::HandleObject statsObj(se::Object::createPlainObject());
+    statsObj->setProperty("count", se::Value(stats.count));
+    statsObj->setProperty("majorCount", se::Value(stats.majorCount));
+    statsObj->setProperty("lastPause", se::Value(stats.lastPause));
+    statsObj->setProperty("maxPause", se::Value(stats.maxPause));
+    statsObj->setProperty("totalPause", se::Value(stats.totalPause));
+    s.rval().setObject(statsObj);
+    return true;
+}
+SE_BIND_FUNC(jsc_getGCStats)
+
+static bool jsc_resetGCStats(se::State& s)
+{
+    se::ScriptEngine::getInstance()->resetGCStats();
+    return true;
+}
+SE_BIND_FUNC(jsc_resetGCStats)
+#endif
+
 static bool jsc_dumpNativePtrToSeObjectMap(se::State& s)
 {
     CC_LOG_DEBUG(">>> total: %d, Dump (native -> jsobj) map begin", (int)se::NativePtrToObjectMap::size());
@@ -653,6 +720,23 @@ static bool JSB_setCursorEnabled(se::State& s)
 }
 SE_BIND_FUNC(JSB_setCursorEnabled)
 
+static bool JSB_prefetchScripts(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    if (argc == 1)
+    {
+        std::vector<std::string> paths;
+        bool ok = seval_to_std_vector_string(args[0], &paths);
+        SE_PRECONDITION2(ok, false, "Error processing arguments");
+        jsb_prefetch_scripts(paths);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_prefetchScripts)
+
 static bool JSB_saveByteCode(se::State& s)
 {
     const auto& args = s.args();
@@ -746,7 +830,18 @@ namespace
         return dst;
     }
 
-    struct ImageInfo* createImageInfo(Image* img)
+    // the optional third argument of jsb.loadImage
+    struct ImageDecodeOptions
+    {
+        int maxWidth = 0;
+        int maxHeight = 0;
+        bool packPixels = false;
+        bool stripOpaqueAlpha = false;
+        // set when any option is, the caller reads the format instead of expecting RGBA8
+        bool keepFormat = false;
+    };
+
+    struct ImageInfo* createImageInfo(Image* img, bool keepFormat)
     {
         struct ImageInfo* imgInfo = new struct ImageInfo();
         imgInfo->length = (uint32_t)img->getDataLen();
@@ -761,7 +856,7 @@ namespace
         // will create a big texture, and update its content with small pictures.
         // The big texture is RGBA888, then the small picture should be the same
         // format, or it will cause 0x502 error on OpenGL ES 2.
-        if (!imgInfo->compressed && imgInfo->format != cc::gfx::Format::RGBA8) {
+        if (!keepFormat && !imgInfo->compressed && imgInfo->format != cc::gfx::Format::RGBA8) {
             imgInfo->length = img->getWidth() * img->getHeight() * 4;
             uint8_t* dst = nullptr;
             uint32_t length = imgInfo->length;
@@ -793,7 +888,7 @@ namespace
     }
 }
 
-bool jsb_global_load_image(const std::string& path, const se::Value& callbackVal) {
+static bool loadImage(const std::string& path, const se::Value& callbackVal, const ImageDecodeOptions& options) {
     if (path.empty())
     {
         se::ValueArray seArgs;
@@ -803,8 +898,11 @@ bool jsb_global_load_image(const std::string& path, const se::Value& callbackVal
     
     std::shared_ptr<se::Value> callbackPtr = std::make_shared<se::Value>(callbackVal);
 
-    auto initImageFunc = [path, callbackPtr](const std::string& fullPath, unsigned char* imageData, int imageBytes){
+    auto initImageFunc = [path, callbackPtr, options](const std::string& fullPath, unsigned char* imageData, int imageBytes){
         Image* img = new (std::nothrow) Image();
+        img->setMaxDecodeSize(options.maxWidth, options.maxHeight);
+        img->setPackPixels(options.packPixels);
+        img->setStripOpaqueAlpha(options.stripOpaqueAlpha);
 
         __threadPool->pushTask([=](int tid){
             // NOTE: FileUtils::getInstance()->fullPathForFilename isn't a threadsafe method,
@@ -826,7 +924,7 @@ bool jsb_global_load_image(const std::string& path, const se::Value& callbackVal
             struct ImageInfo* imgInfo = nullptr;
             if(loadSucceed)
             {
-                imgInfo = createImageInfo(img);
+                imgInfo = createImageInfo(img, options.keepFormat);
             }
 
             Application::getInstance()->getScheduler()->performFunctionInCocosThread([=](){
@@ -841,6 +939,7 @@ bool jsb_global_load_image(const std::string& path, const se::Value& callbackVal
                     retObj->setProperty("data", dataVal);
                     retObj->setProperty("width", se::Value(imgInfo->width));
                     retObj->setProperty("height", se::Value(imgInfo->height));
+                    retObj->setProperty("format", se::Value(static_cast<uint32_t>(imgInfo->format)));
 
                     seArgs.push_back(se::Value(retObj));
 
@@ -893,12 +992,18 @@ bool jsb_global_load_image(const std::string& path, const se::Value& callbackVal
     return true;
 }
 
+bool jsb_global_load_image(const std::string& path, const se::Value& callbackVal) {
+    return loadImage(path, callbackVal, ImageDecodeOptions());
+}
+
+// jsb.loadImage(path, callback[, {maxWidth, maxHeight, packPixels, stripOpaqueAlpha}]), with options the image keeps
+// the format it was decoded to, which the result carries as a gfx.Format
 static bool js_loadImage(se::State& s)
 {
     const auto& args = s.args();
     size_t argc = args.size();
     CC_UNUSED bool ok = true;
-    if (argc == 2) {
+    if (argc == 2 || argc == 3) {
         std::string path;
         ok &= seval_to_std_string(args[0], &path);
         SE_PRECONDITION2(ok, false, "js_loadImage : Error processing arguments");
@@ -907,9 +1012,19 @@ static bool js_loadImage(se::State& s)
         assert(callbackVal.isObject());
         assert(callbackVal.toObject()->isFunction());
 
-        return jsb_global_load_image(path, callbackVal);
+        ImageDecodeOptions options;
+        if (argc == 3 && args[2].isObject()) {
+            se::Object* optionsObj = args[2].toObject();
+            se::Value value;
+            if (optionsObj->getProperty("maxWidth", &value) && value.isNumber()) options.maxWidth = value.toInt32();
+            if (optionsObj->getProperty("maxHeight", &value) && value.isNumber()) options.maxHeight = value.toInt32();
+            if (optionsObj->getProperty("packPixels", &value) && value.isBoolean()) options.packPixels = value.toBoolean();
+            if (optionsObj->getProperty("stripOpaqueAlpha", &value) && value.isBoolean()) options.stripOpaqueAlpha = value.toBoolean();
+            options.keepFormat = true;
+        }
+        return loadImage(path, callbackVal, options);
     }
-    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 2);
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 3);
     return false;
 }
 SE_BIND_FUNC(js_loadImage)
@@ -986,6 +1101,185 @@ static bool JSB_setPreferredFramesPerSecond(se::State& s)
 }
 SE_BIND_FUNC(JSB_setPreferredFramesPerSecond)
 
+static bool JSB_setPerformanceGovernorEnabled(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    if (argc > 0) {
+        Application::getInstance()->getPerformanceGovernor()->setEnabled(args[0].toBoolean());
+        return true;
+    }
+
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_setPerformanceGovernorEnabled)
+
+static bool JSB_getPerformanceLevel(se::State& s)
+{
+    s.rval().setInt32((int32_t)Application::getInstance()->getPerformanceGovernor()->getLevel());
+    return true;
+}
+SE_BIND_FUNC(JSB_getPerformanceLevel)
+
+// jsb.setSpikeDetectorEnabled(enabled[, thresholdMs])
+static bool JSB_setSpikeDetectorEnabled(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    if (argc > 0) {
+        auto* spikeDetector = Application::getInstance()->getSpikeDetector();
+        if (argc > 1 && args[1].isNumber())
+            spikeDetector->setThreshold(args[1].toFloat());
+        spikeDetector->setEnabled(args[0].toBoolean());
+        return true;
+    }
+
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_setSpikeDetectorEnabled)
+
+// the file of the last spike written for upload, an empty string before the first
+static bool JSB_getLastSpikeSnapshot(se::State& s)
+{
+    s.rval().setString(Application::getInstance()->getSpikeDetector()->getLastSnapshotPath());
+    return true;
+}
+SE_BIND_FUNC(JSB_getLastSpikeSnapshot)
+
+#if CC_USE_BENCHMARK
+// jsb.runGFXBenchmark([iterations]), the results of cc::gfx::DeviceBenchmark as JSON, an empty string when it failed.
+// Renders frames of its own, so it must not be called while the pipeline renders, a scheduled callback is fine.
+static bool JSB_runGFXBenchmark(se::State& s)
+{
+    const auto& args = s.args();
+    gfx::DeviceBenchmarkInfo info;
+    if (!args.empty() && args[0].isNumber())
+        info.iterations = args[0].toUint32();
+
+    gfx::DeviceBenchmark benchmark(gfx::Device::getInstance());
+    s.rval().setString(benchmark.run(info) ? benchmark.toJSON() : "");
+    return true;
+}
+SE_BIND_FUNC(JSB_runGFXBenchmark)
+#endif
+
+#if USE_AUDIO
+// jsb.getAudioMixerStats([reset]), see AudioEngine::getMixerStats
+static bool JSB_getAudioMixerStats(se::State& s)
+{
+    const auto& args = s.args();
+    const bool reset = !args.empty() && args[0].toBoolean();
+    s.rval().setString(AudioEngine::getMixerStats(reset));
+    return true;
+}
+SE_BIND_FUNC(JSB_getAudioMixerStats)
+
+#if CC_USE_BENCHMARK
+// jsb.runAudioMixerBenchmark([loopback]), see AudioEngine::runMixerBenchmark
+static bool JSB_runAudioMixerBenchmark(se::State& s)
+{
+    const auto& args = s.args();
+    const bool isLoopbackEnabled = !args.empty() && args[0].toBoolean();
+    s.rval().setString(AudioEngine::runMixerBenchmark(isLoopbackEnabled));
+    return true;
+}
+SE_BIND_FUNC(JSB_runAudioMixerBenchmark)
+#endif
+#endif
+
+#if CC_USE_FAST_COMPRESSION
+// the bytes of a typed array or an ArrayBuffer
+static bool getBufferBytes(const se::Value& value, uint8_t** data, size_t* length)
+{
+    if (!value.isObject()) return false;
+    se::Object* obj = value.toObject();
+    return obj->isTypedArray() ? obj->getTypedArrayData(data, length)
+                               : obj->isArrayBuffer() && obj->getArrayBufferData(data, length);
+}
+
+// the data as an ArrayBuffer, null when the codec failed
+static void setBufferResult(se::State& s, const Data& data)
+{
+    if (data.isNull()) {
+        s.rval().setNull();
+        return;
+    }
+    se::HandleObject buffer(se::Object::createArrayBufferObject(data.getBytes(), data.getSize()));
+    s.rval().setObject(buffer);
+}
+
+// jsb.compressLZ4(buffer, level = 0)
+static bool JSB_compressLZ4(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    uint8_t* data = nullptr;
+    size_t length = 0;
+    SE_PRECONDITION2(argc > 0 && getBufferBytes(args[0], &data, &length), false, "buffer is invalid!");
+    int level = argc > 1 && args[1].isNumber() ? args[1].toInt32() : 0;
+    setBufferResult(s, ZipUtils::compressLZ4(data, static_cast<ssize_t>(length), level));
+    return true;
+}
+SE_BIND_FUNC(JSB_compressLZ4)
+
+// jsb.decompressLZ4(buffer)
+static bool JSB_decompressLZ4(se::State& s)
+{
+    const auto& args = s.args();
+    uint8_t* data = nullptr;
+    size_t length = 0;
+    SE_PRECONDITION2(!args.empty() && getBufferBytes(args[0], &data, &length), false, "buffer is invalid!");
+    setBufferResult(s, ZipUtils::decompressLZ4(data, static_cast<ssize_t>(length)));
+    return true;
+}
+SE_BIND_FUNC(JSB_decompressLZ4)
+
+// jsb.compressZstd(buffer, level = 0, dictionary = null, workers = 0)
+static bool JSB_compressZstd(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    uint8_t* data = nullptr;
+    size_t length = 0;
+    SE_PRECONDITION2(argc > 0 && getBufferBytes(args[0], &data, &length), false, "buffer is invalid!");
+    int level = argc > 1 && args[1].isNumber() ? args[1].toInt32() : 0;
+    Data dictionary;
+    uint8_t* dictionaryData = nullptr;
+    size_t dictionaryLength = 0;
+    if (argc > 2 && getBufferBytes(args[2], &dictionaryData, &dictionaryLength)) {
+        dictionary.fastSet(dictionaryData, static_cast<ssize_t>(dictionaryLength));
+    }
+    int workers = argc > 3 && args[3].isNumber() ? args[3].toInt32() : 0;
+    setBufferResult(s, ZipUtils::compressZstd(data, static_cast<ssize_t>(length), level, &dictionary, workers));
+    // the bytes belong to the script
+    dictionary.takeBuffer();
+    return true;
+}
+SE_BIND_FUNC(JSB_compressZstd)
+
+// jsb.decompressZstd(buffer, dictionary = null)
+static bool JSB_decompressZstd(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    uint8_t* data = nullptr;
+    size_t length = 0;
+    SE_PRECONDITION2(argc > 0 && getBufferBytes(args[0], &data, &length), false, "buffer is invalid!");
+    Data dictionary;
+    uint8_t* dictionaryData = nullptr;
+    size_t dictionaryLength = 0;
+    if (argc > 1 && getBufferBytes(args[1], &dictionaryData, &dictionaryLength)) {
+        dictionary.fastSet(dictionaryData, static_cast<ssize_t>(dictionaryLength));
+    }
+    setBufferResult(s, ZipUtils::decompressZstd(data, static_cast<ssize_t>(length), &dictionary));
+    dictionary.takeBuffer();
+    return true;
+}
+SE_BIND_FUNC(JSB_decompressZstd)
+#endif // CC_USE_FAST_COMPRESSION
+
 #if CC_USE_EDITBOX
 static bool JSB_showInputBox(se::State& s)
 {
@@ -1096,11 +1390,34 @@ bool jsb_register_global_variables(se::Object* global)
 
     __jsbObj->defineFunction("garbageCollect", _SE(jsc_garbageCollect));
     __jsbObj->defineFunction("dumpNativePtrToSeObjectMap", _SE(jsc_dumpNativePtrToSeObjectMap));
+#if SCRIPT_ENGINE_TYPE == SCRIPT_ENGINE_V8
+    __jsbObj->defineFunction("getGCStats", _SE(jsc_getGCStats));
+    __jsbObj->defineFunction("resetGCStats", _SE(jsc_resetGCStats));
+#endif
 
     __jsbObj->defineFunction("loadImage", _SE(js_loadImage));
     __jsbObj->defineFunction("openURL", _SE(JSB_openURL));
     __jsbObj->defineFunction("copyTextToClipboard", _SE(JSB_copyTextToClipboard));
     __jsbObj->defineFunction("setPreferredFramesPerSecond", _SE(JSB_setPreferredFramesPerSecond));
+    __jsbObj->defineFunction("setPerformanceGovernorEnabled", _SE(JSB_setPerformanceGovernorEnabled));
+    __jsbObj->defineFunction("getPerformanceLevel", _SE(JSB_getPerformanceLevel));
+    __jsbObj->defineFunction("setSpikeDetectorEnabled", _SE(JSB_setSpikeDetectorEnabled));
+    __jsbObj->defineFunction("getLastSpikeSnapshot", _SE(JSB_getLastSpikeSnapshot));
+#if CC_USE_BENCHMARK
+    __jsbObj->defineFunction("runGFXBenchmark", _SE(JSB_runGFXBenchmark));
+#endif
+#if USE_AUDIO
+    __jsbObj->defineFunction("getAudioMixerStats", _SE(JSB_getAudioMixerStats));
+#if CC_USE_BENCHMARK
+    __jsbObj->defineFunction("runAudioMixerBenchmark", _SE(JSB_runAudioMixerBenchmark));
+#endif
+#endif
+#if CC_USE_FAST_COMPRESSION
+    __jsbObj->defineFunction("compressLZ4", _SE(JSB_compressLZ4));
+    __jsbObj->defineFunction("decompressLZ4", _SE(JSB_decompressLZ4));
+    __jsbObj->defineFunction("compressZstd", _SE(JSB_compressZstd));
+    __jsbObj->defineFunction("decompressZstd", _SE(JSB_decompressZstd));
+#endif
     __jsbObj->defineFunction("destroyImage", _SE(js_destroyImage));
     #if CC_USE_EDITBOX
     __jsbObj->defineFunction("showInputBox", _SE(JSB_showInputBox));
@@ -1108,6 +1425,7 @@ bool jsb_register_global_variables(se::Object* global)
     #endif
     __jsbObj->defineFunction("setCursorEnabled", _SE(JSB_setCursorEnabled));
     __jsbObj->defineFunction("saveByteCode", _SE(JSB_saveByteCode));
+    __jsbObj->defineFunction("prefetchScripts", _SE(JSB_prefetchScripts));
     global->defineFunction("__getPlatform", _SE(JSBCore_platform));
     global->defineFunction("__getOS", _SE(JSBCore_os));
     global->defineFunction("__getOSVersion", _SE(JSB_getOSVersion));
@@ -1116,6 +1434,8 @@ bool jsb_register_global_variables(se::Object* global)
     global->defineFunction("__restartVM", _SE(JSB_core_restartVM));
     global->defineFunction("__isObjectValid", _SE(JSB_isObjectValid));
 
+    __jsbObj->setProperty("structResultBuffer", se::Value(get_struct_result_buffer()));
+
     se::HandleObject performanceObj(se::Object::createPlainObject());
     performanceObj->defineFunction("now", _SE(js_performance_now));
     global->setProperty("performance", se::Value(performanceObj));
@@ -1125,6 +1445,8 @@ bool jsb_register_global_variables(se::Object* global)
     se::ScriptEngine::getInstance()->addBeforeCleanupHook([](){
         delete __threadPool;
         __threadPool = nullptr;
+        clearPrefetchedScripts();
+        release_struct_result_buffer();
 
         PoolManager::getInstance()->getCurrentPool()->clear();
     });
@@ -29,6 +29,7 @@
 #include "base/memory/Memory.h"
 #include <string>
 #include <type_traits>
+#include <vector>
 
 template<typename T, class ... Args>
 typename std::enable_if<std::is_base_of<cc::Object, T>::value, T>::type*
@@ -77,6 +78,9 @@ extern se::Object* __glObj;
 bool jsb_register_global_variables(se::Object* global);
 
 void jsb_init_file_operation_delegate();
+// Decrypts and inflates scripts on worker threads ahead of their run, each is handed to the first run of its path.
+// Call it on the JS thread once the xxtea key is set.
+void jsb_prefetch_scripts(const std::vector<std::string>& paths);
 bool jsb_enable_debugger(const std::string& debuggerServerAddr, uint32_t port, bool isWaitForConnect = false);
 bool jsb_set_extend_property(const char* ns, const char* clsName);
 bool jsb_run_script(const std::string& filePath, se::Value* rval = nullptr);
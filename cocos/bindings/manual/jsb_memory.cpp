@@ -0,0 +1,215 @@
+#include "jsb_memory.h"
+#include "cocos/bindings/dop/BufferAllocator.h"
+#include "cocos/bindings/jswrapper/SeApi.h"
+#include "cocos/bindings/manual/jsb_conversions.h"
+#include "cocos/bindings/manual/jsb_global.h"
+#include "base/Log.h"
+#include "base/Scheduler.h"
+#include "base/memory/Memory.h"
+#include "base/memory/PoolAlloc.h"
+#include "platform/Application.h"
+#include "renderer/core/gfx/GFXDevice.h"
+
+#if USE_MIDDLEWARE
+    #include "editor-support/TypedArrayPool.h"
+#endif
+
+namespace {
+
+const char *CATEGORY_NAMES[] = {
+    "jsHeapUsed",
+    "jsHeapTotal",
+    "jsHeapLimit",
+    "jsExternal",
+    "seObjects",
+    "dopBuffers",
+    "typedArrayPool",
+    "nativeTracked",
+    "gpuBuffers",
+    "gpuTextures",
+    "objectPools",
+};
+static_assert(sizeof(CATEGORY_NAMES) / sizeof(CATEGORY_NAMES[0]) == static_cast<uint8_t>(MemoryCategory::COUNT), "a memory category has no name");
+
+const char *MEMORY_REPORT_SCHEDULE_KEY = "jsb_memory_report";
+int memoryReportTarget = 0;
+
+} // namespace
+
+const char *jsb_get_memory_category_name(MemoryCategory category) {
+    return category < MemoryCategory::COUNT ? CATEGORY_NAMES[static_cast<uint8_t>(category)] : "";
+}
+
+void jsb_collect_memory_report(MemoryReport *report) {
+    *report = MemoryReport();
+
+    se::ScriptEngine *se = se::ScriptEngine::getInstance();
+#if SCRIPT_ENGINE_TYPE == SCRIPT_ENGINE_V8
+    if (se->isValid()) {
+        v8::HeapStatistics stats;
+        v8::Isolate::GetCurrent()->GetHeapStatistics(&stats);
+        (*report)[MemoryCategory::JS_HEAP_USED] = stats.used_heap_size();
+        (*report)[MemoryCategory::JS_HEAP_TOTAL] = stats.total_heap_size();
+        (*report)[MemoryCategory::JS_HEAP_LIMIT] = stats.heap_size_limit();
+        (*report)[MemoryCategory::JS_EXTERNAL] = stats.external_memory();
+    }
+    (*report)[MemoryCategory::SE_OBJECTS] = se::Object::getReservedBytes();
+#else
+    CC_UNUSED_PARAM(se);
+#endif
+
+    (*report)[MemoryCategory::DOP_BUFFERS] = se::BufferAllocator::getTotalBytes();
+
+#if USE_MIDDLEWARE
+    (*report)[MemoryCategory::TYPED_ARRAY_POOL] = cc::middleware::TypedArrayPool::getInstance()->getPooledBytes();
+#endif
+
+#ifdef CC_MEMORY_TRACKER
+    (*report)[MemoryCategory::NATIVE_TRACKED] = cc::MemTracker::Instance()->total_memory_allocated();
+#endif
+
+    cc::gfx::Device *device = cc::gfx::Device::getInstance();
+    if (device) {
+        const auto &status = device->getMemoryStatus();
+        (*report)[MemoryCategory::GPU_BUFFERS] = status.bufferSize;
+        (*report)[MemoryCategory::GPU_TEXTURES] = status.textureSize;
+    }
+
+    (*report)[MemoryCategory::OBJECT_POOLS] = cc::ObjectPool::getReservedBytes();
+}
+
+void jsb_dump_memory_report() {
+    MemoryReport report;
+    jsb_collect_memory_report(&report);
+
+    std::string text = "Memory report (KB):";
+    char buffer[64];
+    for (uint8_t i = 0; i < static_cast<uint8_t>(MemoryCategory::COUNT); ++i) {
+        snprintf(buffer, sizeof(buffer), " %s %zu", CATEGORY_NAMES[i], report.bytes[i] / 1024);
+        text += buffer;
+    }
+    CC_LOG_INFO("%s", text.c_str());
+}
+
+void jsb_set_memory_report_interval(float interval) {
+    auto scheduler = cc::Application::getInstance()->getScheduler();
+    scheduler->unschedule(MEMORY_REPORT_SCHEDULE_KEY, &memoryReportTarget);
+    if (interval > 0.f) {
+        scheduler->schedule([](float /*dt*/) { jsb_dump_memory_report(); }, &memoryReportTarget, interval, false, MEMORY_REPORT_SCHEDULE_KEY);
+    }
+}
+
+static bool JSB_getMemoryReport(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        MemoryReport report;
+        jsb_collect_memory_report(&report);
+
+        se::HandleObject reportObj(se::Object::createPlainObject());
+        for (uint8_t i = 0; i < static_cast<uint8_t>(MemoryCategory::COUNT); ++i) {
+            reportObj->setProperty(CATEGORY_NAMES[i], se::Value(static_cast<double>(report.bytes[i])));
+        }
+        s.rval().setObject(reportObj);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(JSB_getMemoryReport);
+
+static bool JSB_setMemoryReportInterval(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 1) {
+        float interval = 0.f;
+        bool ok = seval_to_float(args[0], &interval);
+        SE_PRECONDITION2(ok, false, "JSB_setMemoryReportInterval : Error processing arguments");
+        jsb_set_memory_report_interval(interval);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_setMemoryReportInterval);
+
+// {typeName: {live, total}} of the pooled engine objects
+static bool JSB_getObjectPoolReport(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        std::vector<cc::ObjectPool::TypeReport> reports;
+        cc::ObjectPool::getTypeReports(&reports);
+
+        se::HandleObject reportObj(se::Object::createPlainObject());
+        for (const auto &report : reports) {
+            se::HandleObject typeObj(se::Object::createPlainObject());
+            typeObj->setProperty("live", se::Value(report.liveCount));
+            typeObj->setProperty("total", se::Value(static_cast<double>(report.allocationCount)));
+            reportObj->setProperty(report.name.c_str(), se::Value(typeObj));
+        }
+        s.rval().setObject(reportObj);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(JSB_getObjectPoolReport);
+
+// Logs the report of MemSampler and returns its text, empty in builds without CC_USE_MEMORY_SAMPLING.
+static bool JSB_dumpAllocationReport(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc <= 1) {
+        uint32_t topCount = 20;
+        if (argc == 1) {
+            bool ok = seval_to_uint32(args[0], &topCount);
+            SE_PRECONDITION2(ok, false, "JSB_dumpAllocationReport : Error processing arguments");
+        }
+#if CC_USE_MEMORY_SAMPLING
+        const std::string report = cc::MemSampler::getReport(topCount);
+        cc::MemSampler::dumpReport(topCount);
+        s.rval().setString(report);
+#else
+        s.rval().setString("");
+#endif
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_dumpAllocationReport);
+
+static bool JSB_setAllocationSampleInterval(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 1) {
+        uint32_t interval = 0;
+        bool ok = seval_to_uint32(args[0], &interval);
+        SE_PRECONDITION2(ok, false, "JSB_setAllocationSampleInterval : Error processing arguments");
+#if CC_USE_MEMORY_SAMPLING
+        cc::MemSampler::setSampleInterval(interval);
+#endif
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_setAllocationSampleInterval);
+
+bool register_all_memory(se::Object *obj) {
+    se::Value nsVal;
+    if (!obj->getProperty("jsb", &nsVal)) {
+        se::HandleObject jsobj(se::Object::createPlainObject());
+        nsVal.setObject(jsobj);
+        obj->setProperty("jsb", nsVal);
+    }
+    se::Object *ns = nsVal.toObject();
+
+    ns->defineFunction("getMemoryReport", _SE(JSB_getMemoryReport));
+    ns->defineFunction("setMemoryReportInterval", _SE(JSB_setMemoryReportInterval));
+    ns->defineFunction("getObjectPoolReport", _SE(JSB_getObjectPoolReport));
+    ns->defineFunction("dumpAllocationReport", _SE(JSB_dumpAllocationReport));
+    ns->defineFunction("setAllocationSampleInterval", _SE(JSB_setAllocationSampleInterval));
+    return true;
+}
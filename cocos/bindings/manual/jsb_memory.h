@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace se {
+class Object;
+}
+
+enum class MemoryCategory : uint8_t {
+    JS_HEAP_USED,          // live objects of the V8 heap
+    JS_HEAP_TOTAL,         // committed V8 heap
+    JS_HEAP_LIMIT,
+    JS_EXTERNAL,           // array buffers and strings held outside of the V8 heap
+    SE_OBJECTS,            // se::Object wrappers, the pool they come from
+    DOP_BUFFERS,           // array buffers of the dop buffer allocators and pools
+    TYPED_ARRAY_POOL,      // idle typed arrays of the middleware pool
+    NATIVE_TRACKED,        // allocations seen by MemTracker, builds with CC_MEMORY_TRACKER only
+    GPU_BUFFERS,           // buffers of the gfx device
+    GPU_TEXTURES,          // textures of the gfx device
+    OBJECT_POOLS,          // size-class pools of ObjectPool, blocks in use or free
+    COUNT,
+};
+
+// Bytes held per category, a category not available in the build or on the script engine stays 0.
+struct MemoryReport {
+    size_t bytes[static_cast<uint8_t>(MemoryCategory::COUNT)] = {0};
+
+    size_t &operator[](MemoryCategory category) { return bytes[static_cast<uint8_t>(category)]; }
+    size_t operator[](MemoryCategory category) const { return bytes[static_cast<uint8_t>(category)]; }
+};
+
+const char *jsb_get_memory_category_name(MemoryCategory category);
+void jsb_collect_memory_report(MemoryReport *report);
+void jsb_dump_memory_report();
+// Dumps the report to the log every interval in seconds, 0 stops the dumps.
+void jsb_set_memory_report_interval(float interval);
+
+bool register_all_memory(se::Object *obj);
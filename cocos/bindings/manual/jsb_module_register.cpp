@@ -41,6 +41,9 @@
 #include "cocos/bindings/manual/jsb_conversions.h"
 #include "cocos/bindings/manual/jsb_gfx_manual.h"
 #include "cocos/bindings/manual/jsb_global.h"
+#include "cocos/bindings/manual/jsb_memory.h"
+#include "cocos/bindings/manual/jsb_navigation.h"
+#include "cocos/bindings/manual/jsb_worker.h"
 #include "cocos/bindings/manual/jsb_platform.h"
 #include "cocos/bindings/manual/jsb_xmlhttprequest.h"
 
@@ -119,6 +122,9 @@ bool jsb_register_all_modules() {
     // extension depend on network
     se->addRegisterCallback(register_all_extension);
     se->addRegisterCallback(register_all_dop_bindings);
+    se->addRegisterCallback(register_all_memory);
+    se->addRegisterCallback(register_all_navigation);
+    se->addRegisterCallback(register_all_worker);
     se->addRegisterCallback(register_all_pipeline);
     se->addRegisterCallback(register_all_pipeline_manual);
 
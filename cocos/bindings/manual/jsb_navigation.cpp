@@ -0,0 +1,190 @@
+#include "jsb_navigation.h"
+#include "cocos/bindings/jswrapper/SeApi.h"
+#include "cocos/bindings/manual/jsb_conversions.h"
+#include "cocos/bindings/manual/jsb_global.h"
+#include "navigation/NavigationSystem.h"
+
+using cc::navigation::NavigationSystem;
+
+namespace {
+
+// the bytes of a typed array of the given type
+bool getTypedArray(const se::Value &v, se::Object::TypedArrayType type, uint8_t **data, size_t *length) {
+    if (!v.isObject() || !v.toObject()->isTypedArray() || v.toObject()->getTypedArrayType() != type) return false;
+    return v.toObject()->getTypedArrayData(data, length);
+}
+
+} // namespace
+
+// setGrid(id, cells: Uint8Array, width, height, cellSize, originX, originY)
+static bool JSB_setNavigationGrid(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 7) {
+        uint32_t id = 0;
+        uint8_t *cells = nullptr;
+        size_t length = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        float cellSize = 0.f;
+        float originX = 0.f;
+        float originY = 0.f;
+        bool ok = seval_to_uint32(args[0], &id);
+        ok &= getTypedArray(args[1], se::Object::TypedArrayType::UINT8, &cells, &length);
+        ok &= seval_to_uint32(args[2], &width);
+        ok &= seval_to_uint32(args[3], &height);
+        ok &= seval_to_float(args[4], &cellSize);
+        ok &= seval_to_float(args[5], &originX);
+        ok &= seval_to_float(args[6], &originY);
+        SE_PRECONDITION2(ok, false, "JSB_setNavigationGrid : Error processing arguments");
+        SE_PRECONDITION2(length >= static_cast<size_t>(width) * height, false, "JSB_setNavigationGrid : cells shorter than width * height");
+        NavigationSystem::getInstance()->setGrid(id, cells, width, height, cellSize, originX, originY);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 7);
+    return false;
+}
+SE_BIND_FUNC(JSB_setNavigationGrid);
+
+// setMesh(id, vertices: Float32Array, indices: Uint32Array), x, y pairs and 3 indices a triangle
+static bool JSB_setNavigationMesh(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 3) {
+        uint32_t id = 0;
+        uint8_t *vertices = nullptr;
+        size_t vertexBytes = 0;
+        uint8_t *indices = nullptr;
+        size_t indexBytes = 0;
+        bool ok = seval_to_uint32(args[0], &id);
+        ok &= getTypedArray(args[1], se::Object::TypedArrayType::FLOAT32, &vertices, &vertexBytes);
+        ok &= getTypedArray(args[2], se::Object::TypedArrayType::UINT32, &indices, &indexBytes);
+        SE_PRECONDITION2(ok, false, "JSB_setNavigationMesh : Error processing arguments");
+        NavigationSystem::getInstance()->setMesh(id, reinterpret_cast<const float *>(vertices), static_cast<uint32_t>(vertexBytes / (sizeof(float) * 2)),
+                                                 reinterpret_cast<const uint32_t *>(indices), static_cast<uint32_t>(indexBytes / (sizeof(uint32_t) * 3)));
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 3);
+    return false;
+}
+SE_BIND_FUNC(JSB_setNavigationMesh);
+
+static bool JSB_removeNavigationGraph(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 1) {
+        uint32_t id = 0;
+        bool ok = seval_to_uint32(args[0], &id);
+        SE_PRECONDITION2(ok, false, "JSB_removeNavigationGraph : Error processing arguments");
+        NavigationSystem::getInstance()->removeGraph(id);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_removeNavigationGraph);
+
+// updateAgents(agentCount, cellSize): boolean
+static bool JSB_updateNavigationAgents(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 2) {
+        uint32_t agentCount = 0;
+        float cellSize = 0.f;
+        bool ok = seval_to_uint32(args[0], &agentCount);
+        ok &= seval_to_float(args[1], &cellSize);
+        SE_PRECONDITION2(ok, false, "JSB_updateNavigationAgents : Error processing arguments");
+        s.rval().setBoolean(NavigationSystem::getInstance()->updateAgents(agentCount, cellSize));
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 2);
+    return false;
+}
+SE_BIND_FUNC(JSB_updateNavigationAgents);
+
+// findPaths(graphId, queryCount, maxPoints): boolean
+static bool JSB_findNavigationPaths(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 3) {
+        uint32_t graphId = 0;
+        uint32_t queryCount = 0;
+        uint32_t maxPoints = 0;
+        bool ok = seval_to_uint32(args[0], &graphId);
+        ok &= seval_to_uint32(args[1], &queryCount);
+        ok &= seval_to_uint32(args[2], &maxPoints);
+        SE_PRECONDITION2(ok, false, "JSB_findNavigationPaths : Error processing arguments");
+        s.rval().setBoolean(NavigationSystem::getInstance()->findPaths(graphId, queryCount, maxPoints));
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 3);
+    return false;
+}
+SE_BIND_FUNC(JSB_findNavigationPaths);
+
+// queryRadius(queryCount, maxNeighbors): boolean
+static bool JSB_queryNavigationRadius(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 2) {
+        uint32_t queryCount = 0;
+        uint32_t maxNeighbors = 0;
+        bool ok = seval_to_uint32(args[0], &queryCount);
+        ok &= seval_to_uint32(args[1], &maxNeighbors);
+        SE_PRECONDITION2(ok, false, "JSB_queryNavigationRadius : Error processing arguments");
+        s.rval().setBoolean(NavigationSystem::getInstance()->queryRadius(queryCount, maxNeighbors));
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 2);
+    return false;
+}
+SE_BIND_FUNC(JSB_queryNavigationRadius);
+
+static bool JSB_completeNavigation(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        NavigationSystem::getInstance()->complete();
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(JSB_completeNavigation);
+
+static bool JSB_isNavigationFinished(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        s.rval().setBoolean(NavigationSystem::getInstance()->isFinished());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(JSB_isNavigationFinished);
+
+bool register_all_navigation(se::Object *obj) {
+    se::Value nsVal;
+    if (!obj->getProperty("jsb", &nsVal)) {
+        se::HandleObject jsobj(se::Object::createPlainObject());
+        nsVal.setObject(jsobj);
+        obj->setProperty("jsb", nsVal);
+    }
+    se::Object *ns = nsVal.toObject();
+
+    // the streams are allocated by a NativeBufferAllocator of PoolType.NAVIGATION, see NavigationSystem.h
+    se::HandleObject navigationObj(se::Object::createPlainObject());
+    navigationObj->defineFunction("setGrid", _SE(JSB_setNavigationGrid));
+    navigationObj->defineFunction("setMesh", _SE(JSB_setNavigationMesh));
+    navigationObj->defineFunction("removeGraph", _SE(JSB_removeNavigationGraph));
+    navigationObj->defineFunction("updateAgents", _SE(JSB_updateNavigationAgents));
+    navigationObj->defineFunction("findPaths", _SE(JSB_findNavigationPaths));
+    navigationObj->defineFunction("queryRadius", _SE(JSB_queryNavigationRadius));
+    navigationObj->defineFunction("complete", _SE(JSB_completeNavigation));
+    navigationObj->defineFunction("isFinished", _SE(JSB_isNavigationFinished));
+    ns->setProperty("NavigationSystem", se::Value(navigationObj));
+
+    se::ScriptEngine::getInstance()->addBeforeCleanupHook([]() { NavigationSystem::destroyInstance(); });
+    return true;
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+namespace se {
+class Object;
+}
+
+bool register_all_navigation(se::Object *obj);
@@ -3,10 +3,18 @@
 #include "cocos/bindings/jswrapper/SeApi.h"
 #include "cocos/bindings/manual/jsb_conversions.h"
 #include "cocos/bindings/manual/jsb_global.h"
+#include "base/FrameStats.h"
 #include "renderer/core/gfx/GFXPipelineState.h"
 #include "renderer/pipeline/Define.h"
 #include "renderer/pipeline/PipelineStateManager.h"
 #include "renderer/pipeline/RenderPipeline.h"
+#include "renderer/pipeline/ShaderVariantCollector.h"
+#include "renderer/pipeline/helper/EnvironmentPrefilter.h"
+#include "renderer/pipeline/helper/GlyphAtlas.h"
+#include "renderer/pipeline/helper/MorphSystem.h"
+#include "renderer/pipeline/helper/SkinningSystem.h"
+#include "renderer/pipeline/helper/TransformSystem.h"
+#include "renderer/pipeline/helper/TweenSystem.h"
 
 
 static bool js_pipeline_RenderPipeline_getMacros(se::State &s) {
@@ -45,6 +53,473 @@ static bool JSB_getOrCreatePipelineState(se::State &s) {
 }
 SE_BIND_FUNC(JSB_getOrCreatePipelineState);
 
+static bool JSB_prewarmPipelineState(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 4) {
+        bool ok = true;
+        uint32_t passHandle = 0;
+        ok &= seval_to_uint32(args[0], &passHandle);
+        SE_PRECONDITION2(ok, false, "JSB_prewarmPipelineState : Error getting pass handle.");
+        auto shader = static_cast<cc::gfx::Shader *>(args[1].toObject()->getPrivateData());
+        auto renderPass = static_cast<cc::gfx::RenderPass *>(args[2].toObject()->getPrivateData());
+        auto inputAssembler = static_cast<cc::gfx::InputAssembler *>(args[3].toObject()->getPrivateData());
+        cc::pipeline::PipelineStateManager::prewarmPipelineStateByJS(passHandle, shader, inputAssembler, renderPass);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 4);
+    return false;
+}
+SE_BIND_FUNC(JSB_prewarmPipelineState);
+
+static bool JSB_getPrewarmProgress(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        se::HandleObject progress(se::Object::createPlainObject());
+        progress->setProperty("pending", se::Value(cc::pipeline::PipelineStateManager::getPrewarmPendingCount()));
+        progress->setProperty("completed", se::Value(cc::pipeline::PipelineStateManager::getPrewarmCompletedCount()));
+        s.rval().setObject(progress);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(JSB_getPrewarmProgress);
+
+static bool JSB_setShaderVariantRecording(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 1) {
+        cc::pipeline::ShaderVariantCollector::setRecording(args[0].toBoolean());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_setShaderVariantRecording);
+
+static bool JSB_isShaderVariantRecording(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        s.rval().setBoolean(cc::pipeline::ShaderVariantCollector::isRecording());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(JSB_isShaderVariantRecording);
+
+static bool JSB_getRecordedShaderVariants(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        bool ok = std_vector_string_to_seval(cc::pipeline::ShaderVariantCollector::getRecordedNames(), &s.rval());
+        SE_PRECONDITION2(ok, false, "JSB_getRecordedShaderVariants : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(JSB_getRecordedShaderVariants);
+
+static bool JSB_clearShaderVariants(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        cc::pipeline::ShaderVariantCollector::clear();
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(JSB_clearShaderVariants);
+
+static bool JSB_saveShaderVariants(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 1) {
+        s.rval().setBoolean(cc::pipeline::ShaderVariantCollector::save(args[0].toString()));
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_saveShaderVariants);
+
+static bool JSB_prewarmShaderVariants(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 1) {
+        s.rval().setUint32(cc::pipeline::ShaderVariantCollector::prewarm(args[0].toString()));
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_prewarmShaderVariants);
+
+static bool JSB_getFrameStats(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        se::HandleObject stats(se::Object::createPlainObject());
+        for (uint8_t i = 0; i < static_cast<uint8_t>(cc::FrameStat::COUNT); ++i) {
+            const auto stat = static_cast<cc::FrameStat>(i);
+            stats->setProperty(cc::FrameStats::getName(stat), se::Value(cc::FrameStats::get(stat)));
+        }
+        s.rval().setObject(stats);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(JSB_getFrameStats);
+
+static bool JSB_updateTransforms(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        cc::pipeline::TransformSystem::getInstance()->update();
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(JSB_updateTransforms);
+
+static bool JSB_markTransformHierarchyChanged(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        cc::pipeline::TransformSystem::getInstance()->markHierarchyChanged();
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(JSB_markTransformHierarchyChanged);
+
+static bool JSB_spawnTweens(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 1) {
+        uint32_t count = 0;
+        bool ok = seval_to_uint32(args[0], &count);
+        SE_PRECONDITION2(ok, false, "JSB_spawnTweens : Error processing arguments");
+        s.rval().setUint32(cc::pipeline::TweenSystem::getInstance()->spawn(count));
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_spawnTweens);
+
+static bool JSB_stopTween(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 1) {
+        uint32_t id = 0;
+        bool ok = seval_to_uint32(args[0], &id);
+        SE_PRECONDITION2(ok, false, "JSB_stopTween : Error processing arguments");
+        cc::pipeline::TweenSystem::getInstance()->stop(id);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_stopTween);
+
+static bool JSB_stopAllTweens(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        cc::pipeline::TweenSystem::getInstance()->stopAll();
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(JSB_stopAllTweens);
+
+static bool JSB_updateTweens(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 1) {
+        float dt = 0.f;
+        bool ok = seval_to_float(args[0], &dt);
+        SE_PRECONDITION2(ok, false, "JSB_updateTweens : Error processing arguments");
+        s.rval().setUint32(cc::pipeline::TweenSystem::getInstance()->update(dt));
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_updateTweens);
+
+static bool JSB_addSkinningModel(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 1) {
+        uint32_t handle = 0;
+        bool ok = seval_to_uint32(args[0], &handle);
+        SE_PRECONDITION2(ok, false, "JSB_addSkinningModel : Error processing arguments");
+        cc::pipeline::SkinningSystem::getInstance()->addModel(handle);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_addSkinningModel);
+
+static bool JSB_removeSkinningModel(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 1) {
+        uint32_t handle = 0;
+        bool ok = seval_to_uint32(args[0], &handle);
+        SE_PRECONDITION2(ok, false, "JSB_removeSkinningModel : Error processing arguments");
+        cc::pipeline::SkinningSystem::getInstance()->removeModel(handle);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_removeSkinningModel);
+
+static bool JSB_updateSkinning(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 1) {
+        float dt = 0.f;
+        bool ok = seval_to_float(args[0], &dt);
+        SE_PRECONDITION2(ok, false, "JSB_updateSkinning : Error processing arguments");
+        cc::pipeline::SkinningSystem::getInstance()->update(dt);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_updateSkinning);
+
+static bool JSB_addMorphModel(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 1) {
+        uint32_t handle = 0;
+        bool ok = seval_to_uint32(args[0], &handle);
+        SE_PRECONDITION2(ok, false, "JSB_addMorphModel : Error processing arguments");
+        cc::pipeline::MorphSystem::getInstance()->addModel(handle);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_addMorphModel);
+
+static bool JSB_removeMorphModel(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 1) {
+        uint32_t handle = 0;
+        bool ok = seval_to_uint32(args[0], &handle);
+        SE_PRECONDITION2(ok, false, "JSB_removeMorphModel : Error processing arguments");
+        cc::pipeline::MorphSystem::getInstance()->removeModel(handle);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_removeMorphModel);
+
+static bool JSB_updateMorph(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        cc::pipeline::MorphSystem::getInstance()->update();
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(JSB_updateMorph);
+
+static bool JSB_packSparseMorphDeltas(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 3) {
+        uint32_t targetCount = 0;
+        uint32_t vertexCount = 0;
+        bool ok = args[0].isObject() && args[0].toObject()->isTypedArray() &&
+                  args[0].toObject()->getTypedArrayType() == se::Object::TypedArrayType::FLOAT32;
+        ok &= seval_to_uint32(args[1], &targetCount);
+        ok &= seval_to_uint32(args[2], &vertexCount);
+        SE_PRECONDITION2(ok, false, "JSB_packSparseMorphDeltas : Error processing arguments");
+        uint8_t *deltas = nullptr;
+        size_t length = 0;
+        args[0].toObject()->getTypedArrayData(&deltas, &length);
+        SE_PRECONDITION2(length >= static_cast<size_t>(targetCount) * vertexCount * 3 * sizeof(float), false, "JSB_packSparseMorphDeltas : Deltas are too short");
+
+        cc::vector<float> texels;
+        cc::vector<cc::pipeline::MorphTargetRange> ranges(targetCount);
+        cc::pipeline::MorphSystem::packSparseDeltas(reinterpret_cast<const float *>(deltas), targetCount, vertexCount, texels, ranges.data());
+        se::HandleObject result(se::Object::createPlainObject());
+        se::HandleObject texelArray(se::Object::createTypedArray(se::Object::TypedArrayType::FLOAT32, texels.data(), texels.size() * sizeof(float)));
+        se::HandleObject rangeArray(se::Object::createTypedArray(se::Object::TypedArrayType::UINT32, ranges.data(), ranges.size() * sizeof(cc::pipeline::MorphTargetRange)));
+        result->setProperty("texels", se::Value(texelArray));
+        result->setProperty("ranges", se::Value(rangeArray));
+        s.rval().setObject(result);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 3);
+    return false;
+}
+SE_BIND_FUNC(JSB_packSparseMorphDeltas);
+
+static bool layoutGlyphs(se::State &s, bool isSDF) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 2) {
+        cc::String font;
+        cc::String text;
+        bool ok = seval_to_std_string(args[0], &font);
+        ok &= seval_to_std_string(args[1], &text);
+        SE_PRECONDITION2(ok, false, "JSB_layoutGlyphs : Error processing arguments");
+        static cc::vector<float> quads;
+        quads.assign(1, 0.f);
+        auto *atlas = cc::pipeline::GlyphAtlas::getInstance();
+        const float advance = isSDF ? atlas->layoutSDF(font, text, quads) : atlas->layout(font, text, quads);
+        quads[0] = advance;
+        se::HandleObject array(se::Object::createTypedArray(se::Object::TypedArrayType::FLOAT32, quads.data(), quads.size() * sizeof(float)));
+        s.rval().setObject(array);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 2);
+    return false;
+}
+
+static bool JSB_layoutGlyphs(se::State &s) {
+    return layoutGlyphs(s, false);
+}
+SE_BIND_FUNC(JSB_layoutGlyphs);
+
+static bool JSB_layoutSDFGlyphs(se::State &s) {
+    return layoutGlyphs(s, true);
+}
+SE_BIND_FUNC(JSB_layoutSDFGlyphs);
+
+static bool JSB_updateGlyphAtlas(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        cc::pipeline::GlyphAtlas::getInstance()->update();
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(JSB_updateGlyphAtlas);
+
+static bool JSB_getGlyphAtlasPage(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 1) {
+        uint32_t index = 0;
+        bool ok = seval_to_uint32(args[0], &index);
+        SE_PRECONDITION2(ok, false, "JSB_getGlyphAtlasPage : Error processing arguments");
+        native_ptr_to_seval<cc::gfx::Texture>(cc::pipeline::GlyphAtlas::getInstance()->getPageTexture(index), &s.rval());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_getGlyphAtlasPage);
+
+static bool JSB_getGlyphAtlasGeneration(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        s.rval().setUint32(cc::pipeline::GlyphAtlas::getInstance()->getGeneration());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(JSB_getGlyphAtlasGeneration);
+
+static bool JSB_prefilterEnvironment(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 4) {
+        cc::gfx::Texture *texture = nullptr;
+        uint32_t size = 0;
+        bool isRGBE = false;
+        bool ok = seval_to_native_ptr(args[0], &texture);
+        ok &= args[1].isObject() && args[1].toObject()->isTypedArray();
+        ok &= seval_to_uint32(args[2], &size);
+        ok &= seval_to_boolean(args[3], &isRGBE);
+        SE_PRECONDITION2(ok, false, "JSB_prefilterEnvironment : Error processing arguments");
+        uint8_t *faces = nullptr;
+        size_t length = 0;
+        args[1].toObject()->getTypedArrayData(&faces, &length);
+        SE_PRECONDITION2(length >= static_cast<size_t>(size) * size * 6 * 4, false, "JSB_prefilterEnvironment : Faces are too short");
+        cc::pipeline::EnvironmentPrefilter::getInstance()->prefilter(texture, faces, size, isRGBE);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 4);
+    return false;
+}
+SE_BIND_FUNC(JSB_prefilterEnvironment);
+
+static bool JSB_cancelEnvironmentPrefilter(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 1) {
+        cc::gfx::Texture *texture = nullptr;
+        bool ok = seval_to_native_ptr(args[0], &texture);
+        SE_PRECONDITION2(ok, false, "JSB_cancelEnvironmentPrefilter : Error processing arguments");
+        cc::pipeline::EnvironmentPrefilter::getInstance()->cancel(texture);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_cancelEnvironmentPrefilter);
+
+static bool JSB_updateEnvironmentPrefilter(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        cc::pipeline::EnvironmentPrefilter::getInstance()->update();
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(JSB_updateEnvironmentPrefilter);
+
+static bool JSB_getEnvironmentIrradianceSH(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 1) {
+        cc::gfx::Texture *texture = nullptr;
+        bool ok = seval_to_native_ptr(args[0], &texture);
+        SE_PRECONDITION2(ok, false, "JSB_getEnvironmentIrradianceSH : Error processing arguments");
+        const float *sh = cc::pipeline::EnvironmentPrefilter::getInstance()->getIrradianceSH(texture);
+        if (sh) {
+            se::HandleObject array(se::Object::createTypedArray(se::Object::TypedArrayType::FLOAT32, sh, cc::pipeline::EnvironmentPrefilter::SH_FLOAT_COUNT * sizeof(float)));
+            s.rval().setObject(array);
+        } else {
+            s.rval().setNull();
+        }
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(JSB_getEnvironmentIrradianceSH);
+
 bool register_all_pipeline_manual(se::Object *obj) {
     // Get the ns
     se::Value nrVal;
@@ -60,6 +535,104 @@ bool register_all_pipeline_manual(se::Object *obj) {
     psmVal.setObject(jsobj);
     nr->setProperty("PipelineStateManager", psmVal);
     psmVal.toObject()->defineFunction("getOrCreatePipelineState", _SE(JSB_getOrCreatePipelineState));
+    psmVal.toObject()->defineFunction("prewarmPipelineState", _SE(JSB_prewarmPipelineState));
+    psmVal.toObject()->defineFunction("getPrewarmProgress", _SE(JSB_getPrewarmProgress));
+
+    // getRecordedNames() lists the variants, shader names with their defines, pipeline states were created with
+    // while recording; prewarm(path) creates the shaders of a saved file, before the device is asked for them
+    se::Value variantCollectorVal;
+    se::HandleObject variantCollectorObj(se::Object::createPlainObject());
+    variantCollectorVal.setObject(variantCollectorObj);
+    nr->setProperty("ShaderVariantCollector", variantCollectorVal);
+    variantCollectorVal.toObject()->defineFunction("setRecording", _SE(JSB_setShaderVariantRecording));
+    variantCollectorVal.toObject()->defineFunction("isRecording", _SE(JSB_isShaderVariantRecording));
+    variantCollectorVal.toObject()->defineFunction("getRecordedNames", _SE(JSB_getRecordedShaderVariants));
+    variantCollectorVal.toObject()->defineFunction("clear", _SE(JSB_clearShaderVariants));
+    variantCollectorVal.toObject()->defineFunction("save", _SE(JSB_saveShaderVariants));
+    variantCollectorVal.toObject()->defineFunction("prewarm", _SE(JSB_prewarmShaderVariants));
+
+    // counts of the last rendered frame, all zero in builds with CC_USE_FRAME_STATS 0
+    se::Value frameStatsVal;
+    se::HandleObject frameStatsObj(se::Object::createPlainObject());
+    frameStatsVal.setObject(frameStatsObj);
+    nr->setProperty("FrameStats", frameStatsVal);
+    frameStatsVal.toObject()->defineFunction("get", _SE(JSB_getFrameStats));
+    frameStatsVal.toObject()->setProperty("enabled", se::Value(CC_USE_FRAME_STATS != 0));
+
+    // the streams are allocated by a NativeBufferAllocator of PoolType.TRANSFORM, see TransformSystem.h
+    se::Value transformSystemVal;
+    se::HandleObject transformSystemObj(se::Object::createPlainObject());
+    transformSystemVal.setObject(transformSystemObj);
+    nr->setProperty("TransformSystem", transformSystemVal);
+    transformSystemVal.toObject()->defineFunction("update", _SE(JSB_updateTransforms));
+    transformSystemVal.toObject()->defineFunction("markHierarchyChanged", _SE(JSB_markTransformHierarchyChanged));
+    se::ScriptEngine::getInstance()->addBeforeCleanupHook([]() { cc::pipeline::TransformSystem::destroyInstance(); });
+
+    // tweens are TweenSpawn entries of a NativeBufferAllocator of PoolType.TWEEN, see TweenSystem.h;
+    // update(dt) returns the number of completed ids to read, call it before TransformSystem.update()
+    se::Value tweenSystemVal;
+    se::HandleObject tweenSystemObj(se::Object::createPlainObject());
+    tweenSystemVal.setObject(tweenSystemObj);
+    nr->setProperty("TweenSystem", tweenSystemVal);
+    tweenSystemVal.toObject()->defineFunction("spawn", _SE(JSB_spawnTweens));
+    tweenSystemVal.toObject()->defineFunction("stop", _SE(JSB_stopTween));
+    tweenSystemVal.toObject()->defineFunction("stopAll", _SE(JSB_stopAllTweens));
+    tweenSystemVal.toObject()->defineFunction("update", _SE(JSB_updateTweens));
+    se::ScriptEngine::getInstance()->addBeforeCleanupHook([]() { cc::pipeline::TweenSystem::destroyInstance(); });
+
+    // models are SkinningView handles of a NativeBufferPool of PoolType.SKINNING, see SkinningSystem.h
+    se::Value skinningSystemVal;
+    se::HandleObject skinningSystemObj(se::Object::createPlainObject());
+    skinningSystemVal.setObject(skinningSystemObj);
+    nr->setProperty("SkinningSystem", skinningSystemVal);
+    skinningSystemVal.toObject()->defineFunction("addModel", _SE(JSB_addSkinningModel));
+    skinningSystemVal.toObject()->defineFunction("removeModel", _SE(JSB_removeSkinningModel));
+    skinningSystemVal.toObject()->defineFunction("update", _SE(JSB_updateSkinning));
+    se::ScriptEngine::getInstance()->addBeforeCleanupHook([]() { cc::pipeline::SkinningSystem::destroyInstance(); });
+
+    // models are MorphView handles of a NativeBufferPool of PoolType.MORPH, see MorphSystem.h;
+    // packSparseDeltas(deltas, targetCount, vertexCount) returns the texels of the displacement texture and the
+    // MorphTargetRange of every target, 4 uint32 each, for the raw buffer of MorphView.rangesID
+    se::Value morphSystemVal;
+    se::HandleObject morphSystemObj(se::Object::createPlainObject());
+    morphSystemVal.setObject(morphSystemObj);
+    nr->setProperty("MorphSystem", morphSystemVal);
+    morphSystemVal.toObject()->defineFunction("addModel", _SE(JSB_addMorphModel));
+    morphSystemVal.toObject()->defineFunction("removeModel", _SE(JSB_removeMorphModel));
+    morphSystemVal.toObject()->defineFunction("update", _SE(JSB_updateMorph));
+    morphSystemVal.toObject()->defineFunction("packSparseDeltas", _SE(JSB_packSparseMorphDeltas));
+    se::ScriptEngine::getInstance()->addBeforeCleanupHook([]() { cc::pipeline::MorphSystem::destroyInstance(); });
+
+    // layout(font, text) and layoutSDF(font, text) return the advance followed by QUAD_FLOAT_COUNT floats a glyph,
+    // see GlyphAtlas.h for the quads and how the SDF pages are sampled;
+    // the page textures are replaced when the generation changes
+    se::Value glyphAtlasVal;
+    se::HandleObject glyphAtlasObj(se::Object::createPlainObject());
+    glyphAtlasVal.setObject(glyphAtlasObj);
+    nr->setProperty("GlyphAtlas", glyphAtlasVal);
+    glyphAtlasVal.toObject()->defineFunction("layout", _SE(JSB_layoutGlyphs));
+    glyphAtlasVal.toObject()->defineFunction("layoutSDF", _SE(JSB_layoutSDFGlyphs));
+    glyphAtlasVal.toObject()->defineFunction("update", _SE(JSB_updateGlyphAtlas));
+    glyphAtlasVal.toObject()->defineFunction("getPage", _SE(JSB_getGlyphAtlasPage));
+    glyphAtlasVal.toObject()->defineFunction("getGeneration", _SE(JSB_getGlyphAtlasGeneration));
+    glyphAtlasVal.toObject()->setProperty("QUAD_FLOAT_COUNT", se::Value(cc::pipeline::GlyphAtlas::QUAD_FLOAT_COUNT));
+    glyphAtlasVal.toObject()->setProperty("SDF_SIZE", se::Value(cc::pipeline::GlyphAtlas::SDF_SIZE));
+    glyphAtlasVal.toObject()->setProperty("SDF_SPREAD", se::Value(cc::pipeline::GlyphAtlas::SDF_SPREAD));
+    se::ScriptEngine::getInstance()->addBeforeCleanupHook([]() { cc::pipeline::GlyphAtlas::destroyInstance(); });
+
+    // prefilter(texture, faces, size, isRGBE) fills the mip chain of the cube texture from the RGBA8 faces on a
+    // worker thread, update() uploads the finished ones once a frame; getIrradianceSH(texture) returns the
+    // SH_FLOAT_COUNT floats of the irradiance, null until the texture is uploaded, see EnvironmentPrefilter.h
+    se::Value environmentPrefilterVal;
+    se::HandleObject environmentPrefilterObj(se::Object::createPlainObject());
+    environmentPrefilterVal.setObject(environmentPrefilterObj);
+    nr->setProperty("EnvironmentPrefilter", environmentPrefilterVal);
+    environmentPrefilterVal.toObject()->defineFunction("prefilter", _SE(JSB_prefilterEnvironment));
+    environmentPrefilterVal.toObject()->defineFunction("cancel", _SE(JSB_cancelEnvironmentPrefilter));
+    environmentPrefilterVal.toObject()->defineFunction("update", _SE(JSB_updateEnvironmentPrefilter));
+    environmentPrefilterVal.toObject()->defineFunction("getIrradianceSH", _SE(JSB_getEnvironmentIrradianceSH));
+    environmentPrefilterVal.toObject()->setProperty("SH_FLOAT_COUNT", se::Value(cc::pipeline::EnvironmentPrefilter::SH_FLOAT_COUNT));
+    se::ScriptEngine::getInstance()->addBeforeCleanupHook([]() { cc::pipeline::EnvironmentPrefilter::destroyInstance(); });
 
     __jsb_cc_pipeline_RenderPipeline_proto->defineProperty("macros", _SE(js_pipeline_RenderPipeline_getMacros), nullptr);
     return true;
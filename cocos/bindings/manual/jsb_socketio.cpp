@@ -101,13 +101,6 @@ public:
         se::ScriptEngine::getInstance()->clearException();
         se::AutoHandleScope hs;
 
-        if (cc::Application::getInstance() == nullptr)
-            return;
-
-        auto iter = se::NativePtrToObjectMap::find(client); //IDEA: client probably be a new value with the same address as the old one, it may cause undefined result.
-        if (iter == se::NativePtrToObjectMap::end())
-            return;
-
         se::Value dataVal;
         if (data.empty())
         {
@@ -118,6 +111,75 @@ public:
             dataVal.setString(data);
         }
 
+        se::ValueArray args;
+        args.push_back(dataVal);
+        callEvent(client, eventName, args);
+    }
+
+    // The arguments go to the callback as they were received, the attachments follow them as an array of ArrayBuffers.
+    virtual void fireEventDataToScript(SIOClient* client, const std::string& eventName, const char* data, size_t length, SIOAttachments& attachments) override
+    {
+        CC_LOG_DEBUG("JSB SocketIO::SIODelegate->fireEventDataToScript method called from native with name '%s' and %d attachments", eventName.c_str(), static_cast<int>(attachments.size()));
+
+        se::ScriptEngine::getInstance()->clearException();
+        se::AutoHandleScope hs;
+
+        se::ValueArray args;
+        args.resize(1);
+        if (length == 0)
+        {
+            args[0].setNull();
+        }
+        else
+        {
+            args[0].setString(std::string(data, length));
+        }
+
+        if (!attachments.empty())
+        {
+            se::HandleObject array(se::Object::createArrayObject(attachments.size()));
+            for (size_t i = 0; i < attachments.size(); ++i)
+            {
+                auto& attachment = attachments[i];
+                const size_t offset = std::min(attachment.offset, attachment.buffer.size());
+                const size_t byteLength = attachment.buffer.size() - offset;
+#if SCRIPT_ENGINE_TYPE == SCRIPT_ENGINE_V8
+                // the array buffer takes the buffer of the message, it's freed when the engine releases the backing store
+                auto holder = new std::vector<unsigned char>(std::move(attachment.buffer));
+                se::HandleObject arrayBuffer(se::Object::createExternalArrayBufferObject(holder->data() + offset, byteLength, [](void*, size_t, void* userData) {
+                    delete static_cast<std::vector<unsigned char>*>(userData);
+                }, holder));
+#else
+                se::HandleObject arrayBuffer(se::Object::createArrayBufferObject(attachment.buffer.data() + offset, byteLength));
+#endif
+                array->setArrayElement(static_cast<uint32_t>(i), se::Value(arrayBuffer));
+            }
+            args.push_back(se::Value(array));
+        }
+
+        callEvent(client, eventName, args);
+    }
+
+    void addEvent(const std::string& eventName, const se::Value& callback, const se::Value& target)
+    {
+        assert(callback.isObject() && callback.toObject()->isFunction());
+        assert(target.isObject());
+        _eventRegistry[eventName].clear();
+        _eventRegistry[eventName].push_back(callback);
+        _eventRegistry[eventName].push_back(target);
+        target.toObject()->attachObject(callback.toObject());
+    }
+
+private:
+    void callEvent(SIOClient* client, const std::string& eventName, const se::ValueArray& args)
+    {
+        if (cc::Application::getInstance() == nullptr)
+            return;
+
+        auto iter = se::NativePtrToObjectMap::find(client); //IDEA: client probably be a new value with the same address as the old one, it may cause undefined result.
+        if (iter == se::NativePtrToObjectMap::end())
+            return;
+
         JSB_SIOCallbackRegistry::iterator it = _eventRegistry.find(eventName);
 
         if (it != _eventRegistry.end())
@@ -128,8 +190,6 @@ public:
             const se::Value& target = cbStruct[1];
             if (callback.isObject() && callback.toObject()->isFunction() && target.isObject())
             {
-                se::ValueArray args;
-                args.push_back(dataVal);
                 callback.toObject()->call(args, target.toObject());
             }
         }
@@ -140,17 +200,6 @@ public:
         }
     }
 
-    void addEvent(const std::string& eventName, const se::Value& callback, const se::Value& target)
-    {
-        assert(callback.isObject() && callback.toObject()->isFunction());
-        assert(target.isObject());
-        _eventRegistry[eventName].clear();
-        _eventRegistry[eventName].push_back(callback);
-        _eventRegistry[eventName].push_back(target);
-        target.toObject()->attachObject(callback.toObject());
-    }
-
-private:
     JSB_SIOCallbackRegistry _eventRegistry;
 };
 
@@ -240,6 +289,32 @@ static bool SocketIO_emit(se::State& s)
             }
         }
 
+        // emit(eventName, payload, [ArrayBuffer or typed array, ...]) sends a binary event
+        if (argc >= 3 && args[2].isObject() && args[2].toObject()->isArray())
+        {
+            se::Object* array = args[2].toObject();
+            uint32_t length = 0;
+            array->getArrayLength(&length);
+            SIOAttachments attachments(length);
+            se::Value element;
+            for (uint32_t i = 0; i < length; ++i)
+            {
+                uint8_t* data = nullptr;
+                size_t byteLength = 0;
+                ok = array->getArrayElement(i, &element) && element.isObject();
+                if (ok)
+                {
+                    se::Object* obj = element.toObject();
+                    ok = obj->isTypedArray() ? obj->getTypedArrayData(&data, &byteLength)
+                                             : obj->isArrayBuffer() && obj->getArrayBufferData(&data, &byteLength);
+                }
+                SE_PRECONDITION2(ok, false, "Converting attachment %u failed, an ArrayBuffer or a typed array is expected!", i);
+                attachments[i].buffer.assign(data, data + byteLength);
+            }
+            cobj->emit(eventName, payload, attachments);
+            return true;
+        }
+
         cobj->emit(eventName, payload);
         return true;
     }
@@ -113,20 +113,18 @@ static bool js_register_spine_initSkeletonData (se::State& s)
         auto fileUtils = cc::FileUtils::getInstance();
         if (fileUtils->isFileExist(skeletonDataFile))
         {
-            cc::Data cocos2dData;
             const auto fullpath = fileUtils->fullPathForFilename(skeletonDataFile);
-            fileUtils->getContents(fullpath, &cocos2dData);
+            cc::MappedFile skeletonFile = fileUtils->mapFile(fullpath);
             
             spine::SkeletonBinary binary(attachmentLoader);
             binary.setScale(scale);
-            skeletonData = binary.readSkeletonData(cocos2dData.getBytes(), (int)cocos2dData.getSize());
+            skeletonData = binary.readSkeletonData(skeletonFile.getBytes(), (int)skeletonFile.getSize());
             CCASSERT(skeletonData, !binary.getError().isEmpty() ? binary.getError().buffer() : "Error reading binary skeleton data.");
         }
     } else {
-        spine::SkeletonJson json(attachmentLoader);
-        json.setScale(scale);
-        skeletonData = json.readSkeletonData(skeletonDataFile.c_str());
-        CCASSERT(skeletonData, !json.getError().isEmpty() ? json.getError().buffer() : "Error reading json skeleton data.");
+        std::string error;
+        skeletonData = mgr->readJsonSkeletonData(uuid, skeletonDataFile, atlasText, attachmentLoader, scale, error);
+        CCASSERT(skeletonData, !error.empty() ? error.c_str() : "Error reading json skeleton data.");
     }
     
     if (skeletonData) {
@@ -135,7 +135,24 @@ void JSB_WebSocketDelegate::onMessage(WebSocket* ws, const WebSocket::Data& data
 
         if (data.isBinary)
         {
+#if SCRIPT_ENGINE_TYPE == SCRIPT_ENGINE_V8
+            // the array buffer takes the native buffer of the message, it's freed when the engine releases the backing store
+            se::Object* arrayBuffer = nullptr;
+            if (data.buffer != nullptr && data.len > 0)
+            {
+                auto holder = new std::vector<unsigned char>(std::move(*data.buffer));
+                arrayBuffer = se::Object::createExternalArrayBufferObject(holder->data(), data.len, [](void*, size_t, void* userData) {
+                    delete static_cast<std::vector<unsigned char>*>(userData);
+                }, holder);
+            }
+            else
+            {
+                arrayBuffer = se::Object::createArrayBufferObject(data.bytes, data.len);
+            }
+            se::HandleObject dataObj(arrayBuffer);
+#else
             se::HandleObject dataObj(se::Object::createArrayBufferObject(data.bytes, data.len));
+#endif
             jsObj->setProperty("data", se::Value(dataObj));
         }
         else
@@ -551,6 +568,28 @@ static bool WebSocket_getExtensions(se::State& s)
 }
 SE_BIND_PROP_GET(WebSocket_getExtensions)
 
+static bool WebSocket_getDeflateWindowBits(se::State& s)
+{
+    s.rval().setInt32(WebSocket::getDeflateWindowBits());
+    return true;
+}
+SE_BIND_PROP_GET(WebSocket_getDeflateWindowBits)
+
+static bool WebSocket_setDeflateWindowBits(se::State& s)
+{
+    const auto& args = s.args();
+    int argc = (int)args.size();
+
+    if (argc == 1 && args[0].isNumber())
+    {
+        WebSocket::setDeflateWindowBits(args[0].toInt32());
+        return true;
+    }
+    SE_REPORT_ERROR("wrong arguments: %d, was expecting a number", argc);
+    return false;
+}
+SE_BIND_PROP_SET(WebSocket_setDeflateWindowBits)
+
 #define WEBSOCKET_DEFINE_READONLY_INT_FIELD(full_name, value) \
 static bool full_name(se::State& s) \
 { \
@@ -594,6 +633,7 @@ bool register_all_websocket(se::Object* obj)
     tmp.toObject()->defineProperty("CLOSING", _SE(Websocket_CLOSING), nullptr);
     tmp.toObject()->defineProperty("OPEN", _SE(Websocket_OPEN), nullptr);
     tmp.toObject()->defineProperty("CLOSED", _SE(Websocket_CLOSED), nullptr);
+    tmp.toObject()->defineProperty("deflateWindowBits", _SE(WebSocket_getDeflateWindowBits), _SE(WebSocket_setDeflateWindowBits));
 
     JSBClassType::registerClass<WebSocket>(cls);
 
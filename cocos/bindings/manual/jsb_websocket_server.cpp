@@ -332,6 +332,94 @@ static bool WebSocketServer_close(se::State& s)
 SE_BIND_FUNC(WebSocketServer_close)
 
 
+static bool WebSocketServer_broadcast(se::State& s)
+{
+    const auto& args = s.args();
+    int argc = (int)args.size();
+
+    WSSPTR cobj = (WSSPTR)s.nativeThisObject();
+
+    if (argc >= 1)
+    {
+        std::function<void(const std::string & cb)> callback;
+        if (args[argc - 1].isObject() && args[argc - 1].toObject()->isFunction())
+        {
+            std::string callbackId = gen_send_index();
+            s.thisObject()->setProperty(callbackId.c_str(), args[argc - 1]);
+            std::weak_ptr<WebSocketServer> serverWeak = *cobj;
+
+            callback = [callbackId, serverWeak](const std::string& err) {
+                se::AutoHandleScope hs;
+                auto server = serverWeak.lock();
+                if (!server) {
+                    return;
+                }
+                se::Object* sobj = (se::Object*)server->getData();
+                if (!sobj) {
+                    return;
+                }
+                se::Value callback;
+                if (!sobj->getProperty(callbackId.c_str(), &callback)) {
+                    SE_REPORT_ERROR("broadcast[%s] callback not found!", callbackId.c_str());
+                    return;
+                }
+                se::ValueArray args;
+                if (!err.empty())
+                {
+                    args.push_back(se::Value(err));
+                }
+                bool success = callback.toObject()->call(args, sobj, nullptr);
+                if (!success) {
+                    se::ScriptEngine::getInstance()->clearException();
+                }
+                sobj->deleteProperty(callbackId.c_str());
+            };
+        }
+
+        bool ok = false;
+        if (args[0].isString())
+        {
+            std::string data;
+            ok = seval_to_std_string(args[0], &data);
+            SE_PRECONDITION2(ok, false, "Convert string failed");
+            (*cobj)->broadcastTextAsync(data, callback);
+        }
+        else if (args[0].isObject())
+        {
+            se::Object* dataObj = args[0].toObject();
+            uint8_t* ptr = nullptr;
+            size_t length = 0;
+            if (dataObj->isArrayBuffer())
+            {
+                ok = dataObj->getArrayBufferData(&ptr, &length);
+                SE_PRECONDITION2(ok, false, "getArrayBufferData failed!");
+            }
+            else if (dataObj->isTypedArray())
+            {
+                ok = dataObj->getTypedArrayData(&ptr, &length);
+                SE_PRECONDITION2(ok, false, "getTypedArrayData failed!");
+            }
+            else
+            {
+                SE_REPORT_ERROR("wrong argument type, string, ArrayBuffer or TypedArray expected");
+                return false;
+            }
+
+            (*cobj)->broadcastBinaryAsync(ptr, length, callback);
+        }
+        else
+        {
+            SE_REPORT_ERROR("wrong argument type, string, ArrayBuffer or TypedArray expected");
+            return false;
+        }
+
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting 1, 2", argc);
+    return false;
+}
+SE_BIND_FUNC(WebSocketServer_broadcast)
+
 static bool WebSocketServer_connections(se::State& s) {
     const auto& args = s.args();
     int argc = (int)args.size();
@@ -900,6 +988,7 @@ bool register_all_websocket_server(se::Object* obj)
 
     cls->defineFunction("close", _SE(WebSocketServer_close));
     cls->defineFunction("listen", _SE(WebSocketServer_listen));
+    cls->defineFunction("broadcast", _SE(WebSocketServer_broadcast));
     cls->defineProperty("onconnection", nullptr, _SE(WebSocketServer_onconnection));
     cls->defineProperty("onclose", nullptr, _SE(WebSocketServer_onclose));
     cls->defineProperty("connections", _SE(WebSocketServer_connections), nullptr);
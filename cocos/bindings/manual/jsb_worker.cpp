@@ -0,0 +1,181 @@
+#include "jsb_worker.h"
+#include "cocos/bindings/jswrapper/SeApi.h"
+#include "cocos/bindings/manual/jsb_conversions.h"
+#include "cocos/bindings/manual/jsb_global.h"
+
+#if SCRIPT_ENGINE_TYPE == SCRIPT_ENGINE_V8
+    #include "cocos/bindings/jswrapper/v8/Utils.h"
+    #include "cocos/bindings/jswrapper/v8/Worker.h"
+    #include "base/Scheduler.h"
+    #include "platform/Application.h"
+
+    #include <algorithm>
+    #include <vector>
+
+namespace {
+
+struct WorkerEntry {
+    se::Worker *worker = nullptr;
+    se::Object *obj = nullptr;
+};
+
+// Workers still running or with messages left, their JS objects are rooted until the last message is delivered.
+std::vector<WorkerEntry> liveWorkers;
+
+se::Class *__jsb_Worker_class = nullptr;
+
+const char *WORKER_SCHEDULE_KEY = "jsb_worker";
+int workerTarget = 0;
+
+void dispatchWorkerMessage(se::Object *obj, se::Worker::Message &message) {
+    se::AutoHandleScope hs;
+
+    const bool isError = message.type == se::Worker::Message::Type::EXCEPTION;
+    se::HandleObject eventObj(se::Object::createPlainObject());
+    if (isError) {
+        eventObj->setProperty("message", se::Value(message.text));
+    } else {
+        v8::Isolate *isolate = v8::Isolate::GetCurrent();
+        v8::Local<v8::Value> jsval;
+        if (!se::Worker::fromMessage(isolate, message).ToLocal(&jsval)) {
+            SE_LOGE("Worker: can't convert a message of the worker\n");
+            return;
+        }
+        se::Value data;
+        se::internal::jsToSeValue(isolate, jsval, &data);
+        eventObj->setProperty("data", data);
+    }
+
+    se::Value func;
+    if (obj->getProperty(isError ? "onerror" : "onmessage", &func) && func.isObject() && func.toObject()->isFunction()) {
+        se::ValueArray args;
+        args.push_back(se::Value(eventObj));
+        func.toObject()->call(args, obj);
+    } else if (isError) {
+        SE_LOGE("Worker: %s\n", message.text.c_str());
+    }
+}
+
+void drainWorkers(float /*dt*/) {
+    se::Worker::Message message;
+    // handlers may create or terminate workers, so iterate over a snapshot
+    std::vector<WorkerEntry> entries = liveWorkers;
+    for (const auto &entry : entries) {
+        // tested first, what a closed worker posted before exiting is still delivered
+        const bool isRunning = entry.worker->isRunning();
+        while (entry.worker->takeMessage(&message)) {
+            dispatchWorkerMessage(entry.obj, message);
+        }
+        if (!isRunning) {
+            auto iter = std::find_if(liveWorkers.begin(), liveWorkers.end(), [&](const WorkerEntry &e) { return e.worker == entry.worker; });
+            if (iter != liveWorkers.end()) {
+                liveWorkers.erase(iter);
+                entry.obj->unroot();
+            }
+        }
+    }
+
+    if (liveWorkers.empty()) {
+        cc::Application::getInstance()->getScheduler()->unschedule(WORKER_SCHEDULE_KEY, &workerTarget);
+    }
+}
+
+void terminateAllWorkers() {
+    for (const auto &entry : liveWorkers) {
+        entry.worker->terminate();
+        entry.obj->unroot();
+    }
+    liveWorkers.clear();
+}
+
+} // namespace
+
+static bool Worker_finalize(se::State &s) {
+    auto *cobj = static_cast<se::Worker *>(s.nativeThisObject());
+    delete cobj;
+    return true;
+}
+SE_BIND_FINALIZE_FUNC(Worker_finalize)
+
+static bool Worker_constructor(se::State &s) {
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 1) {
+        std::string path;
+        bool ok = seval_to_std_string(args[0], &path);
+        SE_PRECONDITION2(ok, false, "Worker_constructor : Error processing arguments");
+
+        se::Object *obj = s.thisObject();
+        auto *cobj = new se::Worker(path);
+        obj->setPrivateData(cobj);
+        obj->root(); // unrooted once the worker stopped and its messages are delivered
+
+        if (liveWorkers.empty()) {
+            cc::Application::getInstance()->getScheduler()->schedule(drainWorkers, &workerTarget, 0.f, false, WORKER_SCHEDULE_KEY);
+        }
+        liveWorkers.push_back({cobj, obj});
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_CTOR(Worker_constructor, __jsb_Worker_class, Worker_finalize)
+
+static bool Worker_postMessage(se::State &s) {
+    auto *cobj = static_cast<se::Worker *>(s.nativeThisObject());
+    SE_PRECONDITION2(cobj, false, "Worker_postMessage : Invalid Native Object");
+    const auto &args = s.args();
+    size_t argc = args.size();
+    if (argc == 1) {
+        v8::Isolate *isolate = v8::Isolate::GetCurrent();
+        v8::Local<v8::Value> jsval;
+        se::internal::seToJsValue(isolate, args[0], &jsval);
+
+        se::Worker::Message message;
+        bool ok = se::Worker::toMessage(isolate, jsval, &message);
+        SE_PRECONDITION2(ok, false, "Worker_postMessage : the message can't be passed to a worker");
+        cobj->postMessage(std::move(message));
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(Worker_postMessage)
+
+static bool Worker_terminate(se::State &s) {
+    auto *cobj = static_cast<se::Worker *>(s.nativeThisObject());
+    SE_PRECONDITION2(cobj, false, "Worker_terminate : Invalid Native Object");
+    cobj->terminate();
+    return true;
+}
+SE_BIND_FUNC(Worker_terminate)
+
+bool register_all_worker(se::Object *obj) {
+    se::Value nsVal;
+    if (!obj->getProperty("jsb", &nsVal)) {
+        se::HandleObject jsobj(se::Object::createPlainObject());
+        nsVal.setObject(jsobj);
+        obj->setProperty("jsb", nsVal);
+    }
+    se::Object *ns = nsVal.toObject();
+
+    se::Class *cls = se::Class::create("Worker", ns, nullptr, _SE(Worker_constructor));
+    cls->defineFinalizeFunction(_SE(Worker_finalize));
+    cls->defineFunction("postMessage", _SE(Worker_postMessage));
+    cls->defineFunction("terminate", _SE(Worker_terminate));
+    cls->install();
+    __jsb_Worker_class = cls;
+
+    se::ScriptEngine::getInstance()->addBeforeCleanupHook(terminateAllWorkers);
+
+    se::ScriptEngine::getInstance()->clearException();
+    return true;
+}
+
+#else
+
+bool register_all_worker(se::Object * /*obj*/) {
+    return true;
+}
+
+#endif // SCRIPT_ENGINE_TYPE == SCRIPT_ENGINE_V8
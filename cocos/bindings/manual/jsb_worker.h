@@ -0,0 +1,8 @@
+#pragma once
+
+namespace se {
+class Object;
+}
+
+// Registers jsb.Worker, a script run on a thread of its own, V8 only.
+bool register_all_worker(se::Object *obj);
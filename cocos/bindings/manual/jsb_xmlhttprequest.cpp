@@ -144,6 +144,7 @@ public:
     std::function<void()> onabort;
     std::function<void()> onerror;
     std::function<void()> ontimeout;
+    std::function<void(long long loaded, long long total)> onprogress;
 
     XMLHttpRequest();
 
@@ -161,7 +162,7 @@ public:
     uint16_t getStatus() const { return _status; }
     const std::string& getStatusText() const { return _statusText; }
     const std::string& getResponseText() const { return _responseText; }
-    const cc::Data& getResponseData() const { return _responseData; }
+    const std::shared_ptr<std::vector<char>>& getResponseData() const { return _responseData; }
     ResponseType getResponseType() const { return _responseType; }
     void setResponseType(ResponseType type) { _responseType = type; }
 
@@ -175,12 +176,16 @@ public:
 
     bool isDiscardedByReset() const { return _isDiscardedByReset; }
 
+    // The body is streamed to onprogress only while JS listens to it
+    void setProgressObserved(bool isObserved) { _isProgressObserved = isObserved; }
+
 private:
     virtual ~XMLHttpRequest();
 
     void setReadyState(ReadyState readyState);
-    void getHeader(const std::string& header);
+    void setStatusText(const std::string& statusLine);
     void onResponse(cc::network::HttpClient* client, cc::network::HttpResponse* response);
+    void onResponseData(const char* data, size_t size, long long totalSize);
 
     void setHttpRequestData(const char* data, size_t len);
     void sendRequest();
@@ -196,7 +201,9 @@ private:
     std::string _statusText;
     std::string _overrideMimeType;
 
-    cc::Data _responseData;
+    // taken from the HttpResponse without copying, js array buffers are created over it
+    std::shared_ptr<std::vector<char>> _responseData;
+    long long _receivedSize;
 
     cc::network::HttpRequest*  _httpRequest;
 //    cc::EventListenerCustom* _resetDirectorListener;
@@ -215,6 +222,7 @@ private:
     bool _isDiscardedByReset;
     bool _isTimeout;
     bool _isSending;
+    bool _isProgressObserved;
 };
 
 XMLHttpRequest::XMLHttpRequest()
@@ -225,8 +233,10 @@ XMLHttpRequest::XMLHttpRequest()
 , onabort(nullptr)
 , onerror(nullptr)
 , ontimeout(nullptr)
+, onprogress(nullptr)
 , _httpRequest(new (std::nothrow) HttpRequest())
 , _timeoutInMilliseconds(0UL)
+, _receivedSize(0)
 , _status(0)
 , _responseType(ResponseType:: STRING)
 , _readyState(ReadyState::UNSENT)
@@ -238,6 +248,7 @@ XMLHttpRequest::XMLHttpRequest()
 , _isDiscardedByReset(false)
 , _isTimeout(false)
 , _isSending(false)
+, _isProgressObserved(false)
 {
 }
 
@@ -335,6 +346,7 @@ void XMLHttpRequest::abort()
     
     //request is aborted, no more callback needed.
     _httpRequest->setResponseCallback(nullptr);
+    _httpRequest->setResponseDataCallback(nullptr);
 }
 
 void XMLHttpRequest::setReadyState(ReadyState readyState)
@@ -349,58 +361,23 @@ void XMLHttpRequest::setReadyState(ReadyState readyState)
     }
 }
 
-void XMLHttpRequest::getHeader(const std::string& header)
+void XMLHttpRequest::setStatusText(const std::string& statusLine)
 {
-    // check for colon.
-    size_t found_header_field = header.find_first_of(":");
-
-    if (found_header_field != std::string::npos)
+    // Split the status line into tokens
+    int _v1, _v2, code = 0;
+    char statusText[64] = {0};
+    sscanf(statusLine.c_str(), "HTTP/%d.%d %d %63[^\n]", &_v1, &_v2, &code, statusText);
+    _statusText = statusText;
+    if(_statusText.empty())
     {
-        // Found a header field.
-        std::string http_field;
-        std::string http_value;
-
-        http_field = header.substr(0,found_header_field);
-        http_value = header.substr(found_header_field+1, header.length());
-
-        // Get rid of all \n
-        if (!http_value.empty() && http_value[http_value.size() - 1] == '\n') {
-            http_value.erase(http_value.size() - 1);
-        }
-
-        // Get rid of leading space (header is field: value format)
-        if (!http_value.empty() && http_value[0] == ' ') {
-            http_value.erase(0, 1);
+        auto itCode = _httpStatusCodeMap.find(code);
+        if(itCode != _httpStatusCodeMap.end())
+        {
+            _statusText = itCode->second;
         }
-
-        // Transform field name to lower case as they are case-insensitive
-        std::transform(http_field.begin(), http_field.end(), http_field.begin(), ::tolower);
-
-        _httpHeader[http_field] = http_value;
-
-    }
-    else
-    {
-        // Get Header and Set StatusText
-        // Split String into Tokens
-        if (header.find("HTTP") == 0)
+        else 
         {
-            int _v1, _v2, code = 0;
-            char statusText[64] = {0};
-            sscanf(header.c_str(), "HTTP/%d.%d %d %63[^\n]", &_v1, &_v2, &code, statusText);
-            _statusText = statusText;
-            if(_statusText.empty())
-            {
-                auto itCode = _httpStatusCodeMap.find(code);
-                if(itCode != _httpStatusCodeMap.end())
-                {
-                    _statusText = itCode->second;
-                }
-                else 
-                {
-                    CC_LOG_DEBUG("XMLHTTPRequest invalid response code %d", code);
-                }
-            }
+            CC_LOG_DEBUG("XMLHTTPRequest invalid response code %d", code);
         }
     }
 }
@@ -435,7 +412,7 @@ void XMLHttpRequest::onResponse(HttpClient* client, HttpResponse* response)
     sprintf(statusString, "HTTP Status Code: %ld, tag = %s", statusCode, tag.c_str());
 
     _responseText.clear();
-    _responseData.clear();
+    _responseData.reset();
 
     if (!response->isSucceed())
     {
@@ -460,28 +437,39 @@ void XMLHttpRequest::onResponse(HttpClient* client, HttpResponse* response)
         }
     }
 
-    // set header
-    std::vector<char> *headers = response->getResponseHeader();
+    // set header, the values are already split from the names and trimmed by the client
+    const HttpHeaders& headers = response->getResponseHeaders();
+    for (size_t i = 0; i < headers.size(); ++i)
+    {
+        HttpHeaders::View field = headers.getName(i);
+        if (field.size == headers.getLine(i).size)
+        {
+            continue;
+        }
 
-    std::string header(headers->begin(), headers->end());
+        // Transform field name to lower case as they are case-insensitive
+        std::string http_field = field.str();
+        std::transform(http_field.begin(), http_field.end(), http_field.begin(), ::tolower);
+        _httpHeader[http_field] = headers.getValue(i).str();
+    }
 
-    std::istringstream stream(header);
-    std::string line;
-    while(std::getline(stream, line))
+    HttpHeaders::View statusLine = headers.getStatusLine();
+    if (!statusLine.empty())
     {
-        getHeader(line);
+        setStatusText(statusLine.str());
     }
 
     /** get the response data **/
     std::vector<char>* buffer = response->getResponseData();
 
-    if (_responseType == ResponseType::STRING || _responseType == ResponseType::JSON)
+    if (_responseType == ResponseType::STRING)
     {
         _responseText.append(buffer->data(), buffer->size());
     }
     else
     {
-        _responseData.copy((unsigned char*)buffer->data(), buffer->size());
+        // json is parsed from the body too
+        _responseData = std::make_shared<std::vector<char>>(std::move(*buffer));
     }
 
     _status = statusCode;
@@ -500,6 +488,28 @@ void XMLHttpRequest::onResponse(HttpClient* client, HttpResponse* response)
     }
 }
 
+// The text chunks are appended to responseText while LOADING, the other responses are only created when DONE
+void XMLHttpRequest::onResponseData(const char* data, size_t size, long long totalSize)
+{
+    if (_isTimeout || _isAborted || _readyState == ReadyState::UNSENT)
+    {
+        return;
+    }
+
+    _receivedSize += size;
+    if (_responseType == ResponseType::STRING)
+    {
+        _responseText.append(data, size);
+    }
+
+    setReadyState(ReadyState::LOADING);
+
+    if (onprogress != nullptr)
+    {
+        onprogress(_receivedSize, totalSize);
+    }
+}
+
 void XMLHttpRequest::overrideMimeType(const std::string &mimeType)
 {
     _overrideMimeType = mimeType;
@@ -535,7 +545,19 @@ void XMLHttpRequest::sendRequest()
     }
     setHttpRequestHeader();
 
+    _receivedSize = 0;
+    _responseText.clear();
     _httpRequest->setResponseCallback(CC_CALLBACK_2(XMLHttpRequest::onResponse, this));
+    if (_isProgressObserved)
+    {
+        _httpRequest->setResponseDataCallback([this](HttpClient*, HttpResponse*, const char* data, size_t size, long long totalSize) {
+            onResponseData(data, size, totalSize);
+        });
+    }
+    else
+    {
+        _httpRequest->setResponseDataCallback(nullptr);
+    }
     cc::network::HttpClient::getInstance()->sendImmediate(_httpRequest);
 
     if (onloadstart != nullptr)
@@ -606,29 +628,16 @@ std::string XMLHttpRequest::getResonpseHeader(const std::string& key) const
 
 void XMLHttpRequest::setHttpRequestHeader()
 {
-    std::vector<std::string> header;
-
-    for (auto it = _requestHeader.begin(); it != _requestHeader.end(); ++it)
+    if (_requestHeader.empty())
     {
-        const char* first = it->first.c_str();
-        const char* second = it->second.c_str();
-        size_t len = sizeof(char) * (strlen(first) + 3 + strlen(second));
-        char* test = (char*) malloc(len);
-        memset(test, 0, len);
-
-        strcpy(test, first);
-        strcpy(test + strlen(first) , ": ");
-        strcpy(test + strlen(first) + 2, second);
-
-        header.push_back(test);
-
-        free(test);
-
+        return;
     }
 
-    if (!header.empty())
+    // the headers of the request replace the ones of its previous send, in the buffer they used
+    _httpRequest->clearHeaders();
+    for (auto it = _requestHeader.begin(); it != _requestHeader.end(); ++it)
     {
-        _httpRequest->setHeaders(header);
+        _httpRequest->addHeader(it->first, it->second);
     }
 }
 
@@ -723,6 +732,29 @@ static bool XMLHttpRequest_constructor(se::State& s)
             cb("ontimeout");
         }
     };
+    request->onprogress = [=](long long loaded, long long total){
+        if (request->isDiscardedByReset())
+        {
+            return;
+        }
+        se::ScriptEngine::getInstance()->clearException();
+        se::AutoHandleScope hs;
+
+        se::Object* thizObj = thiz.toObject();
+
+        se::Value func;
+        if (thizObj->getProperty("onprogress", &func) && func.isObject() && func.toObject()->isFunction())
+        {
+            se::HandleObject event(se::Object::createPlainObject());
+            event->setProperty("type", se::Value("progress"));
+            event->setProperty("loaded", se::Value((double)loaded));
+            event->setProperty("total", se::Value(total > 0 ? (double)total : 0.0));
+            event->setProperty("lengthComputable", se::Value(total > 0));
+            se::ValueArray args;
+            args.push_back(se::Value(event.get()));
+            func.toObject()->call(args, thizObj);
+        }
+    };
     return true;
 }
 SE_BIND_CTOR(XMLHttpRequest_constructor, __jsb_XMLHttpRequest_class, XMLHttpRequest_finalize)
@@ -765,6 +797,9 @@ static bool XMLHttpRequest_send(se::State& s)
     size_t argc = args.size();
     XMLHttpRequest* request = (XMLHttpRequest*)s.nativeThisObject();
 
+    se::Value onprogress;
+    request->setProgressObserved(s.thisObject()->getProperty("onprogress", &onprogress) && onprogress.isObject() && onprogress.toObject()->isFunction());
+
     if (argc == 0)
     {
         request->send();
@@ -944,7 +979,16 @@ SE_BIND_PROP_GET(XMLHttpRequest_getStatusText)
 static bool XMLHttpRequest_getResponseText(se::State& s)
 {
     XMLHttpRequest* xhr = (XMLHttpRequest*)s.nativeThisObject();
-    s.rval().setString(xhr->getResponseText());
+    const auto& data = xhr->getResponseData();
+    if (xhr->getResponseType() == XMLHttpRequest::ResponseType::JSON && data)
+    {
+        // the json body is only kept as the data it's parsed from
+        s.rval().setString(std::string(data->data(), data->size()));
+    }
+    else
+    {
+        s.rval().setString(xhr->getResponseText());
+    }
     return true;
 }
 SE_BIND_PROP_GET(XMLHttpRequest_getResponseText)
@@ -976,21 +1020,57 @@ static bool XMLHttpRequest_getResponse(se::State& s)
         {
             if (xhr->getResponseType() == XMLHttpRequest::ResponseType::JSON)
             {
-                const std::string& jsonText = xhr->getResponseText();
-                se::HandleObject seObj(se::Object::createJSONObject(jsonText));
-                if (!seObj.isEmpty())
+                const auto& data = xhr->getResponseData();
+                if (!data || data->empty())
                 {
-                    s.rval().setObject(seObj);
+                    s.rval().setNull();
                 }
                 else
                 {
-                    s.rval().setNull();
+#if SCRIPT_ENGINE_TYPE == SCRIPT_ENGINE_V8
+                    // parsed straight from the body, the source string of ASCII json holds a reference to it
+                    auto holder = new std::shared_ptr<std::vector<char>>(data);
+                    bool ok = se::Object::parseJSON(data->data(), data->size(), &s.rval(), [](void*, size_t, void* userData) {
+                        delete static_cast<std::shared_ptr<std::vector<char>>*>(userData);
+                    }, holder);
+                    if (!ok)
+                    {
+                        s.rval().setNull();
+                    }
+#else
+                    se::HandleObject seObj(se::Object::createJSONObject(std::string(data->data(), data->size())));
+                    if (!seObj.isEmpty())
+                    {
+                        s.rval().setObject(seObj);
+                    }
+                    else
+                    {
+                        s.rval().setNull();
+                    }
+#endif
                 }
             }
             else if (xhr->getResponseType() == XMLHttpRequest::ResponseType::ARRAY_BUFFER)
             {
-                const Data& data = xhr->getResponseData();
-                se::HandleObject seObj(se::Object::createArrayBufferObject(data.getBytes(), data.getSize()));
+                const auto& data = xhr->getResponseData();
+#if SCRIPT_ENGINE_TYPE == SCRIPT_ENGINE_V8
+                // the array buffer shares the body, it holds a reference to it until the engine releases the backing store
+                se::Object* arrayBuffer = nullptr;
+                if (data && !data->empty())
+                {
+                    auto holder = new std::shared_ptr<std::vector<char>>(data);
+                    arrayBuffer = se::Object::createExternalArrayBufferObject(data->data(), data->size(), [](void*, size_t, void* userData) {
+                        delete static_cast<std::shared_ptr<std::vector<char>>*>(userData);
+                    }, holder);
+                }
+                else
+                {
+                    arrayBuffer = se::Object::createArrayBufferObject(nullptr, 0);
+                }
+                se::HandleObject seObj(arrayBuffer);
+#else
+                se::HandleObject seObj(se::Object::createArrayBufferObject(data ? data->data() : nullptr, data ? data->size() : 0));
+#endif
                 if (!seObj.isEmpty())
                 {
                     s.rval().setObject(seObj);
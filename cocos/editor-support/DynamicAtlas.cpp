@@ -0,0 +1,341 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "DynamicAtlas.h"
+#include "base/Macros.h"
+#include "renderer/core/Core.h"
+#include <algorithm>
+#include <cstring>
+
+MIDDLEWARE_BEGIN
+
+const uint32_t DynamicAtlas::PADDING;
+
+DynamicAtlas::DynamicAtlas() {
+}
+
+DynamicAtlas::~DynamicAtlas() {
+    destroy();
+}
+
+bool DynamicAtlas::initialize(gfx::Device *device, uint32_t pageSize, uint32_t maxFrameSize) {
+    if (!device || !pageSize || maxFrameSize + 2 * PADDING > pageSize) return false;
+    _device = device;
+    _pageSize = pageSize;
+    _maxFrameSize = maxFrameSize;
+    return true;
+}
+
+void DynamicAtlas::destroy() {
+    for (auto &pair : _regions) {
+        remap(pair.first, pair.second);
+        CC_SAFE_RELEASE(pair.second.originalTexture);
+        pair.first->release();
+    }
+    _regions.clear();
+
+    for (auto *page : _pages) {
+        CC_SAFE_RELEASE(page->delegate);
+        CC_SAFE_DESTROY(page->texture);
+        delete page;
+    }
+    _pages.clear();
+    _device = nullptr;
+}
+
+DynamicAtlas::Page *DynamicAtlas::createPage() {
+    gfx::TextureInfo info;
+    info.usage = gfx::TextureUsageBit::SAMPLED | gfx::TextureUsageBit::TRANSFER_DST;
+    info.format = gfx::Format::RGBA8;
+    info.width = _pageSize;
+    info.height = _pageSize;
+    auto *texture = _device->createTexture(info);
+    if (!texture) return nullptr;
+
+    auto *page = new Page();
+    page->texture = texture;
+    page->delegate = new Texture2D();
+    page->delegate->setPixelsWide(static_cast<int>(_pageSize));
+    page->delegate->setPixelsHigh(static_cast<int>(_pageSize));
+    resetPage(*page);
+    _pages.push_back(page);
+
+    if (_pageCallback) {
+        _pageCallback(page->delegate, texture);
+    }
+    return page;
+}
+
+void DynamicAtlas::resetPage(Page &page) {
+    page.skyline.clear();
+    page.skyline.push_back({0, 0, _pageSize});
+    page.freeRects.clear();
+    page.usedArea = 0;
+    page.regionCount = 0;
+}
+
+int DynamicAtlas::fitSkyline(const Page &page, std::size_t index, uint32_t width, uint32_t height) const {
+    const uint32_t x = page.skyline[index].x;
+    if (x + width > _pageSize) return -1;
+
+    // the region rests on the highest node it spans
+    uint32_t y = 0;
+    int32_t widthLeft = static_cast<int32_t>(width);
+    for (std::size_t i = index; widthLeft > 0; ++i) {
+        y = std::max(y, page.skyline[i].y);
+        if (y + height > _pageSize) return -1;
+        widthLeft -= static_cast<int32_t>(page.skyline[i].width);
+    }
+    return static_cast<int>(y);
+}
+
+void DynamicAtlas::addSkylineLevel(Page &page, std::size_t index, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+    auto &skyline = page.skyline;
+    skyline.insert(skyline.begin() + index, {x, y + height, width});
+
+    // shrinks the nodes now covered by the new one
+    for (std::size_t i = index + 1; i < skyline.size();) {
+        const uint32_t end = skyline[i - 1].x + skyline[i - 1].width;
+        if (skyline[i].x >= end) break;
+        const uint32_t shrink = end - skyline[i].x;
+        if (shrink >= skyline[i].width) {
+            skyline.erase(skyline.begin() + i);
+            continue;
+        }
+        skyline[i].x += shrink;
+        skyline[i].width -= shrink;
+        break;
+    }
+
+    for (std::size_t i = 0; i + 1 < skyline.size();) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+        } else {
+            ++i;
+        }
+    }
+}
+
+bool DynamicAtlas::allocateFromSkyline(Page &page, uint32_t width, uint32_t height, uint32_t &x, uint32_t &y) {
+    // bottom left: the lowest top edge wins, the narrower node breaks ties
+    std::size_t bestIndex = page.skyline.size();
+    uint32_t bestTop = UINT32_MAX;
+    uint32_t bestWidth = UINT32_MAX;
+    for (std::size_t i = 0; i < page.skyline.size(); ++i) {
+        const int fit = fitSkyline(page, i, width, height);
+        if (fit < 0) continue;
+        const uint32_t top = static_cast<uint32_t>(fit) + height;
+        if (top < bestTop || (top == bestTop && page.skyline[i].width < bestWidth)) {
+            bestIndex = i;
+            bestTop = top;
+            bestWidth = page.skyline[i].width;
+        }
+    }
+    if (bestIndex == page.skyline.size()) return false;
+
+    x = page.skyline[bestIndex].x;
+    y = bestTop - height;
+    addSkylineLevel(page, bestIndex, x, y, width, height);
+    return true;
+}
+
+bool DynamicAtlas::allocateFromFreeRects(Page &page, uint32_t width, uint32_t height, uint32_t &x, uint32_t &y) {
+    // best area fit, the rest of the rect is split along its shorter leftover side
+    auto best = page.freeRects.end();
+    for (auto iter = page.freeRects.begin(); iter != page.freeRects.end(); ++iter) {
+        if (iter->width < width || iter->height < height) continue;
+        if (best == page.freeRects.end() || iter->width * iter->height < best->width * best->height) best = iter;
+    }
+    if (best == page.freeRects.end()) return false;
+
+    const FreeRect rect = *best;
+    page.freeRects.erase(best);
+    x = rect.x;
+    y = rect.y;
+
+    const uint32_t restWidth = rect.width - width;
+    const uint32_t restHeight = rect.height - height;
+    if (restWidth < restHeight) {
+        if (restWidth) page.freeRects.push_back({rect.x + width, rect.y, restWidth, height});
+        if (restHeight) page.freeRects.push_back({rect.x, rect.y + height, rect.width, restHeight});
+    } else {
+        if (restWidth) page.freeRects.push_back({rect.x + width, rect.y, restWidth, rect.height});
+        if (restHeight) page.freeRects.push_back({rect.x, rect.y + height, width, restHeight});
+    }
+    return true;
+}
+
+bool DynamicAtlas::allocate(Page &page, uint32_t width, uint32_t height, uint32_t &x, uint32_t &y) {
+    if (!allocateFromFreeRects(page, width, height, x, y) && !allocateFromSkyline(page, width, height, x, y)) return false;
+    page.usedArea += width * height;
+    ++page.regionCount;
+    return true;
+}
+
+bool DynamicAtlas::place(Region &region) {
+    for (std::size_t i = 0; i < _pages.size(); ++i) {
+        if (allocate(*_pages[i], region.width, region.height, region.x, region.y)) {
+            region.page = i;
+            return true;
+        }
+    }
+
+    auto *page = createPage();
+    if (!page || !allocate(*page, region.width, region.height, region.x, region.y)) return false;
+    region.page = _pages.size() - 1;
+    return true;
+}
+
+void DynamicAtlas::upload(Page &page, const std::vector<const Region *> &regions) {
+    if (regions.empty()) return;
+
+    gfx::BufferDataList buffers(regions.size());
+    gfx::BufferTextureCopyList copies(regions.size());
+    for (std::size_t i = 0; i < regions.size(); ++i) {
+        const auto *region = regions[i];
+        buffers[i] = region->pixels.data();
+        auto &copy = copies[i];
+        copy.texOffset.x = static_cast<int>(region->x);
+        copy.texOffset.y = static_cast<int>(region->y);
+        copy.texExtent.width = region->width;
+        copy.texExtent.height = region->height;
+    }
+    _device->copyBuffersToTexture(buffers, page.texture, copies);
+}
+
+void DynamicAtlas::remap(SpriteFrame *frame, const Region &region) {
+    if (_regions.count(frame) && _pages[region.page]->delegate == frame->getTexture()) {
+        frame->setTexture(region.originalTexture);
+        frame->setRectInPixels(region.originalRect);
+    }
+}
+
+bool DynamicAtlas::insert(SpriteFrame *frame, const uint8_t *pixels) {
+    if (!_device || !frame || !pixels || contains(frame)) return false;
+
+    // the extent of the frame as its texture stores it
+    const auto &rect = frame->getRectInPixels();
+    uint32_t width = static_cast<uint32_t>(rect.size.width);
+    uint32_t height = static_cast<uint32_t>(rect.size.height);
+    if (frame->isRotated()) std::swap(width, height);
+    if (!width || !height || width > _maxFrameSize || height > _maxFrameSize) return false;
+
+    Region region;
+    region.originalTexture = frame->getTexture();
+    region.originalRect = rect;
+    region.width = width + 2 * PADDING;
+    region.height = height + 2 * PADDING;
+    if (!place(region)) return false;
+
+    // extrudes the edges of the frame into the padding
+    region.pixels.resize(region.width * region.height * 4);
+    for (uint32_t row = 0; row < region.height; ++row) {
+        const uint32_t srcRow = std::min(std::max(row, PADDING) - PADDING, height - 1);
+        const uint8_t *src = pixels + srcRow * width * 4;
+        uint8_t *dst = region.pixels.data() + row * region.width * 4;
+        for (uint32_t i = 0; i < PADDING; ++i) {
+            memcpy(dst + i * 4, src, 4);
+            memcpy(dst + (PADDING + width + i) * 4, src + (width - 1) * 4, 4);
+        }
+        memcpy(dst + PADDING * 4, src, width * 4);
+    }
+    upload(*_pages[region.page], {&region});
+
+    CC_SAFE_RETAIN(region.originalTexture);
+    frame->retain();
+    frame->setTexture(_pages[region.page]->delegate);
+    frame->setRectInPixels(cc::Rect(static_cast<float>(region.x + PADDING), static_cast<float>(region.y + PADDING), rect.size.width, rect.size.height));
+    _regions.emplace(frame, std::move(region));
+    return true;
+}
+
+void DynamicAtlas::remove(SpriteFrame *frame) {
+    auto iter = _regions.find(frame);
+    if (iter == _regions.end()) return;
+
+    auto &region = iter->second;
+    auto &page = *_pages[region.page];
+    page.freeRects.push_back({region.x, region.y, region.width, region.height});
+    page.usedArea -= region.width * region.height;
+    // an empty page starts over with a flat skyline
+    if (!--page.regionCount) resetPage(page);
+
+    remap(frame, region);
+    CC_SAFE_RELEASE(region.originalTexture);
+    _regions.erase(iter);
+    frame->release();
+}
+
+void DynamicAtlas::defragment() {
+    if (_regions.empty() && _pages.empty()) return;
+
+    // the tallest regions first keep the skyline flat
+    std::vector<std::pair<SpriteFrame *, Region *>> regions;
+    regions.reserve(_regions.size());
+    for (auto &pair : _regions) regions.emplace_back(pair.first, &pair.second);
+    std::sort(regions.begin(), regions.end(), [](const std::pair<SpriteFrame *, Region *> &a, const std::pair<SpriteFrame *, Region *> &b) {
+        if (a.second->height != b.second->height) return a.second->height > b.second->height;
+        return a.second->width > b.second->width;
+    });
+
+    for (auto *page : _pages) resetPage(*page);
+
+    std::vector<std::vector<const Region *>> uploads(_pages.size());
+    for (auto &pair : regions) {
+        auto *region = pair.second;
+        if (!place(*region)) {
+            // no page could be created, the frame goes back to its own texture
+            remap(pair.first, *region);
+            CC_SAFE_RELEASE(region->originalTexture);
+            pair.first->release();
+            _regions.erase(pair.first);
+            continue;
+        }
+        if (uploads.size() < _pages.size()) uploads.resize(_pages.size());
+        uploads[region->page].push_back(region);
+        const auto &rect = pair.first->getRectInPixels();
+        pair.first->setTexture(_pages[region->page]->delegate);
+        pair.first->setRectInPixels(cc::Rect(static_cast<float>(region->x + PADDING), static_cast<float>(region->y + PADDING), rect.size.width, rect.size.height));
+    }
+
+    // regions fill the pages in order, so the empty ones are all at the end
+    std::size_t pageCount = _pages.size();
+    while (pageCount && !_pages[pageCount - 1]->regionCount) --pageCount;
+    for (std::size_t i = 0; i < pageCount; ++i) upload(*_pages[i], uploads[i]);
+    for (std::size_t i = pageCount; i < _pages.size(); ++i) {
+        CC_SAFE_RELEASE(_pages[i]->delegate);
+        CC_SAFE_DESTROY(_pages[i]->texture);
+        delete _pages[i];
+    }
+    _pages.resize(pageCount);
+}
+
+float DynamicAtlas::getOccupancy() const {
+    if (_pages.empty()) return 0.0f;
+    uint64_t usedArea = 0;
+    for (const auto *page : _pages) usedArea += page->usedArea;
+    return static_cast<float>(usedArea) / (static_cast<float>(_pageSize) * _pageSize * _pages.size());
+}
+
+MIDDLEWARE_END
@@ -0,0 +1,146 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#pragma once
+
+#include "MiddlewareMacro.h"
+#include "middleware-adapter.h"
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace cc {
+namespace gfx {
+class Device;
+class Texture;
+} // namespace gfx
+} // namespace cc
+
+MIDDLEWARE_BEGIN
+
+/**
+ * Packs the pixels of small sprite frames into shared RGBA8 atlas pages, so that
+ * sprites loaded at runtime end up on a few textures and batch together.
+ * Pages are packed with a skyline, regions freed in between are reused until
+ * the next defragment repacks every page from scratch.
+ */
+class DynamicAtlas {
+public:
+    /**
+     * Called once a page is created, the page delegate has to be given the index
+     * of a script texture wrapping the gfx texture before it is rendered.
+     */
+    typedef std::function<void(Texture2D *page, gfx::Texture *texture)> pageCallback;
+
+    // border duplicated around every region so linear filtering does not bleed
+    static const uint32_t PADDING = 1;
+
+    DynamicAtlas();
+    ~DynamicAtlas();
+
+    /**
+     * @brief Creates no page yet, they are created as frames are inserted.
+     * @param[in] maxFrameSize Frames larger than this on either side are not packed.
+     */
+    bool initialize(gfx::Device *device, uint32_t pageSize = 2048, uint32_t maxFrameSize = 512);
+    void destroy();
+
+    /**
+     * @brief Moves a frame into the atlas, the frame is remapped to the page and retained until it is removed.
+     * @param[in] pixels Tightly packed RGBA8 pixels of the frame's rect, laid out as its texture stores them.
+     * @return false if the frame is not packed and keeps its own texture.
+     */
+    bool insert(SpriteFrame *frame, const uint8_t *pixels);
+    /**
+     * @brief Frees the region of a frame and moves the frame back to its original texture and rect.
+     */
+    void remove(SpriteFrame *frame);
+    bool contains(SpriteFrame *frame) const { return _regions.count(frame) != 0; }
+
+    /**
+     * @brief Repacks every region into as few pages as possible and destroys the pages left empty.
+     * Frames may move, vertices built from their rects have to be rebuilt afterwards.
+     */
+    void defragment();
+
+    void setPageCallback(const pageCallback &callback) { _pageCallback = callback; }
+    std::size_t getPageCount() const { return _pages.size(); }
+    /** Area of the pages covered by regions, from 0 to 1. */
+    float getOccupancy() const;
+
+private:
+    struct SkylineNode {
+        uint32_t x = 0;
+        uint32_t y = 0;
+        uint32_t width = 0;
+    };
+
+    struct FreeRect {
+        uint32_t x = 0;
+        uint32_t y = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+    };
+
+    struct Page {
+        gfx::Texture *texture = nullptr;
+        Texture2D *delegate = nullptr;
+        std::vector<SkylineNode> skyline;
+        std::vector<FreeRect> freeRects;
+        uint32_t usedArea = 0;
+        uint32_t regionCount = 0;
+    };
+
+    struct Region {
+        Texture2D *originalTexture = nullptr;
+        cc::Rect originalRect;
+        std::size_t page = 0;
+        uint32_t x = 0;
+        uint32_t y = 0;
+        // extent including the padding
+        uint32_t width = 0;
+        uint32_t height = 0;
+        // padded pixels, kept to repack the region
+        std::vector<uint8_t> pixels;
+    };
+
+    Page *createPage();
+    void resetPage(Page &page);
+    bool allocate(Page &page, uint32_t width, uint32_t height, uint32_t &x, uint32_t &y);
+    bool allocateFromFreeRects(Page &page, uint32_t width, uint32_t height, uint32_t &x, uint32_t &y);
+    bool allocateFromSkyline(Page &page, uint32_t width, uint32_t height, uint32_t &x, uint32_t &y);
+    int fitSkyline(const Page &page, std::size_t index, uint32_t width, uint32_t height) const;
+    void addSkylineLevel(Page &page, std::size_t index, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+    bool place(Region &region);
+    void upload(Page &page, const std::vector<const Region *> &regions);
+    void remap(SpriteFrame *frame, const Region &region);
+
+    gfx::Device *_device = nullptr;
+    uint32_t _pageSize = 0;
+    uint32_t _maxFrameSize = 0;
+    std::vector<Page *> _pages;
+    std::unordered_map<SpriteFrame *, Region> _regions;
+    pageCallback _pageCallback = nullptr;
+};
+
+MIDDLEWARE_END
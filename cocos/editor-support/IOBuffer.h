@@ -200,6 +200,10 @@ public:
         _maxSize = maxSize;
     }
 
+    inline std::size_t getMaxSize() const {
+        return _maxSize;
+    }
+
     typedef std::function<void()> fullCallback;
     void setFullCallback(fullCallback callback) {
         _fullCallback = callback;
@@ -36,9 +36,7 @@ IOTypedArray::IOTypedArray(se::Object::TypedArrayType arrayType, std::size_t def
     if (_usePool) {
         _typeArray = TypedArrayPool::getInstance()->pop(_arrayType, _bufferSize);
     } else {
-        se::AutoHandleScope hs;
-        _typeArray = se::Object::createTypedArray(_arrayType, nullptr, _bufferSize);
-        _typeArray->root();
+        _typeArray = TypedArrayPool::createTypedArray(_arrayType, _bufferSize);
     }
 
     se::AutoHandleScope hs;
@@ -64,9 +62,7 @@ void IOTypedArray::resize(std::size_t newLen, bool needCopy) {
     if (_usePool) {
         newTypeBuffer = TypedArrayPool::getInstance()->pop(_arrayType, newLen);
     } else {
-        se::AutoHandleScope hs;
-        newTypeBuffer = se::Object::createTypedArray(_arrayType, nullptr, newLen);
-        newTypeBuffer->root();
+        newTypeBuffer = TypedArrayPool::createTypedArray(_arrayType, newLen);
     }
 
     uint8_t *newBuffer = nullptr;
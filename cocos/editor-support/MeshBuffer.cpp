@@ -23,9 +23,25 @@
  ****************************************************************************/
 
 #include "MeshBuffer.h"
+#include "base/Macros.h"
+#include "renderer/core/Core.h"
 
 MIDDLEWARE_BEGIN
 
+namespace {
+gfx::AttributeList getAttributes(int vertexFormat) {
+    gfx::AttributeList attributes = {
+        {"a_position", gfx::Format::RGB32F},
+        {"a_texCoord", gfx::Format::RG32F},
+        {"a_color", gfx::Format::RGBA32F},
+    };
+    if (vertexFormat == VF_XYZUVCC) {
+        attributes.push_back({"a_color2", gfx::Format::RGBA32F});
+    }
+    return attributes;
+}
+} // namespace
+
 MeshBuffer::MeshBuffer(int vertexFormat)
 : MeshBuffer(vertexFormat, INIT_INDEX_BUFFER_SIZE, MAX_VERTEX_BUFFER_SIZE) {
 }
@@ -50,6 +66,7 @@ MeshBuffer::MeshBuffer(int vertexFormat, size_t indexSize, size_t vertexSize)
 }
 
 MeshBuffer::~MeshBuffer() {
+    destroyNativePages();
     auto num = _vbArr.size();
     for (auto i = 0; i < num; i++) {
         delete _ibArr[i];
@@ -59,10 +76,77 @@ MeshBuffer::~MeshBuffer() {
     _vbArr.clear();
 }
 
+void MeshBuffer::setDevice(gfx::Device *device) {
+    if (_device == device) return;
+    destroyNativePages();
+    _device = device;
+}
+
+const MeshBuffer::NativePage *MeshBuffer::getNativePage(std::size_t bufferPos) const {
+    const auto &pages = _nativePages[_frame];
+    return bufferPos < pages.size() ? &pages[bufferPos] : nullptr;
+}
+
+gfx::Buffer *MeshBuffer::getGFXVertexBuffer(std::size_t bufferPos) const {
+    auto page = getNativePage(bufferPos);
+    return page ? page->vb : nullptr;
+}
+
+gfx::Buffer *MeshBuffer::getGFXIndexBuffer(std::size_t bufferPos) const {
+    auto page = getNativePage(bufferPos);
+    return page ? page->ib : nullptr;
+}
+
+gfx::InputAssembler *MeshBuffer::getInputAssembler(std::size_t bufferPos) const {
+    auto page = getNativePage(bufferPos);
+    return page ? page->ia : nullptr;
+}
+
+// Pages are as large as the most the shared buffers hold, they are created once and written every frame of their slot.
+MeshBuffer::NativePage &MeshBuffer::getOrCreateNativePage(std::size_t bufferPos) {
+    auto &pages = _nativePages[_frame];
+    while (pages.size() <= bufferPos) {
+        NativePage page;
+        auto stride = (uint32_t)(_vertexFormat * sizeof(float));
+        page.vb = _device->createBuffer({
+            gfx::BufferUsageBit::VERTEX | gfx::BufferUsageBit::TRANSFER_DST,
+            gfx::MemoryUsageBit::HOST | gfx::MemoryUsageBit::DEVICE,
+            (uint32_t)_vb.getMaxSize(),
+            stride,
+        });
+        page.ib = _device->createBuffer({
+            gfx::BufferUsageBit::INDEX | gfx::BufferUsageBit::TRANSFER_DST,
+            gfx::MemoryUsageBit::HOST | gfx::MemoryUsageBit::DEVICE,
+            (uint32_t)_ib.getMaxSize(),
+            sizeof(unsigned short),
+        });
+        page.ia = _device->createInputAssembler({getAttributes(_vertexFormat), {page.vb}, page.ib});
+        pages.push_back(page);
+    }
+    return pages[bufferPos];
+}
+
+void MeshBuffer::destroyNativePages() {
+    for (auto &pages : _nativePages) {
+        for (auto &page : pages) {
+            CC_SAFE_DESTROY(page.ia);
+            CC_SAFE_DESTROY(page.ib);
+            CC_SAFE_DESTROY(page.vb);
+        }
+        pages.clear();
+    }
+    _frame = 0;
+}
+
 void MeshBuffer::uploadVB() {
     auto length = _vb.length();
     if (length == 0) return;
 
+    if (_device) {
+        getOrCreateNativePage(_bufferPos).vb->update(_vb.getBuffer(), 0, (uint32_t)length);
+        return;
+    }
+
     auto rVB = _vbArr[_bufferPos];
     rVB->reset();
     rVB->writeBytes((const char *)_vb.getBuffer(), _vb.length());
@@ -72,6 +156,11 @@ void MeshBuffer::uploadIB() {
     auto length = _ib.length();
     if (length == 0) return;
 
+    if (_device) {
+        getOrCreateNativePage(_bufferPos).ib->update(_ib.getBuffer(), 0, (uint32_t)length);
+        return;
+    }
+
     auto rIB = _ibArr[_bufferPos];
     rIB->reset();
     rIB->writeBytes((const char *)_ib.getBuffer(), _ib.length());
@@ -79,6 +168,8 @@ void MeshBuffer::uploadIB() {
 
 void MeshBuffer::next() {
     _bufferPos++;
+    // native pages are created as they are uploaded
+    if (_device) return;
     if (_ibArr.size() <= _bufferPos) {
         auto rIB = new IOTypedArray(se::Object::TypedArrayType::UINT16, _ib.getCapacity());
         _ibArr.push_back(rIB);
@@ -91,6 +182,7 @@ void MeshBuffer::next() {
 }
 
 void MeshBuffer::reset() {
+    if (_device) _frame = (_frame + 1) % RING_FRAME_COUNT;
     _bufferPos = 0;
     _vb.reset();
     _ib.reset();
@@ -27,15 +27,39 @@
 #include "IOTypedArray.h"
 #include <vector>
 
+namespace cc {
+namespace gfx {
+class Buffer;
+class Device;
+class InputAssembler;
+} // namespace gfx
+} // namespace cc
+
 MIDDLEWARE_BEGIN
 
 class MeshBuffer {
 public:
+    // frames a native page is kept from before it is written again, so the draws still in flight read their own vertices
+    static const std::size_t RING_FRAME_COUNT = 3;
+
     MeshBuffer(int vertexFormat);
     MeshBuffer(int vertexFormat, size_t indexSize, size_t vertexSize);
 
     virtual ~MeshBuffer();
 
+    /**
+     * @brief With a device the pages are uploaded into gfx buffers script draws from directly,
+     * instead of being copied into typed arrays, nullptr goes back to the typed arrays.
+     */
+    void setDevice(gfx::Device *device);
+    bool isNative() const { return _device != nullptr; }
+
+    // the gfx buffers of a page of this frame, nullptr without a device
+    gfx::Buffer *getGFXVertexBuffer(std::size_t bufferPos) const;
+    gfx::Buffer *getGFXIndexBuffer(std::size_t bufferPos) const;
+    // over the buffers of a page with the attributes of the vertex format, the draws set their ranges on their own
+    gfx::InputAssembler *getInputAssembler(std::size_t bufferPos) const;
+
     se_object_ptr getVBTypedArray(std::size_t bufferPos) {
         if (_vbArr.size() <= bufferPos) return nullptr;
         return _vbArr[bufferPos]->getTypeArray();
@@ -77,12 +101,26 @@ public:
     void reset();
 
 private:
+    struct NativePage {
+        gfx::Buffer *vb = nullptr;
+        gfx::Buffer *ib = nullptr;
+        gfx::InputAssembler *ia = nullptr;
+    };
+
     void next();
+    const NativePage *getNativePage(std::size_t bufferPos) const;
+    NativePage &getOrCreateNativePage(std::size_t bufferPos);
+    void destroyNativePages();
 
 private:
     std::vector<IOTypedArray *> _ibArr;
     std::vector<IOTypedArray *> _vbArr;
 
+    gfx::Device *_device = nullptr;
+    // pages of the frames of the ring, the current frame writes into _nativePages[_frame]
+    std::vector<NativePage> _nativePages[RING_FRAME_COUNT];
+    std::size_t _frame = 0;
+
     std::size_t _bufferPos = 0;
     IOBuffer _vb;
     IOBuffer _ib;
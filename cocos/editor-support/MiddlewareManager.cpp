@@ -23,7 +23,12 @@
  ****************************************************************************/
 #include "MiddlewareManager.h"
 #include "SeApi.h"
+#include "base/JobSystem.h"
+#include "base/Profiler.h"
+#include "base/memory/MemTracker.h"
+#include "renderer/core/Core.h"
 #include <algorithm>
+#include <cstring>
 
 MIDDLEWARE_BEGIN
 
@@ -47,6 +52,7 @@ MeshBuffer *MiddlewareManager::getMeshBuffer(int format) {
     MeshBuffer *mb = _mbMap[format];
     if (!mb) {
         mb = new MeshBuffer(format);
+        if (_isNativeBuffers) mb->setDevice(gfx::Device::getInstance());
         _mbMap[format] = mb;
     }
     return mb;
@@ -65,6 +71,8 @@ void MiddlewareManager::_clearRemoveList() {
 }
 
 void MiddlewareManager::update(float dt) {
+    CC_PROFILE_ZONE("MiddlewareManager::update");
+    CC_MEM_MODULE_SCOPE(MIDDLEWARE);
     isUpdating = true;
 
     _renderInfo.reset();
@@ -81,17 +89,20 @@ void MiddlewareManager::update(float dt) {
 
     auto isOrderDirty = false;
     uint32_t maxRenderOrder = 0;
+    _parallelList.clear();
     for (std::size_t i = 0, n = _updateList.size(); i < n; i++) {
         auto editor = _updateList[i];
         uint32_t renderOrder = maxRenderOrder;
-        if (_removeList.size() > 0) {
-            auto removeIt = std::find(_removeList.begin(), _removeList.end(), editor);
-            if (removeIt == _removeList.end()) {
+        auto isRemoved = _removeList.size() > 0 && std::find(_removeList.begin(), _removeList.end(), editor) != _removeList.end();
+        if (!isRemoved) {
+            auto interval = editor->getUpdateInterval();
+            if (editor->isCulled() || (interval > 1 && (_updateCount + i) % interval != 0)) {
+                editor->advance(dt);
+            } else if (editor->isParallelUpdate()) {
+                _parallelList.push_back(editor);
+            } else {
                 editor->update(dt);
-                renderOrder = editor->getRenderOrder();
             }
-        } else {
-            editor->update(dt);
             renderOrder = editor->getRenderOrder();
         }
 
@@ -102,7 +113,31 @@ void MiddlewareManager::update(float dt) {
         }
     }
 
+    if (!_parallelList.empty()) {
+        isParallelUpdating = true;
+        if (_parallelList.size() == 1) {
+            _parallelList[0]->update(dt);
+        } else {
+            auto jobSystem = JobSystem::getInstance();
+            jobSystem->wait(jobSystem->parallelFor(static_cast<uint32_t>(_parallelList.size()), 1, [this, dt](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; i++) {
+                    _parallelList[i]->update(dt);
+                }
+            }));
+        }
+        isParallelUpdating = false;
+
+        // script called from postUpdate may remove modules which have not run it yet
+        for (auto editor : _parallelList) {
+            auto isRemoved = _removeList.size() > 0 && std::find(_removeList.begin(), _removeList.end(), editor) != _removeList.end();
+            if (!isRemoved) {
+                editor->postUpdate(dt);
+            }
+        }
+    }
+
     isUpdating = false;
+    _updateCount++;
 
     _clearRemoveList();
 
@@ -114,6 +149,7 @@ void MiddlewareManager::update(float dt) {
 }
 
 void MiddlewareManager::render(float dt) {
+    CC_PROFILE_ZONE("MiddlewareManager::render");
     for (auto it : _mbMap) {
         auto buffer = it.second;
         if (buffer) {
@@ -123,18 +159,29 @@ void MiddlewareManager::render(float dt) {
 
     isRendering = true;
 
+    _renderBlocks.clear();
+    _parallelList.clear();
     for (std::size_t i = 0, n = _updateList.size(); i < n; i++) {
         auto editor = _updateList[i];
         if (_removeList.size() > 0) {
             auto removeIt = std::find(_removeList.begin(), _removeList.end(), editor);
-            if (removeIt == _removeList.end()) {
-                editor->render(dt);
+            if (removeIt != _removeList.end()) {
+                continue;
             }
+        }
+        if (editor->isParallelRender()) {
+            _parallelList.push_back(editor);
         } else {
-            editor->render(dt);
+            _renderModule(editor, dt);
         }
     }
 
+    if (!_parallelList.empty()) {
+        _renderParallel(dt);
+    }
+
+    _mergeRenderSegments();
+
     isRendering = false;
 
     for (auto it : _mbMap) {
@@ -148,6 +195,162 @@ void MiddlewareManager::render(float dt) {
     _clearRemoveList();
 }
 
+// Every module knows the range it takes in the shared buffers only once it rendered into its own data,
+// the ranges are reserved in order on this thread and the data of a whole mesh buffer is copied into it
+// on the JobSystem before the mesh buffer is uploaded and moves on.
+void MiddlewareManager::_renderParallel(float dt) {
+    if (!_renderInfo.getBuffer() || !_attachInfo.getBuffer()) return;
+
+    auto jobSystem = JobSystem::getInstance();
+    auto count = static_cast<uint32_t>(_parallelList.size());
+    _renderDataList.resize(count);
+    jobSystem->wait(jobSystem->parallelFor(count, 1, [this, dt](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            _renderDataList[i] = _parallelList[i]->renderParallel(dt);
+        }
+    }));
+
+    for (uint32_t i = 0; i < count; i++) {
+        auto data = _renderDataList[i];
+        if (!data) continue;
+
+        auto mb = getMeshBuffer(data->vertexFormat);
+        auto &vb = mb->getVB();
+        if (data->vb.length() > vb.getMaxSize()) {
+            _fillPendingRenderData();
+            _renderModule(_parallelList[i], dt);
+            continue;
+        }
+        // the mesh buffer is uploaded when it gets full
+        if (vb.getCurPos() + data->vb.length() > vb.getMaxSize()) {
+            _fillPendingRenderData();
+        }
+        data->meshBuffer = mb;
+        _commitRenderData(_parallelList[i], data);
+    }
+    _fillPendingRenderData();
+}
+
+void MiddlewareManager::_commitRenderData(IMiddleware *editor, ParallelRenderData *data) {
+    auto mb = data->meshBuffer;
+    auto &vb = mb->getVB();
+    auto &ib = mb->getIB();
+    vb.checkSpace(data->vb.length(), true);
+    ib.checkSpace(data->ib.length(), true);
+    data->vbOffset = vb.getCurPos();
+    data->ibOffset = ib.getCurPos();
+    vb.move((int)data->vb.length());
+    ib.move((int)data->ib.length());
+
+    auto renderInfo = _renderInfo.getBuffer();
+    auto attachInfo = _attachInfo.getBuffer();
+    _renderBlocks.push_back({editor, (uint32_t)(renderInfo->getCurPos() / sizeof(uint32_t))});
+    auto sharedBufferOffset = data->sharedBufferOffset;
+    sharedBufferOffset->reset();
+    sharedBufferOffset->writeUint32((uint32_t)renderInfo->getCurPos() / sizeof(uint32_t));
+    sharedBufferOffset->writeUint32((uint32_t)attachInfo->getCurPos() / sizeof(uint32_t));
+
+    // border, material count, then texture, blend src, blend dst, buffer position, index offset and index count
+    auto words = (uint32_t *)data->renderInfo.getBuffer();
+    auto wordCount = data->renderInfo.length() / sizeof(uint32_t);
+    auto bufferPos = (uint32_t)mb->getBufferPos();
+    auto indexOffset = (uint32_t)(data->ibOffset / sizeof(unsigned short));
+    renderInfo->checkSpace(data->renderInfo.length(), true);
+    for (std::size_t i = 0; i < wordCount; i++) {
+        auto field = i < 2 ? -1 : (int)((i - 2) % 6);
+        if (field == 3) {
+            renderInfo->writeUint32(bufferPos);
+        } else if (field == 4) {
+            renderInfo->writeUint32(words[i] + indexOffset);
+        } else {
+            renderInfo->writeUint32(words[i]);
+        }
+    }
+
+    if (data->attachInfo.length() > 0) {
+        attachInfo->checkSpace(data->attachInfo.length(), true);
+        attachInfo->writeBytes((const char *)data->attachInfo.getBuffer(), data->attachInfo.length());
+    }
+    _pendingRenderData.push_back(data);
+}
+
+void MiddlewareManager::_fillPendingRenderData() {
+    if (_pendingRenderData.empty()) return;
+
+    auto fill = [this](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            auto data = _pendingRenderData[i];
+            auto mb = data->meshBuffer;
+            memcpy(mb->getVB().getBuffer() + data->vbOffset, data->vb.getBuffer(), data->vb.length());
+
+            auto vertexOffset = (unsigned short)(data->vbOffset / (data->vertexFormat * sizeof(float)));
+            auto src = (const unsigned short *)data->ib.getBuffer();
+            auto dst = (unsigned short *)(mb->getIB().getBuffer() + data->ibOffset);
+            for (std::size_t ii = 0, nn = data->ib.length() / sizeof(unsigned short); ii < nn; ii++) {
+                dst[ii] = (unsigned short)(src[ii] + vertexOffset);
+            }
+        }
+    };
+    auto count = static_cast<uint32_t>(_pendingRenderData.size());
+    if (count == 1) {
+        fill(0, 1);
+    } else {
+        auto jobSystem = JobSystem::getInstance();
+        jobSystem->wait(jobSystem->parallelFor(count, 1, fill));
+    }
+    _pendingRenderData.clear();
+}
+
+void MiddlewareManager::_renderModule(IMiddleware *editor, float dt) {
+    auto renderInfo = _renderInfo.getBuffer();
+    auto offset = renderInfo ? renderInfo->getCurPos() : 0;
+    editor->render(dt);
+    // a module without render info this frame writes nothing
+    if (renderInfo && renderInfo->getCurPos() > offset) {
+        _renderBlocks.push_back({editor, (uint32_t)(offset / sizeof(uint32_t))});
+    }
+}
+
+// The render info of a module is its border, material count and 6 uint32 per material, see _commitRenderData.
+// The first segment of a module drawn right after another one with the same batch key joins the last segment
+// drawn before it, when texture, blend and mesh buffer match and its indices follow on, and leaves the material
+// list of its module. Script draws the joined segment with the material of the former module.
+void MiddlewareManager::_mergeRenderSegments() {
+    auto renderInfo = _renderInfo.getBuffer();
+    if (!renderInfo || _renderBlocks.size() < 2) return;
+
+    // serial modules render before the parallel ones, the draws follow the render order
+    std::stable_sort(_renderBlocks.begin(), _renderBlocks.end(), [](const RenderBlock &a, const RenderBlock &b) {
+        return a.editor->getRenderOrder() < b.editor->getRenderOrder();
+    });
+
+    auto words = (uint32_t *)renderInfo->getBuffer();
+    uint32_t *lastSegment = nullptr;
+    uint32_t lastKey = 0;
+    uint32_t lastOrder = 0;
+    for (const auto &block : _renderBlocks) {
+        uint32_t key = block.editor->getBatchKey();
+        uint32_t order = block.editor->getRenderOrder();
+        uint32_t *materialCount = words + block.offset + 1;
+        uint32_t *segments = materialCount + 1;
+        bool isBatched = key != 0 && key == lastKey && order == lastOrder + 1;
+        if (!isBatched) lastSegment = nullptr;
+
+        // texture, blend src, blend dst, buffer position, index offset and index count
+        if (lastSegment && *materialCount > 0 && memcmp(lastSegment, segments, sizeof(uint32_t) * 4) == 0 &&
+            lastSegment[4] + lastSegment[5] == segments[4]) {
+            lastSegment[5] += segments[5];
+            memmove(segments, segments + 6, sizeof(uint32_t) * 6 * (*materialCount - 1));
+            --*materialCount;
+        }
+        if (*materialCount > 0) {
+            lastSegment = segments + 6 * (*materialCount - 1);
+        }
+        lastKey = key;
+        lastOrder = order;
+    }
+}
+
 void MiddlewareManager::addTimer(IMiddleware *editor) {
     auto it0 = std::find(_updateList.begin(), _updateList.end(), editor);
     if (it0 != _updateList.end()) {
@@ -204,6 +407,31 @@ std::size_t MiddlewareManager::getIBTypedArrayLength(int format, std::size_t buf
     return mb->getIBTypedArrayLength(bufferPos);
 }
 
+void MiddlewareManager::setNativeBuffersEnabled(bool enabled) {
+    _isNativeBuffers = enabled;
+    for (auto it : _mbMap) {
+        if (it.second) it.second->setDevice(enabled ? gfx::Device::getInstance() : nullptr);
+    }
+}
+
+gfx::Buffer *MiddlewareManager::getGFXVertexBuffer(int format, int bufferPos) {
+    MeshBuffer *mb = _mbMap[format];
+    if (!mb) return nullptr;
+    return mb->getGFXVertexBuffer(bufferPos);
+}
+
+gfx::Buffer *MiddlewareManager::getGFXIndexBuffer(int format, int bufferPos) {
+    MeshBuffer *mb = _mbMap[format];
+    if (!mb) return nullptr;
+    return mb->getGFXIndexBuffer(bufferPos);
+}
+
+gfx::InputAssembler *MiddlewareManager::getInputAssembler(int format, int bufferPos) {
+    MeshBuffer *mb = _mbMap[format];
+    if (!mb) return nullptr;
+    return mb->getInputAssembler(bufferPos);
+}
+
 std::size_t MiddlewareManager::getBufferCount(int format) {
     MeshBuffer *mb = getMeshBuffer(format);
     if (!mb) return 0;
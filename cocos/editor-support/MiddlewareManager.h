@@ -32,6 +32,29 @@
 
 MIDDLEWARE_BEGIN
 
+/**
+ * Vertices, indices and render info a module writes on the JobSystem, the manager reserves
+ * their range in the shared buffers and copies them there afterwards.
+ */
+struct ParallelRenderData {
+    int vertexFormat = 0;
+    // vertices, and indices counted from the first of these vertices
+    IOBuffer vb;
+    IOBuffer ib;
+    // border, material count and 6 uint32 per material laid out as in the shared render info, with the
+    // index offsets counted from the first of the indices above, the buffer positions are written by the manager
+    IOBuffer renderInfo;
+    IOBuffer attachInfo;
+    // receives the offsets of the render info and the attach info, in uint32
+    IOTypedArray *sharedBufferOffset = nullptr;
+
+private:
+    friend class MiddlewareManager;
+    std::size_t vbOffset = 0;
+    std::size_t ibOffset = 0;
+    MeshBuffer *meshBuffer = nullptr;
+};
+
 /**
  * All middleware must implement IMiddleware interface.
  */
@@ -42,6 +65,22 @@ public:
     virtual void update(float dt) = 0;
     virtual void render(float dt) = 0;
     virtual uint32_t getRenderOrder() const = 0;
+    // If true, update only touches the module itself and runs on the JobSystem together with the other such modules.
+    virtual bool isParallelUpdate() const { return false; }
+    // Called for the modules of the parallel update once all of them are done, on the calling thread and in update order.
+    virtual void postUpdate(float dt) {}
+    // A culled module, or one between the updates of its interval, is advanced instead, on the calling thread.
+    virtual bool isCulled() const { return false; }
+    virtual uint32_t getUpdateInterval() const { return 1; }
+    virtual void advance(float dt) { update(dt); }
+    // If true, renderParallel runs on the JobSystem instead of render, a module whose vertices exceed
+    // one mesh buffer is rendered with render afterwards.
+    virtual bool isParallelRender() const { return false; }
+    // Only writes into the returned data of the module, nullptr if there is nothing to render.
+    virtual ParallelRenderData *renderParallel(float dt) { return nullptr; }
+    // Modules with the same non-zero key draw world space vertices of one vertex format with the same effect,
+    // segments of consecutive render orders are merged into one draw when texture and blend match too.
+    virtual uint32_t getBatchKey() const { return 0; }
 };
 
 /**
@@ -102,6 +141,16 @@ public:
     std::size_t getVBTypedArrayLength(int format, std::size_t bufferPos);
     std::size_t getIBTypedArrayLength(int format, std::size_t bufferPos);
 
+    /**
+     * @brief Uploads the meshes of every vertex format into gfx buffers owned by the mesh buffers,
+     * script draws the segments from their input assemblers instead of copying the typed arrays.
+     */
+    void setNativeBuffersEnabled(bool enabled);
+    bool isNativeBuffersEnabled() const { return _isNativeBuffers; }
+    gfx::Buffer *getGFXVertexBuffer(int format, int bufferPos);
+    gfx::Buffer *getGFXIndexBuffer(int format, int bufferPos);
+    gfx::InputAssembler *getInputAssembler(int format, int bufferPos);
+
     SharedBufferManager *getRenderInfoMgr();
     SharedBufferManager *getAttachInfoMgr();
 
@@ -111,15 +160,34 @@ public:
     // If manager is traversing _updateMap, will set the flag untill traverse is finished.
     bool isRendering = false;
     bool isUpdating = false;
+    // Set while the modules of the parallel update run, they defer whatever calls into script until postUpdate.
+    bool isParallelUpdating = false;
 
 private:
     void _clearRemoveList();
+    void _renderParallel(float dt);
+    void _commitRenderData(IMiddleware *editor, ParallelRenderData *data);
+    void _fillPendingRenderData();
+    void _renderModule(IMiddleware *editor, float dt);
+    void _mergeRenderSegments();
 
 private:
     std::vector<IMiddleware *> _updateList;
     std::vector<IMiddleware *> _removeList;
+    std::vector<IMiddleware *> _parallelList; // updated or rendered on the JobSystem after the others
+    uint32_t _updateCount = 0;                // spreads the modules of one update interval over its updates
+    bool _isNativeBuffers = false;
+    std::vector<ParallelRenderData *> _renderDataList;
+    std::vector<ParallelRenderData *> _pendingRenderData; // reserved, not yet copied into the mesh buffers
     std::map<int, MeshBuffer *> _mbMap;
 
+    // render info of a module, in uint32 from the start of the shared render info
+    struct RenderBlock {
+        IMiddleware *editor;
+        uint32_t offset;
+    };
+    std::vector<RenderBlock> _renderBlocks;
+
     SharedBufferManager _renderInfo;
     SharedBufferManager _attachInfo;
 
@@ -0,0 +1,435 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "ParticleEmitter.h"
+#include "base/TypeDef.h"
+#include "base/memory/Memory.h"
+#include "math/Math.h"
+#include "core/gfx/GFXDef.h"
+#include "renderer/pipeline/helper/SharedMemory.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define PARTICLE_USE_NEON
+#elif defined(__SSE__)
+    #include <xmmintrin.h>
+    #define PARTICLE_USE_SSE
+#endif
+
+MIDDLEWARE_BEGIN
+
+namespace {
+// quads copied into the mesh buffer per check, far below the vertex limit of a buffer
+const uint32_t QUADS_PER_BLOCK = 1024;
+const float MIN_LIFE = 0.0001f;
+
+// four lanes of floats, the arrays are accessed unaligned
+#if defined(PARTICLE_USE_NEON)
+typedef float32x4_t F4;
+CC_INLINE F4 f4Load(const float *p) { return vld1q_f32(p); }
+CC_INLINE void f4Store(float *p, F4 v) { vst1q_f32(p, v); }
+CC_INLINE F4 f4Set(float v) { return vdupq_n_f32(v); }
+CC_INLINE F4 f4Add(F4 a, F4 b) { return vaddq_f32(a, b); }
+CC_INLINE F4 f4Mul(F4 a, F4 b) { return vmulq_f32(a, b); }
+CC_INLINE F4 f4MulAdd(F4 a, F4 b, F4 c) { return vmlaq_f32(a, b, c); } // a + b * c
+CC_INLINE F4 f4Min(F4 a, F4 b) { return vminq_f32(a, b); }
+#elif defined(PARTICLE_USE_SSE)
+typedef __m128 F4;
+CC_INLINE F4 f4Load(const float *p) { return _mm_loadu_ps(p); }
+CC_INLINE void f4Store(float *p, F4 v) { _mm_storeu_ps(p, v); }
+CC_INLINE F4 f4Set(float v) { return _mm_set1_ps(v); }
+CC_INLINE F4 f4Add(F4 a, F4 b) { return _mm_add_ps(a, b); }
+CC_INLINE F4 f4Mul(F4 a, F4 b) { return _mm_mul_ps(a, b); }
+CC_INLINE F4 f4MulAdd(F4 a, F4 b, F4 c) { return _mm_add_ps(a, _mm_mul_ps(b, c)); }
+CC_INLINE F4 f4Min(F4 a, F4 b) { return _mm_min_ps(a, b); }
+#else
+struct F4 {
+    float v[4];
+};
+CC_INLINE F4 f4Load(const float *p) { return {{p[0], p[1], p[2], p[3]}}; }
+CC_INLINE void f4Store(float *p, const F4 &a) { memcpy(p, a.v, sizeof(a.v)); }
+CC_INLINE F4 f4Set(float v) { return {{v, v, v, v}}; }
+CC_INLINE F4 f4Add(const F4 &a, const F4 &b) { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+CC_INLINE F4 f4Mul(const F4 &a, const F4 &b) { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+CC_INLINE F4 f4MulAdd(const F4 &a, const F4 &b, const F4 &c) { return f4Add(a, f4Mul(b, c)); }
+CC_INLINE F4 f4Min(const F4 &a, const F4 &b) { return {{std::min(a.v[0], b.v[0]), std::min(a.v[1], b.v[1]), std::min(a.v[2], b.v[2]), std::min(a.v[3], b.v[3])}}; }
+#endif
+
+CC_INLINE uint32_t roundUp4(uint32_t count) { return (count + 3) & ~3u; }
+} // namespace
+
+ParticleEmitter::ParticleEmitter(uint32_t maxParticles) {
+    // store global TypedArray begin and end offset
+    _sharedBufferOffset = new IOTypedArray(se::Object::TypedArrayType::UINT32, sizeof(uint32_t) * 2);
+
+    const float defaults[PARAM_COUNT] = {
+        0.f,                                                                 // render order
+        1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, // world matrix
+        10.f, -1.f,                                                          // emission rate, duration
+        1.f, 1.f,                                                            // life
+        100.f, 100.f,                                                        // speed
+        90.f, 0.f,                                                           // angle
+        0.f, 0.f,                                                            // position variance
+        0.f, 0.f,                                                            // gravity
+        10.f, 10.f,                                                          // size
+        1.f, 1.f, 1.f, 1.f,                                                  // start color
+        1.f, 1.f, 1.f, 1.f,                                                  // end color
+        0.f, 0.f, 1.f, 1.f,                                                  // uv rect
+        0.f,                                                                 // texture index
+        static_cast<float>(gfx::BlendFactor::SRC_ALPHA),
+        static_cast<float>(gfx::BlendFactor::ONE_MINUS_SRC_ALPHA),
+        0.f, 0.f, // rotation speed and variance
+    };
+    _paramsBuffer = new IOTypedArray(se::Object::TypedArrayType::FLOAT32, sizeof(defaults));
+    _paramsBuffer->writeBytes(reinterpret_cast<const char *>(defaults), sizeof(defaults));
+
+    setMaxParticles(maxParticles);
+    onEnable();
+}
+
+ParticleEmitter::~ParticleEmitter() {
+    MiddlewareManager::getInstance()->removeTimer(this);
+    delete _sharedBufferOffset;
+    delete _paramsBuffer;
+}
+
+void ParticleEmitter::onEnable() {
+    MiddlewareManager::getInstance()->addTimer(this);
+}
+
+void ParticleEmitter::onDisable() {
+    MiddlewareManager::getInstance()->removeTimer(this);
+    _sharedBufferOffset->reset();
+    _sharedBufferOffset->clear();
+}
+
+void ParticleEmitter::reset() {
+    _count = 0;
+    _emitCounter = 0.f;
+    _elapsed = 0.f;
+}
+
+void ParticleEmitter::setMaxParticles(uint32_t maxParticles) {
+    _maxParticles = maxParticles;
+    _count = std::min(_count, maxParticles);
+    // padding lanes are integrated along and never drawn
+    const uint32_t capacity = roundUp4(maxParticles);
+    for (auto *stream : {&_posX, &_posY, &_velX, &_velY, &_age, &_invLife, &_rotation}) {
+        stream->resize(capacity, 0.f);
+    }
+    _vertices.reserve(maxParticles * 4);
+}
+
+uint32_t ParticleEmitter::getRenderOrder() const {
+    return static_cast<uint32_t>(getParam(RENDER_ORDER));
+}
+
+se_object_ptr ParticleEmitter::getParamsBuffer() const {
+    return _paramsBuffer->getTypeArray();
+}
+
+se_object_ptr ParticleEmitter::getSharedBufferOffset() const {
+    return _sharedBufferOffset->getTypeArray();
+}
+
+void ParticleEmitter::setInstancedModel(uint32_t modelHandle) {
+    _instancedModel = modelHandle;
+    _isInstanced = true;
+    _vertices.clear();
+}
+
+void ParticleEmitter::clearInstancedModel() {
+    _isInstanced = false;
+}
+
+void ParticleEmitter::update(float dt) {
+    integrate(dt);
+    kill();
+    emit(dt);
+    if (_isInstanced) {
+        buildInstances();
+    } else {
+        buildVertices();
+    }
+}
+
+void ParticleEmitter::integrate(float dt) {
+    const F4 delta = f4Set(dt);
+    const F4 gravityX = f4Set(getParam(GRAVITY_X) * dt);
+    const F4 gravityY = f4Set(getParam(GRAVITY_Y) * dt);
+    const F4 spin = f4Set(MATH_DEG_TO_RAD(getParam(ROTATION_SPEED)) * dt);
+    float *posX = _posX.data(), *posY = _posY.data();
+    float *velX = _velX.data(), *velY = _velY.data();
+    float *age = _age.data(), *rotation = _rotation.data();
+    for (uint32_t i = 0, n = roundUp4(_count); i < n; i += 4) {
+        const F4 vx = f4Add(f4Load(velX + i), gravityX);
+        const F4 vy = f4Add(f4Load(velY + i), gravityY);
+        f4Store(velX + i, vx);
+        f4Store(velY + i, vy);
+        f4Store(posX + i, f4MulAdd(f4Load(posX + i), vx, delta));
+        f4Store(posY + i, f4MulAdd(f4Load(posY + i), vy, delta));
+        f4Store(age + i, f4Add(f4Load(age + i), delta));
+        f4Store(rotation + i, f4Add(f4Load(rotation + i), spin));
+    }
+}
+
+// dead particles are replaced by the last one, the order of particles is not kept
+void ParticleEmitter::kill() {
+    uint32_t i = 0;
+    while (i < _count) {
+        if (_age[i] * _invLife[i] < 1.f) {
+            ++i;
+            continue;
+        }
+        const uint32_t last = --_count;
+        _posX[i] = _posX[last];
+        _posY[i] = _posY[last];
+        _velX[i] = _velX[last];
+        _velY[i] = _velY[last];
+        _age[i] = _age[last];
+        _invLife[i] = _invLife[last];
+        _rotation[i] = _rotation[last];
+    }
+}
+
+void ParticleEmitter::emit(float dt) {
+    const float duration = getParam(DURATION);
+    _elapsed += dt;
+    if (duration >= 0.f && _elapsed > duration) return;
+
+    _emitCounter += std::max(getParam(EMISSION_RATE), 0.f) * dt;
+    const auto emitCount = std::min(static_cast<uint32_t>(_emitCounter), _maxParticles - _count);
+    _emitCounter = _count + emitCount < _maxParticles ? _emitCounter - emitCount : 0.f;
+
+    const float angle = getParam(ANGLE), angleVariance = getParam(ANGLE_VARIANCE);
+    const float speedMin = getParam(SPEED_MIN), speedMax = getParam(SPEED_MAX);
+    const float lifeMin = getParam(LIFE_MIN), lifeMax = getParam(LIFE_MAX);
+    const float varianceX = getParam(POSITION_VARIANCE_X), varianceY = getParam(POSITION_VARIANCE_Y);
+    const float rotationVariance = getParam(ROTATION_VARIANCE);
+    for (uint32_t i = _count, n = _count + emitCount; i < n; ++i) {
+        const float direction = MATH_DEG_TO_RAD(angle + random(-angleVariance, angleVariance));
+        const float speed = random(speedMin, speedMax);
+        _posX[i] = random(-varianceX, varianceX);
+        _posY[i] = random(-varianceY, varianceY);
+        _velX[i] = std::cos(direction) * speed;
+        _velY[i] = std::sin(direction) * speed;
+        _age[i] = 0.f;
+        _invLife[i] = 1.f / std::max(random(lifeMin, lifeMax), MIN_LIFE);
+        _rotation[i] = MATH_DEG_TO_RAD(random(-rotationVariance, rotationVariance));
+    }
+    _count += emitCount;
+}
+
+// Quads in the emitter plane, four particles at a time, the lanes are then scattered into the vertices.
+void ParticleEmitter::buildVertices() {
+    _vertices.resize(_count * 4);
+    if (!_count) return;
+
+    const auto *m = reinterpret_cast<const float *>(_paramsBuffer->getBuffer()) + WORLD_MATRIX;
+    const float *startColor = reinterpret_cast<const float *>(_paramsBuffer->getBuffer()) + START_COLOR;
+    const float *endColor = reinterpret_cast<const float *>(_paramsBuffer->getBuffer()) + END_COLOR;
+    const float *uv = reinterpret_cast<const float *>(_paramsBuffer->getBuffer()) + UV_RECT;
+
+    const F4 one = f4Set(1.f);
+    const F4 startSize = f4Set(getParam(START_SIZE) * 0.5f);
+    const F4 sizeDelta = f4Set((getParam(END_SIZE) - getParam(START_SIZE)) * 0.5f);
+    F4 colorStart[4], colorDelta[4];
+    for (int c = 0; c < 4; ++c) {
+        colorStart[c] = f4Set(startColor[c]);
+        colorDelta[c] = f4Set(endColor[c] - startColor[c]);
+    }
+    F4 matrix[16];
+    for (int k = 0; k < 16; ++k) matrix[k] = f4Set(m[k]);
+    const bool isRotated = getParam(ROTATION_SPEED) != 0.f || getParam(ROTATION_VARIANCE) != 0.f;
+
+    alignas(16) float center[3][4], axisX[3][4], axisY[3][4], color[4][4];
+    for (uint32_t i = 0; i < _count; i += 4) {
+        const F4 px = f4Load(&_posX[i]);
+        const F4 py = f4Load(&_posY[i]);
+        const F4 t = f4Min(f4Mul(f4Load(&_age[i]), f4Load(&_invLife[i])), one);
+        const F4 halfSize = f4MulAdd(startSize, sizeDelta, t);
+        for (int c = 0; c < 3; ++c) {
+            f4Store(center[c], f4MulAdd(f4MulAdd(matrix[12 + c], matrix[c], px), matrix[4 + c], py));
+            f4Store(axisX[c], f4Mul(matrix[c], halfSize));
+            f4Store(axisY[c], f4Mul(matrix[4 + c], halfSize));
+        }
+        for (int c = 0; c < 4; ++c) f4Store(color[c], f4MulAdd(colorStart[c], colorDelta[c], t));
+
+        for (uint32_t lane = 0, laneCount = std::min(4u, _count - i); lane < laneCount; ++lane) {
+            V2F_T2F_C4F *quad = &_vertices[(i + lane) * 4];
+            const Color4F quadColor(color[0][lane], color[1][lane], color[2][lane], color[3][lane]);
+            if (isRotated) {
+                const float cos = std::cos(_rotation[i + lane]);
+                const float sin = std::sin(_rotation[i + lane]);
+                for (int c = 0; c < 3; ++c) {
+                    const float x = axisX[c][lane], y = axisY[c][lane];
+                    axisX[c][lane] = cos * x + sin * y;
+                    axisY[c][lane] = cos * y - sin * x;
+                }
+            }
+            for (int corner = 0; corner < 4; ++corner) {
+                // bottom left, bottom right, top left, top right
+                const float sx = corner & 1 ? 1.f : -1.f;
+                const float sy = corner & 2 ? 1.f : -1.f;
+                V2F_T2F_C4F &vertex = quad[corner];
+                vertex.vertex.x = center[0][lane] + sx * axisX[0][lane] + sy * axisY[0][lane];
+                vertex.vertex.y = center[1][lane] + sx * axisX[1][lane] + sy * axisY[1][lane];
+                vertex.vertex.z = center[2][lane] + sx * axisX[2][lane] + sy * axisY[2][lane];
+                vertex.texCoord.u = corner & 1 ? uv[2] : uv[0];
+                vertex.texCoord.v = corner & 2 ? uv[1] : uv[3];
+                vertex.color = quadColor;
+            }
+        }
+    }
+}
+
+// Same per-particle values as the quads, packed for the instanced attributes of the model.
+void ParticleEmitter::buildInstances() {
+    auto *model = pipeline::SharedMemory::getBuffer<pipeline::ModelView>(_instancedModel);
+    if (!model) return;
+    uint32_t size = 0;
+    auto *instances = pipeline::SharedMemory::getRawBuffer<ParticleInstance>(se::PoolType::RAW_BUFFER, model->instancedBufferID, &size);
+    const uint32_t count = instances ? std::min(_count, size / static_cast<uint32_t>(sizeof(ParticleInstance))) : 0;
+    model->instanceCount = count;
+    if (!count) return;
+
+    const auto *m = reinterpret_cast<const float *>(_paramsBuffer->getBuffer()) + WORLD_MATRIX;
+    const float *startColor = reinterpret_cast<const float *>(_paramsBuffer->getBuffer()) + START_COLOR;
+    const float *endColor = reinterpret_cast<const float *>(_paramsBuffer->getBuffer()) + END_COLOR;
+
+    const F4 one = f4Set(1.f);
+    const F4 startSize = f4Set(getParam(START_SIZE));
+    const F4 sizeDelta = f4Set(getParam(END_SIZE) - getParam(START_SIZE));
+    F4 colorStart[4], colorDelta[4];
+    for (int c = 0; c < 4; ++c) {
+        colorStart[c] = f4Set(startColor[c] * 255.f);
+        colorDelta[c] = f4Set((endColor[c] - startColor[c]) * 255.f);
+    }
+    F4 matrix[16];
+    for (int k = 0; k < 16; ++k) matrix[k] = f4Set(m[k]);
+
+    alignas(16) float center[3][4], sizes[4], color[4][4];
+    for (uint32_t i = 0; i < count; i += 4) {
+        const F4 px = f4Load(&_posX[i]);
+        const F4 py = f4Load(&_posY[i]);
+        const F4 t = f4Min(f4Mul(f4Load(&_age[i]), f4Load(&_invLife[i])), one);
+        for (int c = 0; c < 3; ++c) f4Store(center[c], f4MulAdd(f4MulAdd(matrix[12 + c], matrix[c], px), matrix[4 + c], py));
+        f4Store(sizes, f4MulAdd(startSize, sizeDelta, t));
+        for (int c = 0; c < 4; ++c) f4Store(color[c], f4MulAdd(colorStart[c], colorDelta[c], t));
+
+        for (uint32_t lane = 0, laneCount = std::min(4u, count - i); lane < laneCount; ++lane) {
+            ParticleInstance &instance = instances[i + lane];
+            instance.x = center[0][lane];
+            instance.y = center[1][lane];
+            instance.z = center[2][lane];
+            instance.size = sizes[lane];
+            instance.rotation = _rotation[i + lane];
+            instance.color = static_cast<uint32_t>(color[0][lane] + 0.5f) |
+                             static_cast<uint32_t>(color[1][lane] + 0.5f) << 8 |
+                             static_cast<uint32_t>(color[2][lane] + 0.5f) << 16 |
+                             static_cast<uint32_t>(color[3][lane] + 0.5f) << 24;
+        }
+    }
+}
+
+void ParticleEmitter::render(float /*dt*/) {
+    _sharedBufferOffset->reset();
+    _sharedBufferOffset->clear();
+
+    auto mgr = MiddlewareManager::getInstance();
+    if (!mgr->isRendering) return;
+
+    auto renderInfo = mgr->getRenderInfoMgr()->getBuffer();
+    auto attachInfo = mgr->getAttachInfoMgr()->getBuffer();
+    if (!renderInfo || !attachInfo) return;
+
+    //  store render info offset
+    _sharedBufferOffset->writeUint32((uint32_t)renderInfo->getCurPos() / sizeof(uint32_t));
+    // store attach info offset
+    _sharedBufferOffset->writeUint32((uint32_t)attachInfo->getCurPos() / sizeof(uint32_t));
+
+    // check enough space
+    renderInfo->checkSpace(sizeof(uint32_t) * 2, true);
+    // write border
+    renderInfo->writeUint32(0xffffffff);
+    std::size_t materialLenOffset = renderInfo->getCurPos();
+    //reserved space to save material len
+    renderInfo->writeUint32(0);
+
+    MeshBuffer *mb = mgr->getMeshBuffer(VF_XYZUVC);
+    IOBuffer &vb = mb->getVB();
+    IOBuffer &ib = mb->getIB();
+    const std::size_t vbs = sizeof(V2F_T2F_C4F);
+
+    // instanced particles are drawn by the pipeline with their model
+    const uint32_t totalQuadCount = _isInstanced ? 0 : _count;
+    uint32_t materialLen = 0;
+    std::size_t segmentLenOffset = 0;
+    uint32_t segmentLen = 0;
+    for (uint32_t first = 0; first < totalQuadCount; first += QUADS_PER_BLOCK) {
+        const uint32_t quadCount = std::min(QUADS_PER_BLOCK, totalQuadCount - first);
+        const std::size_t vbSize = quadCount * 4 * vbs;
+        const std::size_t ibSize = quadCount * 6 * sizeof(uint16_t);
+        const int isFull = vb.checkSpace(vbSize, true);
+        ib.checkSpace(ibSize, true);
+
+        // a full mesh buffer moved on to the next one, which needs its own segment
+        if (!materialLen || isFull) {
+            if (materialLen) renderInfo->writeUint32(segmentLenOffset, segmentLen);
+            renderInfo->checkSpace(sizeof(uint32_t) * 6, true);
+            renderInfo->writeUint32(static_cast<uint32_t>(getParam(TEXTURE_INDEX)));
+            renderInfo->writeUint32(static_cast<uint32_t>(getParam(BLEND_SRC)));
+            renderInfo->writeUint32(static_cast<uint32_t>(getParam(BLEND_DST)));
+            renderInfo->writeUint32((uint32_t)mb->getBufferPos());
+            renderInfo->writeUint32((uint32_t)ib.getCurPos() / sizeof(uint16_t));
+            segmentLenOffset = renderInfo->getCurPos();
+            renderInfo->writeUint32(0);
+            segmentLen = 0;
+            materialLen++;
+        }
+
+        const auto vertexOffset = static_cast<uint16_t>(vb.getCurPos() / vbs);
+        memcpy(vb.getCurBuffer(), &_vertices[first * 4], vbSize);
+        auto *indices = reinterpret_cast<uint16_t *>(ib.getCurBuffer());
+        for (uint32_t quad = 0; quad < quadCount; ++quad, indices += 6) {
+            const auto base = static_cast<uint16_t>(vertexOffset + quad * 4);
+            indices[0] = base;
+            indices[1] = base + 1;
+            indices[2] = base + 2;
+            indices[3] = base + 1;
+            indices[4] = base + 3;
+            indices[5] = base + 2;
+        }
+        vb.move(static_cast<int>(vbSize));
+        ib.move(static_cast<int>(ibSize));
+        segmentLen += quadCount * 6;
+    }
+
+    renderInfo->writeUint32(materialLenOffset, materialLen);
+    if (materialLen) renderInfo->writeUint32(segmentLenOffset, segmentLen);
+}
+
+MIDDLEWARE_END
@@ -0,0 +1,144 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#pragma once
+
+#include "IOTypedArray.h"
+#include "MiddlewareManager.h"
+#include "middleware-adapter.h"
+#include <random>
+#include <vector>
+
+MIDDLEWARE_BEGIN
+
+/**
+ * Particle emitter simulated and batched natively, JS only writes the emitter settings into the params buffer.
+ * Particles are stored as structure of arrays and integrated four at a time with SIMD, the quads are built in
+ * update() which MiddlewareManager runs on the JobSystem for all emitters at once, render() only copies them
+ * into the MeshBuffer of VF_XYZUVC and fills the render info in the layout of the spine renderer.
+ *
+ * With an instanced model the quads are not built, update() packs one ParticleInstance per particle into the
+ * instanced buffer of the model instead and sets its instance count, the vertex shader of the model expands
+ * its unit quad per instance.
+ */
+class ParticleEmitter : public IMiddleware {
+public:
+    // Float offsets into the params buffer.
+    enum Param {
+        RENDER_ORDER = 0,
+        WORLD_MATRIX = 1, // 16 floats
+        EMISSION_RATE = 17, // particles per second
+        DURATION = 18,      // seconds of emission, negative emits forever
+        LIFE_MIN = 19,
+        LIFE_MAX = 20,
+        SPEED_MIN = 21,
+        SPEED_MAX = 22,
+        ANGLE = 23,         // emission direction in degrees
+        ANGLE_VARIANCE = 24,
+        POSITION_VARIANCE_X = 25,
+        POSITION_VARIANCE_Y = 26,
+        GRAVITY_X = 27,
+        GRAVITY_Y = 28,
+        START_SIZE = 29,
+        END_SIZE = 30,
+        START_COLOR = 31, // 4 floats, rgba in [0, 1]
+        END_COLOR = 35,   // 4 floats
+        UV_RECT = 39,     // 4 floats, u0 v0 u1 v1
+        TEXTURE_INDEX = 43,
+        BLEND_SRC = 44,
+        BLEND_DST = 45,
+        ROTATION_SPEED = 46,    // degrees per second
+        ROTATION_VARIANCE = 47, // degrees of the start rotation
+        PARAM_COUNT = 48,
+    };
+
+    // Instanced attributes of a particle, RGBA32F position and size, R32F rotation, RGBA8 normalized color.
+    struct ParticleInstance {
+        float x, y, z; // world position
+        float size;
+        float rotation; // radians in the emitter plane
+        uint32_t color;
+    };
+
+    explicit ParticleEmitter(uint32_t maxParticles);
+    virtual ~ParticleEmitter();
+
+    virtual void update(float dt) override;
+    virtual void render(float dt) override;
+    virtual uint32_t getRenderOrder() const override;
+    virtual bool isParallelUpdate() const override { return true; }
+
+    void onEnable();
+    void onDisable();
+
+    // Kills all particles and starts emitting from the beginning of the duration.
+    void reset();
+
+    // The instanced buffer of the model has to hold max particles instances.
+    void setInstancedModel(uint32_t modelHandle);
+    void clearInstancedModel();
+    bool isInstanced() const { return _isInstanced; }
+
+    void setMaxParticles(uint32_t maxParticles);
+    uint32_t getMaxParticles() const { return _maxParticles; }
+    uint32_t getParticleCount() const { return _count; }
+
+    se_object_ptr getParamsBuffer() const;
+    // render info offset and attach info offset of the last render, in uint32
+    se_object_ptr getSharedBufferOffset() const;
+
+private:
+    float getParam(Param param) const { return reinterpret_cast<const float *>(_paramsBuffer->getBuffer())[param]; }
+    float random(float min, float max) { return min + (max - min) * _distribution(_random); }
+
+    void integrate(float dt);
+    void kill();
+    void emit(float dt);
+    void buildVertices();
+    void buildInstances();
+
+    IOTypedArray *_paramsBuffer = nullptr;
+    IOTypedArray *_sharedBufferOffset = nullptr;
+
+    // structure of arrays, padded to a multiple of 4
+    std::vector<float> _posX;
+    std::vector<float> _posY;
+    std::vector<float> _velX;
+    std::vector<float> _velY;
+    std::vector<float> _age;
+    std::vector<float> _invLife;
+    std::vector<float> _rotation; // radians
+
+    std::vector<V2F_T2F_C4F> _vertices; // 4 per particle
+    std::minstd_rand _random;
+    std::uniform_real_distribution<float> _distribution{0.f, 1.f};
+
+    uint32_t _maxParticles = 0;
+    uint32_t _count = 0;
+    float _emitCounter = 0.f;
+    float _elapsed = 0.f;
+    uint32_t _instancedModel = 0;
+    bool _isInstanced = false;
+};
+
+MIDDLEWARE_END
@@ -25,6 +25,10 @@
 #include "MiddlewareMacro.h"
 #include "base/Log.h"
 #include "base/Macros.h"
+#include "base/MemoryPressure.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <functional>
 
 #define POOL_DEBUG 0
@@ -47,9 +51,14 @@ TypedArrayPool *TypedArrayPool::_instance = nullptr;
 
 TypedArrayPool::TypedArrayPool() {
     se::ScriptEngine::getInstance()->addAfterCleanupHook(std::bind(&TypedArrayPool::afterCleanupHandle, this));
+    // the pooled arrays are free, popped ones are left to their owners
+    _memoryPressureHandlerID = cc::MemoryPressure::addHandler("TypedArrayPool", cc::MemoryPressureLevel::MODERATE, [this](cc::MemoryPressureLevel) {
+        clearPool();
+    });
 }
 
 TypedArrayPool::~TypedArrayPool() {
+    cc::MemoryPressure::removeHandler(_memoryPressureHandlerID);
     clearPool();
 }
 
@@ -67,85 +76,107 @@ void TypedArrayPool::afterInitHandle() {
 void TypedArrayPool::clearPool() {
     PoolLog("*****clearPool TypeArray pool begin");
 
-    //map
-    for (auto it = _pool.begin(); it != _pool.end(); it++) {
-        //map
-        fitMap &mapPool = *(it->second);
-        for (auto itMapPool = mapPool.begin(); itMapPool != mapPool.end(); itMapPool++) {
-            //vector
-            objPool &itFitPool = *(itMapPool->second);
-            PoolLog("clear arrayType:%d,fitSize:%lu,objSize:%lu\n", it->first, itMapPool->first, itFitPool.size());
-            for (auto itFit = itFitPool.begin(); itFit != itFitPool.end(); itFit++) {
-                (*itFit)->unroot();
-                (*itFit)->decRef();
+    for (std::size_t type = 0; type < TYPE_COUNT; type++) {
+        for (std::size_t sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; sizeClass++) {
+            objPool &fitPool = _pool[type][sizeClass];
+            if (fitPool.empty()) continue;
+            PoolLog("clear arrayType:%d,fitSize:%lu,objSize:%lu\n", (int)type, getSizeClassBytes(sizeClass), fitPool.size());
+            for (auto &item : fitPool) {
+                item.object->unroot();
+                item.object->decRef();
             }
-            delete &itFitPool;
+            fitPool.clear();
         }
-        delete &mapPool;
     }
-    _pool.clear();
+    _pooledBytes = 0;
 
     PoolLog("*****clearPool TypeArray pool end");
 }
 
 void TypedArrayPool::dump() {
-    //map
-    for (auto it = _pool.begin(); it != _pool.end(); it++) {
-        //map
-        fitMap &mapPool = *(it->second);
-        for (auto itMapPool = mapPool.begin(); itMapPool != mapPool.end(); itMapPool++) {
-            //vector
-            CC_UNUSED objPool &itFitPool = *(itMapPool->second);
-            PoolLog("arrayType:%d,fitSize:%lu,objSize:%lu\n", it->first, itMapPool->first, itFitPool.size());
+    for (std::size_t type = 0; type < TYPE_COUNT; type++) {
+        for (std::size_t sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; sizeClass++) {
+            CC_UNUSED const objPool &fitPool = _pool[type][sizeClass];
+            if (fitPool.empty()) continue;
+            PoolLog("arrayType:%d,fitSize:%lu,objSize:%lu\n", (int)type, getSizeClassBytes(sizeClass), fitPool.size());
         }
     }
 }
 
-se::Object *TypedArrayPool::pop(arrayType type, std::size_t size) {
-    std::size_t fitSize = ceil(size / float(MIN_TYPE_ARRAY_SIZE)) * MIN_TYPE_ARRAY_SIZE;
-    objPool *objPoolPtr = getObjPool(type, fitSize);
+std::size_t TypedArrayPool::getPooledBytes() const {
+    return _pooledBytes;
+}
 
-    if (objPoolPtr->size() > 0) {
-        se::Object *obj = objPoolPtr->back();
-        objPoolPtr->pop_back();
-        PoolLog("TypedArrayPool:pop result:success,type:%d,fitSize:%lu,objSize:%lu\n", (int)type, fitSize, objPoolPtr->size());
-        return obj;
-    }
+std::size_t TypedArrayPool::getSizeClass(std::size_t size) {
+    std::size_t units = (size + MIN_TYPE_ARRAY_SIZE - 1) / MIN_TYPE_ARRAY_SIZE;
+    if (units <= 4) return units > 0 ? units - 1 : 0;
+
+    // units is in (2^exponent, 2^(exponent + 1)], split into 4 classes
+    std::size_t exponent = 0;
+    for (std::size_t value = units - 1; value > 1; value >>= 1) exponent++;
+    const std::size_t shift = exponent - 2;
+    const std::size_t step = (std::size_t)1 << shift;
+    const std::size_t index = (units - ((std::size_t)1 << exponent) + step - 1) >> shift;
+    return 4 * (exponent - 1) + index - 1;
+}
+
+std::size_t TypedArrayPool::getSizeClassBytes(std::size_t sizeClass) {
+    if (sizeClass < 4) return (sizeClass + 1) * MIN_TYPE_ARRAY_SIZE;
+    const std::size_t exponent = sizeClass / 4 + 1;
+    const std::size_t index = sizeClass % 4 + 1;
+    return (((std::size_t)1 << exponent) + (index << (exponent - 2))) * MIN_TYPE_ARRAY_SIZE;
+}
 
-    PoolLog("TypedArrayPool:pop result:empty,type:%d,fitSize:%lu,objSize:%lu\n", (int)type, fitSize, objPoolPtr->size());
+// The memory is owned by the array buffer and freed when the engine collects it, js reads and
+// native writes go to the same bytes and the engine heap does not allocate or copy them.
+se::Object *TypedArrayPool::createTypedArray(arrayType type, std::size_t byteLength) {
     se::AutoHandleScope hs;
-    auto typeArray = se::Object::createTypedArray(type, nullptr, fitSize);
+#if SCRIPT_ENGINE_TYPE == SCRIPT_ENGINE_V8
+    void *contents = calloc(1, byteLength);
+    se::Object *arrayBuffer = se::Object::createExternalArrayBufferObject(contents, byteLength, [](void *data, size_t, void *) {
+        free(data);
+    });
+    se::Object *typeArray = se::Object::createTypedArrayWithBuffer(type, arrayBuffer, 0, byteLength);
+    arrayBuffer->decRef();
+#else
+    se::Object *typeArray = se::Object::createTypedArray(type, nullptr, byteLength);
+#endif
     typeArray->root();
     return typeArray;
 }
 
-TypedArrayPool::objPool *TypedArrayPool::getObjPool(arrayType type, std::size_t fitSize) {
-    auto it = _pool.find(type);
-    fitMap *fitMapPtr = nullptr;
-    if (it == _pool.end()) {
-        fitMapPtr = new fitMap();
-        _pool[type] = fitMapPtr;
-    } else {
-        fitMapPtr = it->second;
+se::Object *TypedArrayPool::pop(arrayType type, std::size_t size) {
+    const std::size_t sizeClass = getSizeClass(size);
+    if (sizeClass >= SIZE_CLASS_COUNT) {
+        std::size_t fitSize = ceil(size / float(MIN_TYPE_ARRAY_SIZE)) * MIN_TYPE_ARRAY_SIZE;
+        PoolLog("TypedArrayPool:pop result:too large,type:%d,fitSize:%lu\n", (int)type, fitSize);
+        return createTypedArray(type, fitSize);
     }
 
-    auto itPool = fitMapPtr->find(fitSize);
-    objPool *objPoolPtr = nullptr;
-    if (itPool == fitMapPtr->end()) {
-        objPoolPtr = new objPool();
-        (*fitMapPtr)[fitSize] = objPoolPtr;
-    } else {
-        objPoolPtr = itPool->second;
+    objPool &fitPool = _pool[(std::size_t)type][sizeClass];
+    if (!fitPool.empty()) {
+        se::Object *obj = fitPool.back().object;
+        _pooledBytes -= fitPool.back().byteLength;
+        fitPool.pop_back();
+        PoolLog("TypedArrayPool:pop result:success,type:%d,fitSize:%lu,objSize:%lu\n", (int)type, getSizeClassBytes(sizeClass), fitPool.size());
+        return obj;
     }
 
-    return objPoolPtr;
+    PoolLog("TypedArrayPool:pop result:empty,type:%d,fitSize:%lu,objSize:%lu\n", (int)type, getSizeClassBytes(sizeClass), fitPool.size());
+    return createTypedArray(type, getSizeClassBytes(sizeClass));
 }
 
 void TypedArrayPool::push(arrayType type, std::size_t arrayCapacity, se::Object *object) {
     if (object == nullptr) return;
 
+    // An array goes into the largest class it can serve, pops of that class never get less than the class size.
+    std::size_t sizeClass = getSizeClass(arrayCapacity);
+    if (sizeClass < SIZE_CLASS_COUNT && getSizeClassBytes(sizeClass) > arrayCapacity) {
+        sizeClass = sizeClass > 0 ? sizeClass - 1 : SIZE_CLASS_COUNT;
+    }
+
     // If script engine is cleaning,delete object directly
-    if (!allowPush) {
+    if (!allowPush || sizeClass >= SIZE_CLASS_COUNT) {
         object->unroot();
         object->decRef();
         object = nullptr;
@@ -153,16 +184,17 @@ void TypedArrayPool::push(arrayType type, std::size_t arrayCapacity, se::Object
         return;
     }
 
-    objPool *objPoolPtr = getObjPool(type, arrayCapacity);
-    auto it = std::find(objPoolPtr->begin(), objPoolPtr->end(), object);
-    if (it != objPoolPtr->end()) {
+    objPool &fitPool = _pool[(std::size_t)type][sizeClass];
+    auto it = std::find_if(fitPool.begin(), fitPool.end(), [object](const PoolItem &item) { return item.object == object; });
+    if (it != fitPool.end()) {
         PoolLog("TypedArrayPool:push result:repeat\n");
         return;
     }
 
-    if (objPoolPtr->size() < maxPoolSize) {
-        objPoolPtr->push_back(object);
-        PoolLog("TypedArrayPool:push result:success,type:%d,arrayCapacity:%lu,objSize:%lu\n", (int)type, arrayCapacity, objPoolPtr->size());
+    if (fitPool.size() < maxPoolSize) {
+        fitPool.push_back({object, arrayCapacity});
+        _pooledBytes += arrayCapacity;
+        PoolLog("TypedArrayPool:push result:success,type:%d,arrayCapacity:%lu,objSize:%lu\n", (int)type, arrayCapacity, fitPool.size());
     } else {
         object->unroot();
         object->decRef();
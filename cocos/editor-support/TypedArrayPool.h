@@ -25,7 +25,6 @@
 #pragma once
 #include "MiddlewareMacro.h"
 #include "SeApi.h"
-#include <map>
 #include <vector>
 
 MIDDLEWARE_BEGIN
@@ -53,11 +52,20 @@ public:
 
 private:
     typedef se::Object::TypedArrayType arrayType;
-    typedef std::vector<se::Object *> objPool;
-    typedef std::map<std::size_t, objPool *> fitMap;
-    typedef std::map<arrayType, fitMap *> typeMap;
 
-    objPool *getObjPool(arrayType type, std::size_t size);
+    // Capacities are rounded up to size classes, MIN_TYPE_ARRAY_SIZE steps up to 4 of them,
+    // then 4 classes per power of two, so a class wastes at most a quarter of its size.
+    static const std::size_t TYPE_COUNT = static_cast<std::size_t>(arrayType::FLOAT64) + 1;
+    static const std::size_t SIZE_CLASS_COUNT = 64;
+
+    struct PoolItem {
+        se::Object *object;
+        std::size_t byteLength;
+    };
+    typedef std::vector<PoolItem> objPool;
+
+    static std::size_t getSizeClass(std::size_t size);
+    static std::size_t getSizeClassBytes(std::size_t sizeClass);
 
     TypedArrayPool();
     ~TypedArrayPool();
@@ -72,15 +80,29 @@ private:
     void afterInitHandle();
 
 private:
-    typeMap _pool;
+    objPool _pool[TYPE_COUNT][SIZE_CLASS_COUNT];
+    std::size_t _pooledBytes = 0;
+    uint32_t _memoryPressureHandlerID = 0;
     bool allowPush = true;
 
 public:
     /**
-     * @brief pop a js TypeArray by given type and size
+     * @brief Creates a rooted js TypeArray over native memory, which is freed with the TypeArray.
+     * @param[in] type TypeArray type.
+     * @param[in] byteLength TypeArray capacity.
+     */
+    static se::Object *createTypedArray(arrayType type, std::size_t byteLength);
+
+    /**
+     * @brief Gets the bytes of the typed arrays waiting in the pool, the popped ones are not counted.
+     */
+    std::size_t getPooledBytes() const;
+
+    /**
+     * @brief pop a js TypeArray by given type and size, a new one views native memory the engine does not allocate.
      * @param[in] type TypeArray type.
      * @param[in] size.
-     * @return a js TypeArray Object.
+     * @return a js TypeArray Object, its capacity is the size class of size.
      */
     se::Object *pop(arrayType type, std::size_t size);
     /**
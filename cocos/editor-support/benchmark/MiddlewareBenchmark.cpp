@@ -0,0 +1,429 @@
+// Headless benchmark of the spine runtime and the middleware manager, built with USE_BENCHMARK and USE_SPINE.
+//
+//   cocos2d-middleware-benchmark [--json file --atlas file | --skel file --atlas file] [--animation name] [--bones N]
+//                                [--instances N,N,...] [--threads N,N,...] [--iterations N] [--warmup N] [--output file]
+//
+// Without files a skeleton is generated: chains of bones with region and weighted mesh attachments, and animations
+// keying every bone, its size set by --bones. JSON skeletons are converted with SkeletonBinaryWriter so both loaders
+// are measured. Animation, world transforms and vertex generation run over every instance count, serially and through
+// MiddlewareManager on JobSystem with every thread count, which counts the main thread. Results are written as one
+// JSON document, the timings are in microseconds per iteration.
+
+#include "MiddlewareManager.h"
+#include "base/JobSystem.h"
+#include "base/ThreadConfig.h"
+#include "bindings/jswrapper/SeApi.h"
+#include "cocos2d.h"
+#include "platform/FileUtils.h"
+#include "renderer/benchmark/BenchmarkHarness.h"
+#include "spine-creator-support/SkeletonAnimation.h"
+#include "spine-creator-support/SkeletonBinaryWriter.h"
+#include "spine-creator-support/SkeletonCache.h"
+#include "spine-creator-support/spine-cocos2dx.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+
+using namespace cc;
+
+namespace {
+constexpr float FRAME_TIME = 1.0f / 60.0f;
+constexpr uint CHAIN_LENGTH = 8;
+constexpr uint ATLAS_SIZE = 256;
+constexpr uint REGION_SIZE = 64; // the regions tile the page
+
+struct Options {
+    std::string json;
+    std::string skel;
+    std::string atlas;
+    std::string animation;
+    uint bones = 64;
+    vector<uint> instances = {1, 16, 64, 256};
+    vector<uint> threads;
+    uint iterations = 50;
+    uint warmup = 5;
+    std::string output;
+};
+
+struct Result {
+    std::string name;
+    uint items = 0; // of the last iteration: skeletons, instances or frames
+    vector<double> samples;
+};
+
+vector<uint> parseList(const char *value) {
+    vector<uint> list;
+    for (const char *begin = value; *begin;) {
+        char *end = nullptr;
+        const auto number = static_cast<uint>(strtoul(begin, &end, 10));
+        if (end == begin) break;
+        if (number) list.push_back(number);
+        begin = *end == ',' ? end + 1 : end;
+    }
+    return list;
+}
+
+bool parseOptions(int argc, char **argv, Options &options) {
+    const bool isParsed = parseBenchmarkOptions(argc, argv, options.output, [&](const char *name, const char *value, uint number) {
+        if (!strcmp(name, "--json")) {
+            options.json = value;
+        } else if (!strcmp(name, "--skel")) {
+            options.skel = value;
+        } else if (!strcmp(name, "--atlas")) {
+            options.atlas = value;
+        } else if (!strcmp(name, "--animation")) {
+            options.animation = value;
+        } else if (!strcmp(name, "--bones")) {
+            options.bones = std::max(number, 1u);
+        } else if (!strcmp(name, "--instances")) {
+            options.instances = parseList(value);
+        } else if (!strcmp(name, "--threads")) {
+            options.threads = parseList(value);
+        } else if (!strcmp(name, "--iterations")) {
+            options.iterations = std::max(number, 1u);
+        } else if (!strcmp(name, "--warmup")) {
+            options.warmup = number;
+        } else {
+            return false;
+        }
+        return true;
+    });
+    if (!isParsed) return false;
+    if ((!options.json.empty() || !options.skel.empty()) && options.atlas.empty()) {
+        fprintf(stderr, "A skeleton file needs --atlas\n");
+        return false;
+    }
+    if (options.threads.empty()) {
+        // JobSystem keeps a worker at least, so two threads are the fewest
+        const uint cores = std::max(std::thread::hardware_concurrency(), 2u);
+        for (uint count = 2; count < cores; count *= 2) options.threads.push_back(count);
+        options.threads.push_back(cores);
+    }
+    return true;
+}
+
+class Benchmark {
+public:
+    explicit Benchmark(const Options &options) : _options(options) {}
+
+    // prepare runs untimed before every iteration, run returns the number of items it processed
+    void measure(const std::string &name, const std::function<void()> &prepare, const std::function<uint()> &run) {
+        Result result;
+        result.name = name;
+        result.samples.reserve(_options.iterations);
+        const uint total = _options.warmup + _options.iterations;
+        for (uint i = 0; i < total; ++i) {
+            if (prepare) prepare();
+            const auto begin = std::chrono::steady_clock::now();
+            result.items = run();
+            const auto end = std::chrono::steady_clock::now();
+            if (i >= _options.warmup) result.samples.push_back(std::chrono::duration<double, std::micro>(end - begin).count());
+        }
+        fprintf(stderr, "%-48s %10u items\n", name.c_str(), result.items);
+        _results.emplace_back(std::move(result));
+    }
+
+    CC_INLINE const vector<Result> &getResults() const { return _results; }
+
+private:
+    const Options &_options;
+    vector<Result> _results;
+};
+
+void appendResult(std::string &json, const Result &result) {
+    auto samples = result.samples;
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (const auto sample : samples) sum += sample;
+    const auto count = samples.size();
+    char buffer[512];
+    snprintf(buffer, sizeof(buffer),
+             "{\"name\":\"%s\",\"items\":%u,\"iterations\":%u,\"meanUs\":%.3f,\"medianUs\":%.3f,\"minUs\":%.3f,\"p95Us\":%.3f,\"maxUs\":%.3f}",
+             result.name.c_str(), result.items, static_cast<uint>(count), sum / count, samples[count / 2], samples.front(),
+             samples[std::min(count - 1, count * 95 / 100)], samples.back());
+    json += buffer;
+}
+
+// Bones in chains of CHAIN_LENGTH under the root, a slot per bone holding a region attachment or a 3x3 mesh
+// weighted to its bone and the parent. "walk" rotates every bone and tints every fourth slot, "idle" scales
+// every other bone.
+std::string createSkeletonJSON(uint boneCount) {
+    char buffer[512];
+    std::string json = "{\"skeleton\":{\"spine\":\"3.8.99\",\"width\":512,\"height\":512},\"bones\":[{\"name\":\"root\"}";
+    for (uint i = 0; i < boneCount; ++i) {
+        const bool isChainStart = i % CHAIN_LENGTH == 0;
+        const std::string parent = isChainStart ? "root" : "b" + std::to_string(i - 1);
+        snprintf(buffer, sizeof(buffer), ",{\"name\":\"b%u\",\"parent\":\"%s\",\"length\":24,\"rotation\":%d,\"x\":%d,\"y\":%d}",
+                 i, parent.c_str(), isChainStart ? static_cast<int>(i / CHAIN_LENGTH * 40) : 8, isChainStart ? 0 : 24, isChainStart ? 0 : 2);
+        json += buffer;
+    }
+
+    json += "],\"slots\":[";
+    for (uint i = 0; i < boneCount; ++i) {
+        snprintf(buffer, sizeof(buffer), "%s{\"name\":\"s%u\",\"bone\":\"b%u\",\"attachment\":\"a%u\"}", i ? "," : "", i, i, i);
+        json += buffer;
+    }
+
+    const uint regionCount = (ATLAS_SIZE / REGION_SIZE) * (ATLAS_SIZE / REGION_SIZE);
+    json += "],\"skins\":[{\"name\":\"default\",\"attachments\":{";
+    for (uint i = 0; i < boneCount; ++i) {
+        snprintf(buffer, sizeof(buffer), "%s\"s%u\":{\"a%u\":", i ? "," : "", i, i);
+        json += buffer;
+        if (i % 2 == 0) {
+            snprintf(buffer, sizeof(buffer), "{\"path\":\"r%u\",\"x\":12,\"width\":32,\"height\":16}}", i % regionCount);
+            json += buffer;
+            continue;
+        }
+
+        // skeleton indices, the root is 0
+        const uint bone = i + 1;
+        const uint parent = i % CHAIN_LENGTH == 0 ? 0 : i;
+        std::string uvs;
+        std::string vertices;
+        for (uint y = 0; y < 3; ++y) {
+            for (uint x = 0; x < 3; ++x) {
+                const float weight = 0.25f + 0.25f * x;
+                snprintf(buffer, sizeof(buffer), "%s%.1f,%.1f", uvs.empty() ? "" : ",", x * 0.5f, y * 0.5f);
+                uvs += buffer;
+                snprintf(buffer, sizeof(buffer), "%s2,%u,%u,%d,%.2f,%u,%u,%d,%.2f", vertices.empty() ? "" : ",",
+                         bone, x * 16, (static_cast<int>(y) - 1) * 8, weight, parent, x * 16, (static_cast<int>(y) - 1) * 8, 1.0f - weight);
+                vertices += buffer;
+            }
+        }
+        std::string triangles;
+        for (uint y = 0; y < 2; ++y) {
+            for (uint x = 0; x < 2; ++x) {
+                const uint v = y * 3 + x;
+                snprintf(buffer, sizeof(buffer), "%s%u,%u,%u,%u,%u,%u", triangles.empty() ? "" : ",", v, v + 1, v + 4, v, v + 4, v + 3);
+                triangles += buffer;
+            }
+        }
+        snprintf(buffer, sizeof(buffer), "{\"type\":\"mesh\",\"path\":\"r%u\",\"width\":32,\"height\":16,\"uvs\":[", i % regionCount);
+        json += buffer;
+        json += uvs + "],\"triangles\":[" + triangles + "],\"vertices\":[" + vertices + "]}}";
+    }
+
+    json += "}}],\"animations\":{\"walk\":{\"bones\":{";
+    for (uint i = 0; i < boneCount; ++i) {
+        const int angle = 10 + static_cast<int>(i % 20);
+        snprintf(buffer, sizeof(buffer),
+                 "%s\"b%u\":{\"rotate\":[{\"angle\":0},{\"time\":0.25,\"angle\":%d},{\"time\":0.5,\"angle\":0},"
+                 "{\"time\":0.75,\"angle\":%d},{\"time\":1,\"angle\":0}]}",
+                 i ? "," : "", i, angle, -angle);
+        json += buffer;
+    }
+    json += "},\"slots\":{";
+    for (uint i = 0; i < boneCount; i += 4) {
+        snprintf(buffer, sizeof(buffer), "%s\"s%u\":{\"color\":[{\"color\":\"ffffffff\"},{\"time\":0.5,\"color\":\"ff8080ff\"},{\"time\":1,\"color\":\"ffffffff\"}]}",
+                 i ? "," : "", i);
+        json += buffer;
+    }
+    json += "}},\"idle\":{\"bones\":{";
+    for (uint i = 0; i < boneCount; i += 2) {
+        snprintf(buffer, sizeof(buffer), "%s\"b%u\":{\"scale\":[{},{\"time\":1,\"x\":1.1,\"y\":0.9},{\"time\":2}]}", i ? "," : "", i);
+        json += buffer;
+    }
+    json += "}}}}";
+    return json;
+}
+
+std::string createAtlas() {
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "synthetic.png\nsize: %u,%u\nformat: RGBA8888\nfilter: Linear,Linear\nrepeat: none\n", ATLAS_SIZE, ATLAS_SIZE);
+    std::string atlas = buffer;
+    for (uint i = 0, n = ATLAS_SIZE / REGION_SIZE; i < n * n; ++i) {
+        snprintf(buffer, sizeof(buffer), "r%u\n  rotate: false\n  xy: %u, %u\n  size: %u, %u\n  orig: %u, %u\n  offset: 0, 0\n  index: -1\n",
+                 i, i % n * REGION_SIZE, i / n * REGION_SIZE, REGION_SIZE, REGION_SIZE, REGION_SIZE, REGION_SIZE);
+        atlas += buffer;
+    }
+    return atlas;
+}
+
+// Every page gets the same texture, there is no device to upload one to
+middleware::Texture2D *loadTexture(const char * /*path*/) {
+    static middleware::Texture2D *texture = nullptr;
+    if (!texture) {
+        texture = new middleware::Texture2D();
+        texture->setPixelsWide(ATLAS_SIZE);
+        texture->setPixelsHigh(ATLAS_SIZE);
+    }
+    return texture;
+}
+
+void runLoadBenchmarks(Benchmark &benchmark, spine::AttachmentLoader *attachmentLoader, const std::string &json, const std::vector<unsigned char> &binary) {
+    if (!json.empty()) {
+        benchmark.measure("SkeletonJson::readSkeletonData", nullptr, [&]() {
+            spine::SkeletonJson reader(attachmentLoader);
+            delete reader.readSkeletonData(json.c_str());
+            return 1u;
+        });
+    }
+    benchmark.measure("SkeletonBinary::readSkeletonData", nullptr, [&]() {
+        spine::SkeletonBinary reader(attachmentLoader);
+        delete reader.readSkeletonData(binary.data(), static_cast<int>(binary.size()));
+        return 1u;
+    });
+}
+
+void runInstanceBenchmarks(Benchmark &benchmark, const Options &options, spine::SkeletonData *skeletonData, const std::string &animation) {
+    auto *manager = middleware::MiddlewareManager::getInstance();
+    for (const uint count : options.instances) {
+        vector<spine::SkeletonAnimation *> instances;
+        for (uint i = 0; i < count; ++i) {
+            auto *instance = new spine::SkeletonAnimation();
+            instance->initWithData(skeletonData, false);
+            instance->setAnimation(0, animation, true)->setTrackTime(i * 0.13f);
+            instances.push_back(instance);
+        }
+        const std::string suffix = "." + std::to_string(count);
+
+        benchmark.measure("AnimationState::apply" + suffix, nullptr, [&]() {
+            for (auto *instance : instances) {
+                instance->getState()->update(FRAME_TIME);
+                instance->getState()->apply(*instance->getSkeleton());
+            }
+            return count;
+        });
+        benchmark.measure("Skeleton::updateWorldTransform" + suffix, nullptr, [&]() {
+            for (auto *instance : instances) instance->getSkeleton()->updateWorldTransform();
+            return count;
+        });
+        // the vertex generation of every instance into its own buffers, which the manager then merges
+        benchmark.measure("SkeletonRenderer::renderParallel" + suffix, nullptr, [&]() {
+            for (auto *instance : instances) instance->renderParallel(FRAME_TIME);
+            return count;
+        });
+
+        for (const uint threads : options.threads) {
+            JobSystem::destroyInstance();
+            auto config = ThreadConfig::getLaneConfig(ThreadLane::CPU);
+            config.threadCount = threads - 1;
+            ThreadConfig::setLaneConfig(ThreadLane::CPU, config);
+
+            const std::string threadSuffix = suffix + ".t" + std::to_string(JobSystem::getInstance()->getThreadCount());
+            benchmark.measure("MiddlewareManager::update" + threadSuffix, nullptr, [&]() {
+                manager->update(FRAME_TIME);
+                return count;
+            });
+            benchmark.measure("MiddlewareManager::render" + threadSuffix, nullptr, [&]() {
+                manager->render(FRAME_TIME);
+                return count;
+            });
+        }
+
+        for (auto *instance : instances) instance->release();
+    }
+}
+
+void runCacheBenchmarks(Benchmark &benchmark, spine::SkeletonData *skeletonData, const std::string &animation) {
+    auto *cache = new spine::SkeletonCache();
+    cache->initWithData(skeletonData, false);
+    cache->buildAnimationData(animation);
+    benchmark.measure(
+        "SkeletonCache::updateToFrame", [&]() { cache->resetAnimationData(animation); },
+        [&]() {
+            cache->updateToFrame(animation);
+            return static_cast<uint>(cache->getAnimationData(animation)->getFrameCount());
+        });
+    cache->release();
+}
+
+std::string toJSON(const Options &options, spine::SkeletonData *skeletonData, const std::string &animation, const vector<Result> &results) {
+    const char *source = !options.json.empty() ? options.json.c_str() : !options.skel.empty() ? options.skel.c_str() : "synthetic";
+    char buffer[1024];
+    snprintf(buffer, sizeof(buffer),
+             "{\"schema\":1,\"engine\":\"%s\",\"skeleton\":{\"source\":\"%s\",\"bones\":%u,\"slots\":%u,\"animation\":\"%s\"},"
+             "\"cores\":%u,\"results\":[",
+             cocos2dVersion(), source, static_cast<uint>(skeletonData->getBones().size()), static_cast<uint>(skeletonData->getSlots().size()),
+             animation.c_str(), std::thread::hardware_concurrency());
+    std::string json = buffer;
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (i) json += ',';
+        appendResult(json, results[i]);
+    }
+    json += "]}\n";
+    return json;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 1;
+
+    // the shared buffers of the middleware are script typed arrays
+    auto *engine = se::ScriptEngine::getInstance();
+    if (!engine->start()) {
+        fprintf(stderr, "Script engine could not be started\n");
+        return 1;
+    }
+    spine::setSpineObjectDisposeCallback([](void *) {});
+    spine::spAtlasPage_setCustomTextureLoader(loadTexture);
+
+    int exitCode = 0;
+    {
+        se::AutoHandleScope handleScope;
+        spine::Cocos2dTextureLoader textureLoader;
+        spine::Atlas *atlas = nullptr;
+        if (options.atlas.empty()) {
+            const auto atlasText = createAtlas();
+            atlas = new spine::Atlas(atlasText.c_str(), static_cast<int>(atlasText.size()), "", &textureLoader);
+        } else {
+            atlas = new spine::Atlas(options.atlas.c_str(), &textureLoader);
+        }
+        auto *attachmentLoader = new spine::Cocos2dAtlasAttachmentLoader(atlas);
+
+        std::string json;
+        std::vector<unsigned char> binary;
+        spine::SkeletonData *skeletonData = nullptr;
+        if (!options.skel.empty()) {
+            const auto data = FileUtils::getInstance()->getDataFromFile(options.skel);
+            binary.assign(data.getBytes(), data.getBytes() + data.getSize());
+            spine::SkeletonBinary reader(attachmentLoader);
+            skeletonData = reader.readSkeletonData(binary.data(), static_cast<int>(binary.size()));
+        } else {
+            json = options.json.empty() ? createSkeletonJSON(options.bones) : FileUtils::getInstance()->getStringFromFile(options.json);
+            spine::SkeletonJson reader(attachmentLoader);
+            skeletonData = reader.readSkeletonData(json.c_str());
+            if (skeletonData && !spine::SkeletonBinaryWriter().write(json.c_str(), skeletonData, binary)) {
+                fprintf(stderr, "The skeleton could not be converted to the binary format\n");
+                exitCode = 1;
+            }
+        }
+
+        std::string animation = options.animation;
+        if (!skeletonData) {
+            fprintf(stderr, "Skeleton data could not be read\n");
+            exitCode = 1;
+        } else if (animation.empty() && skeletonData->getAnimations().size()) {
+            animation = skeletonData->getAnimations()[0]->getName().buffer();
+        }
+        if (!exitCode && !skeletonData->findAnimation(animation.c_str())) {
+            fprintf(stderr, "Animation %s not found\n", animation.c_str());
+            exitCode = 1;
+        }
+
+        if (!exitCode) {
+            Benchmark benchmark(options);
+            runLoadBenchmarks(benchmark, attachmentLoader, json, binary);
+            runInstanceBenchmarks(benchmark, options, skeletonData, animation);
+            runCacheBenchmarks(benchmark, skeletonData, animation);
+
+            const auto result = toJSON(options, skeletonData, animation, benchmark.getResults());
+            if (!writeBenchmarkResults(result, options.output)) exitCode = 1;
+        }
+
+        delete skeletonData;
+        delete attachmentLoader;
+        delete atlas;
+        middleware::MiddlewareManager::destroyInstance();
+        JobSystem::destroyInstance();
+    }
+    se::ScriptEngine::destroyInstance();
+    return exitCode;
+}
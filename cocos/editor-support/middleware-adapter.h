@@ -25,6 +25,8 @@
 
 #include "MiddlewareMacro.h"
 #include "base/Ref.h"
+#include "base/memory/AllocatedObj.h"
+#include "base/memory/PoolAlloc.h"
 #include "math/Geometry.h"
 #include "math/Vec3.h"
 #include <functional>
@@ -123,7 +125,7 @@ struct TwoColorTriangles {
 ///////////////////////////////////////////////////////////////////////
 // adapt to editor texture,this is a texture delegate,not real texture
 ///////////////////////////////////////////////////////////////////////
-class Texture2D : public cc::Ref {
+class Texture2D : public cc::Ref, public cc::AllocatedObject<cc::PoolAllocPolicy<Texture2D>> {
 public:
     Texture2D();
     virtual ~Texture2D();
@@ -193,7 +195,7 @@ private:
 ///////////////////////////////////////////////////////////////////////
 // adapt to editor sprite frame
 ///////////////////////////////////////////////////////////////////////
-class SpriteFrame : public cc::Ref {
+class SpriteFrame : public cc::Ref, public cc::AllocatedObject<cc::PoolAllocPolicy<SpriteFrame>> {
 public:
     static SpriteFrame *createWithTexture(Texture2D *pobTexture, const cc::Rect &rect);
     static SpriteFrame *createWithTexture(Texture2D *pobTexture, const cc::Rect &rect, bool rotated, const cc::Vec2 &offset, const cc::Size &originalSize);
@@ -222,6 +224,19 @@ public:
      */
     void setTexture(Texture2D *pobTexture);
 
+    /** Get rect of the frame in pixels of its texture. */
+    const cc::Rect &getRectInPixels() const { return _rectInPixels; }
+    /** Set rect of the frame in pixels of its texture. */
+    void setRectInPixels(const cc::Rect &rect) { _rectInPixels = rect; }
+    /** Whether the frame is rotated in its texture. */
+    bool isRotated() const { return _rotated; }
+    /** Set whether the frame is rotated in its texture. */
+    void setRotated(bool rotated) { _rotated = rotated; }
+    /** Get offset of the frame in pixels. */
+    const cc::Vec2 &getOffsetInPixels() const { return _offsetInPixels; }
+    /** Get original size of the trimmed frame in pixels. */
+    const cc::Size &getOriginalSizeInPixels() const { return _originalSizeInPixels; }
+
 protected:
     cc::Vec2 _anchorPoint;
     cc::Rect _rectInPixels;
@@ -134,6 +134,11 @@ SkeletonAnimation::~SkeletonAnimation() {
 void SkeletonAnimation::update(float deltaTime) {
     if (!_skeleton) return;
     if (!_paused) {
+        // the listeners call into script, events of the parallel update are raised in postUpdate
+        if (cc::middleware::MiddlewareManager::getInstance()->isParallelUpdating) {
+            _state->disableQueue();
+            _isQueueDeferred = true;
+        }
         deltaTime *= _timeScale * GlobalTimeScale;
         if (_ownsSkeleton) _skeleton->update(deltaTime);
         _state->update(deltaTime);
@@ -142,6 +147,28 @@ void SkeletonAnimation::update(float deltaTime) {
     }
 }
 
+void SkeletonAnimation::advance(float deltaTime) {
+    if (!_skeleton || _paused) return;
+    deltaTime *= _timeScale * GlobalTimeScale;
+    if (_ownsSkeleton) _skeleton->update(deltaTime);
+    _state->update(deltaTime);
+}
+
+void SkeletonAnimation::setCulled(bool culled) {
+    _culled = culled;
+}
+
+void SkeletonAnimation::setUpdateInterval(uint32_t interval) {
+    _updateInterval = interval > 1 ? interval : 1;
+}
+
+void SkeletonAnimation::postUpdate(float deltaTime) {
+    if (!_isQueueDeferred) return;
+    _isQueueDeferred = false;
+    _state->enableQueue();
+    _state->drainQueue();
+}
+
 void SkeletonAnimation::setAnimationStateData(AnimationStateData *stateData) {
     CCASSERT(stateData, "stateData cannot be null.");
 
@@ -164,7 +191,7 @@ void SkeletonAnimation::setMix(const std::string &fromAnimation, const std::stri
 
 TrackEntry *SkeletonAnimation::setAnimation(int trackIndex, const std::string &name, bool loop) {
     if (!_skeleton) return 0;
-    Animation *animation = _skeleton->getData()->findAnimation(name.c_str());
+    Animation *animation = _skeleton->getData()->findAnimation(NameRef(name));
     if (!animation) {
         CC_LOG_WARNING("Spine: Animation not found: %s", name.c_str());
         return 0;
@@ -176,7 +203,7 @@ TrackEntry *SkeletonAnimation::setAnimation(int trackIndex, const std::string &n
 
 TrackEntry *SkeletonAnimation::addAnimation(int trackIndex, const std::string &name, bool loop, float delay) {
     if (!_skeleton) return 0;
-    Animation *animation = _skeleton->getData()->findAnimation(name.c_str());
+    Animation *animation = _skeleton->getData()->findAnimation(NameRef(name));
     if (!animation) {
         CC_LOG_WARNING("Spine: Animation not found: %s", name.c_str());
         return 0;
@@ -206,7 +233,7 @@ TrackEntry *SkeletonAnimation::addEmptyAnimation(int trackIndex, float mixDurati
 
 Animation *SkeletonAnimation::findAnimation(const std::string &name) const {
     if (_skeleton) {
-        return _skeleton->getData()->findAnimation(name.c_str());
+        return _skeleton->getData()->findAnimation(NameRef(name));
     }
     return nullptr;
 }
@@ -51,6 +51,18 @@ public:
     static void setGlobalTimeScale(float timeScale);
 
     virtual void update(float deltaTime) override;
+    // A skeleton shared with another renderer is updated serially.
+    virtual bool isParallelUpdate() const override { return _ownsSkeleton; }
+    virtual void postUpdate(float deltaTime) override;
+    virtual bool isCulled() const override { return _culled; }
+    virtual uint32_t getUpdateInterval() const override { return _updateInterval; }
+    // Only advances the time of the animations, without applying them.
+    virtual void advance(float deltaTime) override;
+
+    // Set by script for a skeleton outside of the camera, it's advanced and not rendered until it's visible again.
+    void setCulled(bool culled);
+    // Applies the animations every interval updates, for distant or tiny skeletons.
+    void setUpdateInterval(uint32_t interval);
 
     void setAnimationStateData(AnimationStateData *stateData);
     void setMix(const std::string &fromAnimation, const std::string &toAnimation, float duration);
@@ -94,6 +106,9 @@ public:
 protected:
     AnimationState *_state = nullptr;
     bool _ownsAnimationStateData = false;
+    bool _isQueueDeferred = false;
+    bool _culled = false;
+    uint32_t _updateInterval = 1;
     StartListener _startListener = nullptr;
     InterruptListener _interruptListener = nullptr;
     EndListener _endListener = nullptr;
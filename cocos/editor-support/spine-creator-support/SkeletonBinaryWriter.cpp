@@ -0,0 +1,807 @@
+/******************************************************************************
+ * Spine Runtimes License Agreement
+ * Last updated January 1, 2020. Replaces all prior versions.
+ *
+ * Copyright (c) 2013-2020, Esoteric Software LLC
+ *
+ * Integration of the Spine Runtimes into software or otherwise creating
+ * derivative works of the Spine Runtimes is permitted under the terms and
+ * conditions of Section 2 of the Spine Editor License Agreement:
+ * http://esotericsoftware.com/spine-editor-license
+ *
+ * Otherwise, it is permitted to integrate the Spine Runtimes into software
+ * or otherwise create derivative works of the Spine Runtimes (collectively,
+ * "Products"), provided that each user of the Products must obtain their own
+ * Spine Editor license and redistribution of the Products in any form must
+ * include this license and copyright notice.
+ *
+ * THE SPINE RUNTIMES ARE PROVIDED BY ESOTERIC SOFTWARE LLC "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES,
+ * BUSINESS INTERRUPTION, OR LOSS OF USE, DATA, OR PROFITS) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THE SPINE RUNTIMES, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include "SkeletonBinaryWriter.h"
+#include <cmath>
+#include <cstring>
+
+namespace spine {
+
+namespace {
+const char *const DEFAULT_COLOR = "ffffffff";
+
+// channel of a hex color, the way SkeletonJson::toColor reads it
+int toByte(const char *hex, size_t index) {
+    if (!hex || index >= strlen(hex) / 2) return 0xff;
+    char digits[3] = {hex[index * 2], hex[index * 2 + 1], '\0'};
+    char *error = nullptr;
+    int value = (int)strtoul(digits, &error, 16);
+    return *error != 0 ? 0xff : value;
+}
+
+unsigned int toRGBA8888(const char *hex) {
+    return toByte(hex, 0) << 24 | toByte(hex, 1) << 16 | toByte(hex, 2) << 8 | toByte(hex, 3);
+}
+
+unsigned int toRGB888(const char *hex) {
+    return toByte(hex, 0) << 16 | toByte(hex, 1) << 8 | toByte(hex, 2);
+}
+
+template <typename T>
+int indexOf(Vector<T *> &items, const char *name) {
+    for (size_t i = 0, n = items.size(); i < n; ++i) {
+        if (name && strcmp(items[i]->getName().buffer(), name) == 0) return (int)i;
+    }
+    return -1;
+}
+} // namespace
+
+bool SkeletonBinaryWriter::write(const char *json, SkeletonData *skeletonData, std::vector<unsigned char> &output) {
+    Json root(json);
+    _skeletonData = skeletonData;
+    _buffer.clear();
+    _strings.clear();
+    _stringIndices.clear();
+    _skinIndices.clear();
+
+    Json *skeleton = Json::getItem(&root, "skeleton");
+    const char *version = skeleton ? Json::getString(skeleton, "spine", 0) : nullptr;
+    // SkeletonBinary refuses this version
+    if (version && strcmp(version, "3.8.75") == 0) return false;
+
+    if (!writeBones(&root)) return false;
+    writeSlots();
+    if (!writeConstraints(&root) || !writeSkins(&root)) return false;
+    writeEvents(&root);
+
+    Json *animations = Json::getItem(&root, "animations");
+    int animationCount = 0;
+    for (Json *animationMap = animations ? animations->_child : nullptr; animationMap; animationMap = animationMap->_next) {
+        if (_skeletonData->findAnimation(animationMap->_name)) animationCount++;
+    }
+    writeVarint(animationCount, true);
+    for (Json *animationMap = animations ? animations->_child : nullptr; animationMap; animationMap = animationMap->_next) {
+        // the JSON reader dropped it
+        if (!_skeletonData->findAnimation(animationMap->_name)) continue;
+        writeString(animationMap->_name);
+        if (!writeAnimation(animationMap)) return false;
+    }
+
+    // the header and the strings go before the data referring to them
+    std::vector<unsigned char> body;
+    body.swap(_buffer);
+    writeString(skeleton ? Json::getString(skeleton, "hash", 0) : nullptr);
+    writeString(version);
+    writeFloat(skeleton ? Json::getFloat(skeleton, "x", 0) : 0);
+    writeFloat(skeleton ? Json::getFloat(skeleton, "y", 0) : 0);
+    writeFloat(skeleton ? Json::getFloat(skeleton, "width", 0) : 0);
+    writeFloat(skeleton ? Json::getFloat(skeleton, "height", 0) : 0);
+    // nonessential, the JSON reader keeps the sizes of meshes
+    writeBoolean(true);
+    writeFloat(skeleton ? Json::getFloat(skeleton, "fps", 30) : 30);
+    writeString(skeleton ? Json::getString(skeleton, "images", 0) : nullptr);
+    writeString(skeleton ? Json::getString(skeleton, "audio", 0) : nullptr);
+    writeVarint((int)_strings.size(), true);
+    for (const auto &value : _strings) writeString(value.c_str());
+
+    output.swap(_buffer);
+    output.insert(output.end(), body.begin(), body.end());
+    _buffer.clear();
+    return true;
+}
+
+void SkeletonBinaryWriter::writeByte(int value) {
+    _buffer.push_back((unsigned char)(value & 0xff));
+}
+
+void SkeletonBinaryWriter::writeBoolean(bool value) {
+    writeByte(value ? 1 : 0);
+}
+
+void SkeletonBinaryWriter::writeInt(int value) {
+    writeByte(value >> 24);
+    writeByte(value >> 16);
+    writeByte(value >> 8);
+    writeByte(value);
+}
+
+void SkeletonBinaryWriter::writeFloat(float value) {
+    union {
+        int intValue;
+        float floatValue;
+    } floatToInt;
+    floatToInt.floatValue = value;
+    writeInt(floatToInt.intValue);
+}
+
+void SkeletonBinaryWriter::writeFloat(Json *object, const char *name, float defaultValue) {
+    writeFloat(Json::getFloat(object, name, defaultValue));
+}
+
+void SkeletonBinaryWriter::writeVarint(int value, bool optimizePositive) {
+    unsigned int bits = optimizePositive ? (unsigned int)value : ((unsigned int)value << 1) ^ (unsigned int)(value >> 31);
+    while (bits > 0x7f) {
+        writeByte((int)((bits & 0x7f) | 0x80));
+        bits >>= 7;
+    }
+    writeByte((int)bits);
+}
+
+void SkeletonBinaryWriter::writeString(const char *value) {
+    if (!value) {
+        writeVarint(0, true);
+        return;
+    }
+    auto length = strlen(value);
+    writeVarint((int)length + 1, true);
+    _buffer.insert(_buffer.end(), value, value + length);
+}
+
+void SkeletonBinaryWriter::writeStringRef(const char *value) {
+    if (!value || !*value) {
+        writeVarint(0, true);
+        return;
+    }
+    auto it = _stringIndices.find(value);
+    if (it == _stringIndices.end()) {
+        it = _stringIndices.emplace(value, (int)_strings.size()).first;
+        _strings.push_back(value);
+    }
+    writeVarint(it->second + 1, true);
+}
+
+void SkeletonBinaryWriter::writeColor(const Color &color) {
+    auto channel = [](float value) { return (int)std::round(std::fmin(std::fmax(value, 0.0f), 1.0f) * 255.0f); };
+    writeByte(channel(color.r));
+    writeByte(channel(color.g));
+    writeByte(channel(color.b));
+    writeByte(channel(color.a));
+}
+
+void SkeletonBinaryWriter::writeCurve(Json *frame) {
+    Json *curve = Json::getItem(frame, "curve");
+    if (!curve) {
+        writeByte(SkeletonBinary::CURVE_LINEAR);
+    } else if (curve->_type == Json::JSON_STRING && strcmp(curve->_valueString, "stepped") == 0) {
+        writeByte(SkeletonBinary::CURVE_STEPPED);
+    } else {
+        writeByte(SkeletonBinary::CURVE_BEZIER);
+        writeFloat(frame, "curve", 0);
+        writeFloat(frame, "c2", 0);
+        writeFloat(frame, "c3", 1);
+        writeFloat(frame, "c4", 1);
+    }
+}
+
+bool SkeletonBinaryWriter::writeBones(Json *root) {
+    Json *bones = Json::getItem(root, "bones");
+    auto &boneDatas = _skeletonData->getBones();
+    if (!bones || bones->_size != (int)boneDatas.size()) return false;
+
+    writeVarint(bones->_size, true);
+    int i = 0;
+    for (Json *boneMap = bones->_child; boneMap; boneMap = boneMap->_next, ++i) {
+        const char *parentName = Json::getString(boneMap, "parent", 0);
+        // the binary format only has the first bone as the root
+        if ((i == 0) != (parentName == nullptr)) return false;
+
+        writeString(Json::getString(boneMap, "name", 0));
+        if (i > 0) writeVarint(_skeletonData->findBoneIndex(parentName), true);
+        writeFloat(boneMap, "rotation", 0);
+        writeFloat(boneMap, "x", 0);
+        writeFloat(boneMap, "y", 0);
+        writeFloat(boneMap, "scaleX", 1);
+        writeFloat(boneMap, "scaleY", 1);
+        writeFloat(boneMap, "shearX", 0);
+        writeFloat(boneMap, "shearY", 0);
+        writeFloat(boneMap, "length", 0);
+        writeVarint(boneDatas[i]->getTransformMode(), true);
+        writeBoolean(Json::getBoolean(boneMap, "skin", false));
+        // color, nonessential
+        writeInt(0);
+    }
+    return true;
+}
+
+void SkeletonBinaryWriter::writeSlots() {
+    auto &slots = _skeletonData->getSlots();
+    writeVarint((int)slots.size(), true);
+    for (size_t i = 0, n = slots.size(); i < n; ++i) {
+        SlotData *slot = slots[i];
+        writeString(slot->getName().buffer());
+        writeVarint(slot->getBoneData().getIndex(), true);
+        writeColor(slot->getColor());
+        if (slot->hasDarkColor()) {
+            // SkeletonBinary takes any value but white with alpha as a dark color
+            Color dark = slot->getDarkColor();
+            dark.a = 0;
+            writeColor(dark);
+        } else {
+            writeInt(-1);
+        }
+        writeStringRef(slot->getAttachmentName().buffer());
+        writeVarint(slot->getBlendMode(), true);
+    }
+}
+
+bool SkeletonBinaryWriter::writeConstraints(Json *root) {
+    auto writeBoneIndices = [this](Vector<BoneData *> &bones) {
+        writeVarint((int)bones.size(), true);
+        for (size_t i = 0, n = bones.size(); i < n; ++i) writeVarint(bones[i]->getIndex(), true);
+    };
+
+    Json *ik = Json::getItem(root, "ik");
+    auto &ikConstraints = _skeletonData->getIkConstraints();
+    if ((ik ? ik->_size : 0) != (int)ikConstraints.size()) return false;
+    writeVarint((int)ikConstraints.size(), true);
+    int i = 0;
+    for (Json *constraintMap = ik ? ik->_child : nullptr; constraintMap; constraintMap = constraintMap->_next, ++i) {
+        IkConstraintData *data = ikConstraints[i];
+        writeString(Json::getString(constraintMap, "name", 0));
+        writeVarint(Json::getInt(constraintMap, "order", 0), true);
+        writeBoolean(Json::getBoolean(constraintMap, "skin", false));
+        writeBoneIndices(data->getBones());
+        writeVarint(data->getTarget()->getIndex(), true);
+        writeFloat(constraintMap, "mix", 1);
+        writeFloat(constraintMap, "softness", 0);
+        writeByte(Json::getInt(constraintMap, "bendPositive", 1) ? 1 : -1);
+        writeBoolean(Json::getInt(constraintMap, "compress", 0) != 0);
+        writeBoolean(Json::getInt(constraintMap, "stretch", 0) != 0);
+        writeBoolean(Json::getInt(constraintMap, "uniform", 0) != 0);
+    }
+
+    Json *transform = Json::getItem(root, "transform");
+    auto &transformConstraints = _skeletonData->getTransformConstraints();
+    if ((transform ? transform->_size : 0) != (int)transformConstraints.size()) return false;
+    writeVarint((int)transformConstraints.size(), true);
+    i = 0;
+    for (Json *constraintMap = transform ? transform->_child : nullptr; constraintMap; constraintMap = constraintMap->_next, ++i) {
+        TransformConstraintData *data = transformConstraints[i];
+        writeString(Json::getString(constraintMap, "name", 0));
+        writeVarint(Json::getInt(constraintMap, "order", 0), true);
+        writeBoolean(Json::getBoolean(constraintMap, "skin", false));
+        writeBoneIndices(data->getBones());
+        writeVarint(data->getTarget()->getIndex(), true);
+        writeBoolean(Json::getInt(constraintMap, "local", 0) != 0);
+        writeBoolean(Json::getInt(constraintMap, "relative", 0) != 0);
+        writeFloat(constraintMap, "rotation", 0);
+        writeFloat(constraintMap, "x", 0);
+        writeFloat(constraintMap, "y", 0);
+        writeFloat(constraintMap, "scaleX", 0);
+        writeFloat(constraintMap, "scaleY", 0);
+        writeFloat(constraintMap, "shearY", 0);
+        writeFloat(constraintMap, "rotateMix", 1);
+        writeFloat(constraintMap, "translateMix", 1);
+        writeFloat(constraintMap, "scaleMix", 1);
+        writeFloat(constraintMap, "shearMix", 1);
+    }
+
+    Json *path = Json::getItem(root, "path");
+    auto &pathConstraints = _skeletonData->getPathConstraints();
+    if ((path ? path->_size : 0) != (int)pathConstraints.size()) return false;
+    writeVarint((int)pathConstraints.size(), true);
+    i = 0;
+    for (Json *constraintMap = path ? path->_child : nullptr; constraintMap; constraintMap = constraintMap->_next, ++i) {
+        PathConstraintData *data = pathConstraints[i];
+        writeString(Json::getString(constraintMap, "name", 0));
+        writeVarint(Json::getInt(constraintMap, "order", 0), true);
+        writeBoolean(Json::getBoolean(constraintMap, "skin", false));
+        writeBoneIndices(data->getBones());
+        writeVarint(data->getTarget()->getIndex(), true);
+        writeVarint(data->getPositionMode(), true);
+        writeVarint(data->getSpacingMode(), true);
+        writeVarint(data->getRotateMode(), true);
+        writeFloat(constraintMap, "rotation", 0);
+        writeFloat(constraintMap, "position", 0);
+        writeFloat(constraintMap, "spacing", 0);
+        writeFloat(constraintMap, "rotateMix", 1);
+        writeFloat(constraintMap, "translateMix", 1);
+    }
+    return true;
+}
+
+bool SkeletonBinaryWriter::writeSkins(Json *root) {
+    Json *skins = Json::getItem(root, "skins");
+    auto &skinDatas = _skeletonData->getSkins();
+    if ((skins ? skins->_size : 0) != (int)skinDatas.size()) return false;
+
+    Skin *defaultSkin = _skeletonData->getDefaultSkin();
+    Json *defaultSkinMap = nullptr;
+    int skinIndex = defaultSkin ? 1 : 0;
+    int i = 0;
+    for (Json *skinMap = skins ? skins->_child : nullptr; skinMap; skinMap = skinMap->_next, ++i) {
+        if (skinDatas[i] == defaultSkin) {
+            defaultSkinMap = skinMap;
+            _skinIndices[skinDatas[i]] = 0;
+        } else {
+            _skinIndices[skinDatas[i]] = skinIndex++;
+        }
+    }
+
+    auto getAttachments = [](Json *skinMap) {
+        Json *attachments = Json::getItem(skinMap, "attachments");
+        return attachments ? attachments : skinMap;
+    };
+
+    // the binary default skin has neither a name, bones nor constraints
+    if (defaultSkin) {
+        if (defaultSkin->getBones().size() > 0 || defaultSkin->getConstraints().size() > 0) return false;
+        if (!writeAttachments(getAttachments(defaultSkinMap), defaultSkin)) return false;
+    } else {
+        writeVarint(0, true);
+    }
+
+    writeVarint((int)skinDatas.size() - (defaultSkin ? 1 : 0), true);
+    i = 0;
+    for (Json *skinMap = skins ? skins->_child : nullptr; skinMap; skinMap = skinMap->_next, ++i) {
+        Skin *skin = skinDatas[i];
+        if (skin == defaultSkin) continue;
+        writeStringRef(skin->getName().buffer());
+        auto &bones = skin->getBones();
+        writeVarint((int)bones.size(), true);
+        for (size_t ii = 0, nn = bones.size(); ii < nn; ++ii) writeVarint(bones[ii]->getIndex(), true);
+
+        auto &constraints = skin->getConstraints();
+        std::vector<int> ikIndices, transformIndices, pathIndices;
+        for (size_t ii = 0, nn = constraints.size(); ii < nn; ++ii) {
+            const char *name = constraints[ii]->getName().buffer();
+            int index = indexOf(_skeletonData->getIkConstraints(), name);
+            if (index >= 0 && _skeletonData->getIkConstraints()[index] == constraints[ii]) {
+                ikIndices.push_back(index);
+                continue;
+            }
+            index = indexOf(_skeletonData->getTransformConstraints(), name);
+            if (index >= 0 && _skeletonData->getTransformConstraints()[index] == constraints[ii]) {
+                transformIndices.push_back(index);
+                continue;
+            }
+            index = indexOf(_skeletonData->getPathConstraints(), name);
+            if (index < 0) return false;
+            pathIndices.push_back(index);
+        }
+        for (auto *indices : {&ikIndices, &transformIndices, &pathIndices}) {
+            writeVarint((int)indices->size(), true);
+            for (auto index : *indices) writeVarint(index, true);
+        }
+
+        if (!writeAttachments(getAttachments(skinMap), skin)) return false;
+    }
+    return true;
+}
+
+bool SkeletonBinaryWriter::writeAttachments(Json *attachmentsMap, Skin *skin) {
+    int slotCount = 0;
+    for (Json *slotMap = attachmentsMap->_child; slotMap; slotMap = slotMap->_next) {
+        int slotIndex = _skeletonData->findSlotIndex(slotMap->_name);
+        if (slotIndex < 0) {
+            if (slotMap->_child) return false;
+            continue;
+        }
+        slotCount++;
+    }
+    // no slots would read as no default skin
+    if (slotCount == 0 && skin == _skeletonData->getDefaultSkin()) return false;
+
+    writeVarint(slotCount, true);
+    for (Json *slotMap = attachmentsMap->_child; slotMap; slotMap = slotMap->_next) {
+        int slotIndex = _skeletonData->findSlotIndex(slotMap->_name);
+        if (slotIndex < 0) continue;
+
+        // the attachments without atlas region were not added
+        int attachmentCount = 0;
+        for (Json *attachmentMap = slotMap->_child; attachmentMap; attachmentMap = attachmentMap->_next) {
+            if (skin->getAttachment(slotIndex, attachmentMap->_name)) attachmentCount++;
+        }
+        writeVarint(slotIndex, true);
+        writeVarint(attachmentCount, true);
+        for (Json *attachmentMap = slotMap->_child; attachmentMap; attachmentMap = attachmentMap->_next) {
+            if (!skin->getAttachment(slotIndex, attachmentMap->_name)) continue;
+            writeStringRef(attachmentMap->_name);
+            if (!writeAttachment(attachmentMap, skin, slotIndex)) return false;
+        }
+    }
+    return true;
+}
+
+bool SkeletonBinaryWriter::writeAttachment(Json *attachmentMap, Skin *skin, int slotIndex) {
+    Attachment *attachment = skin->getAttachment(slotIndex, attachmentMap->_name);
+    const char *name = Json::getString(attachmentMap, "name", attachmentMap->_name);
+    const char *path = Json::getString(attachmentMap, "path", name);
+    const char *type = Json::getString(attachmentMap, "type", "region");
+    writeStringRef(name);
+
+    if (strcmp(type, "region") == 0) {
+        writeByte(AttachmentType_Region);
+        writeStringRef(path);
+        writeFloat(attachmentMap, "rotation", 0);
+        writeFloat(attachmentMap, "x", 0);
+        writeFloat(attachmentMap, "y", 0);
+        writeFloat(attachmentMap, "scaleX", 1);
+        writeFloat(attachmentMap, "scaleY", 1);
+        writeFloat(attachmentMap, "width", 32);
+        writeFloat(attachmentMap, "height", 32);
+        writeColor(static_cast<RegionAttachment *>(attachment)->getColor());
+    } else if (strcmp(type, "mesh") == 0 || strcmp(type, "linkedmesh") == 0) {
+        auto *mesh = static_cast<MeshAttachment *>(attachment);
+        const char *parent = Json::getString(attachmentMap, "parent", 0);
+        if (parent) {
+            // SkeletonBinary fails when the JSON reader only left the mesh unlinked
+            const char *skinName = Json::getString(attachmentMap, "skin", 0);
+            Skin *parentSkin = skinName && *skinName ? _skeletonData->findSkin(skinName) : _skeletonData->getDefaultSkin();
+            if (!parentSkin || !parentSkin->getAttachment(slotIndex, parent)) return false;
+
+            writeByte(AttachmentType_Linkedmesh);
+            writeStringRef(path);
+            writeColor(mesh->getColor());
+            writeStringRef(skinName);
+            writeStringRef(parent);
+            writeBoolean(Json::getInt(attachmentMap, "deform", 1) != 0);
+            writeFloat(attachmentMap, "width", 32);
+            writeFloat(attachmentMap, "height", 32);
+            return true;
+        }
+
+        Json *uvs = Json::getItem(attachmentMap, "uvs");
+        Json *triangles = Json::getItem(attachmentMap, "triangles");
+        if (!uvs || !triangles || uvs->_size % 2) return false;
+        writeByte(AttachmentType_Mesh);
+        writeStringRef(path);
+        writeColor(mesh->getColor());
+        writeVarint(uvs->_size / 2, true);
+        for (Json *entry = uvs->_child; entry; entry = entry->_next) writeFloat(entry->_valueFloat);
+        writeVarint(triangles->_size, true);
+        for (Json *entry = triangles->_child; entry; entry = entry->_next) {
+            writeByte(entry->_valueInt >> 8);
+            writeByte(entry->_valueInt);
+        }
+        if (!writeVertices(attachmentMap, uvs->_size)) return false;
+        writeVarint(Json::getInt(attachmentMap, "hull", 0), true);
+        Json *edges = Json::getItem(attachmentMap, "edges");
+        writeVarint(edges ? edges->_size : 0, true);
+        for (Json *entry = edges ? edges->_child : nullptr; entry; entry = entry->_next) {
+            writeByte(entry->_valueInt >> 8);
+            writeByte(entry->_valueInt);
+        }
+        writeFloat(attachmentMap, "width", 32);
+        writeFloat(attachmentMap, "height", 32);
+    } else if (strcmp(type, "boundingbox") == 0) {
+        int vertexCount = Json::getInt(attachmentMap, "vertexCount", 0);
+        writeByte(AttachmentType_Boundingbox);
+        writeVarint(vertexCount, true);
+        if (!writeVertices(attachmentMap, vertexCount << 1)) return false;
+        writeInt(0);
+    } else if (strcmp(type, "path") == 0) {
+        int vertexCount = Json::getInt(attachmentMap, "vertexCount", 0);
+        writeByte(AttachmentType_Path);
+        writeBoolean(Json::getInt(attachmentMap, "closed", 0) != 0);
+        writeBoolean(Json::getInt(attachmentMap, "constantSpeed", 1) != 0);
+        writeVarint(vertexCount, true);
+        if (!writeVertices(attachmentMap, vertexCount << 1)) return false;
+        Json *lengths = Json::getItem(attachmentMap, "lengths");
+        Json *entry = lengths ? lengths->_child : nullptr;
+        for (int i = 0, n = vertexCount / 3; i < n; ++i) {
+            writeFloat(entry ? entry->_valueFloat : 0);
+            if (entry) entry = entry->_next;
+        }
+        writeInt(0);
+    } else if (strcmp(type, "point") == 0) {
+        writeByte(AttachmentType_Point);
+        writeFloat(attachmentMap, "rotation", 0);
+        writeFloat(attachmentMap, "x", 0);
+        writeFloat(attachmentMap, "y", 0);
+        writeInt(0);
+    } else if (strcmp(type, "clipping") == 0) {
+        int endSlotIndex = _skeletonData->findSlotIndex(Json::getString(attachmentMap, "end", ""));
+        if (endSlotIndex < 0) return false;
+        int vertexCount = Json::getInt(attachmentMap, "vertexCount", 0);
+        writeByte(AttachmentType_Clipping);
+        writeVarint(endSlotIndex, true);
+        writeVarint(vertexCount, true);
+        if (!writeVertices(attachmentMap, vertexCount << 1)) return false;
+        writeInt(0);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool SkeletonBinaryWriter::writeVertices(Json *attachmentMap, int verticesLength) {
+    Json *vertices = Json::getItem(attachmentMap, "vertices");
+    if (!vertices) return false;
+
+    Json *entry = vertices->_child;
+    if (vertices->_size == verticesLength) {
+        writeBoolean(false);
+        for (; entry; entry = entry->_next) writeFloat(entry->_valueFloat);
+        return true;
+    }
+
+    // bone count, then bone index, x, y and weight for every bone of a vertex
+    writeBoolean(true);
+    int vertexCount = 0;
+    while (entry) {
+        int boneCount = (int)entry->_valueFloat;
+        entry = entry->_next;
+        writeVarint(boneCount, true);
+        for (int i = 0; i < boneCount; ++i) {
+            if (!entry || !entry->_next || !entry->_next->_next || !entry->_next->_next->_next) return false;
+            writeVarint((int)entry->_valueFloat, true);
+            entry = entry->_next;
+            for (int ii = 0; ii < 3; ++ii, entry = entry->_next) writeFloat(entry->_valueFloat);
+        }
+        vertexCount++;
+    }
+    return vertexCount * 2 == verticesLength;
+}
+
+void SkeletonBinaryWriter::writeEvents(Json *root) {
+    Json *events = Json::getItem(root, "events");
+    writeVarint(events ? events->_size : 0, true);
+    for (Json *eventMap = events ? events->_child : nullptr; eventMap; eventMap = eventMap->_next) {
+        writeStringRef(eventMap->_name);
+        writeVarint(Json::getInt(eventMap, "int", 0), false);
+        writeFloat(eventMap, "float", 0);
+        writeString(Json::getString(eventMap, "string", 0));
+        const char *audioPath = Json::getString(eventMap, "audio", 0);
+        writeString(audioPath);
+        if (audioPath && *audioPath) {
+            writeFloat(eventMap, "volume", 1);
+            writeFloat(eventMap, "balance", 0);
+        }
+    }
+}
+
+bool SkeletonBinaryWriter::writeAnimation(Json *animationMap) {
+    Json *paths = Json::getItem(animationMap, "path");
+    if (!paths) paths = Json::getItem(animationMap, "paths");
+    Json *drawOrder = Json::getItem(animationMap, "drawOrder");
+    if (!drawOrder) drawOrder = Json::getItem(animationMap, "draworder");
+
+    writeSlotTimelines(Json::getItem(animationMap, "slots"));
+    writeBoneTimelines(Json::getItem(animationMap, "bones"));
+    writeConstraintTimelines(Json::getItem(animationMap, "ik"), Json::getItem(animationMap, "transform"), paths);
+    if (!writeDeformTimelines(Json::getItem(animationMap, "deform"))) return false;
+    writeDrawOrderTimeline(drawOrder);
+    writeEventTimeline(Json::getItem(animationMap, "events"));
+    return true;
+}
+
+void SkeletonBinaryWriter::writeSlotTimelines(Json *slots) {
+    writeVarint(slots ? slots->_size : 0, true);
+    for (Json *slotMap = slots ? slots->_child : nullptr; slotMap; slotMap = slotMap->_next) {
+        writeVarint(_skeletonData->findSlotIndex(slotMap->_name), true);
+        writeVarint(slotMap->_size, true);
+        for (Json *timelineMap = slotMap->_child; timelineMap; timelineMap = timelineMap->_next) {
+            int frameIndex = 0, lastFrame = timelineMap->_size - 1;
+            if (strcmp(timelineMap->_name, "attachment") == 0) {
+                writeByte(SkeletonBinary::SLOT_ATTACHMENT);
+                writeVarint(timelineMap->_size, true);
+                for (Json *valueMap = timelineMap->_child; valueMap; valueMap = valueMap->_next) {
+                    writeFloat(valueMap, "time", 0);
+                    Json *name = Json::getItem(valueMap, "name");
+                    writeStringRef(name && name->_type != Json::JSON_NULL ? name->_valueString : nullptr);
+                }
+            } else if (strcmp(timelineMap->_name, "color") == 0) {
+                writeByte(SkeletonBinary::SLOT_COLOR);
+                writeVarint(timelineMap->_size, true);
+                for (Json *valueMap = timelineMap->_child; valueMap; valueMap = valueMap->_next, ++frameIndex) {
+                    writeFloat(valueMap, "time", 0);
+                    writeInt((int)toRGBA8888(Json::getString(valueMap, "color", DEFAULT_COLOR)));
+                    if (frameIndex < lastFrame) writeCurve(valueMap);
+                }
+            } else {
+                writeByte(SkeletonBinary::SLOT_TWO_COLOR);
+                writeVarint(timelineMap->_size, true);
+                for (Json *valueMap = timelineMap->_child; valueMap; valueMap = valueMap->_next, ++frameIndex) {
+                    writeFloat(valueMap, "time", 0);
+                    writeInt((int)toRGBA8888(Json::getString(valueMap, "light", DEFAULT_COLOR)));
+                    writeInt((int)toRGB888(Json::getString(valueMap, "dark", DEFAULT_COLOR)));
+                    if (frameIndex < lastFrame) writeCurve(valueMap);
+                }
+            }
+        }
+    }
+}
+
+void SkeletonBinaryWriter::writeBoneTimelines(Json *bones) {
+    writeVarint(bones ? bones->_size : 0, true);
+    for (Json *boneMap = bones ? bones->_child : nullptr; boneMap; boneMap = boneMap->_next) {
+        writeVarint(_skeletonData->findBoneIndex(boneMap->_name), true);
+        writeVarint(boneMap->_size, true);
+        for (Json *timelineMap = boneMap->_child; timelineMap; timelineMap = timelineMap->_next) {
+            int frameIndex = 0, lastFrame = timelineMap->_size - 1;
+            bool isRotate = strcmp(timelineMap->_name, "rotate") == 0;
+            bool isScale = strcmp(timelineMap->_name, "scale") == 0;
+            if (isRotate) {
+                writeByte(SkeletonBinary::BONE_ROTATE);
+            } else if (isScale) {
+                writeByte(SkeletonBinary::BONE_SCALE);
+            } else if (strcmp(timelineMap->_name, "shear") == 0) {
+                writeByte(SkeletonBinary::BONE_SHEAR);
+            } else {
+                writeByte(SkeletonBinary::BONE_TRANSLATE);
+            }
+            writeVarint(timelineMap->_size, true);
+            for (Json *valueMap = timelineMap->_child; valueMap; valueMap = valueMap->_next, ++frameIndex) {
+                writeFloat(valueMap, "time", 0);
+                if (isRotate) {
+                    writeFloat(valueMap, "angle", 0);
+                } else {
+                    writeFloat(valueMap, "x", isScale ? 1 : 0);
+                    writeFloat(valueMap, "y", isScale ? 1 : 0);
+                }
+                if (frameIndex < lastFrame) writeCurve(valueMap);
+            }
+        }
+    }
+}
+
+void SkeletonBinaryWriter::writeConstraintTimelines(Json *ik, Json *transform, Json *paths) {
+    writeVarint(ik ? ik->_size : 0, true);
+    for (Json *constraintMap = ik ? ik->_child : nullptr; constraintMap; constraintMap = constraintMap->_next) {
+        int frameIndex = 0, lastFrame = constraintMap->_size - 1;
+        writeVarint(indexOf(_skeletonData->getIkConstraints(), constraintMap->_name), true);
+        writeVarint(constraintMap->_size, true);
+        for (Json *valueMap = constraintMap->_child; valueMap; valueMap = valueMap->_next, ++frameIndex) {
+            writeFloat(valueMap, "time", 0);
+            writeFloat(valueMap, "mix", 1);
+            writeFloat(valueMap, "softness", 0);
+            writeByte(Json::getInt(valueMap, "bendPositive", 1) ? 1 : -1);
+            writeBoolean(Json::getInt(valueMap, "compress", 0) != 0);
+            writeBoolean(Json::getInt(valueMap, "stretch", 0) != 0);
+            if (frameIndex < lastFrame) writeCurve(valueMap);
+        }
+    }
+
+    writeVarint(transform ? transform->_size : 0, true);
+    for (Json *constraintMap = transform ? transform->_child : nullptr; constraintMap; constraintMap = constraintMap->_next) {
+        int frameIndex = 0, lastFrame = constraintMap->_size - 1;
+        writeVarint(indexOf(_skeletonData->getTransformConstraints(), constraintMap->_name), true);
+        writeVarint(constraintMap->_size, true);
+        for (Json *valueMap = constraintMap->_child; valueMap; valueMap = valueMap->_next, ++frameIndex) {
+            writeFloat(valueMap, "time", 0);
+            writeFloat(valueMap, "rotateMix", 1);
+            writeFloat(valueMap, "translateMix", 1);
+            writeFloat(valueMap, "scaleMix", 1);
+            writeFloat(valueMap, "shearMix", 1);
+            if (frameIndex < lastFrame) writeCurve(valueMap);
+        }
+    }
+
+    // the JSON reader skips unknown path timelines
+    auto getPathTimeline = [](Json *timelineMap) {
+        if (strcmp(timelineMap->_name, "position") == 0) return SkeletonBinary::PATH_POSITION;
+        if (strcmp(timelineMap->_name, "spacing") == 0) return SkeletonBinary::PATH_SPACING;
+        if (strcmp(timelineMap->_name, "mix") == 0) return SkeletonBinary::PATH_MIX;
+        return -1;
+    };
+    writeVarint(paths ? paths->_size : 0, true);
+    for (Json *constraintMap = paths ? paths->_child : nullptr; constraintMap; constraintMap = constraintMap->_next) {
+        int timelineCount = 0;
+        for (Json *timelineMap = constraintMap->_child; timelineMap; timelineMap = timelineMap->_next) {
+            if (getPathTimeline(timelineMap) != -1) timelineCount++;
+        }
+        writeVarint(indexOf(_skeletonData->getPathConstraints(), constraintMap->_name), true);
+        writeVarint(timelineCount, true);
+        for (Json *timelineMap = constraintMap->_child; timelineMap; timelineMap = timelineMap->_next) {
+            int timelineType = getPathTimeline(timelineMap);
+            if (timelineType == -1) continue;
+            int frameIndex = 0, lastFrame = timelineMap->_size - 1;
+            writeByte(timelineType);
+            writeVarint(timelineMap->_size, true);
+            for (Json *valueMap = timelineMap->_child; valueMap; valueMap = valueMap->_next, ++frameIndex) {
+                writeFloat(valueMap, "time", 0);
+                if (timelineType == SkeletonBinary::PATH_MIX) {
+                    writeFloat(valueMap, "rotateMix", 1);
+                    writeFloat(valueMap, "translateMix", 1);
+                } else {
+                    writeFloat(valueMap, timelineMap->_name, 0);
+                }
+                if (frameIndex < lastFrame) writeCurve(valueMap);
+            }
+        }
+    }
+}
+
+bool SkeletonBinaryWriter::writeDeformTimelines(Json *deform) {
+    // the JSON reader drops the timelines read before the one of a missing attachment, left to it
+    for (Json *skinMap = deform ? deform->_child : nullptr; skinMap; skinMap = skinMap->_next) {
+        Skin *skin = _skeletonData->findSkin(skinMap->_name);
+        if (!skin) return false;
+        for (Json *slotMap = skinMap->_child; slotMap; slotMap = slotMap->_next) {
+            int slotIndex = _skeletonData->findSlotIndex(slotMap->_name);
+            for (Json *timelineMap = slotMap->_child; timelineMap; timelineMap = timelineMap->_next) {
+                if (!skin->getAttachment(slotIndex, timelineMap->_name)) return false;
+            }
+        }
+    }
+
+    writeVarint(deform ? deform->_size : 0, true);
+    for (Json *skinMap = deform ? deform->_child : nullptr; skinMap; skinMap = skinMap->_next) {
+        writeVarint(_skinIndices[_skeletonData->findSkin(skinMap->_name)], true);
+        writeVarint(skinMap->_size, true);
+        for (Json *slotMap = skinMap->_child; slotMap; slotMap = slotMap->_next) {
+            writeVarint(_skeletonData->findSlotIndex(slotMap->_name), true);
+            writeVarint(slotMap->_size, true);
+            for (Json *timelineMap = slotMap->_child; timelineMap; timelineMap = timelineMap->_next) {
+                int frameIndex = 0, lastFrame = timelineMap->_size - 1;
+                writeStringRef(timelineMap->_name);
+                writeVarint(timelineMap->_size, true);
+                for (Json *valueMap = timelineMap->_child; valueMap; valueMap = valueMap->_next, ++frameIndex) {
+                    writeFloat(valueMap, "time", 0);
+                    Json *vertices = Json::getItem(valueMap, "vertices");
+                    if (!vertices || vertices->_size == 0) {
+                        writeVarint(0, true);
+                    } else {
+                        writeVarint(vertices->_size, true);
+                        writeVarint(Json::getInt(valueMap, "offset", 0), true);
+                        for (Json *vertex = vertices->_child; vertex; vertex = vertex->_next) writeFloat(vertex->_valueFloat);
+                    }
+                    if (frameIndex < lastFrame) writeCurve(valueMap);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void SkeletonBinaryWriter::writeDrawOrderTimeline(Json *drawOrder) {
+    writeVarint(drawOrder ? drawOrder->_size : 0, true);
+    for (Json *valueMap = drawOrder ? drawOrder->_child : nullptr; valueMap; valueMap = valueMap->_next) {
+        writeFloat(valueMap, "time", 0);
+        Json *offsets = Json::getItem(valueMap, "offsets");
+        writeVarint(offsets ? offsets->_size : 0, true);
+        for (Json *offsetMap = offsets ? offsets->_child : nullptr; offsetMap; offsetMap = offsetMap->_next) {
+            writeVarint(_skeletonData->findSlotIndex(Json::getString(offsetMap, "slot", "")), true);
+            // negative offsets wrap around like the unsigned index they are added to
+            writeVarint(Json::getInt(offsetMap, "offset", 0), true);
+        }
+    }
+}
+
+void SkeletonBinaryWriter::writeEventTimeline(Json *events) {
+    auto &eventDatas = _skeletonData->getEvents();
+    writeVarint(events ? events->_size : 0, true);
+    for (Json *valueMap = events ? events->_child : nullptr; valueMap; valueMap = valueMap->_next) {
+        int eventIndex = indexOf(eventDatas, Json::getString(valueMap, "name", 0));
+        EventData *eventData = eventDatas[eventIndex];
+        writeFloat(valueMap, "time", 0);
+        writeVarint(eventIndex, true);
+        writeVarint(Json::getInt(valueMap, "int", eventData->getIntValue()), false);
+        writeFloat(valueMap, "float", eventData->getFloatValue());
+        writeBoolean(true);
+        writeString(Json::getString(valueMap, "string", eventData->getStringValue().buffer()));
+        if (!eventData->getAudioPath().isEmpty()) {
+            writeFloat(valueMap, "volume", 1);
+            writeFloat(valueMap, "balance", 0);
+        }
+    }
+}
+
+} // namespace spine
@@ -0,0 +1,87 @@
+/******************************************************************************
+ * Spine Runtimes License Agreement
+ * Last updated January 1, 2020. Replaces all prior versions.
+ *
+ * Copyright (c) 2013-2020, Esoteric Software LLC
+ *
+ * Integration of the Spine Runtimes into software or otherwise creating
+ * derivative works of the Spine Runtimes is permitted under the terms and
+ * conditions of Section 2 of the Spine Editor License Agreement:
+ * http://esotericsoftware.com/spine-editor-license
+ *
+ * Otherwise, it is permitted to integrate the Spine Runtimes into software
+ * or otherwise create derivative works of the Spine Runtimes (collectively,
+ * "Products"), provided that each user of the Products must obtain their own
+ * Spine Editor license and redistribution of the Products in any form must
+ * include this license and copyright notice.
+ *
+ * THE SPINE RUNTIMES ARE PROVIDED BY ESOTERIC SOFTWARE LLC "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES,
+ * BUSINESS INTERRUPTION, OR LOSS OF USE, DATA, OR PROFITS) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THE SPINE RUNTIMES, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#pragma once
+
+#include "spine/spine.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace spine {
+
+/**
+ * Converts JSON skeleton data into the binary format SkeletonBinary reads, which loads without parsing text.
+ * Values are written unscaled, the reader applies its scale. Attachments and animations the JSON reader
+ * dropped from the skeleton data, for missing atlas regions or broken references, are left out so both
+ * loads give the same skeleton data.
+ */
+class SkeletonBinaryWriter {
+public:
+    // skeletonData is the data the JSON was read into. Returns false for the JSON the binary format
+    // can't express, such as several root bones, output is undefined then.
+    bool write(const char *json, SkeletonData *skeletonData, std::vector<unsigned char> &output);
+
+private:
+    void writeByte(int value);
+    void writeBoolean(bool value);
+    void writeInt(int value);
+    void writeFloat(float value);
+    void writeVarint(int value, bool optimizePositive);
+    void writeString(const char *value);
+    void writeStringRef(const char *value);
+    void writeColor(const Color &color);
+    void writeFloat(Json *object, const char *name, float defaultValue);
+    void writeCurve(Json *frame);
+
+    bool writeBones(Json *root);
+    void writeSlots();
+    bool writeConstraints(Json *root);
+    bool writeSkins(Json *root);
+    bool writeAttachments(Json *attachmentsMap, Skin *skin);
+    bool writeAttachment(Json *attachmentMap, Skin *skin, int slotIndex);
+    bool writeVertices(Json *attachmentMap, int verticesLength);
+    void writeEvents(Json *root);
+    bool writeAnimation(Json *animationMap);
+    void writeSlotTimelines(Json *slots);
+    void writeBoneTimelines(Json *bones);
+    void writeConstraintTimelines(Json *ik, Json *transform, Json *paths);
+    bool writeDeformTimelines(Json *deform);
+    void writeDrawOrderTimeline(Json *drawOrder);
+    void writeEventTimeline(Json *events);
+
+    SkeletonData *_skeletonData = nullptr;
+    std::vector<unsigned char> _buffer;
+    std::vector<std::string> _strings;
+    std::map<std::string, int> _stringIndices;
+    // index of every skin in the binary, the default skin goes first
+    std::map<Skin *, int> _skinIndices;
+};
+
+} // namespace spine
@@ -29,14 +29,41 @@
 
 #include "SkeletonCache.h"
 #include "spine-creator-support/AttachmentVertices.h"
+#include "spine-creator-support/SkeletonCacheMgr.h"
+#include "base/Scheduler.h"
+#include "base/ThreadPool.h"
+#include "platform/Application.h"
+#include <algorithm>
+#include <cfloat>
 
 USING_NS_MW;
 using namespace cc;
 
 namespace spine {
 
+namespace {
+const float UNORM16_MAX = 65535.0f;
+
+inline uint16_t toUnorm16(float value) {
+    return (uint16_t)(std::min(std::max(value, 0.0f), 1.0f) * UNORM16_MAX + 0.5f);
+}
+
+inline uint32_t toRGBA8(const Color4F &color) {
+    auto channel = [](float value) { return (uint32_t)(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f); };
+    return channel(color.r) | channel(color.g) << 8 | channel(color.b) << 16 | channel(color.a) << 24;
+}
+
+inline void fromRGBA8(uint32_t color, float *out) {
+    out[0] = (color & 0xff) / 255.0f;
+    out[1] = (color >> 8 & 0xff) / 255.0f;
+    out[2] = (color >> 16 & 0xff) / 255.0f;
+    out[3] = (color >> 24) / 255.0f;
+}
+} // namespace
+
 float SkeletonCache::FrameTime = 1.0f / 60.0f;
 float SkeletonCache::MaxCacheTime = 120.0f;
+std::size_t SkeletonCache::AnimationData::UseCount = 0;
 
 SkeletonCache::SegmentData::SegmentData() {
 }
@@ -114,6 +141,89 @@ std::size_t SkeletonCache::FrameData::getSegmentCount() const {
     return _segments.size();
 }
 
+bool SkeletonCache::FrameData::isCompatible(const FrameData *other) const {
+    if (!other || getVertexCount() != other->getVertexCount() || _segments.size() != other->_segments.size() || _bones.size() != other->_bones.size()) {
+        return false;
+    }
+    for (std::size_t i = 0, c = _segments.size(); i < c; i++) {
+        auto segment = _segments[i];
+        auto otherSegment = other->_segments[i];
+        if (segment->indexCount != otherSegment->indexCount || segment->vertexFloatCount != otherSegment->vertexFloatCount ||
+            segment->blendMode != otherSegment->blendMode || segment->getTexture() != otherSegment->getTexture()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SkeletonCache::FrameData::pack(const IOBuffer &srcVB, const IOBuffer &srcIB) {
+    auto src = (const V2F_T2F_C4F_C4F *)srcVB.getBuffer();
+    std::size_t count = srcVB.length() / sizeof(V2F_T2F_C4F_C4F);
+
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    for (std::size_t i = 0; i < count; i++) {
+        minX = std::min(minX, src[i].vertex.x);
+        minY = std::min(minY, src[i].vertex.y);
+        maxX = std::max(maxX, src[i].vertex.x);
+        maxY = std::max(maxY, src[i].vertex.y);
+    }
+    _originX = count ? minX : 0.0f;
+    _originY = count ? minY : 0.0f;
+    _stepX = count ? (maxX - minX) / UNORM16_MAX : 0.0f;
+    _stepY = count ? (maxY - minY) / UNORM16_MAX : 0.0f;
+
+    // frames are allocated at their exact size
+    vb.reset();
+    if (count > 0) {
+        vb.resize(count * sizeof(PackedVertex));
+        auto dst = (PackedVertex *)vb.getBuffer();
+        for (std::size_t i = 0; i < count; i++) {
+            dst[i].x = _stepX > 0.0f ? toUnorm16((src[i].vertex.x - _originX) / _stepX / UNORM16_MAX) : 0;
+            dst[i].y = _stepY > 0.0f ? toUnorm16((src[i].vertex.y - _originY) / _stepY / UNORM16_MAX) : 0;
+            dst[i].u = toUnorm16(src[i].texCoord.u);
+            dst[i].v = toUnorm16(src[i].texCoord.v);
+            dst[i].color = toRGBA8(src[i].color);
+            dst[i].darkColor = toRGBA8(src[i].color2);
+        }
+        vb.move((int)(count * sizeof(PackedVertex)));
+    }
+
+    ib.reset();
+    if (srcIB.length() > 0) {
+        ib.resize(srcIB.length());
+        ib.writeBytes((const char *)srcIB.getBuffer(), srcIB.length());
+    }
+}
+
+void SkeletonCache::FrameData::unpackVertices(std::size_t first, std::size_t count, const FrameData *next, float ratio, float *out, int stride) const {
+    auto src = (const PackedVertex *)vb.getBuffer() + first;
+    auto nextSrc = next ? (const PackedVertex *)next->vb.getBuffer() + first : nullptr;
+    for (std::size_t i = 0; i < count; i++, out += stride) {
+        float x = _originX + src[i].x * _stepX;
+        float y = _originY + src[i].y * _stepY;
+        if (nextSrc) {
+            x += (next->_originX + nextSrc[i].x * next->_stepX - x) * ratio;
+            y += (next->_originY + nextSrc[i].y * next->_stepY - y) * ratio;
+        }
+        out[0] = x;
+        out[1] = y;
+        out[2] = 0.0f;
+        out[3] = src[i].u / UNORM16_MAX;
+        out[4] = src[i].v / UNORM16_MAX;
+        fromRGBA8(src[i].color, out + 5);
+        if (stride >= (int)(sizeof(V2F_T2F_C4F_C4F) / sizeof(float))) {
+            fromRGBA8(src[i].darkColor, out + 9);
+        }
+    }
+}
+
+std::size_t SkeletonCache::FrameData::getMemorySize() const {
+    return sizeof(FrameData) + vb.getCapacity() + ib.getCapacity() +
+           _bones.size() * (sizeof(BoneData) + sizeof(BoneData *)) +
+           _colors.size() * (sizeof(ColorData) + sizeof(ColorData *)) +
+           _segments.size() * (sizeof(SegmentData) + sizeof(SegmentData *));
+}
+
 SkeletonCache::AnimationData::AnimationData() {
 }
 
@@ -128,6 +238,8 @@ void SkeletonCache::AnimationData::reset() {
     _frames.clear();
     _isComplete = false;
     _totalTime = 0.0f;
+    _frameTime = 0.0f;
+    _memorySize = 0;
 }
 
 bool SkeletonCache::AnimationData::needUpdate(int toFrameIdx) const {
@@ -156,10 +268,13 @@ std::size_t SkeletonCache::AnimationData::getFrameCount() const {
     return _frames.size();
 }
 
-SkeletonCache::SkeletonCache() {
+SkeletonCache::SkeletonCache() : _isAlive(std::make_shared<bool>(true)) {
 }
 
 SkeletonCache::~SkeletonCache() {
+    // running jobs find the cache gone and release themselves
+    *_isAlive = false;
+    _bakeJobs.clear();
     for (auto it = _animationCaches.begin(); it != _animationCaches.end(); it++) {
         delete it->second;
     }
@@ -210,6 +325,8 @@ void SkeletonCache::updateToFrame(const std::string &animationName, int toFrameI
         return;
     }
 
+    // the use count is shared by all caches
+    if (!_isBaker) animationData->touch();
     if (_curAnimationName != animationName) {
         updateToFrame(_curAnimationName);
         _curAnimationName = animationName;
@@ -218,13 +335,17 @@ void SkeletonCache::updateToFrame(const std::string &animationName, int toFrameI
     // init animation
     if (animationData->getFrameCount() == 0) {
         setAnimation(0, animationName, false);
+        animationData->_frameTime = FrameTime;
     }
 
     do {
-        update(FrameTime);
+        update(animationData->_frameTime);
         renderAnimationFrame(animationData);
-        animationData->_totalTime += FrameTime;
+        animationData->_memorySize += animationData->getFrameData(animationData->getFrameCount() - 1)->getMemorySize();
+        animationData->_totalTime += animationData->_frameTime;
     } while (animationData->needUpdate(toFrameIdx));
+
+    if (!_isBaker) SkeletonCacheMgr::getInstance()->trimToBudget(animationData);
 }
 
 void SkeletonCache::renderAnimationFrame(AnimationData *animationData) {
@@ -245,8 +366,10 @@ void SkeletonCache::renderAnimationFrame(AnimationData *animationData) {
     Color4F darkColor;
 
     AttachmentVertices *attachmentVertices = nullptr;
-    middleware::IOBuffer &vb = frameData->vb;
-    middleware::IOBuffer &ib = frameData->ib;
+    middleware::IOBuffer &vb = _bakeVB;
+    middleware::IOBuffer &ib = _bakeIB;
+    vb.reset();
+    ib.reset();
 
     // vertex size int bytes with two color
     int vbs2 = sizeof(V2F_T2F_C4F_C4F);
@@ -278,7 +401,12 @@ void SkeletonCache::renderAnimationFrame(AnimationData *animationData) {
         }
 
         SegmentData *segmentData = frameData->buildSegmentData(materialLen);
-        segmentData->setTexture(texture);
+        if (_isBaker) {
+            // Ref counts are not atomic, the texture is retained on the cocos thread with the baked frames
+            segmentData->_texture = texture;
+        } else {
+            segmentData->setTexture(texture);
+        }
         segmentData->blendMode = slot->getData().getBlendMode();
 
         // save new segment count pos field
@@ -526,6 +654,8 @@ void SkeletonCache::renderAnimationFrame(AnimationData *animationData) {
         ColorData *preColorData = frameData->buildColorData(colorCount - 1);
         preColorData->vertexFloatOffset = (int)vb.getCurPos() / sizeof(float);
     }
+
+    frameData->pack(vb, ib);
 }
 
 void SkeletonCache::onAnimationStateEvent(TrackEntry *entry, EventType type, Event *event) {
@@ -548,6 +678,91 @@ void SkeletonCache::resetAllAnimationData() {
     }
 }
 
+void SkeletonCache::evictAnimationData(AnimationData *animationData) {
+    // a partly baked animation is not finished when another one is baked
+    if (animationData->_animationName == _curAnimationName) {
+        _curAnimationName = "";
+    }
+    animationData->reset();
+}
+
+bool SkeletonCache::bakeAnimationDataAsync(const std::string &animationName, const BakeCallback &callback) {
+    auto it = _bakeJobs.find(animationName);
+    if (it != _bakeJobs.end()) {
+        if (callback) it->second->callbacks.push_back(callback);
+        return true;
+    }
+
+    if (_uuid.empty()) return false;
+    AnimationData *animationData = buildAnimationData(animationName);
+    if (!animationData || animationData->isComplete()) return false;
+
+    // the baker takes its skeleton data here, SkeletonDataMgr is only used on the cocos thread
+    auto job = new BakeJob();
+    job->baker = new SkeletonCache();
+    job->baker->_isBaker = true;
+    job->baker->initWithUUID(_uuid);
+    job->baker->buildAnimationData(animationName);
+    job->animationName = animationName;
+    if (callback) job->callbacks.push_back(callback);
+    _bakeJobs[animationName] = job;
+
+    auto isAlive = _isAlive;
+    auto finish = [this, job, isAlive]() {
+        if (*isAlive) {
+            finishBake(job);
+        } else {
+            releaseBakeJob(job);
+        }
+    };
+    SkeletonCacheMgr::getInstance()->getBakeThreadPool()->pushTask([job, finish](int /*threadId*/) {
+        job->baker->updateToFrame(job->animationName);
+        cc::Application::getInstance()->getScheduler()->performFunctionInCocosThread(finish);
+    });
+    return true;
+}
+
+void SkeletonCache::finishBake(BakeJob *job) {
+    _bakeJobs.erase(job->animationName);
+
+    AnimationData *bakedData = job->baker->getAnimationData(job->animationName);
+    AnimationData *animationData = getAnimationData(job->animationName);
+    // the animation may have been completed by playing it meanwhile
+    if (bakedData && bakedData->getFrameCount() > 0 && animationData && !animationData->isComplete()) {
+        for (auto frameData : bakedData->_frames) {
+            for (auto segmentData : frameData->_segments) CC_SAFE_RETAIN(segmentData->_texture);
+        }
+        // the state baking it here lags behind the frames now
+        if (job->animationName == _curAnimationName) {
+            _curAnimationName = "";
+        }
+        animationData->reset();
+        std::swap(animationData->_frames, bakedData->_frames);
+        animationData->_isComplete = bakedData->_isComplete;
+        animationData->_totalTime = bakedData->_totalTime;
+        animationData->_frameTime = bakedData->_frameTime;
+        animationData->_memorySize = bakedData->_memorySize;
+        animationData->touch();
+        SkeletonCacheMgr::getInstance()->trimToBudget(animationData);
+    }
+
+    auto callbacks = std::move(job->callbacks);
+    auto animationName = job->animationName;
+    releaseBakeJob(job);
+    for (const auto &callback : callbacks) callback(animationName);
+}
+
+void SkeletonCache::releaseBakeJob(BakeJob *job) {
+    // frames left in the baker hold their textures unretained
+    for (const auto &it : job->baker->_animationCaches) {
+        for (auto frameData : it.second->_frames) {
+            for (auto segmentData : frameData->_segments) segmentData->_texture = nullptr;
+        }
+    }
+    job->baker->release();
+    delete job;
+}
+
 void SkeletonCache::resetAnimationData(const std::string &animationName) {
     for (auto it = _animationCaches.begin(); it != _animationCaches.end(); it++) {
         if (it->second->_animationName == animationName) {
@@ -32,6 +32,8 @@
 #include "IOBuffer.h"
 #include "SkeletonAnimation.h"
 #include "middleware-adapter.h"
+#include <functional>
+#include <memory>
 #include <vector>
 
 namespace spine {
@@ -65,6 +67,17 @@ public:
         int vertexFloatOffset = 0;
     };
 
+    // Baked vertex, the position is quantized into the bounds of its frame, the texture coordinates
+    // into [0, 1] and the colors into RGBA8.
+    struct PackedVertex {
+        uint16_t x = 0;
+        uint16_t y = 0;
+        uint16_t u = 0;
+        uint16_t v = 0;
+        uint32_t color = 0;
+        uint32_t darkColor = 0;
+    };
+
     struct FrameData {
         friend class SkeletonCache;
 
@@ -86,7 +99,20 @@ public:
         }
         std::size_t getSegmentCount() const;
 
+        std::size_t getVertexCount() const {
+            return vb.length() / sizeof(PackedVertex);
+        }
+        // Same segments and vertex count, the vertices of the frames can be interpolated.
+        bool isCompatible(const FrameData *other) const;
+        // Writes count vertices from first on with the float stride of V2F_T2F_C4F or V2F_T2F_C4F_C4F,
+        // the positions are interpolated by ratio towards the compatible next frame if it is not null.
+        void unpackVertices(std::size_t first, std::size_t count, const FrameData *next, float ratio, float *out, int stride) const;
+        std::size_t getMemorySize() const;
+
     private:
+        // packs the V2F_T2F_C4F_C4F of the baked frame into vb and copies the indices
+        void pack(const cc::middleware::IOBuffer &srcVB, const cc::middleware::IOBuffer &srcIB);
+
         // if segment data is empty, it will build new one.
         SegmentData *buildSegmentData(std::size_t index);
         // if color data is empty, it will build new one.
@@ -98,9 +124,14 @@ public:
         std::vector<ColorData *> _colors;
         std::vector<SegmentData *> _segments;
 
+        float _originX = 0.0f;
+        float _originY = 0.0f;
+        float _stepX = 0.0f;
+        float _stepY = 0.0f;
+
     public:
         cc::middleware::IOBuffer ib;
-        cc::middleware::IOBuffer vb;
+        cc::middleware::IOBuffer vb; // PackedVertex
     };
 
     struct AnimationData {
@@ -116,14 +147,26 @@ public:
         bool isComplete() const { return _isComplete; }
         bool needUpdate(int toFrameIdx) const;
 
+        // Seconds between the baked frames, FrameTime when the first frame was baked.
+        float getFrameTime() const { return _frameTime; }
+        std::size_t getMemorySize() const { return _memorySize; }
+        // Marks the animation as used, the least recently used ones are evicted first.
+        void touch() { _lastUsed = ++UseCount; }
+        std::size_t getLastUsed() const { return _lastUsed; }
+
     private:
         // if frame is empty, it will build new one.
         FrameData *buildFrameData(std::size_t frameIdx);
 
     private:
+        static std::size_t UseCount;
+
         std::string _animationName = "";
         bool _isComplete = false;
         float _totalTime = 0.0f;
+        float _frameTime = 0.0f;
+        std::size_t _memorySize = 0;
+        std::size_t _lastUsed = 0;
         std::vector<FrameData *> _frames;
     };
 
@@ -142,9 +185,29 @@ public:
     AnimationData *getAnimationData(const std::string &animationName);
     void resetAllAnimationData();
     void resetAnimationData(const std::string &animationName);
+    const std::map<std::string, AnimationData *> &getAllAnimationData() const { return _animationCaches; }
+    // Frees the frames of the animation, it is baked again when played.
+    void evictAnimationData(AnimationData *animationData);
+
+    typedef std::function<void(const std::string &animationName)> BakeCallback;
+    // Bakes the whole animation on a worker thread instead of frame by frame as it plays, with a Skeleton
+    // and AnimationState of its own over the same SkeletonData. The frames replace the animation data on
+    // the cocos thread, which then runs the callbacks. Returns false if the animation is already complete,
+    // not found, or the cache was not initialized by uuid, the callback is not run then.
+    bool bakeAnimationDataAsync(const std::string &animationName, const BakeCallback &callback = nullptr);
+    bool isBaking(const std::string &animationName) const { return _bakeJobs.find(animationName) != _bakeJobs.end(); }
 
 private:
+    struct BakeJob {
+        SkeletonCache *baker = nullptr;
+        std::string animationName = "";
+        std::vector<BakeCallback> callbacks;
+    };
+
     void renderAnimationFrame(AnimationData *animationData);
+    // takes the frames of the finished job, on the cocos thread
+    void finishBake(BakeJob *job);
+    static void releaseBakeJob(BakeJob *job);
 
 public:
     static float FrameTime;
@@ -153,5 +216,13 @@ public:
 private:
     std::string _curAnimationName = "";
     std::map<std::string, AnimationData *> _animationCaches;
+    // the frame is baked unpacked into these first
+    cc::middleware::IOBuffer _bakeVB;
+    cc::middleware::IOBuffer _bakeIB;
+
+    std::map<std::string, BakeJob *> _bakeJobs;
+    // bakes on a worker thread for another cache, touches nothing shared
+    bool _isBaker = false;
+    std::shared_ptr<bool> _isAlive;
 };
 } // namespace spine
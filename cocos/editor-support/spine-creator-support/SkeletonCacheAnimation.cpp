@@ -45,7 +45,7 @@ static const std::string textureKey = "texture";
 
 namespace spine {
 
-SkeletonCacheAnimation::SkeletonCacheAnimation(const std::string &uuid, bool isShare) {
+SkeletonCacheAnimation::SkeletonCacheAnimation(const std::string &uuid, bool isShare) : _isAlive(std::make_shared<bool>(true)) {
     if (isShare) {
         _skeletonCache = SkeletonCacheMgr::getInstance()->buildSkeletonCache(uuid);
         _skeletonCache->retain();
@@ -70,6 +70,8 @@ SkeletonCacheAnimation::SkeletonCacheAnimation(const std::string &uuid, bool isS
 }
 
 SkeletonCacheAnimation::~SkeletonCacheAnimation() {
+    // bakes still running drop their callbacks
+    *_isAlive = false;
 
     if (_sharedBufferOffset) {
         delete _sharedBufferOffset;
@@ -101,7 +103,7 @@ void SkeletonCacheAnimation::update(float dt) {
 
     if (_isAniComplete) {
         if (_animationQueue.empty() && !_headAnimation) {
-            if (_animationData && !_animationData->isComplete()) {
+            if (_animationData && !_animationData->isComplete() && !_isWaitingForBake) {
                 _skeletonCache->updateToFrame(_animationName);
             }
             return;
@@ -124,7 +126,8 @@ void SkeletonCacheAnimation::update(float dt) {
         }
     }
 
-    if (!_animationData) return;
+    if (!_animationData || _isWaitingForBake) return;
+    _animationData->touch();
 
     if (_accTime <= 0.00001 && _playCount == 0) {
         if (_startListener) {
@@ -133,9 +136,13 @@ void SkeletonCacheAnimation::update(float dt) {
     }
 
     _accTime += dt;
-    int frameIdx = floor(_accTime / SkeletonCache::FrameTime);
+    auto frameTime = _animationData->getFrameTime() > 0.0f ? _animationData->getFrameTime() : SkeletonCache::FrameTime;
+    float frames = _accTime / frameTime;
+    int frameIdx = floor(frames);
+    _frameRatio = frames - frameIdx;
     if (!_animationData->isComplete()) {
-        _skeletonCache->updateToFrame(_animationName, frameIdx);
+        // the next frame is baked too to interpolate towards it
+        _skeletonCache->updateToFrame(_animationName, frameIdx + 1);
     }
 
     int finalFrameIndex = (int)_animationData->getFrameCount() - 1;
@@ -149,6 +156,7 @@ void SkeletonCacheAnimation::update(float dt) {
         } else {
             frameIdx = 0;
         }
+        _frameRatio = 0.0f;
         if (_endListener) {
             _endListener(_animationName);
         }
@@ -163,6 +171,11 @@ void SkeletonCacheAnimation::render(float dt) {
     if (!_animationData) return;
     SkeletonCache::FrameData *frameData = _animationData->getFrameData(_curFrameIndex);
     if (!frameData) return;
+    SkeletonCache::FrameData *nextFrameData = nullptr;
+    if (_frameRatio > 0.001f) {
+        nextFrameData = _animationData->getFrameData(_curFrameIndex + 1);
+        if (!frameData->isCompatible(nextFrameData)) nextFrameData = nullptr;
+    }
 
     auto &segments = frameData->getSegments();
     auto &colors = frameData->getColors();
@@ -199,7 +212,6 @@ void SkeletonCacheAnimation::render(float dt) {
     middleware::MeshBuffer *mb = mgr->getMeshBuffer(vertexFormat);
     middleware::IOBuffer &vb = mb->getVB();
     middleware::IOBuffer &ib = mb->getIB();
-    const auto &srcVB = frameData->vb;
     const auto &srcIB = frameData->ib;
 
     // vertex size int bytes with one color
@@ -318,14 +330,8 @@ void SkeletonCacheAnimation::render(float dt) {
         dstVertexOffset = (int)vb.getCurPos() / vbs;
         dstVertexBuffer = (float *)vb.getCurBuffer();
         dstColorBuffer = (unsigned int *)vb.getCurBuffer();
-        if (!_useTint) {
-            char *srcBuffer = (char *)srcVB.getBuffer() + srcVertexBytesOffset;
-            for (std::size_t srcBufferIdx = 0; srcBufferIdx < srcVertexBytes; srcBufferIdx += vbs2) {
-                vb.writeBytes(srcBuffer + srcBufferIdx, vbs);
-            }
-        } else {
-            vb.writeBytes((char *)srcVB.getBuffer() + srcVertexBytesOffset, vertexBytes);
-        }
+        frameData->unpackVertices(srcVertexBytesOffset / vbs2, vertexFloats / vs, nextFrameData, _frameRatio, dstVertexBuffer, vs);
+        vb.move(vertexBytes);
 
         // batch handle
         if (_batch) {
@@ -395,7 +401,16 @@ void SkeletonCacheAnimation::render(float dt) {
         for (int i = 0, n = boneCount; i < n; i++) {
             auto bone = bonesData[i];
             attachInfo->checkSpace(sizeof(cc::Mat4), true);
-            attachInfo->writeBytes((const char *)&bone->globalTransformMatrix, sizeof(cc::Mat4));
+            if (nextFrameData) {
+                cc::Mat4 boneMat = bone->globalTransformMatrix;
+                const auto &nextMat = nextFrameData->getBones()[i]->globalTransformMatrix;
+                for (auto index : {0, 1, 4, 5, 12, 13}) {
+                    boneMat.m[index] += (nextMat.m[index] - boneMat.m[index]) * _frameRatio;
+                }
+                attachInfo->writeBytes((const char *)&boneMat, sizeof(cc::Mat4));
+            } else {
+                attachInfo->writeBytes((const char *)&bone->globalTransformMatrix, sizeof(cc::Mat4));
+            }
         }
     }
 }
@@ -462,6 +477,15 @@ void SkeletonCacheAnimation::setBatchEnabled(bool enabled) {
     // _batch = enabled;
 }
 
+void SkeletonCacheAnimation::setBatchKey(uint32_t key) {
+    _batchKey = key;
+}
+
+uint32_t SkeletonCacheAnimation::getBatchKey() const {
+    // keyed like SkeletonRenderer, the vertices of the cache always have two colors
+    return _batchKey ? (_batchKey << 1) | 1 : 0;
+}
+
 void SkeletonCacheAnimation::setOpacityModifyRGB(bool value) {
     _premultipliedAlpha = value;
 }
@@ -508,6 +532,11 @@ void SkeletonCacheAnimation::setAnimation(const std::string &name, bool loop) {
     _accTime = 0.0f;
     _playCount = 0;
     _curFrameIndex = 0;
+    _frameRatio = 0.0f;
+    _isWaitingForBake = false;
+    if (_isBackgroundBake) {
+        bakeAnimationCache(name);
+    }
 }
 
 void SkeletonCacheAnimation::addAnimation(const std::string &name, bool loop, float delay) {
@@ -542,6 +571,30 @@ void SkeletonCacheAnimation::updateAllAnimationCache() {
     _skeletonCache->resetAllAnimationData();
 }
 
+void SkeletonCacheAnimation::bakeAnimationCache(const std::string &animationName) {
+    auto isAlive = _isAlive;
+    bool isBaking = _skeletonCache->bakeAnimationDataAsync(animationName, [this, isAlive](const std::string &bakedName) {
+        if (*isAlive) onAnimationCacheBaked(bakedName);
+    });
+    if (isBaking && animationName == _animationName) {
+        _isWaitingForBake = true;
+    }
+}
+
+void SkeletonCacheAnimation::setBackgroundBakeEnabled(bool enabled) {
+    _isBackgroundBake = enabled;
+}
+
+void SkeletonCacheAnimation::onAnimationCacheBaked(const std::string &animationName) {
+    if (!_isWaitingForBake || animationName != _animationName) return;
+    // playback starts over from the baked frames
+    _isWaitingForBake = false;
+    _accTime = 0.0f;
+    _playCount = 0;
+    _curFrameIndex = 0;
+    _frameRatio = 0.0f;
+}
+
 se_object_ptr SkeletonCacheAnimation::getSharedBufferOffset() const {
     if (_sharedBufferOffset) {
         return _sharedBufferOffset->getTypeArray();
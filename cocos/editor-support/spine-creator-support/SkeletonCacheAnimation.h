@@ -33,11 +33,12 @@
 #include "base/Ref.h"
 #include "middleware-adapter.h"
 #include "spine/spine.h"
+#include <memory>
 #include <queue>
 
 namespace spine {
 
-class SkeletonCacheAnimation : public cc::middleware::IMiddleware, public cc::Ref {
+class SkeletonCacheAnimation : public cc::middleware::IMiddleware, public cc::Ref, public cc::AllocatedObject<cc::PoolAllocPolicy<SkeletonCacheAnimation>> {
 public:
     SkeletonCacheAnimation(const std::string &uuid, bool isShare);
     virtual ~SkeletonCacheAnimation();
@@ -45,6 +46,7 @@ public:
     virtual void update(float dt) override;
     virtual void render(float dt) override;
     virtual uint32_t getRenderOrder() const override;
+    virtual uint32_t getBatchKey() const override;
 
     Skeleton *getSkeleton() const;
 
@@ -64,6 +66,8 @@ public:
     bool setAttachment(const std::string &slotName, const char *attachmentName);
     void setColor(float r, float g, float b, float a);
     void setBatchEnabled(bool enabled);
+    // Set by script to the same key for skeletons drawn with the same effect, 0 keeps their draws apart.
+    void setBatchKey(uint32_t key);
     void setAttachEnabled(bool enabled);
 
     void setOpacityModifyRGB(bool value);
@@ -85,6 +89,10 @@ public:
     void setCompleteListener(const CacheFrameEvent &listener);
     void updateAnimationCache(const std::string &animationName);
     void updateAllAnimationCache();
+    // Bakes the animation on a worker thread, the current animation holds still until its frames are in.
+    void bakeAnimationCache(const std::string &animationName);
+    // Animations set from now on are baked on a worker thread unless their cache is complete.
+    void setBackgroundBakeEnabled(bool enabled);
 
     void setToSetupPose();
     void setBonesToSetupPose();
@@ -102,10 +110,13 @@ public:
     se_object_ptr getParamsBuffer() const;
 
 private:
+    void onAnimationCacheBaked(const std::string &animationName);
+
     float _timeScale = 1;
     bool _paused = false;
     bool _useAttach = false;
     bool _batch = true;
+    uint32_t _batchKey = 0;
     cc::middleware::Color4F _nodeColor = cc::middleware::Color4F::WHITE;
     bool _premultipliedAlpha = false;
 
@@ -116,6 +127,8 @@ private:
     SkeletonCache *_skeletonCache = nullptr;
     SkeletonCache::AnimationData *_animationData = nullptr;
     int _curFrameIndex = -1;
+    // progress from the current frame to the next one
+    float _frameRatio = 0.0f;
 
     float _accTime = 0.0f;
     int _playCount = 0;
@@ -123,6 +136,10 @@ private:
     bool _isAniComplete = true;
     std::string _animationName = "";
     bool _useTint = true;
+    bool _isBackgroundBake = false;
+    // switches to cached playback when the background bake of the animation is done
+    bool _isWaitingForBake = false;
+    std::shared_ptr<bool> _isAlive;
 
     struct AniQueueData {
         std::string animationName = "";
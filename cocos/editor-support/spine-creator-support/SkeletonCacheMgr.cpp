@@ -28,9 +28,35 @@
  *****************************************************************************/
 
 #include "SkeletonCacheMgr.h"
+#include "base/MemoryPressure.h"
+#include "base/ThreadPool.h"
 
 namespace spine {
+namespace {
+const int BAKE_THREAD_COUNT = 2;
+} // namespace
+
 SkeletonCacheMgr *SkeletonCacheMgr::_instance = nullptr;
+
+SkeletonCacheMgr::SkeletonCacheMgr() {
+    // evicted animations are baked again when played
+    _memoryPressureHandlerID = cc::MemoryPressure::addHandler("SkeletonCacheMgr", cc::MemoryPressureLevel::LOW, [this](cc::MemoryPressureLevel level) {
+        trimTo(level == cc::MemoryPressureLevel::CRITICAL ? 0 : getMemoryUsage() / 2, nullptr);
+    });
+}
+
+SkeletonCacheMgr::~SkeletonCacheMgr() {
+    cc::MemoryPressure::removeHandler(_memoryPressureHandlerID);
+    // waits for the running bakes
+    CC_SAFE_DELETE(_bakeThreadPool);
+}
+
+cc::ThreadPool *SkeletonCacheMgr::getBakeThreadPool() {
+    if (!_bakeThreadPool) {
+        _bakeThreadPool = cc::ThreadPool::newFixedThreadPool(BAKE_THREAD_COUNT);
+    }
+    return _bakeThreadPool;
+}
 SkeletonCache *SkeletonCacheMgr::buildSkeletonCache(const std::string &uuid) {
     SkeletonCache *animation = _caches.at(uuid);
     if (!animation) {
@@ -48,4 +74,54 @@ void SkeletonCacheMgr::removeSkeletonCache(const std::string &uuid) {
         _caches.erase(it);
     }
 }
+
+void SkeletonCacheMgr::setMemoryBudget(std::size_t budget) {
+    _memoryBudget = budget;
+    trimToBudget();
+}
+
+std::size_t SkeletonCacheMgr::getMemoryUsage() const {
+    std::size_t usage = 0;
+    for (const auto &it : _caches) {
+        for (const auto &animation : it.second->getAllAnimationData()) {
+            usage += animation.second->getMemorySize();
+        }
+    }
+    return usage;
+}
+
+void SkeletonCacheMgr::setFrameRate(float frameRate) {
+    if (frameRate <= 0.0f) return;
+    SkeletonCache::FrameTime = 1.0f / frameRate;
+}
+
+float SkeletonCacheMgr::getFrameRate() const {
+    return 1.0f / SkeletonCache::FrameTime;
+}
+
+void SkeletonCacheMgr::trimToBudget(const SkeletonCache::AnimationData *inUse) {
+    if (_memoryBudget == 0) return;
+    trimTo(_memoryBudget, inUse);
+}
+
+void SkeletonCacheMgr::trimTo(std::size_t bytes, const SkeletonCache::AnimationData *inUse) {
+    auto usage = getMemoryUsage();
+    while (usage > bytes) {
+        SkeletonCache *lruCache = nullptr;
+        SkeletonCache::AnimationData *lruData = nullptr;
+        for (const auto &it : _caches) {
+            for (const auto &animation : it.second->getAllAnimationData()) {
+                auto data = animation.second;
+                if (data == inUse || data->getMemorySize() == 0) continue;
+                if (!lruData || data->getLastUsed() < lruData->getLastUsed()) {
+                    lruCache = it.second;
+                    lruData = data;
+                }
+            }
+        }
+        if (!lruData) break;
+        usage -= lruData->getMemorySize();
+        lruCache->evictAnimationData(lruData);
+    }
+}
 } // namespace spine
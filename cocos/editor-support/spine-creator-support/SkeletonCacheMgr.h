@@ -31,6 +31,10 @@
 #include "SkeletonCache.h"
 #include "base/Map.h"
 
+namespace cc {
+class ThreadPool;
+}
+
 namespace spine {
 
 class SkeletonCacheMgr {
@@ -52,9 +56,32 @@ public:
     void removeSkeletonCache(const std::string &uuid);
     SkeletonCache *buildSkeletonCache(const std::string &uuid);
 
+    // Bytes the baked animations of the shared caches may take, 0 for no limit. Beyond it the least
+    // recently played animations are evicted and baked again when played.
+    void setMemoryBudget(std::size_t budget);
+    std::size_t getMemoryBudget() const { return _memoryBudget; }
+    std::size_t getMemoryUsage() const;
+
+    // Frames per second animations are baked with from now on, playback interpolates between them.
+    void setFrameRate(float frameRate);
+    float getFrameRate() const;
+
+    // Evicts animations until the shared caches fit the budget, inUse is kept.
+    void trimToBudget(const SkeletonCache::AnimationData *inUse = nullptr);
+
+    // Worker threads SkeletonCache::bakeAnimationDataAsync bakes on.
+    cc::ThreadPool *getBakeThreadPool();
+
 private:
+    SkeletonCacheMgr();
+    ~SkeletonCacheMgr();
+    void trimTo(std::size_t bytes, const SkeletonCache::AnimationData *inUse);
+
     static SkeletonCacheMgr *_instance;
+    cc::ThreadPool *_bakeThreadPool = nullptr;
     cc::Map<std::string, SkeletonCache *> _caches;
+    std::size_t _memoryBudget = 0;
+    uint32_t _memoryPressureHandlerID = 0;
 };
 
 } // namespace spine
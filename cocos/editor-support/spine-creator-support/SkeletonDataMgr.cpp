@@ -28,7 +28,11 @@
  *****************************************************************************/
 
 #include "SkeletonDataMgr.h"
+#include "SkeletonBinaryWriter.h"
+#include "base/Log.h"
+#include "platform/FileUtils.h"
 #include <algorithm>
+#include <cstring>
 #include <vector>
 
 using namespace spine;
@@ -64,6 +68,28 @@ public:
 
 } // namespace spine
 
+namespace {
+const char CACHE_MAGIC[] = {'S', 'K', 'C', '1'};
+const size_t CACHE_HEADER_SIZE = sizeof(CACHE_MAGIC) + sizeof(uint64_t);
+
+// FNV-1a of the texts the cache was written from
+uint64_t hashText(const std::string &text, uint64_t hash = 14695981039346656037ULL) {
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+std::string getCachePath(const std::string &uuid) {
+    std::string name = uuid;
+    for (auto &c : name) {
+        if (!isalnum((unsigned char)c) && c != '-') c = '_';
+    }
+    return cc::FileUtils::getInstance()->getWritablePath() + "spine-cache/" + name + ".bin";
+}
+} // namespace
+
 SkeletonDataMgr *SkeletonDataMgr::_instance = nullptr;
 
 bool SkeletonDataMgr::hasSkeletonData(const std::string &uuid) {
@@ -111,3 +137,59 @@ void SkeletonDataMgr::releaseByUUID(const std::string &uuid) {
     }
     info->release();
 }
+
+SkeletonData *SkeletonDataMgr::readJsonSkeletonData(const std::string &uuid, const std::string &json, const std::string &atlasText,
+                                                    AttachmentLoader *attachmentLoader, float scale, std::string &error) {
+    if (!_isBinaryCacheEnabled || uuid.empty()) {
+        SkeletonJson reader(attachmentLoader);
+        reader.setScale(scale);
+        SkeletonData *data = reader.readSkeletonData(json.c_str());
+        if (!data) error = reader.getError().buffer();
+        return data;
+    }
+
+    auto fileUtils = cc::FileUtils::getInstance();
+    const auto cachePath = getCachePath(uuid);
+    const uint64_t hash = hashText(atlasText, hashText(json));
+    if (fileUtils->isFileExist(cachePath)) {
+        cc::MappedFile cache = fileUtils->mapFile(cachePath);
+        const unsigned char *bytes = cache.getBytes();
+        uint64_t cacheHash = 0;
+        if (cache.getSize() > (ssize_t)CACHE_HEADER_SIZE && memcmp(bytes, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0) {
+            memcpy(&cacheHash, bytes + sizeof(CACHE_MAGIC), sizeof(cacheHash));
+        }
+        if (cacheHash == hash) {
+            SkeletonBinary reader(attachmentLoader);
+            reader.setScale(scale);
+            SkeletonData *data = reader.readSkeletonData(bytes + CACHE_HEADER_SIZE, (int)(cache.getSize() - CACHE_HEADER_SIZE));
+            if (data) return data;
+            CC_LOG_WARNING("SkeletonDataMgr: binary cache of %s is unreadable, %s", uuid.c_str(), reader.getError().buffer());
+        }
+    }
+
+    SkeletonJson reader(attachmentLoader);
+    reader.setScale(scale);
+    SkeletonData *data = reader.readSkeletonData(json.c_str());
+    if (!data) {
+        error = reader.getError().buffer();
+        return nullptr;
+    }
+
+    // the JSON is parsed once more by the writer, the later loads save both parses
+    std::vector<unsigned char> bytes(CACHE_HEADER_SIZE);
+    memcpy(bytes.data(), CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    memcpy(bytes.data() + sizeof(CACHE_MAGIC), &hash, sizeof(hash));
+    SkeletonBinaryWriter writer;
+    std::vector<unsigned char> body;
+    if (writer.write(json.c_str(), data, body)) {
+        bytes.insert(bytes.end(), body.begin(), body.end());
+        const auto cacheDir = cachePath.substr(0, cachePath.find_last_of('/') + 1);
+        cc::Data cacheData;
+        cacheData.copy(bytes.data(), (ssize_t)bytes.size());
+        if (!fileUtils->isDirectoryExist(cacheDir)) fileUtils->createDirectory(cacheDir);
+        fileUtils->writeDataToFile(cacheData, cachePath);
+    } else if (fileUtils->isFileExist(cachePath)) {
+        fileUtils->removeFile(cachePath);
+    }
+    return data;
+}
@@ -70,6 +70,16 @@ public:
     SkeletonData *retainByUUID(const std::string &uuid);
     void releaseByUUID(const std::string &uuid);
 
+    /**
+     * Reads JSON skeleton data, through a binary cache in the writable path when it is enabled. The cache
+     * of a uuid is written on the first read and used while the JSON and atlas text are unchanged, which
+     * skips parsing the JSON. Returns nullptr with the error of the JSON reader on failure.
+     */
+    SkeletonData *readJsonSkeletonData(const std::string &uuid, const std::string &json, const std::string &atlasText,
+                                       AttachmentLoader *attachmentLoader, float scale, std::string &error);
+    void setBinaryCacheEnabled(bool enabled) { _isBinaryCacheEnabled = enabled; }
+    bool isBinaryCacheEnabled() const { return _isBinaryCacheEnabled; }
+
     typedef std::function<void(int)> destroyCallback;
     void setDestroyCallback(destroyCallback callback) {
         _destroyCallback = callback;
@@ -79,6 +89,7 @@ private:
     static SkeletonDataMgr *_instance;
     destroyCallback _destroyCallback = nullptr;
     std::map<std::string, SkeletonDataInfo *> _dataMap;
+    bool _isBinaryCacheEnabled = true;
 };
 
 } // namespace spine
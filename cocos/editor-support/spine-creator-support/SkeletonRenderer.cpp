@@ -38,6 +38,7 @@
 #include "core/gfx/GFXDef.h"
 #include "spine-creator-support/AttachmentVertices.h"
 #include "spine-creator-support/spine-cocos2dx.h"
+#include "spine/SimdUtil.h"
 #include <algorithm>
 
 USING_NS_MW;
@@ -165,6 +166,11 @@ SkeletonRenderer::~SkeletonRenderer() {
         _debugBuffer = nullptr;
     }
 
+    if (_renderData) {
+        delete _renderData;
+        _renderData = nullptr;
+    }
+
     if (_sharedBufferOffset) {
         delete _sharedBufferOffset;
         _sharedBufferOffset = nullptr;
@@ -292,6 +298,36 @@ void SkeletonRenderer::render(float deltaTime) {
     // store attach info offset
     _sharedBufferOffset->writeUint32((uint32_t)attachInfo->getCurPos() / sizeof(uint32_t));
 
+    middleware::MeshBuffer *mb = mgr->getMeshBuffer(_useTint ? VF_XYZUVCC : VF_XYZUVC);
+    renderInto(mb->getVB(), mb->getIB(), renderInfo, attachInfo, mb);
+}
+
+bool SkeletonRenderer::isParallelRender() const {
+    // the debug buffer is created in script, a vertex effect may be shared with other skeletons
+    return !_debugSlots && !_debugBones && !_debugMesh && !_effectDelegate;
+}
+
+ParallelRenderData *SkeletonRenderer::renderParallel(float deltaTime) {
+    if (!_skeleton) return nullptr;
+
+    _sharedBufferOffset->reset();
+    _sharedBufferOffset->clear();
+
+    if (!_renderData) {
+        _renderData = new ParallelRenderData();
+    }
+    _renderData->vertexFormat = _useTint ? VF_XYZUVCC : VF_XYZUVC;
+    _renderData->sharedBufferOffset = _sharedBufferOffset;
+    _renderData->vb.reset();
+    _renderData->ib.reset();
+    _renderData->renderInfo.reset();
+    _renderData->attachInfo.reset();
+    renderInto(_renderData->vb, _renderData->ib, &_renderData->renderInfo, &_renderData->attachInfo, nullptr);
+    return _renderData;
+}
+
+// Without a mesh buffer the vertices go into vb and ib of the renderer, from buffer position 0 on.
+void SkeletonRenderer::renderInto(IOBuffer &vb, IOBuffer &ib, IOBuffer *renderInfo, IOBuffer *attachInfo, middleware::MeshBuffer *mb) {
     // check enough space
     renderInfo->checkSpace(sizeof(uint32_t) * 2, true);
     // write border
@@ -301,20 +337,15 @@ void SkeletonRenderer::render(float deltaTime) {
     //reserved space to save material len
     renderInfo->writeUint32(0);
 
-    // If opacity is 0,then return.
-    if (_skeleton->getColor().a == 0) {
+    // If opacity is 0 or the skeleton is culled,then return.
+    if (_skeleton->getColor().a == 0 || isCulled()) {
         return;
     }
 
     // color range is [0.0, 1.0]
     Color4F color;
-    Color4F darkColor;
     AttachmentVertices *attachmentVertices = nullptr;
     bool inRange = _startSlotIndex != -1 || _endSlotIndex != -1 ? false : true;
-    auto vertexFormat = _useTint ? VF_XYZUVCC : VF_XYZUVC;
-    middleware::MeshBuffer *mb = mgr->getMeshBuffer(vertexFormat);
-    middleware::IOBuffer &vb = mb->getVB();
-    middleware::IOBuffer &ib = mb->getIB();
 
     // vertex size int bytes with one color
     int vbs1 = sizeof(V2F_T2F_C4F);
@@ -394,7 +425,7 @@ void SkeletonRenderer::render(float deltaTime) {
         renderInfo->writeUint32(curBlendSrc);
         renderInfo->writeUint32(curBlendDst);
         // fill new index and vertex buffer id
-        auto bufferIndex = mb->getBufferPos();
+        auto bufferIndex = mb ? mb->getBufferPos() : 0;
         renderInfo->writeUint32(bufferIndex);
 
         // fill new index offset
@@ -594,31 +625,28 @@ void SkeletonRenderer::render(float deltaTime) {
             continue;
         }
 
-        float multiplier = _premultipliedAlpha ? color.a : 255;
-        float red = _nodeColor.r * _skeleton->getColor().r * color.r * multiplier;
-        float green = _nodeColor.g * _skeleton->getColor().g * color.g * multiplier;
-        float blue = _nodeColor.b * _skeleton->getColor().b * color.b * multiplier;
-
-        color.r = red * slot->getColor().r;
-        color.g = green * slot->getColor().g;
-        color.b = blue * slot->getColor().b;
-
+        // node, skeleton and attachment rgb, premultiplied and normalized, tints the slot light and dark colors
+        const Color &skeletonColor = _skeleton->getColor();
+        const Color &slotColor = slot->getColor();
+        const Color &slotDarkColor = slot->getDarkColor();
+        float multiplier = (_premultipliedAlpha ? color.a : 255) / 255.0f;
+        simd::F4 tint = simd::mul(simd::mul(simd::set(_nodeColor.r, _nodeColor.g, _nodeColor.b, 0), simd::set(skeletonColor.r, skeletonColor.g, skeletonColor.b, 0)),
+                                  simd::mul(simd::set(color.r, color.g, color.b, 0), simd::set(multiplier)));
+        Color light;
+        Color dark;
+        simd::store(&light.r, simd::mulAdd(simd::set(0, 0, 0, color.a / 255.0f), tint, simd::set(slotColor.r, slotColor.g, slotColor.b, 0)));
         if (slot->hasDarkColor()) {
-            darkColor.r = red * slot->getDarkColor().r;
-            darkColor.g = green * slot->getDarkColor().g;
-            darkColor.b = blue * slot->getDarkColor().b;
+            simd::store(&dark.r, simd::mul(tint, simd::set(slotDarkColor.r, slotDarkColor.g, slotDarkColor.b, 0)));
         } else {
-            darkColor.r = 0;
-            darkColor.g = 0;
-            darkColor.b = 0;
+            dark.r = dark.g = dark.b = 0;
         }
-        darkColor.a = _premultipliedAlpha ? 255 : 0;
+        dark.a = _premultipliedAlpha ? 1 : 0;
 
         // One color tint logic
         if (!_useTint) {
             // Cliping logic
             if (_clipper->isClipping()) {
-                _clipper->clipTriangles((float *)&triangles.verts[0].vertex, triangles.indices, triangles.indexCount, (float *)&triangles.verts[0].texCoord, vs1);
+                _clipper->clipTriangles(slot, (float *)&triangles.verts[0].vertex, triangles.indices, triangles.indexCount, (float *)&triangles.verts[0].texCoord, vs1);
 
                 if (_clipper->getClippedTriangles().size() == 0) {
                     _clipper->clipEnd(*slot);
@@ -639,15 +667,9 @@ void SkeletonRenderer::render(float deltaTime) {
                 float *verts = _clipper->getClippedVertices().buffer();
                 float *uvs = _clipper->getClippedUVs().buffer();
 
-                Color light;
-                Color dark;
-                light.r = color.r / 255.0f;
-                light.g = color.g / 255.0f;
-                light.b = color.b / 255.0f;
-                light.a = color.a / 255.0f;
-                dark.r = dark.g = dark.b = dark.a = 0;
-
                 if (effect) {
+                    Color dark;
+                    dark.r = dark.g = dark.b = dark.a = 0;
                     for (int v = 0, vn = triangles.vertCount, vv = 0; v < vn; ++v, vv += 2) {
                         V2F_T2F_C4F *vertex = triangles.verts + v;
                         Color lightCopy = light;
@@ -669,21 +691,11 @@ void SkeletonRenderer::render(float deltaTime) {
                         vertex->vertex.y = verts[vv + 1];
                         vertex->texCoord.u = uvs[vv];
                         vertex->texCoord.v = uvs[vv + 1];
-                        vertex->color.r = light.r;
-                        vertex->color.g = light.g;
-                        vertex->color.b = light.b;
-                        vertex->color.a = light.a;
                     }
+                    simd::fillColor(&triangles.verts[0].color.r, vs1, triangles.vertCount, &light.r);
                 }
                 // No cliping logic
             } else {
-
-                Color light;
-                light.r = color.r / 255.0f;
-                light.g = color.g / 255.0f;
-                light.b = color.b / 255.0f;
-                light.a = color.a / 255.0f;
-
                 if (effect) {
                     Color dark;
                     dark.r = dark.g = dark.b = dark.a = 0;
@@ -698,20 +710,14 @@ void SkeletonRenderer::render(float deltaTime) {
                         vertex->color.a = lightCopy.a;
                     }
                 } else {
-                    for (int v = 0, vn = triangles.vertCount; v < vn; ++v) {
-                        V2F_T2F_C4F *vertex = triangles.verts + v;
-                        vertex->color.r = light.r;
-                        vertex->color.g = light.g;
-                        vertex->color.b = light.b;
-                        vertex->color.a = light.a;
-                    }
+                    simd::fillColor(&triangles.verts[0].color.r, vs1, triangles.vertCount, &light.r);
                 }
             }
         }
         // Two color tint logic
         else {
             if (_clipper->isClipping()) {
-                _clipper->clipTriangles((float *)&trianglesTwoColor.verts[0].vertex, trianglesTwoColor.indices, trianglesTwoColor.indexCount, (float *)&trianglesTwoColor.verts[0].texCoord, vs2);
+                _clipper->clipTriangles(slot, (float *)&trianglesTwoColor.verts[0].vertex, trianglesTwoColor.indices, trianglesTwoColor.indexCount, (float *)&trianglesTwoColor.verts[0].texCoord, vs2);
 
                 if (_clipper->getClippedTriangles().size() == 0) {
                     _clipper->clipEnd(*slot);
@@ -731,17 +737,6 @@ void SkeletonRenderer::render(float deltaTime) {
                 float *verts = _clipper->getClippedVertices().buffer();
                 float *uvs = _clipper->getClippedUVs().buffer();
 
-                Color light;
-                Color dark;
-                light.r = color.r / 255.0f;
-                light.g = color.g / 255.0f;
-                light.b = color.b / 255.0f;
-                light.a = color.a / 255.0f;
-                dark.r = darkColor.r / 255.0f;
-                dark.g = darkColor.g / 255.0f;
-                dark.b = darkColor.b / 255.0f;
-                dark.a = darkColor.a / 255.0f;
-
                 if (effect) {
                     for (int v = 0, vn = trianglesTwoColor.vertCount, vv = 0; v < vn; ++v, vv += 2) {
                         V2F_T2F_C4F_C4F *vertex = trianglesTwoColor.verts + v;
@@ -768,29 +763,10 @@ void SkeletonRenderer::render(float deltaTime) {
                         vertex->vertex.y = verts[vv + 1];
                         vertex->texCoord.u = uvs[vv];
                         vertex->texCoord.v = uvs[vv + 1];
-                        vertex->color.r = light.r;
-                        vertex->color.g = light.g;
-                        vertex->color.b = light.b;
-                        vertex->color.a = light.a;
-                        vertex->color2.r = dark.r;
-                        vertex->color2.g = dark.g;
-                        vertex->color2.b = dark.b;
-                        vertex->color2.a = dark.a;
                     }
+                    simd::fillTwoColor(&trianglesTwoColor.verts[0].color.r, vs2, trianglesTwoColor.vertCount, &light.r, &dark.r);
                 }
             } else {
-
-                Color light;
-                Color dark;
-                light.r = color.r / 255.0f;
-                light.g = color.g / 255.0f;
-                light.b = color.b / 255.0f;
-                light.a = color.a / 255.0f;
-                dark.r = darkColor.r / 255.0f;
-                dark.g = darkColor.g / 255.0f;
-                dark.b = darkColor.b / 255.0f;
-                dark.a = darkColor.a / 255.0f;
-
                 if (effect) {
                     for (int v = 0, vn = trianglesTwoColor.vertCount; v < vn; ++v) {
                         V2F_T2F_C4F_C4F *vertex = trianglesTwoColor.verts + v;
@@ -807,17 +783,7 @@ void SkeletonRenderer::render(float deltaTime) {
                         vertex->color2.a = dark.a;
                     }
                 } else {
-                    for (int v = 0, vn = trianglesTwoColor.vertCount; v < vn; ++v) {
-                        V2F_T2F_C4F_C4F *vertex = trianglesTwoColor.verts + v;
-                        vertex->color.r = light.r;
-                        vertex->color.g = light.g;
-                        vertex->color.b = light.b;
-                        vertex->color.a = light.a;
-                        vertex->color2.r = dark.r;
-                        vertex->color2.g = dark.g;
-                        vertex->color2.b = dark.b;
-                        vertex->color2.a = dark.a;
-                    }
+                    simd::fillTwoColor(&trianglesTwoColor.verts[0].color.r, vs2, trianglesTwoColor.vertCount, &light.r, &dark.r);
                 }
             }
         }
@@ -832,15 +798,13 @@ void SkeletonRenderer::render(float deltaTime) {
 
         if (vbSize > 0 && ibSize > 0) {
             if (_batch) {
-                uint8_t *vbBuffer = vb.getCurBuffer();
-                cc::Vec3 *point = nullptr;
-                for (int ii = 0, nn = vbSize; ii < nn; ii += vbs) {
-                    point = (cc::Vec3 *)(vbBuffer + ii);
-                    // force z value to zero
-                    point->z = 0;
-                    point->x = point->x * nodeWorldMat.m[0] + point->y * nodeWorldMat.m[4] + nodeWorldMat.m[12]; // x
-                    point->y = point->y * nodeWorldMat.m[1] + point->y * nodeWorldMat.m[5] + nodeWorldMat.m[13]; // y
-                }
+                float *points = (float *)vb.getCurBuffer();
+                int stride = vbs / sizeof(float);
+                int pointCount = vbSize / vbs;
+                const float *m = nodeWorldMat.m;
+                simd::transformPoints(points, stride, points, stride, pointCount, m[0], m[4], m[1], m[5], m[12], m[13]);
+                // force z value to zero
+                for (int ii = 0; ii < pointCount; ii++) points[ii * stride + 2] = 0;
             }
 
             if (vertexOffset > 0) {
@@ -978,14 +942,14 @@ void SkeletonRenderer::setSlotsToSetupPose() {
 
 Bone *SkeletonRenderer::findBone(const std::string &boneName) const {
     if (_skeleton) {
-        return _skeleton->findBone(boneName.c_str());
+        return _skeleton->findBone(NameRef(boneName));
     }
     return nullptr;
 }
 
 Slot *SkeletonRenderer::findSlot(const std::string &slotName) const {
     if (_skeleton) {
-        return _skeleton->findSlot(slotName.c_str());
+        return _skeleton->findSlot(NameRef(slotName));
     }
     return nullptr;
 }
@@ -1071,6 +1035,16 @@ void SkeletonRenderer::setBatchEnabled(bool enabled) {
     // _batch = enabled;
 }
 
+void SkeletonRenderer::setBatchKey(uint32_t key) {
+    _batchKey = key;
+}
+
+uint32_t SkeletonRenderer::getBatchKey() const {
+    // the debug draws of script go between the skeletons, the vertex format is part of the key
+    if (!_batchKey || _debugSlots || _debugBones || _debugMesh) return 0;
+    return (_batchKey << 1) | (_useTint ? 1 : 0);
+}
+
 void SkeletonRenderer::setDebugBonesEnabled(bool enabled) {
     _debugBones = enabled;
 }
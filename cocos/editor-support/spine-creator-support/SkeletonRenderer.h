@@ -46,7 +46,7 @@ class AttachmentVertices;
 
 /** Draws a skeleton.
      */
-class SkeletonRenderer : public cc::middleware::IMiddleware, public cc::Ref {
+class SkeletonRenderer : public cc::middleware::IMiddleware, public cc::Ref, public cc::AllocatedObject<cc::PoolAllocPolicy<SkeletonRenderer>> {
 public:
     static SkeletonRenderer *create();
     static SkeletonRenderer *createWithSkeleton(Skeleton *skeleton, bool ownsSkeleton = false, bool ownsSkeletonData = false);
@@ -55,8 +55,11 @@ public:
 
     virtual void update(float deltaTime) override {}
     virtual void render(float deltaTime) override;
+    virtual bool isParallelRender() const override;
+    virtual cc::middleware::ParallelRenderData *renderParallel(float deltaTime) override;
     virtual cc::Rect getBoundingBox() const;
     virtual uint32_t getRenderOrder() const override;
+    virtual uint32_t getBatchKey() const override;
 
     Skeleton *getSkeleton() const;
 
@@ -116,6 +119,8 @@ public:
 
     void setColor(float r, float g, float b, float a);
     void setBatchEnabled(bool enabled);
+    // Set by script to the same key for skeletons drawn with the same effect, 0 keeps their draws apart.
+    void setBatchKey(uint32_t key);
     void setDebugBonesEnabled(bool enabled);
     void setDebugSlotsEnabled(bool enabled);
     void setDebugMeshEnabled(bool enabled);
@@ -148,6 +153,7 @@ public:
 
 protected:
     void setSkeletonData(SkeletonData *skeletonData, bool ownsSkeletonData);
+    void renderInto(cc::middleware::IOBuffer &vb, cc::middleware::IOBuffer &ib, cc::middleware::IOBuffer *renderInfo, cc::middleware::IOBuffer *attachInfo, cc::middleware::MeshBuffer *mb);
 
     bool _ownsSkeletonData = false;
     bool _ownsSkeleton = false;
@@ -160,6 +166,7 @@ protected:
     bool _paused = false;
 
     bool _batch = true;
+    uint32_t _batchKey = 0;
     bool _useAttach = false;
     bool _debugMesh = false;
     bool _debugSlots = false;
@@ -175,6 +182,7 @@ protected:
 
     cc::middleware::IOTypedArray *_sharedBufferOffset = nullptr;
     cc::middleware::IOTypedArray *_debugBuffer = nullptr;
+    cc::middleware::ParallelRenderData *_renderData = nullptr;
     // Js fill this buffer to send parameter to cpp, avoid to call jsb function.
     cc::middleware::IOTypedArray *_paramsBuffer = nullptr;
 };
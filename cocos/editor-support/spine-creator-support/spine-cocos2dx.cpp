@@ -29,6 +29,7 @@
 
 #include "spine-creator-support/spine-cocos2dx.h"
 #include "base/Data.h"
+#include "base/memory/PoolAlloc.h"
 #include "middleware-adapter.h"
 #include "platform/FileUtils.h"
 #include "spine-creator-support/AttachmentVertices.h"
@@ -133,12 +134,14 @@ Cocos2dExtension::~Cocos2dExtension() {}
 
 char *Cocos2dExtension::_readFile(const spine::String &path, int *length) {
     *length = 0;
-    Data data = FileUtils::getInstance()->getDataFromFile(FileUtils::getInstance()->fullPathForFilename(path.buffer()));
-    if (data.isNull()) return 0;
-
-    char *ret = (char *)malloc(sizeof(unsigned char) * data.getSize());
-    memcpy(ret, (char *)data.getBytes(), data.getSize());
-    *length = (int)data.getSize();
+    // spine frees the returned buffer, so the mapped file is copied once into it
+    MappedFile file = FileUtils::getInstance()->mapFile(FileUtils::getInstance()->fullPathForFilename(path.buffer()));
+    if (file.isNull()) return 0;
+
+    char *ret = (char *)_alloc(sizeof(unsigned char) * file.getSize(), __FILE__, __LINE__);
+    if (!ret) return 0;
+    memcpy(ret, (const char *)file.getBytes(), file.getSize());
+    *length = (int)file.getSize();
     return ret;
 }
 
@@ -146,7 +149,24 @@ SpineExtension *spine::getDefaultExtension() {
     return new Cocos2dExtension();
 }
 
+void *Cocos2dExtension::_alloc(size_t size, const char *file, int line) {
+    if (size == 0) return 0;
+    return ObjectPool::allocate(size);
+}
+
+void *Cocos2dExtension::_calloc(size_t size, const char *file, int line) {
+    if (size == 0) return 0;
+    void *ptr = ObjectPool::allocate(size);
+    if (ptr) memset(ptr, 0, size);
+    return ptr;
+}
+
+void *Cocos2dExtension::_realloc(void *ptr, size_t size, const char *file, int line) {
+    if (size == 0) return 0;
+    return ObjectPool::reallocate(ptr, size);
+}
+
 void Cocos2dExtension::_free(void *mem, const char *file, int line) {
     _spineObjectDisposeCallback(mem);
-    DefaultSpineExtension::_free(mem, file, line);
+    ObjectPool::deallocate(mem);
 }
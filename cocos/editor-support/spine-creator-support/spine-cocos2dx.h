@@ -66,12 +66,30 @@ public:
 
     virtual ~Cocos2dExtension();
 
+    // spine objects, vectors and strings are allocated from the size-class pools of cc::ObjectPool
+    virtual void *_alloc(size_t size, const char *file, int line);
+
+    virtual void *_calloc(size_t size, const char *file, int line);
+
+    virtual void *_realloc(void *ptr, size_t size, const char *file, int line);
+
     virtual void _free(void *mem, const char *file, int line);
 
 protected:
     virtual char *_readFile(const String &path, int *length);
 };
 
+// A String over the chars of a name, lookups by name from script don't copy it.
+class NameRef {
+public:
+    explicit NameRef(const std::string &name) : _string(name.c_str(), true) {}
+    ~NameRef() { _string.unown(); }
+    operator const String &() const { return _string; }
+
+private:
+    String _string;
+};
+
 typedef void (*SpineObjectDisposeCallback)(void *);
 void setSpineObjectDisposeCallback(SpineObjectDisposeCallback callback);
 } // namespace spine
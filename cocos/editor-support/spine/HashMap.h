@@ -85,17 +85,24 @@ public:
 
 	HashMap() :
 			_head(NULL),
+			_freeEntries(NULL),
 			_size(0) {
 	}
 
 	~HashMap() {
 		clear();
+		for (Entry *entry = _freeEntries; entry != NULL;) {
+			Entry* next = entry->next;
+			delete entry;
+			entry = next;
+		}
 	}
 
+	/// Keeps the entries for later puts, maps cleared every update don't allocate.
 	void clear() {
 		for (Entry *entry = _head; entry != NULL;) {
 			Entry* next = entry->next;
-			delete entry;
+			releaseEntry(entry);
 			entry = next;
 		}
 		_head = NULL;
@@ -112,7 +119,7 @@ public:
 			entry->_key = key;
 			entry->_value = value;
 		} else {
-			entry = new(__FILE__, __LINE__) Entry();
+			entry = obtainEntry();
 			entry->_key = key;
 			entry->_value = value;
 
@@ -144,7 +151,7 @@ public:
 		else _head = next;
 		if (next) next->prev = entry->prev;
 
-		delete entry;
+		releaseEntry(entry);
 		_size--;
 
 		return true;
@@ -172,6 +179,22 @@ private:
 		return NULL;
 	}
 
+	Entry *obtainEntry() {
+		if (!_freeEntries) return new(__FILE__, __LINE__) Entry();
+		Entry *entry = _freeEntries;
+		_freeEntries = entry->next;
+		entry->next = NULL;
+		return entry;
+	}
+
+	void releaseEntry(Entry *entry) {
+		entry->_key = K();
+		entry->_value = V();
+		entry->prev = NULL;
+		entry->next = _freeEntries;
+		_freeEntries = entry;
+	}
+
 	class SP_API Entry : public SpineObject {
 	public:
 		K _key;
@@ -183,6 +206,7 @@ private:
 	};
 
 	Entry *_head;
+	Entry *_freeEntries;
 	size_t _size;
 };
 }
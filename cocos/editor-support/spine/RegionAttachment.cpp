@@ -34,6 +34,7 @@
 #include <spine/RegionAttachment.h>
 
 #include <spine/Bone.h>
+#include <spine/SimdUtil.h>
 
 #include <assert.h>
 
@@ -131,32 +132,15 @@ void RegionAttachment::computeWorldVertices(Bone &bone, Vector<float> &worldVert
 }
 
 void RegionAttachment::computeWorldVertices(Bone &bone, float* worldVertices, size_t offset, size_t stride) {
-	float x = bone.getWorldX(), y = bone.getWorldY();
 	float a = bone.getA(), b = bone.getB(), c = bone.getC(), d = bone.getD();
-	float offsetX, offsetY;
-
-	offsetX = _vertexOffset[BRX];
-	offsetY = _vertexOffset[BRY];
-	worldVertices[offset] = offsetX * a + offsetY * b + x; // br
-	worldVertices[offset + 1] = offsetX * c + offsetY * d + y;
-	offset += stride;
-
-	offsetX = _vertexOffset[BLX];
-	offsetY = _vertexOffset[BLY];
-	worldVertices[offset] = offsetX * a + offsetY * b + x; // bl
-	worldVertices[offset + 1] = offsetX * c + offsetY * d + y;
-	offset += stride;
-
-	offsetX = _vertexOffset[ULX];
-	offsetY = _vertexOffset[ULY];
-	worldVertices[offset] = offsetX * a + offsetY * b + x; // ul
-	worldVertices[offset + 1] = offsetX * c + offsetY * d + y;
-	offset += stride;
-
-	offsetX = _vertexOffset[URX];
-	offsetY = _vertexOffset[URY];
-	worldVertices[offset] = offsetX * a + offsetY * b + x; // ur
-	worldVertices[offset + 1] = offsetX * c + offsetY * d + y;
+	simd::F4 ad = simd::set(a, d, a, d), bc = simd::set(b, c, b, c);
+	simd::F4 t = simd::set(bone.getWorldX(), bone.getWorldY(), bone.getWorldX(), bone.getWorldY());
+	float *br = worldVertices + offset, *bl = br + stride, *ul = bl + stride, *ur = ul + stride;
+
+	simd::F4 v = simd::load(&_vertexOffset[BLX]); // bl, ul
+	simd::storePairs(bl, ul, simd::mulAdd(simd::mulAdd(t, v, ad), simd::swapPairs(v), bc));
+	v = simd::load(&_vertexOffset[URX]); // ur, br
+	simd::storePairs(ur, br, simd::mulAdd(simd::mulAdd(t, v, ad), simd::swapPairs(v), bc));
 }
 
 float RegionAttachment::getX() {
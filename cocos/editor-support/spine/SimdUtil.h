@@ -0,0 +1,146 @@
+/******************************************************************************
+ * Spine Runtimes License Agreement
+ * Last updated January 1, 2020. Replaces all prior versions.
+ *
+ * Copyright (c) 2013-2020, Esoteric Software LLC
+ *
+ * Integration of the Spine Runtimes into software or otherwise creating
+ * derivative works of the Spine Runtimes is permitted under the terms and
+ * conditions of Section 2 of the Spine Editor License Agreement:
+ * http://esotericsoftware.com/spine-editor-license
+ *
+ * Otherwise, it is permitted to integrate the Spine Runtimes into software
+ * or otherwise create derivative works of the Spine Runtimes (collectively,
+ * "Products"), provided that each user of the Products must obtain their own
+ * Spine Editor license and redistribution of the Products in any form must
+ * include this license and copyright notice.
+ *
+ * THE SPINE RUNTIMES ARE PROVIDED BY ESOTERIC SOFTWARE LLC "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES,
+ * BUSINESS INTERRUPTION, OR LOSS OF USE, DATA, OR PROFITS) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THE SPINE RUNTIMES, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef Spine_SimdUtil_h
+#define Spine_SimdUtil_h
+
+#include <stddef.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SPINE_USE_NEON
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#define SPINE_USE_SSE
+#endif
+
+namespace spine {
+/// Vertex kernels of the attachments and the renderer, processing two vertices or one color per
+/// operation where SSE or NEON is available. Points are x, y pairs, strides are in floats and
+/// unaligned data is fine.
+namespace simd {
+
+#if defined(SPINE_USE_NEON)
+typedef float32x4_t F4;
+inline F4 load(const float *p) { return vld1q_f32(p); }
+inline void store(float *p, F4 v) { vst1q_f32(p, v); }
+inline F4 set(float v) { return vdupq_n_f32(v); }
+inline F4 set(float x, float y, float z, float w) {
+	const float v[4] = {x, y, z, w};
+	return vld1q_f32(v);
+}
+inline F4 add(F4 a, F4 b) { return vaddq_f32(a, b); }
+inline F4 mul(F4 a, F4 b) { return vmulq_f32(a, b); }
+inline F4 mulAdd(F4 a, F4 b, F4 c) { return vmlaq_f32(a, b, c); } // a + b * c
+inline F4 loadPairs(const float *p0, const float *p1) { return vcombine_f32(vld1_f32(p0), vld1_f32(p1)); }
+inline void storePairs(float *p0, float *p1, F4 v) {
+	vst1_f32(p0, vget_low_f32(v));
+	vst1_f32(p1, vget_high_f32(v));
+}
+inline F4 swapPairs(F4 v) { return vrev64q_f32(v); } // y, x, w, z
+#elif defined(SPINE_USE_SSE)
+typedef __m128 F4;
+inline F4 load(const float *p) { return _mm_loadu_ps(p); }
+inline void store(float *p, F4 v) { _mm_storeu_ps(p, v); }
+inline F4 set(float v) { return _mm_set1_ps(v); }
+inline F4 set(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+inline F4 add(F4 a, F4 b) { return _mm_add_ps(a, b); }
+inline F4 mul(F4 a, F4 b) { return _mm_mul_ps(a, b); }
+inline F4 mulAdd(F4 a, F4 b, F4 c) { return _mm_add_ps(a, _mm_mul_ps(b, c)); }
+inline F4 loadPairs(const float *p0, const float *p1) {
+	return _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)p0), (const __m64 *)p1);
+}
+inline void storePairs(float *p0, float *p1, F4 v) {
+	_mm_storel_pi((__m64 *)p0, v);
+	_mm_storeh_pi((__m64 *)p1, v);
+}
+inline F4 swapPairs(F4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)); }
+#else
+struct F4 {
+	float v[4];
+};
+inline F4 load(const float *p) { return {{p[0], p[1], p[2], p[3]}}; }
+inline void store(float *p, const F4 &a) {
+	p[0] = a.v[0];
+	p[1] = a.v[1];
+	p[2] = a.v[2];
+	p[3] = a.v[3];
+}
+inline F4 set(float v) { return {{v, v, v, v}}; }
+inline F4 set(float x, float y, float z, float w) { return {{x, y, z, w}}; }
+inline F4 add(const F4 &a, const F4 &b) { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+inline F4 mul(const F4 &a, const F4 &b) { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+inline F4 mulAdd(const F4 &a, const F4 &b, const F4 &c) { return add(a, mul(b, c)); }
+inline F4 loadPairs(const float *p0, const float *p1) { return {{p0[0], p0[1], p1[0], p1[1]}}; }
+inline void storePairs(float *p0, float *p1, const F4 &a) {
+	p0[0] = a.v[0];
+	p0[1] = a.v[1];
+	p1[0] = a.v[2];
+	p1[1] = a.v[3];
+}
+inline F4 swapPairs(const F4 &a) { return {{a.v[1], a.v[0], a.v[3], a.v[2]}}; }
+#endif
+
+/// out = (a * x + b * y + tx, c * x + d * y + ty) for count points. Every point is read before it is
+/// written, in and out may be the same.
+inline void transformPoints(const float *in, size_t inStride, float *out, size_t outStride, size_t count,
+	float a, float b, float c, float d, float tx, float ty) {
+	// x * (a, c) + y * (b, d) is in * (a, d) + swapPairs(in) * (b, c)
+	const F4 ad = set(a, d, a, d), bc = set(b, c, b, c), t = set(tx, ty, tx, ty);
+	size_t i = 0;
+	for (; i + 1 < count; i += 2, in += inStride * 2, out += outStride * 2) {
+		F4 v = loadPairs(in, in + inStride);
+		storePairs(out, out + outStride, mulAdd(mulAdd(t, v, ad), swapPairs(v), bc));
+	}
+	if (i < count) {
+		float x = in[0], y = in[1];
+		out[0] = x * a + y * b + tx;
+		out[1] = x * c + y * d + ty;
+	}
+}
+
+/// Writes an r, g, b, a color at every stride floats.
+inline void fillColor(float *out, size_t stride, size_t count, const float *color) {
+	const F4 v = load(color);
+	for (size_t i = 0; i < count; ++i, out += stride) store(out, v);
+}
+
+/// Writes the 8 floats of a light and a dark color at every stride floats.
+inline void fillTwoColor(float *out, size_t stride, size_t count, const float *light, const float *dark) {
+	const F4 l = load(light), d = load(dark);
+	for (size_t i = 0; i < count; ++i, out += stride) {
+		store(out, l);
+		store(out + 4, d);
+	}
+}
+
+} // namespace simd
+} // namespace spine
+
+#endif /* Spine_SimdUtil_h */
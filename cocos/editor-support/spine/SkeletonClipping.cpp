@@ -35,16 +35,24 @@
 
 #include <spine/Slot.h>
 #include <spine/ClippingAttachment.h>
+#include <spine/MathUtil.h>
+
+#include <string.h>
 
 using namespace spine;
 
-SkeletonClipping::SkeletonClipping() : _clipAttachment(NULL) {
+SkeletonClipping::SkeletonClipping() : _clipAttachment(NULL), _clippingPolygons(NULL), _isRectangle(false),
+	_minX(0), _minY(0), _maxX(0), _maxY(0), _decomposedPolygons(NULL) {
 	_clipOutput.ensureCapacity(128);
 	_clippedVertices.ensureCapacity(128);
 	_clippedTriangles.ensureCapacity(128);
 	_clippedUVs.ensureCapacity(128);
 }
 
+SkeletonClipping::~SkeletonClipping() {
+	ContainerUtil::cleanUpVectorOfPointers(_clipCaches);
+}
+
 size_t SkeletonClipping::clipStart(Slot &slot, ClippingAttachment *clip) {
 	if (_clipAttachment != NULL) {
 		return 0;
@@ -56,16 +64,35 @@ size_t SkeletonClipping::clipStart(Slot &slot, ClippingAttachment *clip) {
 	_clippingPolygon.setSize(n, 0);
 	clip->computeWorldVertices(slot, 0, n, _clippingPolygon, 0, 2);
 	makeClockwise(_clippingPolygon);
-	_clippingPolygons = &_triangulator.decompose(_clippingPolygon, _triangulator.triangulate(_clippingPolygon));
-
-	for (size_t i = 0; i < _clippingPolygons->size(); ++i) {
-		Vector<float> *polygonP = (*_clippingPolygons)[i];
-		Vector<float> &polygon = *polygonP;
-		makeClockwise(polygon);
-		polygon.add(polygon[0]);
-		polygon.add(polygon[1]);
+
+	if (isAxisAlignedRectangle(_clippingPolygon)) {
+		_isRectangle = true;
+		_minX = _maxX = _clippingPolygon[0];
+		_minY = _maxY = _clippingPolygon[1];
+		for (size_t i = 2; i < 8; i += 2) {
+			_minX = MathUtil::min(_minX, _clippingPolygon[i]);
+			_maxX = MathUtil::max(_maxX, _clippingPolygon[i]);
+			_minY = MathUtil::min(_minY, _clippingPolygon[i + 1]);
+			_maxY = MathUtil::max(_maxY, _clippingPolygon[i + 1]);
+		}
+		return 1;
 	}
 
+	// the polygon of a clip whose bones didn't move is decomposed once
+	if (_decomposedPolygons == NULL || _decomposedPolygon != _clippingPolygon) {
+		_decomposedPolygon.clearAndAddAll(_clippingPolygon);
+		_decomposedPolygons = &_triangulator.decompose(_clippingPolygon, _triangulator.triangulate(_clippingPolygon));
+
+		for (size_t i = 0; i < _decomposedPolygons->size(); ++i) {
+			Vector<float> *polygonP = (*_decomposedPolygons)[i];
+			Vector<float> &polygon = *polygonP;
+			makeClockwise(polygon);
+			polygon.add(polygon[0]);
+			polygon.add(polygon[1]);
+		}
+	}
+	_clippingPolygons = _decomposedPolygons;
+
 	return (*_clippingPolygons).size();
 }
 
@@ -80,6 +107,7 @@ void SkeletonClipping::clipEnd() {
 
 	_clipAttachment = NULL;
 	_clippingPolygons = NULL;
+	_isRectangle = false;
 	_clippedVertices.clear();
 	_clippedUVs.clear();
 	_clippedTriangles.clear();
@@ -94,19 +122,14 @@ void SkeletonClipping::clipTriangles(float *vertices, unsigned short *triangles,
 	size_t trianglesLength, float *uvs, size_t stride
 ) {
 	Vector<float> &clipOutput = _clipOutput;
-	Vector<float> &clippedVertices = _clippedVertices;
-	Vector<unsigned short> &clippedTriangles = _clippedTriangles;
-	Vector<Vector<float> *> &polygons = *_clippingPolygons;
-	size_t polygonsCount = (*_clippingPolygons).size();
+	size_t polygonsCount = _isRectangle ? 1 : (*_clippingPolygons).size();
 
 	size_t index = 0;
-	clippedVertices.clear();
+	_clippedVertices.clear();
 	_clippedUVs.clear();
-	clippedTriangles.clear();
+	_clippedTriangles.clear();
 
-	size_t i = 0;
-	continue_outer:
-	for (; i < trianglesLength; i += 3) {
+	for (size_t i = 0; i < trianglesLength; i += 3) {
 		int vertexOffset = triangles[i] * stride;
 		float x1 = vertices[vertexOffset], y1 = vertices[vertexOffset + 1];
 		float u1 = uvs[vertexOffset], v1 = uvs[vertexOffset + 1];
@@ -120,67 +143,66 @@ void SkeletonClipping::clipTriangles(float *vertices, unsigned short *triangles,
 		float u3 = uvs[vertexOffset], v3 = uvs[vertexOffset + 1];
 
 		for (size_t p = 0; p < polygonsCount; p++) {
-			size_t s = clippedVertices.size();
-			if (clip(x1, y1, x2, y2, x3, y3, &(*polygons[p]), &clipOutput)) {
-				size_t clipOutputLength = clipOutput.size();
-				if (clipOutputLength == 0) continue;
-				float d0 = y2 - y3, d1 = x3 - x2, d2 = x1 - x3, d4 = y3 - y1;
-				float d = 1 / (d0 * d2 + d1 * (y1 - y3));
-
-				size_t clipOutputCount = clipOutputLength >> 1;
-				clippedVertices.setSize(s + clipOutputCount * 2, 0);
-				_clippedUVs.setSize(s + clipOutputCount * 2, 0);
-				for (size_t ii = 0; ii < clipOutputLength; ii += 2) {
-					float x = clipOutput[ii], y = clipOutput[ii + 1];
-					clippedVertices[s] = x;
-					clippedVertices[s + 1] = y;
-					float c0 = x - x3, c1 = y - y3;
-					float a = (d0 * c0 + d1 * c1) * d;
-					float b = (d4 * c0 + d2 * c1) * d;
-					float c = 1 - a - b;
-					_clippedUVs[s] = u1 * a + u2 * b + u3 * c;
-					_clippedUVs[s + 1] = v1 * a + v2 * b + v3 * c;
-					s += 2;
-				}
-
-				s = clippedTriangles.size();
-				clippedTriangles.setSize(s + 3 * (clipOutputCount - 2), 0);
-				clipOutputCount--;
-				for (size_t ii = 1; ii < clipOutputCount; ii++) {
-					clippedTriangles[s] = (unsigned short)(index);
-					clippedTriangles[s + 1] = (unsigned short)(index + ii);
-					clippedTriangles[s + 2] = (unsigned short)(index + ii + 1);
-					s += 3;
-				}
-				index += clipOutputCount + 1;
-			} else {
-				clippedVertices.setSize(s + 3 * 2, 0);
-				_clippedUVs.setSize(s + 3 * 2, 0);
-				clippedVertices[s] = x1;
-				clippedVertices[s + 1] = y1;
-				clippedVertices[s + 2] = x2;
-				clippedVertices[s + 3] = y2;
-				clippedVertices[s + 4] = x3;
-				clippedVertices[s + 5] = y3;
-
-				_clippedUVs[s] = u1;
-				_clippedUVs[s + 1] = v1;
-				_clippedUVs[s + 2] = u2;
-				_clippedUVs[s + 3] = v2;
-				_clippedUVs[s + 4] = u3;
-				_clippedUVs[s + 5] = v3;
-
-				s = clippedTriangles.size();
-				clippedTriangles.setSize(s + 3, 0);
-				clippedTriangles[s] = (unsigned short)index;
-				clippedTriangles[s + 1] = (unsigned short)(index + 1);
-				clippedTriangles[s + 2] = (unsigned short)(index + 2);
-				index += 3;
-				i += 3;
-				goto continue_outer;
+			bool clipped = _isRectangle ? clipRectangle(x1, y1, x2, y2, x3, y3, &clipOutput)
+				: clip(x1, y1, x2, y2, x3, y3, (*_clippingPolygons)[p], &clipOutput);
+			if (!clipped) {
+				addTriangle(x1, y1, x2, y2, x3, y3, u1, v1, u2, v2, u3, v3, index);
+				break;
 			}
+			if (clipOutput.size() == 0) continue;
+			addClippedPolygon(clipOutput, x1, y1, x2, y2, x3, y3, u1, v1, u2, v2, u3, v3, index);
+		}
+	}
+}
+
+void SkeletonClipping::clipTriangles(const void *key, float *vertices, unsigned short *triangles,
+	size_t trianglesLength, float *uvs, size_t stride
+) {
+	size_t vertexCount = 0;
+	for (size_t i = 0; i < trianglesLength; ++i)
+		vertexCount = MathUtil::max(vertexCount, (size_t)triangles[i] + 1);
+
+	ClipCache *cache = NULL;
+	for (size_t i = 0, n = _clipCaches.size(); i < n; ++i) {
+		if (_clipCaches[i]->key == key && _clipCaches[i]->clip == _clipAttachment) {
+			cache = _clipCaches[i];
+			break;
+		}
+	}
+	if (cache != NULL && isCacheValid(cache, vertices, triangles, trianglesLength, uvs, stride, vertexCount)) {
+		_clippedVertices.clearAndAddAll(cache->clippedVertices);
+		_clippedUVs.clearAndAddAll(cache->clippedUVs);
+		_clippedTriangles.clearAndAddAll(cache->clippedTriangles);
+		return;
+	}
+
+	clipTriangles(vertices, triangles, trianglesLength, uvs, stride);
+
+	if (cache == NULL) {
+		if (_clipCaches.size() >= MAX_CLIP_CACHES) {
+			_clipCachePool.free(_clipCaches[0]);
+			_clipCaches.removeAt(0);
 		}
+		cache = _clipCachePool.obtain();
+		cache->key = key;
+		cache->clip = _clipAttachment;
+		_clipCaches.add(cache);
 	}
+	cache->polygon.clearAndAddAll(_clippingPolygon);
+	cache->triangles.setSize(trianglesLength, 0);
+	if (trianglesLength > 0) memcpy(cache->triangles.buffer(), triangles, trianglesLength * sizeof(unsigned short));
+	cache->vertices.setSize(vertexCount << 1, 0);
+	cache->uvs.setSize(vertexCount << 1, 0);
+	float *cachedVertices = cache->vertices.buffer(), *cachedUVs = cache->uvs.buffer();
+	for (size_t v = 0, w = 0; v < vertexCount; ++v, w += stride) {
+		cachedVertices[v << 1] = vertices[w];
+		cachedVertices[(v << 1) + 1] = vertices[w + 1];
+		cachedUVs[v << 1] = uvs[w];
+		cachedUVs[(v << 1) + 1] = uvs[w + 1];
+	}
+	cache->clippedVertices.clearAndAddAll(_clippedVertices);
+	cache->clippedUVs.clearAndAddAll(_clippedUVs);
+	cache->clippedTriangles.clearAndAddAll(_clippedTriangles);
 }
 
 bool SkeletonClipping::isClipping() {
@@ -301,6 +323,145 @@ bool SkeletonClipping::clip(float x1, float y1, float x2, float y2, float x3, fl
 	return clipped;
 }
 
+bool SkeletonClipping::clipRectangle(float x1, float y1, float x2, float y2, float x3, float y3, Vector<float> *output) {
+	output->clear();
+	float minX = MathUtil::min(x1, MathUtil::min(x2, x3)), maxX = MathUtil::max(x1, MathUtil::max(x2, x3));
+	float minY = MathUtil::min(y1, MathUtil::min(y2, y3)), maxY = MathUtil::max(y1, MathUtil::max(y2, y3));
+	if (minX >= _minX && maxX <= _maxX && minY >= _minY && maxY <= _maxY) return false;
+	if (maxX <= _minX || minX >= _maxX || maxY <= _minY || minY >= _maxY) return true;
+
+	// every edge adds at most one vertex to the triangle
+	float buffers[2][16] = {{x1, y1, x2, y2, x3, y3}};
+	float *input = buffers[0], *clipped = buffers[1];
+	size_t count = 3;
+	const float bounds[4] = {_minX, _minY, _maxX, _maxY};
+	for (int edge = 0; edge < 4; ++edge) {
+		int axis = edge & 1;
+		float bound = bounds[edge], side = edge < 2 ? 1.0f : -1.0f;
+		size_t clippedCount = 0;
+		for (size_t i = 0; i < count; ++i) {
+			float *a = input + (i << 1), *b = input + (((i + 1) % count) << 1);
+			float da = (a[axis] - bound) * side, db = (b[axis] - bound) * side;
+			if (da >= 0) {
+				clipped[clippedCount << 1] = a[0];
+				clipped[(clippedCount << 1) + 1] = a[1];
+				clippedCount++;
+			}
+			if ((da >= 0) != (db >= 0)) {
+				float t = da / (da - db);
+				clipped[clippedCount << 1] = a[0] + (b[0] - a[0]) * t;
+				clipped[(clippedCount << 1) + 1] = a[1] + (b[1] - a[1]) * t;
+				clippedCount++;
+			}
+		}
+		float *temp = input;
+		input = clipped;
+		clipped = temp;
+		count = clippedCount;
+		if (count < 3) return true;
+	}
+
+	output->setSize(count << 1, 0);
+	memcpy(output->buffer(), input, (count << 1) * sizeof(float));
+	return true;
+}
+
+void SkeletonClipping::addClippedPolygon(Vector<float> &polygon, float x1, float y1, float x2, float y2, float x3, float y3,
+	float u1, float v1, float u2, float v2, float u3, float v3, size_t &index
+) {
+	size_t clipOutputLength = polygon.size();
+	float d0 = y2 - y3, d1 = x3 - x2, d2 = x1 - x3, d4 = y3 - y1;
+	float d = 1 / (d0 * d2 + d1 * (y1 - y3));
+
+	size_t s = _clippedVertices.size();
+	size_t clipOutputCount = clipOutputLength >> 1;
+	_clippedVertices.setSize(s + clipOutputCount * 2, 0);
+	_clippedUVs.setSize(s + clipOutputCount * 2, 0);
+	for (size_t ii = 0; ii < clipOutputLength; ii += 2) {
+		float x = polygon[ii], y = polygon[ii + 1];
+		_clippedVertices[s] = x;
+		_clippedVertices[s + 1] = y;
+		float c0 = x - x3, c1 = y - y3;
+		float a = (d0 * c0 + d1 * c1) * d;
+		float b = (d4 * c0 + d2 * c1) * d;
+		float c = 1 - a - b;
+		_clippedUVs[s] = u1 * a + u2 * b + u3 * c;
+		_clippedUVs[s + 1] = v1 * a + v2 * b + v3 * c;
+		s += 2;
+	}
+
+	s = _clippedTriangles.size();
+	_clippedTriangles.setSize(s + 3 * (clipOutputCount - 2), 0);
+	clipOutputCount--;
+	for (size_t ii = 1; ii < clipOutputCount; ii++) {
+		_clippedTriangles[s] = (unsigned short)(index);
+		_clippedTriangles[s + 1] = (unsigned short)(index + ii);
+		_clippedTriangles[s + 2] = (unsigned short)(index + ii + 1);
+		s += 3;
+	}
+	index += clipOutputCount + 1;
+}
+
+void SkeletonClipping::addTriangle(float x1, float y1, float x2, float y2, float x3, float y3,
+	float u1, float v1, float u2, float v2, float u3, float v3, size_t &index
+) {
+	size_t s = _clippedVertices.size();
+	_clippedVertices.setSize(s + 3 * 2, 0);
+	_clippedUVs.setSize(s + 3 * 2, 0);
+	_clippedVertices[s] = x1;
+	_clippedVertices[s + 1] = y1;
+	_clippedVertices[s + 2] = x2;
+	_clippedVertices[s + 3] = y2;
+	_clippedVertices[s + 4] = x3;
+	_clippedVertices[s + 5] = y3;
+
+	_clippedUVs[s] = u1;
+	_clippedUVs[s + 1] = v1;
+	_clippedUVs[s + 2] = u2;
+	_clippedUVs[s + 3] = v2;
+	_clippedUVs[s + 4] = u3;
+	_clippedUVs[s + 5] = v3;
+
+	s = _clippedTriangles.size();
+	_clippedTriangles.setSize(s + 3, 0);
+	_clippedTriangles[s] = (unsigned short)index;
+	_clippedTriangles[s + 1] = (unsigned short)(index + 1);
+	_clippedTriangles[s + 2] = (unsigned short)(index + 2);
+	index += 3;
+}
+
+bool SkeletonClipping::isCacheValid(ClipCache *cache, float *vertices, unsigned short *triangles, size_t trianglesLength,
+	float *uvs, size_t stride, size_t vertexCount
+) {
+	if (cache->polygon != _clippingPolygon) return false;
+	if (cache->triangles.size() != trianglesLength || cache->vertices.size() != vertexCount << 1) return false;
+	if (trianglesLength > 0 && memcmp(cache->triangles.buffer(), triangles, trianglesLength * sizeof(unsigned short)) != 0) return false;
+
+	float *cachedVertices = cache->vertices.buffer(), *cachedUVs = cache->uvs.buffer();
+	for (size_t v = 0, w = 0; v < vertexCount; ++v, w += stride) {
+		if (cachedVertices[v << 1] != vertices[w] || cachedVertices[(v << 1) + 1] != vertices[w + 1]) return false;
+		if (cachedUVs[v << 1] != uvs[w] || cachedUVs[(v << 1) + 1] != uvs[w + 1]) return false;
+	}
+	return true;
+}
+
+bool SkeletonClipping::isAxisAlignedRectangle(Vector<float> &polygon) {
+	if (polygon.size() != 8) return false;
+
+	// the edges alternate between horizontal and vertical, up to the rounding of the bone transforms
+	const float epsilon = 0.00001f;
+	bool wasHorizontal = false;
+	for (size_t i = 0; i < 8; i += 2) {
+		float dx = MathUtil::abs(polygon[(i + 2) % 8] - polygon[i]);
+		float dy = MathUtil::abs(polygon[(i + 3) % 8] - polygon[i + 1]);
+		bool isHorizontal = dy <= dx * epsilon, isVertical = dx <= dy * epsilon;
+		if (isHorizontal == isVertical) return false;
+		if (i > 0 && isHorizontal == wasHorizontal) return false;
+		wasHorizontal = isHorizontal;
+	}
+	return true;
+}
+
 void SkeletonClipping::makeClockwise(Vector<float> &polygon) {
 	size_t verticeslength = polygon.size();
 
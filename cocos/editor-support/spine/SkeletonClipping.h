@@ -31,6 +31,7 @@
 #define Spine_SkeletonClipping_h
 
 #include <spine/Vector.h>
+#include <spine/Pool.h>
 #include <spine/Triangulator.h>
 
 namespace spine {
@@ -41,6 +42,8 @@ namespace spine {
 	public:
 		SkeletonClipping();
 
+		~SkeletonClipping();
+
 		size_t clipStart(Slot& slot, ClippingAttachment* clip);
 
 		void clipEnd(Slot& slot);
@@ -51,6 +54,10 @@ namespace spine {
 
 		void clipTriangles(Vector<float>& vertices, Vector<unsigned short>& triangles, Vector<float>& uvs, size_t stride);
 
+		/// Like clipTriangles, reusing the result of the last call with the same key and clipping attachment when the
+		/// clipping polygon, the triangles, the vertices and the uvs are unchanged, as for slots whose bones didn't move.
+		void clipTriangles(const void* key, float* vertices, unsigned short* triangles, size_t trianglesLength, float* uvs, size_t stride);
+
 		bool isClipping();
 
 		Vector<float>& getClippedVertices();
@@ -58,6 +65,22 @@ namespace spine {
 		Vector<float>& getClippedUVs();
 
 	private:
+		/// Input and result of a clipTriangles call, the input vertices and uvs packed.
+		class ClipCache : public SpineObject {
+		public:
+			const void* key;
+			ClippingAttachment* clip;
+			Vector<float> polygon;
+			Vector<unsigned short> triangles;
+			Vector<float> vertices;
+			Vector<float> uvs;
+			Vector<float> clippedVertices;
+			Vector<unsigned short> clippedTriangles;
+			Vector<float> clippedUVs;
+		};
+
+		static const size_t MAX_CLIP_CACHES = 64;
+
 		Triangulator _triangulator;
 		Vector<float> _clippingPolygon;
 		Vector<float> _clipOutput;
@@ -68,10 +91,36 @@ namespace spine {
 		ClippingAttachment* _clipAttachment;
 		Vector< Vector<float>* > *_clippingPolygons;
 
+		// the clipping polygon is an axis-aligned rectangle, clipped without triangulating it
+		bool _isRectangle;
+		float _minX, _minY, _maxX, _maxY;
+
+		// the decomposed polygons stay valid until the triangulator decomposes again
+		Vector<float> _decomposedPolygon;
+		Vector< Vector<float>* > *_decomposedPolygons;
+
+		Vector<ClipCache*> _clipCaches;
+		Pool<ClipCache> _clipCachePool;
+
 		/** Clips the input triangle against the convex, clockwise clipping area. If the triangle lies entirely within the clipping
 		  * area, false is returned. The clipping area must duplicate the first vertex at the end of the vertices list. */
 		bool clip(float x1, float y1, float x2, float y2, float x3, float y3, Vector<float>* clippingArea, Vector<float>* output);
 
+		/** Clips the input triangle against the rectangle of the axis-aligned clipping polygon, with the result of clip. */
+		bool clipRectangle(float x1, float y1, float x2, float y2, float x3, float y3, Vector<float>* output);
+
+		/** Adds the clipped polygon of a triangle to the clipped vertices, uvs and triangles. */
+		void addClippedPolygon(Vector<float>& polygon, float x1, float y1, float x2, float y2, float x3, float y3,
+			float u1, float v1, float u2, float v2, float u3, float v3, size_t& index);
+
+		/** Adds an unclipped triangle to the clipped vertices, uvs and triangles. */
+		void addTriangle(float x1, float y1, float x2, float y2, float x3, float y3,
+			float u1, float v1, float u2, float v2, float u3, float v3, size_t& index);
+
+		bool isCacheValid(ClipCache* cache, float* vertices, unsigned short* triangles, size_t trianglesLength, float* uvs, size_t stride, size_t vertexCount);
+
+		static bool isAxisAlignedRectangle(Vector<float>& polygon);
+
 		static void makeClockwise(Vector<float>& polygon);
 	};
 }
@@ -37,6 +37,7 @@
 
 #include <spine/Bone.h>
 #include <spine/Skeleton.h>
+#include <spine/SimdUtil.h>
 
 using namespace spine;
 
@@ -70,15 +71,9 @@ void VertexAttachment::computeWorldVertices(Slot &slot, size_t start, size_t cou
 		if (deformArray->size() > 0) vertices = deformArray;
 
 		Bone &bone = slot._bone;
-		float x = bone._worldX;
-		float y = bone._worldY;
-		float a = bone._a, b = bone._b, c = bone._c, d = bone._d;
-		for (size_t vv = start, w = offset; w < count; vv += 2, w += stride) {
-			float vx = (*vertices)[vv];
-			float vy = (*vertices)[vv + 1];
-			worldVertices[w] = vx * a + vy * b + x;
-			worldVertices[w + 1] = vx * c + vy * d + y;
-		}
+		size_t pointCount = count > offset ? (count - offset + stride - 1) / stride : 0;
+		simd::transformPoints(vertices->buffer() + start, 2, worldVertices + offset, stride, pointCount,
+			bone._a, bone._b, bone._c, bone._d, bone._worldX, bone._worldY);
 		return;
 	}
 
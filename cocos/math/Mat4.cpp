@@ -454,6 +454,40 @@ void Mat4::fromRT(const Vec4 &rotation, const Vec3 &translation, Mat4 *dst) {
     dst->m[15] = 1;
 }
 
+void Mat4::fromRTS(const Quaternion &rotation, const Vec3 &translation, const Vec3 &scale, Mat4 *dst) {
+    const auto x = rotation.x, y = rotation.y, z = rotation.z, w = rotation.w;
+    const auto x2 = x + x;
+    const auto y2 = y + y;
+    const auto z2 = z + z;
+
+    const auto xx = x * x2;
+    const auto xy = x * y2;
+    const auto xz = x * z2;
+    const auto yy = y * y2;
+    const auto yz = y * z2;
+    const auto zz = z * z2;
+    const auto wx = w * x2;
+    const auto wy = w * y2;
+    const auto wz = w * z2;
+
+    dst->m[0] = (1 - (yy + zz)) * scale.x;
+    dst->m[1] = (xy + wz) * scale.x;
+    dst->m[2] = (xz - wy) * scale.x;
+    dst->m[3] = 0;
+    dst->m[4] = (xy - wz) * scale.y;
+    dst->m[5] = (1 - (xx + zz)) * scale.y;
+    dst->m[6] = (yz + wx) * scale.y;
+    dst->m[7] = 0;
+    dst->m[8] = (xz + wy) * scale.z;
+    dst->m[9] = (yz - wx) * scale.z;
+    dst->m[10] = (1 - (xx + yy)) * scale.z;
+    dst->m[11] = 0;
+    dst->m[12] = translation.x;
+    dst->m[13] = translation.y;
+    dst->m[14] = translation.z;
+    dst->m[15] = 1;
+}
+
 bool Mat4::decompose(Vec3 *scale, Quaternion *rotation, Vec3 *translation) const {
     if (translation) {
         // Extract the translation.
@@ -717,6 +751,11 @@ void Mat4::multiply(const Mat4 &m1, const Mat4 &m2, Mat4 *dst) {
 #endif
 }
 
+void Mat4::multiply(const Mat4 *m1, const Mat4 *m2, Mat4 *dst, size_t count) {
+    GP_ASSERT(dst || !count);
+    MathUtil::multiplyMatrices(m1->m, m2->m, dst->m, static_cast<unsigned int>(count));
+}
+
 void Mat4::negate() {
 #ifdef __SSE__
     MathUtil::negateMatrix(col, col);
@@ -872,6 +911,18 @@ void Mat4::transformVector(float x, float y, float z, float w, Vec3 *dst) const
     MathUtil::transformVec4(m, x, y, z, w, (float *)dst);
 }
 
+void Mat4::transformPoints(const Vec3 *points, Vec3 *dst, size_t count) const {
+    static_assert(sizeof(Vec3) == sizeof(float) * 3, "points are packed floats");
+    GP_ASSERT(dst || !count);
+    MathUtil::transformPoints(m, &points->x, &dst->x, static_cast<unsigned int>(count));
+}
+
+void Mat4::transformPoints(const Vec3 *points, Vec4 *dst, size_t count) const {
+    static_assert(sizeof(Vec4) == sizeof(float) * 4, "vectors are packed floats");
+    GP_ASSERT(dst || !count);
+    MathUtil::transformPointsHomogeneous(m, &points->x, &dst->x, static_cast<unsigned int>(count));
+}
+
 void Mat4::transformVector(Vec4 *vector) const {
     GP_ASSERT(vector);
     transformVector(*vector, vector);
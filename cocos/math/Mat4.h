@@ -401,6 +401,11 @@ public:
      * Calculate the matrix according to the ratation and translation
      */
     static void fromRT(const Vec4 &rotation, const Vec3 &translation, Mat4 *dst);
+
+    /**
+     * Calculate the matrix according to the rotation, translation and scale
+     */
+    static void fromRTS(const Quaternion &rotation, const Vec3 &translation, const Vec3 &scale, Mat4 *dst);
     
     /**
      * Decomposes the scale, rotation and translation components of this matrix.
@@ -547,6 +552,16 @@ public:
      */
     static void multiply(const Mat4 &m1, const Mat4 &m2, Mat4 *dst);
 
+    /**
+     * Multiplies batches of matrices, dst[i] = m1[i] * m2[i], such as the world matrices of a hierarchy level.
+     *
+     * @param m1 The first matrices to multiply.
+     * @param m2 The second matrices to multiply.
+     * @param dst The matrices to store the results in, may be m1 or m2.
+     * @param count The number of matrices.
+     */
+    static void multiply(const Mat4 *m1, const Mat4 *m2, Mat4 *dst, size_t count);
+
     /**
      * Negates this matrix.
      */
@@ -786,6 +801,24 @@ public:
         transformVector(point.x, point.y, point.z, 1.0f, dst);
     }
 
+    /**
+     * Transforms a batch of points by this matrix like transformPoint.
+     *
+     * @param points The points to transform.
+     * @param dst The points to store the results in, may be points.
+     * @param count The number of points.
+     */
+    void transformPoints(const Vec3 *points, Vec3 *dst, size_t count) const;
+
+    /**
+     * Transforms a batch of points by this matrix with a w of 1, keeping the w of the results.
+     *
+     * @param points The points to transform.
+     * @param dst The vectors to store the results in.
+     * @param count The number of points.
+     */
+    void transformPoints(const Vec3 *points, Vec4 *dst, size_t count) const;
+
     /**
      * Transforms the specified vector by this matrix by
      * treating the fourth (w) coordinate as zero.
@@ -21,6 +21,7 @@ This file was modified to fit the cocos2d-x project
 */
 
 #include "math/MathUtil.h"
+#include "math/Quaternion.h"
 #include "base/Macros.h"
 
 #if (CC_PLATFORM == CC_PLATFORM_ANDROID)
@@ -33,6 +34,7 @@ This file was modified to fit the cocos2d-x project
 //#define INCLUDE_NEON64    : neon 64 code included
 //#define USE_SSE           : SSE code used
 //#define INCLUDE_SSE       : SSE code included
+//#define INCLUDE_AVX2      : AVX2 code included, used once the CPU supports it
 
 #if (CC_PLATFORM == CC_PLATFORM_MAC_IOS)
     #if defined (__arm64__)
@@ -60,19 +62,33 @@ This file was modified to fit the cocos2d-x project
 #define INCLUDE_SSE
 #endif
 
+#if defined (__x86_64__) || defined (_M_X64)
+#define INCLUDE_AVX2
+#endif
+
 #ifdef INCLUDE_NEON32
 #include "math/MathUtilNeon.inl"
 #endif
 
+#include "math/MathUtil.inl"
+
 #ifdef INCLUDE_NEON64
+#include <arm_neon.h>
 #include "math/MathUtilNeon64.inl"
 #endif
 
 #ifdef INCLUDE_SSE
+#include <emmintrin.h>
 #include "math/MathUtilSSE.inl"
 #endif
 
-#include "math/MathUtil.inl"
+#ifdef INCLUDE_AVX2
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include "math/MathUtilAVX2.inl"
+#endif
 
 NS_CC_MATH_BEGIN
 
@@ -137,6 +153,31 @@ bool MathUtil::isNeon64Enabled()
 #endif
 }
 
+bool MathUtil::isAVX2Enabled()
+{
+#if defined (INCLUDE_AVX2) && defined (_MSC_VER)
+    static const bool isEnabled = []() {
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        const bool hasFMA = (info[2] & (1 << 12)) != 0;
+        const bool hasOSXSAVE = (info[2] & (1 << 27)) != 0;
+        const bool hasAVX = (info[2] & (1 << 28)) != 0;
+        // the OS has to save the ymm registers too
+        if (!hasFMA || !hasOSXSAVE || !hasAVX || (_xgetbv(0) & 6) != 6) return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    }();
+    return isEnabled;
+#elif defined (INCLUDE_AVX2)
+    static const bool isEnabled = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return isEnabled;
+#else
+    return false;
+#endif
+}
+
 void MathUtil::addMatrix(const float* m, float scalar, float* dst)
 {
 #ifdef USE_NEON32
@@ -277,6 +318,158 @@ void MathUtil::crossVec3(const float* v1, const float* v2, float* dst)
 #endif
 }
 
+void MathUtil::cullAABBs(const float* centerX, const float* centerY, const float* centerZ,
+                         const float* extentX, const float* extentY, const float* extentZ,
+                         unsigned int count, const float* planes, unsigned int planeCount, unsigned char* results)
+{
+#if defined (USE_NEON64)
+    MathUtilNeon64::cullAABBs(centerX, centerY, centerZ, extentX, extentY, extentZ, count, planes, planeCount, results);
+#elif defined (USE_SSE)
+    MathUtilSSE::cullAABBs(centerX, centerY, centerZ, extentX, extentY, extentZ, count, planes, planeCount, results);
+#else
+    MathUtilC::cullAABBs(centerX, centerY, centerZ, extentX, extentY, extentZ, count, planes, planeCount, results);
+#endif
+}
+
+void MathUtil::intersectSphereAABBs(float sphereX, float sphereY, float sphereZ, float radius,
+                                    const float* centerX, const float* centerY, const float* centerZ,
+                                    const float* extentX, const float* extentY, const float* extentZ,
+                                    unsigned int count, unsigned char* results)
+{
+#if defined (USE_NEON64)
+    MathUtilNeon64::intersectSphereAABBs(sphereX, sphereY, sphereZ, radius, centerX, centerY, centerZ, extentX, extentY, extentZ, count, results);
+#elif defined (USE_SSE)
+    MathUtilSSE::intersectSphereAABBs(sphereX, sphereY, sphereZ, radius, centerX, centerY, centerZ, extentX, extentY, extentZ, count, results);
+#else
+    MathUtilC::intersectSphereAABBs(sphereX, sphereY, sphereZ, radius, centerX, centerY, centerZ, extentX, extentY, extentZ, count, results);
+#endif
+}
+
+void MathUtil::rasterizeDepthSpan(float* depths, unsigned int count, float edge0, float edge1, float edge2,
+                                  float step0, float step1, float step2, float depth)
+{
+#if defined (USE_NEON64)
+    MathUtilNeon64::rasterizeDepthSpan(depths, count, edge0, edge1, edge2, step0, step1, step2, depth);
+#elif defined (USE_SSE)
+    MathUtilSSE::rasterizeDepthSpan(depths, count, edge0, edge1, edge2, step0, step1, step2, depth);
+#else
+    MathUtilC::rasterizeDepthSpan(depths, count, edge0, edge1, edge2, step0, step1, step2, depth);
+#endif
+}
+
+bool MathUtil::isDepthSpanOccluded(const float* depths, unsigned int count, float depth)
+{
+#if defined (USE_NEON64)
+    return MathUtilNeon64::isDepthSpanOccluded(depths, count, depth);
+#elif defined (USE_SSE)
+    return MathUtilSSE::isDepthSpanOccluded(depths, count, depth);
+#else
+    return MathUtilC::isDepthSpanOccluded(depths, count, depth);
+#endif
+}
+
+void MathUtil::multiplyMatrices(const float* m1, const float* m2, float* dst, unsigned int count)
+{
+#if defined (USE_NEON64)
+    MathUtilNeon64::multiplyMatrices(m1, m2, dst, count);
+#elif defined (INCLUDE_AVX2) && defined (USE_SSE)
+    if (isAVX2Enabled()) MathUtilAVX2::multiplyMatrices(m1, m2, dst, count);
+    else MathUtilSSE::multiplyMatrices(m1, m2, dst, count);
+#elif defined (INCLUDE_AVX2)
+    if (isAVX2Enabled()) MathUtilAVX2::multiplyMatrices(m1, m2, dst, count);
+    else MathUtilC::multiplyMatrices(m1, m2, dst, count);
+#elif defined (USE_SSE)
+    MathUtilSSE::multiplyMatrices(m1, m2, dst, count);
+#elif defined (USE_NEON32)
+    for (unsigned int i = 0; i < count; ++i) MathUtilNeon::multiplyMatrix(m1 + i * 16, m2 + i * 16, dst + i * 16);
+#elif defined (INCLUDE_NEON32)
+    if (isNeon32Enabled())
+    {
+        for (unsigned int i = 0; i < count; ++i) MathUtilNeon::multiplyMatrix(m1 + i * 16, m2 + i * 16, dst + i * 16);
+    }
+    else MathUtilC::multiplyMatrices(m1, m2, dst, count);
+#else
+    MathUtilC::multiplyMatrices(m1, m2, dst, count);
+#endif
+}
+
+void MathUtil::transformPoints(const float* m, const float* points, float* dst, unsigned int count)
+{
+#if defined (USE_NEON64)
+    MathUtilNeon64::transformPoints(m, points, dst, count);
+#elif defined (USE_SSE)
+    MathUtilSSE::transformPoints(m, points, dst, count);
+#else
+    MathUtilC::transformPoints(m, points, dst, count);
+#endif
+}
+
+void MathUtil::transformPointsHomogeneous(const float* m, const float* points, float* dst, unsigned int count)
+{
+#if defined (USE_NEON64)
+    MathUtilNeon64::transformPointsHomogeneous(m, points, dst, count);
+#elif defined (USE_SSE)
+    MathUtilSSE::transformPointsHomogeneous(m, points, dst, count);
+#else
+    MathUtilC::transformPointsHomogeneous(m, points, dst, count);
+#endif
+}
+
+void MathUtil::multiplyQuaternions(const float* q1, const float* q2, float* dst, unsigned int count)
+{
+#if defined (USE_NEON64)
+    MathUtilNeon64::multiplyQuaternions(q1, q2, dst, count);
+#elif defined (USE_SSE)
+    MathUtilSSE::multiplyQuaternions(q1, q2, dst, count);
+#else
+    MathUtilC::multiplyQuaternions(q1, q2, dst, count);
+#endif
+}
+
+void MathUtil::slerpQuaternions(const float* q1, const float* q2, float t, float* dst, unsigned int count)
+{
+#if defined (USE_NEON64)
+    MathUtilNeon64::slerpQuaternions(q1, q2, t, dst, count);
+#elif defined (USE_SSE)
+    MathUtilSSE::slerpQuaternions(q1, q2, t, dst, count);
+#else
+    MathUtilC::slerpQuaternions(q1, q2, t, dst, count);
+#endif
+}
+
+void MathUtil::transformVec3sByQuat(const float* q, const float* v, float* dst, unsigned int count)
+{
+#if defined (USE_NEON64)
+    MathUtilNeon64::transformVec3sByQuat(q, v, dst, count);
+#elif defined (USE_SSE)
+    MathUtilSSE::transformVec3sByQuat(q, v, dst, count);
+#else
+    MathUtilC::transformVec3sByQuat(q, v, dst, count);
+#endif
+}
+
+void MathUtil::normalizeVec3s(const float* v, float* dst, unsigned int count)
+{
+#if defined (USE_NEON64)
+    MathUtilNeon64::normalizeVec3s(v, dst, count);
+#elif defined (USE_SSE)
+    MathUtilSSE::normalizeVec3s(v, dst, count);
+#else
+    MathUtilC::normalizeVec3s(v, dst, count);
+#endif
+}
+
+void MathUtil::dotVec3s(const float* v1, const float* v2, float* dst, unsigned int count)
+{
+#if defined (USE_NEON64)
+    MathUtilNeon64::dotVec3s(v1, v2, dst, count);
+#elif defined (USE_SSE)
+    MathUtilSSE::dotVec3s(v1, v2, dst, count);
+#else
+    MathUtilC::dotVec3s(v1, v2, dst, count);
+#endif
+}
+
 void MathUtil::combineHash(size_t& seed, const size_t& v)
 {
     seed ^= v + 0x9e3779b9 + (seed<<6) + (seed>>2);
@@ -96,10 +96,170 @@ public:
      * @param v
      */
     static void combineHash(size_t& seed, const size_t& v);
+
+    /**
+     * Tests a batch of axis-aligned boxes against a set of planes, four boxes per
+     * iteration where SSE or NEON is available.
+     * The boxes are given as structure-of-arrays, the planes as packed
+     * (normal.x, normal.y, normal.z, distance) tuples with normals pointing inwards.
+     *
+     * @param centerX x components of the box centers.
+     * @param centerY y components of the box centers.
+     * @param centerZ z components of the box centers.
+     * @param extentX x components of the box half extents.
+     * @param extentY y components of the box half extents.
+     * @param extentZ z components of the box half extents.
+     * @param count the number of boxes.
+     * @param planes the packed planes, 4 floats per plane.
+     * @param planeCount the number of planes.
+     * @param results receives 1 for every box that is not completely outside any plane and 0 otherwise.
+     */
+    static void cullAABBs(const float* centerX, const float* centerY, const float* centerZ,
+                          const float* extentX, const float* extentY, const float* extentZ,
+                          unsigned int count, const float* planes, unsigned int planeCount, unsigned char* results);
+
+    /**
+     * Tests a batch of axis-aligned boxes against a sphere, four boxes per
+     * iteration where SSE or NEON is available.
+     * The boxes are given as structure-of-arrays like in cullAABBs.
+     *
+     * @param sphereX x component of the sphere center.
+     * @param sphereY y component of the sphere center.
+     * @param sphereZ z component of the sphere center.
+     * @param radius the sphere radius.
+     * @param centerX x components of the box centers.
+     * @param centerY y components of the box centers.
+     * @param centerZ z components of the box centers.
+     * @param extentX x components of the box half extents.
+     * @param extentY y components of the box half extents.
+     * @param extentZ z components of the box half extents.
+     * @param count the number of boxes.
+     * @param results receives 1 for every box the sphere intersects and 0 otherwise.
+     */
+    static void intersectSphereAABBs(float sphereX, float sphereY, float sphereZ, float radius,
+                                     const float* centerX, const float* centerY, const float* centerZ,
+                                     const float* extentX, const float* extentY, const float* extentZ,
+                                     unsigned int count, unsigned char* results);
+
+    /**
+     * Writes a depth into the pixels of a row span covered by a triangle, four pixels per
+     * iteration where SSE or NEON is available. Pixel i lies inside when all three edge
+     * functions edge + step * i are not negative, covered pixels keep the nearer depth.
+     *
+     * @param depths the depth row starting at the first pixel of the span.
+     * @param count the number of pixels in the span.
+     * @param edge0 value of the first edge function at the first pixel.
+     * @param edge1 value of the second edge function at the first pixel.
+     * @param edge2 value of the third edge function at the first pixel.
+     * @param step0 increment of the first edge function per pixel.
+     * @param step1 increment of the second edge function per pixel.
+     * @param step2 increment of the third edge function per pixel.
+     * @param depth the depth to write.
+     */
+    static void rasterizeDepthSpan(float* depths, unsigned int count, float edge0, float edge1, float edge2,
+                                   float step0, float step1, float step2, float depth);
+
+    /**
+     * Tests whether every depth of a row span is nearer than the given depth, four pixels
+     * per iteration where SSE or NEON is available.
+     *
+     * @param depths the depth row starting at the first pixel of the span.
+     * @param count the number of pixels in the span.
+     * @param depth the depth to compare against.
+     * @return true if all depths are less than depth.
+     */
+    static bool isDepthSpanOccluded(const float* depths, unsigned int count, float depth);
+
+    /**
+     * Multiplies batches of column-major matrices, dst[i] = m1[i] * m2[i]. Uses AVX2 where the CPU
+     * supports it, SSE or NEON otherwise.
+     *
+     * @param m1 the left matrices, 16 floats each.
+     * @param m2 the right matrices, 16 floats each.
+     * @param dst receives the products, it may be the same array as m1 or m2.
+     * @param count the number of matrices.
+     */
+    static void multiplyMatrices(const float* m1, const float* m2, float* dst, unsigned int count);
+
+    /**
+     * Transforms packed points by a column-major matrix, taking w as 1 and dropping the w of the
+     * results. Four points per iteration where SSE or NEON is available.
+     *
+     * @param m the matrix.
+     * @param points the points, 3 floats each.
+     * @param dst receives the transformed points, 3 floats each, it may be the same array as points.
+     * @param count the number of points.
+     */
+    static void transformPoints(const float* m, const float* points, float* dst, unsigned int count);
+
+    /**
+     * Transforms packed points by a column-major matrix like transformPoints, keeping the w of the
+     * results, as for projecting points into clip space.
+     *
+     * @param m the matrix.
+     * @param points the points, 3 floats each.
+     * @param dst receives the transformed points, 4 floats each, it must not overlap points.
+     * @param count the number of points.
+     */
+    static void transformPointsHomogeneous(const float* m, const float* points, float* dst, unsigned int count);
+
+    /**
+     * Multiplies batches of quaternions, dst[i] = q1[i] * q2[i]. Four quaternions per iteration
+     * where SSE or NEON is available.
+     *
+     * @param q1 the left quaternions, 4 floats each in x, y, z, w order.
+     * @param q2 the right quaternions, 4 floats each.
+     * @param dst receives the products, it may be the same array as q1 or q2.
+     * @param count the number of quaternions.
+     */
+    static void multiplyQuaternions(const float* q1, const float* q2, float* dst, unsigned int count);
+
+    /**
+     * Interpolates batches of quaternions with the fast slerp of Quaternion::slerp, as when blending
+     * the joints of a skeleton.
+     *
+     * @param q1 the quaternions at t = 0, 4 floats each.
+     * @param q2 the quaternions at t = 1, 4 floats each.
+     * @param t the interpolation coefficient, in [0, 1].
+     * @param dst receives the results, it may be the same array as q1 or q2.
+     * @param count the number of quaternions.
+     */
+    static void slerpQuaternions(const float* q1, const float* q2, float t, float* dst, unsigned int count);
+
+    /**
+     * Rotates packed vectors by a quaternion like Vec3::transformQuat.
+     *
+     * @param q the quaternion, 4 floats.
+     * @param v the vectors, 3 floats each.
+     * @param dst receives the rotated vectors, it may be the same array as v.
+     * @param count the number of vectors.
+     */
+    static void transformVec3sByQuat(const float* q, const float* v, float* dst, unsigned int count);
+
+    /**
+     * Normalizes packed vectors like Vec3::normalize, vectors too close to zero are kept as they are.
+     *
+     * @param v the vectors, 3 floats each.
+     * @param dst receives the normalized vectors, it may be the same array as v.
+     * @param count the number of vectors.
+     */
+    static void normalizeVec3s(const float* v, float* dst, unsigned int count);
+
+    /**
+     * Computes the dot products of pairs of packed vectors, dst[i] = v1[i] . v2[i].
+     *
+     * @param v1 the first vectors, 3 floats each.
+     * @param v2 the second vectors, 3 floats each.
+     * @param dst receives count dot products.
+     * @param count the number of vector pairs.
+     */
+    static void dotVec3s(const float* v1, const float* v2, float* dst, unsigned int count);
 private:
     //Indicates that if neon is enabled
     static bool isNeon32Enabled();
     static bool isNeon64Enabled();
+    //Indicates that if avx2 and fma are supported by the cpu
+    static bool isAVX2Enabled();
 private:
 #ifdef __SSE__
     static void addMatrix(const __m128 m[4], float scalar, __m128 dst[4]);
@@ -42,6 +42,36 @@ public:
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
+
+    inline static void cullAABBs(const float* centerX, const float* centerY, const float* centerZ,
+                                 const float* extentX, const float* extentY, const float* extentZ,
+                                 unsigned int count, const float* planes, unsigned int planeCount, unsigned char* results);
+
+    inline static void intersectSphereAABBs(float sphereX, float sphereY, float sphereZ, float radius,
+                                            const float* centerX, const float* centerY, const float* centerZ,
+                                            const float* extentX, const float* extentY, const float* extentZ,
+                                            unsigned int count, unsigned char* results);
+
+    inline static void rasterizeDepthSpan(float* depths, unsigned int count, float edge0, float edge1, float edge2,
+                                          float step0, float step1, float step2, float depth);
+
+    inline static bool isDepthSpanOccluded(const float* depths, unsigned int count, float depth);
+
+    inline static void multiplyMatrices(const float* m1, const float* m2, float* dst, unsigned int count);
+
+    inline static void transformPoints(const float* m, const float* points, float* dst, unsigned int count);
+
+    inline static void transformPointsHomogeneous(const float* m, const float* points, float* dst, unsigned int count);
+
+    inline static void multiplyQuaternions(const float* q1, const float* q2, float* dst, unsigned int count);
+
+    inline static void slerpQuaternions(const float* q1, const float* q2, float t, float* dst, unsigned int count);
+
+    inline static void transformVec3sByQuat(const float* q, const float* v, float* dst, unsigned int count);
+
+    inline static void normalizeVec3s(const float* v, float* dst, unsigned int count);
+
+    inline static void dotVec3s(const float* v1, const float* v2, float* dst, unsigned int count);
 };
 
 inline void MathUtilC::addMatrix(const float* m, float scalar, float* dst)
@@ -215,4 +245,163 @@ inline void MathUtilC::crossVec3(const float* v1, const float* v2, float* dst)
     dst[2] = z;
 }
 
+inline void MathUtilC::cullAABBs(const float* centerX, const float* centerY, const float* centerZ,
+                                 const float* extentX, const float* extentY, const float* extentZ,
+                                 unsigned int count, const float* planes, unsigned int planeCount, unsigned char* results)
+{
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        unsigned char inside = 1;
+        for (unsigned int p = 0; p < planeCount && inside; ++p)
+        {
+            const float* plane = planes + p * 4;
+            float dot = plane[0] * centerX[i] + plane[1] * centerY[i] + plane[2] * centerZ[i];
+            float r = extentX[i] * std::abs(plane[0]) + extentY[i] * std::abs(plane[1]) + extentZ[i] * std::abs(plane[2]);
+            if (dot + r < plane[3]) inside = 0;
+        }
+        results[i] = inside;
+    }
+}
+
+inline void MathUtilC::intersectSphereAABBs(float sphereX, float sphereY, float sphereZ, float radius,
+                                            const float* centerX, const float* centerY, const float* centerZ,
+                                            const float* extentX, const float* extentY, const float* extentZ,
+                                            unsigned int count, unsigned char* results)
+{
+    const float radiusSq = radius * radius;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        // distance from the sphere center to the closest point of the box
+        float dx = std::max(std::abs(sphereX - centerX[i]) - extentX[i], 0.0f);
+        float dy = std::max(std::abs(sphereY - centerY[i]) - extentY[i], 0.0f);
+        float dz = std::max(std::abs(sphereZ - centerZ[i]) - extentZ[i], 0.0f);
+        results[i] = dx * dx + dy * dy + dz * dz <= radiusSq ? 1 : 0;
+    }
+}
+
+inline void MathUtilC::rasterizeDepthSpan(float* depths, unsigned int count, float edge0, float edge1, float edge2,
+                                          float step0, float step1, float step2, float depth)
+{
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        if (edge0 >= 0.0f && edge1 >= 0.0f && edge2 >= 0.0f)
+        {
+            depths[i] = std::min(depths[i], depth);
+        }
+        edge0 += step0;
+        edge1 += step1;
+        edge2 += step2;
+    }
+}
+
+inline bool MathUtilC::isDepthSpanOccluded(const float* depths, unsigned int count, float depth)
+{
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        if (depths[i] >= depth) return false;
+    }
+    return true;
+}
+
+inline void MathUtilC::multiplyMatrices(const float* m1, const float* m2, float* dst, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        multiplyMatrix(m1 + i * 16, m2 + i * 16, dst + i * 16);
+    }
+}
+
+inline void MathUtilC::transformPoints(const float* m, const float* points, float* dst, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; ++i, points += 3, dst += 3)
+    {
+        const float x = points[0], y = points[1], z = points[2];
+        dst[0] = x * m[0] + y * m[4] + z * m[8] + m[12];
+        dst[1] = x * m[1] + y * m[5] + z * m[9] + m[13];
+        dst[2] = x * m[2] + y * m[6] + z * m[10] + m[14];
+    }
+}
+
+inline void MathUtilC::transformPointsHomogeneous(const float* m, const float* points, float* dst, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; ++i, points += 3, dst += 4)
+    {
+        const float x = points[0], y = points[1], z = points[2];
+        dst[0] = x * m[0] + y * m[4] + z * m[8] + m[12];
+        dst[1] = x * m[1] + y * m[5] + z * m[9] + m[13];
+        dst[2] = x * m[2] + y * m[6] + z * m[10] + m[14];
+        dst[3] = x * m[3] + y * m[7] + z * m[11] + m[15];
+    }
+}
+
+inline void MathUtilC::multiplyQuaternions(const float* q1, const float* q2, float* dst, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; ++i, q1 += 4, q2 += 4, dst += 4)
+    {
+        const float x = q1[3] * q2[0] + q1[0] * q2[3] + q1[1] * q2[2] - q1[2] * q2[1];
+        const float y = q1[3] * q2[1] - q1[0] * q2[2] + q1[1] * q2[3] + q1[2] * q2[0];
+        const float z = q1[3] * q2[2] + q1[0] * q2[1] - q1[1] * q2[0] + q1[2] * q2[3];
+        const float w = q1[3] * q2[3] - q1[0] * q2[0] - q1[1] * q2[1] - q1[2] * q2[2];
+        dst[0] = x;
+        dst[1] = y;
+        dst[2] = z;
+        dst[3] = w;
+    }
+}
+
+inline void MathUtilC::slerpQuaternions(const float* q1, const float* q2, float t, float* dst, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; ++i, q1 += 4, q2 += 4, dst += 4)
+    {
+        Quaternion result;
+        Quaternion::slerp(Quaternion(q1[0], q1[1], q1[2], q1[3]), Quaternion(q2[0], q2[1], q2[2], q2[3]), t, &result);
+        dst[0] = result.x;
+        dst[1] = result.y;
+        dst[2] = result.z;
+        dst[3] = result.w;
+    }
+}
+
+inline void MathUtilC::transformVec3sByQuat(const float* q, const float* v, float* dst, unsigned int count)
+{
+    const float qx = q[0], qy = q[1], qz = q[2], qw = q[3];
+    for (unsigned int i = 0; i < count; ++i, v += 3, dst += 3)
+    {
+        const float x = v[0], y = v[1], z = v[2];
+
+        // calculate quat * vec
+        const float ix = qw * x + qy * z - qz * y;
+        const float iy = qw * y + qz * x - qx * z;
+        const float iz = qw * z + qx * y - qy * x;
+        const float iw = -qx * x - qy * y - qz * z;
+
+        // calculate result * inverse quat
+        dst[0] = ix * qw + iw * -qx + iy * -qz - iz * -qy;
+        dst[1] = iy * qw + iw * -qy + iz * -qx - ix * -qz;
+        dst[2] = iz * qw + iw * -qz + ix * -qy - iy * -qx;
+    }
+}
+
+inline void MathUtilC::normalizeVec3s(const float* v, float* dst, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; ++i, v += 3, dst += 3)
+    {
+        const float x = v[0], y = v[1], z = v[2];
+        float n = std::sqrt(x * x + y * y + z * z);
+        // Too close to zero, kept as is.
+        n = n < MATH_TOLERANCE ? 1.0f : 1.0f / n;
+        dst[0] = x * n;
+        dst[1] = y * n;
+        dst[2] = z * n;
+    }
+}
+
+inline void MathUtilC::dotVec3s(const float* v1, const float* v2, float* dst, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; ++i, v1 += 3, v2 += 3)
+    {
+        dst[i] = v1[0] * v2[0] + v1[1] * v2[1] + v1[2] * v2[2];
+    }
+}
+
 NS_CC_MATH_END
@@ -0,0 +1,50 @@
+NS_CC_MATH_BEGIN
+
+#ifdef INCLUDE_AVX2
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define CC_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+    #define CC_TARGET_AVX2
+#endif
+
+// Compiled for AVX2 and FMA whatever the target of the build, only called once MathUtil::isAVX2Enabled() is true.
+class MathUtilAVX2
+{
+public:
+    CC_TARGET_AVX2 static void multiplyMatrices(const float* m1, const float* m2, float* dst, unsigned int count);
+};
+
+// Two columns of the product at a time, each lane takes one column of m2.
+CC_TARGET_AVX2 inline void MathUtilAVX2::multiplyMatrices(const float* m1, const float* m2, float* dst, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; ++i, m1 += 16, m2 += 16, dst += 16)
+    {
+        const __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m1));
+        const __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m1 + 4));
+        const __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m1 + 8));
+        const __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m1 + 12));
+        const __m256 b01 = _mm256_loadu_ps(m2);
+        const __m256 b23 = _mm256_loadu_ps(m2 + 8);
+
+        __m256 r01 = _mm256_mul_ps(a0, _mm256_permute_ps(b01, 0x00));
+        r01 = _mm256_fmadd_ps(a1, _mm256_permute_ps(b01, 0x55), r01);
+        r01 = _mm256_fmadd_ps(a2, _mm256_permute_ps(b01, 0xAA), r01);
+        r01 = _mm256_fmadd_ps(a3, _mm256_permute_ps(b01, 0xFF), r01);
+
+        __m256 r23 = _mm256_mul_ps(a0, _mm256_permute_ps(b23, 0x00));
+        r23 = _mm256_fmadd_ps(a1, _mm256_permute_ps(b23, 0x55), r23);
+        r23 = _mm256_fmadd_ps(a2, _mm256_permute_ps(b23, 0xAA), r23);
+        r23 = _mm256_fmadd_ps(a3, _mm256_permute_ps(b23, 0xFF), r23);
+
+        // stored last, dst may be m1 or m2
+        _mm256_storeu_ps(dst, r01);
+        _mm256_storeu_ps(dst + 8, r23);
+    }
+}
+
+#undef CC_TARGET_AVX2
+
+#endif
+
+NS_CC_MATH_END
@@ -42,6 +42,36 @@ public:
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
+
+    inline static void cullAABBs(const float* centerX, const float* centerY, const float* centerZ,
+                                 const float* extentX, const float* extentY, const float* extentZ,
+                                 unsigned int count, const float* planes, unsigned int planeCount, unsigned char* results);
+
+    inline static void intersectSphereAABBs(float sphereX, float sphereY, float sphereZ, float radius,
+                                            const float* centerX, const float* centerY, const float* centerZ,
+                                            const float* extentX, const float* extentY, const float* extentZ,
+                                            unsigned int count, unsigned char* results);
+
+    inline static void rasterizeDepthSpan(float* depths, unsigned int count, float edge0, float edge1, float edge2,
+                                          float step0, float step1, float step2, float depth);
+
+    inline static bool isDepthSpanOccluded(const float* depths, unsigned int count, float depth);
+
+    inline static void multiplyMatrices(const float* m1, const float* m2, float* dst, unsigned int count);
+
+    inline static void transformPoints(const float* m, const float* points, float* dst, unsigned int count);
+
+    inline static void transformPointsHomogeneous(const float* m, const float* points, float* dst, unsigned int count);
+
+    inline static void multiplyQuaternions(const float* q1, const float* q2, float* dst, unsigned int count);
+
+    inline static void slerpQuaternions(const float* q1, const float* q2, float t, float* dst, unsigned int count);
+
+    inline static void transformVec3sByQuat(const float* q, const float* v, float* dst, unsigned int count);
+
+    inline static void normalizeVec3s(const float* v, float* dst, unsigned int count);
+
+    inline static void dotVec3s(const float* v1, const float* v2, float* dst, unsigned int count);
 };
 
 inline void MathUtilNeon64::addMatrix(const float* m, float scalar, float* dst)
@@ -262,4 +292,324 @@ inline void MathUtilNeon64::crossVec3(const float* v1, const float* v2, float* d
     );
 }
 
+inline void MathUtilNeon64::cullAABBs(const float* centerX, const float* centerY, const float* centerZ,
+                                      const float* extentX, const float* extentY, const float* extentZ,
+                                      unsigned int count, const float* planes, unsigned int planeCount, unsigned char* results)
+{
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t cx = vld1q_f32(centerX + i);
+        float32x4_t cy = vld1q_f32(centerY + i);
+        float32x4_t cz = vld1q_f32(centerZ + i);
+        float32x4_t ex = vld1q_f32(extentX + i);
+        float32x4_t ey = vld1q_f32(extentY + i);
+        float32x4_t ez = vld1q_f32(extentZ + i);
+        uint32x4_t inside = vdupq_n_u32(0xffffffff);
+
+        for (unsigned int p = 0; p < planeCount; ++p)
+        {
+            const float* plane = planes + p * 4;
+            float32x4_t dot = vmulq_n_f32(cx, plane[0]);
+            dot = vfmaq_n_f32(dot, cy, plane[1]);
+            dot = vfmaq_n_f32(dot, cz, plane[2]);
+            float32x4_t r = vmulq_n_f32(ex, std::abs(plane[0]));
+            r = vfmaq_n_f32(r, ey, std::abs(plane[1]));
+            r = vfmaq_n_f32(r, ez, std::abs(plane[2]));
+            // box is outside when dot + r < d
+            inside = vandq_u32(inside, vcgeq_f32(vaddq_f32(dot, r), vdupq_n_f32(plane[3])));
+            if (vmaxvq_u32(inside) == 0) break;
+        }
+
+        results[i] = vgetq_lane_u32(inside, 0) ? 1 : 0;
+        results[i + 1] = vgetq_lane_u32(inside, 1) ? 1 : 0;
+        results[i + 2] = vgetq_lane_u32(inside, 2) ? 1 : 0;
+        results[i + 3] = vgetq_lane_u32(inside, 3) ? 1 : 0;
+    }
+
+    if (i < count)
+    {
+        MathUtilC::cullAABBs(centerX + i, centerY + i, centerZ + i, extentX + i, extentY + i, extentZ + i,
+                             count - i, planes, planeCount, results + i);
+    }
+}
+
+inline void MathUtilNeon64::intersectSphereAABBs(float sphereX, float sphereY, float sphereZ, float radius,
+                                                 const float* centerX, const float* centerY, const float* centerZ,
+                                                 const float* extentX, const float* extentY, const float* extentZ,
+                                                 unsigned int count, unsigned char* results)
+{
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t sx = vdupq_n_f32(sphereX);
+    const float32x4_t sy = vdupq_n_f32(sphereY);
+    const float32x4_t sz = vdupq_n_f32(sphereZ);
+    const float32x4_t radiusSq = vdupq_n_f32(radius * radius);
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        // distance from the sphere center to the closest point of the box
+        float32x4_t dx = vmaxq_f32(vsubq_f32(vabdq_f32(sx, vld1q_f32(centerX + i)), vld1q_f32(extentX + i)), zero);
+        float32x4_t dy = vmaxq_f32(vsubq_f32(vabdq_f32(sy, vld1q_f32(centerY + i)), vld1q_f32(extentY + i)), zero);
+        float32x4_t dz = vmaxq_f32(vsubq_f32(vabdq_f32(sz, vld1q_f32(centerZ + i)), vld1q_f32(extentZ + i)), zero);
+        float32x4_t distSq = vmulq_f32(dx, dx);
+        distSq = vfmaq_f32(distSq, dy, dy);
+        distSq = vfmaq_f32(distSq, dz, dz);
+
+        uint32x4_t hit = vcleq_f32(distSq, radiusSq);
+        results[i] = vgetq_lane_u32(hit, 0) ? 1 : 0;
+        results[i + 1] = vgetq_lane_u32(hit, 1) ? 1 : 0;
+        results[i + 2] = vgetq_lane_u32(hit, 2) ? 1 : 0;
+        results[i + 3] = vgetq_lane_u32(hit, 3) ? 1 : 0;
+    }
+
+    if (i < count)
+    {
+        MathUtilC::intersectSphereAABBs(sphereX, sphereY, sphereZ, radius, centerX + i, centerY + i, centerZ + i,
+                                        extentX + i, extentY + i, extentZ + i, count - i, results + i);
+    }
+}
+
+inline void MathUtilNeon64::rasterizeDepthSpan(float* depths, unsigned int count, float edge0, float edge1, float edge2,
+                                               float step0, float step1, float step2, float depth)
+{
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float laneData[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+    const float32x4_t lanes = vld1q_f32(laneData);
+    const float32x4_t d = vdupq_n_f32(depth);
+    float32x4_t e0 = vfmaq_f32(vdupq_n_f32(edge0), vdupq_n_f32(step0), lanes);
+    float32x4_t e1 = vfmaq_f32(vdupq_n_f32(edge1), vdupq_n_f32(step1), lanes);
+    float32x4_t e2 = vfmaq_f32(vdupq_n_f32(edge2), vdupq_n_f32(step2), lanes);
+    const float32x4_t s0 = vdupq_n_f32(step0 * 4.0f);
+    const float32x4_t s1 = vdupq_n_f32(step1 * 4.0f);
+    const float32x4_t s2 = vdupq_n_f32(step2 * 4.0f);
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        uint32x4_t inside = vandq_u32(vandq_u32(vcgeq_f32(e0, zero), vcgeq_f32(e1, zero)), vcgeq_f32(e2, zero));
+        float32x4_t old = vld1q_f32(depths + i);
+        vst1q_f32(depths + i, vbslq_f32(inside, vminq_f32(old, d), old));
+        e0 = vaddq_f32(e0, s0);
+        e1 = vaddq_f32(e1, s1);
+        e2 = vaddq_f32(e2, s2);
+    }
+
+    if (i < count)
+    {
+        MathUtilC::rasterizeDepthSpan(depths + i, count - i, edge0 + step0 * i, edge1 + step1 * i, edge2 + step2 * i,
+                                      step0, step1, step2, depth);
+    }
+}
+
+inline bool MathUtilNeon64::isDepthSpanOccluded(const float* depths, unsigned int count, float depth)
+{
+    const float32x4_t d = vdupq_n_f32(depth);
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        if (vmaxvq_u32(vcgeq_f32(vld1q_f32(depths + i), d))) return false;
+    }
+
+    return MathUtilC::isDepthSpanOccluded(depths + i, count - i, depth);
+}
+
+inline void MathUtilNeon64::multiplyMatrices(const float* m1, const float* m2, float* dst, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; ++i, m1 += 16, m2 += 16, dst += 16)
+    {
+        const float32x4_t a0 = vld1q_f32(m1), a1 = vld1q_f32(m1 + 4), a2 = vld1q_f32(m1 + 8), a3 = vld1q_f32(m1 + 12);
+        float32x4_t product[4];
+        for (int j = 0; j < 4; ++j)
+        {
+            const float32x4_t b = vld1q_f32(m2 + j * 4);
+            float32x4_t r = vmulq_laneq_f32(a0, b, 0);
+            r = vfmaq_laneq_f32(r, a1, b, 1);
+            r = vfmaq_laneq_f32(r, a2, b, 2);
+            product[j] = vfmaq_laneq_f32(r, a3, b, 3);
+        }
+        // stored last, dst may be m1 or m2
+        for (int j = 0; j < 4; ++j) vst1q_f32(dst + j * 4, product[j]);
+    }
+}
+
+// Four points at a time, ld3 and st3 deinterleave and interleave the xyz.
+inline void MathUtilNeon64::transformPoints(const float* m, const float* points, float* dst, unsigned int count)
+{
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4, points += 12, dst += 12)
+    {
+        const float32x4x3_t p = vld3q_f32(points);
+        float32x4x3_t r;
+        for (int k = 0; k < 3; ++k)
+        {
+            float32x4_t v = vfmaq_n_f32(vdupq_n_f32(m[12 + k]), p.val[0], m[k]);
+            v = vfmaq_n_f32(v, p.val[1], m[4 + k]);
+            r.val[k] = vfmaq_n_f32(v, p.val[2], m[8 + k]);
+        }
+        vst3q_f32(dst, r);
+    }
+
+    MathUtilC::transformPoints(m, points, dst, count - i);
+}
+
+inline void MathUtilNeon64::transformPointsHomogeneous(const float* m, const float* points, float* dst, unsigned int count)
+{
+    const float32x4_t col0 = vld1q_f32(m), col1 = vld1q_f32(m + 4), col2 = vld1q_f32(m + 8), col3 = vld1q_f32(m + 12);
+    for (unsigned int i = 0; i < count; ++i, points += 3, dst += 4)
+    {
+        float32x4_t r = vfmaq_n_f32(col3, col0, points[0]);
+        r = vfmaq_n_f32(r, col1, points[1]);
+        vst1q_f32(dst, vfmaq_n_f32(r, col2, points[2]));
+    }
+}
+
+// Four quaternions at a time, ld4 and st4 transpose them into lanes of x, y, z and w.
+inline void MathUtilNeon64::multiplyQuaternions(const float* q1, const float* q2, float* dst, unsigned int count)
+{
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4, q1 += 16, q2 += 16, dst += 16)
+    {
+        const float32x4x4_t a = vld4q_f32(q1);
+        const float32x4x4_t b = vld4q_f32(q2);
+        const float32x4_t x1 = a.val[0], y1 = a.val[1], z1 = a.val[2], w1 = a.val[3];
+        const float32x4_t x2 = b.val[0], y2 = b.val[1], z2 = b.val[2], w2 = b.val[3];
+
+        float32x4x4_t r;
+        r.val[0] = vfmsq_f32(vfmaq_f32(vfmaq_f32(vmulq_f32(w1, x2), x1, w2), y1, z2), z1, y2);
+        r.val[1] = vfmaq_f32(vfmaq_f32(vfmsq_f32(vmulq_f32(w1, y2), x1, z2), y1, w2), z1, x2);
+        r.val[2] = vfmaq_f32(vfmsq_f32(vfmaq_f32(vmulq_f32(w1, z2), x1, y2), y1, x2), z1, w2);
+        r.val[3] = vfmsq_f32(vfmsq_f32(vfmsq_f32(vmulq_f32(w1, w2), x1, x2), y1, y2), z1, z2);
+        vst4q_f32(dst, r);
+    }
+
+    MathUtilC::multiplyQuaternions(q1, q2, dst, count - i);
+}
+
+// The fast slerp of Quaternion::slerp over four quaternions at a time, the folding of t is shared by all of them.
+inline void MathUtilNeon64::slerpQuaternions(const float* q1, const float* q2, float t, float* dst, unsigned int count)
+{
+    if (t == 0.0f || t == 1.0f)
+    {
+        MathUtilC::slerpQuaternions(q1, q2, t, dst, count);
+        return;
+    }
+
+    float f2b = t - 0.5f;
+    float u = f2b >= 0 ? f2b : -f2b;
+    const float f2a = u - f2b;
+    f2b += u;
+    u += u;
+    const float f1 = 1.0f - u;
+    const float sqNotU = f1 * f1;
+    const float sqU = u * u;
+
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4, q1 += 16, q2 += 16, dst += 16)
+    {
+        const float32x4x4_t a = vld4q_f32(q1);
+        const float32x4x4_t b = vld4q_f32(q2);
+
+        float32x4_t cosTheta = vmulq_f32(a.val[3], b.val[3]);
+        for (int k = 0; k < 3; ++k) cosTheta = vfmaq_f32(cosTheta, a.val[k], b.val[k]);
+        // fold theta, -1 where cosTheta < 0
+        float32x4_t alpha = vbslq_f32(vcltzq_f32(cosTheta), vdupq_n_f32(-1.0f), one);
+        const float32x4_t halfY = vfmaq_f32(one, alpha, cosTheta);
+
+        // one iteration of Newton to get 1-cos(theta / 2)
+        float32x4_t halfSecHalfTheta = vfmsq_f32(vdupq_n_f32(1.09f), vfmsq_f32(vdupq_n_f32(0.476537f), halfY, vdupq_n_f32(0.0903321f)), halfY);
+        halfSecHalfTheta = vmulq_f32(halfSecHalfTheta, vfmsq_f32(vdupq_n_f32(1.5f), vmulq_f32(halfY, halfSecHalfTheta), halfSecHalfTheta));
+        const float32x4_t versHalfTheta = vfmsq_f32(one, halfY, halfSecHalfTheta);
+
+        // series expansions of the coefficients
+        float32x4_t ratio2 = vmulq_n_f32(versHalfTheta, 0.0000440917108f);
+        float32x4_t ratio1 = vfmaq_n_f32(vdupq_n_f32(-0.00158730159f), ratio2, sqNotU - 16.0f);
+        ratio1 = vfmaq_f32(vdupq_n_f32(0.0333333333f), vmulq_n_f32(ratio1, sqNotU - 9.0f), versHalfTheta);
+        ratio1 = vfmaq_f32(vdupq_n_f32(-0.333333333f), vmulq_n_f32(ratio1, sqNotU - 4.0f), versHalfTheta);
+        ratio1 = vfmaq_f32(one, vmulq_n_f32(ratio1, sqNotU - 1.0f), versHalfTheta);
+
+        ratio2 = vfmaq_n_f32(vdupq_n_f32(-0.00158730159f), ratio2, sqU - 16.0f);
+        ratio2 = vfmaq_f32(vdupq_n_f32(0.0333333333f), vmulq_n_f32(ratio2, sqU - 9.0f), versHalfTheta);
+        ratio2 = vfmaq_f32(vdupq_n_f32(-0.333333333f), vmulq_n_f32(ratio2, sqU - 4.0f), versHalfTheta);
+        ratio2 = vfmaq_f32(one, vmulq_n_f32(ratio2, sqU - 1.0f), versHalfTheta);
+
+        const float32x4_t bf1 = vmulq_n_f32(vmulq_f32(ratio1, halfSecHalfTheta), f1);
+        alpha = vmulq_f32(alpha, vfmaq_n_f32(bf1, ratio2, f2a));
+        const float32x4_t beta = vfmaq_n_f32(bf1, ratio2, f2b);
+
+        float32x4x4_t r;
+        float32x4_t lengthSq = vdupq_n_f32(0.0f);
+        for (int k = 0; k < 4; ++k)
+        {
+            r.val[k] = vfmaq_f32(vmulq_f32(alpha, a.val[k]), beta, b.val[k]);
+            lengthSq = vfmaq_f32(lengthSq, r.val[k], r.val[k]);
+        }
+
+        // correct the small constraint errors of the inputs, equal quaternions are returned as they are
+        const float32x4_t correction = vfmsq_f32(vdupq_n_f32(1.5f), lengthSq, vdupq_n_f32(0.5f));
+        const uint32x4_t equal = vandq_u32(vandq_u32(vceqq_f32(a.val[0], b.val[0]), vceqq_f32(a.val[1], b.val[1])),
+                                           vandq_u32(vceqq_f32(a.val[2], b.val[2]), vceqq_f32(a.val[3], b.val[3])));
+        for (int k = 0; k < 4; ++k) r.val[k] = vbslq_f32(equal, a.val[k], vmulq_f32(r.val[k], correction));
+        vst4q_f32(dst, r);
+    }
+
+    MathUtilC::slerpQuaternions(q1, q2, t, dst, count - i);
+}
+
+inline void MathUtilNeon64::transformVec3sByQuat(const float* q, const float* v, float* dst, unsigned int count)
+{
+    const float32x4_t qx = vdupq_n_f32(q[0]), qy = vdupq_n_f32(q[1]), qz = vdupq_n_f32(q[2]), qw = vdupq_n_f32(q[3]);
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4, v += 12, dst += 12)
+    {
+        const float32x4x3_t p = vld3q_f32(v);
+        const float32x4_t x = p.val[0], y = p.val[1], z = p.val[2];
+
+        // quat * vec
+        const float32x4_t ix = vfmsq_f32(vfmaq_f32(vmulq_f32(qw, x), qy, z), qz, y);
+        const float32x4_t iy = vfmsq_f32(vfmaq_f32(vmulq_f32(qw, y), qz, x), qx, z);
+        const float32x4_t iz = vfmsq_f32(vfmaq_f32(vmulq_f32(qw, z), qx, y), qy, x);
+        const float32x4_t iw = vfmaq_f32(vfmaq_f32(vmulq_f32(qx, x), qy, y), qz, z); // negated
+
+        // result * inverse quat
+        float32x4x3_t r;
+        r.val[0] = vfmaq_f32(vfmsq_f32(vfmaq_f32(vmulq_f32(ix, qw), iw, qx), iy, qz), iz, qy);
+        r.val[1] = vfmaq_f32(vfmsq_f32(vfmaq_f32(vmulq_f32(iy, qw), iw, qy), iz, qx), ix, qz);
+        r.val[2] = vfmaq_f32(vfmsq_f32(vfmaq_f32(vmulq_f32(iz, qw), iw, qz), ix, qy), iy, qx);
+        vst3q_f32(dst, r);
+    }
+
+    MathUtilC::transformVec3sByQuat(q, v, dst, count - i);
+}
+
+inline void MathUtilNeon64::normalizeVec3s(const float* v, float* dst, unsigned int count)
+{
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t tolerance = vdupq_n_f32(MATH_TOLERANCE);
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4, v += 12, dst += 12)
+    {
+        float32x4x3_t p = vld3q_f32(v);
+        const float32x4_t n = vsqrtq_f32(vfmaq_f32(vfmaq_f32(vmulq_f32(p.val[0], p.val[0]), p.val[1], p.val[1]), p.val[2], p.val[2]));
+        // too close to zero, kept as is
+        const float32x4_t scale = vbslq_f32(vcltq_f32(n, tolerance), one, vdivq_f32(one, n));
+        for (int k = 0; k < 3; ++k) p.val[k] = vmulq_f32(p.val[k], scale);
+        vst3q_f32(dst, p);
+    }
+
+    MathUtilC::normalizeVec3s(v, dst, count - i);
+}
+
+inline void MathUtilNeon64::dotVec3s(const float* v1, const float* v2, float* dst, unsigned int count)
+{
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4, v1 += 12, v2 += 12)
+    {
+        const float32x4x3_t a = vld3q_f32(v1);
+        const float32x4x3_t b = vld3q_f32(v2);
+        vst1q_f32(dst + i, vfmaq_f32(vfmaq_f32(vmulq_f32(a.val[0], b.val[0]), a.val[1], b.val[1]), a.val[2], b.val[2]));
+    }
+
+    MathUtilC::dotVec3s(v1, v2, dst + i, count - i);
+}
+
 NS_CC_MATH_END
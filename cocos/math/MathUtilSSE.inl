@@ -151,6 +151,414 @@ void MathUtil::transformVec4(const __m128 m[4], const __m128& v, __m128& dst)
                      );
 }
 
+class MathUtilSSE
+{
+public:
+    inline static void cullAABBs(const float* centerX, const float* centerY, const float* centerZ,
+                                 const float* extentX, const float* extentY, const float* extentZ,
+                                 unsigned int count, const float* planes, unsigned int planeCount, unsigned char* results);
+
+    inline static void intersectSphereAABBs(float sphereX, float sphereY, float sphereZ, float radius,
+                                            const float* centerX, const float* centerY, const float* centerZ,
+                                            const float* extentX, const float* extentY, const float* extentZ,
+                                            unsigned int count, unsigned char* results);
+
+    inline static void rasterizeDepthSpan(float* depths, unsigned int count, float edge0, float edge1, float edge2,
+                                          float step0, float step1, float step2, float depth);
+
+    inline static bool isDepthSpanOccluded(const float* depths, unsigned int count, float depth);
+
+    inline static void multiplyMatrices(const float* m1, const float* m2, float* dst, unsigned int count);
+
+    inline static void transformPoints(const float* m, const float* points, float* dst, unsigned int count);
+
+    inline static void transformPointsHomogeneous(const float* m, const float* points, float* dst, unsigned int count);
+
+    inline static void multiplyQuaternions(const float* q1, const float* q2, float* dst, unsigned int count);
+
+    inline static void slerpQuaternions(const float* q1, const float* q2, float t, float* dst, unsigned int count);
+
+    inline static void transformVec3sByQuat(const float* q, const float* v, float* dst, unsigned int count);
+
+    inline static void normalizeVec3s(const float* v, float* dst, unsigned int count);
+
+    inline static void dotVec3s(const float* v1, const float* v2, float* dst, unsigned int count);
+
+private:
+    // deinterleaves four packed xyz into lanes of x, y and z, and back
+    inline static void loadVec3s(const float* v, __m128& x, __m128& y, __m128& z);
+
+    inline static void storeVec3s(float* v, const __m128& x, const __m128& y, const __m128& z);
+};
+
+inline void MathUtilSSE::cullAABBs(const float* centerX, const float* centerY, const float* centerZ,
+                                   const float* extentX, const float* extentY, const float* extentZ,
+                                   unsigned int count, const float* planes, unsigned int planeCount, unsigned char* results)
+{
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 cx = _mm_loadu_ps(centerX + i);
+        __m128 cy = _mm_loadu_ps(centerY + i);
+        __m128 cz = _mm_loadu_ps(centerZ + i);
+        __m128 ex = _mm_loadu_ps(extentX + i);
+        __m128 ey = _mm_loadu_ps(extentY + i);
+        __m128 ez = _mm_loadu_ps(extentZ + i);
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+        for (unsigned int p = 0; p < planeCount; ++p)
+        {
+            const float* plane = planes + p * 4;
+            __m128 nx = _mm_set1_ps(plane[0]);
+            __m128 ny = _mm_set1_ps(plane[1]);
+            __m128 nz = _mm_set1_ps(plane[2]);
+            __m128 d = _mm_set1_ps(plane[3]);
+
+            __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)), _mm_mul_ps(nz, cz));
+            __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, nx), ex),
+                                             _mm_mul_ps(_mm_andnot_ps(signMask, ny), ey)),
+                                  _mm_mul_ps(_mm_andnot_ps(signMask, nz), ez));
+            // box is outside when dot + r < d
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(dot, r), d));
+            if (_mm_movemask_ps(inside) == 0) break;
+        }
+
+        int mask = _mm_movemask_ps(inside);
+        results[i] = (mask & 1) ? 1 : 0;
+        results[i + 1] = (mask & 2) ? 1 : 0;
+        results[i + 2] = (mask & 4) ? 1 : 0;
+        results[i + 3] = (mask & 8) ? 1 : 0;
+    }
+
+    if (i < count)
+    {
+        MathUtilC::cullAABBs(centerX + i, centerY + i, centerZ + i, extentX + i, extentY + i, extentZ + i,
+                             count - i, planes, planeCount, results + i);
+    }
+}
+
+inline void MathUtilSSE::intersectSphereAABBs(float sphereX, float sphereY, float sphereZ, float radius,
+                                              const float* centerX, const float* centerY, const float* centerZ,
+                                              const float* extentX, const float* extentY, const float* extentZ,
+                                              unsigned int count, unsigned char* results)
+{
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 sx = _mm_set1_ps(sphereX);
+    const __m128 sy = _mm_set1_ps(sphereY);
+    const __m128 sz = _mm_set1_ps(sphereZ);
+    const __m128 radiusSq = _mm_set1_ps(radius * radius);
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        // distance from the sphere center to the closest point of the box
+        __m128 dx = _mm_max_ps(_mm_sub_ps(_mm_andnot_ps(signMask, _mm_sub_ps(sx, _mm_loadu_ps(centerX + i))), _mm_loadu_ps(extentX + i)), zero);
+        __m128 dy = _mm_max_ps(_mm_sub_ps(_mm_andnot_ps(signMask, _mm_sub_ps(sy, _mm_loadu_ps(centerY + i))), _mm_loadu_ps(extentY + i)), zero);
+        __m128 dz = _mm_max_ps(_mm_sub_ps(_mm_andnot_ps(signMask, _mm_sub_ps(sz, _mm_loadu_ps(centerZ + i))), _mm_loadu_ps(extentZ + i)), zero);
+        __m128 distSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+        int mask = _mm_movemask_ps(_mm_cmple_ps(distSq, radiusSq));
+        results[i] = (mask & 1) ? 1 : 0;
+        results[i + 1] = (mask & 2) ? 1 : 0;
+        results[i + 2] = (mask & 4) ? 1 : 0;
+        results[i + 3] = (mask & 8) ? 1 : 0;
+    }
+
+    if (i < count)
+    {
+        MathUtilC::intersectSphereAABBs(sphereX, sphereY, sphereZ, radius, centerX + i, centerY + i, centerZ + i,
+                                        extentX + i, extentY + i, extentZ + i, count - i, results + i);
+    }
+}
+
+inline void MathUtilSSE::rasterizeDepthSpan(float* depths, unsigned int count, float edge0, float edge1, float edge2,
+                                            float step0, float step1, float step2, float depth)
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 lanes = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+    const __m128 d = _mm_set1_ps(depth);
+    __m128 e0 = _mm_add_ps(_mm_set1_ps(edge0), _mm_mul_ps(_mm_set1_ps(step0), lanes));
+    __m128 e1 = _mm_add_ps(_mm_set1_ps(edge1), _mm_mul_ps(_mm_set1_ps(step1), lanes));
+    __m128 e2 = _mm_add_ps(_mm_set1_ps(edge2), _mm_mul_ps(_mm_set1_ps(step2), lanes));
+    const __m128 s0 = _mm_set1_ps(step0 * 4.0f);
+    const __m128 s1 = _mm_set1_ps(step1 * 4.0f);
+    const __m128 s2 = _mm_set1_ps(step2 * 4.0f);
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+        __m128 old = _mm_loadu_ps(depths + i);
+        _mm_storeu_ps(depths + i, _mm_or_ps(_mm_and_ps(inside, _mm_min_ps(old, d)), _mm_andnot_ps(inside, old)));
+        e0 = _mm_add_ps(e0, s0);
+        e1 = _mm_add_ps(e1, s1);
+        e2 = _mm_add_ps(e2, s2);
+    }
+
+    if (i < count)
+    {
+        MathUtilC::rasterizeDepthSpan(depths + i, count - i, edge0 + step0 * i, edge1 + step1 * i, edge2 + step2 * i,
+                                      step0, step1, step2, depth);
+    }
+}
+
+inline bool MathUtilSSE::isDepthSpanOccluded(const float* depths, unsigned int count, float depth)
+{
+    const __m128 d = _mm_set1_ps(depth);
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        if (_mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(depths + i), d))) return false;
+    }
+
+    return MathUtilC::isDepthSpanOccluded(depths + i, count - i, depth);
+}
+
+inline void MathUtilSSE::multiplyMatrices(const float* m1, const float* m2, float* dst, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; ++i, m1 += 16, m2 += 16, dst += 16)
+    {
+        const __m128 a0 = _mm_loadu_ps(m1), a1 = _mm_loadu_ps(m1 + 4), a2 = _mm_loadu_ps(m1 + 8), a3 = _mm_loadu_ps(m1 + 12);
+        __m128 product[4];
+        for (int j = 0; j < 4; ++j)
+        {
+            const __m128 b = _mm_loadu_ps(m2 + j * 4);
+            product[j] = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(a0, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 0, 0, 0))), _mm_mul_ps(a1, _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 1, 1, 1)))),
+                _mm_add_ps(_mm_mul_ps(a2, _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 2, 2, 2))), _mm_mul_ps(a3, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 3, 3)))));
+        }
+        // stored last, dst may be m1 or m2
+        for (int j = 0; j < 4; ++j) _mm_storeu_ps(dst + j * 4, product[j]);
+    }
+}
+
+// Four points at a time, deinterleaved from xyz into x, y and z vectors and interleaved back.
+inline void MathUtilSSE::transformPoints(const float* m, const float* points, float* dst, unsigned int count)
+{
+    const __m128 m0 = _mm_set1_ps(m[0]), m1 = _mm_set1_ps(m[1]), m2 = _mm_set1_ps(m[2]);
+    const __m128 m4 = _mm_set1_ps(m[4]), m5 = _mm_set1_ps(m[5]), m6 = _mm_set1_ps(m[6]);
+    const __m128 m8 = _mm_set1_ps(m[8]), m9 = _mm_set1_ps(m[9]), m10 = _mm_set1_ps(m[10]);
+    const __m128 m12 = _mm_set1_ps(m[12]), m13 = _mm_set1_ps(m[13]), m14 = _mm_set1_ps(m[14]);
+
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4, points += 12, dst += 12)
+    {
+        __m128 x, y, z;
+        loadVec3s(points, x, y, z);
+
+        const __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m0), _mm_mul_ps(y, m4)), _mm_add_ps(_mm_mul_ps(z, m8), m12));
+        const __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m1), _mm_mul_ps(y, m5)), _mm_add_ps(_mm_mul_ps(z, m9), m13));
+        const __m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m2), _mm_mul_ps(y, m6)), _mm_add_ps(_mm_mul_ps(z, m10), m14));
+
+        storeVec3s(dst, rx, ry, rz);
+    }
+
+    MathUtilC::transformPoints(m, points, dst, count - i);
+}
+
+inline void MathUtilSSE::transformPointsHomogeneous(const float* m, const float* points, float* dst, unsigned int count)
+{
+    const __m128 col0 = _mm_loadu_ps(m), col1 = _mm_loadu_ps(m + 4), col2 = _mm_loadu_ps(m + 8), col3 = _mm_loadu_ps(m + 12);
+    for (unsigned int i = 0; i < count; ++i, points += 3, dst += 4)
+    {
+        const __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(col0, _mm_set1_ps(points[0])), _mm_mul_ps(col1, _mm_set1_ps(points[1]))),
+                                    _mm_add_ps(_mm_mul_ps(col2, _mm_set1_ps(points[2])), col3));
+        _mm_storeu_ps(dst, r);
+    }
+}
+
+inline void MathUtilSSE::loadVec3s(const float* v, __m128& x, __m128& y, __m128& z)
+{
+    const __m128 a = _mm_loadu_ps(v);     // x0 y0 z0 x1
+    const __m128 b = _mm_loadu_ps(v + 4); // y1 z1 x2 y2
+    const __m128 c = _mm_loadu_ps(v + 8); // z2 x3 y3 z3
+    x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 1, 0, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+    y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 0, 0, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 0, 0, 3)), _MM_SHUFFLE(3, 0, 2, 0));
+    z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 0, 2)), c, _MM_SHUFFLE(3, 0, 3, 0));
+}
+
+inline void MathUtilSSE::storeVec3s(float* v, const __m128& x, const __m128& y, const __m128& z)
+{
+    _mm_storeu_ps(v, _mm_shuffle_ps(_mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 1, 0)), _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(v + 4, _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(v + 8, _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+// Four quaternions at a time, transposed into lanes of x, y, z and w.
+inline void MathUtilSSE::multiplyQuaternions(const float* q1, const float* q2, float* dst, unsigned int count)
+{
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4, q1 += 16, q2 += 16, dst += 16)
+    {
+        __m128 x1 = _mm_loadu_ps(q1), y1 = _mm_loadu_ps(q1 + 4), z1 = _mm_loadu_ps(q1 + 8), w1 = _mm_loadu_ps(q1 + 12);
+        __m128 x2 = _mm_loadu_ps(q2), y2 = _mm_loadu_ps(q2 + 4), z2 = _mm_loadu_ps(q2 + 8), w2 = _mm_loadu_ps(q2 + 12);
+        _MM_TRANSPOSE4_PS(x1, y1, z1, w1);
+        _MM_TRANSPOSE4_PS(x2, y2, z2, w2);
+
+        __m128 x = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(w1, x2), _mm_mul_ps(x1, w2)), _mm_mul_ps(y1, z2)), _mm_mul_ps(z1, y2));
+        __m128 y = _mm_add_ps(_mm_add_ps(_mm_sub_ps(_mm_mul_ps(w1, y2), _mm_mul_ps(x1, z2)), _mm_mul_ps(y1, w2)), _mm_mul_ps(z1, x2));
+        __m128 z = _mm_add_ps(_mm_sub_ps(_mm_add_ps(_mm_mul_ps(w1, z2), _mm_mul_ps(x1, y2)), _mm_mul_ps(y1, x2)), _mm_mul_ps(z1, w2));
+        __m128 w = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_mul_ps(w1, w2), _mm_mul_ps(x1, x2)), _mm_mul_ps(y1, y2)), _mm_mul_ps(z1, z2));
+
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        _mm_storeu_ps(dst, x);
+        _mm_storeu_ps(dst + 4, y);
+        _mm_storeu_ps(dst + 8, z);
+        _mm_storeu_ps(dst + 12, w);
+    }
+
+    MathUtilC::multiplyQuaternions(q1, q2, dst, count - i);
+}
+
+// The fast slerp of Quaternion::slerp over four quaternions at a time, the folding of t is shared by all of them.
+inline void MathUtilSSE::slerpQuaternions(const float* q1, const float* q2, float t, float* dst, unsigned int count)
+{
+    if (t == 0.0f || t == 1.0f)
+    {
+        MathUtilC::slerpQuaternions(q1, q2, t, dst, count);
+        return;
+    }
+
+    float f2b = t - 0.5f;
+    float u = f2b >= 0 ? f2b : -f2b;
+    const float f2a = u - f2b;
+    f2b += u;
+    u += u;
+    const float f1 = 1.0f - u;
+    const float sqNotU = f1 * f1;
+    const float sqU = u * u;
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 vf1 = _mm_set1_ps(f1), vf2a = _mm_set1_ps(f2a), vf2b = _mm_set1_ps(f2b);
+    const __m128 notU16 = _mm_set1_ps(sqNotU - 16.0f), notU9 = _mm_set1_ps(sqNotU - 9.0f);
+    const __m128 notU4 = _mm_set1_ps(sqNotU - 4.0f), notU1 = _mm_set1_ps(sqNotU - 1.0f);
+    const __m128 u16 = _mm_set1_ps(sqU - 16.0f), u9 = _mm_set1_ps(sqU - 9.0f), u4 = _mm_set1_ps(sqU - 4.0f), u1 = _mm_set1_ps(sqU - 1.0f);
+    const __m128 c0 = _mm_set1_ps(0.0000440917108f), c1 = _mm_set1_ps(-0.00158730159f);
+    const __m128 c2 = _mm_set1_ps(0.0333333333f), c3 = _mm_set1_ps(-0.333333333f);
+
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4, q1 += 16, q2 += 16, dst += 16)
+    {
+        __m128 x1 = _mm_loadu_ps(q1), y1 = _mm_loadu_ps(q1 + 4), z1 = _mm_loadu_ps(q1 + 8), w1 = _mm_loadu_ps(q1 + 12);
+        __m128 x2 = _mm_loadu_ps(q2), y2 = _mm_loadu_ps(q2 + 4), z2 = _mm_loadu_ps(q2 + 8), w2 = _mm_loadu_ps(q2 + 12);
+        _MM_TRANSPOSE4_PS(x1, y1, z1, w1);
+        _MM_TRANSPOSE4_PS(x2, y2, z2, w2);
+
+        const __m128 cosTheta = _mm_add_ps(_mm_add_ps(_mm_mul_ps(w1, w2), _mm_mul_ps(x1, x2)), _mm_add_ps(_mm_mul_ps(y1, y2), _mm_mul_ps(z1, z2)));
+        // fold theta, -1 where cosTheta < 0
+        __m128 alpha = _mm_or_ps(_mm_and_ps(_mm_cmplt_ps(cosTheta, zero), signMask), one);
+        const __m128 halfY = _mm_add_ps(one, _mm_mul_ps(alpha, cosTheta));
+
+        // one iteration of Newton to get 1-cos(theta / 2)
+        __m128 halfSecHalfTheta = _mm_sub_ps(_mm_set1_ps(1.09f), _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(0.476537f), _mm_mul_ps(_mm_set1_ps(0.0903321f), halfY)), halfY));
+        halfSecHalfTheta = _mm_mul_ps(halfSecHalfTheta, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(_mm_mul_ps(halfY, halfSecHalfTheta), halfSecHalfTheta)));
+        const __m128 versHalfTheta = _mm_sub_ps(one, _mm_mul_ps(halfY, halfSecHalfTheta));
+
+        // series expansions of the coefficients
+        __m128 ratio2 = _mm_mul_ps(c0, versHalfTheta);
+        __m128 ratio1 = _mm_add_ps(c1, _mm_mul_ps(notU16, ratio2));
+        ratio1 = _mm_add_ps(c2, _mm_mul_ps(_mm_mul_ps(ratio1, notU9), versHalfTheta));
+        ratio1 = _mm_add_ps(c3, _mm_mul_ps(_mm_mul_ps(ratio1, notU4), versHalfTheta));
+        ratio1 = _mm_add_ps(one, _mm_mul_ps(_mm_mul_ps(ratio1, notU1), versHalfTheta));
+
+        ratio2 = _mm_add_ps(c1, _mm_mul_ps(u16, ratio2));
+        ratio2 = _mm_add_ps(c2, _mm_mul_ps(_mm_mul_ps(ratio2, u9), versHalfTheta));
+        ratio2 = _mm_add_ps(c3, _mm_mul_ps(_mm_mul_ps(ratio2, u4), versHalfTheta));
+        ratio2 = _mm_add_ps(one, _mm_mul_ps(_mm_mul_ps(ratio2, u1), versHalfTheta));
+
+        const __m128 bf1 = _mm_mul_ps(vf1, _mm_mul_ps(ratio1, halfSecHalfTheta));
+        alpha = _mm_mul_ps(alpha, _mm_add_ps(bf1, _mm_mul_ps(vf2a, ratio2)));
+        const __m128 beta = _mm_add_ps(bf1, _mm_mul_ps(vf2b, ratio2));
+
+        __m128 x = _mm_add_ps(_mm_mul_ps(alpha, x1), _mm_mul_ps(beta, x2));
+        __m128 y = _mm_add_ps(_mm_mul_ps(alpha, y1), _mm_mul_ps(beta, y2));
+        __m128 z = _mm_add_ps(_mm_mul_ps(alpha, z1), _mm_mul_ps(beta, z2));
+        __m128 w = _mm_add_ps(_mm_mul_ps(alpha, w1), _mm_mul_ps(beta, w2));
+
+        // correct the small constraint errors of the inputs
+        const __m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(w, w), _mm_mul_ps(x, x)), _mm_add_ps(_mm_mul_ps(y, y), _mm_mul_ps(z, z)));
+        const __m128 correction = _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(_mm_set1_ps(0.5f), lengthSq));
+
+        // equal quaternions are returned as they are
+        const __m128 equal = _mm_and_ps(_mm_and_ps(_mm_cmpeq_ps(x1, x2), _mm_cmpeq_ps(y1, y2)), _mm_and_ps(_mm_cmpeq_ps(z1, z2), _mm_cmpeq_ps(w1, w2)));
+        x = _mm_or_ps(_mm_and_ps(equal, x1), _mm_andnot_ps(equal, _mm_mul_ps(x, correction)));
+        y = _mm_or_ps(_mm_and_ps(equal, y1), _mm_andnot_ps(equal, _mm_mul_ps(y, correction)));
+        z = _mm_or_ps(_mm_and_ps(equal, z1), _mm_andnot_ps(equal, _mm_mul_ps(z, correction)));
+        w = _mm_or_ps(_mm_and_ps(equal, w1), _mm_andnot_ps(equal, _mm_mul_ps(w, correction)));
+
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        _mm_storeu_ps(dst, x);
+        _mm_storeu_ps(dst + 4, y);
+        _mm_storeu_ps(dst + 8, z);
+        _mm_storeu_ps(dst + 12, w);
+    }
+
+    MathUtilC::slerpQuaternions(q1, q2, t, dst, count - i);
+}
+
+inline void MathUtilSSE::transformVec3sByQuat(const float* q, const float* v, float* dst, unsigned int count)
+{
+    const __m128 qx = _mm_set1_ps(q[0]), qy = _mm_set1_ps(q[1]), qz = _mm_set1_ps(q[2]), qw = _mm_set1_ps(q[3]);
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4, v += 12, dst += 12)
+    {
+        __m128 x, y, z;
+        loadVec3s(v, x, y, z);
+
+        // quat * vec
+        const __m128 ix = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(qw, x), _mm_mul_ps(qy, z)), _mm_mul_ps(qz, y));
+        const __m128 iy = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(qw, y), _mm_mul_ps(qz, x)), _mm_mul_ps(qx, z));
+        const __m128 iz = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(qw, z), _mm_mul_ps(qx, y)), _mm_mul_ps(qy, x));
+        const __m128 iw = _mm_add_ps(_mm_add_ps(_mm_mul_ps(qx, x), _mm_mul_ps(qy, y)), _mm_mul_ps(qz, z)); // negated
+
+        // result * inverse quat
+        const __m128 rx = _mm_add_ps(_mm_sub_ps(_mm_add_ps(_mm_mul_ps(ix, qw), _mm_mul_ps(iw, qx)), _mm_mul_ps(iy, qz)), _mm_mul_ps(iz, qy));
+        const __m128 ry = _mm_add_ps(_mm_sub_ps(_mm_add_ps(_mm_mul_ps(iy, qw), _mm_mul_ps(iw, qy)), _mm_mul_ps(iz, qx)), _mm_mul_ps(ix, qz));
+        const __m128 rz = _mm_add_ps(_mm_sub_ps(_mm_add_ps(_mm_mul_ps(iz, qw), _mm_mul_ps(iw, qz)), _mm_mul_ps(ix, qy)), _mm_mul_ps(iy, qx));
+
+        storeVec3s(dst, rx, ry, rz);
+    }
+
+    MathUtilC::transformVec3sByQuat(q, v, dst, count - i);
+}
+
+inline void MathUtilSSE::normalizeVec3s(const float* v, float* dst, unsigned int count)
+{
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 tolerance = _mm_set1_ps(MATH_TOLERANCE);
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4, v += 12, dst += 12)
+    {
+        __m128 x, y, z;
+        loadVec3s(v, x, y, z);
+
+        const __m128 n = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+        // too close to zero, kept as is
+        const __m128 small = _mm_cmplt_ps(n, tolerance);
+        const __m128 scale = _mm_or_ps(_mm_and_ps(small, one), _mm_andnot_ps(small, _mm_div_ps(one, n)));
+
+        storeVec3s(dst, _mm_mul_ps(x, scale), _mm_mul_ps(y, scale), _mm_mul_ps(z, scale));
+    }
+
+    MathUtilC::normalizeVec3s(v, dst, count - i);
+}
+
+inline void MathUtilSSE::dotVec3s(const float* v1, const float* v2, float* dst, unsigned int count)
+{
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4, v1 += 12, v2 += 12)
+    {
+        __m128 x1, y1, z1, x2, y2, z2;
+        loadVec3s(v1, x1, y1, z1);
+        loadVec3s(v2, x2, y2, z2);
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(x1, x2), _mm_mul_ps(y1, y2)), _mm_mul_ps(z1, z2)));
+    }
+
+    MathUtilC::dotVec3s(v1, v2, dst + i, count - i);
+}
+
 #endif
 
 
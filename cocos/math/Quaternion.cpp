@@ -24,6 +24,7 @@
 
 #include <cmath>
 #include "base/Macros.h"
+#include "math/MathUtil.h"
 
 NS_CC_MATH_BEGIN
 
@@ -173,6 +174,13 @@ void Quaternion::multiply(const Quaternion& q1, const Quaternion& q2, Quaternion
     dst->w = w;
 }
 
+void Quaternion::multiply(const Quaternion* q1, const Quaternion* q2, Quaternion* dst, size_t count)
+{
+    static_assert(sizeof(Quaternion) == sizeof(float) * 4, "quaternions are packed floats");
+    GP_ASSERT(dst || !count);
+    MathUtil::multiplyQuaternions(&q1->x, &q2->x, &dst->x, static_cast<unsigned int>(count));
+}
+
 void Quaternion::normalize()
 {
     float n = x * x + y * y + z * z + w * w;
@@ -282,6 +290,13 @@ void Quaternion::lerp(const Quaternion& q1, const Quaternion& q2, float t, Quate
     dst->w = t1 * q1.w + t * q2.w;
 }
 
+void Quaternion::slerp(const Quaternion* q1, const Quaternion* q2, float t, Quaternion* dst, size_t count)
+{
+    GP_ASSERT(dst || !count);
+    GP_ASSERT(!(t < 0.0f || t > 1.0f));
+    MathUtil::slerpQuaternions(&q1->x, &q2->x, t, &dst->x, static_cast<unsigned int>(count));
+}
+
 void Quaternion::slerp(const Quaternion& q1, const Quaternion& q2, float t, Quaternion* dst)
 {
     GP_ASSERT(dst);
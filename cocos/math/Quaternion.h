@@ -233,6 +233,16 @@ public:
      */
     static void multiply(const Quaternion& q1, const Quaternion& q2, Quaternion* dst);
 
+    /**
+     * Multiplies batches of quaternions, dst[i] = q1[i] * q2[i].
+     *
+     * @param q1 The first quaternions.
+     * @param q2 The second quaternions.
+     * @param dst The quaternions to store the results in, may be q1 or q2.
+     * @param count The number of quaternions.
+     */
+    static void multiply(const Quaternion* q1, const Quaternion* q2, Quaternion* dst, size_t count);
+
     /**
      * Normalizes this quaternion to have unit length.
      *
@@ -333,6 +343,17 @@ public:
      */
     static void slerp(const Quaternion& q1, const Quaternion& q2, float t, Quaternion* dst);
 
+    /**
+     * Interpolates batches of quaternions like slerp with the same coefficient for all of them.
+     *
+     * @param q1 The first quaternions.
+     * @param q2 The second quaternions.
+     * @param t The interpolation coefficient.
+     * @param dst The quaternions to store the results in, may be q1 or q2.
+     * @param count The number of quaternions.
+     */
+    static void slerp(const Quaternion* q1, const Quaternion* q2, float t, Quaternion* dst, size_t count);
+
     /**
      * Interpolates over a series of quaternions using spherical spline interpolation.
      *
@@ -204,6 +204,13 @@ void Vec3::transformQuat(const Quaternion& q)
     z = iz * qw + iw * -qz + ix * -qy - iy * -qx;
 }
 
+void Vec3::transformQuat(const Vec3* v, const Quaternion& q, Vec3* dst, size_t count)
+{
+    static_assert(sizeof(Vec3) == sizeof(float) * 3, "vectors are packed floats");
+    GP_ASSERT(dst || !count);
+    MathUtil::transformVec3sByQuat(&q.x, &v->x, &dst->x, static_cast<unsigned int>(count));
+}
+
 float Vec3::distance(const Vec3& v) const
 {
     float dx = v.x - x;
@@ -232,6 +239,12 @@ float Vec3::dot(const Vec3& v1, const Vec3& v2)
     return (v1.x * v2.x + v1.y * v2.y + v1.z * v2.z);
 }
 
+void Vec3::dot(const Vec3* v1, const Vec3* v2, float* dst, size_t count)
+{
+    GP_ASSERT(dst || !count);
+    MathUtil::dotVec3s(&v1->x, &v2->x, dst, static_cast<unsigned int>(count));
+}
+
 void Vec3::normalize()
 {
     float n = x * x + y * y + z * z;
@@ -250,6 +263,12 @@ void Vec3::normalize()
     z *= n;
 }
 
+void Vec3::normalize(const Vec3* v, Vec3* dst, size_t count)
+{
+    GP_ASSERT(dst || !count);
+    MathUtil::normalizeVec3s(&v->x, &dst->x, static_cast<unsigned int>(count));
+}
+
 Vec3 Vec3::getNormalized() const
 {
     Vec3 v(*this);
@@ -240,6 +240,16 @@ public:
      */
     void transformQuat(const Quaternion& q);
 
+    /**
+     * Transforms a batch of vectors by the specified quaternion like transformQuat.
+     *
+     * @param v The vectors to transform.
+     * @param q The quaternion to multiply.
+     * @param dst The vectors to store the results in, may be v.
+     * @param count The number of vectors.
+     */
+    static void transformQuat(const Vec3* v, const Quaternion& q, Vec3* dst, size_t count);
+
     /**
      * Returns the distance between this vector and v.
      *
@@ -286,6 +296,16 @@ public:
      */
     static float dot(const Vec3& v1, const Vec3& v2);
 
+    /**
+     * Computes the dot products of batches of vectors, dst[i] = v1[i] . v2[i].
+     *
+     * @param v1 The first vectors.
+     * @param v2 The second vectors.
+     * @param dst The dot products.
+     * @param count The number of vector pairs.
+     */
+    static void dot(const Vec3* v1, const Vec3* v2, float* dst, size_t count);
+
     /**
      * Computes the length of this vector.
      *
@@ -325,6 +345,15 @@ public:
      */
     void normalize();
 
+    /**
+     * Normalizes a batch of vectors like normalize.
+     *
+     * @param v The vectors to normalize.
+     * @param dst The vectors to store the results in, may be v.
+     * @param count The number of vectors.
+     */
+    static void normalize(const Vec3* v, Vec3* dst, size_t count);
+
     /**
      * Get the normalized vector.
      *
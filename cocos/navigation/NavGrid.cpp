@@ -0,0 +1,138 @@
+#include "NavGrid.h"
+
+#include <cmath>
+#include <cstdlib>
+
+namespace cc {
+namespace navigation {
+namespace {
+constexpr float DIAGONAL = 1.41421356F;
+constexpr int DIRECTIONS[8][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+} // namespace
+
+constexpr uint8_t NavGrid::BLOCKED;
+
+NavGrid::NavGrid(const uint8_t *cells, uint32_t width, uint32_t height, float cellSize, float originX, float originY)
+: _cells(cells, cells + static_cast<size_t>(width) * height),
+  _width(width),
+  _height(height),
+  _cellSize(cellSize > 0.F ? cellSize : 1.F),
+  _originX(originX),
+  _originY(originY) {
+    uint8_t minCost = 0xff;
+    for (uint8_t cost : _cells) {
+        if (cost != BLOCKED) minCost = std::min(minCost, cost);
+    }
+    _minCost = minCost;
+}
+
+uint32_t NavGrid::getNode(float x, float y) const {
+    const float cellX = std::floor((x - _originX) / _cellSize);
+    const float cellY = std::floor((y - _originY) / _cellSize);
+    if (!(cellX >= 0.F && cellY >= 0.F && cellX < static_cast<float>(_width) && cellY < static_cast<float>(_height))) {
+        return INVALID_NODE;
+    }
+    const uint32_t node = static_cast<uint32_t>(cellY) * _width + static_cast<uint32_t>(cellX);
+    return _cells[node] != BLOCKED ? node : INVALID_NODE;
+}
+
+template <class F>
+void NavGrid::forEachNeighbor(uint32_t node, F &&f) const {
+    const int x = static_cast<int>(node % _width);
+    const int y = static_cast<int>(node / _width);
+    const float cost = _cells[node];
+    for (uint32_t i = 0; i < 8; ++i) {
+        const int dx = DIRECTIONS[i][0];
+        const int dy = DIRECTIONS[i][1];
+        if (!isWalkable(x + dx, y + dy)) continue;
+        const bool isDiagonal = dx != 0 && dy != 0;
+        if (isDiagonal && (!isWalkable(x + dx, y) || !isWalkable(x, y + dy))) continue;
+
+        const uint32_t neighbor = static_cast<uint32_t>(y + dy) * _width + static_cast<uint32_t>(x + dx);
+        const float length = isDiagonal ? DIAGONAL : 1.F;
+        f(neighbor, length * _cellSize * (cost + _cells[neighbor]) * 0.5F);
+    }
+}
+
+// octile distance at the cheapest cost
+float NavGrid::estimate(uint32_t node, uint32_t goal) const {
+    const float dx = std::abs(static_cast<float>(node % _width) - static_cast<float>(goal % _width));
+    const float dy = std::abs(static_cast<float>(node / _width) - static_cast<float>(goal / _width));
+    const float straight = std::abs(dx - dy);
+    const float diagonal = std::min(dx, dy);
+    return (straight + diagonal * DIAGONAL) * _cellSize * _minCost;
+}
+
+// Walks the cells the line between the two cell centers touches, both cells beside a corner it passes through included
+bool NavGrid::isLineWalkable(uint32_t from, uint32_t to, uint8_t maxCost) const {
+    const auto isOpen = [&](int x, int y) {
+        return isWalkable(x, y) && _cells[y * _width + x] <= maxCost;
+    };
+    int x = static_cast<int>(from % _width);
+    int y = static_cast<int>(from / _width);
+    const int dx = static_cast<int>(to % _width) - x;
+    const int dy = static_cast<int>(to / _width) - y;
+    const int stepX = dx > 0 ? 1 : -1;
+    const int stepY = dy > 0 ? 1 : -1;
+    const int64_t countX = std::abs(dx);
+    const int64_t countY = std::abs(dy);
+    for (int64_t ix = 0, iy = 0; ix < countX || iy < countY;) {
+        // which cell border the line crosses next, compared in integers
+        const int64_t decision = (1 + 2 * ix) * countY - (1 + 2 * iy) * countX;
+        if (decision == 0) {
+            if (!isOpen(x + stepX, y) || !isOpen(x, y + stepY)) return false;
+            x += stepX;
+            y += stepY;
+            ++ix;
+            ++iy;
+        } else if (decision < 0) {
+            x += stepX;
+            ++ix;
+        } else {
+            y += stepY;
+            ++iy;
+        }
+        if (!isOpen(x, y)) return false;
+    }
+    return true;
+}
+
+int NavGrid::findPath(float startX, float startY, float goalX, float goalY, float *points, uint32_t maxPoints) const {
+    const uint32_t start = getNode(startX, startY);
+    const uint32_t goal = getNode(goalX, goalY);
+    if (start == INVALID_NODE || goal == INVALID_NODE) return -1;
+
+    SearchScratch &scratch = getScratch();
+    if (!search(*this, _width * _height, start, goal, scratch)) return -1;
+
+    uint32_t written = 0;
+    const auto write = [&](float x, float y) {
+        points[written * 2] = x;
+        points[written * 2 + 1] = y;
+        ++written;
+    };
+
+    // a cell becomes a waypoint when the line from the last waypoint can not reach the cell after it
+    const auto &path = scratch.path;
+    const size_t count = path.size();
+    size_t anchor = 0;
+    uint8_t segmentCost = _cells[path[0]];
+    for (size_t i = 1; i < count && written < maxPoints; ++i) {
+        segmentCost = std::max(segmentCost, _cells[path[i]]);
+        if (i + 1 < count) {
+            const uint8_t nextCost = std::max(segmentCost, _cells[path[i + 1]]);
+            if (isLineWalkable(path[anchor], path[i + 1], nextCost)) continue;
+            write(_originX + (static_cast<float>(path[i] % _width) + 0.5F) * _cellSize,
+                  _originY + (static_cast<float>(path[i] / _width) + 0.5F) * _cellSize);
+            anchor = i;
+            segmentCost = _cells[path[i]];
+        } else {
+            write(goalX, goalY);
+        }
+    }
+    if (count == 1 && maxPoints > 0) write(goalX, goalY);
+    return static_cast<int>(written);
+}
+
+} // namespace navigation
+} // namespace cc
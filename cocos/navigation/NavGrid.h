@@ -0,0 +1,49 @@
+#pragma once
+
+#include "PathGraph.h"
+
+namespace cc {
+namespace navigation {
+
+// A grid of cells on the x, y plane, walked in 8 directions. A diagonal step needs both cells beside it to be
+// walkable, so paths never cut a corner. The waypoints are the cell centers where the path turns, a straight
+// line replaces the cells between two waypoints when its cells are walkable and cost no more than theirs.
+class CC_DLL NavGrid final : public PathGraph {
+public:
+    static constexpr uint8_t BLOCKED = 0;
+
+    // cells holds width * height costs row by row from the origin, the corner of the first cell.
+    // BLOCKED cells are never entered, the others cost their value per cell size crossed.
+    NavGrid(const uint8_t *cells, uint32_t width, uint32_t height, float cellSize, float originX, float originY);
+
+    int findPath(float startX, float startY, float goalX, float goalY, float *points, uint32_t maxPoints) const override;
+
+    CC_INLINE uint32_t getWidth() const { return _width; }
+    CC_INLINE uint32_t getHeight() const { return _height; }
+    CC_INLINE uint8_t getCost(uint32_t x, uint32_t y) const { return _cells[y * _width + x]; }
+
+private:
+    friend class PathGraph;
+
+    CC_INLINE bool isWalkable(int x, int y) const {
+        return x >= 0 && y >= 0 && x < static_cast<int>(_width) && y < static_cast<int>(_height) && _cells[y * _width + x] != BLOCKED;
+    }
+
+    uint32_t getNode(float x, float y) const;
+    bool isLineWalkable(uint32_t from, uint32_t to, uint8_t maxCost) const;
+
+    template <class F>
+    void forEachNeighbor(uint32_t node, F &&f) const;
+    float estimate(uint32_t node, uint32_t goal) const;
+
+    std::vector<uint8_t> _cells;
+    uint32_t _width = 0;
+    uint32_t _height = 0;
+    float _cellSize = 1.F;
+    float _originX = 0.F;
+    float _originY = 0.F;
+    uint8_t _minCost = 1; // of the walkable cells, keeps the estimate below the real cost
+};
+
+} // namespace navigation
+} // namespace cc
@@ -0,0 +1,268 @@
+#include "NavMesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace cc {
+namespace navigation {
+namespace {
+constexpr float EDGE_TOLERANCE = 1e-4F; // a point this close outside an edge is still inside
+
+struct Point {
+    float x;
+    float y;
+};
+
+// the shared edges on the way, left and right as seen walking from the start to the goal
+struct Portal {
+    Point left;
+    Point right;
+};
+
+thread_local std::vector<Portal> tPortals;
+
+// positive when c is right of the line from a to b
+CC_INLINE float getArea2(const Point &a, const Point &b, const Point &c) {
+    return (c.x - a.x) * (b.y - a.y) - (b.x - a.x) * (c.y - a.y);
+}
+
+CC_INLINE bool isSamePoint(const Point &a, const Point &b) {
+    const float dx = a.x - b.x;
+    const float dy = a.y - b.y;
+    return dx * dx + dy * dy < 1e-12F;
+}
+} // namespace
+
+constexpr uint32_t NavMesh::MAX_BUCKETS_PER_SIDE;
+
+NavMesh::NavMesh(const float *vertices, uint32_t vertexCount, const uint32_t *indices, uint32_t triangleCount)
+: _vertices(vertices, vertices + static_cast<size_t>(vertexCount) * 2) {
+    _triangles.reserve(triangleCount);
+    for (uint32_t i = 0; i < triangleCount; ++i) {
+        const uint32_t *index = indices + static_cast<size_t>(i) * 3;
+        if (index[0] >= vertexCount || index[1] >= vertexCount || index[2] >= vertexCount) continue;
+
+        Triangle triangle{{index[0], index[1], index[2]}, {INVALID_NODE, INVALID_NODE, INVALID_NODE}, 0.F, 0.F};
+        const Point a{_vertices[index[0] * 2], _vertices[index[0] * 2 + 1]};
+        const Point b{_vertices[index[1] * 2], _vertices[index[1] * 2 + 1]};
+        const Point c{_vertices[index[2] * 2], _vertices[index[2] * 2 + 1]};
+        const float area = getArea2(a, b, c);
+        if (area == 0.F) continue;
+        if (area < 0.F) std::swap(triangle.vertices[1], triangle.vertices[2]); // clockwise
+        triangle.centerX = (a.x + b.x + c.x) / 3.F;
+        triangle.centerY = (a.y + b.y + c.y) / 3.F;
+        _triangles.push_back(triangle);
+    }
+
+    // an edge links the two first triangles having it, further ones stay unlinked along it
+    std::unordered_map<uint64_t, uint32_t> edges;
+    edges.reserve(_triangles.size() * 3);
+    for (uint32_t i = 0; i < static_cast<uint32_t>(_triangles.size()); ++i) {
+        for (uint32_t edge = 0; edge < 3; ++edge) {
+            const uint32_t v0 = _triangles[i].vertices[edge];
+            const uint32_t v1 = _triangles[i].vertices[(edge + 1) % 3];
+            const uint64_t key = (static_cast<uint64_t>(std::min(v0, v1)) << 32) | std::max(v0, v1);
+            auto iter = edges.find(key);
+            if (iter == edges.end()) {
+                edges.emplace(key, i * 3 + edge);
+                continue;
+            }
+            if (iter->second == INVALID_NODE) continue;
+            const uint32_t other = iter->second / 3;
+            _triangles[i].neighbors[edge] = other;
+            _triangles[other].neighbors[iter->second % 3] = i;
+            iter->second = INVALID_NODE;
+        }
+    }
+
+    buildBuckets();
+}
+
+void NavMesh::buildBuckets() {
+    _bucketsX = _bucketsY = 0;
+    _bucketOffsets.clear();
+    _bucketTriangles.clear();
+    if (_triangles.empty()) return;
+
+    float maxX = -INFINITY;
+    float maxY = -INFINITY;
+    _minX = _minY = INFINITY;
+    for (const auto &triangle : _triangles) {
+        for (uint32_t vertex : triangle.vertices) {
+            _minX = std::min(_minX, _vertices[vertex * 2]);
+            _minY = std::min(_minY, _vertices[vertex * 2 + 1]);
+            maxX = std::max(maxX, _vertices[vertex * 2]);
+            maxY = std::max(maxY, _vertices[vertex * 2 + 1]);
+        }
+    }
+
+    // about one triangle a bucket
+    const float extent = std::max(maxX - _minX, maxY - _minY);
+    const float side = std::min(static_cast<float>(MAX_BUCKETS_PER_SIDE), std::ceil(std::sqrt(static_cast<float>(_triangles.size()))));
+    _bucketSize = extent > 0.F ? extent / side : 1.F;
+    _bucketsX = std::min(MAX_BUCKETS_PER_SIDE, static_cast<uint32_t>((maxX - _minX) / _bucketSize) + 1);
+    _bucketsY = std::min(MAX_BUCKETS_PER_SIDE, static_cast<uint32_t>((maxY - _minY) / _bucketSize) + 1);
+
+    const auto forEachBucket = [&](const Triangle &triangle, auto &&f) {
+        float lowX = INFINITY;
+        float lowY = INFINITY;
+        float highX = -INFINITY;
+        float highY = -INFINITY;
+        for (uint32_t vertex : triangle.vertices) {
+            lowX = std::min(lowX, _vertices[vertex * 2]);
+            lowY = std::min(lowY, _vertices[vertex * 2 + 1]);
+            highX = std::max(highX, _vertices[vertex * 2]);
+            highY = std::max(highY, _vertices[vertex * 2 + 1]);
+        }
+        const uint32_t x0 = std::min(_bucketsX - 1, static_cast<uint32_t>((lowX - _minX) / _bucketSize));
+        const uint32_t y0 = std::min(_bucketsY - 1, static_cast<uint32_t>((lowY - _minY) / _bucketSize));
+        const uint32_t x1 = std::min(_bucketsX - 1, static_cast<uint32_t>((highX - _minX) / _bucketSize));
+        const uint32_t y1 = std::min(_bucketsY - 1, static_cast<uint32_t>((highY - _minY) / _bucketSize));
+        for (uint32_t y = y0; y <= y1; ++y) {
+            for (uint32_t x = x0; x <= x1; ++x) f(y * _bucketsX + x);
+        }
+    };
+
+    _bucketOffsets.assign(_bucketsX * _bucketsY + 1, 0);
+    for (const auto &triangle : _triangles) {
+        forEachBucket(triangle, [&](uint32_t bucket) { ++_bucketOffsets[bucket + 1]; });
+    }
+    for (size_t i = 1; i < _bucketOffsets.size(); ++i) {
+        _bucketOffsets[i] += _bucketOffsets[i - 1];
+    }
+    _bucketTriangles.resize(_bucketOffsets.back());
+    std::vector<uint32_t> cursors(_bucketOffsets.begin(), _bucketOffsets.end() - 1);
+    for (uint32_t i = 0; i < static_cast<uint32_t>(_triangles.size()); ++i) {
+        forEachBucket(_triangles[i], [&](uint32_t bucket) { _bucketTriangles[cursors[bucket]++] = i; });
+    }
+}
+
+bool NavMesh::contains(const Triangle &triangle, float x, float y) const {
+    const Point p{x, y};
+    for (uint32_t edge = 0; edge < 3; ++edge) {
+        const uint32_t v0 = triangle.vertices[edge];
+        const uint32_t v1 = triangle.vertices[(edge + 1) % 3];
+        const Point a{_vertices[v0 * 2], _vertices[v0 * 2 + 1]};
+        const Point b{_vertices[v1 * 2], _vertices[v1 * 2 + 1]};
+        const float length = std::sqrt((b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y));
+        // the vertices go clockwise, the inside is right of every edge
+        if (getArea2(a, b, p) < -EDGE_TOLERANCE * length) return false;
+    }
+    return true;
+}
+
+uint32_t NavMesh::findTriangle(float x, float y) const {
+    if (_bucketOffsets.empty()) return INVALID_NODE;
+    const float bucketX = std::floor((x - _minX) / _bucketSize);
+    const float bucketY = std::floor((y - _minY) / _bucketSize);
+    if (!(bucketX >= 0.F && bucketY >= 0.F && bucketX < static_cast<float>(_bucketsX) && bucketY < static_cast<float>(_bucketsY))) {
+        return INVALID_NODE;
+    }
+    const uint32_t bucket = static_cast<uint32_t>(bucketY) * _bucketsX + static_cast<uint32_t>(bucketX);
+    for (uint32_t i = _bucketOffsets[bucket]; i < _bucketOffsets[bucket + 1]; ++i) {
+        if (contains(_triangles[_bucketTriangles[i]], x, y)) return _bucketTriangles[i];
+    }
+    return INVALID_NODE;
+}
+
+template <class F>
+void NavMesh::forEachNeighbor(uint32_t node, F &&f) const {
+    const Triangle &triangle = _triangles[node];
+    for (uint32_t neighbor : triangle.neighbors) {
+        if (neighbor == INVALID_NODE) continue;
+        const float dx = _triangles[neighbor].centerX - triangle.centerX;
+        const float dy = _triangles[neighbor].centerY - triangle.centerY;
+        f(neighbor, std::sqrt(dx * dx + dy * dy));
+    }
+}
+
+// the steps go between the centers, the straight line between two centers is never longer
+float NavMesh::estimate(uint32_t node, uint32_t goal) const {
+    const float dx = _triangles[goal].centerX - _triangles[node].centerX;
+    const float dy = _triangles[goal].centerY - _triangles[node].centerY;
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+int NavMesh::findPath(float startX, float startY, float goalX, float goalY, float *points, uint32_t maxPoints) const {
+    const uint32_t start = findTriangle(startX, startY);
+    const uint32_t goal = findTriangle(goalX, goalY);
+    if (start == INVALID_NODE || goal == INVALID_NODE) return -1;
+
+    SearchScratch &scratch = getScratch();
+    if (!search(*this, static_cast<uint32_t>(_triangles.size()), start, goal, scratch)) return -1;
+
+    // crossing the edge from vertices[i] to vertices[i + 1] of a clockwise triangle, vertices[i] is on the left
+    const Point startPoint{startX, startY};
+    const Point goalPoint{goalX, goalY};
+    auto &portals = tPortals;
+    portals.clear();
+    portals.push_back({startPoint, startPoint});
+    const auto &path = scratch.path;
+    for (size_t i = 0; i + 1 < path.size(); ++i) {
+        const Triangle &triangle = _triangles[path[i]];
+        for (uint32_t edge = 0; edge < 3; ++edge) {
+            if (triangle.neighbors[edge] != path[i + 1]) continue;
+            const uint32_t left = triangle.vertices[edge];
+            const uint32_t right = triangle.vertices[(edge + 1) % 3];
+            portals.push_back({{_vertices[left * 2], _vertices[left * 2 + 1]}, {_vertices[right * 2], _vertices[right * 2 + 1]}});
+            break;
+        }
+    }
+    portals.push_back({goalPoint, goalPoint});
+
+    // a vertex the funnel turns around again, or the goal on it, is written once
+    uint32_t written = 0;
+    Point last = startPoint;
+    const auto write = [&](const Point &point) {
+        if (isSamePoint(point, last)) return;
+        points[written * 2] = point.x;
+        points[written * 2 + 1] = point.y;
+        last = point;
+        ++written;
+    };
+
+    // the funnel narrows portal by portal, when a side crosses the other its vertex becomes a waypoint
+    // and the funnel starts over from there
+    Point apex = startPoint;
+    Point left = startPoint;
+    Point right = startPoint;
+    size_t apexIndex = 0;
+    size_t leftIndex = 0;
+    size_t rightIndex = 0;
+    for (size_t i = 1; i < portals.size() && written < maxPoints; ++i) {
+        const Point &portalLeft = portals[i].left;
+        const Point &portalRight = portals[i].right;
+
+        if (getArea2(apex, right, portalRight) <= 0.F) {
+            if (isSamePoint(apex, right) || getArea2(apex, left, portalRight) > 0.F) {
+                right = portalRight;
+                rightIndex = i;
+            } else {
+                write(left);
+                apex = right = left;
+                apexIndex = rightIndex = leftIndex;
+                i = apexIndex;
+                continue;
+            }
+        }
+
+        if (getArea2(apex, left, portalLeft) >= 0.F) {
+            if (isSamePoint(apex, left) || getArea2(apex, right, portalLeft) < 0.F) {
+                left = portalLeft;
+                leftIndex = i;
+            } else {
+                write(right);
+                apex = left = right;
+                apexIndex = leftIndex = rightIndex;
+                i = apexIndex;
+                continue;
+            }
+        }
+    }
+    if (written < maxPoints) write(goalPoint);
+    return static_cast<int>(written);
+}
+
+} // namespace navigation
+} // namespace cc
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "PathGraph.h"
+
+namespace cc {
+namespace navigation {
+
+// Walkable triangles on the x, y plane. Triangles sharing an edge, the same two vertex indices, are connected.
+// The search goes from triangle to triangle, then the path is pulled tight through the shared edges it
+// crosses, so the waypoints are the vertices it turns around.
+class CC_DLL NavMesh final : public PathGraph {
+public:
+    // vertices holds x, y pairs, indices 3 vertices a triangle in either winding
+    NavMesh(const float *vertices, uint32_t vertexCount, const uint32_t *indices, uint32_t triangleCount);
+
+    int findPath(float startX, float startY, float goalX, float goalY, float *points, uint32_t maxPoints) const override;
+
+    // The triangle containing the point, INVALID_NODE if none does.
+    uint32_t findTriangle(float x, float y) const;
+
+    CC_INLINE uint32_t getTriangleCount() const { return static_cast<uint32_t>(_triangles.size()); }
+
+private:
+    friend class PathGraph;
+
+    // vertices clockwise, neighbors[i] is across the edge from vertices[i] to vertices[(i + 1) % 3]
+    struct Triangle {
+        uint32_t vertices[3];
+        uint32_t neighbors[3];
+        float centerX;
+        float centerY;
+    };
+
+    // buckets of a uniform grid over the bounds, listing the triangles whose bounds overlap them
+    static constexpr uint32_t MAX_BUCKETS_PER_SIDE = 256;
+
+    bool contains(const Triangle &triangle, float x, float y) const;
+    void buildBuckets();
+
+    template <class F>
+    void forEachNeighbor(uint32_t node, F &&f) const;
+    float estimate(uint32_t node, uint32_t goal) const;
+
+    std::vector<float> _vertices;
+    std::vector<Triangle> _triangles;
+
+    float _minX = 0.F;
+    float _minY = 0.F;
+    float _bucketSize = 1.F;
+    uint32_t _bucketsX = 0;
+    uint32_t _bucketsY = 0;
+    std::vector<uint32_t> _bucketOffsets; // _bucketsX * _bucketsY + 1 offsets into _bucketTriangles
+    std::vector<uint32_t> _bucketTriangles;
+};
+
+} // namespace navigation
+} // namespace cc
@@ -0,0 +1,127 @@
+#include "NavigationSystem.h"
+
+#include "NavGrid.h"
+#include "NavMesh.h"
+#include "base/JobSystem.h"
+#include "base/memory/Memory.h"
+#include "bindings/dop/BufferAllocator.h"
+
+#include <algorithm>
+
+namespace cc {
+namespace navigation {
+namespace {
+constexpr uint32_t MAX_JOBS_PER_BATCH = 128; // larger batches take larger ranges, a thread keeps few jobs in flight
+constexpr uint32_t QUERY_FLOATS = 4;
+
+CC_INLINE uint32_t getGrainSize(uint32_t count, uint32_t minGrainSize) {
+    return std::max(minGrainSize, (count + MAX_JOBS_PER_BATCH - 1) / MAX_JOBS_PER_BATCH);
+}
+} // namespace
+
+constexpr uint32_t NavigationSystem::PATH_GRAIN_SIZE;
+constexpr uint32_t NavigationSystem::RADIUS_GRAIN_SIZE;
+NavigationSystem *NavigationSystem::_instance = nullptr;
+
+NavigationSystem *NavigationSystem::getInstance() {
+    if (!_instance) _instance = CC_NEW(NavigationSystem);
+    return _instance;
+}
+
+void NavigationSystem::destroyInstance() {
+    CC_SAFE_DELETE(_instance);
+}
+
+NavigationSystem::~NavigationSystem() {
+    complete();
+}
+
+template <typename T>
+T *NavigationSystem::getStream(NavigationStream stream, uint32_t minCount) {
+    uint size = 0;
+    T *data = se::BufferAllocator::getBuffer<T>(se::PoolType::NAVIGATION, static_cast<uint>(stream), &size);
+    return data && size / sizeof(T) >= minCount ? data : nullptr;
+}
+
+void NavigationSystem::setGrid(uint32_t id, const uint8_t *cells, uint32_t width, uint32_t height, float cellSize, float originX, float originY) {
+    complete();
+    _graphs[id].reset(new NavGrid(cells, width, height, cellSize, originX, originY));
+}
+
+void NavigationSystem::setMesh(uint32_t id, const float *vertices, uint32_t vertexCount, const uint32_t *indices, uint32_t triangleCount) {
+    complete();
+    _graphs[id].reset(new NavMesh(vertices, vertexCount, indices, triangleCount));
+}
+
+void NavigationSystem::removeGraph(uint32_t id) {
+    complete();
+    _graphs.erase(id);
+}
+
+bool NavigationSystem::updateAgents(uint32_t agentCount, float cellSize) {
+    complete();
+    const auto *positions = getStream<float>(NavigationStream::AGENT_POSITION, agentCount * 2);
+    if (!positions) {
+        _agents.build(nullptr, 0, cellSize);
+        return false;
+    }
+    _agents.build(positions, agentCount, cellSize);
+    return true;
+}
+
+bool NavigationSystem::findPaths(uint32_t graphId, uint32_t queryCount, uint32_t maxPoints) {
+    const auto iter = _graphs.find(graphId);
+    if (iter == _graphs.end()) return false;
+    if (queryCount == 0) return true;
+
+    const auto *queries = getStream<float>(NavigationStream::PATH_QUERY, queryCount * QUERY_FLOATS);
+    auto *points = getStream<float>(NavigationStream::PATH_POINT, queryCount * maxPoints * 2);
+    auto *counts = getStream<int32_t>(NavigationStream::PATH_COUNT, queryCount);
+    if (!queries || !points || !counts) return false;
+
+    const PathGraph *graph = iter->second.get();
+    _jobs.push_back(JobSystem::getInstance()->parallelFor(
+        queryCount, getGrainSize(queryCount, PATH_GRAIN_SIZE), [graph, queries, points, counts, maxPoints](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                const float *query = queries + i * QUERY_FLOATS;
+                counts[i] = graph->findPath(query[0], query[1], query[2], query[3], points + i * maxPoints * 2, maxPoints);
+            }
+        }));
+    return true;
+}
+
+bool NavigationSystem::queryRadius(uint32_t queryCount, uint32_t maxNeighbors) {
+    if (queryCount == 0) return true;
+
+    const auto *queries = getStream<float>(NavigationStream::RADIUS_QUERY, queryCount * QUERY_FLOATS);
+    auto *neighbors = getStream<uint32_t>(NavigationStream::NEIGHBOR, queryCount * maxNeighbors);
+    auto *counts = getStream<uint32_t>(NavigationStream::NEIGHBOR_COUNT, queryCount);
+    if (!queries || !neighbors || !counts) return false;
+
+    const SpatialHash *agents = &_agents;
+    _jobs.push_back(JobSystem::getInstance()->parallelFor(
+        queryCount, getGrainSize(queryCount, RADIUS_GRAIN_SIZE), [agents, queries, neighbors, counts, maxNeighbors](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                const float *query = queries + i * QUERY_FLOATS;
+                const uint32_t excluded = query[3] >= 0.F ? static_cast<uint32_t>(query[3]) : SpatialHash::NO_AGENT;
+                counts[i] = agents->queryRadius(query[0], query[1], query[2], excluded, neighbors + i * maxNeighbors, maxNeighbors);
+            }
+        }));
+    return true;
+}
+
+void NavigationSystem::complete() {
+    if (_jobs.empty()) return;
+    auto *jobSystem = JobSystem::getInstance();
+    for (const Job *job : _jobs) {
+        jobSystem->wait(job);
+    }
+    _jobs.clear();
+}
+
+bool NavigationSystem::isFinished() const {
+    return std::all_of(_jobs.begin(), _jobs.end(), [](const Job *job) { return job->isFinished(); });
+}
+
+} // namespace navigation
+} // namespace cc
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "PathGraph.h"
+#include "SpatialHash.h"
+#include "base/Object.h"
+
+#include <memory>
+#include <unordered_map>
+
+namespace cc {
+
+class Job;
+
+namespace navigation {
+
+// The streams are array buffers of a BufferAllocator of PoolType::NAVIGATION, allocated at the index of the stream.
+// JS writes the agents and the queries, the results are written in place once the queries are completed.
+enum class NavigationStream : uint32_t {
+    AGENT_POSITION, // 2 floats an agent, x and y of the agents the spatial hash is built from
+    PATH_QUERY,     // 4 floats a query, x and y of the start then of the goal
+    PATH_POINT,     // maxPoints x, y pairs a query, the waypoints after the start, the goal last
+    PATH_COUNT,     // int32 a query, the waypoints written, -1 if there is no path
+    RADIUS_QUERY,   // 4 floats a query, x and y of the center, the radius, the agent left out or -1
+    NEIGHBOR,       // maxNeighbors uint32 a query, the agents within the radius
+    NEIGHBOR_COUNT, // uint32 a query, the neighbors written
+    COUNT,
+};
+
+// Paths on grids and navigation meshes and radius queries over the agents, run in batches on the JobSystem.
+// findPaths and queryRadius start their batch and return, complete() waits for the batches and their
+// results are read from the streams after it. JS writes no stream of a started batch before complete().
+// The calls come from the thread which created the JobSystem.
+class CC_DLL NavigationSystem final : public Object {
+public:
+    static NavigationSystem *getInstance();
+    static void destroyInstance();
+
+    ~NavigationSystem();
+
+    // A graph replaces the one with the same id, the started batches are completed first.
+    void setGrid(uint32_t id, const uint8_t *cells, uint32_t width, uint32_t height, float cellSize, float originX, float originY);
+    void setMesh(uint32_t id, const float *vertices, uint32_t vertexCount, const uint32_t *indices, uint32_t triangleCount);
+    void removeGraph(uint32_t id);
+
+    // Builds the spatial hash from the first agentCount AGENT_POSITION, completing the started batches first.
+    bool updateAgents(uint32_t agentCount, float cellSize);
+
+    // Start a batch over the first queryCount queries of their stream, false if the graph is unknown or a stream
+    // is missing or too small.
+    bool findPaths(uint32_t graphId, uint32_t queryCount, uint32_t maxPoints);
+    bool queryRadius(uint32_t queryCount, uint32_t maxNeighbors);
+
+    void complete();
+    bool isFinished() const;
+
+private:
+    // queries a job, a path is long enough for the smallest batch to be worth a job
+    static constexpr uint32_t PATH_GRAIN_SIZE = 4;
+    static constexpr uint32_t RADIUS_GRAIN_SIZE = 64;
+
+    template <typename T>
+    static T *getStream(NavigationStream stream, uint32_t minCount);
+
+    std::unordered_map<uint32_t, std::unique_ptr<PathGraph>> _graphs;
+    SpatialHash _agents;
+    std::vector<Job *> _jobs;
+
+    static NavigationSystem *_instance;
+};
+
+} // namespace navigation
+} // namespace cc
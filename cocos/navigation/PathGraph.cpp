@@ -0,0 +1,32 @@
+#include "PathGraph.h"
+
+namespace cc {
+namespace navigation {
+
+constexpr uint32_t PathGraph::INVALID_NODE;
+
+namespace {
+thread_local SearchScratch tScratch;
+} // namespace
+
+void SearchScratch::begin(uint32_t nodeCount) {
+    if (stamps.size() < nodeCount) {
+        stamps.resize(nodeCount, 0);
+        costs.resize(nodeCount);
+        parents.resize(nodeCount);
+        isClosed.resize(nodeCount);
+    }
+    open.clear();
+    // the stamps start over when the generation wraps, no stale node may equal it
+    if (++generation == 0) {
+        std::fill(stamps.begin(), stamps.end(), 0);
+        generation = 1;
+    }
+}
+
+SearchScratch &PathGraph::getScratch() {
+    return tScratch;
+}
+
+} // namespace navigation
+} // namespace cc
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "base/Macros.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace cc {
+namespace navigation {
+
+// State of the searches of one thread, reused from search to search. A node belongs to the current search
+// only while its stamp equals the generation, so nothing is cleared between searches.
+struct SearchScratch {
+    struct OpenNode {
+        float estimate; // cost from the start plus the heuristic
+        uint32_t node;
+        bool operator<(const OpenNode &other) const { return estimate > other.estimate; } // min-heap
+    };
+
+    std::vector<uint32_t> stamps;
+    std::vector<float> costs;
+    std::vector<uint32_t> parents;
+    std::vector<uint8_t> isClosed;
+    std::vector<OpenNode> open;
+    std::vector<uint32_t> path; // nodes of the last search, start first
+    uint32_t generation = 0;
+
+    void begin(uint32_t nodeCount);
+};
+
+// A graph the NavigationSystem finds paths on. findPath runs on any worker of the JobSystem at the same time,
+// the graph is only read.
+class CC_DLL PathGraph {
+public:
+    static constexpr uint32_t INVALID_NODE = 0xffffffff;
+
+    virtual ~PathGraph() = default;
+
+    // Writes the waypoints after the start as x, y pairs, the last one is the goal. A path of more than maxPoints
+    // waypoints is cut after maxPoints. Returns the number written, -1 if the start or the goal is off the graph
+    // or there is no path between them.
+    virtual int findPath(float startX, float startY, float goalX, float goalY, float *points, uint32_t maxPoints) const = 0;
+
+protected:
+    static SearchScratch &getScratch();
+
+    // A* from start to goal, scratch.path is the nodes from start to goal if one is found.
+    // graph.forEachNeighbor(node, f) calls f(neighbor, cost) and graph.estimate(node, goal) never overestimates.
+    template <class Graph>
+    static bool search(const Graph &graph, uint32_t nodeCount, uint32_t start, uint32_t goal, SearchScratch &scratch);
+};
+
+template <class Graph>
+bool PathGraph::search(const Graph &graph, uint32_t nodeCount, uint32_t start, uint32_t goal, SearchScratch &scratch) {
+    scratch.begin(nodeCount);
+    scratch.path.clear();
+    const uint32_t generation = scratch.generation;
+    const auto reach = [&](uint32_t node, float cost, uint32_t parent) {
+        if (scratch.stamps[node] == generation) {
+            if (scratch.isClosed[node] || cost >= scratch.costs[node]) return;
+        } else {
+            scratch.stamps[node] = generation;
+            scratch.isClosed[node] = 0;
+        }
+        scratch.costs[node] = cost;
+        scratch.parents[node] = parent;
+        scratch.open.push_back({cost + graph.estimate(node, goal), node});
+        std::push_heap(scratch.open.begin(), scratch.open.end());
+    };
+
+    reach(start, 0.F, INVALID_NODE);
+    while (!scratch.open.empty()) {
+        std::pop_heap(scratch.open.begin(), scratch.open.end());
+        const uint32_t node = scratch.open.back().node;
+        scratch.open.pop_back();
+        // a node is pushed again when a cheaper way to it is found, the older entries are skipped
+        if (scratch.isClosed[node]) continue;
+        scratch.isClosed[node] = 1;
+
+        if (node == goal) {
+            for (uint32_t current = goal; current != INVALID_NODE; current = scratch.parents[current]) {
+                scratch.path.push_back(current);
+            }
+            std::reverse(scratch.path.begin(), scratch.path.end());
+            return true;
+        }
+
+        const float cost = scratch.costs[node];
+        graph.forEachNeighbor(node, [&](uint32_t neighbor, float stepCost) {
+            reach(neighbor, cost + stepCost, node);
+        });
+    }
+    return false;
+}
+
+} // namespace navigation
+} // namespace cc
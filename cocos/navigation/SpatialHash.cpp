@@ -0,0 +1,98 @@
+#include "SpatialHash.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace cc {
+namespace navigation {
+namespace {
+// the agents found by a query, with their squared distances
+thread_local std::vector<std::pair<float, uint32_t>> tFound;
+} // namespace
+
+constexpr uint32_t SpatialHash::NO_AGENT;
+
+void SpatialHash::build(const float *positions, uint32_t count, float cellSize) {
+    _cellSize = cellSize > 0.F ? cellSize : 1.F;
+    uint32_t bucketCount = 16;
+    while (bucketCount < count * 2) bucketCount <<= 1;
+    _bucketMask = bucketCount - 1;
+
+    // counting sort of the agents by bucket
+    _agentBuckets.resize(count);
+    _bucketOffsets.assign(bucketCount + 1, 0);
+    for (uint32_t i = 0; i < count; ++i) {
+        const int32_t cellX = static_cast<int32_t>(std::floor(positions[i * 2] / _cellSize));
+        const int32_t cellY = static_cast<int32_t>(std::floor(positions[i * 2 + 1] / _cellSize));
+        const uint32_t bucket = getBucket(cellX, cellY);
+        _agentBuckets[i] = bucket;
+        ++_bucketOffsets[bucket + 1];
+    }
+    for (uint32_t i = 1; i <= bucketCount; ++i) {
+        _bucketOffsets[i] += _bucketOffsets[i - 1];
+    }
+
+    _agents.resize(count);
+    _x.resize(count);
+    _y.resize(count);
+    _cellX.resize(count);
+    _cellY.resize(count);
+    _cursors.assign(_bucketOffsets.begin(), _bucketOffsets.end() - 1);
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint32_t slot = _cursors[_agentBuckets[i]]++;
+        _agents[slot] = i;
+        _x[slot] = positions[i * 2];
+        _y[slot] = positions[i * 2 + 1];
+        _cellX[slot] = static_cast<int32_t>(std::floor(_x[slot] / _cellSize));
+        _cellY[slot] = static_cast<int32_t>(std::floor(_y[slot] / _cellSize));
+    }
+}
+
+uint32_t SpatialHash::queryRadius(float x, float y, float radius, uint32_t excluded, uint32_t *results, uint32_t maxResults) const {
+    if (_agents.empty() || maxResults == 0 || !(radius >= 0.F)) return 0;
+
+    auto &found = tFound;
+    found.clear();
+    const float radius2 = radius * radius;
+    const auto test = [&](uint32_t slot) {
+        if (_agents[slot] == excluded) return;
+        const float dx = _x[slot] - x;
+        const float dy = _y[slot] - y;
+        const float distance2 = dx * dx + dy * dy;
+        if (distance2 <= radius2) found.emplace_back(distance2, _agents[slot]);
+    };
+
+    const float minX = std::floor((x - radius) / _cellSize);
+    const float minY = std::floor((y - radius) / _cellSize);
+    const float maxX = std::floor((x + radius) / _cellSize);
+    const float maxY = std::floor((y + radius) / _cellSize);
+    const float cellCount = (maxX - minX + 1.F) * (maxY - minY + 1.F);
+    if (cellCount >= static_cast<float>(_bucketMask + 1)) {
+        // the radius covers more cells than there are buckets, every agent is read once instead
+        for (uint32_t slot = 0; slot < static_cast<uint32_t>(_agents.size()); ++slot) test(slot);
+    } else {
+        // a bucket is shared by the cells hashing to it, only the agents of the cell at hand are tested
+        for (int32_t cellY = static_cast<int32_t>(minY); cellY <= static_cast<int32_t>(maxY); ++cellY) {
+            for (int32_t cellX = static_cast<int32_t>(minX); cellX <= static_cast<int32_t>(maxX); ++cellX) {
+                const uint32_t bucket = getBucket(cellX, cellY);
+                for (uint32_t slot = _bucketOffsets[bucket]; slot < _bucketOffsets[bucket + 1]; ++slot) {
+                    if (_cellX[slot] == cellX && _cellY[slot] == cellY) test(slot);
+                }
+            }
+        }
+    }
+
+    uint32_t count = static_cast<uint32_t>(found.size());
+    if (count > maxResults) {
+        std::partial_sort(found.begin(), found.begin() + maxResults, found.end());
+        count = maxResults;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        results[i] = found[i].second;
+    }
+    return count;
+}
+
+} // namespace navigation
+} // namespace cc
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "base/Macros.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace cc {
+namespace navigation {
+
+// Agents on the x, y plane bucketed by the cells of a uniform grid, rebuilt from their positions when they moved.
+// The cells hash into a table of about twice the agent count, the agents of a bucket are stored together
+// sorted by bucket, so a query reads a few short runs of memory. Queries run from any thread once built.
+class CC_DLL SpatialHash {
+public:
+    static constexpr uint32_t NO_AGENT = 0xffffffff;
+
+    // positions holds x, y pairs, a cell size about the usual query radius keeps the queries to 4 cells.
+    void build(const float *positions, uint32_t count, float cellSize);
+
+    // Writes the indices of the agents within radius of x, y, excluded left out, the nearest first when more than
+    // maxResults are found. Returns the number written.
+    uint32_t queryRadius(float x, float y, float radius, uint32_t excluded, uint32_t *results, uint32_t maxResults) const;
+
+    CC_INLINE uint32_t getAgentCount() const { return static_cast<uint32_t>(_agents.size()); }
+
+private:
+    CC_INLINE uint32_t getBucket(int32_t cellX, int32_t cellY) const {
+        const uint32_t hash = static_cast<uint32_t>(cellX) * 73856093U ^ static_cast<uint32_t>(cellY) * 19349663U;
+        return hash & _bucketMask;
+    }
+
+    float _cellSize = 1.F;
+    uint32_t _bucketMask = 0;
+    std::vector<uint32_t> _bucketOffsets; // bucket count + 1 offsets into the sorted agents
+
+    // sorted by bucket, a bucket mixes the agents of the cells hashing to it
+    std::vector<uint32_t> _agents;
+    std::vector<float> _x;
+    std::vector<float> _y;
+    std::vector<int32_t> _cellX;
+    std::vector<int32_t> _cellY;
+    std::vector<uint32_t> _agentBuckets; // of the agents in input order
+    std::vector<uint32_t> _cursors;
+};
+
+} // namespace navigation
+} // namespace cc
@@ -27,8 +27,12 @@
 #include <set>
 #include <curl/curl.h>
 #include <deque>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
 
 #include "base/Scheduler.h"
+#include "base/StreamHash.h"
 #include "platform/FileUtils.h"
 #include "platform/Application.h"
 #include "network/Downloader.h"
@@ -42,12 +46,45 @@
 #define CC_CURL_POLL_TIMEOUT_MS 50
 #endif
 
+// a file is only split into ranges of at least this size
+#define MIN_CHUNK_SIZE (1024 * 1024)
+// the written ranges of the tasks receiving data are saved at this interval
+#define CHUNK_SAVE_INTERVAL_MS 1000
+#define CHUNK_FILE_SUFFIX ".chunks"
+#define MAX_IDLE_HANDLES 8
+// the transfers receive at most 1/SPEED_BURST_DIVISOR second of the speed limit at once
+#define SPEED_BURST_DIVISOR 4
+// the bytes written out of order are read back for the hash in pieces of this size
+#define HASH_READ_SIZE (16 * 1024)
+
 namespace cc { namespace network {
     using namespace std;
 
 ////////////////////////////////////////////////////////////////////////////////
 //  Implementation DownloadTaskCURL
 
+    class DownloadTaskCURL;
+
+    // the bytes the transfers may still receive, refilled at the speed limit, only used in work thread
+    struct SpeedLimit
+    {
+        int64_t tokens;
+        bool paused;    // a transfer returned CURL_WRITEFUNC_PAUSE
+    };
+
+    // a range [begin, end) of a file task downloaded by its own curl handle, only used in work thread
+    struct DownloadChunk
+    {
+        DownloadTaskCURL* task;
+        int64_t begin;
+        int64_t end;
+        int64_t written;
+        CURL* handle;
+        bool verified;  // the response is the partial content requested
+
+        int64_t remain() const { return end - begin - written; }
+    };
+
     class DownloadTaskCURL : public IDownloadTask
     {
         static int _sSerialId;
@@ -95,6 +132,7 @@ namespace cc { namespace network {
             _fileName = filename;
             _tempFileName = filename;
             _tempFileName.append(tempSuffix);
+            _chunkFileName = _tempFileName + CHUNK_FILE_SUFFIX;
 
             if (_sStoragePathSet.end() != _sStoragePathSet.find(_tempFileName))
             {
@@ -165,13 +203,259 @@ namespace cc { namespace network {
             _errDescription = desc;
         }
 
+        size_t writeChunkDataProc(DownloadChunk& chunk, unsigned char *buffer, size_t size, size_t count)
+        {
+            size_t len = size * count;
+            if (pauseForSpeedLimitProc())
+            {
+                return CURL_WRITEFUNC_PAUSE;
+            }
+            if (!chunk.verified)
+            {
+                // a server ignoring the range answers 200 with the whole file, it must not be written at the offset
+                long httpResponseCode = 0;
+                curl_easy_getinfo(chunk.handle, CURLINFO_RESPONSE_CODE, &httpResponseCode);
+                if (206 != httpResponseCode)
+                {
+                    return 0;
+                }
+                chunk.verified = true;
+            }
+
+            lock_guard<mutex> lock(_mutex);
+            size_t ret = static_cast<size_t>(std::min(static_cast<int64_t>(len), chunk.remain()));
+            if (nullptr == _fp || 0 != fseek(_fp, static_cast<long>(chunk.begin + chunk.written), SEEK_SET))
+            {
+                return 0;
+            }
+            int64_t offset = chunk.begin + chunk.written;
+            ret = fwrite(buffer, 1, ret, _fp);
+            if (ret)
+            {
+                chunk.written += ret;
+                _bytesReceived += ret;
+                _totalBytesReceived += ret;
+                consumeSpeedLimitProc(ret);
+                hashWrittenProc(offset, buffer, ret);
+            }
+            // the bytes beyond the range are dropped
+            return chunk.remain() ? ret : len;
+        }
+
+        // the ranges are saved after the file was flushed, they never claim more than it holds
+        void saveChunksProc()
+        {
+            int64_t written = 0;
+            for (auto& chunk : _chunks)
+            {
+                written += chunk.written;
+            }
+            if (written == _savedChunkBytes)
+            {
+                return;
+            }
+            {
+                lock_guard<mutex> lock(_mutex);
+                if (_fp)
+                {
+                    fflush(_fp);
+                }
+            }
+            FILE* fp = fopen(FileUtils::getInstance()->getSuitableFOpen(_chunkFileName).c_str(), "wb");
+            if (nullptr == fp)
+            {
+                return;
+            }
+            fprintf(fp, "%lld\n%s\n", static_cast<long long>(_totalBytesExpected), _validator.c_str());
+            for (auto& chunk : _chunks)
+            {
+                fprintf(fp, "%lld %lld %lld\n", static_cast<long long>(chunk.begin), static_cast<long long>(chunk.end), static_cast<long long>(chunk.written));
+            }
+            fclose(fp);
+            _savedChunkBytes = written;
+        }
+
+        // the saved ranges are only taken if they cover the same file
+        bool loadChunksProc(int64_t totalBytesExpected)
+        {
+            _chunks.clear();
+            FILE* fp = fopen(FileUtils::getInstance()->getSuitableFOpen(_chunkFileName).c_str(), "rb");
+            if (nullptr == fp)
+            {
+                return false;
+            }
+            bool ret = false;
+            do
+            {
+                long long total = 0;
+                char validator[256] = {0};
+                if (1 != fscanf(fp, "%lld\n", &total) || total != totalBytesExpected)
+                {
+                    break;
+                }
+                if (nullptr == fgets(validator, sizeof(validator), fp))
+                {
+                    break;
+                }
+                string savedValidator = validator;
+                while (savedValidator.length() && (savedValidator.back() == '\n' || savedValidator.back() == '\r'))
+                {
+                    savedValidator.pop_back();
+                }
+                if (savedValidator != _validator)
+                {
+                    break;
+                }
+
+                long long begin = 0, end = 0, written = 0;
+                int64_t next = 0;
+                while (3 == fscanf(fp, "%lld %lld %lld", &begin, &end, &written))
+                {
+                    if (begin != next || end <= begin || written < 0 || written > end - begin)
+                    {
+                        break;
+                    }
+                    _chunks.push_back({this, begin, end, written, nullptr, false});
+                    next = end;
+                }
+                ret = _chunks.size() && next == totalBytesExpected;
+            } while (0);
+            fclose(fp);
+
+            if (!ret)
+            {
+                _chunks.clear();
+            }
+            return ret;
+        }
+
+        // reopens the temp file, "wb" drops what it holds
+        bool reopenFileProc(const char* mode)
+        {
+            lock_guard<mutex> lock(_mutex);
+            if (_fp)
+            {
+                fclose(_fp);
+            }
+            _fp = fopen(FileUtils::getInstance()->getSuitableFOpen(_tempFileName).c_str(), mode);
+            return nullptr != _fp;
+        }
+
+        // a file task is hashed in order, the bytes written ahead of _hashedBytes are read back from the file
+        void resetHashProc()
+        {
+            _hash.reset(_tempFileName.empty() ? nullptr : StreamHash::create(_hashAlgorithm));
+            _hashedBytes = 0;
+        }
+
+        // the bytes written from the beginning of the file without a gap
+        int64_t writtenPrefixProc() const
+        {
+            if (_chunks.empty())
+            {
+                return _totalBytesReceived;
+            }
+            for (auto& chunk : _chunks)
+            {
+                if (chunk.remain())
+                {
+                    return chunk.begin + chunk.written;
+                }
+            }
+            return _chunks.back().end;
+        }
+
+        void hashFileProc(int64_t end)
+        {
+            if (!_hash || _hashedBytes >= end || nullptr == _fp)
+            {
+                return;
+            }
+            fflush(_fp);
+            FILE* fp = fopen(FileUtils::getInstance()->getSuitableFOpen(_tempFileName).c_str(), "rb");
+            if (nullptr == fp || 0 != fseek(fp, static_cast<long>(_hashedBytes), SEEK_SET))
+            {
+                _hash.reset();
+            }
+            unsigned char buf[HASH_READ_SIZE];
+            while (_hash && _hashedBytes < end)
+            {
+                size_t len = fread(buf, 1, static_cast<size_t>(std::min(static_cast<int64_t>(sizeof(buf)), end - _hashedBytes)), fp);
+                if (0 == len)
+                {
+                    _hash.reset();
+                    break;
+                }
+                _hash->update(buf, len);
+                _hashedBytes += len;
+            }
+            if (fp)
+            {
+                fclose(fp);
+            }
+        }
+
+        void hashWrittenProc(int64_t offset, const unsigned char* buffer, size_t len)
+        {
+            if (!_hash)
+            {
+                return;
+            }
+            if (_hashedBytes < offset && offset <= writtenPrefixProc())
+            {
+                hashFileProc(offset);
+            }
+            if (_hash && _hashedBytes == offset)
+            {
+                _hash->update(buffer, len);
+                _hashedBytes += len;
+            }
+        }
+
+        void finishHashProc()
+        {
+            hashFileProc(writtenPrefixProc());
+            if (_hash)
+            {
+                hash = _hash->hexDigest();
+                _hash.reset();
+            }
+        }
+
+        // the data is delivered again when the transfer is resumed
+        bool pauseForSpeedLimitProc()
+        {
+            if (_speedLimit && _speedLimit->tokens <= 0)
+            {
+                _speedLimit->paused = true;
+                return true;
+            }
+            return false;
+        }
+
+        void consumeSpeedLimitProc(size_t len)
+        {
+            if (_speedLimit)
+            {
+                _speedLimit->tokens -= static_cast<int64_t>(len);
+            }
+        }
+
         size_t writeDataProc(unsigned char *buffer, size_t size, size_t count)
         {
+            if (pauseForSpeedLimitProc())
+            {
+                return CURL_WRITEFUNC_PAUSE;
+            }
             lock_guard<mutex> lock(_mutex);
             size_t ret = 0;
             if (_fp)
             {
                 ret = fwrite(buffer, size, count, _fp);
+                if (ret)
+                {
+                    hashWrittenProc(_totalBytesReceived, buffer, ret);
+                }
             }
             else
             {
@@ -188,6 +472,7 @@ namespace cc { namespace network {
             {
                 _bytesReceived += ret;
                 _totalBytesReceived += ret;
+                consumeSpeedLimitProc(ret);
             }
             return ret;
         }
@@ -220,6 +505,19 @@ namespace cc { namespace network {
         vector<unsigned char> _buf;
         FILE*  _fp;
 
+        // for ranges downloaded at once, only used in work thread
+        string _chunkFileName;
+        string _validator;          // ETag of the file, the saved ranges are dropped when it changes
+        vector<DownloadChunk> _chunks;
+        size_t _runningChunkCount;
+        int64_t _savedChunkBytes;
+        SpeedLimit* _speedLimit;    // nullptr without speed limit, only used in work thread
+
+        // for hashing the file while it's written, only used in work thread
+        string _hashAlgorithm;
+        unique_ptr<StreamHash> _hash;
+        int64_t _hashedBytes;
+
         void _initInternal()
         {
             _acceptRanges = (false);
@@ -231,6 +529,13 @@ namespace cc { namespace network {
             _errCodeInternal = (CURLE_OK);
             _header.resize(0);
             _header.reserve(384);   // pre alloc header string buffer
+            _validator.clear();
+            _chunks.clear();
+            _runningChunkCount = 0;
+            _savedChunkBytes = -1;
+            _speedLimit = nullptr;
+            _hash.reset();
+            _hashedBytes = 0;
         }
     };
     int DownloadTaskCURL::_sSerialId;
@@ -330,6 +635,252 @@ namespace cc { namespace network {
             return coTask->writeDataProc((unsigned char *)buffer, size, count);
         }
 
+        static size_t _outputChunkDataCallbackProc(void *buffer, size_t size, size_t count, void *userdata)
+        {
+            DownloadChunk *chunk = (DownloadChunk*)userdata;
+            return chunk->task->writeChunkDataProc(*chunk, (unsigned char *)buffer, size, count);
+        }
+
+        // the value of the header in the last response of the redirects, empty if it's not there
+        static string _getHeaderValue(const string& header, const string& name)
+        {
+            string value;
+            size_t lineBegin = 0;
+            while (lineBegin < header.length())
+            {
+                size_t lineEnd = header.find('\n', lineBegin);
+                if (string::npos == lineEnd)
+                {
+                    lineEnd = header.length();
+                }
+                size_t colon = lineBegin + name.length();
+                if (colon < lineEnd && ':' == header[colon]
+                    && std::equal(name.begin(), name.end(), header.begin() + lineBegin, [](char a, char b) { return ::tolower(a) == ::tolower(b); }))
+                {
+                    size_t first = header.find_first_not_of(" \t", colon + 1);
+                    size_t last = header.find_last_not_of(" \t\r", lineEnd - 1);
+                    value = (string::npos == first || first > last || last >= lineEnd) ? string() : header.substr(first, last - first + 1);
+                }
+                else if (0 == header.compare(lineBegin, 5, "HTTP/"))
+                {
+                    value.clear();
+                }
+                lineBegin = lineEnd + 1;
+            }
+            return value;
+        }
+
+        // only used in work thread
+        CURL* _acquireHandleProc()
+        {
+            if (_idleHandles.empty())
+            {
+                return curl_easy_init();
+            }
+            CURL* handle = _idleHandles.back();
+            _idleHandles.pop_back();
+            return handle;
+        }
+
+        // the handle keeps its connection to the host for the next task
+        void _releaseHandleProc(CURL* handle)
+        {
+            if (_idleHandles.size() < MAX_IDLE_HANDLES)
+            {
+                curl_easy_reset(handle);
+                _idleHandles.push_back(handle);
+            }
+            else
+            {
+                curl_easy_cleanup(handle);
+            }
+        }
+
+        // splits the task into ranges if it's large enough, or takes the ranges saved by the interrupted download
+        bool _prepareChunksProc(DownloadTaskCURL& coTask)
+        {
+            if (coTask._chunks.size())
+            {
+                return coTask.reopenFileProc("r+b");
+            }
+            uint32_t maxChunks = hints.countOfMaxChunksPerTask;
+            if (maxChunks < 2 || !coTask._acceptRanges || coTask._tempFileName.empty()
+                || coTask._totalBytesReceived > 0 || coTask._totalBytesExpected < 2 * MIN_CHUNK_SIZE)
+            {
+                return false;
+            }
+            if (!coTask.reopenFileProc("w+b"))
+            {
+                return false;
+            }
+            int64_t total = coTask._totalBytesExpected;
+            int64_t count = std::min(static_cast<int64_t>(maxChunks), total / MIN_CHUNK_SIZE);
+            int64_t chunkSize = total / count;
+            for (int64_t i = 0; i < count; ++i)
+            {
+                int64_t begin = i * chunkSize;
+                int64_t end = i == count - 1 ? total : begin + chunkSize;
+                coTask._chunks.push_back({&coTask, begin, end, 0, nullptr, false});
+            }
+            coTask.saveChunksProc();
+            return true;
+        }
+
+        // adds a handle for every range not downloaded yet, returns false with the error set if one fails
+        bool _startChunksProc(CURLM* curlmHandle, TaskWrapper& wrapper, unordered_map<CURL*, TaskWrapper>& coTaskMap)
+        {
+            DownloadTaskCURL& coTask = *wrapper.second;
+            for (auto& chunk : coTask._chunks)
+            {
+                if (0 == chunk.remain())
+                {
+                    continue;
+                }
+                CURL* handle = _acquireHandleProc();
+                if (nullptr == handle)
+                {
+                    coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, 0, "Alloc curl handle failed.");
+                    break;
+                }
+                _initCurlHandleProc(handle, wrapper, true);
+                char range[64] = {0};
+                snprintf(range, sizeof(range), "%lld-%lld", static_cast<long long>(chunk.begin + chunk.written), static_cast<long long>(chunk.end - 1));
+                curl_easy_setopt(handle, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)0);
+                curl_easy_setopt(handle, CURLOPT_RANGE, range);
+                curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, DownloaderCURL::Impl::_outputChunkDataCallbackProc);
+                curl_easy_setopt(handle, CURLOPT_WRITEDATA, &chunk);
+                curl_easy_setopt(handle, CURLOPT_PRIVATE, &chunk);
+
+                CURLMcode mcode = curl_multi_add_handle(curlmHandle, handle);
+                if (CURLM_OK != mcode)
+                {
+                    _releaseHandleProc(handle);
+                    coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, mcode, curl_multi_strerror(mcode));
+                    break;
+                }
+                chunk.handle = handle;
+                chunk.verified = false;
+                coTaskMap[handle] = wrapper;
+                ++coTask._runningChunkCount;
+            }
+            if (DownloadTask::ERROR_NO_ERROR != coTask._errCode)
+            {
+                _stopChunksProc(curlmHandle, coTask, coTaskMap);
+                return false;
+            }
+            return coTask._runningChunkCount > 0;
+        }
+
+        void _stopChunksProc(CURLM* curlmHandle, DownloadTaskCURL& coTask, unordered_map<CURL*, TaskWrapper>& coTaskMap)
+        {
+            for (auto& chunk : coTask._chunks)
+            {
+                if (chunk.handle)
+                {
+                    curl_multi_remove_handle(curlmHandle, chunk.handle);
+                    coTaskMap.erase(chunk.handle);
+                    _releaseHandleProc(chunk.handle);
+                    chunk.handle = nullptr;
+                }
+            }
+            coTask._runningChunkCount = 0;
+        }
+
+        // the bytes received by all transfers are drawn from a bucket refilled at the speed limit, the transfers
+        // pause themselves while it's empty, so the socket buffers fill and the peers slow down
+        void _refillSpeedLimitProc(unordered_map<CURL*, TaskWrapper>& coTaskMap)
+        {
+            if (0 == hints.maxBytesPerSecond)
+            {
+                return;
+            }
+            auto now = chrono::steady_clock::now();
+            int64_t elapsedUS = chrono::duration_cast<chrono::microseconds>(now - _speedTime).count();
+            _speedTime = now;
+            const int64_t maxTokens = hints.maxBytesPerSecond / SPEED_BURST_DIVISOR;
+            _speedLimit.tokens = std::min(_speedLimit.tokens + static_cast<int64_t>(hints.maxBytesPerSecond) * elapsedUS / 1000000, maxTokens);
+
+            if (_speedLimit.paused && _speedLimit.tokens > 0)
+            {
+                // resuming a transfer which isn't paused does nothing
+                _speedLimit.paused = false;
+                for (auto& item : coTaskMap)
+                {
+                    curl_easy_pause(item.first, CURLPAUSE_CONT);
+                }
+            }
+        }
+
+        // the server answered a range with the whole file, the ranges are dropped and the file is downloaded in one piece
+        bool _restartWithoutRangesProc(CURLM* curlmHandle, TaskWrapper& wrapper, unordered_map<CURL*, TaskWrapper>& coTaskMap)
+        {
+            DownloadTaskCURL& coTask = *wrapper.second;
+            coTask._chunks.clear();
+            FileUtils::getInstance()->removeFile(coTask._chunkFileName);
+            if (!coTask.reopenFileProc("wb"))
+            {
+                coTask.setErrorProc(DownloadTask::ERROR_FILE_OP_FAILED, 0, "Can't reopen file.");
+                return false;
+            }
+            {
+                lock_guard<mutex> lock(coTask._mutex);
+                coTask._acceptRanges = false;
+                coTask._totalBytesReceived = 0;
+            }
+            coTask.resetHashProc();
+
+            CURL* handle = _acquireHandleProc();
+            if (nullptr == handle)
+            {
+                coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, 0, "Alloc curl handle failed.");
+                return false;
+            }
+            _initCurlHandleProc(handle, wrapper, true);
+            CURLMcode mcode = curl_multi_add_handle(curlmHandle, handle);
+            if (CURLM_OK != mcode)
+            {
+                _releaseHandleProc(handle);
+                coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, mcode, curl_multi_strerror(mcode));
+                return false;
+            }
+            coTaskMap[handle] = wrapper;
+            return true;
+        }
+
+        void _finishTaskProc(TaskWrapper& wrapper)
+        {
+            DownloadTaskCURL& coTask = *wrapper.second;
+            if (DownloadTask::ERROR_NO_ERROR == coTask._errCode)
+            {
+                coTask.finishHashProc();
+            }
+            if (coTask._chunks.size())
+            {
+                if (DownloadTask::ERROR_NO_ERROR == coTask._errCode)
+                {
+                    FileUtils::getInstance()->removeFile(coTask._chunkFileName);
+                }
+                else
+                {
+                    coTask.saveChunksProc();
+                }
+            }
+
+            // remove from _processSet
+            {
+                lock_guard<mutex> lock(_processMutex);
+                if (_processSet.end() != _processSet.find(wrapper)) {
+                    _processSet.erase(wrapper);
+                }
+            }
+
+            // add to finishedQueue
+            {
+                lock_guard<mutex> lock(_finishedMutex);
+                _finishedQueue.push_back(wrapper);
+            }
+        }
+
         // this function designed call in work thread
         // the curl handle destroyed in _threadProc
         // handle inited for get header
@@ -358,6 +909,7 @@ namespace cc { namespace network {
 
             curl_easy_setopt(handle, CURLOPT_FAILONERROR, true);
             curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+            curl_easy_setopt(handle, CURLOPT_SHARE, _shareHandle);
 
             if (forContent)
             {
@@ -432,12 +984,32 @@ namespace cc { namespace network {
                 }
 
                 bool acceptRanges = (string::npos != coTask._header.find("Accept-Ranges")) ? true : false;
+                coTask._validator = _getHeaderValue(coTask._header, "ETag");
 
                 // get current file size
                 int64_t fileSize = 0;
-                if (acceptRanges && coTask._tempFileName.length())
+                if (coTask._tempFileName.length())
                 {
-                    fileSize = FileUtils::getInstance()->getFileSize(coTask._tempFileName);
+                    auto util = FileUtils::getInstance();
+                    if (acceptRanges && coTask.loadChunksProc((int64_t)contentLen))
+                    {
+                        // the temp file has holes, only the saved ranges count
+                        fileSize = 0;
+                        for (auto& chunk : coTask._chunks)
+                        {
+                            fileSize += chunk.written;
+                        }
+                    }
+                    else if (util->isFileExist(coTask._chunkFileName))
+                    {
+                        // the ranges were written for another version of the file
+                        util->removeFile(coTask._chunkFileName);
+                        coTask.reopenFileProc("wb");
+                    }
+                    else if (acceptRanges)
+                    {
+                        fileSize = util->getFileSize(coTask._tempFileName);
+                    }
                 }
 
                 // set header info to coTask
@@ -467,7 +1039,17 @@ namespace cc { namespace network {
             uint32_t countOfMaxProcessingTasks = this->hints.countOfMaxProcessingTasks;
             // init curl content
             CURLM* curlmHandle = curl_multi_init();
+            // the tasks resolve the hosts and resume the tls sessions once
+            _shareHandle = curl_share_init();
+            curl_share_setopt(_shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+            curl_share_setopt(_shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+            // a chunked task has a handle for every range
             unordered_map<CURL*, TaskWrapper> coTaskMap;
+            uint32_t countOfProcessingTasks = 0;
+            _speedTime = chrono::steady_clock::now();
+            _speedLimit.tokens = this->hints.maxBytesPerSecond / SPEED_BURST_DIVISOR;
+            _speedLimit.paused = false;
+            auto lastChunkSaveTime = chrono::steady_clock::now();
             int runningHandles = 0;
             CURLMcode mcode = CURLM_OK;
             int rc = 0;                 // select return code
@@ -555,20 +1137,63 @@ namespace cc { namespace network {
                             CURLcode errCode = m->data.result;
 
                             TaskWrapper wrapper = coTaskMap[curlHandle];
+                            DownloadTaskCURL& coTask = *wrapper.second;
+                            DownloadChunk* chunk = nullptr;
+                            curl_easy_getinfo(curlHandle, CURLINFO_PRIVATE, (char**)&chunk);
 
                             // remove from multi-handle
                             curl_multi_remove_handle(curlmHandle, curlHandle);
+
+                            if (chunk)
+                            {
+                                // a range of a chunked task
+                                chunk->handle = nullptr;
+                                coTaskMap.erase(curlHandle);
+                                _releaseHandleProc(curlHandle);
+                                --coTask._runningChunkCount;
+
+                                if (CURLE_WRITE_ERROR == errCode && !chunk->verified && DownloadTask::ERROR_NO_ERROR == coTask._errCode)
+                                {
+                                    _stopChunksProc(curlmHandle, coTask, coTaskMap);
+                                    if (_restartWithoutRangesProc(curlmHandle, wrapper, coTaskMap))
+                                    {
+                                        continue;
+                                    }
+                                }
+                                else if (CURLE_OK != errCode)
+                                {
+                                    coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, errCode, curl_easy_strerror(errCode));
+                                }
+                                else if (chunk->remain())
+                                {
+                                    coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, CURLE_PARTIAL_FILE, curl_easy_strerror(CURLE_PARTIAL_FILE));
+                                }
+
+                                // the ranges still downloading are stopped by the first failed one
+                                if (DownloadTask::ERROR_NO_ERROR != coTask._errCode)
+                                {
+                                    _stopChunksProc(curlmHandle, coTask, coTaskMap);
+                                }
+                                if (0 == coTask._runningChunkCount)
+                                {
+                                    _finishTaskProc(wrapper);
+                                    --countOfProcessingTasks;
+                                }
+                                continue;
+                            }
+
                             bool reinited = false;
+                            bool chunked = false;
                             do
                             {
                                 if (CURLE_OK != errCode)
                                 {
-                                    wrapper.second->setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, errCode, curl_easy_strerror(errCode));
+                                    coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, errCode, curl_easy_strerror(errCode));
                                     break;
                                 }
 
                                 // if the task is content download task, cleanup the handle
-                                if (wrapper.second->_headerAchieved)
+                                if (coTask._headerAchieved)
                                 {
                                     break;
                                 }
@@ -584,20 +1209,28 @@ namespace cc { namespace network {
                                 // after get header info success
                                 // wrapper.second->_totalBytesReceived inited by local file size
                                 // if the local file size equal with the content size from header, the file has downloaded finish
-                                if (wrapper.second->_totalBytesReceived &&
-                                    wrapper.second->_totalBytesReceived == wrapper.second->_totalBytesExpected)
+                                if (coTask._totalBytesReceived &&
+                                    coTask._totalBytesReceived == coTask._totalBytesExpected)
                                 {
                                     // the file has download complete
                                     // break to move this task to finish queue
                                     break;
                                 }
+
+                                // a large file is downloaded in ranges by their own handles
+                                if (_prepareChunksProc(coTask))
+                                {
+                                    chunked = _startChunksProc(curlmHandle, wrapper, coTaskMap);
+                                    break;
+                                }
+
                                 // reinit curl handle for download content
                                 curl_easy_reset(curlHandle);
                                 _initCurlHandleProc(curlHandle, wrapper, true);
                                 mcode = curl_multi_add_handle(curlmHandle, curlHandle);
                                 if (CURLM_OK != mcode)
                                 {
-                                    wrapper.second->setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, mcode, curl_multi_strerror(mcode));
+                                    coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, mcode, curl_multi_strerror(mcode));
                                     break;
                                 }
                                 reinited = true;
@@ -607,32 +1240,40 @@ namespace cc { namespace network {
                             {
                                 continue;
                             }
-                            curl_easy_cleanup(curlHandle);
-                            DLLOG("    _threadProc task clean cur handle :%p with errCode:%d",  curlHandle, errCode);
+                            DLLOG("    _threadProc task release curl handle :%p with errCode:%d",  curlHandle, errCode);
 
                            // remove from coTaskMap
                             coTaskMap.erase(curlHandle);
+                            _releaseHandleProc(curlHandle);
 
-                            // remove from _processSet
+                            if (chunked)
                             {
-                                lock_guard<mutex> lock(_processMutex);
-                                if (_processSet.end() != _processSet.find(wrapper)) {
-                                    _processSet.erase(wrapper);
-                                }
+                                continue;
                             }
+                            _finishTaskProc(wrapper);
+                            --countOfProcessingTasks;
+                        }
+                    } while(m);
+
+                    _refillSpeedLimitProc(coTaskMap);
 
-                            // add to finishedQueue
+                    // save the ranges written by the chunked tasks
+                    auto now = chrono::steady_clock::now();
+                    if (chrono::duration_cast<chrono::milliseconds>(now - lastChunkSaveTime).count() >= CHUNK_SAVE_INTERVAL_MS)
+                    {
+                        lastChunkSaveTime = now;
+                        for (auto& item : coTaskMap)
+                        {
+                            if (item.second.second->_chunks.size())
                             {
-                                lock_guard<mutex> lock(_finishedMutex);
-                                _finishedQueue.push_back(wrapper);
+                                item.second.second->saveChunksProc();
                             }
                         }
-                    } while(m);
+                    }
                 }
 
                 // process tasks in _requestList
-                auto size = coTaskMap.size();
-                while (0 == countOfMaxProcessingTasks || size < countOfMaxProcessingTasks)
+                while (0 == countOfMaxProcessingTasks || countOfProcessingTasks < countOfMaxProcessingTasks)
                 {
                     // get task wrapper from request queue
                     TaskWrapper wrapper;
@@ -652,9 +1293,12 @@ namespace cc { namespace network {
                     }
 
                     wrapper.second->initProc();
+                    wrapper.second->_speedLimit = this->hints.maxBytesPerSecond ? &_speedLimit : nullptr;
+                    wrapper.second->_hashAlgorithm = wrapper.first->hashAlgorithm;
+                    wrapper.second->resetHashProc();
 
                     // create curl handle from task and add into curl multi handle
-                    CURL* curlHandle = curl_easy_init();
+                    CURL* curlHandle = _acquireHandleProc();
 
                     if (nullptr == curlHandle)
                     {
@@ -671,6 +1315,7 @@ namespace cc { namespace network {
                     mcode = curl_multi_add_handle(curlmHandle, curlHandle);
                     if (CURLM_OK != mcode)
                     {
+                        _releaseHandleProc(curlHandle);
                         wrapper.second->setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, mcode, curl_multi_strerror(mcode));
                         lock_guard<mutex> lock(_finishedMutex);
                         _finishedQueue.push_back(wrapper);
@@ -679,16 +1324,36 @@ namespace cc { namespace network {
 
                     DLLOG("    _threadProc task create curl handle:%p", curlHandle);
                     coTaskMap[curlHandle] = wrapper;
+                    ++countOfProcessingTasks;
                     lock_guard<mutex> lock(_processMutex);
                     _processSet.insert(wrapper);
                 }
             } while (coTaskMap.size());
 
+            // the thread stopped with transfers running, the handles are cleaned up with the multi handle
+            for (auto& item : coTaskMap)
+            {
+                curl_multi_remove_handle(curlmHandle, item.first);
+                curl_easy_cleanup(item.first);
+            }
+            for (auto handle : _idleHandles)
+            {
+                curl_easy_cleanup(handle);
+            }
+            _idleHandles.clear();
             curl_multi_cleanup(curlmHandle);
+            curl_share_cleanup(_shareHandle);
+            _shareHandle = nullptr;
             this->stop();
             DLLOG("----DownloaderCURL::Impl::_threadProc end");
         }
 
+        // only used in work thread
+        CURLSH* _shareHandle = nullptr;
+        vector<CURL*> _idleHandles;
+        chrono::steady_clock::time_point _speedTime;
+        SpeedLimit _speedLimit = {0, false};
+
         thread _thread;
         deque<TaskWrapper>  _requestQueue;
         set<TaskWrapper>    _processSet;
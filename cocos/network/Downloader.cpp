@@ -56,6 +56,11 @@ namespace cc { namespace network {
         DLLOG("Destruct DownloadTask %p", this);
     }
 
+    std::string DownloadTask::getHash() const
+    {
+        return _coTask ? _coTask->hash : "";
+    }
+
 ////////////////////////////////////////////////////////////////////////////////
 //  Implement Downloader
     Downloader::Downloader()
@@ -64,7 +69,9 @@ namespace cc { namespace network {
         {
             6,
             45,
-            ".tmp"
+            ".tmp",
+            0,
+            0
         };
         new(this)Downloader(hints);
     }
@@ -150,7 +157,8 @@ namespace cc { namespace network {
     std::shared_ptr<const DownloadTask> Downloader::createDownloadFileTask(const std::string& srcUrl,
                                                                            const std::string& storagePath,
                                                                            const std::map<std::string, std::string> &header,
-                                                                           const std::string& identifier/* = ""*/)
+                                                                           const std::string& identifier/* = ""*/,
+                                                                           const std::string& hashAlgorithm/* = ""*/)
     {
         DownloadTask *task_ = new (std::nothrow) DownloadTask();
         std::shared_ptr<const DownloadTask> task(task_);
@@ -160,6 +168,7 @@ namespace cc { namespace network {
             task_->storagePath   = storagePath;
             task_->identifier    = identifier;
             task_->header        = header;
+            task_->hashAlgorithm = hashAlgorithm;
             if (0 == srcUrl.length() || 0 == storagePath.length())
             {
                 if (onTaskError)
@@ -176,9 +185,10 @@ namespace cc { namespace network {
     }
     std::shared_ptr<const DownloadTask> Downloader::createDownloadFileTask(const std::string& srcUrl,
                                                                            const std::string& storagePath,
-                                                                           const std::string& identifier/* = ""*/) {
+                                                                           const std::string& identifier/* = ""*/,
+                                                                           const std::string& hashAlgorithm/* = ""*/) {
         const std::map<std::string, std::string> emptyHeader;
-        return createDownloadFileTask(srcUrl, storagePath, emptyHeader, identifier);
+        return createDownloadFileTask(srcUrl, storagePath, emptyHeader, identifier, hashAlgorithm);
     }
 
     void Downloader::abort(const DownloadTask& task) {
@@ -53,10 +53,16 @@ namespace cc { namespace network {
         std::string requestURL;
         std::string storagePath;
         std::map<std::string, std::string> header;
+        // a file task is hashed with this algorithm of StreamHash while it's written, see getHash()
+        std::string hashAlgorithm;
 
         DownloadTask();
         virtual ~DownloadTask();
 
+        // The lowercase hex digest of a file task which succeeded, empty without hashAlgorithm
+        // or if the implementation couldn't hash the file while downloading it.
+        std::string getHash() const;
+
     private:
         friend class Downloader;
         std::unique_ptr<IDownloadTask> _coTask;
@@ -67,6 +73,12 @@ namespace cc { namespace network {
         uint32_t countOfMaxProcessingTasks;
         uint32_t timeoutInSeconds;
         std::string tempFileNameSuffix;
+        // The hints below are only used by the curl implementation, 0 turns them off.
+        // A large file task of a server accepting ranges is downloaded in up to this many ranges at once.
+        // The ranges written are saved beside the temp file, an interrupted task resumes the missing ones.
+        uint32_t countOfMaxChunksPerTask;
+        // the bytes per second all tasks of the downloader receive at most together
+        uint32_t maxBytesPerSecond;
     };
 
     class CC_DLL Downloader final
@@ -105,9 +117,9 @@ namespace cc { namespace network {
 
         std::shared_ptr<const DownloadTask> createDownloadDataTask(const std::string& srcUrl, const std::string& identifier = "");
 
-        std::shared_ptr<const DownloadTask> createDownloadFileTask(const std::string& srcUrl, const std::string& storagePath, const std::string& identifier = "");
+        std::shared_ptr<const DownloadTask> createDownloadFileTask(const std::string& srcUrl, const std::string& storagePath, const std::string& identifier = "", const std::string& hashAlgorithm = "");
 
-        std::shared_ptr<const DownloadTask> createDownloadFileTask(const std::string& srcUrl, const std::string& storagePath, const std::map<std::string, std::string>& header, const std::string& identifier = "");
+        std::shared_ptr<const DownloadTask> createDownloadFileTask(const std::string& srcUrl, const std::string& storagePath, const std::map<std::string, std::string>& header, const std::string& identifier = "", const std::string& hashAlgorithm = "");
 
         void abort(const DownloadTask& task);
 
@@ -48,6 +48,9 @@ namespace cc { namespace network
     {
     public:
         virtual ~IDownloadTask(){}
+
+        // set by the implementations hashing DownloadTask::hashAlgorithm before the task finishes
+        std::string hash;
     };
 
     class IDownloaderImpl
@@ -29,6 +29,9 @@
 #if (CC_PLATFORM == CC_PLATFORM_ANDROID)
 
 #include "network/HttpClient.h"
+#include "base/ThreadConfig.h"
+#include "base/ThreadPool.h"
+#include "base/memory/MemTracker.h"
 
 #include <queue>
 #include <sstream>
@@ -50,8 +53,6 @@ namespace cc {
 
 namespace network {
     
-typedef std::vector<std::string> HttpRequestHeaders;
-typedef HttpRequestHeaders::iterator HttpRequestHeadersIter;
 typedef std::vector<std::string> HttpCookies;
 typedef HttpCookies::iterator HttpCookiesIter;
 
@@ -81,9 +82,9 @@ static size_t writeData(void* buffer, size_t sizes, HttpResponse* response)
 //static size_t writeHeaderData(void *ptr, size_t size, size_t nmemb, void *stream)
 size_t writeHeaderData(void* buffer, size_t sizes,HttpResponse* response)
 {
-    std::vector<char> * recvBuffer = (std::vector<char>*) response->getResponseHeader();
-    recvBuffer->clear();
-    recvBuffer->insert(recvBuffer->end(), (char*)buffer, (char*)buffer + sizes);
+    HttpHeaders& headers = response->getResponseHeaders();
+    headers.clear();
+    headers.append((char*)buffer, sizes);
     return sizes;
 }
 
@@ -139,22 +140,22 @@ public:
             return false;
         }
         /* get custom header data (if set) */
-        HttpRequestHeaders headers=request->getHeaders();
-        if(!headers.empty())
+        const HttpHeaders& headers = request->getRequestHeaders();
+        /* append custom headers one by one, the lines without ':' are skipped */
+        std::string field;
+        std::string value;
+        for (size_t i = 0; i < headers.size(); ++i)
         {
-            /* append custom headers one by one */
-            for (auto& header : headers)
+            HttpHeaders::View line = headers.getLine(i);
+            HttpHeaders::View name = headers.getName(i);
+            if (name.size == line.size)
             {
-                int len = header.length();
-                int pos = header.find(':');
-                if (-1 == pos || pos >= len)
-                {
-                    continue;
-                }
-                std::string str1 = header.substr(0, pos);
-                std::string str2 = header.substr(pos + 1, len - pos - 1);
-                addRequestHeader(str1.c_str(), str2.c_str());
+                continue;
             }
+            HttpHeaders::View data = headers.getValue(i);
+            field.assign(name.data, name.size);
+            value.assign(data.data, data.size);
+            addRequestHeader(field.c_str(), value.c_str());
         }
         
         addCookiesForRequestHeader();
@@ -810,6 +811,8 @@ void HttpClient::processResponse(HttpResponse* response, char* responseMessage)
 void HttpClient::networkThread()
 {    
     increaseThreadCount();
+    CC_MEM_MODULE_SCOPE(NETWORK);
+    ThreadConfig::applyToCurrentThread(ThreadLane::IO);
 
     while (true) 
     {
@@ -821,8 +824,8 @@ void HttpClient::networkThread()
             while (_requestQueue.empty()) {
                 _sleepCondition.wait(_requestQueueMutex);
             }
-            request = _requestQueue.at(0);
-            _requestQueue.erase(0);
+            request = _requestQueue.front();
+            _requestQueue.pop_front();
         }
 
         if (request == _requestSentinel) {
@@ -830,12 +833,12 @@ void HttpClient::networkThread()
         }
         
         // Create a HttpResponse object, the default setting is http access failed
-        HttpResponse *response = new (std::nothrow) HttpResponse(request);
+        HttpResponse *response = obtainResponse(request);
         processResponse(response, _responseMessage);
         
         // add response packet into queue
         _responseQueueMutex.lock();
-        _responseQueue.pushBack(response);
+        _responseQueue.push_back(response);
         _responseQueueMutex.unlock();
         
         _schedulerMutex.lock();
@@ -848,6 +851,10 @@ void HttpClient::networkThread()
     
     // cleanup: if worker thread received quit signal, clean up un-completed request queue
     _requestQueueMutex.lock();
+    for (auto request : _requestQueue)
+    {
+        request->release();
+    }
     _requestQueue.clear();
     _requestQueueMutex.unlock();
     
@@ -862,6 +869,7 @@ void HttpClient::networkThread()
 void HttpClient::networkThreadAlone(HttpRequest* request, HttpResponse* response)
 {
     increaseThreadCount();
+    CC_MEM_MODULE_SCOPE(NETWORK);
 
     char responseMessage[RESPONSE_BUFFER_SIZE] = { 0 };
     processResponse(response, responseMessage);
@@ -877,9 +885,8 @@ void HttpClient::networkThreadAlone(HttpRequest* request, HttpResponse* response
                 callback(this, response);
             }
 
-            response->release();
             // do not release in other thread
-            request->release();
+            recycleResponse(response);
         });
     }
     _schedulerMutex.unlock();
@@ -920,7 +927,7 @@ void HttpClient::destroyInstance()
 
     {
         std::lock_guard<std::mutex> lock(thiz->_requestQueueMutex);
-        thiz->_requestQueue.pushBack(thiz->_requestSentinel);
+        thiz->_requestQueue.push_back(thiz->_requestSentinel);
     }
     thiz->_sleepCondition.notify_one();
 
@@ -951,6 +958,7 @@ HttpClient::HttpClient()
 : _isInited(false)
 , _timeoutForConnect(30)
 , _timeoutForRead(60)
+, _maxConcurrentRequests(16)
 , _threadCount(0)
 , _cookie(nullptr)
 , _requestSentinel(new HttpRequest())
@@ -962,6 +970,10 @@ HttpClient::HttpClient()
 
 HttpClient::~HttpClient()
 {
+    for (auto response : _reusedResponses)
+    {
+        response->release();
+    }
     CC_LOG_DEBUG("In the destructor of HttpClient!");
     CC_SAFE_RELEASE(_requestSentinel);
 }
@@ -999,7 +1011,7 @@ void HttpClient::send(HttpRequest* request)
     request->retain();
 
     _requestQueueMutex.lock();
-    _requestQueue.pushBack(request);
+    _requestQueue.push_back(request);
     _requestQueueMutex.unlock();
 
     // Notify thread start to work
@@ -1015,10 +1027,11 @@ void HttpClient::sendImmediate(HttpRequest* request)
 
     request->retain();
     // Create a HttpResponse object, the default setting is http access failed
-    HttpResponse *response = new (std::nothrow) HttpResponse(request);
+    HttpResponse *response = obtainResponse(request);
 
-    auto t = std::thread(&HttpClient::networkThreadAlone, this, request, response);
-    t.detach();
+    ThreadPool::getDefaultThreadPool()->pushTask([this, request, response](int /*threadId*/) {
+        networkThreadAlone(request, response);
+    }, ThreadPool::TaskType::NETWORK);
 }
 
 // Poll and notify main thread if responses exists in queue
@@ -1032,8 +1045,8 @@ void HttpClient::dispatchResponseCallbacks()
 
     if (!_responseQueue.empty())
     {
-        response = _responseQueue.at(0);
-        _responseQueue.erase(0);
+        response = _responseQueue.front();
+        _responseQueue.pop_front();
     }
 
     _responseQueueMutex.unlock();
@@ -1048,9 +1061,52 @@ void HttpClient::dispatchResponseCallbacks()
             callback(this, response);
         }
 
-        response->release();
         // do not release in other thread
-        request->release();
+        recycleResponse(response);
+    }
+}
+
+// The response takes over the reference send() took on the request
+HttpResponse* HttpClient::obtainResponse(HttpRequest* request)
+{
+    HttpResponse* response = nullptr;
+    _reusedResponsesMutex.lock();
+    if (!_reusedResponses.empty())
+    {
+        response = _reusedResponses.back();
+        _reusedResponses.pop_back();
+    }
+    _reusedResponsesMutex.unlock();
+
+    if (response == nullptr)
+    {
+        response = new (std::nothrow) HttpResponse(nullptr);
+    }
+    response->reuse(request);
+    return response;
+}
+
+// Releases the request after the response callback, the response is kept for the next request unless the callback retained it
+void HttpClient::recycleResponse(HttpResponse* response)
+{
+    if (response->getReferenceCount() > 1)
+    {
+        response->release();
+        return;
+    }
+
+    response->reuse(nullptr);
+    _reusedResponsesMutex.lock();
+    bool isReused = _reusedResponses.size() < static_cast<size_t>(MAX_REUSED_RESPONSES);
+    if (isReused)
+    {
+        _reusedResponses.push_back(response);
+    }
+    _reusedResponsesMutex.unlock();
+
+    if (!isReused)
+    {
+        response->release();
     }
 }
 
@@ -1101,6 +1157,19 @@ int HttpClient::getTimeoutForRead()
     std::lock_guard<std::mutex> lock(_timeoutForReadMutex);
     return _timeoutForRead;
 }
+
+// requests run one by one on the network thread of this platform, the limit is kept for the curl platforms
+void HttpClient::setMaxConcurrentRequests(int value)
+{
+    std::lock_guard<std::mutex> lock(_maxConcurrentRequestsMutex);
+    _maxConcurrentRequests = value;
+}
+
+int HttpClient::getMaxConcurrentRequests()
+{
+    std::lock_guard<std::mutex> lock(_maxConcurrentRequestsMutex);
+    return _maxConcurrentRequests;
+}
     
 const std::string& HttpClient::getCookieFilename()
 {
@@ -25,6 +25,9 @@
  THE SOFTWARE.
  ****************************************************************************/
 #include "network/HttpClient.h"
+#include "base/ThreadConfig.h"
+#include "base/ThreadPool.h"
+#include "base/memory/MemTracker.h"
 
 #include <queue>
 #include <errno.h>
@@ -46,6 +49,8 @@ static int processTask(HttpClient* client, HttpRequest *request, NSString *reque
 void HttpClient::networkThread()
 {
     increaseThreadCount();
+    CC_MEM_MODULE_SCOPE(NETWORK);
+    ThreadConfig::applyToCurrentThread(ThreadLane::IO);
     
     while (true) @autoreleasepool {
         
@@ -57,8 +62,8 @@ void HttpClient::networkThread()
             while (_requestQueue.empty()) {
                 _sleepCondition.wait(_requestQueueMutex);
             }
-            request = _requestQueue.at(0);
-            _requestQueue.erase(0);
+            request = _requestQueue.front();
+            _requestQueue.pop_front();
         }
 
         if (request == _requestSentinel) {
@@ -66,13 +71,13 @@ void HttpClient::networkThread()
         }
         
         // Create a HttpResponse object, the default setting is http access failed
-        HttpResponse *response = new (std::nothrow) HttpResponse(request);
+        HttpResponse *response = obtainResponse(request);
         
         processResponse(response, _responseMessage);
         
         // add response packet into queue
         _responseQueueMutex.lock();
-        _responseQueue.pushBack(response);
+        _responseQueue.push_back(response);
         _responseQueueMutex.unlock();
         
         _schedulerMutex.lock();
@@ -85,6 +90,10 @@ void HttpClient::networkThread()
     
     // cleanup: if worker thread received quit signal, clean up un-completed request queue
     _requestQueueMutex.lock();
+    for (auto request : _requestQueue)
+    {
+        request->release();
+    }
     _requestQueue.clear();
     _requestQueueMutex.unlock();
     
@@ -99,6 +108,7 @@ void HttpClient::networkThread()
 void HttpClient::networkThreadAlone(HttpRequest* request, HttpResponse* response)
 {
     increaseThreadCount();
+    CC_MEM_MODULE_SCOPE(NETWORK);
     
     char responseMessage[RESPONSE_BUFFER_SIZE] = { 0 };
     processResponse(response, responseMessage);
@@ -114,9 +124,8 @@ void HttpClient::networkThreadAlone(HttpRequest* request, HttpResponse* response
                 callback(this, response);
             }
 
-            response->release();
             // do not release in other thread
-            request->release();
+            recycleResponse(response);
         });
     }
     _schedulerMutex.unlock();
@@ -144,20 +153,15 @@ static int processTask(HttpClient* client, HttpRequest* request, NSString* reque
     [nsrequest setHTTPMethod:requestType];
 
     /* get custom header data (if set) */
-    std::vector<std::string> headers=request->getHeaders();
-    if(!headers.empty())
+    const HttpHeaders& headers = request->getRequestHeaders();
+    /* append custom headers one by one */
+    for (size_t i = 0; i < headers.size(); ++i)
     {
-        /* append custom headers one by one */
-        for (auto& header : headers)
-        {
-            unsigned long i = header.find(':', 0);
-            unsigned long length = header.size();
-            std::string field = header.substr(0, i);
-            std::string value = header.substr(i+1, length-i);
-            NSString *headerField = [NSString stringWithUTF8String:field.c_str()];
-            NSString *headerValue = [NSString stringWithUTF8String:value.c_str()];
-            [nsrequest setValue:headerValue forHTTPHeaderField:headerField];
-        }
+        HttpHeaders::View field = headers.getName(i);
+        HttpHeaders::View value = headers.getValue(i);
+        NSString *headerField = [[[NSString alloc] initWithBytes:field.data length:field.size encoding:NSUTF8StringEncoding] autorelease];
+        NSString *headerValue = [[[NSString alloc] initWithBytes:value.data length:value.size encoding:NSUTF8StringEncoding] autorelease];
+        [nsrequest setValue:headerValue forHTTPHeaderField:headerField];
     }
 
     //if request type is post or put,set header and data
@@ -262,22 +266,15 @@ static int processTask(HttpClient* client, HttpRequest* request, NSString* reque
     }
     
     //handle response header
-    NSMutableString *header = [NSMutableString string];
-    [header appendFormat:@"HTTP/1.1 %ld %@\n", (long)httpAsynConn.responseCode, httpAsynConn.statusString];
-    for (id key in httpAsynConn.responseHeader)
+    HttpHeaders *headerBuffer = (HttpHeaders*)headerStream;
+    const char *statusLine = [NSString stringWithFormat:@"HTTP/1.1 %ld %@", (long)httpAsynConn.responseCode, httpAsynConn.statusString].UTF8String;
+    headerBuffer->addLine(statusLine, strlen(statusLine));
+    for (NSString *key in httpAsynConn.responseHeader)
     {
-        [header appendFormat:@"%@: %@\n", key, [httpAsynConn.responseHeader objectForKey:key]];
+        const char *field = key.UTF8String;
+        const char *value = [[httpAsynConn.responseHeader objectForKey:key] UTF8String];
+        headerBuffer->add(field, strlen(field), value, strlen(value));
     }
-    if (header.length > 0)
-    {
-        NSRange range = NSMakeRange(header.length-1, 1);
-        [header deleteCharactersInRange:range];
-    }
-    NSData *headerData = [header dataUsingEncoding:NSUTF8StringEncoding];
-    std::vector<char> *headerBuffer = (std::vector<char>*)headerStream;
-    const void* headerptr = [headerData bytes];
-    long headerlen = [headerData length];
-    headerBuffer->insert(headerBuffer->end(), (char*)headerptr, (char*)headerptr+headerlen);
 
     //handle response data
     std::vector<char> *recvBuffer = (std::vector<char>*)stream;
@@ -321,7 +318,7 @@ void HttpClient::destroyInstance()
     thiz->_schedulerMutex.unlock();
     
     thiz->_requestQueueMutex.lock();
-    thiz->_requestQueue.pushBack(thiz->_requestSentinel);
+    thiz->_requestQueue.push_back(thiz->_requestSentinel);
     thiz->_requestQueueMutex.unlock();
 
     thiz->_sleepCondition.notify_one();
@@ -362,6 +359,7 @@ HttpClient::HttpClient()
 : _isInited(false)
 , _timeoutForConnect(30)
 , _timeoutForRead(60)
+, _maxConcurrentRequests(16)
 , _threadCount(0)
 , _cookie(nullptr)
 , _requestSentinel(new HttpRequest())
@@ -375,6 +373,10 @@ HttpClient::HttpClient()
 
 HttpClient::~HttpClient()
 {
+    for (auto response : _reusedResponses)
+    {
+        response->release();
+    }
     CC_SAFE_RELEASE(_requestSentinel);
     if (!_cookieFilename.empty() && nullptr != _cookie)
     {
@@ -417,7 +419,7 @@ void HttpClient::send(HttpRequest* request)
     request->retain();
 
     _requestQueueMutex.lock();
-    _requestQueue.pushBack(request);
+    _requestQueue.push_back(request);
     _requestQueueMutex.unlock();
 
     // Notify thread start to work
@@ -433,10 +435,13 @@ void HttpClient::sendImmediate(HttpRequest* request)
 
     request->retain();
     // Create a HttpResponse object, the default setting is http access failed
-    HttpResponse *response = new (std::nothrow) HttpResponse(request);
+    HttpResponse *response = obtainResponse(request);
 
-    auto t = std::thread(&HttpClient::networkThreadAlone, this, request, response);
-    t.detach();
+    ThreadPool::getDefaultThreadPool()->pushTask([this, request, response](int /*threadId*/) {
+        @autoreleasepool {
+            networkThreadAlone(request, response);
+        }
+    }, ThreadPool::TaskType::NETWORK);
 }
 
 // Poll and notify main thread if responses exists in queue
@@ -448,8 +453,8 @@ void HttpClient::dispatchResponseCallbacks()
     _responseQueueMutex.lock();
     if (!_responseQueue.empty())
     {
-        response = _responseQueue.at(0);
-        _responseQueue.erase(0);
+        response = _responseQueue.front();
+        _responseQueue.pop_front();
     }
     _responseQueueMutex.unlock();
 
@@ -463,9 +468,8 @@ void HttpClient::dispatchResponseCallbacks()
             callback(this, response);
         }
 
-        response->release();
         // do not release in other thread
-        request->release();
+        recycleResponse(response);
     }
 }
 
@@ -506,7 +510,7 @@ void HttpClient::processResponse(HttpResponse* response, char* responseMessage)
                            requestType,
                            response->getResponseData(),
                            &responseCode,
-                           response->getResponseHeader(),
+                           &response->getResponseHeaders(),
                            responseMessage);
 
     // write data to HttpResponse
@@ -524,6 +528,50 @@ void HttpClient::processResponse(HttpResponse* response, char* responseMessage)
 }
 
 
+// The response takes over the reference send() took on the request
+HttpResponse* HttpClient::obtainResponse(HttpRequest* request)
+{
+    HttpResponse* response = nullptr;
+    _reusedResponsesMutex.lock();
+    if (!_reusedResponses.empty())
+    {
+        response = _reusedResponses.back();
+        _reusedResponses.pop_back();
+    }
+    _reusedResponsesMutex.unlock();
+
+    if (response == nullptr)
+    {
+        response = new (std::nothrow) HttpResponse(nullptr);
+    }
+    response->reuse(request);
+    return response;
+}
+
+// Releases the request after the response callback, the response is kept for the next request unless the callback retained it
+void HttpClient::recycleResponse(HttpResponse* response)
+{
+    if (response->getReferenceCount() > 1)
+    {
+        response->release();
+        return;
+    }
+
+    response->reuse(nullptr);
+    _reusedResponsesMutex.lock();
+    bool isReused = _reusedResponses.size() < static_cast<size_t>(MAX_REUSED_RESPONSES);
+    if (isReused)
+    {
+        _reusedResponses.push_back(response);
+    }
+    _reusedResponsesMutex.unlock();
+
+    if (!isReused)
+    {
+        response->release();
+    }
+}
+
 void HttpClient::increaseThreadCount()
 {
     _threadCountMutex.lock();
@@ -572,6 +620,19 @@ int HttpClient::getTimeoutForRead()
     return _timeoutForRead;
 }
 
+// requests run one by one on the network thread of this platform, the limit is kept for the curl platforms
+void HttpClient::setMaxConcurrentRequests(int value)
+{
+    std::lock_guard<std::mutex> lock(_maxConcurrentRequestsMutex);
+    _maxConcurrentRequests = value;
+}
+
+int HttpClient::getMaxConcurrentRequests()
+{
+    std::lock_guard<std::mutex> lock(_maxConcurrentRequestsMutex);
+    return _maxConcurrentRequests;
+}
+
 const std::string& HttpClient::getCookieFilename()
 {
     std::lock_guard<std::mutex> lock(_cookieFileMutex);
@@ -26,7 +26,15 @@
  ****************************************************************************/
 
 #include "network/HttpClient.h"
+#include "base/ThreadConfig.h"
+#include "base/memory/MemTracker.h"
 #include <queue>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+#include <chrono>
 #include <errno.h>
 #include <curl/curl.h>
 #include "platform/FileUtils.h"
@@ -42,127 +50,16 @@ namespace network {
 typedef int int32_t;
 #endif
 
-static HttpClient* _httpClient = nullptr; // pointer to singleton
-
-typedef size_t (*write_callback)(void *ptr, size_t size, size_t nmemb, void *stream);
-
-// Callback function used by libcurl for collect response data
-static size_t writeData(void *ptr, size_t size, size_t nmemb, void *stream)
-{
-    std::vector<char> *recvBuffer = (std::vector<char>*)stream;
-    size_t sizes = size * nmemb;
-    
-    // add data to the end of recvBuffer
-    // write data maybe called more than once in a single request
-    recvBuffer->insert(recvBuffer->end(), (char*)ptr, (char*)ptr+sizes);
-    
-    return sizes;
-}
-
-// Callback function used by libcurl for collect header data
-static size_t writeHeaderData(void *ptr, size_t size, size_t nmemb, void *stream)
-{
-    std::vector<char> *recvBuffer = (std::vector<char>*)stream;
-    size_t sizes = size * nmemb;
-    
-    // add data to the end of recvBuffer
-    // write data maybe called more than once in a single request
-    recvBuffer->insert(recvBuffer->end(), (char*)ptr, (char*)ptr+sizes);
-    
-    return sizes;
-}
-
-
-static int processGetTask(HttpClient* client, HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-static int processPostTask(HttpClient* client, HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-static int processPutTask(HttpClient* client,  HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-static int processDeleteTask(HttpClient* client,  HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-// int processDownloadTask(HttpRequest *task, write_callback callback, void *stream, int32_t *errorCode);
-
-// Worker thread
-void HttpClient::networkThread()
-{
-    increaseThreadCount();
-
-    while (true)
-    {
-        HttpRequest *request;
-
-        // step 1: send http request if the requestQueue isn't empty
-        {
-            std::lock_guard<std::mutex> lock(_requestQueueMutex);
-            while (_requestQueue.empty())
-            {
-                _sleepCondition.wait(_requestQueueMutex);
-            }
-            request = _requestQueue.at(0);
-            _requestQueue.erase(0);
-        }
-
-        if (request == _requestSentinel) {
-            break;
-        }
-
-        // step 2: libcurl sync access
-        
-        // Create a HttpResponse object, the default setting is http access failed
-        HttpResponse *response = new (std::nothrow) HttpResponse(request);
-
-        processResponse(response, _responseMessage);
-
-
-        // add response packet into queue
-        _responseQueueMutex.lock();
-        _responseQueue.pushBack(response);
-        _responseQueueMutex.unlock();
-
-        _schedulerMutex.lock();
-        if (auto sche = _scheduler.lock())
-        {
-            sche->performFunctionInCocosThread(CC_CALLBACK_0(HttpClient::dispatchResponseCallbacks, this));
-        }
-        _schedulerMutex.unlock();
-    }
-    
-    // cleanup: if worker thread received quit signal, clean up un-completed request queue
-    _requestQueueMutex.lock();
-    _requestQueue.clear();
-    _requestQueueMutex.unlock();
-
-    _responseQueueMutex.lock();
-    _responseQueue.clear();
-    _responseQueueMutex.unlock();
-
-    decreaseThreadCountAndMayDeleteThis();
-}
-
-// Worker thread
-void HttpClient::networkThreadAlone(HttpRequest* request, HttpResponse* response)
-{
-    increaseThreadCount();
-
-    char responseMessage[RESPONSE_BUFFER_SIZE] = { 0 };
-    processResponse(response, responseMessage);
+#ifndef CC_CURL_POLL_TIMEOUT_MS
+#define CC_CURL_POLL_TIMEOUT_MS 50
+#endif
 
-    _schedulerMutex.lock();
-    if (auto sche = _scheduler.lock())
-    {
-        sche->performFunctionInCocosThread([this, response, request]{
-            const ccHttpRequestCallback& callback = request->getResponseCallback();
+// a larger Content-Length only reserves this much, the body grows past it as it arrives
+static const long long MAX_RESERVED_RESPONSE_SIZE = 64 * 1024 * 1024;
 
-            if (callback != nullptr)
-            {
-                callback(this, response);
-            }
-            response->release();
-            // do not release in other thread
-            request->release();
-        });
-    }
-    _schedulerMutex.unlock();
+static HttpClient* _httpClient = nullptr; // pointer to singleton
 
-    decreaseThreadCountAndMayDeleteThis();
-}
+typedef size_t (*write_callback)(void *ptr, size_t size, size_t nmemb, void *stream);
 
 //Configure curl's timeout property
 static bool configureCURL(HttpClient* client, HttpRequest* request, CURL* handle, char* errorBuffer)
@@ -176,11 +73,13 @@ static bool configureCURL(HttpClient* client, HttpRequest* request, CURL* handle
     if (code != CURLE_OK) {
         return false;
     }
-    code = curl_easy_setopt(handle, CURLOPT_TIMEOUT, request->getTimeout());
+    // the timeout is a float, curl reads a long from the variadic argument
+    long timeoutMS = static_cast<long>(request->getTimeout() * 1000);
+    code = curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, timeoutMS);
     if (code != CURLE_OK) {
         return false;
     }
-    code = curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT, request->getTimeout());
+    code = curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT_MS, timeoutMS);
     if (code != CURLE_OK) {
         return false;
     }
@@ -201,6 +100,11 @@ static bool configureCURL(HttpClient* client, HttpRequest* request, CURL* handle
 
     curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, "");
 
+    // HTTP/2 over https when both libcurl and the server support it, HTTP/1.1 otherwise.
+    // A new request waits for a connection being set up to the same host to multiplex on it rather than opening another one.
+    curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_2TLS);
+    curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+
     return true;
 }
 
@@ -226,6 +130,8 @@ public:
             curl_slist_free_all(_headers);
     }
 
+    CURL* getHandle() const { return _curl; }
+
     template <class T>
     bool setOption(CURLoption option, T data)
     {
@@ -246,12 +152,17 @@ public:
             return false;
 
         /* get custom header data (if set) */
-        std::vector<std::string> headers=request->getHeaders();
+        const HttpHeaders& headers = request->getRequestHeaders();
         if(!headers.empty())
         {
-            /* append custom headers one by one */
-            for (auto& header : headers)
-                _headers = curl_slist_append(_headers,header.c_str());
+            /* append custom headers one by one, curl copies the null terminated line */
+            std::string line;
+            for (size_t i = 0; i < headers.size(); ++i)
+            {
+                HttpHeaders::View header = headers.getLine(i);
+                line.assign(header.data, header.size);
+                _headers = curl_slist_append(_headers, line.c_str());
+            }
             /* set custom headers for curl */
             if (!setOption(CURLOPT_HTTPHEADER, _headers))
                 return false;
@@ -273,66 +184,329 @@ public:
                 && setOption(CURLOPT_HEADERDATA, headerStream);
         
     }
+};
 
-    /// @param responseCode Null not allowed
-    bool perform(long *responseCode)
+// A request in flight on the multi handle of the network thread
+struct HttpTransfer
+{
+    CURLRaii curl;
+    HttpResponse* response = nullptr;
+    char errorBuffer[HttpClient::RESPONSE_BUFFER_SIZE] = { 0 };
+    long long contentLength = -1;
+    // the chunks received since the last ccHttpRequestDataCallback
+    bool isStreaming = false;
+    std::vector<char> pendingData;
+    std::chrono::steady_clock::time_point lastStreamTime;
+};
+
+// Callback function used by libcurl for collect response data
+static size_t writeData(void *ptr, size_t size, size_t nmemb, void *stream)
+{
+    HttpTransfer* transfer = (HttpTransfer*)stream;
+    std::vector<char> *recvBuffer = transfer->response->getResponseData();
+    size_t sizes = size * nmemb;
+    
+    // add data to the end of recvBuffer
+    // write data maybe called more than once in a single request
+    recvBuffer->insert(recvBuffer->end(), (char*)ptr, (char*)ptr+sizes);
+    if (transfer->isStreaming)
     {
-        if (CURLE_OK != curl_easy_perform(_curl))
-            return false;
-        CURLcode code = curl_easy_getinfo(_curl, CURLINFO_RESPONSE_CODE, responseCode);
-        if (code != CURLE_OK || !(*responseCode >= 200 && *responseCode < 300)) {
-            CC_LOG_ERROR("Curl curl_easy_getinfo failed: %s", curl_easy_strerror(code));
-            return false;
-        }
-        // Get some mor data.
-        
-        return true;
+        transfer->pendingData.insert(transfer->pendingData.end(), (char*)ptr, (char*)ptr+sizes);
     }
-};
+    
+    return sizes;
+}
 
-//Process Get Request
-static int processGetTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
+// Callback function used by libcurl for collect header data
+static size_t writeHeaderData(void *ptr, size_t size, size_t nmemb, void *stream)
 {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_FOLLOWLOCATION, true)
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
+    HttpTransfer* transfer = (HttpTransfer*)stream;
+    HttpHeaders& headers = transfer->response->getResponseHeaders();
+    size_t sizes = size * nmemb;
+
+    // curl passes one header line per call, a redirect starts a new block with the status line
+    const char* line = (const char*)ptr;
+    if (sizes > 5 && strncmp(line, "HTTP/", 5) == 0)
+    {
+        headers.clear();
+        transfer->contentLength = -1;
+    }
+    size_t index = headers.size();
+    headers.append(line, sizes);
+
+    // The body is allocated once from the Content-Length instead of growing by the appends.
+    // The value is followed by its line ending in the header buffer, which ends the number.
+    if (headers.size() > index && headers.getName(index).equalsIgnoreCase("content-length"))
+    {
+        long long contentLength = strtoll(headers.getValue(index).data, nullptr, 10);
+        if (contentLength > 0)
+        {
+            transfer->contentLength = contentLength;
+            transfer->response->getResponseData()->reserve(static_cast<size_t>(std::min(contentLength, MAX_RESERVED_RESPONSE_SIZE)));
+        }
+    }
+    
+    return sizes;
 }
 
-//Process POST Request
-static int processPostTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
+// Set up the transfer of the request by its type
+static bool initTransfer(HttpClient* client, HttpTransfer* transfer, CURLSH* shareHandle)
 {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_POST, 1)
+    HttpResponse* response = transfer->response;
+    HttpRequest* request = response->getHttpRequest();
+    CURLRaii& curl = transfer->curl;
+    if (!curl.init(client, request, writeData, transfer, writeHeaderData, transfer, transfer->errorBuffer)
+        || !curl.setOption(CURLOPT_SHARE, shareHandle))
+    {
+        return false;
+    }
+    transfer->isStreaming = request->getResponseDataCallback() != nullptr;
+    transfer->lastStreamTime = std::chrono::steady_clock::now();
+
+    switch (request->getRequestType())
+    {
+    case HttpRequest::Type::GET: // HTTP GET
+        return curl.setOption(CURLOPT_FOLLOWLOCATION, true);
+
+    case HttpRequest::Type::POST: // HTTP POST
+        return curl.setOption(CURLOPT_POST, 1)
             && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData())
-            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize())
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
+            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize());
+
+    case HttpRequest::Type::PUT:
+        return curl.setOption(CURLOPT_CUSTOMREQUEST, "PUT")
+            && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData())
+            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize());
+
+    case HttpRequest::Type::DELETE:
+        return curl.setOption(CURLOPT_CUSTOMREQUEST, "DELETE")
+            && curl.setOption(CURLOPT_FOLLOWLOCATION, true);
+
+    default:
+        CCASSERT(false, "CCHttpClient: unknown request type, only GET, POST, PUT or DELETE is supported");
+        return false;
+    }
 }
 
-//Process PUT Request
-static int processPutTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
+// Write the result of a finished transfer to its response
+static void finishTransfer(HttpTransfer* transfer, CURLcode result)
 {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_CUSTOMREQUEST, "PUT")
-            && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData())
-            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize())
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
+    HttpResponse* response = transfer->response;
+    long responseCode = -1;
+    bool succeed = false;
+    if (result == CURLE_OK)
+    {
+        CURLcode code = curl_easy_getinfo(transfer->curl.getHandle(), CURLINFO_RESPONSE_CODE, &responseCode);
+        if (code != CURLE_OK) {
+            CC_LOG_ERROR("Curl curl_easy_getinfo failed: %s", curl_easy_strerror(code));
+        }
+        succeed = code == CURLE_OK && responseCode >= 200 && responseCode < 300;
+    }
+    else if (!transfer->errorBuffer[0])
+    {
+        strncpy(transfer->errorBuffer, curl_easy_strerror(result), HttpClient::RESPONSE_BUFFER_SIZE - 1);
+    }
+
+    // write data to HttpResponse
+    response->setResponseCode(responseCode);
+    response->setSucceed(succeed);
+    if (!succeed)
+    {
+        response->setErrorBuffer(transfer->errorBuffer);
+    }
 }
 
-//Process DELETE Request
-static int processDeleteTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
+// Worker thread
+// All the requests run on one curl multi handle, which keeps the connections alive for reuse and multiplexes
+// the HTTP/2 streams of a host over one connection. The DNS cache, the TLS sessions and the cookies are shared too.
+void HttpClient::networkThread()
 {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_CUSTOMREQUEST, "DELETE")
-            && curl.setOption(CURLOPT_FOLLOWLOCATION, true)
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
+    increaseThreadCount();
+    CC_MEM_MODULE_SCOPE(NETWORK);
+    ThreadConfig::applyToCurrentThread(ThreadLane::IO);
+
+    CURLM* multiHandle = curl_multi_init();
+    curl_multi_setopt(multiHandle, CURLMOPT_PIPELINING, (long)CURLPIPE_MULTIPLEX);
+    // only this thread touches the easy handles, the share handle needs no lock functions
+    CURLSH* shareHandle = curl_share_init();
+    curl_share_setopt(shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    curl_share_setopt(shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_COOKIE);
+
+    std::unordered_map<CURL*, HttpTransfer*> transfers;
+    std::vector<HttpRequest*> requests;
+    bool isQuitting = false;
+
+    while (!isQuitting)
+    {
+        // step 1: take the immediate requests and the queued ones up to the limit, sleep if there is nothing to do
+        {
+            size_t maxCount = static_cast<size_t>(std::max(getMaxConcurrentRequests(), 0));
+            std::lock_guard<std::mutex> lock(_requestQueueMutex);
+            while (transfers.empty() && _requestQueue.empty() && _immediateRequestQueue.empty())
+            {
+                _sleepCondition.wait(_requestQueueMutex);
+            }
+            // the reference send() took on the requests passes to their responses, it is released after the callback
+            for (auto request : _immediateRequestQueue)
+            {
+                requests.push_back(request);
+            }
+            _immediateRequestQueue.clear();
+            while (!_requestQueue.empty() && (maxCount == 0 || transfers.size() + requests.size() < maxCount))
+            {
+                requests.push_back(_requestQueue.front());
+                _requestQueue.pop_front();
+            }
+        }
+
+        // step 2: add the requests to the multi handle
+        for (auto request : requests)
+        {
+            if (request == _requestSentinel) {
+                isQuitting = true;
+                continue;
+            }
+            if (isQuitting) {
+                request->release();
+                continue;
+            }
+
+            // Create a HttpResponse object, the default setting is http access failed
+            auto transfer = new (std::nothrow) HttpTransfer();
+            transfer->response = obtainResponse(request);
+            CURLMcode mcode = CURLM_OK;
+            if (!initTransfer(this, transfer, shareHandle)
+                || CURLM_OK != (mcode = curl_multi_add_handle(multiHandle, transfer->curl.getHandle())))
+            {
+                if (mcode != CURLM_OK) {
+                    strncpy(transfer->errorBuffer, curl_multi_strerror(mcode), RESPONSE_BUFFER_SIZE - 1);
+                }
+                finishTransfer(transfer, CURLE_FAILED_INIT);
+                addResponse(transfer->response);
+                delete transfer;
+                continue;
+            }
+            transfers[transfer->curl.getHandle()] = transfer;
+        }
+        requests.clear();
+        if (isQuitting) {
+            break;
+        }
+
+        // step 3: drive the transfers and hand the finished ones to the cocos thread
+        int runningHandles = 0;
+        curl_multi_perform(multiHandle, &runningHandles);
+
+        CURLMsg* msg = nullptr;
+        int msgCount = 0;
+        while ((msg = curl_multi_info_read(multiHandle, &msgCount)))
+        {
+            if (msg->msg != CURLMSG_DONE) {
+                continue;
+            }
+            CURL* handle = msg->easy_handle;
+            CURLcode result = msg->data.result;
+            auto iter = transfers.find(handle);
+            curl_multi_remove_handle(multiHandle, handle);
+            if (iter == transfers.end()) {
+                continue;
+            }
+            HttpTransfer* transfer = iter->second;
+            transfers.erase(iter);
+            if (!transfer->pendingData.empty())
+            {
+                addResponseData(transfer->response, transfer->pendingData, transfer->contentLength);
+            }
+            finishTransfer(transfer, result);
+            addResponse(transfer->response);
+            delete transfer;
+        }
+
+        // the chunks of the streaming transfers are handed over at most once per poll interval
+        auto now = std::chrono::steady_clock::now();
+        for (auto& iter : transfers)
+        {
+            HttpTransfer* transfer = iter.second;
+            if (!transfer->pendingData.empty() && now - transfer->lastStreamTime >= std::chrono::milliseconds(CC_CURL_POLL_TIMEOUT_MS))
+            {
+                addResponseData(transfer->response, transfer->pendingData, transfer->contentLength);
+                transfer->lastStreamTime = now;
+            }
+        }
+
+        // step 4: wait for the sockets, wake up at times to take the newly sent requests
+        if (!transfers.empty())
+        {
+            int numfds = 0;
+            curl_multi_wait(multiHandle, nullptr, 0, CC_CURL_POLL_TIMEOUT_MS, &numfds);
+        }
+    }
+    
+    // cleanup: if worker thread received quit signal, abort the transfers and clean up un-completed request queue.
+    // Their responses are left like the queued responses, the cocos thread may still hold their data callbacks.
+    for (auto& iter : transfers)
+    {
+        curl_multi_remove_handle(multiHandle, iter.first);
+        delete iter.second;
+    }
+    transfers.clear();
+    curl_multi_cleanup(multiHandle);
+    curl_share_cleanup(shareHandle);
+
+    _requestQueueMutex.lock();
+    for (auto request : _requestQueue)
+    {
+        request->release();
+    }
+    _requestQueue.clear();
+    for (auto request : _immediateRequestQueue)
+    {
+        request->release();
+    }
+    _immediateRequestQueue.clear();
+    _requestQueueMutex.unlock();
+
+    _responseQueueMutex.lock();
+    _responseQueue.clear();
+    _responseQueueMutex.unlock();
+
+    decreaseThreadCountAndMayDeleteThis();
+}
+
+// The chunk is moved out of data, the response is alive until its response callback which is queued after the chunks
+void HttpClient::addResponseData(HttpResponse* response, std::vector<char>& data, long long totalSize)
+{
+    auto chunk = std::make_shared<std::vector<char>>(std::move(data));
+    data.clear();
+
+    _schedulerMutex.lock();
+    if (auto sche = _scheduler.lock())
+    {
+        sche->performFunctionInCocosThread([this, response, chunk, totalSize]{
+            const ccHttpRequestDataCallback& callback = response->getHttpRequest()->getResponseDataCallback();
+            if (callback != nullptr)
+            {
+                callback(this, response, chunk->data(), chunk->size(), totalSize);
+            }
+        });
+    }
+    _schedulerMutex.unlock();
+}
+
+void HttpClient::addResponse(HttpResponse* response)
+{
+    // add response packet into queue
+    _responseQueueMutex.lock();
+    _responseQueue.push_back(response);
+    _responseQueueMutex.unlock();
+
+    _schedulerMutex.lock();
+    if (auto sche = _scheduler.lock())
+    {
+        sche->performFunctionInCocosThread(CC_CALLBACK_0(HttpClient::dispatchResponseCallbacks, this));
+    }
+    _schedulerMutex.unlock();
 }
 
 // HttpClient implementation
@@ -368,7 +542,7 @@ void HttpClient::destroyInstance()
     thiz->_schedulerMutex.unlock();
 
     thiz->_requestQueueMutex.lock();
-    thiz->_requestQueue.pushBack(thiz->_requestSentinel);
+    thiz->_immediateRequestQueue.push_back(thiz->_requestSentinel);
     thiz->_requestQueueMutex.unlock();
 
     thiz->_sleepCondition.notify_one();
@@ -400,18 +574,22 @@ HttpClient::HttpClient()
 : _isInited(false)
 , _timeoutForConnect(30)
 , _timeoutForRead(60)
+, _maxConcurrentRequests(16)
 , _threadCount(0)
 , _cookie(nullptr)
 , _requestSentinel(new HttpRequest())
 {
     CC_LOG_DEBUG("In the constructor of HttpClient!");
-    memset(_responseMessage, 0, RESPONSE_BUFFER_SIZE * sizeof(char));
     _scheduler = Application::getInstance()->getScheduler();
     increaseThreadCount();
 }
 
 HttpClient::~HttpClient()
 {
+    for (auto response : _reusedResponses)
+    {
+        response->release();
+    }
     CC_SAFE_RELEASE(_requestSentinel);
     CC_LOG_DEBUG("HttpClient destructor");
 }
@@ -449,7 +627,7 @@ void HttpClient::send(HttpRequest* request)
     request->retain();
 
     _requestQueueMutex.lock();
-    _requestQueue.pushBack(request);
+    _requestQueue.push_back(request);
     _requestQueueMutex.unlock();
 
     // Notify thread start to work
@@ -458,17 +636,24 @@ void HttpClient::send(HttpRequest* request)
 
 void HttpClient::sendImmediate(HttpRequest* request)
 {
+    if (false == lazyInitThreadSemaphore())
+    {
+        return;
+    }
+
     if(!request)
     {
         return;
     }
 
     request->retain();
-    // Create a HttpResponse object, the default setting is http access failed
-    HttpResponse *response = new (std::nothrow) HttpResponse(request);
 
-    auto t = std::thread(&HttpClient::networkThreadAlone, this, request, response);
-    t.detach();
+    _requestQueueMutex.lock();
+    _immediateRequestQueue.push_back(request);
+    _requestQueueMutex.unlock();
+
+    // Notify thread start to work
+    _sleepCondition.notify_one();
 }
 
 // Poll and notify main thread if responses exists in queue
@@ -481,8 +666,8 @@ void HttpClient::dispatchResponseCallbacks()
     _responseQueueMutex.lock();
     if (!_responseQueue.empty())
     {
-        response = _responseQueue.at(0);
-        _responseQueue.erase(0);
+        response = _responseQueue.front();
+        _responseQueue.pop_front();
     }
     _responseQueueMutex.unlock();
     
@@ -496,77 +681,52 @@ void HttpClient::dispatchResponseCallbacks()
             callback(this, response);
         }
 
-        response->release();
         // do not release in other thread
-        request->release();
+        recycleResponse(response);
     }
 }
 
-// Process Response
-void HttpClient::processResponse(HttpResponse* response, char* responseMessage)
+// The response takes over the reference send() took on the request
+HttpResponse* HttpClient::obtainResponse(HttpRequest* request)
 {
-    auto request = response->getHttpRequest();
-    long responseCode = -1;
-    int retValue = 0;
-
-    // Process the request -> get response packet
-    switch (request->getRequestType())
+    HttpResponse* response = nullptr;
+    _reusedResponsesMutex.lock();
+    if (!_reusedResponses.empty())
     {
-    case HttpRequest::Type::GET: // HTTP GET
-        retValue = processGetTask(this, request,
-            writeData,
-            response->getResponseData(),
-            &responseCode,
-            writeHeaderData,
-            response->getResponseHeader(),
-            responseMessage);
-        break;
-
-    case HttpRequest::Type::POST: // HTTP POST
-        retValue = processPostTask(this, request,
-            writeData,
-            response->getResponseData(),
-            &responseCode,
-            writeHeaderData,
-            response->getResponseHeader(),
-            responseMessage);
-        break;
-
-    case HttpRequest::Type::PUT:
-        retValue = processPutTask(this, request,
-            writeData,
-            response->getResponseData(),
-            &responseCode,
-            writeHeaderData,
-            response->getResponseHeader(),
-            responseMessage);
-        break;
+        response = _reusedResponses.back();
+        _reusedResponses.pop_back();
+    }
+    _reusedResponsesMutex.unlock();
 
-    case HttpRequest::Type::DELETE:
-        retValue = processDeleteTask(this, request,
-            writeData,
-            response->getResponseData(),
-            &responseCode,
-            writeHeaderData,
-            response->getResponseHeader(),
-            responseMessage);
-        break;
+    if (response == nullptr)
+    {
+        response = new (std::nothrow) HttpResponse(nullptr);
+    }
+    response->reuse(request);
+    return response;
+}
 
-    default:
-        CCASSERT(false, "CCHttpClient: unknown request type, only GET, POST, PUT or DELETE is supported");
-        break;
+// Releases the request after the response callback, the response is kept for the next request unless the callback retained it
+void HttpClient::recycleResponse(HttpResponse* response)
+{
+    if (response->getReferenceCount() > 1)
+    {
+        response->release();
+        return;
     }
 
-    // write data to HttpResponse
-    response->setResponseCode(responseCode);
-    if (retValue != 0)
+    response->reuse(nullptr);
+    _reusedResponsesMutex.lock();
+    bool isReused = _reusedResponses.size() < static_cast<size_t>(MAX_REUSED_RESPONSES);
+    if (isReused)
     {
-        response->setSucceed(false);
-        response->setErrorBuffer(responseMessage);
+        _reusedResponses.push_back(response);
     }
-    else
+    _reusedResponsesMutex.unlock();
+
+    if (!isReused)
     {
-        response->setSucceed(true);
+        response->release();
     }
 }
 
@@ -617,6 +777,18 @@ int HttpClient::getTimeoutForRead()
     std::lock_guard<std::mutex> lock(_timeoutForReadMutex);
     return _timeoutForRead;
 }
+
+void HttpClient::setMaxConcurrentRequests(int value)
+{
+    std::lock_guard<std::mutex> lock(_maxConcurrentRequestsMutex);
+    _maxConcurrentRequests = value;
+}
+
+int HttpClient::getMaxConcurrentRequests()
+{
+    std::lock_guard<std::mutex> lock(_maxConcurrentRequestsMutex);
+    return _maxConcurrentRequests;
+}
     
 const std::string& HttpClient::getCookieFilename()
 {
@@ -30,6 +30,7 @@
 
 #include <thread>
 #include <condition_variable>
+#include <deque>
 #include "base/Vector.h"
 #include "network/HttpRequest.h"
 #include "network/HttpResponse.h"
@@ -61,6 +62,11 @@ public:
     */
     static const int RESPONSE_BUFFER_SIZE = 256;
 
+    /**
+    * The number of finished responses kept to be reused with their buffers
+    */
+    static const int MAX_REUSED_RESPONSES = 8;
+
     /**
      * Get instance of HttpClient.
      *
@@ -110,13 +116,29 @@ public:
     void send(HttpRequest* request);
 
     /**
-     * Immediate send a request
+     * Immediate send a request, it starts without waiting for the limit of concurrent requests.
      *
      * @param request a HttpRequest object, which includes url, response callback etc.
                       please make sure request->_requestData is clear before calling "sendImmediate" here.
      */
     void sendImmediate(HttpRequest* request);
 
+    /**
+     * Set the maximum count of requests in flight at the same time, further requests wait in the queue.
+     * Requests to a HTTP/2 host are multiplexed over one connection, the others reuse the idle connections.
+     * Only the curl client on Windows and macOS runs requests concurrently.
+     *
+     * @param value the maximum count of concurrent requests, 0 means no limit. Default is 16.
+     */
+    void setMaxConcurrentRequests(int value);
+
+    /**
+     * Get the maximum count of concurrent requests.
+     *
+     * @return int the maximum count of concurrent requests.
+     */
+    int getMaxConcurrentRequests();
+
     /**
      * Set the timeout value for connecting.
      *
@@ -170,6 +192,10 @@ private:
     void dispatchResponseCallbacks();
 
     void processResponse(HttpResponse* response, char* responseMessage);
+    void addResponse(HttpResponse* response);
+    void addResponseData(HttpResponse* response, std::vector<char>& data, long long totalSize);
+    HttpResponse* obtainResponse(HttpRequest* request);
+    void recycleResponse(HttpResponse* response);
     void increaseThreadCount();
     void decreaseThreadCountAndMayDeleteThis();
 
@@ -182,18 +208,26 @@ private:
     int _timeoutForRead;
     std::mutex _timeoutForReadMutex;
 
+    int _maxConcurrentRequests;
+    std::mutex _maxConcurrentRequestsMutex;
+
     int  _threadCount;
     std::mutex _threadCountMutex;
 
     std::weak_ptr<Scheduler> _scheduler;
     std::mutex _schedulerMutex;
 
-    Vector<HttpRequest*>  _requestQueue;
+    // the queues hold the reference send() takes on the requests, it passes to their responses
+    std::deque<HttpRequest*>  _requestQueue;
+    std::deque<HttpRequest*>  _immediateRequestQueue;
     std::mutex _requestQueueMutex;
 
-    Vector<HttpResponse*> _responseQueue;
+    std::deque<HttpResponse*> _responseQueue;
     std::mutex _responseQueueMutex;
 
+    std::vector<HttpResponse*> _reusedResponses;
+    std::mutex _reusedResponsesMutex;
+
     std::string _cookieFilename;
     std::mutex _cookieFileMutex;
 
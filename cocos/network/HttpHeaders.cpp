@@ -0,0 +1,198 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "network/HttpHeaders.h"
+#include <cctype>
+#include <cstring>
+
+namespace cc {
+
+namespace network {
+
+static const size_t NO_STATUS_LINE = static_cast<size_t>(-1);
+
+static inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t';
+}
+
+bool HttpHeaders::View::equalsIgnoreCase(const char* str) const
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (str[i] == '\0' || ::tolower(static_cast<unsigned char>(data[i])) != ::tolower(static_cast<unsigned char>(str[i])))
+        {
+            return false;
+        }
+    }
+    return str[size] == '\0';
+}
+
+HttpHeaders::HttpHeaders()
+: _indexedSize(0)
+, _statusLine(NO_STATUS_LINE)
+, _statusLineLength(0)
+{
+}
+
+void HttpHeaders::add(const char* name, size_t nameLength, const char* value, size_t valueLength)
+{
+    _data.reserve(_data.size() + nameLength + valueLength + 4);
+    _data.insert(_data.end(), name, name + nameLength);
+    _data.push_back(':');
+    _data.push_back(' ');
+    _data.insert(_data.end(), value, value + valueLength);
+    _data.push_back('\r');
+    _data.push_back('\n');
+    indexLines();
+}
+
+void HttpHeaders::addLine(const char* line, size_t length)
+{
+    _data.reserve(_data.size() + length + 2);
+    _data.insert(_data.end(), line, line + length);
+    _data.push_back('\r');
+    _data.push_back('\n');
+    indexLines();
+}
+
+void HttpHeaders::append(const char* data, size_t size)
+{
+    _data.insert(_data.end(), data, data + size);
+    indexLines();
+}
+
+void HttpHeaders::clear()
+{
+    _data.clear();
+    _entries.clear();
+    _indexedSize = 0;
+    _statusLine = NO_STATUS_LINE;
+    _statusLineLength = 0;
+}
+
+// Indexes the lines completed since the last call, the offsets stay valid when the buffer grows
+void HttpHeaders::indexLines()
+{
+    const char* data = _data.data();
+    const size_t size = _data.size();
+    while (_indexedSize < size)
+    {
+        const void* found = memchr(data + _indexedSize, '\n', size - _indexedSize);
+        if (found == nullptr)
+        {
+            break;
+        }
+        size_t line = _indexedSize;
+        size_t end = static_cast<const char*>(found) - data;
+        _indexedSize = end + 1;
+        if (end > line && data[end - 1] == '\r')
+        {
+            --end;
+        }
+        if (end == line)
+        {
+            continue;
+        }
+
+        if (end - line > 5 && strncmp(data + line, "HTTP/", 5) == 0)
+        {
+            _statusLine = line;
+            _statusLineLength = end - line;
+            continue;
+        }
+
+        Entry entry;
+        entry.line = line;
+        entry.lineLength = end - line;
+        const void* colon = memchr(data + line, ':', end - line);
+        if (colon == nullptr)
+        {
+            entry.nameLength = entry.lineLength;
+            entry.value = end;
+            entry.valueLength = 0;
+        }
+        else
+        {
+            size_t value = static_cast<const char*>(colon) - data;
+            entry.nameLength = value - line;
+            ++value;
+            while (value < end && isSpace(data[value]))
+            {
+                ++value;
+            }
+            size_t valueEnd = end;
+            while (valueEnd > value && isSpace(data[valueEnd - 1]))
+            {
+                --valueEnd;
+            }
+            entry.value = value;
+            entry.valueLength = valueEnd - value;
+        }
+        _entries.push_back(entry);
+    }
+}
+
+HttpHeaders::View HttpHeaders::getLine(size_t index) const
+{
+    const Entry& entry = _entries[index];
+    return View(_data.data() + entry.line, entry.lineLength);
+}
+
+HttpHeaders::View HttpHeaders::getName(size_t index) const
+{
+    const Entry& entry = _entries[index];
+    return View(_data.data() + entry.line, entry.nameLength);
+}
+
+HttpHeaders::View HttpHeaders::getValue(size_t index) const
+{
+    const Entry& entry = _entries[index];
+    return View(_data.data() + entry.value, entry.valueLength);
+}
+
+HttpHeaders::View HttpHeaders::find(const char* name) const
+{
+    for (size_t i = 0, count = _entries.size(); i < count; ++i)
+    {
+        if (getName(i).equalsIgnoreCase(name))
+        {
+            return getValue(i);
+        }
+    }
+    return View();
+}
+
+HttpHeaders::View HttpHeaders::getStatusLine() const
+{
+    if (_statusLine == NO_STATUS_LINE)
+    {
+        return View();
+    }
+    return View(_data.data() + _statusLine, _statusLineLength);
+}
+
+}
+
+}
@@ -0,0 +1,130 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __HTTP_HEADERS_H__
+#define __HTTP_HEADERS_H__
+
+#include "base/Macros.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * @addtogroup network
+ * @{
+ */
+
+namespace cc {
+
+namespace network {
+
+/**
+ * The header lines of a request or a response in one buffer, with an index of where the names and values are.
+ * The lines are kept as they are written, so the buffer is also the raw header data. Looking up a header returns
+ * a view into the buffer instead of a string copy, and clear() keeps the capacity for the next request.
+ */
+class CC_DLL HttpHeaders
+{
+public:
+    /** Characters of the buffer, they are not null terminated and are valid until the headers are changed. */
+    struct View
+    {
+        const char* data = nullptr;
+        size_t size = 0;
+
+        View() = default;
+        View(const char* d, size_t s) : data(d), size(s) {}
+
+        inline bool empty() const { return size == 0; }
+        inline std::string str() const { return std::string(data, size); }
+        /** Compares the characters regardless of the case, like the header names are compared. */
+        bool equalsIgnoreCase(const char* str) const;
+    };
+
+    HttpHeaders();
+
+    /** Adds the line "name: value". */
+    void add(const char* name, size_t nameLength, const char* value, size_t valueLength);
+    inline void add(const std::string& name, const std::string& value) { add(name.c_str(), name.size(), value.c_str(), value.size()); }
+
+    /** Adds a line as it is, e.g. "name: value" or the "name;" of curl which sends a header without value. */
+    void addLine(const char* line, size_t length);
+    inline void addLine(const std::string& line) { addLine(line.c_str(), line.size()); }
+
+    /**
+     * Appends raw header data, the lines ended by '\n' are indexed and the rest when the end of its line arrives.
+     * A line starting with "HTTP/" is the status line, the empty line ending the headers is skipped.
+     */
+    void append(const char* data, size_t size);
+
+    /** Removes the headers, the buffers keep their capacity. */
+    void clear();
+
+    inline bool empty() const { return _entries.empty(); }
+    /** The number of header lines, the status line is not counted. */
+    inline size_t size() const { return _entries.size(); }
+
+    /** The whole line at index, without the line ending. */
+    View getLine(size_t index) const;
+    /** The name at index, the whole line if it has no ':'. */
+    View getName(size_t index) const;
+    /** The value at index without the surrounding spaces, empty if the line has no ':'. */
+    View getValue(size_t index) const;
+
+    /** The value of the first header named name, data is nullptr if there is none. */
+    View find(const char* name) const;
+    /** The status line like "HTTP/1.1 200 OK" without the line ending, empty if there is none. */
+    View getStatusLine() const;
+
+    /** The raw data of the lines, the ones written through the non const overload are not indexed. */
+    inline const std::vector<char>& getData() const { return _data; }
+    inline std::vector<char>& getData() { return _data; }
+
+private:
+    struct Entry
+    {
+        size_t line;
+        size_t lineLength;
+        size_t nameLength;
+        size_t value;
+        size_t valueLength;
+    };
+
+    void indexLines();
+
+    std::vector<char> _data;
+    std::vector<Entry> _entries;
+    size_t _indexedSize;
+    size_t _statusLine;
+    size_t _statusLineLength;
+};
+
+}
+
+}
+
+// end group
+/// @}
+
+#endif //__HTTP_HEADERS_H__
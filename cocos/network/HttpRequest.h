@@ -30,6 +30,9 @@
 
 #include "base/Ref.h"
 #include "base/Macros.h"
+#include "base/memory/AllocatedObj.h"
+#include "base/memory/PoolAlloc.h"
+#include "network/HttpHeaders.h"
 
 #include <string>
 #include <vector>
@@ -48,6 +51,7 @@ class HttpClient;
 class HttpResponse;
 
 typedef std::function<void(HttpClient*/* client*/, HttpResponse*/* response*/)> ccHttpRequestCallback;
+typedef std::function<void(HttpClient*/* client*/, HttpResponse*/* response*/, const char*/* data*/, size_t/* size*/, long long/* totalSize*/)> ccHttpRequestDataCallback;
 
 /**
  * Defines the object which users must packed for HttpClient::send(HttpRequest*) method.
@@ -63,7 +67,7 @@ typedef std::function<void(HttpClient*/* client*/, HttpResponse*/* response*/)>
 #endif
 #endif
 
-class CC_DLL HttpRequest : public Ref
+class CC_DLL HttpRequest : public Ref, public AllocatedObject<PoolAllocPolicy<HttpRequest>>
 {
 public:
     /**
@@ -88,6 +92,7 @@ public:
     HttpRequest()
     : _requestType(Type::UNKNOWN)
     , _callback(nullptr)
+    , _dataCallback(nullptr)
     , _userData(nullptr)
     , _timeoutInSeconds(10.0f)
     {
@@ -254,6 +259,29 @@ public:
         return _callback;
     }
 
+    /**
+     * Set ccHttpRequestDataCallback callback function, it receives the chunks of the response body while they arrive,
+     * in the cocos thread and before the response callback. totalSize is the Content-Length, or -1 if it is unknown.
+     * The response data still holds the whole body in the response callback.
+     * Only the curl client on Windows and macOS streams the body, it is set before sending the request.
+     *
+     * @param callback the ccHttpRequestDataCallback function, nullptr to receive the body in the response callback only.
+     */
+    inline void setResponseDataCallback(const ccHttpRequestDataCallback& callback)
+    {
+        _dataCallback = callback;
+    }
+
+    /**
+     * Get ccHttpRequestDataCallback callback function.
+     *
+     * @return const ccHttpRequestDataCallback& ccHttpRequestDataCallback callback function.
+     */
+    inline const ccHttpRequestDataCallback& getResponseDataCallback() const
+    {
+        return _dataCallback;
+    }
+
     /**
      * Set custom-defined headers.
      *
@@ -261,7 +289,11 @@ public:
      */
     inline void setHeaders(const std::vector<std::string>& headers)
     {
-       _headers = headers;
+        _headers.clear();
+        for (const auto& header : headers)
+        {
+            _headers.addLine(header);
+        }
     }
 
     /**
@@ -270,6 +302,41 @@ public:
      * @return std::vector<std::string> the string vector of custom-defined headers.
      */
     inline std::vector<std::string> getHeaders() const
+    {
+        std::vector<std::string> headers;
+        headers.reserve(_headers.size());
+        for (size_t i = 0; i < _headers.size(); ++i)
+        {
+            headers.push_back(_headers.getLine(i).str());
+        }
+        return headers;
+    }
+
+    /**
+     * Add a custom header, the headers are kept in one buffer which is reused when they are set again.
+     *
+     * @param name the header name.
+     * @param value the header value.
+     */
+    inline void addHeader(const std::string& name, const std::string& value)
+    {
+        _headers.add(name, value);
+    }
+
+    /**
+     * Remove the custom headers.
+     */
+    inline void clearHeaders()
+    {
+        _headers.clear();
+    }
+
+    /**
+     * Get custom headers without copying them.
+     *
+     * @return const HttpHeaders& the custom-defined headers.
+     */
+    inline const HttpHeaders& getRequestHeaders() const
     {
         return _headers;
     }
@@ -291,8 +358,9 @@ protected:
     std::vector<char>           _requestData;    /// used for POST
     std::string                 _tag;            /// user defined tag, to identify different requests in response callback
     ccHttpRequestCallback       _callback;      /// C++11 style callbacks
+    ccHttpRequestDataCallback   _dataCallback;  /// receives the chunks of the response body
     void*                       _userData;      /// You can add your customed data here
-    std::vector<std::string>    _headers;       /// custom http headers
+    HttpHeaders                 _headers;       /// custom http headers
     float _timeoutInSeconds;
 };
 
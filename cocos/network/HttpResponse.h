@@ -44,7 +44,7 @@ namespace network {
  * @since v2.0.2.
  * @lua NA
  */
-class CC_DLL HttpResponse : public cc::Ref
+class CC_DLL HttpResponse : public cc::Ref, public cc::AllocatedObject<cc::PoolAllocPolicy<HttpResponse>>
 {
 public:
     /**
@@ -54,6 +54,7 @@ public:
     HttpResponse(HttpRequest* request)
         : _pHttpRequest(request)
         , _succeed(false)
+        , _responseCode(-1)
         , _responseDataString("")
     {
         if (_pHttpRequest)
@@ -119,12 +120,32 @@ public:
     }
 
     /**
-     * Get the response headers.
-     * @return std::vector<char>* the pointer that point to the _responseHeader.
+     * Get the raw response headers.
+     * The data written through this pointer is not indexed, getResponseHeaders() looks the headers up without parsing them.
+     * @return std::vector<char>* the pointer that point to the raw data of _responseHeaders.
      */
     inline std::vector<char>* getResponseHeader()
     {
-        return &_responseHeader;
+        return &_responseHeaders.getData();
+    }
+
+    /**
+     * Get the response headers, indexed by name.
+     * @return const HttpHeaders& the response headers, they are valid until the response callback returns
+     *         if the response is not retained.
+     */
+    inline const HttpHeaders& getResponseHeaders() const
+    {
+        return _responseHeaders;
+    }
+
+    /**
+     * Get the response headers to write them, it is used by HttpClient.
+     * @return HttpHeaders& the response headers.
+     */
+    inline HttpHeaders& getResponseHeaders()
+    {
+        return _responseHeaders;
     }
 
     /**
@@ -176,7 +197,8 @@ public:
      */
     inline void setResponseHeader(std::vector<char>* data)
     {
-        _responseHeader = *data;
+        _responseHeaders.clear();
+        _responseHeaders.append(data->data(), data->size());
     }
 
 
@@ -222,13 +244,42 @@ public:
     }
 
 protected:
+    friend class HttpClient;
+
+    // a reused response keeps the capacity of its data up to this size
+    static const size_t MAX_REUSED_DATA_CAPACITY = 256 * 1024;
+
     bool initWithRequest(HttpRequest* request);
 
+    /**
+     * Clear the response for another request, it is used by HttpClient to reuse the responses with their buffers.
+     * The response takes over the reference the client holds on the request instead of retaining it again.
+     * @param request the request to take over, nullptr to only release the current one.
+     */
+    void reuse(HttpRequest* request)
+    {
+        if (_pHttpRequest)
+        {
+            _pHttpRequest->release();
+        }
+        _pHttpRequest = request;
+        _succeed = false;
+        _responseCode = -1;
+        _errorBuffer.clear();
+        _responseDataString.clear();
+        _responseHeaders.clear();
+        _responseData.clear();
+        if (_responseData.capacity() > MAX_REUSED_DATA_CAPACITY)
+        {
+            std::vector<char>().swap(_responseData);
+        }
+    }
+
     // properties
     HttpRequest*        _pHttpRequest;  /// the corresponding HttpRequest pointer who leads to this response
     bool                _succeed;       /// to indicate if the http request is successful simply
     std::vector<char>   _responseData;  /// the returned raw data. You can also dump it as a string
-    std::vector<char>   _responseHeader;  /// the returned raw header data. You can also dump it as a string
+    HttpHeaders         _responseHeaders; /// the returned header lines, indexed by name
     long                _responseCode;    /// the status code returned from libcurl, e.g. 200, 404
     std::string         _errorBuffer;   /// if _responseCode != 200, please read _errorBuffer to find the reason
     std::string         _responseDataString; // the returned raw data. You can also dump it as a string
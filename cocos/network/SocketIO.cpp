@@ -48,6 +48,160 @@ namespace cc {
 
 namespace network {
 
+namespace {
+
+// The header of a Socket.IO 1.x packet, <type>[<attachments>-][<namespace>,][<ack id>]<json>, parsed in place
+struct PacketHeader
+{
+    int type = -1;
+    int attachmentCount = 0;
+    std::string endpoint = "/";
+    const char* json = nullptr;
+};
+
+bool parsePacketHeader(const char* p, const char* end, PacketHeader& header)
+{
+    if (p == end || *p < '0' || *p > '9')
+        return false;
+    header.type = *p++ - '0';
+
+    // binary events and acks, the count of the binary messages that follow
+    if (header.type == 5 || header.type == 6)
+    {
+        int count = 0;
+        while (p < end && *p >= '0' && *p <= '9')
+            count = count * 10 + (*p++ - '0');
+        if (p == end || *p != '-')
+            return false;
+        header.attachmentCount = count;
+        ++p;
+    }
+
+    if (p < end && *p == '/')
+    {
+        const char* endpointEnd = std::find(p, end, ',');
+        header.endpoint.assign(p, endpointEnd);
+        p = endpointEnd < end ? endpointEnd + 1 : end;
+    }
+
+    // the ack id, acks aren't requested
+    while (p < end && *p >= '0' && *p <= '9')
+        ++p;
+
+    header.json = p;
+    return true;
+}
+
+const char* skipSpace(const char* p, const char* end)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+        ++p;
+    return p;
+}
+
+int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Reads the JSON string p points to the opening quote of, returns the end of it or nullptr if it's malformed.
+const char* scanString(const char* p, const char* end, std::string& out)
+{
+    out.clear();
+    ++p;
+    while (p < end)
+    {
+        const char* run = p;
+        while (p < end && *p != '"' && *p != '\\')
+            ++p;
+        out.append(run, p);
+        if (p == end)
+            return nullptr;
+        if (*p++ == '"')
+            return p;
+
+        if (p == end)
+            return nullptr;
+        const char c = *p++;
+        switch (c)
+        {
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u':
+            {
+                // the escaped code units in a row, a surrogate pair takes two of them
+                std::u16string units;
+                --p;
+                while (end - p >= 5 && p[0] == 'u')
+                {
+                    int unit = 0;
+                    for (int i = 1; i <= 4; ++i)
+                    {
+                        const int digit = hexValue(p[i]);
+                        if (digit < 0)
+                            return nullptr;
+                        unit = unit * 16 + digit;
+                    }
+                    units += static_cast<char16_t>(unit);
+                    p += 5;
+                    if (end - p >= 6 && p[0] == '\\' && p[1] == 'u')
+                        ++p;
+                    else
+                        break;
+                }
+                std::string utf8;
+                if (units.empty() || !StringUtils::UTF16ToUTF8(units, utf8))
+                    return nullptr;
+                out += utf8;
+                break;
+            }
+            default:
+                out += c;
+                break;
+        }
+    }
+    return nullptr;
+}
+
+// Finds the name and the arguments of the event ["name", args...] without building a document. The arguments are
+// the JSON text after the name as it was received, the script parses them.
+bool scanEvent(const char* p, const char* end, std::string& name, const char*& args, const char*& argsEnd)
+{
+    p = skipSpace(p, end);
+    if (p == end || *p != '[')
+        return false;
+    p = skipSpace(p + 1, end);
+    if (p == end || *p != '"')
+        return false;
+    p = scanString(p, end, name);
+    if (!p)
+        return false;
+
+    const char* last = end;
+    while (last > p && (last[-1] == ' ' || last[-1] == '\t' || last[-1] == '\n' || last[-1] == '\r'))
+        --last;
+    if (last == p || last[-1] != ']')
+        return false;
+    --last;
+
+    p = skipSpace(p, last);
+    if (p < last && *p == ',')
+        p = skipSpace(p + 1, last);
+    while (last > p && (last[-1] == ' ' || last[-1] == '\t' || last[-1] == '\n' || last[-1] == '\r'))
+        --last;
+    args = p;
+    argsEnd = last;
+    return true;
+}
+
+} // namespace
+
 //class declarations
 
 class SocketIOPacketV10x;
@@ -358,6 +512,21 @@ private:
 
     Map<std::string, SIOClient*> _clients;
 
+    // a binary event or ack of Socket.IO 1.x waits for the binary messages of its attachments
+    struct BinaryPacket
+    {
+        int type = 0;
+        int attachmentCount = 0;
+        std::string endpoint;
+        std::string eventName;
+        std::string args;
+        SIOAttachments attachments;
+    };
+    BinaryPacket _binaryPacket;
+
+    void onBinaryMessage(const WebSocket::Data& data);
+    void fireBinaryPacket();
+
 public:
     SIOClientImpl(const Uri& uri, const std::string& caFilePath);
     virtual ~SIOClientImpl();
@@ -386,6 +555,7 @@ public:
     void send(const std::string& endpoint, const std::string& s);
     void send(SocketIOPacket *packet);
     void emit(const std::string& endpoint, const std::string& eventname, const std::string& args);
+    void emit(const std::string& endpoint, const std::string& eventname, const std::string& args, const SIOAttachments& attachments);
 
 
 };
@@ -737,6 +907,56 @@ void SIOClientImpl::emit(const std::string& endpoint, const std::string& eventna
     delete packet;
 }
 
+void SIOClientImpl::emit(const std::string& endpoint, const std::string& eventname, const std::string& args, const SIOAttachments& attachments)
+{
+    if (_version != SocketIOPacket::SocketIOVersion::V10x)
+    {
+        CC_LOG_ERROR("Binary events need Socket.IO 1.x, \"%s\" isn't emitted", eventname.c_str());
+        return;
+    }
+    if (!_connected)
+    {
+        CC_LOG_INFO("Cant emit the binary event (%s) because disconnected", eventname.c_str());
+        return;
+    }
+
+    CC_LOG_INFO("Emitting binary event \"%s\" with %d attachments", eventname.c_str(), static_cast<int>(attachments.size()));
+
+    // the arguments are followed by a placeholder of every attachment, which the server replaces by a Buffer
+    rapidjson::StringBuffer s;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(s);
+    writer.StartArray();
+    writer.String(eventname.c_str());
+    writer.String(args.c_str());
+    for (size_t i = 0; i < attachments.size(); ++i)
+    {
+        writer.StartObject();
+        writer.String("_placeholder");
+        writer.Bool(true);
+        writer.String("num");
+        writer.Uint(static_cast<unsigned>(i));
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    std::stringstream encoded;
+    encoded << "45" << attachments.size() << "-";
+    if (endpoint != "/" && endpoint != "")
+        encoded << endpoint << ",";
+    encoded << s.GetString();
+    _ws->send(encoded.str());
+
+    std::vector<unsigned char> message;
+    for (const auto& attachment : attachments)
+    {
+        const size_t offset = std::min(attachment.offset, attachment.buffer.size());
+        // with the packet type of Engine.IO in front
+        message.assign(1, 4);
+        message.insert(message.end(), attachment.buffer.begin() + offset, attachment.buffer.end());
+        _ws->send(message.data(), static_cast<unsigned int>(message.size()));
+    }
+}
+
 void SIOClientImpl::onOpen(WebSocket* /*ws*/)
 {
     _connected = true;
@@ -761,11 +981,22 @@ void SIOClientImpl::onOpen(WebSocket* /*ws*/)
 
 void SIOClientImpl::onMessage(WebSocket* /*ws*/, const WebSocket::Data& data)
 {
+    if (data.isBinary)
+    {
+        onBinaryMessage(data);
+        return;
+    }
+
     CC_LOG_INFO("SIOClientImpl::onMessage received: %s", data.bytes);
 
-    std::string payload = data.bytes;
-    int control = atoi(payload.substr(0, 1).c_str());
-    payload = payload.substr(1, payload.size() - 1);
+    // the messages of Socket.IO 1.x are parsed in place, the payload is copied for the others
+    const size_t length = strlen(data.bytes);
+    if (length == 0)
+        return;
+    const int control = (data.bytes[0] >= '0' && data.bytes[0] <= '9') ? data.bytes[0] - '0' : 0;
+    std::string payload;
+    if (_version == SocketIOPacket::SocketIOVersion::V09x || control != 4)
+        payload.assign(data.bytes + 1, length - 1);
 
     SIOClient *c = nullptr;
 
@@ -896,70 +1127,63 @@ void SIOClientImpl::onMessage(WebSocket* /*ws*/, const WebSocket::Data& data)
                 break;
             case 4:
             {
-                int control2 = payload.at(0) - '0';
-                CC_LOG_INFO("Message code: [%i]", control2);
-
-                std::string endpoint = "";
-
-                std::string::size_type a = payload.find("/");
-                std::string::size_type b = payload.find("[");
-
-                if (b != std::string::npos)
+                // parsed in place in the received message, after the packet type of Engine.IO
+                const char* begin = data.bytes + 1;
+                const char* end = data.bytes + length;
+                PacketHeader header;
+                if (!parsePacketHeader(begin, end, header))
                 {
-                    if (a != std::string::npos && a < b)
-                    {
-                        //we have an endpoint and a payload
-                        endpoint = payload.substr(a, b - (a + 1));
-                    }
-                }
-                else if (a != std::string::npos) {
-                    //we have an endpoint with no payload
-                    endpoint = payload.substr(a, payload.size() - a);
+                    CC_LOG_ERROR("Malformed packet: %s", data.bytes);
+                    break;
                 }
+                CC_LOG_INFO("Message code: [%i]", header.type);
 
-                // we didn't find and endpoint and we are in the default namespace
-                if (endpoint == "") endpoint = "/";
+                c = getClient(header.endpoint);
 
-                c = getClient(endpoint);
-
-                payload = payload.substr(1);
-
-                if (endpoint != "/") payload = payload.substr(endpoint.size());
-                if (endpoint != "/" && payload != "") payload = payload.substr(1);
-
-                switch (control2)
+                switch (header.type)
                 {
                 case 0:
                     CC_LOG_INFO("Socket Connected");
                     if (c) {
                         c->onConnect();
-                        c->fireEvent("connect", payload);
+                        c->fireEvent("connect", std::string(header.json, end));
                     }
                     break;
                 case 1:
                     CC_LOG_INFO("Socket Disconnected");
-                    disconnectFromEndpoint(endpoint);
-                    c->fireEvent("disconnect", payload);
+                    disconnectFromEndpoint(header.endpoint);
+                    if (c) c->fireEvent("disconnect", std::string(header.json, end));
                     break;
                 case 2:
+                case 5:
                 {
-                    CC_LOG_INFO("Event Received (%s)", payload.c_str());
-
-                    std::string::size_type payloadFirstSlashPos = payload.find("\"");
-                    std::string::size_type payloadSecondSlashPos = payload.substr(payloadFirstSlashPos + 1).find("\"");
-
-                    std::string eventname = payload.substr(payloadFirstSlashPos + 1,
-                                                           payloadSecondSlashPos - payloadFirstSlashPos + 1);
-
-                    CC_LOG_INFO("event name %s between %i and %i", eventname.c_str(),
-                              payloadFirstSlashPos, payloadSecondSlashPos);
-
-                    payload = payload.substr(payloadSecondSlashPos + 4,
-                                             payload.size() - (payloadSecondSlashPos + 5));
+                    std::string eventName;
+                    const char* args = nullptr;
+                    const char* argsEnd = nullptr;
+                    if (!scanEvent(header.json, end, eventName, args, argsEnd))
+                    {
+                        CC_LOG_ERROR("Malformed event: %s", data.bytes);
+                        break;
+                    }
+                    CC_LOG_INFO("Event Received (%s) with %d attachments", eventName.c_str(), header.attachmentCount);
 
-                    if (c) c->fireEvent(eventname, payload);
-                    if (c) c->getDelegate()->onMessage(c, payload);
+                    if (header.type == 5 && header.attachmentCount > 0)
+                    {
+                        _binaryPacket.type = header.type;
+                        _binaryPacket.attachmentCount = header.attachmentCount;
+                        _binaryPacket.endpoint = header.endpoint;
+                        _binaryPacket.eventName = std::move(eventName);
+                        _binaryPacket.args.assign(args, argsEnd);
+                        _binaryPacket.attachments.clear();
+                        break;
+                    }
 
+                    if (c)
+                    {
+                        SIOAttachments attachments;
+                        c->fireEvent(eventName, args, argsEnd - args, attachments);
+                        c->getDelegate()->onMessage(c, std::string(args, argsEnd));
+                    }
                 }
                 break;
                 case 3:
@@ -967,13 +1191,17 @@ void SIOClientImpl::onMessage(WebSocket* /*ws*/, const WebSocket::Data& data)
                     break;
                 case 4:
                     CC_LOG_ERROR("Error");
-                    if (c) c->fireEvent("error", payload);
-                    break;
-                case 5:
-                    CC_LOG_INFO("Binary Event");
+                    if (c) c->fireEvent("error", std::string(header.json, end));
                     break;
                 case 6:
                     CC_LOG_INFO("Binary Ack");
+                    // its attachments are dropped as they come
+                    if (header.attachmentCount > 0)
+                    {
+                        _binaryPacket.type = header.type;
+                        _binaryPacket.attachmentCount = header.attachmentCount;
+                        _binaryPacket.attachments.clear();
+                    }
                     break;
                 }
             }
@@ -992,6 +1220,41 @@ void SIOClientImpl::onMessage(WebSocket* /*ws*/, const WebSocket::Data& data)
     return;
 }
 
+void SIOClientImpl::onBinaryMessage(const WebSocket::Data& data)
+{
+    if (_binaryPacket.attachmentCount <= 0)
+    {
+        CC_LOG_INFO("SIOClientImpl::onBinaryMessage no binary packet waits for the %d bytes", static_cast<int>(data.len));
+        return;
+    }
+
+    // the buffer of the message is taken over where the websocket provides it
+    SIOAttachment attachment;
+    if (data.buffer)
+        attachment.buffer = std::move(*data.buffer);
+    else
+        attachment.buffer.assign(data.bytes, data.bytes + data.len);
+    // Engine.IO before protocol 4 starts a binary message with the packet type
+    attachment.offset = attachment.buffer.empty() ? 0 : 1;
+    _binaryPacket.attachments.push_back(std::move(attachment));
+
+    if (static_cast<int>(_binaryPacket.attachments.size()) == _binaryPacket.attachmentCount)
+    {
+        fireBinaryPacket();
+    }
+}
+
+void SIOClientImpl::fireBinaryPacket()
+{
+    BinaryPacket packet = std::move(_binaryPacket);
+    _binaryPacket = BinaryPacket();
+    if (packet.type != 5)
+        return;
+
+    SIOClient* c = getClient(packet.endpoint);
+    if (c) c->fireEvent(packet.eventName, packet.args.data(), packet.args.size(), packet.attachments);
+}
+
 void SIOClientImpl::onClose(WebSocket* /*ws*/)
 {
     if (!_clients.empty())
@@ -1072,6 +1335,18 @@ void SIOClient::emit(const std::string& eventname, const std::string& args)
 
 }
 
+void SIOClient::emit(const std::string& eventname, const std::string& args, const SIOAttachments& attachments)
+{
+    if(_connected)
+    {
+        _socket->emit(_path, eventname, args, attachments);
+    }
+    else
+    {
+        _delegate->onError(this, "Client not yet connected");
+    }
+}
+
 void SIOClient::disconnect()
 {
     if (_connected)
@@ -1113,6 +1388,22 @@ void SIOClient::fireEvent(const std::string& eventName, const std::string& data)
     CC_LOG_INFO("SIOClient::fireEvent no native event with name %s found", eventName.c_str());
 }
 
+void SIOClient::fireEvent(const std::string& eventName, const char* data, size_t length, SIOAttachments& attachments)
+{
+    CC_LOG_INFO("SIOClient::fireEvent called with event name: %s and %d bytes of data", eventName.c_str(), static_cast<int>(length));
+
+    _delegate->fireEventDataToScript(this, eventName, data, length, attachments);
+
+    auto iter = _eventRegistry.find(eventName);
+    if (iter != _eventRegistry.end() && iter->second)
+    {
+        iter->second(this, std::string(data, length));
+        return;
+    }
+
+    CC_LOG_INFO("SIOClient::fireEvent no native event with name %s found", eventName.c_str());
+}
+
 void SIOClient::setTag(const char* tag)
 {
     _tag = tag;
@@ -41,6 +41,11 @@ emitting an event to be handled by the server, argument json formatting is up to
 
     client->emit("eventname", "[{\"arg\":\"value\"}]");
 
+binary data goes as attachments of the event instead of being encoded in its arguments, the server receives them
+as Buffer arguments after the others
+
+    client->emit("eventname", "{\"arg\":\"value\"}", attachments);
+
 registering an event callback, target should be a member function in a subclass of SIODelegate
 CC_CALLBACK_2 is used to wrap the callback with std::bind and store as an SIOEvent
 
@@ -61,6 +66,7 @@ in the onClose method the pointer should be set to NULL or used to connect to a
 #include <string>
 #include <unordered_map>
 #include <functional>
+#include <vector>
 #include "base/Macros.h"
 #include "base/Map.h"
 
@@ -78,6 +84,18 @@ namespace network {
 class SIOClientImpl;
 class SIOClient;
 
+/**
+ * A binary attachment of a Socket.IO 1.x event, the bytes of a binary message that followed the event or the
+ * bytes to send after it.
+ */
+struct SIOAttachment
+{
+    std::vector<unsigned char> buffer;
+    /** Where the attachment starts in the buffer, after the packet type of Engine.IO a received message starts with. */
+    size_t offset = 0;
+};
+typedef std::vector<SIOAttachment> SIOAttachments;
+
 /**
  * Singleton and wrapper class to provide static creation method as well as registry of all sockets.
  *
@@ -145,6 +163,19 @@ public:
          * @param data the event's data information.
          */
         virtual void fireEventToScript(SIOClient* client, const std::string& eventName, const std::string& data) { CC_LOG_DEBUG("SIODelegate event '%s' fired with data: %s", eventName.c_str(), data.c_str()); };
+        /**
+         * Fire a Socket.IO 1.x event to script with the JSON text of its arguments, a slice of the received message,
+         * and the binary attachments the placeholders {"_placeholder":true,"num":index} of the arguments stand for.
+         * Both are valid during the call only, the delegate may move the buffers of the attachments out.
+         * Calls fireEventToScript() with a copy of the arguments by default.
+         *
+         * @param client the connected SIOClient object.
+         * @param eventName the event's name.
+         * @param data the JSON text of the event's arguments.
+         * @param length the length of data.
+         * @param attachments the binary attachments of the event.
+         */
+        virtual void fireEventDataToScript(SIOClient* client, const std::string& eventName, const char* data, size_t length, SIOAttachments& attachments) { fireEventToScript(client, eventName, std::string(data, length)); };
     };
 
     /**
@@ -216,6 +247,7 @@ private:
     uint32_t _instanceId;
 
     void fireEvent(const std::string& eventName, const std::string& data);
+    void fireEvent(const std::string& eventName, const char* data, size_t length, SIOAttachments& attachments);
 
     void onOpen();
     void onConnect();
@@ -261,6 +293,14 @@ public:
      * @param args
      */
     void emit(const std::string& eventname, const std::string& args);
+    /**
+     *  Emit the eventname, the args and binary attachments as a binary event, the server receives the attachments
+     *  as arguments after the args.
+     * @param eventname
+     * @param args
+     * @param attachments sent from their offsets on.
+     */
+    void emit(const std::string& eventname, const std::string& args, const SIOAttachments& attachments);
     /**
      * Used to register a socket.io event callback.
      * Event argument should be passed using CC_CALLBACK2(&Base::function, this).
@@ -32,6 +32,8 @@
 #endif
 
 static std::vector<cc::network::WebSocket*>* __websocketInstances = nullptr;
+// SRWebSocket doesn't support permessage-deflate, the setting is only kept
+static int __deflateWindowBits = 15;
 
 @interface WebSocketImpl : NSObject<SRWebSocketDelegate>
 {
@@ -234,6 +236,16 @@ void WebSocket::closeAllConnections()
     }
 }
 
+void WebSocket::setDeflateWindowBits(int windowBits)
+{
+    __deflateWindowBits = windowBits <= 0 ? 0 : std::min(std::max(windowBits, 8), 15);
+}
+
+int WebSocket::getDeflateWindowBits()
+{
+    return __deflateWindowBits;
+}
+
 WebSocket::WebSocket()
 : _impl(nil)
 {
@@ -33,7 +33,6 @@
 #include <atomic>
 #include <condition_variable>
 #include <errno.h>
-#include <list>
 #include <mutex>
 #include <memory>  // for std::shared_ptr
 #include <queue>
@@ -53,6 +52,8 @@
 
 #define WS_RX_BUFFER_SIZE (65536)
 #define WS_RESERVE_RECEIVE_BUFFER_SIZE (4096)
+// lws_cancel_service wakes the service up for new frames and requests, the timeout only bounds the idle wait
+#define WS_SERVICE_TIMEOUT_MS (50)
 
 #define  LOG_TAG    "WebSocket.cpp"
 
@@ -177,6 +178,90 @@ static void printWebSocketLog(int level, const char *line)
 #endif // #if CC_DEBUG > 0
 }
 
+// A frame of the send or receive queue of a connection. The buffer keeps its capacity while the frame is recycled.
+// Sent frames have LWS_PRE bytes of headroom before the payload for the header lws_write puts there.
+struct WsFrame
+{
+    std::atomic<WsFrame*> next;
+    std::vector<unsigned char> buffer;
+    ssize_t length;  // payload length
+    ssize_t issued;  // payload bytes written by lws_write
+    bool isBinary;
+
+    WsFrame() : next(nullptr), length(0), issued(0), isBinary(false) {}
+};
+
+/**
+ *  @brief Lock-free queue of frames between one producer thread and one consumer thread.
+ *  The frames the consumer has passed are recycled by the producer with their buffers,
+ *  so the queue only allocates when it holds more frames than it ever did before.
+ */
+class WsFrameQueue
+{
+public:
+    WsFrameQueue()
+    {
+        _head = _first = _tailCopy = new (std::nothrow) WsFrame();
+        _tail.store(_head, std::memory_order_relaxed);
+    }
+
+    ~WsFrameQueue()
+    {
+        WsFrame* frame = _first;
+        while (frame != nullptr)
+        {
+            WsFrame* next = frame->next.load(std::memory_order_relaxed);
+            delete frame;
+            frame = next;
+        }
+    }
+
+    // Producer: gets a frame to fill, a recycled one if the consumer has passed any.
+    WsFrame* acquire()
+    {
+        if (_first == _tailCopy)
+        {
+            _tailCopy = _tail.load(std::memory_order_acquire);
+        }
+        if (_first != _tailCopy)
+        {
+            WsFrame* frame = _first;
+            _first = frame->next.load(std::memory_order_relaxed);
+            frame->next.store(nullptr, std::memory_order_relaxed);
+            return frame;
+        }
+        return new (std::nothrow) WsFrame();
+    }
+
+    // Producer: publishes a frame from acquire.
+    void push(WsFrame* frame)
+    {
+        _head->next.store(frame, std::memory_order_release);
+        _head = frame;
+    }
+
+    // Consumer: the oldest frame, it stays valid until the frame after it is popped as well.
+    WsFrame* front() const
+    {
+        return _tail.load(std::memory_order_relaxed)->next.load(std::memory_order_acquire);
+    }
+
+    // Consumer: moves past the front frame.
+    void pop()
+    {
+        WsFrame* tail = _tail.load(std::memory_order_relaxed);
+        _tail.store(tail->next.load(std::memory_order_relaxed), std::memory_order_release);
+    }
+
+private:
+    // consumer, the last frame passed
+    std::atomic<WsFrame*> _tail;
+    // producer, the frames from _first to _tailCopy are recycled
+    WsFrame* _head;
+    WsFrame* _first;
+    WsFrame* _tailCopy;
+};
+
 class WebSocketImpl
 {
 public:
@@ -213,6 +298,12 @@ private:
     int onConnectionError();
     int onConnectionClosed();
 
+    // Invoked in websocket thread before servicing, asks for the writable callback if frames are queued or it's closing
+    void requestWritable();
+    // Invoked in cocos thread, delivers the received frames
+    void dispatchReceivedFrames();
+    void sendFrame(const unsigned char* data, size_t len, bool isBinary);
+
     struct lws_vhost* createVhost(struct lws_protocols* protocols, int& sslConnection);
 
 private:
@@ -220,7 +311,19 @@ private:
     cc::network::WebSocket::State _readyState;
     std::mutex  _readyStateMutex;
     std::string _url;
-    std::vector<char> _receivedData;
+    // the extensions offered by the connection, lws keeps using them after connecting
+    std::string _deflateOffer;
+    struct lws_extension _extensions[3];
+
+    // cocos thread to websocket thread
+    WsFrameQueue _sendQueue;
+    std::atomic<size_t> _bufferedAmount;
+    std::atomic<size_t> _sendingFrameCount;
+    bool _isWritableRequested;
+    // websocket thread to cocos thread, _receivingFrame is assembled from the fragments
+    WsFrameQueue _receiveQueue;
+    WsFrame* _receivingFrame;
+    std::atomic<bool> _isReceiveDispatchScheduled;
 
     struct lws* _wsInstance;
     struct lws_protocols* _lwsProtocols;
@@ -250,17 +353,12 @@ private:
     friend class WebSocketCallbackWrapper;
 };
 
-enum WS_MSG {
-    WS_MSG_TO_SUBTRHEAD_SENDING_STRING = 0,
-    WS_MSG_TO_SUBTRHEAD_SENDING_BINARY,
-    WS_MSG_TO_SUBTHREAD_CREATE_CONNECTION
-};
-
 class WsThreadHelper;
 
 static std::vector<WebSocketImpl*>* __websocketInstances = nullptr;
 static std::mutex __instanceMutex;
-static struct lws_context* __wsContext = nullptr;
+static std::atomic<struct lws_context*> __wsContext(nullptr);
+static std::atomic<int> __deflateWindowBits(15);
 static WsThreadHelper* __wsHelper = nullptr;
 
 #if (CC_PLATFORM == CC_PLATFORM_ANDROID)
@@ -317,23 +415,8 @@ static lws_context_creation_info convertToContextCreationInfo(const struct lws_p
     return info;
 }
 
-class WsMessage
-{
-public:
-    WsMessage() : id(++__id), what(0), data(nullptr), user(nullptr){}
-    unsigned int id;
-    unsigned int what; // message type
-    cc::network::WebSocket::Data* data;
-    void* user;
-
-private:
-    static unsigned int __id;
-};
-
-unsigned int WsMessage::__id = 0;
-
 /**
- *  @brief Websocket thread helper, it's used for sending message between UI thread and websocket thread.
+ *  @brief Websocket thread helper, it runs the lws context serving all the connections in one thread.
  */
 class WsThreadHelper
 {
@@ -349,10 +432,11 @@ public:
     // Sends message to Cocos thread. It's needed to be invoked in Websocket thread.
     void sendMessageToCocosThread(const std::function<void()>& cb);
 
-    // Sends message to Websocket thread. It's needs to be invoked in Cocos thread.
-    void sendMessageToWebSocketThread(WsMessage *msg);
+    // Asks websocket thread to open the connection. It's needs to be invoked in Cocos thread.
+    void requestConnection(WebSocketImpl* ws);
 
-    size_t countBufferdBytes(const WebSocketImpl *ws);
+    // Wakes up websocket thread waiting in lws_service, it could be invoked in any thread.
+    void wakeUp();
 
     // Waits the sub-thread (websocket thread) to exit,
     void joinWebSocketThread();
@@ -364,11 +448,13 @@ public:
 protected:
     void wsThreadEntryFunc();
 public:
-    std::list<WsMessage*>* _subThreadWsMessageQueue;
-    std::mutex   _subThreadWsMessageQueueMutex;
+    // the connections being served, only used in websocket thread
+    std::vector<WebSocketImpl*> _connections;
+    std::vector<WebSocketImpl*> _connectionRequests;
+    std::mutex _connectionRequestsMutex;
     std::thread* _subThreadInstance;
 private:
-    bool _needQuit;
+    std::atomic<bool> _needQuit;
 };
 
 // Wrapper for converting websocket callback from static function to member function of WebSocket class.
@@ -404,14 +490,12 @@ WsThreadHelper::WsThreadHelper()
 : _subThreadInstance(nullptr)
 , _needQuit(false)
 {
-    _subThreadWsMessageQueue = new (std::nothrow) std::list<WsMessage*>();
 }
 
 WsThreadHelper::~WsThreadHelper()
 {
     joinWebSocketThread();
     CC_SAFE_DELETE(_subThreadInstance);
-    delete _subThreadWsMessageQueue;
 }
 
 bool WsThreadHelper::createWebSocketThread()
@@ -424,39 +508,29 @@ bool WsThreadHelper::createWebSocketThread()
 void WsThreadHelper::quitWebSocketThread()
 {
     _needQuit = true;
+    wakeUp();
 }
 
 void WsThreadHelper::onSubThreadLoop()
 {
     if (__wsContext)
     {
-        //        _readyStateMutex.unlock();
-        __wsHelper->_subThreadWsMessageQueueMutex.lock();
-        bool isEmpty = __wsHelper->_subThreadWsMessageQueue->empty();
+        std::vector<WebSocketImpl*> requests;
+        {
+            std::lock_guard<std::mutex> lk(_connectionRequestsMutex);
+            requests.swap(_connectionRequests);
+        }
+        for (auto ws : requests)
+        {
+            // REFINE: ws may be a invalid pointer
+            ws->onClientOpenConnectionRequest();
+        }
 
-        if (!isEmpty)
+        for (auto ws : _connections)
         {
-            auto iter = __wsHelper->_subThreadWsMessageQueue->begin();
-            for (; iter != __wsHelper->_subThreadWsMessageQueue->end(); )
-            {
-                auto msg = (*iter);
-                auto ws = (WebSocketImpl*)msg->user;
-                // REFINE: ws may be a invalid pointer
-                if (msg->what == WS_MSG_TO_SUBTHREAD_CREATE_CONNECTION)
-                {
-                    ws->onClientOpenConnectionRequest();
-                    delete *iter;
-                    iter = __wsHelper->_subThreadWsMessageQueue->erase(iter);
-                }
-                else
-                {
-                    ++iter;
-                }
-            }
+            ws->requestWritable();
         }
-        __wsHelper->_subThreadWsMessageQueueMutex.unlock();
-        // Cause delay 4ms for event WS_MSG_TO_SUBTHREAD_CREATE_CONNECTION
-        lws_service(__wsContext, 4);
+        lws_service(__wsContext, WS_SERVICE_TIMEOUT_MS);
     }
 }
 
@@ -481,6 +555,7 @@ void WsThreadHelper::onSubThreadEnded()
     if (__wsContext != nullptr)
     {
         lws_context_destroy(__wsContext);
+        __wsContext = nullptr;
     }
 }
 
@@ -504,27 +579,24 @@ void WsThreadHelper::sendMessageToCocosThread(const std::function<void()>& cb)
     cc::Application::getInstance()->getScheduler()->performFunctionInCocosThread(cb);
 }
 
-void WsThreadHelper::sendMessageToWebSocketThread(WsMessage *msg)
+void WsThreadHelper::requestConnection(WebSocketImpl* ws)
 {
-    std::lock_guard<std::mutex> lk(_subThreadWsMessageQueueMutex);
-    _subThreadWsMessageQueue->push_back(msg);
+    {
+        std::lock_guard<std::mutex> lk(_connectionRequestsMutex);
+        _connectionRequests.push_back(ws);
+    }
+    wakeUp();
 }
 
-size_t WsThreadHelper::countBufferdBytes(const WebSocketImpl *ws)
+void WsThreadHelper::wakeUp()
 {
-    std::lock_guard<std::mutex> lk(_subThreadWsMessageQueueMutex);
-    size_t total = 0;
-    for (auto msg : *_subThreadWsMessageQueue)
+    struct lws_context* context = __wsContext;
+    if (context != nullptr)
     {
-        if (msg->user == ws && msg->data && (msg->what == WS_MSG_TO_SUBTRHEAD_SENDING_STRING
-        || msg->what == WS_MSG_TO_SUBTRHEAD_SENDING_BINARY)) {
-            total += msg->data->getRemain();
-        }
+        lws_cancel_service(context);
     }
-    return total;
 }
 
-
 void WsThreadHelper::joinWebSocketThread()
 {
     if (_subThreadInstance->joinable())
@@ -533,57 +605,6 @@ void WsThreadHelper::joinWebSocketThread()
     }
 }
 
-// Define a WebSocket frame
-class WebSocketFrame
-{
-public:
-    WebSocketFrame()
-        : _payload(nullptr)
-        , _payloadLength(0)
-        , _frameLength(0)
-    {
-    }
-
-    bool init(unsigned char* buf, ssize_t len)
-    {
-        if (buf == nullptr && len > 0)
-            return false;
-
-        if (!_data.empty())
-        {
-            LOGD("WebSocketFrame was initialized, should not init it again!\n");
-            return false;
-        }
-
-        _data.resize(LWS_PRE + len);
-        if (len > 0)
-        {
-            std::copy(buf, buf+len, _data.begin() + LWS_PRE);
-        }
-
-        _payload = _data.data() + LWS_PRE;
-        _payloadLength = len;
-        _frameLength = len;
-        return true;
-    }
-
-    void update(ssize_t issued)
-    {
-        _payloadLength -= issued;
-        _payload += issued;
-    }
-
-    unsigned char* getPayload() const { return _payload; }
-    ssize_t getPayloadLength() const { return _payloadLength; }
-    ssize_t getFrameLength() const { return _frameLength; }
-private:
-    unsigned char* _payload;
-    ssize_t _payloadLength;
-
-    ssize_t _frameLength;
-    std::vector<unsigned char> _data;
-};
-
 //
 
 void WebSocketImpl::closeAllConnections()
@@ -607,14 +628,17 @@ void WebSocketImpl::closeAllConnections()
 WebSocketImpl::WebSocketImpl(cc::network::WebSocket* ws)
 : _ws(ws)
 , _readyState(cc::network::WebSocket::State::CONNECTING)
+, _bufferedAmount(0)
+, _sendingFrameCount(0)
+, _isWritableRequested(false)
+, _receivingFrame(nullptr)
+, _isReceiveDispatchScheduled(false)
 , _wsInstance(nullptr)
 , _lwsProtocols(nullptr)
 , _isDestroyed(std::make_shared<std::atomic<bool>>(false))
 , _delegate(nullptr)
 , _closeState(CloseState::NONE)
 {
-    // reserve data buffer to avoid allocate memory frequently
-    _receivedData.reserve(WS_RESERVE_RECEIVE_BUFFER_SIZE);
     if (__websocketInstances == nullptr)
     {
         __websocketInstances = new (std::nothrow) std::vector<WebSocketImpl*>();
@@ -667,6 +691,9 @@ WebSocketImpl::~WebSocketImpl()
 // NOTE: Refer to the comment in constructor!!!
 //    cc::Director::getInstance()->getEventDispatcher()->removeEventListener(_resetDirectorListener);
 
+    // it was taken from _receiveQueue but not pushed back
+    delete _receivingFrame;
+
     *_isDestroyed = true;
 }
 
@@ -719,13 +746,10 @@ bool WebSocketImpl::init(const cc::network::WebSocket::Delegate& delegate,
         isWebSocketThreadCreated = false;
     }
 
-    WsMessage* msg = new (std::nothrow) WsMessage();
-    msg->what = WS_MSG_TO_SUBTHREAD_CREATE_CONNECTION;
-    msg->user = this;
-    __wsHelper->sendMessageToWebSocketThread(msg);
+    __wsHelper->requestConnection(this);
 
     // fixed https://github.com/cocos2d/cocos2d-x/issues/17433
-    // createWebSocketThread has to be after message WS_MSG_TO_SUBTHREAD_CREATE_CONNECTION was sent.
+    // createWebSocketThread has to be after the connection was requested.
     // And websocket thread should only be created once.
     if (!isWebSocketThreadCreated)
     {
@@ -737,7 +761,7 @@ bool WebSocketImpl::init(const cc::network::WebSocket::Delegate& delegate,
 
 size_t WebSocketImpl::getBufferedAmount() const
 {
-    return __wsHelper->countBufferdBytes(this);
+    return _bufferedAmount.load(std::memory_order_relaxed);
 }
 
 std::string WebSocketImpl::getExtensions() const
@@ -755,18 +779,7 @@ void WebSocketImpl::send(const std::string& message)
     if (_readyState == cc::network::WebSocket::State::OPEN)
     {
         // In main thread
-        cc::network::WebSocket::Data* data = new (std::nothrow) cc::network::WebSocket::Data();
-        data->bytes = (char*)malloc(message.length() + 1);
-        // Make sure the last byte is '\0'
-        data->bytes[message.length()] = '\0';
-        strcpy(data->bytes, message.c_str());
-        data->len = static_cast<ssize_t>(message.length());
-
-        WsMessage* msg = new (std::nothrow) WsMessage();
-        msg->what = WS_MSG_TO_SUBTRHEAD_SENDING_STRING;
-        msg->data = data;
-        msg->user = this;
-        __wsHelper->sendMessageToWebSocketThread(msg);
+        sendFrame((const unsigned char*)message.data(), message.length(), false);
     }
     else
     {
@@ -779,25 +792,7 @@ void WebSocketImpl::send(const unsigned char* binaryMsg, unsigned int len)
     if (_readyState == cc::network::WebSocket::State::OPEN)
     {
         // In main thread
-        cc::network::WebSocket::Data* data = new (std::nothrow) cc::network::WebSocket::Data();
-        if (len == 0)
-        {
-            // If data length is zero, allocate 1 byte for safe.
-            data->bytes = (char*)malloc(1);
-            data->bytes[0] = '\0';
-        }
-        else
-        {
-            data->bytes = (char*)malloc(len);
-            memcpy((void*)data->bytes, (void*)binaryMsg, len);
-        }
-        data->len = len;
-
-        WsMessage* msg = new (std::nothrow) WsMessage();
-        msg->what = WS_MSG_TO_SUBTRHEAD_SENDING_BINARY;
-        msg->data = data;
-        msg->user = this;
-        __wsHelper->sendMessageToWebSocketThread(msg);
+        sendFrame(binaryMsg, len, true);
     }
     else
     {
@@ -805,6 +800,33 @@ void WebSocketImpl::send(const unsigned char* binaryMsg, unsigned int len)
     }
 }
 
+// The message is copied once, into a recycled frame behind the headroom lws_write needs, and written from there.
+void WebSocketImpl::sendFrame(const unsigned char* data, size_t len, bool isBinary)
+{
+    WsFrame* frame = _sendQueue.acquire();
+    if (frame == nullptr)
+    {
+        LOGE("Couldn't allocate the websocket frame, drop the sending data!\n");
+        return;
+    }
+    frame->buffer.resize(LWS_PRE + len);
+    if (len > 0)
+    {
+        memcpy(frame->buffer.data() + LWS_PRE, data, len);
+    }
+    frame->length = static_cast<ssize_t>(len);
+    frame->issued = 0;
+    frame->isBinary = isBinary;
+
+    _bufferedAmount.fetch_add(len, std::memory_order_relaxed);
+    bool wasIdle = _sendingFrameCount.fetch_add(1, std::memory_order_relaxed) == 0;
+    _sendQueue.push(frame);
+    if (wasIdle)
+    {
+        __wsHelper->wakeUp();
+    }
+}
+
 void WebSocketImpl::close()
 {
     if (_closeState != CloseState::NONE)
@@ -830,6 +852,7 @@ void WebSocketImpl::close()
         _readyState = cc::network::WebSocket::State::CLOSING;
         _readyStateMutex.unlock();
     }
+    __wsHelper->wakeUp();
 
     {
         std::unique_lock<std::mutex> lkClose(_closeMutex);
@@ -867,6 +890,7 @@ void WebSocketImpl::closeAsync()
     }
 
     _readyState = cc::network::WebSocket::State::CLOSING;
+    __wsHelper->wakeUp();
 }
 
 cc::network::WebSocket::State WebSocketImpl::getReadyState() const
@@ -980,22 +1004,26 @@ void WebSocketImpl::onClientOpenConnectionRequest()
 {
     if (nullptr != __wsContext)
     {
-        static const struct lws_extension exts[] = {
-            {
-                "permessage-deflate",
-                lws_extension_callback_pm_deflate,
-                // client_no_context_takeover extension is not supported in the current version, it will cause connection fail
-                // It may be a bug of lib websocket build
-                //            "permessage-deflate; client_no_context_takeover; client_max_window_bits"
-                "permessage-deflate; client_max_window_bits"
-            },
+        memset(_extensions, 0, sizeof(_extensions));
+        int windowBits = __deflateWindowBits;
+        if (windowBits > 0)
+        {
+            // client_no_context_takeover extension is not supported in the current version, it will cause connection fail
+            // It may be a bug of lib websocket build
+            //            "permessage-deflate; client_no_context_takeover; client_max_window_bits"
+            _deflateOffer = "permessage-deflate; client_max_window_bits";
+            if (windowBits < 15)
             {
-                "deflate-frame",
-                lws_extension_callback_pm_deflate,
-                "deflate_frame"
-            },
-            { nullptr, nullptr, nullptr /* terminator */ }
-        };
+                // both sides compress with the smaller window
+                _deflateOffer += "=" + std::to_string(windowBits) + "; server_max_window_bits=" + std::to_string(windowBits);
+            }
+            _extensions[0].name = "permessage-deflate";
+            _extensions[0].callback = lws_extension_callback_pm_deflate;
+            _extensions[0].client_offer = _deflateOffer.c_str();
+            _extensions[1].name = "deflate-frame";
+            _extensions[1].callback = lws_extension_callback_pm_deflate;
+            _extensions[1].client_offer = "deflate_frame";
+        }
 
         _readyStateMutex.lock();
         _readyState = cc::network::WebSocket::State::CONNECTING;
@@ -1040,7 +1068,7 @@ void WebSocketImpl::onClientOpenConnectionRequest()
         connectInfo.protocol = _clientSupportedProtocols.empty() ? nullptr : _clientSupportedProtocols.c_str();
         connectInfo.ietf_version_or_minus_one = -1;
         connectInfo.userdata = this;
-        connectInfo.client_exts = exts;
+        connectInfo.client_exts = _extensions;
         connectInfo.vhost = vhost;
 
         _wsInstance = lws_client_connect_via_info(&connectInfo);
@@ -1050,6 +1078,7 @@ void WebSocketImpl::onClientOpenConnectionRequest()
             onConnectionError();
             return;
         }
+        __wsHelper->_connections.push_back(this);
     }
     else
     {
@@ -1057,9 +1086,24 @@ void WebSocketImpl::onClientOpenConnectionRequest()
     }
 }
 
+void WebSocketImpl::requestWritable()
+{
+    if (_isWritableRequested || _wsInstance == nullptr)
+    {
+        return;
+    }
+    if (_sendQueue.front() == nullptr && getReadyState() != cc::network::WebSocket::State::CLOSING)
+    {
+        return;
+    }
+    _isWritableRequested = true;
+    lws_callback_on_writable(_wsInstance);
+}
+
 int WebSocketImpl::onClientWritable()
 {
 //    LOGD("onClientWritable ... \n");
+    _isWritableRequested = false;
     {
         std::lock_guard<std::mutex> readMutex(_readyStateMutex);
         if (_readyState == cc::network::WebSocket::State::CLOSING)
@@ -1069,158 +1113,66 @@ int WebSocketImpl::onClientWritable()
         }
     }
 
-    do
+    // One fragment of the oldest frame is written per callback
+    WsFrame* frame = _sendQueue.front();
+    if (frame != nullptr)
     {
-        std::lock_guard<std::mutex> lk(__wsHelper->_subThreadWsMessageQueueMutex);
+        const ssize_t c_bufferSize = WS_RX_BUFFER_SIZE;
 
-        if (__wsHelper->_subThreadWsMessageQueue->empty())
-        {
-            break;
-        }
+        const ssize_t remaining = frame->length - frame->issued;
+        const ssize_t n = std::min(remaining, c_bufferSize);
 
-        std::list<WsMessage*>::iterator iter = __wsHelper->_subThreadWsMessageQueue->begin();
+        int writeProtocol;
 
-        while (iter != __wsHelper->_subThreadWsMessageQueue->end())
+        if (frame->issued == 0)
         {
-            WsMessage* msg = *iter;
-            if (msg->user == this)
-            {
-                break;
-            }
-            else
-            {
-                ++iter;
-            }
+            writeProtocol = frame->isBinary ? LWS_WRITE_BINARY : LWS_WRITE_TEXT;
+
+            // If we have more than 1 fragment
+            if (frame->length > c_bufferSize)
+                writeProtocol |= LWS_WRITE_NO_FIN;
+        } else {
+            // we are in the middle of fragments
+            writeProtocol = LWS_WRITE_CONTINUATION;
+            // and if not in the last fragment
+            if (remaining != n)
+                writeProtocol |= LWS_WRITE_NO_FIN;
         }
 
-        ssize_t bytesWrite = 0;
-        if (iter != __wsHelper->_subThreadWsMessageQueue->end())
-        {
-            WsMessage* subThreadMsg = *iter;
-
-            cc::network::WebSocket::Data* data = (cc::network::WebSocket::Data*)subThreadMsg->data;
-
-            const ssize_t c_bufferSize = WS_RX_BUFFER_SIZE;
-
-            const ssize_t remaining = data->len - data->issued;
-            const ssize_t n = std::min(remaining, c_bufferSize);
-
-            WebSocketFrame* frame = nullptr;
+        // The LWS_PRE bytes before a fragment are the headroom or the payload already sent, lws puts the header there.
+        // lws_write takes the whole fragment, it buffers what the socket doesn't accept yet.
+        unsigned char* payload = frame->buffer.data() + LWS_PRE + frame->issued;
+        ssize_t bytesWrite = lws_write(_wsInstance, payload, n, (lws_write_protocol)writeProtocol);
 
-            if (data->ext)
-            {
-                frame = (WebSocketFrame*)data->ext;
-            }
-            else
-            {
-                frame = new (std::nothrow) WebSocketFrame();
-                bool success = frame && frame->init((unsigned char*)(data->bytes + data->issued), n);
-                if (success)
-                {
-                    data->ext = frame;
-                }
-                else
-                { // If frame initialization failed, delete the frame and drop the sending data
-                  // These codes should never be called.
-                    LOGD("WebSocketFrame initialization failed, drop the sending data, msg(%d)\n", (int)subThreadMsg->id);
-                    delete frame;
-                    CC_SAFE_FREE(data->bytes);
-                    CC_SAFE_DELETE(data);
-                    __wsHelper->_subThreadWsMessageQueue->erase(iter);
-                    CC_SAFE_DELETE(subThreadMsg);
-                    break;
-                }
-            }
-
-            int writeProtocol;
-
-            if (data->issued == 0)
-            {
-                if (WS_MSG_TO_SUBTRHEAD_SENDING_STRING == subThreadMsg->what)
-                {
-                    writeProtocol = LWS_WRITE_TEXT;
-                }
-                else
-                {
-                    writeProtocol = LWS_WRITE_BINARY;
-                }
-
-                // If we have more than 1 fragment
-                if (data->len > c_bufferSize)
-                    writeProtocol |= LWS_WRITE_NO_FIN;
-            } else {
-                // we are in the middle of fragments
-                writeProtocol = LWS_WRITE_CONTINUATION;
-                // and if not in the last fragment
-                if (remaining != n)
-                    writeProtocol |= LWS_WRITE_NO_FIN;
-            }
-
-            bytesWrite = lws_write(_wsInstance, frame->getPayload(), frame->getPayloadLength(), (lws_write_protocol)writeProtocol);
+        // Handle the result of lws_write
+        if (bytesWrite < 0)
+        {
+            LOGD("ERROR: lws_write return: %d, but it should be %d, drop this message.\n", (int)bytesWrite, (int)n);
+            // socket error, we need to close the socket connection
+            _bufferedAmount.fetch_sub(remaining, std::memory_order_relaxed);
+            _sendingFrameCount.fetch_sub(1, std::memory_order_relaxed);
+            _sendQueue.pop();
 
-            // Handle the result of lws_write
-            // Buffer overrun?
-            if (bytesWrite < 0)
-            {
-                LOGD("ERROR: msg(%u), lws_write return: %d, but it should be %d, drop this message.\n", subThreadMsg->id, (int)bytesWrite, (int)n);
-                // socket error, we need to close the socket connection
-                CC_SAFE_FREE(data->bytes);
-                delete ((WebSocketFrame*)data->ext);
-                data->ext = nullptr;
-                CC_SAFE_DELETE(data);
-                __wsHelper->_subThreadWsMessageQueue->erase(iter);
-                CC_SAFE_DELETE(subThreadMsg);
-
-                closeAsync();
-            }
-            else if (bytesWrite < frame->getPayloadLength())
+            closeAsync();
+        }
+        else
+        {
+            if (bytesWrite < n)
             {
-                frame->update(bytesWrite);
-                LOGD("frame wasn't sent completely, bytesWrite: %d, remain: %d\n", (int)bytesWrite, (int)frame->getPayloadLength());
+                LOGD("frame wasn't taken completely, bytesWrite: %d, expected: %d\n", (int)bytesWrite, (int)n);
             }
-            // Do we have another fragments to send?
-            else if (remaining > frame->getFrameLength() && bytesWrite == frame->getPayloadLength())
+            frame->issued += n;
+            _bufferedAmount.fetch_sub(n, std::memory_order_relaxed);
+            if (frame->issued >= frame->length)
             {
-                // A frame was totally sent, plus data->issued to send next frame
-                LOGD("msg(%u) append: %d + %d = %d\n", subThreadMsg->id, (int)data->issued, (int)frame->getFrameLength(), (int)(data->issued + frame->getFrameLength()));
-                data->issued += frame->getFrameLength();
-                delete ((WebSocketFrame*)data->ext);
-                data->ext = nullptr;
-            }
-            // Safely done!
-            else
-            {
-                LOGD("Safely done, msg(%d)!\n", subThreadMsg->id);
-                if (remaining == frame->getFrameLength())
-                {
-                    LOGD("msg(%u) append: %d + %d = %d\n", subThreadMsg->id, (int)data->issued, (int)frame->getFrameLength(), (int)(data->issued + frame->getFrameLength()));
-                    LOGD("msg(%u) was totally sent!\n", subThreadMsg->id);
-                }
-                else
-                {
-                    LOGD("ERROR: msg(%u), remaining(%d) < bytesWrite(%d)\n", subThreadMsg->id, (int)remaining, (int)frame->getFrameLength());
-                    LOGD("Drop the msg(%u)\n", subThreadMsg->id);
-                    closeAsync();
-                }
-
-                CC_SAFE_FREE(data->bytes);
-                delete ((WebSocketFrame*)data->ext);
-                data->ext = nullptr;
-                CC_SAFE_DELETE(data);
-                __wsHelper->_subThreadWsMessageQueue->erase(iter);
-                CC_SAFE_DELETE(subThreadMsg);
-
-                LOGD("-----------------------------------------------------------\n");
+                _sendingFrameCount.fetch_sub(1, std::memory_order_relaxed);
+                _sendQueue.pop();
             }
         }
-
-    } while(false);
-
-    if (_wsInstance != nullptr)
-    {
-        lws_callback_on_writable(_wsInstance);
     }
 
+    requestWritable();
+
     return 0;
 }
 
@@ -1229,12 +1181,26 @@ int WebSocketImpl::onClientReceivedData(void* in, ssize_t len)
     // In websocket thread
     static int packageIndex = 0;
     packageIndex++;
+
+    // The fragments are assembled in a frame of _receiveQueue, its buffer is reused once the frame was delivered
+    if (_receivingFrame == nullptr)
+    {
+        _receivingFrame = _receiveQueue.acquire();
+        if (_receivingFrame == nullptr)
+        {
+            LOGE("Couldn't allocate the websocket frame, drop the received data!\n");
+            return 0;
+        }
+        _receivingFrame->buffer.clear();
+        _receivingFrame->buffer.reserve(WS_RESERVE_RECEIVE_BUFFER_SIZE);
+    }
+
     if (in != nullptr && len > 0)
     {
         LOGD("Receiving data:index:%d, len=%d\n", packageIndex, (int)len);
 
         unsigned char* inData = (unsigned char*)in;
-        _receivedData.insert(_receivedData.end(), inData, inData + len);
+        _receivingFrame->buffer.insert(_receivingFrame->buffer.end(), inData, inData + len);
     }
     else
     {
@@ -1248,44 +1214,62 @@ int WebSocketImpl::onClientReceivedData(void* in, ssize_t len)
 
     if (remainingSize == 0 && isFinalFragment)
     {
-        std::vector<char>* frameData = new (std::nothrow) std::vector<char>(std::move(_receivedData));
+        WsFrame* frame = _receivingFrame;
+        _receivingFrame = nullptr;
 
-        // reset capacity of received data buffer
-        _receivedData.reserve(WS_RESERVE_RECEIVE_BUFFER_SIZE);
+        frame->length = static_cast<ssize_t>(frame->buffer.size());
+        frame->isBinary = (lws_frame_is_binary(_wsInstance) != 0);
 
-        ssize_t frameSize = frameData->size();
-
-        bool isBinary = (lws_frame_is_binary(_wsInstance) != 0);
+        if (!frame->isBinary)
+        {
+            frame->buffer.push_back('\0');
+        }
+        _receiveQueue.push(frame);
 
-        if (!isBinary)
+        // one dispatch delivers all the frames queued until it runs
+        if (!_isReceiveDispatchScheduled.exchange(true))
         {
-            frameData->push_back('\0');
+            std::shared_ptr<std::atomic<bool>> isDestroyed = _isDestroyed;
+            __wsHelper->sendMessageToCocosThread([this, isDestroyed](){
+                // In UI thread
+                if (*isDestroyed)
+                {
+                    LOGD("WebSocket instance was destroyed!\n");
+                }
+                else
+                {
+                    dispatchReceivedFrames();
+                }
+            });
         }
+    }
+
+    return 0;
+}
 
-        std::shared_ptr<std::atomic<bool>> isDestroyed = _isDestroyed;
-        __wsHelper->sendMessageToCocosThread([this, frameData, frameSize, isBinary, isDestroyed](){
-            // In UI thread
-            LOGD("Notify data len %d to Cocos thread.\n", (int)frameSize);
+void WebSocketImpl::dispatchReceivedFrames()
+{
+    std::shared_ptr<std::atomic<bool>> isDestroyed = _isDestroyed;
+    _isReceiveDispatchScheduled = false;
 
-            cc::network::WebSocket::Data data;
-            data.isBinary = isBinary;
-            data.bytes = (char*)frameData->data();
-            data.len = frameSize;
+    while (WsFrame* frame = _receiveQueue.front())
+    {
+        LOGD("Notify data len %d to Cocos thread.\n", (int)frame->length);
 
-            if (*isDestroyed)
-            {
-                LOGD("WebSocket instance was destroyed!\n");
-            }
-            else
-            {
-                _delegate->onMessage(_ws, data);
-            }
+        cc::network::WebSocket::Data data;
+        data.isBinary = frame->isBinary;
+        data.bytes = (char*)frame->buffer.data();
+        data.len = frame->length;
+        data.buffer = &frame->buffer;
+        _delegate->onMessage(_ws, data);
 
-            delete frameData;
-        });
+        // onMessage may destroy the websocket
+        if (*isDestroyed)
+        {
+            return;
+        }
+        _receiveQueue.pop();
     }
-
-    return 0;
 }
 
 int WebSocketImpl::onConnectionOpened()
@@ -1297,6 +1281,7 @@ int WebSocketImpl::onConnectionOpened()
      * start the ball rolling,
      * LWS_CALLBACK_CLIENT_WRITEABLE will come next service
      */
+    _isWritableRequested = true;
     lws_callback_on_writable(_wsInstance);
 
     {
@@ -1353,6 +1338,12 @@ int WebSocketImpl::onConnectionError()
 
 int WebSocketImpl::onConnectionClosed()
 {
+    auto connectionIter = std::find(__wsHelper->_connections.begin(), __wsHelper->_connections.end(), this);
+    if (connectionIter != __wsHelper->_connections.end())
+    {
+        __wsHelper->_connections.erase(connectionIter);
+    }
+
     {
         std::lock_guard<std::mutex> lk(_readyStateMutex);
         LOGD("WebSocket (%p) onConnectionClosed, state: %d ...\n", this, (int)_readyState);
@@ -1470,6 +1461,18 @@ void WebSocket::closeAllConnections()
     WebSocketImpl::closeAllConnections();
 }
 
+/*static*/
+void WebSocket::setDeflateWindowBits(int windowBits)
+{
+    __deflateWindowBits = windowBits <= 0 ? 0 : std::min(std::max(windowBits, 8), 15);
+}
+
+/*static*/
+int WebSocket::getDeflateWindowBits()
+{
+    return __deflateWindowBits;
+}
+
 WebSocket::WebSocket()
 {
     _impl = new (std::nothrow) WebSocketImpl(this);
@@ -68,6 +68,15 @@ public:
      * @note This method has to be invoked on Cocos Thread
      */
     static void closeAllConnections();
+
+    /**
+     * Sets the largest LZ77 window, in bits, negotiated for permessage-deflate by the connections opened afterwards.
+     * Smaller windows need less memory to inflate and deflate the messages on both sides, at some compression ratio.
+     * @param windowBits 8 to 15, 15 by default. 0 doesn't offer permessage-deflate at all.
+     * @note It's ignored by the implementation which doesn't support permessage-deflate.
+     */
+    static void setDeflateWindowBits(int windowBits);
+    static int getDeflateWindowBits();
     
     /**
      * Constructor of WebSocket.
@@ -91,11 +100,16 @@ public:
      */
     struct Data
     {
-        Data():bytes(nullptr), len(0), issued(0), isBinary(false), ext(nullptr){}
+        Data():bytes(nullptr), len(0), issued(0), isBinary(false), ext(nullptr), buffer(nullptr){}
         char* bytes;
         ssize_t len, issued;
         bool isBinary;
         void* ext;
+        /**
+         * The native buffer bytes point to, nullptr if the implementation doesn't provide it.
+         * onMessage may move it out of a binary message to keep the bytes without copying them, bytes is invalid then.
+         */
+        std::vector<unsigned char>* buffer;
         ssize_t getRemain() { return std::max((ssize_t)0, len - issued); }
     };
 
@@ -71,22 +71,25 @@ namespace {
 
     struct AsyncTaskData {
         std::mutex mtx;
-        std::list<std::function<void()> > tasks;
+        std::vector<std::function<void()> > tasks;
+        // only used in server thread, keeps its capacity between the flushes
+        std::vector<std::function<void()> > running;
     };
 
     // run in server thread loop
     void flush_tasks_in_server_loop_cb(uv_async_t* asyn)
     {
         AsyncTaskData* data = (AsyncTaskData*)asyn->data;
-        std::lock_guard<std::mutex> guard(data->mtx);
-        while (!data->tasks.empty())
         {
-            // fetch task, run task
-            data->tasks.front()();
-            // drop task
-            data->tasks.pop_front();
+            std::lock_guard<std::mutex> guard(data->mtx);
+            data->running.swap(data->tasks);
         }
-
+        // the tasks run without the lock, game thread keeps queuing meanwhile
+        for (auto& task : data->running)
+        {
+            task();
+        }
+        data->running.clear();
     }
     void init_libuv_async_handle(uv_loop_t* loop, uv_async_t* async)
     {
@@ -159,23 +162,6 @@ void DataFrame::append(unsigned char* p, int len)
     _underlyingData.insert(_underlyingData.end(), p, p + len);
 }
 
-int DataFrame::slice(unsigned char** p, int len) {
-    *p = getData() + _consumed;
-    if (_consumed + len > size()) {
-        return size() - _consumed;
-    }
-    return len;
-}
-
-int DataFrame::consume(int len) {
-    _consumed = len + _consumed > size() ? size() : len + _consumed;
-    return _consumed;
-}
-
-int DataFrame::remain() const {
-    return size() - _consumed;
-}
-
 
 std::string DataFrame::toString()
 {
@@ -317,6 +303,54 @@ std::vector<std::shared_ptr<WebSocketServerConnection>> WebSocketServer::getConn
     return ret;
 }
 
+void WebSocketServer::broadcastTextAsync(const std::string& text, std::function<void(const std::string&)> callback)
+{
+    std::shared_ptr<DataFrame> data = std::make_shared<DataFrame>(text);
+    RUN_IN_SERVERTHREAD(this->broadcast(data, callback));
+}
+
+void WebSocketServer::broadcastBinaryAsync(const void* in, size_t len, std::function<void(const std::string&)> callback)
+{
+    std::shared_ptr<DataFrame> data = std::make_shared<DataFrame>(in, len);
+    RUN_IN_SERVERTHREAD(this->broadcast(data, callback));
+}
+
+void WebSocketServer::broadcast(std::shared_ptr<DataFrame> data, std::function<void(const std::string&)> callback)
+{
+    {
+        std::lock_guard<std::mutex> guard(_connsMtx);
+        for (auto& itr : _conns) {
+            if (itr.second->getReadyState() == WebSocketServerConnection::OPEN) {
+                _broadcastTargets.emplace_back(itr.second);
+            }
+        }
+    }
+
+    if (callback) {
+        if (_broadcastTargets.empty()) {
+            RUN_IN_GAMETHREAD(callback(""));
+        } else {
+            // the frame finishes once per connection, all in server thread
+            auto remaining = std::make_shared<size_t>(_broadcastTargets.size());
+            auto error = std::make_shared<std::string>();
+            data->setCallback([callback, remaining, error](const std::string& msg) {
+                if (!msg.empty() && error->empty()) {
+                    *error = msg;
+                }
+                if (--(*remaining) == 0) {
+                    std::string err = *error;
+                    RUN_IN_GAMETHREAD(callback(err));
+                }
+            });
+        }
+    }
+
+    for (auto& conn : _broadcastTargets) {
+        conn->send(data);
+    }
+    _broadcastTargets.clear();
+}
+
 void WebSocketServer::onCreateClient(struct lws* wsi)
 {
     LOGE();
@@ -444,8 +478,10 @@ WebSocketServerConnection::~WebSocketServerConnection()
 
 bool WebSocketServerConnection::send(std::shared_ptr<DataFrame> data)
 {
-    _sendQueue.emplace_back(data);
-    onDrainData();
+    _sendQueue.push_back({data, 0});
+    if (_sendQueue.size() == 1) {
+        scheduleSend();
+    }
     return true;
 }
 
@@ -530,64 +566,60 @@ int WebSocketServerConnection::onDrainData()
         return -1;
     }
     if (_readyState != ReadyState::OPEN) return 0;
-    unsigned char* p = nullptr;
-    int send_len = 0;
-    int finish_len = 0;
-    int flags = 0;
-
-    std::vector<char> buff(SEND_BUFF + LWS_PRE);
 
     if (!_sendQueue.empty())
     {
-        std::shared_ptr<DataFrame> frag = _sendQueue.front();
+        PendingFrame& pending = _sendQueue.front();
+        std::shared_ptr<DataFrame> frag = pending.frame;
 
-        send_len = frag->slice(&p, SEND_BUFF);
+        unsigned char* p = frag->getData() + pending.sent;
+        int send_len = std::min(frag->size() - pending.sent, SEND_BUFF);
+        int flags = 0;
 
-        if(frag->isFront())
+        if (pending.sent == 0)
         {
-            if (frag->isBinary()) 
-            {
-                flags |= LWS_WRITE_BINARY;
-            }
-            if (frag->isString())  
-            {
-                flags |= LWS_WRITE_TEXT;
-            }
+            flags |= frag->isBinary() ? LWS_WRITE_BINARY : LWS_WRITE_TEXT;
+        }
+        else
+        {
+            flags |= LWS_WRITE_CONTINUATION;
         }
 
-        if (frag->remain() != send_len)
+        if (pending.sent + send_len != frag->size())
         {
             // remain bytes > 0
             // not FIN
             flags |= LWS_WRITE_NO_FIN;
         }
 
-        if (!frag->isFront()) {
-            flags |= LWS_WRITE_CONTINUATION;
-        }
-
-        finish_len = lws_write(_wsi, p, send_len, (lws_write_protocol)flags);
-
-        if (finish_len == 0)
+        // lws_write puts the header into the LWS_PRE bytes before p. Behind the first fragment they are payload
+        // the other connections the frame is broadcast to may not have sent yet, so they are restored.
+        unsigned char headroom[LWS_PRE];
+        if (pending.sent > 0)
         {
-            frag->onFinish("Connection Closed");
-            return -1;
+            memcpy(headroom, p - LWS_PRE, LWS_PRE);
         }
-        else if (finish_len < 0)
+        int finish_len = lws_write(_wsi, p, send_len, (lws_write_protocol)flags);
+        if (pending.sent > 0)
         {
-            frag->onFinish("Send Error!");
-            return -1; 
+            memcpy(p - LWS_PRE, headroom, LWS_PRE);
         }
-        else
+
+        if (finish_len <= 0)
         {
-            frag->consume(finish_len);
+            _sendQueue.pop_front();
+            frag->onFinish(finish_len == 0 ? "Connection Closed" : "Send Error!");
+            return -1;
         }
- 
-        if (frag->remain() == 0) {
-            frag->onFinish("");
+
+        pending.sent = std::min(pending.sent + finish_len, frag->size());
+        if (pending.sent == frag->size()) {
             _sendQueue.pop_front();
+            frag->onFinish("");
+        }
+        if (!_sendQueue.empty()) {
+            lws_callback_on_writable(_wsi);
         }
-        lws_callback_on_writable(_wsi);
     }
 
     return 0;
@@ -644,6 +676,13 @@ void WebSocketServerConnection::onClientCloseInit()
 void WebSocketServerConnection::onDestroyClient()
 {
     _readyState = ReadyState::CLOSED;
+    // the frames never sent still finish, a broadcast waits for every connection
+    while (!_sendQueue.empty())
+    {
+        std::shared_ptr<DataFrame> frag = _sendQueue.front().frame;
+        _sendQueue.pop_front();
+        frag->onFinish("Connection Closed");
+    }
     //on wsi destroied
     if (_wsi)
     {
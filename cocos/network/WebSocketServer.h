@@ -35,6 +35,7 @@
 #include <memory>
 #include <map>
 #include <list>
+#include <deque>
 #include <unordered_map>
 #include <thread>
 #include <mutex>
@@ -50,6 +51,7 @@ namespace cc {
 
         /**
         * receive/send data buffer with reserved bytes
+        * a frame being sent is shared by the connections it's broadcast to, each of them tracks its own progress
         */
         class DataFrame {
         public:
@@ -62,15 +64,8 @@ namespace cc {
 
             void append(unsigned char* p, int len);
 
-            int slice(unsigned char** p, int len);
-
-            int consume(int len);
-
-            int remain() const;
-
             inline bool isBinary() const { return _isBinary; }
             inline bool isString() const { return !_isBinary; }
-            inline bool isFront() const { return _consumed == 0; }
 
             void setCallback(std::function<void(const std::string&)> callback)
             {
@@ -92,7 +87,6 @@ namespace cc {
         private:
 
             std::vector<unsigned char> _underlyingData;
-            int _consumed = 0;
             bool _isBinary = false;
             std::function<void(const std::string&) > _callback;
 
@@ -195,9 +189,14 @@ namespace cc {
 
             void onDestroyClient();
 
+            struct PendingFrame {
+                std::shared_ptr<DataFrame> frame;
+                int sent;
+            };
+
             struct lws* _wsi = nullptr;
             std::map<std::string, std::string> _headers;
-            std::list<std::shared_ptr<DataFrame>> _sendQueue;
+            std::deque<PendingFrame> _sendQueue;
             std::shared_ptr<DataFrame> _prevPkg;
             bool _closed = false;
             std::string _closeReason = "close connection";
@@ -230,6 +229,13 @@ namespace cc {
 
             std::vector<std::shared_ptr<WebSocketServerConnection>> getConnections() const;
 
+            /**
+            * sends the message to all the open connections, it's copied once and shared by them
+            * callback is invoked in game thread after every connection sent it, with the first error if any
+            */
+            void broadcastTextAsync(const std::string& text, std::function<void(const std::string&)> callback = nullptr);
+            void broadcastBinaryAsync(const void* data, size_t len, std::function<void(const std::string&)> callback = nullptr);
+
             void setOnListening(std::function<void(const std::string&)> cb)
             {
                 _onlistening = cb;
@@ -278,6 +284,7 @@ namespace cc {
 
             std::shared_ptr<WebSocketServerConnection> findConnection(struct lws *wsi);
             void destroyContext();
+            void broadcast(std::shared_ptr<DataFrame> data, std::function<void(const std::string&)> callback);
 
             std::string _host;
             lws_context* _ctx = nullptr;
@@ -285,6 +292,8 @@ namespace cc {
 
             mutable std::mutex _connsMtx;
             std::unordered_map<struct lws*, std::shared_ptr<WebSocketServerConnection> > _conns;
+            // only used in server thread, reused by every broadcast
+            std::vector<std::shared_ptr<WebSocketServerConnection> > _broadcastTargets;
 
             // Attention: do not reference **this** in callbacks
             std::function<void(const std::string&)> _onlistening;
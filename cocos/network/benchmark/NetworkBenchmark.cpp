@@ -0,0 +1,493 @@
+// Throughput and soak harness of HttpClient, Downloader and WebSocket against a local server, built with USE_BENCHMARK
+// on Windows and macOS.
+//
+//   cocos2d-network-benchmark [--http url] [--download url] [--ws url] [--requests N] [--concurrency N] [--downloads N]
+//                             [--messages N] [--message-size N] [--warmup N] [--duration seconds] [--timeout seconds]
+//                             [--tick us] [--output file]
+//
+// --http gets the url --requests times, --concurrency of them in flight, and reports requests/s and the latency from
+// send to the response callback. --download downloads the url --downloads times, --concurrency files at once, and
+// reports MB/s and the process CPU time per MB. --ws sends binary messages of --message-size bytes to an echo server one
+// at a time and reports the round trip latency. Suites without their url are skipped. --duration turns the request and
+// message counts into a soak test of that many seconds each.
+//
+// The callbacks arrive on the cocos thread, which this process pumps every --tick microseconds, so the latencies hold
+// the dispatch delay a game sees at a much smaller frame time. Allocations are the calls of operator new of the whole
+// process, the live ones are counted after a suite released everything it created, a soak test leaking grows them.
+
+#include "cocos2d.h"
+#include "network/Downloader.h"
+#include "network/HttpClient.h"
+#include "platform/Application.h"
+#include "platform/FileUtils.h"
+#include "renderer/benchmark/BenchmarkHarness.h"
+#if USE_SOCKET
+    #include "network/WebSocket.h"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <thread>
+
+#if CC_PLATFORM == CC_PLATFORM_WINDOWS
+    #include <windows.h>
+#else
+    #include <sys/resource.h>
+#endif
+#if CC_PLATFORM == CC_PLATFORM_MAC_OSX
+    #include <CoreFoundation/CoreFoundation.h>
+#endif
+
+namespace {
+std::atomic<uint64_t> allocCount{0};
+std::atomic<uint64_t> freeCount{0};
+
+void *countedAlloc(size_t size) {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    return malloc(size ? size : 1);
+}
+
+void countedFree(void *ptr) {
+    if (!ptr) return;
+    freeCount.fetch_add(1, std::memory_order_relaxed);
+    free(ptr);
+}
+} // namespace
+
+void *operator new(size_t size) {
+    void *ptr = countedAlloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+void *operator new[](size_t size) {
+    void *ptr = countedAlloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+void *operator new(size_t size, const std::nothrow_t & /*tag*/) noexcept { return countedAlloc(size); }
+void *operator new[](size_t size, const std::nothrow_t & /*tag*/) noexcept { return countedAlloc(size); }
+void operator delete(void *ptr) noexcept { countedFree(ptr); }
+void operator delete[](void *ptr) noexcept { countedFree(ptr); }
+void operator delete(void *ptr, size_t /*size*/) noexcept { countedFree(ptr); }
+void operator delete[](void *ptr, size_t /*size*/) noexcept { countedFree(ptr); }
+void operator delete(void *ptr, const std::nothrow_t & /*tag*/) noexcept { countedFree(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t & /*tag*/) noexcept { countedFree(ptr); }
+
+using namespace cc;
+using namespace cc::network;
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string http;
+    std::string download;
+    std::string ws;
+    uint requests = 1000;
+    uint concurrency = 8;
+    uint downloads = 5;
+    uint messages = 1000;
+    uint messageSize = 64;
+    uint warmup = 10;
+    uint duration = 0; // seconds, 0 runs the counts
+    uint timeout = 60; // seconds of a suite beyond the duration
+    uint tick = 1000;  // microseconds
+    std::string output;
+};
+
+bool parseOptions(int argc, char **argv, Options &options) {
+    const bool isParsed = parseBenchmarkOptions(argc, argv, options.output, [&](const char *name, const char *value, uint number) {
+        if (!strcmp(name, "--http")) {
+            options.http = value;
+        } else if (!strcmp(name, "--download")) {
+            options.download = value;
+        } else if (!strcmp(name, "--ws")) {
+            options.ws = value;
+        } else if (!strcmp(name, "--requests")) {
+            options.requests = std::max(number, 1u);
+        } else if (!strcmp(name, "--concurrency")) {
+            options.concurrency = std::max(number, 1u);
+        } else if (!strcmp(name, "--downloads")) {
+            options.downloads = std::max(number, 1u);
+        } else if (!strcmp(name, "--messages")) {
+            options.messages = std::max(number, 1u);
+        } else if (!strcmp(name, "--message-size")) {
+            options.messageSize = std::max(number, 1u);
+        } else if (!strcmp(name, "--warmup")) {
+            options.warmup = number;
+        } else if (!strcmp(name, "--duration")) {
+            options.duration = number;
+        } else if (!strcmp(name, "--timeout")) {
+            options.timeout = std::max(number, 1u);
+        } else if (!strcmp(name, "--tick")) {
+            options.tick = std::max(number, 1u);
+        } else {
+            return false;
+        }
+        return true;
+    });
+    if (!isParsed) return false;
+    if (options.http.empty() && options.download.empty() && options.ws.empty()) {
+        fprintf(stderr, "Nothing to run, give --http, --download or --ws\n");
+        return false;
+    }
+    return true;
+}
+
+double getMicroseconds(Clock::time_point begin, Clock::time_point end) {
+    return std::chrono::duration<double, std::micro>(end - begin).count();
+}
+
+// user and kernel time of the process in microseconds
+double getProcessCPUTime() {
+#if CC_PLATFORM == CC_PLATFORM_WINDOWS
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime)) return 0.0;
+    const auto toMicroseconds = [](const FILETIME &time) {
+        return static_cast<double>((static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime) / 10.0;
+    };
+    return toMicroseconds(kernelTime) + toMicroseconds(userTime);
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage)) return 0.0;
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1e6 + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#endif
+}
+
+CC_INLINE int64_t getLiveAllocations() {
+    return static_cast<int64_t>(allocCount.load(std::memory_order_relaxed) - freeCount.load(std::memory_order_relaxed));
+}
+
+std::string latencyToJSON(vector<double> samples) {
+    if (samples.empty()) return "null";
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (const auto sample : samples) sum += sample;
+    const auto count = samples.size();
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "{\"meanUs\":%.3f,\"medianUs\":%.3f,\"minUs\":%.3f,\"p95Us\":%.3f,\"p99Us\":%.3f,\"maxUs\":%.3f}",
+             sum / count, samples[count / 2], samples.front(), samples[std::min(count - 1, count * 95 / 100)],
+             samples[std::min(count - 1, count * 99 / 100)], samples.back());
+    return buffer;
+}
+
+class NetworkBenchmark {
+public:
+    explicit NetworkBenchmark(const Options &options) : _options(options) {}
+
+    bool runHttp();
+    bool runDownload();
+    bool runWebSocket();
+
+    std::string toJSON() const;
+
+private:
+    // Runs what the network threads queued for the cocos thread until isDone or the deadline
+    bool pump(const std::function<bool()> &isDone, Clock::time_point deadline);
+    Clock::time_point getDeadline() const;
+    bool isRunning(Clock::time_point end, uint done, uint count) const;
+
+    void sendRequest();
+
+    const Options &_options;
+    std::string _http;
+    std::string _download;
+    std::string _ws;
+
+    // state of the running HTTP suite
+    bool _isRecording = false;
+    uint _inFlight = 0;
+    uint _sent = 0;
+    uint _errors = 0;
+    Clock::time_point _end;
+    vector<double> _latencies;
+};
+
+Clock::time_point NetworkBenchmark::getDeadline() const {
+    return Clock::now() + std::chrono::seconds(_options.duration + _options.timeout);
+}
+
+// a soak test runs until end, otherwise until done reaches count
+bool NetworkBenchmark::isRunning(Clock::time_point end, uint done, uint count) const {
+    return _options.duration ? Clock::now() < end : done < count;
+}
+
+bool NetworkBenchmark::pump(const std::function<bool()> &isDone, Clock::time_point deadline) {
+    auto scheduler = Application::getInstance()->getScheduler();
+    auto last = Clock::now();
+    while (!isDone()) {
+        if (Clock::now() > deadline) {
+            fprintf(stderr, "Timed out\n");
+            return false;
+        }
+#if CC_PLATFORM == CC_PLATFORM_MAC_OSX
+        // the Apple implementations call back on the main queue, the run loop serves it
+        CFRunLoopRunInMode(kCFRunLoopDefaultMode, _options.tick / 1e6, true);
+#else
+        std::this_thread::sleep_for(std::chrono::microseconds(_options.tick));
+#endif
+        const auto now = Clock::now();
+        scheduler->update(std::chrono::duration<float>(now - last).count());
+        last = now;
+    }
+    return true;
+}
+
+void NetworkBenchmark::sendRequest() {
+    auto *request = new HttpRequest();
+    request->setUrl(_options.http);
+    request->setRequestType(HttpRequest::Type::GET);
+    const auto begin = Clock::now();
+    request->setResponseCallback([this, begin](HttpClient * /*client*/, HttpResponse *response) {
+        --_inFlight;
+        if (!response->isSucceed()) {
+            ++_errors;
+        } else if (_isRecording) {
+            _latencies.push_back(getMicroseconds(begin, Clock::now()));
+        }
+        if (_isRecording ? isRunning(_end, _sent, _options.requests) : _sent < _options.warmup) sendRequest();
+    });
+    ++_inFlight;
+    ++_sent;
+    HttpClient::getInstance()->send(request);
+    request->release();
+}
+
+bool NetworkBenchmark::runHttp() {
+    auto *client = HttpClient::getInstance();
+    client->setMaxConcurrentRequests(static_cast<int>(_options.concurrency));
+
+    const auto deadline = getDeadline();
+    const auto isIdle = [this]() { return !_inFlight; };
+    _sent = _errors = 0;
+    _isRecording = false;
+    for (uint i = 0; i < std::min(_options.concurrency, _options.warmup); ++i) sendRequest();
+    if (!pump(isIdle, deadline)) return false;
+
+    const auto liveAllocations = getLiveAllocations();
+    const auto allocations = allocCount.load(std::memory_order_relaxed);
+    _sent = _errors = 0;
+    _isRecording = true;
+    _latencies.clear();
+    _latencies.reserve(_options.duration ? 65536 : _options.requests);
+    const auto begin = Clock::now();
+    _end = begin + std::chrono::seconds(_options.duration);
+    for (uint i = 0; i < (_options.duration ? _options.concurrency : std::min(_options.concurrency, _options.requests)); ++i) sendRequest();
+    if (!pump(isIdle, deadline)) return false;
+    const auto seconds = getMicroseconds(begin, Clock::now()) / 1e6;
+    const auto allocationsPerRequest = static_cast<double>(allocCount.load(std::memory_order_relaxed) - allocations) / _sent;
+
+    char buffer[512];
+    snprintf(buffer, sizeof(buffer),
+             "{\"url\":\"%s\",\"requests\":%u,\"concurrency\":%u,\"errors\":%u,\"seconds\":%.3f,\"requestsPerSecond\":%.1f,"
+             "\"allocationsPerRequest\":%.1f,\"liveAllocations\":%lld,\"latency\":",
+             _options.http.c_str(), _sent, _options.concurrency, _errors, seconds, _sent / seconds, allocationsPerRequest,
+             static_cast<long long>(getLiveAllocations() - liveAllocations));
+    _http = buffer + latencyToJSON(std::move(_latencies)) + "}";
+    _latencies = {};
+    fprintf(stderr, "HttpClient  %u requests, %.1f requests/s, %u errors\n", _sent, _sent / seconds, _errors);
+    return true;
+}
+
+bool NetworkBenchmark::runDownload() {
+    const auto directory = FileUtils::getInstance()->getWritablePath() + "network-benchmark/";
+    FileUtils::getInstance()->createDirectory(directory);
+
+    const auto liveAllocations = getLiveAllocations();
+    uint finished = 0;
+    uint errors = 0;
+    int64_t bytes = 0;
+    double cpuTime = 0.0;
+    double seconds = 0.0;
+    bool isSucceeded = false;
+    {
+        DownloaderHints hints{_options.concurrency, _options.duration + _options.timeout, ".tmp", 0, 0};
+        Downloader downloader(hints);
+        downloader.setOnFileTaskSuccess([&](const DownloadTask &task) {
+            ++finished;
+            bytes += FileUtils::getInstance()->getFileSize(task.storagePath);
+            FileUtils::getInstance()->removeFile(task.storagePath);
+        });
+        downloader.setOnTaskError([&](const DownloadTask & /*task*/, int errorCode, int errorCodeInternal, const std::string &errorStr) {
+            ++finished;
+            ++errors;
+            fprintf(stderr, "Download failed %d (%d): %s\n", errorCode, errorCodeInternal, errorStr.c_str());
+        });
+
+        const auto beginCPUTime = getProcessCPUTime();
+        const auto begin = Clock::now();
+        for (uint i = 0; i < _options.downloads; ++i) {
+            downloader.createDownloadFileTask(_options.download, directory + std::to_string(i));
+        }
+        isSucceeded = pump([&]() { return finished == _options.downloads; }, getDeadline());
+        seconds = getMicroseconds(begin, Clock::now()) / 1e6;
+        cpuTime = getProcessCPUTime() - beginCPUTime;
+    }
+    FileUtils::getInstance()->removeDirectory(directory);
+    if (!isSucceeded) return false;
+
+    const double megabytes = bytes / (1024.0 * 1024.0);
+    char buffer[512];
+    snprintf(buffer, sizeof(buffer),
+             "{\"url\":\"%s\",\"files\":%u,\"concurrency\":%u,\"errors\":%u,\"bytes\":%lld,\"seconds\":%.3f,\"megabytesPerSecond\":%.2f,"
+             "\"cpuMsPerMegabyte\":%.3f,\"liveAllocations\":%lld}",
+             _options.download.c_str(), _options.downloads, _options.concurrency, errors, static_cast<long long>(bytes), seconds,
+             megabytes / seconds, megabytes > 0.0 ? cpuTime / 1e3 / megabytes : 0.0,
+             static_cast<long long>(getLiveAllocations() - liveAllocations));
+    _download = buffer;
+    fprintf(stderr, "Downloader  %.1f MB, %.2f MB/s, %u errors\n", megabytes, megabytes / seconds, errors);
+    return true;
+}
+
+#if USE_SOCKET
+// Sends the next message when the echo of the last one arrives
+class EchoClient : public WebSocket::Delegate {
+public:
+    // a soak test runs until end, otherwise count messages are echoed
+    EchoClient(const Options &options, uint count, Clock::time_point end)
+    : _options(options), _count(count), _end(end), _message(options.messageSize, 0x5a) {}
+
+    void onOpen(WebSocket *ws) override {
+        _isOpen = true;
+        send(ws);
+    }
+
+    void onMessage(WebSocket *ws, const WebSocket::Data &data) override {
+        if (static_cast<uint>(data.len) != _options.messageSize) ++errors;
+        latencies.push_back(getMicroseconds(_sendTime, Clock::now()));
+        if (_end != Clock::time_point() ? Clock::now() < _end : latencies.size() < _count) {
+            send(ws);
+        } else {
+            isDone = true;
+        }
+    }
+
+    void onClose(WebSocket * /*ws*/) override {
+        isClosed = true;
+        isDone = true;
+    }
+
+    void onError(WebSocket * /*ws*/, const WebSocket::ErrorCode &error) override {
+        fprintf(stderr, "WebSocket error %d\n", static_cast<int>(error));
+        ++errors;
+        isDone = true;
+    }
+
+    CC_INLINE bool isOpen() const { return _isOpen; }
+
+    vector<double> latencies;
+    uint errors = 0;
+    bool isDone = false;
+    bool isClosed = false;
+
+private:
+    void send(WebSocket *ws) {
+        _sendTime = Clock::now();
+        ws->send(_message.data(), static_cast<unsigned int>(_message.size()));
+    }
+
+    const Options &_options;
+    uint _count = 0;
+    Clock::time_point _end;
+    Clock::time_point _sendTime;
+    vector<unsigned char> _message;
+    bool _isOpen = false;
+};
+#endif
+
+bool NetworkBenchmark::runWebSocket() {
+#if USE_SOCKET
+    const auto liveAllocations = getLiveAllocations();
+    const auto deadline = getDeadline();
+    bool isSucceeded = false;
+    uint messages = 0;
+    double seconds = 0.0;
+    double allocationsPerMessage = 0.0;
+    std::string latency;
+    {
+        // the first connection warms up, the second is measured
+        EchoClient warmup(_options, _options.warmup, Clock::time_point());
+        EchoClient client(_options, _options.messages, _options.duration ? Clock::now() + std::chrono::seconds(_options.duration) : Clock::time_point());
+        isSucceeded = true;
+        for (auto *delegate : {&warmup, &client}) {
+            if (delegate == &warmup && !_options.warmup) continue;
+            auto *ws = new WebSocket();
+            const auto allocations = allocCount.load(std::memory_order_relaxed);
+            const auto begin = Clock::now();
+            if (ws->init(*delegate, _options.ws)) {
+                isSucceeded = pump([delegate]() { return delegate->isDone; }, deadline) && delegate->isOpen() && !delegate->errors;
+                seconds = getMicroseconds(begin, Clock::now()) / 1e6;
+                allocationsPerMessage = static_cast<double>(allocCount.load(std::memory_order_relaxed) - allocations) /
+                                        std::max(delegate->latencies.size(), static_cast<size_t>(1));
+                if (!delegate->isClosed) {
+                    ws->closeAsync();
+                    pump([delegate]() { return delegate->isClosed; }, deadline);
+                }
+            } else {
+                isSucceeded = false;
+            }
+            ws->release();
+            if (!isSucceeded) break;
+        }
+        messages = static_cast<uint>(client.latencies.size());
+        latency = latencyToJSON(std::move(client.latencies));
+    }
+    if (!isSucceeded) return false;
+
+    char buffer[512];
+    snprintf(buffer, sizeof(buffer),
+             "{\"url\":\"%s\",\"messages\":%u,\"messageSize\":%u,\"seconds\":%.3f,\"messagesPerSecond\":%.1f,\"allocationsPerMessage\":%.1f,"
+             "\"liveAllocations\":%lld,\"roundTrip\":",
+             _options.ws.c_str(), messages, _options.messageSize, seconds, messages / seconds, allocationsPerMessage,
+             static_cast<long long>(getLiveAllocations() - liveAllocations));
+    _ws = buffer + latency + "}";
+    fprintf(stderr, "WebSocket   %u messages, %.1f messages/s\n", messages, messages / seconds);
+    return true;
+#else
+    fprintf(stderr, "WebSocket needs USE_SOCKET\n");
+    return false;
+#endif
+}
+
+std::string NetworkBenchmark::toJSON() const {
+    std::string json = "{\"schema\":1,\"engine\":\"";
+    json += cocos2dVersion();
+    json += "\",\"tickUs\":" + std::to_string(_options.tick) + ",\"duration\":" + std::to_string(_options.duration);
+    json += ",\"http\":" + (_http.empty() ? "null" : _http);
+    json += ",\"download\":" + (_download.empty() ? "null" : _download);
+    json += ",\"webSocket\":" + (_ws.empty() ? "null" : _ws);
+    json += "}\n";
+    return json;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 1;
+
+    // never initialized, it only provides the scheduler of the cocos thread
+    Application application(0, 0);
+
+    int exitCode = 0;
+    {
+        NetworkBenchmark benchmark(options);
+        if (!options.http.empty() && !benchmark.runHttp()) exitCode = 1;
+        if (!options.download.empty() && !benchmark.runDownload()) exitCode = 1;
+        if (!options.ws.empty() && !benchmark.runWebSocket()) exitCode = 1;
+
+        const auto result = benchmark.toJSON();
+        if (!writeBenchmarkResults(result, options.output)) exitCode = 1;
+    }
+#if USE_SOCKET
+    WebSocket::closeAllConnections();
+#endif
+    HttpClient::destroyInstance();
+    return exitCode;
+}
@@ -24,6 +24,7 @@ THE SOFTWARE.
 ****************************************************************************/
 #pragma once
 
+#include <algorithm>
 #include <string>
 #include <memory>
 #include <thread>    // // std::this_thread::sleep_for
@@ -32,8 +33,14 @@ THE SOFTWARE.
 #include "bindings/event/EventDispatcher.h"
 #include "base/Scheduler.h"
 #include "base/AutoreleasePool.h"
+#include "base/Profiler.h"
+#include "base/Startup.h"
 #include "base/TypeDef.h"
+#include "base/memory/MemTracker.h"
 #include "math/Vec2.h"
+#include "platform/FramePacer.h"
+#include "platform/PerformanceGovernor.h"
+#include "platform/SpikeDetector.h"
 
 #define NANOSECONDS_PER_SECOND 1000000000
 #define NANOSECONDS_60FPS 16666667L
@@ -96,32 +103,51 @@ public:
     
     void tick()
     {
+        CC_PROFILE_ZONE("Application::tick");
         static std::chrono::steady_clock::time_point prevTime;
         static std::chrono::steady_clock::time_point now;
         static float dt = 0.f;
         static long dtNS = NANOSECONDS_60FPS;
         
         ++_totalFrames;
+        if (_totalFrames == 1) {
+            // boot tasks nothing waited for are done before the first frame runs
+            Startup::waitAll();
+        }
 
         // iOS/macOS use its own fps limitation algorithm.
 #if (CC_PLATFORM == CC_PLATFORM_ANDROID || CC_PLATFORM == CC_PLATFORM_WINDOWS)
-        if (dtNS < _prefererredNanosecondsPerFrame) {
-            std::this_thread::sleep_for(
-                    std::chrono::nanoseconds(_prefererredNanosecondsPerFrame - dtNS));
-            dtNS = _prefererredNanosecondsPerFrame;
-        }
+        dt = _framePacer.waitForNextFrame();
 #endif
 
         prevTime = std::chrono::steady_clock::now();
 
         _scheduler->update(dt);
-        cc::EventDispatcher::dispatchTickEvent(dt);
+        {
+            CC_MEM_MODULE_SCOPE(SCRIPT);
+            cc::EventDispatcher::dispatchTickEvent(dt);
+        }
 
         PoolManager::getInstance()->getCurrentPool()->clear();
+        if (_totalFrames == 1) {
+            Startup::finish();
+        }
 
         now = std::chrono::steady_clock::now();
+        const long workNS = (long)std::chrono::duration_cast<std::chrono::nanoseconds>(now - prevTime).count();
+        _performanceGovernor.update(dt, workNS, _prefererredNanosecondsPerFrame);
+        _spikeDetector.update(workNS);
+
+        // the rest of the frame budget goes to garbage collection instead of a long pause in some later frame
+        const long idleNS = _prefererredNanosecondsPerFrame - workNS;
+        if (idleNS > 0) {
+            cc::EventDispatcher::dispatchIdleEvent((double)idleNS / NANOSECONDS_PER_SECOND);
+            now = std::chrono::steady_clock::now();
+        }
+#if (CC_PLATFORM != CC_PLATFORM_ANDROID && CC_PLATFORM != CC_PLATFORM_WINDOWS)
         dtNS = dtNS * 0.1 + 0.9 * std::chrono::duration_cast<std::chrono::nanoseconds>(now - prevTime).count();
         dt = (float)dtNS / NANOSECONDS_PER_SECOND;
+#endif
     }
 
     inline std::shared_ptr<Scheduler> getScheduler() const { return _scheduler; }
@@ -136,6 +162,23 @@ public:
      * @brief Get the preferred frame rate for main loop callback.
      */
     inline int getPreferredFramesPerSecond() const { return _fps; }
+
+    /**
+     * @brief Limits the frame rate below the preferred one without changing it, 0 removes the limit.
+     */
+    void setFramesPerSecondLimit(int limit)
+    {
+        _fpsLimit = limit;
+        setPreferredFramesPerSecond(_fps);
+    }
+
+    /**
+     * @brief Get the frame rate the main loop runs at, the preferred one within the limit.
+     */
+    inline int getFramesPerSecond() const { return _fpsLimit > 0 ? std::min(_fps, _fpsLimit) : _fps; }
+
+    inline PerformanceGovernor *getPerformanceGovernor() { return &_performanceGovernor; }
+    inline SpikeDetector *getSpikeDetector() { return &_spikeDetector; }
     
     CC_INLINE uint getTotalFrames() const { return _totalFrames; }
 
@@ -190,9 +233,13 @@ private:
     static Application* _instance;
     static std::shared_ptr<Scheduler> _scheduler;
     int _fps = 60;
+    int _fpsLimit = 0;
     long _prefererredNanosecondsPerFrame = NANOSECONDS_60FPS;
     uint _totalFrames = 0;
     cc::Vec2 _viewLogicalSize;
+    FramePacer _framePacer;
+    PerformanceGovernor _performanceGovernor;
+    SpikeDetector _spikeDetector;
 };
 
 // end of platform group
@@ -0,0 +1,134 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "platform/AssetPack.h"
+#include "base/Log.h"
+#include <cstring>
+#include "zlib.h"
+
+namespace cc {
+
+const uint32_t AssetPack::VERSION;
+
+std::shared_ptr<AssetPack> AssetPack::create(const std::string &path, MappedFile &&file) {
+    auto pack = std::make_shared<AssetPack>();
+    pack->_path = path;
+    pack->_file = std::move(file);
+    if (!pack->init()) {
+        CC_LOG_ERROR("AssetPack: %s is not a valid pack.", path.c_str());
+        return nullptr;
+    }
+    return pack;
+}
+
+uint64_t AssetPack::hash(const char *name, size_t length) {
+    uint64_t value = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < length; ++i) {
+        value ^= static_cast<unsigned char>(name[i]);
+        value *= 0x100000001b3ULL;
+    }
+    return value;
+}
+
+bool AssetPack::init() {
+    const unsigned char *bytes = _file.getBytes();
+    const uint64_t size = static_cast<uint64_t>(_file.getSize());
+    if (!bytes || size < sizeof(Header)) return false;
+
+    _header = reinterpret_cast<const Header *>(bytes);
+    const auto &header = *_header;
+    if (memcmp(header.magic, "CCPK", 4) != 0 || header.version != VERSION) return false;
+    if (!header.bucketCount || (header.bucketCount & (header.bucketCount - 1))) return false;
+    if (header.bucketsOffset + (header.bucketCount + 1ULL) * sizeof(uint32_t) > size) return false;
+    if (header.entriesOffset + static_cast<uint64_t>(header.entryCount) * sizeof(Entry) > size) return false;
+    if (header.namesOffset > size) return false;
+
+    _buckets = reinterpret_cast<const uint32_t *>(bytes + header.bucketsOffset);
+    _entries = reinterpret_cast<const Entry *>(bytes + header.entriesOffset);
+    _names = reinterpret_cast<const char *>(bytes + header.namesOffset);
+    if (_buckets[header.bucketCount] != header.entryCount) return false;
+
+    // checked once here so lookups and reads trust the index
+    for (uint32_t i = 0; i < header.entryCount; ++i) {
+        const auto &entry = _entries[i];
+        if (header.namesOffset + entry.nameOffset + entry.nameLength > size) return false;
+        if (entry.offset + entry.storedSize > size) return false;
+    }
+    return true;
+}
+
+const AssetPack::Entry *AssetPack::find(const std::string &name) const {
+    const uint64_t value = hash(name.data(), name.size());
+    const uint32_t bucket = static_cast<uint32_t>(value) & (_header->bucketCount - 1);
+    for (uint32_t i = _buckets[bucket]; i < _buckets[bucket + 1]; ++i) {
+        const auto &entry = _entries[i];
+        if (entry.hash == value && entry.nameLength == name.size() && !memcmp(_names + entry.nameOffset, name.data(), name.size())) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool AssetPack::inflate(const Entry *entry, unsigned char *dst) const {
+    switch (static_cast<Compression>(entry->compression)) {
+        case Compression::NONE:
+            memcpy(dst, _file.getBytes() + entry->offset, entry->size);
+            return true;
+        case Compression::ZLIB: {
+            uLongf size = entry->size;
+            return uncompress(dst, &size, _file.getBytes() + entry->offset, entry->storedSize) == Z_OK && size == entry->size;
+        }
+        default:
+            CC_LOG_ERROR("AssetPack: compression %u of %s is not supported.", entry->compression, _path.c_str());
+            return false;
+    }
+}
+
+FileUtils::Status AssetPack::read(const Entry *entry, ResizableBuffer *buffer) const {
+    buffer->resize(entry->size);
+    if (!entry->size) return FileUtils::Status::OK;
+    if (!inflate(entry, static_cast<unsigned char *>(buffer->buffer()))) {
+        buffer->resize(0);
+        return FileUtils::Status::ReadFailed;
+    }
+    return FileUtils::Status::OK;
+}
+
+MappedFile AssetPack::map(const Entry *entry) {
+    if (!entry->size) return MappedFile();
+
+    if (static_cast<Compression>(entry->compression) == Compression::NONE) {
+        auto pack = shared_from_this();
+        return MappedFile(_file.getBytes() + entry->offset, entry->size, [pack]() {});
+    }
+
+    auto *data = static_cast<unsigned char *>(malloc(entry->size));
+    if (!data) return MappedFile();
+    if (!inflate(entry, data)) {
+        free(data);
+        return MappedFile();
+    }
+    return MappedFile(data, entry->size, [data]() { free(data); });
+}
+
+} // namespace cc
@@ -0,0 +1,95 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#pragma once
+
+#include "platform/FileUtils.h"
+#include <memory>
+
+namespace cc {
+
+/**
+ * Read-only archive of many small files, mounted with FileUtils::mountPack and looked up before the search paths.
+ * The pack is mapped once, its index is a hash table so a lookup costs one hash and a few compares, and entries
+ * stored without compression are mapped straight out of the pack. Packs are written by tools/asset-pack.
+ *
+ * Layout, little endian: Header, uint32_t buckets[bucketCount + 1] with the first entry of every bucket,
+ * the entries sorted by bucket, their names, then their data.
+ */
+class CC_DLL AssetPack : public std::enable_shared_from_this<AssetPack> {
+public:
+    enum class Compression : uint16_t {
+        NONE = 0,
+        ZLIB = 1,
+        // reserved, no decoder is linked
+        LZ4 = 2,
+        ZSTD = 3,
+    };
+
+    struct Header {
+        char magic[4]; // CCPK
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t bucketCount; // power of two
+        uint64_t bucketsOffset;
+        uint64_t entriesOffset;
+        uint64_t namesOffset;
+    };
+
+    struct Entry {
+        uint64_t hash; // FNV-1a of the name
+        uint64_t offset;
+        uint32_t storedSize;
+        uint32_t size;
+        uint32_t nameOffset;
+        uint16_t nameLength;
+        uint16_t compression;
+    };
+
+    static const uint32_t VERSION = 1;
+
+    // validates the index, nullptr if the file is no pack of this version
+    static std::shared_ptr<AssetPack> create(const std::string &path, MappedFile &&file);
+    static uint64_t hash(const char *name, size_t length);
+
+    const Entry *find(const std::string &name) const;
+    FileUtils::Status read(const Entry *entry, ResizableBuffer *buffer) const;
+    // the view keeps the pack alive
+    MappedFile map(const Entry *entry);
+
+    inline const std::string &getPath() const { return _path; }
+    inline uint32_t getEntryCount() const { return _header->entryCount; }
+
+private:
+    bool init();
+    bool inflate(const Entry *entry, unsigned char *dst) const;
+
+    std::string _path;
+    MappedFile _file;
+    const Header *_header = nullptr;
+    const uint32_t *_buckets = nullptr;
+    const Entry *_entries = nullptr;
+    const char *_names = nullptr;
+};
+
+} // namespace cc
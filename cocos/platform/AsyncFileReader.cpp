@@ -0,0 +1,177 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "platform/AsyncFileReader.h"
+#include "platform/Application.h"
+#include <algorithm>
+
+namespace cc {
+
+AsyncFileReader::AsyncFileReader(FileUtils *fileUtils, uint32_t maxConcurrentReads)
+: _fileUtils(fileUtils),
+  _maxConcurrentReads(std::max(maxConcurrentReads, 1u)),
+  _isAlive(std::make_shared<std::atomic<bool>>(true)) {
+}
+
+AsyncFileReader::~AsyncFileReader() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isStopped = true;
+        *_isAlive = false;
+    }
+    _condition.notify_all();
+    for (auto &thread : _threads) thread.join();
+    _threads.clear();
+
+    // the running reads were deleted by their threads
+    for (auto &pair : _requests) delete pair.second;
+    _requests.clear();
+    _queue.clear();
+    _handles.clear();
+}
+
+FileUtils::ReadHandle AsyncFileReader::read(const std::string &fullPath, FileUtils::ReadPriority priority, const FileUtils::ReadCallback &callback) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_isStopped) return 0;
+
+    const FileUtils::ReadHandle handle = _nextHandle++;
+    if (!_nextHandle) _nextHandle = 1;
+
+    Request *request = nullptr;
+    auto iter = _requests.find(fullPath);
+    if (iter == _requests.end()) {
+        request = new Request();
+        request->fullPath = fullPath;
+        request->priority = priority;
+        request->sequence = _sequence++;
+        _requests.emplace(fullPath, request);
+        _queue.insert(request);
+    } else {
+        // coalesced, a pending read moves up to the highest priority asked for
+        request = iter->second;
+        if (!request->isRunning && priority > request->priority) {
+            _queue.erase(request);
+            request->priority = priority;
+            _queue.insert(request);
+        }
+    }
+    request->callbacks.emplace_back(handle, callback);
+    _handles.emplace(handle, request);
+
+    const bool needsThread = !request->isRunning && !_idleThreads && _threads.size() < _maxConcurrentReads;
+    if (needsThread) _threads.emplace_back(&AsyncFileReader::run, this);
+    lock.unlock();
+    _condition.notify_one();
+    return handle;
+}
+
+void AsyncFileReader::cancel(FileUtils::ReadHandle handle) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto iter = _handles.find(handle);
+    if (iter == _handles.end()) return;
+
+    Request *request = iter->second;
+    _handles.erase(iter);
+    if (!request) return; // delivered soon, the missing handle drops the callback
+
+    auto &callbacks = request->callbacks;
+    callbacks.erase(std::remove_if(callbacks.begin(), callbacks.end(), [handle](const std::pair<FileUtils::ReadHandle, FileUtils::ReadCallback> &callback) {
+                        return callback.first == handle;
+                    }),
+                    callbacks.end());
+    if (callbacks.empty() && !request->isRunning) {
+        _queue.erase(request);
+        _requests.erase(request->fullPath);
+        delete request;
+    }
+}
+
+void AsyncFileReader::setMaxConcurrentReads(uint32_t count) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _maxConcurrentReads = std::max(count, 1u);
+        while (_threads.size() < _maxConcurrentReads && _queue.size() > _idleThreads + _runningReads) {
+            _threads.emplace_back(&AsyncFileReader::run, this);
+        }
+    }
+    _condition.notify_all();
+}
+
+void AsyncFileReader::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        ++_idleThreads;
+        _condition.wait(lock, [this]() { return _isStopped || (!_queue.empty() && _runningReads < _maxConcurrentReads); });
+        --_idleThreads;
+        if (_isStopped) break;
+
+        Request *request = *_queue.begin();
+        _queue.erase(_queue.begin());
+        request->isRunning = true;
+        ++_runningReads;
+        lock.unlock();
+
+        auto file = std::make_shared<MappedFile>(_fileUtils->mapFile(request->fullPath));
+        if (file->isNull()) file = nullptr;
+
+        lock.lock();
+        --_runningReads;
+        _requests.erase(request->fullPath);
+        for (const auto &callback : request->callbacks) _handles[callback.first] = nullptr;
+        auto callbacks = std::move(request->callbacks);
+        delete request;
+
+        if (!callbacks.empty() && !_isStopped) {
+            lock.unlock();
+            deliver(std::move(callbacks), file);
+            lock.lock();
+        }
+        // the slot is free for another thread when the limit was lowered
+        _condition.notify_one();
+    }
+}
+
+void AsyncFileReader::deliver(std::vector<std::pair<FileUtils::ReadHandle, FileUtils::ReadCallback>> &&callbacks, const std::shared_ptr<MappedFile> &file) {
+    auto isAlive = _isAlive;
+    auto deliverCallbacks = [this, isAlive, callbacks, file]() {
+        for (const auto &callback : callbacks) {
+            // the reader and cancelRead() only go away on the cocos thread, which runs this
+            if (!*isAlive) return;
+            bool isCancelled = false;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                isCancelled = !_handles.erase(callback.first);
+            }
+            if (!isCancelled && callback.second) callback.second(file);
+        }
+    };
+
+    auto *application = Application::getInstance();
+    if (application && application->getScheduler()) {
+        application->getScheduler()->performFunctionInCocosThread(deliverCallbacks);
+    } else {
+        deliverCallbacks();
+    }
+}
+
+} // namespace cc
@@ -0,0 +1,88 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#pragma once
+
+#include "platform/FileUtils.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace cc {
+
+/**
+ * The I/O threads behind FileUtils::readAsync. Pending reads are kept per full path so requests for the same
+ * file share one read, and are picked by priority, then in the order they were first requested.
+ */
+class AsyncFileReader {
+public:
+    AsyncFileReader(FileUtils *fileUtils, uint32_t maxConcurrentReads);
+    // joins the I/O threads, the running reads finish without delivering
+    ~AsyncFileReader();
+
+    FileUtils::ReadHandle read(const std::string &fullPath, FileUtils::ReadPriority priority, const FileUtils::ReadCallback &callback);
+    void cancel(FileUtils::ReadHandle handle);
+    // fewer threads read at once from their next read on, more are started when needed
+    void setMaxConcurrentReads(uint32_t count);
+
+private:
+    struct Request {
+        std::string fullPath;
+        FileUtils::ReadPriority priority = FileUtils::ReadPriority::Normal;
+        uint64_t sequence = 0;
+        bool isRunning = false;
+        std::vector<std::pair<FileUtils::ReadHandle, FileUtils::ReadCallback>> callbacks;
+    };
+
+    struct RequestOrder {
+        bool operator()(const Request *a, const Request *b) const {
+            if (a->priority != b->priority) return a->priority > b->priority;
+            return a->sequence < b->sequence;
+        }
+    };
+
+    void run();
+    void deliver(std::vector<std::pair<FileUtils::ReadHandle, FileUtils::ReadCallback>> &&callbacks, const std::shared_ptr<MappedFile> &file);
+
+    FileUtils *_fileUtils = nullptr;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::unordered_map<std::string, Request *> _requests; // pending and running ones by full path
+    std::set<Request *, RequestOrder> _queue;              // pending ones
+    std::unordered_map<FileUtils::ReadHandle, Request *> _handles; // nullptr once the read finished
+    std::vector<std::thread> _threads;
+    uint32_t _maxConcurrentReads = 0;
+    uint32_t _runningReads = 0;
+    uint32_t _idleThreads = 0;
+    uint64_t _sequence = 0;
+    FileUtils::ReadHandle _nextHandle = 1;
+    bool _isStopped = false;
+    // tells deliveries scheduled on the cocos thread that the reader is gone
+    std::shared_ptr<std::atomic<bool>> _isAlive;
+};
+
+} // namespace cc
@@ -0,0 +1,139 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/AsyncFileWriter.h"
+#include "platform/Application.h"
+#include <unordered_set>
+
+namespace cc {
+
+AsyncFileWriter::AsyncFileWriter(FileUtils *fileUtils)
+: _fileUtils(fileUtils),
+  _isAlive(std::make_shared<std::atomic<bool>>(true)) {
+    _thread = std::thread(&AsyncFileWriter::run, this);
+}
+
+AsyncFileWriter::~AsyncFileWriter() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isStopped = true;
+        *_isAlive = false;
+    }
+    _condition.notify_all();
+    _thread.join();
+}
+
+void AsyncFileWriter::write(Data &&data, const std::string &fullPath, FileUtils::FsyncPolicy policy, const FileUtils::WriteCallback &callback) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_isStopped) return;
+
+    Request *request = nullptr;
+    auto iter = _requests.find(fullPath);
+    if (iter == _requests.end()) {
+        request = new Request();
+        request->fullPath = fullPath;
+        _requests.emplace(fullPath, request);
+        _queue.push_back(request);
+    } else {
+        // coalesced, only the newest contents reach the disk
+        request = iter->second;
+    }
+    request->data = std::move(data);
+    request->policy = policy;
+    if (callback) request->callbacks.push_back(callback);
+    ++_requestedWrites;
+    lock.unlock();
+    _condition.notify_one();
+}
+
+void AsyncFileWriter::flush() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    const uint64_t target = _requestedWrites;
+    _flushCondition.wait(lock, [this, target]() { return _finishedWrites >= target; });
+}
+
+void AsyncFileWriter::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _condition.wait(lock, [this]() { return _isStopped || !_queue.empty(); });
+        if (_queue.empty()) break; // stopped with nothing left to write
+
+        std::vector<Request *> batch;
+        batch.swap(_queue);
+        _requests.clear();
+        const uint64_t batchEnd = _requestedWrites;
+        lock.unlock();
+
+        writeBatch(batch);
+
+        lock.lock();
+        _finishedWrites = batchEnd;
+        _flushCondition.notify_all();
+    }
+}
+
+void AsyncFileWriter::writeBatch(std::vector<Request *> &batch) {
+    // a directory is synced once, after the last of its files in the batch was renamed into it
+    std::unordered_set<std::string> syncedDirectories;
+    std::vector<bool> syncsDirectory(batch.size(), false);
+    for (size_t i = batch.size(); i-- > 0;) {
+        if (batch[i]->policy != FileUtils::FsyncPolicy::FileAndDirectory) continue;
+        const std::string &fullPath = batch[i]->fullPath;
+        if (syncedDirectories.insert(fullPath.substr(0, fullPath.find_last_of('/') + 1)).second) syncsDirectory[i] = true;
+    }
+
+    std::vector<std::pair<FileUtils::WriteCallback, bool>> results;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        Request *request = batch[i];
+        FileUtils::FsyncPolicy policy = request->policy;
+        if (policy == FileUtils::FsyncPolicy::FileAndDirectory && !syncsDirectory[i]) policy = FileUtils::FsyncPolicy::File;
+
+        const bool succeeded = _fileUtils->writeFileAtomically(request->data.getBytes(), request->data.getSize(), request->fullPath, policy);
+        for (const auto &callback : request->callbacks) results.emplace_back(callback, succeeded);
+        delete request;
+    }
+    batch.clear();
+
+    if (!results.empty()) deliver(std::move(results));
+}
+
+void AsyncFileWriter::deliver(std::vector<std::pair<FileUtils::WriteCallback, bool>> &&results) {
+    auto isAlive = _isAlive;
+    auto deliverResults = [isAlive, results]() {
+        for (const auto &result : results) {
+            // the writer only goes away on the cocos thread, which runs this
+            if (!*isAlive) return;
+            result.first(result.second);
+        }
+    };
+
+    auto *application = Application::getInstance();
+    if (application && application->getScheduler()) {
+        application->getScheduler()->performFunctionInCocosThread(deliverResults);
+    } else {
+        deliverResults();
+    }
+}
+
+} // namespace cc
@@ -0,0 +1,78 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "platform/FileUtils.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace cc {
+
+/**
+ * The I/O thread behind FileUtils::writeDataToFileAsync. Pending writes are kept per full path, a newer write of
+ * the same file replaces the older one's data and both callbacks get its result. Everything pending is taken and
+ * written as one batch, so many small files wake the thread and the cocos thread once.
+ */
+class AsyncFileWriter {
+public:
+    explicit AsyncFileWriter(FileUtils *fileUtils);
+    // writes what is pending before joining the I/O thread, without delivering
+    ~AsyncFileWriter();
+
+    void write(Data &&data, const std::string &fullPath, FileUtils::FsyncPolicy policy, const FileUtils::WriteCallback &callback);
+    // blocks until the writes requested so far are renamed into place
+    void flush();
+
+private:
+    struct Request {
+        std::string fullPath;
+        Data data;
+        FileUtils::FsyncPolicy policy = FileUtils::FsyncPolicy::None;
+        std::vector<FileUtils::WriteCallback> callbacks;
+    };
+
+    void run();
+    void writeBatch(std::vector<Request *> &batch);
+    void deliver(std::vector<std::pair<FileUtils::WriteCallback, bool>> &&results);
+
+    FileUtils *_fileUtils = nullptr;
+    std::mutex _mutex;
+    std::condition_variable _condition;      // wakes the I/O thread
+    std::condition_variable _flushCondition; // wakes flush()
+    std::unordered_map<std::string, Request *> _requests; // pending ones by full path
+    std::vector<Request *> _queue;                         // pending ones in the order first requested
+    std::thread _thread;
+    uint64_t _requestedWrites = 0;
+    uint64_t _finishedWrites = 0;
+    bool _isStopped = false;
+    // tells deliveries scheduled on the cocos thread that the writer is gone
+    std::shared_ptr<std::atomic<bool>> _isAlive;
+};
+
+} // namespace cc
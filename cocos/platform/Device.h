@@ -136,6 +136,26 @@ public:
 
     static NetworkType getNetworkType();
 
+    // After the thermalState of iOS, the thermal statuses of Android from LIGHT up map to FAIR, SERIOUS and CRITICAL.
+    enum class ThermalState
+    {
+        NOMINAL,
+        FAIR,
+        SERIOUS,
+        CRITICAL
+    };
+
+    /**
+     * Gets how hot the device runs, available on iOS, macOS and Android 10 and later, NOMINAL elsewhere.
+     */
+    static ThermalState getThermalState();
+
+    /**
+     * Gets the forecast of the thermal headroom in the given seconds, 1.0 is where the device throttles heavily.
+     * Only available on Android 11 and later, a negative value elsewhere.
+     */
+    static float getThermalHeadroom(int forecastSeconds);
+
     /*
      * Gets the SafeArea edge.
      * Vec4(x, y, z, w) means Edge(top, left, bottom, right)
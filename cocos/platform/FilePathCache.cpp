@@ -0,0 +1,234 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "platform/FilePathCache.h"
+#include <algorithm>
+#include <cctype>
+
+namespace cc {
+
+const size_t FilePathCache::MAX_INDEXED_FILES;
+const size_t FilePathCache::INITIAL_CAPACITY;
+
+namespace {
+
+// names with '.' or '..' components, hidden files or backslashes are probed, the index only knows plain names
+bool isIndexableName(const std::string &filename) {
+    return !filename.empty() && filename[0] != '.' && filename[0] != '/' &&
+           filename.find("/.") == std::string::npos && filename.find("//") == std::string::npos && filename.find('\\') == std::string::npos;
+}
+
+std::string getIndexKey(const std::string &filename) {
+#if (CC_PLATFORM == CC_PLATFORM_WINDOWS || CC_PLATFORM == CC_PLATFORM_MAC_OSX)
+    // the file systems are case insensitive
+    std::string key = filename;
+    std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return key;
+#else
+    return filename;
+#endif
+}
+
+} // namespace
+
+FilePathCache::Table::Table(const std::shared_ptr<SearchPaths> &searchPaths, size_t capacity)
+: searchPaths(searchPaths),
+  slots(new std::atomic<Entry *>[capacity]),
+  mask(capacity - 1) {
+    for (size_t i = 0; i < capacity; ++i) slots[i].store(nullptr, std::memory_order_relaxed);
+}
+
+FilePathCache::Table::~Table() {
+    for (size_t i = 0; i <= mask; ++i) delete slots[i].load(std::memory_order_relaxed);
+}
+
+FilePathCache::FilePathCache(const Probe &probe, const Lister &lister)
+: _probe(probe),
+  _lister(lister) {
+    _table.store(new Table(std::make_shared<SearchPaths>(), INITIAL_CAPACITY));
+}
+
+FilePathCache::~FilePathCache() {
+    delete _table.load();
+    for (auto *table : _retiredTables) delete table;
+}
+
+void FilePathCache::reset(const std::vector<std::string> &searchPaths, const std::vector<bool> &isIndexable) {
+    auto paths = std::make_shared<SearchPaths>();
+    for (size_t i = 0; i < searchPaths.size(); ++i) {
+        std::unique_ptr<SearchPath> searchPath(new SearchPath());
+        searchPath->path = searchPaths[i];
+        searchPath->isIndexable = i < isIndexable.size() && isIndexable[i];
+        paths->push_back(std::move(searchPath));
+    }
+
+    std::lock_guard<std::mutex> lock(_writeMutex);
+    replace(new Table(paths, INITIAL_CAPACITY));
+}
+
+void FilePathCache::clear() {
+    std::lock_guard<std::mutex> lock(_writeMutex);
+    replace(new Table(_table.load()->searchPaths, INITIAL_CAPACITY));
+}
+
+void FilePathCache::replace(Table *table) {
+    _retiredTables.push_back(_table.exchange(table));
+    _hasRetiredTables.store(true);
+    freeRetiredTables();
+}
+
+void FilePathCache::freeRetiredTables() {
+    // readers count themselves before they load the table, none of them can reach a retired one any more
+    if (_readers.load() != 0) return;
+    for (auto *table : _retiredTables) delete table;
+    _retiredTables.clear();
+    _hasRetiredTables.store(false);
+}
+
+const FilePathCache::Entry *FilePathCache::lookup(const Table *table, size_t hash, const std::string &filename) const {
+    for (size_t i = hash & table->mask, probes = 0; probes <= table->mask; i = (i + 1) & table->mask, ++probes) {
+        const Entry *entry = table->slots[i].load(std::memory_order_acquire);
+        if (!entry) return nullptr;
+        if (entry->hash == hash && entry->filename == filename) return entry;
+    }
+    return nullptr;
+}
+
+bool FilePathCache::add(Table *table, Entry *entry) {
+    // at most half full, so probe sequences stay short
+    if (table->count.load(std::memory_order_relaxed) * 2 > table->mask) return false;
+
+    for (size_t i = entry->hash & table->mask, probes = 0; probes <= table->mask; i = (i + 1) & table->mask, ++probes) {
+        Entry *current = table->slots[i].load(std::memory_order_acquire);
+        if (!current && table->slots[i].compare_exchange_strong(current, entry, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            table->count.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        // another thread cached the name first
+        if (current->hash == entry->hash && current->filename == entry->filename) {
+            delete entry;
+            return true;
+        }
+    }
+    return false;
+}
+
+void FilePathCache::grow(Table *table) {
+    std::lock_guard<std::mutex> lock(_writeMutex);
+    if (_table.load() != table) return;
+
+    // names cached into the old table while it is copied are resolved again later
+    auto *grown = new Table(table->searchPaths, (table->mask + 1) * 2);
+    for (size_t i = 0; i <= table->mask; ++i) {
+        const Entry *entry = table->slots[i].load(std::memory_order_acquire);
+        if (!entry) continue;
+        auto *copy = new Entry(*entry);
+        if (!add(grown, copy)) delete copy;
+    }
+    replace(grown);
+}
+
+void FilePathCache::insert(Table *table, size_t hash, const std::string &filename, const std::string &fullPath) {
+    auto *entry = new Entry();
+    entry->hash = hash;
+    entry->filename = filename;
+    entry->fullPath = fullPath;
+    if (add(table, entry)) return;
+
+    grow(table);
+    // a reset may have replaced the search paths the name was resolved in
+    auto *current = _table.load();
+    if (current->searchPaths != table->searchPaths || !add(current, entry)) delete entry;
+}
+
+bool FilePathCache::mayContain(SearchPath &searchPath, const std::string &filename) {
+    if (!searchPath.isIndexable || !isIndexableName(filename)) return true;
+
+    buildIndex(searchPath);
+    return !searchPath.index || searchPath.index->count(getIndexKey(filename));
+}
+
+void FilePathCache::buildIndex(SearchPath &searchPath) {
+    std::call_once(searchPath.indexFlag, [&]() {
+        std::vector<std::string> files;
+        if (!_lister(searchPath.path, &files) || files.empty() || files.size() > MAX_INDEXED_FILES) return;
+        searchPath.index.reset(new std::unordered_set<std::string>(files.size()));
+        for (const auto &file : files) searchPath.index->insert(getIndexKey(file));
+    });
+}
+
+std::string FilePathCache::resolve(const std::string &filename) {
+    std::string fullPath;
+    {
+        ReadGuard guard(_readers);
+        auto *table = _table.load();
+        const size_t hash = std::hash<std::string>()(filename);
+        if (const auto *entry = lookup(table, hash, filename)) return entry->fullPath;
+
+        for (const auto &searchPath : *table->searchPaths) {
+            if (!mayContain(*searchPath, filename)) continue;
+            fullPath = _probe(filename, searchPath->path);
+            if (!fullPath.empty()) break;
+        }
+        insert(table, hash, filename, fullPath);
+    }
+
+    if (_hasRetiredTables.load(std::memory_order_relaxed) && _writeMutex.try_lock()) {
+        freeRetiredTables();
+        _writeMutex.unlock();
+    }
+    return fullPath;
+}
+
+bool FilePathCache::find(const std::string &filename, std::string *fullPath) {
+    ReadGuard guard(_readers);
+    const auto *entry = lookup(_table.load(), std::hash<std::string>()(filename), filename);
+    if (!entry || entry->fullPath.empty()) return false;
+    *fullPath = entry->fullPath;
+    return true;
+}
+
+void FilePathCache::insert(const std::string &filename, const std::string &fullPath) {
+    ReadGuard guard(_readers);
+    insert(_table.load(), std::hash<std::string>()(filename), filename, fullPath);
+}
+
+void FilePathCache::buildIndexes() {
+    ReadGuard guard(_readers);
+    for (const auto &searchPath : *_table.load()->searchPaths) {
+        if (searchPath->isIndexable) buildIndex(*searchPath);
+    }
+}
+
+std::unordered_map<std::string, std::string> FilePathCache::getEntries() {
+    std::unordered_map<std::string, std::string> entries;
+    ReadGuard guard(_readers);
+    const auto *table = _table.load();
+    for (size_t i = 0; i <= table->mask; ++i) {
+        const Entry *entry = table->slots[i].load(std::memory_order_acquire);
+        if (entry && !entry->fullPath.empty()) entries.emplace(entry->filename, entry->fullPath);
+    }
+    return entries;
+}
+
+} // namespace cc
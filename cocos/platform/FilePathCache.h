@@ -0,0 +1,131 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace cc {
+
+/**
+ * The cache behind FileUtils::fullPathForFilename. Hits and misses are both cached in an open addressing table
+ * whose slots are only ever filled, so cached names are resolved with a few atomic loads and no lock. Search paths
+ * which may be listed are indexed the first time they are searched, names missing from the index are ruled out
+ * without touching the filesystem.
+ *
+ * Tables replaced by a reset or a growth are freed once no thread is reading any table.
+ */
+class FilePathCache {
+public:
+    // Resolves a name in one search path, empty if the file isn't there.
+    using Probe = std::function<std::string(const std::string &filename, const std::string &searchPath)>;
+    // Lists the files beneath a search path relative to it, false if they can't be listed completely.
+    using Lister = std::function<bool(const std::string &searchPath, std::vector<std::string> *files)>;
+
+    // search paths with more files are probed instead
+    static const size_t MAX_INDEXED_FILES = 65536;
+
+    FilePathCache(const Probe &probe, const Lister &lister);
+    ~FilePathCache();
+
+    // Drops the entries and indexes, isIndexable tells which of the search paths may be listed.
+    void reset(const std::vector<std::string> &searchPaths, const std::vector<bool> &isIndexable);
+    // Drops the entries, the indexes are kept.
+    void clear();
+
+    // Thread safe, empty if the file is in none of the search paths.
+    std::string resolve(const std::string &filename);
+    // Entries added directly, no misses are reported.
+    bool find(const std::string &filename, std::string *fullPath);
+    void insert(const std::string &filename, const std::string &fullPath);
+    // Thread safe, lists the indexable search paths now instead of on their first lookup.
+    void buildIndexes();
+
+    // the hits cached so far
+    std::unordered_map<std::string, std::string> getEntries();
+
+private:
+    struct Entry {
+        size_t hash = 0;
+        std::string filename;
+        std::string fullPath; // empty for a miss
+    };
+
+    struct SearchPath {
+        std::string path;
+        bool isIndexable = false;
+        std::once_flag indexFlag;
+        std::unique_ptr<std::unordered_set<std::string>> index; // nullptr if the path is not indexed
+    };
+
+    using SearchPaths = std::vector<std::unique_ptr<SearchPath>>;
+
+    struct Table {
+        Table(const std::shared_ptr<SearchPaths> &searchPaths, size_t capacity);
+        ~Table();
+
+        std::shared_ptr<SearchPaths> searchPaths;
+        std::unique_ptr<std::atomic<Entry *>[]> slots;
+        size_t mask = 0;
+        std::atomic<size_t> count{0};
+    };
+
+    // counts the threads reading a table
+    class ReadGuard {
+    public:
+        explicit ReadGuard(std::atomic<uint32_t> &readers) : _readers(readers) { _readers.fetch_add(1); }
+        ~ReadGuard() { _readers.fetch_sub(1); }
+
+    private:
+        std::atomic<uint32_t> &_readers;
+    };
+
+    static const size_t INITIAL_CAPACITY = 1024;
+
+    const Entry *lookup(const Table *table, size_t hash, const std::string &filename) const;
+    void insert(Table *table, size_t hash, const std::string &filename, const std::string &fullPath);
+    bool add(Table *table, Entry *entry);
+    void grow(Table *table);
+    bool mayContain(SearchPath &searchPath, const std::string &filename);
+    void buildIndex(SearchPath &searchPath);
+    // callers hold _writeMutex
+    void replace(Table *table);
+    void freeRetiredTables();
+
+    Probe _probe;
+    Lister _lister;
+    std::atomic<Table *> _table{nullptr};
+    std::atomic<uint32_t> _readers{0};
+    std::atomic<bool> _hasRetiredTables{false};
+    std::mutex _writeMutex;
+    std::vector<Table *> _retiredTables;
+};
+
+} // namespace cc
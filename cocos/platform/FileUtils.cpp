@@ -25,11 +25,17 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "platform/FileUtils.h"
+#include "platform/AssetPack.h"
+#include "platform/AsyncFileReader.h"
+#include "platform/AsyncFileWriter.h"
+#include "platform/FilePathCache.h"
 
 #include <stack>
 
 #include "base/Data.h"
 #include "base/Log.h"
+#include "base/MemoryPressure.h"
+#include "base/Startup.h"
 #include "platform/SAXParser.h"
 
 #include "tinyxml2/tinyxml2.h"
@@ -41,7 +47,15 @@ THE SOFTWARE.
 #include "unzip/unzip.h"
 #endif
 #include <sys/stat.h>
+#include <algorithm>
 #include <regex>
+#if (CC_PLATFORM != CC_PLATFORM_WINDOWS)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
 
 namespace cc {
 
@@ -105,7 +119,7 @@ public:
         parser.setDelegator(this);
 
         parser.parse(fileName);
-        return _rootDict;
+        return std::move(_rootDict);
     }
 
     ValueMap dictionaryWithDataOfFile(const char* filedata, int filesize)
@@ -117,7 +131,7 @@ public:
         parser.setDelegator(this);
 
         parser.parse(filedata, filesize);
-        return _rootDict;
+        return std::move(_rootDict);
     }
 
     ValueVector arrayWithContentsOfFile(const std::string& fileName)
@@ -129,7 +143,7 @@ public:
         parser.setDelegator(this);
 
         parser.parse(fileName);
-        return _rootArray;
+        return std::move(_rootArray);
     }
 
     virtual void startElement(void *ctx, const char *name, const char **atts) override
@@ -155,16 +169,17 @@ public:
             if (SAX_ARRAY == preState)
             {
                 // add a new dictionary into the array
-                _curArray->push_back(Value(ValueMap()));
-                _curDict = &(_curArray->rbegin())->asValueMap();
+                _curArray->emplace_back(ValueMap());
+                _curDict = &_curArray->back().asValueMap();
             }
             else if (SAX_DICT == preState)
             {
                 // add a new dictionary into the pre dictionary
                 CCASSERT(! _dictStack.empty(), "The state is wrong!");
                 ValueMap* preDict = _dictStack.top();
-                (*preDict)[_curKey] = Value(ValueMap());
-                _curDict = &(*preDict)[_curKey].asValueMap();
+                Value& dict = (*preDict)[_curKey];
+                dict = ValueMap();
+                _curDict = &dict.asValueMap();
             }
 
             // record the dict state
@@ -203,14 +218,15 @@ public:
 
             if (preState == SAX_DICT)
             {
-                (*_curDict)[_curKey] = Value(ValueVector());
-                _curArray = &(*_curDict)[_curKey].asValueVector();
+                Value& array = (*_curDict)[_curKey];
+                array = ValueVector();
+                _curArray = &array.asValueVector();
             }
             else if (preState == SAX_ARRAY)
             {
                 CCASSERT(! _arrayStack.empty(), "The state is wrong!");
                 ValueVector* preArray = _arrayStack.top();
-                preArray->push_back(Value(ValueVector()));
+                preArray->emplace_back(ValueVector());
                 _curArray = &(_curArray->rbegin())->asValueVector();
             }
             // record the array state
@@ -273,16 +289,16 @@ public:
             if (SAX_ARRAY == curState)
             {
                 if (sName == "string")
-                    _curArray->push_back(Value(_curValue));
+                    _curArray->emplace_back(std::move(_curValue));
                 else if (sName == "integer")
-                    _curArray->push_back(Value(atoi(_curValue.c_str())));
+                    _curArray->emplace_back(atoi(_curValue.c_str()));
                 else
-                    _curArray->push_back(Value(std::atof(_curValue.c_str())));
+                    _curArray->emplace_back(std::atof(_curValue.c_str()));
             }
             else if (SAX_DICT == curState)
             {
                 if (sName == "string")
-                    (*_curDict)[_curKey] = Value(_curValue);
+                    (*_curDict)[_curKey] = std::move(_curValue);
                 else if (sName == "integer")
                     (*_curDict)[_curKey] = Value(atoi(_curValue.c_str()));
                 else
@@ -304,12 +320,10 @@ public:
         }
 
         SAXState curState = _stateStack.empty() ? SAX_DICT : _stateStack.top();
-        const std::string text = std::string((char*)ch,len);
-
         switch(_state)
         {
         case SAX_KEY:
-            _curKey = text;
+            _curKey.assign(ch, len);
             break;
         case SAX_INT:
         case SAX_REAL:
@@ -320,7 +334,7 @@ public:
                     CCASSERT(!_curKey.empty(), "key not found : <integer/real>");
                 }
 
-                _curValue.append(text);
+                _curValue.append(ch, len);
             }
             break;
         default:
@@ -551,13 +565,23 @@ FileUtils* FileUtils::s_sharedFileUtils = nullptr;
 
 void FileUtils::destroyInstance()
 {
+    // the I/O threads go through the derived instance, they stop before it is destroyed
+    if (s_sharedFileUtils)
+    {
+        CC_SAFE_DELETE(s_sharedFileUtils->_asyncFileReader);
+        CC_SAFE_DELETE(s_sharedFileUtils->_asyncFileWriter);
+    }
     CC_SAFE_DELETE(s_sharedFileUtils);
 }
 
 void FileUtils::setDelegate(FileUtils *delegate)
 {
     if (s_sharedFileUtils)
+    {
+        CC_SAFE_DELETE(s_sharedFileUtils->_asyncFileReader);
+        CC_SAFE_DELETE(s_sharedFileUtils->_asyncFileWriter);
         delete s_sharedFileUtils;
+    }
 
     s_sharedFileUtils = delegate;
 }
@@ -565,10 +589,22 @@ void FileUtils::setDelegate(FileUtils *delegate)
 FileUtils::FileUtils()
     : _writablePath("")
 {
+    _pathCache = new FilePathCache([this](const std::string& filename, const std::string& searchPath) {
+        return getPathForFilename(filename, searchPath);
+    }, [this](const std::string& searchPath, std::vector<std::string>* files) {
+        return listSearchPathFiles(searchPath, files);
+    });
+    _memoryPressureHandlerID = MemoryPressure::addHandler("FileUtils", MemoryPressureLevel::LOW, [this](MemoryPressureLevel) {
+        purgeCachedEntries();
+    });
 }
 
 FileUtils::~FileUtils()
 {
+    MemoryPressure::removeHandler(_memoryPressureHandlerID);
+    CC_SAFE_DELETE(_asyncFileReader);
+    CC_SAFE_DELETE(_asyncFileWriter);
+    CC_SAFE_DELETE(_pathCache);
 }
 
 bool FileUtils::writeStringToFile(const std::string& dataStr, const std::string& fullPath)
@@ -585,38 +621,180 @@ bool FileUtils::writeStringToFile(const std::string& dataStr, const std::string&
 
 bool FileUtils::writeDataToFile(const Data& data, const std::string& fullPath)
 {
-    size_t size = 0;
-    const char* mode = "wb";
-
     CCASSERT(!fullPath.empty() && data.getSize() != 0, "Invalid parameters.");
 
-    auto fileutils = FileUtils::getInstance();
-    do
+    if (!writeFileAtomically(data.getBytes(), data.getSize(), fullPath, _fsyncPolicy))
+        return false;
+
+    // the file may have been cached as missing
+    _pathCache->clear();
+    return true;
+}
+
+static bool syncFile(FILE* fp)
+{
+#if (CC_PLATFORM == CC_PLATFORM_WINDOWS)
+    return _commit(_fileno(fp)) == 0;
+#else
+    return fsync(fileno(fp)) == 0;
+#endif
+}
+
+static bool syncDirectory(const std::string& fullPath)
+{
+#if (CC_PLATFORM == CC_PLATFORM_WINDOWS)
+    // directories can't be opened for syncing, the rename is journaled by NTFS
+    return true;
+#else
+    std::string directory = fullPath.substr(0, fullPath.find_last_of('/') + 1);
+    int fd = open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    bool succeeded = fsync(fd) == 0;
+    close(fd);
+    return succeeded;
+#endif
+}
+
+bool FileUtils::writeFileAtomically(const unsigned char* bytes, size_t size, const std::string& fullPath, FsyncPolicy policy)
+{
+    std::string tempPath = fullPath + ".tmp";
+    std::string suitableTempPath = getSuitableFOpen(tempPath);
+
+    FILE *fp = fopen(suitableTempPath.c_str(), "wb");
+    if (!fp)
+        return false;
+
+    bool succeeded = size == 0 || fwrite(bytes, size, 1, fp) == 1;
+    succeeded = fflush(fp) == 0 && succeeded;
+    if (succeeded && policy != FsyncPolicy::None)
+        succeeded = syncFile(fp);
+    succeeded = fclose(fp) == 0 && succeeded;
+
+    // a short write never replaces the previous contents
+    if (!succeeded || !renameFile(tempPath, fullPath))
     {
-        // Read the file from hardware
-        FILE *fp = fopen(fileutils->getSuitableFOpen(fullPath).c_str(), mode);
-        CC_BREAK_IF(!fp);
-        size = data.getSize();
+        CC_LOG_ERROR("Fail to write file %s", fullPath.c_str());
+        remove(suitableTempPath.c_str());
+        return false;
+    }
 
-        fwrite(data.getBytes(), size, 1, fp);
+    if (policy == FsyncPolicy::FileAndDirectory && !syncDirectory(fullPath))
+        CC_LOG_WARNING("Fail to sync the directory of %s", fullPath.c_str());
+    return true;
+}
 
-        fclose(fp);
+void FileUtils::writeDataToFileAsync(Data&& data, const std::string& fullPath, const WriteCallback& callback)
+{
+    CCASSERT(!fullPath.empty(), "Invalid parameters.");
+
+    getAsyncFileWriter()->write(std::move(data), fullPath, _fsyncPolicy, [this, callback](bool succeeded) {
+        // the file may have been cached as missing
+        if (succeeded)
+            _pathCache->clear();
+        if (callback)
+            callback(succeeded);
+    });
+}
 
-        return true;
-    } while (0);
+void FileUtils::writeDataToFileAsync(const Data& data, const std::string& fullPath, const WriteCallback& callback)
+{
+    writeDataToFileAsync(Data(data), fullPath, callback);
+}
 
-    return false;
+void FileUtils::writeStringToFileAsync(const std::string& dataStr, const std::string& fullPath, const WriteCallback& callback)
+{
+    Data data;
+    data.copy((const unsigned char*)dataStr.c_str(), dataStr.size());
+    writeDataToFileAsync(std::move(data), fullPath, callback);
+}
+
+void FileUtils::flushWrites()
+{
+    if (_asyncFileWriter)
+        _asyncFileWriter->flush();
+}
+
+AsyncFileWriter* FileUtils::getAsyncFileWriter()
+{
+    if (!_asyncFileWriter)
+        _asyncFileWriter = new AsyncFileWriter(this);
+    return _asyncFileWriter;
 }
 
 bool FileUtils::init()
 {
+    CC_STARTUP_PHASE("FileUtils");
     _searchPathArray.push_back(_defaultResRootPath);
+    resetPathCache();
     return true;
 }
 
 void FileUtils::purgeCachedEntries()
 {
-    _fullPathCache.clear();
+    resetPathCache();
+}
+
+void FileUtils::buildSearchPathIndexes()
+{
+    _pathCache->buildIndexes();
+}
+
+std::unordered_map<std::string, std::string> FileUtils::getFullPathCache() const
+{
+    return _pathCache->getEntries();
+}
+
+bool FileUtils::canIndexSearchPath(const std::string& searchPath) const
+{
+    // only the resources shipped with the app are known not to change while it runs
+    return !_defaultResRootPath.empty() && isAbsolutePath(_defaultResRootPath) &&
+           searchPath.compare(0, _defaultResRootPath.size(), _defaultResRootPath) == 0 &&
+           searchPath.find("/.") == std::string::npos && isDirectoryExistInternal(searchPath);
+}
+
+bool FileUtils::listSearchPathFiles(const std::string& searchPath, std::vector<std::string>* files) const
+{
+    std::vector<std::string> fullPaths;
+    listFilesRecursively(searchPath, &fullPaths);
+
+    // the listed paths may repeat separators
+    auto collapse = [](const std::string& path) {
+        std::string collapsed;
+        collapsed.reserve(path.size());
+        for (char c : path)
+        {
+            if (c == '\\')
+                c = '/';
+            if (c != '/' || collapsed.empty() || collapsed.back() != '/')
+                collapsed.push_back(c);
+        }
+        return collapsed;
+    };
+    std::string root = collapse(searchPath);
+    if (root.empty() || root.back() != '/')
+        root.push_back('/');
+
+    files->reserve(fullPaths.size());
+    for (const auto& fullPath : fullPaths)
+    {
+        std::string path = collapse(fullPath);
+        if (path.back() == '/')
+            continue;
+        if (path.compare(0, root.size(), root) != 0)
+            return false;
+        files->push_back(path.substr(root.size()));
+    }
+    return true;
+}
+
+void FileUtils::resetPathCache()
+{
+    std::vector<bool> isIndexable;
+    isIndexable.reserve(_searchPathArray.size());
+    for (const auto& searchPath : _searchPathArray)
+        isIndexable.push_back(canIndexSearchPath(searchPath));
+    _pathCache->reset(_searchPathArray, isIndexable);
 }
 
 std::string FileUtils::getStringFromFile(const std::string& filename)
@@ -641,6 +819,10 @@ FileUtils::Status FileUtils::getContents(const std::string& filename, ResizableB
 
     auto fs = FileUtils::getInstance();
 
+    Status status;
+    if (fs->getContentsFromPack(filename, buffer, &status))
+        return status;
+
     std::string fullPath = fs->fullPathForFilename(filename);
     if (fullPath.empty())
         return Status::NotExists;
@@ -673,6 +855,195 @@ FileUtils::Status FileUtils::getContents(const std::string& filename, ResizableB
     return Status::OK;
 }
 
+MappedFile::MappedFile(const unsigned char* bytes, ssize_t size, const Releaser& releaser)
+: _bytes(bytes)
+, _size(size)
+, _releaser(releaser)
+{
+}
+
+MappedFile::MappedFile(MappedFile&& other)
+: _bytes(other._bytes)
+, _size(other._size)
+, _releaser(std::move(other._releaser))
+{
+    other._bytes = nullptr;
+    other._size = 0;
+    other._releaser = nullptr;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other)
+{
+    if (this != &other)
+    {
+        reset();
+        _bytes = other._bytes;
+        _size = other._size;
+        _releaser = std::move(other._releaser);
+        other._bytes = nullptr;
+        other._size = 0;
+        other._releaser = nullptr;
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile()
+{
+    reset();
+}
+
+void MappedFile::reset()
+{
+    if (_releaser)
+    {
+        _releaser();
+        _releaser = nullptr;
+    }
+    _bytes = nullptr;
+    _size = 0;
+}
+
+MappedFile FileUtils::mapFile(const std::string& filename)
+{
+    if (filename.empty())
+        return MappedFile();
+
+    MappedFile packed;
+    if (mapFileFromPack(filename, &packed))
+        return packed;
+
+    std::string fullPath = fullPathForFilename(filename);
+    if (fullPath.empty())
+        return MappedFile();
+
+#if (CC_PLATFORM != CC_PLATFORM_WINDOWS)
+    int descriptor = open(getSuitableFOpen(fullPath).c_str(), O_RDONLY);
+    if (descriptor == -1)
+        return MappedFile();
+
+    struct stat statBuf;
+    if (fstat(descriptor, &statBuf) == -1 || statBuf.st_size <= 0) {
+        close(descriptor);
+        return MappedFile();
+    }
+
+    // the mapping outlives the descriptor
+    const size_t size = statBuf.st_size;
+    void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (address != MAP_FAILED)
+        return MappedFile(static_cast<const unsigned char*>(address), size, [address, size]() { munmap(address, size); });
+#endif
+
+    return copyToMappedFile(fullPath);
+}
+
+FileUtils::ReadHandle FileUtils::readAsync(const std::string& filename, ReadPriority priority, const ReadCallback& callback)
+{
+    // resolved here, the search path cache is not shared with the I/O threads
+    std::string fullPath = fullPathForFilename(filename);
+    return getAsyncFileReader()->read(fullPath, priority, callback);
+}
+
+void FileUtils::cancelRead(ReadHandle handle)
+{
+    if (_asyncFileReader)
+        _asyncFileReader->cancel(handle);
+}
+
+void FileUtils::setMaxConcurrentReads(uint32_t count)
+{
+    _maxConcurrentReads = std::max(count, 1u);
+    if (_asyncFileReader)
+        _asyncFileReader->setMaxConcurrentReads(_maxConcurrentReads);
+}
+
+uint32_t FileUtils::getMaxConcurrentReads() const
+{
+    return _maxConcurrentReads;
+}
+
+AsyncFileReader* FileUtils::getAsyncFileReader()
+{
+    if (!_asyncFileReader)
+        _asyncFileReader = new AsyncFileReader(this, _maxConcurrentReads);
+    return _asyncFileReader;
+}
+
+bool FileUtils::mountPack(const std::string& filename)
+{
+    std::string fullPath = fullPathForFilename(filename);
+    if (fullPath.empty())
+    {
+        CC_LOG_ERROR("Asset pack %s doesn't exist.", filename.c_str());
+        return false;
+    }
+    unmountPack(fullPath);
+
+    auto pack = AssetPack::create(fullPath, mapFile(fullPath));
+    if (!pack)
+        return false;
+    _packs.push_back(pack);
+    return true;
+}
+
+void FileUtils::unmountPack(const std::string& filename)
+{
+    std::string fullPath = fullPathForFilename(filename);
+    _packs.erase(std::remove_if(_packs.begin(), _packs.end(), [&](const std::shared_ptr<AssetPack>& pack) {
+        return pack->getPath() == fullPath || pack->getPath() == filename;
+    }), _packs.end());
+}
+
+bool FileUtils::isFileInPack(const std::string& filename) const
+{
+    for (auto iter = _packs.rbegin(); iter != _packs.rend(); ++iter)
+    {
+        if ((*iter)->find(filename))
+            return true;
+    }
+    return false;
+}
+
+bool FileUtils::getContentsFromPack(const std::string& filename, ResizableBuffer* buffer, Status* status) const
+{
+    for (auto iter = _packs.rbegin(); iter != _packs.rend(); ++iter)
+    {
+        if (const auto* entry = (*iter)->find(filename))
+        {
+            *status = (*iter)->read(entry, buffer);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FileUtils::mapFileFromPack(const std::string& filename, MappedFile* file) const
+{
+    for (auto iter = _packs.rbegin(); iter != _packs.rend(); ++iter)
+    {
+        if (const auto* entry = (*iter)->find(filename))
+        {
+            *file = (*iter)->map(entry);
+            return true;
+        }
+    }
+    return false;
+}
+
+MappedFile FileUtils::copyToMappedFile(const std::string& filename)
+{
+    Data* data = new (std::nothrow) Data();
+    if (!data)
+        return MappedFile();
+
+    if (getContents(filename, data) != Status::OK || data->isNull()) {
+        delete data;
+        return MappedFile();
+    }
+    return MappedFile(data->getBytes(), data->getSize(), [data]() { delete data; });
+}
+
 unsigned char* FileUtils::getFileDataFromZip(const std::string& zipFilePath, const std::string& filename, ssize_t *size)
 {
     unsigned char * buffer = nullptr;
@@ -745,34 +1116,18 @@ std::string FileUtils::fullPathForFilename(const std::string &filename) const
         return "";
     }
 
-    if (isAbsolutePath(filename))
-    {
-        return normalizePath(filename);
-    }
-
-    // Already Cached ?
-    auto cacheIter = _fullPathCache.find(filename);
-    if(cacheIter != _fullPathCache.end())
+    if (isFileInPack(filename))
     {
-        return cacheIter->second;
+        return filename;
     }
 
-    std::string fullpath;
-
-    for (const auto& searchIt : _searchPathArray)
+    if (isAbsolutePath(filename))
     {
-        fullpath = this->getPathForFilename(filename, searchIt);
-        
-        if (!fullpath.empty())
-        {
-            // Using the filename passed in as key.
-            _fullPathCache.insert(std::make_pair(filename, fullpath));
-            return fullpath;
-        }
+        return normalizePath(filename);
     }
 
-    // The file wasn't found, return empty string.
-    return "";
+    // Using the filename passed in as key, empty if the file wasn't found.
+    return _pathCache->resolve(filename);
 }
 
 std::string FileUtils::fullPathFromRelativeFile(const std::string &filename, const std::string &relativeFile)
@@ -804,7 +1159,6 @@ void FileUtils::setDefaultResourceRootPath(const std::string& path)
 {
     if (_defaultResRootPath != path)
     {
-        _fullPathCache.clear();
         _defaultResRootPath = path;
         if (!_defaultResRootPath.empty() && _defaultResRootPath[_defaultResRootPath.length()-1] != '/')
         {
@@ -821,7 +1175,6 @@ void FileUtils::setSearchPaths(const std::vector<std::string>& searchPaths)
     bool existDefaultRootPath = false;
     _originalSearchPaths = searchPaths;
 
-    _fullPathCache.clear();
     _searchPathArray.clear();
 
     for (const auto& path : _originalSearchPaths)
@@ -850,6 +1203,7 @@ void FileUtils::setSearchPaths(const std::vector<std::string>& searchPaths)
         //CC_LOG_DEBUG("Default root path doesn't exist, adding it.");
         _searchPathArray.push_back(_defaultResRootPath);
     }
+    resetPathCache();
 }
 
 void FileUtils::addSearchPath(const std::string &searchpath,const bool front)
@@ -870,6 +1224,7 @@ void FileUtils::addSearchPath(const std::string &searchpath,const bool front)
         _originalSearchPaths.push_back(searchpath);
         _searchPathArray.push_back(path);
     }
+    resetPathCache();
 }
 
 std::string FileUtils::getFullPathForDirectoryAndFilename(const std::string& directory, const std::string& filename) const
@@ -920,10 +1275,10 @@ bool FileUtils::isDirectoryExist(const std::string& dirPath) const
     }
 
     // Already Cached ?
-    auto cacheIter = _fullPathCache.find(dirPath);
-    if( cacheIter != _fullPathCache.end() )
+    std::string cachedPath;
+    if (_pathCache->find(dirPath, &cachedPath))
     {
-        return isDirectoryExistInternal(cacheIter->second);
+        return isDirectoryExistInternal(cachedPath);
     }
 
     std::string fullpath;
@@ -933,7 +1288,7 @@ bool FileUtils::isDirectoryExist(const std::string& dirPath) const
         fullpath = fullPathForFilename(searchIt + dirPath);
         if (isDirectoryExistInternal(fullpath))
         {
-            _fullPathCache.insert(std::make_pair(dirPath, fullpath));
+            _pathCache->insert(dirPath, fullpath);
             return true;
         }
     }
@@ -26,6 +26,8 @@ THE SOFTWARE.
 #ifndef __CC_FILEUTILS_H__
 #define __CC_FILEUTILS_H__
 
+#include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -114,6 +116,43 @@ public:
     }
 };
 
+class AsyncFileReader;
+class AsyncFileWriter;
+class AssetPack;
+class FilePathCache;
+
+/**
+ * Read-only view of the contents of a file, returned by FileUtils::mapFile.
+ * The bytes stay valid as long as the object lives and are unmapped when it is destroyed.
+ */
+class CC_DLL MappedFile
+{
+public:
+    /** Unmaps the bytes, called once when the view is destroyed or reset. */
+    typedef std::function<void()> Releaser;
+
+    MappedFile() = default;
+    MappedFile(const unsigned char* bytes, ssize_t size, const Releaser& releaser);
+    MappedFile(MappedFile&& other);
+    MappedFile& operator=(MappedFile&& other);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    inline const unsigned char* getBytes() const { return _bytes; }
+    inline ssize_t getSize() const { return _size; }
+    inline bool isNull() const { return _bytes == nullptr || _size == 0; }
+
+    /** Releases the view, it is null afterwards. */
+    void reset();
+
+private:
+    const unsigned char* _bytes = nullptr;
+    ssize_t _size = 0;
+    Releaser _releaser = nullptr;
+};
+
 /** Helper class to handle file operations. */
 class CC_DLL FileUtils
 {
@@ -151,10 +190,16 @@ public:
     virtual ~FileUtils();
 
     /**
-     *  Purges full path caches.
+     *  Purges full path caches, call it once files were added or removed behind the back of FileUtils.
      */
     virtual void purgeCachedEntries();
 
+    /**
+     *  Lists the search paths which may be indexed ahead of the first lookups, thread safe.
+     *  Lookups racing with it wait for the listing of the path they search instead of listing it again.
+     */
+    void buildSearchPathIndexes();
+
     /**
      *  Gets string from a file.
      */
@@ -245,6 +290,66 @@ public:
     }
     virtual Status getContents(const std::string& filename, ResizableBuffer* buffer);
 
+    /**
+     *  Maps a file into memory read-only instead of copying its contents.
+     *
+     *  Files on disk are mapped with mmap or MapViewOfFile, uncompressed Android assets are read in place from the APK.
+     *  Files which can't be mapped, such as the ones in an OBB file, are read into a buffer the view owns.
+     *
+     *  @code
+     *  MappedFile file = FileUtils::getInstance()->mapFile("path/to/file");
+     *  if (!file.isNull()) parse(file.getBytes(), file.getSize());
+     *  @endcode
+     *
+     *  @param[in]  filename The resource file name which contains the path.
+     *  @return The view of the file, null if the file doesn't exist, can't be read or is empty.
+     */
+    virtual MappedFile mapFile(const std::string& filename);
+
+    enum class ReadPriority
+    {
+        Low = 0,
+        Normal = 1,
+        High = 2
+    };
+
+    /** Called on the cocos thread, the file is null if it couldn't be read. */
+    typedef std::function<void(const std::shared_ptr<MappedFile>& file)> ReadCallback;
+    /** Identifies a read to cancel, 0 is never a valid one. */
+    typedef uint32_t ReadHandle;
+
+    /**
+     *  Maps a file on an I/O thread and delivers it to the cocos thread through Scheduler::performFunctionInCocosThread.
+     *
+     *  Reads of the same file which are still pending are coalesced into one, which takes the highest priority of them.
+     *  Higher priorities are read first and at most getMaxConcurrentReads() files are read at once.
+     *
+     *  @param[in]  filename The resource file name which contains the path, resolved on the calling thread.
+     *  @param[in]  priority The priority among the pending reads.
+     *  @param[in]  callback Receives the file, shared by the coalesced reads.
+     *  @return The handle to cancel the read with.
+     */
+    ReadHandle readAsync(const std::string& filename, ReadPriority priority, const ReadCallback& callback);
+
+    /** Drops the callback of a read, the file isn't read at all once no callback waits for it. */
+    void cancelRead(ReadHandle handle);
+
+    void setMaxConcurrentReads(uint32_t count);
+    uint32_t getMaxConcurrentReads() const;
+
+    /**
+     *  Mounts a pack written by tools/asset-pack, whose files are found ahead of the search paths.
+     *
+     *  The files are looked up by the relative name they were packed with, fullPathForFilename returns that name unchanged.
+     *  A file in the pack mounted last hides the ones with the same name in earlier packs.
+     *  Mount packs at startup, before any file is read.
+     *
+     *  @param[in]  filename The pack file, resolved with fullPathForFilename before the pack is mapped.
+     *  @return True if the pack was mounted.
+     */
+    bool mountPack(const std::string& filename);
+    void unmountPack(const std::string& filename);
+
     /**
      *  Gets resource file data from a zip file.
      *
@@ -296,6 +401,10 @@ public:
 
      If the new file can't be found on the file system, it will return the parameter filename directly.
 
+     Hits and misses are both cached until the search paths change, cached names are resolved without a lock so
+     worker threads may call it concurrently. Search paths beneath the default resource root are listed once and
+     names which aren't listed are skipped without touching the file system.
+
      This method was added to simplify multiplatform support. Whether you are using cocos2d-js or any cross-compilation toolchain like StellaSDK or Apportable,
      you might need to load different resources for a given file in the different platforms.
 
@@ -417,12 +526,55 @@ public:
     /**
      * write Data into a file
      *
+     * The data is written to fullPath + ".tmp" which is then renamed over the file, so a crash leaves either
+     * the old or the new contents. The temporary file is synced according to getFsyncPolicy().
+     *
      *@param data the data want to save
      *@param fullPath The full path to the file you want to save a string
      *@return bool
      */
     virtual bool writeDataToFile(const Data& data, const std::string& fullPath);
 
+    /** How far writes wait for the storage before the file is renamed into place. */
+    enum class FsyncPolicy
+    {
+        None = 0,            // leaves flushing to the system, the rename may reach the disk before the data
+        File = 1,            // syncs the file before renaming it
+        FileAndDirectory = 2 // also syncs the directory after the rename, which makes the rename itself durable
+    };
+
+    /** Applies to the writes started afterwards, FsyncPolicy::None by default. */
+    void setFsyncPolicy(FsyncPolicy policy) { _fsyncPolicy = policy; }
+    FsyncPolicy getFsyncPolicy() const { return _fsyncPolicy; }
+
+    /** Called on the cocos thread once the file was renamed into place or the write failed. */
+    typedef std::function<void(bool succeeded)> WriteCallback;
+
+    /**
+     *  Writes a file on an I/O thread the way writeDataToFile does, the result is delivered through
+     *  Scheduler::performFunctionInCocosThread.
+     *
+     *  Writes of the same file which are still pending are coalesced, only the newest data is written and every
+     *  callback receives its result. All the pending files are written as one batch, with FsyncPolicy::FileAndDirectory
+     *  each directory of the batch is synced once.
+     *
+     *  @param[in]  data     The contents, taken over by the writer.
+     *  @param[in]  fullPath The full path to the file.
+     *  @param[in]  callback Receives the result, may be empty.
+     */
+    void writeDataToFileAsync(Data&& data, const std::string& fullPath, const WriteCallback& callback = nullptr);
+    void writeDataToFileAsync(const Data& data, const std::string& fullPath, const WriteCallback& callback = nullptr);
+    void writeStringToFileAsync(const std::string& dataStr, const std::string& fullPath, const WriteCallback& callback = nullptr);
+
+    /** Blocks until the asynchronous writes requested so far are on disk, e.g. before the application is suspended. */
+    void flushWrites();
+
+    /**
+     *  Writes to fullPath + ".tmp", syncs it according to the policy and renames it over fullPath.
+     *  Doesn't touch the path cache, so it can run on any thread.
+     */
+    bool writeFileAtomically(const unsigned char* bytes, size_t size, const std::string& fullPath, FsyncPolicy policy);
+
     /**
     * write ValueMap into a plist file
     *
@@ -559,7 +711,7 @@ public:
     virtual long getFileSize(const std::string &filepath);
 
     /** Returns the full path cache. */
-    const std::unordered_map<std::string, std::string>& getFullPathCache() const { return _fullPathCache; }
+    std::unordered_map<std::string, std::string> getFullPathCache() const;
 
     std::string normalizePath(const std::string& path) const;
     std::string getFileDir(const std::string& path) const;
@@ -580,6 +732,27 @@ protected:
      */
     virtual bool init();
 
+    /** Reads a file into a buffer owned by the returned view, for files which can't be mapped. */
+    MappedFile copyToMappedFile(const std::string& filename);
+
+    AsyncFileReader* getAsyncFileReader();
+    AsyncFileWriter* getAsyncFileWriter();
+
+    /** Reads a file from the mounted packs, false if none of them contains it. */
+    bool getContentsFromPack(const std::string& filename, ResizableBuffer* buffer, Status* status) const;
+    /** Maps a file from the mounted packs, false if none of them contains it. */
+    bool mapFileFromPack(const std::string& filename, MappedFile* file) const;
+    bool isFileInPack(const std::string& filename) const;
+
+    /**
+     *  Checks whether the files beneath a search path may be listed once and looked up in the listing,
+     *  called on the thread setting the search paths.
+     */
+    virtual bool canIndexSearchPath(const std::string& searchPath) const;
+    /** Lists the files beneath a search path, relative to it. */
+    bool listSearchPathFiles(const std::string& searchPath, std::vector<std::string>* files) const;
+    void resetPathCache();
+
     /**
      *  Checks whether a file exists without considering search paths and resolution orders.
      *  @param filename The file (with absolute path) to look up for
@@ -636,16 +809,38 @@ protected:
     std::string _defaultResRootPath;
 
     /**
-     *  The full path cache. When a file is found, it will be added into this cache.
+     *  The full path cache, which remembers the files found and the ones missing from every search path.
      *  This variable is used for improving the performance of file search.
      */
-    mutable std::unordered_map<std::string, std::string> _fullPathCache;
+    FilePathCache* _pathCache = nullptr;
 
     /**
      * Writable path.
      */
     std::string _writablePath;
 
+    /**
+     *  The I/O threads of readAsync, created with the first read.
+     */
+    AsyncFileReader* _asyncFileReader = nullptr;
+    uint32_t _maxConcurrentReads = 4;
+
+    /**
+     *  The I/O thread of writeDataToFileAsync, created with the first write.
+     */
+    AsyncFileWriter* _asyncFileWriter = nullptr;
+    FsyncPolicy _fsyncPolicy = FsyncPolicy::None;
+
+    /**
+     *  Purges the cached entries when memory runs low, see MemoryPressure.
+     */
+    uint32_t _memoryPressureHandlerID = 0;
+
+    /**
+     *  The mounted packs, the last one is searched first.
+     */
+    std::vector<std::shared_ptr<AssetPack>> _packs;
+
     /**
      *  The singleton pointer of FileUtils.
      */
@@ -0,0 +1,91 @@
+#include "platform/FramePacer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace cc {
+namespace {
+const int64_t DEFAULT_INTERVAL_NS = 16666667;
+// the sleeps end this much earlier and yield for the rest, the timers of Windows have a resolution of 1 ms at best
+#if CC_PLATFORM == CC_PLATFORM_WINDOWS
+const int64_t SPIN_NS = 1500000;
+#else
+const int64_t SPIN_NS = 200000;
+#endif
+
+int64_t nowNS() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// the refresh nearest to timeNS
+int64_t nearestRefresh(int64_t timeNS, int64_t vsyncNS, int64_t periodNS) {
+    const int64_t offsetNS = timeNS - vsyncNS + periodNS / 2;
+    int64_t refreshes = offsetNS / periodNS;
+    if (offsetNS % periodNS < 0) {
+        refreshes -= 1;
+    }
+    return vsyncNS + refreshes * periodNS;
+}
+} // namespace
+
+#if CC_PLATFORM != CC_PLATFORM_ANDROID && CC_PLATFORM != CC_PLATFORM_WINDOWS
+DisplayVsync *DisplayVsync::create() {
+    return nullptr;
+}
+#endif
+
+FramePacer::FramePacer() : _vsync(DisplayVsync::create()), _intervalNS(DEFAULT_INTERVAL_NS) {}
+
+FramePacer::~FramePacer() = default;
+
+float FramePacer::waitForNextFrame() {
+    int64_t vsyncNS = 0;
+    int64_t periodNS = 0;
+    const bool synced = _vsync && _vsync->getLatest(&vsyncNS, &periodNS) && periodNS > 0;
+    // the fewest refreshes within the preferred frame rate, give or take a tenth of a refresh, 60 fps on a display of
+    // 90 Hz is 2 refreshes since 1.5 on average would show every other frame longer
+    const int64_t stepNS = synced ? std::max<int64_t>(1, (_intervalNS + periodNS * 9 / 10) / periodNS) * periodNS : _intervalNS;
+
+    int64_t now = nowNS();
+    int64_t start = _lastStartNS ? _lastStartNS + stepNS : now;
+    if (synced) {
+        start = nearestRefresh(start, vsyncNS, periodNS);
+    }
+    if (start > now) {
+        if (synced) {
+            while (now < start) {
+                _vsync->wait(start - now);
+                _vsync->getLatest(&vsyncNS, &periodNS);
+                // Choreographer reports the refresh a little after it happened
+                if (vsyncNS >= start - periodNS / 4) {
+                    break;
+                }
+                now = nowNS();
+            }
+        } else {
+            sleepUntil(start);
+        }
+    } else if (synced && _lastStartNS) {
+        // late, on the refresh the frame is starting after
+        start = std::max(nearestRefresh(now, vsyncNS, periodNS), _lastStartNS + periodNS);
+    } else if (_lastStartNS) {
+        start = now;
+    }
+
+    const int64_t dtNS = _lastStartNS ? start - _lastStartNS : stepNS;
+    _lastStartNS = start;
+    return static_cast<float>(dtNS) / 1000000000.F;
+}
+
+void FramePacer::sleepUntil(int64_t timeNS) {
+    int64_t remainNS = timeNS - nowNS();
+    if (remainNS > SPIN_NS) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(remainNS - SPIN_NS));
+    }
+    while (nowNS() < timeNS) {
+        std::this_thread::yield();
+    }
+}
+
+} // namespace cc
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "base/Macros.h"
+
+#include <cstdint>
+#include <memory>
+
+namespace cc {
+
+// The refreshes of the display, from Choreographer on Android and from DWM on Windows.
+class DisplayVsync {
+public:
+    // nullptr where the platform has no source of refreshes
+    static DisplayVsync *create();
+
+    virtual ~DisplayVsync() = default;
+
+    // The latest refresh on the steady clock and the refresh period, false until they are known.
+    virtual bool getLatest(int64_t *timeNS, int64_t *periodNS) = 0;
+    // Sleeps at most timeoutNS, it may return at a refresh.
+    virtual void wait(int64_t timeoutNS) = 0;
+};
+
+// Starts the frames of Application::tick() on the refreshes of the display, a frame lasts a whole number of
+// refreshes closest to the preferred frame rate, it doesn't wait when the previous frame was late. The delta time
+// of a frame is the time between the refreshes it starts on, which is when it's going to be shown compared to the
+// previous frame, rather than the measured time of the CPU side. Without refreshes the frames are paced on the clock.
+class FramePacer {
+public:
+    FramePacer();
+    ~FramePacer();
+
+    void setFrameInterval(int64_t intervalNS) { _intervalNS = intervalNS; }
+
+    // Waits until the next frame should start, returns its delta time in seconds.
+    float waitForNextFrame();
+    // The next frame starts without waiting, e.g. after a pause.
+    void reset() { _lastStartNS = 0; }
+
+private:
+    void sleepUntil(int64_t timeNS);
+
+    std::unique_ptr<DisplayVsync> _vsync;
+    int64_t _intervalNS;
+    int64_t _lastStartNS = 0;
+};
+
+} // namespace cc
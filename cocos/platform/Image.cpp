@@ -53,13 +53,32 @@ extern "C"
 #include "webp/decode.h"
 #endif // CC_USE_WEBP
 
+#if CC_USE_BASISU
+#include "basisu/transcoder/basisu_transcoder.h"
+#endif // CC_USE_BASISU
+#include "base/ThreadPool.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include "platform/FileUtils.h"
+#include "platform/PlatformImageDecoder.h"
 #include "base/ZipUtils.h"
 #if (CC_PLATFORM == CC_PLATFORM_ANDROID)
 #include "platform/android/FileUtils-android.h"
 #endif
 
+#include <algorithm>
 #include <map>
+#include <memory>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && (defined(__arm64__) || defined(__aarch64__))
+#include <arm_neon.h>
+#endif
 
 namespace cc {
 
@@ -242,6 +261,115 @@ namespace
 }
 //pvr structure end
 
+//////////////////////////////////////////////////////////////////////////
+//struct and data for ktx2 structure
+
+namespace
+{
+    static const unsigned char KTX2_IDENTIFIER[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+    enum class KTX2Supercompression : uint32_t
+    {
+        NONE = 0,
+        BASIS_LZ = 1,
+        ZSTANDARD = 2,
+        ZLIB = 3,
+    };
+
+    typedef struct
+    {
+        unsigned char identifier[12];
+        uint32_t vkFormat;
+        uint32_t typeSize;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t layerCount;
+        uint32_t faceCount;
+        uint32_t levelCount;
+        uint32_t supercompressionScheme;
+        uint32_t dfdByteOffset;
+        uint32_t dfdByteLength;
+        uint32_t kvdByteOffset;
+        uint32_t kvdByteLength;
+        uint64_t sgdByteOffset;
+        uint64_t sgdByteLength;
+    } KTX2Header;
+
+    typedef struct
+    {
+        uint64_t byteOffset;
+        uint64_t byteLength;
+        uint64_t uncompressedByteLength;
+    } KTX2LevelIndex;
+
+    // VkFormat values of the formats copied as they are
+    typedef const std::map<uint32_t, gfx::Format> _ktx2_formathash;
+    static const _ktx2_formathash::value_type ktx2_formathash_value[] =
+    {
+        _ktx2_formathash::value_type(23,    gfx::Format::RGB8),
+        _ktx2_formathash::value_type(37,    gfx::Format::RGBA8),
+        _ktx2_formathash::value_type(131,   gfx::Format::BC1),
+        _ktx2_formathash::value_type(133,   gfx::Format::BC1_ALPHA),
+        _ktx2_formathash::value_type(137,   gfx::Format::BC3),
+        _ktx2_formathash::value_type(147,   gfx::Format::ETC2_RGB8),
+        _ktx2_formathash::value_type(149,   gfx::Format::ETC2_RGB8_A1),
+        _ktx2_formathash::value_type(151,   gfx::Format::ETC2_RGBA8),
+        _ktx2_formathash::value_type(157,   gfx::Format::ASTC_RGBA_4x4),
+    };
+
+    static const int KTX2_MAX_TABLE_ELEMENTS = sizeof(ktx2_formathash_value) / sizeof(ktx2_formathash_value[0]);
+    static const _ktx2_formathash ktx2_formathash(ktx2_formathash_value, ktx2_formathash_value + KTX2_MAX_TABLE_ELEMENTS);
+
+#if CC_USE_BASISU
+    // picks the best block format the device samples, RGBA8 is the last resort
+    static basist::transcoder_texture_format selectTranscodeTarget(bool hasAlpha, uint32_t width, uint32_t height, gfx::Format &renderFormat)
+    {
+        const gfx::Device *device = gfx::Device::getInstance();
+        if (device)
+        {
+            if (device->hasFeature(gfx::Feature::FORMAT_ASTC))
+            {
+                renderFormat = gfx::Format::ASTC_RGBA_4x4;
+                return basist::transcoder_texture_format::cTFASTC_4x4_RGBA;
+            }
+            if (device->hasFeature(gfx::Feature::FORMAT_DXT))
+            {
+                renderFormat = hasAlpha ? gfx::Format::BC3 : gfx::Format::BC1;
+                return hasAlpha ? basist::transcoder_texture_format::cTFBC3_RGBA : basist::transcoder_texture_format::cTFBC1_RGB;
+            }
+            if (device->hasFeature(gfx::Feature::FORMAT_ETC2))
+            {
+                // ETC1 blocks are valid ETC2 RGB blocks
+                renderFormat = hasAlpha ? gfx::Format::ETC2_RGBA8 : gfx::Format::ETC2_RGB8;
+                return hasAlpha ? basist::transcoder_texture_format::cTFETC2_RGBA : basist::transcoder_texture_format::cTFETC1_RGB;
+            }
+            if (!hasAlpha && device->hasFeature(gfx::Feature::FORMAT_ETC1))
+            {
+                renderFormat = gfx::Format::ETC_RGB8;
+                return basist::transcoder_texture_format::cTFETC1_RGB;
+            }
+            // PVRTC1 only covers square power of two textures
+            if (device->hasFeature(gfx::Feature::FORMAT_PVRTC) && width == height && !(width & (width - 1)))
+            {
+                renderFormat = hasAlpha ? gfx::Format::PVRTC_RGBA4 : gfx::Format::PVRTC_RGB4;
+                return hasAlpha ? basist::transcoder_texture_format::cTFPVRTC1_4_RGBA : basist::transcoder_texture_format::cTFPVRTC1_4_RGB;
+            }
+        }
+        renderFormat = gfx::Format::RGBA8;
+        return basist::transcoder_texture_format::cTFRGBA32;
+    }
+#endif // CC_USE_BASISU
+
+    // fixed pools push tasks from any thread, images are loaded on several of them
+    static ThreadPool *getDecodeThreadPool()
+    {
+        static ThreadPool *threadPool = ThreadPool::newFixedThreadPool(std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1));
+        return threadPool;
+    }
+}
+//ktx2 structure end
+
 namespace
 {
     typedef struct
@@ -267,6 +395,137 @@ namespace
         }
     }
 #endif //CC_USE_PNG
+
+    // box filters the rows of an image down to a smaller size while they arrive from the decoder, in order
+    class RowDownscaler
+    {
+    public:
+        RowDownscaler(int srcWidth, int srcHeight, int dstWidth, int dstHeight, int channels)
+        : _srcHeight(srcHeight), _dstWidth(dstWidth), _dstHeight(dstHeight), _channels(channels),
+          _sums(static_cast<size_t>(dstWidth) * channels, 0), _columns(srcWidth), _columnWidths(dstWidth)
+        {
+            for (int x = 0; x < dstWidth; ++x)
+            {
+                const int begin = static_cast<int>(static_cast<int64_t>(x) * srcWidth / dstWidth);
+                const int end = static_cast<int>(static_cast<int64_t>(x + 1) * srcWidth / dstWidth);
+                std::fill(_columns.begin() + begin, _columns.begin() + end, x);
+                _columnWidths[x] = end - begin;
+            }
+        }
+
+        // true when the row completed an output row, which was written to dst
+        bool addRow(const unsigned char *src, unsigned char *dst)
+        {
+            const int srcWidth = static_cast<int>(_columns.size());
+            for (int x = 0; x < srcWidth; ++x)
+            {
+                uint32_t *sum = &_sums[static_cast<size_t>(_columns[x]) * _channels];
+                const unsigned char *pixel = src + static_cast<size_t>(x) * _channels;
+                for (int c = 0; c < _channels; ++c)
+                    sum[c] += pixel[c];
+            }
+            ++_srcY;
+            ++_rowsInSum;
+            if (_srcY != static_cast<int>(static_cast<int64_t>(_dstY + 1) * _srcHeight / _dstHeight))
+                return false;
+
+            for (int x = 0; x < _dstWidth; ++x)
+            {
+                const uint32_t count = static_cast<uint32_t>(_columnWidths[x] * _rowsInSum);
+                uint32_t *sum = &_sums[static_cast<size_t>(x) * _channels];
+                unsigned char *pixel = dst + static_cast<size_t>(x) * _channels;
+                for (int c = 0; c < _channels; ++c)
+                {
+                    pixel[c] = static_cast<unsigned char>((sum[c] + count / 2) / count);
+                    sum[c] = 0;
+                }
+            }
+            _rowsInSum = 0;
+            ++_dstY;
+            return true;
+        }
+
+    private:
+        int _srcHeight = 0;
+        int _dstWidth = 0;
+        int _dstHeight = 0;
+        int _channels = 0;
+        int _srcY = 0;
+        int _dstY = 0;
+        int _rowsInSum = 0;
+        std::vector<uint32_t> _sums;
+        std::vector<int> _columns;      // the output column of each source column
+        std::vector<int> _columnWidths; // the source columns of each output column
+    };
+
+    inline uint16_t scaleChannel(unsigned int value, unsigned int max)
+    {
+        return static_cast<uint16_t>((value * max + 127) / 255);
+    }
+
+    // the packed pixels are written over the ones already read, so both work in place
+    void packRGB565(unsigned char *pixels, ssize_t pixelCount)
+    {
+        uint16_t *dst = reinterpret_cast<uint16_t*>(pixels);
+        for (ssize_t i = 0; i < pixelCount; ++i)
+        {
+            const unsigned char *p = pixels + i * 3;
+            dst[i] = static_cast<uint16_t>(scaleChannel(p[0], 31) << 11 | scaleChannel(p[1], 63) << 5 | scaleChannel(p[2], 31));
+        }
+    }
+
+    // 0 decodes every JPEG image with libjpeg
+    std::atomic<int> platformDecodeThreshold{0};
+
+    // the component count of the frame header of a JPEG image, 0 if there is none
+    int getJpgComponentCount(const unsigned char *data, ssize_t dataLen)
+    {
+        ssize_t pos = 2;
+        while (pos + 4 <= dataLen && data[pos] == 0xFF)
+        {
+            const unsigned char marker = data[pos + 1];
+            const ssize_t length = data[pos + 2] << 8 | data[pos + 3];
+            // SOF0 to SOF15 without DHT, JPG and DAC
+            if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+                return pos + 9 < dataLen ? data[pos + 9] : 0;
+            if (marker == 0xDA)
+                break;
+            pos += 2 + length;
+        }
+        return 0;
+    }
+
+    void packRGBA4444(unsigned char *pixels, ssize_t pixelCount)
+    {
+        uint16_t *dst = reinterpret_cast<uint16_t*>(pixels);
+        for (ssize_t i = 0; i < pixelCount; ++i)
+        {
+            const unsigned char *p = pixels + i * 4;
+            dst[i] = static_cast<uint16_t>(scaleChannel(p[0], 15) << 12 | scaleChannel(p[1], 15) << 8 | scaleChannel(p[2], 15) << 4 | scaleChannel(p[3], 15));
+        }
+    }
+
+    bool isAlphaOpaque(const unsigned char *pixels, ssize_t pixelCount, int channels)
+    {
+        for (ssize_t i = channels - 1; i < pixelCount * channels; i += channels)
+        {
+            if (pixels[i] != 255)
+                return false;
+        }
+        return true;
+    }
+
+    // drops the last channel in place
+    void stripAlpha(unsigned char *pixels, ssize_t pixelCount, int channels)
+    {
+        unsigned char *dst = pixels;
+        for (ssize_t i = 0; i < pixelCount; ++i)
+        {
+            const unsigned char *p = pixels + i * channels;
+            for (int c = 0; c < channels - 1; ++c)
+                *dst++ = p[c];
+        }
+    }
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -279,7 +538,153 @@ Image::Image(): _renderFormat(gfx::Format::UNKNOWN)
 
 Image::~Image()
 {
-    CC_SAFE_FREE(_data);
+    releaseData();
+}
+
+unsigned char *Image::allocateData(ssize_t size)
+{
+    _ownsData = !_dataAllocator;
+    _data = _dataAllocator ? _dataAllocator(size) : static_cast<unsigned char*>(malloc(size * sizeof(unsigned char)));
+    return _data;
+}
+
+void Image::releaseData()
+{
+    if (_ownsData)
+    {
+        CC_SAFE_FREE(_data);
+    }
+    _data = nullptr;
+    _ownsData = true;
+}
+
+void Image::getDecodeSize(int width, int height, int *decodeWidth, int *decodeHeight) const
+{
+    fitDecodeSize(width, height, _maxDecodeWidth, _maxDecodeHeight, decodeWidth, decodeHeight);
+}
+
+void Image::fitDecodeSize(int width, int height, int maxWidth, int maxHeight, int *decodeWidth, int *decodeHeight)
+{
+    double scale = 1.0;
+    if (maxWidth > 0 && width > maxWidth)
+        scale = std::min(scale, static_cast<double>(maxWidth) / width);
+    if (maxHeight > 0 && height > maxHeight)
+        scale = std::min(scale, static_cast<double>(maxHeight) / height);
+
+    *decodeWidth = scale < 1.0 ? std::max(static_cast<int>(width * scale), 1) : width;
+    *decodeHeight = scale < 1.0 ? std::max(static_cast<int>(height * scale), 1) : height;
+}
+
+void Image::convertDecodedPixels()
+{
+    const ssize_t pixelCount = static_cast<ssize_t>(_width) * _height;
+    if (_stripOpaqueAlpha)
+    {
+        if (_renderFormat == gfx::Format::RGBA8 && isAlphaOpaque(_data, pixelCount, 4))
+        {
+            stripAlpha(_data, pixelCount, 4);
+            _renderFormat = gfx::Format::RGB8;
+            _hasPremultipliedAlpha = false;
+        }
+        else if (_renderFormat == gfx::Format::LA8 && isAlphaOpaque(_data, pixelCount, 2))
+        {
+            stripAlpha(_data, pixelCount, 2);
+            _renderFormat = gfx::Format::L8;
+            _hasPremultipliedAlpha = false;
+        }
+    }
+
+    if (_packPixels)
+    {
+        if (_renderFormat == gfx::Format::RGB8)
+        {
+            packRGB565(_data, pixelCount);
+            _renderFormat = gfx::Format::R5G6B5;
+        }
+        else if (_renderFormat == gfx::Format::RGBA8)
+        {
+            packRGBA4444(_data, pixelCount);
+            _renderFormat = gfx::Format::RGBA4;
+        }
+    }
+
+    int bytesPerPixel = 1;
+    switch (_renderFormat)
+    {
+        case gfx::Format::LA8:
+        case gfx::Format::R5G6B5:
+        case gfx::Format::RGBA4:
+            bytesPerPixel = 2;
+            break;
+        case gfx::Format::RGB8:
+            bytesPerPixel = 3;
+            break;
+        case gfx::Format::RGBA8:
+            bytesPerPixel = 4;
+            break;
+        default:
+            break;
+    }
+    const ssize_t dataLen = pixelCount * bytesPerPixel;
+    if (dataLen == _dataLen)
+        return;
+    _dataLen = dataLen;
+    // the memory of an allocator stays as large as it was asked for
+    if (_ownsData)
+    {
+        unsigned char *data = static_cast<unsigned char*>(realloc(_data, _dataLen));
+        if (data)
+            _data = data;
+    }
+}
+
+void Image::premultiplyAlpha(unsigned char *pixels, ssize_t pixelCount)
+{
+    ssize_t i = 0;
+#if defined(__SSE2__)
+    // four pixels a time, (c * a + 128) * 257 >> 16 rounds c * a / 255 exactly
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i half = _mm_set1_epi16(128);
+    const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+    for (; i + 4 <= pixelCount; i += 4)
+    {
+        __m128i *p = reinterpret_cast<__m128i*>(pixels + i * 4);
+        const __m128i px = _mm_loadu_si128(p);
+        __m128i lo = _mm_unpacklo_epi8(px, zero);
+        __m128i hi = _mm_unpackhi_epi8(px, zero);
+        const __m128i alphaLo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        const __m128i alphaHi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        lo = _mm_add_epi16(_mm_mullo_epi16(lo, alphaLo), half);
+        hi = _mm_add_epi16(_mm_mullo_epi16(hi, alphaHi), half);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+        const __m128i result = _mm_packus_epi16(lo, hi);
+        _mm_storeu_si128(p, _mm_or_si128(_mm_andnot_si128(alphaMask, result), _mm_and_si128(alphaMask, px)));
+    }
+#elif defined(__ARM_NEON) && (defined(__arm64__) || defined(__aarch64__))
+    // eight pixels a time, vraddhn(x, x >> 8 rounded) rounds x / 255 exactly
+    for (; i + 8 <= pixelCount; i += 8)
+    {
+        uint8_t *p = pixels + i * 4;
+        uint8x8x4_t px = vld4_u8(p);
+        for (int c = 0; c < 3; ++c)
+        {
+            const uint16x8_t product = vmull_u8(px.val[c], px.val[3]);
+            px.val[c] = vraddhn_u16(product, vrshrq_n_u16(product, 8));
+        }
+        vst4_u8(p, px);
+    }
+#endif
+    for (; i < pixelCount; ++i)
+    {
+        unsigned char *p = pixels + i * 4;
+        const unsigned int alpha = p[3];
+        for (int c = 0; c < 3; ++c)
+        {
+            const unsigned int value = p[c] * alpha + 128;
+            p[c] = static_cast<unsigned char>((value + (value >> 8)) >> 8);
+        }
+    }
 }
 
 bool Image::initWithImageFile(const std::string& path)
@@ -289,11 +694,11 @@ bool Image::initWithImageFile(const std::string& path)
 //    _filePath = FileUtils::getInstance()->fullPathForFilename(path);
     _filePath = path;
 
-    Data data = FileUtils::getInstance()->getDataFromFile(_filePath);
+    MappedFile file = FileUtils::getInstance()->mapFile(_filePath);
 
-    if (!data.isNull())
+    if (!file.isNull())
     {
-        ret = initWithImageData(data.getBytes(), data.getSize());
+        ret = initWithImageData(file.getBytes(), file.getSize());
     }
 
     return ret;
@@ -333,7 +738,7 @@ bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen)
             ret = initWithPngData(unpackedData, unpackedLen);
             break;
         case Format::JPG:
-            ret = initWithJpgData(unpackedData, unpackedLen);
+            ret = initWithPlatformData(unpackedData, unpackedLen) || initWithJpgData(unpackedData, unpackedLen);
             break;
         case Format::WEBP:
             ret = initWithWebpData(unpackedData, unpackedLen);
@@ -350,6 +755,9 @@ bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen)
         case Format::ASTC:
             ret = initWithASTCData(unpackedData, unpackedLen);
             break;
+        case Format::KTX2:
+            ret = initWithKTX2Data(unpackedData, unpackedLen);
+            break;
         default:
             break;
         }
@@ -390,6 +798,16 @@ bool Image::isASTC(const unsigned char * data, ssize_t dataLen)
     return astcIsValid((astc_byte*)data) ? true : false;
 }
 
+bool Image::isKtx2(const unsigned char * data, ssize_t dataLen)
+{
+    if (static_cast<size_t>(dataLen) < sizeof(KTX2Header))
+    {
+        return false;
+    }
+
+    return memcmp(data, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) == 0;
+}
+
 bool Image::isJpg(const unsigned char * data, ssize_t dataLen)
 {
     if (dataLen <= 4)
@@ -459,6 +877,10 @@ Image::Format Image::detectFormat(const unsigned char * data, ssize_t dataLen)
     {
         return Format::ASTC;
     }
+    else if (isKtx2(data, dataLen))
+    {
+        return Format::KTX2;
+    }
     else
     {
         return Format::UNKNOWN;
@@ -621,25 +1043,58 @@ bool Image::initWithJpgData(const unsigned char * data, ssize_t dataLen)
             _renderFormat = gfx::Format::RGB8;
         }
 
+        // the DCT scales by 1/2, 1/4 and 1/8 for free, the box filter only takes what is left
+        int decodeWidth = 0, decodeHeight = 0;
+        getDecodeSize(cinfo.image_width, cinfo.image_height, &decodeWidth, &decodeHeight);
+        cinfo.scale_num = 1;
+        cinfo.scale_denom = 1;
+        while (cinfo.scale_denom < 8)
+        {
+            const unsigned int denom = cinfo.scale_denom * 2;
+            if (static_cast<int>((cinfo.image_width + denom - 1) / denom) < decodeWidth ||
+                static_cast<int>((cinfo.image_height + denom - 1) / denom) < decodeHeight)
+                break;
+            cinfo.scale_denom = denom;
+        }
+
         /* Start decompression jpeg here */
         jpeg_start_decompress( &cinfo );
 
         /* init image info */
         _isCompressed = false;
-        _width  = cinfo.output_width;
-        _height = cinfo.output_height;
-        _dataLen = cinfo.output_width*cinfo.output_height*cinfo.output_components;
-        _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
-        CC_BREAK_IF(! _data);
+        _width  = decodeWidth;
+        _height = decodeHeight;
+        _dataLen = decodeWidth*decodeHeight*cinfo.output_components;
+        if (!allocateData(_dataLen))
+        {
+            jpeg_destroy_decompress( &cinfo );
+            break;
+        }
 
         /* now actually read the jpeg into the raw buffer */
         /* read one scan line at a time */
-        while (cinfo.output_scanline < cinfo.output_height)
+        if (static_cast<int>(cinfo.output_width) == decodeWidth && static_cast<int>(cinfo.output_height) == decodeHeight)
         {
-            row_pointer[0] = _data + location;
-            location += cinfo.output_width*cinfo.output_components;
-            jpeg_read_scanlines(&cinfo, row_pointer, 1);
+            while (cinfo.output_scanline < cinfo.output_height)
+            {
+                row_pointer[0] = _data + location;
+                location += cinfo.output_width*cinfo.output_components;
+                jpeg_read_scanlines(&cinfo, row_pointer, 1);
+            }
         }
+        else
+        {
+            RowDownscaler downscaler(cinfo.output_width, cinfo.output_height, decodeWidth, decodeHeight, cinfo.output_components);
+            std::vector<unsigned char> scanline(cinfo.output_width*cinfo.output_components);
+            while (cinfo.output_scanline < cinfo.output_height)
+            {
+                row_pointer[0] = scanline.data();
+                jpeg_read_scanlines(&cinfo, row_pointer, 1);
+                if (downscaler.addRow(scanline.data(), _data + location))
+                    location += decodeWidth*cinfo.output_components;
+            }
+        }
+        convertDecodedPixels();
 
         /* When read image file with broken data, jpeg_finish_decompress() may cause error.
          * Besides, jpeg_destroy_decompress() shall deallocate and release all memory associated
@@ -762,9 +1217,13 @@ bool Image::initWithPngData(const unsigned char * data, ssize_t dataLen)
 
         rowbytes = png_get_rowbytes(png_ptr, info_ptr);
 
-        _dataLen = rowbytes * _height;
-        _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
-        if (!_data)
+        int decodeWidth = 0, decodeHeight = 0;
+        getDecodeSize(_width, _height, &decodeWidth, &decodeHeight);
+        const bool isDownscaled = decodeWidth != _width || decodeHeight != _height;
+        const size_t decodeRowBytes = isDownscaled ? static_cast<size_t>(decodeWidth) * png_get_channels(png_ptr, info_ptr) : rowbytes;
+
+        _dataLen = decodeRowBytes * decodeHeight;
+        if (!allocateData(_dataLen))
         {
             if (row_pointers != nullptr)
             {
@@ -773,12 +1232,71 @@ bool Image::initWithPngData(const unsigned char * data, ssize_t dataLen)
             break;
         }
 
-        for (unsigned short i = 0; i < _height; ++i)
+        const bool premultiply = _premultiplyAlpha && _renderFormat == gfx::Format::RGBA8;
+        const bool isInterlaced = png_get_interlace_type(png_ptr, info_ptr) != PNG_INTERLACE_NONE;
+        if (isDownscaled)
+        {
+            // filtered down a row at a time, interlaced images only have complete rows after the last pass so
+            // they still go through a full size buffer
+            std::vector<unsigned char> source(isInterlaced ? rowbytes * _height : rowbytes);
+            if (isInterlaced)
+            {
+                for (int i = 0; i < _height; ++i)
+                {
+                    row_pointers[i] = source.data() + i*rowbytes;
+                }
+                png_read_image(png_ptr, row_pointers);
+            }
+
+            RowDownscaler downscaler(_width, _height, decodeWidth, decodeHeight, png_get_channels(png_ptr, info_ptr));
+            unsigned char *dst = _data;
+            for (int i = 0; i < _height; ++i)
+            {
+                unsigned char *row = isInterlaced ? row_pointers[i] : source.data();
+                if (!isInterlaced)
+                {
+                    png_read_row(png_ptr, row, nullptr);
+                }
+                // premultiplied before filtering, so transparent pixels don't bleed their color
+                if (premultiply)
+                {
+                    premultiplyAlpha(row, _width);
+                }
+                if (downscaler.addRow(row, dst))
+                {
+                    dst += decodeRowBytes;
+                }
+            }
+            _width = decodeWidth;
+            _height = decodeHeight;
+        }
+        else
         {
-            row_pointers[i] = _data + i*rowbytes;
+            for (unsigned short i = 0; i < _height; ++i)
+            {
+                row_pointers[i] = _data + i*rowbytes;
+            }
+            if (premultiply && !isInterlaced)
+            {
+                // each row is premultiplied while it is still in the cache
+                for (int i = 0; i < _height; ++i)
+                {
+                    png_read_row(png_ptr, row_pointers[i], nullptr);
+                    premultiplyAlpha(row_pointers[i], _width);
+                }
+            }
+            else
+            {
+                png_read_image(png_ptr, row_pointers);
+                if (premultiply)
+                {
+                    premultiplyAlpha(_data, static_cast<ssize_t>(_width) * _height);
+                }
+            }
         }
-        png_read_image(png_ptr, row_pointers);
+        _hasPremultipliedAlpha = premultiply;
         png_read_end(png_ptr, nullptr);
+        convertDecodedPixels();
 
         if (row_pointers != nullptr)
         {
@@ -796,6 +1314,53 @@ bool Image::initWithPngData(const unsigned char * data, ssize_t dataLen)
 #endif //CC_USE_PNG
 }
 
+void Image::setPlatformDecodeThreshold(int pixelCount)
+{
+    platformDecodeThreshold.store(std::max(pixelCount, 0), std::memory_order_relaxed);
+}
+
+int Image::getPlatformDecodeThreshold()
+{
+    return platformDecodeThreshold.load(std::memory_order_relaxed);
+}
+
+bool Image::initWithPlatformData(const unsigned char * data, ssize_t dataLen)
+{
+    // grayscale images stay L8 with libjpeg, the platform only decodes color
+    const int threshold = platformDecodeThreshold.load(std::memory_order_relaxed);
+    if (threshold <= 0 || getJpgComponentCount(data, dataLen) != 3)
+        return false;
+
+    std::unique_ptr<PlatformImageDecoder> decoder(PlatformImageDecoder::create(data, dataLen));
+    if (!decoder || static_cast<int64_t>(decoder->getWidth()) * decoder->getHeight() < threshold)
+        return false;
+
+    int decodeWidth = 0, decodeHeight = 0;
+    getDecodeSize(decoder->getWidth(), decoder->getHeight(), &decodeWidth, &decodeHeight);
+    if ((decodeWidth != decoder->getWidth() || decodeHeight != decoder->getHeight()) && !decoder->setTargetSize(decodeWidth, decodeHeight))
+        return false;
+
+    const size_t stride = static_cast<size_t>(decodeWidth) * 4;
+    if (!allocateData(static_cast<ssize_t>(stride) * decodeHeight))
+        return false;
+    float duration = 0.0f;
+    if (!decoder->decodeFrame(_data, stride, false, &duration))
+    {
+        releaseData();
+        return false;
+    }
+
+    // decoded as RGBA8, stripped to the RGB8 of libjpeg, converting trims the memory to it
+    _isCompressed = false;
+    _width = decodeWidth;
+    _height = decodeHeight;
+    stripAlpha(_data, static_cast<ssize_t>(decodeWidth) * decodeHeight, 4);
+    _renderFormat = gfx::Format::RGB8;
+    _dataLen = static_cast<ssize_t>(stride) * decodeHeight;
+    convertDecodedPixels();
+    return true;
+}
+
 bool Image::initWithPVRv2Data(const unsigned char * data, ssize_t dataLen)
 {
     int width = 0, height = 0;
@@ -916,7 +1481,7 @@ bool Image::initWithETCData(const unsigned char * data, ssize_t dataLen)
     _dataLen = dataLen - ETC_PKM_HEADER_SIZE;
     _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
     memcpy(_data, static_cast<const unsigned char*>(data) + ETC_PKM_HEADER_SIZE, _dataLen);
-    return true;
+    return decodeUnsupportedBlocks();
 }
 
 bool Image::initWithETC2Data(const unsigned char * data, ssize_t dataLen)
@@ -947,6 +1512,100 @@ bool Image::initWithETC2Data(const unsigned char * data, ssize_t dataLen)
     _dataLen = dataLen - ETC2_PKM_HEADER_SIZE;
     _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
     memcpy(_data, static_cast<const unsigned char*>(data) + ETC2_PKM_HEADER_SIZE, _dataLen);
+    return decodeUnsupportedBlocks();
+}
+
+bool Image::decodeUnsupportedBlocks()
+{
+    gfx::Feature feature = gfx::Feature::FORMAT_ETC2;
+    if (_renderFormat == gfx::Format::ETC_RGB8)
+        feature = gfx::Feature::FORMAT_ETC1;
+    else if (_renderFormat != gfx::Format::ETC2_RGB8 && _renderFormat != gfx::Format::ETC2_RGBA8)
+        return true;
+
+    const gfx::Device *device = gfx::Device::getInstance();
+    if (!device || device->hasFeature(feature))
+        return true;
+    if (feature == gfx::Feature::FORMAT_ETC1 && device->hasFeature(gfx::Feature::FORMAT_ETC2))
+    {
+        // ETC1 blocks are valid ETC2 RGB8 blocks
+        _renderFormat = gfx::Format::ETC2_RGB8;
+        return true;
+    }
+
+    const bool hasAlpha = _renderFormat == gfx::Format::ETC2_RGBA8;
+    const uint32_t channels = hasAlpha ? 4 : 3;
+    const uint32_t levelCount = static_cast<uint32_t>(std::max(_numberOfMipmaps, 1));
+    std::vector<ssize_t> srcOffsets(levelCount + 1, 0);
+    std::vector<ssize_t> dstOffsets(levelCount + 1, 0);
+    for (uint32_t i = 0; i < levelCount; ++i)
+    {
+        const uint32_t width = std::max(static_cast<uint32_t>(_width) >> i, 1u);
+        const uint32_t height = std::max(static_cast<uint32_t>(_height) >> i, 1u);
+        srcOffsets[i + 1] = srcOffsets[i] + gfx::FormatSize(_renderFormat, width, height, 1);
+        dstOffsets[i + 1] = dstOffsets[i] + static_cast<ssize_t>(width) * height * channels;
+    }
+    if (srcOffsets[levelCount] > _dataLen)
+    {
+        CC_LOG_DEBUG("decodeUnsupportedBlocks: WARNING: the data is shorter than its levels");
+        return false;
+    }
+
+    unsigned char *decoded = static_cast<unsigned char*>(malloc(dstOffsets[levelCount]));
+    if (!decoded)
+    {
+        return false;
+    }
+
+    // 16 block rows a task, enough to keep every thread of the pool busy on large levels
+    static const uint32_t BLOCK_ROWS_PER_TASK = 16;
+    struct Task
+    {
+        uint32_t level;
+        uint32_t firstBlockRow;
+        uint32_t lastBlockRow;
+    };
+    std::vector<Task> tasks;
+    for (uint32_t i = 0; i < levelCount; ++i)
+    {
+        const uint32_t blockRows = (std::max(static_cast<uint32_t>(_height) >> i, 1u) + 3) / 4;
+        for (uint32_t row = 0; row < blockRows; row += BLOCK_ROWS_PER_TASK)
+        {
+            tasks.push_back({i, row, std::min(row + BLOCK_ROWS_PER_TASK, blockRows)});
+        }
+    }
+
+    const auto decodeTask = [&](const Task &task) {
+        const uint32_t width = std::max(static_cast<uint32_t>(_width) >> task.level, 1u);
+        const uint32_t height = std::max(static_cast<uint32_t>(_height) >> task.level, 1u);
+        etc2_decode_image_rows(_data + srcOffsets[task.level], hasAlpha, width, height, task.firstBlockRow, task.lastBlockRow,
+                               decoded + dstOffsets[task.level], channels);
+    };
+
+    // the tasks go to the pool while this thread takes the first one
+    std::mutex mutex;
+    std::condition_variable condition;
+    size_t pendingTasks = tasks.size() - 1;
+    ThreadPool *threadPool = getDecodeThreadPool();
+    for (size_t i = 1; i < tasks.size(); ++i)
+    {
+        threadPool->pushTask([&, i](int /*threadId*/) {
+            decodeTask(tasks[i]);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!--pendingTasks) condition.notify_one();
+        });
+    }
+    decodeTask(tasks[0]);
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&]() { return !pendingTasks; });
+    }
+
+    releaseData();
+    _data = decoded;
+    _dataLen = dstOffsets[levelCount];
+    _renderFormat = hasAlpha ? gfx::Format::RGBA8 : gfx::Format::RGB8;
+    _isCompressed = false;
     return true;
 }
 
@@ -982,6 +1641,153 @@ bool Image::initWithASTCData(const unsigned char * data, ssize_t dataLen)
     return true;
 }
 
+bool Image::initWithKTX2Data(const unsigned char * data, ssize_t dataLen)
+{
+    KTX2Header header;
+    memcpy(&header, data, sizeof(KTX2Header));
+
+    // only 2D textures, cube maps, arrays and volumes are not supported
+    if (header.pixelDepth > 1 || header.layerCount > 1 || header.faceCount != 1 || !header.pixelWidth || !header.pixelHeight)
+    {
+        CC_LOG_DEBUG("initWithKTX2Data: WARNING: only 2D textures are supported");
+        return false;
+    }
+
+    const uint32_t levelCount = std::max(header.levelCount, 1u);
+    if (static_cast<size_t>(dataLen) < sizeof(KTX2Header) + levelCount * sizeof(KTX2LevelIndex))
+    {
+        return false;
+    }
+
+    if (header.supercompressionScheme == static_cast<uint32_t>(KTX2Supercompression::BASIS_LZ) || header.vkFormat == 0)
+    {
+#if CC_USE_BASISU
+        return transcodeKTX2Data(data, dataLen);
+#else
+        CC_LOG_DEBUG("initWithKTX2Data: WARNING: Basis Universal textures need CC_USE_BASISU");
+        return false;
+#endif // CC_USE_BASISU
+    }
+
+    if (header.supercompressionScheme != static_cast<uint32_t>(KTX2Supercompression::NONE))
+    {
+        CC_LOG_DEBUG("initWithKTX2Data: WARNING: unsupported supercompression scheme %u", header.supercompressionScheme);
+        return false;
+    }
+
+    auto it = ktx2_formathash.find(header.vkFormat);
+    if (it == ktx2_formathash.end())
+    {
+        CC_LOG_DEBUG("initWithKTX2Data: WARNING: unsupported VkFormat %u", header.vkFormat);
+        return false;
+    }
+
+    // the file stores the smallest level first, the data holds the largest one first
+    std::vector<KTX2LevelIndex> levels(levelCount);
+    memcpy(levels.data(), data + sizeof(KTX2Header), levelCount * sizeof(KTX2LevelIndex));
+    ssize_t totalLength = 0;
+    for (const auto &level : levels)
+    {
+        if (level.byteOffset + level.byteLength > static_cast<uint64_t>(dataLen))
+        {
+            return false;
+        }
+        totalLength += static_cast<ssize_t>(level.byteLength);
+    }
+
+    _width = header.pixelWidth;
+    _height = header.pixelHeight;
+    _numberOfMipmaps = levelCount;
+    _renderFormat = it->second;
+    _isCompressed = gfx::GFX_FORMAT_INFOS[static_cast<uint>(_renderFormat)].isCompressed;
+
+    _dataLen = totalLength;
+    _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
+    unsigned char *dst = _data;
+    for (const auto &level : levels)
+    {
+        memcpy(dst, data + level.byteOffset, level.byteLength);
+        dst += level.byteLength;
+    }
+
+    return decodeUnsupportedBlocks();
+}
+
+#if CC_USE_BASISU
+bool Image::transcodeKTX2Data(const unsigned char * data, ssize_t dataLen)
+{
+    static std::once_flag initFlag;
+    std::call_once(initFlag, basist::basisu_transcoder_init);
+
+    basist::ktx2_transcoder transcoder;
+    if (!transcoder.init(data, static_cast<uint32_t>(dataLen)) || !transcoder.start_transcoding())
+    {
+        CC_LOG_DEBUG("transcodeKTX2Data: WARNING: invalid Basis Universal data");
+        return false;
+    }
+
+    const uint32_t width = transcoder.get_width();
+    const uint32_t height = transcoder.get_height();
+    const uint32_t levelCount = std::max(transcoder.get_levels(), 1u);
+    gfx::Format renderFormat = gfx::Format::UNKNOWN;
+    const auto target = selectTranscodeTarget(transcoder.get_has_alpha(), width, height, renderFormat);
+    const uint32_t unitSize = basist::basis_get_bytes_per_block_or_pixel(target);
+
+    std::vector<uint32_t> offsets(levelCount + 1, 0);
+    for (uint32_t i = 0; i < levelCount; ++i)
+    {
+        offsets[i + 1] = offsets[i] + gfx::FormatSize(renderFormat, std::max(width >> i, 1u), std::max(height >> i, 1u), 1);
+    }
+    unsigned char *levelData = static_cast<unsigned char*>(malloc(offsets[levelCount]));
+    if (!levelData)
+    {
+        return false;
+    }
+
+    const auto transcodeLevel = [&](uint32_t level) {
+        // the state keeps the transcoder thread safe across levels
+        basist::ktx2_transcoder_state state;
+        return transcoder.transcode_image_level(level, 0, 0, levelData + offsets[level], (offsets[level + 1] - offsets[level]) / unitSize, target, 0, 0, 0, -1, -1, &state);
+    };
+
+    // the smaller levels go to the pool while this thread transcodes the largest one
+    std::mutex mutex;
+    std::condition_variable condition;
+    uint32_t pendingLevels = levelCount - 1;
+    std::atomic<bool> succeeded(true);
+    ThreadPool *threadPool = getDecodeThreadPool();
+    for (uint32_t i = 1; i < levelCount; ++i)
+    {
+        threadPool->pushTask([&, i](int /*threadId*/) {
+            if (!transcodeLevel(i)) succeeded = false;
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!--pendingLevels) condition.notify_one();
+        });
+    }
+    if (!transcodeLevel(0)) succeeded = false;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&]() { return !pendingLevels; });
+    }
+
+    if (!succeeded)
+    {
+        CC_LOG_DEBUG("transcodeKTX2Data: WARNING: failed to transcode the levels");
+        free(levelData);
+        return false;
+    }
+
+    _width = width;
+    _height = height;
+    _numberOfMipmaps = levelCount;
+    _renderFormat = renderFormat;
+    _isCompressed = renderFormat != gfx::Format::RGBA8;
+    _dataLen = offsets[levelCount];
+    _data = levelData;
+    return true;
+}
+#endif // CC_USE_BASISU
+
 bool Image::initWithPVRData(const unsigned char * data, ssize_t dataLen)
 {
     return initWithPVRv2Data(data, dataLen) || initWithPVRv3Data(data, dataLen);
@@ -1001,12 +1807,19 @@ bool Image::initWithWebpData(const unsigned char * data, ssize_t dataLen)
         
         config.output.colorspace = config.input.has_alpha?MODE_rgbA:MODE_RGB;
         _renderFormat = config.input.has_alpha ? gfx::Format::RGBA8 : gfx::Format::RGB8;
-        _width    = config.input.width;
-        _height   = config.input.height;
+        getDecodeSize(config.input.width, config.input.height, &_width, &_height);
         _isCompressed = false;
+        if (_width != config.input.width || _height != config.input.height)
+        {
+            config.options.use_scaling = 1;
+            config.options.scaled_width = _width;
+            config.options.scaled_height = _height;
+        }
         
         _dataLen = _width * _height * (config.input.has_alpha?4:3);
-        _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
+        if (!allocateData(_dataLen)) break;
+        // MODE_rgbA premultiplies while decoding
+        _hasPremultipliedAlpha = config.input.has_alpha;
         
         config.output.u.RGBA.rgba = static_cast<uint8_t*>(_data);
         config.output.u.RGBA.stride = _width * (config.input.has_alpha?4:3);
@@ -1015,10 +1828,10 @@ bool Image::initWithWebpData(const unsigned char * data, ssize_t dataLen)
         
         if (WebPDecode(static_cast<const uint8_t*>(data), dataLen, &config) != VP8_STATUS_OK)
         {
-            free(_data);
-            _data = nullptr;
+            releaseData();
             break;
         }
+        convertDecodedPixels();
         
         ret = true;
     } while (0);
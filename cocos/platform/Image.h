@@ -24,7 +24,9 @@ THE SOFTWARE.
 ****************************************************************************/
 #pragma once
 
+#include "base/Config.h"
 #include "base/Ref.h"
+#include <functional>
 #include <string>
 #include <map>
 
@@ -54,6 +56,8 @@ public:
         ETC2,
         //! ASTC
         ASTC,
+        //! KTX2, Basis Universal supercompressed ones are transcoded
+        KTX2,
         //! Raw Data
         RAW_DATA,
         //! Unknown format
@@ -61,6 +65,12 @@ public:
     };
 
 
+    /**
+     * Returns the memory PNG, JPEG and WebP images are decoded into, which stays owned by the caller.
+     * Returning nullptr fails the decode.
+     */
+    typedef std::function<unsigned char *(ssize_t size)> DataAllocator;
+
     bool initWithImageFile(const std::string &path);
     bool initWithImageData(const unsigned char *data, ssize_t dataLen);
 
@@ -79,30 +89,79 @@ public:
     inline gfx::Format getRenderFormat() const { return _renderFormat; }
     inline int getWidth() const { return _width; }
     inline int getHeight() const { return _height; }
+    // levels stored in the data one after another, largest first
+    inline int getNumberOfMipmaps() const { return _numberOfMipmaps; }
     inline std::string getFilePath() const { return _filePath; }
 
     inline bool isCompressed() const { return _isCompressed; }
 
+    // set before init, decodes straight into the memory of the allocator instead of a buffer of the image
+    inline void setDataAllocator(const DataAllocator &allocator) { _dataAllocator = allocator; }
+    // set before init, RGBA PNG images are premultiplied while their rows are decoded
+    inline void setPremultiplyAlpha(bool premultiply) { _premultiplyAlpha = premultiply; }
+    inline bool hasPremultipliedAlpha() const { return _hasPremultipliedAlpha; }
+    // set before init, JPEG, PNG and WebP images larger than this are downscaled while they are decoded, keeping
+    // their aspect ratio, 0 leaves a dimension unbounded
+    inline void setMaxDecodeSize(int maxWidth, int maxHeight) { _maxDecodeWidth = maxWidth; _maxDecodeHeight = maxHeight; }
+    // set before init, decoded RGB8 images are packed to R5G6B5 and RGBA8 ones to RGBA4
+    inline void setPackPixels(bool pack) { _packPixels = pack; }
+    // set before init, decoded images whose alpha is opaque everywhere drop the channel
+    inline void setStripOpaqueAlpha(bool strip) { _stripOpaqueAlpha = strip; }
+
+    // premultiplies tightly packed RGBA8 pixels in place
+    static void premultiplyAlpha(unsigned char *pixels, ssize_t pixelCount);
+    // the size width x height is decoded at within a max decode size, see setMaxDecodeSize
+    static void fitDecodeSize(int width, int height, int maxWidth, int maxHeight, int *decodeWidth, int *decodeHeight);
+    /**
+     * Color JPEG images of at least this many pixels are decoded by the codecs of the platform, which use the
+     * hardware decoder where there is one, see PlatformImageDecoder. 0, the default, decodes all with libjpeg.
+     */
+    static void setPlatformDecodeThreshold(int pixelCount);
+    static int getPlatformDecodeThreshold();
+
 protected:
     bool initWithJpgData(const unsigned char *data, ssize_t dataLen);
     bool initWithPngData(const unsigned char *data, ssize_t dataLen);
     bool initWithWebpData(const unsigned char *data, ssize_t dataLen);
+    bool initWithPlatformData(const unsigned char *data, ssize_t dataLen);
     bool initWithPVRData(const unsigned char *data, ssize_t dataLen);
     bool initWithPVRv2Data(const unsigned char *data, ssize_t dataLen);
     bool initWithPVRv3Data(const unsigned char *data, ssize_t dataLen);
     bool initWithETCData(const unsigned char *data, ssize_t dataLen);
     bool initWithETC2Data(const unsigned char *data, ssize_t dataLen);
     bool initWithASTCData(const unsigned char * data, ssize_t dataLen);
+    bool initWithKTX2Data(const unsigned char * data, ssize_t dataLen);
+#if CC_USE_BASISU
+    bool transcodeKTX2Data(const unsigned char * data, ssize_t dataLen);
+#endif
 
 protected:
     unsigned char *_data = nullptr;
     ssize_t _dataLen = 0;
     int _width = 0;
     int _height = 0;
+    int _numberOfMipmaps = 1;
     Format _fileType = Format::UNKNOWN;
     gfx::Format _renderFormat;
     std::string _filePath;
     bool _isCompressed = false;
+    bool _ownsData = true;
+    bool _premultiplyAlpha = false;
+    bool _hasPremultipliedAlpha = false;
+    bool _packPixels = false;
+    bool _stripOpaqueAlpha = false;
+    int _maxDecodeWidth = 0;
+    int _maxDecodeHeight = 0;
+    DataAllocator _dataAllocator = nullptr;
+
+    unsigned char *allocateData(ssize_t size);
+    void releaseData();
+    // the size the max decode size lets width x height be decoded at
+    void getDecodeSize(int width, int height, int *decodeWidth, int *decodeHeight) const;
+    // strips opaque alpha and packs the decoded 8 bit pixels as asked for
+    void convertDecodedPixels();
+    // decodes ETC levels the device can't sample to RGB8 or RGBA8, spread over the decode threads
+    bool decodeUnsupportedBlocks();
 
 protected:
     // noncopyable
@@ -123,6 +182,7 @@ protected:
     bool isEtc(const unsigned char *data, ssize_t dataLen);
     bool isEtc2(const unsigned char *data, ssize_t dataLen);
     bool isASTC(const unsigned char * data, ssize_t detaLen);
+    bool isKtx2(const unsigned char * data, ssize_t dataLen);
 
     gfx::Format getASTCFormat(const unsigned char * pHeader) const;
 };
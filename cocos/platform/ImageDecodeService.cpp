@@ -0,0 +1,178 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "platform/ImageDecodeService.h"
+#include "base/Log.h"
+#include "base/ThreadPool.h"
+#include "renderer/core/Core.h"
+#include <algorithm>
+#include <thread>
+
+namespace cc {
+
+ImageDecodeService::ImageDecodeService() {
+}
+
+ImageDecodeService::~ImageDecodeService() {
+    destroy();
+}
+
+bool ImageDecodeService::initialize(int threadCount) {
+    if (_threadPool) return true;
+    if (threadCount <= 0) threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    _threadPool = ThreadPool::newFixedThreadPool(threadCount);
+    return _threadPool != nullptr;
+}
+
+void ImageDecodeService::destroy() {
+    // waits for the queued decodes
+    CC_SAFE_DELETE(_threadPool);
+
+    for (auto *task : _finishedTasks) {
+        task->callback = nullptr;
+        finish(task);
+    }
+    _finishedTasks.clear();
+    _pendingCount = 0;
+
+    for (const auto &buffer : _freeStagingBuffers) free(buffer.data);
+    _freeStagingBuffers.clear();
+    _freeStagingSize = 0;
+}
+
+void ImageDecodeService::decode(const std::string &path, const DecodeCallback &callback, const Image::DataAllocator &allocator, bool premultiplyAlpha) {
+    auto *task = new Task();
+    task->path = path;
+    task->callback = callback;
+    pushTask(task, allocator, premultiplyAlpha);
+}
+
+void ImageDecodeService::decodeToTexture(const std::string &path, gfx::Texture *texture, gfx::Fence *fence, bool premultiplyAlpha, const DecodeCallback &callback) {
+    auto *task = new Task();
+    task->path = path;
+    task->callback = callback;
+    task->texture = texture;
+    task->fence = fence;
+    const auto allocator = [this, task](ssize_t size) {
+        task->staging = acquireStagingBuffer(size);
+        return task->staging.data;
+    };
+    pushTask(task, allocator, premultiplyAlpha);
+}
+
+void ImageDecodeService::pushTask(Task *task, const Image::DataAllocator &allocator, bool premultiplyAlpha) {
+    if (!_threadPool) {
+        CC_LOG_ERROR("ImageDecodeService: decode of %s requested before initialize.", task->path.c_str());
+        delete task;
+        return;
+    }
+
+    ++_pendingCount;
+    _threadPool->pushTask([this, task, allocator, premultiplyAlpha](int /*threadId*/) {
+        task->image = new Image();
+        task->image->setDataAllocator(allocator);
+        task->image->setPremultiplyAlpha(premultiplyAlpha);
+        task->isLoaded = task->image->initWithImageFile(task->path);
+
+        std::lock_guard<std::mutex> lock(_taskMutex);
+        _finishedTasks.push_back(task);
+    });
+}
+
+ImageDecodeService::StagingBuffer ImageDecodeService::acquireStagingBuffer(ssize_t size) {
+    {
+        // the smallest free buffer which is large enough
+        std::lock_guard<std::mutex> lock(_stagingMutex);
+        auto best = _freeStagingBuffers.end();
+        for (auto iter = _freeStagingBuffers.begin(); iter != _freeStagingBuffers.end(); ++iter) {
+            if (iter->size >= size && (best == _freeStagingBuffers.end() || iter->size < best->size)) best = iter;
+        }
+        if (best != _freeStagingBuffers.end()) {
+            const StagingBuffer buffer = *best;
+            _freeStagingBuffers.erase(best);
+            _freeStagingSize -= buffer.size;
+            return buffer;
+        }
+    }
+
+    StagingBuffer buffer;
+    buffer.data = static_cast<unsigned char *>(malloc(size));
+    buffer.size = buffer.data ? size : 0;
+    return buffer;
+}
+
+void ImageDecodeService::releaseStagingBuffer(const StagingBuffer &buffer) {
+    if (!buffer.data) return;
+
+    std::lock_guard<std::mutex> lock(_stagingMutex);
+    if (_freeStagingSize + buffer.size > MAX_FREE_STAGING_SIZE) {
+        free(buffer.data);
+        return;
+    }
+    _freeStagingBuffers.push_back(buffer);
+    _freeStagingSize += buffer.size;
+}
+
+void ImageDecodeService::upload(Task *task) {
+    auto *image = task->image;
+    auto *texture = task->texture;
+    if (image->getRenderFormat() != texture->getFormat()) {
+        CC_LOG_ERROR("ImageDecodeService: %s doesn't match the format of its texture.", task->path.c_str());
+        task->isLoaded = false;
+        return;
+    }
+
+    const uint width = static_cast<uint>(image->getWidth());
+    const uint height = static_cast<uint>(image->getHeight());
+    if (texture->getWidth() != width || texture->getHeight() != height) texture->resize(width, height);
+
+    // the device stages the pixels before returning, the staging memory is free again right after
+    gfx::BufferTextureCopy region;
+    region.texExtent.width = width;
+    region.texExtent.height = height;
+    const uint8_t *buffer = image->getData();
+    gfx::Device::getInstance()->copyBuffersToTextureAsync(&buffer, texture, &region, 1, task->fence);
+}
+
+void ImageDecodeService::finish(Task *task) {
+    if (task->callback) task->callback(task->isLoaded ? task->image : nullptr);
+    CC_SAFE_RELEASE(task->image);
+    releaseStagingBuffer(task->staging);
+    delete task;
+}
+
+void ImageDecodeService::update() {
+    {
+        std::lock_guard<std::mutex> lock(_taskMutex);
+        _deliveredTasks.swap(_finishedTasks);
+    }
+
+    for (auto *task : _deliveredTasks) {
+        if (task->texture && task->isLoaded) upload(task);
+        finish(task);
+        --_pendingCount;
+    }
+    _deliveredTasks.clear();
+}
+
+} // namespace cc
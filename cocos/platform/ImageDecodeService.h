@@ -0,0 +1,109 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#pragma once
+
+#include "platform/Image.h"
+#include <mutex>
+#include <vector>
+
+namespace cc {
+
+class ThreadPool;
+
+namespace gfx {
+class Fence;
+class Texture;
+} // namespace gfx
+
+/**
+ * Decodes images on a pool of worker threads, many of them at once.
+ * Pixels are decoded straight into the memory of an allocator, or into staging memory of the service
+ * which feeds Device::copyBuffersToTextureAsync, so no decode copies the pixels afterwards.
+ */
+class CC_DLL ImageDecodeService {
+public:
+    // Runs on the thread calling update(), the image is nullptr if the file failed to load or upload.
+    typedef std::function<void(Image *image)> DecodeCallback;
+
+    // staging memory kept for later decodes once it was uploaded
+    static const ssize_t MAX_FREE_STAGING_SIZE = 64 * 1024 * 1024;
+
+    ImageDecodeService();
+    ~ImageDecodeService();
+
+    // threadCount 0 uses every core but one
+    bool initialize(int threadCount = 0);
+    // waits for the running decodes, the finished ones are dropped without their callbacks
+    void destroy();
+
+    /**
+     * Decodes an image file, an allocator returns the memory to decode into, which stays owned by the caller.
+     * RGBA PNG images are premultiplied in the decoding pass if asked, WebP ones always are.
+     */
+    void decode(const std::string &path, const DecodeCallback &callback, const Image::DataAllocator &allocator = nullptr, bool premultiplyAlpha = false);
+    /**
+     * Decodes an image file into staging memory and uploads it asynchronously, the fence is signaled once the
+     * texture can be sampled. The texture is resized to the image and has to have its format.
+     */
+    void decodeToTexture(const std::string &path, gfx::Texture *texture, gfx::Fence *fence, bool premultiplyAlpha = false, const DecodeCallback &callback = nullptr);
+
+    // Uploads and delivers the finished decodes, once a frame.
+    void update();
+    inline size_t getPendingCount() const { return _pendingCount; }
+
+private:
+    struct StagingBuffer {
+        unsigned char *data = nullptr;
+        ssize_t size = 0;
+    };
+
+    struct Task {
+        std::string path;
+        Image *image = nullptr;
+        DecodeCallback callback;
+        gfx::Texture *texture = nullptr;
+        gfx::Fence *fence = nullptr;
+        StagingBuffer staging;
+        bool isLoaded = false;
+    };
+
+    void pushTask(Task *task, const Image::DataAllocator &allocator, bool premultiplyAlpha);
+    StagingBuffer acquireStagingBuffer(ssize_t size);
+    void releaseStagingBuffer(const StagingBuffer &buffer);
+    void upload(Task *task);
+    void finish(Task *task);
+
+    ThreadPool *_threadPool = nullptr;
+    size_t _pendingCount = 0;
+
+    std::mutex _taskMutex;
+    std::vector<Task *> _finishedTasks;
+    std::vector<Task *> _deliveredTasks;
+
+    std::mutex _stagingMutex;
+    std::vector<StagingBuffer> _freeStagingBuffers;
+    ssize_t _freeStagingSize = 0;
+};
+
+} // namespace cc
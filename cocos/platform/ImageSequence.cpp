@@ -0,0 +1,172 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/ImageSequence.h"
+#include "platform/FileUtils.h"
+#include "platform/Image.h"
+#include "platform/PlatformImageDecoder.h"
+#include "renderer/core/Core.h"
+#include <algorithm>
+
+namespace cc {
+
+namespace {
+// what browsers show the frames of a shorter delay for
+constexpr float MIN_FRAME_DURATION = 0.011f;
+constexpr float DEFAULT_FRAME_DURATION = 0.1f;
+} // namespace
+
+ImageSequence::ImageSequence() = default;
+
+ImageSequence::~ImageSequence() {
+    delete _decoder;
+}
+
+bool ImageSequence::initWithImageFile(const std::string &path) {
+    _source = FileUtils::getInstance()->getDataFromFile(path);
+    return !_source.isNull() && (initWithDecoder() || initWithImage());
+}
+
+bool ImageSequence::initWithImageData(const unsigned char *data, ssize_t dataLen) {
+    if (!data || dataLen <= 0) return false;
+    _source.copy(data, dataLen);
+    return initWithDecoder() || initWithImage();
+}
+
+bool ImageSequence::initWithDecoder() {
+    _decoder = PlatformImageDecoder::create(_source.getBytes(), _source.getSize());
+    if (!_decoder) return false;
+
+    Image::fitDecodeSize(_decoder->getWidth(), _decoder->getHeight(), _maxDecodeWidth, _maxDecodeHeight, &_width, &_height);
+    if ((_width != _decoder->getWidth() || _height != _decoder->getHeight()) && !_decoder->setTargetSize(_width, _height)) {
+        _width = _decoder->getWidth();
+        _height = _decoder->getHeight();
+    }
+    _isAnimated = _decoder->isAnimated();
+    _repeatsLeft = _decoder->getRepeatCount();
+    _hasPremultipliedAlpha = _premultiplyAlpha;
+    _frame.assign(static_cast<size_t>(_width) * _height * 4, 0);
+    if (decodeFrame()) return true;
+
+    delete _decoder;
+    _decoder = nullptr;
+    return false;
+}
+
+bool ImageSequence::initWithImage() {
+    auto *image = new Image();
+    image->setMaxDecodeSize(_maxDecodeWidth, _maxDecodeHeight);
+    image->setPremultiplyAlpha(_premultiplyAlpha);
+    bool ret = false;
+    if (image->initWithImageData(_source.getBytes(), _source.getSize())) {
+        const ssize_t pixelCount = static_cast<ssize_t>(image->getWidth()) * image->getHeight();
+        const unsigned char *data = image->getData();
+        if (image->getRenderFormat() == gfx::Format::RGBA8) {
+            _frame.assign(data, data + pixelCount * 4);
+            _hasPremultipliedAlpha = image->hasPremultipliedAlpha();
+            if (_premultiplyAlpha && !_hasPremultipliedAlpha) {
+                Image::premultiplyAlpha(_frame.data(), pixelCount);
+                _hasPremultipliedAlpha = true;
+            }
+            ret = true;
+        } else if (image->getRenderFormat() == gfx::Format::RGB8) {
+            _frame.resize(pixelCount * 4);
+            for (ssize_t i = 0; i < pixelCount; ++i) {
+                std::copy(data + i * 3, data + i * 3 + 3, &_frame[i * 4]);
+                _frame[i * 4 + 3] = 255;
+            }
+            _hasPremultipliedAlpha = _premultiplyAlpha;
+            ret = true;
+        }
+        _width = image->getWidth();
+        _height = image->getHeight();
+    }
+    image->release();
+    // a still image keeps no data to decode from
+    _source.clear();
+    _isAnimated = false;
+    return ret;
+}
+
+bool ImageSequence::decodeFrame() {
+    float duration = 0.0f;
+    if (!_decoder->decodeFrame(_frame.data(), static_cast<size_t>(_width) * 4, _premultiplyAlpha, &duration)) return false;
+    _frameDuration = duration < MIN_FRAME_DURATION ? DEFAULT_FRAME_DURATION : duration;
+    return true;
+}
+
+bool ImageSequence::advanceFrame() {
+    if (_decoder->advanceFrame()) return true;
+    if (_repeatsLeft == 0 || !_decoder->rewind()) {
+        _isFinished = true;
+        return false;
+    }
+    if (_repeatsLeft != PlatformImageDecoder::INFINITE_REPEAT) --_repeatsLeft;
+    return true;
+}
+
+bool ImageSequence::update(float dt) {
+    if (!isAnimated() || _isFinished) return false;
+
+    _frameTime += dt;
+    int decodedCount = 0;
+    while (_frameTime >= _frameDuration && !_isFinished) {
+        if (decodedCount == MAX_FRAMES_PER_UPDATE) {
+            _frameTime = 0.0f;
+            break;
+        }
+        _frameTime -= _frameDuration;
+        if (!advanceFrame()) break;
+        if (!decodeFrame()) {
+            _isFinished = true;
+            break;
+        }
+        ++decodedCount;
+    }
+    return decodedCount > 0;
+}
+
+bool ImageSequence::restart() {
+    if (!isAnimated() || !_decoder->rewind()) return false;
+    _repeatsLeft = _decoder->getRepeatCount();
+    _isFinished = false;
+    _frameTime = 0.0f;
+    return decodeFrame();
+}
+
+void ImageSequence::copyToTexture(gfx::Texture *texture) const {
+    if (_frame.empty() || texture->getFormat() != gfx::Format::RGBA8) return;
+
+    const uint width = static_cast<uint>(_width);
+    const uint height = static_cast<uint>(_height);
+    if (texture->getWidth() != width || texture->getHeight() != height) texture->resize(width, height);
+
+    gfx::BufferTextureCopy region;
+    region.texExtent.width = width;
+    region.texExtent.height = height;
+    const uint8_t *buffer = _frame.data();
+    gfx::Device::getInstance()->copyBuffersToTexture(&buffer, texture, &region, 1);
+}
+
+} // namespace cc
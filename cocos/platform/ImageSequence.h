@@ -0,0 +1,107 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "base/Data.h"
+#include "base/Ref.h"
+#include <string>
+#include <vector>
+
+namespace cc {
+
+namespace gfx {
+class Texture;
+} // namespace gfx
+
+class PlatformImageDecoder;
+
+/**
+ * Plays animated PNG, WebP and GIF images. The codecs of the platform decode one frame at a time straight into an
+ * RGBA8 frame buffer, which is uploaded to textures as it is, see PlatformImageDecoder. Where the platform has no
+ * decoder for the image, Image decodes its first frame and the sequence holds still.
+ */
+class CC_DLL ImageSequence : public Ref {
+public:
+    // frames decoded at most by one update, a late update skips the time beyond them
+    static const int MAX_FRAMES_PER_UPDATE = 4;
+
+    ImageSequence();
+
+    bool initWithImageFile(const std::string &path);
+    // the data is copied, the frames are decoded from it while the sequence plays
+    bool initWithImageData(const unsigned char *data, ssize_t dataLen);
+
+    // set before init, frames larger than this are downscaled while they are decoded, see Image::setMaxDecodeSize
+    inline void setMaxDecodeSize(int maxWidth, int maxHeight) { _maxDecodeWidth = maxWidth; _maxDecodeHeight = maxHeight; }
+    // set before init, the frames are premultiplied while they are decoded
+    inline void setPremultiplyAlpha(bool premultiply) { _premultiplyAlpha = premultiply; }
+
+    inline int getWidth() const { return _width; }
+    inline int getHeight() const { return _height; }
+    // the current frame, RGBA8 rows of getWidth() pixels
+    inline const unsigned char *getData() const { return _frame.data(); }
+    inline ssize_t getDataLen() const { return static_cast<ssize_t>(_frame.size()); }
+    inline bool hasPremultipliedAlpha() const { return _hasPremultipliedAlpha; }
+    inline bool isAnimated() const { return _decoder && _isAnimated; }
+    // the animation played all its repeats and holds the last frame
+    inline bool isFinished() const { return _isFinished; }
+    // seconds the current frame is shown
+    inline float getFrameDuration() const { return _frameDuration; }
+
+    /**
+     * Advances the playback by dt seconds and decodes the frames which were due.
+     * @return whether the current frame changed.
+     */
+    bool update(float dt);
+    // plays the animation from its first frame again
+    bool restart();
+    // copies the current frame into a RGBA8 texture of the size of the sequence
+    void copyToTexture(gfx::Texture *texture) const;
+
+protected:
+    virtual ~ImageSequence();
+
+    bool initWithDecoder();
+    bool initWithImage();
+    bool decodeFrame();
+    bool advanceFrame();
+
+    Data _source;
+    PlatformImageDecoder *_decoder = nullptr;
+    std::vector<unsigned char> _frame;
+    int _width = 0;
+    int _height = 0;
+    int _maxDecodeWidth = 0;
+    int _maxDecodeHeight = 0;
+    bool _premultiplyAlpha = false;
+    bool _hasPremultipliedAlpha = false;
+    bool _isAnimated = false;
+    bool _isFinished = false;
+    int _repeatsLeft = 0;
+    float _frameDuration = 0.0f;
+    float _frameTime = 0.0f;
+};
+
+} // namespace cc
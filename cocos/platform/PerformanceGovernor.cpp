@@ -0,0 +1,112 @@
+#include "platform/PerformanceGovernor.h"
+
+#include "base/Log.h"
+#include "base/ThreadConfig.h"
+#include "platform/Application.h"
+
+#include <algorithm>
+
+namespace cc {
+namespace {
+// the readings are polled once a second, the thermal headroom can't be asked more often
+const float POLL_INTERVAL = 1.0F;
+// a level is kept this long after the readings went lower, so that it doesn't flip with each reading
+const float RECOVERY_TIME = 30.0F;
+const int HEADROOM_FORECAST_SECONDS = 10;
+// the forecast headroom where the device throttles in a while, and where it's close to
+const float HEADROOM_SERIOUS = 1.0F;
+const float HEADROOM_FAIR = 0.85F;
+
+const char *const LEVEL_NAMES[] = {"NOMINAL", "FAIR", "SERIOUS", "CRITICAL"};
+} // namespace
+
+PerformanceGovernor::PerformanceGovernor() = default;
+
+PerformanceGovernor::~PerformanceGovernor() = default;
+
+void PerformanceGovernor::setEnabled(bool enabled) {
+    if (enabled == _enabled) return;
+    _enabled = enabled;
+    _pollTime = POLL_INTERVAL;
+    _recoveryTime = 0.0F;
+    if (!enabled) {
+        setLevel(Level::NOMINAL);
+    }
+}
+
+void PerformanceGovernor::update(float dt, int64_t workNS, int64_t targetNS) {
+    updateHint(workNS, targetNS);
+    if (!_enabled) return;
+
+    _pollTime += dt;
+    if (_pollTime < POLL_INTERVAL) return;
+    const float elapsed = _pollTime;
+    _pollTime = 0.0F;
+
+    const Level reading = readLevel();
+    if (reading > _level) {
+        _recoveryTime = 0.0F;
+        setLevel(reading);
+    } else if (reading < _level) {
+        _recoveryTime += elapsed;
+        if (_recoveryTime >= RECOVERY_TIME) {
+            _recoveryTime = 0.0F;
+            setLevel(static_cast<Level>(static_cast<int>(_level) - 1));
+        }
+    } else {
+        _recoveryTime = 0.0F;
+    }
+}
+
+void PerformanceGovernor::updateHint(int64_t workNS, int64_t targetNS) {
+    PerformanceHint::setFrameTarget(targetNS);
+
+    // the session covers the calling thread, the one running the frames, and the job workers it waits for; it's
+    // created again once they changed, a failed creation isn't retried before
+    const uint32_t generation = ThreadConfig::getThreadGeneration();
+    if (!_hintTargetNS || generation != _hintGeneration) {
+        std::vector<int32_t> threadIds = ThreadConfig::getThreadIds(ThreadLane::CPU);
+        threadIds.push_back(PerformanceHint::getCurrentThreadId());
+        _hint.reset();
+        _hint.reset(PerformanceHint::create(threadIds, targetNS));
+        _hintTargetNS = targetNS;
+        _hintGeneration = generation;
+    }
+    if (_hint) {
+        if (targetNS != _hintTargetNS) {
+            _hint->setTarget(targetNS);
+            _hintTargetNS = targetNS;
+        }
+        _hint->report(workNS);
+    }
+}
+
+PerformanceGovernor::Level PerformanceGovernor::readLevel() const {
+    Level level = Device::getThermalState();
+
+    const float headroom = Device::getThermalHeadroom(HEADROOM_FORECAST_SECONDS);
+    if (headroom >= HEADROOM_SERIOUS) {
+        level = std::max(level, Level::SERIOUS);
+    } else if (headroom >= HEADROOM_FAIR) {
+        level = std::max(level, Level::FAIR);
+    }
+
+    // a negative level is unknown
+    const float battery = Device::getBatteryLevel();
+    if (battery >= 0.0F && battery < _lowBatteryLevel) {
+        level = std::max(level, Level::FAIR);
+    }
+    return level;
+}
+
+void PerformanceGovernor::setLevel(Level level) {
+    if (level == _level) return;
+    CC_LOG_INFO("Performance level %s -> %s", LEVEL_NAMES[static_cast<int>(_level)], LEVEL_NAMES[static_cast<int>(level)]);
+    _level = level;
+    auto *app = Application::getInstance();
+    if (app) {
+        app->setFramesPerSecondLimit(level >= Level::SERIOUS ? _frameRateLimit : 0);
+    }
+}
+
+} // namespace cc
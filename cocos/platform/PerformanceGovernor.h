@@ -0,0 +1,55 @@
+#pragma once
+
+#include "base/Macros.h"
+#include "platform/Device.h"
+#include "platform/PerformanceHint.h"
+
+#include <cstdint>
+#include <memory>
+
+namespace cc {
+
+// Steps the load of the engine down while the device runs hot or its battery runs low, and back up a level at a
+// time once the readings stayed lower for a while. The thermal headroom forecast of Android steps down before the
+// device starts to throttle. From SERIOUS on the frame rate is limited, the pipeline lowers its resolution and
+// shadows by the level, see ForwardPipeline. The performance hint session of the main loop covers the frame
+// thread and the CPU lane of ThreadConfig, and is kept whether the governor is enabled or not.
+class CC_DLL PerformanceGovernor {
+public:
+    using Level = Device::ThermalState;
+
+    PerformanceGovernor();
+    ~PerformanceGovernor();
+
+    // The level stays NOMINAL while it's disabled.
+    void setEnabled(bool enabled);
+    CC_INLINE bool isEnabled() const { return _enabled; }
+    CC_INLINE Level getLevel() const { return _level; }
+
+    // The frame rate from SERIOUS on, 30 by default.
+    CC_INLINE void setFrameRateLimit(int fps) { _frameRateLimit = fps; }
+    CC_INLINE int getFrameRateLimit() const { return _frameRateLimit; }
+    // A battery below the level counts as FAIR, 0.2 by default, 0 ignores the battery.
+    CC_INLINE void setLowBatteryLevel(float level) { _lowBatteryLevel = level; }
+    CC_INLINE float getLowBatteryLevel() const { return _lowBatteryLevel; }
+
+    // Called by Application::tick() with the time the frame worked, without waiting for its start.
+    void update(float dt, int64_t workNS, int64_t targetNS);
+
+private:
+    void updateHint(int64_t workNS, int64_t targetNS);
+    Level readLevel() const;
+    void setLevel(Level level);
+
+    bool _enabled = false;
+    Level _level = Level::NOMINAL;
+    int _frameRateLimit = 30;
+    float _lowBatteryLevel = 0.2F;
+    float _pollTime = 0.0F;
+    float _recoveryTime = 0.0F;
+    std::unique_ptr<PerformanceHint> _hint;
+    int64_t _hintTargetNS = 0;
+    uint32_t _hintGeneration = 0;
+};
+
+} // namespace cc
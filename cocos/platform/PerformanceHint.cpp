@@ -0,0 +1,28 @@
+#include "platform/PerformanceHint.h"
+
+#include <atomic>
+
+namespace cc {
+namespace {
+std::atomic<int64_t> frameTargetNS{0};
+} // namespace
+
+#if CC_PLATFORM != CC_PLATFORM_ANDROID
+PerformanceHint *PerformanceHint::create(const std::vector<int32_t> & /*threadIds*/, int64_t /*targetNS*/) {
+    return nullptr;
+}
+
+int32_t PerformanceHint::getCurrentThreadId() {
+    return 0;
+}
+#endif
+
+void PerformanceHint::setFrameTarget(int64_t targetNS) {
+    frameTargetNS.store(targetNS, std::memory_order_relaxed);
+}
+
+int64_t PerformanceHint::getFrameTarget() {
+    return frameTargetNS.load(std::memory_order_relaxed);
+}
+
+} // namespace cc
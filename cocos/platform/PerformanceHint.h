@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace cc {
+
+// Tells the platform how long the frames of a group of threads work against their target, so that it runs the
+// cores no faster than needed and boosts them before a frame misses it. The performance hint sessions of
+// Android 13.
+class PerformanceHint {
+public:
+    // nullptr where the platform takes no hints, the threads are kernel ids as of getCurrentThreadId()
+    static PerformanceHint *create(const std::vector<int32_t> &threadIds, int64_t targetNS);
+    // 0 where the platform takes no hints
+    static int32_t getCurrentThreadId();
+
+    // The target of the frames of the main loop, published by Application::tick() for the sessions of the other
+    // threads which work on the frames, such as the render thread. 0 before the first frame.
+    static void setFrameTarget(int64_t targetNS);
+    static int64_t getFrameTarget();
+
+    virtual ~PerformanceHint() = default;
+
+    virtual void setTarget(int64_t targetNS) = 0;
+    virtual void report(int64_t workNS) = 0;
+};
+
+} // namespace cc
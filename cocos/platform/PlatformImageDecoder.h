@@ -0,0 +1,75 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "base/Macros.h"
+#include <cstddef>
+#include <stdint.h> // for ssize_t on android
+#include <string>   // for ssize_t on linux
+
+namespace cc {
+
+/**
+ * Decodes PNG, JPEG, WebP and GIF images and the frames of animated ones with the codecs of the platform, which
+ * use the hardware JPEG decoder where there is one: AImageDecoder of Android 11, animations need Android 12, and
+ * ImageIO on iOS and macOS. Frames are decoded as RGBA8 rows straight into the memory of the caller.
+ */
+class PlatformImageDecoder {
+public:
+    // Repeats of an animation which loops forever.
+    static const int INFINITE_REPEAT = -1;
+
+    // nullptr where the platform has no decoder for the data, which has to outlive the decoder
+    static PlatformImageDecoder *create(const unsigned char *data, ssize_t dataLen);
+
+    virtual ~PlatformImageDecoder() = default;
+
+    // the size frames are decoded at, the size of the image until setTargetSize
+    inline int getWidth() const { return _width; }
+    inline int getHeight() const { return _height; }
+    inline bool isAnimated() const { return _isAnimated; }
+    // how often the animation is played after the first time, INFINITE_REPEAT if it loops forever
+    inline int getRepeatCount() const { return _repeatCount; }
+
+    // scales the frames decoded afterwards to the size, false if the decoder can't
+    virtual bool setTargetSize(int width, int height) = 0;
+    /**
+     * Decodes the current frame into rows of stride bytes and returns how long it's shown in seconds.
+     * A frame of an animation can be drawn over the previous one, so the memory has to hold the previous frame.
+     */
+    virtual bool decodeFrame(unsigned char *pixels, size_t stride, bool premultiplyAlpha, float *duration) = 0;
+    // moves to the next frame, false after the last one
+    virtual bool advanceFrame() = 0;
+    // moves back to the first frame
+    virtual bool rewind() = 0;
+
+protected:
+    int _width = 0;
+    int _height = 0;
+    bool _isAnimated = false;
+    int _repeatCount = 0;
+};
+
+} // namespace cc
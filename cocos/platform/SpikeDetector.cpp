@@ -0,0 +1,218 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/SpikeDetector.h"
+#include "base/Log.h"
+#include "base/Profiler.h"
+#include "platform/FileUtils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace cc {
+
+namespace {
+
+struct Event {
+    uint64_t time;
+    SpikeEventType type;
+    float value;
+};
+
+std::atomic<uint32_t> enabledDetectors{0};
+
+// the events of the last frames, the oldest are overwritten
+std::mutex eventMutex;
+Event events[SpikeDetector::MAX_EVENTS];
+uint32_t eventHead = 0;
+
+template <typename T>
+void append(std::vector<uint8_t> &bytes, T value) {
+    const size_t offset = bytes.size();
+    bytes.resize(offset + sizeof(T));
+    memcpy(bytes.data() + offset, &value, sizeof(T));
+}
+
+void appendName(std::vector<uint8_t> &bytes, const char *name) {
+    const auto length = static_cast<uint16_t>(std::min<size_t>(strlen(name), UINT16_MAX));
+    append(bytes, length);
+    bytes.insert(bytes.end(), name, name + length);
+}
+
+uint32_t toMicroseconds(uint64_t ns) {
+    return static_cast<uint32_t>(std::min<uint64_t>(ns / 1000, UINT32_MAX));
+}
+
+} // namespace
+
+SpikeDetector::SpikeDetector() = default;
+
+SpikeDetector::~SpikeDetector() {
+    setEnabled(false);
+}
+
+void SpikeDetector::setEnabled(bool enabled) {
+    if (_enabled == enabled) return;
+    _enabled = enabled;
+
+    if (enabled) {
+        if (enabledDetectors.fetch_add(1) == 0) Profiler::setRingEnabled(true);
+        _directory = FileUtils::getInstance()->getWritablePath() + "spikes/";
+        FileUtils::getInstance()->createDirectory(_directory);
+        reset();
+    } else if (enabledDetectors.fetch_sub(1) == 1) {
+        Profiler::setRingEnabled(false);
+    }
+}
+
+void SpikeDetector::setFrameCount(uint32_t count) {
+    _frameCount = std::max(1U, std::min(count, MAX_FRAMES));
+}
+
+void SpikeDetector::reset() {
+    _frameHead = 0;
+    _lastFrameEnd = 0;
+}
+
+void SpikeDetector::update(int64_t workNS) {
+    if (!_enabled) return;
+
+    const uint64_t now = Profiler::now();
+    if (!_lastFrameEnd) {
+        _lastFrameEnd = now;
+        return;
+    }
+
+    auto &frame = _frames[_frameHead % MAX_FRAMES];
+    frame.begin = _lastFrameEnd;
+    frame.end = now;
+    frame.workNS = static_cast<uint64_t>(std::max<int64_t>(workNS, 0));
+    for (uint8_t i = 0; i < static_cast<uint8_t>(FrameStat::COUNT); ++i) {
+        frame.counters[i] = FrameStats::get(static_cast<FrameStat>(i));
+    }
+    ++_frameHead;
+    _lastFrameEnd = now;
+
+    if (static_cast<int64_t>(frame.end - frame.begin) <= _thresholdNS) return;
+
+    ++_spikeCount;
+    if (_lastSnapshotTime && static_cast<int64_t>(now - _lastSnapshotTime) < _cooldownNS) return;
+    _lastSnapshotTime = now;
+    writeSnapshot();
+}
+
+void SpikeDetector::writeSnapshot() {
+    const uint32_t frameCount = std::min(_frameHead, _frameCount);
+    const uint32_t firstFrame = _frameHead - frameCount;
+    const uint64_t begin = _frames[firstFrame % MAX_FRAMES].begin;
+    const auto &spike = _frames[(_frameHead - 1) % MAX_FRAMES];
+
+    std::vector<Profiler::RingZone> zones;
+    Profiler::getRingZones(begin, &zones);
+
+    std::vector<Event> frameEvents;
+    {
+        std::lock_guard<std::mutex> lock(eventMutex);
+        const uint32_t count = std::min(eventHead, MAX_EVENTS);
+        for (uint32_t i = eventHead - count; i != eventHead; ++i) {
+            const auto &event = events[i % MAX_EVENTS];
+            if (event.time >= begin) frameEvents.push_back(event);
+        }
+    }
+
+    // zone names are literals or interned, their pointers identify them
+    std::unordered_map<const char *, uint16_t> nameIndices;
+    std::vector<const char *> names;
+    for (uint8_t i = 0; i < static_cast<uint8_t>(FrameStat::COUNT); ++i) {
+        names.push_back(FrameStats::getName(static_cast<FrameStat>(i)));
+    }
+    for (const auto &zone : zones) {
+        if (names.size() < UINT16_MAX && nameIndices.emplace(zone.name, static_cast<uint16_t>(names.size())).second) {
+            names.push_back(zone.name);
+        }
+    }
+
+    std::vector<uint8_t> bytes;
+    bytes.reserve(64 + frameCount * 64 + zones.size() * 12 + frameEvents.size() * 12);
+    append(bytes, FILE_MAGIC);
+    append(bytes, FILE_VERSION);
+    append(bytes, static_cast<uint16_t>(FrameStat::COUNT));
+    append(bytes, frameCount);
+    append(bytes, static_cast<uint32_t>(names.size()));
+    append(bytes, static_cast<uint32_t>(zones.size()));
+    append(bytes, static_cast<uint32_t>(frameEvents.size()));
+    append(bytes, toMicroseconds(static_cast<uint64_t>(_thresholdNS)));
+    append(bytes, _spikeCount);
+
+    for (const auto *name : names) appendName(bytes, name);
+
+    for (uint32_t i = firstFrame; i != _frameHead; ++i) {
+        const auto &frame = _frames[i % MAX_FRAMES];
+        append(bytes, toMicroseconds(frame.begin - begin));
+        append(bytes, toMicroseconds(frame.end - frame.begin));
+        append(bytes, toMicroseconds(frame.workNS));
+        for (const auto counter : frame.counters) append(bytes, counter);
+    }
+
+    for (const auto &zone : zones) {
+        // zones of names past the table are attributed to its last one
+        const auto iter = nameIndices.find(zone.name);
+        const uint64_t zoneBegin = std::max(zone.begin, begin);
+        append(bytes, iter != nameIndices.end() ? iter->second : static_cast<uint16_t>(names.size() - 1));
+        append(bytes, static_cast<uint16_t>(std::min<uint32_t>(zone.threadIndex, UINT16_MAX)));
+        append(bytes, toMicroseconds(zoneBegin - begin));
+        append(bytes, toMicroseconds(zone.end > zoneBegin ? zone.end - zoneBegin : 0));
+    }
+
+    for (const auto &event : frameEvents) {
+        append(bytes, static_cast<uint8_t>(event.type));
+        append(bytes, static_cast<uint8_t>(0));
+        append(bytes, static_cast<uint16_t>(0));
+        append(bytes, toMicroseconds(event.time - begin));
+        append(bytes, event.value);
+    }
+
+    _lastSnapshotPath = _directory + "spike-" + std::to_string(_snapshotCount % _fileCount) + ".bin";
+    ++_snapshotCount;
+    CC_LOG_INFO("SpikeDetector: %.1f ms frame, %u frames and %u zones written to %s", static_cast<double>(spike.end - spike.begin) * 1e-6, frameCount, static_cast<uint32_t>(zones.size()), _lastSnapshotPath.c_str());
+
+    Data data;
+    data.copy(bytes.data(), static_cast<ssize_t>(bytes.size()));
+    FileUtils::getInstance()->writeDataToFileAsync(std::move(data), _lastSnapshotPath);
+}
+
+void SpikeDetector::recordEvent(SpikeEventType type, float value) {
+    if (!enabledDetectors.load(std::memory_order_relaxed)) return;
+
+    const uint64_t time = Profiler::now();
+    std::lock_guard<std::mutex> lock(eventMutex);
+    events[eventHead % SpikeDetector::MAX_EVENTS] = {time, type, value};
+    ++eventHead;
+}
+
+} // namespace cc
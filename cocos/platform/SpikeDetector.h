@@ -0,0 +1,116 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "base/FrameStats.h"
+#include "base/Macros.h"
+#include <cstdint>
+#include <string>
+
+namespace cc {
+
+enum class SpikeEventType : uint8_t {
+    MINOR_GC, // the value is the pause in milliseconds
+    MAJOR_GC, // mark-compact collections, the value is the pause in milliseconds
+};
+
+/**
+ * Watches the frame times for the rare hitches averages hide. Application::tick() hands it every frame, which goes
+ * into a ring of the last frames along with the FrameStats counters of the frame. A frame taking longer than the
+ * threshold writes those frames, the profiler zones and the events recorded meanwhile to a compact binary file
+ * beneath the writable path for the game to upload. While it's enabled the profiler keeps its zone rings, see
+ * Profiler::setRingEnabled, that and copying the counters is all a frame without a spike costs.
+ *
+ * The files are written in the byte order of the device, which is little endian on every supported platform:
+ *   header  u32 magic "CCSP", u16 version, u16 counter count, u32 frame count, u32 name count, u32 zone count,
+ *           u32 event count, u32 threshold in us, u32 spikes detected so far
+ *   names   name count times u16 length and the characters, the counter names first, then the zone names
+ *   frames  u32 begin, u32 duration, u32 time worked, the counters as u32
+ *   zones   u16 name index, u16 thread index, u32 begin, u32 duration
+ *   events  u8 type, three bytes of padding, u32 time, f32 value
+ * Times are in microseconds, relative to the begin of the first frame.
+ */
+class CC_DLL SpikeDetector {
+public:
+    static constexpr uint32_t MAX_FRAMES   = 240;
+    static constexpr uint32_t MAX_EVENTS   = 256;
+    static constexpr uint32_t FILE_MAGIC   = 0x50534343; // "CCSP" read as bytes
+    static constexpr uint16_t FILE_VERSION = 1;
+
+    SpikeDetector();
+    ~SpikeDetector();
+
+    void setEnabled(bool enabled);
+    CC_INLINE bool isEnabled() const { return _enabled; }
+
+    // A frame taking longer is a spike, 100 ms by default.
+    CC_INLINE void setThreshold(float ms) { _thresholdNS = static_cast<int64_t>(ms * 1e6F); }
+    CC_INLINE float getThreshold() const { return static_cast<float>(_thresholdNS) * 1e-6F; }
+    // The frames written with a spike, including it, 120 by default and at most MAX_FRAMES.
+    void setFrameCount(uint32_t count);
+    CC_INLINE uint32_t getFrameCount() const { return _frameCount; }
+    // Spikes closer to the last one written are counted without being written, 10 s by default.
+    CC_INLINE void setCooldown(float seconds) { _cooldownNS = static_cast<int64_t>(seconds * 1e9F); }
+    // The files are spikes/spike-<n>.bin beneath the writable path, n cycles through the count, 8 by default.
+    CC_INLINE void setFileCount(uint32_t count) { _fileCount = count > 0 ? count : 1; }
+
+    CC_INLINE uint32_t getSpikeCount() const { return _spikeCount; }
+    // the file of the last spike written, empty before the first
+    CC_INLINE const std::string &getLastSnapshotPath() const { return _lastSnapshotPath; }
+
+    // Called by Application::tick() at the end of every frame with the time it worked.
+    void update(int64_t workNS);
+    // Called when the application resumes, the time paused isn't a frame.
+    void reset();
+
+    // Thread safe, ignored while no detector is enabled.
+    static void recordEvent(SpikeEventType type, float value);
+
+private:
+    struct Frame {
+        uint64_t begin = 0;
+        uint64_t end = 0;
+        uint64_t workNS = 0;
+        uint32_t counters[static_cast<uint8_t>(FrameStat::COUNT)] = {};
+    };
+
+    void writeSnapshot();
+
+    bool _enabled = false;
+    int64_t _thresholdNS = 100000000;
+    int64_t _cooldownNS = 10000000000LL;
+    uint32_t _frameCount = 120;
+    uint32_t _fileCount = 8;
+    Frame _frames[MAX_FRAMES];
+    uint32_t _frameHead = 0; // frames recorded since the last reset
+    uint64_t _lastFrameEnd = 0;
+    uint64_t _lastSnapshotTime = 0;
+    uint32_t _spikeCount = 0;
+    uint32_t _snapshotCount = 0;
+    std::string _directory;
+    std::string _lastSnapshotPath;
+};
+
+} // namespace cc
@@ -107,6 +107,9 @@ void Application::onPause()
 
 void Application::onResume()
 {
+    // the time paused isn't a frame
+    _framePacer.reset();
+    _spikeDetector.reset();
 }
 
 void Application::setPreferredFramesPerSecond(int fps)
@@ -115,7 +118,8 @@ void Application::setPreferredFramesPerSecond(int fps)
         return;
 
     _fps = fps;
-    _prefererredNanosecondsPerFrame = (long)(1.0 / _fps * NANOSECONDS_PER_SECOND);
+    _prefererredNanosecondsPerFrame = (long)(1.0 / getFramesPerSecond() * NANOSECONDS_PER_SECOND);
+    _framePacer.setFrameInterval(_prefererredNanosecondsPerFrame);
 }
 
 std::string Application::getCurrentLanguageCode() const
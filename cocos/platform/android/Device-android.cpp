@@ -29,6 +29,7 @@ THE SOFTWARE.
 
 #include "platform/Device.h"
 #include <string.h>
+#include <algorithm>
 #include <android/log.h>
 #include <jni.h>
 #include <android_native_app_glue.h>
@@ -146,6 +147,18 @@ Device::NetworkType Device::getNetworkType()
     return (Device::NetworkType)JniHelper::callStaticIntMethod(JCLS_HELPER, "getNetworkType");
 }
 
+Device::ThermalState Device::getThermalState()
+{
+    // PowerManager.THERMAL_STATUS_NONE, LIGHT, MODERATE, SEVERE, CRITICAL, EMERGENCY and SHUTDOWN
+    const int status = JniHelper::callStaticIntMethod(JCLS_HELPER, "getThermalStatus");
+    return (Device::ThermalState)std::min(std::max(status, 0), (int)Device::ThermalState::CRITICAL);
+}
+
+float Device::getThermalHeadroom(int forecastSeconds)
+{
+    return JniHelper::callStaticFloatMethod(JCLS_HELPER, "getThermalHeadroom", forecastSeconds);
+}
+
 cc::Vec4 Device::getSafeAreaEdge()
 {
     float *data = JniHelper::callStaticFloatArrayMethod(JCLS_HELPER, "getSafeArea");
@@ -192,6 +192,12 @@ bool FileUtilsAndroid::isDirectoryExistInternal(const std::string& dirPath_) con
     return false;
 }
 
+bool FileUtilsAndroid::canIndexSearchPath(const std::string& searchPath) const
+{
+    // asset directories can't be listed with their sub directories
+    return searchPath[0] == '/' && FileUtils::canIndexSearchPath(searchPath);
+}
+
 bool FileUtilsAndroid::isAbsolutePath(const std::string& strPath) const
 {
     // On Android, there are two situations for full path.
@@ -210,6 +216,10 @@ FileUtils::Status FileUtilsAndroid::getContents(const std::string& filename, Res
     if (filename.empty())
         return FileUtils::Status::NotExists;
 
+    FileUtils::Status status;
+    if (getContentsFromPack(filename, buffer, &status))
+        return status;
+
     std::string fullPath = fullPathForFilename(filename);
     if (fullPath.empty())
         return FileUtils::Status::NotExists;
@@ -258,6 +268,56 @@ FileUtils::Status FileUtilsAndroid::getContents(const std::string& filename, Res
     return FileUtils::Status::OK;
 }
 
+MappedFile FileUtilsAndroid::mapFile(const std::string& filename)
+{
+    if (filename.empty())
+        return MappedFile();
+
+    MappedFile packed;
+    if (mapFileFromPack(filename, &packed))
+        return packed;
+
+    std::string fullPath = fullPathForFilename(filename);
+    if (fullPath.empty())
+        return MappedFile();
+
+    if (fullPath[0] == '/')
+        return FileUtils::mapFile(fullPath);
+
+    std::string relativePath;
+    size_t position = fullPath.find(ASSETS_FOLDER_NAME);
+    if (0 == position) {
+        // "@assets/" is at the beginning of the path and we don't want it
+        relativePath += fullPath.substr(strlen(ASSETS_FOLDER_NAME));
+    } else {
+        relativePath = fullPath;
+    }
+
+    // stored entries of the obb file are mapped from it, compressed ones are inflated into a buffer
+    if (obbfile && obbfile->fileExists(relativePath))
+        return obbfile->mapFile(relativePath);
+
+    if (nullptr == assetmanager) {
+        LOGD("... FileUtilsAndroid::assetmanager is nullptr");
+        return MappedFile();
+    }
+
+    AAsset* asset = AAssetManager_open(assetmanager, relativePath.data(), AASSET_MODE_BUFFER);
+    if (nullptr == asset) {
+        LOGD("asset (%s) is nullptr", filename.c_str());
+        return MappedFile();
+    }
+
+    // uncompressed assets are mapped from the apk, compressed ones are inflated once by the asset
+    const void* buffer = AAsset_getBuffer(asset);
+    auto size = AAsset_getLength(asset);
+    if (nullptr == buffer || size <= 0) {
+        AAsset_close(asset);
+        return MappedFile();
+    }
+    return MappedFile(static_cast<const unsigned char*>(buffer), size, [asset]() { AAsset_close(asset); });
+}
+
 std::string FileUtilsAndroid::getWritablePath() const
 {
     // Fix for Nexus 10 (Android 4.2 multi-user environment)
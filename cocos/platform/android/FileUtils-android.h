@@ -64,6 +64,7 @@ public:
     /* override functions */
     bool init() override;
     virtual FileUtils::Status getContents(const std::string& filename, ResizableBuffer* buffer) override;
+    virtual MappedFile mapFile(const std::string& filename) override;
 
     virtual std::string getWritablePath() const override;
     virtual bool isAbsolutePath(const std::string& strPath) const override;
@@ -71,6 +72,7 @@ public:
 private:
     virtual bool isFileExistInternal(const std::string& strFilePath) const override;
     virtual bool isDirectoryExistInternal(const std::string& dirPath) const override;
+    virtual bool canIndexSearchPath(const std::string& searchPath) const override;
 
     static AAssetManager* assetmanager;
     static ZipFile* obbfile;
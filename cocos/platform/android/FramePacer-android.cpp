@@ -0,0 +1,129 @@
+#include "platform/FramePacer.h"
+
+#include <android/log.h>
+#include <android/looper.h>
+#include <dlfcn.h>
+
+#include <algorithm>
+#include <chrono>
+
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, "FramePacer", __VA_ARGS__)
+
+namespace cc {
+namespace {
+// AChoreographer of API 24, the functions are looked up at run time for the older versions
+using GetInstanceFn = void *(*)();
+using FrameCallback = void (*)(long frameTimeNanos, void *data);
+using FrameCallback64 = void (*)(int64_t frameTimeNanos, void *data);
+using PostFrameCallbackFn = void (*)(void *choreographer, FrameCallback callback, void *data);
+using PostFrameCallback64Fn = void (*)(void *choreographer, FrameCallback64 callback, void *data);
+
+const int PERIOD_SAMPLES = 16;
+// the refreshes of the fastest displays are longer
+const int64_t MIN_PERIOD_NS = 4000000;
+
+int64_t nowNS() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// The frame callbacks of Choreographer on the looper of the game thread, they arrive when the looper is polled.
+// A callback posts the next one, so the times of two callbacks are a whole number of refreshes apart, the
+// refresh period is the shortest of the recent ones.
+class ChoreographerVsync : public DisplayVsync {
+public:
+    static ChoreographerVsync *create() {
+        void *lib = dlopen("libandroid.so", RTLD_NOW | RTLD_LOCAL);
+        if (!lib) {
+            return nullptr;
+        }
+        auto getInstance = reinterpret_cast<GetInstanceFn>(dlsym(lib, "AChoreographer_getInstance"));
+        // the 32 bit long of postFrameCallback wraps every 4 seconds, postFrameCallback64 is API 29
+        auto post64 = reinterpret_cast<PostFrameCallback64Fn>(dlsym(lib, "AChoreographer_postFrameCallback64"));
+        auto post = reinterpret_cast<PostFrameCallbackFn>(dlsym(lib, "AChoreographer_postFrameCallback"));
+        if (!getInstance || (!post64 && !post)) {
+            LOGD("Choreographer is unavailable, the frames are paced on the clock");
+            return nullptr;
+        }
+        // Choreographer needs a looper on the thread
+        ALooper_prepare(0);
+        void *choreographer = getInstance();
+        if (!choreographer) {
+            return nullptr;
+        }
+        auto *vsync = new ChoreographerVsync(choreographer, post64, post);
+        vsync->postCallback();
+        return vsync;
+    }
+
+    bool getLatest(int64_t *timeNS, int64_t *periodNS) override {
+        // dispatches the callback of a refresh which happened since the last poll
+        ALooper_pollAll(0, nullptr, nullptr, nullptr);
+        if (!_periodNS) {
+            return false;
+        }
+        *timeNS = _timeNS;
+        *periodNS = _periodNS;
+        return true;
+    }
+
+    void wait(int64_t timeoutNS) override {
+        // returns at the callback of the next refresh
+        ALooper_pollOnce(static_cast<int>(std::max<int64_t>(1, timeoutNS / 1000000)), nullptr, nullptr, nullptr);
+    }
+
+private:
+    ChoreographerVsync(void *choreographer, PostFrameCallback64Fn post64, PostFrameCallbackFn post)
+    : _choreographer(choreographer), _post64(post64), _post(post) {}
+
+    void postCallback() {
+        if (_post64) {
+            _post64(_choreographer, onFrame64, this);
+        } else {
+            _post(_choreographer, onFrame, this);
+        }
+    }
+
+    static void onFrame(long frameTimeNanos, void *data) {
+        int64_t timeNS = frameTimeNanos;
+        if (sizeof(long) < sizeof(int64_t)) {
+            // the high bits from the clock, the refresh was less than 4 seconds ago
+            const int64_t now = nowNS();
+            timeNS = (now & ~INT64_C(0xFFFFFFFF)) | static_cast<uint32_t>(frameTimeNanos);
+            if (timeNS > now) {
+                timeNS -= INT64_C(0x100000000);
+            }
+        }
+        static_cast<ChoreographerVsync *>(data)->onRefresh(timeNS);
+    }
+
+    static void onFrame64(int64_t frameTimeNanos, void *data) {
+        static_cast<ChoreographerVsync *>(data)->onRefresh(frameTimeNanos);
+    }
+
+    void onRefresh(int64_t timeNS) {
+        if (_timeNS && timeNS - _timeNS >= MIN_PERIOD_NS) {
+            _periods[_nextSample] = timeNS - _timeNS;
+            _nextSample = (_nextSample + 1) % PERIOD_SAMPLES;
+            _samples = std::min(_samples + 1, PERIOD_SAMPLES);
+            _periodNS = *std::min_element(_periods, _periods + _samples);
+        }
+        _timeNS = timeNS;
+        postCallback();
+    }
+
+    void *_choreographer;
+    PostFrameCallback64Fn _post64;
+    PostFrameCallbackFn _post;
+    int64_t _timeNS = 0;
+    int64_t _periodNS = 0;
+    int64_t _periods[PERIOD_SAMPLES] = {0};
+    int _nextSample = 0;
+    int _samples = 0;
+};
+} // namespace
+
+DisplayVsync *DisplayVsync::create() {
+    return ChoreographerVsync::create();
+}
+
+} // namespace cc
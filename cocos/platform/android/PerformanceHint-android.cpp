@@ -0,0 +1,71 @@
+#include "platform/PerformanceHint.h"
+
+#include <dlfcn.h>
+#include <unistd.h>
+
+namespace cc {
+namespace {
+// APerformanceHint of API 33, the functions are looked up at run time for the older versions
+using GetManagerFn = void *(*)();
+using CreateSessionFn = void *(*)(void *manager, const int32_t *threadIds, size_t size, int64_t targetNS);
+using UpdateTargetFn = int (*)(void *session, int64_t targetNS);
+using ReportActualFn = int (*)(void *session, int64_t workNS);
+using CloseSessionFn = void (*)(void *session);
+
+class HintSession : public PerformanceHint {
+public:
+    static HintSession *create(const std::vector<int32_t> &threadIds, int64_t targetNS) {
+        void *lib = dlopen("libandroid.so", RTLD_NOW | RTLD_LOCAL);
+        if (!lib) {
+            return nullptr;
+        }
+        auto getManager = reinterpret_cast<GetManagerFn>(dlsym(lib, "APerformanceHint_getManager"));
+        auto createSession = reinterpret_cast<CreateSessionFn>(dlsym(lib, "APerformanceHint_createSession"));
+        auto updateTarget = reinterpret_cast<UpdateTargetFn>(dlsym(lib, "APerformanceHint_updateTargetWorkDuration"));
+        auto reportActual = reinterpret_cast<ReportActualFn>(dlsym(lib, "APerformanceHint_reportActualWorkDuration"));
+        auto closeSession = reinterpret_cast<CloseSessionFn>(dlsym(lib, "APerformanceHint_closeSession"));
+        void *manager = getManager && createSession && updateTarget && reportActual && closeSession ? getManager() : nullptr;
+        if (!manager || threadIds.empty()) {
+            return nullptr;
+        }
+        void *session = createSession(manager, threadIds.data(), threadIds.size(), targetNS);
+        if (!session) {
+            return nullptr;
+        }
+        return new HintSession(session, updateTarget, reportActual, closeSession);
+    }
+
+    ~HintSession() override {
+        _close(_session);
+    }
+
+    void setTarget(int64_t targetNS) override {
+        _updateTarget(_session, targetNS);
+    }
+
+    void report(int64_t workNS) override {
+        if (workNS > 0) {
+            _reportActual(_session, workNS);
+        }
+    }
+
+private:
+    HintSession(void *session, UpdateTargetFn updateTarget, ReportActualFn reportActual, CloseSessionFn close)
+    : _session(session), _updateTarget(updateTarget), _reportActual(reportActual), _close(close) {}
+
+    void *_session;
+    UpdateTargetFn _updateTarget;
+    ReportActualFn _reportActual;
+    CloseSessionFn _close;
+};
+} // namespace
+
+PerformanceHint *PerformanceHint::create(const std::vector<int32_t> &threadIds, int64_t targetNS) {
+    return HintSession::create(threadIds, targetNS);
+}
+
+int32_t PerformanceHint::getCurrentThreadId() {
+    return gettid();
+}
+
+} // namespace cc
@@ -0,0 +1,186 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/PlatformImageDecoder.h"
+
+#include <dlfcn.h>
+#include <climits>
+
+namespace cc {
+namespace {
+// AImageDecoder of libjnigraphics, API 30 and the animation functions of API 31 are looked up at run time
+constexpr int32_t DECODER_SUCCESS = 0;
+constexpr int32_t DECODER_FINISHED = -10;
+constexpr int32_t DECODER_INFINITE = INT32_MAX;
+constexpr int32_t BITMAP_FORMAT_RGBA_8888 = 1;
+
+using CreateFromBufferFn = int (*)(const void *buffer, size_t length, void **decoder);
+using DeleteFn = void (*)(void *decoder);
+using GetHeaderInfoFn = const void *(*)(const void *decoder);
+using GetDimensionFn = int32_t (*)(const void *info);
+using SetBitmapFormatFn = int (*)(void *decoder, int32_t format);
+using SetUnpremultipliedRequiredFn = int (*)(void *decoder, bool required);
+using SetTargetSizeFn = int (*)(void *decoder, int32_t width, int32_t height);
+using DecodeImageFn = int (*)(void *decoder, void *pixels, size_t stride, size_t size);
+using IsAnimatedFn = bool (*)(void *decoder);
+using GetRepeatCountFn = int32_t (*)(void *decoder);
+using DecoderFn = int (*)(void *decoder);
+using FrameInfoCreateFn = void *(*)();
+using FrameInfoDeleteFn = void (*)(void *info);
+using GetFrameInfoFn = int (*)(void *decoder, void *info);
+using FrameInfoGetDurationFn = int64_t (*)(const void *info);
+
+struct Functions {
+    CreateFromBufferFn createFromBuffer = nullptr;
+    DeleteFn deleteDecoder = nullptr;
+    GetHeaderInfoFn getHeaderInfo = nullptr;
+    GetDimensionFn getWidth = nullptr;
+    GetDimensionFn getHeight = nullptr;
+    SetBitmapFormatFn setBitmapFormat = nullptr;
+    SetUnpremultipliedRequiredFn setUnpremultipliedRequired = nullptr;
+    SetTargetSizeFn setTargetSize = nullptr;
+    DecodeImageFn decodeImage = nullptr;
+    // nullptr before API 31
+    IsAnimatedFn isAnimated = nullptr;
+    GetRepeatCountFn getRepeatCount = nullptr;
+    DecoderFn advanceFrame = nullptr;
+    DecoderFn rewind = nullptr;
+    FrameInfoCreateFn createFrameInfo = nullptr;
+    FrameInfoDeleteFn deleteFrameInfo = nullptr;
+    GetFrameInfoFn getFrameInfo = nullptr;
+    FrameInfoGetDurationFn getFrameDuration = nullptr;
+
+    Functions() {
+        void *lib = dlopen("libjnigraphics.so", RTLD_NOW | RTLD_LOCAL);
+        if (!lib) {
+            return;
+        }
+        createFromBuffer = reinterpret_cast<CreateFromBufferFn>(dlsym(lib, "AImageDecoder_createFromBuffer"));
+        deleteDecoder = reinterpret_cast<DeleteFn>(dlsym(lib, "AImageDecoder_delete"));
+        getHeaderInfo = reinterpret_cast<GetHeaderInfoFn>(dlsym(lib, "AImageDecoder_getHeaderInfo"));
+        getWidth = reinterpret_cast<GetDimensionFn>(dlsym(lib, "AImageDecoderHeaderInfo_getWidth"));
+        getHeight = reinterpret_cast<GetDimensionFn>(dlsym(lib, "AImageDecoderHeaderInfo_getHeight"));
+        setBitmapFormat = reinterpret_cast<SetBitmapFormatFn>(dlsym(lib, "AImageDecoder_setAndroidBitmapFormat"));
+        setUnpremultipliedRequired = reinterpret_cast<SetUnpremultipliedRequiredFn>(dlsym(lib, "AImageDecoder_setUnpremultipliedRequired"));
+        setTargetSize = reinterpret_cast<SetTargetSizeFn>(dlsym(lib, "AImageDecoder_setTargetSize"));
+        decodeImage = reinterpret_cast<DecodeImageFn>(dlsym(lib, "AImageDecoder_decodeImage"));
+        isAnimated = reinterpret_cast<IsAnimatedFn>(dlsym(lib, "AImageDecoder_isAnimated"));
+        getRepeatCount = reinterpret_cast<GetRepeatCountFn>(dlsym(lib, "AImageDecoder_getRepeatCount"));
+        advanceFrame = reinterpret_cast<DecoderFn>(dlsym(lib, "AImageDecoder_advanceFrame"));
+        rewind = reinterpret_cast<DecoderFn>(dlsym(lib, "AImageDecoder_rewind"));
+        createFrameInfo = reinterpret_cast<FrameInfoCreateFn>(dlsym(lib, "AImageDecoderFrameInfo_create"));
+        deleteFrameInfo = reinterpret_cast<FrameInfoDeleteFn>(dlsym(lib, "AImageDecoderFrameInfo_delete"));
+        getFrameInfo = reinterpret_cast<GetFrameInfoFn>(dlsym(lib, "AImageDecoder_getFrameInfo"));
+        getFrameDuration = reinterpret_cast<FrameInfoGetDurationFn>(dlsym(lib, "AImageDecoderFrameInfo_getDuration"));
+    }
+
+    bool isSupported() const {
+        return createFromBuffer && deleteDecoder && getHeaderInfo && getWidth && getHeight && setBitmapFormat &&
+               setUnpremultipliedRequired && setTargetSize && decodeImage;
+    }
+
+    bool isAnimationSupported() const {
+        return isAnimated && getRepeatCount && advanceFrame && rewind && createFrameInfo && deleteFrameInfo && getFrameInfo && getFrameDuration;
+    }
+};
+
+const Functions &getFunctions() {
+    static const Functions functions;
+    return functions;
+}
+
+class AImageDecoderWrapper : public PlatformImageDecoder {
+public:
+    static AImageDecoderWrapper *create(const unsigned char *data, ssize_t dataLen) {
+        const auto &functions = getFunctions();
+        void *decoder = nullptr;
+        if (!functions.isSupported() || functions.createFromBuffer(data, static_cast<size_t>(dataLen), &decoder) != DECODER_SUCCESS) {
+            return nullptr;
+        }
+        if (functions.setBitmapFormat(decoder, BITMAP_FORMAT_RGBA_8888) != DECODER_SUCCESS) {
+            functions.deleteDecoder(decoder);
+            return nullptr;
+        }
+        return new AImageDecoderWrapper(decoder);
+    }
+
+    ~AImageDecoderWrapper() override {
+        if (_frameInfo) _functions.deleteFrameInfo(_frameInfo);
+        _functions.deleteDecoder(_decoder);
+    }
+
+    bool setTargetSize(int width, int height) override {
+        if (_functions.setTargetSize(_decoder, width, height) != DECODER_SUCCESS) return false;
+        _width = width;
+        _height = height;
+        return true;
+    }
+
+    bool decodeFrame(unsigned char *pixels, size_t stride, bool premultiplyAlpha, float *duration) override {
+        if (premultiplyAlpha != _isPremultiplied) {
+            // opaque images refuse unpremultiplied decodes, their pixels are the same either way
+            if (_functions.setUnpremultipliedRequired(_decoder, !premultiplyAlpha) == DECODER_SUCCESS) _isPremultiplied = premultiplyAlpha;
+        }
+        if (_functions.decodeImage(_decoder, pixels, stride, stride * _height) != DECODER_SUCCESS) return false;
+
+        *duration = 0.0f;
+        if (_isAnimated && _functions.getFrameInfo(_decoder, _frameInfo) == DECODER_SUCCESS) {
+            *duration = static_cast<float>(_functions.getFrameDuration(_frameInfo) / 1e9);
+        }
+        return true;
+    }
+
+    bool advanceFrame() override {
+        return _isAnimated && _functions.advanceFrame(_decoder) == DECODER_SUCCESS;
+    }
+
+    bool rewind() override {
+        return !_isAnimated || _functions.rewind(_decoder) == DECODER_SUCCESS;
+    }
+
+private:
+    explicit AImageDecoderWrapper(void *decoder) : _functions(getFunctions()), _decoder(decoder) {
+        const void *info = _functions.getHeaderInfo(decoder);
+        _width = _functions.getWidth(info);
+        _height = _functions.getHeight(info);
+        if (_functions.isAnimationSupported() && _functions.isAnimated(decoder)) {
+            _frameInfo = _functions.createFrameInfo();
+            _isAnimated = _frameInfo != nullptr;
+            const int32_t repeatCount = _functions.getRepeatCount(decoder);
+            _repeatCount = repeatCount == DECODER_INFINITE ? INFINITE_REPEAT : repeatCount;
+        }
+    }
+
+    const Functions &_functions;
+    void *_decoder = nullptr;
+    void *_frameInfo = nullptr;
+    bool _isPremultiplied = true;
+};
+} // namespace
+
+PlatformImageDecoder *PlatformImageDecoder::create(const unsigned char *data, ssize_t dataLen) {
+    return AImageDecoderWrapper::create(data, dataLen);
+}
+
+} // namespace cc
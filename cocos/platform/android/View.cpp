@@ -27,6 +27,7 @@ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
 #include <android_native_app_glue.h>
 #include "cocos/bindings/event/EventDispatcher.h"
 #include "cocos/bindings/event/CustomEventTypes.h"
+#include "base/MemoryPressure.h"
 #include "platform/Application.h"
 #include "platform/android/jni/JniCocosActivity.h"
 
@@ -105,8 +106,13 @@ void View::engineHandleCmd(int cmd)
             if (Application::getInstance())
                 Application::getInstance()->onPause();
 	        break;
-	    case APP_CMD_LOW_MEMORY:
-	        cc::EventDispatcher::dispatchMemoryWarningEvent();
+	    case APP_CMD_LOW_MEMORY: {
+            const int level = cocosApp.memoryPressureLevel.exchange(-1);
+            if (level >= 0) {
+                cc::MemoryPressure::notify(static_cast<cc::MemoryPressureLevel>(level));
+            }
+            cc::EventDispatcher::dispatchMemoryWarningEvent();
+	    }
 	        break;
         default:
             break;
@@ -77,6 +77,7 @@ public class CocosActivity extends Activity implements SurfaceHolder.Callback {
     private native void onStartNative();
 
     private native void onLowMemoryNative();
+    private native void onTrimMemoryNative(int level);
 
     private native void onWindowFocusChangedNative(boolean hasFocus);
 
@@ -209,6 +210,14 @@ public class CocosActivity extends Activity implements SurfaceHolder.Callback {
         }
     }
 
+    @Override
+    public void onTrimMemory(int level) {
+        super.onTrimMemory(level);
+        if (!mDestroyed) {
+            onTrimMemoryNative(level);
+        }
+    }
+
     @Override
     public void onWindowFocusChanged(boolean hasFocus) {
         super.onWindowFocusChanged(hasFocus);
@@ -42,6 +42,7 @@ import android.os.BatteryManager;
 import android.os.Build;
 import android.os.Environment;
 import android.os.ParcelFileDescriptor;
+import android.os.PowerManager;
 import android.os.Vibrator;
 import android.util.Log;
 import android.view.Display;
@@ -171,6 +172,49 @@ public class CocosHelper {
     }
 
     public static float getBatteryLevel() { return sBatteryReceiver.sBatteryLevel; }
+
+    private static PowerManager sPowerManager;
+    private static Method sGetThermalStatus;
+    private static Method sGetThermalHeadroom;
+    private static boolean sThermalUnavailable = false;
+
+    // PowerManager.getCurrentThermalStatus() of API 29, THERMAL_STATUS_NONE before
+    public static int getThermalStatus() {
+        if (android.os.Build.VERSION.SDK_INT < 29 || sThermalUnavailable) {
+            return 0;
+        }
+        try {
+            if (sGetThermalStatus == null) {
+                sPowerManager = (PowerManager) sActivity.getSystemService(Context.POWER_SERVICE);
+                sGetThermalStatus = PowerManager.class.getMethod("getCurrentThermalStatus");
+            }
+            return (Integer) sGetThermalStatus.invoke(sPowerManager);
+        } catch (Exception e) {
+            Log.w(TAG, "The thermal status is unavailable: " + e);
+            sThermalUnavailable = true;
+            return 0;
+        }
+    }
+
+    // PowerManager.getThermalHeadroom() of API 30, negative before or without a forecast
+    public static float getThermalHeadroom(int forecastSeconds) {
+        if (android.os.Build.VERSION.SDK_INT < 30 || sThermalUnavailable) {
+            return -1.0f;
+        }
+        try {
+            if (sGetThermalHeadroom == null) {
+                sPowerManager = (PowerManager) sActivity.getSystemService(Context.POWER_SERVICE);
+                sGetThermalHeadroom = PowerManager.class.getMethod("getThermalHeadroom", int.class);
+            }
+            // NaN when it's unsupported or asked more than once a second
+            float headroom = (Float) sGetThermalHeadroom.invoke(sPowerManager, forecastSeconds);
+            return Float.isNaN(headroom) ? -1.0f : headroom;
+        } catch (Exception e) {
+            Log.w(TAG, "The thermal headroom is unavailable: " + e);
+            sThermalUnavailable = true;
+            return -1.0f;
+        }
+    }
     public static String getObbFilePath() { return CocosHelper.sObbFilePath; }
     public static String getWritablePath() {
         return sActivity.getFilesDir().getAbsolutePath();
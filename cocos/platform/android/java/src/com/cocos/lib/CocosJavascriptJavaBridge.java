@@ -23,6 +23,39 @@
 
 package com.cocos.lib;
 
+import android.util.Log;
+
+import java.lang.reflect.Method;
+import java.util.HashMap;
+
 public class CocosJavascriptJavaBridge {
+    private static final String TAG = CocosJavascriptJavaBridge.class.getSimpleName();
+    // the methods of the batches, looked up once, the bridge is only called by the script thread
+    private static final HashMap<String, Method> sBatchMethods = new HashMap<>();
+
     public static native int evalString(String value);
+
+    // Calls the messages of jsb.reflection.callStaticMethodBatch(), class name, method name and argument triples,
+    // all in the one transition from native code. Every method is a static void method(String). Returns how many
+    // of them were called.
+    public static int dispatchBatch(String[] messages) {
+        int called = 0;
+        for (int i = 0; i + 2 < messages.length; i += 3) {
+            final String key = messages[i] + "." + messages[i + 1];
+            try {
+                Method method = sBatchMethods.get(key);
+                if (method == null) {
+                    final Class<?> cls = Class.forName(messages[i].replace('/', '.'));
+                    method = cls.getDeclaredMethod(messages[i + 1], String.class);
+                    method.setAccessible(true);
+                    sBatchMethods.put(key, method);
+                }
+                method.invoke(null, messages[i + 2]);
+                ++called;
+            } catch (Exception e) {
+                Log.e(TAG, "Failed to call " + key + "(String) of a batch: " + e);
+            }
+        }
+        return called;
+    }
 }
@@ -47,6 +47,8 @@ public class CocosLocalStorage {
             TABLE_NAME = tableName;
             mDatabaseOpenHelper = new DBOpenHelper(GlobalObject.getActivity());
             mDatabase = mDatabaseOpenHelper.getWritableDatabase();
+            // the writes append to the log instead of rewriting the pages with a journal
+            mDatabase.enableWriteAheadLogging();
             return true;
         }
         return false;
@@ -67,6 +69,32 @@ public class CocosLocalStorage {
         }
     }
 
+    /**
+     * Applies the writes in one transaction, called from the thread which flushes the native cache.
+     * @param values The values of the keys, null removes the key
+     */
+    public static void setItems(String[] keys, String[] values) {
+        try {
+            String replaceSql = "replace into "+TABLE_NAME+"(key,value)values(?,?)";
+            String deleteSql = "delete from "+TABLE_NAME+" where key=?";
+            mDatabase.beginTransaction();
+            try {
+                for (int i = 0; i < keys.length; ++i) {
+                    if (values[i] != null) {
+                        mDatabase.execSQL(replaceSql, new Object[] { keys[i], values[i] });
+                    } else {
+                        mDatabase.execSQL(deleteSql, new Object[] { keys[i] });
+                    }
+                }
+                mDatabase.setTransactionSuccessful();
+            } finally {
+                mDatabase.endTransaction();
+            }
+        } catch (Exception e) {
+            e.printStackTrace();
+        }
+    }
+
     public static String getItem(String key) {
         String ret = null;
         try {
@@ -38,6 +38,7 @@ import android.app.Activity;
 import com.cocos.lib.CocosVideoView.OnVideoEventListener;
 
 import java.lang.ref.WeakReference;
+import java.nio.ByteBuffer;
 import java.util.concurrent.Callable;
 import java.util.concurrent.ExecutionException;
 import java.util.concurrent.FutureTask;
@@ -75,6 +76,7 @@ public class CocosVideoHelper {
     private final static int VideoTaskKeepRatio = 11;
     private final static int VideoTaskFullScreen = 12;
     private final static int VideoTaskSetVolume = 13;
+    private final static int VideoTaskRenderToTexture = 14;
 
     final static int KeyEventBack = 1000;
 
@@ -156,6 +158,10 @@ public class CocosVideoHelper {
                 helper._setVolume(msg.arg1, volume);
                 break;
             }
+            case VideoTaskRenderToTexture: {
+                helper._setRenderToTextureEnabled(msg.arg1, msg.arg2 == 1);
+                break;
+            }
             default:
                 break;
             }
@@ -165,6 +171,8 @@ public class CocosVideoHelper {
     }
 
     public static native void nativeExecuteVideoCallback(int index,int event);
+    // called on the frame thread of the view, the buffer is only valid during the call
+    public static native void nativeOnVideoFrame(int index, ByteBuffer pixels, int width, int height, int rowStride);
 
     OnVideoEventListener videoEventListener = new OnVideoEventListener() {
 
@@ -428,4 +436,19 @@ public class CocosVideoHelper {
         msg.arg2 = (int) (volume * 10);
         mVideoHandler.sendMessage(msg);
     }
+
+    public static void setRenderToTextureEnabled(int index, boolean enabled) {
+        Message msg = new Message();
+        msg.what = VideoTaskRenderToTexture;
+        msg.arg1 = index;
+        msg.arg2 = enabled ? 1 : 0;
+        mVideoHandler.sendMessage(msg);
+    }
+
+    private void _setRenderToTextureEnabled(int index, boolean enabled) {
+        CocosVideoView videoView = sVideoViews.get(index);
+        if (videoView != null) {
+            videoView.setRenderToTexture(enabled);
+        }
+    }
 }
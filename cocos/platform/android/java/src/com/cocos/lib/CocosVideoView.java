@@ -23,9 +23,14 @@ import android.content.DialogInterface;
 import android.content.Intent;
 import android.content.res.AssetFileDescriptor;
 import android.content.res.Resources;
+import android.graphics.PixelFormat;
 import android.media.AudioManager;
+import android.media.Image;
+import android.media.ImageReader;
 import android.media.MediaPlayer;
 import android.net.Uri;
+import android.os.Handler;
+import android.os.HandlerThread;
 import android.util.Log;
 import android.view.MotionEvent;
 import android.view.SurfaceHolder;
@@ -111,6 +116,12 @@ public class CocosVideoView extends SurfaceView {
     // and use it to play after MedialPlayer is created again.
     private int mPositionBeforeRelease = 0;
 
+    // Frames go to an ImageReader and on to the native texture instead of the surface of the view,
+    // which stays hidden.
+    private boolean mRenderToTexture = false;
+    private ImageReader mImageReader = null;
+    private HandlerThread mFrameThread = null;
+
     // ===========================================================
     // Constructors
     // ===========================================================
@@ -157,6 +168,19 @@ public class CocosVideoView extends SurfaceView {
         fixSize();
     }
 
+    public void setRenderToTexture(boolean enabled) {
+        if (mRenderToTexture == enabled)
+            return;
+
+        mPositionBeforeRelease = getCurrentPosition();
+        this.release();
+        mRenderToTexture = enabled;
+        super.setVisibility(enabled ? GONE : VISIBLE);
+        // without a surface the video opens on its own
+        if (enabled)
+            this.openVideo();
+    }
+
     public void setVideoURL(String url) {
         mIsAssetRouse = false;
         setVideoURI(Uri.parse(url), null);
@@ -215,7 +239,7 @@ public class CocosVideoView extends SurfaceView {
 
     @Override
     public void setVisibility(int visibility) {
-        super.setVisibility(visibility);
+        super.setVisibility(mRenderToTexture ? GONE : visibility);
     }
 
     @Override
@@ -389,10 +413,14 @@ public class CocosVideoView extends SurfaceView {
         mVideoUri = uri;
         mVideoWidth = 0;
         mVideoHeight = 0;
+        if (mRenderToTexture) {
+            this.release();
+            this.openVideo();
+        }
     }
 
     private void openVideo() {
-        if (mSurfaceHolder == null) {
+        if (mSurfaceHolder == null && !mRenderToTexture) {
             // not ready for playback just yet, will try again later
             return;
         }
@@ -410,7 +438,8 @@ public class CocosVideoView extends SurfaceView {
             mMediaPlayer.setOnPreparedListener(mPreparedListener);
             mMediaPlayer.setOnCompletionListener(mCompletionListener);
             mMediaPlayer.setOnErrorListener(mErrorListener);
-            mMediaPlayer.setDisplay(mSurfaceHolder);
+            if (!mRenderToTexture)
+                mMediaPlayer.setDisplay(mSurfaceHolder);
             mMediaPlayer.setAudioStreamType(AudioManager.STREAM_MUSIC);
             mMediaPlayer.setScreenOnWhilePlaying(true);
 
@@ -425,6 +454,8 @@ public class CocosVideoView extends SurfaceView {
 
             // Use Prepare() instead of PrepareAsync to make things easy.
             mMediaPlayer.prepare();
+            if (mRenderToTexture)
+                this.openImageReader();
             this.showFirstFrame();
 
 //            mMediaPlayer.prepareAsync();
@@ -541,6 +572,8 @@ public class CocosVideoView extends SurfaceView {
         public void surfaceDestroyed(SurfaceHolder holder) {
             // after we return from this we can't use the surface any more
             mSurfaceHolder = null;
+            if (mRenderToTexture)
+                return;
             mPositionBeforeRelease = getCurrentPosition();
             CocosVideoView.this.release();
         }
@@ -554,6 +587,38 @@ public class CocosVideoView extends SurfaceView {
             mMediaPlayer.release();
             mMediaPlayer = null;
         }
+        if (mImageReader != null) {
+            mImageReader.close();
+            mImageReader = null;
+        }
+        if (mFrameThread != null) {
+            mFrameThread.quitSafely();
+            mFrameThread = null;
+        }
+    }
+
+    // the size of the video is only known once it is prepared, the reader is created then
+    private void openImageReader() {
+        int width = mMediaPlayer.getVideoWidth();
+        int height = mMediaPlayer.getVideoHeight();
+        if (width == 0 || height == 0)
+            return;
+
+        mFrameThread = new HandlerThread("CocosVideoFrames");
+        mFrameThread.start();
+        mImageReader = ImageReader.newInstance(width, height, PixelFormat.RGBA_8888, 2);
+        mImageReader.setOnImageAvailableListener(new ImageReader.OnImageAvailableListener() {
+            @Override
+            public void onImageAvailable(ImageReader reader) {
+                Image image = reader.acquireLatestImage();
+                if (image == null)
+                    return;
+                Image.Plane plane = image.getPlanes()[0];
+                CocosVideoHelper.nativeOnVideoFrame(mViewTag, plane.getBuffer(), image.getWidth(), image.getHeight(), plane.getRowStride());
+                image.close();
+            }
+        }, new Handler(mFrameThread.getLooper()));
+        mMediaPlayer.setSurface(mImageReader.getSurface());
     }
 
     private void showFirstFrame() {
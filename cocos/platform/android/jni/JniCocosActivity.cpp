@@ -3,11 +3,13 @@
 #include "platform/android/FileUtils-android.h"
 #include "platform/Application.h"
 #include "platform/android/View.h"
+#include "base/MemoryPressure.h"
 #include <jni.h>
 #include <android/log.h>
 #include <android/asset_manager_jni.h>
 #include <android/native_window_jni.h>
 #include <android_native_app_glue.h>
+#include <algorithm>
 #include <thread>
 #include <unistd.h>
 #include <fcntl.h>
@@ -38,6 +40,31 @@ namespace {
         write(pipeWrite, &cmd, sizeof(cmd));
     }
 
+    // several reports before the game thread gets to them are handled once, at the highest level
+    void reportMemoryPressure(cc::MemoryPressureLevel level) {
+        int previous = cc::cocosApp.memoryPressureLevel.load();
+        while (!cc::cocosApp.memoryPressureLevel.compare_exchange_weak(previous, std::max(previous, static_cast<int>(level)))) {
+        }
+        if (previous < 0) {
+            writeCommand(APP_CMD_LOW_MEMORY);
+        }
+    }
+
+    // see ComponentCallbacks2, the levels of a running app and the ones of a cached app are both mapped
+    cc::MemoryPressureLevel getTrimMemoryPressureLevel(int level) {
+        const int TRIM_MEMORY_RUNNING_LOW = 10;
+        const int TRIM_MEMORY_RUNNING_CRITICAL = 15;
+        const int TRIM_MEMORY_UI_HIDDEN = 20;
+        const int TRIM_MEMORY_MODERATE = 60;
+        const int TRIM_MEMORY_COMPLETE = 80;
+        if (level >= TRIM_MEMORY_COMPLETE) return cc::MemoryPressureLevel::CRITICAL;
+        if (level >= TRIM_MEMORY_MODERATE) return cc::MemoryPressureLevel::LOW;
+        if (level >= TRIM_MEMORY_UI_HIDDEN) return cc::MemoryPressureLevel::MODERATE;
+        if (level >= TRIM_MEMORY_RUNNING_CRITICAL) return cc::MemoryPressureLevel::CRITICAL;
+        if (level >= TRIM_MEMORY_RUNNING_LOW) return cc::MemoryPressureLevel::LOW;
+        return cc::MemoryPressureLevel::MODERATE;
+    }
+
     int readCommand(int8_t &cmd) {
         return read(pipeRead, &cmd, sizeof(cmd));
     }
@@ -208,7 +235,11 @@ JNIEXPORT void JNICALL Java_com_cocos_lib_CocosActivity_onStopNative(JNIEnv *env
 }
 
 JNIEXPORT void JNICALL Java_com_cocos_lib_CocosActivity_onLowMemoryNative(JNIEnv *env, jobject obj) {
-    writeCommand(APP_CMD_LOW_MEMORY);
+    reportMemoryPressure(cc::MemoryPressureLevel::CRITICAL);
+}
+
+JNIEXPORT void JNICALL Java_com_cocos_lib_CocosActivity_onTrimMemoryNative(JNIEnv *env, jobject obj, jint level) {
+    reportMemoryPressure(getTrimMemoryPressureLevel(level));
 }
 
 JNIEXPORT void JNICALL Java_com_cocos_lib_CocosActivity_onWindowFocusChangedNative(JNIEnv *env, jobject obj, jboolean has_focus) {
@@ -3,6 +3,7 @@
 #include <string>
 #include <android/native_window.h>
 #include <android/asset_manager.h>
+#include <atomic>
 #include <mutex>
 #include <condition_variable>
 
@@ -23,6 +24,9 @@ struct CocosApp {
 
 	// Current state of the app's activity.  May be either APP_CMD_RESUME, APP_CMD_PAUSE.
     int activityState = 0;
+
+    // The highest cc::MemoryPressureLevel reported since APP_CMD_LOW_MEMORY was last handled, -1 for none.
+    std::atomic<int> memoryPressureLevel{-1};
 };
 
 extern CocosApp cocosApp;
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include <string.h>
 #include <pthread.h>
 #include <android_native_app_glue.h>
+#include <mutex>
 
 #include "base/UTF8.h"
 
@@ -38,6 +39,17 @@ THE SOFTWARE.
 
 static pthread_key_t g_key;
 
+namespace {
+struct CachedMethod {
+    jclass classID; // a global reference
+    jmethodID methodID;
+};
+
+// keyed by the class name, method name and signature, the game and the UI threads share it
+std::mutex g_methodCacheMutex;
+std::unordered_map<std::string, CachedMethod> g_methodCache;
+} // namespace
+
 jclass _getClassID(const char *className) {
     if (nullptr == className) {
         return nullptr;
@@ -156,6 +168,8 @@ namespace cc {
             return false;
         }
 
+        // the classes of the previous loader are stale
+        clearMethodCache();
         JniHelper::classloader = cc::JniHelper::getEnv()->NewGlobalRef(_c);
         JniHelper::loadclassMethod_methodID = _m.methodID;
         JniHelper::_activity = cc::JniHelper::getEnv()->NewGlobalRef(activityinstance);
@@ -170,36 +184,7 @@ namespace cc {
                                         const char *className,
                                         const char *methodName,
                                         const char *paramCode) {
-        if ((nullptr == className) ||
-            (nullptr == methodName) ||
-            (nullptr == paramCode)) {
-            return false;
-        }
-
-        JNIEnv *env = JniHelper::getEnv();
-        if (!env) {
-            LOGE("Failed to get JNIEnv");
-            return false;
-        }
-
-        jclass classID = _getClassID(className);
-        if (! classID) {
-            LOGE("Failed to find class %s", className);
-            env->ExceptionClear();
-            return false;
-        }
-
-        jmethodID methodID = env->GetStaticMethodID(classID, methodName, paramCode);
-        if (! methodID) {
-            LOGE("Failed to find static method id of %s", methodName);
-            env->ExceptionClear();
-            return false;
-        }
-
-        methodinfo.classID = classID;
-        methodinfo.env = env;
-        methodinfo.methodID = methodID;
-        return true;
+        return getCachedMethodInfo(methodinfo, className, methodName, paramCode, true);
     }
 
     bool JniHelper::getMethodInfo_DefaultClassLoader(JniMethodInfo &methodinfo,
@@ -242,6 +227,14 @@ namespace cc {
                                   const char *className,
                                   const char *methodName,
                                   const char *paramCode) {
+        return getCachedMethodInfo(methodinfo, className, methodName, paramCode, false);
+    }
+
+    bool JniHelper::getCachedMethodInfo(JniMethodInfo &methodinfo,
+                                        const char *className,
+                                        const char *methodName,
+                                        const char *paramCode,
+                                        bool isStatic) {
         if ((nullptr == className) ||
             (nullptr == methodName) ||
             (nullptr == paramCode)) {
@@ -250,9 +243,26 @@ namespace cc {
 
         JNIEnv *env = JniHelper::getEnv();
         if (!env) {
+            LOGE("Failed to get JNIEnv");
             return false;
         }
 
+        std::string key;
+        key.reserve(strlen(className) + strlen(methodName) + strlen(paramCode) + 2);
+        key.append(isStatic ? "S" : "I").append(className).append(".").append(methodName).append(paramCode);
+
+        {
+            std::lock_guard<std::mutex> lock(g_methodCacheMutex);
+            auto iter = g_methodCache.find(key);
+            if (iter != g_methodCache.end()) {
+                methodinfo.classID = (jclass) env->NewLocalRef(iter->second.classID);
+                methodinfo.env = env;
+                methodinfo.methodID = iter->second.methodID;
+                return true;
+            }
+        }
+
+        // looked up without the lock, loading the class may run Java code that comes back here
         jclass classID = _getClassID(className);
         if (! classID) {
             LOGE("Failed to find class %s", className);
@@ -260,20 +270,42 @@ namespace cc {
             return false;
         }
 
-        jmethodID methodID = env->GetMethodID(classID, methodName, paramCode);
+        jmethodID methodID = isStatic ? env->GetStaticMethodID(classID, methodName, paramCode)
+                                      : env->GetMethodID(classID, methodName, paramCode);
         if (! methodID) {
-            LOGE("Failed to find method id of %s", methodName);
+            LOGE("Failed to find %smethod id of %s", isStatic ? "static " : "", methodName);
             env->ExceptionClear();
+            env->DeleteLocalRef(classID);
             return false;
         }
 
+        {
+            std::lock_guard<std::mutex> lock(g_methodCacheMutex);
+            if (!g_methodCache.count(key)) {
+                CachedMethod method;
+                method.classID = (jclass) env->NewGlobalRef(classID);
+                method.methodID = methodID;
+                g_methodCache.emplace(std::move(key), method);
+            }
+        }
+
         methodinfo.classID = classID;
         methodinfo.env = env;
         methodinfo.methodID = methodID;
-
         return true;
     }
 
+    void JniHelper::clearMethodCache() {
+        JNIEnv *env = JniHelper::getEnv();
+        std::lock_guard<std::mutex> lock(g_methodCacheMutex);
+        if (env) {
+            for (const auto &method : g_methodCache) {
+                env->DeleteGlobalRef(method.second.classID);
+            }
+        }
+        g_methodCache.clear();
+    }
+
     std::string JniHelper::jstring2string(jstring jstr) {
         if (jstr == nullptr) {
             return "";
@@ -302,6 +334,15 @@ namespace cc {
         return convert(localRefs, t, x.c_str());
     }
 
+    jobject JniHelper::convert(JniHelper::LocalRefMapType& localRefs, cc::JniMethodInfo& t, const JniByteBuffer& x) {
+        jobject ret = nullptr;
+        if (x.data)
+            ret = t.env->NewDirectByteBuffer(x.data, static_cast<jlong>(x.length));
+
+        localRefs[t.env].push_back(ret);
+        return ret;
+    }
+
     void JniHelper::deleteLocalRefs(JNIEnv* env, JniHelper::LocalRefMapType& localRefs) {
         if (!env) {
             return;
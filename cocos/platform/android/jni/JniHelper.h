@@ -49,6 +49,14 @@ typedef struct JniMethodInfo_
     jmethodID   methodID;
 } JniMethodInfo;
 
+// Bulk data handed to Java as a direct java.nio.ByteBuffer over the native memory, without a copy: the memory has to
+// stay valid for as long as Java uses the buffer.
+struct JniByteBuffer
+{
+    void *      data;
+    size_t      length;
+};
+
 class CC_DLL JniHelper
 {
 public:
@@ -59,6 +67,8 @@ public:
     static jobject getActivity();
     static void init(JNIEnv *env, jobject activity);
 
+    // The classes and method IDs are looked up once a class name, method name and signature and cached until the class
+    // loader changes, methodinfo.classID is a new local reference the caller deletes.
     static bool getStaticMethodInfo(JniMethodInfo &methodinfo,
                                     const char *className,
                                     const char *methodName,
@@ -314,6 +324,12 @@ private:
     static JavaVM* _javaVM;
 
     static JNIEnv* cacheEnv();
+    static bool getCachedMethodInfo(JniMethodInfo &methodinfo,
+                                    const char *className,
+                                    const char *methodName,
+                                    const char *paramCode,
+                                    bool isStatic);
+    static void clearMethodCache();
     static bool getMethodInfo_DefaultClassLoader(JniMethodInfo &methodinfo,
                                                  const char *className,
                                                  const char *methodName,
@@ -323,6 +339,8 @@ private:
 
     static jstring convert(LocalRefMapType &localRefs, cc::JniMethodInfo& t, const std::string& x);
 
+    static jobject convert(LocalRefMapType &localRefs, cc::JniMethodInfo& t, const JniByteBuffer& x);
+
     template <typename T>
     static T convert(LocalRefMapType &localRefs, cc::JniMethodInfo&, T x) {
         return x;
@@ -374,6 +392,10 @@ private:
         return "Ljava/lang/String;";
     }
 
+    static std::string getJNISignature(const JniByteBuffer&) {
+        return "Ljava/nio/ByteBuffer;";
+    }
+
     template <typename T>
     static std::string getJNISignature(T x) {
         // This template should never be instantiated
@@ -0,0 +1,189 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/PlatformImageDecoder.h"
+
+#import <CoreGraphics/CoreGraphics.h>
+#import <Foundation/Foundation.h>
+#import <ImageIO/ImageIO.h>
+#include <algorithm>
+
+namespace cc {
+namespace {
+// the delay of a frame and the plays of the image, read from the dictionary of its format
+float readFrameDuration(CGImageSourceRef source, size_t index) {
+    NSDictionary *properties = CFBridgingRelease(CGImageSourceCopyPropertiesAtIndex(source, index, nullptr));
+    NSDictionary *format = properties[(NSString *)kCGImagePropertyGIFDictionary];
+    NSNumber *delay = format[(NSString *)kCGImagePropertyGIFUnclampedDelayTime] ?: format[(NSString *)kCGImagePropertyGIFDelayTime];
+    if (!format) {
+        format = properties[(NSString *)kCGImagePropertyPNGDictionary];
+        delay = format[(NSString *)kCGImagePropertyAPNGUnclampedDelayTime] ?: format[(NSString *)kCGImagePropertyAPNGDelayTime];
+    }
+    if (!format) {
+        if (@available(iOS 14.0, macOS 11.0, *)) {
+            format = properties[(NSString *)kCGImagePropertyWebPDictionary];
+            delay = format[(NSString *)kCGImagePropertyWebPUnclampedDelayTime] ?: format[(NSString *)kCGImagePropertyWebPDelayTime];
+        }
+    }
+    return delay ? delay.floatValue : 0.0f;
+}
+
+int readRepeatCount(CGImageSourceRef source) {
+    NSDictionary *properties = CFBridgingRelease(CGImageSourceCopyProperties(source, nullptr));
+    NSNumber *loopCount = properties[(NSString *)kCGImagePropertyGIFDictionary][(NSString *)kCGImagePropertyGIFLoopCount]
+                              ?: properties[(NSString *)kCGImagePropertyPNGDictionary][(NSString *)kCGImagePropertyAPNGLoopCount];
+    if (!loopCount) {
+        if (@available(iOS 14.0, macOS 11.0, *)) {
+            loopCount = properties[(NSString *)kCGImagePropertyWebPDictionary][(NSString *)kCGImagePropertyWebPLoopCount];
+        }
+    }
+    // the formats count the plays, 0 loops forever
+    const int plays = loopCount ? loopCount.intValue : 0;
+    return plays ? plays - 1 : PlatformImageDecoder::INFINITE_REPEAT;
+}
+
+void unpremultiplyAlpha(unsigned char *pixels, size_t stride, int width, int height) {
+    for (int y = 0; y < height; ++y) {
+        unsigned char *p = pixels + y * stride;
+        for (int x = 0; x < width; ++x, p += 4) {
+            const unsigned int alpha = p[3];
+            if (alpha == 0 || alpha == 255) continue;
+            for (int c = 0; c < 3; ++c) p[c] = static_cast<unsigned char>(std::min((p[c] * 255u + alpha / 2) / alpha, 255u));
+        }
+    }
+}
+
+class ImageIODecoder : public PlatformImageDecoder {
+public:
+    static ImageIODecoder *create(const unsigned char *data, ssize_t dataLen) {
+        @autoreleasepool {
+            return createWithData(data, dataLen);
+        }
+    }
+
+    ~ImageIODecoder() override {
+        CFRelease(_source);
+        CGColorSpaceRelease(_colorSpace);
+    }
+
+    bool setTargetSize(int width, int height) override {
+        if (width <= 0 || height <= 0) return false;
+        _width = width;
+        _height = height;
+        return true;
+    }
+
+    bool decodeFrame(unsigned char *pixels, size_t stride, bool premultiplyAlpha, float *duration) override {
+        // decodes run on worker threads, which have no pool of their own
+        @autoreleasepool {
+            return decodeFrameToPixels(pixels, stride, premultiplyAlpha, duration);
+        }
+    }
+
+    bool advanceFrame() override {
+        if (_frameIndex + 1 >= _frameCount) return false;
+        ++_frameIndex;
+        return true;
+    }
+
+    bool rewind() override {
+        _frameIndex = 0;
+        return true;
+    }
+
+private:
+    static ImageIODecoder *createWithData(const unsigned char *data, ssize_t dataLen) {
+        CFDataRef cfData = CFDataCreateWithBytesNoCopy(kCFAllocatorDefault, data, dataLen, kCFAllocatorNull);
+        if (!cfData) return nullptr;
+        CGImageSourceRef source = CGImageSourceCreateWithData(cfData, nullptr);
+        CFRelease(cfData);
+        if (!source) return nullptr;
+
+        const size_t frameCount = CGImageSourceGetCount(source);
+        NSDictionary *properties = frameCount ? CFBridgingRelease(CGImageSourceCopyPropertiesAtIndex(source, 0, nullptr)) : nil;
+        NSNumber *width = properties[(NSString *)kCGImagePropertyPixelWidth];
+        NSNumber *height = properties[(NSString *)kCGImagePropertyPixelHeight];
+        if (!width || !height) {
+            CFRelease(source);
+            return nullptr;
+        }
+        return new ImageIODecoder(source, frameCount, width.intValue, height.intValue);
+    }
+
+    bool decodeFrameToPixels(unsigned char *pixels, size_t stride, bool premultiplyAlpha, float *duration) {
+        // downscaled decodes are thumbnails, which the JPEG decoder subsamples like the target size of Android
+        CGImageRef image = nullptr;
+        const int maxSize = std::max(_width, _height);
+        if (maxSize < std::max(_imageWidth, _imageHeight)) {
+            NSDictionary *options = @{
+                (NSString *)kCGImageSourceCreateThumbnailFromImageAlways : @YES,
+                (NSString *)kCGImageSourceThumbnailMaxPixelSize : @(maxSize),
+                (NSString *)kCGImageSourceShouldCacheImmediately : @YES,
+            };
+            image = CGImageSourceCreateThumbnailAtIndex(_source, _frameIndex, (__bridge CFDictionaryRef)options);
+        } else {
+            image = CGImageSourceCreateImageAtIndex(_source, _frameIndex, nullptr);
+        }
+        if (!image) return false;
+
+        // bitmap contexts only take premultiplied alpha, drawing a frame replaces the previous one
+        CGContextRef context = CGBitmapContextCreate(pixels, _width, _height, 8, stride, _colorSpace,
+                                                     kCGImageAlphaPremultipliedLast | kCGBitmapByteOrder32Big);
+        if (!context) {
+            CGImageRelease(image);
+            return false;
+        }
+        CGContextSetBlendMode(context, kCGBlendModeCopy);
+        CGContextSetInterpolationQuality(context, kCGInterpolationMedium);
+        CGContextDrawImage(context, CGRectMake(0, 0, _width, _height), image);
+        CGContextRelease(context);
+        CGImageRelease(image);
+
+        if (!premultiplyAlpha) unpremultiplyAlpha(pixels, stride, _width, _height);
+        *duration = _isAnimated ? readFrameDuration(_source, _frameIndex) : 0.0f;
+        return true;
+    }
+
+    ImageIODecoder(CGImageSourceRef source, size_t frameCount, int width, int height)
+    : _source(source), _colorSpace(CGColorSpaceCreateWithName(kCGColorSpaceSRGB)), _frameCount(frameCount), _imageWidth(width), _imageHeight(height) {
+        _width = width;
+        _height = height;
+        _isAnimated = frameCount > 1;
+        _repeatCount = _isAnimated ? readRepeatCount(source) : 0;
+    }
+
+    CGImageSourceRef _source = nullptr;
+    CGColorSpaceRef _colorSpace = nullptr;
+    size_t _frameCount = 0;
+    size_t _frameIndex = 0;
+    int _imageWidth = 0;
+    int _imageHeight = 0;
+};
+} // namespace
+
+PlatformImageDecoder *PlatformImageDecoder::create(const unsigned char *data, ssize_t dataLen) {
+    return ImageIODecoder::create(data, dataLen);
+}
+
+} // namespace cc
@@ -238,6 +238,8 @@ void Application::onResume() {
 #ifndef CC_USE_METAL
     [_timer resume];
 #endif
+    // the time paused isn't a frame
+    _spikeDetector.reset();
 }
 
 std::string Application::getSystemVersion() {
@@ -248,7 +250,7 @@ std::string Application::getSystemVersion() {
 void Application::setPreferredFramesPerSecond(int fps) {
     _fps = fps;
 #ifndef CC_USE_METAL
-    [_timer changeFPS:_fps];
+    [_timer changeFPS:getFramesPerSecond()];
 #endif
 }
 
@@ -297,6 +297,29 @@ Device::NetworkType Device::getNetworkType()
     return ret;
 }
 
+Device::ThermalState Device::getThermalState()
+{
+    if (@available(iOS 11.0, *))
+    {
+        switch ([NSProcessInfo processInfo].thermalState) {
+            case NSProcessInfoThermalStateFair:
+                return ThermalState::FAIR;
+            case NSProcessInfoThermalStateSerious:
+                return ThermalState::SERIOUS;
+            case NSProcessInfoThermalStateCritical:
+                return ThermalState::CRITICAL;
+            default:
+                break;
+        }
+    }
+    return ThermalState::NOMINAL;
+}
+
+float Device::getThermalHeadroom(int forecastSeconds)
+{
+    return -1.0f;
+}
+
 cc::Vec4 Device::getSafeAreaEdge()
 {
    UIView* screenView = UIApplication.sharedApplication.delegate.window.rootViewController.view;
@@ -153,7 +153,7 @@ void Application::setPreferredFramesPerSecond(int fps) {
     _fps = fps;
 
 #ifndef CC_USE_METAL
-    [_timer changeFPS:_fps];
+    [_timer changeFPS:getFramesPerSecond()];
 #endif
 }
 
@@ -245,6 +245,8 @@ void Application::onResume() {
 #ifndef CC_USE_METAL
     [_timer resume];
 #endif
+    // the time paused isn't a frame
+    _spikeDetector.reset();
 }
 
 std::string Application::getSystemVersion() {
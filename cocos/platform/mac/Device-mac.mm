@@ -116,6 +116,29 @@ Device::NetworkType Device::getNetworkType()
     return ret;
 }
 
+Device::ThermalState Device::getThermalState()
+{
+    if (@available(macOS 10.10.3, *))
+    {
+        switch ([NSProcessInfo processInfo].thermalState) {
+            case NSProcessInfoThermalStateFair:
+                return ThermalState::FAIR;
+            case NSProcessInfoThermalStateSerious:
+                return ThermalState::SERIOUS;
+            case NSProcessInfoThermalStateCritical:
+                return ThermalState::CRITICAL;
+            default:
+                break;
+        }
+    }
+    return ThermalState::NOMINAL;
+}
+
+float Device::getThermalHeadroom(int forecastSeconds)
+{
+    return -1.0f;
+}
+
 Vec4 Device::getSafeAreaEdge()
 {
     // no SafeArea concept on mac, return ZERO Vec4.
@@ -90,6 +90,16 @@ Device::NetworkType Device::getNetworkType()
     return Device::NetworkType::LAN;
 }
 
+Device::ThermalState Device::getThermalState()
+{
+    return Device::ThermalState::NOMINAL;
+}
+
+float Device::getThermalHeadroom(int forecastSeconds)
+{
+    return -1.0f;
+}
+
 cc::Vec4 Device::getSafeAreaEdge()
 {
     // no SafeArea concept on win32, return ZERO Vec4.
@@ -169,6 +169,10 @@ FileUtils::Status FileUtilsWin32::getContents(const std::string& filename, Resiz
     if (filename.empty())
         return FileUtils::Status::NotExists;
 
+    FileUtils::Status status;
+    if (getContentsFromPack(filename, buffer, &status))
+        return status;
+
     // read the file from hardware
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
 
@@ -203,6 +207,44 @@ FileUtils::Status FileUtilsWin32::getContents(const std::string& filename, Resiz
     return FileUtils::Status::OK;
 }
 
+MappedFile FileUtilsWin32::mapFile(const std::string& filename)
+{
+    if (filename.empty())
+        return MappedFile();
+
+    MappedFile packed;
+    if (mapFileFromPack(filename, &packed))
+        return packed;
+
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
+    if (fullPath.empty())
+        return MappedFile();
+
+    HANDLE fileHandle = ::CreateFile(StringUtf8ToWideChar(fullPath).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, NULL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        return MappedFile();
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(fileHandle, &size) || size.QuadPart <= 0)
+    {
+        ::CloseHandle(fileHandle);
+        return MappedFile();
+    }
+
+    // the view keeps the mapping alive once both handles are closed
+    HANDLE mappingHandle = ::CreateFileMapping(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    ::CloseHandle(fileHandle);
+    if (!mappingHandle)
+        return copyToMappedFile(fullPath);
+
+    void* address = ::MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    ::CloseHandle(mappingHandle);
+    if (!address)
+        return copyToMappedFile(fullPath);
+
+    return MappedFile(static_cast<const unsigned char*>(address), static_cast<ssize_t>(size.QuadPart), [address]() { ::UnmapViewOfFile(address); });
+}
+
 std::string FileUtilsWin32::getPathForFilename(const std::string& filename, const std::string& searchPath) const
 {
     std::string unixFileName = convertPathFormatToUnixStyle(filename);
@@ -280,15 +322,8 @@ bool FileUtilsWin32::renameFile(const std::string &oldfullpath, const std::strin
     std::wstring _wNew = StringUtf8ToWideChar(newfullpath);
     std::wstring _wOld = StringUtf8ToWideChar(oldfullpath);
 
-    if (FileUtils::getInstance()->isFileExist(newfullpath))
-    {
-        if (!DeleteFile(_wNew.c_str()))
-        {
-            CC_LOG_ERROR("Fail to delete file %s !Error code is 0x%x", newfullpath.c_str(), GetLastError());
-        }
-    }
-
-    if (MoveFile(_wOld.c_str(), _wNew.c_str()))
+    // replaces the target in one step, writeFileAtomically relies on it and runs it off the cocos thread
+    if (MoveFileExW(_wOld.c_str(), _wNew.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
     {
         return true;
     }
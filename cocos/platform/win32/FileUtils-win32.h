@@ -110,6 +110,8 @@ protected:
 
 	virtual FileUtils::Status getContents(const std::string& filename, ResizableBuffer* buffer) override;
 
+    virtual MappedFile mapFile(const std::string& filename) override;
+
     /**
      *  Gets full path for filename, resolution directory and search path.
      *
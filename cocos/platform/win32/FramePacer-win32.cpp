@@ -0,0 +1,66 @@
+#include "platform/FramePacer.h"
+
+#include <Windows.h>
+#include <dwmapi.h>
+
+#include <chrono>
+#include <thread>
+
+namespace cc {
+namespace {
+int64_t nowNS() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// The refreshes of the compositor, it presents the frames of windowed applications at them.
+class DwmVsync : public DisplayVsync {
+public:
+    DwmVsync() {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        _frequency = frequency.QuadPart;
+    }
+
+    bool getLatest(int64_t *timeNS, int64_t *periodNS) override {
+        DWM_TIMING_INFO info = {};
+        info.cbSize = sizeof(info);
+        // the timing of the whole desktop, Windows 8.1 and later need nullptr for the window
+        if (FAILED(DwmGetCompositionTimingInfo(nullptr, &info)) || !info.qpcRefreshPeriod) {
+            return false;
+        }
+        // the performance counter and the steady clock count the same time from different origins
+        LARGE_INTEGER counter;
+        QueryPerformanceCounter(&counter);
+        *timeNS = nowNS() - ticksToNS(static_cast<int64_t>(counter.QuadPart - info.qpcVBlank));
+        *periodNS = ticksToNS(static_cast<int64_t>(info.qpcRefreshPeriod));
+        return true;
+    }
+
+    void wait(int64_t timeoutNS) override {
+        // Sleep() is 1 ms at best with timeBeginPeriod(1), the end of the wait is spent yielding
+        if (timeoutNS > 2000000) {
+            Sleep(static_cast<DWORD>(timeoutNS / 1000000 - 1));
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    int64_t ticksToNS(int64_t ticks) const {
+        return ticks / _frequency * 1000000000 + ticks % _frequency * 1000000000 / _frequency;
+    }
+
+    int64_t _frequency = 1;
+};
+} // namespace
+
+DisplayVsync *DisplayVsync::create() {
+    BOOL enabled = FALSE;
+    // composition can only be off before Windows 8
+    if (FAILED(DwmIsCompositionEnabled(&enabled)) || !enabled) {
+        return nullptr;
+    }
+    return new DwmVsync();
+}
+
+} // namespace cc
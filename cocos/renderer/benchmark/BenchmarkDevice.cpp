@@ -0,0 +1,91 @@
+#include "BenchmarkDevice.h"
+#include "gfx/GFXDevice.h"
+
+#if CC_PLATFORM == CC_PLATFORM_WINDOWS && (defined(CC_USE_GLES2) || defined(CC_USE_GLES3) || defined(CC_USE_VULKAN))
+    #define CC_BENCHMARK_DEVICE 1
+    #include "sdl2/SDL.h"
+    #include "sdl2/SDL_syswm.h"
+#endif
+#ifdef CC_USE_GLES2
+    #include "renderer/gfx-gles2/GFXGLES2.h"
+#endif
+#ifdef CC_USE_GLES3
+    #include "renderer/gfx-gles3/GFXGLES3.h"
+#endif
+#ifdef CC_USE_VULKAN
+    #include "renderer/gfx-vulkan/GFXVulkan.h"
+#endif
+
+#include <cstdio>
+
+namespace cc {
+
+#if CC_BENCHMARK_DEVICE
+namespace {
+SDL_Window *window = nullptr;
+} // namespace
+
+gfx::Device *createBenchmarkDevice(const std::string &name, uint width, uint height) {
+    gfx::Device *device = nullptr;
+    #ifdef CC_USE_VULKAN
+    if (name == "vulkan") device = CC_NEW(gfx::CCVKDevice);
+    #endif
+    #ifdef CC_USE_GLES3
+    if (name == "gles3") device = CC_NEW(gfx::GLES3Device);
+    #endif
+    #ifdef CC_USE_GLES2
+    if (name == "gles2") device = CC_NEW(gfx::GLES2Device);
+    #endif
+    if (!device) {
+        fprintf(stderr, "Device %s is not built in\n", name.c_str());
+        return nullptr;
+    }
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+        fprintf(stderr, "SDL could not initialize: %s\n", SDL_GetError());
+        CC_DELETE(device);
+        return nullptr;
+    }
+    window = SDL_CreateWindow("cocos2d-benchmark", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, width, height, SDL_WINDOW_HIDDEN);
+    SDL_SysWMinfo wmInfo;
+    SDL_VERSION(&wmInfo.version);
+    if (!window || !SDL_GetWindowWMInfo(window, &wmInfo)) {
+        fprintf(stderr, "Window could not be created: %s\n", SDL_GetError());
+        CC_DELETE(device);
+        return nullptr;
+    }
+
+    gfx::DeviceInfo info;
+    info.windowHandle = reinterpret_cast<uintptr_t>(wmInfo.info.win.window);
+    info.width = info.nativeWidth = width;
+    info.height = info.nativeHeight = height;
+    // the benchmark shaders bind no resources, every set starts at the first slot
+    info.bindingMappingInfo.bufferOffsets = {0, 0, 0};
+    info.bindingMappingInfo.samplerOffsets = {0, 0, 0};
+    if (!device->initialize(info)) {
+        fprintf(stderr, "Device %s could not be initialized\n", name.c_str());
+        CC_DELETE(device);
+        return nullptr;
+    }
+    return device;
+}
+
+void destroyBenchmarkDevice(gfx::Device *device) {
+    if (device) {
+        device->destroy();
+        CC_DELETE(device);
+    }
+    if (window) SDL_DestroyWindow(window);
+    window = nullptr;
+    SDL_Quit();
+}
+#else
+gfx::Device *createBenchmarkDevice(const std::string &name, uint /*width*/, uint /*height*/) {
+    fprintf(stderr, "Device %s is not supported by this build\n", name.c_str());
+    return nullptr;
+}
+
+void destroyBenchmarkDevice(gfx::Device * /*device*/) {}
+#endif
+
+} // namespace cc
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "base/TypeDef.h"
+#include <string>
+
+namespace cc {
+namespace gfx {
+class Device;
+} // namespace gfx
+
+// Devices of the benchmark executables, created on a hidden window where the build supports one.
+// Names are gles2, gles3 and vulkan, for the backends built in. Returns nullptr and tells why on stderr otherwise.
+gfx::Device *createBenchmarkDevice(const std::string &name, uint width, uint height);
+void destroyBenchmarkDevice(gfx::Device *device);
+
+} // namespace cc
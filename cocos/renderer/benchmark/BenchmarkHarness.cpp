@@ -0,0 +1,42 @@
+#include "BenchmarkHarness.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace cc {
+
+bool parseBenchmarkOptions(int argc, char **argv, std::string &output, const BenchmarkOptionHandler &handler) {
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Missing value of %s\n", arg);
+            return false;
+        }
+        const char *value = argv[++i];
+        if (!strcmp(arg, "--output")) {
+            output = value;
+        } else if (!handler(arg, value, static_cast<uint>(strtoul(value, nullptr, 10)))) {
+            fprintf(stderr, "Unknown option %s\n", arg);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool writeBenchmarkResults(const std::string &results, const std::string &output) {
+    if (output.empty()) {
+        fputs(results.c_str(), stdout);
+        return true;
+    }
+    FILE *file = fopen(output.c_str(), "wb");
+    if (!file) {
+        fprintf(stderr, "Results could not be written to %s\n", output.c_str());
+        return false;
+    }
+    fwrite(results.data(), 1, results.size(), file);
+    fclose(file);
+    return true;
+}
+
+} // namespace cc
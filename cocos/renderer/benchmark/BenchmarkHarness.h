@@ -0,0 +1,23 @@
+#pragma once
+
+#include "base/Macros.h"
+#include "base/TypeDef.h"
+
+#include <functional>
+#include <string>
+
+namespace cc {
+
+// Called for every option with its value, and the value read as a decimal number, 0 if it is none.
+// Returns false for an option the benchmark doesn't know.
+using BenchmarkOptionHandler = std::function<bool(const char *name, const char *value, uint number)>;
+
+// Reads the --name value pairs of the benchmark executables. --output is taken into output, the others go to
+// handler. Returns false and tells why on stderr on a missing value or an unknown option.
+CC_DLL bool parseBenchmarkOptions(int argc, char **argv, std::string &output, const BenchmarkOptionHandler &handler);
+
+// Writes the results to stdout if output is empty, else to the file. Returns false and tells why on stderr
+// if the file can't be written.
+CC_DLL bool writeBenchmarkResults(const std::string &results, const std::string &output);
+
+} // namespace cc
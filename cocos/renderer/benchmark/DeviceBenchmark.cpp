@@ -0,0 +1,364 @@
+#include "DeviceBenchmark.h"
+#include "cocos2d.h"
+#include "gfx/GFXBuffer.h"
+#include "gfx/GFXCommandBuffer.h"
+#include "gfx/GFXDescriptorSet.h"
+#include "gfx/GFXDescriptorSetLayout.h"
+#include "gfx/GFXDevice.h"
+#include "gfx/GFXFramebuffer.h"
+#include "gfx/GFXInputAssembler.h"
+#include "gfx/GFXPipelineLayout.h"
+#include "gfx/GFXPipelineState.h"
+#include "gfx/GFXQueue.h"
+#include "gfx/GFXRenderPass.h"
+#include "gfx/GFXSampler.h"
+#include "gfx/GFXShader.h"
+#include "gfx/GFXTexture.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace cc {
+namespace gfx {
+namespace {
+const char *BENCHMARK_VERT_GLSL4 = R"(
+precision highp float;
+layout(location = 0) in vec3 a_position;
+void main () { gl_Position = vec4(a_position, 1.0); }
+)";
+const char *BENCHMARK_FRAG_GLSL4 = R"(
+precision mediump float;
+layout(location = 0) out vec4 o_color;
+void main () { o_color = vec4(1.0); }
+)";
+const char *BENCHMARK_VERT_GLSL3 = R"(
+precision highp float;
+in vec3 a_position;
+void main () { gl_Position = vec4(a_position, 1.0); }
+)";
+const char *BENCHMARK_FRAG_GLSL3 = R"(
+precision mediump float;
+out vec4 o_color;
+void main () { o_color = vec4(1.0); }
+)";
+const char *BENCHMARK_VERT_GLSL1 = R"(
+precision highp float;
+attribute vec3 a_position;
+void main () { gl_Position = vec4(a_position, 1.0); }
+)";
+const char *BENCHMARK_FRAG_GLSL1 = R"(
+precision mediump float;
+void main () { gl_FragColor = vec4(1.0); }
+)";
+
+// a triangle of a few pixels, the draws are bound by the CPU
+float TRIANGLE_POSITIONS[] = {-0.01f, -0.01f, 0.0f, 0.01f, -0.01f, 0.0f, 0.0f, 0.01f, 0.0f};
+
+// uploaded in chunks of this size, the limit of an inline update on some backends
+constexpr uint UPDATE_CHUNK_BYTES = 64 * 1024;
+constexpr uint UNIFORM_BUFFER_BYTES = 256;
+
+const CullMode CULL_MODES[] = {CullMode::NONE, CullMode::FRONT, CullMode::BACK};
+const ComparisonFunc DEPTH_FUNCS[] = {ComparisonFunc::LESS, ComparisonFunc::LESS_EQUAL, ComparisonFunc::GREATER, ComparisonFunc::ALWAYS};
+const BlendFactor BLEND_FACTORS[] = {BlendFactor::ZERO, BlendFactor::ONE, BlendFactor::SRC_ALPHA, BlendFactor::ONE_MINUS_SRC_ALPHA};
+
+// the i-th of the distinct pipeline states the cases create
+PipelineStateInfo getPipelineStateInfo(uint i, Shader *shader, PipelineLayout *pipelineLayout, RenderPass *renderPass) {
+    PipelineStateInfo info;
+    info.shader = shader;
+    info.pipelineLayout = pipelineLayout;
+    info.renderPass = renderPass;
+    info.inputState = {shader->getAttributes()};
+    info.rasterizerState.cullMode = CULL_MODES[i % 3];
+    info.depthStencilState.depthFunc = DEPTH_FUNCS[(i / 3) % 4];
+    BlendTarget target;
+    target.blend = i / 12 > 0 ? 1 : 0;
+    target.blendSrc = BLEND_FACTORS[(i / 12) % 4];
+    target.blendDst = BLEND_FACTORS[(i / 48) % 4];
+    target.blendColorMask = static_cast<ColorMask>(0xf - (i / 192) % 0xf);
+    info.blendState.targets = {target};
+    return info;
+}
+
+void appendEscaped(String &json, const String &str) {
+    for (const char c : str) {
+        if (c == '"' || c == '\\') json += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20) json += c;
+    }
+}
+} // namespace
+
+bool DeviceBenchmark::run(const DeviceBenchmarkInfo &info) {
+    _info = info;
+    _info.iterations = std::max(_info.iterations, 1u);
+    _results.clear();
+    if (!createResources()) {
+        CC_LOG_ERROR("DeviceBenchmark: resources could not be created on %s", _device->getDeviceName().c_str());
+        destroyResources();
+        return false;
+    }
+
+    runCreationCases();
+    runUpdateCases();
+    runDrawCases();
+
+    destroyResources();
+    return true;
+}
+
+bool DeviceBenchmark::createResources() {
+    ShaderInfo shaderInfo;
+    shaderInfo.name = "benchmark-device";
+    shaderInfo.attributes = {{"a_position", Format::RGB32F}};
+    switch (_device->getGfxAPI()) {
+        case API::GLES2:
+            shaderInfo.stages = {{ShaderStageFlagBit::VERTEX, BENCHMARK_VERT_GLSL1}, {ShaderStageFlagBit::FRAGMENT, BENCHMARK_FRAG_GLSL1}};
+            break;
+        case API::GLES3:
+            shaderInfo.stages = {{ShaderStageFlagBit::VERTEX, BENCHMARK_VERT_GLSL3}, {ShaderStageFlagBit::FRAGMENT, BENCHMARK_FRAG_GLSL3}};
+            break;
+        default:
+            shaderInfo.stages = {{ShaderStageFlagBit::VERTEX, BENCHMARK_VERT_GLSL4}, {ShaderStageFlagBit::FRAGMENT, BENCHMARK_FRAG_GLSL4}};
+            break;
+    }
+    _shader = _device->createShader(shaderInfo);
+
+    // what a material set typically holds, the shader binds none of it
+    _descriptorSetLayout = _device->createDescriptorSetLayout({{
+        {0, DescriptorType::UNIFORM_BUFFER, 1, ShaderStageFlagBit::VERTEX | ShaderStageFlagBit::FRAGMENT},
+        {1, DescriptorType::SAMPLER, 1, ShaderStageFlagBit::FRAGMENT},
+    }});
+    _pipelineLayout = _device->createPipelineLayout({});
+    if (!_shader || !_descriptorSetLayout || !_pipelineLayout) return false;
+
+    TextureInfo colorInfo;
+    colorInfo.usage = TextureUsageBit::COLOR_ATTACHMENT | TextureUsageBit::SAMPLED;
+    colorInfo.format = Format::RGBA8;
+    colorInfo.width = FRAMEBUFFER_SIZE;
+    colorInfo.height = FRAMEBUFFER_SIZE;
+    _colorTexture = _device->createTexture(colorInfo);
+    ColorAttachment colorAttachment;
+    colorAttachment.format = Format::RGBA8;
+    colorAttachment.endLayout = TextureLayout::SHADER_READONLY_OPTIMAL;
+    DepthStencilAttachment depthStencilAttachment;
+    _renderPass = _device->createRenderPass({{colorAttachment}, depthStencilAttachment});
+    if (!_colorTexture || !_renderPass) return false;
+    _framebuffer = _device->createFramebuffer({_renderPass, {_colorTexture}, nullptr});
+
+    _vertexBuffer = _device->createBuffer({
+        BufferUsageBit::VERTEX | BufferUsageBit::TRANSFER_DST,
+        MemoryUsageBit::HOST | MemoryUsageBit::DEVICE,
+        sizeof(TRIANGLE_POSITIONS),
+        3 * sizeof(float),
+    });
+    _uniformBuffer = _device->createBuffer({
+        BufferUsageBit::UNIFORM | BufferUsageBit::TRANSFER_DST,
+        MemoryUsageBit::HOST | MemoryUsageBit::DEVICE,
+        UNIFORM_BUFFER_BYTES,
+        UNIFORM_BUFFER_BYTES,
+    });
+    TextureInfo textureInfo;
+    textureInfo.usage = TextureUsageBit::SAMPLED | TextureUsageBit::TRANSFER_DST;
+    textureInfo.format = Format::RGBA8;
+    textureInfo.width = textureInfo.height = 4;
+    _texture = _device->createTexture(textureInfo);
+    _sampler = _device->createSampler({});
+    if (!_framebuffer || !_vertexBuffer || !_uniformBuffer || !_texture || !_sampler) return false;
+    _vertexBuffer->update(TRIANGLE_POSITIONS, 0, sizeof(TRIANGLE_POSITIONS));
+
+    _inputAssembler = _device->createInputAssembler({shaderInfo.attributes, {_vertexBuffer}});
+    return _inputAssembler != nullptr;
+}
+
+void DeviceBenchmark::destroyResources() {
+    CC_SAFE_DESTROY(_inputAssembler);
+    CC_SAFE_DESTROY(_sampler);
+    CC_SAFE_DESTROY(_texture);
+    CC_SAFE_DESTROY(_uniformBuffer);
+    CC_SAFE_DESTROY(_vertexBuffer);
+    CC_SAFE_DESTROY(_framebuffer);
+    CC_SAFE_DESTROY(_colorTexture);
+    CC_SAFE_DESTROY(_renderPass);
+    CC_SAFE_DESTROY(_pipelineLayout);
+    CC_SAFE_DESTROY(_descriptorSetLayout);
+    CC_SAFE_DESTROY(_shader);
+}
+
+void DeviceBenchmark::measure(const char *name, const char *unit, const std::function<void()> &prepare, const std::function<uint()> &run) {
+    Result result;
+    result.name = name;
+    result.unit = unit;
+    result.samples.reserve(_info.iterations);
+    const uint total = _info.warmup + _info.iterations;
+    for (uint i = 0; i < total; ++i) {
+        _device->acquire();
+        _device->getCommandBuffer()->begin();
+        _isRecording = true;
+        if (prepare) prepare();
+        const auto begin = std::chrono::steady_clock::now();
+        result.items = run();
+        const auto end = std::chrono::steady_clock::now();
+        submit();
+        _device->present();
+        if (i >= _info.warmup) result.samples.push_back(std::chrono::duration<double, std::micro>(end - begin).count());
+    }
+    CC_LOG_INFO("DeviceBenchmark: %-36s %10u %s", name, result.items, unit);
+    _results.emplace_back(std::move(result));
+}
+
+void DeviceBenchmark::submit() {
+    if (!_isRecording) return;
+    auto *cmdBuff = _device->getCommandBuffer();
+    cmdBuff->end();
+    _device->getQueue()->submit({cmdBuff});
+    _isRecording = false;
+}
+
+void DeviceBenchmark::runCreationCases() {
+    vector<Buffer *> buffers(_info.bufferCount);
+    measure("Device::createBuffer", "objects", nullptr, [&]() {
+        for (auto &buffer : buffers) {
+            buffer = _device->createBuffer({
+                BufferUsageBit::VERTEX | BufferUsageBit::TRANSFER_DST,
+                MemoryUsageBit::DEVICE,
+                _info.bufferSize,
+                3 * sizeof(float),
+            });
+        }
+        for (auto *buffer : buffers) CC_DESTROY(buffer);
+        return _info.bufferCount;
+    });
+
+    vector<Texture *> textures(_info.textureCount);
+    TextureInfo textureInfo;
+    textureInfo.usage = TextureUsageBit::SAMPLED | TextureUsageBit::TRANSFER_DST;
+    textureInfo.format = Format::RGBA8;
+    textureInfo.width = textureInfo.height = _info.textureSize;
+    measure("Device::createTexture", "objects", nullptr, [&]() {
+        for (auto &texture : textures) texture = _device->createTexture(textureInfo);
+        for (auto *texture : textures) CC_DESTROY(texture);
+        return _info.textureCount;
+    });
+
+    vector<DescriptorSet *> descriptorSets(_info.descriptorSetCount);
+    measure("Device::createDescriptorSet", "objects", nullptr, [&]() {
+        for (auto &descriptorSet : descriptorSets) {
+            descriptorSet = _device->createDescriptorSet({_descriptorSetLayout});
+            descriptorSet->bindBuffer(0, _uniformBuffer);
+            descriptorSet->bindTexture(1, _texture);
+            descriptorSet->bindSampler(1, _sampler);
+            descriptorSet->update();
+        }
+        for (auto *descriptorSet : descriptorSets) CC_DESTROY(descriptorSet);
+        return _info.descriptorSetCount;
+    });
+
+    vector<PipelineStateInfo> pipelineStateInfos;
+    for (uint i = 0; i < _info.pipelineStateCount; ++i) {
+        pipelineStateInfos.push_back(getPipelineStateInfo(i, _shader, _pipelineLayout, _renderPass));
+    }
+    vector<PipelineState *> pipelineStates(_info.pipelineStateCount);
+    measure("Device::createPipelineState", "objects", nullptr, [&]() {
+        for (uint i = 0; i < _info.pipelineStateCount; ++i) pipelineStates[i] = _device->createPipelineState(pipelineStateInfos[i]);
+        for (auto *pipelineState : pipelineStates) CC_DESTROY(pipelineState);
+        return _info.pipelineStateCount;
+    });
+}
+
+void DeviceBenchmark::runUpdateCases() {
+    const uint size = std::max(_info.updateBytes / UPDATE_CHUNK_BYTES, 1u) * UPDATE_CHUNK_BYTES;
+    vector<uint8_t> data(size);
+    for (uint i = 0; i < size; ++i) data[i] = static_cast<uint8_t>(i * 31);
+    auto *buffer = _device->createBuffer({
+        BufferUsageBit::VERTEX | BufferUsageBit::TRANSFER_DST,
+        MemoryUsageBit::HOST | MemoryUsageBit::DEVICE,
+        size,
+        3 * sizeof(float),
+    });
+    if (!buffer) return;
+
+    measure("Buffer::update", "bytes", nullptr, [&]() {
+        for (uint offset = 0; offset < size; offset += UPDATE_CHUNK_BYTES) buffer->update(data.data() + offset, offset, UPDATE_CHUNK_BYTES);
+        return size;
+    });
+    measure("CommandBuffer::updateBuffer", "bytes", nullptr, [&]() {
+        auto *cmdBuff = _device->getCommandBuffer();
+        for (uint offset = 0; offset < size; offset += UPDATE_CHUNK_BYTES) cmdBuff->updateBuffer(buffer, data.data() + offset, UPDATE_CHUNK_BYTES, offset);
+        submit();
+        return size;
+    });
+    CC_DESTROY(buffer);
+}
+
+void DeviceBenchmark::runDrawCases() {
+    const uint stateCount = std::max(std::min(_info.pipelineStateCount, 16u), 1u);
+    vector<PipelineState *> pipelineStates;
+    for (uint i = 0; i < stateCount; ++i) {
+        pipelineStates.push_back(_device->createPipelineState(getPipelineStateInfo(i, _shader, _pipelineLayout, _renderPass)));
+    }
+    const Rect renderArea = {0, 0, FRAMEBUFFER_SIZE, FRAMEBUFFER_SIZE};
+    const Color clearColor = {0.0f, 0.0f, 0.0f, 1.0f};
+    auto *cmdBuff = _device->getCommandBuffer();
+
+    // recording and submission, the draws share their state
+    measure("CommandBuffer::draw", "draws", nullptr, [&]() {
+        cmdBuff->beginRenderPass(_renderPass, _framebuffer, renderArea, &clearColor, 1.0f, 0);
+        cmdBuff->bindPipelineState(pipelineStates[0]);
+        cmdBuff->bindInputAssembler(_inputAssembler);
+        for (uint i = 0; i < _info.drawCount; ++i) cmdBuff->draw(_inputAssembler);
+        cmdBuff->endRenderPass();
+        submit();
+        return _info.drawCount;
+    });
+    // the same with a pipeline state and input assembler bound before every draw
+    measure("CommandBuffer::draw.stateChanges", "draws", nullptr, [&]() {
+        cmdBuff->beginRenderPass(_renderPass, _framebuffer, renderArea, &clearColor, 1.0f, 0);
+        for (uint i = 0; i < _info.drawCount; ++i) {
+            cmdBuff->bindPipelineState(pipelineStates[i % stateCount]);
+            cmdBuff->bindInputAssembler(_inputAssembler);
+            cmdBuff->draw(_inputAssembler);
+        }
+        cmdBuff->endRenderPass();
+        submit();
+        return _info.drawCount;
+    });
+
+    for (auto *pipelineState : pipelineStates) CC_DESTROY(pipelineState);
+}
+
+String DeviceBenchmark::toJSON() const {
+    String json = "{\"schema\":1,\"engine\":\"";
+    appendEscaped(json, cocos2dVersion());
+    json += "\",\"api\":\"";
+    appendEscaped(json, _device->getDeviceName());
+    json += "\",\"renderer\":\"";
+    appendEscaped(json, _device->getRenderer());
+    json += "\",\"vendor\":\"";
+    appendEscaped(json, _device->getVendor());
+    json += "\",\"version\":\"";
+    appendEscaped(json, _device->getVersion());
+    json += "\",\"results\":[";
+
+    char buffer[512];
+    for (size_t i = 0; i < _results.size(); ++i) {
+        const auto &result = _results[i];
+        auto samples = result.samples;
+        std::sort(samples.begin(), samples.end());
+        double sum = 0.0;
+        for (const auto sample : samples) sum += sample;
+        const auto count = samples.size();
+        const double median = samples[count / 2];
+        snprintf(buffer, sizeof(buffer),
+                 "%s{\"name\":\"%s\",\"unit\":\"%s\",\"items\":%u,\"iterations\":%u,\"meanUs\":%.3f,\"medianUs\":%.3f,\"minUs\":%.3f,"
+                 "\"p95Us\":%.3f,\"maxUs\":%.3f,\"itemsPerSecond\":%.1f}",
+                 i ? "," : "", result.name.c_str(), result.unit.c_str(), result.items, static_cast<uint>(count), sum / count, median,
+                 samples.front(), samples[std::min(count - 1, count * 95 / 100)], samples.back(), median > 0.0 ? result.items * 1e6 / median : 0.0);
+        json += buffer;
+    }
+    json += "]}\n";
+    return json;
+}
+
+} // namespace gfx
+} // namespace cc
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "core/CoreStd.h"
+#include "gfx/GFXDef.h"
+
+#include <functional>
+
+namespace cc {
+namespace gfx {
+
+struct CC_DLL DeviceBenchmarkInfo {
+    uint iterations = 30;
+    uint warmup = 5;
+    uint bufferCount = 256; // created and destroyed per iteration
+    uint bufferSize = 64 * 1024;
+    uint textureCount = 64;
+    uint textureSize = 256;
+    uint descriptorSetCount = 256;
+    uint pipelineStateCount = 64;  // distinct states, so drivers can't hand out cached ones
+    uint updateBytes = 4 << 20;    // uploaded per iteration
+    uint drawCount = 4096;
+};
+
+// Creation and destruction rates of buffers, textures, descriptor sets and pipeline states, the bandwidth of buffer
+// updates and the throughput of draw recording and submission, through the backend independent API. Runs on any
+// initialized device, so every backend of a device family is measured by the same code, one backend per run.
+// Every iteration is a frame of its own which renders offscreen and presents. In a running game it must be run
+// between two frames, and it takes about iterations times the frame interval per case.
+class CC_DLL DeviceBenchmark {
+public:
+    struct Result {
+        String name;
+        String unit;    // what the items are: objects, bytes or draws
+        uint items = 0; // per iteration
+        vector<double> samples; // microseconds per iteration
+    };
+
+    explicit DeviceBenchmark(Device *device) : _device(device) {}
+
+    bool run(const DeviceBenchmarkInfo &info);
+    CC_INLINE const vector<Result> &getResults() const { return _results; }
+
+    // One JSON document naming the backend, the GPU and its driver with the results, comparable across devices.
+    String toJSON() const;
+
+    // the offscreen target the draw cases render to, and the size the window of the device needs
+    static constexpr uint FRAMEBUFFER_SIZE = 256;
+
+private:
+    bool createResources();
+    void destroyResources();
+    // prepare runs untimed after the frame began, run returns the number of items it processed
+    void measure(const char *name, const char *unit, const std::function<void()> &prepare, const std::function<uint()> &run);
+    // ends and submits the command buffer of the frame, timed where a case calls it
+    void submit();
+
+    void runCreationCases();
+    void runUpdateCases();
+    void runDrawCases();
+
+    Device *_device = nullptr;
+    DeviceBenchmarkInfo _info;
+    vector<Result> _results;
+    bool _isRecording = false;
+
+    Shader *_shader = nullptr;
+    DescriptorSetLayout *_descriptorSetLayout = nullptr;
+    PipelineLayout *_pipelineLayout = nullptr;
+    RenderPass *_renderPass = nullptr;
+    Texture *_colorTexture = nullptr;
+    Framebuffer *_framebuffer = nullptr;
+    Buffer *_vertexBuffer = nullptr;
+    Buffer *_uniformBuffer = nullptr;
+    Texture *_texture = nullptr;
+    Sampler *_sampler = nullptr;
+    InputAssembler *_inputAssembler = nullptr;
+};
+
+} // namespace gfx
+} // namespace cc
@@ -0,0 +1,64 @@
+// Benchmark of GFX resource creation, buffer updates and draw submission on one backend, built with USE_BENCHMARK.
+//
+//   cocos2d-gfx-benchmark --device gles2|gles3|vulkan [--iterations N] [--warmup N] [--draws N] [--output file]
+//
+// Run it once per backend and compare the documents, they name the GPU and the driver. The timings are in
+// microseconds per iteration. On mobile devices and with Metal the same cases run in the game, see jsb.runGFXBenchmark.
+
+#include "cocos2d.h"
+#include "renderer/benchmark/BenchmarkDevice.h"
+#include "renderer/benchmark/BenchmarkHarness.h"
+#include "renderer/benchmark/DeviceBenchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+using namespace cc;
+
+namespace {
+struct Options {
+    gfx::DeviceBenchmarkInfo info;
+    std::string device;
+    std::string output;
+};
+
+bool parseOptions(int argc, char **argv, Options &options) {
+    const bool isParsed = parseBenchmarkOptions(argc, argv, options.output, [&](const char *name, const char *value, uint number) {
+        if (!strcmp(name, "--iterations")) {
+            options.info.iterations = std::max(number, 1u);
+        } else if (!strcmp(name, "--warmup")) {
+            options.info.warmup = number;
+        } else if (!strcmp(name, "--draws")) {
+            options.info.drawCount = number;
+        } else if (!strcmp(name, "--device")) {
+            options.device = value;
+        } else {
+            return false;
+        }
+        return true;
+    });
+    if (!isParsed) return false;
+    if (options.device.empty()) {
+        fprintf(stderr, "No --device given\n");
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 1;
+
+    auto *device = createBenchmarkDevice(options.device, gfx::DeviceBenchmark::FRAMEBUFFER_SIZE, gfx::DeviceBenchmark::FRAMEBUFFER_SIZE);
+    if (!device) return 1;
+
+    int exitCode = 0;
+    gfx::DeviceBenchmark benchmark(device);
+    if (!benchmark.run(options.info) || !writeBenchmarkResults(benchmark.toJSON(), options.output)) exitCode = 1;
+
+    destroyBenchmarkDevice(device);
+    return exitCode;
+}
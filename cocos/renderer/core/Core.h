@@ -21,8 +21,10 @@
 #include "gfx/GFXDescriptorSet.h"
 #include "gfx/GFXCommandBuffer.h"
 #include "gfx/GFXFence.h"
+#include "gfx/GFXQueryPool.h"
 #include "gfx/GFXQueue.h"
 #include "gfx/GFXCommand.h"
 #include "gfx/GFXCommandPool.h"
+#include "gfx/GFXCommandStream.h"
 
 #endif // CC_CORE_CORE_H_
@@ -10,6 +10,8 @@ enum class GFXCmdType : uint8_t {
     DRAW,
     UPDATE_BUFFER,
     COPY_BUFFER_TO_TEXTURE,
+    COPY_TEXTURE,
+    QUERY,
     COUNT,
 };
 
@@ -17,8 +17,12 @@ public:
     virtual void destroy() = 0;
     virtual void begin(RenderPass *renderPass, uint subpass, Framebuffer *frameBuffer) = 0;
     virtual void end() = 0;
-    virtual void beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea, const Color *colors, float depth, int stencil) = 0;
+    // When secondaryCmdBuffCount is not zero, the render pass content is expected to be provided
+    // by execute() on these secondary command buffers only, no inline commands may follow.
+    virtual void beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea, const Color *colors, float depth, int stencil, const CommandBuffer *const *secondaryCmdBuffs, uint secondaryCmdBuffCount) = 0;
     virtual void endRenderPass() = 0;
+    // Moves on to the next subpass of the render pass, see Feature::SUBPASS_INPUT.
+    virtual void nextSubpass() = 0;
     virtual void bindPipelineState(PipelineState *pso) = 0;
     virtual void bindDescriptorSet(uint set, DescriptorSet *descriptorSet, uint dynamicOffsetCount, const uint *dynamicOffsets) = 0;
     virtual void bindInputAssembler(InputAssembler *ia) = 0;
@@ -31,9 +35,21 @@ public:
     virtual void setStencilWriteMask(StencilFace face, uint mask) = 0;
     virtual void setStencilCompareMask(StencilFace face, int ref, uint mask) = 0;
     virtual void draw(InputAssembler *ia) = 0;
+    // Draws the DrawInfos [drawOffset, drawOffset + drawCount) of an INDIRECT buffer with the vertex and index buffers
+    // of ia. The GPU reads the arguments where Feature::DRAW_INDIRECT is supported, the draws are replayed on the CPU
+    // otherwise, indirect buffers are always updated from their first DrawInfo.
+    virtual void drawIndirect(InputAssembler *ia, Buffer *indirectBuffer, uint drawOffset, uint drawCount) = 0;
     virtual void updateBuffer(Buffer *buff, const void *data, uint size, uint offset) = 0;
     virtual void copyBuffersToTexture(const uint8_t *const *buffers, Texture *texture, const BufferTextureCopy *regions, uint count) = 0;
+    // Copies texel blocks between textures of the same format, outside of a render pass.
+    // Depth stencil textures can only be copied when Feature::DEPTH_STENCIL_COPY is supported.
+    virtual void copyTexture(Texture *srcTexture, Texture *dstTexture, const TextureCopy *regions, uint count) = 0;
     virtual void execute(const CommandBuffer *const *cmdBuffs, uint32_t count) = 0;
+    // Query commands, resetQueryPool may not be recorded inside a render pass.
+    virtual void resetQueryPool(QueryPool *queryPool) = 0;
+    virtual void writeTimestamp(QueryPool *queryPool, uint query) = 0;
+    virtual void beginQuery(QueryPool *queryPool, uint query) = 0;
+    virtual void endQuery(QueryPool *queryPool, uint query) = 0;
     
     CC_INLINE void bindDescriptorSetForJS(uint set, DescriptorSet *descriptorSet) {
         bindDescriptorSet(set, descriptorSet, 0, nullptr); 
@@ -52,12 +68,21 @@ public:
     CC_INLINE void bindDescriptorSet(uint set, DescriptorSet *descriptorSet, const vector<uint> &dynamicOffsets) {
         bindDescriptorSet(set, descriptorSet, static_cast<uint>(dynamicOffsets.size()), dynamicOffsets.data());
     }
+    CC_INLINE void beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea, const Color *colors, float depth, int stencil) {
+        beginRenderPass(renderPass, fbo, renderArea, colors, depth, stencil, nullptr, 0);
+    }
     CC_INLINE void beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea, const ColorList &colors, float depth, int stencil) {
-        beginRenderPass(renderPass, fbo, renderArea, colors.data(), depth, stencil);
+        beginRenderPass(renderPass, fbo, renderArea, colors.data(), depth, stencil, nullptr, 0);
+    }
+    CC_INLINE void beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea, const ColorList &colors, float depth, int stencil, const CommandBufferList &secondaryCmdBuffs) {
+        beginRenderPass(renderPass, fbo, renderArea, colors.data(), depth, stencil, secondaryCmdBuffs.data(), static_cast<uint>(secondaryCmdBuffs.size()));
     }
     CC_INLINE void copyBuffersToTexture(const BufferDataList &buffers, Texture *texture, const BufferTextureCopyList &regions) {
         copyBuffersToTexture(buffers.data(), texture, regions.data(), static_cast<uint>(regions.size()));
     }
+    CC_INLINE void copyTexture(Texture *srcTexture, Texture *dstTexture, const TextureCopyList &regions) {
+        copyTexture(srcTexture, dstTexture, regions.data(), static_cast<uint>(regions.size()));
+    }
 
     CC_INLINE Device *getDevice() const { return _device; }
     CC_INLINE Queue *getQueue() const { return _queue; }
@@ -0,0 +1,245 @@
+#include "CoreStd.h"
+#include "GFXCommandStream.h"
+#include "GFXBuffer.h"
+#include "GFXCommandBuffer.h"
+#include "GFXDescriptorSet.h"
+#include "GFXFramebuffer.h"
+#include "GFXInputAssembler.h"
+#include "GFXPipelineState.h"
+#include "GFXRenderPass.h"
+#include "GFXSampler.h"
+#include "GFXTexture.h"
+
+#include <cstring>
+
+namespace cc {
+namespace gfx {
+
+namespace {
+
+// Reads the payload of one command, anything out of its bounds or of the wrong type makes it invalid.
+class CommandReader {
+public:
+    CommandReader(const uint *words, uint wordCount, GFXObject *const *objects, uint objectCount)
+    : _words(words), _wordCount(wordCount), _objects(objects), _objectCount(objectCount) {}
+
+    CC_INLINE bool isValid() const { return _isValid; }
+
+    uint readUint() {
+        if (_pos >= _wordCount) {
+            _isValid = false;
+            return 0u;
+        }
+        return _words[_pos++];
+    }
+
+    CC_INLINE int readInt() { return static_cast<int>(readUint()); }
+
+    float readFloat() {
+        const uint bits = readUint();
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // the data stays in the stream, which outlives the replay
+    const uint *readWords(uint count, uint stride = 1u) {
+        if (count > (_wordCount - _pos) / stride) {
+            _isValid = false;
+            return nullptr;
+        }
+        const uint *words = _words + _pos;
+        _pos += count * stride;
+        return words;
+    }
+
+    CC_INLINE const uint8_t *readData(uint size) {
+        return reinterpret_cast<const uint8_t *>(readWords(size / 4u + (size % 4u ? 1u : 0u)));
+    }
+
+    template <class T>
+    T *readObject(ObjectType type, bool isNullable = false) {
+        const uint index = readUint();
+        if (index == CommandStream::NULL_OBJECT && isNullable) return nullptr;
+
+        GFXObject *object = index < _objectCount ? _objects[index] : nullptr;
+        if (!object || object->GFXObject::getType() != type) {
+            _isValid = false;
+            return nullptr;
+        }
+        return static_cast<T *>(object);
+    }
+
+private:
+    const uint *_words = nullptr;
+    uint _wordCount = 0;
+    uint _pos = 0;
+    GFXObject *const *_objects = nullptr;
+    uint _objectCount = 0;
+    bool _isValid = true;
+};
+
+} // namespace
+
+bool CommandStream::replay(const uint *words, uint wordCount, GFXObject *const *objects, uint objectCount) {
+    static ColorList colors;
+
+    uint pos = 0;
+    while (pos < wordCount) {
+        const uint header = words[pos];
+        const auto command = static_cast<StreamCommand>(header & ((1u << TYPE_BITS) - 1u));
+        const uint size = header >> TYPE_BITS;
+        if (!size || size > wordCount - pos || command >= StreamCommand::COUNT) {
+            CC_LOG_ERROR("CommandStream: malformed command header at word %u.", pos);
+            return false;
+        }
+
+        CommandReader reader(words + pos + 1, size - 1, objects, objectCount);
+        switch (command) {
+            case StreamCommand::BUFFER_UPDATE: {
+                auto *buffer = reader.readObject<Buffer>(ObjectType::BUFFER);
+                const uint offset = reader.readUint();
+                const uint dataSize = reader.readUint();
+                const uint8_t *data = reader.readData(dataSize);
+                if (reader.isValid()) buffer->update(const_cast<uint8_t *>(data), offset, dataSize);
+                break;
+            }
+            case StreamCommand::DESCRIPTOR_SET_BIND_BUFFER: {
+                auto *descriptorSet = reader.readObject<DescriptorSet>(ObjectType::DESCRIPTOR_SET);
+                const uint binding = reader.readUint();
+                auto *buffer = reader.readObject<Buffer>(ObjectType::BUFFER, true);
+                const uint index = reader.readUint();
+                if (reader.isValid()) descriptorSet->bindBuffer(binding, buffer, index);
+                break;
+            }
+            case StreamCommand::DESCRIPTOR_SET_BIND_TEXTURE: {
+                auto *descriptorSet = reader.readObject<DescriptorSet>(ObjectType::DESCRIPTOR_SET);
+                const uint binding = reader.readUint();
+                auto *texture = reader.readObject<Texture>(ObjectType::TEXTURE, true);
+                const uint index = reader.readUint();
+                if (reader.isValid()) descriptorSet->bindTexture(binding, texture, index);
+                break;
+            }
+            case StreamCommand::DESCRIPTOR_SET_BIND_SAMPLER: {
+                auto *descriptorSet = reader.readObject<DescriptorSet>(ObjectType::DESCRIPTOR_SET);
+                const uint binding = reader.readUint();
+                auto *sampler = reader.readObject<Sampler>(ObjectType::SAMPLER, true);
+                const uint index = reader.readUint();
+                if (reader.isValid()) descriptorSet->bindSampler(binding, sampler, index);
+                break;
+            }
+            case StreamCommand::DESCRIPTOR_SET_UPDATE: {
+                auto *descriptorSet = reader.readObject<DescriptorSet>(ObjectType::DESCRIPTOR_SET);
+                if (reader.isValid()) descriptorSet->update();
+                break;
+            }
+            case StreamCommand::BEGIN: {
+                auto *cmdBuff = reader.readObject<CommandBuffer>(ObjectType::COMMAND_BUFFER);
+                auto *renderPass = reader.readObject<RenderPass>(ObjectType::RENDER_PASS, true);
+                const uint subpass = reader.readUint();
+                auto *framebuffer = reader.readObject<Framebuffer>(ObjectType::FRAMEBUFFER, true);
+                if (reader.isValid()) cmdBuff->begin(renderPass, subpass, framebuffer);
+                break;
+            }
+            case StreamCommand::END: {
+                auto *cmdBuff = reader.readObject<CommandBuffer>(ObjectType::COMMAND_BUFFER);
+                if (reader.isValid()) cmdBuff->end();
+                break;
+            }
+            case StreamCommand::BEGIN_RENDER_PASS: {
+                auto *cmdBuff = reader.readObject<CommandBuffer>(ObjectType::COMMAND_BUFFER);
+                auto *renderPass = reader.readObject<RenderPass>(ObjectType::RENDER_PASS);
+                auto *framebuffer = reader.readObject<Framebuffer>(ObjectType::FRAMEBUFFER);
+                Rect renderArea;
+                renderArea.x = reader.readInt();
+                renderArea.y = reader.readInt();
+                renderArea.width = reader.readUint();
+                renderArea.height = reader.readUint();
+                const float depth = reader.readFloat();
+                const int stencil = reader.readInt();
+                const uint colorCount = reader.readUint();
+                const uint *colorWords = reader.readWords(colorCount, 4u);
+                if (!reader.isValid()) break;
+
+                colors.resize(colorCount);
+                memcpy(colors.data(), colorWords, colorCount * sizeof(Color));
+                cmdBuff->beginRenderPass(renderPass, framebuffer, renderArea, colors.data(), depth, stencil, nullptr, 0);
+                break;
+            }
+            case StreamCommand::END_RENDER_PASS: {
+                auto *cmdBuff = reader.readObject<CommandBuffer>(ObjectType::COMMAND_BUFFER);
+                if (reader.isValid()) cmdBuff->endRenderPass();
+                break;
+            }
+            case StreamCommand::BIND_PIPELINE_STATE: {
+                auto *cmdBuff = reader.readObject<CommandBuffer>(ObjectType::COMMAND_BUFFER);
+                auto *pso = reader.readObject<PipelineState>(ObjectType::PIPELINE_STATE);
+                if (reader.isValid()) cmdBuff->bindPipelineState(pso);
+                break;
+            }
+            case StreamCommand::BIND_DESCRIPTOR_SET: {
+                auto *cmdBuff = reader.readObject<CommandBuffer>(ObjectType::COMMAND_BUFFER);
+                const uint set = reader.readUint();
+                auto *descriptorSet = reader.readObject<DescriptorSet>(ObjectType::DESCRIPTOR_SET);
+                const uint dynamicOffsetCount = reader.readUint();
+                const uint *dynamicOffsets = reader.readWords(dynamicOffsetCount);
+                if (reader.isValid()) cmdBuff->bindDescriptorSet(set, descriptorSet, dynamicOffsetCount, dynamicOffsets);
+                break;
+            }
+            case StreamCommand::BIND_INPUT_ASSEMBLER: {
+                auto *cmdBuff = reader.readObject<CommandBuffer>(ObjectType::COMMAND_BUFFER);
+                auto *ia = reader.readObject<InputAssembler>(ObjectType::INPUT_ASSEMBLER);
+                if (reader.isValid()) cmdBuff->bindInputAssembler(ia);
+                break;
+            }
+            case StreamCommand::SET_VIEWPORT: {
+                auto *cmdBuff = reader.readObject<CommandBuffer>(ObjectType::COMMAND_BUFFER);
+                Viewport viewport;
+                viewport.left = reader.readInt();
+                viewport.top = reader.readInt();
+                viewport.width = reader.readUint();
+                viewport.height = reader.readUint();
+                viewport.minDepth = reader.readFloat();
+                viewport.maxDepth = reader.readFloat();
+                if (reader.isValid()) cmdBuff->setViewport(viewport);
+                break;
+            }
+            case StreamCommand::SET_SCISSOR: {
+                auto *cmdBuff = reader.readObject<CommandBuffer>(ObjectType::COMMAND_BUFFER);
+                Rect rect;
+                rect.x = reader.readInt();
+                rect.y = reader.readInt();
+                rect.width = reader.readUint();
+                rect.height = reader.readUint();
+                if (reader.isValid()) cmdBuff->setScissor(rect);
+                break;
+            }
+            case StreamCommand::DRAW: {
+                auto *cmdBuff = reader.readObject<CommandBuffer>(ObjectType::COMMAND_BUFFER);
+                auto *ia = reader.readObject<InputAssembler>(ObjectType::INPUT_ASSEMBLER);
+                if (reader.isValid()) cmdBuff->draw(ia);
+                break;
+            }
+            case StreamCommand::UPDATE_BUFFER: {
+                auto *cmdBuff = reader.readObject<CommandBuffer>(ObjectType::COMMAND_BUFFER);
+                auto *buffer = reader.readObject<Buffer>(ObjectType::BUFFER);
+                const uint offset = reader.readUint();
+                const uint dataSize = reader.readUint();
+                const uint8_t *data = reader.readData(dataSize);
+                if (reader.isValid()) cmdBuff->updateBuffer(buffer, data, dataSize, offset);
+                break;
+            }
+            default: break;
+        }
+
+        if (!reader.isValid()) {
+            CC_LOG_ERROR("CommandStream: malformed command %u at word %u.", static_cast<uint>(command), pos);
+            return false;
+        }
+        pos += size;
+    }
+    return true;
+}
+
+} // namespace gfx
+} // namespace cc
@@ -0,0 +1,46 @@
+#ifndef CC_CORE_GFX_COMMAND_STREAM_H_
+#define CC_CORE_GFX_COMMAND_STREAM_H_
+
+#include "GFXDef.h"
+
+namespace cc {
+namespace gfx {
+
+// Commands of a stream of 32-bit words filled by script, so a whole frame of calls crosses the binding at once.
+// Every command starts with a header of its type in the low 8 bits and its size in words, header included, in
+// the upper 24 bits. Objects are referred to by their index in the object table replayed along with the stream,
+// NULL_OBJECT standing for nullptr. Data uploaded by a command follows it inline, padded to whole words.
+enum class StreamCommand : uint {
+    BUFFER_UPDATE,                // buffer, offset, size, data
+    DESCRIPTOR_SET_BIND_BUFFER,   // descriptorSet, binding, buffer, index
+    DESCRIPTOR_SET_BIND_TEXTURE,  // descriptorSet, binding, texture, index
+    DESCRIPTOR_SET_BIND_SAMPLER,  // descriptorSet, binding, sampler, index
+    DESCRIPTOR_SET_UPDATE,        // descriptorSet
+    BEGIN,                        // commandBuffer, renderPass, subpass, framebuffer
+    END,                          // commandBuffer
+    BEGIN_RENDER_PASS,            // commandBuffer, renderPass, framebuffer, x, y, width, height, depth, stencil, colorCount, colors
+    END_RENDER_PASS,              // commandBuffer
+    BIND_PIPELINE_STATE,          // commandBuffer, pipelineState
+    BIND_DESCRIPTOR_SET,          // commandBuffer, set, descriptorSet, dynamicOffsetCount, dynamicOffsets
+    BIND_INPUT_ASSEMBLER,         // commandBuffer, inputAssembler
+    SET_VIEWPORT,                 // commandBuffer, left, top, width, height, minDepth, maxDepth
+    SET_SCISSOR,                  // commandBuffer, x, y, width, height
+    DRAW,                         // commandBuffer, inputAssembler
+    UPDATE_BUFFER,                // commandBuffer, buffer, offset, size, data
+    COUNT,
+};
+
+class CC_DLL CommandStream {
+public:
+    static constexpr uint NULL_OBJECT = 0xffffffffu;
+    static constexpr uint TYPE_BITS = 8u;
+
+    // Replays the commands in order, signed integers and floats are stored by their bits. Stops at the first
+    // malformed command, returning false, the commands before it have been replayed.
+    static bool replay(const uint *words, uint wordCount, GFXObject *const *objects, uint objectCount);
+};
+
+} // namespace gfx
+} // namespace cc
+
+#endif // CC_CORE_GFX_COMMAND_STREAM_H_
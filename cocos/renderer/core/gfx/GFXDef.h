@@ -19,6 +19,7 @@ class DescriptorSet;
 class CommandAllocator;
 class CommandBuffer;
 class Fence;
+class QueryPool;
 class Queue;
 class Window;
 class Context;
@@ -43,6 +44,7 @@ enum class ObjectType {
     COMMAND_BUFFER,
     FENCE,
     QUEUE,
+    QUERY_POOL,
 };
 
 enum class Status {
@@ -98,6 +100,19 @@ enum class Feature {
     LINE_WIDTH,
     STENCIL_WRITE_MASK,
     STENCIL_COMPARE_MASK,
+    TIMESTAMP_QUERY,
+    DEPTH_STENCIL_COPY,
+    DRAW_INDIRECT,
+    ASYNC_TEXTURE_UPLOAD,
+    // Render passes whose attachments have a sampleCount above 1 render multisampled into the single sampled
+    // textures of their framebuffers: the samples only live in tile memory and are resolved into the textures as
+    // the pass ends, the multisampled attachments never reach DRAM. The depth stencil samples are dropped, so
+    // depth stencil contents don't survive such a pass, and loading color attachments isn't supported.
+    MULTISAMPLED_RENDER_TO_TEXTURE,
+    // Render passes have all of their subpasses, CommandBuffer::nextSubpass() moves on to the next one and the
+    // DescriptorType::INPUT_ATTACHMENT bindings read the attachments earlier subpasses wrote at the same pixel,
+    // straight from tile memory. Without it only the first subpass is drawn to.
+    SUBPASS_INPUT,
     COUNT,
 };
 
@@ -561,6 +576,8 @@ enum class DescriptorType : FlagBits {
     STORAGE_BUFFER = 0x4,
     DYNAMIC_STORAGE_BUFFER = 0x8,
     SAMPLER = 0x10,
+    // bound with bindTexture() to an attachment of the render pass, the sampler is ignored
+    INPUT_ATTACHMENT = 0x20,
 };
 
 enum class QueueType {
@@ -574,6 +591,11 @@ enum class CommandBufferType {
     SECONDARY,
 };
 
+enum class QueryType {
+    TIMESTAMP,
+    OCCLUSION,
+};
+
 enum class ClearFlagBit : FlagBits {
     NONE = 0,
     COLOR = 0x1,
@@ -644,6 +666,7 @@ struct TextureCopy {
     Offset dstOffset;
     Extent extent;
 };
+typedef cc::vector<TextureCopy> TextureCopyList;
 
 struct BufferTextureCopy {
     uint buffStride = 0;
@@ -719,6 +742,7 @@ struct DeviceInfo {
     uint nativeHeight = 0;
     Context *sharedCtx = nullptr;
     BindingMappingInfo bindingMappingInfo;
+    bool multithreaded = false;
 };
 
 struct WindowInfo {
@@ -883,6 +907,7 @@ struct InputAssemblerInfo {
 
 struct ColorAttachment {
     Format format = Format::UNKNOWN;
+    // see Feature::MULTISAMPLED_RENDER_TO_TEXTURE, all attachments of a pass share the count
     uint sampleCount = 1;
     LoadOp loadOp = LoadOp::CLEAR;
     StoreOp storeOp = StoreOp::STORE;
@@ -1030,6 +1055,7 @@ struct PipelineStateInfo {
     BlendState blendState;
     PrimitiveMode primitive = PrimitiveMode::TRIANGLE_LIST;
     DynamicStateFlags dynamicStates = DynamicStateFlagBit::NONE;
+    uint subpass = 0;
 };
 
 struct CommandBufferInfo {
@@ -1045,6 +1071,11 @@ struct QueueInfo {
 struct FenceInfo {
 };
 
+struct QueryPoolInfo {
+    QueryType type = QueryType::TIMESTAMP;
+    uint maxQueryObjects = 0;
+};
+
 struct FormatInfo {
     String name;
     uint size = 0;
@@ -1068,6 +1099,15 @@ struct MemoryStatus {
     uint textureSize = 0;
 };
 
+struct MemoryHeapBudget {
+    // bytes the application may allocate from the heap, what other processes use taken into account
+    uint64_t budget = 0u;
+    // bytes allocated by the application
+    uint64_t usage = 0u;
+    bool isDeviceLocal = false;
+};
+typedef cc::vector<MemoryHeapBudget> MemoryHeapBudgetList;
+
 extern CC_DLL uint FormatSize(Format format, uint width, uint height, uint depth);
 
 extern CC_DLL uint FormatSurfaceSize(Format format, uint width, uint height, uint depth, uint mips);
@@ -36,6 +36,7 @@ public:
     CC_INLINE Buffer *getBuffer(uint binding) const { return getBuffer(binding, 0u); }
     CC_INLINE Texture *getTexture(uint binding) const { return getTexture(binding, 0u); }
     CC_INLINE Sampler *getSampler(uint binding) const { return getSampler(binding, 0u); }
+    CC_INLINE const TextureList &getTextures() const { return _textures; }
 
 protected:
     Device *_device = nullptr;
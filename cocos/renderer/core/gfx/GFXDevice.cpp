@@ -1,8 +1,39 @@
 #include "CoreStd.h"
 #include "GFXDevice.h"
 #include "GFXContext.h"
+#include "GFXDescriptorSet.h"
+#include "GFXDescriptorSetLayout.h"
+#include "GFXShader.h"
+#include "platform/FileUtils.h"
+
 namespace cc {
 namespace gfx {
+namespace {
+const uint SPIRV_MAGIC = 0x07230203u;
+
+// FNV-1a of the stage and the source, tools/shader-compiler/compile-shaders.py names the blobs the same way
+uint64_t hashShaderStage(ShaderStageFlagBit stage, const String &source) {
+    uint64_t hash = 14695981039346656037ULL;
+    auto combine = [&hash](const void *data, size_t size) {
+        const auto *bytes = static_cast<const uint8_t *>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        }
+    };
+    const uint stageBits = static_cast<uint>(stage);
+    combine(&stageBits, sizeof(stageBits));
+    combine(source.data(), source.size());
+    return hash;
+}
+
+uint64_t hashDescriptors(uint64_t hash, const void *data, size_t size) {
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+} // namespace
 
 Device *Device::_instance = nullptr;
 
@@ -36,5 +67,121 @@ Format Device::getDepthStencilFormat() const {
     return _context->getDepthStencilFormat();
 }
 
+bool Device::prewarmShader(const ShaderInfo &info) {
+    if (_prewarmedShaders.count(info.name)) return true;
+
+    Shader *shader = createShader(info);
+    if (!shader) return false;
+    _prewarmedShaders.emplace(info.name, shader);
+    return true;
+}
+
+bool Device::loadPrecompiledShader(ShaderStageFlagBit stage, const String &source, const String &backend, vector<uint> &spirv) const {
+    if (_precompiledShaderPath.empty()) return false;
+
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.spv", static_cast<unsigned long long>(hashShaderStage(stage, source)));
+    const String path = _precompiledShaderPath + backend + "/" + name;
+    FileUtils *fileUtils = FileUtils::getInstance();
+    if (!fileUtils->isFileExist(path)) return false;
+
+    const Data data = fileUtils->getDataFromFile(path);
+    const auto size = static_cast<size_t>(data.getSize());
+    if (size < 5 * sizeof(uint) || size % sizeof(uint) || *reinterpret_cast<const uint *>(data.getBytes()) != SPIRV_MAGIC) {
+        CC_LOG_WARNING("%s is not a SPIR-V module, compiling the shader at runtime.", path.c_str());
+        return false;
+    }
+    spirv.resize(size / sizeof(uint));
+    memcpy(spirv.data(), data.getBytes(), size);
+    return true;
+}
+
+void Device::releasePrewarmedShaders() {
+    for (auto &pair : _prewarmedShaders) {
+        CC_SAFE_DESTROY(pair.second);
+    }
+    _prewarmedShaders.clear();
+}
+
+Shader *Device::takePrewarmedShader(const ShaderInfo &info) {
+    if (_prewarmedShaders.empty()) return nullptr;
+    auto iter = _prewarmedShaders.find(info.name);
+    if (iter == _prewarmedShaders.end()) return nullptr;
+
+    // the name holds the defines, the sources are compared in case the effect changed since the variants were saved
+    Shader *shader = iter->second;
+    const ShaderStageList &stages = shader->getStages();
+    bool isSame = stages.size() == info.stages.size();
+    for (size_t i = 0; isSame && i < stages.size(); ++i) {
+        isSame = stages[i].stage == info.stages[i].stage && stages[i].source == info.stages[i].source;
+    }
+    if (!isSame) return nullptr;
+
+    _prewarmedShaders.erase(iter);
+    return shader;
+}
+
+DescriptorSet *Device::getSharedDescriptorSet(DescriptorSetLayout *layout, const BufferList &buffers, const TextureList &textures, const SamplerList &samplers) {
+    uint64_t hash = hashDescriptors(14695981039346656037ULL, &layout, sizeof(layout));
+    hash = hashDescriptors(hash, buffers.data(), buffers.size() * sizeof(Buffer *));
+    hash = hashDescriptors(hash, textures.data(), textures.size() * sizeof(Texture *));
+    hash = hashDescriptors(hash, samplers.data(), samplers.size() * sizeof(Sampler *));
+
+    auto &entries = _sharedDescriptorSets[hash];
+    for (auto &entry : entries) {
+        if (entry.layout == layout && entry.buffers == buffers && entry.textures == textures && entry.samplers == samplers) {
+            ++entry.refCount;
+            return entry.descriptorSet;
+        }
+    }
+
+    DescriptorSet *descriptorSet = createDescriptorSet({layout});
+    const vector<uint> &descriptorIndices = layout->getDescriptorIndices();
+    for (const auto &binding : layout->getBindings()) {
+        const uint descriptorIndex = descriptorIndices[binding.binding];
+        const bool isBuffer = static_cast<uint>(binding.descriptorType) & DESCRIPTOR_BUFFER_TYPE;
+        for (uint i = 0; i < binding.count; ++i) {
+            const uint index = descriptorIndex + i;
+            if (isBuffer) {
+                if (index < buffers.size()) descriptorSet->bindBuffer(binding.binding, buffers[index], i);
+            } else {
+                if (index < textures.size()) descriptorSet->bindTexture(binding.binding, textures[index], i);
+                if (index < samplers.size()) descriptorSet->bindSampler(binding.binding, samplers[index], i);
+            }
+        }
+    }
+    descriptorSet->update();
+
+    entries.push_back({descriptorSet, layout, buffers, textures, samplers, 1});
+    _sharedDescriptorSetHashes.emplace(descriptorSet, hash);
+    return descriptorSet;
+}
+
+void Device::releaseSharedDescriptorSet(DescriptorSet *descriptorSet) {
+    auto hashIter = _sharedDescriptorSetHashes.find(descriptorSet);
+    if (hashIter == _sharedDescriptorSetHashes.end()) return;
+
+    auto &entries = _sharedDescriptorSets[hashIter->second];
+    for (auto iter = entries.begin(); iter != entries.end(); ++iter) {
+        if (iter->descriptorSet != descriptorSet) continue;
+        if (--iter->refCount) return;
+        CC_SAFE_DESTROY(iter->descriptorSet);
+        entries.erase(iter);
+        break;
+    }
+    if (entries.empty()) _sharedDescriptorSets.erase(hashIter->second);
+    _sharedDescriptorSetHashes.erase(hashIter);
+}
+
+void Device::releaseSharedDescriptorSets() {
+    for (auto &pair : _sharedDescriptorSets) {
+        for (auto &entry : pair.second) {
+            CC_SAFE_DESTROY(entry.descriptorSet);
+        }
+    }
+    _sharedDescriptorSets.clear();
+    _sharedDescriptorSetHashes.clear();
+}
+
 } // namespace gfx
 } // namespace cc
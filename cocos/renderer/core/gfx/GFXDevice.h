@@ -22,6 +22,7 @@ public:
     virtual CommandBuffer *createCommandBuffer(const CommandBufferInfo &info) = 0;
     virtual Fence *createFence(const FenceInfo &info) = 0;
     virtual Queue *createQueue(const QueueInfo &info) = 0;
+    virtual QueryPool *createQueryPool(const QueryPoolInfo &info) = 0;
     virtual Buffer *createBuffer(const BufferInfo &info) = 0;
     virtual Buffer *createBuffer(const BufferViewInfo &info) = 0;
     virtual Texture *createTexture(const TextureInfo &info) = 0;
@@ -36,10 +37,18 @@ public:
     virtual PipelineLayout *createPipelineLayout(const PipelineLayoutInfo &info) = 0;
     virtual PipelineState *createPipelineState(const PipelineStateInfo &info) = 0;
     virtual void copyBuffersToTexture(const uint8_t *const *buffers, Texture *dst, const BufferTextureCopy *regions, uint count) = 0;
+    // Uploads on a transfer context off the frame's command buffer, the buffers are staged before returning.
+    // The fence is reset here and signaled once the texture can be sampled by the following frames, until then
+    // the texture must neither be used nor resized. Its previous contents are discarded.
+    // Devices without Feature::ASYNC_TEXTURE_UPLOAD copy synchronously and signal the fence right away.
+    virtual void copyBuffersToTextureAsync(const uint8_t *const *buffers, Texture *dst, const BufferTextureCopy *regions, uint count, Fence *fence) = 0;
 
     CC_INLINE void copyBuffersToTexture(const BufferDataList &buffers, Texture *dst, const BufferTextureCopyList &regions) {
         copyBuffersToTexture(buffers.data(), dst, regions.data(), static_cast<uint>(regions.size()) );
     }
+    CC_INLINE void copyBuffersToTextureAsync(const BufferDataList &buffers, Texture *dst, const BufferTextureCopyList &regions, Fence *fence) {
+        copyBuffersToTextureAsync(buffers.data(), dst, regions.data(), static_cast<uint>(regions.size()), fence);
+    }
 
     CC_INLINE API getGfxAPI() const { return _API; }
     CC_INLINE SurfaceTransform getSurfaceTransform() const { return _transform; }
@@ -54,6 +63,7 @@ public:
     CC_INLINE CommandBuffer *getCommandBuffer() const { return _cmdBuff; }
     CC_INLINE const String &getRenderer() const { return _renderer; }
     CC_INLINE const String &getVendor() const { return _vendor; }
+    CC_INLINE const String &getVersion() const { return _version; }
     CC_INLINE uint getNumDrawCalls() const { return _numDrawCalls; }
     CC_INLINE uint getNumInstances() const { return _numInstances; }
     CC_INLINE uint getNumTris() const { return _numTriangles; }
@@ -80,7 +90,40 @@ public:
     CC_INLINE const BindingMappingInfo &bindingMappingInfo() const { return _bindingMappingInfo; }
     CC_INLINE uint genShaderId() { return _shaderIdGen++; }
 
+    // Creates the shader ahead of its first request, the first createShader() with the same name and sources is
+    // handed it instead of compiling it again. The ones nobody asked for are destroyed by releasePrewarmedShaders(),
+    // which has to run before the device is destroyed.
+    bool prewarmShader(const ShaderInfo &info);
+    void releasePrewarmedShaders();
+    CC_INLINE uint getPrewarmedShaderCount() const { return static_cast<uint>(_prewarmedShaders.size()); }
+
+    // SPIR-V compiled at build time by tools/shader-compiler, found by the stage and its source under
+    // getPrecompiledShaderPath() + backend, for the backends that would otherwise translate the GLSL at runtime.
+    bool loadPrecompiledShader(ShaderStageFlagBit stage, const String &source, const String &backend, vector<uint> &spirv) const;
+    // relative to the search paths, empty turns the lookup off
+    CC_INLINE void setPrecompiledShaderPath(const String &path) { _precompiledShaderPath = path; }
+    CC_INLINE const String &getPrecompiledShaderPath() const { return _precompiledShaderPath; }
+
+    // Returns a descriptor set of the layout with the resources bound, indexed like the lists of DescriptorSet, shared
+    // by every request for the same layout and resources. The set is updated already and must not be bound to again.
+    // Every request is paired with a releaseSharedDescriptorSet() before its resources are destroyed, and the sets
+    // still requested are destroyed by releaseSharedDescriptorSets(), which has to run before the device is destroyed.
+    DescriptorSet *getSharedDescriptorSet(DescriptorSetLayout *layout, const BufferList &buffers, const TextureList &textures, const SamplerList &samplers);
+    void releaseSharedDescriptorSet(DescriptorSet *descriptorSet);
+    void releaseSharedDescriptorSets();
+    CC_INLINE uint getSharedDescriptorSetCount() const { return static_cast<uint>(_sharedDescriptorSetHashes.size()); }
+
+    // Budget and usage of every memory heap, empty where the backend can't tell.
+    virtual MemoryHeapBudgetList getMemoryBudgets() { return MemoryHeapBudgetList(); }
+    // Compacts up to maxBytesToMove bytes of device memory allocations, so that long sessions don't fragment the
+    // heaps until allocations fail. Waits for the GPU, meant to run a step of it per frame on loading screens,
+    // outside of command buffer recording. Returns the bytes moved, 0 once there is nothing left to compact.
+    virtual uint64_t defragmentMemory(uint64_t maxBytesToMove) { return 0u; }
+
 protected:
+    // called by createShader() of the backends first
+    Shader *takePrewarmedShader(const ShaderInfo &info);
+
     API _API = API::UNKNOWN;
     SurfaceTransform _transform = SurfaceTransform::IDENTITY;
     String _deviceName;
@@ -114,6 +157,20 @@ protected:
     uint _stencilBits = 0u;
     uint _shaderIdGen = 0u;
     unordered_map<String, String> _macros;
+    unordered_map<String, Shader *> _prewarmedShaders;
+
+    struct SharedDescriptorSet {
+        DescriptorSet *descriptorSet = nullptr;
+        DescriptorSetLayout *layout = nullptr;
+        BufferList buffers;
+        TextureList textures;
+        SamplerList samplers;
+        uint refCount = 0;
+    };
+    // content hash -> the sets sharing it, which differ in content
+    unordered_map<uint64_t, vector<SharedDescriptorSet>> _sharedDescriptorSets;
+    unordered_map<DescriptorSet *, uint64_t> _sharedDescriptorSetHashes;
+    String _precompiledShaderPath = "precompiled-shaders/";
     float _clipSpaceMinZ = -1.0f;
     float _screenSpaceSignY = 1.0f;
     float _UVSpaceSignY = -1.0f;
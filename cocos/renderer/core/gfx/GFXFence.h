@@ -16,6 +16,8 @@ public:
     virtual void destroy() = 0;
     virtual void wait() = 0;
     virtual void reset() = 0;
+    // Polls the fence without blocking.
+    virtual bool isSignaled() = 0;
 
 protected:
     Device *_device = nullptr;
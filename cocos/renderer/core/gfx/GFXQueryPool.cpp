@@ -0,0 +1,15 @@
+#include "CoreStd.h"
+#include "GFXQueryPool.h"
+
+namespace cc {
+namespace gfx {
+
+QueryPool::QueryPool(Device *device)
+: GFXObject(ObjectType::QUERY_POOL), _device(device) {
+}
+
+QueryPool::~QueryPool() {
+}
+
+} // namespace gfx
+} // namespace cc
@@ -0,0 +1,39 @@
+#ifndef CC_CORE_GFX_QUERY_POOL_H_
+#define CC_CORE_GFX_QUERY_POOL_H_
+
+#include "GFXDef.h"
+
+namespace cc {
+namespace gfx {
+
+// A fixed-size set of GPU queries written by CommandBuffer::writeTimestamp/beginQuery/endQuery.
+// Queries have to be reset with CommandBuffer::resetQueryPool outside of any render pass before
+// they are written again. On Metal occlusion results are attached to render passes, an occlusion
+// pool can only be written inside the first render pass beginning after it was reset.
+class CC_DLL QueryPool : public GFXObject {
+public:
+    QueryPool(Device *device);
+    virtual ~QueryPool();
+
+public:
+    virtual bool initialize(const QueryPoolInfo &info) = 0;
+    virtual void destroy() = 0;
+    // Never blocks, returns false while any of the requested results is not available yet.
+    // Timestamps are returned in nanoseconds, occlusion queries as the number of passed samples
+    // (non-zero only meaning some samples passed on backends with boolean occlusion queries).
+    virtual bool getResults(uint first, uint count, uint64_t *results) = 0;
+
+    CC_INLINE Device *getDevice() const { return _device; }
+    CC_INLINE QueryType getType() const { return _type; }
+    CC_INLINE uint getMaxQueryObjects() const { return _maxQueryObjects; }
+
+protected:
+    Device *_device = nullptr;
+    QueryType _type = QueryType::TIMESTAMP;
+    uint _maxQueryObjects = 0;
+};
+
+} // namespace gfx
+} // namespace cc
+
+#endif // CC_CORE_GFX_QUERY_POOL_H_
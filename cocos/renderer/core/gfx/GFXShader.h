@@ -14,6 +14,8 @@ public:
 public:
     virtual bool initialize(const ShaderInfo &info) = 0;
     virtual void destroy() = 0;
+    // Whether the backend finished building the shader, using it before stalls until it's done.
+    virtual bool isReady() const { return true; }
 
     CC_INLINE Device *getDevice() const { return _device; }
     CC_INLINE uint getID() const { return _shaderID; }
@@ -11,5 +11,15 @@ Texture::Texture(Device *device)
 Texture::~Texture() {
 }
 
+void Texture::resize(uint width, uint height, uint levelCount) {
+    // backends only reallocate when the size changes, a new chain of the same size passes through a single level first
+    if (levelCount != _levelCount && width == _width && height == _height) {
+        _levelCount = 1;
+        resize(width == 1 ? 2 : 1, 1);
+    }
+    _levelCount = levelCount;
+    resize(width, height);
+}
+
 } // namespace gfx
 } // namespace cc
@@ -16,6 +16,8 @@ public:
     virtual bool initialize(const TextureViewInfo &info) = 0;
     virtual void destroy() = 0;
     virtual void resize(uint width, uint height) = 0;
+    // Reallocates the texture with another mip chain, the contents are undefined until they are uploaded again.
+    void resize(uint width, uint height, uint levelCount);
 
     CC_INLINE TextureType getType() const { return _type; }
     CC_INLINE TextureUsage getUsage() const { return _usage; }
@@ -1,4 +1,5 @@
 #include "GLES2Std.h"
+#include "base/FrameStats.h"
 
 #include "GLES2Buffer.h"
 #include "GLES2Commands.h"
@@ -126,6 +127,7 @@ void GLES2Buffer::update(void *buffer, uint offset, uint size) {
     CCASSERT(!_isBufferView, "Cannot update through buffer views");
     CCASSERT(size != 0, "Should not update buffer with 0 bytes of data");
     CCASSERT(buffer, "Buffer should not be nullptr");
+    CC_FRAME_STAT_ADD(BUFFER_UPLOAD_BYTES, size);
 
     if (_buffer) {
         memcpy(_buffer + offset, buffer, size);
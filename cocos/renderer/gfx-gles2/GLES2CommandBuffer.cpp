@@ -1,4 +1,5 @@
 #include "GLES2Std.h"
+#include "base/FrameStats.h"
 
 #include "GLES2Buffer.h"
 #include "GLES2CommandBuffer.h"
@@ -7,6 +8,7 @@
 #include "GLES2Framebuffer.h"
 #include "GLES2InputAssembler.h"
 #include "GLES2PipelineState.h"
+#include "GLES2QueryPool.h"
 #include "GLES2RenderPass.h"
 #include "GLES2Texture.h"
 
@@ -63,7 +65,7 @@ void GLES2CommandBuffer::end() {
     _isInRenderPass = false;
 }
 
-void GLES2CommandBuffer::beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea, const Color *colors, float depth, int stencil) {
+void GLES2CommandBuffer::beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea, const Color *colors, float depth, int stencil, const CommandBuffer *const *secondaryCmdBuffs, uint secondaryCmdBuffCount) {
     _isInRenderPass = true;
 
     GLES2CmdBeginRenderPass *cmd = _gles2Allocator->beginRenderPassCmdPool.alloc();
@@ -85,7 +87,12 @@ void GLES2CommandBuffer::endRenderPass() {
     _cmdPackage->cmds.push(GFXCmdType::END_RENDER_PASS);
 }
 
+void GLES2CommandBuffer::nextSubpass() {
+    // render passes only have their first subpass without Feature::SUBPASS_INPUT
+}
+
 void GLES2CommandBuffer::bindPipelineState(PipelineState *pso) {
+    CC_FRAME_STAT_ADD(PIPELINE_STATE_BINDS, 1);
     GLES2GPUPipelineState *gpuPipelineState = ((GLES2PipelineState *)pso)->gpuPipelineState();
     if (_curGPUPipelineState != gpuPipelineState) {
         _curGPUPipelineState = gpuPipelineState;
@@ -94,6 +101,7 @@ void GLES2CommandBuffer::bindPipelineState(PipelineState *pso) {
 }
 
 void GLES2CommandBuffer::bindDescriptorSet(uint set, DescriptorSet *descriptorSet, uint dynamicOffsetCount, const uint *dynamicOffsets) {
+    CC_FRAME_STAT_ADD(DESCRIPTOR_SET_BINDS, 1);
     CCASSERT(_curGPUDescriptorSets.size() > set, "Invalid set index");
 
     GLES2GPUDescriptorSet *gpuDescriptorSet = ((GLES2DescriptorSet *)descriptorSet)->gpuDescriptorSet();
@@ -208,6 +216,7 @@ void GLES2CommandBuffer::draw(InputAssembler *ia) {
         _cmdPackage->cmds.push(GFXCmdType::DRAW);
 
         ++_numDrawCalls;
+        CC_FRAME_STAT_ADD(DRAW_CALLS, 1);
         _numInstances += ia->getInstanceCount();
         if (_curGPUPipelineState) {
             switch (_curGPUPipelineState->glPrimitive) {
@@ -233,7 +242,31 @@ void GLES2CommandBuffer::draw(InputAssembler *ia) {
     }
 }
 
+void GLES2CommandBuffer::drawIndirect(InputAssembler *ia, Buffer *indirectBuffer, uint drawOffset, uint drawCount) {
+    if ((_type == CommandBufferType::PRIMARY && _isInRenderPass) ||
+        (_type == CommandBufferType::SECONDARY)) {
+        if (_isStateInvalid) {
+            BindStates();
+        }
+
+        // GLES has no indirect draws, the arguments are replayed when the package is executed
+        GLES2CmdDraw *cmd = _gles2Allocator->drawCmdPool.alloc();
+        ((GLES2InputAssembler *)ia)->ExtractCmdDraw(cmd);
+        cmd->gpuIndirectBuffer = ((GLES2Buffer *)indirectBuffer)->gpuBuffer();
+        cmd->drawOffset = drawOffset;
+        cmd->drawCount = drawCount;
+        _cmdPackage->drawCmds.push(cmd);
+        _cmdPackage->cmds.push(GFXCmdType::DRAW);
+
+        _numDrawCalls += drawCount;
+        CC_FRAME_STAT_ADD(DRAW_CALLS, drawCount);
+    } else {
+        CC_LOG_ERROR("Command 'drawIndirect' must be recorded inside a render pass.");
+    }
+}
+
 void GLES2CommandBuffer::updateBuffer(Buffer *buff, const void *data, uint size, uint offset) {
+    CC_FRAME_STAT_ADD(BUFFER_UPLOAD_BYTES, size);
     if ((_type == CommandBufferType::PRIMARY && !_isInRenderPass) ||
         (_type == CommandBufferType::SECONDARY)) {
         GLES2GPUBuffer *gpuBuffer = ((GLES2Buffer *)buff)->gpuBuffer();
@@ -281,6 +314,25 @@ void GLES2CommandBuffer::copyBuffersToTexture(const uint8_t *const *buffers, Tex
     }
 }
 
+void GLES2CommandBuffer::copyTexture(Texture *srcTexture, Texture *dstTexture, const TextureCopy *regions, uint count) {
+    if ((_type == CommandBufferType::PRIMARY && !_isInRenderPass) ||
+        (_type == CommandBufferType::SECONDARY)) {
+        GLES2GPUTexture *gpuSrcTexture = ((GLES2Texture *)srcTexture)->gpuTexture();
+        GLES2GPUTexture *gpuDstTexture = ((GLES2Texture *)dstTexture)->gpuTexture();
+        if (gpuSrcTexture && gpuDstTexture) {
+            GLES2CmdCopyTexture *cmd = _gles2Allocator->copyTextureCmdPool.alloc();
+            cmd->gpuSrcTexture = gpuSrcTexture;
+            cmd->gpuDstTexture = gpuDstTexture;
+            cmd->regions.assign(regions, regions + count);
+
+            _cmdPackage->copyTextureCmds.push(cmd);
+            _cmdPackage->cmds.push(GFXCmdType::COPY_TEXTURE);
+        }
+    } else {
+        CC_LOG_ERROR("Command 'copyTexture' must be recorded outside a render pass.");
+    }
+}
+
 void GLES2CommandBuffer::execute(const CommandBuffer *const *cmdBuffs, uint32_t count) {
     for (uint i = 0; i < count; ++i) {
         GLES2CommandBuffer *cmdBuff = (GLES2CommandBuffer *)cmdBuffs[i];
@@ -310,6 +362,16 @@ void GLES2CommandBuffer::execute(const CommandBuffer *const *cmdBuffs, uint32_t
             ++cmd->refCount;
             _cmdPackage->copyBufferToTextureCmds.push(cmd);
         }
+        for (uint j = 0; j < cmdBuff->_cmdPackage->copyTextureCmds.size(); ++j) {
+            GLES2CmdCopyTexture *cmd = cmdBuff->_cmdPackage->copyTextureCmds[j];
+            ++cmd->refCount;
+            _cmdPackage->copyTextureCmds.push(cmd);
+        }
+        for (uint j = 0; j < cmdBuff->_cmdPackage->queryCmds.size(); ++j) {
+            GLES2CmdQuery *cmd = cmdBuff->_cmdPackage->queryCmds[j];
+            ++cmd->refCount;
+            _cmdPackage->queryCmds.push(cmd);
+        }
         _cmdPackage->cmds.concat(cmdBuff->_cmdPackage->cmds);
 
         _numDrawCalls += cmdBuff->getNumDrawCalls();
@@ -318,6 +380,32 @@ void GLES2CommandBuffer::execute(const CommandBuffer *const *cmdBuffs, uint32_t
     }
 }
 
+void GLES2CommandBuffer::resetQueryPool(QueryPool *queryPool) {
+    // GL queries are rewritten in place without an explicit reset
+}
+
+void GLES2CommandBuffer::writeTimestamp(QueryPool *queryPool, uint query) {
+    recordQuery(queryPool, GLES2QueryOp::WRITE_TIMESTAMP, query);
+}
+
+void GLES2CommandBuffer::beginQuery(QueryPool *queryPool, uint query) {
+    recordQuery(queryPool, GLES2QueryOp::BEGIN, query);
+}
+
+void GLES2CommandBuffer::endQuery(QueryPool *queryPool, uint query) {
+    recordQuery(queryPool, GLES2QueryOp::END, query);
+}
+
+void GLES2CommandBuffer::recordQuery(QueryPool *queryPool, GLES2QueryOp op, uint query) {
+    GLES2CmdQuery *cmd = _gles2Allocator->queryCmdPool.alloc();
+    cmd->gpuQueryPool = ((GLES2QueryPool *)queryPool)->gpuQueryPool();
+    cmd->op = op;
+    cmd->id = query;
+
+    _cmdPackage->queryCmds.push(cmd);
+    _cmdPackage->cmds.push(GFXCmdType::QUERY);
+}
+
 void GLES2CommandBuffer::BindStates() {
     GLES2CmdBindStates *cmd = _gles2Allocator->bindStatesCmdPool.alloc();
     cmd->gpuPipelineState = _curGPUPipelineState;
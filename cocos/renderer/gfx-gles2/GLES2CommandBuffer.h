@@ -21,8 +21,9 @@ public:
 
     virtual void begin(RenderPass *renderPass, uint subpass, Framebuffer *frameBuffer) override;
     virtual void end() override;
-    virtual void beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea, const Color *colors, float depth, int stencil) override;
+    virtual void beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea, const Color *colors, float depth, int stencil, const CommandBuffer *const *secondaryCmdBuffs, uint secondaryCmdBuffCount) override;
     virtual void endRenderPass() override;
+    virtual void nextSubpass() override;
     virtual void bindPipelineState(PipelineState *pso) override;
     virtual void bindDescriptorSet(uint set, DescriptorSet *descriptorSet, uint dynamicOffsetCount, const uint *dynamicOffsets) override;
     virtual void bindInputAssembler(InputAssembler *ia) override;
@@ -35,12 +36,19 @@ public:
     virtual void setStencilWriteMask(StencilFace face, uint mask) override;
     virtual void setStencilCompareMask(StencilFace face, int ref, uint mask) override;
     virtual void draw(InputAssembler *ia) override;
+    virtual void drawIndirect(InputAssembler *ia, Buffer *indirectBuffer, uint drawOffset, uint drawCount) override;
     virtual void updateBuffer(Buffer *buff, const void *data, uint size, uint offset) override;
     virtual void copyBuffersToTexture(const uint8_t *const *buffers, Texture *texture, const BufferTextureCopy *regions, uint count) override;
+    virtual void copyTexture(Texture *srcTexture, Texture *dstTexture, const TextureCopy *regions, uint count) override;
     virtual void execute(const CommandBuffer *const *cmdBuffs, uint32_t count) override;
+    virtual void resetQueryPool(QueryPool *queryPool) override;
+    virtual void writeTimestamp(QueryPool *queryPool, uint query) override;
+    virtual void beginQuery(QueryPool *queryPool, uint query) override;
+    virtual void endQuery(QueryPool *queryPool, uint query) override;
 
 private:
     void BindStates();
+    void recordQuery(QueryPool *queryPool, GLES2QueryOp op, uint query);
 
 private:
     GLES2CmdPackage *_cmdPackage = nullptr;
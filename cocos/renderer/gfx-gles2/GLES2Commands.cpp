@@ -3,6 +3,7 @@
 #include "GLES2Commands.h"
 #include "GLES2Context.h"
 #include "GLES2Device.h"
+#include "platform/FileUtils.h"
 
 #define BUFFER_OFFSET(idx) (static_cast<char *>(0) + (idx))
 
@@ -917,93 +918,226 @@ void GLES2CmdFuncCreateSampler(GLES2Device *device, GLES2GPUSampler *gpuSampler)
 void GLES2CmdFuncDestroySampler(GLES2Device *device, GLES2GPUSampler *gpuSampler) {
 }
 
+namespace {
+const uint PROGRAM_BINARY_MAGIC = 0x43434750; // 'CCGP'
+const uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+
+// stored in front of the driver blob, the blob is discarded if anything here mismatches
+struct ProgramBinaryFileHeader {
+    uint magic = PROGRAM_BINARY_MAGIC;
+    uint format = 0u;
+    uint64_t driverHash = 0u;
+    uint64_t sourceHash = 0u;
+    uint dataSize = 0u;
+};
+
+// FNV-1a, the hashes name files and have to stay the same across runs
+uint64_t hashBytes(uint64_t hash, const void *data, size_t size) {
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+uint64_t hashProgramSources(const GLES2GPUShader *gpuShader) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (const GLES2GPUShaderStage &gpuStage : gpuShader->gpuStages) {
+        const uint type = static_cast<uint>(gpuStage.type);
+        hash = hashBytes(hash, &type, sizeof(type));
+        hash = hashBytes(hash, gpuStage.source.data(), gpuStage.source.size() + 1);
+    }
+    return hash;
+}
+
+String getProgramBinaryPath(const GLES2GPUProgramCache *gpuProgramCache, uint64_t sourceHash) {
+    char name[24];
+    snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(sourceHash));
+    return gpuProgramCache->path + name;
+}
+
+bool loadProgramBinary(const GLES2GPUProgramCache *gpuProgramCache, GLES2GPUShader *gpuShader, uint64_t sourceHash) {
+    FileUtils *fileUtils = FileUtils::getInstance();
+    const String path = getProgramBinaryPath(gpuProgramCache, sourceHash);
+    if (!fileUtils->isFileExist(path)) return false;
+
+    Data data = fileUtils->getDataFromFile(path);
+    ProgramBinaryFileHeader header;
+    if ((size_t)data.getSize() > sizeof(header)) {
+        memcpy(&header, data.getBytes(), sizeof(header));
+    }
+    if (header.magic != PROGRAM_BINARY_MAGIC || header.driverHash != gpuProgramCache->driverHash ||
+        header.sourceHash != sourceHash || header.dataSize != data.getSize() - sizeof(header)) {
+        fileUtils->removeFile(path);
+        return false;
+    }
+
+    gpuShader->glProgram = glCreateProgram();
+    glProgramBinaryOES(gpuShader->glProgram, header.format, data.getBytes() + sizeof(header), header.dataSize);
+
+    // the driver may still reject a binary that passed the header check
+    GLint status = 0;
+    glGetProgramiv(gpuShader->glProgram, GL_LINK_STATUS, &status);
+    if (status != 1) {
+        glDeleteProgram(gpuShader->glProgram);
+        gpuShader->glProgram = 0;
+        fileUtils->removeFile(path);
+        return false;
+    }
+    return true;
+}
+
+void saveProgramBinary(const GLES2GPUProgramCache *gpuProgramCache, const GLES2GPUShader *gpuShader, uint64_t sourceHash) {
+    GLint length = 0;
+    glGetProgramiv(gpuShader->glProgram, GL_PROGRAM_BINARY_LENGTH_OES, &length);
+    if (length <= 0) return;
+
+    ProgramBinaryFileHeader header;
+    header.driverHash = gpuProgramCache->driverHash;
+    header.sourceHash = sourceHash;
+
+    // released by Data through free()
+    auto *buffer = (uint8_t *)malloc(sizeof(header) + length);
+    GLsizei dataSize = 0;
+    GLenum format = 0;
+    glGetProgramBinaryOES(gpuShader->glProgram, length, &dataSize, &format, buffer + sizeof(header));
+    if (dataSize <= 0) {
+        free(buffer);
+        return;
+    }
+    header.format = format;
+    header.dataSize = (uint)dataSize;
+    memcpy(buffer, &header, sizeof(header));
+
+    Data data;
+    data.fastSet(buffer, sizeof(header) + dataSize);
+    if (!FileUtils::getInstance()->writeDataToFile(data, getProgramBinaryPath(gpuProgramCache, sourceHash))) {
+        CC_LOG_WARNING("Failed to write the program binary of shader '%s'.", gpuShader->name.c_str());
+    }
+}
+} // namespace
+
+void GLES2CmdFuncCreateProgramCache(GLES2Device *device, GLES2GPUProgramCache *gpuProgramCache) {
+    if (!device->checkExtension("get_program_binary") || !glGetProgramBinaryOES || !glProgramBinaryOES) return;
+
+    GLint formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS_OES, &formatCount);
+    if (formatCount <= 0) return;
+
+    // the version string names the driver build, an update of it invalidates every binary
+    FileUtils *fileUtils = FileUtils::getInstance();
+    const String driver = device->getRenderer() + "\n" + device->getVendor() + "\n" + device->getVersion();
+    const String path = fileUtils->getWritablePath() + "gles2_program_cache/";
+    const String driverPath = path + "driver.txt";
+    if (!fileUtils->isFileExist(driverPath) || fileUtils->getStringFromFile(driverPath) != driver) {
+        fileUtils->removeDirectory(path);
+        if (!fileUtils->createDirectory(path) || !fileUtils->writeStringToFile(driver, driverPath)) {
+            CC_LOG_WARNING("GLES2 program cache unavailable.");
+            return;
+        }
+    }
+    gpuProgramCache->path = path;
+    gpuProgramCache->driverHash = hashBytes(FNV_OFFSET_BASIS, driver.data(), driver.size());
+}
+
 void GLES2CmdFuncCreateShader(GLES2Device *device, GLES2GPUShader *gpuShader) {
     GLenum glShaderType = 0;
     String shaderTypeStr;
     GLint status;
 
-    for (size_t i = 0; i < gpuShader->gpuStages.size(); ++i) {
-        GLES2GPUShaderStage &gpuStage = gpuShader->gpuStages[i];
+    GLES2GPUProgramCache *gpuProgramCache = device->programCache();
+    const bool useProgramCache = gpuProgramCache && !gpuProgramCache->path.empty();
+    const uint64_t sourceHash = useProgramCache ? hashProgramSources(gpuShader) : 0;
+    const bool isCached = useProgramCache && loadProgramBinary(gpuProgramCache, gpuShader, sourceHash);
 
-        switch (gpuStage.type) {
-            case ShaderStageFlagBit::VERTEX: {
-                glShaderType = GL_VERTEX_SHADER;
-                shaderTypeStr = "Vertex Shader";
-                break;
-            }
-            case ShaderStageFlagBit::FRAGMENT: {
-                glShaderType = GL_FRAGMENT_SHADER;
-                shaderTypeStr = "Fragment Shader";
-                break;
+    if (!isCached) {
+        for (size_t i = 0; i < gpuShader->gpuStages.size(); ++i) {
+            GLES2GPUShaderStage &gpuStage = gpuShader->gpuStages[i];
+
+            switch (gpuStage.type) {
+                case ShaderStageFlagBit::VERTEX: {
+                    glShaderType = GL_VERTEX_SHADER;
+                    shaderTypeStr = "Vertex Shader";
+                    break;
+                }
+                case ShaderStageFlagBit::FRAGMENT: {
+                    glShaderType = GL_FRAGMENT_SHADER;
+                    shaderTypeStr = "Fragment Shader";
+                    break;
+                }
+                default: {
+                    CCASSERT(false, "Unsupported ShaderStageFlagBit");
+                    return;
+                }
             }
-            default: {
-                CCASSERT(false, "Unsupported ShaderStageFlagBit");
+
+            gpuStage.glShader = glCreateShader(glShaderType);
+            const char *shaderSrc = gpuStage.source.c_str();
+            glShaderSource(gpuStage.glShader, 1, (const GLchar **)&shaderSrc, nullptr);
+            glCompileShader(gpuStage.glShader);
+
+            glGetShaderiv(gpuStage.glShader, GL_COMPILE_STATUS, &status);
+            if (status != 1) {
+                GLint logSize = 0;
+                glGetShaderiv(gpuStage.glShader, GL_INFO_LOG_LENGTH, &logSize);
+
+                ++logSize;
+                GLchar *logs = (GLchar *)CC_MALLOC(logSize);
+                glGetShaderInfoLog(gpuStage.glShader, logSize, nullptr, logs);
+
+                CC_LOG_ERROR("%s in %s compilation failed.", shaderTypeStr.c_str(), gpuShader->name.c_str());
+                CC_LOG_ERROR("Shader source:%s", gpuStage.source.c_str());
+                CC_LOG_ERROR(logs);
+                CC_FREE(logs);
+                glDeleteShader(gpuStage.glShader);
+                gpuStage.glShader = 0;
                 return;
             }
         }
 
-        gpuStage.glShader = glCreateShader(glShaderType);
-        const char *shaderSrc = gpuStage.source.c_str();
-        glShaderSource(gpuStage.glShader, 1, (const GLchar **)&shaderSrc, nullptr);
-        glCompileShader(gpuStage.glShader);
+        gpuShader->glProgram = glCreateProgram();
 
-        glGetShaderiv(gpuStage.glShader, GL_COMPILE_STATUS, &status);
-        if (status != 1) {
-            GLint logSize = 0;
-            glGetShaderiv(gpuStage.glShader, GL_INFO_LOG_LENGTH, &logSize);
-
-            ++logSize;
-            GLchar *logs = (GLchar *)CC_MALLOC(logSize);
-            glGetShaderInfoLog(gpuStage.glShader, logSize, nullptr, logs);
-
-            CC_LOG_ERROR("%s in %s compilation failed.", shaderTypeStr.c_str(), gpuShader->name.c_str());
-            CC_LOG_ERROR("Shader source:%s", gpuStage.source.c_str());
-            CC_LOG_ERROR(logs);
-            CC_FREE(logs);
-            glDeleteShader(gpuStage.glShader);
-            gpuStage.glShader = 0;
-            return;
+        // link program
+        for (size_t i = 0; i < gpuShader->gpuStages.size(); ++i) {
+            GLES2GPUShaderStage &gpuStage = gpuShader->gpuStages[i];
+            glAttachShader(gpuShader->glProgram, gpuStage.glShader);
         }
-    }
 
-    gpuShader->glProgram = glCreateProgram();
+        glLinkProgram(gpuShader->glProgram);
 
-    // link program
-    for (size_t i = 0; i < gpuShader->gpuStages.size(); ++i) {
-        GLES2GPUShaderStage &gpuStage = gpuShader->gpuStages[i];
-        glAttachShader(gpuShader->glProgram, gpuStage.glShader);
-    }
-
-    glLinkProgram(gpuShader->glProgram);
+        // detach & delete immediately
+        for (size_t i = 0; i < gpuShader->gpuStages.size(); ++i) {
+            GLES2GPUShaderStage &gpuStage = gpuShader->gpuStages[i];
+            if (gpuStage.glShader) {
+                glDetachShader(gpuShader->glProgram, gpuStage.glShader);
+                glDeleteShader(gpuStage.glShader);
+                gpuStage.glShader = 0;
+            }
+        }
 
-    // detach & delete immediately
-    for (size_t i = 0; i < gpuShader->gpuStages.size(); ++i) {
-        GLES2GPUShaderStage &gpuStage = gpuShader->gpuStages[i];
-        if (gpuStage.glShader) {
-            glDetachShader(gpuShader->glProgram, gpuStage.glShader);
-            glDeleteShader(gpuStage.glShader);
-            gpuStage.glShader = 0;
+        glGetProgramiv(gpuShader->glProgram, GL_LINK_STATUS, &status);
+        if (status != 1) {
+            CC_LOG_ERROR("Failed to link Shader [%s].", gpuShader->name.c_str());
+            GLint logSize = 0;
+            glGetProgramiv(gpuShader->glProgram, GL_INFO_LOG_LENGTH, &logSize);
+            if (logSize) {
+                ++logSize;
+                GLchar *logs = (GLchar *)CC_MALLOC(logSize);
+                glGetProgramInfoLog(gpuShader->glProgram, logSize, nullptr, logs);
+
+                CC_LOG_ERROR("Failed to link shader '%s'.", gpuShader->name.c_str());
+                CC_LOG_ERROR(logs);
+                CC_FREE(logs);
+                return;
+            }
         }
-    }
 
-    glGetProgramiv(gpuShader->glProgram, GL_LINK_STATUS, &status);
-    if (status != 1) {
-        CC_LOG_ERROR("Failed to link Shader [%s].", gpuShader->name.c_str());
-        GLint logSize = 0;
-        glGetProgramiv(gpuShader->glProgram, GL_INFO_LOG_LENGTH, &logSize);
-        if (logSize) {
-            ++logSize;
-            GLchar *logs = (GLchar *)CC_MALLOC(logSize);
-            glGetProgramInfoLog(gpuShader->glProgram, logSize, nullptr, logs);
-
-            CC_LOG_ERROR("Failed to link shader '%s'.", gpuShader->name.c_str());
-            CC_LOG_ERROR(logs);
-            CC_FREE(logs);
-            return;
+        if (useProgramCache && status == 1) {
+            saveProgramBinary(gpuProgramCache, gpuShader, sourceHash);
         }
     }
 
-    CC_LOG_INFO("Shader '%s' compilation succeeded.", gpuShader->name.c_str());
+    CC_LOG_INFO("Shader '%s' %s.", gpuShader->name.c_str(), isCached ? "loaded from the program cache" : "compilation succeeded");
 
     GLint attrMaxLength = 0;
     GLint attrCount = 0;
@@ -1364,6 +1498,42 @@ void GLES2CmdFuncDestroyFramebuffer(GLES2Device *device, GLES2GPUFramebuffer *gp
     }
 }
 
+void GLES2CmdFuncCreateQueryPool(GLES2Device *device, GLES2GPUQueryPool *gpuQueryPool) {
+    gpuQueryPool->glQueryIds.resize(gpuQueryPool->maxQueryObjects);
+    glGenQueriesEXT(gpuQueryPool->maxQueryObjects, gpuQueryPool->glQueryIds.data());
+}
+
+void GLES2CmdFuncDestroyQueryPool(GLES2Device *device, GLES2GPUQueryPool *gpuQueryPool) {
+    if (gpuQueryPool->glQueryIds.size()) {
+        glDeleteQueriesEXT((GLsizei)gpuQueryPool->glQueryIds.size(), gpuQueryPool->glQueryIds.data());
+        gpuQueryPool->glQueryIds.clear();
+    }
+}
+
+bool GLES2CmdFuncGetQueryResults(GLES2Device *device, GLES2GPUQueryPool *gpuQueryPool, uint first, uint count, uint64_t *results) {
+    bool isTimestamp = gpuQueryPool->type == QueryType::TIMESTAMP;
+    // a disjoint operation invalidates every timestamp in flight
+    GLint disjoint = 0;
+    if (isTimestamp) glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+
+    // queries complete in submission order, the last one being available covers the whole range
+    GLuint available = GL_FALSE;
+    glGetQueryObjectuivEXT(gpuQueryPool->glQueryIds[first + count - 1], GL_QUERY_RESULT_AVAILABLE_EXT, &available);
+    if (!available || disjoint) return false;
+
+    for (uint i = 0u; i < count; ++i) {
+        GLuint glQuery = gpuQueryPool->glQueryIds[first + i];
+        if (isTimestamp) {
+            glGetQueryObjectui64vEXT(glQuery, GL_QUERY_RESULT_EXT, &results[i]);
+        } else {
+            GLuint result = 0u;
+            glGetQueryObjectuivEXT(glQuery, GL_QUERY_RESULT_EXT, &result);
+            results[i] = result;
+        }
+    }
+    return true;
+}
+
 void GLES2CmdFuncExecuteCmds(GLES2Device *device, GLES2CmdPackage *cmdPackage) {
     static uint cmdIndices[(int)GFXCmdType::COUNT] = {0};
     static GLenum glAttachments[GFX_MAX_ATTACHMENTS] = {0};
@@ -2231,7 +2401,8 @@ void GLES2CmdFuncExecuteCmds(GLES2Device *device, GLES2CmdPackage *cmdPackage) {
             case GFXCmdType::DRAW: {
                 GLES2CmdDraw *cmd = cmdPackage->drawCmds[cmdIdx];
                 if (gpuInputAssembler && gpuPipelineState) {
-                    if (!gpuInputAssembler->gpuIndirectBuffer) {
+                    const auto *gpuIndirectBuffer = cmd->gpuIndirectBuffer ? cmd->gpuIndirectBuffer : gpuInputAssembler->gpuIndirectBuffer;
+                    if (!gpuIndirectBuffer) {
 
                         if (gpuInputAssembler->gpuIndexBuffer) {
                             if (cmd->drawInfo.indexCount > 0) {
@@ -2255,13 +2426,16 @@ void GLES2CmdFuncExecuteCmds(GLES2Device *device, GLES2CmdPackage *cmdPackage) {
                             }
                         }
                     } else {
-                        for (size_t j = 0; j < gpuInputAssembler->gpuIndirectBuffer->indirects.size(); ++j) {
-                            const DrawInfo &draw = gpuInputAssembler->gpuIndirectBuffer->indirects[j];
+                        const size_t drawCount = gpuIndirectBuffer->indirects.size();
+                        const size_t begin = cmd->gpuIndirectBuffer ? std::min<size_t>(cmd->drawOffset, drawCount) : 0;
+                        const size_t end = cmd->gpuIndirectBuffer ? std::min<size_t>(begin + cmd->drawCount, drawCount) : drawCount;
+                        for (size_t j = begin; j < end; ++j) {
+                            const DrawInfo &draw = gpuIndirectBuffer->indirects[j];
                             if (gpuInputAssembler->gpuIndexBuffer) {
                                 if (draw.indexCount > 0) {
                                     uint8_t *offset = 0;
                                     offset += draw.firstIndex * gpuInputAssembler->gpuIndexBuffer->stride;
-                                    if (cmd->drawInfo.instanceCount == 0) {
+                                    if (draw.instanceCount == 0) {
                                         glDrawElements(glPrimitive, draw.indexCount, gpuInputAssembler->glIndexType, offset);
                                     } else {
                                         if (device->useDrawInstanced()) {
@@ -2293,6 +2467,21 @@ void GLES2CmdFuncExecuteCmds(GLES2Device *device, GLES2CmdPackage *cmdPackage) {
                 GLES2CmdFuncCopyBuffersToTexture(device, cmd->buffers.data(), cmd->gpuTexture, cmd->regions, cmd->count);
                 break;
             }
+            case GFXCmdType::COPY_TEXTURE: {
+                GLES2CmdCopyTexture *cmd = cmdPackage->copyTextureCmds[cmdIdx];
+                GLES2CmdFuncCopyTexture(device, cmd->gpuSrcTexture, cmd->gpuDstTexture, cmd->regions.data(), (uint)cmd->regions.size());
+                break;
+            }
+            case GFXCmdType::QUERY: {
+                GLES2CmdQuery *cmd = cmdPackage->queryCmds[cmdIdx];
+                GLuint glQuery = cmd->gpuQueryPool->glQueryIds[cmd->id];
+                switch (cmd->op) {
+                    case GLES2QueryOp::WRITE_TIMESTAMP: glQueryCounterEXT(glQuery, GL_TIMESTAMP_EXT); break;
+                    case GLES2QueryOp::BEGIN: glBeginQueryEXT(GL_ANY_SAMPLES_PASSED_CONSERVATIVE_EXT, glQuery); break;
+                    case GLES2QueryOp::END: glEndQueryEXT(GL_ANY_SAMPLES_PASSED_CONSERVATIVE_EXT); break;
+                }
+                break;
+            }
             default:
                 break;
         } // namespace cc
@@ -2459,5 +2648,42 @@ void GLES2CmdFuncCopyBuffersToTexture(GLES2Device *device, const uint8_t *const
     }
 }
 
+void GLES2CmdFuncCopyTexture(GLES2Device *device, GLES2GPUTexture *gpuSrcTexture, GLES2GPUTexture *gpuDstTexture, const TextureCopy *regions, uint count) {
+    // ES 2.0 has no framebuffer blits, only color can be read back into a texture
+    const FormatInfo &info = GFX_FORMAT_INFOS[(uint)gpuSrcTexture->format];
+    if (info.hasDepth || info.hasStencil) {
+        CC_LOG_ERROR("GLES2CmdFuncCopyTexture: copying depth stencil textures is not supported.");
+        return;
+    }
+
+    GLES2GPUStateCache *cache = device->stateCache();
+    if (!cache->glCopyFBO) {
+        glGenFramebuffers(1, &cache->glCopyFBO);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, cache->glCopyFBO);
+
+    GLuint &glTexture = cache->glTextures[cache->texUint];
+    if (glTexture != gpuDstTexture->glTexture) {
+        glBindTexture(gpuDstTexture->glTarget, gpuDstTexture->glTexture);
+        glTexture = gpuDstTexture->glTexture;
+    }
+
+    const bool isSrcCube = gpuSrcTexture->glTarget == GL_TEXTURE_CUBE_MAP;
+    const bool isDstCube = gpuDstTexture->glTarget == GL_TEXTURE_CUBE_MAP;
+    for (uint i = 0u; i < count; ++i) {
+        const TextureCopy &region = regions[i];
+        for (uint l = 0u; l < region.srcSubres.layerCount; ++l) {
+            const GLenum glSrcTarget = isSrcCube ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + region.srcSubres.baseArrayLayer + l : gpuSrcTexture->glTarget;
+            const GLenum glDstTarget = isDstCube ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + region.dstSubres.baseArrayLayer + l : gpuDstTexture->glTarget;
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, glSrcTarget, gpuSrcTexture->glTexture, region.srcSubres.mipLevel);
+            glCopyTexSubImage2D(glDstTarget, region.dstSubres.mipLevel, region.dstOffset.x, region.dstOffset.y,
+                                region.srcOffset.x, region.srcOffset.y, (GLsizei)region.extent.width, (GLsizei)region.extent.height);
+        }
+    }
+
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, cache->glFramebuffer);
+}
+
 } // namespace gfx
 } // namespace cc
@@ -114,9 +114,15 @@ public:
 class GLES2CmdDraw : public GFXCmd {
 public:
     DrawInfo drawInfo;
+    // replaces the indirect buffer of the input assembler for drawIndirect
+    GLES2GPUBuffer *gpuIndirectBuffer = nullptr;
+    uint drawOffset = 0;
+    uint drawCount = 0;
 
     GLES2CmdDraw() : GFXCmd(GFXCmdType::DRAW) {}
-    virtual void clear() override {}
+    virtual void clear() override {
+        gpuIndirectBuffer = nullptr;
+    }
 };
 
 class GLES2CmdUpdateBuffer : public GFXCmd {
@@ -151,6 +157,40 @@ public:
     }
 };
 
+class GLES2CmdCopyTexture : public GFXCmd {
+public:
+    GLES2GPUTexture *gpuSrcTexture = nullptr;
+    GLES2GPUTexture *gpuDstTexture = nullptr;
+    vector<TextureCopy> regions;
+
+    GLES2CmdCopyTexture() : GFXCmd(GFXCmdType::COPY_TEXTURE) {}
+
+    virtual void clear() override {
+        gpuSrcTexture = nullptr;
+        gpuDstTexture = nullptr;
+        regions.clear();
+    }
+};
+
+enum class GLES2QueryOp : uint8_t {
+    WRITE_TIMESTAMP,
+    BEGIN,
+    END,
+};
+
+class GLES2CmdQuery : public GFXCmd {
+public:
+    GLES2GPUQueryPool *gpuQueryPool = nullptr;
+    GLES2QueryOp op = GLES2QueryOp::WRITE_TIMESTAMP;
+    uint id = 0u;
+
+    GLES2CmdQuery() : GFXCmd(GFXCmdType::QUERY) {}
+
+    virtual void clear() override {
+        gpuQueryPool = nullptr;
+    }
+};
+
 class GLES2CmdPackage : public Object {
 public:
     CachedArray<GFXCmdType> cmds;
@@ -159,6 +199,8 @@ public:
     CachedArray<GLES2CmdDraw *> drawCmds;
     CachedArray<GLES2CmdUpdateBuffer *> updateBufferCmds;
     CachedArray<GLES2CmdCopyBufferToTexture *> copyBufferToTextureCmds;
+    CachedArray<GLES2CmdCopyTexture *> copyTextureCmds;
+    CachedArray<GLES2CmdQuery *> queryCmds;
 };
 
 class GLES2GPUCommandAllocator : public Object {
@@ -168,6 +210,8 @@ public:
     CommandPool<GLES2CmdDraw> drawCmdPool;
     CommandPool<GLES2CmdUpdateBuffer> updateBufferCmdPool;
     CommandPool<GLES2CmdCopyBufferToTexture> copyBufferToTextureCmdPool;
+    CommandPool<GLES2CmdCopyTexture> copyTextureCmdPool;
+    CommandPool<GLES2CmdQuery> queryCmdPool;
 
     void clearCmds(GLES2CmdPackage *cmd_package) {
         if (cmd_package->beginRenderPassCmds.size()) {
@@ -185,6 +229,12 @@ public:
         if (cmd_package->copyBufferToTextureCmds.size()) {
             copyBufferToTextureCmdPool.freeCmds(cmd_package->copyBufferToTextureCmds);
         }
+        if (cmd_package->copyTextureCmds.size()) {
+            copyTextureCmdPool.freeCmds(cmd_package->copyTextureCmds);
+        }
+        if (cmd_package->queryCmds.size()) {
+            queryCmdPool.freeCmds(cmd_package->queryCmds);
+        }
 
         cmd_package->cmds.clear();
     }
@@ -195,6 +245,8 @@ public:
         drawCmdPool.release();
         updateBufferCmdPool.release();
         copyBufferToTextureCmdPool.release();
+        copyTextureCmdPool.release();
+        queryCmdPool.release();
     }
 };
 
@@ -207,14 +259,19 @@ CC_GLES2_API void GLES2CmdFuncDestroyTexture(GLES2Device *device, GLES2GPUTextur
 CC_GLES2_API void GLES2CmdFuncResizeTexture(GLES2Device *device, GLES2GPUTexture *gpuTexture);
 CC_GLES2_API void GLES2CmdFuncCreateSampler(GLES2Device *device, GLES2GPUSampler *gpuSampler);
 CC_GLES2_API void GLES2CmdFuncDestroySampler(GLES2Device *device, GLES2GPUSampler *gpuSampler);
+CC_GLES2_API void GLES2CmdFuncCreateProgramCache(GLES2Device *device, GLES2GPUProgramCache *gpuProgramCache);
 CC_GLES2_API void GLES2CmdFuncCreateShader(GLES2Device *device, GLES2GPUShader *gpuShader);
 CC_GLES2_API void GLES2CmdFuncDestroyShader(GLES2Device *device, GLES2GPUShader *gpuShader);
 CC_GLES2_API void GLES2CmdFuncCreateInputAssembler(GLES2Device *device, GLES2GPUInputAssembler *gpuInputAssembler);
 CC_GLES2_API void GLES2CmdFuncDestroyInputAssembler(GLES2Device *device, GLES2GPUInputAssembler *gpuInputAssembler);
 CC_GLES2_API void GLES2CmdFuncCreateFramebuffer(GLES2Device *device, GLES2GPUFramebuffer *gpuFBO);
 CC_GLES2_API void GLES2CmdFuncDestroyFramebuffer(GLES2Device *device, GLES2GPUFramebuffer *gpuFBO);
+CC_GLES2_API void GLES2CmdFuncCreateQueryPool(GLES2Device *device, GLES2GPUQueryPool *gpuQueryPool);
+CC_GLES2_API void GLES2CmdFuncDestroyQueryPool(GLES2Device *device, GLES2GPUQueryPool *gpuQueryPool);
+CC_GLES2_API bool GLES2CmdFuncGetQueryResults(GLES2Device *device, GLES2GPUQueryPool *gpuQueryPool, uint first, uint count, uint64_t *results);
 CC_GLES2_API void GLES2CmdFuncExecuteCmds(GLES2Device *device, GLES2CmdPackage *cmd_package);
 CC_GLES2_API void GLES2CmdFuncCopyBuffersToTexture(GLES2Device *device, const uint8_t *const *buffers, GLES2GPUTexture *gpuTexture, const BufferTextureCopy *regions, uint count);
+CC_GLES2_API void GLES2CmdFuncCopyTexture(GLES2Device *device, GLES2GPUTexture *gpuSrcTexture, GLES2GPUTexture *gpuDstTexture, const TextureCopy *regions, uint count);
 
 } // namespace gfx
 } // namespace cc
@@ -11,11 +11,13 @@
 #include "GLES2InputAssembler.h"
 #include "GLES2PipelineLayout.h"
 #include "GLES2PipelineState.h"
+#include "GLES2QueryPool.h"
 #include "GLES2Queue.h"
 #include "GLES2RenderPass.h"
 #include "GLES2Sampler.h"
 #include "GLES2Shader.h"
 #include "GLES2Texture.h"
+#include "base/Startup.h"
 
 namespace cc {
 namespace gfx {
@@ -27,6 +29,7 @@ GLES2Device::~GLES2Device() {
 }
 
 bool GLES2Device::initialize(const DeviceInfo &info) {
+    CC_STARTUP_PHASE("GFXDevice");
     _API = API::GLES2;
     _deviceName = "GLES2";
     _width = info.width;
@@ -78,6 +81,9 @@ bool GLES2Device::initialize(const DeviceInfo &info) {
     if (checkExtension("texture_half_float_linear"))
         _features[(int)Feature::TEXTURE_HALF_FLOAT_LINEAR] = true;
 
+    if (checkExtension("disjoint_timer_query") && glQueryCounterEXT && glGetQueryObjectui64vEXT)
+        _features[(int)Feature::TIMESTAMP_QUERY] = true;
+
     if (checkExtension("draw_buffers"))
         _features[(int)Feature::MULTIPLE_RENDER_TARGETS] = true;
 
@@ -157,14 +163,21 @@ bool GLES2Device::initialize(const DeviceInfo &info) {
 
     _gpuStateCache->initialize(_maxTextureUnits, _maxVertexAttributes);
 
+    _gpuProgramCache = CC_NEW(GLES2GPUProgramCache);
+    GLES2CmdFuncCreateProgramCache(this, _gpuProgramCache);
+
     return true;
 }
 
 void GLES2Device::destroy() {
     CC_SAFE_DESTROY(_queue);
     CC_SAFE_DESTROY(_cmdBuff);
+    if (_gpuStateCache && _gpuStateCache->glCopyFBO) {
+        glDeleteFramebuffers(1, &_gpuStateCache->glCopyFBO);
+    }
     CC_SAFE_DESTROY(_context);
     CC_SAFE_DELETE(_gpuStagingBufferPool);
+    CC_SAFE_DELETE(_gpuProgramCache);
     CC_SAFE_DELETE(_gpuCmdAllocator);
     CC_SAFE_DELETE(_gpuStateCache);
 }
@@ -220,6 +233,15 @@ Queue *GLES2Device::createQueue(const QueueInfo &info) {
     return nullptr;
 }
 
+QueryPool *GLES2Device::createQueryPool(const QueryPoolInfo &info) {
+    QueryPool *queryPool = CC_NEW(GLES2QueryPool(this));
+    if (queryPool->initialize(info))
+        return queryPool;
+
+    CC_SAFE_DESTROY(queryPool);
+    return nullptr;
+}
+
 Buffer *GLES2Device::createBuffer(const BufferInfo &info) {
     Buffer *buffer = CC_NEW(GLES2Buffer(this));
     if (buffer->initialize(info))
@@ -266,6 +288,9 @@ Sampler *GLES2Device::createSampler(const SamplerInfo &info) {
 }
 
 Shader *GLES2Device::createShader(const ShaderInfo &info) {
+    Shader *prewarmed = takePrewarmedShader(info);
+    if (prewarmed) return prewarmed;
+
     Shader *shader = CC_NEW(GLES2Shader(this));
     if (shader->initialize(info))
         return shader;
@@ -341,6 +366,11 @@ void GLES2Device::copyBuffersToTexture(const uint8_t *const *buffers, Texture *d
     GLES2CmdFuncCopyBuffersToTexture(this, buffers, ((GLES2Texture *)dst)->gpuTexture(), regions, count);
 }
 
+void GLES2Device::copyBuffersToTextureAsync(const uint8_t *const *buffers, Texture *dst, const BufferTextureCopy *regions, uint count, Fence *fence) {
+    // no sync objects to share textures across contexts with, GLES2 fences are always signaled
+    copyBuffersToTexture(buffers, dst, regions, count);
+}
+
 bool GLES2Device::checkForETC2() const {
     GLint numFormats = 0;
     glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &numFormats);
@@ -15,6 +15,7 @@ namespace gfx {
 class GLES2GPUStateCache;
 class GLES2GPUCommandAllocator;
 class GLES2GPUStagingBufferPool;
+class GLES2GPUProgramCache;
 
 class CC_GLES2_API GLES2Device : public Device {
 public:
@@ -30,6 +31,7 @@ public:
     virtual CommandBuffer *createCommandBuffer(const CommandBufferInfo &info) override;
     virtual Fence *createFence(const FenceInfo &info) override;
     virtual Queue *createQueue(const QueueInfo &info) override;
+    virtual QueryPool *createQueryPool(const QueryPoolInfo &info) override;
     virtual Buffer *createBuffer(const BufferInfo &info) override;
     virtual Buffer *createBuffer(const BufferViewInfo &info) override;
     virtual Texture *createTexture(const TextureInfo &info) override;
@@ -44,6 +46,7 @@ public:
     virtual PipelineLayout *createPipelineLayout(const PipelineLayoutInfo &info) override;
     virtual PipelineState *createPipelineState(const PipelineStateInfo &info) override;
     virtual void copyBuffersToTexture(const uint8_t *const *buffers, Texture *dst, const BufferTextureCopy *regions, uint count) override;
+    virtual void copyBuffersToTextureAsync(const uint8_t *const *buffers, Texture *dst, const BufferTextureCopy *regions, uint count, Fence *fence) override;
     bool checkForETC2() const;
 
     CC_INLINE bool useVAO() const { return _useVAO; }
@@ -54,6 +57,7 @@ public:
     CC_INLINE GLES2GPUStateCache *stateCache() const { return _gpuStateCache; }
     CC_INLINE GLES2GPUCommandAllocator *cmdAllocator() const { return _gpuCmdAllocator; }
     CC_INLINE GLES2GPUStagingBufferPool *stagingBufferPool() const { return _gpuStagingBufferPool; }
+    CC_INLINE GLES2GPUProgramCache *programCache() const { return _gpuProgramCache; }
 
     CC_INLINE bool checkExtension(const String &extension) const {
         for (size_t i = 0; i < _extensions.size(); ++i) {
@@ -68,6 +72,7 @@ private:
     GLES2GPUStateCache *_gpuStateCache = nullptr;
     GLES2GPUCommandAllocator *_gpuCmdAllocator = nullptr;
     GLES2GPUStagingBufferPool *_gpuStagingBufferPool = nullptr;
+    GLES2GPUProgramCache *_gpuProgramCache = nullptr;
 
     StringArray _extensions;
 
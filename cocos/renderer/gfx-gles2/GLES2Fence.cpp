@@ -41,5 +41,10 @@ void GLES2Fence::reset() {
     // TODO
 }
 
+bool GLES2Fence::isSignaled() {
+    // nothing is submitted asynchronously
+    return true;
+}
+
 } // namespace gfx
 } // namespace cc
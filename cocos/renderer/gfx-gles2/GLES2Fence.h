@@ -16,6 +16,7 @@ public:
     virtual void destroy() override;
     virtual void wait() override;
     virtual void reset() override;
+    virtual bool isSignaled() override;
 
 private:
     GLES2GPUFence *_gpuFence = nullptr;
@@ -263,6 +263,20 @@ class GLES2GPUFence : public Object {
 public:
 };
 
+class GLES2GPUQueryPool : public Object {
+public:
+    QueryType type = QueryType::TIMESTAMP;
+    uint maxQueryObjects = 0u;
+    vector<GLuint> glQueryIds;
+};
+
+// The linked programs of earlier runs, one file each in the directory, which is emptied once the driver changed.
+class GLES2GPUProgramCache : public Object {
+public:
+    String path; // empty without GL_OES_get_program_binary or any binary format
+    uint64_t driverHash = 0;
+};
+
 class GLES2GPUStateCache : public Object {
 public:
     GLuint glArrayBuffer = 0;
@@ -276,6 +290,7 @@ public:
     vector<bool> glCurrentAttribLocs;
     GLuint glFramebuffer = 0;
     GLuint glReadFBO = 0;
+    GLuint glCopyFBO = 0; // texture copies read their source through it
     Viewport viewport;
     Rect scissor;
     RasterizerState rs;
@@ -44,6 +44,7 @@ bool GLES2PipelineState::initialize(const PipelineStateInfo &info) {
     _dynamicStates = info.dynamicStates;
     _renderPass = info.renderPass;
     _pipelineLayout = info.pipelineLayout;
+    _subpass = info.subpass;
 
     _gpuPipelineState = CC_NEW(GLES2GPUPipelineState);
     _gpuPipelineState->glPrimitive = GLES2Primitives[(int)_primitive];
@@ -0,0 +1,53 @@
+#include "GLES2Std.h"
+
+#include "GLES2Commands.h"
+#include "GLES2Device.h"
+#include "GLES2QueryPool.h"
+
+namespace cc {
+namespace gfx {
+
+GLES2QueryPool::GLES2QueryPool(Device *device)
+: QueryPool(device) {
+}
+
+GLES2QueryPool::~GLES2QueryPool() {
+}
+
+bool GLES2QueryPool::initialize(const QueryPoolInfo &info) {
+    _type = info.type;
+    _maxQueryObjects = info.maxQueryObjects;
+
+    GLES2Device *device = (GLES2Device *)_device;
+    if (_type == QueryType::TIMESTAMP && !device->hasFeature(Feature::TIMESTAMP_QUERY)) {
+        CC_LOG_ERROR("GLES2QueryPool: GL_EXT_disjoint_timer_query is not supported.");
+        return false;
+    }
+    if (_type == QueryType::OCCLUSION && !device->checkExtension("occlusion_query_boolean")) {
+        CC_LOG_ERROR("GLES2QueryPool: GL_EXT_occlusion_query_boolean is not supported.");
+        return false;
+    }
+
+    _gpuQueryPool = CC_NEW(GLES2GPUQueryPool);
+    _gpuQueryPool->type = _type;
+    _gpuQueryPool->maxQueryObjects = _maxQueryObjects;
+
+    GLES2CmdFuncCreateQueryPool(device, _gpuQueryPool);
+
+    return true;
+}
+
+void GLES2QueryPool::destroy() {
+    if (_gpuQueryPool) {
+        GLES2CmdFuncDestroyQueryPool((GLES2Device *)_device, _gpuQueryPool);
+        CC_DELETE(_gpuQueryPool);
+        _gpuQueryPool = nullptr;
+    }
+}
+
+bool GLES2QueryPool::getResults(uint first, uint count, uint64_t *results) {
+    return GLES2CmdFuncGetQueryResults((GLES2Device *)_device, _gpuQueryPool, first, count, results);
+}
+
+} // namespace gfx
+} // namespace cc
@@ -0,0 +1,28 @@
+#ifndef CC_GFXGLES2_QUERY_POOL_H_
+#define CC_GFXGLES2_QUERY_POOL_H_
+
+namespace cc {
+namespace gfx {
+
+class GLES2GPUQueryPool;
+
+class CC_GLES2_API GLES2QueryPool : public QueryPool {
+public:
+    GLES2QueryPool(Device *device);
+    ~GLES2QueryPool();
+
+public:
+    virtual bool initialize(const QueryPoolInfo &info) override;
+    virtual void destroy() override;
+    virtual bool getResults(uint first, uint count, uint64_t *results) override;
+
+    CC_INLINE GLES2GPUQueryPool *gpuQueryPool() const { return _gpuQueryPool; }
+
+private:
+    GLES2GPUQueryPool *_gpuQueryPool = nullptr;
+};
+
+} // namespace gfx
+} // namespace cc
+
+#endif
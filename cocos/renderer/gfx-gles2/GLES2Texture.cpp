@@ -129,6 +129,7 @@ void GLES2Texture::resize(uint width, uint height) {
         _gpuTexture->width = _width;
         _gpuTexture->height = _height;
         _gpuTexture->size = _size;
+        _gpuTexture->mipLevel = _levelCount;
         GLES2CmdFuncResizeTexture((GLES2Device *)_device, _gpuTexture);
         status.bufferSize -= oldSize;
         status.bufferSize += _size;
@@ -1,7 +1,9 @@
 #include "GLES3Std.h"
+#include "base/FrameStats.h"
 
 #include "GLES3Buffer.h"
 #include "GLES3Commands.h"
+#include "GLES3Device.h"
 
 namespace cc {
 namespace gfx {
@@ -47,7 +49,9 @@ bool GLES3Buffer::initialize(const BufferInfo &info) {
         _gpuBuffer->buffer = _buffer;
     }
 
-    GLES3CmdFuncCreateBuffer((GLES3Device *)_device, _gpuBuffer);
+    GLES3Device *device = (GLES3Device *)_device;
+    GLES3GPUBuffer *gpuBuffer = _gpuBuffer;
+    device->execute([device, gpuBuffer]() { GLES3CmdFuncCreateBuffer(device, gpuBuffer); });
     _device->getMemoryStatus().bufferSize += _size;
     
     return true;
@@ -71,22 +75,34 @@ bool GLES3Buffer::initialize(const BufferViewInfo &info) {
     _gpuBuffer->size = _size;
     _gpuBuffer->stride = _stride;
     _gpuBuffer->count = _count;
-    _gpuBuffer->glTarget = buffer->_gpuBuffer->glTarget;
-    _gpuBuffer->glBuffer = buffer->_gpuBuffer->glBuffer;
     _gpuBuffer->glOffset = info.offset;
     _gpuBuffer->buffer = buffer->_gpuBuffer->buffer;
-    _gpuBuffer->indirects = buffer->_gpuBuffer->indirects;
+
+    // the source GL buffer is created on the render thread when multithreaded
+    GLES3GPUBuffer *gpuBuffer = _gpuBuffer;
+    GLES3GPUBuffer *srcGPUBuffer = buffer->_gpuBuffer;
+    ((GLES3Device *)_device)->execute([gpuBuffer, srcGPUBuffer]() {
+        gpuBuffer->glTarget = srcGPUBuffer->glTarget;
+        gpuBuffer->glBuffer = srcGPUBuffer->glBuffer;
+        gpuBuffer->indirects = srcGPUBuffer->indirects;
+    });
 
     return true;
 }
 
 void GLES3Buffer::destroy() {
     if (_gpuBuffer) {
+        GLES3Device *device = (GLES3Device *)_device;
+        GLES3GPUBuffer *gpuBuffer = _gpuBuffer;
         if (!_isBufferView) {
-            GLES3CmdFuncDestroyBuffer((GLES3Device *)_device, _gpuBuffer);
+            device->execute([device, gpuBuffer]() {
+                GLES3CmdFuncDestroyBuffer(device, gpuBuffer);
+                CC_DELETE(gpuBuffer);
+            });
             _device->getMemoryStatus().bufferSize -= _size;
+        } else {
+            device->execute([gpuBuffer]() { CC_DELETE(gpuBuffer); });
         }
-        CC_DELETE(_gpuBuffer);
         _gpuBuffer = nullptr;
     }
 
@@ -106,9 +122,14 @@ void GLES3Buffer::resize(uint size) {
         _count = _size / _stride;
 
         MemoryStatus &status = _device->getMemoryStatus();
-        _gpuBuffer->size = _size;
-        _gpuBuffer->count = _count;
-        GLES3CmdFuncResizeBuffer((GLES3Device *)_device, _gpuBuffer);
+        GLES3Device *device = (GLES3Device *)_device;
+        GLES3GPUBuffer *gpuBuffer = _gpuBuffer;
+        uint count = _count;
+        device->execute([device, gpuBuffer, size, count]() {
+            gpuBuffer->size = size;
+            gpuBuffer->count = count;
+            GLES3CmdFuncResizeBuffer(device, gpuBuffer);
+        });
         status.bufferSize -= oldSize;
         status.bufferSize += _size;
 
@@ -130,11 +151,24 @@ void GLES3Buffer::resize(uint size) {
 
 void GLES3Buffer::update(void *buffer, uint offset, uint size) {
     CCASSERT(!_isBufferView, "Cannot update through buffer views");
+    CC_FRAME_STAT_ADD(BUFFER_UPLOAD_BYTES, size);
 
     if (_buffer) {
         memcpy(_buffer + offset, buffer, size);
     }
-    GLES3CmdFuncUpdateBuffer((GLES3Device *)_device, _gpuBuffer, buffer, offset, size);
+
+    GLES3Device *device = (GLES3Device *)_device;
+    if (device->isMultithreaded()) {
+        uint8_t *data = (uint8_t *)CC_MALLOC(size);
+        memcpy(data, buffer, size);
+        GLES3GPUBuffer *gpuBuffer = _gpuBuffer;
+        device->execute([device, gpuBuffer, data, offset, size]() {
+            GLES3CmdFuncUpdateBuffer(device, gpuBuffer, data, offset, size);
+            CC_FREE(data);
+        });
+    } else {
+        GLES3CmdFuncUpdateBuffer(device, _gpuBuffer, buffer, offset, size);
+    }
 }
 
 } // namespace gfx
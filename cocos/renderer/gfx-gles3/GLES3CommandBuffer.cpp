@@ -1,4 +1,5 @@
 #include "GLES3Std.h"
+#include "base/FrameStats.h"
 
 #include "GLES3Buffer.h"
 #include "GLES3CommandBuffer.h"
@@ -7,6 +8,7 @@
 #include "GLES3Framebuffer.h"
 #include "GLES3InputAssembler.h"
 #include "GLES3PipelineState.h"
+#include "GLES3QueryPool.h"
 #include "GLES3RenderPass.h"
 #include "GLES3Texture.h"
 
@@ -36,6 +38,21 @@ bool GLES3CommandBuffer::initialize(const CommandBufferInfo &info) {
 }
 
 void GLES3CommandBuffer::destroy() {
+    GLES3RenderThread *renderThread = ((GLES3Device *)_device)->renderThread();
+    if (renderThread) {
+        renderThread->flush();
+    }
+
+    for (vector<GLES3CmdPackage *> &packages : _retiredPackages) {
+        _freePackages.insert(_freePackages.end(), packages.begin(), packages.end());
+        packages.clear();
+    }
+    for (GLES3CmdPackage *cmdPackage : _freePackages) {
+        if (_gles3Allocator) _gles3Allocator->clearCmds(cmdPackage);
+        CC_DELETE(cmdPackage);
+    }
+    _freePackages.clear();
+
     if (_gles3Allocator) {
         _gles3Allocator->clearCmds(_cmdPackage);
         _gles3Allocator = nullptr;
@@ -44,8 +61,34 @@ void GLES3CommandBuffer::destroy() {
     CC_SAFE_DELETE(_cmdPackage);
 }
 
+void GLES3CommandBuffer::recyclePackage() {
+    uint frameCount = ((GLES3Device *)_device)->getFrameCount();
+    vector<GLES3CmdPackage *> &retiredPackages = _retiredPackages[frameCount % GLES3RenderThread::FRAME_RESOURCE_COUNT];
+    if (_lastRecycleFrame != frameCount) {
+        // retired at least FRAME_RESOURCE_COUNT frames ago, already consumed by the render thread
+        for (GLES3CmdPackage *cmdPackage : retiredPackages) {
+            _gles3Allocator->clearCmds(cmdPackage);
+            _freePackages.push_back(cmdPackage);
+        }
+        retiredPackages.clear();
+        _lastRecycleFrame = frameCount;
+    }
+
+    retiredPackages.push_back(_cmdPackage);
+    if (_freePackages.empty()) {
+        _cmdPackage = CC_NEW(GLES3CmdPackage);
+    } else {
+        _cmdPackage = _freePackages.back();
+        _freePackages.pop_back();
+    }
+}
+
 void GLES3CommandBuffer::begin(RenderPass *renderPass, uint subpass, Framebuffer *frameBuffer) {
-    _gles3Allocator->clearCmds(_cmdPackage);
+    if (((GLES3Device *)_device)->isMultithreaded()) {
+        recyclePackage();
+    } else {
+        _gles3Allocator->clearCmds(_cmdPackage);
+    }
     _curGPUPipelineState = nullptr;
     _curGPUInputAssember = nullptr;
     _curGPUDescriptorSets.assign(_curGPUDescriptorSets.size(), nullptr);
@@ -63,7 +106,7 @@ void GLES3CommandBuffer::end() {
     _isInRenderPass = false;
 }
 
-void GLES3CommandBuffer::beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea, const Color *colors, float depth, int stencil) {
+void GLES3CommandBuffer::beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea, const Color *colors, float depth, int stencil, const CommandBuffer *const *secondaryCmdBuffs, uint secondaryCmdBuffCount) {
     _isInRenderPass = true;
 
     GLES3CmdBeginRenderPass *cmd = _gles3Allocator->beginRenderPassCmdPool.alloc();
@@ -85,7 +128,12 @@ void GLES3CommandBuffer::endRenderPass() {
     _cmdPackage->cmds.push(GFXCmdType::END_RENDER_PASS);
 }
 
+void GLES3CommandBuffer::nextSubpass() {
+    // render passes only have their first subpass without Feature::SUBPASS_INPUT
+}
+
 void GLES3CommandBuffer::bindPipelineState(PipelineState *pso) {
+    CC_FRAME_STAT_ADD(PIPELINE_STATE_BINDS, 1);
     GLES3GPUPipelineState *gpuPipelineState = ((GLES3PipelineState *)pso)->gpuPipelineState();
     if (_curGPUPipelineState != gpuPipelineState) {
         _curGPUPipelineState = gpuPipelineState;
@@ -94,6 +142,7 @@ void GLES3CommandBuffer::bindPipelineState(PipelineState *pso) {
 }
 
 void GLES3CommandBuffer::bindDescriptorSet(uint set, DescriptorSet *descriptorSet, uint dynamicOffsetCount, const uint *dynamicOffsets) {
+    CC_FRAME_STAT_ADD(DESCRIPTOR_SET_BINDS, 1);
     CCASSERT(_curGPUDescriptorSets.size() > set, "Invalid set index");
 
     GLES3GPUDescriptorSet *gpuDescriptorSet = ((GLES3DescriptorSet *)descriptorSet)->gpuDescriptorSet();
@@ -216,6 +265,7 @@ void GLES3CommandBuffer::draw(InputAssembler *ia) {
         _cmdPackage->cmds.push(GFXCmdType::DRAW);
 
         ++_numDrawCalls;
+        CC_FRAME_STAT_ADD(DRAW_CALLS, 1);
         _numInstances += ia->getInstanceCount();
         if (_curGPUPipelineState) {
             switch (_curGPUPipelineState->glPrimitive) {
@@ -237,7 +287,31 @@ void GLES3CommandBuffer::draw(InputAssembler *ia) {
     }
 }
 
+void GLES3CommandBuffer::drawIndirect(InputAssembler *ia, Buffer *indirectBuffer, uint drawOffset, uint drawCount) {
+    if ((_type == CommandBufferType::PRIMARY && _isInRenderPass) ||
+        (_type == CommandBufferType::SECONDARY)) {
+        if (_isStateInvalid) {
+            BindStates();
+        }
+
+        // GLES has no indirect draws, the arguments are replayed when the package is executed
+        GLES3CmdDraw *cmd = _gles3Allocator->drawCmdPool.alloc();
+        ((GLES3InputAssembler *)ia)->ExtractCmdDraw(cmd);
+        cmd->gpuIndirectBuffer = ((GLES3Buffer *)indirectBuffer)->gpuBuffer();
+        cmd->drawOffset = drawOffset;
+        cmd->drawCount = drawCount;
+        _cmdPackage->drawCmds.push(cmd);
+        _cmdPackage->cmds.push(GFXCmdType::DRAW);
+
+        _numDrawCalls += drawCount;
+        CC_FRAME_STAT_ADD(DRAW_CALLS, drawCount);
+    } else {
+        CC_LOG_ERROR("Command 'drawIndirect' must be recorded inside a render pass.");
+    }
+}
+
 void GLES3CommandBuffer::updateBuffer(Buffer *buff, const void *data, uint size, uint offset) {
+    CC_FRAME_STAT_ADD(BUFFER_UPLOAD_BYTES, size);
     if ((_type == CommandBufferType::PRIMARY && !_isInRenderPass) ||
         (_type == CommandBufferType::SECONDARY)) {
 
@@ -288,6 +362,26 @@ void GLES3CommandBuffer::copyBuffersToTexture(const uint8_t *const *buffers, Tex
     }
 }
 
+void GLES3CommandBuffer::copyTexture(Texture *srcTexture, Texture *dstTexture, const TextureCopy *regions, uint count) {
+    if ((_type == CommandBufferType::PRIMARY && !_isInRenderPass) ||
+        (_type == CommandBufferType::SECONDARY)) {
+
+        GLES3GPUTexture *gpuSrcTexture = ((GLES3Texture *)srcTexture)->gpuTexture();
+        GLES3GPUTexture *gpuDstTexture = ((GLES3Texture *)dstTexture)->gpuTexture();
+        if (gpuSrcTexture && gpuDstTexture) {
+            GLES3CmdCopyTexture *cmd = _gles3Allocator->copyTextureCmdPool.alloc();
+            cmd->gpuSrcTexture = gpuSrcTexture;
+            cmd->gpuDstTexture = gpuDstTexture;
+            cmd->regions.assign(regions, regions + count);
+
+            _cmdPackage->copyTextureCmds.push(cmd);
+            _cmdPackage->cmds.push(GFXCmdType::COPY_TEXTURE);
+        }
+    } else {
+        CC_LOG_ERROR("Command 'copyTexture' must be recorded outside a render pass.");
+    }
+}
+
 void GLES3CommandBuffer::execute(const CommandBuffer *const *cmdBuffs, uint32_t count) {
     for (uint i = 0; i < count; ++i) {
         GLES3CommandBuffer *cmdBuff = (GLES3CommandBuffer *)cmdBuffs[i];
@@ -317,6 +411,16 @@ void GLES3CommandBuffer::execute(const CommandBuffer *const *cmdBuffs, uint32_t
             ++cmd->refCount;
             _cmdPackage->copyBufferToTextureCmds.push(cmd);
         }
+        for (uint j = 0; j < cmdBuff->_cmdPackage->copyTextureCmds.size(); ++j) {
+            GLES3CmdCopyTexture *cmd = cmdBuff->_cmdPackage->copyTextureCmds[j];
+            ++cmd->refCount;
+            _cmdPackage->copyTextureCmds.push(cmd);
+        }
+        for (uint j = 0; j < cmdBuff->_cmdPackage->queryCmds.size(); ++j) {
+            GLES3CmdQuery *cmd = cmdBuff->_cmdPackage->queryCmds[j];
+            ++cmd->refCount;
+            _cmdPackage->queryCmds.push(cmd);
+        }
         _cmdPackage->cmds.concat(cmdBuff->_cmdPackage->cmds);
 
         _numDrawCalls += cmdBuff->getNumDrawCalls();
@@ -325,6 +429,33 @@ void GLES3CommandBuffer::execute(const CommandBuffer *const *cmdBuffs, uint32_t
     }
 }
 
+void GLES3CommandBuffer::resetQueryPool(QueryPool *queryPool) {
+    // GL queries are rewritten in place, only results cached for the previous use are invalidated
+    ((GLES3QueryPool *)queryPool)->gpuQueryPool()->generation++;
+}
+
+void GLES3CommandBuffer::writeTimestamp(QueryPool *queryPool, uint query) {
+    recordQuery(queryPool, GLES3QueryOp::WRITE_TIMESTAMP, query);
+}
+
+void GLES3CommandBuffer::beginQuery(QueryPool *queryPool, uint query) {
+    recordQuery(queryPool, GLES3QueryOp::BEGIN, query);
+}
+
+void GLES3CommandBuffer::endQuery(QueryPool *queryPool, uint query) {
+    recordQuery(queryPool, GLES3QueryOp::END, query);
+}
+
+void GLES3CommandBuffer::recordQuery(QueryPool *queryPool, GLES3QueryOp op, uint query) {
+    GLES3CmdQuery *cmd = _gles3Allocator->queryCmdPool.alloc();
+    cmd->gpuQueryPool = ((GLES3QueryPool *)queryPool)->gpuQueryPool();
+    cmd->op = op;
+    cmd->id = query;
+
+    _cmdPackage->queryCmds.push(cmd);
+    _cmdPackage->cmds.push(GFXCmdType::QUERY);
+}
+
 void GLES3CommandBuffer::BindStates() {
     GLES3CmdBindStates *cmd = _gles3Allocator->bindStatesCmdPool.alloc();
     cmd->gpuPipelineState = _curGPUPipelineState;
@@ -2,6 +2,7 @@
 #define CC_GFXGLES3_COMMAND_BUFFER_H_
 
 #include "GLES3Commands.h"
+#include "GLES3RenderThread.h"
 
 namespace cc {
 namespace gfx {
@@ -21,8 +22,9 @@ public:
 
     virtual void begin(RenderPass *renderPass, uint subpass, Framebuffer *frameBuffer) override;
     virtual void end() override;
-    virtual void beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea, const Color *colors, float depth, int stencil) override;
+    virtual void beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea, const Color *colors, float depth, int stencil, const CommandBuffer *const *secondaryCmdBuffs, uint secondaryCmdBuffCount) override;
     virtual void endRenderPass() override;
+    virtual void nextSubpass() override;
     virtual void bindPipelineState(PipelineState *pso) override;
     virtual void bindDescriptorSet(uint set, DescriptorSet *descriptorSet, uint dynamicOffsetCount, const uint *dynamicOffsets) override;
     virtual void bindInputAssembler(InputAssembler *ia) override;
@@ -35,15 +37,27 @@ public:
     virtual void setStencilWriteMask(StencilFace face, uint mask) override;
     virtual void setStencilCompareMask(StencilFace face, int ref, uint mask) override;
     virtual void draw(InputAssembler *ia) override;
+    virtual void drawIndirect(InputAssembler *ia, Buffer *indirectBuffer, uint drawOffset, uint drawCount) override;
     virtual void updateBuffer(Buffer *buff, const void *data, uint size, uint offset) override;
     virtual void copyBuffersToTexture(const uint8_t *const *buffers, Texture *texture, const BufferTextureCopy *regions, uint count) override;
+    virtual void copyTexture(Texture *srcTexture, Texture *dstTexture, const TextureCopy *regions, uint count) override;
     virtual void execute(const CommandBuffer *const *cmdBuffs, uint32_t count) override;
+    virtual void resetQueryPool(QueryPool *queryPool) override;
+    virtual void writeTimestamp(QueryPool *queryPool, uint query) override;
+    virtual void beginQuery(QueryPool *queryPool, uint query) override;
+    virtual void endQuery(QueryPool *queryPool, uint query) override;
 
 private:
     void BindStates();
+    void recordQuery(QueryPool *queryPool, GLES3QueryOp op, uint query);
+    void recyclePackage();
 
 private:
     GLES3CmdPackage *_cmdPackage = nullptr;
+    // with a render thread, submitted packages are only reused once their frame has been consumed
+    vector<GLES3CmdPackage *> _retiredPackages[GLES3RenderThread::FRAME_RESOURCE_COUNT];
+    vector<GLES3CmdPackage *> _freePackages;
+    uint _lastRecycleFrame = 0u;
     GLES3GPUCommandAllocator *_gles3Allocator = nullptr;
     bool _isInRenderPass = false;
     GLES3GPUPipelineState *_curGPUPipelineState = nullptr;
@@ -3,6 +3,9 @@
 #include "GLES3Commands.h"
 #include "GLES3Context.h"
 #include "GLES3Device.h"
+#include "platform/FileUtils.h"
+
+#include <algorithm>
 
 #define BUFFER_OFFSET(idx) (static_cast<char *>(0) + (idx))
 
@@ -577,6 +580,38 @@ const GLenum GLES3_BLEND_FACTORS[] = {
 };
 
 GLES3ObjectCache gfxStateCache;
+
+bool StreamBufferData(GLES3Device *device, GLES3GPUBuffer *gpuBuffer, const void *buffer, uint offset, uint size) {
+    if (!gpuBuffer->glBuffer) return false;
+
+    // the copy targets leave the VAO and the cached array/element/uniform bindings untouched
+    if (offset == 0 && size == gpuBuffer->size) {
+        // orphan the old storage instead of waiting for the draws still reading it
+        GLenum glUsage = (gpuBuffer->memUsage & MemoryUsageBit::HOST ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, gpuBuffer->glBuffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, size, nullptr, glUsage);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, 0, size, buffer);
+        return true;
+    }
+
+    GLES3GPUStagingRing *ring = device->stagingRing();
+    if (!ring || !ring->glBuffer) return false;
+
+    uint alignedOffset = (ring->curOffset + GLES3GPUStagingRing::ALIGNMENT - 1) & ~(GLES3GPUStagingRing::ALIGNMENT - 1);
+    if (alignedOffset + size > GLES3GPUStagingRing::SEGMENT_SIZE) return false;
+
+    uint ringOffset = ring->segmentIndex * GLES3GPUStagingRing::SEGMENT_SIZE + alignedOffset;
+    glBindBuffer(GL_COPY_READ_BUFFER, ring->glBuffer);
+    void *mapped = glMapBufferRange(GL_COPY_READ_BUFFER, ringOffset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if (!mapped) return false;
+    memcpy(mapped, buffer, size);
+    glUnmapBuffer(GL_COPY_READ_BUFFER);
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, gpuBuffer->glBuffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, ringOffset, offset, size);
+    ring->curOffset = alignedOffset + size;
+    return true;
+}
 } // namespace
 
 void GLES3CmdFuncCreateBuffer(GLES3Device *device, GLES3GPUBuffer *gpuBuffer) {
@@ -765,7 +800,7 @@ void GLES3CmdFuncUpdateBuffer(GLES3Device *device, GLES3GPUBuffer *gpuBuffer, vo
         memcpy((uint8_t *)gpuBuffer->indirects.data() + offset, buffer, size);
     } else if (gpuBuffer->usage & BufferUsageBit::TRANSFER_SRC) {
         memcpy((uint8_t *)gpuBuffer->buffer + offset, buffer, size);
-    } else {
+    } else if (!StreamBufferData(device, gpuBuffer, buffer, offset, size)) {
         switch (gpuBuffer->glTarget) {
             case GL_ARRAY_BUFFER: {
                 if (device->stateCache()->glVAO) {
@@ -808,6 +843,207 @@ void GLES3CmdFuncUpdateBuffer(GLES3Device *device, GLES3GPUBuffer *gpuBuffer, vo
     }
 }
 
+namespace {
+const uint PROGRAM_BINARY_MAGIC = 0x43434750; // 'CCGP'
+const uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+
+// stored in front of the driver blob, the blob is discarded if anything here mismatches
+struct ProgramBinaryFileHeader {
+    uint magic = PROGRAM_BINARY_MAGIC;
+    uint format = 0u;
+    uint64_t driverHash = 0u;
+    uint64_t sourceHash = 0u;
+    uint dataSize = 0u;
+};
+
+// FNV-1a, the hashes name files and have to stay the same across runs
+uint64_t hashBytes(uint64_t hash, const void *data, size_t size) {
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+uint64_t hashProgramSources(const GLES3GPUShader *gpuShader) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (const GLES3GPUShaderStage &gpuStage : gpuShader->gpuStages) {
+        const uint type = static_cast<uint>(gpuStage.type);
+        hash = hashBytes(hash, &type, sizeof(type));
+        hash = hashBytes(hash, gpuStage.source.data(), gpuStage.source.size() + 1);
+    }
+    return hash;
+}
+
+String getProgramBinaryPath(const GLES3GPUProgramCache *gpuProgramCache, uint64_t sourceHash) {
+    char name[24];
+    snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(sourceHash));
+    return gpuProgramCache->path + name;
+}
+
+bool loadProgramBinary(const GLES3GPUProgramCache *gpuProgramCache, GLES3GPUShader *gpuShader, uint64_t sourceHash) {
+    FileUtils *fileUtils = FileUtils::getInstance();
+    const String path = getProgramBinaryPath(gpuProgramCache, sourceHash);
+    if (!fileUtils->isFileExist(path)) return false;
+
+    Data data = fileUtils->getDataFromFile(path);
+    ProgramBinaryFileHeader header;
+    if ((size_t)data.getSize() > sizeof(header)) {
+        memcpy(&header, data.getBytes(), sizeof(header));
+    }
+    if (header.magic != PROGRAM_BINARY_MAGIC || header.driverHash != gpuProgramCache->driverHash ||
+        header.sourceHash != sourceHash || header.dataSize != data.getSize() - sizeof(header)) {
+        fileUtils->removeFile(path);
+        return false;
+    }
+
+    gpuShader->glProgram = glCreateProgram();
+    glProgramBinary(gpuShader->glProgram, header.format, data.getBytes() + sizeof(header), header.dataSize);
+
+    // the driver may still reject a binary that passed the header check
+    GLint status = 0;
+    glGetProgramiv(gpuShader->glProgram, GL_LINK_STATUS, &status);
+    if (status != 1) {
+        glDeleteProgram(gpuShader->glProgram);
+        gpuShader->glProgram = 0;
+        fileUtils->removeFile(path);
+        return false;
+    }
+    return true;
+}
+
+void saveProgramBinary(const GLES3GPUProgramCache *gpuProgramCache, const GLES3GPUShader *gpuShader, uint64_t sourceHash) {
+    GLint length = 0;
+    glGetProgramiv(gpuShader->glProgram, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    ProgramBinaryFileHeader header;
+    header.driverHash = gpuProgramCache->driverHash;
+    header.sourceHash = sourceHash;
+
+    // released by Data through free()
+    auto *buffer = (uint8_t *)malloc(sizeof(header) + length);
+    GLsizei dataSize = 0;
+    GLenum format = 0;
+    glGetProgramBinary(gpuShader->glProgram, length, &dataSize, &format, buffer + sizeof(header));
+    if (dataSize <= 0) {
+        free(buffer);
+        return;
+    }
+    header.format = format;
+    header.dataSize = (uint)dataSize;
+    memcpy(buffer, &header, sizeof(header));
+
+    Data data;
+    data.fastSet(buffer, sizeof(header) + dataSize);
+    if (!FileUtils::getInstance()->writeDataToFile(data, getProgramBinaryPath(gpuProgramCache, sourceHash))) {
+        CC_LOG_WARNING("Failed to write the program binary of shader '%s'.", gpuShader->name.c_str());
+    }
+}
+} // namespace
+
+void GLES3CmdFuncCreateProgramCache(GLES3Device *device, GLES3GPUProgramCache *gpuProgramCache) {
+    GLint formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    if (formatCount <= 0) return;
+
+    // the version string names the driver build, an update of it invalidates every binary
+    FileUtils *fileUtils = FileUtils::getInstance();
+    const String driver = device->getRenderer() + "\n" + device->getVendor() + "\n" + device->getVersion();
+    const String path = fileUtils->getWritablePath() + "gles3_program_cache/";
+    const String driverPath = path + "driver.txt";
+    if (!fileUtils->isFileExist(driverPath) || fileUtils->getStringFromFile(driverPath) != driver) {
+        fileUtils->removeDirectory(path);
+        if (!fileUtils->createDirectory(path) || !fileUtils->writeStringToFile(driver, driverPath)) {
+            CC_LOG_WARNING("GLES3 program cache unavailable.");
+            return;
+        }
+    }
+    gpuProgramCache->path = path;
+    gpuProgramCache->driverHash = hashBytes(FNV_OFFSET_BASIS, driver.data(), driver.size());
+}
+
+void GLES3CmdFuncCreateStagingRing(GLES3Device *device, GLES3GPUStagingRing *gpuStagingRing) {
+    glGenBuffers(1, &gpuStagingRing->glBuffer);
+    glBindBuffer(GL_COPY_READ_BUFFER, gpuStagingRing->glBuffer);
+    glBufferData(GL_COPY_READ_BUFFER, GLES3GPUStagingRing::SEGMENT_COUNT * GLES3GPUStagingRing::SEGMENT_SIZE, nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+}
+
+void GLES3CmdFuncDestroyStagingRing(GLES3Device *device, GLES3GPUStagingRing *gpuStagingRing) {
+    for (GLsync &glFence : gpuStagingRing->glFences) {
+        if (glFence) {
+            glDeleteSync(glFence);
+            glFence = 0;
+        }
+    }
+    if (gpuStagingRing->glBuffer) {
+        glDeleteBuffers(1, &gpuStagingRing->glBuffer);
+        gpuStagingRing->glBuffer = 0;
+    }
+}
+
+void GLES3CmdFuncAdvanceStagingRing(GLES3Device *device, GLES3GPUStagingRing *gpuStagingRing) {
+    if (!gpuStagingRing->glBuffer) return;
+
+    if (gpuStagingRing->curOffset) {
+        gpuStagingRing->glFences[gpuStagingRing->segmentIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    gpuStagingRing->segmentIndex = (gpuStagingRing->segmentIndex + 1) % GLES3GPUStagingRing::SEGMENT_COUNT;
+    gpuStagingRing->curOffset = 0;
+
+    GLsync &glFence = gpuStagingRing->glFences[gpuStagingRing->segmentIndex];
+    if (glFence) {
+        GLenum result = GL_TIMEOUT_EXPIRED;
+        while (result == GL_TIMEOUT_EXPIRED) {
+            result = glClientWaitSync(glFence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+        }
+        glDeleteSync(glFence);
+        glFence = 0;
+    }
+}
+
+void GLES3CmdFuncCreateQueryPool(GLES3Device *device, GLES3GPUQueryPool *gpuQueryPool) {
+    gpuQueryPool->glQueryIds.resize(gpuQueryPool->maxQueryObjects);
+    glGenQueries(gpuQueryPool->maxQueryObjects, gpuQueryPool->glQueryIds.data());
+}
+
+void GLES3CmdFuncDestroyQueryPool(GLES3Device *device, GLES3GPUQueryPool *gpuQueryPool) {
+    if (gpuQueryPool->glQueryIds.size()) {
+        glDeleteQueries((GLsizei)gpuQueryPool->glQueryIds.size(), gpuQueryPool->glQueryIds.data());
+        gpuQueryPool->glQueryIds.clear();
+    }
+}
+
+void GLES3CmdFuncResolveQueryPool(GLES3Device *device, GLES3GPUQueryPool *gpuQueryPool, uint generation, uint first, uint count) {
+    bool isTimestamp = gpuQueryPool->type == QueryType::TIMESTAMP;
+    // a disjoint operation invalidates every timestamp in flight
+    GLint disjoint = 0;
+    if (isTimestamp) glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+
+    // queries complete in submission order, the last one being available covers the whole range
+    GLuint available = GL_FALSE;
+    glGetQueryObjectuiv(gpuQueryPool->glQueryIds[first + count - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+
+    if (available && !disjoint) {
+        gpuQueryPool->results.resize(count);
+        for (uint i = 0u; i < count; ++i) {
+            GLuint glQuery = gpuQueryPool->glQueryIds[first + i];
+            if (isTimestamp) {
+                glGetQueryObjectui64vEXT(glQuery, GL_QUERY_RESULT, &gpuQueryPool->results[i]);
+            } else {
+                GLuint result = 0u;
+                glGetQueryObjectuiv(glQuery, GL_QUERY_RESULT, &result);
+                gpuQueryPool->results[i] = result;
+            }
+        }
+        gpuQueryPool->resolvedFirst = first;
+        gpuQueryPool->resolvedCount = count;
+        gpuQueryPool->resolvedGeneration.store(generation, std::memory_order_release);
+    }
+    gpuQueryPool->isResolving = false;
+}
+
 void GLES3CmdFuncCreateTexture(GLES3Device *device, GLES3GPUTexture *gpuTexture) {
     gpuTexture->glInternelFmt = MapGLInternalFormat(gpuTexture->format);
     gpuTexture->glFormat = MapGLFormat(gpuTexture->format);
@@ -1016,28 +1252,18 @@ void GLES3CmdFuncDestroySampler(GLES3Device *device, GLES3GPUSampler *gpuSampler
     }
 }
 
-void GLES3CmdFuncCreateShader(GLES3Device *device, GLES3GPUShader *gpuShader) {
-    GLenum glShaderStage = 0;
-    String shaderStageStr;
-    GLint status;
-
+namespace {
+bool compileShaderStages(GLES3GPUShader *gpuShader) {
     for (size_t i = 0; i < gpuShader->gpuStages.size(); ++i) {
         GLES3GPUShaderStage &gpuStage = gpuShader->gpuStages[i];
 
+        GLenum glShaderStage = 0;
         switch (gpuStage.type) {
-            case ShaderStageFlagBit::VERTEX: {
-                glShaderStage = GL_VERTEX_SHADER;
-                shaderStageStr = "Vertex Shader";
-                break;
-            }
-            case ShaderStageFlagBit::FRAGMENT: {
-                glShaderStage = GL_FRAGMENT_SHADER;
-                shaderStageStr = "Fragment Shader";
-                break;
-            }
+            case ShaderStageFlagBit::VERTEX: glShaderStage = GL_VERTEX_SHADER; break;
+            case ShaderStageFlagBit::FRAGMENT: glShaderStage = GL_FRAGMENT_SHADER; break;
             default: {
                 CCASSERT(false, "Unsupported ShaderStageFlagBit");
-                return;
+                return false;
             }
         }
 
@@ -1046,7 +1272,18 @@ void GLES3CmdFuncCreateShader(GLES3Device *device, GLES3GPUShader *gpuShader) {
         const char *source = shaderSource.c_str();
         glShaderSource(gpuStage.glShader, 1, (const GLchar **)&source, nullptr);
         glCompileShader(gpuStage.glShader);
+    }
+    return true;
+}
+
+// logs and deletes the stages that failed to compile
+bool checkShaderStages(GLES3GPUShader *gpuShader) {
+    bool isCompiled = true;
+    for (size_t i = 0; i < gpuShader->gpuStages.size(); ++i) {
+        GLES3GPUShaderStage &gpuStage = gpuShader->gpuStages[i];
+        if (!gpuStage.glShader) continue;
 
+        GLint status = 0;
         glGetShaderiv(gpuStage.glShader, GL_COMPILE_STATUS, &status);
         if (status != 1) {
             GLint logSize = 0;
@@ -1056,54 +1293,136 @@ void GLES3CmdFuncCreateShader(GLES3Device *device, GLES3GPUShader *gpuShader) {
             GLchar *logs = (GLchar *)CC_MALLOC(logSize);
             glGetShaderInfoLog(gpuStage.glShader, logSize, nullptr, logs);
 
-            CC_LOG_ERROR("%s in %s compilation failed.", shaderStageStr.c_str(), gpuShader->name.c_str());
+            const char *shaderStageStr = gpuStage.type == ShaderStageFlagBit::VERTEX ? "Vertex Shader" : "Fragment Shader";
+            CC_LOG_ERROR("%s in %s compilation failed.", shaderStageStr, gpuShader->name.c_str());
             CC_LOG_ERROR("Shader source: %s", gpuStage.source.c_str());
             CC_LOG_ERROR(logs);
             CC_FREE(logs);
             glDeleteShader(gpuStage.glShader);
             gpuStage.glShader = 0;
-            return;
+            isCompiled = false;
         }
     }
+    return isCompiled;
+}
 
+void linkProgram(GLES3GPUShader *gpuShader) {
     gpuShader->glProgram = glCreateProgram();
 
-    // link program
     for (size_t i = 0; i < gpuShader->gpuStages.size(); ++i) {
         GLES3GPUShaderStage &gpuStage = gpuShader->gpuStages[i];
         glAttachShader(gpuShader->glProgram, gpuStage.glShader);
     }
 
+    // hinted before linking, some drivers don't keep a binary to retrieve otherwise
+    glProgramParameteri(gpuShader->glProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     glLinkProgram(gpuShader->glProgram);
+}
 
-    // detach & delete immediately
+void deleteShaderStages(GLES3GPUShader *gpuShader) {
     for (size_t i = 0; i < gpuShader->gpuStages.size(); ++i) {
         GLES3GPUShaderStage &gpuStage = gpuShader->gpuStages[i];
         if (gpuStage.glShader) {
-            glDetachShader(gpuShader->glProgram, gpuStage.glShader);
+            if (gpuShader->glProgram) {
+                glDetachShader(gpuShader->glProgram, gpuStage.glShader);
+            }
             glDeleteShader(gpuStage.glShader);
             gpuStage.glShader = 0;
         }
     }
+}
+} // namespace
 
-    glGetProgramiv(gpuShader->glProgram, GL_LINK_STATUS, &status);
-    if (status != 1) {
-        CC_LOG_ERROR("Failed to link Shader [%s].", gpuShader->name.c_str());
-        GLint logSize = 0;
-        glGetProgramiv(gpuShader->glProgram, GL_INFO_LOG_LENGTH, &logSize);
-        if (logSize) {
-            ++logSize;
-            GLchar *logs = (GLchar *)CC_MALLOC(logSize);
-            glGetProgramInfoLog(gpuShader->glProgram, logSize, nullptr, logs);
+void GLES3CmdFuncCreateShader(GLES3Device *device, GLES3GPUShader *gpuShader) {
+    GLES3GPUProgramCache *gpuProgramCache = device->programCache();
+    if (gpuProgramCache && !gpuProgramCache->path.empty() &&
+        loadProgramBinary(gpuProgramCache, gpuShader, hashProgramSources(gpuShader))) {
+        GLES3CmdFuncCompleteShader(device, gpuShader);
+        return;
+    }
 
-            CC_LOG_ERROR("Failed to link shader '%s'.", gpuShader->name.c_str());
-            CC_LOG_ERROR(logs);
-            CC_FREE(logs);
+    if (!compileShaderStages(gpuShader)) {
+        deleteShaderStages(gpuShader);
+        gpuShader->isLinking = false;
+        return;
+    }
+
+    // with parallel compilation the results are only queried once the driver is done, see GLES3CmdFuncPollShaders()
+    if (gpuShader->isLinking) {
+        linkProgram(gpuShader);
+        device->pendingShaders().push_back(gpuShader);
+        return;
+    }
+
+    if (!checkShaderStages(gpuShader)) {
+        deleteShaderStages(gpuShader);
+        return;
+    }
+    linkProgram(gpuShader);
+    GLES3CmdFuncCompleteShader(device, gpuShader);
+}
+
+void GLES3CmdFuncPollShaders(GLES3Device *device) {
+    auto &pendingShaders = device->pendingShaders();
+    for (size_t i = 0; i < pendingShaders.size();) {
+        GLES3GPUShader *gpuShader = pendingShaders[i];
+        GLint isCompleted = GL_FALSE;
+        glGetProgramiv(gpuShader->glProgram, GL_COMPLETION_STATUS_KHR, &isCompleted);
+        if (isCompleted) {
+            // removes it from the list
+            GLES3CmdFuncCompleteShader(device, gpuShader);
+        } else {
+            ++i;
+        }
+    }
+}
+
+void GLES3CmdFuncCompleteShader(GLES3Device *device, GLES3GPUShader *gpuShader) {
+    auto &pendingShaders = device->pendingShaders();
+    pendingShaders.erase(std::remove(pendingShaders.begin(), pendingShaders.end(), gpuShader), pendingShaders.end());
+
+    // a program loaded from the cache has no stages left to check
+    bool isCached = true;
+    for (const GLES3GPUShaderStage &gpuStage : gpuShader->gpuStages) {
+        if (gpuStage.glShader) isCached = false;
+    }
+
+    if (!isCached) {
+        const bool isCompiled = checkShaderStages(gpuShader);
+        deleteShaderStages(gpuShader);
+        if (!isCompiled) {
+            glDeleteProgram(gpuShader->glProgram);
+            gpuShader->glProgram = 0;
+            gpuShader->isLinking = false;
             return;
         }
+
+        GLint status;
+        glGetProgramiv(gpuShader->glProgram, GL_LINK_STATUS, &status);
+        if (status != 1) {
+            CC_LOG_ERROR("Failed to link Shader [%s].", gpuShader->name.c_str());
+            GLint logSize = 0;
+            glGetProgramiv(gpuShader->glProgram, GL_INFO_LOG_LENGTH, &logSize);
+            if (logSize) {
+                ++logSize;
+                GLchar *logs = (GLchar *)CC_MALLOC(logSize);
+                glGetProgramInfoLog(gpuShader->glProgram, logSize, nullptr, logs);
+
+                CC_LOG_ERROR("Failed to link shader '%s'.", gpuShader->name.c_str());
+                CC_LOG_ERROR(logs);
+                CC_FREE(logs);
+                gpuShader->isLinking = false;
+                return;
+            }
+        }
+
+        GLES3GPUProgramCache *gpuProgramCache = device->programCache();
+        if (gpuProgramCache && !gpuProgramCache->path.empty() && status == 1) {
+            saveProgramBinary(gpuProgramCache, gpuShader, hashProgramSources(gpuShader));
+        }
     }
 
-    CC_LOG_INFO("Shader '%s' compilation succeeded.", gpuShader->name.c_str());
+    CC_LOG_INFO("Shader '%s' %s.", gpuShader->name.c_str(), isCached ? "loaded from the program cache" : "compilation succeeded");
 
     GLint attrMaxLength = 0;
     GLint attrCount = 0;
@@ -1312,9 +1631,16 @@ void GLES3CmdFuncCreateShader(GLES3Device *device, GLES3GPUShader *gpuShader) {
 
     // strip out the inactive ones
     gpuShader->glSamplers = glActiveSamplers;
+    gpuShader->isLinking = false;
 }
 
 void GLES3CmdFuncDestroyShader(GLES3Device *device, GLES3GPUShader *gpuShader) {
+    if (gpuShader->isLinking) {
+        auto &pendingShaders = device->pendingShaders();
+        pendingShaders.erase(std::remove(pendingShaders.begin(), pendingShaders.end(), gpuShader), pendingShaders.end());
+        deleteShaderStages(gpuShader);
+        gpuShader->isLinking = false;
+    }
     if (gpuShader->glProgram) {
         if (device->stateCache()->glProgram == gpuShader->glProgram) {
             glUseProgram(0);
@@ -1376,6 +1702,30 @@ void GLES3CmdFuncDestroyInputAssembler(GLES3Device *device, GLES3GPUInputAssembl
     gpuInputAssembler->glVAOs.clear();
 }
 
+namespace {
+// the attachments of a pass share their sample count, see Feature::MULTISAMPLED_RENDER_TO_TEXTURE
+GLsizei getRenderToTextureSamples(GLES3Device *device, const GLES3GPURenderPass *gpuRenderPass) {
+    const uint sampleCount = gpuRenderPass->colorAttachments.empty() ? gpuRenderPass->depthStencilAttachment.sampleCount
+                                                                     : gpuRenderPass->colorAttachments[0].sampleCount;
+    if (sampleCount <= 1 || !device->hasFeature(Feature::MULTISAMPLED_RENDER_TO_TEXTURE)) return 1;
+    return std::min(static_cast<GLsizei>(sampleCount), static_cast<GLsizei>(device->getMaxRenderToTextureSamples()));
+}
+
+// the samples stay in tile memory and are resolved into the texture as the framebuffer is flushed,
+// which the extensions only support for the base level
+void framebufferTexture2D(GLenum attachment, const GLES3GPUTexture *gpuTexture, GLint level, GLsizei samples) {
+    if (samples > 1 && level == 0) {
+        if (glFramebufferTexture2DMultisampleEXT) {
+            glFramebufferTexture2DMultisampleEXT(GL_FRAMEBUFFER, attachment, gpuTexture->glTarget, gpuTexture->glTexture, level, samples);
+        } else {
+            glFramebufferTexture2DMultisampleIMG(GL_FRAMEBUFFER, attachment, gpuTexture->glTarget, gpuTexture->glTexture, level, samples);
+        }
+        return;
+    }
+    glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, gpuTexture->glTarget, gpuTexture->glTexture, level);
+}
+} // namespace
+
 void GLES3CmdFuncCreateFramebuffer(GLES3Device *device, GLES3GPUFramebuffer *gpuFBO) {
     size_t colorViewCount = gpuFBO->gpuColorTextures.size();
     uint swapchainImageIndices = 0;
@@ -1399,6 +1749,7 @@ void GLES3CmdFuncCreateFramebuffer(GLES3Device *device, GLES3GPUFramebuffer *gpu
 
         GLenum attachments[GFX_MAX_ATTACHMENTS] = {0};
         uint attachmentCount = 0;
+        const GLsizei samples = getRenderToTextureSamples(device, gpuFBO->gpuRenderPass);
 
         size_t colorMipmapLevelCount = gpuFBO->colorMipmapLevels.size();
         for (size_t i = 0; i < gpuFBO->gpuColorTextures.size(); ++i) {
@@ -1408,7 +1759,7 @@ void GLES3CmdFuncCreateFramebuffer(GLES3Device *device, GLES3GPUFramebuffer *gpu
                 if (i < colorMipmapLevelCount) {
                     mipmapLevel = gpuFBO->colorMipmapLevels[i];
                 }
-                glFramebufferTexture2D(GL_FRAMEBUFFER, (GLenum)(GL_COLOR_ATTACHMENT0 + i), gpuColorTexture->glTarget, gpuColorTexture->glTexture, mipmapLevel);
+                framebufferTexture2D((GLenum)(GL_COLOR_ATTACHMENT0 + i), gpuColorTexture, mipmapLevel, samples);
 
                 attachments[attachmentCount++] = (GLenum)(GL_COLOR_ATTACHMENT0 + i);
             }
@@ -1417,7 +1768,7 @@ void GLES3CmdFuncCreateFramebuffer(GLES3Device *device, GLES3GPUFramebuffer *gpu
         if (gpuFBO->gpuDepthStencilTexture) {
             GLES3GPUTexture *gpuDepthStencilTexture = gpuFBO->gpuDepthStencilTexture;
             const GLenum glAttachment = GFX_FORMAT_INFOS[(int)gpuDepthStencilTexture->format].hasStencil ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
-            glFramebufferTexture2D(GL_FRAMEBUFFER, glAttachment, gpuDepthStencilTexture->glTarget, gpuDepthStencilTexture->glTexture, gpuFBO->depthStencilMipmapLevel);
+            framebufferTexture2D(glAttachment, gpuDepthStencilTexture, gpuFBO->depthStencilMipmapLevel, samples);
         }
 
         glDrawBuffers(attachmentCount, attachments);
@@ -1464,6 +1815,84 @@ void GLES3CmdFuncDestroyFramebuffer(GLES3Device *device, GLES3GPUFramebuffer *gp
     }
 }
 
+namespace {
+bool IsSameDescriptors(const GLES3CmdBindStates *lhs, const GLES3CmdBindStates *rhs) {
+    return lhs->gpuPipelineState == rhs->gpuPipelineState &&
+           lhs->gpuDescriptorSets == rhs->gpuDescriptorSets &&
+           lhs->dynamicOffsets == rhs->dynamicOffsets;
+}
+
+bool IsSameStates(const GLES3CmdBindStates *lhs, const GLES3CmdBindStates *rhs) {
+    return IsSameDescriptors(lhs, rhs) &&
+           lhs->gpuInputAssembler == rhs->gpuInputAssembler &&
+           !memcmp(&lhs->viewport, &rhs->viewport, sizeof(Viewport)) &&
+           !memcmp(&lhs->scissor, &rhs->scissor, sizeof(Rect)) &&
+           lhs->lineWidth == rhs->lineWidth &&
+           lhs->depthBiasEnabled == rhs->depthBiasEnabled &&
+           !memcmp(&lhs->depthBias, &rhs->depthBias, sizeof(GLES3DepthBias)) &&
+           !memcmp(&lhs->blendConstants, &rhs->blendConstants, sizeof(Color)) &&
+           !memcmp(&lhs->depthBounds, &rhs->depthBounds, sizeof(GLES3DepthBounds)) &&
+           !memcmp(&lhs->stencilWriteMask, &rhs->stencilWriteMask, sizeof(GLES3StencilWriteMask)) &&
+           !memcmp(&lhs->stencilCompareMask, &rhs->stencilCompareMask, sizeof(GLES3StencilCompareMask));
+}
+} // namespace
+
+// Drops bind-states commands that would not change anything at playback and marks the
+// ones whose descriptor sets are already bound. Only binds separated by draws are compared,
+// every other command may touch the texture, buffer or VAO bindings and starts over.
+void GLES3CmdFuncOptimizeCmds(GLES3CmdPackage *cmdPackage) {
+    cmdPackage->numRedundantBindStates = 0;
+    cmdPackage->numSkippedDescriptorBinds = 0;
+
+    GLES3CmdBindStates *prevBound = nullptr;       // last kept bind before the current one
+    GLES3CmdBindStates *bound = nullptr;           // state in effect for the next draw
+    bool isDrawn = false;                          // whether a draw consumed the current state
+    uint bindIdx = 0;
+
+    for (uint i = 0; i < cmdPackage->cmds.size(); ++i) {
+        switch (cmdPackage->cmds[i]) {
+            case GFXCmdType::BIND_STATES: {
+                GLES3CmdBindStates *cmd = cmdPackage->bindStatesCmds[bindIdx++];
+                cmd->isRedundant = false;
+                cmd->isDescriptorBound = false;
+
+                // consecutive binds of the same pipeline: only the last one is needed
+                if (bound && !isDrawn && bound->gpuPipelineState == cmd->gpuPipelineState) {
+                    if (!bound->isRedundant) {
+                        bound->isRedundant = true;
+                        cmdPackage->numRedundantBindStates++;
+                        if (bound->isDescriptorBound) cmdPackage->numSkippedDescriptorBinds--;
+                    }
+                    bound = prevBound;
+                    isDrawn = true;
+                }
+
+                if (bound && IsSameStates(cmd, bound)) {
+                    cmd->isRedundant = true;
+                    cmdPackage->numRedundantBindStates++;
+                    break;
+                }
+
+                if (bound && IsSameDescriptors(cmd, bound)) {
+                    cmd->isDescriptorBound = true;
+                    cmdPackage->numSkippedDescriptorBinds++;
+                }
+                prevBound = bound;
+                bound = cmd;
+                isDrawn = false;
+                break;
+            }
+            case GFXCmdType::DRAW:
+                isDrawn = true;
+                break;
+            default:
+                prevBound = nullptr;
+                bound = nullptr;
+                break;
+        }
+    }
+}
+
 void GLES3CmdFuncExecuteCmds(GLES3Device *device, GLES3CmdPackage *cmdPackage) {
     static uint cmdIndices[(int)GFXCmdType::COUNT] = {0};
     static GLenum glAttachments[GFX_MAX_ATTACHMENTS] = {0};
@@ -1686,6 +2115,7 @@ void GLES3CmdFuncExecuteCmds(GLES3Device *device, GLES3CmdPackage *cmdPackage) {
             }
             case GFXCmdType::BIND_STATES: {
                 GLES3CmdBindStates *cmd = cmdPackage->bindStatesCmds[cmdIdx];
+                if (cmd->isRedundant) break;
                 isShaderChanged = false;
 
                 if (cmd->gpuPipelineState && gpuPipelineState != cmd->gpuPipelineState) {
@@ -1693,6 +2123,10 @@ void GLES3CmdFuncExecuteCmds(GLES3Device *device, GLES3CmdPackage *cmdPackage) {
                     glPrimitive = gpuPipelineState->glPrimitive;
 
                     if (gpuPipelineState->gpuShader) {
+                        // used before the parallel compilation finished, waits for it
+                        if (gpuPipelineState->gpuShader->isLinking) {
+                            GLES3CmdFuncCompleteShader(device, gpuPipelineState->gpuShader);
+                        }
                         if (cache->glProgram != gpuPipelineState->gpuShader->glProgram) {
                             glUseProgram(gpuPipelineState->gpuShader->glProgram);
                             cache->glProgram = gpuPipelineState->gpuShader->glProgram;
@@ -1889,7 +2323,7 @@ void GLES3CmdFuncExecuteCmds(GLES3Device *device, GLES3CmdPackage *cmdPackage) {
                 } // if
 
                 // bind descriptor sets
-                if (cmd->gpuPipelineState && gpuPipelineState->gpuShader && gpuPipelineState->gpuPipelineLayout) {
+                if (!cmd->isDescriptorBound && cmd->gpuPipelineState && gpuPipelineState->gpuShader && gpuPipelineState->gpuPipelineLayout) {
 
                     size_t blockLen = gpuPipelineState->gpuShader->glBlocks.size();
                     const vector<vector<int>> &dynamicOffsetIndices = gpuPipelineState->gpuPipelineLayout->dynamicOffsetIndices;
@@ -2189,7 +2623,8 @@ void GLES3CmdFuncExecuteCmds(GLES3Device *device, GLES3CmdPackage *cmdPackage) {
             case GFXCmdType::DRAW: {
                 GLES3CmdDraw *cmd = cmdPackage->drawCmds[cmdIdx];
                 if (gpuInputAssembler && gpuPipelineState) {
-                    if (!gpuInputAssembler->gpuIndirectBuffer) {
+                    const auto *gpuIndirectBuffer = cmd->gpuIndirectBuffer ? cmd->gpuIndirectBuffer : gpuInputAssembler->gpuIndirectBuffer;
+                    if (!gpuIndirectBuffer) {
                         if (gpuInputAssembler->gpuIndexBuffer) {
                             if (cmd->drawInfo.indexCount > 0) {
                                 uint8_t *offset = 0;
@@ -2208,8 +2643,11 @@ void GLES3CmdFuncExecuteCmds(GLES3Device *device, GLES3CmdPackage *cmdPackage) {
                             }
                         }
                     } else {
-                        for (size_t j = 0; j < gpuInputAssembler->gpuIndirectBuffer->indirects.size(); ++j) {
-                            const DrawInfo &draw = gpuInputAssembler->gpuIndirectBuffer->indirects[j];
+                        const size_t drawCount = gpuIndirectBuffer->indirects.size();
+                        const size_t begin = cmd->gpuIndirectBuffer ? std::min<size_t>(cmd->drawOffset, drawCount) : 0;
+                        const size_t end = cmd->gpuIndirectBuffer ? std::min<size_t>(begin + cmd->drawCount, drawCount) : drawCount;
+                        for (size_t j = begin; j < end; ++j) {
+                            const DrawInfo &draw = gpuIndirectBuffer->indirects[j];
                             if (gpuInputAssembler->gpuIndexBuffer) {
                                 if (draw.indexCount > 0) {
                                     uint8_t *offset = 0;
@@ -2242,6 +2680,21 @@ void GLES3CmdFuncExecuteCmds(GLES3Device *device, GLES3CmdPackage *cmdPackage) {
                 GLES3CmdFuncCopyBuffersToTexture(device, cmd->buffers.data(), cmd->gpuTexture, cmd->regions, cmd->count);
                 break;
             }
+            case GFXCmdType::COPY_TEXTURE: {
+                GLES3CmdCopyTexture *cmd = cmdPackage->copyTextureCmds[cmdIdx];
+                GLES3CmdFuncCopyTexture(device, cmd->gpuSrcTexture, cmd->gpuDstTexture, cmd->regions.data(), (uint)cmd->regions.size());
+                break;
+            }
+            case GFXCmdType::QUERY: {
+                GLES3CmdQuery *cmd = cmdPackage->queryCmds[cmdIdx];
+                GLuint glQuery = cmd->gpuQueryPool->glQueryIds[cmd->id];
+                switch (cmd->op) {
+                    case GLES3QueryOp::WRITE_TIMESTAMP: glQueryCounterEXT(glQuery, GL_TIMESTAMP_EXT); break;
+                    case GLES3QueryOp::BEGIN: glBeginQuery(GL_ANY_SAMPLES_PASSED_CONSERVATIVE, glQuery); break;
+                    case GLES3QueryOp::END: glEndQuery(GL_ANY_SAMPLES_PASSED_CONSERVATIVE); break;
+                }
+                break;
+            }
             default:
                 break;
         }
@@ -2249,13 +2702,9 @@ void GLES3CmdFuncExecuteCmds(GLES3Device *device, GLES3CmdPackage *cmdPackage) {
     }
 }
 
-void GLES3CmdFuncCopyBuffersToTexture(GLES3Device *device, const uint8_t *const *buffers, GLES3GPUTexture *gpuTexture, const BufferTextureCopy *regions, uint count) {
-    GLuint &glTexture = device->stateCache()->glTextures[device->stateCache()->texUint];
-    if (glTexture != gpuTexture->glTexture) {
-        glBindTexture(gpuTexture->glTarget, gpuTexture->glTexture);
-        glTexture = gpuTexture->glTexture;
-    }
-
+namespace {
+// uploads into the texture bound to the current unit of the current context
+void copyBuffersToBoundTexture(const uint8_t *const *buffers, GLES3GPUTexture *gpuTexture, const BufferTextureCopy *regions, uint count) {
     bool isCompressed = GFX_FORMAT_INFOS[(int)gpuTexture->format].isCompressed;
     uint n = 0;
 
@@ -2406,10 +2855,89 @@ void GLES3CmdFuncCopyBuffersToTexture(GLES3Device *device, const uint8_t *const
     }
 
     if (!isCompressed && gpuTexture->flags & TextureFlagBit::GEN_MIPMAP) {
-        glBindTexture(gpuTexture->glTarget, gpuTexture->glTexture);
         glGenerateMipmap(gpuTexture->glTarget);
     }
 }
+} // namespace
+
+void GLES3CmdFuncCopyBuffersToTexture(GLES3Device *device, const uint8_t *const *buffers, GLES3GPUTexture *gpuTexture, const BufferTextureCopy *regions, uint count) {
+    GLuint &glTexture = device->stateCache()->glTextures[device->stateCache()->texUint];
+    if (glTexture != gpuTexture->glTexture) {
+        glBindTexture(gpuTexture->glTarget, gpuTexture->glTexture);
+        glTexture = gpuTexture->glTexture;
+    }
+
+    copyBuffersToBoundTexture(buffers, gpuTexture, regions, count);
+}
+
+void GLES3CmdFuncUploadBuffersToTexture(const uint8_t *const *buffers, GLES3GPUTexture *gpuTexture, const BufferTextureCopy *regions, uint count) {
+    glBindTexture(gpuTexture->glTarget, gpuTexture->glTexture);
+    copyBuffersToBoundTexture(buffers, gpuTexture, regions, count);
+    glBindTexture(gpuTexture->glTarget, 0);
+
+    // blocks the upload thread only, the main context can sample the texture once this returns
+    GLsync glSync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    GLenum status = GL_TIMEOUT_EXPIRED;
+    while (status == GL_TIMEOUT_EXPIRED) {
+        status = glClientWaitSync(glSync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+    }
+    if (status == GL_WAIT_FAILED) {
+        CC_LOG_ERROR("GLES3CmdFuncUploadBuffersToTexture: waiting for the upload failed.");
+    }
+    glDeleteSync(glSync);
+}
+
+namespace {
+void attachCopyTexture(GLenum glTarget, GLenum glAttachment, const GLES3GPUTexture *gpuTexture, uint mipLevel, uint layer) {
+    if (!gpuTexture) {
+        glFramebufferTexture2D(glTarget, glAttachment, GL_TEXTURE_2D, 0, 0);
+    } else if (gpuTexture->glTarget == GL_TEXTURE_CUBE_MAP) {
+        glFramebufferTexture2D(glTarget, glAttachment, GL_TEXTURE_CUBE_MAP_POSITIVE_X + layer, gpuTexture->glTexture, mipLevel);
+    } else {
+        glFramebufferTexture2D(glTarget, glAttachment, gpuTexture->glTarget, gpuTexture->glTexture, mipLevel);
+    }
+}
+} // namespace
+
+void GLES3CmdFuncCopyTexture(GLES3Device *device, GLES3GPUTexture *gpuSrcTexture, GLES3GPUTexture *gpuDstTexture, const TextureCopy *regions, uint count) {
+    GLES3GPUStateCache *cache = device->stateCache();
+    if (!cache->glCopyFBOs[0]) {
+        glGenFramebuffers(2, cache->glCopyFBOs);
+    }
+
+    const FormatInfo &info = GFX_FORMAT_INFOS[(uint)gpuSrcTexture->format];
+    GLenum glAttachment = GL_COLOR_ATTACHMENT0;
+    GLbitfield glMask = GL_COLOR_BUFFER_BIT;
+    if (info.hasDepth || info.hasStencil) {
+        glAttachment = info.hasStencil ? (info.hasDepth ? GL_DEPTH_STENCIL_ATTACHMENT : GL_STENCIL_ATTACHMENT) : GL_DEPTH_ATTACHMENT;
+        glMask = (info.hasDepth ? GL_DEPTH_BUFFER_BIT : 0) | (info.hasStencil ? GL_STENCIL_BUFFER_BIT : 0);
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, cache->glCopyFBOs[0]);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, cache->glCopyFBOs[1]);
+    // the scissor test is the only fragment operation affecting blits
+    glDisable(GL_SCISSOR_TEST);
+
+    for (uint i = 0u; i < count; ++i) {
+        const TextureCopy &region = regions[i];
+        for (uint l = 0u; l < region.srcSubres.layerCount; ++l) {
+            attachCopyTexture(GL_READ_FRAMEBUFFER, glAttachment, gpuSrcTexture, region.srcSubres.mipLevel, region.srcSubres.baseArrayLayer + l);
+            attachCopyTexture(GL_DRAW_FRAMEBUFFER, glAttachment, gpuDstTexture, region.dstSubres.mipLevel, region.dstSubres.baseArrayLayer + l);
+
+            const GLint srcX = region.srcOffset.x, srcY = region.srcOffset.y;
+            const GLint dstX = region.dstOffset.x, dstY = region.dstOffset.y;
+            const GLint width = (GLint)region.extent.width, height = (GLint)region.extent.height;
+            glBlitFramebuffer(srcX, srcY, srcX + width, srcY + height, dstX, dstY, dstX + width, dstY + height, glMask, GL_NEAREST);
+        }
+    }
+
+    // don't keep the textures alive through the copy framebuffers
+    attachCopyTexture(GL_READ_FRAMEBUFFER, glAttachment, nullptr, 0, 0);
+    attachCopyTexture(GL_DRAW_FRAMEBUFFER, glAttachment, nullptr, 0, 0);
+
+    glEnable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_FRAMEBUFFER, cache->glFramebuffer);
+}
 
 } // namespace gfx
 } // namespace cc
@@ -99,6 +99,9 @@ public:
     GLES3DepthBounds depthBounds;
     GLES3StencilWriteMask stencilWriteMask;
     GLES3StencilCompareMask stencilCompareMask;
+    // filled in by GLES3CmdFuncOptimizeCmds before playback
+    bool isRedundant = false;
+    bool isDescriptorBound = false;
 
     GLES3CmdBindStates() : GFXCmd(GFXCmdType::BIND_STATES) {}
 
@@ -108,15 +111,23 @@ public:
         gpuDescriptorSets.clear();
         dynamicOffsets.clear();
         memset(stateFlags, 0, sizeof(stateFlags));
+        isRedundant = false;
+        isDescriptorBound = false;
     }
 };
 
 class GLES3CmdDraw : public GFXCmd {
 public:
     DrawInfo drawInfo;
+    // replaces the indirect buffer of the input assembler for drawIndirect
+    GLES3GPUBuffer *gpuIndirectBuffer = nullptr;
+    uint drawOffset = 0;
+    uint drawCount = 0;
 
     GLES3CmdDraw() : GFXCmd(GFXCmdType::DRAW) {}
-    virtual void clear() override {}
+    virtual void clear() override {
+        gpuIndirectBuffer = nullptr;
+    }
 };
 
 class GLES3CmdUpdateBuffer : public GFXCmd {
@@ -151,6 +162,40 @@ public:
     }
 };
 
+class GLES3CmdCopyTexture : public GFXCmd {
+public:
+    GLES3GPUTexture *gpuSrcTexture = nullptr;
+    GLES3GPUTexture *gpuDstTexture = nullptr;
+    vector<TextureCopy> regions;
+
+    GLES3CmdCopyTexture() : GFXCmd(GFXCmdType::COPY_TEXTURE) {}
+
+    virtual void clear() override {
+        gpuSrcTexture = nullptr;
+        gpuDstTexture = nullptr;
+        regions.clear();
+    }
+};
+
+enum class GLES3QueryOp : uint8_t {
+    WRITE_TIMESTAMP,
+    BEGIN,
+    END,
+};
+
+class GLES3CmdQuery : public GFXCmd {
+public:
+    GLES3GPUQueryPool *gpuQueryPool = nullptr;
+    GLES3QueryOp op = GLES3QueryOp::WRITE_TIMESTAMP;
+    uint id = 0u;
+
+    GLES3CmdQuery() : GFXCmd(GFXCmdType::QUERY) {}
+
+    virtual void clear() override {
+        gpuQueryPool = nullptr;
+    }
+};
+
 class GLES3CmdPackage : public Object {
 public:
     CachedArray<GFXCmdType> cmds;
@@ -159,6 +204,10 @@ public:
     CachedArray<GLES3CmdDraw *> drawCmds;
     CachedArray<GLES3CmdUpdateBuffer *> updateBufferCmds;
     CachedArray<GLES3CmdCopyBufferToTexture *> copyBufferToTextureCmds;
+    CachedArray<GLES3CmdCopyTexture *> copyTextureCmds;
+    CachedArray<GLES3CmdQuery *> queryCmds;
+    uint numRedundantBindStates = 0;
+    uint numSkippedDescriptorBinds = 0;
 };
 
 class GLES3GPUCommandAllocator : public Object {
@@ -168,6 +217,8 @@ public:
     CommandPool<GLES3CmdDraw> drawCmdPool;
     CommandPool<GLES3CmdUpdateBuffer> updateBufferCmdPool;
     CommandPool<GLES3CmdCopyBufferToTexture> copyBufferToTextureCmdPool;
+    CommandPool<GLES3CmdCopyTexture> copyTextureCmdPool;
+    CommandPool<GLES3CmdQuery> queryCmdPool;
 
     void clearCmds(GLES3CmdPackage *cmd_package) {
         if (cmd_package->beginRenderPassCmds.size()) {
@@ -185,6 +236,12 @@ public:
         if (cmd_package->copyBufferToTextureCmds.size()) {
             copyBufferToTextureCmdPool.freeCmds(cmd_package->copyBufferToTextureCmds);
         }
+        if (cmd_package->copyTextureCmds.size()) {
+            copyTextureCmdPool.freeCmds(cmd_package->copyTextureCmds);
+        }
+        if (cmd_package->queryCmds.size()) {
+            queryCmdPool.freeCmds(cmd_package->queryCmds);
+        }
 
         cmd_package->cmds.clear();
     }
@@ -195,6 +252,8 @@ public:
         drawCmdPool.release();
         updateBufferCmdPool.release();
         copyBufferToTextureCmdPool.release();
+        copyTextureCmdPool.release();
+        queryCmdPool.release();
     }
 };
 
@@ -208,13 +267,28 @@ CC_GLES3_API void GLES3CmdFuncResizeTexture(GLES3Device *device, GLES3GPUTexture
 CC_GLES3_API void GLES3CmdFuncCreateSampler(GLES3Device *device, GLES3GPUSampler *gpuSampler);
 CC_GLES3_API void GLES3CmdFuncDestroySampler(GLES3Device *device, GLES3GPUSampler *gpuSampler);
 CC_GLES3_API void GLES3CmdFuncCreateShader(GLES3Device *device, GLES3GPUShader *gpuShader);
+// Completes the shaders the driver finished linking in parallel, once a frame.
+CC_GLES3_API void GLES3CmdFuncPollShaders(GLES3Device *device);
+// Queries the link results and reflects the program, waiting for a parallel link still running.
+CC_GLES3_API void GLES3CmdFuncCompleteShader(GLES3Device *device, GLES3GPUShader *gpuShader);
 CC_GLES3_API void GLES3CmdFuncDestroyShader(GLES3Device *device, GLES3GPUShader *gpuShader);
 CC_GLES3_API void GLES3CmdFuncCreateInputAssembler(GLES3Device *device, GLES3GPUInputAssembler *gpuInputAssembler);
 CC_GLES3_API void GLES3CmdFuncDestroyInputAssembler(GLES3Device *device, GLES3GPUInputAssembler *gpuInputAssembler);
 CC_GLES3_API void GLES3CmdFuncCreateFramebuffer(GLES3Device *device, GLES3GPUFramebuffer *gpuFBO);
 CC_GLES3_API void GLES3CmdFuncDestroyFramebuffer(GLES3Device *device, GLES3GPUFramebuffer *gpuFBO);
+CC_GLES3_API void GLES3CmdFuncCreateProgramCache(GLES3Device *device, GLES3GPUProgramCache *gpuProgramCache);
+CC_GLES3_API void GLES3CmdFuncCreateStagingRing(GLES3Device *device, GLES3GPUStagingRing *gpuStagingRing);
+CC_GLES3_API void GLES3CmdFuncDestroyStagingRing(GLES3Device *device, GLES3GPUStagingRing *gpuStagingRing);
+CC_GLES3_API void GLES3CmdFuncAdvanceStagingRing(GLES3Device *device, GLES3GPUStagingRing *gpuStagingRing);
+CC_GLES3_API void GLES3CmdFuncCreateQueryPool(GLES3Device *device, GLES3GPUQueryPool *gpuQueryPool);
+CC_GLES3_API void GLES3CmdFuncDestroyQueryPool(GLES3Device *device, GLES3GPUQueryPool *gpuQueryPool);
+CC_GLES3_API void GLES3CmdFuncResolveQueryPool(GLES3Device *device, GLES3GPUQueryPool *gpuQueryPool, uint generation, uint first, uint count);
+CC_GLES3_API void GLES3CmdFuncOptimizeCmds(GLES3CmdPackage *cmdPackage);
 CC_GLES3_API void GLES3CmdFuncExecuteCmds(GLES3Device *device, GLES3CmdPackage *cmd_package);
 CC_GLES3_API void GLES3CmdFuncCopyBuffersToTexture(GLES3Device *device, const uint8_t *const *buffers, GLES3GPUTexture *gpuTexture, const BufferTextureCopy *regions, uint count);
+// Runs on the upload context, which shares its objects with the main one but none of its state.
+CC_GLES3_API void GLES3CmdFuncUploadBuffersToTexture(const uint8_t *const *buffers, GLES3GPUTexture *gpuTexture, const BufferTextureCopy *regions, uint count);
+CC_GLES3_API void GLES3CmdFuncCopyTexture(GLES3Device *device, GLES3GPUTexture *gpuSrcTexture, GLES3GPUTexture *gpuDstTexture, const TextureCopy *regions, uint count);
 
 } // namespace gfx
 } // namespace cc
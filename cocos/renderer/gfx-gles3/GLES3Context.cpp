@@ -309,33 +309,36 @@ bool GLES3Context::initialize(const ContextInfo &info) {
     }
 
     #if (CC_PLATFORM == CC_PLATFORM_ANDROID)
-    EventDispatcher::addCustomEventListener(EVENT_DESTROY_WINDOW, [=](const CustomEvent &) -> void {
-        if (_eglSurface != EGL_NO_SURFACE) {
-            eglDestroySurface(_eglDisplay, _eglSurface);
-            _eglSurface = EGL_NO_SURFACE;
-        }
-    });
-
-    EventDispatcher::addCustomEventListener(EVENT_RECREATE_WINDOW, [=](const CustomEvent &event) -> void {
-        _windowHandle = (uintptr_t)event.args->ptrVal;
+    // shared contexts render into a pbuffer which outlives the window
+    if (_isPrimaryContex) {
+        EventDispatcher::addCustomEventListener(EVENT_DESTROY_WINDOW, [=](const CustomEvent &) -> void {
+            if (_eglSurface != EGL_NO_SURFACE) {
+                eglDestroySurface(_eglDisplay, _eglSurface);
+                _eglSurface = EGL_NO_SURFACE;
+            }
+        });
 
-        EGLint nFmt;
-        if (eglGetConfigAttrib(_eglDisplay, _eglConfig, EGL_NATIVE_VISUAL_ID, &nFmt) == EGL_FALSE) {
-            CC_LOG_ERROR("Getting configuration attributes failed.");
-            return;
-        }
-        uint width = _device->getWidth();
-        uint height = _device->getHeight();
-        ANativeWindow_setBuffersGeometry((ANativeWindow *)_windowHandle, width, height, nFmt);
+        EventDispatcher::addCustomEventListener(EVENT_RECREATE_WINDOW, [=](const CustomEvent &event) -> void {
+            _windowHandle = (uintptr_t)event.args->ptrVal;
 
-        _eglSurface = eglCreateWindowSurface(_eglDisplay, _eglConfig, (EGLNativeWindowType)_windowHandle, NULL);
-        if (_eglSurface == EGL_NO_SURFACE) {
-            CC_LOG_ERROR("Recreate window surface failed.");
-            return;
-        }
+            EGLint nFmt;
+            if (eglGetConfigAttrib(_eglDisplay, _eglConfig, EGL_NATIVE_VISUAL_ID, &nFmt) == EGL_FALSE) {
+                CC_LOG_ERROR("Getting configuration attributes failed.");
+                return;
+            }
+            uint width = _device->getWidth();
+            uint height = _device->getHeight();
+            ANativeWindow_setBuffersGeometry((ANativeWindow *)_windowHandle, width, height, nFmt);
+
+            _eglSurface = eglCreateWindowSurface(_eglDisplay, _eglConfig, (EGLNativeWindowType)_windowHandle, NULL);
+            if (_eglSurface == EGL_NO_SURFACE) {
+                CC_LOG_ERROR("Recreate window surface failed.");
+                return;
+            }
 
-        MakeCurrent();
-    });
+            MakeCurrent();
+        });
+    }
     #endif
 
     return true;
@@ -375,6 +378,10 @@ void GLES3Context::present() {
     eglSwapBuffers(_eglDisplay, _eglSurface);
 }
 
+void GLES3Context::ReleaseCurrent() {
+    eglMakeCurrent(_eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+}
+
 #endif
 
 bool GLES3Context::MakeCurrent() {
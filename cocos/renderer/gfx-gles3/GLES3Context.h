@@ -42,6 +42,7 @@ public:
     virtual void present() override;
 
     bool MakeCurrent();
+    void ReleaseCurrent();
     bool CheckExtension(const String &extension) const;
 
 #if (CC_PLATFORM == CC_PLATFORM_MAC_IOS)
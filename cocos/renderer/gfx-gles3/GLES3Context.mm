@@ -194,6 +194,11 @@ bool GLES3Context::MakeCurrentImpl()
   return [EAGLContext setCurrentContext:(EAGLContext*)_eaglContext];
 }
 
+void GLES3Context::ReleaseCurrent()
+{
+  [EAGLContext setCurrentContext:nil];
+}
+
 } // namespace gfx
 } // namespace cc
 
@@ -2,6 +2,7 @@
 
 #include "GLES3Buffer.h"
 #include "GLES3Commands.h"
+#include "GLES3Device.h"
 #include "GLES3DescriptorSet.h"
 #include "GLES3DescriptorSetLayout.h"
 #include "GLES3Sampler.h"
@@ -46,7 +47,8 @@ bool GLES3DescriptorSet::initialize(const DescriptorSetInfo &info) {
 
 void GLES3DescriptorSet::destroy() {
     if (_gpuDescriptorSet) {
-        CC_DELETE(_gpuDescriptorSet);
+        GLES3GPUDescriptorSet *gpuDescriptorSet = _gpuDescriptorSet;
+        ((GLES3Device *)_device)->execute([gpuDescriptorSet]() { CC_DELETE(gpuDescriptorSet); });
         _gpuDescriptorSet = nullptr;
     }
     // do remember to clear these or else it might not be properly updated when reused
@@ -57,21 +59,31 @@ void GLES3DescriptorSet::destroy() {
 
 void GLES3DescriptorSet::update() {
     if (_isDirty && _gpuDescriptorSet) {
-        const GLES3GPUDescriptorList &descriptors = _gpuDescriptorSet->gpuDescriptors;
+        GLES3Device *device = (GLES3Device *)_device;
+        // the render thread may still be reading the current descriptors, update a copy instead
+        GLES3GPUDescriptorList descriptorCopy;
+        if (device->isMultithreaded()) {
+            descriptorCopy = _gpuDescriptorSet->gpuDescriptors;
+        }
+        GLES3GPUDescriptorList &descriptors = device->isMultithreaded() ? descriptorCopy : _gpuDescriptorSet->gpuDescriptors;
         for (size_t i = 0; i < descriptors.size(); i++) {
             if ((uint)descriptors[i].type & DESCRIPTOR_BUFFER_TYPE) {
                 if (_buffers[i]) {
-                    _gpuDescriptorSet->gpuDescriptors[i].gpuBuffer = ((GLES3Buffer *)_buffers[i])->gpuBuffer();
+                    descriptors[i].gpuBuffer = ((GLES3Buffer *)_buffers[i])->gpuBuffer();
                 }
             } else if ((uint)descriptors[i].type & DESCRIPTOR_SAMPLER_TYPE) {
                 if (_textures[i]) {
-                    _gpuDescriptorSet->gpuDescriptors[i].gpuTexture = ((GLES3Texture *)_textures[i])->gpuTexture();
+                    descriptors[i].gpuTexture = ((GLES3Texture *)_textures[i])->gpuTexture();
                 }
                 if (_samplers[i]) {
-                    _gpuDescriptorSet->gpuDescriptors[i].gpuSampler = ((GLES3Sampler *)_samplers[i])->gpuSampler();
+                    descriptors[i].gpuSampler = ((GLES3Sampler *)_samplers[i])->gpuSampler();
                 }
             }
         }
+        if (device->isMultithreaded()) {
+            GLES3GPUDescriptorSet *gpuDescriptorSet = _gpuDescriptorSet;
+            device->execute([gpuDescriptorSet, descriptorCopy]() { gpuDescriptorSet->gpuDescriptors = descriptorCopy; });
+        }
         _isDirty = false;
     }
 }
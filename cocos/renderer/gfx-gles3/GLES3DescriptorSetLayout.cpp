@@ -1,6 +1,7 @@
 #include "GLES3Std.h"
 
 #include "GLES3Commands.h"
+#include "GLES3Device.h"
 #include "GLES3DescriptorSetLayout.h"
 
 namespace cc {
@@ -57,7 +58,8 @@ bool GLES3DescriptorSetLayout::initialize(const DescriptorSetLayoutInfo &info) {
 
 void GLES3DescriptorSetLayout::destroy() {
     if (_gpuDescriptorSetLayout) {
-        CC_DELETE(_gpuDescriptorSetLayout);
+        GLES3GPUDescriptorSetLayout *gpuDescriptorSetLayout = _gpuDescriptorSetLayout;
+        ((GLES3Device *)_device)->execute([gpuDescriptorSetLayout]() { CC_DELETE(gpuDescriptorSetLayout); });
         _gpuDescriptorSetLayout = nullptr;
     }
 }
@@ -11,11 +11,13 @@
 #include "GLES3InputAssembler.h"
 #include "GLES3PipelineLayout.h"
 #include "GLES3PipelineState.h"
+#include "GLES3QueryPool.h"
 #include "GLES3Queue.h"
 #include "GLES3RenderPass.h"
 #include "GLES3Sampler.h"
 #include "GLES3Shader.h"
 #include "GLES3Texture.h"
+#include "base/Startup.h"
 
 namespace cc {
 namespace gfx {
@@ -27,6 +29,7 @@ GLES3Device::~GLES3Device() {
 }
 
 bool GLES3Device::initialize(const DeviceInfo &info) {
+    CC_STARTUP_PHASE("GFXDevice");
     _API = API::GLES3;
     _deviceName = "GLES3";
     _width = info.width;
@@ -45,7 +48,9 @@ bool GLES3Device::initialize(const DeviceInfo &info) {
 
     _gpuStateCache = CC_NEW(GLES3GPUStateCache);
     _gpuCmdAllocator = CC_NEW(GLES3GPUCommandAllocator);
-    _gpuStagingBufferPool = CC_NEW(GLES3GPUStagingBufferPool);
+    for (uint i = 0u; i < GLES3RenderThread::FRAME_RESOURCE_COUNT; ++i) {
+        _gpuStagingBufferPools[i] = CC_NEW(GLES3GPUStagingBufferPool);
+    }
 
     ContextInfo ctxInfo;
     ctxInfo.windowHandle = _windowHandle;
@@ -81,6 +86,28 @@ bool GLES3Device::initialize(const DeviceInfo &info) {
     if (checkExtension("texture_half_float_linear"))
         _features[(int)Feature::TEXTURE_HALF_FLOAT_LINEAR] = true;
 
+    if (checkExtension("disjoint_timer_query") && glQueryCounterEXT && glGetQueryObjectui64vEXT)
+        _features[(int)Feature::TIMESTAMP_QUERY] = true;
+
+    _useParallelShaderCompile = checkExtension("parallel_shader_compile");
+    if (_useParallelShaderCompile && glMaxShaderCompilerThreadsKHR) {
+        // as many threads as the driver likes, it may compile on none before
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+    }
+
+    // tile based GPUs resolve the samples of framebuffer textures attached with these in tile memory
+    if (checkExtension("multisampled_render_to_texture")) {
+        if (glFramebufferTexture2DMultisampleEXT) {
+            glGetIntegerv(GL_MAX_SAMPLES_EXT, (GLint *)&_maxRenderToTextureSamples);
+        } else if (glFramebufferTexture2DMultisampleIMG) {
+            glGetIntegerv(GL_MAX_SAMPLES_IMG, (GLint *)&_maxRenderToTextureSamples);
+        }
+        _features[(int)Feature::MULTISAMPLED_RENDER_TO_TEXTURE] = _maxRenderToTextureSamples > 1;
+    }
+
+    // depth stencil copies are framebuffer blits, which ES 3.0 supports for any matching formats
+    _features[(int)Feature::DEPTH_STENCIL_COPY] = true;
+
     String compressedFmts;
 
     if (checkExtension("compressed_ETC1")) {
@@ -122,6 +149,8 @@ bool GLES3Device::initialize(const DeviceInfo &info) {
     CC_LOG_INFO("SCREEN_SIZE: %d x %d", _width, _height);
     CC_LOG_INFO("NATIVE_SIZE: %d x %d", _nativeWidth, _nativeHeight);
     CC_LOG_INFO("COMPRESSED_FORMATS: %s", compressedFmts.c_str());
+    CC_LOG_INFO("PARALLEL_SHADER_COMPILE: %s", _useParallelShaderCompile ? "true" : "false");
+    CC_LOG_INFO("MAX_RENDER_TO_TEXTURE_SAMPLES: %u", _maxRenderToTextureSamples);
 
     QueueInfo queueInfo;
     queueInfo.type = QueueType::GRAPHICS;
@@ -147,14 +176,74 @@ bool GLES3Device::initialize(const DeviceInfo &info) {
 
     _gpuStateCache->initialize(_maxTextureUnits, _maxUniformBufferBindings, _maxVertexAttributes);
 
+    _gpuStagingRing = CC_NEW(GLES3GPUStagingRing);
+    GLES3CmdFuncCreateStagingRing(this, _gpuStagingRing);
+
+    _gpuProgramCache = CC_NEW(GLES3GPUProgramCache);
+    GLES3CmdFuncCreateProgramCache(this, _gpuProgramCache);
+
+    if (info.multithreaded) {
+        _renderThread = CC_NEW(GLES3RenderThread((GLES3Context *)_context));
+        if (!_renderThread->start()) {
+            CC_LOG_WARNING("GLES3 render thread unavailable, falling back to single-threaded rendering.");
+            CC_SAFE_DELETE(_renderThread);
+        }
+    }
+
+    // created last, the render thread has to own the main context before another one can be bound here
+    ContextInfo uploadCtxInfo;
+    uploadCtxInfo.sharedCtx = _context;
+    _uploadContext = CC_NEW(GLES3Context(this));
+    if (_uploadContext->initialize(uploadCtxInfo)) {
+        _uploadThread = CC_NEW(GLES3RenderThread(_uploadContext));
+        if (!_uploadThread->start()) {
+            CC_SAFE_DELETE(_uploadThread);
+        }
+    }
+    if (_uploadThread) {
+        _gpuUploadStagingBufferPool = CC_NEW(GLES3GPUStagingBufferPool);
+        _features[(int)Feature::ASYNC_TEXTURE_UPLOAD] = true;
+    } else {
+        CC_LOG_WARNING("GLES3 upload context unavailable, async texture uploads fall back to synchronous ones.");
+        CC_SAFE_DESTROY(_uploadContext);
+    }
+    if (!_renderThread) {
+        ((GLES3Context *)_context)->MakeCurrent();
+    }
+
     return true;
 }
 
 void GLES3Device::destroy() {
+    if (_renderThread) {
+        _renderThread->stop();
+        CC_SAFE_DELETE(_renderThread);
+    }
+    if (_uploadThread) {
+        // the remaining uploads are handed over by now, stopping binds the upload context here
+        _uploadThread->stop();
+        CC_SAFE_DELETE(_uploadThread);
+        CC_SAFE_DESTROY(_uploadContext);
+        ((GLES3Context *)_context)->MakeCurrent();
+    }
+    CC_SAFE_DELETE(_gpuUploadStagingBufferPool);
+    _numPendingUploads = 0u;
+
     CC_SAFE_DESTROY(_queue);
     CC_SAFE_DESTROY(_cmdBuff);
+    if (_gpuStagingRing) {
+        GLES3CmdFuncDestroyStagingRing(this, _gpuStagingRing);
+        CC_DELETE(_gpuStagingRing);
+        _gpuStagingRing = nullptr;
+    }
+    if (_gpuStateCache && _gpuStateCache->glCopyFBOs[0]) {
+        glDeleteFramebuffers(2, _gpuStateCache->glCopyFBOs);
+    }
     CC_SAFE_DESTROY(_context);
-    CC_SAFE_DELETE(_gpuStagingBufferPool);
+    for (uint i = 0u; i < GLES3RenderThread::FRAME_RESOURCE_COUNT; ++i) {
+        CC_SAFE_DELETE(_gpuStagingBufferPools[i]);
+    }
+    CC_SAFE_DELETE(_gpuProgramCache);
     CC_SAFE_DELETE(_gpuCmdAllocator);
     CC_SAFE_DELETE(_gpuStateCache);
 }
@@ -165,8 +254,9 @@ void GLES3Device::resize(uint width, uint height) {
 }
 
 void GLES3Device::acquire() {
+    ++_frameCount;
     _gpuCmdAllocator->releaseCmds();
-    _gpuStagingBufferPool->reset();
+    stagingBufferPool()->reset();
 }
 
 void GLES3Device::present() {
@@ -174,13 +264,29 @@ void GLES3Device::present() {
     _numDrawCalls = queue->_numDrawCalls;
     _numInstances = queue->_numInstances;
     _numTriangles = queue->_numTriangles;
-
-    _context->present();
+    _numRedundantBindStates = queue->_numRedundantBindStates;
+    _numSkippedDescriptorBinds = queue->_numSkippedDescriptorBinds;
+
+    Context *context = _context;
+    GLES3GPUStagingRing *gpuStagingRing = _gpuStagingRing;
+    GLES3RenderThread *renderThread = _renderThread;
+    execute([this, context, gpuStagingRing, renderThread]() {
+        GLES3CmdFuncAdvanceStagingRing(this, gpuStagingRing);
+        GLES3CmdFuncPollShaders(this);
+        if (renderThread) renderThread->beginPresent();
+        context->present();
+        if (renderThread) renderThread->endPresent();
+    });
+    if (_renderThread) {
+        _renderThread->finishFrame();
+    }
 
     // Clear queue stats
     queue->_numDrawCalls = 0;
     queue->_numInstances = 0;
     queue->_numTriangles = 0;
+    queue->_numRedundantBindStates = 0;
+    queue->_numSkippedDescriptorBinds = 0;
 }
 
 CommandBuffer *GLES3Device::createCommandBuffer(const CommandBufferInfo &info) {
@@ -210,6 +316,15 @@ Queue *GLES3Device::createQueue(const QueueInfo &info) {
     return nullptr;
 }
 
+QueryPool *GLES3Device::createQueryPool(const QueryPoolInfo &info) {
+    QueryPool *queryPool = CC_NEW(GLES3QueryPool(this));
+    if (queryPool->initialize(info))
+        return queryPool;
+
+    CC_SAFE_DESTROY(queryPool);
+    return nullptr;
+}
+
 Buffer *GLES3Device::createBuffer(const BufferInfo &info) {
     Buffer *buffer = CC_NEW(GLES3Buffer(this));
     if (buffer->initialize(info))
@@ -256,6 +371,9 @@ Sampler *GLES3Device::createSampler(const SamplerInfo &info) {
 }
 
 Shader *GLES3Device::createShader(const ShaderInfo &info) {
+    Shader *prewarmed = takePrewarmedShader(info);
+    if (prewarmed) return prewarmed;
+
     Shader *shader = CC_NEW(GLES3Shader(this));
     if (shader->initialize(info))
         return shader;
@@ -328,7 +446,98 @@ PipelineState *GLES3Device::createPipelineState(const PipelineStateInfo &info) {
 }
 
 void GLES3Device::copyBuffersToTexture(const uint8_t *const *buffers, Texture *dst, const BufferTextureCopy *regions, uint count) {
-    GLES3CmdFuncCopyBuffersToTexture(this, buffers, ((GLES3Texture *)dst)->gpuTexture(), regions, count);
+    GLES3GPUTexture *gpuTexture = ((GLES3Texture *)dst)->gpuTexture();
+    if (!_renderThread) {
+        GLES3CmdFuncCopyBuffersToTexture(this, buffers, gpuTexture, regions, count);
+        return;
+    }
+
+    // the source buffers are owned by the caller, take a copy for the render thread
+    vector<BufferTextureCopy> regionCopies(regions, regions + count);
+    vector<uint> offsets;
+    uint totalSize = 0u;
+    for (uint i = 0u; i < count; ++i) {
+        const BufferTextureCopy &region = regions[i];
+        bool is3D = gpuTexture->type == TextureType::TEX3D;
+        uint sliceCount = is3D ? 1u : region.texSubres.layerCount;
+        uint size = FormatSize(gpuTexture->format, region.texExtent.width, region.texExtent.height, is3D ? region.texExtent.depth : 1u);
+        for (uint l = 0u; l < sliceCount; ++l) {
+            offsets.push_back(totalSize);
+            totalSize += size;
+        }
+    }
+    uint8_t *data = (uint8_t *)CC_MALLOC(totalSize);
+    for (size_t n = 0u; n < offsets.size(); ++n) {
+        uint size = (n + 1 < offsets.size() ? offsets[n + 1] : totalSize) - offsets[n];
+        memcpy(data + offsets[n], buffers[n], size);
+    }
+
+    execute([this, gpuTexture, data, regionCopies, offsets]() {
+        vector<const uint8_t *> sliceBuffers(offsets.size());
+        for (size_t n = 0u; n < offsets.size(); ++n) {
+            sliceBuffers[n] = data + offsets[n];
+        }
+        GLES3CmdFuncCopyBuffersToTexture(this, sliceBuffers.data(), gpuTexture, regionCopies.data(), (uint)regionCopies.size());
+        CC_FREE(data);
+    });
+}
+
+namespace {
+void signalFence(GLES3GPUFence *gpuFence) {
+    {
+        std::lock_guard<std::mutex> lock(gpuFence->mutex);
+        gpuFence->signaled = true;
+    }
+    gpuFence->cv.notify_all();
+}
+} // namespace
+
+void GLES3Device::copyBuffersToTextureAsync(const uint8_t *const *buffers, Texture *dst, const BufferTextureCopy *regions, uint count, Fence *fence) {
+    GLES3GPUFence *gpuFence = ((GLES3Fence *)fence)->gpuFence();
+    if (!_uploadThread) {
+        copyBuffersToTexture(buffers, dst, regions, count);
+        signalFence(gpuFence);
+        return;
+    }
+
+    GLES3GPUTexture *gpuTexture = ((GLES3Texture *)dst)->gpuTexture();
+    vector<BufferTextureCopy> regionCopies(regions, regions + count);
+    vector<const uint8_t *> sliceBuffers;
+    {
+        std::lock_guard<std::mutex> lock(_uploadMutex);
+        for (uint i = 0u; i < count; ++i) {
+            const BufferTextureCopy &region = regions[i];
+            bool is3D = gpuTexture->type == TextureType::TEX3D;
+            uint sliceCount = is3D ? 1u : region.texSubres.layerCount;
+            uint size = FormatSize(gpuTexture->format, region.texExtent.width, region.texExtent.height, is3D ? region.texExtent.depth : 1u);
+            for (uint l = 0u; l < sliceCount; ++l) {
+                uint8_t *data = _gpuUploadStagingBufferPool->alloc(size);
+                memcpy(data, buffers[sliceBuffers.size()], size);
+                sliceBuffers.push_back(data);
+            }
+        }
+        ++_numPendingUploads;
+    }
+    fence->reset();
+
+    // handed over through the render thread, which has to create the texture storage first
+    execute([this, gpuTexture, regionCopies, sliceBuffers, gpuFence]() {
+        // objects created on the main context are only visible to the upload context once flushed
+        glFlush();
+        // the main context binds the texture again on its next use, which makes the upload visible to it
+        for (GLuint &glTexture : _gpuStateCache->glTextures) {
+            if (glTexture == gpuTexture->glTexture) glTexture = 0u;
+        }
+
+        _uploadThread->enqueue([this, gpuTexture, regionCopies, sliceBuffers, gpuFence]() {
+            GLES3CmdFuncUploadBuffersToTexture(sliceBuffers.data(), gpuTexture, regionCopies.data(), (uint)regionCopies.size());
+            {
+                std::lock_guard<std::mutex> lock(_uploadMutex);
+                if (!--_numPendingUploads) _gpuUploadStagingBufferPool->reset();
+            }
+            signalFence(gpuFence);
+        });
+    });
 }
 
 } // namespace gfx
@@ -1,12 +1,18 @@
 #ifndef CC_GFXGLES3_DEVICE_H_
 #define CC_GFXGLES3_DEVICE_H_
 
+#include "GLES3RenderThread.h"
+
 namespace cc {
 namespace gfx {
 
+class GLES3Context;
 class GLES3GPUStateCache;
 class GLES3GPUCommandAllocator;
 class GLES3GPUStagingBufferPool;
+class GLES3GPUStagingRing;
+class GLES3GPUProgramCache;
+class GLES3GPUShader;
 
 class CC_GLES3_API GLES3Device : public Device {
 public:
@@ -22,6 +28,7 @@ public:
     virtual CommandBuffer *createCommandBuffer(const CommandBufferInfo &info) override;
     virtual Fence *createFence(const FenceInfo &info) override;
     virtual Queue *createQueue(const QueueInfo &info) override;
+    virtual QueryPool *createQueryPool(const QueryPoolInfo &info) override;
     virtual Buffer *createBuffer(const BufferInfo &info) override;
     virtual Buffer *createBuffer(const BufferViewInfo &info) override;
     virtual Texture *createTexture(const TextureInfo &info) override;
@@ -36,10 +43,36 @@ public:
     virtual PipelineLayout *createPipelineLayout(const PipelineLayoutInfo &info) override;
     virtual PipelineState *createPipelineState(const PipelineStateInfo &info) override;
     virtual void copyBuffersToTexture(const uint8_t *const *buffers, Texture *dst, const BufferTextureCopy *regions, uint count) override;
+    virtual void copyBuffersToTextureAsync(const uint8_t *const *buffers, Texture *dst, const BufferTextureCopy *regions, uint count, Fence *fence) override;
 
     CC_INLINE GLES3GPUStateCache *stateCache() const { return _gpuStateCache; }
     CC_INLINE GLES3GPUCommandAllocator *cmdAllocator() const { return _gpuCmdAllocator; }
-    CC_INLINE GLES3GPUStagingBufferPool *stagingBufferPool() const { return _gpuStagingBufferPool; }
+    CC_INLINE GLES3GPUStagingBufferPool *stagingBufferPool() const { return _gpuStagingBufferPools[_frameCount % GLES3RenderThread::FRAME_RESOURCE_COUNT]; }
+    CC_INLINE GLES3GPUStagingRing *stagingRing() const { return _gpuStagingRing; }
+    CC_INLINE GLES3GPUProgramCache *programCache() const { return _gpuProgramCache; }
+    // GL_KHR_parallel_shader_compile, shaders are completed a few frames after their creation
+    CC_INLINE bool useParallelShaderCompile() const { return _useParallelShaderCompile; }
+    // the shaders still linking in parallel, only touched on the GL thread
+    CC_INLINE vector<GLES3GPUShader *> &pendingShaders() { return _pendingShaders; }
+    // GL_EXT_multisampled_render_to_texture or its IMG variant, 0 without either
+    CC_INLINE uint getMaxRenderToTextureSamples() const { return _maxRenderToTextureSamples; }
+    CC_INLINE GLES3RenderThread *renderThread() const { return _renderThread; }
+    CC_INLINE uint getFrameCount() const { return _frameCount; }
+    // bind-states commands dropped and descriptor rebinds skipped during the last frame
+    CC_INLINE uint getNumRedundantBindStates() const { return _numRedundantBindStates; }
+    CC_INLINE uint getNumSkippedDescriptorBinds() const { return _numSkippedDescriptorBinds; }
+    CC_INLINE bool isMultithreaded() const { return _renderThread != nullptr; }
+
+    // Runs GL work on the render thread when multithreaded, inline otherwise.
+    // Tasks may run after the call returns, so they must not reference caller-owned memory.
+    template <typename Func>
+    CC_INLINE void execute(Func &&func) {
+        if (_renderThread) {
+            _renderThread->enqueue(std::forward<Func>(func));
+        } else {
+            func();
+        }
+    }
 
     CC_INLINE bool checkExtension(const String &extension) const {
         for (size_t i = 0; i < _extensions.size(); ++i) {
@@ -53,7 +86,25 @@ public:
 private:
     GLES3GPUStateCache *_gpuStateCache = nullptr;
     GLES3GPUCommandAllocator *_gpuCmdAllocator = nullptr;
-    GLES3GPUStagingBufferPool *_gpuStagingBufferPool = nullptr;
+    GLES3GPUStagingBufferPool *_gpuStagingBufferPools[GLES3RenderThread::FRAME_RESOURCE_COUNT] = {nullptr};
+    GLES3GPUStagingRing *_gpuStagingRing = nullptr;
+    GLES3GPUProgramCache *_gpuProgramCache = nullptr;
+    GLES3RenderThread *_renderThread = nullptr;
+
+    // async uploads run on a context sharing its objects with the main one, staged with the calling thread
+    GLES3Context *_uploadContext = nullptr;
+    GLES3RenderThread *_uploadThread = nullptr;
+    GLES3GPUStagingBufferPool *_gpuUploadStagingBufferPool = nullptr;
+    std::mutex _uploadMutex;
+    uint _numPendingUploads = 0u; // the staging pool is reset whenever it drops to 0
+
+    uint _frameCount = 0u;
+    uint _numRedundantBindStates = 0u;
+    uint _numSkippedDescriptorBinds = 0u;
+
+    bool _useParallelShaderCompile = false;
+    vector<GLES3GPUShader *> _pendingShaders;
+    uint _maxRenderToTextureSamples = 0u;
 
     StringArray _extensions;
 };
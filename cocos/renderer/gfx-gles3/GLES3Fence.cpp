@@ -20,26 +20,29 @@ bool GLES3Fence::initialize(const FenceInfo &info) {
         return false;
     }
 
-    // TODO
-
     return true;
 }
 
 void GLES3Fence::destroy() {
     if (_gpuFence) {
-        // TODO
-
         CC_DELETE(_gpuFence);
         _gpuFence = nullptr;
     }
 }
 
 void GLES3Fence::wait() {
-    // TODO
+    std::unique_lock<std::mutex> lock(_gpuFence->mutex);
+    _gpuFence->cv.wait(lock, [this]() { return _gpuFence->signaled; });
 }
 
 void GLES3Fence::reset() {
-    // TODO
+    std::lock_guard<std::mutex> lock(_gpuFence->mutex);
+    _gpuFence->signaled = false;
+}
+
+bool GLES3Fence::isSignaled() {
+    std::lock_guard<std::mutex> lock(_gpuFence->mutex);
+    return _gpuFence->signaled;
 }
 
 } // namespace gfx
@@ -16,6 +16,9 @@ public:
     virtual void destroy() override;
     virtual void wait() override;
     virtual void reset() override;
+    virtual bool isSignaled() override;
+
+    CC_INLINE GLES3GPUFence *gpuFence() const { return _gpuFence; }
 
 private:
     GLES3GPUFence *_gpuFence = nullptr;
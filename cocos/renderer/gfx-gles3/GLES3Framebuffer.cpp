@@ -2,6 +2,7 @@
 #include "GLES3Framebuffer.h"
 #include "GLES3RenderPass.h"
 #include "GLES3Commands.h"
+#include "GLES3Device.h"
 #include "GLES3Texture.h"
 
 namespace cc {
@@ -39,15 +40,21 @@ bool GLES3Framebuffer::initialize(const FramebufferInfo &info) {
         _gpuFBO->gpuDepthStencilTexture = ((GLES3Texture *)_depthStencilTexture)->gpuTexture();
     }
 
-    GLES3CmdFuncCreateFramebuffer((GLES3Device *)_device, _gpuFBO);
+    GLES3Device *device = (GLES3Device *)_device;
+    GLES3GPUFramebuffer *gpuFBO = _gpuFBO;
+    device->execute([device, gpuFBO]() { GLES3CmdFuncCreateFramebuffer(device, gpuFBO); });
 
     return true;
 }
 
 void GLES3Framebuffer::destroy() {
     if (_gpuFBO) {
-        GLES3CmdFuncDestroyFramebuffer((GLES3Device *)_device, _gpuFBO);
-        CC_DELETE(_gpuFBO);
+        GLES3Device *device = (GLES3Device *)_device;
+        GLES3GPUFramebuffer *gpuFBO = _gpuFBO;
+        device->execute([device, gpuFBO]() {
+            GLES3CmdFuncDestroyFramebuffer(device, gpuFBO);
+            CC_DELETE(gpuFBO);
+        });
         _gpuFBO = nullptr;
     }
 }
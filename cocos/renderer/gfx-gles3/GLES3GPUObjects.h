@@ -1,6 +1,11 @@
 #ifndef CC_GFXGLES3_GPU_OBJECTS_H_
 #define CC_GFXGLES3_GPU_OBJECTS_H_
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
 #include "gles3w.h"
 
 namespace cc {
@@ -136,6 +141,8 @@ public:
     GLES3GPUInputList glInputs;
     GLES3GPUUniformBlockList glBlocks;
     GLES3GPUUniformSamplerList glSamplers;
+    // set while the driver compiles and links the program on threads of its own, cleared on the GL thread
+    std::atomic<bool> isLinking{false};
 };
 
 struct GLES3GPUAttribute {
@@ -225,8 +232,50 @@ public:
     const vector<uint> *descriptorIndices = nullptr;
 };
 
+// Signaled by the upload thread once the uploads submitted with it completed on the GPU.
 class GLES3GPUFence : public Object {
 public:
+    bool signaled = true;
+    std::mutex mutex;
+    std::condition_variable cv;
+};
+
+class GLES3GPUQueryPool : public Object {
+public:
+    QueryType type = QueryType::TIMESTAMP;
+    uint maxQueryObjects = 0u;
+    vector<GLuint> glQueryIds;
+
+    // Results are read back on the GL thread into a cache tagged with the reset generation
+    // they belong to, so the device thread never waits for the render thread.
+    uint generation = 0u; // device thread only, bumped by every reset
+    std::atomic<uint> resolvedGeneration{~0u};
+    std::atomic<bool> isResolving{false};
+    uint resolvedFirst = 0u;
+    uint resolvedCount = 0u;
+    vector<uint64_t> results;
+};
+
+// GL-side ring that buffer updates are streamed through with unsynchronized mappings.
+// Every frame writes its own segment, which is fenced at present and only rewritten
+// once the GPU has signaled that fence SEGMENT_COUNT frames later.
+class GLES3GPUStagingRing : public Object {
+public:
+    static constexpr uint SEGMENT_COUNT = 3;
+    static constexpr uint SEGMENT_SIZE = 1024 * 1024;
+    static constexpr uint ALIGNMENT = 16;
+
+    GLuint glBuffer = 0;
+    uint segmentIndex = 0;
+    uint curOffset = 0;
+    GLsync glFences[SEGMENT_COUNT] = {0};
+};
+
+// The linked programs of earlier runs, one file each in the directory, which is emptied once the driver changed.
+class GLES3GPUProgramCache : public Object {
+public:
+    String path; // empty if the driver can't retrieve program binaries
+    uint64_t driverHash = 0;
 };
 
 class GLES3GPUStateCache : public Object {
@@ -245,6 +294,7 @@ public:
     vector<bool> glCurrentAttribLocs;
     GLuint glFramebuffer = 0;
     GLuint glReadFBO = 0;
+    GLuint glCopyFBOs[2] = {0, 0}; // read and draw framebuffers texture copies are blitted through
     Viewport viewport;
     Rect scissor;
     RasterizerState rs;
@@ -282,7 +332,7 @@ public:
         Buffer *buffer = nullptr;
         for (size_t idx = 0u; idx < bufferCount; idx++) {
             Buffer *cur = &_pool[idx];
-            if (chunkSize - cur->curOffset >= size) {
+            if (cur->size - cur->curOffset >= size) {
                 buffer = cur;
                 break;
             }
@@ -290,7 +340,8 @@ public:
         if (!buffer) {
             _pool.resize(bufferCount + 1);
             buffer = &_pool.back();
-            buffer->mappedData = (uint8_t *)CC_MALLOC(chunkSize);
+            buffer->size = std::max(chunkSize, size);
+            buffer->mappedData = (uint8_t *)CC_MALLOC(buffer->size);
         }
         uint8_t *data = buffer->mappedData + buffer->curOffset;
         buffer->curOffset += size;
@@ -306,6 +357,7 @@ public:
 private:
     struct Buffer {
         uint8_t *mappedData = nullptr;
+        size_t size = 0u;
         size_t curOffset = 0u;
     };
     vector<Buffer> _pool;
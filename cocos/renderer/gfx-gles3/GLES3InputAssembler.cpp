@@ -1,6 +1,7 @@
 #include "GLES3Std.h"
 #include "GLES3InputAssembler.h"
 #include "GLES3Commands.h"
+#include "GLES3Device.h"
 #include "GLES3Buffer.h"
 
 namespace cc {
@@ -42,7 +43,9 @@ bool GLES3InputAssembler::initialize(const InputAssemblerInfo &info) {
     if (info.indirectBuffer)
         _gpuInputAssembler->gpuIndirectBuffer = static_cast<GLES3Buffer *>(info.indirectBuffer)->gpuBuffer();
 
-    GLES3CmdFuncCreateInputAssembler((GLES3Device *)_device, _gpuInputAssembler);
+    GLES3Device *device = (GLES3Device *)_device;
+    GLES3GPUInputAssembler *gpuInputAssembler = _gpuInputAssembler;
+    device->execute([device, gpuInputAssembler]() { GLES3CmdFuncCreateInputAssembler(device, gpuInputAssembler); });
     _attributesHash = computeAttributesHash();
 
     return true;
@@ -50,8 +53,12 @@ bool GLES3InputAssembler::initialize(const InputAssemblerInfo &info) {
 
 void GLES3InputAssembler::destroy() {
     if (_gpuInputAssembler) {
-        GLES3CmdFuncDestroyInputAssembler((GLES3Device *)_device, _gpuInputAssembler);
-        CC_DELETE(_gpuInputAssembler);
+        GLES3Device *device = (GLES3Device *)_device;
+        GLES3GPUInputAssembler *gpuInputAssembler = _gpuInputAssembler;
+        device->execute([device, gpuInputAssembler]() {
+            GLES3CmdFuncDestroyInputAssembler(device, gpuInputAssembler);
+            CC_DELETE(gpuInputAssembler);
+        });
         _gpuInputAssembler = nullptr;
     }
 }
@@ -1,6 +1,7 @@
 #include "GLES3Std.h"
 
 #include "GLES3Commands.h"
+#include "GLES3Device.h"
 #include "GLES3DescriptorSetLayout.h"
 #include "GLES3PipelineLayout.h"
 
@@ -45,7 +46,8 @@ bool GLES3PipelineLayout::initialize(const PipelineLayoutInfo &info) {
 void GLES3PipelineLayout::destroy() {
 
     if (_gpuPipelineLayout) {
-        CC_DELETE(_gpuPipelineLayout);
+        GLES3GPUPipelineLayout *gpuPipelineLayout = _gpuPipelineLayout;
+        ((GLES3Device *)_device)->execute([gpuPipelineLayout]() { CC_DELETE(gpuPipelineLayout); });
         _gpuPipelineLayout = nullptr;
     }
 }
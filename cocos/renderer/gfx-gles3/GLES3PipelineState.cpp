@@ -1,6 +1,7 @@
 #include "GLES3Std.h"
 
 #include "GLES3Commands.h"
+#include "GLES3Device.h"
 #include "GLES3PipelineState.h"
 #include "GLES3PipelineLayout.h"
 #include "GLES3RenderPass.h"
@@ -44,6 +45,7 @@ bool GLES3PipelineState::initialize(const PipelineStateInfo &info) {
     _dynamicStates = info.dynamicStates;
     _renderPass = info.renderPass;
     _pipelineLayout = info.pipelineLayout;
+    _subpass = info.subpass;
 
     _gpuPipelineState = CC_NEW(GLES3GPUPipelineState);
     _gpuPipelineState->glPrimitive = GLES3Primitives[(int)_primitive];
@@ -65,7 +67,8 @@ bool GLES3PipelineState::initialize(const PipelineStateInfo &info) {
 
 void GLES3PipelineState::destroy() {
     if (_gpuPipelineState) {
-        CC_DELETE(_gpuPipelineState);
+        GLES3GPUPipelineState *gpuPipelineState = _gpuPipelineState;
+        ((GLES3Device *)_device)->execute([gpuPipelineState]() { CC_DELETE(gpuPipelineState); });
         _gpuPipelineState = nullptr;
     }
 }
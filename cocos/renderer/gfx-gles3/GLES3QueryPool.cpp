@@ -0,0 +1,72 @@
+#include "GLES3Std.h"
+
+#include "GLES3Commands.h"
+#include "GLES3Device.h"
+#include "GLES3QueryPool.h"
+
+namespace cc {
+namespace gfx {
+
+GLES3QueryPool::GLES3QueryPool(Device *device)
+: QueryPool(device) {
+}
+
+GLES3QueryPool::~GLES3QueryPool() {
+}
+
+bool GLES3QueryPool::initialize(const QueryPoolInfo &info) {
+    _type = info.type;
+    _maxQueryObjects = info.maxQueryObjects;
+
+    if (_type == QueryType::TIMESTAMP && !_device->hasFeature(Feature::TIMESTAMP_QUERY)) {
+        CC_LOG_ERROR("GLES3QueryPool: GL_EXT_disjoint_timer_query is not supported.");
+        return false;
+    }
+
+    _gpuQueryPool = CC_NEW(GLES3GPUQueryPool);
+    _gpuQueryPool->type = _type;
+    _gpuQueryPool->maxQueryObjects = _maxQueryObjects;
+
+    GLES3Device *device = (GLES3Device *)_device;
+    GLES3GPUQueryPool *gpuQueryPool = _gpuQueryPool;
+    device->execute([device, gpuQueryPool]() { GLES3CmdFuncCreateQueryPool(device, gpuQueryPool); });
+
+    return true;
+}
+
+void GLES3QueryPool::destroy() {
+    if (_gpuQueryPool) {
+        GLES3Device *device = (GLES3Device *)_device;
+        GLES3GPUQueryPool *gpuQueryPool = _gpuQueryPool;
+        device->execute([device, gpuQueryPool]() {
+            GLES3CmdFuncDestroyQueryPool(device, gpuQueryPool);
+            CC_DELETE(gpuQueryPool);
+        });
+        _gpuQueryPool = nullptr;
+    }
+}
+
+bool GLES3QueryPool::getResults(uint first, uint count, uint64_t *results) {
+    GLES3Device *device = (GLES3Device *)_device;
+    GLES3GPUQueryPool *gpuQueryPool = _gpuQueryPool;
+    uint generation = gpuQueryPool->generation;
+
+    if (gpuQueryPool->resolvedGeneration.load(std::memory_order_acquire) != generation &&
+        !gpuQueryPool->isResolving.exchange(true)) {
+        device->execute([device, gpuQueryPool, generation, first, count]() {
+            GLES3CmdFuncResolveQueryPool(device, gpuQueryPool, generation, first, count);
+        });
+    }
+
+    // resolved inline when single-threaded, otherwise picked up by one of the next calls
+    if (gpuQueryPool->resolvedGeneration.load(std::memory_order_acquire) != generation ||
+        gpuQueryPool->resolvedFirst != first || gpuQueryPool->resolvedCount != count) {
+        return false;
+    }
+
+    memcpy(results, gpuQueryPool->results.data(), count * sizeof(uint64_t));
+    return true;
+}
+
+} // namespace gfx
+} // namespace cc
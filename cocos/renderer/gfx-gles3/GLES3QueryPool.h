@@ -0,0 +1,30 @@
+#ifndef CC_GFXGLES3_QUERY_POOL_H_
+#define CC_GFXGLES3_QUERY_POOL_H_
+
+namespace cc {
+namespace gfx {
+
+class GLES3GPUQueryPool;
+
+class CC_GLES3_API GLES3QueryPool : public QueryPool {
+public:
+    GLES3QueryPool(Device *device);
+    ~GLES3QueryPool();
+
+public:
+    virtual bool initialize(const QueryPoolInfo &info) override;
+    virtual void destroy() override;
+    // Results are read back asynchronously with the render thread, a pool is resolved
+    // for a single range between two resets.
+    virtual bool getResults(uint first, uint count, uint64_t *results) override;
+
+    CC_INLINE GLES3GPUQueryPool *gpuQueryPool() const { return _gpuQueryPool; }
+
+private:
+    GLES3GPUQueryPool *_gpuQueryPool = nullptr;
+};
+
+} // namespace gfx
+} // namespace cc
+
+#endif
@@ -1,6 +1,7 @@
 #include "GLES3Std.h"
 #include "GLES3Queue.h"
 #include "GLES3Commands.h"
+#include "GLES3Device.h"
 #include "GLES3CommandBuffer.h"
 
 namespace cc {
@@ -26,10 +27,15 @@ void GLES3Queue::submit(const CommandBuffer *const *cmdBuffs, uint count, Fence
     if (!_isAsync) {
         for (uint i = 0; i < count; ++i) {
             GLES3CommandBuffer *cmdBuffer = (GLES3CommandBuffer *)cmdBuffs[i];
-            GLES3CmdFuncExecuteCmds((GLES3Device *)_device, cmdBuffer->_cmdPackage);
+            GLES3Device *device = (GLES3Device *)_device;
+            GLES3CmdPackage *cmdPackage = cmdBuffer->_cmdPackage;
+            GLES3CmdFuncOptimizeCmds(cmdPackage);
+            device->execute([device, cmdPackage]() { GLES3CmdFuncExecuteCmds(device, cmdPackage); });
             _numDrawCalls += cmdBuffer->_numDrawCalls;
             _numInstances += cmdBuffer->_numInstances;
             _numTriangles += cmdBuffer->_numTriangles;
+            _numRedundantBindStates += cmdPackage->numRedundantBindStates;
+            _numSkippedDescriptorBinds += cmdPackage->numSkippedDescriptorBinds;
         }
     }
 }
@@ -20,6 +20,8 @@ private:
     uint _numDrawCalls = 0;
     uint _numInstances = 0;
     uint _numTriangles = 0;
+    uint _numRedundantBindStates = 0;
+    uint _numSkippedDescriptorBinds = 0;
 };
 
 } // namespace gfx
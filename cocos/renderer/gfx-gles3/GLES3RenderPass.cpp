@@ -1,6 +1,7 @@
 #include "GLES3Std.h"
 #include "GLES3RenderPass.h"
 #include "GLES3Commands.h"
+#include "GLES3Device.h"
 
 namespace cc {
 namespace gfx {
@@ -28,7 +29,8 @@ bool GLES3RenderPass::initialize(const RenderPassInfo &info) {
 
 void GLES3RenderPass::destroy() {
     if (_gpuRenderPass) {
-        CC_DELETE(_gpuRenderPass);
+        GLES3GPURenderPass *gpuRenderPass = _gpuRenderPass;
+        ((GLES3Device *)_device)->execute([gpuRenderPass]() { CC_DELETE(gpuRenderPass); });
         _gpuRenderPass = nullptr;
     }
 }
@@ -0,0 +1,150 @@
+#include "GLES3Std.h"
+
+#include "GLES3Context.h"
+#include "GLES3RenderThread.h"
+#include "platform/PerformanceHint.h"
+
+namespace cc {
+namespace gfx {
+
+GLES3RenderThread::GLES3RenderThread(GLES3Context *context)
+: _context(context) {
+}
+
+GLES3RenderThread::~GLES3RenderThread() {
+    stop();
+}
+
+bool GLES3RenderThread::start() {
+    if (_running) return true;
+
+    _context->ReleaseCurrent();
+    _running = true;
+    _thread = std::thread(&GLES3RenderThread::run, this);
+
+    // the render thread makes the context current before consuming any task
+    flush();
+    if (!_contextReady) {
+        CC_LOG_ERROR("GLES3RenderThread: failed to bind the GL context on the render thread.");
+        stop();
+        return false;
+    }
+
+    CC_LOG_INFO("GLES3 render thread started.");
+    return true;
+}
+
+void GLES3RenderThread::stop() {
+    if (!_running) return;
+
+    {
+        std::lock_guard<std::mutex> lock(_taskMutex);
+        _running = false;
+    }
+    _taskCV.notify_one();
+    _thread.join();
+
+    _context->MakeCurrent();
+}
+
+void GLES3RenderThread::enqueue(Task &&task) {
+    uint tail = _tail.load(std::memory_order_relaxed);
+    while (tail - _head.load(std::memory_order_acquire) >= QUEUE_CAPACITY) {
+        std::this_thread::yield();
+    }
+
+    _tasks[tail % QUEUE_CAPACITY] = std::move(task);
+    _tail.store(tail + 1);
+
+    if (_sleeping.load()) {
+        std::lock_guard<std::mutex> lock(_taskMutex);
+        _taskCV.notify_one();
+    }
+}
+
+void GLES3RenderThread::flush() {
+    wait(signal());
+}
+
+void GLES3RenderThread::finishFrame() {
+    uint fence = signal();
+    wait(_frameFences[_frameIndex]);
+    _frameFences[_frameIndex] = fence;
+    _frameIndex = (_frameIndex + 1) % MAX_FRAMES_IN_FLIGHT;
+}
+
+void GLES3RenderThread::beginPresent() {
+    const auto now = std::chrono::steady_clock::now();
+    _workNS += std::chrono::duration_cast<std::chrono::nanoseconds>(now - _workStart).count();
+    _workStart = now;
+
+    // the session is created on the first frame here, the upload thread presents none
+    const int64_t targetNS = PerformanceHint::getFrameTarget();
+    if (targetNS > 0 && !_hintTargetNS) {
+        _hint.reset(PerformanceHint::create({PerformanceHint::getCurrentThreadId()}, targetNS));
+        _hintTargetNS = targetNS;
+    }
+    if (_hint) {
+        if (targetNS > 0 && targetNS != _hintTargetNS) {
+            _hint->setTarget(targetNS);
+            _hintTargetNS = targetNS;
+        }
+        _hint->report(_workNS);
+    }
+    _workNS = 0;
+}
+
+void GLES3RenderThread::endPresent() {
+    _workStart = std::chrono::steady_clock::now();
+}
+
+uint GLES3RenderThread::signal() {
+    uint fence = ++_lastFence;
+    enqueue([this, fence]() {
+        {
+            std::lock_guard<std::mutex> lock(_fenceMutex);
+            _signaledFence = fence;
+        }
+        _fenceCV.notify_all();
+    });
+    return fence;
+}
+
+void GLES3RenderThread::wait(uint fence) {
+    if (_signaledFence.load() >= fence) return;
+
+    std::unique_lock<std::mutex> lock(_fenceMutex);
+    _fenceCV.wait(lock, [this, fence]() { return _signaledFence.load() >= fence; });
+}
+
+void GLES3RenderThread::run() {
+    _contextReady = _context->MakeCurrent();
+    _workStart = std::chrono::steady_clock::now();
+
+    while (true) {
+        uint head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load()) {
+            std::unique_lock<std::mutex> lock(_taskMutex);
+            if (!_running) break;
+
+            _workNS += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _workStart).count();
+            _sleeping = true;
+            _taskCV.wait(lock, [this, head]() { return head != _tail.load() || !_running; });
+            _sleeping = false;
+            _workStart = std::chrono::steady_clock::now();
+            continue;
+        }
+
+        Task &task = _tasks[head % QUEUE_CAPACITY];
+        task();
+        task = nullptr;
+        _head.store(head + 1, std::memory_order_release);
+    }
+
+    _hint.reset();
+    _hintTargetNS = 0;
+    _context->ReleaseCurrent();
+}
+
+} // namespace gfx
+} // namespace cc
@@ -0,0 +1,83 @@
+#ifndef CC_GFXGLES3_RENDER_THREAD_H_
+#define CC_GFXGLES3_RENDER_THREAD_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace cc {
+class PerformanceHint;
+
+namespace gfx {
+
+class GLES3Context;
+
+// Owns the GL context on a dedicated thread and runs the tasks handed over by the device
+// in submission order. The task queue is a single-producer single-consumer ring, the device
+// thread being the only producer; at most one frame is allowed in flight. The time the thread
+// works on a frame is reported to a performance hint session of its own.
+class CC_GLES3_API GLES3RenderThread : public Object {
+public:
+    using Task = std::function<void()>;
+
+    static constexpr uint QUEUE_CAPACITY = 4096;
+    static constexpr uint MAX_FRAMES_IN_FLIGHT = 1;
+    // copies of per-frame resources needed to keep recording while the render thread consumes
+    static constexpr uint FRAME_RESOURCE_COUNT = MAX_FRAMES_IN_FLIGHT + 1;
+
+    GLES3RenderThread(GLES3Context *context);
+    ~GLES3RenderThread();
+
+public:
+    // Releases the context on the calling thread and makes it current on the render thread.
+    bool start();
+    // Drains the queue, stops the render thread and makes the context current on the calling thread again.
+    void stop();
+    void enqueue(Task &&task);
+    // Blocks until every task enqueued so far has been executed.
+    void flush();
+    // Marks the end of a frame and waits for the frames exceeding MAX_FRAMES_IN_FLIGHT.
+    void finishFrame();
+    // Called by the tasks around the wait for the display, which doesn't count to the work of the frame.
+    void beginPresent();
+    void endPresent();
+
+private:
+    void run();
+    uint signal();
+    void wait(uint fence);
+
+    GLES3Context *_context = nullptr;
+    std::thread _thread;
+    std::atomic<bool> _running{false};
+    std::atomic<bool> _sleeping{false};
+    bool _contextReady = false;
+
+    Task _tasks[QUEUE_CAPACITY];
+    std::atomic<uint> _head{0u}; // next slot to execute, written by the render thread
+    std::atomic<uint> _tail{0u}; // next slot to fill, written by the producer
+    std::mutex _taskMutex;
+    std::condition_variable _taskCV;
+
+    uint _lastFence = 0u;
+    uint _frameFences[MAX_FRAMES_IN_FLIGHT] = {0u};
+    uint _frameIndex = 0u;
+    std::atomic<uint> _signaledFence{0u};
+    std::mutex _fenceMutex;
+    std::condition_variable _fenceCV;
+
+    // used by the render thread only
+    std::unique_ptr<PerformanceHint> _hint;
+    int64_t _hintTargetNS = 0;
+    int64_t _workNS = 0;
+    std::chrono::steady_clock::time_point _workStart;
+};
+
+} // namespace gfx
+} // namespace cc
+
+#endif
@@ -1,6 +1,7 @@
 #include "GLES3Std.h"
 #include "GLES3Sampler.h"
 #include "GLES3Commands.h"
+#include "GLES3Device.h"
 
 namespace cc {
 namespace gfx {
@@ -36,15 +37,21 @@ bool GLES3Sampler::initialize(const SamplerInfo &info) {
     _gpuSampler->minLOD = _minLOD;
     _gpuSampler->maxLOD = _maxLOD;
 
-    GLES3CmdFuncCreateSampler((GLES3Device *)_device, _gpuSampler);
+    GLES3Device *device = (GLES3Device *)_device;
+    GLES3GPUSampler *gpuSampler = _gpuSampler;
+    device->execute([device, gpuSampler]() { GLES3CmdFuncCreateSampler(device, gpuSampler); });
 
     return true;
 }
 
 void GLES3Sampler::destroy() {
     if (_gpuSampler) {
-        GLES3CmdFuncDestroySampler((GLES3Device *)_device, _gpuSampler);
-        CC_DELETE(_gpuSampler);
+        GLES3Device *device = (GLES3Device *)_device;
+        GLES3GPUSampler *gpuSampler = _gpuSampler;
+        device->execute([device, gpuSampler]() {
+            GLES3CmdFuncDestroySampler(device, gpuSampler);
+            CC_DELETE(gpuSampler);
+        });
         _gpuSampler = nullptr;
     }
 }
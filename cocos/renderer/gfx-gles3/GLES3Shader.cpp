@@ -1,6 +1,7 @@
 #include "GLES3Std.h"
 #include "GLES3Shader.h"
 #include "GLES3Commands.h"
+#include "GLES3Device.h"
 
 namespace cc {
 namespace gfx {
@@ -28,15 +29,27 @@ bool GLES3Shader::initialize(const ShaderInfo &info) {
         _gpuShader->gpuStages.emplace_back(std::move(gpuShaderStage));
     }
 
-    GLES3CmdFuncCreateShader((GLES3Device *)_device, _gpuShader);
+    GLES3Device *device = (GLES3Device *)_device;
+    GLES3GPUShader *gpuShader = _gpuShader;
+    // set here, the creation may only run on the render thread later
+    gpuShader->isLinking = device->useParallelShaderCompile();
+    device->execute([device, gpuShader]() { GLES3CmdFuncCreateShader(device, gpuShader); });
 
     return true;
 }
 
+bool GLES3Shader::isReady() const {
+    return !_gpuShader || !_gpuShader->isLinking;
+}
+
 void GLES3Shader::destroy() {
     if (_gpuShader) {
-        GLES3CmdFuncDestroyShader((GLES3Device *)_device, _gpuShader);
-        CC_DELETE(_gpuShader);
+        GLES3Device *device = (GLES3Device *)_device;
+        GLES3GPUShader *gpuShader = _gpuShader;
+        device->execute([device, gpuShader]() {
+            GLES3CmdFuncDestroyShader(device, gpuShader);
+            CC_DELETE(gpuShader);
+        });
         _gpuShader = nullptr;
     }
 }
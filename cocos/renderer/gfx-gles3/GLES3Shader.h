@@ -14,6 +14,7 @@ public:
 public:
     virtual bool initialize(const ShaderInfo &info) override;
     virtual void destroy() override;
+    virtual bool isReady() const override;
 
     CC_INLINE GLES3GPUShader *gpuShader() const { return _gpuShader; }
 
@@ -1,6 +1,7 @@
 #include "GLES3Std.h"
 
 #include "GLES3Commands.h"
+#include "GLES3Device.h"
 #include "GLES3Texture.h"
 
 namespace cc {
@@ -89,7 +90,9 @@ bool GLES3Texture::initialize(const TextureInfo &info) {
     _gpuTexture->flags = _flags;
     _gpuTexture->isPowerOf2 = math::IsPowerOfTwo(_width) && math::IsPowerOfTwo(_height);
 
-    GLES3CmdFuncCreateTexture((GLES3Device *)_device, _gpuTexture);
+    GLES3Device *device = (GLES3Device *)_device;
+    GLES3GPUTexture *gpuTexture = _gpuTexture;
+    device->execute([device, gpuTexture]() { GLES3CmdFuncCreateTexture(device, gpuTexture); });
     _device->getMemoryStatus().textureSize += _size;
 
     return true;
@@ -104,9 +107,13 @@ bool GLES3Texture::initialize(const TextureViewInfo &info) {
 
 void GLES3Texture::destroy() {
     if (_gpuTexture) {
-        GLES3CmdFuncDestroyTexture((GLES3Device *)_device, _gpuTexture);
+        GLES3Device *device = (GLES3Device *)_device;
+        GLES3GPUTexture *gpuTexture = _gpuTexture;
+        device->execute([device, gpuTexture]() {
+            GLES3CmdFuncDestroyTexture(device, gpuTexture);
+            CC_DELETE(gpuTexture);
+        });
         _device->getMemoryStatus().textureSize -= _size;
-        CC_DELETE(_gpuTexture);
         _gpuTexture = nullptr;
     }
 
@@ -126,10 +133,16 @@ void GLES3Texture::resize(uint width, uint height) {
         _size = size;
 
         MemoryStatus &status = _device->getMemoryStatus();
-        _gpuTexture->width = _width;
-        _gpuTexture->height = _height;
-        _gpuTexture->size = _size;
-        GLES3CmdFuncResizeTexture((GLES3Device *)_device, _gpuTexture);
+        GLES3Device *device = (GLES3Device *)_device;
+        GLES3GPUTexture *gpuTexture = _gpuTexture;
+        const uint levelCount = _levelCount;
+        device->execute([device, gpuTexture, width, height, size, levelCount]() {
+            gpuTexture->width = width;
+            gpuTexture->height = height;
+            gpuTexture->size = size;
+            gpuTexture->mipLevel = levelCount;
+            GLES3CmdFuncResizeTexture(device, gpuTexture);
+        });
         status.bufferSize -= oldSize;
         status.bufferSize += _size;
 
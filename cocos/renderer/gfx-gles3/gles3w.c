@@ -469,6 +469,9 @@ PFNGLGETOBJECTLABELEXTPROC gles3wGetObjectLabelEXT;
 PFNGLINSERTEVENTMARKEREXTPROC gles3wInsertEventMarkerEXT;
 PFNGLPUSHGROUPMARKEREXTPROC gles3wPushGroupMarkerEXT;
 PFNGLPOPGROUPMARKEREXTPROC gles3wPopGroupMarkerEXT;
+PFNGLQUERYCOUNTEREXTPROC gles3wQueryCounterEXT;
+PFNGLMAXSHADERCOMPILERTHREADSKHRPROC gles3wMaxShaderCompilerThreadsKHR;
+PFNGLGETQUERYOBJECTUI64VEXTPROC gles3wGetQueryObjectui64vEXT;
 
 PFNGLDEBUGMESSAGECONTROLKHRPROC gles3wDebugMessageControlKHR;
 PFNGLDEBUGMESSAGECALLBACKKHRPROC gles3wDebugMessageCallbackKHR;
@@ -728,6 +731,9 @@ static void load_procs(void)
     gles3wInsertEventMarkerEXT = (PFNGLINSERTEVENTMARKEREXTPROC) get_proc("glInsertEventMarkerEXT");
     gles3wPushGroupMarkerEXT = (PFNGLPUSHGROUPMARKEREXTPROC) get_proc("glPushGroupMarkerEXT");
     gles3wPopGroupMarkerEXT = (PFNGLPOPGROUPMARKEREXTPROC) get_proc("glPopGroupMarkerEXT");
+    gles3wQueryCounterEXT = (PFNGLQUERYCOUNTEREXTPROC) get_proc("glQueryCounterEXT");
+    gles3wMaxShaderCompilerThreadsKHR = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC) get_proc("glMaxShaderCompilerThreadsKHR");
+    gles3wGetQueryObjectui64vEXT = (PFNGLGETQUERYOBJECTUI64VEXTPROC) get_proc("glGetQueryObjectui64vEXT");
     gles3wUseProgramStagesEXT = (PFNGLUSEPROGRAMSTAGESEXTPROC) get_proc("glUseProgramStagesEXT");
     gles3wActiveShaderProgramEXT = (PFNGLACTIVESHADERPROGRAMEXTPROC) get_proc("glActiveShaderProgramEXT");
     gles3wCreateShaderProgramvEXT = (PFNGLCREATESHADERPROGRAMVEXTPROC) get_proc("glCreateShaderProgramvEXT");
@@ -48,6 +48,22 @@ extern "C" {
 
 #endif /* GL_EXT_texture_sRGB */
 
+#ifndef GL_KHR_parallel_shader_compile
+    #define GL_KHR_parallel_shader_compile 1
+
+    #define GL_MAX_SHADER_COMPILER_THREADS_KHR     0x91B0
+    #define GL_COMPLETION_STATUS_KHR               0x91B1
+
+typedef void (GL_APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+#endif /* GL_KHR_parallel_shader_compile */
+
+#ifndef GL_MAX_SAMPLES_EXT
+    #define GL_MAX_SAMPLES_EXT                     0x8D57
+#endif
+#ifndef GL_MAX_SAMPLES_IMG
+    #define GL_MAX_SAMPLES_IMG                     0x9135
+#endif
+
 /* gles3w api */
 int gles3wInit();
 int gles3wIsSupported(int major, int minor);
@@ -595,6 +611,9 @@ extern PFNGLGETOBJECTLABELEXTPROC gles3wGetObjectLabelEXT;
 extern PFNGLINSERTEVENTMARKEREXTPROC gles3wInsertEventMarkerEXT;
 extern PFNGLPUSHGROUPMARKEREXTPROC gles3wPushGroupMarkerEXT;
 extern PFNGLPOPGROUPMARKEREXTPROC gles3wPopGroupMarkerEXT;
+extern PFNGLQUERYCOUNTEREXTPROC gles3wQueryCounterEXT;
+extern PFNGLMAXSHADERCOMPILERTHREADSKHRPROC gles3wMaxShaderCompilerThreadsKHR;
+extern PFNGLGETQUERYOBJECTUI64VEXTPROC gles3wGetQueryObjectui64vEXT;
 extern PFNGLUSEPROGRAMSTAGESEXTPROC gles3wUseProgramStagesEXT;
 extern PFNGLACTIVESHADERPROGRAMEXTPROC gles3wActiveShaderProgramEXT;
 extern PFNGLCREATESHADERPROGRAMVEXTPROC gles3wCreateShaderProgramvEXT;
@@ -888,6 +907,9 @@ extern PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEIMGPROC gles3wFramebufferTexture2DMul
 #define glInsertEventMarkerEXT                gles3wInsertEventMarkerEXT
 #define glPushGroupMarkerEXT                  gles3wPushGroupMarkerEXT
 #define glPopGroupMarkerEXT                   gles3wPopGroupMarkerEXT
+#define glQueryCounterEXT                     gles3wQueryCounterEXT
+#define glMaxShaderCompilerThreadsKHR         gles3wMaxShaderCompilerThreadsKHR
+#define glGetQueryObjectui64vEXT              gles3wGetQueryObjectui64vEXT
 #define glUseProgramStagesEXT                 gles3wUseProgramStagesEXT
 #define glActiveShaderProgramEXT              gles3wActiveShaderProgramEXT
 #define glCreateShaderProgramvEXT             gles3wCreateShaderProgramvEXT
@@ -1,5 +1,6 @@
 #pragma once
 
+#import <Metal/MTLBlitCommandEncoder.h>
 #import <Metal/MTLBuffer.h>
 #import <Metal/MTLRenderCommandEncoder.h>
 #import <Metal/MTLStageInputOutputDescriptor.h>
@@ -22,6 +23,8 @@ public:
     virtual void update(void *buffer, uint offset, uint size) override;
 
     void encodeBuffer(CCMTLRenderCommandEncoder &encoder, uint offset, uint binding, ShaderStageFlags stages);
+    // Copies the contents last encoded from the dynamic uniform ring into the persistent buffer.
+    void flushRing(id<MTLBlitCommandEncoder> encoder);
 
     CC_INLINE id<MTLBuffer> getMTLBuffer() const { return _mtlBuffer; }
     CC_INLINE MTLIndexType getIndexType() const { return _indexType; }
@@ -32,6 +35,7 @@ private:
     void resizeBuffer(uint8_t **, uint, uint);
     bool createMTLBuffer(uint size, MemoryUsage usage);
     void updateMTLBuffer(void *buffer, uint offset, uint size);
+    id<MTLBuffer> getRingBuffer(uint *ringOffset);
 
     id<MTLDevice> _mtlDevice = nil;
     id<MTLBuffer> _mtlBuffer = nullptr;
@@ -40,6 +44,15 @@ private:
     NSMutableArray *_dynamicDataBuffers = nil;
     bool _isIndirectDrawSupported = false;
     uint _bufferViewOffset = 0;
+    CCMTLBuffer *_sourceBuffer = nullptr;
+
+    // Uniform updates are kept in a CPU copy and written to a slice of the frame's staging ring
+    // the first time the buffer gets encoded after them, instead of a blit pass for each update.
+    uint8_t *_uniformData = nullptr;
+    bool _isUniformDirty = false;
+    id<MTLBuffer> _ringBuffer = nil;
+    uint _ringOffset = 0;
+    uint _ringFrame = UINT_MAX;
 
     bool _isDrawIndirectByIndex = false;
     std::vector<MTLDrawIndexedPrimitivesIndirectArguments> _indexedPrimitivesIndirectArguments;
@@ -1,4 +1,5 @@
 #include "MTLStd.h"
+#include "base/FrameStats.h"
 
 #include "MTLBuffer.h"
 #include "MTLCommandBuffer.h"
@@ -42,6 +43,15 @@ bool CCMTLBuffer::initialize(const BufferInfo &info) {
         }
     }
 
+    if (_usage & BufferUsageBit::UNIFORM && _size > 0) {
+        _uniformData = (uint8_t *)CC_MALLOC(_size);
+        if (!_uniformData) {
+            CC_LOG_ERROR("CCMTLBuffer: Failed to create uniform data buffer.");
+            return false;
+        }
+        memset(_uniformData, 0, _size);
+    }
+
     if (_usage & BufferUsageBit::VERTEX ||
         _usage & BufferUsageBit::UNIFORM ||
         _usage & BufferUsageBit::INDEX) {
@@ -61,6 +71,8 @@ bool CCMTLBuffer::initialize(const BufferInfo &info) {
 
 bool CCMTLBuffer::initialize(const BufferViewInfo &info) {
     *this = *static_cast<CCMTLBuffer *>(info.buffer);
+    _sourceBuffer = static_cast<CCMTLBuffer *>(info.buffer);
+    _uniformData = nullptr;
     _bufferViewOffset = info.offset;
     _isBufferView = true;
     return true;
@@ -72,7 +84,10 @@ bool CCMTLBuffer::createMTLBuffer(uint size, MemoryUsage usage) {
     if (_mtlBuffer) {
         [_mtlBuffer release];
     }
-    _mtlBuffer = [_mtlDevice newBufferWithLength:size options:_mtlResourceOptions];
+    _mtlBuffer = static_cast<CCMTLDevice *>(_device)->gpuHeapPool()->alloc(size, _mtlResourceOptions);
+    if (_mtlBuffer == nil) {
+        _mtlBuffer = [_mtlDevice newBufferWithLength:size options:_mtlResourceOptions];
+    }
     if (_mtlBuffer == nil) {
         CCASSERT(false, "Failed to create MTLBuffer.");
         return false;
@@ -93,6 +108,16 @@ void CCMTLBuffer::destroy() {
         _mtlBuffer = nil;
     }
 
+    if (_uniformData) {
+        CC_FREE(_uniformData);
+        _uniformData = nullptr;
+    }
+    if (_ringFrame == static_cast<CCMTLDevice *>(_device)->getFrameCount()) {
+        static_cast<CCMTLDevice *>(_device)->removeRingUniformBuffer(this);
+    }
+    _ringBuffer = nil;
+    _ringFrame = UINT_MAX;
+
     if (_buffer) {
         CC_FREE(_buffer);
         _device->getMemoryStatus().bufferSize -= _size;
@@ -124,6 +149,19 @@ void CCMTLBuffer::resize(uint size) {
     _size = size;
     _count = _size / _stride;
     resizeBuffer(&_buffer, _size, oldSize);
+    if (_uniformData) {
+        uint8_t *uniformData = (uint8_t *)CC_MALLOC(_size);
+        memcpy(uniformData, _uniformData, std::min(oldSize, _size));
+        if (_size > oldSize) memset(uniformData + oldSize, 0, _size - oldSize);
+        CC_FREE(_uniformData);
+        _uniformData = uniformData;
+        // the new persistent buffer has none of the old contents
+        _isUniformDirty = true;
+        if (_ringFrame == static_cast<CCMTLDevice *>(_device)->getFrameCount()) {
+            static_cast<CCMTLDevice *>(_device)->removeRingUniformBuffer(this);
+        }
+        _ringFrame = UINT_MAX;
+    }
     if (_usage & BufferUsageBit::INDIRECT) {
         if (_isIndirectDrawSupported) {
             createMTLBuffer(size, _memUsage);
@@ -160,6 +198,7 @@ void CCMTLBuffer::update(void *buffer, uint offset, uint size) {
         CC_LOG_WARNING("Cannot update a buffer view.");
         return;
     }
+    CC_FRAME_STAT_ADD(BUFFER_UPLOAD_BYTES, size);
 
     if (_buffer)
         memcpy(_buffer + offset, buffer, size);
@@ -167,6 +206,7 @@ void CCMTLBuffer::update(void *buffer, uint offset, uint size) {
     if (_usage & BufferUsageBit::INDIRECT) {
         if (_isIndirectDrawSupported) {
             uint drawInfoCount = size / _stride;
+            uint firstDrawInfo = offset / _stride;
             const DrawInfo *drawInfo = static_cast<const DrawInfo *>(buffer);
 
             if (drawInfoCount > 0) {
@@ -183,10 +223,10 @@ void CCMTLBuffer::update(void *buffer, uint offset, uint size) {
                         arguments.baseInstance = drawInfo->firstInstance;
                         ++drawInfo;
                     }
-                    updateMTLBuffer(_indexedPrimitivesIndirectArguments.data(), offset, drawInfoCount * stride);
+                    updateMTLBuffer(_indexedPrimitivesIndirectArguments.data(), firstDrawInfo * stride, drawInfoCount * stride);
                 } else {
                     _isDrawIndirectByIndex = false;
-                    uint stride = sizeof(MTLDrawIndexedPrimitivesIndirectArguments);
+                    uint stride = sizeof(MTLDrawPrimitivesIndirectArguments);
 
                     for (uint i = 0; i < drawInfoCount; ++i) {
                         auto &arguments = _primitiveIndirectArguments[i];
@@ -196,22 +236,56 @@ void CCMTLBuffer::update(void *buffer, uint offset, uint size) {
                         arguments.baseInstance = drawInfo->firstInstance;
                         ++drawInfo;
                     }
-                    updateMTLBuffer(_primitiveIndirectArguments.data(), offset, drawInfoCount * stride);
+                    updateMTLBuffer(_primitiveIndirectArguments.data(), firstDrawInfo * stride, drawInfoCount * stride);
                 }
             }
         } else {
-            memcpy(_drawInfos.data(), buffer, size);
+            memcpy(_drawInfos.data() + offset / _stride, buffer, size);
         }
+    } else if (_uniformData) {
+        memcpy(_uniformData + offset, buffer, size);
+        _isUniformDirty = true;
     } else {
         updateMTLBuffer(buffer, offset, size);
     }
 }
 
+id<MTLBuffer> CCMTLBuffer::getRingBuffer(uint *ringOffset) {
+    auto *device = static_cast<CCMTLDevice *>(_device);
+    const uint frame = device->getFrameCount();
+    if (_isUniformDirty) {
+        // draws encoded earlier keep reading the previous slice
+        CCMTLGPUBuffer slice;
+        slice.size = _size;
+        device->gpuStagingBufferPool()->alloc(&slice, std::max(device->getUboOffsetAlignment(), 1));
+        memcpy(slice.mappedData, _uniformData, _size);
+        if (_ringFrame != frame) {
+            device->addRingUniformBuffer(this);
+        }
+        _ringBuffer = slice.mtlBuffer;
+        _ringOffset = slice.startOffset;
+        _ringFrame = frame;
+        _isUniformDirty = false;
+    }
+
+    if (_ringFrame != frame) return _mtlBuffer;
+    *ringOffset = _ringOffset;
+    return _ringBuffer;
+}
+
+void CCMTLBuffer::flushRing(id<MTLBlitCommandEncoder> encoder) {
+    [encoder copyFromBuffer:_ringBuffer
+               sourceOffset:_ringOffset
+                   toBuffer:_mtlBuffer
+          destinationOffset:0
+                       size:_size];
+}
+
 void CCMTLBuffer::updateMTLBuffer(void *buffer, uint offset, uint size) {
     if (_mtlBuffer) {
         CommandBuffer *cmdBuffer = _device->getCommandBuffer();
         cmdBuffer->begin();
-        static_cast<CCMTLCommandBuffer *>(cmdBuffer)->updateBuffer(this, buffer, size, offset);
+        static_cast<CCMTLCommandBuffer *>(cmdBuffer)->copyToBuffer(this, buffer, size, offset);
 #if (CC_PLATFORM == CC_PLATFORM_MAC_OSX)
         if (_mtlResourceOptions == MTLResourceStorageModeManaged)
             [_mtlBuffer didModifyRange:NSMakeRange(0, _size)]; // Synchronize the managed buffer.
@@ -221,15 +295,23 @@ void CCMTLBuffer::updateMTLBuffer(void *buffer, uint offset, uint size) {
 
 void CCMTLBuffer::encodeBuffer(CCMTLRenderCommandEncoder &encoder, uint offset, uint binding, ShaderStageFlags stages) {
     if (_isBufferView) {
-        offset += _bufferViewOffset;
+        _sourceBuffer->encodeBuffer(encoder, offset + _bufferViewOffset, binding, stages);
+        return;
+    }
+
+    id<MTLBuffer> mtlBuffer = _mtlBuffer;
+    if (_uniformData) {
+        uint ringOffset = 0;
+        mtlBuffer = getRingBuffer(&ringOffset);
+        offset += ringOffset;
     }
 
     if (stages & ShaderStageFlagBit::VERTEX) {
-        encoder.setVertexBuffer(_mtlBuffer, offset, binding);
+        encoder.setVertexBuffer(mtlBuffer, offset, binding);
     }
 
     if (stages & ShaderStageFlagBit::FRAGMENT) {
-        encoder.setFragmentBuffer(_mtlBuffer, offset, binding);
+        encoder.setFragmentBuffer(mtlBuffer, offset, binding);
     }
 }
 
@@ -16,6 +16,7 @@ class CCMTLInputAssembler;
 class CCMTLDevice;
 class CCMTLRenderPass;
 class CCMTLFence;
+class CCMTLQueryPool;
 
 class CCMTLCommandBuffer : public CommandBuffer {
     friend class CCMTLQueue;
@@ -28,8 +29,9 @@ public:
     virtual void destroy() override;
     virtual void begin(RenderPass *renderPass, uint subpass, Framebuffer *frameBuffer) override;
     virtual void end() override;
-    virtual void beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea, const Color *colors, float depth, int stencil) override;
+    virtual void beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea, const Color *colors, float depth, int stencil, const CommandBuffer *const *secondaryCmdBuffs, uint secondaryCmdBuffCount) override;
     virtual void endRenderPass() override;
+    virtual void nextSubpass() override;
     virtual void bindPipelineState(PipelineState *pso) override;
     virtual void bindDescriptorSet(uint set, DescriptorSet *descriptorSet, uint dynamicOffsetCount, const uint *dynamicOffsets) override;
     virtual void bindInputAssembler(InputAssembler *ia) override;
@@ -42,9 +44,17 @@ public:
     virtual void setStencilWriteMask(StencilFace face, uint mask) override;
     virtual void setStencilCompareMask(StencilFace face, int ref, uint mask) override;
     virtual void draw(InputAssembler *ia) override;
+    virtual void drawIndirect(InputAssembler *ia, Buffer *indirectBuffer, uint drawOffset, uint drawCount) override;
     virtual void updateBuffer(Buffer *buff, const void *data, uint size, uint offset) override;
     virtual void copyBuffersToTexture(const uint8_t *const *buffers, Texture *texture, const BufferTextureCopy *regions, uint count) override;
+    virtual void copyTexture(Texture *srcTexture, Texture *dstTexture, const TextureCopy *regions, uint count) override;
     virtual void execute(const CommandBuffer *const *cmdBuffs, uint32_t count) override;
+    virtual void resetQueryPool(QueryPool *queryPool) override;
+    virtual void writeTimestamp(QueryPool *queryPool, uint query) override;
+    virtual void beginQuery(QueryPool *queryPool, uint query) override;
+    virtual void endQuery(QueryPool *queryPool, uint query) override;
+    // Blits raw data into the buffer, updateBuffer translates the DrawInfos of indirect buffers first.
+    void copyToBuffer(CCMTLBuffer *buffer, const void *data, uint size, uint offset);
     CC_INLINE bool isCommandBufferBegan() const { return _commandBufferBegan; }
     CC_INLINE id<MTLCommandBuffer> getMTLCommandBuffer() const { return _mtlCommandBuffer; } 
 
@@ -69,6 +79,8 @@ private:
     CCMTLInputAssembler *_inputAssembler = nullptr;
     MTLIndexType _indexType = MTLIndexTypeUInt16;
     MTLPrimitiveType _mtlPrimitiveType = MTLPrimitiveType::MTLPrimitiveTypeTriangle;
+    // occlusion pool the next render pass writes its visibility results to
+    CCMTLQueryPool *_visibilityQueryPool = nullptr;
 };
 
 } // namespace gfx
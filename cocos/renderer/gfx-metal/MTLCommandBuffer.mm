@@ -1,4 +1,5 @@
 #include "MTLStd.h"
+#include "base/FrameStats.h"
 
 #include "MTLBuffer.h"
 #include "MTLCommandBuffer.h"
@@ -9,6 +10,7 @@
 #include "MTLFramebuffer.h"
 #include "MTLInputAssembler.h"
 #include "MTLPipelineState.h"
+#include "MTLQueryPool.h"
 #include "MTLQueue.h"
 #include "MTLRenderPass.h"
 #include "MTLSampler.h"
@@ -55,6 +57,7 @@ void CCMTLCommandBuffer::begin(RenderPass *renderPass, uint subpass, Framebuffer
         dynamicOffset.clear();
     }
     _firstDirtyDescriptorSet = UINT_MAX;
+    _visibilityQueryPool = nullptr;
     _commandBufferBegan = true;
 }
 
@@ -69,14 +72,16 @@ bool CCMTLCommandBuffer::isRenderingEntireDrawable(const Rect &rect, const CCMTL
     return rect.x == 0 && rect.y == 0 && rect.width == renderTargetSize.x && rect.height == renderTargetSize.y;
 }
 
-void CCMTLCommandBuffer::beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea, const Color *colors, float depth, int stencil) {
+void CCMTLCommandBuffer::beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea, const Color *colors, float depth, int stencil, const CommandBuffer *const *secondaryCmdBuffs, uint secondaryCmdBuffCount) {
     auto isOffscreen = static_cast<CCMTLFramebuffer *>(fbo)->isOffscreen();
     if (!isOffscreen) {
         static_cast<CCMTLRenderPass *>(renderPass)->setColorAttachment(0, _mtkView.currentDrawable.texture, 0);
         static_cast<CCMTLRenderPass *>(renderPass)->setDepthStencilAttachment(_mtkView.depthStencilTexture, 0);
     }
     MTLRenderPassDescriptor *mtlRenderPassDescriptor = static_cast<CCMTLRenderPass *>(renderPass)->getMTLRenderPassDescriptor();
-    if (!isRenderingEntireDrawable(renderArea, static_cast<CCMTLRenderPass *>(renderPass))) {
+    // memoryless samples don't survive the extra encoder of a partial clear, they are cleared entirely instead
+    const bool isMultisampled = static_cast<CCMTLRenderPass *>(renderPass)->getSampleCount() > 1;
+    if (!isMultisampled && !isRenderingEntireDrawable(renderArea, static_cast<CCMTLRenderPass *>(renderPass))) {
         //Metal doesn't apply the viewports and scissors to renderpass load-action clearing.
         mu::clearRenderArea(_mtlDevice, _mtlCommandBuffer, renderPass, renderArea, colors, depth, stencil);
     } else {
@@ -84,13 +89,15 @@ void CCMTLCommandBuffer::beginRenderPass(RenderPass *renderPass, Framebuffer *fb
         const auto colorAttachmentCount = colorAttachments.size();
         for (size_t slot = 0u; slot < colorAttachmentCount; slot++) {
             mtlRenderPassDescriptor.colorAttachments[slot].clearColor = mu::toMTLClearColor(colors[slot]);
-            mtlRenderPassDescriptor.colorAttachments[slot].loadAction = colorAttachments[slot].loadOp == LoadOp::CLEAR ? MTLLoadActionClear : MTLLoadActionLoad;
+            const MTLLoadAction keepAction = isMultisampled ? MTLLoadActionDontCare : MTLLoadActionLoad;
+            mtlRenderPassDescriptor.colorAttachments[slot].loadAction = colorAttachments[slot].loadOp == LoadOp::CLEAR ? MTLLoadActionClear : keepAction;
         }
 
         mtlRenderPassDescriptor.depthAttachment.clearDepth = depth;
         mtlRenderPassDescriptor.stencilAttachment.clearStencil = stencil;
     }
 
+    mtlRenderPassDescriptor.visibilityResultBuffer = _visibilityQueryPool ? _visibilityQueryPool->getMTLVisibilityBuffer() : nil;
     _commandEncoder.initialize(_mtlCommandBuffer, mtlRenderPassDescriptor);
     _commandEncoder.setViewport(renderArea);
     _commandEncoder.setScissor(renderArea);
@@ -98,9 +105,16 @@ void CCMTLCommandBuffer::beginRenderPass(RenderPass *renderPass, Framebuffer *fb
 
 void CCMTLCommandBuffer::endRenderPass() {
     _commandEncoder.endEncoding();
+    // later render passes would reset the visibility results again
+    _visibilityQueryPool = nullptr;
+}
+
+void CCMTLCommandBuffer::nextSubpass() {
+    // render passes only have their first subpass without Feature::SUBPASS_INPUT
 }
 
 void CCMTLCommandBuffer::bindPipelineState(PipelineState *pso) {
+    CC_FRAME_STAT_ADD(PIPELINE_STATE_BINDS, 1);
     _gpuPipelineState = static_cast<CCMTLPipelineState *>(pso)->getGPUPipelineState();
     _mtlPrimitiveType = _gpuPipelineState->primitiveType;
 
@@ -117,6 +131,7 @@ void CCMTLCommandBuffer::bindPipelineState(PipelineState *pso) {
 }
 
 void CCMTLCommandBuffer::bindDescriptorSet(uint set, DescriptorSet *descriptorSet, uint dynamicOffsetCount, const uint *dynamicOffsets) {
+    CC_FRAME_STAT_ADD(DESCRIPTOR_SET_BINDS, 1);
     CCASSERT(set < _GPUDescriptorSets.size(), "Invalid set index");
     if (dynamicOffsetCount) {
         _dynamicOffsets[set].assign(dynamicOffsets, dynamicOffsets + dynamicOffsetCount);
@@ -183,6 +198,7 @@ void CCMTLCommandBuffer::draw(InputAssembler *ia) {
 
             if (_indirectDrawSuppotred) {
                 ++_numDrawCalls;
+                CC_FRAME_STAT_ADD(DRAW_CALLS, 1);
                 if (indirectBuffer->isDrawIndirectByIndex()) {
                     [mtlEncoder drawIndexedPrimitives:_mtlPrimitiveType
                                             indexType:_indexType
@@ -201,6 +217,7 @@ void CCMTLCommandBuffer::draw(InputAssembler *ia) {
                 uint drawInfoCount = indirectBuffer->getCount();
                 const auto &drawInfos = indirectBuffer->getDrawInfos();
                 _numDrawCalls += drawInfoCount;
+                CC_FRAME_STAT_ADD(DRAW_CALLS, drawInfoCount);
 
                 for (uint i = 0; i < drawInfoCount; ++i) {
                     const auto &drawInfo = drawInfos[i];
@@ -268,6 +285,7 @@ void CCMTLCommandBuffer::draw(InputAssembler *ia) {
             }
             _numInstances += drawInfo.instanceCount;
             _numDrawCalls++;
+            CC_FRAME_STAT_ADD(DRAW_CALLS, 1);
             if (_gpuPipelineState) {
                 uint indexCount = drawInfo.indexCount ? drawInfo.indexCount : drawInfo.vertexCount;
                 switch (_mtlPrimitiveType) {
@@ -289,11 +307,84 @@ void CCMTLCommandBuffer::draw(InputAssembler *ia) {
     }
 }
 
+void CCMTLCommandBuffer::drawIndirect(InputAssembler *ia, Buffer *indirectBuffer, uint drawOffset, uint drawCount) {
+    if (_type == CommandBufferType::SECONDARY) {
+        CC_LOG_ERROR("CommandBufferType::SECONDARY not implemented.");
+        return;
+    }
+    if (!indirectBuffer || !drawCount) return;
+
+    if (_firstDirtyDescriptorSet < _GPUDescriptorSets.size()) {
+        bindDescriptorSets();
+    }
+
+    const auto mtlIndirectBuffer = static_cast<CCMTLBuffer *>(indirectBuffer);
+    const auto indexBuffer = static_cast<CCMTLBuffer *>(ia->getIndexBuffer());
+    auto mtlEncoder = _commandEncoder.getMTLEncoder();
+    _numDrawCalls += drawCount;
+    CC_FRAME_STAT_ADD(DRAW_CALLS, drawCount);
+
+    // without indirect command buffers every argument is its own indirect draw
+    if (_indirectDrawSuppotred) {
+        const auto indirectMTLBuffer = mtlIndirectBuffer->getMTLBuffer();
+        for (uint i = drawOffset; i < drawOffset + drawCount; ++i) {
+            if (mtlIndirectBuffer->isDrawIndirectByIndex()) {
+                [mtlEncoder drawIndexedPrimitives:_mtlPrimitiveType
+                                        indexType:_indexType
+                                      indexBuffer:indexBuffer->getMTLBuffer()
+                                indexBufferOffset:0
+                                   indirectBuffer:indirectMTLBuffer
+                             indirectBufferOffset:i * sizeof(MTLDrawIndexedPrimitivesIndirectArguments)];
+            } else {
+                [mtlEncoder drawPrimitives:_mtlPrimitiveType
+                            indirectBuffer:indirectMTLBuffer
+                      indirectBufferOffset:i * sizeof(MTLDrawPrimitivesIndirectArguments)];
+            }
+        }
+        return;
+    }
+
+    const auto &drawInfos = mtlIndirectBuffer->getDrawInfos();
+    const uint drawEnd = std::min(drawOffset + drawCount, static_cast<uint>(drawInfos.size()));
+    for (uint i = drawOffset; i < drawEnd; ++i) {
+        const auto &drawInfo = drawInfos[i];
+        const uint instanceCount = std::max(drawInfo.instanceCount, 1u);
+        if (drawInfo.indexCount) {
+            [mtlEncoder drawIndexedPrimitives:_mtlPrimitiveType
+                                   indexCount:drawInfo.indexCount
+                                    indexType:_indexType
+                                  indexBuffer:indexBuffer->getMTLBuffer()
+                            indexBufferOffset:drawInfo.firstIndex * indexBuffer->getStride()
+                                instanceCount:instanceCount
+                                   baseVertex:drawInfo.firstVertex
+                                 baseInstance:drawInfo.firstInstance];
+        } else if (drawInfo.vertexCount) {
+            [mtlEncoder drawPrimitives:_mtlPrimitiveType
+                           vertexStart:drawInfo.firstVertex
+                           vertexCount:drawInfo.vertexCount
+                         instanceCount:instanceCount
+                          baseInstance:drawInfo.firstInstance];
+        }
+        _numInstances += drawInfo.instanceCount;
+    }
+}
+
 void CCMTLCommandBuffer::updateBuffer(Buffer *buff, const void *data, uint size, uint offset) {
     if (!buff) {
         CC_LOG_ERROR("CCMTLCommandBuffer::updateBuffer: buffer is nullptr.");
         return;
     }
+
+    // the arguments Metal reads differ from DrawInfo, the buffer converts them on update
+    if (buff->getUsage() & BufferUsageBit::INDIRECT) {
+        buff->update(const_cast<void *>(data), offset, size);
+        return;
+    }
+    CC_FRAME_STAT_ADD(BUFFER_UPLOAD_BYTES, size);
+    copyToBuffer(static_cast<CCMTLBuffer *>(buff), data, size, offset);
+}
+
+void CCMTLCommandBuffer::copyToBuffer(CCMTLBuffer *buffer, const void *data, uint size, uint offset) {
     CCMTLGPUBuffer stagingBuffer;
     stagingBuffer.size = size;
     _mtlDevice->gpuStagingBufferPool()->alloc(&stagingBuffer);
@@ -301,7 +392,7 @@ void CCMTLCommandBuffer::updateBuffer(Buffer *buff, const void *data, uint size,
     id<MTLBlitCommandEncoder> encoder = [_mtlCommandBuffer blitCommandEncoder];
     [encoder copyFromBuffer:stagingBuffer.mtlBuffer
                sourceOffset:stagingBuffer.startOffset
-                   toBuffer:((CCMTLBuffer *)buff)->getMTLBuffer()
+                   toBuffer:buffer->getMTLBuffer()
           destinationOffset:offset
                        size:size];
     [encoder endEncoding];
@@ -366,6 +457,32 @@ void CCMTLCommandBuffer::copyBuffersToTexture(const uint8_t *const *buffers, Tex
     [encoder endEncoding];
 }
 
+void CCMTLCommandBuffer::copyTexture(Texture *srcTexture, Texture *dstTexture, const TextureCopy *regions, uint count) {
+    if (!srcTexture || !dstTexture) {
+        CC_LOG_ERROR("CCMTLCommandBuffer::copyTexture: texture is nullptr");
+        return;
+    }
+
+    id<MTLTexture> mtlSrcTexture = static_cast<CCMTLTexture *>(srcTexture)->getMTLTexture();
+    id<MTLTexture> mtlDstTexture = static_cast<CCMTLTexture *>(dstTexture)->getMTLTexture();
+    id<MTLBlitCommandEncoder> encoder = [_mtlCommandBuffer blitCommandEncoder];
+    for (uint i = 0; i < count; i++) {
+        const auto &region = regions[i];
+        for (uint l = 0; l < region.srcSubres.layerCount; l++) {
+            [encoder copyFromTexture:mtlSrcTexture
+                         sourceSlice:region.srcSubres.baseArrayLayer + l
+                         sourceLevel:region.srcSubres.mipLevel
+                        sourceOrigin:MTLOriginMake(region.srcOffset.x, region.srcOffset.y, region.srcOffset.z)
+                          sourceSize:MTLSizeMake(region.extent.width, region.extent.height, region.extent.depth)
+                           toTexture:mtlDstTexture
+                    destinationSlice:region.dstSubres.baseArrayLayer + l
+                    destinationLevel:region.dstSubres.mipLevel
+                   destinationOrigin:MTLOriginMake(region.dstOffset.x, region.dstOffset.y, region.dstOffset.z)];
+        }
+    }
+    [encoder endEncoding];
+}
+
 void CCMTLCommandBuffer::execute(const CommandBuffer *const *commandBuffs, uint32_t count) {
     for (uint i = 0; i < count; ++i) {
         auto commandBuffer = static_cast<const CCMTLCommandBuffer *>(commandBuffs[i]);
@@ -375,6 +492,29 @@ void CCMTLCommandBuffer::execute(const CommandBuffer *const *commandBuffs, uint3
     }
 }
 
+void CCMTLCommandBuffer::resetQueryPool(QueryPool *queryPool) {
+    // counter samples are overwritten in place
+    if (queryPool->getType() == QueryType::OCCLUSION) {
+        _visibilityQueryPool = static_cast<CCMTLQueryPool *>(queryPool);
+        _visibilityQueryPool->resetVisibilityResults();
+    }
+}
+
+void CCMTLCommandBuffer::writeTimestamp(QueryPool *queryPool, uint query) {
+    static_cast<CCMTLQueryPool *>(queryPool)->sampleTimestamp(_mtlCommandBuffer, _commandEncoder.getMTLEncoder(), query);
+}
+
+void CCMTLCommandBuffer::beginQuery(QueryPool *queryPool, uint query) {
+    // visibility results only land in the pool attached to the current render pass
+    if (queryPool != _visibilityQueryPool) return;
+    _visibilityQueryPool->beginVisibilityQuery(_commandEncoder.getMTLEncoder(), query);
+}
+
+void CCMTLCommandBuffer::endQuery(QueryPool *queryPool, uint query) {
+    if (queryPool != _visibilityQueryPool) return;
+    _visibilityQueryPool->endVisibilityQuery(_commandEncoder.getMTLEncoder());
+}
+
 void CCMTLCommandBuffer::bindDescriptorSets() {
     auto &vertexBuffers = _inputAssembler->getVertexBuffers();
     for (const auto &bindingInfo : _gpuPipelineState->vertexBufferBindingInfo) {
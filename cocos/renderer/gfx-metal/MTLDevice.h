@@ -1,11 +1,15 @@
 #pragma once
 
 #include "MTLConfig.h"
+#include "base/MemoryPressure.h"
+#include <mutex>
 
 namespace cc {
 namespace gfx {
 
+class CCMTLBuffer;
 class CCMTLCommandAllocator;
+class CCMTLGPUHeapPool;
 class CCMTLGPUStagingBufferPool;
 class CCMTLSemaphore;
 
@@ -22,6 +26,7 @@ public:
     virtual CommandBuffer *createCommandBuffer(const CommandBufferInfo &info) override;
     virtual Fence *createFence(const FenceInfo &info) override;
     virtual Queue *createQueue(const QueueInfo &info) override;
+    virtual QueryPool *createQueryPool(const QueryPoolInfo &info) override;
     virtual Buffer *createBuffer(const BufferInfo &info) override;
     virtual Buffer *createBuffer(const BufferViewInfo &info) override;
     virtual Texture *createTexture(const TextureInfo &info) override;
@@ -36,6 +41,7 @@ public:
     virtual PipelineLayout *createPipelineLayout(const PipelineLayoutInfo &info) override;
     virtual PipelineState *createPipelineState(const PipelineStateInfo &info) override;
     virtual void copyBuffersToTexture(const uint8_t *const *buffers, Texture *dst, const BufferTextureCopy *regions, uint count) override;
+    virtual void copyBuffersToTextureAsync(const uint8_t *const *buffers, Texture *dst, const BufferTextureCopy *regions, uint count, Fence *fence) override;
 
     CC_INLINE void *getMTLCommandQueue() const { return _mtlCommandQueue; }
     CC_INLINE void *getMTKView() const { return _mtkView; }
@@ -46,13 +52,27 @@ public:
     CC_INLINE bool isIndirectCommandBufferSupported() const { return _icbSuppored; }
     CC_INLINE bool isIndirectDrawSupported() const { return _indirectDrawSupported; }
     CC_INLINE CCMTLGPUStagingBufferPool *gpuStagingBufferPool() const { return _gpuStagingBufferPools[_currentFrameIndex]; }
+    CC_INLINE CCMTLGPUHeapPool *gpuHeapPool() const { return _gpuHeapPool; }
+    CC_INLINE uint getFrameCount() const { return _frameCount; }
+
+    // Uniform buffers encoded from the dynamic ring this frame, their persistent buffers are caught up on present.
+    void addRingUniformBuffer(CCMTLBuffer *buffer);
+    void removeRingUniformBuffer(CCMTLBuffer *buffer);
     CC_INLINE bool isSamplerDescriptorCompareFunctionSupported() const { return _isSamplerDescriptorCompareFunctionSupported; }
 
+    // Render pipelines are looked up in the binary archive before they are compiled, the missing ones are harvested
+    // into it and written for the next launches by savePipelineCache(), which destroy() calls too.
+    CC_INLINE void *getMTLBinaryArchive() const { return _mtlBinaryArchive; }
+    void harvestRenderPipeline(void *descriptor);
+    void savePipelineCache();
+
 private:
-    void onMemoryWarning();
+    void onMemoryPressure(MemoryPressureLevel level);
+    void createPipelineCache();
 
 private:
     void *_mtlCommandQueue = nullptr;
+    void *_mtlTransferQueue = nullptr; // async uploads are blitted apart from the frames
     void *_mtkView = nullptr;
     void *_mtlDevice = nullptr;
     unsigned long _mtlFeatureSet = 0;
@@ -65,7 +85,13 @@ private:
     CCMTLGPUStagingBufferPool *_gpuStagingBufferPools[MAX_FRAMES_IN_FLIGHT] = {nullptr};
     CCMTLSemaphore *_inFlightSemaphore = nullptr;
     uint _currentFrameIndex = 0;
-    uint32_t _memoryAlarmListenerId = 0;
+    uint _frameCount = 0;
+    CCMTLGPUHeapPool *_gpuHeapPool = nullptr;
+    vector<CCMTLBuffer *> _ringUniformBuffers;
+    uint32_t _memoryPressureHandlerID = 0;
+    void *_mtlBinaryArchive = nullptr;
+    bool _isPipelineCacheDirty = false;
+    std::mutex _pipelineCacheMutex; // pipelines may be prewarmed on a worker thread
 };
 
 } // namespace gfx
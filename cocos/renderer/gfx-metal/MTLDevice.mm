@@ -12,6 +12,7 @@
 #include "MTLInputAssembler.h"
 #include "MTLPipelineLayout.h"
 #include "MTLPipelineState.h"
+#include "MTLQueryPool.h"
 #include "MTLQueue.h"
 #include "MTLRenderPass.h"
 #include "MTLSampler.h"
@@ -20,14 +21,20 @@
 #include "MTLTexture.h"
 #include "MTLUtils.h"
 #include "TargetConditionals.h"
-#include "cocos/bindings/event/CustomEventTypes.h"
-#include "cocos/bindings/event/EventDispatcher.h"
+#include "base/MemoryPressure.h"
+#include "base/Startup.h"
+#include "platform/FileUtils.h"
 
 #import <MetalKit/MTKView.h>
 #include <dispatch/dispatch.h>
 
 namespace cc {
 namespace gfx {
+namespace {
+String getPipelineCachePath() {
+    return FileUtils::getInstance()->getWritablePath() + "mtl_pipeline_cache.metallib";
+}
+} // namespace
 
 CCMTLDevice::CCMTLDevice() {
     _clipSpaceMinZ = 0.0f;
@@ -36,6 +43,7 @@ CCMTLDevice::CCMTLDevice() {
 }
 
 bool CCMTLDevice::initialize(const DeviceInfo &info) {
+    CC_STARTUP_PHASE("GFXDevice");
     _API = API::METAL;
     _deviceName = "Metal";
     _width = info.width;
@@ -59,6 +67,7 @@ bool CCMTLDevice::initialize(const DeviceInfo &info) {
     id<MTLDevice> mtlDevice = ((MTKView *)_mtkView).device;
     _mtlDevice = mtlDevice;
     _mtlCommandQueue = [mtlDevice newCommandQueue];
+    _mtlTransferQueue = [mtlDevice newCommandQueue];
 
     _mtlFeatureSet = mu::highestSupportedFeatureSet(mtlDevice);
     const auto gpuFamily = mu::getGPUFamily(MTLFeatureSet(_mtlFeatureSet));
@@ -99,6 +108,7 @@ bool CCMTLDevice::initialize(const DeviceInfo &info) {
     for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
         _gpuStagingBufferPools[i] = CC_NEW(CCMTLGPUStagingBufferPool(mtlDevice));
     }
+    _gpuHeapPool = CC_NEW(CCMTLGPUHeapPool(mtlDevice));
 
     _features[static_cast<int>(Feature::COLOR_FLOAT)] = mu::isColorBufferFloatSupported(gpuFamily);
     _features[static_cast<int>(Feature::COLOR_HALF_FLOAT)] = mu::isColorBufferHalfFloatSupported(gpuFamily);
@@ -140,8 +150,25 @@ bool CCMTLDevice::initialize(const DeviceInfo &info) {
     _features[static_cast<uint>(Feature::FORMAT_D24S8)] = mu::isDepthStencilFormatSupported(mtlDevice, Format::D24S8, gpuFamily);
     _features[static_cast<uint>(Feature::FORMAT_D32F)] = mu::isDepthStencilFormatSupported(mtlDevice, Format::D32F, gpuFamily);
     _features[static_cast<uint>(Feature::FORMAT_D32FS8)] = mu::isDepthStencilFormatSupported(mtlDevice, Format::D32F_S8, gpuFamily);
+    _features[static_cast<uint>(Feature::DEPTH_STENCIL_COPY)] = true;
+    _features[static_cast<uint>(Feature::ASYNC_TEXTURE_UPLOAD)] = true;
+    _features[static_cast<uint>(Feature::DRAW_INDIRECT)] = _indirectDrawSupported;
+#if (CC_PLATFORM == CC_PLATFORM_MAC_IOS)
+    // memoryless multisampled attachments, see CCMTLRenderPass; macOS resolves from private textures instead
+    _features[static_cast<uint>(Feature::MULTISAMPLED_RENDER_TO_TEXTURE)] = [mtlDevice supportsTextureSampleCount:4];
+#endif
+    if (@available(macOS 11.0, iOS 14.0, *)) {
+        bool hasTimestampCounters = false;
+        for (id<MTLCounterSet> counterSet in mtlDevice.counterSets) {
+            hasTimestampCounters |= [counterSet.name isEqualToString:MTLCommonCounterSetTimestamp];
+        }
+        _features[static_cast<uint>(Feature::TIMESTAMP_QUERY)] = hasTimestampCounters &&
+                                                                 [mtlDevice supportsCounterSampling:MTLCounterSamplingPointAtDrawBoundary] &&
+                                                                 [mtlDevice supportsCounterSampling:MTLCounterSamplingPointAtBlitBoundary];
+    }
 
-    _memoryAlarmListenerId = EventDispatcher::addCustomEventListener(EVENT_MEMORY_WARNING, std::bind(&CCMTLDevice::onMemoryWarning, this));
+    _memoryPressureHandlerID = MemoryPressure::addHandler("CCMTLDevice", MemoryPressureLevel::MODERATE, std::bind(&CCMTLDevice::onMemoryPressure, this, std::placeholders::_1));
+    createPipelineCache();
 
     CC_LOG_INFO("Metal Feature Set: %s", mu::featureSetToString(MTLFeatureSet(_mtlFeatureSet)).c_str());
 
@@ -149,9 +176,18 @@ bool CCMTLDevice::initialize(const DeviceInfo &info) {
 }
 
 void CCMTLDevice::destroy() {
-    if (_memoryAlarmListenerId != 0) {
-        EventDispatcher::removeCustomEventListener(EVENT_MEMORY_WARNING, _memoryAlarmListenerId);
-        _memoryAlarmListenerId = 0;
+    if (_memoryPressureHandlerID != 0) {
+        MemoryPressure::removeHandler(_memoryPressureHandlerID);
+        _memoryPressureHandlerID = 0;
+    }
+    if (_mtlBinaryArchive) {
+        savePipelineCache();
+        [id(_mtlBinaryArchive) release];
+        _mtlBinaryArchive = nullptr;
+    }
+    if (_mtlTransferQueue) {
+        [id<MTLCommandQueue>(_mtlTransferQueue) release];
+        _mtlTransferQueue = nullptr;
     }
     CC_SAFE_DESTROY(_queue);
     CC_SAFE_DESTROY(_cmdBuff);
@@ -162,6 +198,68 @@ void CCMTLDevice::destroy() {
         CC_SAFE_DELETE(_gpuStagingBufferPools[i]);
         _gpuStagingBufferPools[i] = nullptr;
     }
+    CC_SAFE_DELETE(_gpuHeapPool);
+    _ringUniformBuffers.clear();
+}
+
+void CCMTLDevice::createPipelineCache() {
+    if (@available(macOS 11.0, iOS 14.0, *)) {
+        id<MTLDevice> mtlDevice = id<MTLDevice>(_mtlDevice);
+        const String path = getPipelineCachePath();
+        MTLBinaryArchiveDescriptor *descriptor = [[MTLBinaryArchiveDescriptor alloc] init];
+        if (FileUtils::getInstance()->isFileExist(path)) {
+            descriptor.url = [NSURL fileURLWithPath:[NSString stringWithUTF8String:path.c_str()]];
+        }
+
+        NSError *nsError = nil;
+        id<MTLBinaryArchive> archive = [mtlDevice newBinaryArchiveWithDescriptor:descriptor error:&nsError];
+        if (!archive && descriptor.url) {
+            // archives of another OS version or GPU are rejected
+            CC_LOG_INFO("Metal pipeline cache is out of date, rebuilding.");
+            descriptor.url = nil;
+            archive = [mtlDevice newBinaryArchiveWithDescriptor:descriptor error:&nsError];
+        }
+        [descriptor release];
+
+        if (!archive) {
+            CC_LOG_WARNING("Failed to create the Metal binary archive: %s", [nsError.localizedDescription UTF8String]);
+            return;
+        }
+        _mtlBinaryArchive = archive;
+    }
+}
+
+void CCMTLDevice::harvestRenderPipeline(void *descriptor) {
+    if (@available(macOS 11.0, iOS 14.0, *)) {
+        if (!_mtlBinaryArchive) return;
+
+        std::lock_guard<std::mutex> lock(_pipelineCacheMutex);
+        NSError *nsError = nil;
+        if ([id<MTLBinaryArchive>(_mtlBinaryArchive) addRenderPipelineFunctionsWithDescriptor:(MTLRenderPipelineDescriptor *)descriptor error:&nsError]) {
+            _isPipelineCacheDirty = true;
+        } else {
+            CC_LOG_WARNING("Failed to add the render pipeline to the Metal binary archive: %s", [nsError.localizedDescription UTF8String]);
+        }
+    }
+}
+
+void CCMTLDevice::savePipelineCache() {
+    if (@available(macOS 11.0, iOS 14.0, *)) {
+        std::lock_guard<std::mutex> lock(_pipelineCacheMutex);
+        if (!_mtlBinaryArchive || !_isPipelineCacheDirty) return;
+
+        // the loaded archive may still be mapped from the file, it is replaced once the new one is complete
+        const String path = getPipelineCachePath();
+        const String tmpPath = path + ".tmp";
+        NSURL *url = [NSURL fileURLWithPath:[NSString stringWithUTF8String:tmpPath.c_str()]];
+        NSError *nsError = nil;
+        if (![id<MTLBinaryArchive>(_mtlBinaryArchive) serializeToURL:url error:&nsError] ||
+            !FileUtils::getInstance()->renameFile(tmpPath, path)) {
+            CC_LOG_WARNING("Failed to write the Metal pipeline cache.");
+            return;
+        }
+        _isPipelineCacheDirty = false;
+    }
 }
 
 void CCMTLDevice::resize(uint width, uint height) {}
@@ -182,11 +280,21 @@ void CCMTLDevice::present() {
     _numInstances = queue->_numInstances;
     _numTriangles = queue->_numTriangles;
 
+    auto mtlCommandBuffer = static_cast<CCMTLCommandBuffer *>(_cmdBuff)->getMTLCommandBuffer();
+    if (!_ringUniformBuffers.empty()) {
+        id<MTLBlitCommandEncoder> encoder = [mtlCommandBuffer blitCommandEncoder];
+        for (auto *buffer : _ringUniformBuffers) {
+            buffer->flushRing(encoder);
+        }
+        [encoder endEncoding];
+        _ringUniformBuffers.clear();
+    }
+
     //hold this pointer before update _currentFrameIndex
     CCMTLGPUStagingBufferPool *bufferPool = _gpuStagingBufferPools[_currentFrameIndex];
     _currentFrameIndex = (_currentFrameIndex + 1) % MAX_FRAMES_IN_FLIGHT;
+    ++_frameCount;
 
-    auto mtlCommandBuffer = static_cast<CCMTLCommandBuffer *>(_cmdBuff)->getMTLCommandBuffer();
     auto mtkView = static_cast<MTKView *>(_mtkView);
     [mtlCommandBuffer presentDrawable:mtkView.currentDrawable];
     [mtlCommandBuffer addCompletedHandler:^(id<MTLCommandBuffer> commandBuffer) {
@@ -206,6 +314,15 @@ Fence *CCMTLDevice::createFence(const FenceInfo &info) {
     return nullptr;
 }
 
+QueryPool *CCMTLDevice::createQueryPool(const QueryPoolInfo &info) {
+    auto queryPool = CC_NEW(CCMTLQueryPool(this));
+    if (queryPool && queryPool->initialize(info))
+        return queryPool;
+
+    CC_SAFE_DESTROY(queryPool);
+    return nullptr;
+}
+
 Queue *CCMTLDevice::createQueue(const QueueInfo &info) {
     auto queue = CC_NEW(CCMTLQueue(this));
     if (queue && queue->initialize(info))
@@ -270,6 +387,9 @@ Sampler *CCMTLDevice::createSampler(const SamplerInfo &info) {
 }
 
 Shader *CCMTLDevice::createShader(const ShaderInfo &info) {
+    Shader *prewarmed = takePrewarmedShader(info);
+    if (prewarmed) return prewarmed;
+
     auto shader = CC_NEW(CCMTLShader(this));
     if (shader && shader->initialize(info))
         return shader;
@@ -351,10 +471,99 @@ void CCMTLDevice::copyBuffersToTexture(const uint8_t *const *buffers, Texture *t
     static_cast<CCMTLCommandBuffer *>(_cmdBuff)->copyBuffersToTexture(buffers, texture, regions, count);
 }
 
-void CCMTLDevice::onMemoryWarning() {
+void CCMTLDevice::copyBuffersToTextureAsync(const uint8_t *const *buffers, Texture *texture, const BufferTextureCopy *regions, uint count, Fence *fence) {
+    auto *mtlFence = static_cast<CCMTLFence *>(fence);
+    auto *mtlTexture = static_cast<CCMTLTexture *>(texture);
+    mtlFence->reset();
+
+    const auto format = texture->getFormat();
+    const auto convertedFormat = mtlTexture->getConvertedFormat();
+    vector<uint> bufferSize(count);
+    vector<NSUInteger> offsets(count);
+    vector<CCMTLGPUBufferImageCopy> stagingRegions(count);
+    NSUInteger totalSize = 0;
+    for (size_t i = 0; i < count; i++) {
+        const auto &region = regions[i];
+        auto &stagingRegion = stagingRegions[i];
+        auto w = region.buffStride > 0 ? region.buffStride : region.texExtent.width;
+        auto h = region.buffTexHeight > 0 ? region.buffTexHeight : region.texExtent.height;
+        bufferSize[i] = w * h;
+        stagingRegion.sourceBytesPerRow = mu::getBytesPerRow(convertedFormat, w);
+        stagingRegion.sourceBytesPerImage = FormatSize(convertedFormat, w, h, region.texExtent.depth);
+        stagingRegion.sourceSize = {w, h, region.texExtent.depth};
+        stagingRegion.destinationSlice = region.texSubres.baseArrayLayer;
+        stagingRegion.destinationLevel = region.texSubres.mipLevel;
+        stagingRegion.destinationOrigin = {
+            static_cast<uint>(region.texOffset.x),
+            static_cast<uint>(region.texOffset.y),
+            static_cast<uint>(region.texOffset.z)};
+        offsets[i] = totalSize;
+        totalSize += stagingRegion.sourceBytesPerImage;
+    }
+
+    // staged apart from the per-frame pools, the upload may outlive the frame
+    id<MTLBuffer> stagingBuffer = [id<MTLDevice>(_mtlDevice) newBufferWithLength:totalSize options:MTLResourceStorageModeShared];
+    auto *stagingData = static_cast<uint8_t *>(stagingBuffer.contents);
+    for (size_t i = 0; i < count; i++) {
+        const auto convertedData = mu::convertData(buffers[i], bufferSize[i], format);
+        memcpy(stagingData + offsets[i], convertedData, stagingRegions[i].sourceBytesPerImage);
+        if (convertedData != buffers[i]) {
+            CC_FREE(convertedData);
+        }
+    }
+
+    id<MTLCommandBuffer> mtlCommandBuffer = [id<MTLCommandQueue>(_mtlTransferQueue) commandBuffer];
+    [mtlCommandBuffer retain];
+    id<MTLBlitCommandEncoder> encoder = [mtlCommandBuffer blitCommandEncoder];
+    id<MTLTexture> dstTexture = mtlTexture->getMTLTexture();
+    const bool isArrayTexture = mtlTexture->isArray();
+    for (size_t i = 0; i < count; i++) {
+        const auto &stagingRegion = stagingRegions[i];
+        const auto sourceBytesPerImage = isArrayTexture ? stagingRegion.sourceBytesPerImage : 0;
+        [encoder copyFromBuffer:stagingBuffer
+                   sourceOffset:offsets[i]
+              sourceBytesPerRow:mtlTexture->isPVRTC() ? 0 : stagingRegion.sourceBytesPerRow
+            sourceBytesPerImage:mtlTexture->isPVRTC() ? 0 : sourceBytesPerImage
+                     sourceSize:stagingRegion.sourceSize
+                      toTexture:dstTexture
+               destinationSlice:stagingRegion.destinationSlice
+               destinationLevel:stagingRegion.destinationLevel
+              destinationOrigin:stagingRegion.destinationOrigin];
+    }
+    if (texture->getFlags() & TextureFlags::GEN_MIPMAP && mu::pixelFormatIsColorRenderable(convertedFormat)) {
+        [encoder generateMipmapsForTexture:dstTexture];
+    }
+    [encoder endEncoding];
+
+    // command buffers of other queues see the texture once this one completed
+    [mtlCommandBuffer addCompletedHandler:^(id<MTLCommandBuffer> commandBuffer) {
+        [commandBuffer release];
+        mtlFence->signal();
+    }];
+    [mtlCommandBuffer commit];
+    // retained by the command buffer until it completes
+    [stagingBuffer release];
+}
+
+void CCMTLDevice::addRingUniformBuffer(CCMTLBuffer *buffer) {
+    _ringUniformBuffers.push_back(buffer);
+}
+
+void CCMTLDevice::removeRingUniformBuffer(CCMTLBuffer *buffer) {
+    auto iter = std::find(_ringUniformBuffers.begin(), _ringUniformBuffers.end(), buffer);
+    if (iter != _ringUniformBuffers.end()) {
+        _ringUniformBuffers.erase(iter);
+    }
+}
+
+void CCMTLDevice::onMemoryPressure(MemoryPressureLevel level) {
     for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
         _gpuStagingBufferPools[i]->shrinkSize();
     }
+    _gpuHeapPool->shrinkSize();
+
+    // the pipelines harvested so far survive the process being killed
+    if (level == MemoryPressureLevel::CRITICAL) savePipelineCache();
 }
 
 } // namespace gfx
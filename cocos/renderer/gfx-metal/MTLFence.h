@@ -1,4 +1,7 @@
 #pragma once
+
+#include <condition_variable>
+#include <mutex>
 namespace cc {
 namespace gfx {
 
@@ -11,8 +14,15 @@ public:
     virtual void destroy() override;
     virtual void wait() override;
     virtual void reset() override;
+    virtual bool isSignaled() override;
+
+    // called from the completion handlers of the command buffers submitted with the fence
+    void signal();
 
 private:
+    bool _signaled = true;
+    std::mutex _mutex;
+    std::condition_variable _cv;
 };
 
 } // namespace gfx
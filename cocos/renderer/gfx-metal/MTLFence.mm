@@ -18,9 +18,26 @@ void CCMTLFence::destroy() {
 }
 
 void CCMTLFence::wait() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _cv.wait(lock, [this]() { return _signaled; });
 }
 
 void CCMTLFence::reset() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _signaled = false;
+}
+
+bool CCMTLFence::isSignaled() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _signaled;
+}
+
+void CCMTLFence::signal() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _signaled = true;
+    }
+    _cv.notify_all();
 }
 
 } // namespace gfx
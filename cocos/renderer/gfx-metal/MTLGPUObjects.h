@@ -4,6 +4,7 @@
 
 #import "MTLUtils.h"
 #import <Metal/MTLBuffer.h>
+#import <Metal/MTLHeap.h>
 #import <Metal/MTLRenderCommandEncoder.h>
 #import <Metal/MTLRenderPipeline.h>
 #import <Metal/MTLSampler.h>
@@ -193,6 +194,77 @@ private:
     vector<Buffer> _pool;
 };
 
+/**
+ * Suballocates small private buffers from shared MTLHeaps instead of allocating each one from the device.
+ * Only used where heaps can be hazard tracked, untracked heap resources would need explicit fences.
+ */
+class CCMTLGPUHeapPool : public Object {
+public:
+    static constexpr NSUInteger HEAP_SIZE = 8 * 1024 * 1024;
+    static constexpr NSUInteger MAX_SUBALLOCATION_SIZE = 512 * 1024;
+
+    CCMTLGPUHeapPool(id<MTLDevice> device)
+    : _device(device) {
+        if (@available(iOS 13.0, macOS 10.15, *)) {
+            _isSupported = true;
+        }
+    }
+
+    ~CCMTLGPUHeapPool() {
+        for (id<MTLHeap> heap : _heaps) {
+            [heap release];
+        }
+        _heaps.clear();
+    }
+
+    // Returns nil when the buffer should be allocated from the device directly.
+    id<MTLBuffer> alloc(NSUInteger size, MTLResourceOptions options) {
+        if (!_isSupported || size > MAX_SUBALLOCATION_SIZE || (options & MTLResourceStorageModeMask) != MTLResourceStorageModePrivate) {
+            return nil;
+        }
+
+        if (@available(iOS 13.0, macOS 10.15, *)) {
+            MTLSizeAndAlign sizeAndAlign = [_device heapBufferSizeAndAlignWithLength:size options:options];
+            for (id<MTLHeap> heap : _heaps) {
+                if ([heap maxAvailableSizeWithAlignment:sizeAndAlign.align] >= sizeAndAlign.size) {
+                    id<MTLBuffer> buffer = [heap newBufferWithLength:size options:options];
+                    if (buffer) return buffer;
+                }
+            }
+
+            MTLHeapDescriptor *descriptor = [[MTLHeapDescriptor alloc] init];
+            descriptor.size = HEAP_SIZE;
+            descriptor.storageMode = MTLStorageModePrivate;
+            descriptor.hazardTrackingMode = MTLHazardTrackingModeTracked;
+            id<MTLHeap> heap = [_device newHeapWithDescriptor:descriptor];
+            [descriptor release];
+            if (!heap) {
+                _isSupported = false;
+                return nil;
+            }
+            _heaps.push_back(heap);
+            return [heap newBufferWithLength:size options:options];
+        }
+        return nil;
+    }
+
+    void shrinkSize() {
+        for (auto iter = _heaps.begin(); iter != _heaps.end();) {
+            if ([*iter usedSize] == 0) {
+                [*iter release];
+                iter = _heaps.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+    }
+
+private:
+    id<MTLDevice> _device = nil;
+    vector<id<MTLHeap>> _heaps;
+    bool _isSupported = false;
+};
+
 struct CCMTLGPUBufferImageCopy {
     NSUInteger sourceBytesPerRow = 0;
     NSUInteger sourceBytesPerImage = 0;
@@ -5,6 +5,7 @@
 #include "MTLGPUObjects.h"
 #include "MTLPipelineLayout.h"
 #include "MTLPipelineState.h"
+#include "MTLRenderPass.h"
 #include "MTLSampler.h"
 #include "MTLShader.h"
 #include "MTLTexture.h"
@@ -28,6 +29,7 @@ bool CCMTLPipelineState::initialize(const PipelineStateInfo &info) {
     _dynamicStates = info.dynamicStates;
     _renderPass = info.renderPass;
     _pipelineLayout = info.pipelineLayout;
+    _subpass = info.subpass;
 
     if (!createGPUPipelineState()) {
         return false;
@@ -215,6 +217,8 @@ void CCMTLPipelineState::setFormats(MTLRenderPipelineDescriptor *descriptor) {
     mtlPixelFormat = mu::toMTLPixelFormat(_renderPass->getDepthStencilAttachment().format);
     if (mtlPixelFormat != MTLPixelFormatInvalid)
         descriptor.stencilAttachmentPixelFormat = mtlPixelFormat;
+
+    descriptor.sampleCount = static_cast<CCMTLRenderPass *>(_renderPass)->getSampleCount();
 }
 
 void CCMTLPipelineState::setBlendStates(MTLRenderPipelineDescriptor *descriptor) {
@@ -244,8 +248,22 @@ void CCMTLPipelineState::setBlendStates(MTLRenderPipelineDescriptor *descriptor)
 }
 
 bool CCMTLPipelineState::createMTLRenderPipeline(MTLRenderPipelineDescriptor *descriptor) {
-    id<MTLDevice> mtlDevice = id<MTLDevice>(((CCMTLDevice *)_device)->getMTLDevice());
+    auto *device = static_cast<CCMTLDevice *>(_device);
+    id<MTLDevice> mtlDevice = id<MTLDevice>(device->getMTLDevice());
     NSError *nsError = nil;
+    if (@available(macOS 11.0, iOS 14.0, *)) {
+        id<MTLBinaryArchive> archive = id<MTLBinaryArchive>(device->getMTLBinaryArchive());
+        if (archive) {
+            descriptor.binaryArchives = @[archive];
+            // a miss fails without compiling, the functions are then harvested and the pipeline is built from the archive
+            _mtlRenderPipelineState = [mtlDevice newRenderPipelineStateWithDescriptor:descriptor
+                                                                              options:MTLPipelineOptionFailOnBinaryArchiveMiss
+                                                                           reflection:nil
+                                                                                error:nil];
+            if (_mtlRenderPipelineState) return true;
+            device->harvestRenderPipeline(descriptor);
+        }
+    }
     _mtlRenderPipelineState = [mtlDevice newRenderPipelineStateWithDescriptor:descriptor error:&nsError];
     if (!_mtlRenderPipelineState) {
         CC_LOG_ERROR("Failed to create MTLRenderPipelineState: %s", [nsError.localizedDescription UTF8String]);
@@ -0,0 +1,41 @@
+#pragma once
+
+#import <Metal/MTLCommandBuffer.h>
+#import <Metal/MTLCounters.h>
+#import <Metal/MTLRenderCommandEncoder.h>
+
+namespace cc {
+namespace gfx {
+
+// Timestamps are sampled into a counter sample buffer at draw or blit boundaries,
+// GPUs only able to sample at stage boundaries report no TIMESTAMP_QUERY feature.
+// Occlusion queries count visible samples into a visibility result buffer, which Metal attaches
+// to a render pass when it begins: only the next render pass after a reset writes the pool.
+class CCMTLQueryPool : public QueryPool {
+public:
+    CCMTLQueryPool(Device *device);
+    ~CCMTLQueryPool() = default;
+
+    virtual bool initialize(const QueryPoolInfo &info) override;
+    virtual void destroy() override;
+    virtual bool getResults(uint first, uint count, uint64_t *results) override;
+
+    void sampleTimestamp(id<MTLCommandBuffer> commandBuffer, id<MTLRenderCommandEncoder> renderEncoder, uint query);
+    void resetVisibilityResults();
+    void beginVisibilityQuery(id<MTLRenderCommandEncoder> renderEncoder, uint query);
+    void endVisibilityQuery(id<MTLRenderCommandEncoder> renderEncoder);
+
+    CC_INLINE id<MTLBuffer> getMTLVisibilityBuffer() const { return _mtlVisibilityBuffer; }
+
+private:
+    bool initializeOcclusion();
+
+    id _mtlSampleBuffer = nil; // id<MTLCounterSampleBuffer>
+    id<MTLBuffer> _mtlVisibilityBuffer = nil;
+    uint64_t _cpuTimestamp = 0u;
+    uint64_t _gpuTimestamp = 0u;
+    uint _lastSampleFrame = 0u;
+};
+
+} // namespace gfx
+} // namespace cc
@@ -0,0 +1,135 @@
+#include "MTLStd.h"
+
+#include "MTLConfig.h"
+#include "MTLDevice.h"
+#include "MTLQueryPool.h"
+
+namespace cc {
+namespace gfx {
+
+CCMTLQueryPool::CCMTLQueryPool(Device *device)
+: QueryPool(device) {
+}
+
+bool CCMTLQueryPool::initialize(const QueryPoolInfo &info) {
+    _type = info.type;
+    _maxQueryObjects = info.maxQueryObjects;
+
+    if (_type == QueryType::OCCLUSION) {
+        return initializeOcclusion();
+    }
+    if (!_device->hasFeature(Feature::TIMESTAMP_QUERY)) {
+        CC_LOG_ERROR("CCMTLQueryPool: counter sampling at draw boundaries is not supported.");
+        return false;
+    }
+
+    if (@available(macOS 11.0, iOS 14.0, *)) {
+        id<MTLDevice> mtlDevice = id<MTLDevice>(((CCMTLDevice *)_device)->getMTLDevice());
+        MTLCounterSampleBufferDescriptor *descriptor = [[MTLCounterSampleBufferDescriptor alloc] init];
+        for (id<MTLCounterSet> counterSet in mtlDevice.counterSets) {
+            if ([counterSet.name isEqualToString:MTLCommonCounterSetTimestamp]) {
+                descriptor.counterSet = counterSet;
+                break;
+            }
+        }
+        descriptor.storageMode = MTLStorageModeShared;
+        descriptor.sampleCount = _maxQueryObjects;
+
+        NSError *error = nil;
+        _mtlSampleBuffer = [mtlDevice newCounterSampleBufferWithDescriptor:descriptor error:&error];
+        [descriptor release];
+        if (!_mtlSampleBuffer) {
+            CC_LOG_ERROR("CCMTLQueryPool: failed to create counter sample buffer: %s", [error.localizedDescription UTF8String]);
+            return false;
+        }
+
+        // calibration point to convert GPU ticks into nanoseconds
+        [mtlDevice sampleTimestamps:&_cpuTimestamp gpuTimestamp:&_gpuTimestamp];
+        return true;
+    }
+    return false;
+}
+
+bool CCMTLQueryPool::initializeOcclusion() {
+    id<MTLDevice> mtlDevice = id<MTLDevice>(((CCMTLDevice *)_device)->getMTLDevice());
+    _mtlVisibilityBuffer = [mtlDevice newBufferWithLength:_maxQueryObjects * sizeof(uint64_t) options:MTLResourceStorageModeShared];
+    if (!_mtlVisibilityBuffer) {
+        CC_LOG_ERROR("CCMTLQueryPool: failed to create visibility result buffer.");
+        return false;
+    }
+    resetVisibilityResults();
+    return true;
+}
+
+void CCMTLQueryPool::destroy() {
+    if (_mtlSampleBuffer) {
+        [_mtlSampleBuffer release];
+        _mtlSampleBuffer = nil;
+    }
+    if (_mtlVisibilityBuffer) {
+        [_mtlVisibilityBuffer release];
+        _mtlVisibilityBuffer = nil;
+    }
+}
+
+void CCMTLQueryPool::resetVisibilityResults() {
+    // the buffer is shared, callers only reset pools whose results were read back
+    memset(_mtlVisibilityBuffer.contents, 0, _maxQueryObjects * sizeof(uint64_t));
+}
+
+void CCMTLQueryPool::beginVisibilityQuery(id<MTLRenderCommandEncoder> renderEncoder, uint query) {
+    [renderEncoder setVisibilityResultMode:MTLVisibilityResultModeCounting offset:query * sizeof(uint64_t)];
+    _lastSampleFrame = ((CCMTLDevice *)_device)->getFrameCount();
+}
+
+void CCMTLQueryPool::endVisibilityQuery(id<MTLRenderCommandEncoder> renderEncoder) {
+    [renderEncoder setVisibilityResultMode:MTLVisibilityResultModeDisabled offset:0];
+}
+
+void CCMTLQueryPool::sampleTimestamp(id<MTLCommandBuffer> commandBuffer, id<MTLRenderCommandEncoder> renderEncoder, uint query) {
+    if (@available(macOS 11.0, iOS 14.0, *)) {
+        id<MTLCounterSampleBuffer> sampleBuffer = _mtlSampleBuffer;
+        if (renderEncoder) {
+            [renderEncoder sampleCountersInBuffer:sampleBuffer atSampleIndex:query withBarrier:YES];
+        } else {
+            id<MTLBlitCommandEncoder> blitEncoder = [commandBuffer blitCommandEncoder];
+            [blitEncoder sampleCountersInBuffer:sampleBuffer atSampleIndex:query withBarrier:YES];
+            [blitEncoder endEncoding];
+        }
+        _lastSampleFrame = ((CCMTLDevice *)_device)->getFrameCount();
+    }
+}
+
+bool CCMTLQueryPool::getResults(uint first, uint count, uint64_t *results) {
+    CCMTLDevice *device = (CCMTLDevice *)_device;
+    // samples can only be resolved once the frame writing them has completed
+    if (device->getFrameCount() - _lastSampleFrame < MAX_FRAMES_IN_FLIGHT) return false;
+
+    if (_type == QueryType::OCCLUSION) {
+        memcpy(results, (const uint64_t *)_mtlVisibilityBuffer.contents + first, count * sizeof(uint64_t));
+        return true;
+    }
+
+    if (@available(macOS 11.0, iOS 14.0, *)) {
+        id<MTLCounterSampleBuffer> sampleBuffer = _mtlSampleBuffer;
+        NSData *data = [sampleBuffer resolveCounterRange:NSMakeRange(first, count)];
+        if (!data) return false;
+
+        id<MTLDevice> mtlDevice = id<MTLDevice>(device->getMTLDevice());
+        MTLTimestamp cpuTimestamp = 0u;
+        MTLTimestamp gpuTimestamp = 0u;
+        [mtlDevice sampleTimestamps:&cpuTimestamp gpuTimestamp:&gpuTimestamp];
+        double nsPerTick = gpuTimestamp > _gpuTimestamp ? double(cpuTimestamp - _cpuTimestamp) / double(gpuTimestamp - _gpuTimestamp) : 1.0;
+
+        const MTLCounterResultTimestamp *timestamps = (const MTLCounterResultTimestamp *)data.bytes;
+        for (uint i = 0u; i < count; ++i) {
+            if (timestamps[i].timestamp == MTLCounterErrorValue) return false;
+            results[i] = static_cast<uint64_t>(timestamps[i].timestamp * nsPerTick);
+        }
+        return true;
+    }
+    return false;
+}
+
+} // namespace gfx
+} // namespace cc
@@ -23,11 +23,18 @@ public:
     CC_INLINE MTLRenderPassDescriptor *getMTLRenderPassDescriptor() const { return _mtlRenderPassDescriptor; }
     CC_INLINE size_t getColorRenderTargetNums() const { return _colorRenderTargetNums; }
     CC_INLINE const vector<Vec2> &getRenderTargetSizes() const { return _renderTargetSizes; }
+    // Above 1 the pass renders into memoryless multisampled textures resolved into the attachments set.
+    CC_INLINE uint getSampleCount() const { return _sampleCount; }
 
 private:
+    id<MTLTexture> getMultisampleTexture(id<MTLTexture> &cache, id<MTLTexture> texture) const;
+
     MTLRenderPassDescriptor *_mtlRenderPassDescriptor = nil;
     size_t _colorRenderTargetNums = 0;
     vector<Vec2> _renderTargetSizes;
+    uint _sampleCount = 1;
+    vector<id<MTLTexture>> _multisampleTextures;
+    id<MTLTexture> _multisampleDepthStencilTexture = nil;
 };
 
 } // namespace gfx
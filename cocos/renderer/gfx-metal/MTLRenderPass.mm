@@ -29,12 +29,41 @@ bool CCMTLRenderPass::initialize(const RenderPassInfo &info) {
     _mtlRenderPassDescriptor.stencilAttachment.loadAction = mu::toMTLLoadAction(_depthStencilAttachment.stencilLoadOp);
     _mtlRenderPassDescriptor.stencilAttachment.storeAction = mu::toMTLStoreAction(_depthStencilAttachment.stencilStoreOp);
 
+    // the samples stay in tile memory, only the resolved colors are stored, see Feature::MULTISAMPLED_RENDER_TO_TEXTURE
+    if (!_colorAttachments.empty() && _colorAttachments[0].sampleCount > 1) {
+        id<MTLDevice> mtlDevice = id<MTLDevice>(static_cast<CCMTLDevice *>(_device)->getMTLDevice());
+        for (uint count = 2; count <= _colorAttachments[0].sampleCount && [mtlDevice supportsTextureSampleCount:count]; count *= 2) {
+            _sampleCount = count;
+        }
+    }
+    if (_sampleCount > 1) {
+        _multisampleTextures.resize(_colorRenderTargetNums, nil);
+        for (size_t slot = 0; slot < _colorRenderTargetNums; ++slot) {
+            auto *colorAttachment = _mtlRenderPassDescriptor.colorAttachments[slot];
+            if (colorAttachment.loadAction == MTLLoadActionLoad) colorAttachment.loadAction = MTLLoadActionDontCare;
+            colorAttachment.storeAction = _colorAttachments[slot].storeOp == StoreOp::STORE ? MTLStoreActionMultisampleResolve : MTLStoreActionDontCare;
+        }
+        for (MTLRenderPassAttachmentDescriptor *attachment in @[_mtlRenderPassDescriptor.depthAttachment, _mtlRenderPassDescriptor.stencilAttachment]) {
+            if (attachment.loadAction == MTLLoadActionLoad) attachment.loadAction = MTLLoadActionDontCare;
+            attachment.storeAction = MTLStoreActionDontCare;
+        }
+    }
+
     _hash = computeHash();
 
     return true;
 }
 
 void CCMTLRenderPass::destroy() {
+    for (id<MTLTexture> texture : _multisampleTextures) {
+        [texture release];
+    }
+    _multisampleTextures.clear();
+    if (_multisampleDepthStencilTexture) {
+        [_multisampleDepthStencilTexture release];
+        _multisampleDepthStencilTexture = nil;
+    }
+
     if (_mtlRenderPassDescriptor) {
         [_mtlRenderPassDescriptor release];
         _mtlRenderPassDescriptor = nil;
@@ -52,8 +81,14 @@ void CCMTLRenderPass::setColorAttachment(size_t slot, id<MTLTexture> texture, in
         return;
     }
 
-    _mtlRenderPassDescriptor.colorAttachments[slot].texture = texture;
-    _mtlRenderPassDescriptor.colorAttachments[slot].level = level;
+    if (_sampleCount > 1) {
+        _mtlRenderPassDescriptor.colorAttachments[slot].texture = getMultisampleTexture(_multisampleTextures[slot], texture);
+        _mtlRenderPassDescriptor.colorAttachments[slot].resolveTexture = texture;
+        _mtlRenderPassDescriptor.colorAttachments[slot].resolveLevel = level;
+    } else {
+        _mtlRenderPassDescriptor.colorAttachments[slot].texture = texture;
+        _mtlRenderPassDescriptor.colorAttachments[slot].level = level;
+    }
     _renderTargetSizes[slot] = {static_cast<float>(texture.width), static_cast<float>(texture.height)};
 }
 
@@ -63,11 +98,44 @@ void CCMTLRenderPass::setDepthStencilAttachment(id<MTLTexture> texture, int leve
         return;
     }
 
+    if (_sampleCount > 1) {
+        // the depth stencil samples are never stored, the texture only gives the size and format
+        texture = getMultisampleTexture(_multisampleDepthStencilTexture, texture);
+        level = 0;
+    }
     _mtlRenderPassDescriptor.depthAttachment.texture = texture;
     _mtlRenderPassDescriptor.depthAttachment.level = level;
     _mtlRenderPassDescriptor.stencilAttachment.texture = texture;
     _mtlRenderPassDescriptor.stencilAttachment.level = level;
 }
 
+id<MTLTexture> CCMTLRenderPass::getMultisampleTexture(id<MTLTexture> &cache, id<MTLTexture> texture) const {
+    if (!texture) return nil;
+    if (cache && cache.width == texture.width && cache.height == texture.height && cache.pixelFormat == texture.pixelFormat) {
+        return cache;
+    }
+
+    [cache release];
+    MTLTextureDescriptor *descriptor = [MTLTextureDescriptor texture2DDescriptorWithPixelFormat:texture.pixelFormat
+                                                                                          width:texture.width
+                                                                                         height:texture.height
+                                                                                      mipmapped:NO];
+    descriptor.textureType = MTLTextureType2DMultisample;
+    descriptor.sampleCount = _sampleCount;
+    descriptor.usage = MTLTextureUsageRenderTarget;
+#if (CC_PLATFORM == CC_PLATFORM_MAC_IOS)
+    if (@available(iOS 10.0, *)) {
+        descriptor.storageMode = MTLStorageModeMemoryless;
+    } else {
+        descriptor.storageMode = MTLStorageModePrivate;
+    }
+#else
+    descriptor.storageMode = MTLStorageModePrivate;
+#endif
+    id<MTLDevice> mtlDevice = id<MTLDevice>(static_cast<CCMTLDevice *>(_device)->getMTLDevice());
+    cache = [mtlDevice newTextureWithDescriptor:descriptor];
+    return cache;
+}
+
 } // namespace gfx
 } // namespace cc
@@ -9,6 +9,7 @@
 #include "StandAlone/ResourceLimits.h"
 #include "TargetConditionals.h"
 #include "gfx/GFXDef.h"
+#include "platform/FileUtils.h"
 #include "glslang/SPIRV/GlslangToSpv.h"
 #include "spirv_cross/spirv_msl.hpp"
 #include <vector>
@@ -117,8 +118,173 @@ enum class GPUFamily {
     Mac1,
     Mac2,
 };
+
+// Converted MSL of a stage along with the resources it binds, keyed by the hash of everything the conversion reads,
+// so that later launches skip glslang and spirv-cross.
+constexpr uint SHADER_CACHE_MAGIC = 0x43534d43; // 'CMSC'
+constexpr uint SHADER_CACHE_VERSION = 1u;
+
+struct ShaderReflection {
+    vector<CCMTLGPUUniformBlock> blocks;
+    vector<CCMTLGPUSamplerBlock> samplers;
+};
+
+uint64_t hashShaderSource(const String &src, ShaderStageFlagBit shaderType, Device *device) {
+    // FNV-1a, stable between launches unlike std::hash
+    uint64_t hash = 14695981039346656037ULL;
+    auto combine = [&hash](const void *data, size_t size) {
+        const auto *bytes = static_cast<const uint8_t *>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        }
+    };
+    const uint maxBufferBindingIndex = static_cast<CCMTLDevice *>(device)->getMaximumBufferBindingIndex();
+    const uint maxSamplerUnits = static_cast<CCMTLDevice *>(device)->getMaximumSamplerUnits();
+    const auto &bindingMappingInfo = device->bindingMappingInfo();
+    combine(src.data(), src.size());
+    combine(&shaderType, sizeof(shaderType));
+    combine(&maxBufferBindingIndex, sizeof(maxBufferBindingIndex));
+    combine(&maxSamplerUnits, sizeof(maxSamplerUnits));
+    combine(bindingMappingInfo.bufferOffsets.data(), bindingMappingInfo.bufferOffsets.size() * sizeof(int));
+    combine(bindingMappingInfo.samplerOffsets.data(), bindingMappingInfo.samplerOffsets.size() * sizeof(int));
+    return hash;
+}
+
+String getShaderCachePath(uint64_t hash) {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(hash));
+    return FileUtils::getInstance()->getWritablePath() + "mtl_shader_cache/" + name;
 }
 
+void writeUint(String &out, uint value) { out.append(reinterpret_cast<const char *>(&value), sizeof(value)); }
+
+void writeString(String &out, const String &value) {
+    writeUint(out, static_cast<uint>(value.size()));
+    out.append(value);
+}
+
+struct ShaderCacheReader {
+    const String &data;
+    size_t offset = 0;
+    bool failed = false;
+
+    uint readUint() {
+        uint value = 0u;
+        if (offset + sizeof(value) > data.size()) {
+            failed = true;
+            return value;
+        }
+        memcpy(&value, data.data() + offset, sizeof(value));
+        offset += sizeof(value);
+        return value;
+    }
+
+    String readString() {
+        const uint size = readUint();
+        if (failed || offset + size > data.size()) {
+            failed = true;
+            return "";
+        }
+        offset += size;
+        return data.substr(offset - size, size);
+    }
+};
+
+bool loadShaderCache(const String &path, uint64_t hash, uint sourceSize, ShaderReflection &reflection, String &msl) {
+    auto *fileUtils = FileUtils::getInstance();
+    if (!fileUtils->isFileExist(path)) return false;
+
+    const String data = fileUtils->getStringFromFile(path);
+    ShaderCacheReader reader{data};
+    if (reader.readUint() != SHADER_CACHE_MAGIC || reader.readUint() != SHADER_CACHE_VERSION) return false;
+    const uint hashLow = reader.readUint();
+    const uint hashHigh = reader.readUint();
+    // the source size catches the odd hash collision
+    if (hashLow != static_cast<uint>(hash) || hashHigh != static_cast<uint>(hash >> 32) || reader.readUint() != sourceSize) return false;
+
+    const uint blockCount = reader.readUint();
+    for (uint i = 0u; i < blockCount && !reader.failed; ++i) {
+        CCMTLGPUUniformBlock block;
+        block.name = reader.readString();
+        block.set = reader.readUint();
+        block.binding = reader.readUint();
+        block.mappedBinding = reader.readUint();
+        block.size = reader.readUint();
+        reflection.blocks.push_back(std::move(block));
+    }
+    const uint samplerCount = reader.readUint();
+    for (uint i = 0u; i < samplerCount && !reader.failed; ++i) {
+        CCMTLGPUSamplerBlock sampler;
+        sampler.name = reader.readString();
+        sampler.set = reader.readUint();
+        sampler.binding = reader.readUint();
+        sampler.textureBinding = reader.readUint();
+        sampler.samplerBinding = reader.readUint();
+        reflection.samplers.push_back(std::move(sampler));
+    }
+    msl = reader.readString();
+    if (reader.failed || msl.empty()) {
+        reflection = {};
+        return false;
+    }
+    return true;
+}
+
+void saveShaderCache(const String &path, uint64_t hash, uint sourceSize, const ShaderReflection &reflection, const String &msl) {
+    String data;
+    writeUint(data, SHADER_CACHE_MAGIC);
+    writeUint(data, SHADER_CACHE_VERSION);
+    writeUint(data, static_cast<uint>(hash));
+    writeUint(data, static_cast<uint>(hash >> 32));
+    writeUint(data, sourceSize);
+    writeUint(data, static_cast<uint>(reflection.blocks.size()));
+    for (const auto &block : reflection.blocks) {
+        writeString(data, block.name);
+        writeUint(data, block.set);
+        writeUint(data, block.binding);
+        writeUint(data, block.mappedBinding);
+        writeUint(data, static_cast<uint>(block.size));
+    }
+    writeUint(data, static_cast<uint>(reflection.samplers.size()));
+    for (const auto &sampler : reflection.samplers) {
+        writeString(data, sampler.name);
+        writeUint(data, sampler.set);
+        writeUint(data, sampler.binding);
+        writeUint(data, sampler.textureBinding);
+        writeUint(data, sampler.samplerBinding);
+    }
+    writeString(data, msl);
+
+    auto *fileUtils = FileUtils::getInstance();
+    const String directory = fileUtils->getWritablePath() + "mtl_shader_cache/";
+    if (!fileUtils->isDirectoryExist(directory)) fileUtils->createDirectory(directory);
+    // shaders may be compiled from several threads, a partial file is never seen under the final name
+    const String tmpPath = path + ".tmp";
+    if (!fileUtils->writeStringToFile(data, tmpPath) || !fileUtils->renameFile(tmpPath, path)) {
+        CC_LOG_WARNING("Failed to write the Metal shader cache.");
+    }
+}
+
+void mergeReflection(CCMTLGPUShader *gpuShader, const ShaderReflection &reflection, ShaderStageFlagBit shaderType) {
+    for (const auto &block : reflection.blocks) {
+        auto iter = gpuShader->blocks.find(block.mappedBinding);
+        if (iter == gpuShader->blocks.end()) {
+            gpuShader->blocks[block.mappedBinding] = {block.name, block.set, block.binding, block.mappedBinding, shaderType, block.size};
+        } else {
+            iter->second.stages |= shaderType;
+        }
+    }
+    for (const auto &sampler : reflection.samplers) {
+        auto iter = gpuShader->samplers.find(sampler.textureBinding);
+        if (iter == gpuShader->samplers.end()) {
+            gpuShader->samplers[sampler.textureBinding] = {sampler.name, sampler.set, sampler.binding, sampler.textureBinding, sampler.samplerBinding, shaderType};
+        } else {
+            iter->second.stages |= shaderType;
+        }
+    }
+}
+} // namespace
+
 namespace mu {
 MTLResourceOptions toMTLResourseOption(MemoryUsage usage) {
     if (usage & MemoryUsage::HOST && usage & MemoryUsage::DEVICE)
@@ -589,9 +755,22 @@ String compileGLSLShader2Msl(const String &src,
                              Device *device,
                              CCMTLGPUShader *gpuShader) {
 #if CC_USE_METAL
+    const uint64_t hash = hashShaderSource(src, shaderType, device);
+    const uint sourceSize = static_cast<uint>(src.size());
+    const String cachePath = getShaderCachePath(hash);
+    ShaderReflection reflection;
+    String output;
+    if (loadShaderCache(cachePath, hash, sourceSize, reflection, output)) {
+        mergeReflection(gpuShader, reflection, shaderType);
+        return output;
+    }
+
     String shaderSource("#version 310 es\n");
     shaderSource.append(src);
-    const auto &spv = GLSL2SPIRV(shaderType, shaderSource);
+    vector<unsigned int> spv;
+    if (!device->loadPrecompiledShader(shaderType, src, "mtl", spv)) {
+        spv = GLSL2SPIRV(shaderType, shaderSource);
+    }
     if (spv.size() == 0)
         return "";
 
@@ -624,11 +803,7 @@ String compileGLSLShader2Msl(const String &src,
         newBinding.msl_sampler = 0;
         msl.add_msl_resource_binding(newBinding);
 
-        if (gpuShader->blocks.find(mappedBinding) == gpuShader->blocks.end())
-            gpuShader->blocks[mappedBinding] = {ubo.name, set, binding, mappedBinding, shaderType, size};
-        else {
-            gpuShader->blocks[mappedBinding].stages |= shaderType;
-        }
+        reflection.blocks.push_back({ubo.name, set, binding, mappedBinding, shaderType, size});
     }
 
     //TODO: coulsonwang, need to set sampler binding explicitly
@@ -652,14 +827,11 @@ String compileGLSLShader2Msl(const String &src,
         newBinding.msl_sampler = samplerIndex;
         msl.add_msl_resource_binding(newBinding);
 
-        if (gpuShader->samplers.find(mappedBinding) == gpuShader->samplers.end()) {
-            gpuShader->samplers[mappedBinding] = {sampler.name, set, binding, mappedBinding, samplerIndex, shaderType};
-        } else {
-            gpuShader->samplers[mappedBinding].stages |= shaderType;
-        }
+        reflection.samplers.push_back({sampler.name, set, binding, mappedBinding, samplerIndex, shaderType});
 
         samplerIndex++;
     }
+    mergeReflection(gpuShader, reflection, shaderType);
 
     // Set some options.
     spirv_cross::CompilerMSL::Options options;
@@ -671,11 +843,13 @@ String compileGLSLShader2Msl(const String &src,
     msl.set_msl_options(options);
 
     // Compile to MSL, ready to give to metal driver.
-    String output = msl.compile();
+    output = msl.compile();
     if (!output.size()) {
         CC_LOG_ERROR("Compile to MSL failed.");
         CC_LOG_ERROR("%s", shaderSource.c_str());
+        return output;
     }
+    saveShaderCache(cachePath, hash, sourceSize, reflection, output);
     return output;
 
 #else
@@ -1,4 +1,5 @@
 #include "VKStd.h"
+#include "base/FrameStats.h"
 
 #include "VKBuffer.h"
 #include "VKCommandBuffer.h"
@@ -45,6 +46,9 @@ bool CCVKBuffer::initialize(const BufferInfo &info) {
 
     CCVKCmdFuncCreateBuffer((CCVKDevice *)_device, _gpuBuffer);
     _device->getMemoryStatus().bufferSize += _size;
+    if (_memUsage == MemoryUsage::DEVICE) {
+        ((CCVKDevice *)_device)->trackBuffer(_gpuBuffer);
+    }
 
     _gpuBufferView = CC_NEW(CCVKGPUBufferView);
     createBufferView();
@@ -87,6 +91,7 @@ void CCVKBuffer::destroy() {
 
     if (_gpuBuffer) {
         if (!_isBufferView) {
+            ((CCVKDevice *)_device)->untrackBuffer(_gpuBuffer);
             ((CCVKDevice *)_device)->gpuRecycleBin()->collect(_gpuBuffer);
             _device->getMemoryStatus().bufferSize -= _size;
             CC_DELETE(_gpuBuffer);
@@ -142,6 +147,7 @@ void CCVKBuffer::resize(uint size) {
 
 void CCVKBuffer::update(void *buffer, uint offset, uint size) {
     CCASSERT(!_isBufferView, "Cannot update through buffer views");
+    CC_FRAME_STAT_ADD(BUFFER_UPLOAD_BYTES, size);
 
 #if CC_DEBUG > 0
     if (_usage & BufferUsageBit::INDIRECT) {
@@ -170,7 +176,7 @@ void CCVKBuffer::update(void *buffer, uint offset, uint size) {
     // getting rid of this interface all together might become a better option.
     CommandBuffer *cmdBuff = _device->getCommandBuffer();
     cmdBuff->begin();
-    const CCVKGPUCommandBuffer *gpuCommandBuffer = ((CCVKCommandBuffer *)cmdBuff)->gpuCommandBuffer();
+    CCVKGPUCommandBuffer *gpuCommandBuffer = ((CCVKCommandBuffer *)cmdBuff)->gpuCommandBuffer();
     CCVKCmdFuncUpdateBuffer((CCVKDevice *)_device, _gpuBuffer, buffer, offset, size, gpuCommandBuffer);
     /* */
 }
@@ -1,4 +1,5 @@
 #include "VKStd.h"
+#include "base/FrameStats.h"
 
 #include "VKBuffer.h"
 #include "VKCommandBuffer.h"
@@ -9,6 +10,7 @@
 #include "VKFramebuffer.h"
 #include "VKInputAssembler.h"
 #include "VKPipelineState.h"
+#include "VKQueryPool.h"
 #include "VKQueue.h"
 #include "VKRenderPass.h"
 #include "VKTexture.h"
@@ -30,7 +32,25 @@ bool CCVKCommandBuffer::initialize(const CommandBufferInfo &info) {
     _gpuCommandBuffer = CC_NEW(CCVKGPUCommandBuffer);
     _gpuCommandBuffer->level = MapVkCommandBufferLevel(_type);
     _gpuCommandBuffer->queueFamilyIndex = ((CCVKQueue *)_queue)->gpuQueue()->queueFamilyIndex;
-    ((CCVKDevice *)_device)->gpuCommandBufferPool()->request(_gpuCommandBuffer);
+    if (_type == CommandBufferType::SECONDARY) {
+        // Vulkan command pools are externally synchronized, a dedicated pool
+        // lets secondaries be recorded on worker threads in parallel
+        CCVKGPUDevice *gpuDevice = ((CCVKDevice *)_device)->gpuDevice();
+        VkCommandPoolCreateInfo createInfo{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+        createInfo.queueFamilyIndex = _gpuCommandBuffer->queueFamilyIndex;
+        createInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        VK_CHECK(vkCreateCommandPool(gpuDevice->vkDevice, &createInfo, nullptr, &_gpuCommandBuffer->vkCommandPool));
+
+        // one per frame in flight, the recording of the frame before may still be executing
+        _gpuCommandBuffer->frameCommandBuffers.resize(CCVKDevice::MAX_FRAMES_IN_FLIGHT);
+        VkCommandBufferAllocateInfo allocateInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+        allocateInfo.commandPool = _gpuCommandBuffer->vkCommandPool;
+        allocateInfo.commandBufferCount = CCVKDevice::MAX_FRAMES_IN_FLIGHT;
+        allocateInfo.level = _gpuCommandBuffer->level;
+        VK_CHECK(vkAllocateCommandBuffers(gpuDevice->vkDevice, &allocateInfo, _gpuCommandBuffer->frameCommandBuffers.data()));
+        _gpuCommandBuffer->vkCommandBuffer = _gpuCommandBuffer->frameCommandBuffers[0];
+    }
+    // primary command buffers are requested from the pool of the frame they begin in
 
     uint setCount = ((CCVKDevice *)_device)->bindingMappingInfo().bufferOffsets.size();
     _curGPUDescriptorSets.resize(setCount);
@@ -41,7 +61,15 @@ bool CCVKCommandBuffer::initialize(const CommandBufferInfo &info) {
 
 void CCVKCommandBuffer::destroy() {
     if (_gpuCommandBuffer) {
-        ((CCVKDevice *)_device)->gpuCommandBufferPool()->yield(_gpuCommandBuffer);
+        if (_gpuCommandBuffer->vkCommandPool != VK_NULL_HANDLE) {
+            // destroying the pool frees its command buffers as well
+            vkDestroyCommandPool(((CCVKDevice *)_device)->gpuDevice()->vkDevice, _gpuCommandBuffer->vkCommandPool, nullptr);
+            _gpuCommandBuffer->vkCommandPool = VK_NULL_HANDLE;
+            _gpuCommandBuffer->vkCommandBuffer = VK_NULL_HANDLE;
+            _gpuCommandBuffer->frameCommandBuffers.clear();
+        } else {
+            ((CCVKDevice *)_device)->gpuCommandBufferPool()->yield(_gpuCommandBuffer);
+        }
         CC_DELETE(_gpuCommandBuffer);
         _gpuCommandBuffer = nullptr;
     }
@@ -65,16 +93,35 @@ void CCVKCommandBuffer::begin(RenderPass *renderPass, uint subpass, Framebuffer
     VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
     beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
+    VkCommandBufferInheritanceInfo inheritanceInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
     if (_type == CommandBufferType::SECONDARY) {
         if (!renderPass) {
             CC_LOG_ERROR("RenderPass has to be specified when beginning secondary command buffers.");
             return;
         }
-        VkCommandBufferInheritanceInfo inheritanceInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
         inheritanceInfo.renderPass = ((CCVKRenderPass *)renderPass)->gpuRenderPass()->vkRenderPass;
         inheritanceInfo.subpass = subpass;
-        if (frameBuffer) inheritanceInfo.framebuffer = ((CCVKFramebuffer *)frameBuffer)->gpuFBO()->vkFramebuffer;
+        if (frameBuffer) {
+            CCVKGPUFramebuffer *gpuFBO = ((CCVKFramebuffer *)frameBuffer)->gpuFBO();
+            inheritanceInfo.framebuffer = gpuFBO->isOffscreen ? gpuFBO->vkFramebuffer : gpuFBO->swapchain->vkSwapchainFramebufferListMap[gpuFBO][gpuFBO->swapchain->curImageIndex];
+        }
+        beginInfo.flags |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
         beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+        // dynamic states are not inherited from the primary command buffer
+        _curViewport = Viewport();
+        _curScissor = Rect();
+        _curLineWidth = 1.0f;
+        _curDepthBias = CCVKDepthBias();
+        _curBlendConstants = Color();
+        _curDepthBounds = CCVKDepthBounds();
+        _curStencilWriteMask = CCVKStencilWriteMask();
+        _curStencilCompareMask = CCVKStencilCompareMask();
+
+        // beginning resets the command buffer, the one of this frame slot is done on the GPU by now
+        _gpuCommandBuffer->vkCommandBuffer = _gpuCommandBuffer->frameCommandBuffers[((CCVKDevice *)_device)->frameIndex()];
+    } else if (!_gpuCommandBuffer->vkCommandBuffer) {
+        ((CCVKDevice *)_device)->gpuCommandBufferPool()->request(_gpuCommandBuffer);
     }
     VK_CHECK(vkBeginCommandBuffer(_gpuCommandBuffer->vkCommandBuffer, &beginInfo));
 
@@ -85,12 +132,16 @@ void CCVKCommandBuffer::end() {
     if (!_gpuCommandBuffer->began) return;
 
     _curGPUFBO = nullptr;
+    CCVKCmdFuncFlushBufferCopies(_gpuCommandBuffer);
     VK_CHECK(vkEndCommandBuffer(_gpuCommandBuffer->vkCommandBuffer));
     _gpuCommandBuffer->began = false;
 }
 
 void CCVKCommandBuffer::beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea,
-                                        const Color *colors, float depth, int stencil) {
+                                        const Color *colors, float depth, int stencil, const CommandBuffer *const *secondaryCmdBuffs, uint secondaryCmdBuffCount) {
+    // the draws of the render pass see every update recorded before
+    CCVKCmdFuncFlushBufferCopies(_gpuCommandBuffer);
+
     _curGPUFBO = ((CCVKFramebuffer *)fbo)->gpuFBO();
     CCVKGPURenderPass *gpuRenderPass = ((CCVKRenderPass *)renderPass)->gpuRenderPass();
     VkFramebuffer framebuffer = _curGPUFBO->vkFramebuffer;
@@ -135,6 +186,11 @@ void CCVKCommandBuffer::beginRenderPass(RenderPass *renderPass, Framebuffer *fbo
     passBeginInfo.clearValueCount = clearValues.size();
     passBeginInfo.pClearValues = clearValues.data();
     passBeginInfo.renderArea = {{(int)renderArea.x, (int)renderArea.y}, {renderArea.width, renderArea.height}};
+    if (secondaryCmdBuffCount) {
+        // no inline commands are allowed in this subpass, viewport and scissor are set by the secondaries
+        vkCmdBeginRenderPass(_gpuCommandBuffer->vkCommandBuffer, &passBeginInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+        return;
+    }
     vkCmdBeginRenderPass(_gpuCommandBuffer->vkCommandBuffer, &passBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
 
     VkViewport viewport{(float)renderArea.x, (float)renderArea.y, (float)renderArea.width, (float)renderArea.height, 0.f, 1.f};
@@ -151,7 +207,12 @@ void CCVKCommandBuffer::endRenderPass() {
     _curGPUFBO = nullptr;
 }
 
+void CCVKCommandBuffer::nextSubpass() {
+    vkCmdNextSubpass(_gpuCommandBuffer->vkCommandBuffer, VK_SUBPASS_CONTENTS_INLINE);
+}
+
 void CCVKCommandBuffer::bindPipelineState(PipelineState *pso) {
+    CC_FRAME_STAT_ADD(PIPELINE_STATE_BINDS, 1);
     CCVKGPUPipelineState *gpuPipelineState = ((CCVKPipelineState *)pso)->gpuPipelineState();
 
     if (_curGPUPipelineState != gpuPipelineState) {
@@ -161,6 +222,7 @@ void CCVKCommandBuffer::bindPipelineState(PipelineState *pso) {
 }
 
 void CCVKCommandBuffer::bindDescriptorSet(uint set, DescriptorSet *descriptorSet, uint dynamicOffsetCount, const uint *dynamicOffsets) {
+    CC_FRAME_STAT_ADD(DESCRIPTOR_SET_BINDS, 1);
     CCASSERT(_curGPUDescriptorSets.size() > set, "Invalid set index");
 
     CCVKGPUDescriptorSet *gpuDescriptorSet = ((CCVKDescriptorSet *)descriptorSet)->gpuDescriptorSet();
@@ -342,6 +404,7 @@ void CCVKCommandBuffer::draw(InputAssembler *ia) {
         }
 
         ++_numDrawCalls;
+        CC_FRAME_STAT_ADD(DRAW_CALLS, 1);
         _numInstances += drawInfo.instanceCount;
         if (_curGPUPipelineState) {
             uint indexCount = hasIndexBuffer ? drawInfo.indexCount : drawInfo.vertexCount;
@@ -359,6 +422,30 @@ void CCVKCommandBuffer::draw(InputAssembler *ia) {
     }
 }
 
+void CCVKCommandBuffer::drawIndirect(InputAssembler *ia, Buffer *indirectBuffer, uint drawOffset, uint drawCount) {
+    if (!drawCount) return;
+    if (_firstDirtyDescriptorSet < _curGPUDescriptorSets.size()) {
+        bindDescriptorSets();
+    }
+
+    const CCVKGPUBuffer *gpuIndirectBuffer = ((CCVKBuffer *)indirectBuffer)->gpuBuffer();
+    const bool useMultiDraw = static_cast<CCVKDevice *>(_device)->gpuDevice()->useMultiDrawIndirect;
+    const uint stride = gpuIndirectBuffer->isDrawIndirectByIndex ? sizeof(VkDrawIndexedIndirectCommand) : sizeof(VkDrawIndirectCommand);
+    // without multi draw every command needs its own call
+    const uint callCount = useMultiDraw ? 1 : drawCount;
+    const uint countPerCall = useMultiDraw ? drawCount : 1;
+    for (uint i = 0u; i < callCount; ++i) {
+        const VkDeviceSize offset = gpuIndirectBuffer->startOffset + (drawOffset + i) * stride;
+        if (gpuIndirectBuffer->isDrawIndirectByIndex) {
+            vkCmdDrawIndexedIndirect(_gpuCommandBuffer->vkCommandBuffer, gpuIndirectBuffer->vkBuffer, offset, countPerCall, stride);
+        } else {
+            vkCmdDrawIndirect(_gpuCommandBuffer->vkCommandBuffer, gpuIndirectBuffer->vkBuffer, offset, countPerCall, stride);
+        }
+    }
+    _numDrawCalls += callCount;
+    CC_FRAME_STAT_ADD(DRAW_CALLS, callCount);
+}
+
 void CCVKCommandBuffer::execute(const CommandBuffer *const *cmdBuffs, uint count) {
     if (!count) return;
 
@@ -376,7 +463,28 @@ void CCVKCommandBuffer::execute(const CommandBuffer *const *cmdBuffs, uint count
     vkCmdExecuteCommands(_gpuCommandBuffer->vkCommandBuffer, count, vkCmdBuffs.data());
 }
 
+void CCVKCommandBuffer::resetQueryPool(QueryPool *queryPool) {
+    CCVKGPUQueryPool *gpuQueryPool = ((CCVKQueryPool *)queryPool)->gpuQueryPool();
+    vkCmdResetQueryPool(_gpuCommandBuffer->vkCommandBuffer, gpuQueryPool->vkPool, 0, gpuQueryPool->maxQueryObjects);
+}
+
+void CCVKCommandBuffer::writeTimestamp(QueryPool *queryPool, uint query) {
+    CCVKGPUQueryPool *gpuQueryPool = ((CCVKQueryPool *)queryPool)->gpuQueryPool();
+    vkCmdWriteTimestamp(_gpuCommandBuffer->vkCommandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, gpuQueryPool->vkPool, query);
+}
+
+void CCVKCommandBuffer::beginQuery(QueryPool *queryPool, uint query) {
+    CCVKGPUQueryPool *gpuQueryPool = ((CCVKQueryPool *)queryPool)->gpuQueryPool();
+    vkCmdBeginQuery(_gpuCommandBuffer->vkCommandBuffer, gpuQueryPool->vkPool, query, 0);
+}
+
+void CCVKCommandBuffer::endQuery(QueryPool *queryPool, uint query) {
+    CCVKGPUQueryPool *gpuQueryPool = ((CCVKQueryPool *)queryPool)->gpuQueryPool();
+    vkCmdEndQuery(_gpuCommandBuffer->vkCommandBuffer, gpuQueryPool->vkPool, query);
+}
+
 void CCVKCommandBuffer::updateBuffer(Buffer *buffer, const void *data, uint size, uint offset) {
+    CC_FRAME_STAT_ADD(BUFFER_UPLOAD_BYTES, size);
     CCVKCmdFuncUpdateBuffer((CCVKDevice *)_device, ((CCVKBuffer *)buffer)->gpuBuffer(), data, offset, size, _gpuCommandBuffer);
 }
 
@@ -384,9 +492,19 @@ void CCVKCommandBuffer::copyBuffersToTexture(const uint8_t *const *buffers, Text
     CCVKCmdFuncCopyBuffersToTexture((CCVKDevice *)_device, buffers, ((CCVKTexture *)texture)->gpuTexture(), regions, count, _gpuCommandBuffer);
 }
 
+void CCVKCommandBuffer::copyTexture(Texture *srcTexture, Texture *dstTexture, const TextureCopy *regions, uint count) {
+    CCVKCmdFuncCopyTexture((CCVKDevice *)_device, ((CCVKTexture *)srcTexture)->gpuTexture(), ((CCVKTexture *)dstTexture)->gpuTexture(),
+                           regions, count, _gpuCommandBuffer);
+}
+
 void CCVKCommandBuffer::bindDescriptorSets() {
 
     CCVKDevice *device = (CCVKDevice *)_device;
+    // pipeline layouts and descriptor update entries are shared scratch space,
+    // serialize secondaries that may be recording on several threads at once
+    std::unique_lock<std::mutex> lock(device->gpuDescriptorSetPool()->mutex(), std::defer_lock);
+    if (_type == CommandBufferType::SECONDARY) lock.lock();
+
     CCVKGPUDevice *gpuDevice = device->gpuDevice();
     VkCommandBuffer cmdBuff = _gpuCommandBuffer->vkCommandBuffer;
     CCVKGPUPipelineLayout *pipelineLayout = _curGPUPipelineState->gpuPipelineLayout;
@@ -397,28 +515,66 @@ void CCVKCommandBuffer::bindDescriptorSets() {
 
     const vector<VkDescriptorSetLayout> &layouts = _curGPUPipelineState->gpuPipelineLayout->descriptorSetLayouts;
     vector<VkDescriptorSet> &sets = _curGPUPipelineState->gpuPipelineLayout->descriptorSets;
-    device->gpuDescriptorSetPool()->alloc(layouts.data() + _firstDirtyDescriptorSet,
-                                          sets.data() + _firstDirtyDescriptorSet,
-                                          dirtyDescriptorSetCount);
+    CCVKGPUDescriptorSetPool *descriptorSetPool = device->gpuDescriptorSetPool();
+    const uint poolGeneration = descriptorSetPool->generation();
 
-    for (uint i = 0u, offsetAcc = 0u; i < dirtyDescriptorSetCount; i++) {
+    // sets whose descriptors didn't change since they were last written in this frame are bound as is
+    _allocLayouts.clear();
+    _allocSetIndices.clear();
+    for (uint i = 0u; i < dirtyDescriptorSetCount; i++) {
         uint set = _firstDirtyDescriptorSet + i;
         CCVKGPUDescriptorSet *gpuDescriptorSet = _curGPUDescriptorSets[set];
+        if (gpuDescriptorSet && gpuDescriptorSet->vkDescriptorSet &&
+            gpuDescriptorSet->allocatedPool == descriptorSetPool &&
+            gpuDescriptorSet->allocatedGeneration == poolGeneration &&
+            gpuDescriptorSet->vkDescriptorSetLayout == layouts[set] &&
+            !memcmp(gpuDescriptorSet->writtenInfos.data(), gpuDescriptorSet->descriptorInfos.data(),
+                    gpuDescriptorSet->descriptorInfos.size() * sizeof(CCVKDescriptorInfo))) {
+            sets[set] = gpuDescriptorSet->vkDescriptorSet;
+            continue;
+        }
+        _allocLayouts.push_back(layouts[set]);
+        _allocSetIndices.push_back(set);
+    }
+
+    uint allocCount = _allocSetIndices.size();
+    if (allocCount) {
+        _allocSets.resize(allocCount);
+        descriptorSetPool->alloc(_allocLayouts.data(), _allocSets.data(), allocCount);
+    }
+
+    _descriptorWrites.clear();
+    for (uint i = 0u; i < allocCount; i++) {
+        uint set = _allocSetIndices[i];
+        sets[set] = _allocSets[i];
+        CCVKGPUDescriptorSet *gpuDescriptorSet = _curGPUDescriptorSets[set];
         if (!gpuDescriptorSet || !gpuDescriptorSet->gpuDescriptors.size()) continue;
 
         if (gpuDevice->useDescriptorUpdateTemplate) {
-            const vector<CCVKDescriptorInfo> &descriptorInfos = gpuDescriptorSet->descriptorInfos;
-            const vector<VkDescriptorUpdateTemplate> &templates = pipelineLayout->vkDescriptorUpdateTemplates;
-            vkUpdateDescriptorSetWithTemplateKHR(device->gpuDevice()->vkDevice, sets[set], templates[set], descriptorInfos.data());
+            VkDescriptorUpdateTemplate updateTemplate = pipelineLayout->setLayouts[set]->vkDescriptorUpdateTemplate;
+            vkUpdateDescriptorSetWithTemplateKHR(gpuDevice->vkDevice, sets[set], updateTemplate, gpuDescriptorSet->descriptorInfos.data());
         } else {
-            vector<VkWriteDescriptorSet> &entries = gpuDescriptorSet->descriptorUpdateEntries;
-
-            for (uint j = 0u; j < entries.size(); j++) {
-                entries[j].dstSet = sets[set];
+            for (VkWriteDescriptorSet entry : gpuDescriptorSet->descriptorUpdateEntries) {
+                entry.dstSet = sets[set];
+                _descriptorWrites.push_back(entry);
             }
-            vkUpdateDescriptorSets(device->gpuDevice()->vkDevice, entries.size(), entries.data(), 0, nullptr);
         }
 
+        gpuDescriptorSet->vkDescriptorSet = sets[set];
+        gpuDescriptorSet->vkDescriptorSetLayout = layouts[set];
+        gpuDescriptorSet->allocatedPool = descriptorSetPool;
+        gpuDescriptorSet->allocatedGeneration = poolGeneration;
+        gpuDescriptorSet->writtenInfos = gpuDescriptorSet->descriptorInfos;
+    }
+    if (!_descriptorWrites.empty()) {
+        vkUpdateDescriptorSets(gpuDevice->vkDevice, _descriptorWrites.size(), _descriptorWrites.data(), 0, nullptr);
+    }
+
+    for (uint i = 0u, offsetAcc = 0u; i < dirtyDescriptorSetCount; i++) {
+        uint set = _firstDirtyDescriptorSet + i;
+        CCVKGPUDescriptorSet *gpuDescriptorSet = _curGPUDescriptorSets[set];
+        if (!gpuDescriptorSet || !gpuDescriptorSet->gpuDescriptors.size()) continue;
+
         uint offsetCount = pipelineLayout->dynamicOffsetOffsets[set + 1] - dynamicOffsetStartIndex;
         if (_curDynamicOffsets[set].size() && offsetCount > 0) {
             memcpy(dynamicOffsets + offsetAcc, _curDynamicOffsets[set].data(), offsetCount * sizeof(uint));
@@ -19,8 +19,9 @@ public:
 
     virtual void begin(RenderPass *renderPass, uint subpass, Framebuffer *frameBuffer) override;
     virtual void end() override;
-    virtual void beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea, const Color *colors, float depth, int stencil) override;
+    virtual void beginRenderPass(RenderPass *renderPass, Framebuffer *fbo, const Rect &renderArea, const Color *colors, float depth, int stencil, const CommandBuffer *const *secondaryCmdBuffs, uint secondaryCmdBuffCount) override;
     virtual void endRenderPass() override;
+    virtual void nextSubpass() override;
     virtual void bindPipelineState(PipelineState *pso) override;
     virtual void bindDescriptorSet(uint set, DescriptorSet *descriptorSet, uint dynamicOffsetCount, const uint *dynamicOffsets) override;
     virtual void bindInputAssembler(InputAssembler *ia) override;
@@ -33,9 +34,15 @@ public:
     virtual void setStencilWriteMask(StencilFace face, uint mask) override;
     virtual void setStencilCompareMask(StencilFace face, int reference, uint mask) override;
     virtual void draw(InputAssembler *ia) override;
+    virtual void drawIndirect(InputAssembler *ia, Buffer *indirectBuffer, uint drawOffset, uint drawCount) override;
     virtual void updateBuffer(Buffer *buffer, const void *data, uint size, uint offset) override;
     virtual void copyBuffersToTexture(const uint8_t *const *buffers, Texture *texture, const BufferTextureCopy *regions, uint count) override;
+    virtual void copyTexture(Texture *srcTexture, Texture *dstTexture, const TextureCopy *regions, uint count) override;
     virtual void execute(const CommandBuffer *const *cmdBuffs, uint count) override;
+    virtual void resetQueryPool(QueryPool *queryPool) override;
+    virtual void writeTimestamp(QueryPool *queryPool, uint query) override;
+    virtual void beginQuery(QueryPool *queryPool, uint query) override;
+    virtual void endQuery(QueryPool *queryPool, uint query) override;
 
     CCVKGPUCommandBuffer *gpuCommandBuffer() const { return _gpuCommandBuffer; }
 
@@ -49,6 +56,12 @@ private:
     vector<vector<uint>> _curDynamicOffsets;
     uint _firstDirtyDescriptorSet = UINT_MAX;
 
+    // scratch storage for allocating and writing the dirty descriptor sets in one batch
+    vector<VkDescriptorSetLayout> _allocLayouts;
+    vector<VkDescriptorSet> _allocSets;
+    vector<uint> _allocSetIndices;
+    vector<VkWriteDescriptorSet> _descriptorWrites;
+
     CCVKGPUInputAssembler *_curGPUInputAssember = nullptr;
     CCVKGPUFramebuffer *_curGPUFBO = nullptr;
 
@@ -36,6 +36,49 @@ void insertVkDynamicStates(vector<VkDynamicState> &out, const vector<DynamicStat
     }
 }
 
+namespace {
+// the highest count up to the requested one the device supports for both color and depth stencil attachments
+uint getSupportedSampleCount(CCVKDevice *device, uint sampleCount) {
+    const VkPhysicalDeviceLimits &limits = device->gpuContext()->physicalDeviceProperties.limits;
+    const VkSampleCountFlags supported = limits.framebufferColorSampleCounts & limits.framebufferDepthSampleCounts;
+    uint count = 1u;
+    while (count * 2u <= sampleCount && (supported & (count * 2u))) count *= 2u;
+    return count;
+}
+
+CCVKGPUTextureView *createMultisampleAttachment(CCVKDevice *device, Format format, uint width, uint height, uint sampleCount) {
+    const bool isDepthStencil = GFX_FORMAT_INFOS[(uint)format].hasDepth;
+    CCVKGPUTexture *gpuTexture = CC_NEW(CCVKGPUTexture);
+    gpuTexture->format = format;
+    gpuTexture->usage = TextureUsageBit::TRANSIENT_ATTACHMENT |
+                        (isDepthStencil ? TextureUsageBit::DEPTH_STENCIL_ATTACHMENT : TextureUsageBit::COLOR_ATTACHMENT);
+    gpuTexture->width = width;
+    gpuTexture->height = height;
+    gpuTexture->size = FormatSize(format, width, height, 1u);
+    uint samples = 0u;
+    while ((2u << samples) <= sampleCount) ++samples;
+    gpuTexture->samples = static_cast<SampleCount>(samples);
+    CCVKCmdFuncCreateTexture(device, gpuTexture);
+
+    CCVKGPUTextureView *gpuTextureView = CC_NEW(CCVKGPUTextureView);
+    gpuTextureView->gpuTexture = gpuTexture;
+    gpuTextureView->format = format;
+    CCVKCmdFuncCreateTextureView(device, gpuTextureView);
+    return gpuTextureView;
+}
+
+void destroyMultisampleAttachments(CCVKGPUDevice *gpuDevice, CCVKGPUFramebuffer *gpuFramebuffer) {
+    for (CCVKGPUTextureView *gpuTextureView : gpuFramebuffer->gpuMultisampleViews) {
+        if (gpuTextureView->vkImageView) vkDestroyImageView(gpuDevice->vkDevice, gpuTextureView->vkImageView, nullptr);
+        CCVKGPUTexture *gpuTexture = gpuTextureView->gpuTexture;
+        if (gpuTexture->vkImage) vmaDestroyImage(gpuDevice->memoryAllocator, gpuTexture->vkImage, gpuTexture->vmaAllocation);
+        CC_DELETE(gpuTexture);
+        CC_DELETE(gpuTextureView);
+    }
+    gpuFramebuffer->gpuMultisampleViews.clear();
+}
+} // namespace
+
 void CCVKCmdFuncGetDeviceQueue(CCVKDevice *device, CCVKGPUQueue *gpuQueue) {
     uint queueType = 0u;
     VkBool32 needPresentable = VK_FALSE;
@@ -51,11 +94,32 @@ void CCVKCmdFuncGetDeviceQueue(CCVKDevice *device, CCVKGPUQueue *gpuQueue) {
     const CCVKGPUContext *context = ((CCVKContext *)device->getContext())->gpuContext();
 
     size_t queueCount = context->queueFamilyProperties.size();
+    uint queueIndex = 0u;
+    if (gpuQueue->type == QueueType::TRANSFER) {
+        // families with neither graphics nor compute map to the copy engines,
+        // which need to copy single texels to upload the tails of mip chains
+        for (size_t i = 0u; i < queueCount; ++i) {
+            const VkQueueFamilyProperties &properties = context->queueFamilyProperties[i];
+            const VkExtent3D &granularity = properties.minImageTransferGranularity;
+            if (properties.queueCount > 0 && (properties.queueFlags & VK_QUEUE_TRANSFER_BIT) &&
+                !(properties.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) &&
+                granularity.width == 1u && granularity.height == 1u && granularity.depth == 1u) {
+                vkGetDeviceQueue(device->gpuDevice()->vkDevice, i, 0, &gpuQueue->vkQueue);
+                gpuQueue->queueFamilyIndex = i;
+                return;
+            }
+        }
+        // otherwise another queue of the graphics family, the graphics queue itself as a last resort
+        queueType = VK_QUEUE_GRAPHICS_BIT;
+        needPresentable = VK_TRUE;
+        queueIndex = 1u;
+    }
+
     for (size_t i = 0u; i < queueCount; ++i) {
         const VkQueueFamilyProperties &properties = context->queueFamilyProperties[i];
         const VkBool32 isPresentable = context->queueFamilyPresentables[i];
         if (properties.queueCount > 0 && (properties.queueFlags & queueType) && (!needPresentable || isPresentable)) {
-            vkGetDeviceQueue(device->gpuDevice()->vkDevice, i, 0, &gpuQueue->vkQueue);
+            vkGetDeviceQueue(device->gpuDevice()->vkDevice, i, std::min(queueIndex, properties.queueCount - 1), &gpuQueue->vkQueue);
             gpuQueue->queueFamilyIndex = i;
             break;
         }
@@ -76,7 +140,12 @@ void CCVKCmdFuncCreateTexture(CCVKDevice *device, CCVKGPUTexture *gpuTexture) {
     }
 
     VkImageUsageFlags usageFlags = MapVkImageUsageFlagBits(gpuTexture->usage);
-    if (gpuTexture->flags & TextureFlags::GEN_MIPMAP) {
+    bool isTransient = gpuTexture->usage & TextureUsage::TRANSIENT_ATTACHMENT;
+    if (isTransient) {
+        // transient images may only be used as attachments, their contents never leave the tile memory
+        usageFlags &= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                      VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+    } else if (gpuTexture->flags & TextureFlags::GEN_MIPMAP) {
         usageFlags |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
     }
 
@@ -96,7 +165,30 @@ void CCVKCmdFuncCreateTexture(CCVKDevice *device, CCVKGPUTexture *gpuTexture) {
     allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
 
     VmaAllocationInfo res;
-    VK_CHECK(vmaCreateImage(device->gpuDevice()->memoryAllocator, &createInfo, &allocInfo, &gpuTexture->vkImage, &gpuTexture->vmaAllocation, &res));
+    if (isTransient) {
+        allocInfo.usage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+        VkResult result = vmaCreateImage(device->gpuDevice()->memoryAllocator, &createInfo, &allocInfo, &gpuTexture->vkImage, &gpuTexture->vmaAllocation, &res);
+        if (result == VK_SUCCESS) {
+            gpuTexture->memoryless = true;
+        } else {
+            // desktop GPUs usually don't expose lazily allocated memory
+            allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+            VK_CHECK(vmaCreateImage(device->gpuDevice()->memoryAllocator, &createInfo, &allocInfo, &gpuTexture->vkImage, &gpuTexture->vmaAllocation, &res));
+        }
+    } else {
+        // rather drop the generated mip chain than go over the memory budget of the heap
+        allocInfo.flags = VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT;
+        VkResult result = vmaCreateImage(device->gpuDevice()->memoryAllocator, &createInfo, &allocInfo, &gpuTexture->vkImage, &gpuTexture->vmaAllocation, &res);
+        if (result != VK_SUCCESS && createInfo.mipLevels > 1 && (gpuTexture->flags & TextureFlags::GEN_MIPMAP)) {
+            createInfo.mipLevels = gpuTexture->mipLevels = 1u;
+            result = vmaCreateImage(device->gpuDevice()->memoryAllocator, &createInfo, &allocInfo, &gpuTexture->vkImage, &gpuTexture->vmaAllocation, &res);
+        }
+        if (result != VK_SUCCESS) {
+            CC_LOG_WARNING("CCVKCmdFuncCreateTexture: %ux%u texture exceeds the memory budget", gpuTexture->width, gpuTexture->height);
+            allocInfo.flags = 0u;
+            VK_CHECK(vmaCreateImage(device->gpuDevice()->memoryAllocator, &createInfo, &allocInfo, &gpuTexture->vkImage, &gpuTexture->vmaAllocation, &res));
+        }
+    }
     //CC_LOG_DEBUG("Allocated texture: %llu %llx %llx %llu %x", res.size, gpuTexture->vkImage, res.deviceMemory, res.offset, res.pMappedData);
 
     gpuTexture->layout = MapVkImageLayout(gpuTexture->usage, gpuTexture->format);
@@ -115,6 +207,10 @@ void CCVKCmdFuncCreateTextureView(CCVKDevice *device, CCVKGPUTextureView *gpuTex
     createInfo.subresourceRange.aspectMask = GFX_FORMAT_INFOS[(uint)gpuTextureView->format].hasDepth ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
     createInfo.subresourceRange.baseMipLevel = gpuTextureView->baseLevel;
     createInfo.subresourceRange.levelCount = gpuTextureView->levelCount;
+    // the texture may have fewer levels than requested, see CCVKCmdFuncCreateTexture
+    if (gpuTextureView->baseLevel < gpuTextureView->gpuTexture->mipLevels) {
+        createInfo.subresourceRange.levelCount = std::min(gpuTextureView->levelCount, gpuTextureView->gpuTexture->mipLevels - gpuTextureView->baseLevel);
+    }
     createInfo.subresourceRange.baseArrayLayer = gpuTextureView->baseLayer;
     createInfo.subresourceRange.layerCount = gpuTextureView->layerCount;
 
@@ -147,6 +243,16 @@ void CCVKCmdFuncCreateSampler(CCVKDevice *device, CCVKGPUSampler *gpuSampler) {
     device->gpuDescriptorHub()->update(gpuSampler);
 }
 
+VkBufferUsageFlags getBufferUsageFlags(const CCVKGPUBuffer *gpuBuffer) {
+    VkBufferUsageFlags usage = MapVkBufferUsageFlagBits(gpuBuffer->usage);
+    if (gpuBuffer->memUsage == MemoryUsage::HOST) {
+        usage |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    } else if (gpuBuffer->memUsage & MemoryUsage::DEVICE) {
+        usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    }
+    return usage;
+}
+
 void CCVKCmdFuncCreateBuffer(CCVKDevice *device, CCVKGPUBuffer *gpuBuffer) {
     if (!gpuBuffer->size) {
         return;
@@ -154,19 +260,16 @@ void CCVKCmdFuncCreateBuffer(CCVKDevice *device, CCVKGPUBuffer *gpuBuffer) {
 
     VkBufferCreateInfo bufferInfo{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
     bufferInfo.size = gpuBuffer->size;
-    bufferInfo.usage = MapVkBufferUsageFlagBits(gpuBuffer->usage);
+    bufferInfo.usage = getBufferUsageFlags(gpuBuffer);
 
     VmaAllocationCreateInfo allocInfo{};
     allocInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
 
     if (gpuBuffer->memUsage == MemoryUsage::HOST) {
-        bufferInfo.usage |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
         allocInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
     } else if (gpuBuffer->memUsage == MemoryUsage::DEVICE) {
-        bufferInfo.usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
         allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
     } else if (gpuBuffer->memUsage == (MemoryUsage::HOST | MemoryUsage::DEVICE)) {
-        bufferInfo.usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
         allocInfo.usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
     }
 
@@ -181,6 +284,21 @@ void CCVKCmdFuncCreateBuffer(CCVKDevice *device, CCVKGPUBuffer *gpuBuffer) {
     gpuBuffer->targetStage = MapVkPipelineStageFlags(gpuBuffer->usage);
 }
 
+void CCVKCmdFuncRebindBuffer(CCVKDevice *device, CCVKGPUBuffer *gpuBuffer) {
+    VkBufferCreateInfo bufferInfo{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    bufferInfo.size = gpuBuffer->size;
+    bufferInfo.usage = getBufferUsageFlags(gpuBuffer);
+
+    vkDestroyBuffer(device->gpuDevice()->vkDevice, gpuBuffer->vkBuffer, nullptr);
+    VK_CHECK(vkCreateBuffer(device->gpuDevice()->vkDevice, &bufferInfo, nullptr, &gpuBuffer->vkBuffer));
+    VK_CHECK(vmaBindBufferMemory(device->gpuDevice()->memoryAllocator, gpuBuffer->vmaAllocation, gpuBuffer->vkBuffer));
+
+    VmaAllocationInfo res;
+    vmaGetAllocationInfo(device->gpuDevice()->memoryAllocator, gpuBuffer->vmaAllocation, &res);
+    gpuBuffer->mappedData = (uint8_t *)res.pMappedData;
+    device->gpuDescriptorHub()->update(gpuBuffer);
+}
+
 void CCVKCmdFuncCreateRenderPass(CCVKDevice *device, CCVKGPURenderPass *gpuRenderPass) {
     const size_t colorAttachmentCount = gpuRenderPass->colorAttachments.size();
     const size_t hasDepth = gpuRenderPass->depthStencilAttachment.format != Format::UNKNOWN ? 1 : 0;
@@ -213,22 +331,108 @@ void CCVKCmdFuncCreateRenderPass(CCVKDevice *device, CCVKGPURenderPass *gpuRende
         attachmentDescriptions[colorAttachmentCount].samples = MapVkSampleCount(depthStencilAttachment.sampleCount);
         attachmentDescriptions[colorAttachmentCount].loadOp = MapVkLoadOp(depthStencilAttachment.depthLoadOp);
         attachmentDescriptions[colorAttachmentCount].storeOp = MapVkStoreOp(depthStencilAttachment.depthStoreOp);
-        attachmentDescriptions[colorAttachmentCount].stencilLoadOp = MapVkLoadOp(depthStencilAttachment.stencilLoadOp);
-        attachmentDescriptions[colorAttachmentCount].stencilStoreOp = MapVkStoreOp(depthStencilAttachment.stencilStoreOp);
+        // the stencil ops would needlessly keep a depth only attachment around otherwise
+        attachmentDescriptions[colorAttachmentCount].stencilLoadOp = hasStencil ? MapVkLoadOp(depthStencilAttachment.stencilLoadOp) : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        attachmentDescriptions[colorAttachmentCount].stencilStoreOp = hasStencil ? MapVkStoreOp(depthStencilAttachment.stencilStoreOp) : VK_ATTACHMENT_STORE_OP_DONT_CARE;
         attachmentDescriptions[colorAttachmentCount].initialLayout = beginLayout;
         attachmentDescriptions[colorAttachmentCount].finalLayout = endLayout;
     }
 
+    // the multisampled attachments never leave tile memory, the default subpass resolves them into the
+    // framebuffer textures, which follow as single sampled attachments taking over the store ops and layouts
     const size_t subpassCount = gpuRenderPass->subPasses.size();
+    const uint sampleCount = colorAttachmentCount && !subpassCount ? gpuRenderPass->colorAttachments[0].sampleCount : 1u;
+    gpuRenderPass->sampleCount = sampleCount > 1u ? getSupportedSampleCount(device, sampleCount) : 1u;
+    vector<VkAttachmentReference> resolveReferences;
+    if (gpuRenderPass->sampleCount > 1u) {
+        const VkSampleCountFlagBits samples = MapVkSampleCount(gpuRenderPass->sampleCount);
+        const size_t resolveOffset = attachmentDescriptions.size();
+        attachmentDescriptions.resize(resolveOffset + colorAttachmentCount);
+        for (size_t i = 0u; i < resolveOffset; i++) {
+            VkAttachmentDescription &description = attachmentDescriptions[i];
+            if (i < colorAttachmentCount) {
+                VkAttachmentDescription &resolveDescription = attachmentDescriptions[resolveOffset + i];
+                resolveDescription = description;
+                resolveDescription.samples = VK_SAMPLE_COUNT_1_BIT;
+                resolveDescription.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+                resolveDescription.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+                resolveReferences.push_back({(uint32_t)(resolveOffset + i), VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
+                description.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            } else {
+                description.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+                description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+                if (description.stencilLoadOp == VK_ATTACHMENT_LOAD_OP_LOAD) description.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+            }
+            description.samples = samples;
+            description.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            description.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            if (description.loadOp == VK_ATTACHMENT_LOAD_OP_LOAD) description.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        }
+    }
+
     vector<VkSubpassDescription> subpassDescriptions(1, {VK_PIPELINE_BIND_POINT_GRAPHICS});
     vector<VkAttachmentReference> attachmentReferences;
+    vector<uint32_t> preserveReferences;
+    vector<VkSubpassDependency> dependencies;
+
+    if (subpassCount) { // pass on user-specified subpasses, the depth stencil attachment is indexed after the color ones
+        size_t referenceCount = 0u;
+        size_t preserveCount = 0u;
+        for (const SubPassInfo &subPassInfo : gpuRenderPass->subPasses) {
+            referenceCount += subPassInfo.inputs.size() + subPassInfo.colors.size() + subPassInfo.resolves.size() + 1;
+            preserveCount += subPassInfo.preserves.size();
+        }
+        // the descriptions point into them
+        attachmentReferences.reserve(referenceCount);
+        preserveReferences.reserve(preserveCount);
 
-    if (subpassCount) { // pass on user-specified subpasses
-        subpassDescriptions.resize(subpassCount);
+        subpassDescriptions.resize(subpassCount, {VK_PIPELINE_BIND_POINT_GRAPHICS});
         for (size_t i = 0u; i < subpassCount; i++) {
             const SubPassInfo &subPassInfo = gpuRenderPass->subPasses[i];
-            subpassDescriptions[i].pipelineBindPoint = MapVkPipelineBindPoint(subPassInfo.bindPoint);
-            // TODO
+            VkSubpassDescription &description = subpassDescriptions[i];
+            description.pipelineBindPoint = MapVkPipelineBindPoint(subPassInfo.bindPoint);
+
+            description.inputAttachmentCount = subPassInfo.inputs.size();
+            description.pInputAttachments = attachmentReferences.data() + attachmentReferences.size();
+            for (const uint8_t input : subPassInfo.inputs) {
+                attachmentReferences.push_back({input, input < colorAttachmentCount ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL});
+            }
+            description.colorAttachmentCount = subPassInfo.colors.size();
+            description.pColorAttachments = attachmentReferences.data() + attachmentReferences.size();
+            for (const uint8_t color : subPassInfo.colors) {
+                attachmentReferences.push_back({color, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
+            }
+            if (!subPassInfo.resolves.empty()) {
+                description.pResolveAttachments = attachmentReferences.data() + attachmentReferences.size();
+                for (const uint8_t resolve : subPassInfo.resolves) {
+                    attachmentReferences.push_back({resolve, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
+                }
+            }
+            if (subPassInfo.depthStencil != GFX_INVALID_BINDING) {
+                // read as an input too, the depth stencil attachment can only be tested against
+                const bool isInput = std::find(subPassInfo.inputs.begin(), subPassInfo.inputs.end(), subPassInfo.depthStencil) != subPassInfo.inputs.end();
+                description.pDepthStencilAttachment = attachmentReferences.data() + attachmentReferences.size();
+                attachmentReferences.push_back({subPassInfo.depthStencil, isInput ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL});
+            }
+            description.preserveAttachmentCount = subPassInfo.preserves.size();
+            description.pPreserveAttachments = preserveReferences.data() + preserveReferences.size();
+            for (const uint8_t preserve : subPassInfo.preserves) {
+                preserveReferences.push_back(preserve);
+            }
+
+            // the writes of a subpass are read by the next ones at the same pixel only, so they stay in tile memory
+            if (i) {
+                VkSubpassDependency dependency{};
+                dependency.srcSubpass = i - 1;
+                dependency.dstSubpass = i;
+                dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+                dependency.dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+                dependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+                dependency.dstAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                           VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+                dependency.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+                dependencies.push_back(dependency);
+            }
         }
     } else { // generate a default subpass from attachment info
         for (size_t i = 0u; i < colorAttachmentCount; i++) {
@@ -238,6 +442,7 @@ void CCVKCmdFuncCreateRenderPass(CCVKDevice *device, CCVKGPURenderPass *gpuRende
         subpassDescriptions[0].colorAttachmentCount = attachmentReferences.size() - 1;
         subpassDescriptions[0].pColorAttachments = attachmentReferences.data();
         if (hasDepth) subpassDescriptions[0].pDepthStencilAttachment = &attachmentReferences.back();
+        if (!resolveReferences.empty()) subpassDescriptions[0].pResolveAttachments = resolveReferences.data();
     }
 
     VkRenderPassCreateInfo renderPassCreateInfo{VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO};
@@ -245,6 +450,8 @@ void CCVKCmdFuncCreateRenderPass(CCVKDevice *device, CCVKGPURenderPass *gpuRende
     renderPassCreateInfo.pAttachments = attachmentDescriptions.data();
     renderPassCreateInfo.subpassCount = subpassDescriptions.size();
     renderPassCreateInfo.pSubpasses = subpassDescriptions.data();
+    renderPassCreateInfo.dependencyCount = dependencies.size();
+    renderPassCreateInfo.pDependencies = dependencies.data();
 
     VK_CHECK(vkCreateRenderPass(device->gpuDevice()->vkDevice, &renderPassCreateInfo, nullptr, &gpuRenderPass->vkRenderPass));
 }
@@ -273,6 +480,42 @@ void CCVKCmdFuncCreateFramebuffer(CCVKDevice *device, CCVKGPUFramebuffer *gpuFra
     }
     gpuFramebuffer->isOffscreen = !swapchainImageIndices;
 
+    // storing a lazily allocated attachment forces the driver to commit its memory after all
+    const CCVKGPURenderPass *gpuRenderPass = gpuFramebuffer->gpuRenderPass;
+    for (size_t i = 0u; i < colorViewCount && i < gpuRenderPass->colorAttachments.size(); i++) {
+        CCVKGPUTextureView *texView = gpuFramebuffer->gpuColorViews[i];
+        if (texView && texView->gpuTexture->memoryless && gpuRenderPass->colorAttachments[i].storeOp == StoreOp::STORE) {
+            CC_LOG_WARNING("CCVKCmdFuncCreateFramebuffer: transient color attachment %d is stored, use StoreOp::DISCARD instead.", i);
+        }
+    }
+    if (depthSpecified && gpuFramebuffer->gpuDepthStencilView->gpuTexture->memoryless &&
+        (gpuRenderPass->depthStencilAttachment.depthStoreOp == StoreOp::STORE || gpuRenderPass->depthStencilAttachment.stencilStoreOp == StoreOp::STORE)) {
+        CC_LOG_WARNING("CCVKCmdFuncCreateFramebuffer: transient depth stencil attachment is stored, use StoreOp::DISCARD instead.");
+    }
+
+    // the transient multisampled attachments come first, the framebuffer textures are resolved into
+    // while the depth stencil one is replaced, as the render pass lays them out
+    size_t resolveOffset = 0u;
+    if (gpuRenderPass->sampleCount > 1u) {
+        // swapchain framebuffers are rebuilt once the device is idle
+        destroyMultisampleAttachments(device->gpuDevice(), gpuFramebuffer);
+        const uint width = gpuFramebuffer->isOffscreen && gpuTexture ? gpuTexture->width : device->getWidth();
+        const uint height = gpuFramebuffer->isOffscreen && gpuTexture ? gpuTexture->height : device->getHeight();
+        for (const ColorAttachment &colorAttachment : gpuRenderPass->colorAttachments) {
+            gpuFramebuffer->gpuMultisampleViews.push_back(createMultisampleAttachment(device, colorAttachment.format, width, height, gpuRenderPass->sampleCount));
+        }
+        if (gpuRenderPass->depthStencilAttachment.format != Format::UNKNOWN) {
+            gpuFramebuffer->gpuMultisampleViews.push_back(createMultisampleAttachment(device, gpuRenderPass->depthStencilAttachment.format, width, height, gpuRenderPass->sampleCount));
+        }
+
+        resolveOffset = gpuFramebuffer->gpuMultisampleViews.size();
+        attachments.resize(colorViewCount);
+        attachments.insert(attachments.begin(), resolveOffset, VK_NULL_HANDLE);
+        for (size_t i = 0u; i < resolveOffset; i++) {
+            attachments[i] = gpuFramebuffer->gpuMultisampleViews[i]->vkImageView;
+        }
+    }
+
     if (gpuFramebuffer->isOffscreen) {
         VkFramebufferCreateInfo createInfo{VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO};
         createInfo.renderPass = gpuFramebuffer->gpuRenderPass->vkRenderPass;
@@ -308,10 +551,10 @@ void CCVKCmdFuncCreateFramebuffer(CCVKDevice *device, CCVKGPUFramebuffer *gpuFra
         for (size_t i = 0u; i < swapchainImageCount; i++) {
             for (size_t j = 0u; j < colorViewCount; j++) {
                 if (swapchainImageIndices & (1 << j)) {
-                    attachments[j] = gpuFramebuffer->swapchain->vkSwapchainImageViews[i];
+                    attachments[resolveOffset + j] = gpuFramebuffer->swapchain->vkSwapchainImageViews[i];
                 }
             }
-            if (swapchainImageIndices & (1 << colorViewCount)) {
+            if (!resolveOffset && (swapchainImageIndices & (1 << colorViewCount))) {
                 attachments[colorViewCount] = gpuFramebuffer->swapchain->depthStencilImageViews[i];
             }
             VK_CHECK(vkCreateFramebuffer(device->gpuDevice()->vkDevice, &createInfo, nullptr, &fboListMap[gpuFramebuffer][i]));
@@ -321,7 +564,10 @@ void CCVKCmdFuncCreateFramebuffer(CCVKDevice *device, CCVKGPUFramebuffer *gpuFra
 
 void CCVKCmdFuncCreateShader(CCVKDevice *device, CCVKGPUShader *gpuShader) {
     for (CCVKGPUShaderStage &stage : gpuShader->gpuStages) {
-        vector<unsigned int> spirv = GLSL2SPIRV(stage.type, "#version 450\n" + stage.source, ((CCVKContext *)device->getContext())->minorVersion());
+        vector<unsigned int> spirv;
+        if (!device->loadPrecompiledShader(stage.type, stage.source, "vk", spirv)) {
+            spirv = GLSL2SPIRV(stage.type, "#version 450\n" + stage.source, ((CCVKContext *)device->getContext())->minorVersion());
+        }
         VkShaderModuleCreateInfo createInfo{VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
         createInfo.codeSize = spirv.size() * sizeof(unsigned int);
         createInfo.pCode = spirv.data();
@@ -348,6 +594,31 @@ void CCVKCmdFuncCreateDescriptorSetLayout(CCVKDevice *device, CCVKGPUDescriptorS
     setCreateInfo.bindingCount = bindingCount;
     setCreateInfo.pBindings = gpuDescriptorSetLayout->vkBindings.data();
     VK_CHECK(vkCreateDescriptorSetLayout(gpuDevice->vkDevice, &setCreateInfo, nullptr, &gpuDescriptorSetLayout->vkDescriptorSetLayout));
+
+    if (gpuDevice->useDescriptorUpdateTemplate && bindingCount) {
+        const vector<VkDescriptorSetLayoutBinding> &bindings = gpuDescriptorSetLayout->vkBindings;
+
+        vector<VkDescriptorUpdateTemplateEntry> entries(bindingCount);
+        for (size_t j = 0u, k = 0u; j < bindingCount; j++) {
+            const VkDescriptorSetLayoutBinding &binding = bindings[j];
+            if (binding.descriptorType != VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT) {
+                entries[j].dstBinding = binding.binding;
+                entries[j].dstArrayElement = 0;
+                entries[j].descriptorCount = binding.descriptorCount;
+                entries[j].descriptorType = binding.descriptorType;
+                entries[j].offset = sizeof(CCVKDescriptorInfo) * k;
+                entries[j].stride = sizeof(CCVKDescriptorInfo);
+                k += binding.descriptorCount;
+            } // TODO: inline UBOs
+        }
+
+        VkDescriptorUpdateTemplateCreateInfo createInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO};
+        createInfo.descriptorUpdateEntryCount = bindingCount;
+        createInfo.pDescriptorUpdateEntries = entries.data();
+        createInfo.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+        createInfo.descriptorSetLayout = gpuDescriptorSetLayout->vkDescriptorSetLayout;
+        VK_CHECK(vkCreateDescriptorUpdateTemplateKHR(gpuDevice->vkDevice, &createInfo, nullptr, &gpuDescriptorSetLayout->vkDescriptorUpdateTemplate));
+    }
 }
 
 void CCVKCmdFuncCreatePipelineLayout(CCVKDevice *device, CCVKGPUPipelineLayout *gpuPipelineLayout) {
@@ -364,39 +635,6 @@ void CCVKCmdFuncCreatePipelineLayout(CCVKDevice *device, CCVKGPUPipelineLayout *
     pipelineLayoutCreateInfo.setLayoutCount = layoutCount;
     pipelineLayoutCreateInfo.pSetLayouts = gpuPipelineLayout->descriptorSetLayouts.data();
     VK_CHECK(vkCreatePipelineLayout(gpuDevice->vkDevice, &pipelineLayoutCreateInfo, nullptr, &gpuPipelineLayout->vkPipelineLayout));
-
-    if (gpuDevice->useDescriptorUpdateTemplate) {
-        gpuPipelineLayout->vkDescriptorUpdateTemplates.resize(layoutCount);
-
-        for (uint i = 0; i < layoutCount; i++) {
-            const vector<VkDescriptorSetLayoutBinding> &bindings = gpuPipelineLayout->setLayouts[i]->vkBindings;
-            uint bindingCount = bindings.size();
-            if (!bindingCount) continue;
-
-            vector<VkDescriptorUpdateTemplateEntry> entries(bindingCount);
-            for (size_t j = 0u, k = 0u; j < bindingCount; j++) {
-                const VkDescriptorSetLayoutBinding &binding = bindings[j];
-                if (binding.descriptorType != VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT) {
-                    entries[j].dstBinding = binding.binding;
-                    entries[j].dstArrayElement = 0;
-                    entries[j].descriptorCount = binding.descriptorCount;
-                    entries[j].descriptorType = binding.descriptorType;
-                    entries[j].offset = sizeof(CCVKDescriptorInfo) * k;
-                    entries[j].stride = sizeof(CCVKDescriptorInfo);
-                    k += binding.descriptorCount;
-                } // TODO: inline UBOs
-            }
-
-            VkDescriptorUpdateTemplateCreateInfo createInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO};
-            createInfo.descriptorUpdateEntryCount = bindingCount;
-            createInfo.pDescriptorUpdateEntries = entries.data();
-            createInfo.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
-            createInfo.descriptorSetLayout = gpuPipelineLayout->setLayouts[i]->vkDescriptorSetLayout;
-            createInfo.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-            createInfo.pipelineLayout = gpuPipelineLayout->vkPipelineLayout;
-            VK_CHECK(vkCreateDescriptorUpdateTemplateKHR(gpuDevice->vkDevice, &createInfo, nullptr, &gpuPipelineLayout->vkDescriptorUpdateTemplates[i]));
-        }
-    }
 }
 
 void CCVKCmdFuncCreatePipelineState(CCVKDevice *device, CCVKGPUPipelineState *gpuPipelineState) {
@@ -515,7 +753,7 @@ void CCVKCmdFuncCreatePipelineState(CCVKDevice *device, CCVKGPUPipelineState *gp
     ///////////////////// Multisample State /////////////////////
 
     VkPipelineMultisampleStateCreateInfo multisampleState{VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO};
-    multisampleState.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+    multisampleState.rasterizationSamples = MapVkSampleCount(gpuPipelineState->gpuRenderPass->sampleCount);
     multisampleState.alphaToCoverageEnable = gpuPipelineState->bs.isA2C;
     //multisampleState.sampleShadingEnable;
     //multisampleState.minSampleShading;
@@ -585,6 +823,7 @@ void CCVKCmdFuncCreatePipelineState(CCVKDevice *device, CCVKGPUPipelineState *gp
 
     createInfo.layout = gpuPipelineState->gpuPipelineLayout->vkPipelineLayout;
     createInfo.renderPass = gpuPipelineState->gpuRenderPass->vkRenderPass;
+    createInfo.subpass = gpuPipelineState->subpass;
 
     ///////////////////// Creation /////////////////////
 
@@ -597,7 +836,14 @@ void CCVKCmdFuncCreateFence(CCVKDevice *device, CCVKGPUFence *gpuFence) {
     VK_CHECK(vkCreateFence(device->gpuDevice()->vkDevice, &createInfo, nullptr, &gpuFence->vkFence));
 }
 
-void CCVKCmdFuncUpdateBuffer(CCVKDevice *device, CCVKGPUBuffer *gpuBuffer, const void *buffer, uint offset, uint size, const CCVKGPUCommandBuffer *cmdBuffer) {
+void CCVKCmdFuncCreateQueryPool(CCVKDevice *device, CCVKGPUQueryPool *gpuQueryPool) {
+    VkQueryPoolCreateInfo createInfo{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+    createInfo.queryType = gpuQueryPool->type == QueryType::OCCLUSION ? VK_QUERY_TYPE_OCCLUSION : VK_QUERY_TYPE_TIMESTAMP;
+    createInfo.queryCount = gpuQueryPool->maxQueryObjects;
+    VK_CHECK(vkCreateQueryPool(device->gpuDevice()->vkDevice, &createInfo, nullptr, &gpuQueryPool->vkPool));
+}
+
+void CCVKCmdFuncUpdateBuffer(CCVKDevice *device, CCVKGPUBuffer *gpuBuffer, const void *buffer, uint offset, uint size, CCVKGPUCommandBuffer *cmdBuffer) {
     if (!gpuBuffer) return;
 
     const void *dataToUpload = nullptr;
@@ -649,19 +895,41 @@ void CCVKCmdFuncUpdateBuffer(CCVKDevice *device, CCVKGPUBuffer *gpuBuffer, const
 
     VkBufferCopy region{stagingBuffer.startOffset, gpuBuffer->startOffset + offset, sizeToUpload};
     if (cmdBuffer) {
-        vkCmdCopyBuffer(cmdBuffer->vkCommandBuffer, stagingBuffer.vkBuffer, gpuBuffer->vkBuffer, 1, &region);
-
-        // guard against RAW hazard
-        VkBufferMemoryBarrier barrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = gpuBuffer->accessMask;
-        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.buffer = gpuBuffer->vkBuffer;
-        barrier.offset = region.dstOffset;
-        barrier.size = region.size;
-        vkCmdPipelineBarrier(cmdBuffer->vkCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, gpuBuffer->targetStage, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+        auto iter = cmdBuffer->pendingCopyIndices.find(gpuBuffer->vkBuffer);
+        if (iter != cmdBuffer->pendingCopyIndices.end()) {
+            // the regions of one copy command are unordered, so overlapping updates need a batch of their own
+            const CCVKGPUBufferCopy &copy = cmdBuffer->pendingCopies[iter->second];
+            bool flush = copy.srcBuffer != stagingBuffer.vkBuffer;
+            for (size_t i = 0u; !flush && i < copy.regions.size(); ++i) {
+                const VkBufferCopy &pending = copy.regions[i];
+                flush = pending.dstOffset < region.dstOffset + region.size && region.dstOffset < pending.dstOffset + pending.size;
+            }
+            if (flush) {
+                CCVKCmdFuncFlushBufferCopies(cmdBuffer);
+                iter = cmdBuffer->pendingCopyIndices.end();
+            }
+        }
 
+        if (iter == cmdBuffer->pendingCopyIndices.end()) {
+            if (cmdBuffer->pendingCopies.size() <= cmdBuffer->pendingCopyCount) {
+                cmdBuffer->pendingCopies.resize(cmdBuffer->pendingCopyCount + 1);
+            }
+            CCVKGPUBufferCopy &copy = cmdBuffer->pendingCopies[cmdBuffer->pendingCopyCount];
+            copy.srcBuffer = stagingBuffer.vkBuffer;
+            copy.dstBuffer = gpuBuffer->vkBuffer;
+            copy.regions.push_back(region);
+            cmdBuffer->pendingCopyIndices[gpuBuffer->vkBuffer] = cmdBuffer->pendingCopyCount++;
+        } else {
+            // consecutive updates of a buffer are mostly contiguous on both sides
+            VkBufferCopy &last = cmdBuffer->pendingCopies[iter->second].regions.back();
+            if (last.srcOffset + last.size == region.srcOffset && last.dstOffset + last.size == region.dstOffset) {
+                last.size += region.size;
+            } else {
+                cmdBuffer->pendingCopies[iter->second].regions.push_back(region);
+            }
+        }
+        cmdBuffer->pendingCopyStages |= gpuBuffer->targetStage;
+        cmdBuffer->pendingCopyAccesses |= gpuBuffer->accessMask;
     } else {
         device->gpuTransportHub()->checkIn([&](const CCVKGPUCommandBuffer *cmdBuff) {
             vkCmdCopyBuffer(cmdBuff->vkCommandBuffer, stagingBuffer.vkBuffer, gpuBuffer->vkBuffer, 1, &region);
@@ -669,6 +937,35 @@ void CCVKCmdFuncUpdateBuffer(CCVKDevice *device, CCVKGPUBuffer *gpuBuffer, const
     }
 }
 
+void CCVKCmdFuncFlushBufferCopies(CCVKGPUCommandBuffer *cmdBuffer) {
+    if (!cmdBuffer->pendingCopyCount) return;
+
+    // guard against WAR hazard, the commands recorded before may still read the old contents,
+    // and against WAW hazard with the batch before
+    VkMemoryBarrier barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmdBuffer->vkCommandBuffer, cmdBuffer->pendingCopyStages | VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    for (uint i = 0u; i < cmdBuffer->pendingCopyCount; ++i) {
+        CCVKGPUBufferCopy &copy = cmdBuffer->pendingCopies[i];
+        vkCmdCopyBuffer(cmdBuffer->vkCommandBuffer, copy.srcBuffer, copy.dstBuffer, toUint(copy.regions.size()), copy.regions.data());
+        copy.regions.clear();
+    }
+
+    // guard against RAW hazard
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = cmdBuffer->pendingCopyAccesses;
+    vkCmdPipelineBarrier(cmdBuffer->vkCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, cmdBuffer->pendingCopyStages,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    cmdBuffer->pendingCopyIndices.clear();
+    cmdBuffer->pendingCopyCount = 0u;
+    cmdBuffer->pendingCopyStages = 0u;
+    cmdBuffer->pendingCopyAccesses = 0u;
+}
+
 void CCVKCmdFuncCopyBuffersToTexture(CCVKDevice *device, const uint8_t *const *buffers, CCVKGPUTexture *gpuTexture,
                                      const BufferTextureCopy *regions, uint count, const CCVKGPUCommandBuffer *cmdBuff) {
     //bool isCompressed = GFX_FORMAT_INFOS[(int)gpuTexture->format].isCompressed;
@@ -798,6 +1095,142 @@ void CCVKCmdFuncCopyBuffersToTexture(CCVKDevice *device, const uint8_t *const *b
     gpuTexture->currentLayout = gpuTexture->layout;
 }
 
+void CCVKCmdFuncUploadBuffersToTexture(CCVKDevice *device, const uint8_t *const *buffers, CCVKGPUTexture *gpuTexture,
+                                       const BufferTextureCopy *regions, uint count, uint dstQueueFamilyIndex, CCVKGPUAsyncUpload *gpuUpload) {
+    // the previous contents are discarded, so the image needn't be released by the graphics family first
+    VkImageMemoryBarrier barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+    barrier.image = gpuTexture->vkImage;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+    barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+    barrier.subresourceRange.aspectMask = gpuTexture->aspectMask;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    vkCmdPipelineBarrier(gpuUpload->vkCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_DEPENDENCY_BY_REGION_BIT, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    uint totalSize = 0u;
+    vector<uint> regionSizes(count);
+    for (size_t i = 0u; i < count; ++i) {
+        const BufferTextureCopy &region = regions[i];
+        uint w = region.buffStride > 0 ? region.buffStride : region.texExtent.width;
+        uint h = region.buffTexHeight > 0 ? region.buffTexHeight : region.texExtent.height;
+        totalSize += regionSizes[i] = FormatSize(gpuTexture->format, w, h, region.texExtent.depth);
+    }
+
+    // staged apart from the per-frame pool, the upload may take longer than a frame
+    VkBufferCreateInfo bufferInfo{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    bufferInfo.size = totalSize;
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    VmaAllocationCreateInfo allocInfo{};
+    allocInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    allocInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+    VmaAllocationInfo res;
+    VK_CHECK(vmaCreateBuffer(device->gpuDevice()->memoryAllocator, &bufferInfo, &allocInfo, &gpuUpload->vkStagingBuffer, &gpuUpload->vmaStagingAllocation, &res));
+    uint8_t *mappedData = (uint8_t *)res.pMappedData;
+
+    vector<VkBufferImageCopy> stagingRegions(count);
+    VkDeviceSize offset = 0;
+    for (size_t i = 0u; i < count; ++i) {
+        const BufferTextureCopy &region = regions[i];
+        VkBufferImageCopy &stagingRegion = stagingRegions[i];
+        stagingRegion.bufferOffset = offset;
+        stagingRegion.bufferRowLength = region.buffStride;
+        stagingRegion.bufferImageHeight = region.buffTexHeight;
+        stagingRegion.imageSubresource = {gpuTexture->aspectMask, region.texSubres.mipLevel, region.texSubres.baseArrayLayer, region.texSubres.layerCount};
+        stagingRegion.imageOffset = {region.texOffset.x, region.texOffset.y, region.texOffset.z};
+        stagingRegion.imageExtent = {region.texExtent.width, region.texExtent.height, region.texExtent.depth};
+
+        memcpy(mappedData + offset, buffers[i], regionSizes[i]);
+        offset += regionSizes[i];
+    }
+
+    vkCmdCopyBufferToImage(gpuUpload->vkCommandBuffer, gpuUpload->vkStagingBuffer, gpuTexture->vkImage,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, stagingRegions.size(), stagingRegions.data());
+
+    // released to the graphics family when uploaded from another one, which acquires it on collection
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = gpuTexture->layout;
+    const uint srcQueueFamilyIndex = device->gpuTransferQueue()->queueFamilyIndex;
+    gpuUpload->needsAcquire = srcQueueFamilyIndex != dstQueueFamilyIndex;
+    if (gpuUpload->needsAcquire) {
+        barrier.srcQueueFamilyIndex = srcQueueFamilyIndex;
+        barrier.dstQueueFamilyIndex = dstQueueFamilyIndex;
+        barrier.dstAccessMask = 0;
+        vkCmdPipelineBarrier(gpuUpload->vkCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                             VK_DEPENDENCY_BY_REGION_BIT, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        // the texture may be destroyed as soon as it is signaled, the acquisition keeps what it needs
+        gpuUpload->acquireBarrier = barrier;
+        gpuUpload->acquireBarrier.srcAccessMask = 0;
+        gpuUpload->acquireBarrier.dstAccessMask = gpuTexture->accessMask;
+        gpuUpload->acquireStageMask = gpuTexture->targetStage;
+    } else {
+        barrier.dstAccessMask = gpuTexture->accessMask;
+        vkCmdPipelineBarrier(gpuUpload->vkCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, gpuTexture->targetStage,
+                             VK_DEPENDENCY_BY_REGION_BIT, 0, nullptr, 0, nullptr, 1, &barrier);
+    }
+
+    gpuTexture->currentLayout = gpuTexture->layout;
+}
+
+void CCVKCmdFuncAcquireUploadedTexture(const CCVKGPUAsyncUpload *gpuUpload, const CCVKGPUCommandBuffer *cmdBuff) {
+    vkCmdPipelineBarrier(cmdBuff->vkCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, gpuUpload->acquireStageMask,
+                         VK_DEPENDENCY_BY_REGION_BIT, 0, nullptr, 0, nullptr, 1, &gpuUpload->acquireBarrier);
+}
+
+void CCVKCmdFuncCopyTexture(CCVKDevice *device, CCVKGPUTexture *gpuSrcTexture, CCVKGPUTexture *gpuDstTexture,
+                            const TextureCopy *regions, uint count, const CCVKGPUCommandBuffer *cmdBuff) {
+    // both textures are expected in the layouts their usages map to,
+    // render passes writing into them should end in those layouts as well
+    VkImageMemoryBarrier barriers[2]{};
+    for (VkImageMemoryBarrier &barrier : barriers) {
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+        barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+    }
+    barriers[0].image = gpuSrcTexture->vkImage;
+    barriers[0].subresourceRange.aspectMask = gpuSrcTexture->aspectMask;
+    barriers[0].srcAccessMask = gpuSrcTexture->accessMask;
+    barriers[0].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barriers[0].oldLayout = gpuSrcTexture->layout;
+    barriers[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barriers[1].image = gpuDstTexture->vkImage;
+    barriers[1].subresourceRange.aspectMask = gpuDstTexture->aspectMask;
+    barriers[1].srcAccessMask = gpuDstTexture->accessMask;
+    barriers[1].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barriers[1].oldLayout = gpuDstTexture->layout;
+    barriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    vkCmdPipelineBarrier(cmdBuff->vkCommandBuffer, gpuSrcTexture->targetStage | gpuDstTexture->targetStage, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_DEPENDENCY_BY_REGION_BIT, 0, nullptr, 0, nullptr, 2, barriers);
+
+    vector<VkImageCopy> copyRegions(count);
+    for (uint i = 0u; i < count; ++i) {
+        const TextureCopy &region = regions[i];
+        VkImageCopy &copyRegion = copyRegions[i];
+        copyRegion.srcSubresource = {gpuSrcTexture->aspectMask, region.srcSubres.mipLevel, region.srcSubres.baseArrayLayer, region.srcSubres.layerCount};
+        copyRegion.srcOffset = {region.srcOffset.x, region.srcOffset.y, region.srcOffset.z};
+        copyRegion.dstSubresource = {gpuDstTexture->aspectMask, region.dstSubres.mipLevel, region.dstSubres.baseArrayLayer, region.dstSubres.layerCount};
+        copyRegion.dstOffset = {region.dstOffset.x, region.dstOffset.y, region.dstOffset.z};
+        copyRegion.extent = {region.extent.width, region.extent.height, region.extent.depth};
+    }
+    vkCmdCopyImage(cmdBuff->vkCommandBuffer, gpuSrcTexture->vkImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                   gpuDstTexture->vkImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, count, copyRegions.data());
+
+    std::swap(barriers[0].srcAccessMask, barriers[0].dstAccessMask);
+    std::swap(barriers[0].oldLayout, barriers[0].newLayout);
+    std::swap(barriers[1].srcAccessMask, barriers[1].dstAccessMask);
+    std::swap(barriers[1].oldLayout, barriers[1].newLayout);
+    vkCmdPipelineBarrier(cmdBuff->vkCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, gpuSrcTexture->targetStage | gpuDstTexture->targetStage,
+                         VK_DEPENDENCY_BY_REGION_BIT, 0, nullptr, 0, nullptr, 2, barriers);
+}
+
 void CCVKCmdFuncDestroyRenderPass(CCVKGPUDevice *gpuDevice, CCVKGPURenderPass *gpuRenderPass) {
     if (gpuRenderPass->vkRenderPass != VK_NULL_HANDLE) {
         vkDestroyRenderPass(gpuDevice->vkDevice, gpuRenderPass->vkRenderPass, nullptr);
@@ -820,6 +1253,7 @@ void CCVKCmdFuncDestroyShader(CCVKGPUDevice *gpuDevice, CCVKGPUShader *gpuShader
 }
 
 void CCVKCmdFuncDestroyFramebuffer(CCVKGPUDevice *gpuDevice, CCVKGPUFramebuffer *gpuFramebuffer) {
+    destroyMultisampleAttachments(gpuDevice, gpuFramebuffer);
     if (gpuFramebuffer->isOffscreen) {
         if (gpuFramebuffer->vkFramebuffer != VK_NULL_HANDLE) {
             vkDestroyFramebuffer(gpuDevice->vkDevice, gpuFramebuffer->vkFramebuffer, nullptr);
@@ -839,6 +1273,11 @@ void CCVKCmdFuncDestroyFramebuffer(CCVKGPUDevice *gpuDevice, CCVKGPUFramebuffer
 }
 
 void CCVKCmdFuncDestroyDescriptorSetLayout(CCVKGPUDevice *gpuDevice, CCVKGPUDescriptorSetLayout *gpuDescriptorSetLayout) {
+    if (gpuDescriptorSetLayout->vkDescriptorUpdateTemplate != VK_NULL_HANDLE) {
+        vkDestroyDescriptorUpdateTemplateKHR(gpuDevice->vkDevice, gpuDescriptorSetLayout->vkDescriptorUpdateTemplate, nullptr);
+        gpuDescriptorSetLayout->vkDescriptorUpdateTemplate = VK_NULL_HANDLE;
+    }
+
     if (gpuDescriptorSetLayout->vkDescriptorSetLayout != VK_NULL_HANDLE) {
         vkDestroyDescriptorSetLayout(gpuDevice->vkDevice, gpuDescriptorSetLayout->vkDescriptorSetLayout, nullptr);
         gpuDescriptorSetLayout->vkDescriptorSetLayout = VK_NULL_HANDLE;
@@ -846,13 +1285,6 @@ void CCVKCmdFuncDestroyDescriptorSetLayout(CCVKGPUDevice *gpuDevice, CCVKGPUDesc
 }
 
 void CCVKCmdFuncDestroyPipelineLayout(CCVKGPUDevice *gpuDevice, CCVKGPUPipelineLayout *gpuPipelineLayout) {
-    for (VkDescriptorUpdateTemplate updateTemplate : gpuPipelineLayout->vkDescriptorUpdateTemplates) {
-        if (updateTemplate != VK_NULL_HANDLE) {
-            vkDestroyDescriptorUpdateTemplateKHR(gpuDevice->vkDevice, updateTemplate, nullptr);
-        }
-    }
-    gpuPipelineLayout->vkDescriptorUpdateTemplates.clear();
-
     if (gpuPipelineLayout->vkPipelineLayout != VK_NULL_HANDLE) {
         vkDestroyPipelineLayout(gpuDevice->vkDevice, gpuPipelineLayout->vkPipelineLayout, nullptr);
         gpuPipelineLayout->vkPipelineLayout = VK_NULL_HANDLE;
@@ -873,6 +1305,13 @@ void CCVKCmdFuncDestroyFence(CCVKGPUDevice *gpuDevice, CCVKGPUFence *gpuFence) {
     }
 }
 
+void CCVKCmdFuncDestroyQueryPool(CCVKGPUDevice *gpuDevice, CCVKGPUQueryPool *gpuQueryPool) {
+    if (gpuQueryPool->vkPool) {
+        vkDestroyQueryPool(gpuDevice->vkDevice, gpuQueryPool->vkPool, nullptr);
+        gpuQueryPool->vkPool = VK_NULL_HANDLE;
+    }
+}
+
 void CCVKGPURecycleBin::clear() {
     for (uint i = 0u; i < _count; i++) {
         Resource &res = _resources[i];
@@ -953,6 +1392,13 @@ void CCVKGPURecycleBin::clear() {
                     res.gpuFence = nullptr;
                 }
                 break;
+            case RecycledType::QUERY_POOL:
+                if (res.gpuQueryPool) {
+                    CCVKCmdFuncDestroyQueryPool(_device, res.gpuQueryPool);
+                    CC_DELETE(res.gpuQueryPool);
+                    res.gpuQueryPool = nullptr;
+                }
+                break;
             default: break;
         }
         res.type = RecycledType::UNKNOWN;
@@ -43,9 +43,20 @@ CC_VULKAN_API void CCVKCmdFuncCreateDescriptorSetLayout(CCVKDevice *device, CCVK
 CC_VULKAN_API void CCVKCmdFuncCreatePipelineLayout(CCVKDevice *device, CCVKGPUPipelineLayout *gpuPipelineLayout);
 CC_VULKAN_API void CCVKCmdFuncCreatePipelineState(CCVKDevice *device, CCVKGPUPipelineState *gpuPipelineState);
 CC_VULKAN_API void CCVKCmdFuncCreateFence(CCVKDevice *device, CCVKGPUFence *gpuFence);
+CC_VULKAN_API void CCVKCmdFuncCreateQueryPool(CCVKDevice *device, CCVKGPUQueryPool *gpuQueryPool);
+// Binds a new VkBuffer to the allocation of the buffer after the defragmentation moved it, the old one must be idle.
+CC_VULKAN_API void CCVKCmdFuncRebindBuffer(CCVKDevice *device, CCVKGPUBuffer *gpuBuffer);
 
-CC_VULKAN_API void CCVKCmdFuncUpdateBuffer(CCVKDevice *device, CCVKGPUBuffer *gpuBuffer, const void *buffer, uint offset, uint size, const CCVKGPUCommandBuffer *cmdBuffer = nullptr);
+// Updates through a command buffer are batched, see CCVKCmdFuncFlushBufferCopies.
+CC_VULKAN_API void CCVKCmdFuncUpdateBuffer(CCVKDevice *device, CCVKGPUBuffer *gpuBuffer, const void *buffer, uint offset, uint size, CCVKGPUCommandBuffer *cmdBuffer = nullptr);
+// Records the batched buffer updates with a barrier on each side of the whole batch,
+// called before anything that may read the buffers is recorded into the command buffer.
+CC_VULKAN_API void CCVKCmdFuncFlushBufferCopies(CCVKGPUCommandBuffer *cmdBuffer);
 CC_VULKAN_API void CCVKCmdFuncCopyBuffersToTexture(CCVKDevice *device, const uint8_t *const *buffers, CCVKGPUTexture *gpuTexture, const BufferTextureCopy *regions, uint count, const CCVKGPUCommandBuffer *cmdBuff);
+// Records into the command buffer of the upload, which is submitted to the transfer queue.
+CC_VULKAN_API void CCVKCmdFuncUploadBuffersToTexture(CCVKDevice *device, const uint8_t *const *buffers, CCVKGPUTexture *gpuTexture, const BufferTextureCopy *regions, uint count, uint dstQueueFamilyIndex, CCVKGPUAsyncUpload *gpuUpload);
+CC_VULKAN_API void CCVKCmdFuncAcquireUploadedTexture(const CCVKGPUAsyncUpload *gpuUpload, const CCVKGPUCommandBuffer *cmdBuff);
+CC_VULKAN_API void CCVKCmdFuncCopyTexture(CCVKDevice *device, CCVKGPUTexture *gpuSrcTexture, CCVKGPUTexture *gpuDstTexture, const TextureCopy *regions, uint count, const CCVKGPUCommandBuffer *cmdBuff);
 
 CC_VULKAN_API void CCVKCmdFuncDestroyRenderPass(CCVKGPUDevice *device, CCVKGPURenderPass *gpuRenderPass);
 CC_VULKAN_API void CCVKCmdFuncDestroySampler(CCVKGPUDevice *device, CCVKGPUSampler *gpuSampler);
@@ -55,6 +66,7 @@ CC_VULKAN_API void CCVKCmdFuncDestroyDescriptorSetLayout(CCVKGPUDevice *device,
 CC_VULKAN_API void CCVKCmdFuncDestroyPipelineLayout(CCVKGPUDevice *device, CCVKGPUPipelineLayout *gpuPipelineLayout);
 CC_VULKAN_API void CCVKCmdFuncDestroyPipelineState(CCVKGPUDevice *device, CCVKGPUPipelineState *gpuPipelineState);
 CC_VULKAN_API void CCVKCmdFuncDestroyFence(CCVKGPUDevice *device, CCVKGPUFence *gpuFence);
+CC_VULKAN_API void CCVKCmdFuncDestroyQueryPool(CCVKGPUDevice *device, CCVKGPUQueryPool *gpuQueryPool);
 
 } // namespace gfx
 } // namespace cc
@@ -278,13 +278,9 @@ bool CCVKContext::initialize(const ContextInfo &info) {
             if (_gpuContext && _gpuContext->vkSurface != VK_NULL_HANDLE) {
 
                 CCVKDevice* device = (CCVKDevice*)_device;
-                CCVKQueue *queue = (CCVKQueue *)device->_queue;
 
-                if (!queue->gpuQueue()->fences.empty()) {
-                    VK_CHECK(vkWaitForFences(device->_gpuDevice->vkDevice, queue->gpuQueue()->fences.size(),
-                                             queue->gpuQueue()->fences.data(), VK_TRUE, DEFAULT_TIMEOUT));
-                    queue->gpuQueue()->fences.clear();
-                }
+                // every frame in flight may still render into the swapchain
+                VK_CHECK(vkDeviceWaitIdle(device->_gpuDevice->vkDevice));
 
                 device->destroySwapchain();
                 device->_swapchainReady = false;
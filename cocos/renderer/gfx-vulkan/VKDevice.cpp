@@ -11,12 +11,16 @@
 #include "VKInputAssembler.h"
 #include "VKPipelineLayout.h"
 #include "VKPipelineState.h"
+#include "VKQueryPool.h"
 #include "VKQueue.h"
 #include "VKRenderPass.h"
 #include "VKSampler.h"
 #include "VKShader.h"
 #include "VKTexture.h"
 #include "VKUtils.h"
+#include "base/MemoryPressure.h"
+#include "base/Startup.h"
+#include "platform/FileUtils.h"
 
 CC_DISABLE_WARNINGS()
 #define VMA_IMPLEMENTATION
@@ -37,11 +41,38 @@ CCVKDevice::CCVKDevice() {
 CCVKDevice::~CCVKDevice() {
 }
 
+namespace {
+const uint PIPELINE_CACHE_MAGIC = 0x43435650; // 'CCVP'
+
+// stored in front of the driver blob, the blob is discarded if anything here mismatches
+struct PipelineCacheFileHeader {
+    uint magic = PIPELINE_CACHE_MAGIC;
+    uint driverVersion = 0u;
+    uint vendorID = 0u;
+    uint deviceID = 0u;
+    uint8_t pipelineCacheUUID[VK_UUID_SIZE] = {0};
+    uint dataSize = 0u;
+};
+
+String getPipelineCachePath() {
+    return FileUtils::getInstance()->getWritablePath() + "vk_pipeline_cache.bin";
+}
+
+bool isPipelineCacheCompatible(const PipelineCacheFileHeader &header, const VkPhysicalDeviceProperties &properties) {
+    return header.magic == PIPELINE_CACHE_MAGIC &&
+           header.driverVersion == properties.driverVersion &&
+           header.vendorID == properties.vendorID &&
+           header.deviceID == properties.deviceID &&
+           !memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+}
+} // namespace
+
 CCVKGPUContext *CCVKDevice::gpuContext() const {
     return ((CCVKContext *)_context)->gpuContext();
 }
 
 bool CCVKDevice::initialize(const DeviceInfo &info) {
+    CC_STARTUP_PHASE("GFXDevice");
     _API = API::VULKAN;
     _deviceName = "Vulkan";
     _width = info.width;
@@ -86,6 +117,7 @@ bool CCVKDevice::initialize(const DeviceInfo &info) {
         VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME,
         VK_KHR_DEDICATED_ALLOCATION_EXTENSION_NAME,
         VK_KHR_GET_MEMORY_REQUIREMENTS_2_EXTENSION_NAME,
+        VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
     };
     VkPhysicalDeviceFeatures2 requestedFeatures2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
     VkPhysicalDeviceVulkan11Features requestedVulkan11Features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES};
@@ -95,6 +127,9 @@ bool CCVKDevice::initialize(const DeviceInfo &info) {
     requestedFeatures2.features.textureCompressionBC = deviceFeatures.textureCompressionBC;
     requestedFeatures2.features.textureCompressionETC2 = deviceFeatures.textureCompressionETC2;
     requestedFeatures2.features.samplerAnisotropy = deviceFeatures.samplerAnisotropy;
+    if (context->minorVersion() >= 2) {
+        requestedVulkan12Features.timelineSemaphore = gpuContext->physicalDeviceVulkan12Features.timelineSemaphore;
+    }
     requestedFeatures2.features.depthBounds = deviceFeatures.depthBounds;
     requestedFeatures2.features.multiDrawIndirect = deviceFeatures.multiDrawIndirect;
 
@@ -169,6 +204,7 @@ bool CCVKDevice::initialize(const DeviceInfo &info) {
     }
 
     VK_CHECK(vkCreateDevice(gpuContext->physicalDevice, &deviceCreateInfo, nullptr, &_gpuDevice->vkDevice));
+    _gpuDevice->useTimelineSemaphore = requestedVulkan12Features.timelineSemaphore;
 
     ///////////////////// Gather Device Properties /////////////////////
 
@@ -245,6 +281,13 @@ bool CCVKDevice::initialize(const DeviceInfo &info) {
     _maxTextureSize = limits.maxImageDimension2D;
     _maxCubeMapTextureSize = limits.maxImageDimensionCube;
     _uboOffsetAlignment = (uint)limits.minUniformBufferOffsetAlignment;
+    _features[(uint)Feature::TIMESTAMP_QUERY] = limits.timestampComputeAndGraphics;
+    _features[(uint)Feature::DEPTH_STENCIL_COPY] = true;
+    _features[(uint)Feature::DRAW_INDIRECT] = true;
+    // resolved in a subpass into lazily allocated attachments, see CCVKCmdFuncCreateRenderPass
+    _features[(uint)Feature::MULTISAMPLED_RENDER_TO_TEXTURE] =
+        (limits.framebufferColorSampleCounts & limits.framebufferDepthSampleCounts & ~VK_SAMPLE_COUNT_1_BIT) != 0;
+    _features[(uint)Feature::SUBPASS_INPUT] = true;
     MapDepthStencilBits(_context->getDepthStencilFormat(), _depthBits, _stencilBits);
 
     ///////////////////// Resource Initialization /////////////////////
@@ -279,6 +322,12 @@ bool CCVKDevice::initialize(const DeviceInfo &info) {
         vmaVulkanFunc.vkGetImageMemoryRequirements2KHR = vkGetImageMemoryRequirements2KHR;
     }
 
+    // VMA estimates the budgets from the heap sizes otherwise
+    vmaVulkanFunc.vkGetPhysicalDeviceMemoryProperties2KHR = vkGetPhysicalDeviceMemoryProperties2KHR ? vkGetPhysicalDeviceMemoryProperties2KHR : vkGetPhysicalDeviceMemoryProperties2;
+    if (checkExtension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) && vmaVulkanFunc.vkGetPhysicalDeviceMemoryProperties2KHR) {
+        allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+    }
+
     allocatorInfo.pVulkanFunctions = &vmaVulkanFunc;
 
     VK_CHECK(vmaCreateAllocator(&allocatorInfo, &_gpuDevice->memoryAllocator));
@@ -287,16 +336,34 @@ bool CCVKDevice::initialize(const DeviceInfo &info) {
     queueInfo.type = QueueType::GRAPHICS;
     _queue = createQueue(queueInfo);
 
-    _gpuFencePool = CC_NEW(CCVKGPUFencePool(_gpuDevice));
-    _gpuRecycleBin = CC_NEW(CCVKGPURecycleBin(_gpuDevice));
+    if (_gpuDevice->useTimelineSemaphore) {
+        VkSemaphoreTypeCreateInfo typeCreateInfo{VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO};
+        typeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        VkSemaphoreCreateInfo semaphoreCreateInfo{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+        semaphoreCreateInfo.pNext = &typeCreateInfo;
+        VK_CHECK(vkCreateSemaphore(_gpuDevice->vkDevice, &semaphoreCreateInfo, nullptr, &((CCVKQueue *)_queue)->gpuQueue()->timelineSemaphore));
+    }
+
     _gpuTransportHub = CC_NEW(CCVKGPUTransportHub(_gpuDevice));
     _gpuDescriptorHub = CC_NEW(CCVKGPUDescriptorHub(_gpuDevice));
-    _gpuSemaphorePool = CC_NEW(CCVKGPUSemaphorePool(_gpuDevice));
-    _gpuDescriptorSetPool = CC_NEW(CCVKGPUDescriptorSetPool(_gpuDevice));
-    _gpuCommandBufferPool = CC_NEW(CCVKGPUCommandBufferPool(_gpuDevice));
-    _gpuStagingBufferPool = CC_NEW(CCVKGPUStagingBufferPool(_gpuDevice));
+    for (uint i = 0u; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        _gpuFencePools[i] = CC_NEW(CCVKGPUFencePool(_gpuDevice));
+        _gpuRecycleBins[i] = CC_NEW(CCVKGPURecycleBin(_gpuDevice));
+        _gpuSemaphorePools[i] = CC_NEW(CCVKGPUSemaphorePool(_gpuDevice));
+        _gpuDescriptorSetPools[i] = CC_NEW(CCVKGPUDescriptorSetPool(_gpuDevice));
+        _gpuCommandBufferPools[i] = CC_NEW(CCVKGPUCommandBufferPool(_gpuDevice));
+        _gpuStagingBufferPools[i] = CC_NEW(CCVKGPUStagingBufferPool(_gpuDevice));
+    }
 
-    _gpuTransportHub->link(((CCVKQueue *)_queue)->gpuQueue(), _gpuFencePool, _gpuCommandBufferPool, _gpuStagingBufferPool);
+    _gpuTransportHub->link(((CCVKQueue *)_queue)->gpuQueue(), gpuFencePool(), gpuCommandBufferPool(), gpuStagingBufferPool());
+
+    queueInfo.type = QueueType::TRANSFER;
+    _transferQueue = createQueue(queueInfo);
+    VkCommandPoolCreateInfo transferPoolInfo{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+    transferPoolInfo.queueFamilyIndex = gpuTransferQueue()->queueFamilyIndex;
+    transferPoolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    VK_CHECK(vkCreateCommandPool(_gpuDevice->vkDevice, &transferPoolInfo, nullptr, &_transferCommandPool));
+    _features[(uint)Feature::ASYNC_TEXTURE_UPLOAD] = true;
 
     CommandBufferInfo cmdBuffInfo;
     cmdBuffInfo.type = CommandBufferType::PRIMARY;
@@ -321,13 +388,17 @@ bool CCVKDevice::initialize(const DeviceInfo &info) {
     _gpuDevice->defaultBuffer.count = 1u;
     CCVKCmdFuncCreateBuffer(this, &_gpuDevice->defaultBuffer);
     
-    VkPipelineCacheCreateInfo pipelineCacheInfo{VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
-    VK_CHECK(vkCreatePipelineCache(_gpuDevice->vkDevice, &pipelineCacheInfo, nullptr, &_gpuDevice->vkPipelineCache));
+    createPipelineCache();
+    // the pipelines compiled so far survive the process being killed
+    _memoryPressureHandlerID = MemoryPressure::addHandler("CCVKDevice", MemoryPressureLevel::CRITICAL, [this](MemoryPressureLevel) {
+        savePipelineCache();
+    });
 
     for (uint i = 0u; i < gpuContext->swapchainCreateInfo.minImageCount; i++) {
         TextureInfo depthStencilTexInfo;
         depthStencilTexInfo.type = TextureType::TEX2D;
-        depthStencilTexInfo.usage = TextureUsageBit::DEPTH_STENCIL_ATTACHMENT | TextureUsageBit::SAMPLED;
+        // the swapchain depth buffer is never sampled nor read back, keep it in tile memory where possible
+        depthStencilTexInfo.usage = TextureUsageBit::DEPTH_STENCIL_ATTACHMENT | TextureUsageBit::TRANSIENT_ATTACHMENT;
         depthStencilTexInfo.format = _context->getDepthStencilFormat();
         depthStencilTexInfo.width = _width;
         depthStencilTexInfo.height = _height;
@@ -377,6 +448,11 @@ bool CCVKDevice::initialize(const DeviceInfo &info) {
 }
 
 void CCVKDevice::destroy() {
+    if (_memoryPressureHandlerID) {
+        MemoryPressure::removeHandler(_memoryPressureHandlerID);
+        _memoryPressureHandlerID = 0;
+    }
+
     if (_gpuDevice && _gpuDevice->vkDevice) {
         VK_CHECK(vkDeviceWaitIdle(_gpuDevice->vkDevice));
     }
@@ -390,24 +466,44 @@ void CCVKDevice::destroy() {
     }
     _depthStencilTextures.clear();
 
-    if (_gpuRecycleBin) {
-        _gpuRecycleBin->clear();
+    for (CCVKGPURecycleBin *recycleBin : _gpuRecycleBins) {
+        if (recycleBin) recycleBin->clear();
     }
 
+    // idle by now, nothing to acquire anymore
+    for (CCVKGPUAsyncUpload *gpuUpload : _asyncUploads) {
+        vkFreeCommandBuffers(_gpuDevice->vkDevice, _transferCommandPool, 1, &gpuUpload->vkCommandBuffer);
+        vmaDestroyBuffer(_gpuDevice->memoryAllocator, gpuUpload->vkStagingBuffer, gpuUpload->vmaStagingAllocation);
+        CC_DELETE(gpuUpload);
+    }
+    _asyncUploads.clear();
+    if (_transferCommandPool) {
+        vkDestroyCommandPool(_gpuDevice->vkDevice, _transferCommandPool, nullptr);
+        _transferCommandPool = VK_NULL_HANDLE;
+    }
+    CC_SAFE_DESTROY(_transferQueue);
+    if (_queue && ((CCVKQueue *)_queue)->gpuQueue()->timelineSemaphore) {
+        vkDestroySemaphore(_gpuDevice->vkDevice, ((CCVKQueue *)_queue)->gpuQueue()->timelineSemaphore, nullptr);
+        ((CCVKQueue *)_queue)->gpuQueue()->timelineSemaphore = VK_NULL_HANDLE;
+    }
     CC_SAFE_DESTROY(_queue);
     CC_SAFE_DESTROY(_cmdBuff);
     CC_SAFE_DELETE(_gpuSwapchain);
-    CC_SAFE_DELETE(_gpuStagingBufferPool);
-    CC_SAFE_DELETE(_gpuCommandBufferPool);
-    CC_SAFE_DELETE(_gpuDescriptorSetPool);
-    CC_SAFE_DELETE(_gpuSemaphorePool);
+    for (uint i = 0u; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        CC_SAFE_DELETE(_gpuStagingBufferPools[i]);
+        CC_SAFE_DELETE(_gpuCommandBufferPools[i]);
+        CC_SAFE_DELETE(_gpuDescriptorSetPools[i]);
+        CC_SAFE_DELETE(_gpuSemaphorePools[i]);
+        CC_SAFE_DELETE(_gpuRecycleBins[i]);
+        CC_SAFE_DELETE(_gpuFencePools[i]);
+        _frameFences[i].clear();
+    }
     CC_SAFE_DELETE(_gpuDescriptorHub);
     CC_SAFE_DELETE(_gpuTransportHub);
-    CC_SAFE_DELETE(_gpuRecycleBin);
-    CC_SAFE_DELETE(_gpuFencePool);
 
     if (_gpuDevice) {
         if (_gpuDevice->vkPipelineCache) {
+            savePipelineCache();
             vkDestroyPipelineCache(_gpuDevice->vkDevice, _gpuDevice->vkPipelineCache, nullptr);
             _gpuDevice->vkPipelineCache = VK_NULL_HANDLE;
         }
@@ -450,16 +546,139 @@ void CCVKDevice::destroy() {
 }
 
 // op-op since we maintain surface size internally
+void CCVKDevice::createPipelineCache() {
+    const VkPhysicalDeviceProperties &properties = gpuContext()->physicalDeviceProperties;
+
+    VkPipelineCacheCreateInfo pipelineCacheInfo{VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
+    Data data;
+    String path = getPipelineCachePath();
+    if (FileUtils::getInstance()->isFileExist(path)) {
+        data = FileUtils::getInstance()->getDataFromFile(path);
+    }
+    if ((size_t)data.getSize() > sizeof(PipelineCacheFileHeader)) {
+        PipelineCacheFileHeader header;
+        memcpy(&header, data.getBytes(), sizeof(header));
+        if (isPipelineCacheCompatible(header, properties) && header.dataSize == data.getSize() - sizeof(header)) {
+            pipelineCacheInfo.initialDataSize = header.dataSize;
+            pipelineCacheInfo.pInitialData = data.getBytes() + sizeof(header);
+        } else {
+            CC_LOG_INFO("Vulkan pipeline cache is out of date, rebuilding.");
+        }
+    }
+
+    if (vkCreatePipelineCache(_gpuDevice->vkDevice, &pipelineCacheInfo, nullptr, &_gpuDevice->vkPipelineCache) != VK_SUCCESS &&
+        pipelineCacheInfo.initialDataSize) {
+        // the driver may still reject a blob that passed the header check
+        pipelineCacheInfo.initialDataSize = 0u;
+        pipelineCacheInfo.pInitialData = nullptr;
+        VK_CHECK(vkCreatePipelineCache(_gpuDevice->vkDevice, &pipelineCacheInfo, nullptr, &_gpuDevice->vkPipelineCache));
+    }
+}
+
+void CCVKDevice::savePipelineCache() {
+    if (!_gpuDevice || !_gpuDevice->vkPipelineCache) return;
+
+    size_t dataSize = 0u;
+    VK_CHECK(vkGetPipelineCacheData(_gpuDevice->vkDevice, _gpuDevice->vkPipelineCache, &dataSize, nullptr));
+    if (!dataSize) return;
+
+    const VkPhysicalDeviceProperties &properties = gpuContext()->physicalDeviceProperties;
+    PipelineCacheFileHeader header;
+    header.driverVersion = properties.driverVersion;
+    header.vendorID = properties.vendorID;
+    header.deviceID = properties.deviceID;
+    memcpy(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+    // released by Data through free()
+    auto *buffer = (uint8_t *)malloc(sizeof(header) + dataSize);
+    if (vkGetPipelineCacheData(_gpuDevice->vkDevice, _gpuDevice->vkPipelineCache, &dataSize, buffer + sizeof(header)) != VK_SUCCESS) {
+        free(buffer);
+        return;
+    }
+    header.dataSize = (uint)dataSize;
+    memcpy(buffer, &header, sizeof(header));
+
+    Data data;
+    data.fastSet(buffer, sizeof(header) + dataSize);
+    if (!FileUtils::getInstance()->writeDataToFile(data, getPipelineCachePath())) {
+        CC_LOG_WARNING("Failed to write the Vulkan pipeline cache.");
+    }
+}
+
 void CCVKDevice::resize(uint width, uint height) {}
 
+void CCVKDevice::flushPendingCommands() {
+    CCVKGPUQueue *gpuQueue = ((CCVKQueue *)_queue)->gpuQueue();
+    CCVKGPUCommandBuffer *gpuCommandBuffer = ((CCVKCommandBuffer *)_cmdBuff)->gpuCommandBuffer();
+    if (_gpuTransportHub->empty() && !gpuCommandBuffer->began) return;
+
+    gpuQueue->commandBuffers.clear();
+    _gpuTransportHub->depart();
+    if (gpuCommandBuffer->began) {
+        _cmdBuff->end();
+        gpuQueue->commandBuffers.push(gpuCommandBuffer->vkCommandBuffer);
+        gpuCommandBufferPool()->yield(gpuCommandBuffer);
+    }
+
+    VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    submitInfo.commandBufferCount = gpuQueue->commandBuffers.size();
+    submitInfo.pCommandBuffers = &gpuQueue->commandBuffers[0];
+
+    VkFence vkFence = VK_NULL_HANDLE;
+    VkTimelineSemaphoreSubmitInfo timelineInfo{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+    uint64_t signalValue = 0u;
+    if (gpuQueue->timelineSemaphore) {
+        signalValue = ++gpuQueue->timelineValue;
+        timelineInfo.signalSemaphoreValueCount = 1;
+        timelineInfo.pSignalSemaphoreValues = &signalValue;
+        submitInfo.pNext = &timelineInfo;
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &gpuQueue->timelineSemaphore;
+    } else {
+        vkFence = gpuFencePool()->alloc();
+        gpuQueue->fences.push_back(vkFence);
+    }
+    VK_CHECK(vkQueueSubmit(gpuQueue->vkQueue, 1, &submitInfo, vkFence));
+}
+
+void CCVKDevice::waitForFrame(uint frameIndex) {
+    if (_gpuDevice->useTimelineSemaphore) {
+        if (!_frameTimelineValues[frameIndex]) return;
+        VkSemaphoreWaitInfo waitInfo{VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO};
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &((CCVKQueue *)_queue)->gpuQueue()->timelineSemaphore;
+        waitInfo.pValues = &_frameTimelineValues[frameIndex];
+        VK_CHECK(vkWaitSemaphores(_gpuDevice->vkDevice, &waitInfo, DEFAULT_TIMEOUT));
+    } else {
+        vector<VkFence> &fences = _frameFences[frameIndex];
+        if (fences.empty()) return;
+        VK_CHECK(vkWaitForFences(_gpuDevice->vkDevice, fences.size(), fences.data(), VK_TRUE, DEFAULT_TIMEOUT));
+        fences.clear();
+    }
+}
+
 void CCVKDevice::acquire() {
     CCVKQueue *queue = (CCVKQueue *)_queue;
 
-    if (!queue->gpuQueue()->fences.empty()) {
-        VK_CHECK(vkWaitForFences(_gpuDevice->vkDevice, queue->gpuQueue()->fences.size(),
-                                 queue->gpuQueue()->fences.data(), VK_TRUE, DEFAULT_TIMEOUT));
-        queue->gpuQueue()->fences.clear();
-    }
+    // close the frame recorded so far, the commands recorded before acquire belong to it as well
+    flushPendingCommands();
+    _frameFences[_frameIndex].swap(queue->gpuQueue()->fences);
+    queue->gpuQueue()->fences.clear();
+    _frameTimelineValues[_frameIndex] = queue->gpuQueue()->timelineValue;
+
+    // only wait for the frame that last used the pools of the next one,
+    // the frames in between keep running on the GPU
+    _frameIndex = (_frameIndex + 1) % MAX_FRAMES_IN_FLIGHT;
+    waitForFrame(_frameIndex);
+
+    gpuFencePool()->reset();
+    gpuRecycleBin()->clear();
+    gpuCommandBufferPool()->reset();
+    gpuStagingBufferPool()->reset();
+    gpuDescriptorSetPool()->reset();
+    gpuSemaphorePool()->reset();
+    vmaSetCurrentFrameIndex(_gpuDevice->memoryAllocator, _frameIndex);
+    _gpuTransportHub->link(queue->gpuQueue(), gpuFencePool(), gpuCommandBufferPool(), gpuStagingBufferPool());
 
     if (!checkSwapchainStatus()) return;
 
@@ -469,22 +688,76 @@ void CCVKDevice::acquire() {
     queue->gpuQueue()->nextWaitSemaphore = VK_NULL_HANDLE;
     queue->gpuQueue()->nextSignalSemaphore = VK_NULL_HANDLE;
 
-    // reset everything only when no pending commands
-    if (_gpuTransportHub->empty() && !((CCVKCommandBuffer *)_cmdBuff)->gpuCommandBuffer()->began) {
-        _gpuFencePool->reset();
-        _gpuRecycleBin->clear();
-        _gpuDescriptorSetPool->reset();
-        _gpuCommandBufferPool->reset();
-        _gpuStagingBufferPool->reset();
-    }
-
-    _gpuSemaphorePool->reset();
-    VkSemaphore acquireSemaphore = _gpuSemaphorePool->alloc();
+    VkSemaphore acquireSemaphore = gpuSemaphorePool()->alloc();
     VK_CHECK(vkAcquireNextImageKHR(_gpuDevice->vkDevice, _gpuSwapchain->vkSwapchain, ~0ull,
                                    acquireSemaphore, VK_NULL_HANDLE, &_gpuSwapchain->curImageIndex));
 
     queue->gpuQueue()->nextWaitSemaphore = acquireSemaphore;
-    queue->gpuQueue()->nextSignalSemaphore = _gpuSemaphorePool->alloc();
+    queue->gpuQueue()->nextSignalSemaphore = gpuSemaphorePool()->alloc();
+}
+
+MemoryHeapBudgetList CCVKDevice::getMemoryBudgets() {
+    const VkPhysicalDeviceMemoryProperties *memoryProperties = nullptr;
+    vmaGetMemoryProperties(_gpuDevice->memoryAllocator, &memoryProperties);
+    VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+    vmaGetBudget(_gpuDevice->memoryAllocator, budgets);
+
+    MemoryHeapBudgetList heapBudgets(memoryProperties->memoryHeapCount);
+    for (uint i = 0u; i < memoryProperties->memoryHeapCount; ++i) {
+        heapBudgets[i].budget = budgets[i].budget;
+        heapBudgets[i].usage = budgets[i].usage;
+        heapBudgets[i].isDeviceLocal = memoryProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+    }
+    return heapBudgets;
+}
+
+uint64_t CCVKDevice::defragmentMemory(uint64_t maxBytesToMove) {
+    // the buffer updates recorded so far still refer to the buffers that may move
+    flushPendingCommands();
+
+    vector<CCVKGPUBuffer *> gpuBuffers;
+    vector<VmaAllocation> allocations;
+    for (CCVKGPUBuffer *gpuBuffer : _defragmentableBuffers) {
+        if (!gpuBuffer->vmaAllocation) continue;
+        gpuBuffers.push_back(gpuBuffer);
+        allocations.push_back(gpuBuffer->vmaAllocation);
+    }
+    if (allocations.empty()) return 0u;
+    vector<VkBool32> allocationsChanged(allocations.size(), VK_FALSE);
+
+    // images can't be moved by the GPU, the buffers are copied with the transport hub
+    VmaDefragmentationInfo2 defragInfo{};
+    defragInfo.allocationCount = toUint(allocations.size());
+    defragInfo.pAllocations = allocations.data();
+    defragInfo.pAllocationsChanged = allocationsChanged.data();
+    defragInfo.maxGpuBytesToMove = maxBytesToMove;
+    defragInfo.maxGpuAllocationsToMove = UINT32_MAX;
+
+    VmaDefragmentationStats stats{};
+    VmaDefragmentationContext defragContext = VK_NULL_HANDLE;
+    _gpuTransportHub->checkIn(
+        [&](const CCVKGPUCommandBuffer *gpuCommandBuffer) {
+            defragInfo.commandBuffer = gpuCommandBuffer->vkCommandBuffer;
+            vmaDefragmentationBegin(_gpuDevice->memoryAllocator, &defragInfo, &stats, &defragContext);
+
+            VkMemoryBarrier barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+            vkCmdPipelineBarrier(gpuCommandBuffer->vkCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                 0, 1, &barrier, 0, nullptr, 0, nullptr);
+        },
+        true);
+    if (defragContext) {
+        vmaDefragmentationEnd(_gpuDevice->memoryAllocator, defragContext);
+    }
+
+    // the submission waited for covers every frame submitted before, the old buffers are idle
+    for (size_t i = 0u; i < gpuBuffers.size(); ++i) {
+        if (allocationsChanged[i]) {
+            CCVKCmdFuncRebindBuffer(this, gpuBuffers[i]);
+        }
+    }
+    return stats.bytesMoved;
 }
 
 void CCVKDevice::present() {
@@ -535,6 +808,15 @@ Queue *CCVKDevice::createQueue(const QueueInfo &info) {
     return nullptr;
 }
 
+QueryPool *CCVKDevice::createQueryPool(const QueryPoolInfo &info) {
+    QueryPool *queryPool = CC_NEW(CCVKQueryPool(this));
+    if (queryPool->initialize(info))
+        return queryPool;
+
+    CC_SAFE_DESTROY(queryPool);
+    return nullptr;
+}
+
 Buffer *CCVKDevice::createBuffer(const BufferInfo &info) {
     Buffer *buffer = CC_NEW(CCVKBuffer(this));
     if (buffer->initialize(info))
@@ -581,6 +863,9 @@ Sampler *CCVKDevice::createSampler(const SamplerInfo &info) {
 }
 
 Shader *CCVKDevice::createShader(const ShaderInfo &info) {
+    Shader *prewarmed = takePrewarmedShader(info);
+    if (prewarmed) return prewarmed;
+
     Shader *shader = CC_NEW(CCVKShader(this));
     if (shader->initialize(info))
         return shader;
@@ -663,6 +948,69 @@ void CCVKDevice::copyBuffersToTexture(const uint8_t *const *buffers, Texture *ds
     CCVKCmdFuncCopyBuffersToTexture(this, buffers, ((CCVKTexture *)dst)->gpuTexture(), regions, count, gpuCommandBuffer);
 }
 
+void CCVKDevice::copyBuffersToTextureAsync(const uint8_t *const *buffers, Texture *dst, const BufferTextureCopy *regions, uint count, Fence *fence) {
+    CCVKGPUTexture *gpuTexture = ((CCVKTexture *)dst)->gpuTexture();
+    CCVKGPUQueue *transferQueue = gpuTransferQueue();
+    VkFence vkFence = ((CCVKFence *)fence)->gpuFence()->vkFence;
+
+    // the fence may still be held by an upload finished since the last submission
+    collectAsyncUploads();
+    fence->reset();
+
+    // mip chains are blitted by the graphics queue
+    if (gpuTexture->flags & TextureFlags::GEN_MIPMAP) {
+        copyBuffersToTexture(buffers, dst, regions, count);
+        VK_CHECK(vkQueueSubmit(transferQueue->vkQueue, 0, nullptr, vkFence));
+        return;
+    }
+
+    CCVKGPUAsyncUpload *gpuUpload = CC_NEW(CCVKGPUAsyncUpload);
+    VkCommandBufferAllocateInfo allocateInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+    allocateInfo.commandPool = _transferCommandPool;
+    allocateInfo.commandBufferCount = 1;
+    allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    VK_CHECK(vkAllocateCommandBuffers(_gpuDevice->vkDevice, &allocateInfo, &gpuUpload->vkCommandBuffer));
+
+    VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    VK_CHECK(vkBeginCommandBuffer(gpuUpload->vkCommandBuffer, &beginInfo));
+    CCVKCmdFuncUploadBuffersToTexture(this, buffers, gpuTexture, regions, count, ((CCVKQueue *)_queue)->gpuQueue()->queueFamilyIndex, gpuUpload);
+    VK_CHECK(vkEndCommandBuffer(gpuUpload->vkCommandBuffer));
+
+    VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &gpuUpload->vkCommandBuffer;
+    VK_CHECK(vkQueueSubmit(transferQueue->vkQueue, 1, &submitInfo, vkFence));
+    gpuUpload->vkFence = vkFence;
+    _asyncUploads.push_back(gpuUpload);
+}
+
+CCVKGPUQueue *CCVKDevice::gpuTransferQueue() const {
+    return ((CCVKQueue *)_transferQueue)->gpuQueue();
+}
+
+void CCVKDevice::collectAsyncUploads() {
+    for (size_t i = 0u; i < _asyncUploads.size();) {
+        CCVKGPUAsyncUpload *gpuUpload = _asyncUploads[i];
+        if (vkGetFenceStatus(_gpuDevice->vkDevice, gpuUpload->vkFence) != VK_SUCCESS) {
+            ++i;
+            continue;
+        }
+
+        // recorded ahead of the command buffers of this submission, so before any use of the texture
+        if (gpuUpload->needsAcquire) {
+            _gpuTransportHub->checkIn([gpuUpload](const CCVKGPUCommandBuffer *cmdBuff) {
+                CCVKCmdFuncAcquireUploadedTexture(gpuUpload, cmdBuff);
+            });
+        }
+        vkFreeCommandBuffers(_gpuDevice->vkDevice, _transferCommandPool, 1, &gpuUpload->vkCommandBuffer);
+        vmaDestroyBuffer(_gpuDevice->memoryAllocator, gpuUpload->vkStagingBuffer, gpuUpload->vmaStagingAllocation);
+        CC_DELETE(gpuUpload);
+        _asyncUploads[i] = _asyncUploads.back();
+        _asyncUploads.pop_back();
+    }
+}
+
 bool CCVKDevice::checkSwapchainStatus() {
     CCVKGPUContext *context = ((CCVKContext *)_context)->gpuContext();
 
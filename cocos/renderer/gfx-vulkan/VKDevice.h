@@ -5,11 +5,14 @@ namespace cc {
 namespace gfx {
 
 class CCVKBuffer;
+class CCVKGPUBuffer;
 class CCVKTexture;
 class CCVKRenderPass;
 
 class CCVKGPUDevice;
+class CCVKGPUQueue;
 class CCVKGPUContext;
+class CCVKGPUAsyncUpload;
 class CCVKGPUSwapchain;
 
 class CCVKGPUFencePool;
@@ -23,6 +26,10 @@ class CCVKGPUStagingBufferPool;
 
 class CC_VULKAN_API CCVKDevice : public Device {
 public:
+    // the CPU records a frame while the GPU is still busy with the ones before, every resource
+    // a frame submits with is only reset or destroyed once the frame is done on the GPU
+    static constexpr uint MAX_FRAMES_IN_FLIGHT = 2;
+
     CCVKDevice();
     ~CCVKDevice();
 
@@ -36,6 +43,7 @@ public:
     virtual CommandBuffer *createCommandBuffer(const CommandBufferInfo &info) override;
     virtual Fence *createFence(const FenceInfo &info) override;
     virtual Queue *createQueue(const QueueInfo &info) override;
+    virtual QueryPool *createQueryPool(const QueryPoolInfo &info) override;
     virtual Buffer *createBuffer(const BufferInfo &info) override;
     virtual Buffer *createBuffer(const BufferViewInfo &info) override;
     virtual Texture *createTexture(const TextureInfo &info) override;
@@ -50,6 +58,9 @@ public:
     virtual PipelineLayout *createPipelineLayout(const PipelineLayoutInfo &info) override;
     virtual PipelineState *createPipelineState(const PipelineStateInfo &info) override;
     virtual void copyBuffersToTexture(const uint8_t *const *buffers, Texture *dst, const BufferTextureCopy *regions, uint count) override;
+    virtual void copyBuffersToTextureAsync(const uint8_t *const *buffers, Texture *dst, const BufferTextureCopy *regions, uint count, Fence *fence) override;
+    virtual MemoryHeapBudgetList getMemoryBudgets() override;
+    virtual uint64_t defragmentMemory(uint64_t maxBytesToMove) override;
 
     CC_INLINE bool checkExtension(const String &extension) const {
         return std::find_if(_extensions.begin(), _extensions.end(),
@@ -62,31 +73,61 @@ public:
     CC_INLINE CCVKGPUDevice *gpuDevice() const { return _gpuDevice; }
     CC_INLINE CCVKGPUSwapchain *gpuSwapchain() { return _gpuSwapchain; }
 
-    CC_INLINE CCVKGPUFencePool *gpuFencePool() { return _gpuFencePool; }
-    CC_INLINE CCVKGPURecycleBin *gpuRecycleBin() { return _gpuRecycleBin; }
+    // the pools of the frame being recorded
+    CC_INLINE uint frameIndex() const { return _frameIndex; }
+    CC_INLINE CCVKGPUFencePool *gpuFencePool() { return _gpuFencePools[_frameIndex]; }
+    CC_INLINE CCVKGPURecycleBin *gpuRecycleBin() { return _gpuRecycleBins[_frameIndex]; }
     CC_INLINE CCVKGPUTransportHub *gpuTransportHub() { return _gpuTransportHub; }
     CC_INLINE CCVKGPUDescriptorHub *gpuDescriptorHub() { return _gpuDescriptorHub; }
-    CC_INLINE CCVKGPUSemaphorePool *gpuSemaphorePool() { return _gpuSemaphorePool; }
-    CC_INLINE CCVKGPUDescriptorSetPool *gpuDescriptorSetPool() { return _gpuDescriptorSetPool; }
-    CC_INLINE CCVKGPUCommandBufferPool *gpuCommandBufferPool() { return _gpuCommandBufferPool; }
-    CC_INLINE CCVKGPUStagingBufferPool *gpuStagingBufferPool() { return _gpuStagingBufferPool; }
+    CC_INLINE CCVKGPUSemaphorePool *gpuSemaphorePool() { return _gpuSemaphorePools[_frameIndex]; }
+    CC_INLINE CCVKGPUDescriptorSetPool *gpuDescriptorSetPool() { return _gpuDescriptorSetPools[_frameIndex]; }
+    CC_INLINE CCVKGPUCommandBufferPool *gpuCommandBufferPool() { return _gpuCommandBufferPools[_frameIndex]; }
+    CC_INLINE CCVKGPUStagingBufferPool *gpuStagingBufferPool() { return _gpuStagingBufferPools[_frameIndex]; }
+    CCVKGPUQueue *gpuTransferQueue() const;
+
+    // the device local buffers defragmentMemory() may move
+    CC_INLINE void trackBuffer(CCVKGPUBuffer *gpuBuffer) { _defragmentableBuffers.insert(gpuBuffer); }
+    CC_INLINE void untrackBuffer(CCVKGPUBuffer *gpuBuffer) { _defragmentableBuffers.erase(gpuBuffer); }
+
+    // Releases the async uploads whose fences are signaled, the graphics queue calls it before every submission
+    // to acquire the textures uploaded by another queue family before they are used.
+    void collectAsyncUploads();
+
+    // Writes the pipeline cache to the writable path, also done on destroy.
+    // The cache is internally synchronized, pipelines may be created from any thread.
+    void savePipelineCache();
 
 private:
     void destroySwapchain();
     bool checkSwapchainStatus();
+    void createPipelineCache();
+    // submits the commands recorded outside of any queue submission, as part of the frame being recorded
+    void flushPendingCommands();
+    void waitForFrame(uint frameIndex);
 
     CCVKGPUDevice *_gpuDevice = nullptr;
     CCVKGPUSwapchain *_gpuSwapchain = nullptr;
     vector<CCVKTexture *> _depthStencilTextures;
 
-    CCVKGPUFencePool *_gpuFencePool = nullptr;
-    CCVKGPURecycleBin *_gpuRecycleBin = nullptr;
     CCVKGPUTransportHub *_gpuTransportHub = nullptr;
     CCVKGPUDescriptorHub *_gpuDescriptorHub = nullptr;
-    CCVKGPUSemaphorePool *_gpuSemaphorePool = nullptr;
-    CCVKGPUDescriptorSetPool *_gpuDescriptorSetPool = nullptr;
-    CCVKGPUCommandBufferPool *_gpuCommandBufferPool = nullptr;
-    CCVKGPUStagingBufferPool *_gpuStagingBufferPool = nullptr;
+
+    uint _frameIndex = 0u;
+    CCVKGPUFencePool *_gpuFencePools[MAX_FRAMES_IN_FLIGHT] = {nullptr};
+    CCVKGPURecycleBin *_gpuRecycleBins[MAX_FRAMES_IN_FLIGHT] = {nullptr};
+    CCVKGPUSemaphorePool *_gpuSemaphorePools[MAX_FRAMES_IN_FLIGHT] = {nullptr};
+    CCVKGPUDescriptorSetPool *_gpuDescriptorSetPools[MAX_FRAMES_IN_FLIGHT] = {nullptr};
+    CCVKGPUCommandBufferPool *_gpuCommandBufferPools[MAX_FRAMES_IN_FLIGHT] = {nullptr};
+    CCVKGPUStagingBufferPool *_gpuStagingBufferPools[MAX_FRAMES_IN_FLIGHT] = {nullptr};
+    // what the submissions of each frame signal, the fences or the value of the queue timeline semaphore
+    vector<VkFence> _frameFences[MAX_FRAMES_IN_FLIGHT];
+    uint64_t _frameTimelineValues[MAX_FRAMES_IN_FLIGHT] = {0u};
+
+    Queue *_transferQueue = nullptr;
+    VkCommandPool _transferCommandPool = VK_NULL_HANDLE;
+    vector<CCVKGPUAsyncUpload *> _asyncUploads;
+    set<CCVKGPUBuffer *> _defragmentableBuffers;
+    uint32_t _memoryPressureHandlerID = 0;
 
     vector<const char *> _layers;
     vector<const char *> _extensions;
@@ -42,5 +42,9 @@ void CCVKFence::reset() {
     VK_CHECK(vkResetFences(((CCVKDevice *)_device)->gpuDevice()->vkDevice, 1, &_gpuFence->vkFence));
 }
 
+bool CCVKFence::isSignaled() {
+    return vkGetFenceStatus(((CCVKDevice *)_device)->gpuDevice()->vkDevice, _gpuFence->vkFence) == VK_SUCCESS;
+}
+
 } // namespace gfx
 } // namespace cc
@@ -3,6 +3,8 @@
 
 #include "VKUtils.h"
 
+#include <mutex>
+
 namespace cc {
 namespace gfx {
 
@@ -34,6 +36,8 @@ public:
     SubPassInfoList subPasses;
     VkRenderPass vkRenderPass;
     vector<VkClearValue> clearValues;
+    // above 1 the attachments are transient multisampled ones resolved into the framebuffer textures
+    uint sampleCount = 1u;
 };
 
 class CCVKGPUTexture : public Object {
@@ -50,6 +54,7 @@ public:
     SampleCount samples = SampleCount::X1;
     TextureFlags flags = TextureFlagBit::NONE;
     bool isPowerOf2 = false;
+    bool memoryless = false; // transient attachment backed by lazily allocated memory
 
     VkImage vkImage = VK_NULL_HANDLE;
     VmaAllocation vmaAllocation = VK_NULL_HANDLE;
@@ -132,6 +137,8 @@ public:
     CCVKGPURenderPass *gpuRenderPass = nullptr;
     CCVKGPUTextureViewList gpuColorViews;
     CCVKGPUTextureView *gpuDepthStencilView = nullptr;
+    // the transient attachments of a multisampled render pass, owned by the framebuffer
+    CCVKGPUTextureViewList gpuMultisampleViews;
     VkFramebuffer vkFramebuffer = VK_NULL_HANDLE;
     CCVKGPUSwapchain *swapchain = nullptr;
     bool isOffscreen = true;
@@ -153,12 +160,29 @@ public:
     vector<VkImageView> depthStencilImageViews;
 };
 
+struct CCVKGPUBufferCopy {
+    VkBuffer srcBuffer = VK_NULL_HANDLE;
+    VkBuffer dstBuffer = VK_NULL_HANDLE;
+    vector<VkBufferCopy> regions;
+};
+
 class CCVKGPUCommandBuffer : public Object {
 public:
     VkCommandBuffer vkCommandBuffer = VK_NULL_HANDLE;
     VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
     uint queueFamilyIndex = 0u;
     bool began = false;
+    // secondary command buffers own their pool so they can be recorded on any thread,
+    // with one command buffer per frame in flight, vkCommandBuffer is the one of the current frame
+    VkCommandPool vkCommandPool = VK_NULL_HANDLE;
+    vector<VkCommandBuffer> frameCommandBuffers;
+
+    // buffer updates batched until anything that may read them is recorded, one copy per destination
+    vector<CCVKGPUBufferCopy> pendingCopies;
+    unordered_map<VkBuffer, uint> pendingCopyIndices;
+    uint pendingCopyCount = 0u;
+    VkPipelineStageFlags pendingCopyStages = 0u;
+    VkAccessFlags pendingCopyAccesses = 0u;
 };
 
 class CCVKGPUQueue : public Object {
@@ -170,7 +194,11 @@ public:
     VkSemaphore nextSignalSemaphore = VK_NULL_HANDLE;
     VkPipelineStageFlags submitStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
     CachedArray<VkCommandBuffer> commandBuffers;
+    // the fences of the submissions of the frame being recorded, handed over to its frame on acquire
     vector<VkFence> fences;
+    // signaled with an increasing value by every submission instead, when supported
+    VkSemaphore timelineSemaphore = VK_NULL_HANDLE;
+    uint64_t timelineValue = 0u;
 };
 
 struct CCVKGPUShaderStage {
@@ -221,6 +249,13 @@ public:
 
     vector<CCVKDescriptorInfo> descriptorInfos;
     vector<VkWriteDescriptorSet> descriptorUpdateEntries;
+
+    // the last VkDescriptorSet written with these descriptors, reused by later binds within the same frame
+    VkDescriptorSet vkDescriptorSet = VK_NULL_HANDLE;
+    VkDescriptorSetLayout vkDescriptorSetLayout = VK_NULL_HANDLE;
+    const void *allocatedPool = nullptr;
+    uint allocatedGeneration = 0u;
+    vector<CCVKDescriptorInfo> writtenInfos;
 };
 
 class CCVKGPUDescriptorSetLayout : public Object {
@@ -230,6 +265,7 @@ public:
 
     vector<VkDescriptorSetLayoutBinding> vkBindings;
     VkDescriptorSetLayout vkDescriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorUpdateTemplate vkDescriptorUpdateTemplate = VK_NULL_HANDLE;
 
     vector<uint> bindingIndices;
     vector<uint> descriptorIndices;
@@ -242,7 +278,6 @@ public:
     CCVKGPUDescriptorSetLayoutList setLayouts;
 
     VkPipelineLayout vkPipelineLayout = VK_NULL_HANDLE;
-    vector<VkDescriptorUpdateTemplate> vkDescriptorUpdateTemplates;
 
     // helper storage
     vector<VkDescriptorSetLayout> descriptorSetLayouts;
@@ -263,6 +298,7 @@ public:
     BlendState bs;
     DynamicStateList dynamicStates;
     CCVKGPURenderPass *gpuRenderPass = nullptr;
+    uint subpass = 0u;
     VkPipeline vkPipeline = VK_NULL_HANDLE;
 };
 
@@ -271,6 +307,26 @@ public:
     VkFence vkFence;
 };
 
+// A texture upload submitted to the transfer queue, its resources are released once the fence is signaled.
+class CCVKGPUAsyncUpload : public Object {
+public:
+    VkCommandBuffer vkCommandBuffer = VK_NULL_HANDLE;
+    VkBuffer vkStagingBuffer = VK_NULL_HANDLE;
+    VmaAllocation vmaStagingAllocation = VK_NULL_HANDLE;
+    VkFence vkFence = VK_NULL_HANDLE;
+    // ownership transfer to the graphics family, when uploaded from another one
+    bool needsAcquire = false;
+    VkImageMemoryBarrier acquireBarrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+    VkPipelineStageFlags acquireStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+};
+
+class CCVKGPUQueryPool : public Object {
+public:
+    QueryType type = QueryType::TIMESTAMP;
+    uint maxQueryObjects = 0u;
+    VkQueryPool vkPool = VK_NULL_HANDLE;
+};
+
 class CCVKGPUDevice : public Object {
 public:
     VkDevice vkDevice = VK_NULL_HANDLE;
@@ -281,6 +337,7 @@ public:
 
     bool useDescriptorUpdateTemplate = false;
     bool useMultiDrawIndirect = false;
+    bool useTimelineSemaphore = false;
 
     CCVKGPUSampler defaultSampler;
     CCVKGPUTexture defaultTexture;
@@ -420,6 +477,7 @@ public:
                 {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 128},
                 {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 128},
                 {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 128},
+                {VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 128},
             };
 
             VkDescriptorPoolCreateInfo createInfo{VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
@@ -438,6 +496,11 @@ public:
         _counts[idx] += count;
     }
 
+    // guards allocations and descriptor updates issued by secondary command buffers on worker threads
+    CC_INLINE std::mutex &mutex() { return _mutex; }
+    // bumped on every reset, sets allocated under a previous generation are no longer valid
+    CC_INLINE uint generation() const { return _generation; }
+
     void reset() {
         size_t size = _pools.size();
         for (uint i = 0u; i < size; i++) {
@@ -446,12 +509,15 @@ public:
                 _counts[i] = 0;
             }
         }
+        ++_generation;
     }
 
 private:
     CCVKGPUDevice *_device;
     vector<VkDescriptorPool> _pools;
     vector<uint> _counts;
+    uint _generation = 0u;
+    std::mutex _mutex;
 };
 
 /**
@@ -556,7 +622,7 @@ public:
         for (size_t idx = 0u; idx < bufferCount; idx++) {
             Buffer *cur = &_pool[idx];
             offset = roundUp(cur->curOffset, alignment);
-            if (chunkSize - offset >= gpuBuffer->size) {
+            if (cur->size >= offset && cur->size - offset >= gpuBuffer->size) {
                 buffer = cur;
                 break;
             }
@@ -564,8 +630,10 @@ public:
         if (!buffer) {
             _pool.resize(bufferCount + 1);
             buffer = &_pool.back();
+            // uploads larger than a block get one of their own, reused like the others
+            buffer->size = std::max(chunkSize, (size_t)gpuBuffer->size);
             VkBufferCreateInfo bufferInfo{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
-            bufferInfo.size = chunkSize;
+            bufferInfo.size = buffer->size;
             bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
             VmaAllocationCreateInfo allocInfo{};
             allocInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
@@ -593,6 +661,7 @@ private:
         uint8_t *mappedData = nullptr;
         VmaAllocation vmaAllocation = VK_NULL_HANDLE;
 
+        VkDeviceSize size = 0u;
         VkDeviceSize curOffset = 0u;
     };
 
@@ -622,6 +691,16 @@ public:
     DEFINE_DESCRIPTOR_HUB_FN(update)
     DEFINE_DESCRIPTOR_HUB_FN(disengage)
 
+    // updates the descriptors of every view of the buffer
+    void update(const CCVKGPUBuffer *buffer) {
+        for (auto &it : _buffers) {
+            if (it.first->gpuBuffer != buffer) continue;
+            for (uint i = 0u; i < it.second.size(); i++) {
+                _doUpdate(it.first, it.second[i]);
+            }
+        }
+    }
+
 private:
     template <typename M, typename K, typename V>
     void connect(M &map, const K *name, V *descriptor) {
@@ -680,8 +759,8 @@ private:
 }; // namespace gfx
 
 /**
- * Recycle bin for GPU resources, clears after vkDeviceWaitIdle every frame.
- * All the destroy events will be postponed to that time.
+ * Recycle bin for GPU resources, one per frame in flight.
+ * All the destroy events will be postponed to the time the frame they happened in is done on the GPU.
  */
 class CCVKGPURecycleBin : public Object {
 public:
@@ -710,6 +789,7 @@ public:
     DEFINE_RECYCLE_BIN_COLLECT_FN(CCVKGPUPipelineLayout, RecycledType::PIPELINE_LAYOUT, res.gpuPipelineLayout = gpuRes)
     DEFINE_RECYCLE_BIN_COLLECT_FN(CCVKGPUPipelineState, RecycledType::PIPELINE_STATE, res.gpuPipelineState = gpuRes)
     DEFINE_RECYCLE_BIN_COLLECT_FN(CCVKGPUFence, RecycledType::FENCE, res.gpuFence = gpuRes)
+    DEFINE_RECYCLE_BIN_COLLECT_FN(CCVKGPUQueryPool, RecycledType::QUERY_POOL, res.gpuQueryPool = gpuRes)
 
     void clear();
 
@@ -727,6 +807,7 @@ private:
         PIPELINE_LAYOUT,
         PIPELINE_STATE,
         FENCE,
+        QUERY_POOL,
     };
     struct Buffer {
         VkBuffer vkBuffer;
@@ -754,6 +835,7 @@ private:
             CCVKGPUPipelineLayout *gpuPipelineLayout;
             CCVKGPUPipelineState *gpuPipelineState;
             CCVKGPUFence *gpuFence;
+            CCVKGPUQueryPool *gpuQueryPool;
         };
     };
     CCVKGPUDevice *_device = nullptr;
@@ -813,6 +895,9 @@ public:
             VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
             beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
             VK_CHECK(vkBeginCommandBuffer(_cmdBuff.vkCommandBuffer, &beginInfo));
+            // the frames still in flight may read what is about to be overwritten
+            vkCmdPipelineBarrier(_cmdBuff.vkCommandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 0, 0, nullptr, 0, nullptr, 0, nullptr);
         }
 
         record(&_cmdBuff);
@@ -831,6 +916,11 @@ public:
 
     void depart() {
         if (_cmdBuff.vkCommandBuffer) {
+            VkMemoryBarrier barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+            vkCmdPipelineBarrier(_cmdBuff.vkCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                 0, 1, &barrier, 0, nullptr, 0, nullptr);
             VK_CHECK(vkEndCommandBuffer(_cmdBuff.vkCommandBuffer));
             _queue->commandBuffers.push(_cmdBuff.vkCommandBuffer);
             _commandBufferPool->yield(&_cmdBuff);
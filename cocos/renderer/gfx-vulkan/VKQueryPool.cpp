@@ -0,0 +1,62 @@
+#include "VKStd.h"
+
+#include "VKCommands.h"
+#include "VKDevice.h"
+#include "VKQueryPool.h"
+
+namespace cc {
+namespace gfx {
+
+CCVKQueryPool::CCVKQueryPool(Device *device)
+: QueryPool(device) {
+}
+
+CCVKQueryPool::~CCVKQueryPool() {
+}
+
+bool CCVKQueryPool::initialize(const QueryPoolInfo &info) {
+    _type = info.type;
+    _maxQueryObjects = info.maxQueryObjects;
+
+    if (_type == QueryType::TIMESTAMP && !_device->hasFeature(Feature::TIMESTAMP_QUERY)) {
+        CC_LOG_ERROR("CCVKQueryPool: timestamp queries are not supported on this device.");
+        return false;
+    }
+
+    _gpuQueryPool = CC_NEW(CCVKGPUQueryPool);
+    if (!_gpuQueryPool) {
+        CC_LOG_ERROR("CCVKQueryPool: CC_NEW CCVKGPUQueryPool failed.");
+        return false;
+    }
+    _gpuQueryPool->type = _type;
+    _gpuQueryPool->maxQueryObjects = _maxQueryObjects;
+
+    CCVKCmdFuncCreateQueryPool((CCVKDevice *)_device, _gpuQueryPool);
+
+    return true;
+}
+
+void CCVKQueryPool::destroy() {
+    if (_gpuQueryPool) {
+        ((CCVKDevice *)_device)->gpuRecycleBin()->collect(_gpuQueryPool);
+        _gpuQueryPool = nullptr;
+    }
+}
+
+bool CCVKQueryPool::getResults(uint first, uint count, uint64_t *results) {
+    CCVKDevice *device = (CCVKDevice *)_device;
+    VkResult res = vkGetQueryPoolResults(device->gpuDevice()->vkDevice, _gpuQueryPool->vkPool, first, count,
+                                         count * sizeof(uint64_t), results, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+    if (res != VK_SUCCESS) return false;
+
+    if (_type == QueryType::TIMESTAMP) {
+        double period = device->gpuContext()->physicalDeviceProperties.limits.timestampPeriod;
+        for (uint i = 0u; i < count; ++i) {
+            results[i] = static_cast<uint64_t>(results[i] * period);
+        }
+    }
+    return true;
+}
+
+} // namespace gfx
+} // namespace cc
@@ -0,0 +1,28 @@
+#ifndef CC_GFXVULKAN_QUERY_POOL_H_
+#define CC_GFXVULKAN_QUERY_POOL_H_
+
+namespace cc {
+namespace gfx {
+
+class CCVKGPUQueryPool;
+
+class CC_VULKAN_API CCVKQueryPool : public QueryPool {
+public:
+    CCVKQueryPool(Device *device);
+    virtual ~CCVKQueryPool() override;
+
+public:
+    virtual bool initialize(const QueryPoolInfo &info) override;
+    virtual void destroy() override;
+    virtual bool getResults(uint first, uint count, uint64_t *results) override;
+
+    CC_INLINE CCVKGPUQueryPool *gpuQueryPool() { return _gpuQueryPool; }
+
+private:
+    CCVKGPUQueryPool *_gpuQueryPool = nullptr;
+};
+
+} // namespace gfx
+} // namespace cc
+
+#endif
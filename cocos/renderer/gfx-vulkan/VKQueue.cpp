@@ -38,6 +38,7 @@ void CCVKQueue::destroy() {
 void CCVKQueue::submit(const CommandBuffer *const *cmdBuffs, uint count, Fence *fence) {
     CCVKDevice *device = (CCVKDevice *)_device;
     _gpuQueue->commandBuffers.clear();
+    device->collectAsyncUploads();
     device->gpuTransportHub()->depart();
 
     for (uint i = 0u; i < count; ++i) {
@@ -46,9 +47,8 @@ void CCVKQueue::submit(const CommandBuffer *const *cmdBuffs, uint count, Fence *
         _numDrawCalls += cmdBuffer->_numDrawCalls;
         _numInstances += cmdBuffer->_numInstances;
         _numTriangles += cmdBuffer->_numTriangles;
-        // prepare the next command buffer to use
+        // the next begin requests a command buffer from the pool of the frame it is recorded in
         device->gpuCommandBufferPool()->yield(cmdBuffer->_gpuCommandBuffer);
-        device->gpuCommandBufferPool()->request(cmdBuffer->_gpuCommandBuffer);
     }
 
     VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
@@ -57,13 +57,32 @@ void CCVKQueue::submit(const CommandBuffer *const *cmdBuffs, uint count, Fence *
     submitInfo.pWaitDstStageMask = &_gpuQueue->submitStageMask;
     submitInfo.commandBufferCount = _gpuQueue->commandBuffers.size();
     submitInfo.pCommandBuffers = &_gpuQueue->commandBuffers[0];
-    submitInfo.signalSemaphoreCount = _gpuQueue->nextSignalSemaphore ? 1 : 0;
-    submitInfo.pSignalSemaphores = &_gpuQueue->nextSignalSemaphore;
 
-    VkFence vkFence = fence ? ((CCVKFence *)fence)->gpuFence()->vkFence : device->gpuFencePool()->alloc();
+    VkSemaphore signalSemaphores[2];
+    uint64_t signalValues[2] = {0u, 0u};
+    uint signalSemaphoreCount = 0u;
+    if (_gpuQueue->nextSignalSemaphore) {
+        signalSemaphores[signalSemaphoreCount++] = _gpuQueue->nextSignalSemaphore;
+    }
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+    VkFence vkFence = fence ? ((CCVKFence *)fence)->gpuFence()->vkFence : VK_NULL_HANDLE;
+    if (_gpuQueue->timelineSemaphore) {
+        // binary semaphores ignore their values
+        signalValues[signalSemaphoreCount] = ++_gpuQueue->timelineValue;
+        signalSemaphores[signalSemaphoreCount++] = _gpuQueue->timelineSemaphore;
+        timelineInfo.signalSemaphoreValueCount = signalSemaphoreCount;
+        timelineInfo.pSignalSemaphoreValues = signalValues;
+        submitInfo.pNext = &timelineInfo;
+    } else if (!vkFence) {
+        vkFence = device->gpuFencePool()->alloc();
+    }
+    submitInfo.signalSemaphoreCount = signalSemaphoreCount;
+    submitInfo.pSignalSemaphores = signalSemaphores;
+
     VK_CHECK(vkQueueSubmit(_gpuQueue->vkQueue, 1, &submitInfo, vkFence));
 
-    _gpuQueue->fences.push_back(vkFence);
+    if (!_gpuQueue->timelineSemaphore) _gpuQueue->fences.push_back(vkFence);
     _gpuQueue->nextWaitSemaphore = _gpuQueue->nextSignalSemaphore;
     _gpuQueue->nextSignalSemaphore = device->gpuSemaphorePool()->alloc();
 }
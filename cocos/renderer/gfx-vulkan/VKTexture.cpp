@@ -169,6 +169,8 @@ void CCVKTexture::resize(uint width, uint height) {
         _gpuTexture->width = _width;
         _gpuTexture->height = _height;
         _gpuTexture->size = _size;
+        _gpuTexture->mipLevels = _levelCount;
+        _gpuTextureView->levelCount = _levelCount;
 
         CCVKCmdFuncCreateTexture((CCVKDevice *)_device, _gpuTexture);
         status.bufferSize -= old_size;
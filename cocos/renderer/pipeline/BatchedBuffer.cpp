@@ -1,19 +1,19 @@
 #include "BatchedBuffer.h"
 #include "gfx/GFXBuffer.h"
 #include "gfx/GFXDescriptorSet.h"
+#include "gfx/GFXDescriptorSetLayout.h"
 #include "gfx/GFXDevice.h"
 #include "gfx/GFXInputAssembler.h"
 #include "helper/SharedMemory.h"
 
 namespace cc {
 namespace pipeline {
-map<uint, map<uint, BatchedBuffer *>> BatchedBuffer::_buffers;
+FlatHashMap<uint64_t, BatchedBuffer *> BatchedBuffer::_buffers;
 BatchedBuffer *BatchedBuffer::get(uint pass) {
     return BatchedBuffer::get(pass, 0);
 }
 BatchedBuffer *BatchedBuffer::get(uint pass, uint extraKey) {
-    auto &record = _buffers[pass];
-    auto &buffer = record[extraKey];
+    auto &buffer = _buffers[static_cast<uint64_t>(pass) << 32 | extraKey];
     if (buffer == nullptr) buffer = CC_NEW(BatchedBuffer(GET_PASS(pass)));
     return buffer;
 }
@@ -39,13 +39,15 @@ void BatchedBuffer::destroy() {
         batch.indexBuffer->destroy();
         batch.ia->destroy();
         batch.ubo->destroy();
+        if (_isExclusiveDescriptorSets) CC_SAFE_DESTROY(batch.descriptorSet);
 
         CC_FREE(batch.indexData);
     }
     _batches.clear();
+    CC_SAFE_DESTROY(_descriptorSetLayout);
 }
 
-void BatchedBuffer::merge(const SubModelView *subModel, uint passIdx, const ModelView *model) {
+void BatchedBuffer::merge(const SubModelView *subModel, uint passIdx, const ModelView *model, gfx::Shader *shaderImplant) {
     const auto subMesh = subModel->getSubMesh();
     const auto flatBuffersID = subMesh->getFlatBufferArrayID();
     const auto flatBuffersCount = flatBuffersID ? flatBuffersID[0] : 0;
@@ -57,9 +59,9 @@ void BatchedBuffer::merge(const SubModelView *subModel, uint passIdx, const Mode
     auto vbSize = 0;
     auto indexSize = 0;
     const auto vbCount = flatBuffer->count;
-    const auto pass = subModel->getPassView(passIdx);
-    const auto shader = subModel->getShader(passIdx);
-    const auto descriptorSet = subModel->getDescriptorSet();
+    const auto pass = shaderImplant ? _pass : subModel->getPassView(passIdx);
+    const auto shader = shaderImplant ? shaderImplant : subModel->getShader(passIdx);
+    auto descriptorSet = subModel->getDescriptorSet();
     bool isBatchExist = false;
 
     for (auto i = 0; i < _batches.size(); ++i) {
@@ -75,6 +77,13 @@ void BatchedBuffer::merge(const SubModelView *subModel, uint passIdx, const Mode
             }
 
             if (isBatchExist) {
+                if (batch.mergeCount == batch.slots.size()) batch.slots.emplace_back();
+                auto &slot = batch.slots[batch.mergeCount];
+                const bool isSlotChanged = slot.subModel != subModel || slot.vbOffset != batch.vbCount;
+                slot.subModel = subModel;
+                slot.vbOffset = batch.vbCount;
+                slot.sources.resize(flatBuffersCount, nullptr);
+
                 for (auto j = 0; j < flatBuffersCount; ++j) {
                     const auto flatBuffer = subMesh->getFlatBuffer(flatBuffersID[j + 1]);
                     auto batchVB = batch.vbs[j];
@@ -88,12 +97,18 @@ void BatchedBuffer::merge(const SubModelView *subModel, uint passIdx, const Mode
                         CC_FREE(vbData);
                         batch.vbDatas[j] = vbDataNew;
                         vbData = vbDataNew;
+                        batch.isVertexDirty = true;
                     }
 
+                    // mesh data is immutable once uploaded, the same buffer holds the same vertices
                     auto size = 0u;
-                    auto offset = batch.vbCount * flatBuffer->stride;
                     const auto data = flatBuffer->getBuffer(&size);
+                    if (!isSlotChanged && slot.sources[j] == data) continue;
+
+                    auto offset = batch.vbCount * flatBuffer->stride;
                     memcpy(vbData + offset, data, size);
+                    slot.sources[j] = data;
+                    batch.isVertexDirty = true;
                 }
 
                 auto indexData = batch.indexData;
@@ -106,28 +121,35 @@ void BatchedBuffer::merge(const SubModelView *subModel, uint passIdx, const Mode
                     batch.indexData = newIndexData;
                     indexData = batch.indexData;
                     batch.indexBuffer->resize(indexSize);
+                    batch.isIndexDirty = true;
                 }
 
                 const auto start = batch.vbCount;
                 const auto end = start + vbCount;
-                const auto mergeCount = batch.mergeCount;
-                if (indexData[start] != mergeCount || indexData[end - 1] != mergeCount) {
+                const auto batchID = batch.mergeCount + 0.1f; // guard against underflow
+                if (indexData[start] != batchID || indexData[end - 1] != batchID) {
                     for (auto j = start; j < end; j++) {
-                        indexData[j] = mergeCount + 0.1f; // guard against underflow
+                        indexData[j] = batchID;
                     }
+                    batch.isIndexDirty = true;
                 }
 
                 // update world matrix
                 const auto offset = UBOLocalBatched::MAT_WORLDS_OFFSET + batch.mergeCount * 16;
                 const auto &worldMatrix = model->getTransform()->worldMatrix;
-                memcpy(batch.uboData.data() + offset, worldMatrix.m, sizeof(worldMatrix));
+                if (memcmp(batch.uboData.data() + offset, worldMatrix.m, sizeof(worldMatrix))) {
+                    memcpy(batch.uboData.data() + offset, worldMatrix.m, sizeof(worldMatrix));
+                    batch.isUBODirty = true;
+                }
 
                 if (!batch.mergeCount) {
-                    descriptorSet->bindBuffer(UBOLocalBatched::BINDING, batch.ubo);
-                    descriptorSet->update();
+                    if (!_isExclusiveDescriptorSets) {
+                        descriptorSet->bindBuffer(UBOLocalBatched::BINDING, batch.ubo);
+                        descriptorSet->update();
+                        batch.descriptorSet = descriptorSet;
+                    }
                     batch.pass = pass;
                     batch.shader = shader;
-                    batch.descriptorSet = descriptorSet;
                 }
 
                 ++batch.mergeCount;
@@ -143,6 +165,9 @@ void BatchedBuffer::merge(const SubModelView *subModel, uint passIdx, const Mode
     vector<gfx::Buffer *> vbs(flatBuffersCount, nullptr);
     vector<uint8_t *> vbDatas(flatBuffersCount, 0);
     vector<gfx::Buffer *> totalVBs(flatBuffersCount + 1, nullptr);
+    vector<BatchedSlot> slots(1);
+    slots[0].subModel = subModel;
+    slots[0].sources.resize(flatBuffersCount, nullptr);
 
     for (auto i = 0; i < flatBuffersCount; ++i) {
         const auto flatBuffer = subMesh->getFlatBuffer(flatBuffersID[i + 1]);
@@ -158,7 +183,8 @@ void BatchedBuffer::merge(const SubModelView *subModel, uint passIdx, const Mode
 
         vbs[i] = newVB;
         vbDatas[i] = static_cast<uint8_t *>(CC_MALLOC(newVB->getSize()));
-        memset(vbDatas[i], 0, newVB->getSize());
+        memcpy(vbDatas[i], data, size);
+        slots[0].sources[i] = data;
         totalVBs[i] = newVB;
     }
 
@@ -192,6 +218,10 @@ void BatchedBuffer::merge(const SubModelView *subModel, uint passIdx, const Mode
         UBOLocalBatched::SIZE,
     });
 
+    if (_isExclusiveDescriptorSets) {
+        if (!_descriptorSetLayout) _descriptorSetLayout = _device->createDescriptorSetLayout({localDescriptorSetLayout.bindings});
+        descriptorSet = _device->createDescriptorSet({_descriptorSetLayout});
+    }
     descriptorSet->bindBuffer(UBOLocalBatched::BINDING, ubo);
     descriptorSet->update();
 
@@ -211,6 +241,7 @@ void BatchedBuffer::merge(const SubModelView *subModel, uint passIdx, const Mode
         descriptorSet,                   //descriptorSet
         pass,                            //pass
         shader,                          //shader
+        std::move(slots),                //slots
     };
     _batches.emplace_back(std::move(item));
 }
@@ -1,12 +1,20 @@
 #pragma once
 
 #include "Define.h"
+#include "helper/FlatHashMap.h"
 
 namespace cc {
 namespace pipeline {
 struct PassView;
 struct SubModelView;
 
+// Source of the vertices merged into a batch slot, a slot copying the same data to the same offset again is skipped.
+struct CC_DLL BatchedSlot {
+    const SubModelView *subModel = nullptr;
+    uint vbOffset = 0;
+    vector<const uint8_t *> sources;
+};
+
 struct CC_DLL BatchedItem {
     gfx::BufferList vbs;
     vector<uint8_t *> vbDatas;
@@ -20,6 +28,11 @@ struct CC_DLL BatchedItem {
     gfx::DescriptorSet *descriptorSet = nullptr;
     const PassView *pass = nullptr;
     gfx::Shader *shader = nullptr;
+    vector<BatchedSlot> slots;
+    // cleared once uploaded, static batches upload nothing after their first frame
+    bool isVertexDirty = true;
+    bool isIndexDirty = true;
+    bool isUBODirty = true;
 };
 typedef vector<BatchedItem> BatchedItemList;
 typedef vector<uint> DynamicOffsetList;
@@ -33,20 +46,29 @@ public:
     virtual ~BatchedBuffer();
 
     void destroy();
-    void merge(const SubModelView *, uint passIdx, const ModelView *);
+    // with a shader implant the batch is drawn with the pass of the buffer and that shader instead of the sub-model ones
+    void merge(const SubModelView *, uint passIdx, const ModelView *, gfx::Shader *shaderImplant = nullptr);
     void clear();
     void setDynamicOffset(uint idx, uint value);
 
+    // batches bind their UBO into descriptor sets of their own rather than into the one of their first sub-model,
+    // for buffers batching sub-models another buffer batches too
+    CC_INLINE void setExclusiveDescriptorSets(bool value) { _isExclusiveDescriptorSets = value; }
+
     CC_INLINE const BatchedItemList &getBatches() const { return _batches; }
+    CC_INLINE BatchedItemList &getBatches() { return _batches; }
     CC_INLINE const PassView *getPass() const { return _pass; }
     CC_INLINE const DynamicOffsetList &getDynamicOffset() const { return _dynamicOffsets; }
 
 private:
-    static map<uint, map<uint, BatchedBuffer *>> _buffers;
+    // keyed on the pass handle in the high 32 bits and the extra key in the low ones
+    static FlatHashMap<uint64_t, BatchedBuffer *> _buffers;
     DynamicOffsetList _dynamicOffsets;
     BatchedItemList _batches;
     const PassView *_pass = nullptr;
     gfx::Device *_device = nullptr;
+    gfx::DescriptorSetLayout *_descriptorSetLayout = nullptr;
+    bool _isExclusiveDescriptorSets = false;
 };
 
 } // namespace pipeline
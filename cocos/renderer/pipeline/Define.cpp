@@ -95,6 +95,49 @@ const gfx::UniformBlock UBOShadow::LAYOUT = {
         {"cc_matLightViewProj", gfx::Type::MAT4, 1},
         {"cc_shadowColor", gfx::Type::FLOAT4, 1},
         {"cc_shadowInfo", gfx::Type::FLOAT4, 1},
+        {"cc_matCascadeViewProj", gfx::Type::MAT4, UBOShadow::MAX_CASCADES},
+        {"cc_cascadeSplits", gfx::Type::FLOAT4, 1},
+        {"cc_cascadeInfo", gfx::Type::FLOAT4, 1},
+    },
+    1,
+};
+
+const String UBOClusterLights::NAME = "CCClusterLights";
+const gfx::DescriptorSetLayoutBinding UBOClusterLights::DESCRIPTOR = {
+    UBOClusterLights::BINDING,
+    gfx::DescriptorType::UNIFORM_BUFFER,
+    1,
+    gfx::ShaderStageFlagBit::FRAGMENT,
+};
+const gfx::UniformBlock UBOClusterLights::LAYOUT = {
+    GLOBAL_SET,
+    UBOClusterLights::BINDING,
+    UBOClusterLights::NAME,
+    {
+        {"cc_clusterInfo", gfx::Type::FLOAT4, 1},
+        {"cc_clusterDepth", gfx::Type::FLOAT4, 1},
+        {"cc_clusterLightPos", gfx::Type::FLOAT4, UBOClusterLights::MAX_LIGHTS},
+        {"cc_clusterLightColor", gfx::Type::FLOAT4, UBOClusterLights::MAX_LIGHTS},
+        {"cc_clusterLightSizeRangeAngle", gfx::Type::FLOAT4, UBOClusterLights::MAX_LIGHTS},
+        {"cc_clusterLightDir", gfx::Type::FLOAT4, UBOClusterLights::MAX_LIGHTS},
+    },
+    1,
+};
+
+const String UBOClusterGrid::NAME = "CCClusterGrid";
+const gfx::DescriptorSetLayoutBinding UBOClusterGrid::DESCRIPTOR = {
+    UBOClusterGrid::BINDING,
+    gfx::DescriptorType::UNIFORM_BUFFER,
+    1,
+    gfx::ShaderStageFlagBit::FRAGMENT,
+};
+const gfx::UniformBlock UBOClusterGrid::LAYOUT = {
+    GLOBAL_SET,
+    UBOClusterGrid::BINDING,
+    UBOClusterGrid::NAME,
+    {
+        {"cc_clusters", gfx::Type::UINT4, UBOClusterGrid::CLUSTER_COUNT / 4},
+        {"cc_clusterLightIndices", gfx::Type::UINT4, UBOClusterGrid::MAX_LIGHT_INDICES / 16},
     },
     1,
 };
@@ -156,6 +199,7 @@ const gfx::UniformBlock UBOSkinningTexture::LAYOUT = {
 };
 
 const String UBOSkinningAnimation::NAME = "CCSkinningAnimation";
+const String UBOSkinningAnimation::INSTANCED_ATTRIBUTE_NAME = "a_jointAnimInfo";
 const gfx::DescriptorSetLayoutBinding UBOSkinningAnimation::DESCRIPTOR = {
     UBOSkinningAnimation::BINDING,
     gfx::DescriptorType::UNIFORM_BUFFER,
@@ -190,7 +234,7 @@ const gfx::UniformBlock UBOSkinning::LAYOUT = {
 };
 
 const uint UBOMorph::COUNT_BASE_4_BYTES = 4 * std::ceil(UBOMorph::MAX_MORPH_TARGET_COUNT / 4) + 4;
-const uint UBOMorph::SIZE = UBOMorph::COUNT_BASE_4_BYTES * 4;
+const uint UBOMorph::SIZE = UBOMorph::COUNT_BASE_4_BYTES * 4 + UBOMorph::MAX_MORPH_TARGET_COUNT * 16;
 const String UBOMorph::NAME = "CCMorph";
 const gfx::DescriptorSetLayoutBinding UBOMorph::DESCRIPTOR = {
     UBOMorph::BINDING,
@@ -204,7 +248,8 @@ const gfx::UniformBlock UBOMorph::LAYOUT = {
     UBOMorph::NAME,
     {
         {"cc_displacementWeights", gfx::Type::FLOAT4, static_cast<uint>(UBOMorph::MAX_MORPH_TARGET_COUNT / 4)},
-        {"cc_displacementWeights", gfx::Type::FLOAT4, 1},
+        {"cc_displacementTextureInfo", gfx::Type::FLOAT4, 1},
+        {"cc_displacementTargets", gfx::Type::FLOAT4, UBOMorph::MAX_MORPH_TARGET_COUNT},
     },
     1,
 };
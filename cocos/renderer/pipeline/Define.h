@@ -38,6 +38,7 @@ struct CC_DLL RenderPass {
     uint shaderID = 0;
     uint passIndex = 0;
     const SubModelView *subModel = nullptr;
+    const ModelView *model = nullptr;
 };
 typedef vector<RenderPass> RenderPassList;
 
@@ -100,10 +101,17 @@ struct CC_DLL InternalBindingInst : public InternalBindingDesc {
     gfx::Texture *texture = nullptr;
 };
 
+enum class CC_DLL RenderQueueSortMode {
+    FRONT_TO_BACK,
+    BACK_TO_FRONT,
+};
+
 struct CC_DLL RenderQueueCreateInfo {
     bool isTransparent = false;
     uint phases = 0;
     std::function<bool(const RenderPass &a, const RenderPass &b)> sortFunc;
+    // depth order of the packed keys used by radix sorting
+    RenderQueueSortMode sortMode = RenderQueueSortMode::FRONT_TO_BACK;
 };
 
 enum class CC_DLL RenderPriority {
@@ -112,11 +120,6 @@ enum class CC_DLL RenderPriority {
     DEFAULT = 0x80,
 };
 
-enum class CC_DLL RenderQueueSortMode {
-    FRONT_TO_BACK,
-    BACK_TO_FRONT,
-};
-
 struct CC_DLL RenderQueueDesc {
     bool isTransparent = false;
     RenderQueueSortMode sortMode = RenderQueueSortMode::FRONT_TO_BACK;
@@ -153,6 +156,10 @@ enum class CC_DLL PipelineGlobalBindings {
     SAMPLER_ENVIRONMENT, // don't put this as the first sampler binding due to Mac GL driver issues: cubemap at texture unit 0 causes rendering issues
     SAMPLER_SPOT_LIGHTING_MAP,
 
+    // appended to keep the bindings of existing effects
+    UBO_CLUSTER_LIGHTS,
+    UBO_CLUSTER_GRID,
+
     COUNT,
 };
 
@@ -220,6 +227,8 @@ struct CC_DLL UBOSkinningTexture {
     static const String NAME;
 };
 
+// The frame of a baked animation, instanced draws take it from the a_jointAnimInfo instanced attribute instead:
+// (frame, joint count, first texel in the joint texture, 0), written by the SkinningSystem.
 struct CC_DLL UBOSkinningAnimation {
     static constexpr uint JOINTS_ANIM_INFO_OFFSET = 0;
     static constexpr uint COUNT = UBOSkinningAnimation::JOINTS_ANIM_INFO_OFFSET + 4;
@@ -228,6 +237,7 @@ struct CC_DLL UBOSkinningAnimation {
     static const gfx::DescriptorSetLayoutBinding DESCRIPTOR;
     static const gfx::UniformBlock LAYOUT;
     static const String NAME;
+    static const String INSTANCED_ATTRIBUTE_NAME;
 };
 
 struct CC_DLL UBOSkinning {
@@ -240,12 +250,16 @@ struct CC_DLL UBOSkinning {
     static const String NAME;
 };
 
+// Byte offsets. The models of the MorphSystem only upload their active targets, the weights are compacted and
+// OFFSET_OF_TARGETS holds the sparse range of every active target, see MorphSystem.h.
 struct CC_DLL UBOMorph {
     static constexpr uint MAX_MORPH_TARGET_COUNT = 60;
     static constexpr uint OFFSET_OF_WEIGHTS = 0;
     static constexpr uint OFFSET_OF_DISPLACEMENT_TEXTURE_WIDTH = 4 * MAX_MORPH_TARGET_COUNT;
     static constexpr uint OFFSET_OF_DISPLACEMENT_TEXTURE_HEIGHT = OFFSET_OF_DISPLACEMENT_TEXTURE_WIDTH + 4;
     static constexpr uint OFFSET_OF_VERTICES_COUNT = OFFSET_OF_DISPLACEMENT_TEXTURE_HEIGHT + 4;
+    static constexpr uint OFFSET_OF_ACTIVE_TARGET_COUNT = OFFSET_OF_VERTICES_COUNT + 4;
+    static constexpr uint OFFSET_OF_TARGETS = OFFSET_OF_ACTIVE_TARGET_COUNT + 4;
     static const uint COUNT_BASE_4_BYTES;
     static const uint SIZE;
     static constexpr uint BINDING = static_cast<uint>(ModelLocalBindings::UBO_MORPH);
@@ -265,6 +279,15 @@ enum class CC_DLL ForwardFlowPriority {
     UI = 10,
 };
 
+enum class CC_DLL DeferredStagePriority {
+    DEFERRED = 10,
+};
+
+enum class CC_DLL DeferredFlowPriority {
+    SHADOW = 0,
+    DEFERRED = 1,
+};
+
 enum class CC_DLL RenderFlowTag {
     SCENE,
     POSTPROCESS,
@@ -313,7 +336,12 @@ struct CC_DLL UBOShadow : public Object {
     static constexpr uint MAT_LIGHT_VIEW_PROJ_OFFSET = UBOShadow::MAT_LIGHT_PLANE_PROJ_OFFSET + 16;
     static constexpr uint SHADOW_COLOR_OFFSET = UBOShadow::MAT_LIGHT_VIEW_PROJ_OFFSET + 16;
     static constexpr uint SHADOW_INFO_OFFSET = UBOShadow::SHADOW_COLOR_OFFSET + 4;
-    static constexpr uint COUNT = UBOShadow::SHADOW_INFO_OFFSET + 4;
+    // cascades of the main directional light, packed into tiles of its shadow map
+    static constexpr uint MAX_CASCADES = 4;
+    static constexpr uint MAT_CASCADE_VIEW_PROJ_OFFSET = UBOShadow::SHADOW_INFO_OFFSET + 4;
+    static constexpr uint CASCADE_SPLITS_OFFSET = UBOShadow::MAT_CASCADE_VIEW_PROJ_OFFSET + 16 * UBOShadow::MAX_CASCADES;
+    static constexpr uint CASCADE_INFO_OFFSET = UBOShadow::CASCADE_SPLITS_OFFSET + 4;
+    static constexpr uint COUNT = UBOShadow::CASCADE_INFO_OFFSET + 4;
     static constexpr uint SIZE = UBOShadow::COUNT * 4;
     static constexpr uint BINDING = static_cast<uint>(PipelineGlobalBindings::UBO_SHADOW);
     static const gfx::DescriptorSetLayoutBinding DESCRIPTOR;
@@ -321,6 +349,44 @@ struct CC_DLL UBOShadow : public Object {
     static const String NAME;
 };
 
+// Lights shaded by the forward pass in clustered lighting mode.
+struct CC_DLL UBOClusterLights : public Object {
+    static constexpr uint MAX_LIGHTS = 128;
+    // grid size in x, y and z, light count
+    static constexpr uint CLUSTER_INFO_OFFSET = 0;
+    // slice = floor(log(view depth) * x + y), z and w are the near and far depth of the grid
+    static constexpr uint CLUSTER_DEPTH_OFFSET = UBOClusterLights::CLUSTER_INFO_OFFSET + 4;
+    static constexpr uint LIGHT_POS_OFFSET = UBOClusterLights::CLUSTER_DEPTH_OFFSET + 4;
+    static constexpr uint LIGHT_COLOR_OFFSET = UBOClusterLights::LIGHT_POS_OFFSET + UBOClusterLights::MAX_LIGHTS * 4;
+    static constexpr uint LIGHT_SIZE_RANGE_ANGLE_OFFSET = UBOClusterLights::LIGHT_COLOR_OFFSET + UBOClusterLights::MAX_LIGHTS * 4;
+    static constexpr uint LIGHT_DIR_OFFSET = UBOClusterLights::LIGHT_SIZE_RANGE_ANGLE_OFFSET + UBOClusterLights::MAX_LIGHTS * 4;
+    static constexpr uint COUNT = UBOClusterLights::LIGHT_DIR_OFFSET + UBOClusterLights::MAX_LIGHTS * 4;
+    static constexpr uint SIZE = UBOClusterLights::COUNT * 4;
+    static constexpr uint BINDING = static_cast<uint>(PipelineGlobalBindings::UBO_CLUSTER_LIGHTS);
+    static const gfx::DescriptorSetLayoutBinding DESCRIPTOR;
+    static const gfx::UniformBlock LAYOUT;
+    static const String NAME;
+};
+
+// Froxel grid of the clustered lighting mode, tiles in x and y are taken from the NDC of the fragment.
+struct CC_DLL UBOClusterGrid : public Object {
+    static constexpr uint GRID_X = 16;
+    static constexpr uint GRID_Y = 8;
+    static constexpr uint GRID_Z = 16;
+    static constexpr uint CLUSTER_COUNT = UBOClusterGrid::GRID_X * UBOClusterGrid::GRID_Y * UBOClusterGrid::GRID_Z;
+    static constexpr uint MAX_LIGHT_INDICES = 8192;
+    // one uint per cluster, offset of its range in the light indices in the low 16 bits and light count in the high ones
+    static constexpr uint CLUSTERS_OFFSET = 0;
+    // 8-bit light indices, four per uint with the first one in the lowest byte
+    static constexpr uint LIGHT_INDICES_OFFSET = UBOClusterGrid::CLUSTERS_OFFSET + UBOClusterGrid::CLUSTER_COUNT;
+    static constexpr uint COUNT = UBOClusterGrid::LIGHT_INDICES_OFFSET + UBOClusterGrid::MAX_LIGHT_INDICES / 4;
+    static constexpr uint SIZE = UBOClusterGrid::COUNT * 4;
+    static constexpr uint BINDING = static_cast<uint>(PipelineGlobalBindings::UBO_CLUSTER_GRID);
+    static const gfx::DescriptorSetLayoutBinding DESCRIPTOR;
+    static const gfx::UniformBlock LAYOUT;
+    static const String NAME;
+};
+
 class CC_DLL SamplerLib : public Object {
 public:
     gfx::Sampler *getSampler(uint hash);
@@ -8,13 +8,24 @@
 
 namespace cc {
 namespace pipeline {
-map<uint, map<uint, InstancedBuffer *>> InstancedBuffer::_buffers;
+namespace {
+CC_INLINE void markDirty(InstancedItem &instance, uint begin, uint end) {
+    if (instance.dirtyBegin == instance.dirtyEnd) {
+        instance.dirtyBegin = begin;
+        instance.dirtyEnd = end;
+    } else {
+        instance.dirtyBegin = std::min(instance.dirtyBegin, begin);
+        instance.dirtyEnd = std::max(instance.dirtyEnd, end);
+    }
+}
+} // namespace
+
+FlatHashMap<uint64_t, InstancedBuffer *> InstancedBuffer::_buffers;
 InstancedBuffer *InstancedBuffer::get(uint pass) {
     return InstancedBuffer::get(pass, 0);
 }
 InstancedBuffer *InstancedBuffer::get(uint pass, uint extraKey) {
-    auto &record = _buffers[pass];
-    auto &buffer = record[extraKey];
+    auto &buffer = _buffers[static_cast<uint64_t>(pass) << 32 | extraKey];
     if (buffer == nullptr) buffer = CC_NEW(InstancedBuffer(GET_PASS(pass)));
 
     return buffer;
@@ -37,37 +48,57 @@ void InstancedBuffer::destroy() {
     _instances.clear();
 }
 
-void InstancedBuffer::merge(const ModelView *model, const SubModelView *subModel, uint passIdx) {
+void InstancedBuffer::merge(const ModelView *model, const SubModelView *subModel, uint passIdx, gfx::Shader *shaderImplant) {
+    uint size = 0;
+    const auto instancedBuffer = model->getInstancedBuffer(&size);
+    if (!model->instanceCount) {
+        merge(model, subModel, passIdx, instancedBuffer, size, 1, shaderImplant);
+        return;
+    }
+
+    // packed instances, the stride is what the instanced attributes take
     uint stride = 0;
-    const auto instancedBuffer = model->getInstancedBuffer(&stride);
+    const auto attributesID = model->getInstancedAttributeID();
+    for (uint i = 1; i <= attributesID[0]; i++) {
+        stride += gfx::GFX_FORMAT_INFOS[static_cast<uint>(model->getInstancedAttribute(attributesID[i])->format)].size;
+    }
+    if (!stride) return;
+    merge(model, subModel, passIdx, instancedBuffer, stride, std::min(model->instanceCount, size / stride), shaderImplant);
+}
 
-    if (!stride) return; // we assume per-instance attributes are always present
+void InstancedBuffer::merge(const ModelView *model, const SubModelView *subModel, uint passIdx, const uint8_t *data, uint stride, uint count, gfx::Shader *shaderImplant) {
+    if (!stride || !count) return; // we assume per-instance attributes are always present
+    const auto dataSize = stride * count;
     auto sourceIA = subModel->getInputAssembler();
     auto lightingMap = subModel->getDescriptorSet()->getTexture(LIGHTMAP_TEXTURE::BINDING);
-    auto shader = subModel->getShader(passIdx);
+    auto jointTexture = subModel->getDescriptorSet()->getTexture(JOINT_TEXTURE::BINDING);
+    auto shader = shaderImplant ? shaderImplant : subModel->getShader(passIdx);
     auto descriptorSet = subModel->getDescriptorSet();
     for (int i = 0; i < _instances.size(); i++) {
         auto &instance = _instances[i];
-        if (instance.ia->getIndexBuffer() != sourceIA->getIndexBuffer() || instance.count >= MAX_CAPACITY) {
+        if (instance.ia->getIndexBuffer() != sourceIA->getIndexBuffer()) {
             continue;
         }
 
         // check same binding
-        if (instance.lightingMap != lightingMap) {
+        if (instance.lightingMap != lightingMap || instance.jointTexture != jointTexture) {
             continue;
         }
 
         if (instance.stride != stride) {
             return;
         }
-        if (instance.count >= instance.capacity) { // resize buffers
-            instance.capacity <<= 1;
+        if (instance.count + count > instance.capacity) { // resize buffers
+            while (instance.count + count > instance.capacity) instance.capacity <<= 1;
             const auto newSize = instance.stride * instance.capacity;
             const auto oldData = instance.data;
             instance.data = (uint8_t *)CC_MALLOC(newSize);
             memcpy(instance.data, oldData, instance.vb->getSize());
             instance.vb->resize(newSize);
             CC_FREE(oldData);
+            // the resized vertex buffer does not keep its content
+            markDirty(instance, 0, instance.stride * instance.count);
+            instance.writtenSize = instance.stride * instance.count;
         }
         if (instance.shader != shader) {
             instance.shader = shader;
@@ -75,13 +106,23 @@ void InstancedBuffer::merge(const ModelView *model, const SubModelView *subModel
         if (instance.descriptorSet != descriptorSet) {
             instance.descriptorSet = descriptorSet;
         }
-        memcpy(instance.data + instance.stride * instance.count++, instancedBuffer, stride);
+        // instance data persists across frames, only rewrite and upload what changed
+        const auto offset = instance.stride * instance.count;
+        instance.count += count;
+        // slots never written hold whatever the allocation left, they are always written
+        if (offset + dataSize > instance.writtenSize || memcmp(instance.data + offset, data, dataSize)) {
+            memcpy(instance.data + offset, data, dataSize);
+            markDirty(instance, offset, offset + dataSize);
+            instance.writtenSize = std::max(instance.writtenSize, offset + dataSize);
+        }
         _hasPendingModels = true;
         return;
     }
 
     // Create a new instance
-    auto newSize = stride * INITIAL_CAPACITY;
+    uint capacity = INITIAL_CAPACITY;
+    while (capacity < count) capacity <<= 1;
+    auto newSize = stride * capacity;
     auto vb = _device->createBuffer({
         gfx::BufferUsageBit::VERTEX | gfx::BufferUsageBit::TRANSFER_DST,
         gfx::MemoryUsageBit::HOST | gfx::MemoryUsageBit::DEVICE,
@@ -101,12 +142,12 @@ void InstancedBuffer::merge(const ModelView *model, const SubModelView *subModel
         attributes.emplace_back(std::move(newAttr));
     }
 
-    uint8_t *data = (uint8_t *)CC_MALLOC(newSize);
-    memcpy(data, instancedBuffer, stride);
+    uint8_t *instanceData = (uint8_t *)CC_MALLOC(newSize);
+    memcpy(instanceData, data, dataSize);
     vertexBuffers.emplace_back(vb);
     gfx::InputAssemblerInfo iaInfo = {attributes, vertexBuffers, indexBuffer};
     auto ia = _device->createInputAssembler(iaInfo);
-    InstancedItem item = {1, INITIAL_CAPACITY, vb, data, ia, stride, shader, descriptorSet, lightingMap};
+    InstancedItem item = {count, capacity, vb, instanceData, ia, stride, shader, descriptorSet, lightingMap, jointTexture, 0, dataSize, dataSize};
     _instances.emplace_back(std::move(item));
     _hasPendingModels = true;
 }
@@ -115,7 +156,16 @@ void InstancedBuffer::uploadBuffers(gfx::CommandBuffer *cmdBuff) {
     for (auto &instance : _instances) {
         if (!instance.count) continue;
 
-        cmdBuff->updateBuffer(instance.vb, instance.data, instance.vb->getSize());
+        // slots past count are not drawn this frame, leave them for later frames
+        const auto dirtyEnd = std::min(instance.dirtyEnd, instance.stride * instance.count);
+        if (instance.dirtyBegin < dirtyEnd) {
+            cmdBuff->updateBuffer(instance.vb, instance.data + instance.dirtyBegin, dirtyEnd - instance.dirtyBegin, instance.dirtyBegin);
+            if (dirtyEnd == instance.dirtyEnd) {
+                instance.dirtyBegin = instance.dirtyEnd = 0;
+            } else {
+                instance.dirtyBegin = dirtyEnd;
+            }
+        }
         instance.ia->setInstanceCount(instance.count);
     }
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Define.h"
+#include "helper/FlatHashMap.h"
 
 namespace cc {
 namespace gfx {
@@ -27,6 +28,12 @@ struct CC_DLL InstancedItem {
     gfx::Shader *shader = nullptr;
     gfx::DescriptorSet *descriptorSet = nullptr;
     gfx::Texture *lightingMap = nullptr;
+    gfx::Texture *jointTexture = nullptr; // baked animations share theirs, the frames go through a_jointAnimInfo
+    // byte range of data that differs from the vertex buffer content
+    uint dirtyBegin = 0;
+    uint dirtyEnd = 0;
+    // bytes of data written since the vertex buffer was created, slots past it hold no instance yet
+    uint writtenSize = 0;
 };
 typedef vector<InstancedItem> InstancedItemList;
 typedef vector<uint> DynamicOffsetList;
@@ -34,7 +41,6 @@ typedef vector<uint> DynamicOffsetList;
 class InstancedBuffer : public Object {
 public:
     static constexpr uint INITIAL_CAPACITY = 32;
-    static constexpr uint MAX_CAPACITY = 1024;
     static InstancedBuffer *get(uint pass);
     static InstancedBuffer *get(uint pass, uint extraKey);
 
@@ -42,7 +48,10 @@ public:
     virtual ~InstancedBuffer();
 
     void destroy();
-    void merge(const ModelView *, const SubModelView *, uint);
+    // a shader implant draws the instances with that shader instead of the one of the sub-model pass
+    void merge(const ModelView *, const SubModelView *, uint, gfx::Shader *shaderImplant = nullptr);
+    // count instances of stride bytes each, packed in data, drawn with the instanced attributes of the model
+    void merge(const ModelView *, const SubModelView *, uint, const uint8_t *data, uint stride, uint count, gfx::Shader *shaderImplant = nullptr);
     void uploadBuffers(gfx::CommandBuffer *cmdBuff);
     void clear();
     void setDynamicOffset(uint idx, uint value);
@@ -53,7 +62,8 @@ public:
     CC_INLINE const DynamicOffsetList &dynamicOffsets() const { return _dynamicOffsets; }
 
 private:
-    static map<uint, map<uint, InstancedBuffer *>> _buffers;
+    // keyed on the pass handle in the high 32 bits and the extra key in the low ones
+    static FlatHashMap<uint64_t, InstancedBuffer *> _buffers;
     InstancedItemList _instances;
     const PassView *_pass = nullptr;
     bool _hasPendingModels = false;
@@ -1,4 +1,7 @@
 #include "PipelineStateManager.h"
+#include "ShaderVariantCollector.h"
+#include "base/MemoryPressure.h"
+#include "base/ThreadPool.h"
 #include "gfx/GFXDevice.h"
 #include "gfx/GFXInputAssembler.h"
 #include "gfx/GFXRenderPass.h"
@@ -7,33 +10,99 @@
 
 namespace cc {
 namespace pipeline {
-map<uint, gfx::PipelineState *> PipelineStateManager::_PSOHashMap;
-gfx::PipelineState *PipelineStateManager::getOrCreatePipelineState(const PassView *pass,
-                                                                   gfx::Shader *shader,
-                                                                   gfx::InputAssembler *inputAssembler,
-                                                                   gfx::RenderPass *renderPass) {
+FlatHashMap<uint, gfx::PipelineState *> PipelineStateManager::_PSOHashMap;
+std::mutex PipelineStateManager::_PSOMutex;
+map<uint, bool> PipelineStateManager::_prewarmStates;
+vector<PipelineStateManager::PrewarmJob> PipelineStateManager::_prewarmQueue;
+ThreadPool *PipelineStateManager::_prewarmThreadPool = nullptr;
+uint PipelineStateManager::_prewarmCompletedCount = 0;
+uint32_t PipelineStateManager::_memoryPressureHandlerID = 0;
+
+uint PipelineStateManager::getHash(const PassView *pass, gfx::Shader *shader, gfx::InputAssembler *inputAssembler, gfx::RenderPass *renderPass, uint subpass, DepthPassVariant variant) {
     const auto passHash = pass->hash;
     const auto renderPassHash = renderPass->getHash();
     const auto iaHash = inputAssembler->getAttributesHash();
     const auto shaderID = shader->getID();
-    const auto hash = passHash ^ renderPassHash ^ iaHash ^ shaderID;
+    return passHash ^ renderPassHash ^ iaHash ^ shaderID ^ (subpass << 24) ^ (static_cast<uint>(variant) << 28);
+}
+
+gfx::PipelineStateInfo PipelineStateManager::getPipelineStateInfo(const PassView *pass, gfx::Shader *shader, gfx::InputAssembler *inputAssembler, gfx::RenderPass *renderPass, uint subpass, DepthPassVariant variant) {
+    auto pipelineLayout = pass->getPipelineLayout();
+    gfx::PipelineStateInfo info = {
+        shader,
+        pipelineLayout,
+        renderPass,
+        {inputAssembler->getAttributes()},
+        *(pass->getRasterizerState()),
+        *(pass->getDepthStencilState()),
+        *(pass->getBlendState()),
+        pass->getPrimitive(),
+        pass->getDynamicState(),
+        subpass};
 
-    auto pso = _PSOHashMap[hash];
+    switch (variant) {
+        case DepthPassVariant::DEPTH_ONLY:
+            // the pass shader still runs for the fragments it discards, only its outputs are masked
+            for (auto &target : info.blendState.targets) target.blendColorMask = gfx::ColorMask::NONE;
+            info.depthStencilState.depthWrite = 1;
+            info.depthStencilState.depthFunc = gfx::ComparisonFunc::LESS_EQUAL;
+            break;
+        case DepthPassVariant::DEPTH_EQUAL:
+            info.depthStencilState.depthWrite = 0;
+            info.depthStencilState.depthFunc = gfx::ComparisonFunc::EQUAL;
+            break;
+        default: break;
+    }
+    return info;
+}
+
+gfx::PipelineState *PipelineStateManager::getOrCreatePipelineState(const PassView *pass,
+                                                                   gfx::Shader *shader,
+                                                                   gfx::InputAssembler *inputAssembler,
+                                                                   gfx::RenderPass *renderPass,
+                                                                   uint subpass) {
+    return getOrCreatePipelineState(getHash(pass, shader, inputAssembler, renderPass, subpass), pass, shader, inputAssembler, renderPass, subpass, DepthPassVariant::NONE);
+}
+
+gfx::PipelineState *PipelineStateManager::getOrCreatePipelineState(const PassView *pass,
+                                                                   gfx::Shader *shader,
+                                                                   gfx::InputAssembler *inputAssembler,
+                                                                   gfx::RenderPass *renderPass,
+                                                                   LastHit &lastHit,
+                                                                   uint subpass,
+                                                                   DepthPassVariant variant) {
+    const auto hash = getHash(pass, shader, inputAssembler, renderPass, subpass, variant);
+    if (lastHit.pso && lastHit.hash == hash) return lastHit.pso;
+
+    auto pso = getOrCreatePipelineState(hash, pass, shader, inputAssembler, renderPass, subpass, variant);
+    // states still compiling are not remembered so that they are picked up once ready
+    if (pso) {
+        lastHit.hash = hash;
+        lastHit.pso = pso;
+    }
+    return pso;
+}
+
+gfx::PipelineState *PipelineStateManager::getOrCreatePipelineState(uint hash,
+                                                                   const PassView *pass,
+                                                                   gfx::Shader *shader,
+                                                                   gfx::InputAssembler *inputAssembler,
+                                                                   gfx::RenderPass *renderPass,
+                                                                   uint subpass,
+                                                                   DepthPassVariant variant) {
+    std::lock_guard<std::mutex> lock(_PSOMutex);
+    auto &pso = _PSOHashMap[hash];
     if (!pso) {
-        auto pipelineLayout = pass->getPipelineLayout();
-        gfx::PipelineStateInfo info = {
-            shader,
-            pipelineLayout,
-            renderPass,
-            {inputAssembler->getAttributes()},
-            *(pass->getRasterizerState()),
-            *(pass->getDepthStencilState()),
-            *(pass->getBlendState()),
-            pass->getPrimitive(),
-            pass->getDynamicState()};
-
-        pso = gfx::Device::getInstance()->createPipelineState(std::move(info));
-        _PSOHashMap[hash] = pso;
+        auto iter = _prewarmStates.find(hash);
+        if (iter != _prewarmStates.end()) {
+            // being compiled in the background, skip the draw instead of stalling the frame
+            if (iter->second || !shader->isReady()) return nullptr;
+            // queued but not started yet, the queued job is dropped when it finds the entry removed
+            _prewarmStates.erase(iter);
+        }
+
+        ShaderVariantCollector::record(shader);
+        pso = gfx::Device::getInstance()->createPipelineState(getPipelineStateInfo(pass, shader, inputAssembler, renderPass, subpass, variant));
     }
 
     return pso;
@@ -48,5 +117,119 @@ gfx::PipelineState *PipelineStateManager::getOrCreatePipelineStateByJS(uint32_t
     return PipelineStateManager::getOrCreatePipelineState(pass, shader, inputAssembler, renderPass);
 }
 
+void PipelineStateManager::prewarmPipelineState(const PassView *pass,
+                                                gfx::Shader *shader,
+                                                gfx::InputAssembler *inputAssembler,
+                                                gfx::RenderPass *renderPass) {
+    // the pass states are captured here so that the job doesn't read the shared memory from another thread,
+    // and the attributes are copied since the input assembler may be gone by the time the job runs
+    PrewarmJob job;
+    job.hash = getHash(pass, shader, inputAssembler, renderPass, 0);
+    job.info = getPipelineStateInfo(pass, shader, inputAssembler, renderPass, 0);
+
+    std::lock_guard<std::mutex> lock(_PSOMutex);
+    auto psoSlot = _PSOHashMap.find(job.hash);
+    if ((psoSlot && *psoSlot) || _prewarmStates.count(job.hash)) return;
+    _prewarmStates[job.hash] = false;
+
+    if (!_memoryPressureHandlerID) {
+        _memoryPressureHandlerID = MemoryPressure::addHandler("PipelineStateManager", MemoryPressureLevel::LOW, [](MemoryPressureLevel) {
+            dropPendingPrewarms();
+        });
+    }
+
+    const auto api = gfx::Device::getInstance()->getGfxAPI();
+    if (api == gfx::API::VULKAN || api == gfx::API::METAL) {
+        if (!_prewarmThreadPool) _prewarmThreadPool = ThreadPool::newSingleThreadPool();
+        _prewarmThreadPool->pushTask([job](int /*tid*/) { compile(job); });
+    } else {
+        // GL objects are tied to the context thread, compile them within the frame budget instead
+        _prewarmQueue.emplace_back(std::move(job));
+    }
+}
+
+void PipelineStateManager::prewarmPipelineStateByJS(uint32_t passHandle,
+                                                    gfx::Shader *shader,
+                                                    gfx::InputAssembler *inputAssembler,
+                                                    gfx::RenderPass *renderPass) {
+    const auto pass = GET_PASS(passHandle);
+    CC_ASSERT(pass);
+    PipelineStateManager::prewarmPipelineState(pass, shader, inputAssembler, renderPass);
+}
+
+void PipelineStateManager::processPrewarmQueue() {
+    vector<PrewarmJob> jobs;
+    {
+        std::lock_guard<std::mutex> lock(_PSOMutex);
+        if (_prewarmQueue.empty()) return;
+        // the jobs whose shaders the driver still compiles in parallel stay queued, they don't count against the budget
+        auto iter = _prewarmQueue.begin();
+        while (iter != _prewarmQueue.end() && jobs.size() < PREWARM_BUDGET_PER_FRAME) {
+            if (iter->info.shader->isReady()) {
+                jobs.emplace_back(std::move(*iter));
+                iter = _prewarmQueue.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+    }
+
+    for (const auto &job : jobs) {
+        compile(job);
+    }
+}
+
+void PipelineStateManager::compile(const PrewarmJob &job) {
+    {
+        std::lock_guard<std::mutex> lock(_PSOMutex);
+        auto iter = _prewarmStates.find(job.hash);
+        // already created on demand
+        if (iter == _prewarmStates.end()) return;
+        iter->second = true;
+    }
+
+    ShaderVariantCollector::record(job.info.shader);
+    auto pso = gfx::Device::getInstance()->createPipelineState(job.info);
+
+    std::lock_guard<std::mutex> lock(_PSOMutex);
+    _PSOHashMap[job.hash] = pso;
+    _prewarmStates.erase(job.hash);
+    ++_prewarmCompletedCount;
+}
+
+void PipelineStateManager::dropPendingPrewarms() {
+    // the pipeline states are created on demand instead, queued jobs find their entries removed and return
+    std::lock_guard<std::mutex> lock(_PSOMutex);
+    for (auto iter = _prewarmStates.begin(); iter != _prewarmStates.end();) {
+        iter = iter->second ? std::next(iter) : _prewarmStates.erase(iter);
+    }
+    _prewarmQueue.clear();
+}
+
+void PipelineStateManager::destroyPrewarmQueue() {
+    if (_memoryPressureHandlerID) {
+        MemoryPressure::removeHandler(_memoryPressureHandlerID);
+        _memoryPressureHandlerID = 0;
+    }
+
+    // the thread pool finishes the running job before joining
+    CC_SAFE_DELETE(_prewarmThreadPool);
+
+    std::lock_guard<std::mutex> lock(_PSOMutex);
+    _prewarmStates.clear();
+    _prewarmQueue.clear();
+    _prewarmCompletedCount = 0;
+}
+
+uint PipelineStateManager::getPrewarmPendingCount() {
+    std::lock_guard<std::mutex> lock(_PSOMutex);
+    return static_cast<uint>(_prewarmStates.size());
+}
+
+uint PipelineStateManager::getPrewarmCompletedCount() {
+    std::lock_guard<std::mutex> lock(_PSOMutex);
+    return _prewarmCompletedCount;
+}
+
 } // namespace pipeline
 } // namespace cc
@@ -1,8 +1,13 @@
 #pragma once
 
 #include "core/CoreStd.h"
+#include "gfx/GFXDef.h"
+#include "helper/FlatHashMap.h"
+#include <mutex>
 
 namespace cc {
+class ThreadPool;
+
 namespace gfx {
 class InputAssembler;
 class PipelineState;
@@ -12,19 +17,92 @@ class RenderPass;
 namespace pipeline {
 struct PassView;
 
+// Depth state overrides of a pass for the depth pre-pass, see ForwardPipeline::setDepthPrepassMode().
+enum class DepthPassVariant : uint {
+    NONE,
+    DEPTH_ONLY,  // color writes off, depth written with LESS_EQUAL
+    DEPTH_EQUAL, // depth tested with EQUAL against the pre-pass and not written
+};
+
 class CC_DLL PipelineStateManager {
 public:
+    // number of queued pre-warm requests compiled per frame when they can not be offloaded to a worker thread
+    static constexpr uint PREWARM_BUDGET_PER_FRAME = 4;
+
+    // Last pipeline state returned to a render queue, consecutive draws sharing a state skip the shared lookup.
+    // Every queue owns its own, so it needs no locking when queues are recorded in parallel.
+    struct LastHit {
+        uint hash = 0;
+        gfx::PipelineState *pso = nullptr;
+    };
+
+    // Returns nullptr while the pipeline state is being compiled in the background,
+    // callers are expected to skip the draw for this frame.
+    static gfx::PipelineState *getOrCreatePipelineState(const PassView *pass,
+                                                        gfx::Shader *shader,
+                                                        gfx::InputAssembler *inputAssembler,
+                                                        gfx::RenderPass *renderPass,
+                                                        uint subpass = 0);
     static gfx::PipelineState *getOrCreatePipelineState(const PassView *pass,
                                                         gfx::Shader *shader,
                                                         gfx::InputAssembler *inputAssembler,
-                                                        gfx::RenderPass *renderPass);
+                                                        gfx::RenderPass *renderPass,
+                                                        LastHit &lastHit,
+                                                        uint subpass = 0,
+                                                        DepthPassVariant variant = DepthPassVariant::NONE);
     static gfx::PipelineState *getOrCreatePipelineStateByJS(uint32_t passHandle,
                                                             gfx::Shader *shader,
                                                             gfx::InputAssembler *inputAssembler,
                                                             gfx::RenderPass *renderPass);
 
+    // Queues the pipeline state for compilation ahead of its first use.
+    // It is compiled on a worker thread on Vulkan and Metal, and within the per-frame budget otherwise,
+    // once the shader is ready. Draws using it are skipped until then.
+    static void prewarmPipelineState(const PassView *pass,
+                                     gfx::Shader *shader,
+                                     gfx::InputAssembler *inputAssembler,
+                                     gfx::RenderPass *renderPass);
+    static void prewarmPipelineStateByJS(uint32_t passHandle,
+                                         gfx::Shader *shader,
+                                         gfx::InputAssembler *inputAssembler,
+                                         gfx::RenderPass *renderPass);
+    // Compiles up to PREWARM_BUDGET_PER_FRAME queued pipeline states on the calling thread, called once per frame.
+    static void processPrewarmQueue();
+    // Waits for the background compilation and drops the requests not started yet.
+    static void destroyPrewarmQueue();
+
+    static uint getPrewarmPendingCount();
+    static uint getPrewarmCompletedCount();
+
 private:
-    static map<uint, gfx::PipelineState *> _PSOHashMap;
+    struct PrewarmJob {
+        uint hash = 0;
+        gfx::PipelineStateInfo info;
+    };
+
+    static uint getHash(const PassView *pass, gfx::Shader *shader, gfx::InputAssembler *inputAssembler, gfx::RenderPass *renderPass, uint subpass, DepthPassVariant variant = DepthPassVariant::NONE);
+    static gfx::PipelineStateInfo getPipelineStateInfo(const PassView *pass, gfx::Shader *shader, gfx::InputAssembler *inputAssembler, gfx::RenderPass *renderPass, uint subpass, DepthPassVariant variant = DepthPassVariant::NONE);
+    static gfx::PipelineState *getOrCreatePipelineState(uint hash,
+                                                        const PassView *pass,
+                                                        gfx::Shader *shader,
+                                                        gfx::InputAssembler *inputAssembler,
+                                                        gfx::RenderPass *renderPass,
+                                                        uint subpass,
+                                                        DepthPassVariant variant);
+    static void compile(const PrewarmJob &job);
+    // drops the prewarm requests whose compilation has not started, when memory runs low
+    static void dropPendingPrewarms();
+
+    static FlatHashMap<uint, gfx::PipelineState *> _PSOHashMap;
+    // render queues may be recorded on several threads at once
+    static std::mutex _PSOMutex;
+
+    // hash -> whether the compilation has started, entries are removed once the pipeline state is created
+    static map<uint, bool> _prewarmStates;
+    static vector<PrewarmJob> _prewarmQueue;
+    static ThreadPool *_prewarmThreadPool;
+    static uint _prewarmCompletedCount;
+    static uint32_t _memoryPressureHandlerID;
 };
 
 } // namespace pipeline
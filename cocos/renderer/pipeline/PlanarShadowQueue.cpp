@@ -21,6 +21,7 @@ namespace pipeline {
 PlanarShadowQueue::PlanarShadowQueue(RenderPipeline *pipeline)
 :_pipeline(static_cast<ForwardPipeline *>(pipeline)){
     _instancedQueue = CC_NEW(RenderInstancedQueue);
+    _batchedQueue = CC_NEW(RenderBatchedQueue);
 }
 
 void PlanarShadowQueue::gatherShadowPasses(Camera *camera, gfx::CommandBuffer *cmdBufferer) {
@@ -35,7 +36,10 @@ void PlanarShadowQueue::gatherShadowPasses(Camera *camera, gfx::CommandBuffer *c
     
     const auto models = scene->getModels();
     const auto modelCount = models[0];
-    auto *instancedBuffer = InstancedBuffer::get(shadowInfo->planarPass);
+    // the passes only differ from the planar one in their shader defines, the implants carry the variants
+    auto *instancedBuffer = InstancedBuffer::get(shadowInfo->instancePass);
+    auto *instancingShader = shadowInfo->getPlanarInstancingShader();
+    auto *batchingShader = shadowInfo->getPlanarBatchingShader();
 
     uint visibility = 0, lenght = 0;
     for (uint i = 1; i <= modelCount; i++) {
@@ -53,57 +57,64 @@ void PlanarShadowQueue::gatherShadowPasses(Camera *camera, gfx::CommandBuffer *c
 
                 const auto *attributesID = model->getInstancedAttributeID();
                 lenght = attributesID[0];
-                if (lenght > 0) {
-                    const auto *subModelID = model->getSubModelID();
-                    const auto subModelCount = subModelID[0];
-                    for (uint m = 1; m <= subModelCount; ++m) {
-                        const auto *subModel = model->getSubModelView(subModelID[m]);
-                        instancedBuffer->merge(model, subModel, m - 1);
+                const auto *subModelID = model->getSubModelID();
+                const auto subModelCount = subModelID[0];
+                for (uint m = 1; m <= subModelCount; ++m) {
+                    const auto *subModel = model->getSubModelView(subModelID[m]);
+                    if (lenght > 0 && instancingShader) {
+                        instancedBuffer->merge(model, subModel, 0, instancingShader);
                         _instancedQueue->add(instancedBuffer);
+                    } else if (batchingShader && subModel->getPassView(0)->getBatchingScheme() == BatchingSchemes::VB_MERGING) {
+                        // keyed by the sub-model pass as well, a batch only merges vertices of one layout
+                        auto *batchedBuffer = BatchedBuffer::get(shadowInfo->planarPass, subModel->passID[0]);
+                        batchedBuffer->setExclusiveDescriptorSets(true);
+                        batchedBuffer->merge(subModel, 0, model, batchingShader);
+                        _batchedQueue->add(batchedBuffer);
+                    } else {
+                        _pendingSubModels.emplace_back(subModel);
                     }
-                } else {
-                    _pendingModels.emplace_back(model);
                 }
             }
         }
     }
 
     _instancedQueue->uploadBuffers(cmdBufferer);
+    _batchedQueue->uploadBuffers(cmdBufferer);
 }
 
 void PlanarShadowQueue::clear() {
-    _pendingModels.clear();
+    _pendingSubModels.clear();
     if (_instancedQueue) _instancedQueue->clear();
+    if (_batchedQueue) _batchedQueue->clear();
 }
 
-void PlanarShadowQueue::recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuffer) {
+void PlanarShadowQueue::recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuffer, uint subpass) {
     const auto *shadowInfo = _pipeline->getShadows();
-    if (!shadowInfo->enabled || shadowInfo->getShadowType() != ShadowType::PLANAR || _pendingModels.empty()) { return; }
+    if (!shadowInfo->enabled || shadowInfo->getShadowType() != ShadowType::PLANAR) { return; }
 
-    _instancedQueue->recordCommandBuffer(device, renderPass, cmdBuffer);
+    _instancedQueue->recordCommandBuffer(device, renderPass, cmdBuffer, subpass);
+    _batchedQueue->recordCommandBuffer(device, renderPass, cmdBuffer, subpass);
+    if (_pendingSubModels.empty()) { return; }
 
     const auto *pass = shadowInfo->getPlanarShadowPass();
     cmdBuffer->bindDescriptorSet(MATERIAL_SET, pass->getDescriptorSet());
     auto *shader = shadowInfo->getPlanarShader();
 
-    for (auto model : _pendingModels) {
-        const auto subModelID = model->getSubModelID();
-        const auto subModelCount = subModelID[0];
-        for (unsigned m = 1; m <= subModelCount; ++m) {
-            const auto subModel = model->getSubModelView(subModelID[m]);
-            const auto ia = subModel->getInputAssembler();
-            const auto pso = PipelineStateManager::getOrCreatePipelineState(pass, shader, ia, renderPass);
-
-            cmdBuffer->bindPipelineState(pso);
-            cmdBuffer->bindDescriptorSet(LOCAL_SET, subModel->getDescriptorSet());
-            cmdBuffer->bindInputAssembler(ia);
-            cmdBuffer->draw(ia);
-        }
+    for (const auto *subModel : _pendingSubModels) {
+        const auto ia = subModel->getInputAssembler();
+        const auto pso = PipelineStateManager::getOrCreatePipelineState(pass, shader, ia, renderPass, subpass);
+        if (!pso) continue;
+
+        cmdBuffer->bindPipelineState(pso);
+        cmdBuffer->bindDescriptorSet(LOCAL_SET, subModel->getDescriptorSet());
+        cmdBuffer->bindInputAssembler(ia);
+        cmdBuffer->draw(ia);
     }
 }
 
 void PlanarShadowQueue::destroy() {
     CC_SAFE_DELETE(_instancedQueue);
+    CC_SAFE_DELETE(_batchedQueue);
 }
 }
 } // namespace cc
@@ -34,13 +34,17 @@ public:
 
     void clear();
     void gatherShadowPasses(Camera *camera , gfx::CommandBuffer *cmdBufferer);
-    void recordCommandBuffer(gfx::Device *, gfx::RenderPass *, gfx::CommandBuffer *);
+    void recordCommandBuffer(gfx::Device *, gfx::RenderPass *, gfx::CommandBuffer *, uint subpass = 0);
     void destroy();
-    
+
+    CC_INLINE const std::vector<const SubModelView *> &getPendingSubModels() const { return _pendingSubModels; }
+
 private:
     ForwardPipeline *_pipeline = nullptr;
     RenderInstancedQueue *_instancedQueue = nullptr;
-    std::vector<const ModelView *> _pendingModels;
+    RenderBatchedQueue *_batchedQueue = nullptr;
+    // drawn one by one, with no instancing nor batching
+    std::vector<const SubModelView *> _pendingSubModels;
 };
 } // namespace pipeline
 } // namespace cc
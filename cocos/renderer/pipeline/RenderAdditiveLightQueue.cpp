@@ -54,6 +54,17 @@ RenderAdditiveLightQueue::RenderAdditiveLightQueue(RenderPipeline *pipeline) : _
     _lightBufferData.resize(_lightBufferElementCount * _lightBufferCount);
     _dynamicOffsets.resize(1, 0);
 
+    _lightGlobalShadowOffset = ((UBOGlobal::SIZE + alignment - 1) / alignment) * alignment;
+    _lightGlobalStride = _lightGlobalShadowOffset + ((UBOShadow::SIZE + alignment - 1) / alignment) * alignment;
+    _lightGlobalSlotCount = _lightBufferCount;
+    _lightGlobalBuffer = device->createBuffer({
+        gfx::BufferUsageBit::UNIFORM | gfx::BufferUsageBit::TRANSFER_DST,
+        gfx::MemoryUsageBit::HOST | gfx::MemoryUsageBit::DEVICE,
+        _lightGlobalStride * _lightGlobalSlotCount,
+        _lightGlobalStride,
+    });
+    _lightGlobalBufferData.resize(_lightGlobalStride / sizeof(float) * _lightGlobalSlotCount);
+
     gfx::SamplerInfo info{
         gfx::Filter::LINEAR,
         gfx::Filter::LINEAR,
@@ -88,6 +99,7 @@ void RenderAdditiveLightQueue::recordCommandBuffer(gfx::Device *device, gfx::Ren
         const auto lights = lightPass.lights;
         auto *ia = subModel->getInputAssembler();
         auto *pso = PipelineStateManager::getOrCreatePipelineState(pass, shader, ia, renderPass);
+        if (!pso) continue;
         auto *descriptorSet = subModel->getDescriptorSet();
 
         cmdBuffer->bindPipelineState(pso);
@@ -140,20 +152,14 @@ void RenderAdditiveLightQueue::gatherLightPasses(const Camera *camera, gfx::Comm
     updateUBOs(camera, cmdBufferer);
     updateLightDescriptorSet(camera, cmdBufferer);
 
+    updateLightCullingStates();
+
     const auto &renderObjects = _pipeline->getRenderObjects();
     for (const auto &renderObject : renderObjects) {
         const auto model = renderObject.model;
         if (!getLightPassIndex(model, lightPassIndices)) continue;
 
-        _lightIndices.clear();
-        for (size_t i = 0; i < _validLights.size(); i++) {
-            const auto light = _validLights[i];
-            const bool isCulled = cullingLight(light, model);
-            if (!isCulled) {
-                _lightIndices.emplace_back(i);
-            }
-        }
-
+        gatherModelLights(model);
         if (_lightIndices.empty()) continue;
         const auto subModelArrayID = model->getSubModelID();
         const auto subModelCount = subModelArrayID[0];
@@ -199,13 +205,100 @@ void RenderAdditiveLightQueue::gatherLightPasses(const Camera *camera, gfx::Comm
     }
     _instancedQueue->uploadBuffers(cmdBufferer);
     _batchedQueue->uploadBuffers(cmdBufferer);
+
+    // forget models which left the scene
+    if (_modelLightCaches.size() > renderObjects.size() * 2) {
+        for (auto iter = _modelLightCaches.begin(); iter != _modelLightCaches.end();) {
+            iter = iter->second.lastFrame == _frameIndex ? std::next(iter) : _modelLightCaches.erase(iter);
+        }
+    }
+}
+
+void RenderAdditiveLightQueue::updateLightCullingStates() {
+    ++_frameIndex;
+
+    for (const auto *light : _validLights) {
+        auto iter = _lightCullingStates.find(light);
+        if (iter == _lightCullingStates.end()) {
+            iter = _lightCullingStates.emplace(light, LightCullingState()).first;
+            auto &state = iter->second;
+            if (_freeLightIDs.empty()) {
+                state.id = _lightIDCount++;
+            } else {
+                state.id = _freeLightIDs.back();
+                _freeLightIDs.pop_back();
+            }
+            state.changedFrame = _frameIndex;
+        }
+
+        // the range and angle may change without the node moving
+        auto &state = iter->second;
+        const auto *aabb = light->getAABB();
+        if (light->getNode()->flagsChanged || state.center != aabb->center || state.halfExtents != aabb->halfExtents ||
+            state.spotAngle != light->spotAngle) {
+            state.changedFrame = _frameIndex;
+            state.center = aabb->center;
+            state.halfExtents = aabb->halfExtents;
+            state.spotAngle = light->spotAngle;
+        }
+        state.lastFrame = _frameIndex;
+    }
+
+    // a recycled id belongs to a new light, which is tested against every model again
+    if (_lightCullingStates.size() > _validLights.size() * 2) {
+        for (auto iter = _lightCullingStates.begin(); iter != _lightCullingStates.end();) {
+            if (iter->second.lastFrame == _frameIndex) {
+                ++iter;
+                continue;
+            }
+            _freeLightIDs.emplace_back(iter->second.id);
+            iter = _lightCullingStates.erase(iter);
+        }
+    }
+}
+
+void RenderAdditiveLightQueue::gatherModelLights(const ModelView *model) {
+    _lightIndices.clear();
+
+    auto &cache = _modelLightCaches[model];
+    const auto *transform = model->transformID ? model->getTransform() : model->getNode();
+    const auto *bounds = model->worldBoundsID ? model->getWorldBounds() : nullptr;
+    // skinned models keep their transform while animating, but not their world bounds
+    if (!cache.lastFrame || (transform && transform->flagsChanged) ||
+        (bounds && (cache.center != bounds->center || cache.halfExtents != bounds->halfExtents))) {
+        cache.changedFrame = _frameIndex;
+        if (bounds) {
+            cache.center = bounds->center;
+            cache.halfExtents = bounds->halfExtents;
+        }
+    }
+    cache.lastFrame = _frameIndex;
+    if (cache.results.size() < _lightIDCount) cache.results.resize(_lightIDCount, 0);
+
+    for (size_t i = 0; i < _validLights.size(); i++) {
+        const auto *light = _validLights[i];
+        const auto &state = _lightCullingStates.at(light);
+        auto &result = cache.results[state.id];
+        if ((result >> 1) < std::max(cache.changedFrame, state.changedFrame)) {
+            result = _frameIndex << 1 | (cullingLight(light, model) ? 0 : 1);
+        }
+        if (result & 1) {
+            _lightIndices.emplace_back(i);
+        }
+    }
 }
 
 void RenderAdditiveLightQueue::destroy() {
+    for (auto &slot : _lightGlobalSlots) {
+        CC_SAFE_DESTROY(slot.globalUBOView);
+        CC_SAFE_DESTROY(slot.shadowUBOView);
+    }
+    _lightGlobalSlots.clear();
+    _lightSlotMap.clear();
+    CC_SAFE_DESTROY(_lightGlobalBuffer);
+
     for (auto &pair : _descriptorSetMap) {
         auto *descriptorSet = pair.second;
-        descriptorSet->getBuffer(UBOGlobal::BINDING)->destroy();
-        descriptorSet->getBuffer(UBOShadow::BINDING)->destroy();
         descriptorSet->getSampler(SHADOWMAP::BINDING)->destroy();
         descriptorSet->getTexture(SHADOWMAP::BINDING)->destroy();
         descriptorSet->getSampler(SPOT_LIGHTING_MAP::BINDING)->destroy();
@@ -213,6 +306,11 @@ void RenderAdditiveLightQueue::destroy() {
         descriptorSet->destroy();
     }
     _descriptorSetMap.clear();
+
+    _lightCullingStates.clear();
+    _modelLightCaches.clear();
+    _freeLightIDs.clear();
+    _lightIDCount = 0;
 }
 
 void RenderAdditiveLightQueue::clear() {
@@ -297,9 +395,11 @@ void RenderAdditiveLightQueue::updateLightDescriptorSet(const Camera *camera, gf
     const Light *mainLight = nullptr;
     if (scene->mainLightID) mainLight = scene->getMainLight();
 
+    uint usedSlotCount = 0;
     for (const auto *light : _validLights) {
         auto *descriptorSet = getOrCreateDescriptorSet(light);
         if (!descriptorSet) { return; }
+        const auto slot = _lightSlotMap.at(light);
 
         descriptorSet->bindSampler(SHADOWMAP::BINDING, _sampler);
         descriptorSet->bindSampler(SPOT_LIGHTING_MAP::BINDING, _sampler);
@@ -328,7 +428,7 @@ void RenderAdditiveLightQueue::updateLightDescriptorSet(const Camera *camera, gf
                 matShadowViewProj.multiply(matShadowView);
 
                 // shadow info
-                float shadowInfos[4] = {shadowInfo->size.x, shadowInfo->size.y, (float)shadowInfo->pcfType, shadowInfo->bias};
+                float shadowInfos[4] = {shadowInfo->size.x, shadowInfo->size.y, (float)_pipeline->getShadowPCFType(), shadowInfo->bias};
                 memcpy(_shadowUBO.data() + UBOShadow::MAT_LIGHT_VIEW_PROJ_OFFSET, matShadowViewProj.m, sizeof(matShadowViewProj));
                 memcpy(_shadowUBO.data() + UBOShadow::SHADOW_COLOR_OFFSET, &shadowInfo->color, sizeof(Vec4));
                 memcpy(_shadowUBO.data() + UBOShadow::SHADOW_INFO_OFFSET, &shadowInfos, sizeof(shadowInfos));
@@ -352,8 +452,14 @@ void RenderAdditiveLightQueue::updateLightDescriptorSet(const Camera *camera, gf
         }
         descriptorSet->update();
 
-        cmdBuffer->updateBuffer(descriptorSet->getBuffer(UBOShadow::BINDING), _shadowUBO.data(), UBOShadow::SIZE);
-        cmdBuffer->updateBuffer(descriptorSet->getBuffer(UBOGlobal::BINDING), _globalUBO.data(),UBOGlobal::SIZE);
+        auto *slotData = reinterpret_cast<uint8_t *>(_lightGlobalBufferData.data()) + slot * _lightGlobalStride;
+        memcpy(slotData, _globalUBO.data(), UBOGlobal::SIZE);
+        memcpy(slotData + _lightGlobalShadowOffset, _shadowUBO.data(), UBOShadow::SIZE);
+        usedSlotCount = std::max(usedSlotCount, slot + 1);
+    }
+
+    if (usedSlotCount) {
+        cmdBuffer->updateBuffer(_lightGlobalBuffer, _lightGlobalBufferData.data(), usedSlotCount * _lightGlobalStride);
     }
 }
 
@@ -512,23 +618,19 @@ gfx::DescriptorSet *RenderAdditiveLightQueue::getOrCreateDescriptorSet(const Lig
         auto *device = gfx::Device::getInstance();
         auto *descriptorSet = device->createDescriptorSet({_pipeline->getDescriptorSetLayout()});
 
-        auto globalUBO = device->createBuffer({
-            gfx::BufferUsageBit::UNIFORM | gfx::BufferUsageBit::TRANSFER_DST,
-            gfx::MemoryUsageBit::HOST | gfx::MemoryUsageBit::DEVICE,
-            UBOGlobal::SIZE,
-            UBOGlobal::SIZE,
-            gfx::BufferFlagBit::NONE,
-        });
-        descriptorSet->bindBuffer(UBOGlobal::BINDING, globalUBO);
-
-        auto shadowUBO = device->createBuffer({
-            gfx::BufferUsageBit::UNIFORM | gfx::BufferUsageBit::TRANSFER_DST,
-            gfx::MemoryUsageBit::HOST | gfx::MemoryUsageBit::DEVICE,
-            UBOShadow::SIZE,
-            UBOShadow::SIZE,
-            gfx::BufferFlagBit::NONE,
-        });
-        descriptorSet->bindBuffer(UBOShadow::BINDING, shadowUBO);
+        const auto slot = static_cast<uint>(_lightGlobalSlots.size());
+        if (slot >= _lightGlobalSlotCount) {
+            resizeLightGlobalBuffer(nextPow2(slot + 1));
+        }
+        const auto slotOffset = slot * _lightGlobalStride;
+        LightGlobalSlot lightSlot;
+        lightSlot.globalUBOView = device->createBuffer({_lightGlobalBuffer, slotOffset, UBOGlobal::SIZE});
+        lightSlot.shadowUBOView = device->createBuffer({_lightGlobalBuffer, slotOffset + _lightGlobalShadowOffset, UBOShadow::SIZE});
+        _lightGlobalSlots.emplace_back(lightSlot);
+        _lightSlotMap.emplace(light, slot);
+
+        descriptorSet->bindBuffer(UBOGlobal::BINDING, lightSlot.globalUBOView);
+        descriptorSet->bindBuffer(UBOShadow::BINDING, lightSlot.shadowUBOView);
 
         // Main light sampler binding
         descriptorSet->bindSampler(SHADOWMAP::BINDING, _sampler);
@@ -547,5 +649,22 @@ gfx::DescriptorSet *RenderAdditiveLightQueue::getOrCreateDescriptorSet(const Lig
     return _descriptorSetMap.at(light);
 }
 
+void RenderAdditiveLightQueue::resizeLightGlobalBuffer(uint slotCount) {
+    for (auto &slot : _lightGlobalSlots) {
+        slot.globalUBOView->destroy();
+        slot.shadowUBOView->destroy();
+    }
+
+    _lightGlobalSlotCount = slotCount;
+    _lightGlobalBuffer->resize(_lightGlobalStride * _lightGlobalSlotCount);
+    _lightGlobalBufferData.resize(_lightGlobalStride / sizeof(float) * _lightGlobalSlotCount);
+
+    for (uint i = 0; i < _lightGlobalSlots.size(); ++i) {
+        const auto slotOffset = i * _lightGlobalStride;
+        _lightGlobalSlots[i].globalUBOView->initialize({_lightGlobalBuffer, slotOffset, UBOGlobal::SIZE});
+        _lightGlobalSlots[i].shadowUBOView->initialize({_lightGlobalBuffer, slotOffset + _lightGlobalShadowOffset, UBOShadow::SIZE});
+    }
+}
+
 } // namespace pipeline
 } // namespace cc
@@ -44,7 +44,10 @@ private:
     void updateGlobalDescriptorSet(const Camera *camera, gfx::CommandBuffer *cmdBuffer);
     bool getLightPassIndex(const ModelView *model, vector<uint> &lightPassIndices) const;
     bool cullingLight(const Light *light, const ModelView *model);
+    void updateLightCullingStates();
+    void gatherModelLights(const ModelView *model);
     gfx::DescriptorSet *getOrCreateDescriptorSet(const Light *);
+    void resizeLightGlobalBuffer(uint slotCount);
 
 private:
     ForwardPipeline *_pipeline = nullptr;
@@ -63,10 +66,47 @@ private:
     gfx::Sampler *_sampler = nullptr;
 
     std::unordered_map<const Light *, gfx::DescriptorSet *> _descriptorSetMap;
+
+    // UBOGlobal and UBOShadow of every light live in one slot of a shared buffer
+    // bound through views, so all of them are uploaded with a single update per frame
+    struct LightGlobalSlot {
+        gfx::Buffer *globalUBOView = nullptr;
+        gfx::Buffer *shadowUBOView = nullptr;
+    };
+    std::unordered_map<const Light *, uint> _lightSlotMap;
+    vector<LightGlobalSlot> _lightGlobalSlots;
+    vector<float> _lightGlobalBufferData;
+    gfx::Buffer *_lightGlobalBuffer = nullptr;
+    uint _lightGlobalShadowOffset = 0;
+    uint _lightGlobalStride = 0;
+    uint _lightGlobalSlotCount = 0;
     std::array<float, UBOGlobal::COUNT> _globalUBO;
     std::array<float, UBOCamera::COUNT> _cameraUBO;
     std::array<float, UBOShadow::COUNT> _shadowUBO;
 
+    // Culling results are cached per model and light, a pair is only tested again once either of them
+    // changed since, so gathering costs what moved rather than models times lights.
+    struct LightCullingState {
+        uint id = 0;
+        uint changedFrame = 0;
+        uint lastFrame = 0;
+        Vec3 center;
+        Vec3 halfExtents;
+        float spotAngle = 0.0f;
+    };
+    struct ModelLightCache {
+        uint changedFrame = 0;
+        uint lastFrame = 0;
+        Vec3 center;
+        Vec3 halfExtents;
+        vector<uint> results; // per light id, the frame tested in shifted left by one, lowest bit set if lit
+    };
+    std::unordered_map<const Light *, LightCullingState> _lightCullingStates;
+    std::unordered_map<const ModelView *, ModelLightCache> _modelLightCaches;
+    vector<uint> _freeLightIDs;
+    uint _lightIDCount = 0;
+    uint _frameIndex = 0;
+
     float _fpScale = 0;
     bool _isHDR = false;
     uint _lightBufferStride = 0;
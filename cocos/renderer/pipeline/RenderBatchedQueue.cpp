@@ -1,6 +1,7 @@
 #include "RenderBatchedQueue.h"
 #include "BatchedBuffer.h"
 #include "PipelineStateManager.h"
+#include "base/FrameStats.h"
 #include "gfx/GFXBuffer.h"
 #include "gfx/GFXCommandBuffer.h"
 #include "helper/SharedMemory.h"
@@ -21,24 +22,35 @@ void RenderBatchedQueue::uploadBuffers(gfx::CommandBuffer *cmdBuffer) {
         for (auto &batch : batches) {
             if (!batch.mergeCount) continue;
 
-            auto i = 0u;
-            for (auto vb : batch.vbs) {
-                cmdBuffer->updateBuffer(vb, batch.vbDatas[i++], vb->getSize());
+            if (batch.isVertexDirty) {
+                auto i = 0u;
+                for (auto vb : batch.vbs) {
+                    cmdBuffer->updateBuffer(vb, batch.vbDatas[i++], batch.vbCount * vb->getStride());
+                }
+                batch.isVertexDirty = false;
+            }
+            if (batch.isIndexDirty) {
+                cmdBuffer->updateBuffer(batch.indexBuffer, batch.indexData, batch.vbCount * sizeof(float));
+                batch.isIndexDirty = false;
+            }
+            if (batch.isUBODirty) {
+                cmdBuffer->updateBuffer(batch.ubo, batch.uboData.data(), batch.ubo->getSize());
+                batch.isUBODirty = false;
             }
-            cmdBuffer->updateBuffer(batch.indexBuffer, batch.indexData, batch.indexBuffer->getSize());
-            cmdBuffer->updateBuffer(batch.ubo, batch.uboData.data(), batch.ubo->getSize());
         }
     }
 }
 
-void RenderBatchedQueue::recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuffer) {
+void RenderBatchedQueue::recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuffer, uint subpass) {
+    uint mergeCount = 0;
     for (auto batchedBuffer : _queues) {
         bool boundPSO = false;
         const auto &batches = batchedBuffer->getBatches();
         for (const auto &batch : batches) {
             if (!batch.mergeCount) continue;
             if (!boundPSO) {
-                auto pso = PipelineStateManager::getOrCreatePipelineState(batch.pass, batch.shader, batch.ia, renderPass);
+                auto pso = PipelineStateManager::getOrCreatePipelineState(batch.pass, batch.shader, batch.ia, renderPass, subpass);
+                if (!pso) continue;
                 cmdBuffer->bindPipelineState(pso);
                 cmdBuffer->bindDescriptorSet(MATERIAL_SET, batch.pass->getDescriptorSet());
                 boundPSO = true;
@@ -47,8 +59,10 @@ void RenderBatchedQueue::recordCommandBuffer(gfx::Device *device, gfx::RenderPas
             cmdBuffer->bindDescriptorSet(LOCAL_SET, batch.descriptorSet, batchedBuffer->getDynamicOffset());
             cmdBuffer->bindInputAssembler(batch.ia);
             cmdBuffer->draw(batch.ia);
+            mergeCount += batch.mergeCount;
         }
     }
+    CC_FRAME_STAT_ADD(BATCHED_MERGES, mergeCount);
 }
 
 void RenderBatchedQueue::add(BatchedBuffer *batchedBuffer) {
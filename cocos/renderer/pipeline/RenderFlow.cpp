@@ -1,5 +1,7 @@
 #include "RenderFlow.h"
+#include "RenderPipeline.h"
 #include "RenderStage.h"
+#include "helper/GPUTimer.h"
 
 namespace cc {
 namespace pipeline {
@@ -27,8 +29,11 @@ void RenderFlow::activate(RenderPipeline *pipeline) {
 }
 
 void RenderFlow::render(Camera *camera) {
-    for (const auto stage : _stages)
+    GPUTimer *gpuTimer = _pipeline->getGPUTimer();
+    for (const auto stage : _stages) {
         stage->render(camera);
+        if (gpuTimer) gpuTimer->endStage(stage);
+    }
 }
 
 void RenderFlow::destroy() {
@@ -29,6 +29,7 @@ public:
     CC_INLINE const String &getName() const { return _name; }
     CC_INLINE uint getPriority() const { return _priority; }
     CC_INLINE uint getTag() const { return _tag; }
+    CC_INLINE const RenderStageList &getStages() const { return _stages; }
 
 protected:
     RenderStageList _stages;
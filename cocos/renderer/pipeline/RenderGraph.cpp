@@ -0,0 +1,392 @@
+#include "RenderGraph.h"
+#include "base/memory/FrameAlloc.h"
+#include "gfx/GFXCommandBuffer.h"
+#include "gfx/GFXDevice.h"
+#include "gfx/GFXFramebuffer.h"
+#include "gfx/GFXRenderPass.h"
+#include "gfx/GFXTexture.h"
+
+namespace cc {
+namespace pipeline {
+namespace {
+CC_INLINE void hashCombine(size_t &hash, size_t value) {
+    hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+}
+
+size_t getRenderPassHash(const gfx::RenderPassInfo &info) {
+    size_t hash = info.colorAttachments.size();
+    for (const auto &color : info.colorAttachments) {
+        hashCombine(hash, static_cast<size_t>(color.format));
+        hashCombine(hash, static_cast<size_t>(color.loadOp));
+        hashCombine(hash, static_cast<size_t>(color.storeOp));
+        hashCombine(hash, static_cast<size_t>(color.beginLayout));
+        hashCombine(hash, static_cast<size_t>(color.endLayout));
+    }
+    const auto &depthStencil = info.depthStencilAttachment;
+    hashCombine(hash, static_cast<size_t>(depthStencil.format));
+    hashCombine(hash, static_cast<size_t>(depthStencil.depthLoadOp));
+    hashCombine(hash, static_cast<size_t>(depthStencil.depthStoreOp));
+    hashCombine(hash, static_cast<size_t>(depthStencil.stencilLoadOp));
+    hashCombine(hash, static_cast<size_t>(depthStencil.stencilStoreOp));
+    hashCombine(hash, static_cast<size_t>(depthStencil.beginLayout));
+    hashCombine(hash, static_cast<size_t>(depthStencil.endLayout));
+    return hash;
+}
+
+CC_INLINE bool isSameDesc(const RenderGraphTextureDesc &lhs, const RenderGraphTextureDesc &rhs) {
+    return lhs.format == rhs.format && lhs.width == rhs.width && lhs.height == rhs.height && lhs.usage == rhs.usage;
+}
+} // namespace
+
+void RenderGraph::PassBuilder::writeColor(uint texture, const gfx::Color &clearColor) {
+    if (texture >= _graph->_textures.size()) return;
+    auto &pass = _graph->_passes[_pass];
+    Attachment attachment;
+    attachment.texture = texture;
+    attachment.clearColor = clearColor;
+    pass.colors.push_back(attachment);
+    _graph->_textures[texture].desc.usage |= gfx::TextureUsageBit::COLOR_ATTACHMENT;
+}
+
+void RenderGraph::PassBuilder::writeDepthStencil(uint texture, float clearDepth, int clearStencil) {
+    if (texture >= _graph->_textures.size()) return;
+    auto &attachment = _graph->_passes[_pass].depthStencil;
+    attachment.texture = texture;
+    attachment.clearDepth = clearDepth;
+    attachment.clearStencil = clearStencil;
+    _graph->_textures[texture].desc.usage |= gfx::TextureUsageBit::DEPTH_STENCIL_ATTACHMENT;
+}
+
+void RenderGraph::PassBuilder::read(uint texture) {
+    if (texture >= _graph->_textures.size()) return;
+    _graph->_passes[_pass].reads.push_back(texture);
+    _graph->_textures[texture].desc.usage |= gfx::TextureUsageBit::SAMPLED;
+}
+
+void RenderGraph::PassBuilder::setSideEffect() {
+    _graph->_passes[_pass].hasSideEffect = true;
+}
+
+uint RenderGraph::createTexture(const String &name, const RenderGraphTextureDesc &desc) {
+    VirtualTexture texture;
+    texture.name = name;
+    texture.desc = desc;
+    _textures.push_back(texture);
+    return static_cast<uint>(_textures.size() - 1);
+}
+
+uint RenderGraph::importTexture(const String &name, gfx::Texture *texture, gfx::TextureLayout finalLayout, bool isCleared) {
+    VirtualTexture imported;
+    imported.name = name;
+    imported.desc = {texture->getFormat(), texture->getWidth(), texture->getHeight(), texture->getUsage()};
+    imported.texture = texture;
+    imported.finalLayout = finalLayout;
+    imported.isImported = true;
+    imported.isCleared = isCleared;
+    _textures.push_back(imported);
+    return static_cast<uint>(_textures.size() - 1);
+}
+
+void RenderGraph::addPass(const String &name, const SetupCallback &setup, const ExecuteCallback &execute) {
+    Pass pass;
+    pass.name = name;
+    pass.execute = execute;
+    _passes.push_back(pass);
+    _isCompiled = false;
+
+    PassBuilder builder(this, static_cast<uint>(_passes.size() - 1));
+    setup(builder);
+}
+
+gfx::Texture *RenderGraph::getTexture(uint texture) const {
+    return texture < _textures.size() ? _textures[texture].texture : nullptr;
+}
+
+void RenderGraph::compile() {
+    if (!_device) _device = gfx::Device::getInstance();
+
+    cullPasses();
+    computeLifetimes();
+    allocateTextures();
+    createRenderPasses();
+    _isCompiled = true;
+}
+
+void RenderGraph::cullPasses() {
+    // walks back from the passes writing imported textures, everything they consume stays alive
+    FrameVector<bool> isNeeded(_textures.size(), false);
+    for (size_t p = _passes.size(); p-- > 0;) {
+        auto &pass = _passes[p];
+        bool isAlive = pass.hasSideEffect;
+        for (const auto &color : pass.colors) {
+            isAlive = isAlive || _textures[color.texture].isImported || isNeeded[color.texture];
+        }
+        if (pass.depthStencil.texture != INVALID_HANDLE) {
+            const auto texture = pass.depthStencil.texture;
+            isAlive = isAlive || _textures[texture].isImported || isNeeded[texture];
+        }
+        pass.isCulled = !isAlive;
+        if (!isAlive) continue;
+
+        // an earlier writer provides the content this pass loads
+        for (const auto &color : pass.colors) isNeeded[color.texture] = true;
+        if (pass.depthStencil.texture != INVALID_HANDLE) isNeeded[pass.depthStencil.texture] = true;
+        for (auto texture : pass.reads) isNeeded[texture] = true;
+    }
+}
+
+void RenderGraph::computeLifetimes() {
+    for (auto &texture : _textures) {
+        texture.firstPass = INVALID_HANDLE;
+        texture.lastPass = 0;
+    }
+    auto use = [this](uint texture, uint pass) {
+        auto &virtualTexture = _textures[texture];
+        virtualTexture.firstPass = std::min(virtualTexture.firstPass, pass);
+        virtualTexture.lastPass = std::max(virtualTexture.lastPass, pass);
+    };
+    for (uint p = 0; p < _passes.size(); ++p) {
+        const auto &pass = _passes[p];
+        if (pass.isCulled) continue;
+        for (const auto &color : pass.colors) use(color.texture, p);
+        if (pass.depthStencil.texture != INVALID_HANDLE) use(pass.depthStencil.texture, p);
+        for (auto texture : pass.reads) use(texture, p);
+    }
+}
+
+void RenderGraph::allocateTextures() {
+    for (uint p = 0; p < _passes.size(); ++p) {
+        if (_passes[p].isCulled) continue;
+        for (auto &texture : _textures) {
+            if (texture.isImported || texture.firstPass != p) continue;
+            texture.pooledIndex = acquirePooledTexture(texture.desc);
+            texture.texture = _pool[texture.pooledIndex].texture;
+        }
+        // textures whose last use is this pass hand their memory to the ones starting later
+        for (auto &texture : _textures) {
+            if (!texture.isImported && texture.pooledIndex >= 0 && texture.lastPass == p) {
+                _pool[texture.pooledIndex].isInUse = false;
+            }
+        }
+    }
+}
+
+int RenderGraph::acquirePooledTexture(const RenderGraphTextureDesc &desc) {
+    for (size_t i = 0; i < _pool.size(); ++i) {
+        auto &pooled = _pool[i];
+        if (pooled.isInUse || !isSameDesc(pooled.desc, desc)) continue;
+        pooled.isInUse = true;
+        pooled.idleExecutions = 0;
+        return static_cast<int>(i);
+    }
+
+    PooledTexture pooled;
+    pooled.desc = desc;
+    pooled.texture = _device->createTexture({
+        gfx::TextureType::TEX2D,
+        desc.usage,
+        desc.format,
+        desc.width,
+        desc.height,
+    });
+    pooled.isInUse = true;
+    _pool.push_back(pooled);
+    return static_cast<int>(_pool.size() - 1);
+}
+
+bool RenderGraph::isWrittenBefore(uint texture, uint pass) const {
+    for (uint p = 0; p < pass; ++p) {
+        const auto &other = _passes[p];
+        if (other.isCulled) continue;
+        if (other.depthStencil.texture == texture) return true;
+        for (const auto &color : other.colors) {
+            if (color.texture == texture) return true;
+        }
+    }
+    return false;
+}
+
+bool RenderGraph::isUsedAfter(uint texture, uint pass, bool *isRead) const {
+    for (uint p = pass + 1; p < _passes.size(); ++p) {
+        const auto &other = _passes[p];
+        if (other.isCulled) continue;
+        bool isWritten = other.depthStencil.texture == texture;
+        for (const auto &color : other.colors) {
+            isWritten = isWritten || color.texture == texture;
+        }
+        if (isWritten) {
+            *isRead = false;
+            return true;
+        }
+        if (std::find(other.reads.begin(), other.reads.end(), texture) != other.reads.end()) {
+            *isRead = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+void RenderGraph::setupAttachment(uint texture, uint pass, bool isDepthStencil, gfx::LoadOp *loadOp, gfx::StoreOp *storeOp,
+                                  gfx::TextureLayout *beginLayout, gfx::TextureLayout *endLayout) {
+    auto &virtualTexture = _textures[texture];
+    const auto attachmentLayout = isDepthStencil ? gfx::TextureLayout::DEPTH_STENCIL_ATTACHMENT_OPTIMAL : gfx::TextureLayout::COLOR_ATTACHMENT_OPTIMAL;
+
+    // imported textures enter the graph in the layout they left it with
+    if (virtualTexture.firstPass == pass) {
+        virtualTexture.layout = virtualTexture.isImported ? virtualTexture.finalLayout : gfx::TextureLayout::UNDEFINED;
+    }
+    const bool hasContent = isWrittenBefore(texture, pass) || (virtualTexture.isImported && !virtualTexture.isCleared);
+    *loadOp = hasContent ? gfx::LoadOp::LOAD : gfx::LoadOp::CLEAR;
+    *beginLayout = hasContent ? virtualTexture.layout : gfx::TextureLayout::UNDEFINED;
+
+    bool isRead = false;
+    const bool isUsed = isUsedAfter(texture, pass, &isRead);
+    *storeOp = isUsed || virtualTexture.isImported ? gfx::StoreOp::STORE : gfx::StoreOp::DISCARD;
+    if (isUsed) {
+        *endLayout = isRead ? gfx::TextureLayout::SHADER_READONLY_OPTIMAL : attachmentLayout;
+    } else {
+        *endLayout = virtualTexture.isImported ? virtualTexture.finalLayout : attachmentLayout;
+    }
+    virtualTexture.layout = *endLayout;
+}
+
+void RenderGraph::createRenderPasses() {
+    for (uint p = 0; p < _passes.size(); ++p) {
+        auto &pass = _passes[p];
+        if (pass.isCulled) continue;
+
+        gfx::RenderPassInfo info;
+        gfx::TextureList colorTextures;
+        bool isImported = false;
+        for (const auto &color : pass.colors) {
+            gfx::ColorAttachment attachment;
+            attachment.format = _textures[color.texture].desc.format;
+            setupAttachment(color.texture, p, false, &attachment.loadOp, &attachment.storeOp, &attachment.beginLayout, &attachment.endLayout);
+            info.colorAttachments.push_back(attachment);
+            colorTextures.push_back(_textures[color.texture].texture);
+            isImported = isImported || _textures[color.texture].isImported;
+        }
+
+        gfx::Texture *depthStencilTexture = nullptr;
+        if (pass.depthStencil.texture != INVALID_HANDLE) {
+            const auto texture = pass.depthStencil.texture;
+            auto &attachment = info.depthStencilAttachment;
+            attachment.format = _textures[texture].desc.format;
+            setupAttachment(texture, p, true, &attachment.depthLoadOp, &attachment.depthStoreOp, &attachment.beginLayout, &attachment.endLayout);
+            attachment.stencilLoadOp = attachment.depthLoadOp;
+            attachment.stencilStoreOp = attachment.depthStoreOp;
+            depthStencilTexture = _textures[texture].texture;
+            isImported = isImported || _textures[texture].isImported;
+        } else {
+            info.depthStencilAttachment.format = gfx::Format::UNKNOWN;
+        }
+
+        pass.renderPass = getOrCreateRenderPass(info);
+        pass.framebuffer = getOrCreateFramebuffer(pass.renderPass, colorTextures, depthStencilTexture, isImported);
+    }
+}
+
+gfx::RenderPass *RenderGraph::getOrCreateRenderPass(const gfx::RenderPassInfo &info) {
+    const auto hash = getRenderPassHash(info);
+    auto iter = _renderPasses.find(hash);
+    if (iter != _renderPasses.end()) return iter->second;
+
+    auto *renderPass = _device->createRenderPass(info);
+    _renderPasses.emplace(hash, renderPass);
+    return renderPass;
+}
+
+gfx::Framebuffer *RenderGraph::getOrCreateFramebuffer(gfx::RenderPass *renderPass, const gfx::TextureList &colors, gfx::Texture *depthStencil, bool isImported) {
+    // imported textures may be destroyed and their addresses reused, don't key anything on them
+    if (isImported) {
+        auto *framebuffer = _device->createFramebuffer({renderPass, colors, depthStencil, {}});
+        _importedFramebuffers.push_back(framebuffer);
+        return framebuffer;
+    }
+
+    vector<const void *> key;
+    key.push_back(renderPass);
+    key.insert(key.end(), colors.begin(), colors.end());
+    key.push_back(depthStencil);
+    auto iter = _framebuffers.find(key);
+    if (iter != _framebuffers.end()) return iter->second;
+
+    auto *framebuffer = _device->createFramebuffer({renderPass, colors, depthStencil, {}});
+    _framebuffers.emplace(std::move(key), framebuffer);
+    return framebuffer;
+}
+
+void RenderGraph::destroyFramebuffers(const gfx::Texture *texture) {
+    for (auto iter = _framebuffers.begin(); iter != _framebuffers.end();) {
+        const auto &key = iter->first;
+        if (std::find(key.begin() + 1, key.end(), texture) == key.end()) {
+            ++iter;
+            continue;
+        }
+        CC_SAFE_DESTROY(iter->second);
+        iter = _framebuffers.erase(iter);
+    }
+}
+
+void RenderGraph::execute(gfx::CommandBuffer *cmdBuff) {
+    if (!_isCompiled) compile();
+
+    gfx::ColorList clearColors;
+    for (auto &pass : _passes) {
+        if (pass.isCulled) continue;
+
+        clearColors.clear();
+        for (const auto &color : pass.colors) clearColors.push_back(color.clearColor);
+        const auto &depthStencil = pass.depthStencil;
+        const auto firstTexture = pass.colors.empty() ? depthStencil.texture : pass.colors[0].texture;
+        const auto &desc = _textures[firstTexture].desc;
+        gfx::Rect renderArea = {0, 0, desc.width, desc.height};
+
+        cmdBuff->beginRenderPass(pass.renderPass, pass.framebuffer, renderArea, clearColors, depthStencil.clearDepth, depthStencil.clearStencil);
+        pass.execute(*this, pass.renderPass, cmdBuff);
+        cmdBuff->endRenderPass();
+    }
+}
+
+void RenderGraph::reset() {
+    for (auto *framebuffer : _importedFramebuffers) {
+        CC_SAFE_DESTROY(framebuffer);
+    }
+    _importedFramebuffers.clear();
+
+    for (auto iter = _pool.begin(); iter != _pool.end();) {
+        auto &pooled = *iter;
+        pooled.isInUse = false;
+        if (++pooled.idleExecutions <= MAX_IDLE_EXECUTIONS) {
+            ++iter;
+            continue;
+        }
+        destroyFramebuffers(pooled.texture);
+        CC_SAFE_DESTROY(pooled.texture);
+        iter = _pool.erase(iter);
+    }
+
+    _passes.clear();
+    _textures.clear();
+    _isCompiled = false;
+}
+
+void RenderGraph::destroy() {
+    reset();
+
+    for (auto &pair : _framebuffers) {
+        CC_SAFE_DESTROY(pair.second);
+    }
+    _framebuffers.clear();
+    for (auto &pooled : _pool) {
+        CC_SAFE_DESTROY(pooled.texture);
+    }
+    _pool.clear();
+    for (auto &pair : _renderPasses) {
+        CC_SAFE_DESTROY(pair.second);
+    }
+    _renderPasses.clear();
+}
+
+} // namespace pipeline
+} // namespace cc
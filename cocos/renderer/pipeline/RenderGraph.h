@@ -0,0 +1,142 @@
+#pragma once
+
+#include <functional>
+
+#include "Define.h"
+
+namespace cc {
+
+namespace gfx {
+class Framebuffer;
+} // namespace gfx
+
+namespace pipeline {
+
+struct CC_DLL RenderGraphTextureDesc {
+    gfx::Format format = gfx::Format::UNKNOWN;
+    uint width = 0;
+    uint height = 0;
+    // usages besides the ones derived from the passes, e.g. TRANSFER_SRC for textures copied outside the graph
+    gfx::TextureUsage usage = gfx::TextureUsageBit::NONE;
+};
+
+// Passes declare the textures they render into and sample from, the graph derives everything else once
+// they are all added: passes whose results nobody consumes are culled, transient textures live from their
+// first to their last use and share pooled textures with the ones whose lifetimes don't overlap, and the
+// load and store ops and the begin and end layouts of every attachment follow from the neighbouring uses.
+// GFX has no memory aliasing between resources, so aliasing works on whole textures of the same
+// description. Passes are recorded in the order they were added.
+class CC_DLL RenderGraph : public Object {
+public:
+    static constexpr uint INVALID_HANDLE = UINT_MAX;
+    // pooled textures no graph used for this many executions are destroyed
+    static constexpr uint MAX_IDLE_EXECUTIONS = 60;
+
+    class CC_DLL PassBuilder {
+    public:
+        // The clear values only apply where the attachment has no content from earlier passes.
+        void writeColor(uint texture, const gfx::Color &clearColor = {0.0f, 0.0f, 0.0f, 1.0f});
+        void writeDepthStencil(uint texture, float clearDepth = 1.0f, int clearStencil = 0);
+        void read(uint texture);
+        // Keeps passes with effects outside of the graph, such as writing buffers, from being culled.
+        void setSideEffect();
+
+    private:
+        friend class RenderGraph;
+        PassBuilder(RenderGraph *graph, uint pass) : _graph(graph), _pass(pass) {}
+
+        RenderGraph *_graph = nullptr;
+        uint _pass = 0;
+    };
+
+    using SetupCallback = std::function<void(PassBuilder &builder)>;
+    using ExecuteCallback = std::function<void(RenderGraph &graph, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff)>;
+
+    RenderGraph() = default;
+    ~RenderGraph() = default;
+
+    uint createTexture(const String &name, const RenderGraphTextureDesc &desc);
+    // Imported textures outlive the graph, they keep their content and end in the final layout.
+    // Loading is the default for their first write, a cleared import passes isCleared.
+    uint importTexture(const String &name, gfx::Texture *texture, gfx::TextureLayout finalLayout, bool isCleared = false);
+    void addPass(const String &name, const SetupCallback &setup, const ExecuteCallback &execute);
+
+    void compile();
+    void execute(gfx::CommandBuffer *cmdBuff);
+    // Drops the passes and textures of the last execution, the pooled textures stay for the next one.
+    void reset();
+    void destroy();
+
+    // Only valid while the graph executes, transient textures are shared with other passes afterwards.
+    gfx::Texture *getTexture(uint texture) const;
+    CC_INLINE bool isPassCulled(uint pass) const { return pass >= _passes.size() || _passes[pass].isCulled; }
+
+private:
+    struct Attachment {
+        uint texture = INVALID_HANDLE;
+        gfx::Color clearColor;
+        float clearDepth = 1.0f;
+        int clearStencil = 0;
+    };
+
+    struct Pass {
+        String name;
+        vector<Attachment> colors;
+        Attachment depthStencil;
+        vector<uint> reads;
+        ExecuteCallback execute;
+        bool hasSideEffect = false;
+        bool isCulled = false;
+        gfx::RenderPass *renderPass = nullptr;
+        gfx::Framebuffer *framebuffer = nullptr;
+    };
+
+    struct VirtualTexture {
+        String name;
+        RenderGraphTextureDesc desc;
+        gfx::Texture *texture = nullptr;
+        gfx::TextureLayout finalLayout = gfx::TextureLayout::UNDEFINED;
+        bool isImported = false;
+        bool isCleared = false;
+        uint firstPass = INVALID_HANDLE;
+        uint lastPass = 0;
+        int pooledIndex = -1;
+        gfx::TextureLayout layout = gfx::TextureLayout::UNDEFINED; // left by the last attachment while compiling
+    };
+
+    struct PooledTexture {
+        RenderGraphTextureDesc desc;
+        gfx::Texture *texture = nullptr;
+        uint idleExecutions = 0;
+        bool isInUse = false;
+    };
+
+    friend class PassBuilder;
+
+    void cullPasses();
+    void computeLifetimes();
+    void allocateTextures();
+    void createRenderPasses();
+    int acquirePooledTexture(const RenderGraphTextureDesc &desc);
+    gfx::RenderPass *getOrCreateRenderPass(const gfx::RenderPassInfo &info);
+    gfx::Framebuffer *getOrCreateFramebuffer(gfx::RenderPass *renderPass, const gfx::TextureList &colors, gfx::Texture *depthStencil, bool isImported);
+    void destroyFramebuffers(const gfx::Texture *texture);
+    bool isUsedAfter(uint texture, uint pass, bool *isRead) const;
+    bool isWrittenBefore(uint texture, uint pass) const;
+    void setupAttachment(uint texture, uint pass, bool isDepthStencil, gfx::LoadOp *loadOp, gfx::StoreOp *storeOp,
+                         gfx::TextureLayout *beginLayout, gfx::TextureLayout *endLayout);
+
+    gfx::Device *_device = nullptr;
+    vector<Pass> _passes;
+    vector<VirtualTexture> _textures;
+    vector<PooledTexture> _pool;
+    bool _isCompiled = false;
+
+    std::unordered_map<size_t, gfx::RenderPass *> _renderPasses;
+    // framebuffers of pooled textures are kept with them, the ones with imported textures only for one execution
+    map<vector<const void *>, gfx::Framebuffer *> _framebuffers;
+    vector<gfx::Framebuffer *> _importedFramebuffers;
+};
+
+} // namespace pipeline
+} // namespace cc
@@ -1,11 +1,25 @@
 #include "RenderInstancedQueue.h"
 #include "InstancedBuffer.h"
 #include "PipelineStateManager.h"
+#include "base/FrameStats.h"
+#include "gfx/GFXBuffer.h"
 #include "gfx/GFXCommandBuffer.h"
+#include "gfx/GFXDevice.h"
+#include "gfx/GFXInputAssembler.h"
 #include "helper/SharedMemory.h"
 
 namespace cc {
 namespace pipeline {
+namespace {
+// the argument layout of a buffer is picked from its first draw, only indexed draws are packed
+CC_INLINE bool isIndirectItem(const InstancedItem &instance) {
+    return instance.count && instance.ia->getIndexCount() && instance.ia->getIndexBuffer();
+}
+} // namespace
+
+RenderInstancedQueue::~RenderInstancedQueue() {
+    CC_SAFE_DESTROY(_indirectBuffer);
+}
 
 void RenderInstancedQueue::clear() {
     for (auto it : _queues) {
@@ -20,9 +34,47 @@ void RenderInstancedQueue::uploadBuffers(gfx::CommandBuffer *cmdBuffer) {
             instanceBuffer->uploadBuffers(cmdBuffer);
         }
     }
+
+    auto *device = gfx::Device::getInstance();
+    if (!device->hasFeature(gfx::Feature::DRAW_INDIRECT)) return;
+
+    // arguments are packed in the order recordCommandBuffer visits the items
+    _drawInfos.clear();
+    for (auto instanceBuffer : _queues) {
+        if (!instanceBuffer->hasPendingModels()) continue;
+        for (const auto &instance : instanceBuffer->getInstances()) {
+            if (!isIndirectItem(instance)) continue;
+            gfx::DrawInfo drawInfo;
+            drawInfo.indexCount = instance.ia->getIndexCount();
+            drawInfo.firstIndex = instance.ia->getFirstIndex();
+            drawInfo.vertexOffset = instance.ia->getVertexOffset();
+            drawInfo.firstVertex = instance.ia->getFirstVertex();
+            drawInfo.vertexCount = instance.ia->getVertexCount();
+            drawInfo.instanceCount = instance.count;
+            _drawInfos.push_back(drawInfo);
+        }
+    }
+    if (_drawInfos.empty()) return;
+
+    const auto size = static_cast<uint>(_drawInfos.size() * sizeof(gfx::DrawInfo));
+    if (!_indirectBuffer) {
+        _indirectBuffer = device->createBuffer({
+            gfx::BufferUsageBit::INDIRECT | gfx::BufferUsageBit::TRANSFER_DST,
+            gfx::MemoryUsageBit::HOST | gfx::MemoryUsageBit::DEVICE,
+            size,
+            sizeof(gfx::DrawInfo),
+        });
+    } else if (_indirectBuffer->getSize() < size) {
+        _indirectBuffer->resize(std::max(size, _indirectBuffer->getSize() * 2));
+    }
+    // backends translate the arguments starting from the offset, always write them from the first one
+    cmdBuffer->updateBuffer(_indirectBuffer, _drawInfos.data(), size, 0);
 }
 
-void RenderInstancedQueue::recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuffer) {
+void RenderInstancedQueue::recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuffer, uint subpass) {
+    const bool isIndirect = _indirectBuffer && !_drawInfos.empty() && device->hasFeature(gfx::Feature::DRAW_INDIRECT);
+    uint drawIndex = 0;
+    uint mergeCount = 0;
     for (auto instanceBuffer : _queues) {
         if (!instanceBuffer->hasPendingModels()) continue;
 
@@ -35,16 +87,26 @@ void RenderInstancedQueue::recordCommandBuffer(gfx::Device *device, gfx::RenderP
             if (!instance.count) {
                 continue;
             }
-            auto pso = PipelineStateManager::getOrCreatePipelineState(pass, instance.shader, instance.ia, renderPass);
+            // skipped draws still own their slot of the packed arguments
+            const bool isIndirectDraw = isIndirect && isIndirectItem(instance);
+            const uint argument = isIndirectDraw ? drawIndex++ : 0;
+            auto pso = PipelineStateManager::getOrCreatePipelineState(pass, instance.shader, instance.ia, renderPass, _lastPSOHit, subpass);
+            if (!pso) continue;
             if (lastPSO != pso) {
                 cmdBuffer->bindPipelineState(pso);
                 lastPSO = pso;
             }
             cmdBuffer->bindDescriptorSet(LOCAL_SET, instance.descriptorSet, instanceBuffer->dynamicOffsets());
             cmdBuffer->bindInputAssembler(instance.ia);
-            cmdBuffer->draw(instance.ia);
+            if (isIndirectDraw) {
+                cmdBuffer->drawIndirect(instance.ia, _indirectBuffer, argument, 1);
+            } else {
+                cmdBuffer->draw(instance.ia);
+            }
+            mergeCount += instance.count;
         }
     }
+    CC_FRAME_STAT_ADD(INSTANCED_MERGES, mergeCount);
 }
 
 void RenderInstancedQueue::add(InstancedBuffer *instancedBuffer) {
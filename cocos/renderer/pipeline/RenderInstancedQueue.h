@@ -1,24 +1,31 @@
 #pragma once
 
 #include "core/CoreStd.h"
+#include "PipelineStateManager.h"
 
 namespace cc {
 namespace pipeline {
 
 class InstancedBuffer;
 
+// Where the device reads draw arguments from GPU memory, the draw arguments of all indexed items
+// are written into one indirect buffer during the upload and the items are drawn from it.
 class CC_DLL RenderInstancedQueue : public Object {
 public:
     RenderInstancedQueue() = default;
-    ~RenderInstancedQueue() = default;
+    ~RenderInstancedQueue();
 
-    void recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuffer);
+    void recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuffer, uint subpass = 0);
     void add(InstancedBuffer *instancedBuffer);
     void uploadBuffers(gfx::CommandBuffer *cmdBuffer);
     void clear();
 
 private:
     set<InstancedBuffer *> _queues;
+    PipelineStateManager::LastHit _lastPSOHit;
+
+    gfx::Buffer *_indirectBuffer = nullptr;
+    vector<gfx::DrawInfo> _drawInfos;
 };
 
 } // namespace pipeline
@@ -1,5 +1,9 @@
 #include "RenderPipeline.h"
 #include "RenderFlow.h"
+#include "RenderGraph.h"
+#include "RenderStage.h"
+#include "helper/GPUTimer.h"
+#include "base/Profiler.h"
 #include "gfx/GFXCommandBuffer.h"
 #include "gfx/GFXDescriptorSet.h"
 #include "gfx/GFXDescriptorSetLayout.h"
@@ -39,6 +43,10 @@ void RenderPipeline::setDescriptorSetLayout() {
     globalDescriptorSetLayout.bindings[ENVIRONMENT::BINDING] = ENVIRONMENT::DESCRIPTOR;
     globalDescriptorSetLayout.samplers[SPOT_LIGHTING_MAP::NAME] = SPOT_LIGHTING_MAP::LAYOUT;
     globalDescriptorSetLayout.bindings[SPOT_LIGHTING_MAP::BINDING] = SPOT_LIGHTING_MAP::DESCRIPTOR;
+    globalDescriptorSetLayout.blocks[UBOClusterLights::NAME] = UBOClusterLights::LAYOUT;
+    globalDescriptorSetLayout.bindings[UBOClusterLights::BINDING] = UBOClusterLights::DESCRIPTOR;
+    globalDescriptorSetLayout.blocks[UBOClusterGrid::NAME] = UBOClusterGrid::LAYOUT;
+    globalDescriptorSetLayout.bindings[UBOClusterGrid::BINDING] = UBOClusterGrid::DESCRIPTOR;
 
     localDescriptorSetLayout.bindings.resize(static_cast<size_t>(ModelLocalBindings::COUNT));
     localDescriptorSetLayout.blocks[UBOLocalBatched::NAME] = UBOLocalBatched::LAYOUT;
@@ -88,6 +96,8 @@ bool RenderPipeline::activate() {
     }
     _descriptorSet = _device->createDescriptorSet({_descriptorSetLayout});
 
+    if (!_renderGraph) _renderGraph = CC_NEW(RenderGraph);
+
     for (const auto flow : _flows)
         flow->activate(this);
 
@@ -107,15 +117,39 @@ bool RenderPipeline::activate() {
 }
 
 void RenderPipeline::render(const vector<uint> &cameras) {
+    CC_PROFILE_ZONE("RenderPipeline::render");
     for (const auto flow : _flows) {
         for (const auto cameraID : cameras) {
             Camera* camera = GET_CAMERA(cameraID);
             flow->render(camera);
         }
     }
+    se::BufferPool::clearAllDirty();
+}
+
+void RenderPipeline::setGPUTimingEnabled(bool enabled) {
+    if (enabled == isGPUTimingEnabled()) return;
+
+    if (enabled) {
+        _gpuTimer = CC_NEW(GPUTimer);
+        if (!_gpuTimer->initialize(_device)) {
+            CC_LOG_WARNING("GPU timing is not supported on this device.");
+            CC_SAFE_DELETE(_gpuTimer);
+        }
+    } else {
+        CC_SAFE_DESTROY(_gpuTimer);
+        for (const auto flow : _flows) {
+            for (const auto stage : flow->getStages()) {
+                stage->setGPUTime(0.0f);
+            }
+        }
+    }
 }
 
 void RenderPipeline::destroy() {
+    CC_SAFE_DESTROY(_gpuTimer);
+    CC_SAFE_DESTROY(_renderGraph);
+
     for (auto flow : _flows) {
         flow->destroy();
     }
@@ -14,6 +14,8 @@ struct Camera;
 } // namespace gfx
 namespace pipeline {
 class DefineMap;
+class GPUTimer;
+class RenderGraph;
 
 struct CC_DLL RenderPipelineInfo {
     uint tag = 0;
@@ -40,6 +42,12 @@ public:
     CC_INLINE gfx::DescriptorSet *getDescriptorSet() const { return _descriptorSet; }
     CC_INLINE gfx::DescriptorSetLayout *getDescriptorSetLayout() const { return _descriptorSetLayout; }
     CC_INLINE gfx::Texture *getDefaultTexture() const { return _defaultTexture; }
+    // Per-stage GPU timing with timestamp queries, stays disabled on devices without TIMESTAMP_QUERY.
+    void setGPUTimingEnabled(bool enabled);
+    CC_INLINE bool isGPUTimingEnabled() const { return _gpuTimer != nullptr; }
+    CC_INLINE GPUTimer *getGPUTimer() const { return _gpuTimer; }
+    // Shared by the stages building their passes on it, its pool keeps transient textures between executions.
+    CC_INLINE RenderGraph *getRenderGraph() const { return _renderGraph; }
 
 protected:
     static RenderPipeline *_instance;
@@ -57,6 +65,8 @@ protected:
     // has not initBuiltinRes,
     // create temporary default Texture to binding sampler2d
     gfx::Texture *_defaultTexture = nullptr;
+    GPUTimer *_gpuTimer = nullptr;
+    RenderGraph *_renderGraph = nullptr;
 };
 
 } // namespace pipeline
@@ -1,11 +1,24 @@
 #include "RenderQueue.h"
 #include "PipelineStateManager.h"
+#include "base/FrameStats.h"
 #include "gfx/GFXCommandBuffer.h"
 #include "gfx/GFXShader.h"
+#include "helper/GPUOcclusionQueries.h"
 #include "helper/SharedMemory.h"
 
 namespace cc {
 namespace pipeline {
+namespace {
+constexpr uint RADIX_BITS = 8;
+constexpr uint RADIX_BUCKETS = 1 << RADIX_BITS;
+
+// maps a float onto an unsigned integer with the same ordering
+CC_INLINE uint32_t orderedFloatBits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+} // namespace
 
 RenderQueue::RenderQueue(const RenderQueueCreateInfo &desc)
 : _passDesc(desc) {
@@ -27,31 +40,105 @@ bool RenderQueue::insertRenderPass(const RenderObject &renderObj, uint subModelI
 
     const auto hash = (0 << 30) | (pass->priority << 16) | (subModel->priority << 8) | passIdx;
     uint shaderID = subModel->shaderID[passIdx];
-    RenderPass renderPass = {hash, renderObj.depth, shaderID, passIdx, subModel};
+    RenderPass renderPass = {hash, renderObj.depth, shaderID, passIdx, subModel, renderObj.model};
     _queue.emplace_back(std::move(renderPass));
     return true;
 }
 
 void RenderQueue::sort() {
-    std::sort(_queue.begin(), _queue.end(), _passDesc.sortFunc);
+    if (_isRadixSort) {
+        radixSort();
+    } else {
+        std::sort(_queue.begin(), _queue.end(), _passDesc.sortFunc);
+    }
+    CC_FRAME_STAT_ADD(QUEUED_PASSES, _queue.size());
+}
+
+void RenderQueue::radixSort() {
+    const auto count = static_cast<uint>(_queue.size());
+    if (count < 2) return;
+
+    _sortEntries.resize(count);
+    _sortScratch.resize(count);
+
+    // hash in the high half keeps the primary order of sortFunc, depth breaks ties
+    const bool backToFront = _passDesc.sortMode == RenderQueueSortMode::BACK_TO_FRONT;
+    uint64_t changedBits = 0;
+    for (uint i = 0; i < count; ++i) {
+        const auto &item = _queue[i];
+        const auto depthBits = orderedFloatBits(item.depth);
+        const uint64_t key = (static_cast<uint64_t>(item.hash) << 32) | (backToFront ? ~depthBits : depthBits);
+        _sortEntries[i] = {key, i};
+        changedBits |= key ^ _sortEntries[0].key;
+    }
+
+    uint offsets[RADIX_BUCKETS];
+    for (uint shift = 0; shift < 64; shift += RADIX_BITS) {
+        // every key shares this digit, the pass would not move anything
+        if (!((changedBits >> shift) & (RADIX_BUCKETS - 1))) continue;
+
+        memset(offsets, 0, sizeof(offsets));
+        for (uint i = 0; i < count; ++i) {
+            ++offsets[(_sortEntries[i].key >> shift) & (RADIX_BUCKETS - 1)];
+        }
+        for (uint b = 0, sum = 0; b < RADIX_BUCKETS; ++b) {
+            const auto bucketSize = offsets[b];
+            offsets[b] = sum;
+            sum += bucketSize;
+        }
+        for (uint i = 0; i < count; ++i) {
+            const auto &entry = _sortEntries[i];
+            _sortScratch[offsets[(entry.key >> shift) & (RADIX_BUCKETS - 1)]++] = entry;
+        }
+        _sortEntries.swap(_sortScratch);
+    }
+
+    // the sort is stable, equal keys keep their insertion order
+    _sortedQueue.resize(count);
+    for (uint i = 0; i < count; ++i) {
+        _sortedQueue[i] = _queue[_sortEntries[i].index];
+    }
+    _queue.swap(_sortedQueue);
 }
 
-void RenderQueue::recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff) {
+void RenderQueue::recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff, GPUOcclusionQueries *occlusionQueries, uint subpass,
+                                      DepthPassVariant depthVariant) {
+    const bool isDepthOnly = depthVariant == DepthPassVariant::DEPTH_ONLY;
+    bool hasDraws = false;
     for (size_t i = 0; i < _queue.size(); ++i) {
         const auto subModel = _queue[i].subModel;
         const auto passIdx = _queue[i].passIndex;
         auto inputAssembler = subModel->getInputAssembler();
 
+        if (occlusionQueries && occlusionQueries->isOccluded(_queue[i].model)) continue;
+
         const auto pass = subModel->getPassView(passIdx);
         auto shader = subModel->getShader(passIdx);
 
-        auto pso = PipelineStateManager::getOrCreatePipelineState(pass, shader, inputAssembler, renderPass);
+        // passes not writing depth, the skybox among them, have nothing to lay down or test equal against
+        const auto *depthStencilState = pass->getDepthStencilState();
+        const bool isDepthWriting = depthStencilState->depthTest && depthStencilState->depthWrite;
+        if (isDepthOnly && !isDepthWriting) continue;
+        const auto variant = isDepthWriting ? depthVariant : DepthPassVariant::NONE;
+
+        auto pso = PipelineStateManager::getOrCreatePipelineState(pass, shader, inputAssembler, renderPass, _lastPSOHit, subpass, variant);
+        if (!pso) continue;
         cmdBuff->bindPipelineState(pso);
         cmdBuff->bindDescriptorSet(MATERIAL_SET, pass->getDescriptorSet());
         cmdBuff->bindDescriptorSet(LOCAL_SET, subModel->getDescriptorSet());
         cmdBuff->bindInputAssembler(inputAssembler);
-        cmdBuff->draw(inputAssembler);
+        if (occlusionQueries && !isDepthOnly) {
+            const auto query = occlusionQueries->beginQuery(_queue[i].model, cmdBuff);
+            cmdBuff->draw(inputAssembler);
+            if (query != UINT_MAX) occlusionQueries->endQuery(query, cmdBuff);
+        } else {
+            cmdBuff->draw(inputAssembler);
+        }
+        hasDraws = true;
     }
+
+    // proxies test against the depth written above and reuse the descriptor sets it bound
+    if (occlusionQueries && hasDraws && !isDepthOnly) occlusionQueries->recordProxies(renderPass, cmdBuff);
 }
 
 } // namespace pipeline
@@ -1,9 +1,11 @@
 #pragma once
 
 #include "Define.h"
+#include "PipelineStateManager.h"
 
 namespace cc {
 namespace pipeline {
+class GPUOcclusionQueries;
 
 class CC_DLL RenderQueue : public Object {
 public:
@@ -11,12 +13,33 @@ public:
 
     void clear();
     bool insertRenderPass(const RenderObject &renderObj, uint subModelIdx, uint passIdx);
-    void recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff);
+    // Draws of models the occlusion queries found hidden are skipped, the others are queried.
+    // With a depth pass variant, the passes writing depth take its overrides: DEPTH_ONLY draws only them, without
+    // queries, and DEPTH_EQUAL draws them against the depth the DEPTH_ONLY pass left.
+    void recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff, GPUOcclusionQueries *occlusionQueries = nullptr, uint subpass = 0,
+                             DepthPassVariant depthVariant = DepthPassVariant::NONE);
     void sort();
+    CC_INLINE const RenderPassList &getRenderPasses() const { return _queue; }
+
+    // Sorts by a 64-bit key packing hash and depth with a LSD radix sort instead of sortFunc.
+    CC_INLINE void setRadixSort(bool enabled) { _isRadixSort = enabled; }
+    CC_INLINE bool isRadixSort() const { return _isRadixSort; }
 
 private:
+    struct SortEntry {
+        uint64_t key = 0;
+        uint index = 0;
+    };
+
+    void radixSort();
+
     RenderPassList _queue;
     RenderQueueCreateInfo _passDesc;
+    bool _isRadixSort = false;
+    vector<SortEntry> _sortEntries;
+    vector<SortEntry> _sortScratch;
+    RenderPassList _sortedQueue;
+    PipelineStateManager::LastHit _lastPSOHit;
 };
 
 } // namespace pipeline
@@ -36,6 +36,9 @@ public:
     CC_INLINE const String &getName() const { return _name; }
     CC_INLINE uint getPriority() const { return _priority; }
     CC_INLINE uint getTag() const { return _tag; }
+    // GPU time of the last measured frame in milliseconds, see RenderPipeline::setGPUTimingEnabled
+    CC_INLINE float getGPUTime() const { return _gpuTime; }
+    CC_INLINE void setGPUTime(float time) { _gpuTime = time; }
 
 protected:
     RenderQueueDescList _renderQueueDescriptors;
@@ -46,6 +49,7 @@ protected:
     String _name;
     uint _priority = 0;
     uint _tag = 0;
+    float _gpuTime = 0.0f;
     gfx::ColorList _clearColors = {{0, 0, 0, 1.0f}};
 };
 
@@ -0,0 +1,243 @@
+#include "ShaderVariantCollector.h"
+#include "gfx/GFXDevice.h"
+#include "gfx/GFXShader.h"
+#include "platform/FileUtils.h"
+
+namespace cc {
+namespace pipeline {
+namespace {
+const uint VARIANT_FILE_MAGIC = 0x43435356; // 'CCSV'
+const uint VARIANT_FILE_VERSION = 1u;
+
+class Writer {
+public:
+    void write(uint value) { append(&value, sizeof(value)); }
+    void write(bool value) { write(static_cast<uint>(value)); }
+    void write(const String &value) {
+        write(static_cast<uint>(value.size()));
+        append(value.data(), value.size());
+    }
+    const vector<uint8_t> &getBuffer() const { return _buffer; }
+
+private:
+    void append(const void *data, size_t size) {
+        const auto *bytes = static_cast<const uint8_t *>(data);
+        _buffer.insert(_buffer.end(), bytes, bytes + size);
+    }
+
+    vector<uint8_t> _buffer;
+};
+
+// reads zeros and turns invalid once past the end, checked after each variant
+class Reader {
+public:
+    Reader(const uint8_t *data, size_t size) : _data(data), _size(size) {}
+
+    uint readUint() {
+        uint value = 0u;
+        if (take(sizeof(value))) memcpy(&value, _data + _offset - sizeof(value), sizeof(value));
+        return value;
+    }
+    bool readBool() { return readUint() != 0u; }
+    String readString() {
+        const uint size = readUint();
+        if (!take(size)) return String();
+        return String(reinterpret_cast<const char *>(_data + _offset - size), size);
+    }
+    // a count of elements that each take at least minSize bytes, 0 for one the file can't hold
+    uint readCount(size_t minSize) {
+        const uint count = readUint();
+        if ((_size - _offset) / minSize < count) {
+            _isValid = false;
+            return 0u;
+        }
+        return count;
+    }
+    bool isValid() const { return _isValid; }
+
+private:
+    bool take(size_t size) {
+        if (!_isValid || _size - _offset < size) {
+            _isValid = false;
+            return false;
+        }
+        _offset += size;
+        return true;
+    }
+
+    const uint8_t *_data = nullptr;
+    size_t _size = 0;
+    size_t _offset = 0;
+    bool _isValid = true;
+};
+
+void writeShaderInfo(Writer &writer, const gfx::ShaderInfo &info) {
+    writer.write(info.name);
+    writer.write(static_cast<uint>(info.stages.size()));
+    for (const auto &stage : info.stages) {
+        writer.write(static_cast<uint>(stage.stage));
+        writer.write(stage.source);
+    }
+    writer.write(static_cast<uint>(info.attributes.size()));
+    for (const auto &attribute : info.attributes) {
+        writer.write(attribute.name);
+        writer.write(static_cast<uint>(attribute.format));
+        writer.write(attribute.isNormalized);
+        writer.write(attribute.stream);
+        writer.write(attribute.isInstanced);
+        writer.write(attribute.location);
+    }
+    writer.write(static_cast<uint>(info.blocks.size()));
+    for (const auto &block : info.blocks) {
+        writer.write(block.set);
+        writer.write(block.binding);
+        writer.write(block.name);
+        writer.write(static_cast<uint>(block.members.size()));
+        for (const auto &member : block.members) {
+            writer.write(member.name);
+            writer.write(static_cast<uint>(member.type));
+            writer.write(member.count);
+        }
+        writer.write(block.count);
+    }
+    writer.write(static_cast<uint>(info.samplers.size()));
+    for (const auto &sampler : info.samplers) {
+        writer.write(sampler.set);
+        writer.write(sampler.binding);
+        writer.write(sampler.name);
+        writer.write(static_cast<uint>(sampler.type));
+        writer.write(sampler.count);
+    }
+}
+
+void readShaderInfo(Reader &reader, gfx::ShaderInfo &info) {
+    info.name = reader.readString();
+    info.stages.resize(reader.readCount(2 * sizeof(uint)));
+    for (auto &stage : info.stages) {
+        stage.stage = static_cast<gfx::ShaderStageFlagBit>(reader.readUint());
+        stage.source = reader.readString();
+    }
+    info.attributes.resize(reader.readCount(6 * sizeof(uint)));
+    for (auto &attribute : info.attributes) {
+        attribute.name = reader.readString();
+        attribute.format = static_cast<gfx::Format>(reader.readUint());
+        attribute.isNormalized = reader.readBool();
+        attribute.stream = reader.readUint();
+        attribute.isInstanced = reader.readBool();
+        attribute.location = reader.readUint();
+    }
+    info.blocks.resize(reader.readCount(5 * sizeof(uint)));
+    for (auto &block : info.blocks) {
+        block.set = reader.readUint();
+        block.binding = reader.readUint();
+        block.name = reader.readString();
+        block.members.resize(reader.readCount(3 * sizeof(uint)));
+        for (auto &member : block.members) {
+            member.name = reader.readString();
+            member.type = static_cast<gfx::Type>(reader.readUint());
+            member.count = reader.readUint();
+        }
+        block.count = reader.readUint();
+    }
+    info.samplers.resize(reader.readCount(5 * sizeof(uint)));
+    for (auto &sampler : info.samplers) {
+        sampler.set = reader.readUint();
+        sampler.binding = reader.readUint();
+        sampler.name = reader.readString();
+        sampler.type = static_cast<gfx::Type>(reader.readUint());
+        sampler.count = reader.readUint();
+    }
+}
+
+String getFullPath(const String &path) {
+    FileUtils *fileUtils = FileUtils::getInstance();
+    return fileUtils->isAbsolutePath(path) ? path : fileUtils->getWritablePath() + path;
+}
+} // namespace
+
+std::atomic<bool> ShaderVariantCollector::_recording{false};
+std::mutex ShaderVariantCollector::_mutex;
+map<String, gfx::ShaderInfo> ShaderVariantCollector::_variants;
+
+void ShaderVariantCollector::setRecording(bool recording) {
+    _recording = recording;
+}
+
+void ShaderVariantCollector::record(gfx::Shader *shader) {
+    if (!_recording || !shader) return;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_variants.count(shader->getName())) return;
+    gfx::ShaderInfo &info = _variants[shader->getName()];
+    info.name = shader->getName();
+    info.stages = shader->getStages();
+    info.attributes = shader->getAttributes();
+    info.blocks = shader->getBlocks();
+    info.samplers = shader->getSamplers();
+}
+
+StringArray ShaderVariantCollector::getRecordedNames() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    StringArray names;
+    names.reserve(_variants.size());
+    for (const auto &pair : _variants) {
+        names.push_back(pair.first);
+    }
+    return names;
+}
+
+void ShaderVariantCollector::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _variants.clear();
+}
+
+bool ShaderVariantCollector::save(const String &path) {
+    Writer writer;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        writer.write(VARIANT_FILE_MAGIC);
+        writer.write(VARIANT_FILE_VERSION);
+        writer.write(static_cast<uint>(_variants.size()));
+        for (const auto &pair : _variants) {
+            writeShaderInfo(writer, pair.second);
+        }
+    }
+
+    Data data;
+    data.copy(writer.getBuffer().data(), static_cast<ssize_t>(writer.getBuffer().size()));
+    if (!FileUtils::getInstance()->writeDataToFile(data, getFullPath(path))) {
+        CC_LOG_WARNING("Failed to write the shader variants to %s.", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+uint ShaderVariantCollector::prewarm(const String &path) {
+    FileUtils *fileUtils = FileUtils::getInstance();
+    const String fullPath = getFullPath(path);
+    if (!fileUtils->isFileExist(fullPath)) return 0u;
+
+    const Data data = fileUtils->getDataFromFile(fullPath);
+    Reader reader(data.getBytes(), static_cast<size_t>(data.getSize()));
+    if (reader.readUint() != VARIANT_FILE_MAGIC || reader.readUint() != VARIANT_FILE_VERSION) {
+        CC_LOG_WARNING("%s holds no shader variants of this version.", path.c_str());
+        return 0u;
+    }
+
+    gfx::Device *device = gfx::Device::getInstance();
+    uint prewarmedCount = 0u;
+    const uint count = reader.readCount(sizeof(uint));
+    for (uint i = 0u; i < count; ++i) {
+        gfx::ShaderInfo info;
+        readShaderInfo(reader, info);
+        if (!reader.isValid()) {
+            CC_LOG_WARNING("The shader variants of %s are cut short.", path.c_str());
+            break;
+        }
+        if (device->prewarmShader(info)) ++prewarmedCount;
+    }
+    return prewarmedCount;
+}
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "core/CoreStd.h"
+#include "gfx/GFXDef.h"
+#include <atomic>
+#include <mutex>
+
+namespace cc {
+namespace pipeline {
+
+// Records the shader variants pipeline states are created with, a variant being a program compiled with a set of
+// defines, which the shader name is made of. The variants saved during a play session are prewarmed by the loading
+// of the next one, and their names tell the build which permutations are used at all.
+class CC_DLL ShaderVariantCollector {
+public:
+    static void setRecording(bool recording);
+    CC_INLINE static bool isRecording() { return _recording; }
+    // Called with the shader of every pipeline state created, from any thread.
+    static void record(gfx::Shader *shader);
+    static StringArray getRecordedNames();
+    static void clear();
+
+    // Writes the recorded variants to the file, relative paths are under the writable path.
+    static bool save(const String &path);
+    // Creates the shaders of the variants in the file through gfx::Device::prewarmShader(), returns how many.
+    static uint prewarm(const String &path);
+
+private:
+    static std::atomic<bool> _recording;
+    // the states prewarmed on Vulkan and Metal are created on a worker thread
+    static std::mutex _mutex;
+    static map<String, gfx::ShaderInfo> _variants;
+};
+
+} // namespace pipeline
+} // namespace cc
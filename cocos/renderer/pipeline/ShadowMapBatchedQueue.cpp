@@ -28,11 +28,18 @@ void ShadowMapBatchedQueue::gatherLightPasses(const Light *light, gfx::CommandBu
     clear();
 
     const auto *shadowInfo = _pipeline->getShadows();
-    const auto &shadowObjects = _pipeline->getShadowObjects();
     if (light && shadowInfo->enabled && shadowInfo->getShadowType() == ShadowType::SHADOWMAP) {
         updateUBOs(light, cmdBufferer);
+        gatherCasters(light, _pipeline->getShadowObjects(), cmdBufferer);
+    }
+}
+
+void ShadowMapBatchedQueue::gatherCasters(const Light *light, const RenderObjectList &casters, gfx::CommandBuffer *cmdBufferer) {
+    clear();
 
-        for (const auto ro : shadowObjects) {
+    const auto *shadowInfo = _pipeline->getShadows();
+    if (light && shadowInfo->enabled && shadowInfo->getShadowType() == ShadowType::SHADOWMAP) {
+        for (const auto ro : casters) {
             const auto *model = ro.model;
 
             switch (light->getType()) {
@@ -105,6 +112,7 @@ void ShadowMapBatchedQueue::recordCommandBuffer(gfx::Device *device, gfx::Render
         const auto pass = _passes[i];
         const auto ia = subModel->getInputAssembler();
         const auto pso = PipelineStateManager::getOrCreatePipelineState(pass, shader, ia, renderPass);
+        if (!pso) continue;
 
         cmdBuffer->bindPipelineState(pso);
         cmdBuffer->bindDescriptorSet(MATERIAL_SET, pass->getDescriptorSet());
@@ -122,9 +130,8 @@ void ShadowMapBatchedQueue::destroy() {
     _buffer = nullptr;
 }
 
-void ShadowMapBatchedQueue::updateUBOs(const Light *light, gfx::CommandBuffer *cmdBufferer) const {
+const Mat4 &ShadowMapBatchedQueue::updateUBOs(const Light *light, gfx::CommandBuffer *cmdBufferer) {
     const auto *shadowInfo = _pipeline->getShadows();
-    auto shadowUBO = _pipeline->getShadowUBO();
     auto *device = gfx::Device::getInstance();
 
     switch (light->getType()) {
@@ -158,7 +165,7 @@ void ShadowMapBatchedQueue::updateUBOs(const Light *light, gfx::CommandBuffer *c
             Mat4::createOrthographicOffCenter(-x, x, -y, y, shadowInfo->nearValue, farClamp, device->getClipSpaceMinZ(), projectionSinY, &matShadowViewProj);
 
             matShadowViewProj.multiply(matShadowView);
-            memcpy(shadowUBO.data() + UBOShadow::MAT_LIGHT_VIEW_PROJ_OFFSET, matShadowViewProj.m, sizeof(matShadowViewProj));
+            _matLightViewProj = matShadowViewProj;
         } break;
         case LightType::SPOT: {
             const auto &matShadowCamera = light->getNode()->worldMatrix;
@@ -169,16 +176,28 @@ void ShadowMapBatchedQueue::updateUBOs(const Light *light, gfx::CommandBuffer *c
             cc::Mat4::createPerspective(light->spotAngle, light->aspect, 0.001f, light->range, &matShadowViewProj);
 
             matShadowViewProj.multiply(matShadowView);
-            memcpy(shadowUBO.data() + UBOShadow::MAT_LIGHT_VIEW_PROJ_OFFSET, matShadowViewProj.m, sizeof(matShadowViewProj));
+            _matLightViewProj = matShadowViewProj;
         } break;
         default:;
     }
 
-    float shadowInfos[4] = {shadowInfo->size.x, shadowInfo->size.y, (float)shadowInfo->pcfType, shadowInfo->bias};
+    return updateUBOs(_matLightViewProj, cmdBufferer);
+}
+
+const Mat4 &ShadowMapBatchedQueue::updateUBOs(const Mat4 &matLightViewProj, gfx::CommandBuffer *cmdBufferer) {
+    const auto *shadowInfo = _pipeline->getShadows();
+    auto shadowUBO = _pipeline->getShadowUBO();
+
+    _matLightViewProj = matLightViewProj;
+    memcpy(shadowUBO.data() + UBOShadow::MAT_LIGHT_VIEW_PROJ_OFFSET, _matLightViewProj.m, sizeof(_matLightViewProj));
+
+    float shadowInfos[4] = {shadowInfo->size.x, shadowInfo->size.y, (float)_pipeline->getShadowPCFType(), shadowInfo->bias};
     memcpy(shadowUBO.data() + UBOShadow::SHADOW_COLOR_OFFSET, &shadowInfo->color, sizeof(Vec4));
     memcpy(shadowUBO.data() + UBOShadow::SHADOW_INFO_OFFSET, &shadowInfos, sizeof(shadowInfos));
 
     cmdBufferer->updateBuffer(_pipeline->getDescriptorSet()->getBuffer(UBOShadow::BINDING), shadowUBO.data(), UBOShadow::SIZE);
+
+    return _matLightViewProj;
 }
 
 int ShadowMapBatchedQueue::getShadowPassIndex(const ModelView *model) const {
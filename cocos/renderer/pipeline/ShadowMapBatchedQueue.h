@@ -3,6 +3,7 @@
 
 #include "core/CoreStd.h"
 #include "Define.h"
+#include "math/Mat4.h"
 
 namespace cc {
 namespace pipeline {
@@ -27,11 +28,16 @@ public:
 
     void clear();
     void gatherLightPasses(const Light *, gfx::CommandBuffer *);
+    // Only gathers the given casters, the shadow UBO of the light has to be updated beforehand.
+    void gatherCasters(const Light *, const RenderObjectList &, gfx::CommandBuffer *);
+    // Returns the light view projection matrix the shadow UBO has been filled with.
+    const Mat4 &updateUBOs(const Light *, gfx::CommandBuffer *);
+    // Fills the shadow UBO with the given light view projection, e.g. the one of a shadow cascade.
+    const Mat4 &updateUBOs(const Mat4 &matLightViewProj, gfx::CommandBuffer *);
     void add(const ModelView *, gfx::CommandBuffer *);
     void recordCommandBuffer(gfx::Device *, gfx::RenderPass *, gfx::CommandBuffer *) const;
 
 private:
-    void updateUBOs(const Light *, gfx::CommandBuffer *) const;
     int getShadowPassIndex(const ModelView *model) const;
 
 private:
@@ -43,6 +49,7 @@ private:
     RenderBatchedQueue *_batchedQueue = nullptr;
     gfx::Buffer *_buffer = nullptr;
     uint _phaseID = 0;
+    Mat4 _matLightViewProj;
 };
 } // namespace pipeline
 } // namespace cc
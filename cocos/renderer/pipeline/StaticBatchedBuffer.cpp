@@ -0,0 +1,274 @@
+#include "StaticBatchedBuffer.h"
+#include "PipelineStateManager.h"
+#include "gfx/GFXBuffer.h"
+#include "gfx/GFXCommandBuffer.h"
+#include "gfx/GFXDescriptorSet.h"
+#include "gfx/GFXDevice.h"
+#include "gfx/GFXInputAssembler.h"
+#include "helper/SharedMemory.h"
+
+#include <tuple>
+
+namespace cc {
+namespace pipeline {
+namespace {
+CC_INLINE uint64_t getMemberKey(uint subModelID, uint passIdx) {
+    return static_cast<uint64_t>(subModelID) << 2 | passIdx;
+}
+
+struct AttributeOffset {
+    uint stream = 0;
+    uint offset = 0;
+    bool isValid = false;
+};
+
+// vertices of a flat buffer are interleaved in the order of the attributes of its stream
+AttributeOffset findAttribute(const gfx::AttributeList &attributes, const String &name, gfx::Format format) {
+    AttributeOffset result;
+    vector<uint> streamOffsets;
+    for (const auto &attribute : attributes) {
+        if (attribute.stream >= streamOffsets.size()) streamOffsets.resize(attribute.stream + 1, 0);
+        if (attribute.name == name) {
+            result.stream = attribute.stream;
+            result.offset = streamOffsets[attribute.stream];
+            result.isValid = attribute.format == format;
+            return result;
+        }
+        streamOffsets[attribute.stream] += gfx::GFX_FORMAT_INFOS[static_cast<uint>(attribute.format)].size;
+    }
+    return result;
+}
+} // namespace
+
+void StaticBatchedBuffer::build(const vector<const ModelView *> &models, const vector<float> &lightingMapUVParams, uint phaseID) {
+    destroy();
+
+    // sub-models drawn with the same state end up in the same batches
+    map<std::tuple<uint, uint, gfx::Texture *>, vector<PendingMember>> groups;
+    for (size_t i = 0; i < models.size(); ++i) {
+        const auto *model = models[i];
+        if (!model || !model->transformID) continue;
+
+        Vec4 uvParam;
+        if (lightingMapUVParams.size() >= (i + 1) * 4) {
+            uvParam.set(&lightingMapUVParams[i * 4]);
+        }
+
+        const auto subModelID = model->getSubModelID();
+        const auto subModelCount = subModelID[0];
+        for (uint m = 1; m <= subModelCount; ++m) {
+            const auto *subModel = model->getSubModelView(subModelID[m]);
+            const auto flatBuffersID = subModel->getSubMesh()->getFlatBufferArrayID();
+            if (!flatBuffersID || !flatBuffersID[0]) continue;
+
+            auto *lightingMap = subModel->getDescriptorSet()->getTexture(LIGHTMAP_TEXTURE::BINDING);
+            for (uint p = 0; p < subModel->passCount; ++p) {
+                const auto *pass = subModel->getPassView(p);
+                // transparent passes are sorted per object, instancing and dynamic batching merge on their own
+                if (pass->phase != phaseID || pass->getBlendState()->targets[0].blend) continue;
+                const auto batchingScheme = pass->getBatchingScheme();
+                if (batchingScheme == BatchingSchemes::INSTANCING || batchingScheme == BatchingSchemes::VB_MERGING) continue;
+
+                auto &group = groups[std::make_tuple(subModel->passID[p], subModel->shaderID[p], lightingMap)];
+                group.push_back({model, subModel, subModelID[m], p, uvParam});
+            }
+        }
+    }
+
+    for (const auto &pair : groups) {
+        buildBatch(pair.second, std::get<2>(pair.first));
+    }
+}
+
+void StaticBatchedBuffer::buildBatch(const vector<PendingMember> &members, gfx::Texture *lightingMap) {
+    // split into batches that stay below the vertex limit and share the vertex layout of the first sub-model
+    size_t begin = 0;
+    while (begin < members.size()) {
+        const auto &reference = members[begin];
+        const auto *referenceSubMesh = reference.subModel->getSubMesh();
+        const auto referenceBuffersID = referenceSubMesh->getFlatBufferArrayID();
+        const uint streamCount = referenceBuffersID[0];
+
+        vector<uint> strides(streamCount);
+        for (uint j = 0; j < streamCount; ++j) {
+            strides[j] = referenceSubMesh->getFlatBuffer(referenceBuffersID[j + 1])->stride;
+        }
+
+        vector<const PendingMember *> batchMembers;
+        uint vertexCount = 0;
+        size_t end = begin;
+        for (; end < members.size(); ++end) {
+            const auto *subMesh = members[end].subModel->getSubMesh();
+            const auto buffersID = subMesh->getFlatBufferArrayID();
+            const auto count = subMesh->getFlatBuffer(buffersID[1])->count;
+            if (!batchMembers.empty() && vertexCount + count > MAX_VERTEX_COUNT) break;
+
+            bool isCompatible = buffersID[0] == streamCount;
+            for (uint j = 0; isCompatible && j < streamCount; ++j) {
+                isCompatible = subMesh->getFlatBuffer(buffersID[j + 1])->stride == strides[j];
+            }
+            if (!isCompatible) {
+                CC_LOG_WARNING("Sub-model vertex layout differs from the static batch it shares a pass with, it is drawn on its own.");
+                continue;
+            }
+            batchMembers.push_back(&members[end]);
+            vertexCount += count;
+        }
+        begin = end;
+        if (batchMembers.size() < 2) continue;
+
+        const auto *representative = batchMembers[0];
+        const auto &attributes = representative->subModel->getInputAssembler()->getAttributes();
+        const auto position = findAttribute(attributes, "a_position", gfx::Format::RGB32F);
+        const auto normal = findAttribute(attributes, "a_normal", gfx::Format::RGB32F);
+        const auto tangent = findAttribute(attributes, "a_tangent", gfx::Format::RGBA32F);
+        const auto lightingMapUV = findAttribute(attributes, "a_texCoord1", gfx::Format::RG32F);
+        if (!position.isValid) continue;
+
+        StaticBatchedItem item;
+        item.pass = representative->subModel->getPassView(representative->passIdx);
+        item.shader = representative->subModel->getShader(representative->passIdx);
+        item.descriptorSet = representative->subModel->getDescriptorSet();
+        item.lightingMap = lightingMap;
+        item.worldMatrix = representative->model->getTransform()->worldMatrix;
+        item.lightingMapUVParam = representative->lightingMapUVParam;
+        item.vertexCount = vertexCount;
+
+        Mat4 invWorld = item.worldMatrix.getInversed();
+        const auto &baseUV = item.lightingMapUVParam;
+        const bool isRemapUV = lightingMap && lightingMapUV.isValid && baseUV.z != 0.0f && baseUV.w != 0.0f;
+
+        vector<vector<uint8_t>> datas(streamCount);
+        for (uint j = 0; j < streamCount; ++j) {
+            datas[j].resize(vertexCount * strides[j]);
+        }
+
+        Mat4 matBake, matNormal;
+        uint firstVertex = 0;
+        for (const auto *member : batchMembers) {
+            const auto *subMesh = member->subModel->getSubMesh();
+            const auto buffersID = subMesh->getFlatBufferArrayID();
+            const auto count = subMesh->getFlatBuffer(buffersID[1])->count;
+            for (uint j = 0; j < streamCount; ++j) {
+                auto size = 0u;
+                const auto *data = subMesh->getFlatBuffer(buffersID[j + 1])->getBuffer(&size);
+                memcpy(datas[j].data() + firstVertex * strides[j], data, std::min(size, count * strides[j]));
+            }
+
+            // bring the vertices from the member's model space into the representative's
+            Mat4::multiply(invWorld, member->model->getTransform()->worldMatrix, &matBake);
+            matNormal = matBake.getInversed();
+            matNormal.transpose();
+            const auto &uv = member->lightingMapUVParam;
+            for (uint v = firstVertex; v < firstVertex + count; ++v) {
+                auto *p = reinterpret_cast<float *>(datas[position.stream].data() + v * strides[position.stream] + position.offset);
+                Vec3 value(p[0], p[1], p[2]);
+                matBake.transformPoint(&value);
+                p[0] = value.x, p[1] = value.y, p[2] = value.z;
+
+                if (normal.isValid) {
+                    auto *n = reinterpret_cast<float *>(datas[normal.stream].data() + v * strides[normal.stream] + normal.offset);
+                    value.set(n[0], n[1], n[2]);
+                    matNormal.transformVector(&value);
+                    value.normalize();
+                    n[0] = value.x, n[1] = value.y, n[2] = value.z;
+                }
+                if (tangent.isValid) {
+                    auto *t = reinterpret_cast<float *>(datas[tangent.stream].data() + v * strides[tangent.stream] + tangent.offset);
+                    value.set(t[0], t[1], t[2]);
+                    matBake.transformVector(&value);
+                    value.normalize();
+                    t[0] = value.x, t[1] = value.y, t[2] = value.z;
+                }
+                // the representative's UV params are applied in the shader, undo them for its atlas slot
+                if (isRemapUV) {
+                    auto *l = reinterpret_cast<float *>(datas[lightingMapUV.stream].data() + v * strides[lightingMapUV.stream] + lightingMapUV.offset);
+                    l[0] = (uv.x + l[0] * uv.z - baseUV.x) / baseUV.z;
+                    l[1] = (uv.y + l[1] * uv.w - baseUV.y) / baseUV.w;
+                }
+            }
+
+            _members[getMemberKey(member->subModelID, member->passIdx)] = {static_cast<uint>(_batches.size() + 1), static_cast<uint>(item.members.size())};
+            item.members.push_back({firstVertex, count});
+            firstVertex += count;
+        }
+
+        auto *device = gfx::Device::getInstance();
+        for (uint j = 0; j < streamCount; ++j) {
+            auto *vb = device->createBuffer({
+                gfx::BufferUsageBit::VERTEX | gfx::BufferUsageBit::TRANSFER_DST,
+                gfx::MemoryUsageBit::HOST | gfx::MemoryUsageBit::DEVICE,
+                static_cast<uint>(datas[j].size()),
+                strides[j],
+            });
+            vb->update(datas[j].data(), 0, static_cast<uint>(datas[j].size()));
+            item.vbs.push_back(vb);
+        }
+        gfx::InputAssemblerInfo iaInfo = {attributes, item.vbs};
+        item.ia = device->createInputAssembler(iaInfo);
+        _batches.emplace_back(std::move(item));
+    }
+}
+
+void StaticBatchedBuffer::destroy() {
+    for (auto &batch : _batches) {
+        for (auto vb : batch.vbs) {
+            CC_SAFE_DESTROY(vb);
+        }
+        CC_SAFE_DESTROY(batch.ia);
+    }
+    _batches.clear();
+    _members.clear();
+    _mergedBatches.clear();
+}
+
+bool StaticBatchedBuffer::merge(uint subModelID, uint passIdx) {
+    if (_batches.empty()) return false;
+
+    const auto *ref = _members.find(getMemberKey(subModelID, passIdx));
+    if (!ref || !ref->batch) return false;
+
+    auto &batch = _batches[ref->batch - 1];
+    if (batch.visibleMembers.empty()) _mergedBatches.push_back(ref->batch - 1);
+    batch.visibleMembers.push_back(ref->member);
+    return true;
+}
+
+void StaticBatchedBuffer::clear() {
+    for (auto index : _mergedBatches) {
+        _batches[index].visibleMembers.clear();
+    }
+    _mergedBatches.clear();
+}
+
+void StaticBatchedBuffer::recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff) {
+    for (auto index : _mergedBatches) {
+        auto &batch = _batches[index];
+        auto *pso = PipelineStateManager::getOrCreatePipelineState(batch.pass, batch.shader, batch.ia, renderPass);
+        if (!pso) continue;
+
+        cmdBuff->bindPipelineState(pso);
+        cmdBuff->bindDescriptorSet(MATERIAL_SET, batch.pass->getDescriptorSet());
+        cmdBuff->bindDescriptorSet(LOCAL_SET, batch.descriptorSet);
+        cmdBuff->bindInputAssembler(batch.ia);
+
+        // members are laid out in order, neighbours visible together are drawn as one range
+        auto &visible = batch.visibleMembers;
+        std::sort(visible.begin(), visible.end());
+        for (size_t i = 0; i < visible.size();) {
+            const auto &first = batch.members[visible[i]];
+            uint vertexCount = first.vertexCount;
+            size_t j = i + 1;
+            for (; j < visible.size() && visible[j] == visible[j - 1] + 1; ++j) {
+                vertexCount += batch.members[visible[j]].vertexCount;
+            }
+            batch.ia->setFirstVertex(first.firstVertex);
+            batch.ia->setVertexCount(vertexCount);
+            cmdBuff->draw(batch.ia);
+            i = j;
+        }
+    }
+}
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Define.h"
+#include "helper/FlatHashMap.h"
+#include "math/Mat4.h"
+#include "math/Vec4.h"
+
+namespace cc {
+namespace pipeline {
+struct ModelView;
+struct PassView;
+struct SubModelView;
+
+struct CC_DLL StaticBatchedMember {
+    uint firstVertex = 0;
+    uint vertexCount = 0;
+};
+
+struct CC_DLL StaticBatchedItem {
+    gfx::BufferList vbs;
+    gfx::InputAssembler *ia = nullptr;
+    const PassView *pass = nullptr;
+    gfx::Shader *shader = nullptr;
+    // local set of the first sub-model, the others are baked into its model space
+    gfx::DescriptorSet *descriptorSet = nullptr;
+    gfx::Texture *lightingMap = nullptr;
+    Mat4 worldMatrix;
+    Vec4 lightingMapUVParam;
+    vector<StaticBatchedMember> members;
+    uint vertexCount = 0;
+    // members merged in the current frame
+    vector<uint> visibleMembers;
+};
+typedef vector<StaticBatchedItem> StaticBatchedItemList;
+
+// Merges the forward passes of static sub-models sharing a pass, shader and lightmap into large vertex
+// buffers once, when a scene is loaded. Vertices are baked into the model space of the first sub-model of
+// every batch, which is drawn with its local descriptor set, so the models must not move, skin or morph
+// after they are built. Visible members are drawn as ranges of the merged buffers, adjacent ones in a
+// single draw, which removes the per-object cost of dynamic batching for static level geometry.
+class CC_DLL StaticBatchedBuffer : public Object {
+public:
+    // merged vertex buffers are split once they reach this many vertices
+    static constexpr uint MAX_VERTEX_COUNT = 1 << 20;
+
+    StaticBatchedBuffer() = default;
+    ~StaticBatchedBuffer() = default;
+
+    // Lightmap UV params are 4 floats per model, they can be omitted for models without lightmaps.
+    void build(const vector<const ModelView *> &models, const vector<float> &lightingMapUVParams, uint phaseID);
+    void destroy();
+
+    // Returns false for passes which are not baked, they have to be drawn on their own.
+    bool merge(uint subModelID, uint passIdx);
+    void clear();
+    void recordCommandBuffer(gfx::Device *device, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff);
+
+    CC_INLINE const StaticBatchedItemList &getBatches() const { return _batches; }
+    CC_INLINE bool empty() const { return _batches.empty(); }
+
+private:
+    struct MemberRef {
+        uint batch = 0; // batch index + 1, 0 for passes that are not baked
+        uint member = 0;
+    };
+
+    struct PendingMember {
+        const ModelView *model = nullptr;
+        const SubModelView *subModel = nullptr;
+        uint subModelID = 0;
+        uint passIdx = 0;
+        Vec4 lightingMapUVParam;
+    };
+
+    void buildBatch(const vector<PendingMember> &members, gfx::Texture *lightingMap);
+
+    StaticBatchedItemList _batches;
+    FlatHashMap<uint64_t, MemberRef> _members;
+    vector<uint> _mergedBatches;
+};
+
+} // namespace pipeline
+} // namespace cc
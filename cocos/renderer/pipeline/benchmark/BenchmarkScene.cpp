@@ -0,0 +1,586 @@
+#include "BenchmarkScene.h"
+#include "bindings/dop/BufferAllocator.h"
+#include "bindings/dop/BufferPool.h"
+#include "bindings/dop/ObjectPool.h"
+#include "bindings/jswrapper/SeApi.h"
+#include "gfx/GFXBuffer.h"
+#include "gfx/GFXDescriptorSet.h"
+#include "gfx/GFXDescriptorSetLayout.h"
+#include "gfx/GFXDevice.h"
+#include "gfx/GFXFramebuffer.h"
+#include "gfx/GFXInputAssembler.h"
+#include "gfx/GFXPipelineLayout.h"
+#include "gfx/GFXRenderPass.h"
+#include "gfx/GFXShader.h"
+#include "gfx/GFXTexture.h"
+
+#include <new>
+#include <random>
+
+namespace cc {
+namespace pipeline {
+namespace {
+const char *BENCHMARK_VERT_GLSL4 = R"(
+precision highp float;
+layout(location = 0) in vec3 a_position;
+void main () { gl_Position = vec4(a_position * 0.01, 1.0); }
+)";
+const char *BENCHMARK_FRAG_GLSL4 = R"(
+precision mediump float;
+layout(location = 0) out vec4 o_color;
+void main () { o_color = vec4(1.0); }
+)";
+const char *BENCHMARK_VERT_GLSL3 = R"(
+precision highp float;
+in vec3 a_position;
+void main () { gl_Position = vec4(a_position * 0.01, 1.0); }
+)";
+const char *BENCHMARK_FRAG_GLSL3 = R"(
+precision mediump float;
+out vec4 o_color;
+void main () { o_color = vec4(1.0); }
+)";
+const char *BENCHMARK_VERT_GLSL1 = R"(
+precision highp float;
+attribute vec3 a_position;
+void main () { gl_Position = vec4(a_position * 0.01, 1.0); }
+)";
+const char *BENCHMARK_FRAG_GLSL1 = R"(
+precision mediump float;
+void main () { gl_FragColor = vec4(1.0); }
+)";
+
+// entries per pool chunk, the script side uses the same size for most pools
+constexpr uint POOL_ENTRY_BITS = 8;
+// byte size of a blend state entry: isA2C, isIndepend, blendColor and the blend target array handle
+constexpr uint BLEND_STATE_BYTES = 7 * sizeof(uint32_t);
+constexpr uint DEFAULT_PRIORITY = 128;
+constexpr uint CUBE_VERTEX_COUNT = 8;
+constexpr uint CUBE_INDEX_COUNT = 36;
+constexpr uint INSTANCED_STRIDE = 12 * sizeof(float); // the first three rows of the world matrix
+constexpr uint UI_QUAD_INDEX_COUNT = 6;
+
+float CUBE_POSITIONS[CUBE_VERTEX_COUNT * 3] = {
+    -1.0f, -1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, -1.0f, 1.0f, -1.0f,
+    -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f, -1.0f, 1.0f, 1.0f};
+uint16_t CUBE_INDICES[CUBE_INDEX_COUNT] = {
+    0, 2, 1, 0, 3, 2, 4, 5, 6, 4, 6, 7, 0, 1, 5, 0, 5, 4,
+    3, 6, 2, 3, 7, 6, 0, 4, 7, 0, 7, 3, 1, 2, 6, 1, 6, 5};
+
+// Planes are extracted from the rows of the view projection matrix, their normals point inside.
+void updateFrustum(Frustum *frustum, const Mat4 &matViewProj, const Mat4 &matViewProjInv) {
+    const float *m = matViewProj.m;
+    const float rows[4][4] = {
+        {m[0], m[4], m[8], m[12]},
+        {m[1], m[5], m[9], m[13]},
+        {m[2], m[6], m[10], m[14]},
+        {m[3], m[7], m[11], m[15]},
+    };
+    for (uint i = 0; i < PLANE_LENGTH; ++i) {
+        const float *axis = rows[i / 2];
+        const float sign = i % 2 ? -1.0f : 1.0f;
+        Vec3 normal(rows[3][0] + sign * axis[0], rows[3][1] + sign * axis[1], rows[3][2] + sign * axis[2]);
+        const float length = normal.length();
+        frustum->planes[i].normal = normal / length;
+        frustum->planes[i].distance = -(rows[3][3] + sign * axis[3]) / length;
+    }
+
+    const float *inv = matViewProjInv.m;
+    for (uint i = 0; i < 8; ++i) {
+        const float x = i & 1 ? 1.0f : -1.0f;
+        const float y = i & 2 ? 1.0f : -1.0f;
+        const float z = i & 4 ? 1.0f : -1.0f;
+        const float w = inv[3] * x + inv[7] * y + inv[11] * z + inv[15];
+        frustum->vertices[i].set((inv[0] * x + inv[4] * y + inv[8] * z + inv[12]) / w,
+                                 (inv[1] * x + inv[5] * y + inv[9] * z + inv[13]) / w,
+                                 (inv[2] * x + inv[6] * y + inv[10] * z + inv[14]) / w);
+    }
+}
+} // namespace
+
+uint8_t *BenchmarkScene::allocateEntry(se::PoolType type, uint bytes, uint &handle) {
+    auto &pool = _pools[static_cast<uint>(type)];
+    if (!pool.pool) {
+        pool.pool = CC_NEW(se::BufferPool(type, POOL_ENTRY_BITS, bytes));
+        pool.count = 1; // handle 0 stands for none
+    }
+    if (pool.count >= pool.capacity) {
+        pool.pool->allocateNewChunk();
+        pool.capacity += 1 << POOL_ENTRY_BITS;
+    }
+    handle = pool.count++;
+    return pool.pool->getTypedObject<uint8_t>(handle);
+}
+
+uint BenchmarkScene::allocateArray(se::PoolType type, const vector<uint> &handles) {
+    auto &allocator = _allocators[static_cast<uint>(type)];
+    if (!allocator) allocator = CC_NEW(se::BufferAllocator(type));
+
+    // the first element holds the count
+    const uint index = ++_allocatorCounts[static_cast<uint>(type)];
+    allocator->alloc(index, static_cast<uint>(handles.size() + 1) * sizeof(uint32_t));
+    auto *array = se::BufferAllocator::getBuffer<uint32_t>(type, index);
+    array[0] = static_cast<uint32_t>(handles.size());
+    std::copy(handles.begin(), handles.end(), array + 1);
+    return index;
+}
+
+uint8_t *BenchmarkScene::allocateRawBuffer(uint bytes, uint &handle) {
+    auto &allocator = _allocators[static_cast<uint>(se::PoolType::RAW_BUFFER)];
+    if (!allocator) allocator = CC_NEW(se::BufferAllocator(se::PoolType::RAW_BUFFER));
+
+    handle = ++_allocatorCounts[static_cast<uint>(se::PoolType::RAW_BUFFER)];
+    allocator->alloc(handle, bytes);
+    return se::BufferAllocator::getBuffer<uint8_t>(se::PoolType::RAW_BUFFER, handle);
+}
+
+uint BenchmarkScene::bindObject(se::PoolType type, void *object) {
+    auto &pool = _objectPools[static_cast<uint>(type)];
+    if (!pool) {
+        se::HandleObject array(se::Object::createArrayObject(0));
+        pool = CC_NEW(se::ObjectPool(type, array));
+    }
+
+    // the pool reads the native object of the script wrapper once, when it is bound
+    auto *wrapper = se::Object::createPlainObject();
+    wrapper->setPrivateData(object);
+    const auto handle = static_cast<uint>(_boundObjects.size()) + 1;
+    pool->bind(handle, wrapper);
+    _boundObjects.push_back(wrapper);
+    return handle;
+}
+
+bool BenchmarkScene::initialize(const BenchmarkSceneInfo &info, gfx::Device *device) {
+    _info = info;
+    _info.materialCount = std::max(_info.materialCount, 1u);
+    _device = device;
+
+    if (_device && !createDeviceResources()) {
+        destroy();
+        return false;
+    }
+
+    allocate<Scene>(_scene);
+    createMaterials();
+    createModels();
+    createLights();
+    createUIBatches();
+    createCameras();
+
+    auto *shadows = allocate<Shadows>(_shadows);
+    shadows->enabled = 1;
+    shadows->shadowType = static_cast<uint32_t>(ShadowType::SHADOWMAP);
+    shadows->normal.set(0.0f, 1.0f, 0.0f);
+    shadows->size.set(1024.0f, 1024.0f);
+    allocate<Skybox>(_skybox);
+
+    update(0.0f);
+    return true;
+}
+
+bool BenchmarkScene::createDeviceResources() {
+    gfx::ShaderInfo shaderInfo;
+    shaderInfo.name = "benchmark-unlit";
+    shaderInfo.attributes = {{"a_position", gfx::Format::RGB32F}};
+    switch (_device->getGfxAPI()) {
+        case gfx::API::GLES2:
+            shaderInfo.stages = {{gfx::ShaderStageFlagBit::VERTEX, BENCHMARK_VERT_GLSL1}, {gfx::ShaderStageFlagBit::FRAGMENT, BENCHMARK_FRAG_GLSL1}};
+            break;
+        case gfx::API::GLES3:
+            shaderInfo.stages = {{gfx::ShaderStageFlagBit::VERTEX, BENCHMARK_VERT_GLSL3}, {gfx::ShaderStageFlagBit::FRAGMENT, BENCHMARK_FRAG_GLSL3}};
+            break;
+        default:
+            shaderInfo.stages = {{gfx::ShaderStageFlagBit::VERTEX, BENCHMARK_VERT_GLSL4}, {gfx::ShaderStageFlagBit::FRAGMENT, BENCHMARK_FRAG_GLSL4}};
+            break;
+    }
+    _shader = _device->createShader(shaderInfo);
+
+    // the global and material sets are left empty, the queues bind them all the same
+    _materialSetLayout = _device->createDescriptorSetLayout({});
+    _localSetLayout = _device->createDescriptorSetLayout({{UBOLocal::DESCRIPTOR, LIGHTMAP_TEXTURE::DESCRIPTOR}});
+    if (!_shader || !_materialSetLayout || !_localSetLayout) return false;
+    _pipelineLayout = _device->createPipelineLayout({{_materialSetLayout, _materialSetLayout, _localSetLayout}});
+
+    _vertexBuffer = _device->createBuffer({
+        gfx::BufferUsageBit::VERTEX | gfx::BufferUsageBit::TRANSFER_DST,
+        gfx::MemoryUsageBit::HOST | gfx::MemoryUsageBit::DEVICE,
+        sizeof(CUBE_POSITIONS),
+        3 * sizeof(float),
+    });
+    _indexBuffer = _device->createBuffer({
+        gfx::BufferUsageBit::INDEX | gfx::BufferUsageBit::TRANSFER_DST,
+        gfx::MemoryUsageBit::HOST | gfx::MemoryUsageBit::DEVICE,
+        sizeof(CUBE_INDICES),
+        sizeof(uint16_t),
+    });
+
+    // the UI batches draw consecutive quads of one shared buffer, like the 2D renderer does
+    const uint uiQuadCount = std::max(_info.uiBatchCount, 1u);
+    vector<float> uiPositions(uiQuadCount * 4 * 3, 0.0f);
+    vector<uint32_t> uiIndices(uiQuadCount * UI_QUAD_INDEX_COUNT);
+    for (uint i = 0; i < uiQuadCount; ++i) {
+        const uint32_t base = i * 4;
+        const uint32_t quad[UI_QUAD_INDEX_COUNT] = {base, base + 1, base + 2, base, base + 2, base + 3};
+        std::copy(quad, quad + UI_QUAD_INDEX_COUNT, uiIndices.begin() + i * UI_QUAD_INDEX_COUNT);
+    }
+    _uiVertexBuffer = _device->createBuffer({
+        gfx::BufferUsageBit::VERTEX | gfx::BufferUsageBit::TRANSFER_DST,
+        gfx::MemoryUsageBit::HOST | gfx::MemoryUsageBit::DEVICE,
+        static_cast<uint>(uiPositions.size() * sizeof(float)),
+        3 * sizeof(float),
+    });
+    _uiIndexBuffer = _device->createBuffer({
+        gfx::BufferUsageBit::INDEX | gfx::BufferUsageBit::TRANSFER_DST,
+        gfx::MemoryUsageBit::HOST | gfx::MemoryUsageBit::DEVICE,
+        static_cast<uint>(uiIndices.size() * sizeof(uint32_t)),
+        sizeof(uint32_t),
+    });
+    if (!_pipelineLayout || !_vertexBuffer || !_indexBuffer || !_uiVertexBuffer || !_uiIndexBuffer) return false;
+    _vertexBuffer->update(CUBE_POSITIONS, 0, sizeof(CUBE_POSITIONS));
+    _indexBuffer->update(CUBE_INDICES, 0, sizeof(CUBE_INDICES));
+    _uiVertexBuffer->update(uiPositions.data(), 0, _uiVertexBuffer->getSize());
+    _uiIndexBuffer->update(uiIndices.data(), 0, _uiIndexBuffer->getSize());
+
+    gfx::TextureInfo colorInfo;
+    colorInfo.usage = gfx::TextureUsageBit::COLOR_ATTACHMENT | gfx::TextureUsageBit::SAMPLED;
+    colorInfo.format = gfx::Format::RGBA8;
+    colorInfo.width = FRAMEBUFFER_WIDTH;
+    colorInfo.height = FRAMEBUFFER_HEIGHT;
+    _colorTexture = _device->createTexture(colorInfo);
+    gfx::TextureInfo depthStencilInfo = colorInfo;
+    depthStencilInfo.usage = gfx::TextureUsageBit::DEPTH_STENCIL_ATTACHMENT;
+    depthStencilInfo.format = _device->getDepthStencilFormat();
+    _depthStencilTexture = _device->createTexture(depthStencilInfo);
+
+    gfx::ColorAttachment colorAttachment;
+    colorAttachment.format = gfx::Format::RGBA8;
+    colorAttachment.endLayout = gfx::TextureLayout::SHADER_READONLY_OPTIMAL;
+    gfx::DepthStencilAttachment depthStencilAttachment;
+    depthStencilAttachment.format = _device->getDepthStencilFormat();
+    depthStencilAttachment.depthStoreOp = gfx::StoreOp::DISCARD;
+    depthStencilAttachment.stencilStoreOp = gfx::StoreOp::DISCARD;
+    _renderPass = _device->createRenderPass({{colorAttachment}, depthStencilAttachment});
+    if (!_colorTexture || !_depthStencilTexture || !_renderPass) return false;
+
+    _framebuffer = _device->createFramebuffer({_renderPass, {_colorTexture}, _depthStencilTexture});
+    if (!_framebuffer) return false;
+
+    for (const char *name : {"a_matWorld0", "a_matWorld1", "a_matWorld2"}) {
+        _instancedAttributes.push_back(CC_NEW(gfx::Attribute({name, gfx::Format::RGBA32F, false, 0, true})));
+    }
+    return true;
+}
+
+void BenchmarkScene::createMaterials() {
+    uint blendTarget = 0;
+    auto *target = allocate<gfx::BlendTarget>(se::PoolType::BLEND_TARGET, blendTarget);
+    const uint opaqueTargets = allocateArray(se::PoolType::BLEND_TARGET_ARRAY, {blendTarget});
+    uint transparentTarget = 0;
+    target = allocate<gfx::BlendTarget>(se::PoolType::BLEND_TARGET, transparentTarget);
+    target->blend = 1;
+    target->blendSrc = gfx::BlendFactor::SRC_ALPHA;
+    target->blendDst = gfx::BlendFactor::ONE_MINUS_SRC_ALPHA;
+    const uint transparentTargets = allocateArray(se::PoolType::BLEND_TARGET_ARRAY, {transparentTarget});
+
+    uint rasterizerState = 0;
+    allocate<gfx::RasterizerState>(se::PoolType::RASTERIZER_STATE, rasterizerState);
+    uint depthStencilState = 0;
+    allocate<gfx::DepthStencilState>(se::PoolType::DEPTH_STENCIL_STATE, depthStencilState);
+
+    uint materialDescriptorSet = 0;
+    uint pipelineLayout = 0;
+    if (_device) {
+        auto *descriptorSet = _device->createDescriptorSet({_materialSetLayout});
+        _descriptorSets.push_back(descriptorSet);
+        materialDescriptorSet = bindObject(se::PoolType::DESCRIPTOR_SETS, descriptorSet);
+        pipelineLayout = bindObject(se::PoolType::PIPELINE_LAYOUT, _pipelineLayout);
+    }
+
+    const uint phase = getPhaseID("default");
+    // the last pass is the one of the UI batches
+    for (uint i = 0; i <= _info.materialCount; ++i) {
+        const bool isUI = i == _info.materialCount;
+        uint blendState = 0;
+        auto *blendStateData = reinterpret_cast<uint32_t *>(allocateEntry(se::PoolType::BLEND_STATE, BLEND_STATE_BYTES, blendState));
+        blendStateData[6] = isUI ? transparentTargets : opaqueTargets;
+
+        uint handle = 0;
+        auto *pass = allocate<PassView>(handle);
+        pass->priority = DEFAULT_PRIORITY;
+        pass->phase = phase;
+        // materials alternate between the schemes so both batching paths are fed from one scene
+        pass->batchingScheme = static_cast<uint32_t>(i % 2 ? BatchingSchemes::VB_MERGING : BatchingSchemes::INSTANCING);
+        pass->primitive = static_cast<uint32_t>(gfx::PrimitiveMode::TRIANGLE_LIST);
+        pass->hash = i + 1;
+        pass->rasterizerStateID = rasterizerState;
+        pass->depthStencilStateID = depthStencilState;
+        pass->blendStateID = blendState;
+        pass->descriptorSetID = materialDescriptorSet;
+        pass->pipelineLayoutID = pipelineLayout;
+        _passes.push_back(handle);
+    }
+}
+
+void BenchmarkScene::createModels() {
+    std::mt19937 random(_info.seed);
+    std::uniform_real_distribution<float> position(-_info.extent, _info.extent);
+    std::uniform_real_distribution<float> size(0.5f, 2.0f);
+
+    // every model shares the mesh, the batched buffers copy its flat vertex buffer
+    uint flatBufferData = 0;
+    auto *vertices = allocateRawBuffer(sizeof(CUBE_POSITIONS), flatBufferData);
+    memcpy(vertices, CUBE_POSITIONS, sizeof(CUBE_POSITIONS));
+    uint flatBuffer = 0;
+    auto *flatBufferView = allocate<FlatBufferView>(flatBuffer);
+    flatBufferView->stride = 3 * sizeof(float);
+    flatBufferView->count = CUBE_VERTEX_COUNT;
+    flatBufferView->bufferID = flatBufferData;
+    uint subMesh = 0;
+    allocate<RenderingSubMesh>(subMesh)->flatBuffersID = allocateArray(se::PoolType::FLAT_BUFFER_ARRAY, {flatBuffer});
+
+    uint shader = 0;
+    uint instancedAttributes = 0;
+    if (_device) {
+        shader = bindObject(se::PoolType::SHADER, _shader);
+        vector<uint> attributeHandles;
+        for (auto *attribute : _instancedAttributes) {
+            attributeHandles.push_back(bindObject(se::PoolType::ATTRIBUTE, attribute));
+        }
+        instancedAttributes = allocateArray(se::PoolType::ATTRIBUTE_ARRAY, attributeHandles);
+    }
+
+    _models.reserve(_info.modelCount);
+    _subModels.reserve(_info.modelCount);
+    for (uint i = 0; i < _info.modelCount; ++i) {
+        uint nodeHandle = 0;
+        auto *node = allocate<Node>(nodeHandle);
+        node->layer = static_cast<uint>(LayerList::DEFAULT);
+        node->worldScale.set(1.0f, 1.0f, 1.0f);
+        node->worldPosition.set(position(random), position(random), position(random));
+        node->worldRotation.set(0.0f, 0.0f, 0.0f, 1.0f);
+
+        uint bounds = 0;
+        auto *aabb = allocate<AABB>(bounds);
+        aabb->center = node->worldPosition;
+        aabb->halfExtents.set(size(random), size(random), size(random));
+
+        uint subModelHandle = 0;
+        auto *subModel = allocate<SubModelView>(subModelHandle);
+        subModel->priority = DEFAULT_PRIORITY;
+        subModel->passCount = 1;
+        subModel->passID[0] = _passes[i % _info.materialCount];
+        subModel->subMeshID = subMesh;
+        if (_device) {
+            auto *localBuffer = _device->createBuffer({
+                gfx::BufferUsageBit::UNIFORM | gfx::BufferUsageBit::TRANSFER_DST,
+                gfx::MemoryUsageBit::HOST | gfx::MemoryUsageBit::DEVICE,
+                UBOLocal::SIZE,
+                UBOLocal::SIZE,
+            });
+            auto *descriptorSet = _device->createDescriptorSet({_localSetLayout});
+            descriptorSet->bindBuffer(UBOLocal::BINDING, localBuffer);
+            descriptorSet->update();
+            auto *inputAssembler = _device->createInputAssembler({{{"a_position", gfx::Format::RGB32F}}, {_vertexBuffer}, _indexBuffer});
+            _localBuffers.push_back(localBuffer);
+            _descriptorSets.push_back(descriptorSet);
+            _inputAssemblers.push_back(inputAssembler);
+
+            subModel->shaderID[0] = shader;
+            subModel->descriptorSetID = bindObject(se::PoolType::DESCRIPTOR_SETS, descriptorSet);
+            subModel->inputAssemblerID = bindObject(se::PoolType::INPUT_ASSEMBLER, inputAssembler);
+        }
+        _subModels.push_back(subModelHandle);
+
+        uint modelHandle = 0;
+        auto *model = allocate<ModelView>(modelHandle);
+        model->enabled = 1;
+        model->visFlags = static_cast<uint>(LayerList::DEFAULT);
+        model->castShadow = i % 2;
+        model->receiveShadow = 1;
+        model->worldBoundsID = bounds;
+        model->nodeID = nodeHandle;
+        model->transformID = nodeHandle;
+        model->subModelsID = allocateArray(se::PoolType::SUB_MODEL_ARRAY, {subModelHandle});
+        if (_device) {
+            allocateRawBuffer(INSTANCED_STRIDE, model->instancedBufferID);
+            model->instancedAttrsID = instancedAttributes;
+        }
+        _models.push_back(modelHandle);
+    }
+
+    GET_SCENE(_scene)->modelsID = allocateArray(se::PoolType::MODEL_ARRAY, _models);
+}
+
+void BenchmarkScene::createLights() {
+    std::mt19937 random(_info.seed + 1);
+    std::uniform_real_distribution<float> position(-_info.extent, _info.extent);
+    std::uniform_real_distribution<float> range(5.0f, 50.0f);
+
+    auto *scene = GET_SCENE(_scene);
+    uint mainLightNode = 0;
+    auto *node = allocate<Node>(mainLightNode);
+    node->worldRotation.set(0.0f, 0.0f, 0.0f, 1.0f);
+    auto *mainLight = allocate<Light>(scene->mainLightID);
+    mainLight->lightType = static_cast<uint32_t>(LightType::DIRECTIONAL);
+    mainLight->nodeID = mainLightNode;
+    mainLight->direction.set(0.0f, -1.0f, -1.0f);
+    mainLight->direction.normalize();
+    mainLight->color.set(1.0f, 1.0f, 1.0f);
+
+    vector<uint> spotLights;
+    for (uint i = 0; i < _info.lightCount; ++i) {
+        uint handle = 0;
+        auto *light = allocate<Light>(handle);
+        light->lightType = static_cast<uint32_t>(LightType::SPOT);
+        light->position.set(position(random), position(random), position(random));
+        light->range = range(random);
+        light->spotAngle = 0.5f;
+        light->direction.set(0.0f, -1.0f, 0.0f);
+        light->color.set(1.0f, 1.0f, 1.0f);
+        spotLights.push_back(handle);
+    }
+    scene->spotLights = allocateArray(se::PoolType::LIGHT_ARRAY, spotLights);
+    scene->sphereLights = allocateArray(se::PoolType::LIGHT_ARRAY, {});
+}
+
+void BenchmarkScene::createUIBatches() {
+    uint shader = 0;
+    uint descriptorSet = 0;
+    if (_device && _info.uiBatchCount) {
+        shader = bindObject(se::PoolType::SHADER, _shader);
+        auto *localSet = _device->createDescriptorSet({_localSetLayout});
+        _descriptorSets.push_back(localSet);
+        descriptorSet = bindObject(se::PoolType::DESCRIPTOR_SETS, localSet);
+    }
+
+    for (uint i = 0; i < _info.uiBatchCount; ++i) {
+        uint handle = 0;
+        auto *batch = allocate<UIBatch>(handle);
+        batch->visFlags = static_cast<uint>(LayerList::UI_2D);
+        batch->passCount = 1;
+        batch->passID[0] = _passes.back();
+        batch->shaderID[0] = shader;
+        batch->descriptorSetID = descriptorSet;
+        if (_device) {
+            auto *inputAssembler = _device->createInputAssembler({{{"a_position", gfx::Format::RGB32F}}, {_uiVertexBuffer}, _uiIndexBuffer});
+            inputAssembler->setFirstIndex(i * UI_QUAD_INDEX_COUNT);
+            inputAssembler->setIndexCount(UI_QUAD_INDEX_COUNT);
+            _inputAssemblers.push_back(inputAssembler);
+            batch->inputAssemblerID = bindObject(se::PoolType::INPUT_ASSEMBLER, inputAssembler);
+        }
+        _uiBatches.push_back(handle);
+    }
+    GET_SCENE(_scene)->uiBatches = allocateArray(se::PoolType::UI_BATCH_ARRAY, _uiBatches);
+}
+
+void BenchmarkScene::createCameras() {
+    uint window = 0;
+    allocate<RenderWindow>(window);
+
+    for (auto *handle : {&_camera, &_uiCamera}) {
+        auto *camera = allocate<Camera>(*handle);
+        camera->width = FRAMEBUFFER_WIDTH;
+        camera->height = FRAMEBUFFER_HEIGHT;
+        camera->clearFlag = static_cast<uint32_t>(gfx::ClearFlagBit::ALL);
+        camera->clearDepth = 1.0f;
+        camera->sceneID = _scene;
+        camera->windowID = window;
+        camera->viewportWidth = 1.0f;
+        camera->viewportHeight = 1.0f;
+        allocate<Node>(camera->nodeID);
+        allocate<Frustum>(camera->frustumID);
+    }
+    getCamera()->visibility = CAMERA_DEFAULT_MASK;
+    getUICamera()->visibility = static_cast<uint>(LayerList::UI_2D);
+    getUICamera()->clearFlag = static_cast<uint32_t>(gfx::ClearFlagBit::DEPTH_STENCIL);
+}
+
+void BenchmarkScene::updateCamera(Camera *camera, const Vec3 &position, float angle) {
+    camera->position = position;
+    camera->forward.set(std::sin(angle), 0.0f, -std::cos(angle));
+    Mat4::createLookAt(position, position + camera->forward, Vec3(0.0f, 1.0f, 0.0f), &camera->matView);
+    Mat4::createPerspective(MATH_DEG_TO_RAD(45.0f), static_cast<float>(camera->width) / camera->height, 1.0f, _info.extent * 2.0f, &camera->matProj);
+    camera->matProjInv = camera->matProj.getInversed();
+    Mat4::multiply(camera->matProj, camera->matView, &camera->matViewProj);
+    camera->matViewProjInv = camera->matViewProj.getInversed();
+    updateFrustum(GET_FRUSTUM(camera->frustumID), camera->matViewProj, camera->matViewProjInv);
+
+    auto *node = GET_NODE(camera->nodeID);
+    node->worldPosition = position;
+    node->flagsChanged = 1;
+}
+
+void BenchmarkScene::update(float time) {
+    // the camera turns around the center, so a different part of the scene passes culling every frame
+    updateCamera(getCamera(), Vec3::ZERO, time * 0.5f);
+    updateCamera(getUICamera(), Vec3::ZERO, 0.0f);
+
+    const float offset = std::sin(time) * 0.1f;
+    for (uint i = 0; i < _models.size(); ++i) {
+        const auto *model = GET_MODEL(_models[i]);
+        auto *node = GET_NODE(model->nodeID);
+        node->worldPosition.y += offset;
+        node->flagsChanged = 1;
+        Mat4::createTranslation(node->worldPosition, &node->worldMatrix);
+        GET_AABB(model->worldBoundsID)->center = node->worldPosition;
+
+        if (model->instancedBufferID) {
+            // per-instance data is the transposed world matrix without its last row
+            uint size = 0;
+            auto *instance = reinterpret_cast<float *>(GET_RAW_BUFFER(model->instancedBufferID, &size));
+            const float *m = node->worldMatrix.m;
+            for (uint row = 0; row < 3; ++row) {
+                for (uint column = 0; column < 4; ++column) {
+                    instance[row * 4 + column] = m[column * 4 + row];
+                }
+            }
+        }
+    }
+}
+
+void BenchmarkScene::destroy() {
+    for (auto *inputAssembler : _inputAssemblers) CC_SAFE_DESTROY(inputAssembler);
+    _inputAssemblers.clear();
+    for (auto *descriptorSet : _descriptorSets) CC_SAFE_DESTROY(descriptorSet);
+    _descriptorSets.clear();
+    for (auto *buffer : _localBuffers) CC_SAFE_DESTROY(buffer);
+    _localBuffers.clear();
+    for (auto *attribute : _instancedAttributes) CC_DELETE(attribute);
+    _instancedAttributes.clear();
+
+    CC_SAFE_DESTROY(_framebuffer);
+    CC_SAFE_DESTROY(_renderPass);
+    CC_SAFE_DESTROY(_depthStencilTexture);
+    CC_SAFE_DESTROY(_colorTexture);
+    CC_SAFE_DESTROY(_uiIndexBuffer);
+    CC_SAFE_DESTROY(_uiVertexBuffer);
+    CC_SAFE_DESTROY(_indexBuffer);
+    CC_SAFE_DESTROY(_vertexBuffer);
+    CC_SAFE_DESTROY(_pipelineLayout);
+    CC_SAFE_DESTROY(_localSetLayout);
+    CC_SAFE_DESTROY(_materialSetLayout);
+    CC_SAFE_DESTROY(_shader);
+
+    for (auto *wrapper : _boundObjects) {
+        wrapper->clearPrivateData();
+        wrapper->decRef();
+    }
+    _boundObjects.clear();
+    for (auto &pair : _objectPools) CC_DELETE(pair.second);
+    _objectPools.clear();
+    for (auto &pair : _allocators) CC_DELETE(pair.second);
+    _allocators.clear();
+    _allocatorCounts.clear();
+    for (auto &pair : _pools) CC_DELETE(pair.second.pool);
+    _pools.clear();
+
+    _passes.clear();
+    _models.clear();
+    _subModels.clear();
+    _uiBatches.clear();
+    _scene = _camera = _uiCamera = _shadows = _skybox = 0;
+    _device = nullptr;
+}
+
+} // namespace pipeline
+} // namespace cc
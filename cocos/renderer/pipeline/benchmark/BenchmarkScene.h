@@ -0,0 +1,133 @@
+#pragma once
+
+#include "base/TypeDef.h"
+#include "bindings/dop/PoolType.h"
+#include "pipeline/helper/SharedMemory.h"
+
+#include <unordered_map>
+
+namespace se {
+class BufferPool;
+class BufferAllocator;
+class ObjectPool;
+class Object;
+} // namespace se
+
+namespace cc {
+namespace gfx {
+class Buffer;
+class DescriptorSet;
+class DescriptorSetLayout;
+class Device;
+class Framebuffer;
+class InputAssembler;
+class PipelineLayout;
+class RenderPass;
+class Shader;
+class Texture;
+} // namespace gfx
+
+namespace pipeline {
+
+struct CC_DLL BenchmarkSceneInfo {
+    uint modelCount = 10000;
+    uint lightCount = 32;
+    uint uiBatchCount = 1000;
+    uint materialCount = 16;
+    float extent = 500.0f; // models are scattered in a cube of this half size around the camera
+    uint seed = 1;
+};
+
+// A synthetic scene written straight into the shared memory pools which the script side fills in a game,
+// so the pipeline reads it exactly like a real one. The pools are backed by script array buffers,
+// the script engine has to be started before the scene is initialized.
+// Without a device only the data read by culling and sorting is created, with one every sub-model and
+// UI batch also gets the gfx objects merging and command recording need.
+class CC_DLL BenchmarkScene {
+public:
+    static constexpr uint FRAMEBUFFER_WIDTH = 1280;
+    static constexpr uint FRAMEBUFFER_HEIGHT = 720;
+
+    bool initialize(const BenchmarkSceneInfo &info, gfx::Device *device);
+    void destroy();
+
+    // Moves the models and the camera, so every iteration reads changed data like a running game does.
+    void update(float time);
+
+    CC_INLINE const BenchmarkSceneInfo &getInfo() const { return _info; }
+    CC_INLINE Camera *getCamera() const { return GET_CAMERA(_camera); }
+    CC_INLINE Camera *getUICamera() const { return GET_CAMERA(_uiCamera); }
+    CC_INLINE uint getShadows() const { return _shadows; }
+    CC_INLINE uint getSkybox() const { return _skybox; }
+    CC_INLINE const vector<uint> &getPasses() const { return _passes; }
+    CC_INLINE gfx::RenderPass *getRenderPass() const { return _renderPass; }
+    CC_INLINE gfx::Framebuffer *getFramebuffer() const { return _framebuffer; }
+    CC_INLINE bool hasDevice() const { return _device != nullptr; }
+
+private:
+    struct Pool {
+        se::BufferPool *pool = nullptr;
+        uint count = 0;
+        uint capacity = 0;
+    };
+
+    template <typename T>
+    T *allocate(uint &handle) {
+        return allocate<T>(T::type, handle);
+    }
+    template <typename T>
+    T *allocate(se::PoolType type, uint &handle) {
+        return new (allocateEntry(type, sizeof(T), handle)) T();
+    }
+    uint8_t *allocateEntry(se::PoolType type, uint bytes, uint &handle);
+    uint allocateArray(se::PoolType type, const vector<uint> &handles);
+    uint8_t *allocateRawBuffer(uint bytes, uint &handle);
+    uint bindObject(se::PoolType type, void *object);
+
+    void createCameras();
+    void createMaterials();
+    void createModels();
+    void createLights();
+    bool createDeviceResources();
+    void createUIBatches();
+    void updateCamera(Camera *camera, const Vec3 &position, float angle);
+
+    BenchmarkSceneInfo _info;
+    gfx::Device *_device = nullptr;
+
+    std::unordered_map<uint, Pool> _pools;
+    std::unordered_map<uint, se::BufferAllocator *> _allocators;
+    std::unordered_map<uint, uint> _allocatorCounts;
+    std::unordered_map<uint, se::ObjectPool *> _objectPools;
+    vector<se::Object *> _boundObjects;
+
+    uint _scene = 0;
+    uint _camera = 0;
+    uint _uiCamera = 0;
+    uint _shadows = 0;
+    uint _skybox = 0;
+    vector<uint> _passes;
+    vector<uint> _models;
+    vector<uint> _subModels;
+    vector<uint> _uiBatches;
+
+    gfx::Shader *_shader = nullptr;
+    gfx::DescriptorSetLayout *_materialSetLayout = nullptr;
+    gfx::DescriptorSetLayout *_localSetLayout = nullptr;
+    gfx::PipelineLayout *_pipelineLayout = nullptr;
+    gfx::Buffer *_vertexBuffer = nullptr;
+    gfx::Buffer *_indexBuffer = nullptr;
+    gfx::Buffer *_uiVertexBuffer = nullptr;
+    gfx::Buffer *_uiIndexBuffer = nullptr;
+    gfx::Texture *_colorTexture = nullptr;
+    gfx::Texture *_depthStencilTexture = nullptr;
+    gfx::RenderPass *_renderPass = nullptr;
+    gfx::Framebuffer *_framebuffer = nullptr;
+    vector<gfx::Buffer *> _localBuffers;
+    vector<gfx::DescriptorSet *> _descriptorSets;
+    vector<gfx::InputAssembler *> _inputAssemblers;
+    vector<gfx::Attribute *> _instancedAttributes;
+};
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,473 @@
+// Headless benchmark of the native render pipeline, built with USE_BENCHMARK.
+//
+//   cocos2d-benchmark [--models N] [--lights N] [--ui-batches N] [--materials N]
+//                     [--iterations N] [--warmup N] [--seed N] [--device none|gles2|gles3|vulkan] [--output file]
+//
+// Culling, sorting, the batched math and the UTF conversions run on every platform. The merge and command recording benchmarks need a device,
+// which is created on a hidden window where the build supports one. Results are written as one JSON
+// document, the timings are in microseconds per iteration.
+
+#include "cocos2d.h"
+#include "base/FrameStats.h"
+#include "base/UTF8.h"
+#include "base/memory/FrameAlloc.h"
+#include "bindings/jswrapper/SeApi.h"
+#include "gfx/GFXCommandBuffer.h"
+#include "gfx/GFXDevice.h"
+#include "gfx/GFXQueue.h"
+#include "math/Quaternion.h"
+#include "pipeline/BatchedBuffer.h"
+#include "pipeline/InstancedBuffer.h"
+#include "pipeline/RenderBatchedQueue.h"
+#include "pipeline/RenderInstancedQueue.h"
+#include "pipeline/RenderQueue.h"
+#include "pipeline/benchmark/BenchmarkScene.h"
+#include "pipeline/forward/ForwardPipeline.h"
+#include "pipeline/forward/SceneCulling.h"
+#include "pipeline/forward/UIPhase.h"
+#include "renderer/benchmark/BenchmarkDevice.h"
+#include "renderer/benchmark/BenchmarkHarness.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+
+using namespace cc;
+using namespace cc::pipeline;
+
+namespace {
+struct Options {
+    BenchmarkSceneInfo scene;
+    uint iterations = 100;
+    uint warmup = 10;
+    std::string device = "none";
+    std::string output;
+};
+
+struct Result {
+    std::string name;
+    uint items = 0; // work items of the last iteration: models, passes or draws
+    vector<double> samples;
+};
+
+bool parseOptions(int argc, char **argv, Options &options) {
+    return parseBenchmarkOptions(argc, argv, options.output, [&](const char *name, const char *value, uint number) {
+        if (!strcmp(name, "--models")) {
+            options.scene.modelCount = number;
+        } else if (!strcmp(name, "--lights")) {
+            options.scene.lightCount = number;
+        } else if (!strcmp(name, "--ui-batches")) {
+            options.scene.uiBatchCount = number;
+        } else if (!strcmp(name, "--materials")) {
+            options.scene.materialCount = std::max(number, 1u);
+        } else if (!strcmp(name, "--seed")) {
+            options.scene.seed = number;
+        } else if (!strcmp(name, "--iterations")) {
+            options.iterations = std::max(number, 1u);
+        } else if (!strcmp(name, "--warmup")) {
+            options.warmup = number;
+        } else if (!strcmp(name, "--device")) {
+            options.device = value;
+        } else {
+            return false;
+        }
+        return true;
+    });
+}
+
+class Benchmark {
+public:
+    Benchmark(const Options &options, BenchmarkScene &scene) : _options(options), _scene(scene) {}
+
+    // prepare runs untimed before every iteration, run returns the number of items it processed
+    void measure(const char *name, const std::function<void()> &prepare, const std::function<uint()> &run) {
+        Result result;
+        result.name = name;
+        result.samples.reserve(_options.iterations);
+        const uint total = _options.warmup + _options.iterations;
+        for (uint i = 0; i < total; ++i) {
+            _scene.update(static_cast<float>(_frame++) / 60.0f);
+            if (prepare) prepare();
+            const auto begin = std::chrono::steady_clock::now();
+            result.items = run();
+            const auto end = std::chrono::steady_clock::now();
+            if (i >= _options.warmup) result.samples.push_back(std::chrono::duration<double, std::micro>(end - begin).count());
+        }
+        fprintf(stderr, "%-36s %10u items\n", name, result.items);
+        _results.emplace_back(std::move(result));
+    }
+
+    CC_INLINE const vector<Result> &getResults() const { return _results; }
+
+private:
+    const Options &_options;
+    BenchmarkScene &_scene;
+    vector<Result> _results;
+    uint _frame = 0;
+};
+
+void appendResult(std::string &json, const Result &result) {
+    auto samples = result.samples;
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (const auto sample : samples) sum += sample;
+    const auto count = samples.size();
+    char buffer[512];
+    snprintf(buffer, sizeof(buffer),
+             "{\"name\":\"%s\",\"items\":%u,\"iterations\":%u,\"meanUs\":%.3f,\"medianUs\":%.3f,\"minUs\":%.3f,\"p95Us\":%.3f,\"maxUs\":%.3f}",
+             result.name.c_str(), result.items, static_cast<uint>(count), sum / count, samples[count / 2], samples.front(),
+             samples[std::min(count - 1, count * 95 / 100)], samples.back());
+    json += buffer;
+}
+
+std::string toJSON(const Options &options, const char *deviceName, const vector<Result> &results) {
+    char buffer[512];
+    snprintf(buffer, sizeof(buffer),
+             "{\"schema\":1,\"engine\":\"%s\",\"device\":\"%s\",\"frameStats\":%s,"
+             "\"scene\":{\"models\":%u,\"lights\":%u,\"uiBatches\":%u,\"materials\":%u,\"seed\":%u},\"results\":[",
+             cocos2dVersion(), deviceName, CC_USE_FRAME_STATS ? "true" : "false", options.scene.modelCount, options.scene.lightCount,
+             options.scene.uiBatchCount, options.scene.materialCount, options.scene.seed);
+    std::string json = buffer;
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (i) json += ',';
+        appendResult(json, results[i]);
+    }
+    json += "]}\n";
+    return json;
+}
+
+uint fillQueue(RenderQueue &queue, const RenderObjectList &renderObjects) {
+    queue.clear();
+    for (const auto &renderObject : renderObjects) {
+        const auto subModelID = renderObject.model->getSubModelID();
+        for (uint i = 0; i < subModelID[0]; ++i) {
+            const auto *subModel = renderObject.model->getSubModelView(subModelID[i + 1]);
+            for (uint j = 0; j < subModel->passCount; ++j) queue.insertRenderPass(renderObject, i, j);
+        }
+    }
+    return static_cast<uint>(renderObjects.size());
+}
+
+void runCPUBenchmarks(Benchmark &benchmark, ForwardPipeline *pipeline, BenchmarkScene &scene) {
+    auto *camera = scene.getCamera();
+    const auto &renderObjects = pipeline->getRenderObjects();
+
+    pipeline->setParallelCulling(false);
+    benchmark.measure("sceneCulling", nullptr, [&]() {
+        sceneCulling(pipeline, camera);
+        return static_cast<uint>(renderObjects.size());
+    });
+    pipeline->setParallelCulling(true);
+    benchmark.measure("sceneCulling.parallel", nullptr, [&]() {
+        sceneCulling(pipeline, camera);
+        return static_cast<uint>(renderObjects.size());
+    });
+    pipeline->setParallelCulling(false);
+
+    benchmark.measure("shadowCollecting", nullptr, [&]() {
+        shadowCollecting(pipeline, camera);
+        return static_cast<uint>(pipeline->getShadowObjects().size());
+    });
+    std::vector<const Light *> lights;
+    benchmark.measure("lightCollecting", nullptr, [&]() {
+        lightCollecting(camera, lights);
+        return static_cast<uint>(lights.size());
+    });
+
+    RenderQueue queue({false, getPhaseID("default"), opaqueCompareFn, RenderQueueSortMode::FRONT_TO_BACK});
+    const auto prepareQueue = [&]() {
+        sceneCulling(pipeline, camera);
+        fillQueue(queue, renderObjects);
+    };
+    queue.setRadixSort(false);
+    benchmark.measure("RenderQueue::sort", prepareQueue, [&]() {
+        queue.sort();
+        return static_cast<uint>(renderObjects.size());
+    });
+    queue.setRadixSort(true);
+    benchmark.measure("RenderQueue::sort.radix", prepareQueue, [&]() {
+        queue.sort();
+        return static_cast<uint>(renderObjects.size());
+    });
+}
+
+// The batched math routines against a loop over their per-element versions, which are the C paths.
+void runMathBenchmarks(Benchmark &benchmark) {
+    constexpr uint COUNT = 4096;
+    vector<Quaternion> q1(COUNT), q2(COUNT), quats(COUNT);
+    vector<Vec3> v1(COUNT), v2(COUNT), vectors(COUNT);
+    vector<float> dots(COUNT);
+    for (uint i = 0; i < COUNT; ++i) {
+        const auto f = static_cast<float>(i);
+        q1[i].set(std::sin(f), std::cos(f), std::sin(f * 0.5f), std::cos(f * 0.3f));
+        q1[i].normalize();
+        q2[i].set(std::cos(f * 0.7f), std::sin(f * 1.3f), std::cos(f), std::sin(f * 0.1f));
+        q2[i].normalize();
+        v1[i].set(std::sin(f) * 10.0f, std::cos(f * 0.2f) * 5.0f, f * 0.01f);
+        v2[i].set(std::cos(f), std::sin(f * 0.6f), std::cos(f * 0.9f));
+    }
+    const Quaternion &rotation = q1[0];
+
+    benchmark.measure("Quaternion::multiply", nullptr, [&]() {
+        for (uint i = 0; i < COUNT; ++i) Quaternion::multiply(q1[i], q2[i], &quats[i]);
+        return COUNT;
+    });
+    benchmark.measure("Quaternion::multiply.batch", nullptr, [&]() {
+        Quaternion::multiply(q1.data(), q2.data(), quats.data(), COUNT);
+        return COUNT;
+    });
+    benchmark.measure("Quaternion::slerp", nullptr, [&]() {
+        for (uint i = 0; i < COUNT; ++i) Quaternion::slerp(q1[i], q2[i], 0.3f, &quats[i]);
+        return COUNT;
+    });
+    benchmark.measure("Quaternion::slerp.batch", nullptr, [&]() {
+        Quaternion::slerp(q1.data(), q2.data(), 0.3f, quats.data(), COUNT);
+        return COUNT;
+    });
+    benchmark.measure("Vec3::transformQuat", nullptr, [&]() {
+        for (uint i = 0; i < COUNT; ++i) {
+            vectors[i] = v1[i];
+            vectors[i].transformQuat(rotation);
+        }
+        return COUNT;
+    });
+    benchmark.measure("Vec3::transformQuat.batch", nullptr, [&]() {
+        Vec3::transformQuat(v1.data(), rotation, vectors.data(), COUNT);
+        return COUNT;
+    });
+    benchmark.measure("Vec3::normalize", nullptr, [&]() {
+        for (uint i = 0; i < COUNT; ++i) {
+            vectors[i] = v1[i];
+            vectors[i].normalize();
+        }
+        return COUNT;
+    });
+    benchmark.measure("Vec3::normalize.batch", nullptr, [&]() {
+        Vec3::normalize(v1.data(), vectors.data(), COUNT);
+        return COUNT;
+    });
+    benchmark.measure("Vec3::dot", nullptr, [&]() {
+        for (uint i = 0; i < COUNT; ++i) dots[i] = v1[i].dot(v2[i]);
+        return COUNT;
+    });
+    benchmark.measure("Vec3::dot.batch", nullptr, [&]() {
+        Vec3::dot(v1.data(), v2.data(), dots.data(), COUNT);
+        return COUNT;
+    });
+}
+
+// The conversions of the strings crossing to the scripts and Java, on ASCII text and on text mixing CJK with it,
+// items are the characters converted.
+void runStringBenchmarks(Benchmark &benchmark) {
+    constexpr uint COUNT = 64 * 1024;
+    std::string ascii;
+    std::string mixed;
+    for (uint i = 0; i < COUNT; ++i) {
+        ascii += static_cast<char>('a' + i % 26);
+        if (i % 8 < 5) {
+            mixed += "\xe4\xbd\xa0"; // U+4F60
+        } else {
+            mixed += static_cast<char>('a' + i % 26);
+        }
+    }
+    std::u16string ascii16;
+    std::u16string mixed16;
+    StringUtils::UTF8ToUTF16(ascii, ascii16);
+    StringUtils::UTF8ToUTF16(mixed, mixed16);
+    std::u16string utf16;
+    std::string utf8;
+
+    benchmark.measure("StringUtils::UTF8ToUTF16.ascii", nullptr, [&]() {
+        StringUtils::UTF8ToUTF16(ascii, utf16);
+        return COUNT;
+    });
+    benchmark.measure("StringUtils::UTF8ToUTF16.mixed", nullptr, [&]() {
+        StringUtils::UTF8ToUTF16(mixed, utf16);
+        return COUNT;
+    });
+    benchmark.measure("StringUtils::UTF16ToUTF8.ascii", nullptr, [&]() {
+        StringUtils::UTF16ToUTF8(ascii16, utf8);
+        return COUNT;
+    });
+    benchmark.measure("StringUtils::UTF16ToUTF8.mixed", nullptr, [&]() {
+        StringUtils::UTF16ToUTF8(mixed16, utf8);
+        return COUNT;
+    });
+}
+
+// Records into an offscreen framebuffer, a frame is acquired and submitted around every iteration.
+void measureRecording(Benchmark &benchmark, gfx::Device *device, BenchmarkScene &scene, const char *name,
+                      const std::function<void(gfx::CommandBuffer *)> &prepare, const std::function<uint(gfx::CommandBuffer *)> &record) {
+    auto *cmdBuff = device->getCommandBuffer();
+    const gfx::Rect renderArea = {0, 0, BenchmarkScene::FRAMEBUFFER_WIDTH, BenchmarkScene::FRAMEBUFFER_HEIGHT};
+    const gfx::Color clearColor = {0.0f, 0.0f, 0.0f, 1.0f};
+    bool isRecording = false;
+    const auto endFrame = [&]() {
+        if (!isRecording) return;
+        cmdBuff->endRenderPass();
+        cmdBuff->end();
+        device->getQueue()->submit({cmdBuff});
+        device->present();
+        FrameStats::endFrame();
+        FrameAllocator::endFrame();
+        isRecording = false;
+    };
+
+    benchmark.measure(
+        name, [&]() {
+            endFrame();
+            device->acquire();
+            cmdBuff->begin();
+            if (prepare) prepare(cmdBuff);
+            cmdBuff->beginRenderPass(scene.getRenderPass(), scene.getFramebuffer(), renderArea, &clearColor, 1.0f, 0);
+            isRecording = true; },
+        [&]() { return record(cmdBuff); });
+    endFrame();
+}
+
+void runDeviceBenchmarks(Benchmark &benchmark, gfx::Device *device, ForwardPipeline *pipeline, BenchmarkScene &scene) {
+    auto *camera = scene.getCamera();
+    const auto &renderObjects = pipeline->getRenderObjects();
+    const auto &passes = scene.getPasses();
+
+    // every visible sub-model is merged, whatever the batching scheme of its material
+    const auto mergeInstances = [&]() {
+        uint count = 0;
+        for (const auto &renderObject : renderObjects) {
+            const auto subModelID = renderObject.model->getSubModelID();
+            const auto *subModel = renderObject.model->getSubModelView(subModelID[1]);
+            InstancedBuffer::get(subModel->passID[0])->merge(renderObject.model, subModel, 0);
+            ++count;
+        }
+        return count;
+    };
+    const auto mergeBatches = [&]() {
+        uint count = 0;
+        for (const auto &renderObject : renderObjects) {
+            const auto subModelID = renderObject.model->getSubModelID();
+            const auto *subModel = renderObject.model->getSubModelView(subModelID[1]);
+            BatchedBuffer::get(subModel->passID[0])->merge(subModel, 0, renderObject.model);
+            ++count;
+        }
+        return count;
+    };
+    const auto clearBuffers = [&]() {
+        for (const auto pass : passes) {
+            InstancedBuffer::get(pass)->clear();
+            BatchedBuffer::get(pass)->clear();
+        }
+    };
+
+    benchmark.measure("InstancedBuffer::merge", [&]() { sceneCulling(pipeline, camera); clearBuffers(); }, mergeInstances);
+    benchmark.measure("BatchedBuffer::merge", [&]() { sceneCulling(pipeline, camera); clearBuffers(); }, mergeBatches);
+
+    RenderQueue queue({false, getPhaseID("default"), opaqueCompareFn, RenderQueueSortMode::FRONT_TO_BACK});
+    measureRecording(
+        benchmark, device, scene, "RenderQueue::recordCommandBuffer",
+        [&](gfx::CommandBuffer *) {
+            sceneCulling(pipeline, camera);
+            fillQueue(queue, renderObjects);
+            queue.sort();
+        },
+        [&](gfx::CommandBuffer *cmdBuff) {
+            queue.recordCommandBuffer(device, scene.getRenderPass(), cmdBuff);
+            return static_cast<uint>(renderObjects.size());
+        });
+
+    RenderInstancedQueue instancedQueue;
+    measureRecording(
+        benchmark, device, scene, "RenderInstancedQueue::recordCommandBuffer",
+        [&](gfx::CommandBuffer *cmdBuff) {
+            sceneCulling(pipeline, camera);
+            instancedQueue.clear();
+            mergeInstances();
+            for (const auto pass : passes) instancedQueue.add(InstancedBuffer::get(pass));
+            instancedQueue.uploadBuffers(cmdBuff);
+        },
+        [&](gfx::CommandBuffer *cmdBuff) {
+            instancedQueue.recordCommandBuffer(device, scene.getRenderPass(), cmdBuff);
+            return static_cast<uint>(passes.size());
+        });
+    instancedQueue.clear();
+
+    RenderBatchedQueue batchedQueue;
+    measureRecording(
+        benchmark, device, scene, "RenderBatchedQueue::recordCommandBuffer",
+        [&](gfx::CommandBuffer *cmdBuff) {
+            sceneCulling(pipeline, camera);
+            batchedQueue.clear();
+            mergeBatches();
+            for (const auto pass : passes) batchedQueue.add(BatchedBuffer::get(pass));
+            batchedQueue.uploadBuffers(cmdBuff);
+        },
+        [&](gfx::CommandBuffer *cmdBuff) {
+            batchedQueue.recordCommandBuffer(device, scene.getRenderPass(), cmdBuff);
+            return static_cast<uint>(passes.size());
+        });
+    batchedQueue.clear();
+
+    UIPhase uiPhase;
+    measureRecording(benchmark, device, scene, "UIPhase::render", nullptr, [&](gfx::CommandBuffer *cmdBuff) {
+        uiPhase.render(scene.getUICamera(), scene.getRenderPass(), cmdBuff);
+        return scene.getInfo().uiBatchCount;
+    });
+
+    for (const auto pass : passes) {
+        InstancedBuffer::get(pass)->destroy();
+        BatchedBuffer::get(pass)->destroy();
+    }
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 1;
+
+    // the shared memory pools are backed by script array buffers
+    auto *engine = se::ScriptEngine::getInstance();
+    if (!engine->start()) {
+        fprintf(stderr, "Script engine could not be started\n");
+        return 1;
+    }
+    int exitCode = 0;
+    {
+        se::AutoHandleScope handleScope;
+
+        auto *device = options.device == "none" ? nullptr : createBenchmarkDevice(options.device, BenchmarkScene::FRAMEBUFFER_WIDTH, BenchmarkScene::FRAMEBUFFER_HEIGHT);
+        if (options.device != "none" && !device) exitCode = 1;
+
+        auto *pipeline = CC_NEW(ForwardPipeline);
+        pipeline->initialize({});
+
+        BenchmarkScene scene;
+        if (!exitCode && !scene.initialize(options.scene, device)) {
+            fprintf(stderr, "Benchmark scene could not be created\n");
+            exitCode = 1;
+        }
+
+        if (!exitCode) {
+            pipeline->setShadows(scene.getShadows());
+            pipeline->setSkybox(scene.getSkybox());
+
+            Benchmark benchmark(options, scene);
+            runCPUBenchmarks(benchmark, pipeline, scene);
+            runMathBenchmarks(benchmark);
+            runStringBenchmarks(benchmark);
+            if (device) runDeviceBenchmarks(benchmark, device, pipeline, scene);
+
+            const auto json = toJSON(options, device ? options.device.c_str() : "none", benchmark.getResults());
+            if (!writeBenchmarkResults(json, options.output)) exitCode = 1;
+        }
+
+        scene.destroy();
+        pipeline->destroy();
+        CC_DELETE(pipeline);
+        destroyBenchmarkDevice(device);
+    }
+    se::ScriptEngine::destroyInstance();
+    return exitCode;
+}
@@ -0,0 +1,47 @@
+#include "DeferredFlow.h"
+#include "../forward/ForwardPipeline.h"
+#include "../forward/SceneCulling.h"
+#include "DeferredStage.h"
+
+namespace cc {
+namespace pipeline {
+RenderFlowInfo DeferredFlow::_initInfo = {
+    "DeferredFlow",
+    static_cast<uint>(DeferredFlowPriority::DEFERRED),
+    static_cast<uint>(RenderFlowTag::SCENE),
+    {},
+};
+const RenderFlowInfo &DeferredFlow::getInitializeInfo() { return DeferredFlow::_initInfo; }
+
+DeferredFlow::~DeferredFlow() {
+}
+
+bool DeferredFlow::initialize(const RenderFlowInfo &info) {
+    RenderFlow::initialize(info);
+
+    if (_stages.size() == 0) {
+        auto deferredStage = CC_NEW(DeferredStage);
+        deferredStage->initialize(DeferredStage::getInitializeInfo());
+        _stages.emplace_back(deferredStage);
+    }
+
+    return true;
+}
+
+void DeferredFlow::activate(RenderPipeline *pipeline) {
+    RenderFlow::activate(pipeline);
+}
+
+void DeferredFlow::render(Camera *camera) {
+    auto pipeline = static_cast<ForwardPipeline *>(_pipeline);
+    sceneCulling(pipeline, camera);
+    pipeline->updateCameraUBO(camera);
+    RenderFlow::render(camera);
+}
+
+void DeferredFlow::destroy() {
+    RenderFlow::destroy();
+}
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "../RenderFlow.h"
+
+namespace cc {
+namespace pipeline {
+
+struct Camera;
+
+class CC_DLL DeferredFlow : public RenderFlow {
+public:
+    static const RenderFlowInfo &getInitializeInfo();
+
+    DeferredFlow() = default;
+    virtual ~DeferredFlow();
+
+    virtual bool initialize(const RenderFlowInfo &info) override;
+    virtual void activate(RenderPipeline *pipeline) override;
+    virtual void destroy() override;
+    virtual void render(Camera *camera) override;
+
+private:
+    static RenderFlowInfo _initInfo;
+};
+
+} // namespace pipeline
+} // namespace cc
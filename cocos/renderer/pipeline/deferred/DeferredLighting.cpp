@@ -0,0 +1,415 @@
+#include "DeferredLighting.h"
+#include "../RenderPipeline.h"
+#include "gfx/GFXBuffer.h"
+#include "gfx/GFXCommandBuffer.h"
+#include "gfx/GFXDescriptorSet.h"
+#include "gfx/GFXDescriptorSetLayout.h"
+#include "gfx/GFXDevice.h"
+#include "gfx/GFXFramebuffer.h"
+#include "gfx/GFXInputAssembler.h"
+#include "gfx/GFXPipelineLayout.h"
+#include "gfx/GFXPipelineState.h"
+#include "gfx/GFXRenderPass.h"
+#include "gfx/GFXSampler.h"
+#include "gfx/GFXShader.h"
+#include "gfx/GFXTexture.h"
+
+namespace cc {
+namespace pipeline {
+namespace {
+// A single triangle covers the screen, its clip space position is the NDC the geometry was drawn at.
+const char *LIGHTING_VERT_GLSL4 = R"(
+precision highp float;
+layout(location = 0) in vec2 a_position;
+layout(location = 0) out vec2 v_ndc;
+void main () {
+    v_ndc = a_position;
+    gl_Position = vec4(a_position, 0.0, 1.0);
+}
+)";
+const char *LIGHTING_VERT_GLSL3 = R"(
+precision highp float;
+in vec2 a_position;
+out vec2 v_ndc;
+void main () {
+    v_ndc = a_position;
+    gl_Position = vec4(a_position, 0.0, 1.0);
+}
+)";
+
+const char *LIGHTING_BLOCKS = R"(
+uniform CCCamera {
+    mat4 cc_matView; mat4 cc_matViewInv; mat4 cc_matProj; mat4 cc_matProjInv; mat4 cc_matViewProj; mat4 cc_matViewProjInv;
+    vec4 cc_cameraPos; vec4 cc_screenScale; vec4 cc_exposure; vec4 cc_mainLitDir; vec4 cc_mainLitColor;
+    vec4 cc_ambientSky; vec4 cc_ambientGround; vec4 cc_fogColor; vec4 cc_fogBase; vec4 cc_fogAdd;
+};
+CLUSTER_LIGHTS_LAYOUT uniform CCClusterLights {
+    vec4 cc_clusterInfo; vec4 cc_clusterDepth;
+    vec4 cc_clusterLightPos[MAX_LIGHTS]; vec4 cc_clusterLightColor[MAX_LIGHTS];
+    vec4 cc_clusterLightSizeRangeAngle[MAX_LIGHTS]; vec4 cc_clusterLightDir[MAX_LIGHTS];
+};
+CLUSTER_GRID_LAYOUT uniform CCClusterGrid {
+    uvec4 cc_clusters[CLUSTER_COUNT / 4]; uvec4 cc_clusterLightIndices[MAX_LIGHT_INDICES / 16];
+};
+)";
+
+// Normalized Blinn-Phong on a metallic workflow, the lights are scaled by the exposure already.
+const char *LIGHTING_FRAG_BODY = R"(
+vec3 shade (vec3 N, vec3 V, vec3 L, vec3 radiance, vec3 diffuse, vec3 specular, float roughness) {
+    float NL = max(dot(N, L), 0.0);
+    float NH = max(dot(N, normalize(L + V)), 0.0);
+    float a = max(roughness * roughness, 0.03);
+    float shininess = 2.0 / (a * a) - 2.0;
+    return (diffuse + specular * pow(NH, shininess) * (shininess + 8.0) * 0.125) * radiance * NL;
+}
+
+void main () {
+    float depth = fetchDepth();
+    // nothing was drawn, the clear color or the sky drawn after shows through
+    if (depth >= 1.0) discard;
+
+    vec4 albedo = fetchAlbedo();
+    vec4 normalRoughness = fetchNormal();
+    vec4 emissiveMetallic = fetchEmissive();
+
+    vec4 viewPos = cc_matProjInv * vec4(v_ndc, depth * CLIP_Z_SCALE + CLIP_Z_BIAS, 1.0);
+    viewPos /= viewPos.w;
+    vec3 worldPos = (cc_matViewInv * viewPos).xyz;
+    vec3 N = normalize(normalRoughness.xyz * 2.0 - 1.0);
+    vec3 V = normalize(cc_cameraPos.xyz - worldPos);
+    float roughness = normalRoughness.w;
+    float metallic = emissiveMetallic.w;
+    vec3 diffuse = albedo.rgb * (1.0 - metallic);
+    vec3 specular = mix(vec3(0.04), albedo.rgb, metallic);
+
+    vec3 color = shade(N, V, -cc_mainLitDir.xyz, cc_mainLitColor.rgb * cc_mainLitColor.w, diffuse, specular, roughness);
+    color += mix(cc_ambientGround.rgb, cc_ambientSky.rgb, N.y * 0.5 + 0.5) * cc_ambientSky.w * diffuse * albedo.a;
+    color += emissiveMetallic.rgb;
+
+    vec2 tile = clamp(floor((v_ndc * 0.5 + 0.5) * cc_clusterInfo.xy), vec2(0.0), cc_clusterInfo.xy - 1.0);
+    float slice = clamp(floor(log(-viewPos.z) * cc_clusterDepth.x + cc_clusterDepth.y), 0.0, cc_clusterInfo.z - 1.0);
+    uint cluster = uint((slice * cc_clusterInfo.y + tile.y) * cc_clusterInfo.x + tile.x);
+    uint range = cc_clusters[cluster / 4u][cluster % 4u];
+    uint first = range & 0xffffu;
+    uint last = first + (range >> 16u);
+    for (uint i = first; i < last; ++i) {
+        uint light = (cc_clusterLightIndices[i / 16u][(i / 4u) % 4u] >> ((i % 4u) * 8u)) & 0xffu;
+        vec4 position = cc_clusterLightPos[light];
+        vec4 sizeRangeAngle = cc_clusterLightSizeRangeAngle[light];
+        vec3 toLight = position.xyz - worldPos;
+        float distance = length(toLight);
+        vec3 L = toLight / max(distance, 0.0001);
+        float falloff = clamp(1.0 - pow(distance / sizeRangeAngle.y, 4.0), 0.0, 1.0);
+        float attenuation = falloff * falloff / max(distance * distance, sizeRangeAngle.x * sizeRangeAngle.x);
+        // the angle is the cosine of the half cone
+        if (position.w > 0.5) attenuation *= smoothstep(sizeRangeAngle.z, mix(sizeRangeAngle.z, 1.0, 0.2), dot(-cc_clusterLightDir[light].xyz, L));
+        vec4 lightColor = cc_clusterLightColor[light];
+        color += shade(N, V, L, lightColor.rgb * lightColor.w * attenuation, diffuse, specular, roughness);
+    }
+
+    if (cc_exposure.z < 0.5) color = sqrt(clamp(color, 0.0, 1.0));
+    OUTPUT(vec4(color, 1.0), depth);
+}
+)";
+
+// subpass inputs, the lighting draws into the window in the subpass after the geometry
+const char *LIGHTING_INPUTS_SUBPASS = R"(
+layout(input_attachment_index = 0, set = LIGHTING_SET, binding = 0) uniform subpassInput u_gbufferAlbedo;
+layout(input_attachment_index = 1, set = LIGHTING_SET, binding = 1) uniform subpassInput u_gbufferNormal;
+layout(input_attachment_index = 2, set = LIGHTING_SET, binding = 2) uniform subpassInput u_gbufferEmissive;
+layout(input_attachment_index = 3, set = LIGHTING_SET, binding = 3) uniform subpassInput u_gbufferDepth;
+layout(location = 0) in vec2 v_ndc;
+layout(location = 0) out vec4 o_color;
+vec4 fetchAlbedo () { return subpassLoad(u_gbufferAlbedo); }
+vec4 fetchNormal () { return subpassLoad(u_gbufferNormal); }
+vec4 fetchEmissive () { return subpassLoad(u_gbufferEmissive); }
+float fetchDepth () { return subpassLoad(u_gbufferDepth).r; }
+#define OUTPUT(color, depth) o_color = color
+)";
+// sampled textures, the window takes over the depth of the geometry
+const char *LIGHTING_INPUTS_SAMPLED_GLSL4 = R"(
+layout(set = LIGHTING_SET, binding = 0) uniform sampler2D u_gbufferAlbedo;
+layout(set = LIGHTING_SET, binding = 1) uniform sampler2D u_gbufferNormal;
+layout(set = LIGHTING_SET, binding = 2) uniform sampler2D u_gbufferEmissive;
+layout(set = LIGHTING_SET, binding = 3) uniform sampler2D u_gbufferDepth;
+layout(location = 0) in vec2 v_ndc;
+layout(location = 0) out vec4 o_color;
+)";
+const char *LIGHTING_INPUTS_SAMPLED_GLSL3 = R"(
+uniform sampler2D u_gbufferAlbedo;
+uniform sampler2D u_gbufferNormal;
+uniform sampler2D u_gbufferEmissive;
+uniform sampler2D u_gbufferDepth;
+in vec2 v_ndc;
+out vec4 o_color;
+)";
+const char *LIGHTING_FETCH_SAMPLED = R"(
+vec4 fetchAlbedo () { return texelFetch(u_gbufferAlbedo, ivec2(gl_FragCoord.xy), 0); }
+vec4 fetchNormal () { return texelFetch(u_gbufferNormal, ivec2(gl_FragCoord.xy), 0); }
+vec4 fetchEmissive () { return texelFetch(u_gbufferEmissive, ivec2(gl_FragCoord.xy), 0); }
+float fetchDepth () { return texelFetch(u_gbufferDepth, ivec2(gl_FragCoord.xy), 0).r; }
+#define OUTPUT(color, depth) o_color = color; gl_FragDepth = depth
+)";
+
+constexpr uint DEPTH_BINDING = DeferredLighting::GBUFFER_COUNT;
+
+String getDefine(const char *name, const String &value) {
+    return String("#define ") + name + " " + value + "\n";
+}
+String getLayout(uint binding) {
+    return "layout(set = " + std::to_string(GLOBAL_SET) + ", binding = " + std::to_string(binding) + ")";
+}
+} // namespace
+
+bool DeferredLighting::initialize(RenderPipeline *pipeline) {
+    _pipeline = pipeline;
+    _device = gfx::Device::getInstance();
+    _isSubpassLighting = _device->hasFeature(gfx::Feature::SUBPASS_INPUT);
+
+    if (!createLightingResources()) {
+        destroy();
+        return false;
+    }
+    return true;
+}
+
+bool DeferredLighting::createLightingResources() {
+    float vertices[] = {-1.0f, -1.0f, 3.0f, -1.0f, -1.0f, 3.0f};
+    _vertexBuffer = _device->createBuffer({
+        gfx::BufferUsageBit::VERTEX | gfx::BufferUsageBit::TRANSFER_DST,
+        gfx::MemoryUsageBit::HOST | gfx::MemoryUsageBit::DEVICE,
+        sizeof(vertices),
+        2 * sizeof(float),
+    });
+    if (!_vertexBuffer) return false;
+    _vertexBuffer->update(vertices, 0, sizeof(vertices));
+
+    gfx::AttributeList attributes = {{"a_position", gfx::Format::RG32F}};
+    _inputAssembler = _device->createInputAssembler({attributes, {_vertexBuffer}});
+
+    // gbuffer texels are fetched, never filtered
+    gfx::SamplerInfo samplerInfo;
+    samplerInfo.minFilter = gfx::Filter::POINT;
+    samplerInfo.magFilter = gfx::Filter::POINT;
+    samplerInfo.mipFilter = gfx::Filter::NONE;
+    samplerInfo.addressU = gfx::Address::CLAMP;
+    samplerInfo.addressV = gfx::Address::CLAMP;
+    samplerInfo.addressW = gfx::Address::CLAMP;
+    _sampler = _device->createSampler(samplerInfo);
+
+    const bool isGLSL3 = _device->getGfxAPI() == gfx::API::GLES3;
+    const float minZ = _device->getClipSpaceMinZ();
+    String defines = getDefine("LIGHTING_SET", std::to_string(MATERIAL_SET)) +
+                     getDefine("MAX_LIGHTS", std::to_string(UBOClusterLights::MAX_LIGHTS)) +
+                     getDefine("CLUSTER_COUNT", std::to_string(UBOClusterGrid::CLUSTER_COUNT)) +
+                     getDefine("MAX_LIGHT_INDICES", std::to_string(UBOClusterGrid::MAX_LIGHT_INDICES)) +
+                     getDefine("CLIP_Z_SCALE", std::to_string(1.0f - minZ)) +
+                     getDefine("CLIP_Z_BIAS", std::to_string(minZ)) +
+                     (isGLSL3 ? getDefine("CLUSTER_LIGHTS_LAYOUT", "layout(std140)") + getDefine("CLUSTER_GRID_LAYOUT", "layout(std140)")
+                              : getDefine("CLUSTER_LIGHTS_LAYOUT", getLayout(UBOClusterLights::BINDING)) + getDefine("CLUSTER_GRID_LAYOUT", getLayout(UBOClusterGrid::BINDING)));
+    String fragSource = "precision highp float;\n" + defines + (isGLSL3 ? "layout(std140)" : getLayout(UBOCamera::BINDING)) + LIGHTING_BLOCKS;
+    if (_isSubpassLighting) {
+        fragSource += LIGHTING_INPUTS_SUBPASS;
+    } else {
+        fragSource += isGLSL3 ? LIGHTING_INPUTS_SAMPLED_GLSL3 : LIGHTING_INPUTS_SAMPLED_GLSL4;
+        fragSource += LIGHTING_FETCH_SAMPLED;
+    }
+    fragSource += LIGHTING_FRAG_BODY;
+
+    gfx::ShaderInfo shaderInfo;
+    shaderInfo.name = _isSubpassLighting ? "deferred-lighting-subpass" : "deferred-lighting";
+    shaderInfo.attributes = attributes;
+    shaderInfo.stages = {{gfx::ShaderStageFlagBit::VERTEX, isGLSL3 ? LIGHTING_VERT_GLSL3 : LIGHTING_VERT_GLSL4}, {gfx::ShaderStageFlagBit::FRAGMENT, fragSource}};
+    shaderInfo.blocks = {UBOCamera::LAYOUT, UBOClusterLights::LAYOUT, UBOClusterGrid::LAYOUT};
+    // there is no type for subpass inputs, the descriptor set layout tells them apart
+    const auto samplerType = gfx::Type::SAMPLER2D;
+    shaderInfo.samplers = {
+        {MATERIAL_SET, 0, "u_gbufferAlbedo", samplerType, 1},
+        {MATERIAL_SET, 1, "u_gbufferNormal", samplerType, 1},
+        {MATERIAL_SET, 2, "u_gbufferEmissive", samplerType, 1},
+        {MATERIAL_SET, DEPTH_BINDING, "u_gbufferDepth", samplerType, 1},
+    };
+    _shader = _device->createShader(shaderInfo);
+
+    const auto descriptorType = _isSubpassLighting ? gfx::DescriptorType::INPUT_ATTACHMENT : gfx::DescriptorType::SAMPLER;
+    gfx::DescriptorSetLayoutInfo layoutInfo;
+    for (uint i = 0; i <= DEPTH_BINDING; ++i) {
+        layoutInfo.bindings.push_back({i, descriptorType, 1, gfx::ShaderStageFlagBit::FRAGMENT});
+    }
+    _descriptorSetLayout = _device->createDescriptorSetLayout(layoutInfo);
+    if (!_inputAssembler || !_sampler || !_shader || !_descriptorSetLayout) return false;
+
+    // the sets in between are never used by the lighting
+    gfx::DescriptorSetLayoutList setLayouts(MATERIAL_SET + 1, _pipeline->getDescriptorSetLayout());
+    setLayouts[MATERIAL_SET] = _descriptorSetLayout;
+    _descriptorSet = _device->createDescriptorSet({_descriptorSetLayout});
+    _pipelineLayout = _device->createPipelineLayout({setLayouts});
+    if (!_descriptorSet || !_pipelineLayout) return false;
+
+    for (uint i = 0; i <= DEPTH_BINDING; ++i) {
+        _descriptorSet->bindSampler(i, _sampler);
+    }
+    return true;
+}
+
+void DeferredLighting::destroy() {
+    destroyFramebuffer();
+    for (auto &pair : _pipelineStates) {
+        CC_SAFE_DESTROY(pair.second);
+    }
+    _pipelineStates.clear();
+    CC_SAFE_DESTROY(_descriptorSet);
+    CC_SAFE_DESTROY(_pipelineLayout);
+    CC_SAFE_DESTROY(_descriptorSetLayout);
+    CC_SAFE_DESTROY(_shader);
+    CC_SAFE_DESTROY(_sampler);
+    CC_SAFE_DESTROY(_inputAssembler);
+    CC_SAFE_DESTROY(_vertexBuffer);
+    _pipeline = nullptr;
+    _device = nullptr;
+}
+
+void DeferredLighting::destroyFramebuffer() {
+    CC_SAFE_DESTROY(_framebuffer);
+    for (auto &texture : _gbufferTextures) {
+        CC_SAFE_DESTROY(texture);
+    }
+    CC_SAFE_DESTROY(_depthStencilTexture);
+    // the pipeline states of the subpass lighting are tied to the render pass going away
+    if (_isSubpassLighting && _renderPass) {
+        auto iter = _pipelineStates.find(_renderPass);
+        if (iter != _pipelineStates.end()) {
+            CC_SAFE_DESTROY(iter->second);
+            _pipelineStates.erase(iter);
+        }
+    }
+    CC_SAFE_DESTROY(_renderPass);
+    _windowRenderPass = nullptr;
+    _windowFramebuffer = nullptr;
+    _width = _height = 0;
+}
+
+gfx::RenderPass *DeferredLighting::resize(gfx::Framebuffer *windowFramebuffer, gfx::RenderPass *windowRenderPass, uint width, uint height) {
+    width = std::max(width, 1u);
+    height = std::max(height, 1u);
+    if (_framebuffer && width == _width && height == _height && windowRenderPass == _windowRenderPass && windowFramebuffer == _windowFramebuffer) {
+        return _renderPass;
+    }
+    destroyFramebuffer();
+
+    const gfx::TextureUsage gbufferUsage = _isSubpassLighting ? gfx::TextureUsageBit::INPUT_ATTACHMENT | gfx::TextureUsageBit::TRANSIENT_ATTACHMENT
+                                                              : gfx::TextureUsageBit::SAMPLED;
+    const gfx::StoreOp gbufferStoreOp = _isSubpassLighting ? gfx::StoreOp::DISCARD : gfx::StoreOp::STORE;
+    const gfx::TextureLayout gbufferEndLayout = _isSubpassLighting ? gfx::TextureLayout::COLOR_ATTACHMENT_OPTIMAL : gfx::TextureLayout::SHADER_READONLY_OPTIMAL;
+
+    gfx::RenderPassInfo renderPassInfo;
+    gfx::TextureList colorTextures;
+    if (_isSubpassLighting) {
+        renderPassInfo.colorAttachments.push_back(windowRenderPass->getColorAttachments()[0]);
+        colorTextures.push_back(windowFramebuffer->getColorTextures()[0]);
+    }
+    for (auto &texture : _gbufferTextures) {
+        renderPassInfo.colorAttachments.push_back({
+            gfx::Format::RGBA8,
+            1,
+            gfx::LoadOp::CLEAR,
+            gbufferStoreOp,
+            gfx::TextureLayout::UNDEFINED,
+            gbufferEndLayout,
+        });
+        texture = _device->createTexture({
+            gfx::TextureType::TEX2D,
+            gfx::TextureUsageBit::COLOR_ATTACHMENT | gbufferUsage,
+            gfx::Format::RGBA8,
+            width,
+            height,
+        });
+        colorTextures.push_back(texture);
+    }
+    renderPassInfo.depthStencilAttachment = {
+        _device->getDepthStencilFormat(),
+        1,
+        gfx::LoadOp::CLEAR,
+        gbufferStoreOp,
+        gfx::LoadOp::CLEAR,
+        gfx::StoreOp::DISCARD,
+        gfx::TextureLayout::UNDEFINED,
+        _isSubpassLighting ? gfx::TextureLayout::DEPTH_STENCIL_ATTACHMENT_OPTIMAL : gfx::TextureLayout::DEPTH_STENCIL_READONLY_OPTIMAL,
+    };
+    _depthStencilTexture = _device->createTexture({
+        gfx::TextureType::TEX2D,
+        gfx::TextureUsageBit::DEPTH_STENCIL_ATTACHMENT | gbufferUsage,
+        _device->getDepthStencilFormat(),
+        width,
+        height,
+    });
+
+    if (_isSubpassLighting) {
+        const auto depthStencil = static_cast<uint8_t>(renderPassInfo.colorAttachments.size());
+        gfx::SubPassInfo geometry;
+        gfx::SubPassInfo lighting;
+        for (uint8_t i = 1; i <= GBUFFER_COUNT; ++i) {
+            geometry.colors.push_back(i);
+            lighting.inputs.push_back(i);
+        }
+        geometry.depthStencil = depthStencil;
+        lighting.inputs.push_back(depthStencil);
+        lighting.colors.push_back(0);
+        lighting.depthStencil = depthStencil;
+        renderPassInfo.subPasses = {geometry, lighting};
+    }
+
+    _renderPass = _device->createRenderPass(renderPassInfo);
+    _framebuffer = _device->createFramebuffer({
+        _renderPass,
+        colorTextures,
+        _depthStencilTexture,
+        {}, //colorMipmapLevels
+    });
+    _clearColors.assign(renderPassInfo.colorAttachments.size(), gfx::Color());
+    _windowRenderPass = windowRenderPass;
+    _windowFramebuffer = windowFramebuffer;
+    _width = width;
+    _height = height;
+
+    for (uint i = 0; i < GBUFFER_COUNT; ++i) {
+        _descriptorSet->bindTexture(i, _gbufferTextures[i]);
+    }
+    _descriptorSet->bindTexture(DEPTH_BINDING, _depthStencilTexture);
+    _descriptorSet->update();
+    return _renderPass;
+}
+
+void DeferredLighting::recordLighting(gfx::RenderPass *renderPass, uint subpass, gfx::CommandBuffer *cmdBuff) {
+    if (!_framebuffer) return;
+
+    auto *pso = getOrCreatePipelineState(renderPass, subpass);
+    if (!pso) return;
+    cmdBuff->bindPipelineState(pso);
+    cmdBuff->bindDescriptorSet(MATERIAL_SET, _descriptorSet);
+    cmdBuff->bindInputAssembler(_inputAssembler);
+    cmdBuff->draw(_inputAssembler);
+}
+
+gfx::PipelineState *DeferredLighting::getOrCreatePipelineState(gfx::RenderPass *renderPass, uint subpass) {
+    auto &pso = _pipelineStates[renderPass];
+    if (pso) return pso;
+
+    gfx::PipelineStateInfo info;
+    info.shader = _shader;
+    info.pipelineLayout = _pipelineLayout;
+    info.renderPass = renderPass;
+    info.subpass = subpass;
+    info.inputState = {_inputAssembler->getAttributes()};
+    info.rasterizerState.cullMode = gfx::CullMode::NONE;
+    // the sampled lighting hands the depth of the geometry over to the window
+    info.depthStencilState.depthTest = !_isSubpassLighting;
+    info.depthStencilState.depthFunc = gfx::ComparisonFunc::ALWAYS;
+    info.depthStencilState.depthWrite = !_isSubpassLighting;
+    info.blendState.targets.assign(1, gfx::BlendTarget());
+    pso = _device->createPipelineState(info);
+    return pso;
+}
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "../Define.h"
+
+namespace cc {
+
+namespace gfx {
+class Buffer;
+class CommandBuffer;
+class DescriptorSet;
+class DescriptorSetLayout;
+class Framebuffer;
+class InputAssembler;
+class PipelineLayout;
+class PipelineState;
+class RenderPass;
+class Sampler;
+class Shader;
+class Texture;
+} // namespace gfx
+
+namespace pipeline {
+class RenderPipeline;
+
+// Geometry buffer of a camera and the fullscreen pass lighting it from the main light, the ambient and the lights
+// binned by ClusterLightCulling, so that a light costs per lit pixel instead of per object it touches.
+//
+// With Feature::SUBPASS_INPUT both make a single render pass into the window: the first subpass fills the gbuffer,
+// the second one reads it back as input attachments and goes on with the forward draws. The gbuffer and its depth
+// are transient and never leave tile memory, the draws of the second subpass test against the depth of the first
+// one but can't write it. Elsewhere the gbuffer is a render pass of its own whose textures the lighting samples,
+// drawn first in the render pass of the window, where it writes the depth of the geometry along with the color.
+//
+// The geometry phase writes linear colors into three RGBA8 targets:
+//     0: albedo, ambient occlusion
+//     1: world normal * 0.5 + 0.5, roughness
+//     2: emissive, metallic
+class CC_DLL DeferredLighting : public Object {
+public:
+    static constexpr uint GBUFFER_COUNT = 3;
+
+    bool initialize(RenderPipeline *pipeline);
+    void destroy();
+
+    // Recreates the targets when the size or the render pass of the window changed. Returns the render pass the
+    // geometry is drawn with, the one lighting it too when isSubpassLighting().
+    gfx::RenderPass *resize(gfx::Framebuffer *windowFramebuffer, gfx::RenderPass *windowRenderPass, uint width, uint height);
+    // Draws the lighting in the subpass, binds its own descriptor set at MATERIAL_SET.
+    void recordLighting(gfx::RenderPass *renderPass, uint subpass, gfx::CommandBuffer *cmdBuff);
+
+    CC_INLINE bool isSubpassLighting() const { return _isSubpassLighting; }
+    CC_INLINE gfx::RenderPass *getRenderPass() const { return _renderPass; }
+    CC_INLINE gfx::Framebuffer *getFramebuffer() const { return _framebuffer; }
+    // clear colors of the attachments of getRenderPass(), the window one first when isSubpassLighting()
+    CC_INLINE gfx::ColorList &getClearColors() { return _clearColors; }
+
+private:
+    bool createLightingResources();
+    void destroyFramebuffer();
+    gfx::PipelineState *getOrCreatePipelineState(gfx::RenderPass *renderPass, uint subpass);
+
+    RenderPipeline *_pipeline = nullptr;
+    gfx::Device *_device = nullptr;
+    bool _isSubpassLighting = false;
+
+    gfx::RenderPass *_renderPass = nullptr;
+    gfx::RenderPass *_windowRenderPass = nullptr;
+    gfx::Framebuffer *_windowFramebuffer = nullptr;
+    gfx::Framebuffer *_framebuffer = nullptr;
+    gfx::Texture *_gbufferTextures[GBUFFER_COUNT] = {};
+    gfx::Texture *_depthStencilTexture = nullptr;
+    gfx::ColorList _clearColors;
+    uint _width = 0;
+    uint _height = 0;
+
+    gfx::Buffer *_vertexBuffer = nullptr;
+    gfx::InputAssembler *_inputAssembler = nullptr;
+    gfx::Sampler *_sampler = nullptr;
+    gfx::Shader *_shader = nullptr;
+    gfx::DescriptorSetLayout *_descriptorSetLayout = nullptr;
+    gfx::DescriptorSet *_descriptorSet = nullptr;
+    gfx::PipelineLayout *_pipelineLayout = nullptr;
+    std::unordered_map<gfx::RenderPass *, gfx::PipelineState *> _pipelineStates;
+};
+
+} // namespace pipeline
+} // namespace cc
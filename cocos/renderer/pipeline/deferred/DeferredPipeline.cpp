@@ -0,0 +1,39 @@
+#include "DeferredPipeline.h"
+#include "../forward/ForwardFlow.h"
+#include "../shadow/ShadowFlow.h"
+#include "DeferredFlow.h"
+#include "gfx/GFXDevice.h"
+
+namespace cc {
+namespace pipeline {
+
+bool DeferredPipeline::initialize(const RenderPipelineInfo &info) {
+    if (info.flows.size()) return ForwardPipeline::initialize(info);
+
+    RenderPipelineInfo deferredInfo = info;
+    auto shadowFlow = CC_NEW(ShadowFlow);
+    shadowFlow->initialize(ShadowFlow::getInitializeInfo());
+    deferredInfo.flows.emplace_back(shadowFlow);
+
+    if (gfx::Device::getInstance()->hasFeature(gfx::Feature::MULTIPLE_RENDER_TARGETS)) {
+        auto deferredFlow = CC_NEW(DeferredFlow);
+        deferredFlow->initialize(DeferredFlow::getInitializeInfo());
+        deferredInfo.flows.emplace_back(deferredFlow);
+    } else {
+        CC_LOG_WARNING("DeferredPipeline: no multiple render targets on this device, falling back to forward shading.");
+        auto forwardFlow = CC_NEW(ForwardFlow);
+        forwardFlow->initialize(ForwardFlow::getInitializeInfo());
+        deferredInfo.flows.emplace_back(forwardFlow);
+    }
+    return ForwardPipeline::initialize(deferredInfo);
+}
+
+bool DeferredPipeline::activate() {
+    if (!ForwardPipeline::activate()) return false;
+    // the forward passes drawn after the lighting read the same clusters
+    setClusteredLighting(true);
+    return true;
+}
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "../forward/ForwardPipeline.h"
+
+namespace cc {
+namespace pipeline {
+
+// The forward pipeline with the opaque passes of the "deferred" phase shaded from a gbuffer, see DeferredLighting.
+// The lights are always clustered, devices without Feature::MULTIPLE_RENDER_TARGETS keep the forward flow.
+class CC_DLL DeferredPipeline : public ForwardPipeline {
+public:
+    DeferredPipeline() = default;
+    ~DeferredPipeline() = default;
+
+    virtual bool initialize(const RenderPipelineInfo &info) override;
+    virtual bool activate() override;
+};
+
+} // namespace pipeline
+} // namespace cc
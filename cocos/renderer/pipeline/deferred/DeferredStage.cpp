@@ -0,0 +1,229 @@
+#include "DeferredStage.h"
+#include "../BatchedBuffer.h"
+#include "../InstancedBuffer.h"
+#include "../PlanarShadowQueue.h"
+#include "../RenderBatchedQueue.h"
+#include "../RenderInstancedQueue.h"
+#include "../RenderQueue.h"
+#include "../forward/ClusterLightCulling.h"
+#include "../forward/ForwardPipeline.h"
+#include "../forward/UIPhase.h"
+#include "../helper/SharedMemory.h"
+#include "DeferredLighting.h"
+#include "base/Profiler.h"
+#include "gfx/GFXCommandBuffer.h"
+#include "gfx/GFXDevice.h"
+#include "gfx/GFXFramebuffer.h"
+#include "gfx/GFXTexture.h"
+
+namespace cc {
+namespace pipeline {
+namespace {
+void SRGBToLinear(gfx::Color &out, const gfx::Color &gamma) {
+    out.x = gamma.x * gamma.x;
+    out.y = gamma.y * gamma.y;
+    out.z = gamma.z * gamma.z;
+}
+} // namespace
+
+RenderStageInfo DeferredStage::_initInfo = {
+    "DeferredStage",
+    static_cast<uint>(DeferredStagePriority::DEFERRED),
+    static_cast<uint>(RenderFlowTag::SCENE),
+    {{false, RenderQueueSortMode::FRONT_TO_BACK, {"deferred"}},
+     {false, RenderQueueSortMode::FRONT_TO_BACK, {"default"}},
+     {true, RenderQueueSortMode::BACK_TO_FRONT, {"default", "planarShadow"}}}};
+const RenderStageInfo &DeferredStage::getInitializeInfo() { return DeferredStage::_initInfo; }
+
+DeferredStage::DeferredStage() : RenderStage() {
+    _geometryBatchedQueue = CC_NEW(RenderBatchedQueue);
+    _geometryInstancedQueue = CC_NEW(RenderInstancedQueue);
+    _batchedQueue = CC_NEW(RenderBatchedQueue);
+    _instancedQueue = CC_NEW(RenderInstancedQueue);
+    _lighting = CC_NEW(DeferredLighting);
+    _uiPhase = CC_NEW(UIPhase);
+}
+
+DeferredStage::~DeferredStage() {
+}
+
+bool DeferredStage::initialize(const RenderStageInfo &info) {
+    RenderStage::initialize(info);
+    _renderQueueDescriptors = info.renderQueues;
+    _geometryPhaseID = getPhaseID("deferred");
+    _phaseID = getPhaseID("default");
+    return true;
+}
+
+void DeferredStage::activate(RenderPipeline *pipeline, RenderFlow *flow) {
+    RenderStage::activate(pipeline, flow);
+    for (const auto &descriptor : _renderQueueDescriptors) {
+        uint phase = 0;
+        for (const auto &stage : descriptor.stages) {
+            phase |= getPhaseID(stage);
+        }
+
+        std::function<int(const RenderPass &, const RenderPass &)> sortFunc = opaqueCompareFn;
+        if (descriptor.sortMode == RenderQueueSortMode::BACK_TO_FRONT) sortFunc = transparentCompareFn;
+
+        RenderQueueCreateInfo info = {descriptor.isTransparent, phase, sortFunc, descriptor.sortMode};
+        _renderQueues.emplace_back(CC_NEW(RenderQueue(std::move(info))));
+    }
+
+    _planarShadowQueue = CC_NEW(PlanarShadowQueue(_pipeline));
+    _uiPhase->activate(pipeline);
+    if (!_lighting->initialize(pipeline)) {
+        CC_LOG_ERROR("DeferredStage: failed to create the lighting pass.");
+    }
+}
+
+void DeferredStage::destroy() {
+    if (_lighting) _lighting->destroy();
+    CC_SAFE_DELETE(_lighting);
+    CC_SAFE_DELETE(_geometryBatchedQueue);
+    CC_SAFE_DELETE(_geometryInstancedQueue);
+    CC_SAFE_DELETE(_batchedQueue);
+    CC_SAFE_DELETE(_instancedQueue);
+    CC_SAFE_DELETE(_clusterLightCulling);
+    CC_SAFE_DELETE(_planarShadowQueue);
+    CC_SAFE_DELETE(_uiPhase);
+    RenderStage::destroy();
+}
+
+void DeferredStage::gatherQueues(Camera *camera) {
+    _geometryInstancedQueue->clear();
+    _geometryBatchedQueue->clear();
+    _instancedQueue->clear();
+    _batchedQueue->clear();
+    auto pipeline = static_cast<ForwardPipeline *>(_pipeline);
+    const auto &renderObjects = pipeline->getRenderObjects();
+
+    for (auto queue : _renderQueues) {
+        queue->clear();
+        queue->setRadixSort(pipeline->isRadixSort());
+    }
+
+    // the static batches are drawn with a single render pass, the passes go through the queues of their phase instead
+    for (const auto &ro : renderObjects) {
+        const auto model = ro.model;
+        const auto subModelID = model->getSubModelID();
+        const auto subModelCount = subModelID[0];
+        for (uint m = 1; m <= subModelCount; ++m) {
+            auto subModel = model->getSubModelView(subModelID[m]);
+            for (uint p = 0; p < subModel->passCount; ++p) {
+                const PassView *pass = subModel->getPassView(p);
+                const bool isGeometry = pass->phase == _geometryPhaseID;
+                if (!isGeometry && pass->phase != _phaseID) continue;
+
+                if (pass->getBatchingScheme() == BatchingSchemes::INSTANCING) {
+                    auto instancedBuffer = InstancedBuffer::get(subModel->passID[p]);
+                    instancedBuffer->merge(model, subModel, p);
+                    (isGeometry ? _geometryInstancedQueue : _instancedQueue)->add(instancedBuffer);
+                } else if (pass->getBatchingScheme() == BatchingSchemes::VB_MERGING) {
+                    auto batchedBuffer = BatchedBuffer::get(subModel->passID[p]);
+                    batchedBuffer->merge(subModel, p, model);
+                    (isGeometry ? _geometryBatchedQueue : _batchedQueue)->add(batchedBuffer);
+                } else {
+                    for (auto queue : _renderQueues) {
+                        queue->insertRenderPass(ro, m, p);
+                    }
+                }
+            }
+        }
+    }
+    for (auto queue : _renderQueues) {
+        queue->sort();
+    }
+}
+
+void DeferredStage::render(Camera *camera) {
+    CC_PROFILE_ZONE("DeferredStage::render");
+    auto pipeline = static_cast<ForwardPipeline *>(_pipeline);
+    gatherQueues(camera);
+
+    auto cmdBuff = pipeline->getCommandBuffers()[0];
+    _geometryInstancedQueue->uploadBuffers(cmdBuff);
+    _geometryBatchedQueue->uploadBuffers(cmdBuff);
+    _instancedQueue->uploadBuffers(cmdBuff);
+    _batchedQueue->uploadBuffers(cmdBuff);
+    // the lighting reads the clusters whether or not the forward passes do
+    if (!_clusterLightCulling) _clusterLightCulling = CC_NEW(ClusterLightCulling(pipeline));
+    _clusterLightCulling->update(camera, cmdBuff);
+    _planarShadowQueue->gatherShadowPasses(camera, cmdBuff);
+
+    // render area is not oriented
+    uint w = camera->getWindow()->hasOnScreenAttachments && (uint)_device->getSurfaceTransform() % 2 ? camera->height : camera->width;
+    uint h = camera->getWindow()->hasOnScreenAttachments && (uint)_device->getSurfaceTransform() % 2 ? camera->width : camera->height;
+    _renderArea.x = camera->viewportX * w;
+    _renderArea.y = camera->viewportY * h;
+    _renderArea.width = camera->viewportWidth * w * pipeline->getShadingScale();
+    _renderArea.height = camera->viewportHeight * h * pipeline->getShadingScale();
+
+    if (static_cast<gfx::ClearFlags>(camera->clearFlag) & gfx::ClearFlagBit::COLOR) {
+        if (pipeline->isHDR()) {
+            SRGBToLinear(_clearColors[0], camera->clearColor);
+            auto scale = pipeline->getFpScale() / camera->exposure;
+            _clearColors[0].x *= scale;
+            _clearColors[0].y *= scale;
+            _clearColors[0].z *= scale;
+        } else {
+            _clearColors[0].x = camera->clearColor.x;
+            _clearColors[0].y = camera->clearColor.y;
+            _clearColors[0].z = camera->clearColor.z;
+        }
+    }
+    _clearColors[0].w = camera->clearColor.w;
+
+    auto framebuffer = camera->getWindow()->getFramebuffer();
+    const auto &colorTextures = framebuffer->getColorTextures();
+    const bool isOffscreen = colorTextures.size() && colorTextures[0];
+    auto renderPass = isOffscreen ? framebuffer->getRenderPass() : pipeline->getOrCreateRenderPass(static_cast<gfx::ClearFlagBit>(camera->clearFlag));
+    const uint width = isOffscreen ? colorTextures[0]->getWidth() : _device->getWidth();
+    const uint height = isOffscreen ? colorTextures[0]->getHeight() : _device->getHeight();
+
+    auto *geometryRenderPass = _lighting->resize(framebuffer, renderPass, width, height);
+    if (!geometryRenderPass) return;
+
+    auto &geometryClearColors = _lighting->getClearColors();
+    if (_lighting->isSubpassLighting()) {
+        geometryClearColors[0] = _clearColors[0];
+        cmdBuff->beginRenderPass(geometryRenderPass, _lighting->getFramebuffer(), _renderArea, geometryClearColors, camera->clearDepth, camera->clearStencil);
+        cmdBuff->bindDescriptorSet(GLOBAL_SET, _pipeline->getDescriptorSet());
+        recordGeometry(geometryRenderPass, cmdBuff);
+        cmdBuff->nextSubpass();
+        _lighting->recordLighting(geometryRenderPass, 1, cmdBuff);
+        cmdBuff->bindDescriptorSet(GLOBAL_SET, _pipeline->getDescriptorSet());
+        recordForward(camera, geometryRenderPass, 1, cmdBuff);
+        cmdBuff->endRenderPass();
+        return;
+    }
+
+    cmdBuff->beginRenderPass(geometryRenderPass, _lighting->getFramebuffer(), _renderArea, geometryClearColors, camera->clearDepth, camera->clearStencil);
+    cmdBuff->bindDescriptorSet(GLOBAL_SET, _pipeline->getDescriptorSet());
+    recordGeometry(geometryRenderPass, cmdBuff);
+    cmdBuff->endRenderPass();
+
+    cmdBuff->beginRenderPass(renderPass, framebuffer, _renderArea, _clearColors, camera->clearDepth, camera->clearStencil);
+    cmdBuff->bindDescriptorSet(GLOBAL_SET, _pipeline->getDescriptorSet());
+    _lighting->recordLighting(renderPass, 0, cmdBuff);
+    recordForward(camera, renderPass, 0, cmdBuff);
+    cmdBuff->endRenderPass();
+}
+
+void DeferredStage::recordGeometry(gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff) {
+    _renderQueues[0]->recordCommandBuffer(_device, renderPass, cmdBuff);
+    _geometryInstancedQueue->recordCommandBuffer(_device, renderPass, cmdBuff);
+    _geometryBatchedQueue->recordCommandBuffer(_device, renderPass, cmdBuff);
+}
+
+void DeferredStage::recordForward(Camera *camera, gfx::RenderPass *renderPass, uint subpass, gfx::CommandBuffer *cmdBuff) {
+    _renderQueues[1]->recordCommandBuffer(_device, renderPass, cmdBuff, nullptr, subpass);
+    _instancedQueue->recordCommandBuffer(_device, renderPass, cmdBuff, subpass);
+    _batchedQueue->recordCommandBuffer(_device, renderPass, cmdBuff, subpass);
+    _planarShadowQueue->recordCommandBuffer(_device, renderPass, cmdBuff, subpass);
+    _renderQueues[2]->recordCommandBuffer(_device, renderPass, cmdBuff, nullptr, subpass);
+    _uiPhase->render(camera, renderPass, cmdBuff, subpass);
+}
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../RenderStage.h"
+
+namespace cc {
+namespace pipeline {
+
+class RenderFlow;
+class RenderBatchedQueue;
+class RenderInstancedQueue;
+class ClusterLightCulling;
+class DeferredLighting;
+class PlanarShadowQueue;
+class UIPhase;
+struct Camera;
+
+// Draws the "deferred" phase of the opaque passes into the gbuffer, lights it with the clustered lights and goes on
+// with the "default" phase, the transparent passes and the UI on top, see DeferredLighting.
+class CC_DLL DeferredStage : public RenderStage {
+public:
+    static const RenderStageInfo &getInitializeInfo();
+
+    DeferredStage();
+    ~DeferredStage();
+
+    virtual bool initialize(const RenderStageInfo &info) override;
+    virtual void activate(RenderPipeline *pipeline, RenderFlow *flow) override;
+    virtual void destroy() override;
+    virtual void render(Camera *camera) override;
+
+private:
+    void gatherQueues(Camera *camera);
+    void recordGeometry(gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff);
+    void recordForward(Camera *camera, gfx::RenderPass *renderPass, uint subpass, gfx::CommandBuffer *cmdBuff);
+
+    static RenderStageInfo _initInfo;
+    PlanarShadowQueue *_planarShadowQueue = nullptr;
+    RenderBatchedQueue *_geometryBatchedQueue = nullptr;
+    RenderInstancedQueue *_geometryInstancedQueue = nullptr;
+    RenderBatchedQueue *_batchedQueue = nullptr;
+    RenderInstancedQueue *_instancedQueue = nullptr;
+    ClusterLightCulling *_clusterLightCulling = nullptr;
+    DeferredLighting *_lighting = nullptr;
+    UIPhase *_uiPhase = nullptr;
+    gfx::Rect _renderArea;
+    uint _geometryPhaseID = 0;
+    uint _phaseID = 0;
+};
+
+} // namespace pipeline
+} // namespace cc
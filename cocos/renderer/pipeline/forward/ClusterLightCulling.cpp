@@ -0,0 +1,293 @@
+#include <condition_variable>
+#include <mutex>
+
+#include "ClusterLightCulling.h"
+#include "ForwardPipeline.h"
+#include "base/ThreadPool.h"
+#include "gfx/GFXBuffer.h"
+#include "gfx/GFXCommandBuffer.h"
+#include "gfx/GFXDescriptorSet.h"
+#include "gfx/GFXDevice.h"
+#include "math/MathUtil.h"
+
+namespace cc {
+namespace pipeline {
+
+ClusterLightCulling::ClusterLightCulling(ForwardPipeline *pipeline)
+: _pipeline(pipeline) {
+    auto *device = gfx::Device::getInstance();
+    _lightsUBO = device->createBuffer({
+        gfx::BufferUsageBit::UNIFORM | gfx::BufferUsageBit::TRANSFER_DST,
+        gfx::MemoryUsageBit::HOST | gfx::MemoryUsageBit::DEVICE,
+        UBOClusterLights::SIZE,
+        UBOClusterLights::SIZE,
+        gfx::BufferFlagBit::NONE,
+    });
+    _gridUBO = device->createBuffer({
+        gfx::BufferUsageBit::UNIFORM | gfx::BufferUsageBit::TRANSFER_DST,
+        gfx::MemoryUsageBit::HOST | gfx::MemoryUsageBit::DEVICE,
+        UBOClusterGrid::SIZE,
+        UBOClusterGrid::SIZE,
+        gfx::BufferFlagBit::NONE,
+    });
+
+    auto *descriptorSet = _pipeline->getDescriptorSet();
+    descriptorSet->bindBuffer(UBOClusterLights::BINDING, _lightsUBO);
+    descriptorSet->bindBuffer(UBOClusterGrid::BINDING, _gridUBO);
+    descriptorSet->update();
+
+    _clusterLights.resize(UBOClusterGrid::CLUSTER_COUNT * UBOClusterLights::MAX_LIGHTS);
+    _clusterLightCounts.fill(0);
+    _lightsUBOData.fill(0.0f);
+    _gridUBOData.fill(0);
+}
+
+ClusterLightCulling::~ClusterLightCulling() {
+    destroy();
+}
+
+void ClusterLightCulling::update(const Camera *camera, gfx::CommandBuffer *cmdBuffer) {
+    collectLights(camera);
+    updateClusterBounds(camera);
+
+    if (_pipeline->getWorkerThreadPool() && _lights.size() >= PARALLEL_LIGHT_COUNT) {
+        binSlicesInParallel();
+    } else {
+        binSlices(0, UBOClusterGrid::GRID_Z);
+    }
+
+    uploadLights(camera, cmdBuffer);
+    uploadGrid(cmdBuffer);
+}
+
+void ClusterLightCulling::collectLights(const Camera *camera) {
+    _lights.clear();
+    _lightSpheres.clear();
+
+    const auto scene = camera->getScene();
+    Sphere sphere;
+    const auto addLight = [&](const Light *light) {
+        sphere.setCenter(light->position);
+        sphere.setRadius(light->range);
+        if (!sphere_frustum(&sphere, camera->getFrustum())) return;
+
+        if (_lights.size() == UBOClusterLights::MAX_LIGHTS) {
+            if (!_isLightOverflowReported) {
+                CC_LOG_WARNING("More than %u lights are visible, the rest is not shaded in clustered lighting mode.", UBOClusterLights::MAX_LIGHTS);
+                _isLightOverflowReported = true;
+            }
+            return;
+        }
+
+        Vec3 center(light->position);
+        camera->matView.transformPoint(&center);
+        _lights.emplace_back(light);
+        _lightSpheres.emplace_back(center.x, center.y, center.z, light->range);
+    };
+
+    const auto sphereLightArrayID = scene->getSphereLightArrayID();
+    auto count = sphereLightArrayID ? sphereLightArrayID[0] : 0;
+    for (uint i = 1; i <= count; i++) {
+        addLight(scene->getSphereLight(sphereLightArrayID[i]));
+    }
+    // spot lights are binned by their bounding spheres as well, the cone is left to the shader
+    const auto spotLightArrayID = scene->getSpotLightArrayID();
+    count = spotLightArrayID ? spotLightArrayID[0] : 0;
+    for (uint i = 1; i <= count; i++) {
+        addLight(scene->getSpotLight(spotLightArrayID[i]));
+    }
+}
+
+void ClusterLightCulling::updateClusterBounds(const Camera *camera) {
+    if (_isBoundsValid && !memcmp(_matProj.m, camera->matProj.m, sizeof(_matProj.m))) return;
+    _matProj = camera->matProj;
+    _isBoundsValid = true;
+
+    const auto &matProjInv = camera->matProjInv;
+    const auto unproject = [&matProjInv](float x, float y, float z) {
+        Vec4 point(x, y, z, 1.0f);
+        matProjInv.transformVector(&point);
+        return Vec3(point.x / point.w, point.y / point.w, point.z / point.w);
+    };
+
+    const float minZ = gfx::Device::getInstance()->getClipSpaceMinZ();
+    const bool isOrtho = camera->matProj.m[15] != 0.0f;
+    const float nearDepth = std::max(-unproject(0.0f, 0.0f, minZ).z, 0.01f);
+    const float farDepth = std::max(-unproject(0.0f, 0.0f, 1.0f).z, nearDepth + 0.01f);
+
+    // exponential slices keep the clusters roughly cubic along the depth
+    for (uint z = 0; z <= UBOClusterGrid::GRID_Z; ++z) {
+        _sliceDepths[z] = nearDepth * std::pow(farDepth / nearDepth, (float)z / UBOClusterGrid::GRID_Z);
+    }
+
+    Vec3 corners[4];
+    for (uint y = 0; y < UBOClusterGrid::GRID_Y; ++y) {
+        const float ndcY0 = -1.0f + 2.0f * y / UBOClusterGrid::GRID_Y;
+        const float ndcY1 = -1.0f + 2.0f * (y + 1) / UBOClusterGrid::GRID_Y;
+        for (uint x = 0; x < UBOClusterGrid::GRID_X; ++x) {
+            const float ndcX0 = -1.0f + 2.0f * x / UBOClusterGrid::GRID_X;
+            const float ndcX1 = -1.0f + 2.0f * (x + 1) / UBOClusterGrid::GRID_X;
+            corners[0] = unproject(ndcX0, ndcY0, minZ);
+            corners[1] = unproject(ndcX1, ndcY0, minZ);
+            corners[2] = unproject(ndcX0, ndcY1, minZ);
+            corners[3] = unproject(ndcX1, ndcY1, minZ);
+
+            for (uint z = 0; z < UBOClusterGrid::GRID_Z; ++z) {
+                Vec3 min(FLT_MAX, FLT_MAX, FLT_MAX);
+                Vec3 max(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+                for (const float depth : {_sliceDepths[z], _sliceDepths[z + 1]}) {
+                    for (const auto &corner : corners) {
+                        // tile corners move along the view rays of a perspective projection
+                        const Vec3 point = isOrtho ? Vec3(corner.x, corner.y, -depth) : corner * (depth / -corner.z);
+                        min.set(std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z));
+                        max.set(std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z));
+                    }
+                }
+
+                const uint cluster = z * SLICE_CLUSTER_COUNT + y * UBOClusterGrid::GRID_X + x;
+                _centerX[cluster] = (min.x + max.x) * 0.5f;
+                _centerY[cluster] = (min.y + max.y) * 0.5f;
+                _centerZ[cluster] = (min.z + max.z) * 0.5f;
+                _extentX[cluster] = (max.x - min.x) * 0.5f;
+                _extentY[cluster] = (max.y - min.y) * 0.5f;
+                _extentZ[cluster] = (max.z - min.z) * 0.5f;
+            }
+        }
+    }
+}
+
+void ClusterLightCulling::binSlices(uint beginSlice, uint endSlice) {
+    uint8_t hits[SLICE_CLUSTER_COUNT];
+    const auto lightCount = static_cast<uint>(_lights.size());
+    for (uint z = beginSlice; z < endSlice; ++z) {
+        const uint base = z * SLICE_CLUSTER_COUNT;
+        std::fill(_clusterLightCounts.begin() + base, _clusterLightCounts.begin() + base + SLICE_CLUSTER_COUNT, 0);
+
+        for (uint l = 0; l < lightCount; ++l) {
+            const auto &sphere = _lightSpheres[l];
+            const float depth = -sphere.z;
+            if (depth + sphere.w < _sliceDepths[z] || depth - sphere.w > _sliceDepths[z + 1]) continue;
+
+            MathUtil::intersectSphereAABBs(sphere.x, sphere.y, sphere.z, sphere.w,
+                                           _centerX.data() + base, _centerY.data() + base, _centerZ.data() + base,
+                                           _extentX.data() + base, _extentY.data() + base, _extentZ.data() + base,
+                                           SLICE_CLUSTER_COUNT, hits);
+            for (uint k = 0; k < SLICE_CLUSTER_COUNT; ++k) {
+                if (!hits[k]) continue;
+                const uint cluster = base + k;
+                _clusterLights[cluster * UBOClusterLights::MAX_LIGHTS + _clusterLightCounts[cluster]++] = static_cast<uint8_t>(l);
+            }
+        }
+    }
+}
+
+void ClusterLightCulling::binSlicesInParallel() {
+    auto threadPool = _pipeline->getWorkerThreadPool();
+    constexpr uint taskCount = (UBOClusterGrid::GRID_Z + SLICES_PER_TASK - 1) / SLICES_PER_TASK;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint pending = taskCount - 1;
+
+    // every task owns its slices, nothing is shared but the read-only bounds and lights
+    for (uint task = 1; task < taskCount; ++task) {
+        const uint begin = task * SLICES_PER_TASK;
+        const uint end = std::min(begin + SLICES_PER_TASK, UBOClusterGrid::GRID_Z);
+        threadPool->pushTask([&, begin, end](int /*threadId*/) {
+            binSlices(begin, end);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pending == 0) cv.notify_one();
+        });
+    }
+
+    // the calling thread takes the first slices instead of idling
+    binSlices(0, std::min(SLICES_PER_TASK, UBOClusterGrid::GRID_Z));
+
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&pending]() { return pending == 0; });
+}
+
+void ClusterLightCulling::uploadLights(const Camera *camera, gfx::CommandBuffer *cmdBuffer) {
+    const auto lightCount = static_cast<uint>(_lights.size());
+    const float depthScale = UBOClusterGrid::GRID_Z / std::log(_sliceDepths[UBOClusterGrid::GRID_Z] / _sliceDepths[0]);
+
+    auto *data = _lightsUBOData.data();
+    data[UBOClusterLights::CLUSTER_INFO_OFFSET] = (float)UBOClusterGrid::GRID_X;
+    data[UBOClusterLights::CLUSTER_INFO_OFFSET + 1] = (float)UBOClusterGrid::GRID_Y;
+    data[UBOClusterLights::CLUSTER_INFO_OFFSET + 2] = (float)UBOClusterGrid::GRID_Z;
+    data[UBOClusterLights::CLUSTER_INFO_OFFSET + 3] = (float)lightCount;
+    data[UBOClusterLights::CLUSTER_DEPTH_OFFSET] = depthScale;
+    data[UBOClusterLights::CLUSTER_DEPTH_OFFSET + 1] = -std::log(_sliceDepths[0]) * depthScale;
+    data[UBOClusterLights::CLUSTER_DEPTH_OFFSET + 2] = _sliceDepths[0];
+    data[UBOClusterLights::CLUSTER_DEPTH_OFFSET + 3] = _sliceDepths[UBOClusterGrid::GRID_Z];
+
+    // same light parameters as the additive light passes
+    const float luminanceScale = (_pipeline->isHDR() ? _pipeline->getFpScale() : camera->exposure) * LIGHT_METER_SCALE;
+    for (uint l = 0; l < lightCount; ++l) {
+        const auto *light = _lights[l];
+        const bool isSpot = light->getType() == LightType::SPOT;
+
+        auto *pos = data + UBOClusterLights::LIGHT_POS_OFFSET + l * 4;
+        pos[0] = light->position.x;
+        pos[1] = light->position.y;
+        pos[2] = light->position.z;
+        pos[3] = isSpot ? 1.0f : 0.0f;
+
+        auto *color = data + UBOClusterLights::LIGHT_COLOR_OFFSET + l * 4;
+        color[0] = light->color.x;
+        color[1] = light->color.y;
+        color[2] = light->color.z;
+        if (light->useColorTemperature) {
+            color[0] *= light->colorTemperatureRGB.x;
+            color[1] *= light->colorTemperatureRGB.y;
+            color[2] *= light->colorTemperatureRGB.z;
+        }
+        color[3] = light->luminance * luminanceScale;
+
+        auto *sizeRangeAngle = data + UBOClusterLights::LIGHT_SIZE_RANGE_ANGLE_OFFSET + l * 4;
+        sizeRangeAngle[0] = light->size;
+        sizeRangeAngle[1] = light->range;
+        sizeRangeAngle[2] = isSpot ? light->spotAngle : 0.0f;
+
+        if (isSpot) {
+            auto *dir = data + UBOClusterLights::LIGHT_DIR_OFFSET + l * 4;
+            dir[0] = light->direction.x;
+            dir[1] = light->direction.y;
+            dir[2] = light->direction.z;
+        }
+    }
+
+    cmdBuffer->updateBuffer(_lightsUBO, _lightsUBOData.data(), UBOClusterLights::SIZE);
+}
+
+void ClusterLightCulling::uploadGrid(gfx::CommandBuffer *cmdBuffer) {
+    auto *lightIndices = reinterpret_cast<uint8_t *>(_gridUBOData.data() + UBOClusterGrid::LIGHT_INDICES_OFFSET);
+    uint offset = 0;
+    for (uint cluster = 0; cluster < UBOClusterGrid::CLUSTER_COUNT; ++cluster) {
+        const uint count = std::min(_clusterLightCounts[cluster], UBOClusterGrid::MAX_LIGHT_INDICES - offset);
+        if (count < _clusterLightCounts[cluster] && !_isIndexOverflowReported) {
+            CC_LOG_WARNING("Clustered light indices exceed %u, lights are dropped from the farther clusters.", UBOClusterGrid::MAX_LIGHT_INDICES);
+            _isIndexOverflowReported = true;
+        }
+
+        _gridUBOData[UBOClusterGrid::CLUSTERS_OFFSET + cluster] = offset | count << 16;
+        memcpy(lightIndices + offset, &_clusterLights[cluster * UBOClusterLights::MAX_LIGHTS], count);
+        offset += count;
+    }
+
+    // only the used part of the light indices is uploaded
+    const uint size = (UBOClusterGrid::LIGHT_INDICES_OFFSET + (offset + 3) / 4) * sizeof(uint);
+    cmdBuffer->updateBuffer(_gridUBO, _gridUBOData.data(), size);
+}
+
+void ClusterLightCulling::destroy() {
+    CC_SAFE_DESTROY(_lightsUBO);
+    CC_SAFE_DESTROY(_gridUBO);
+    _lights.clear();
+    _lightSpheres.clear();
+    _isBoundsValid = false;
+}
+
+} // namespace pipeline
+} // namespace cc
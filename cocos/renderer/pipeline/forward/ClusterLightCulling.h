@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+
+#include "../Define.h"
+#include "../helper/SharedMemory.h"
+#include "math/Mat4.h"
+#include "math/Vec4.h"
+
+namespace cc {
+namespace pipeline {
+class ForwardPipeline;
+
+// Bins the sphere and spot lights visible to a camera into a froxel grid of view space clusters,
+// which is uploaded together with the lights so that the forward pass shades all of them at once
+// instead of drawing an additive pass per light. The clusters of a depth slice are tested against
+// the light bounding spheres with SIMD, the slices are spread over the worker thread pool.
+class CC_DLL ClusterLightCulling : public Object {
+public:
+    ClusterLightCulling(ForwardPipeline *pipeline);
+    ~ClusterLightCulling();
+
+    void update(const Camera *camera, gfx::CommandBuffer *cmdBuffer);
+    void destroy();
+
+private:
+    void collectLights(const Camera *camera);
+    void updateClusterBounds(const Camera *camera);
+    void binSlices(uint beginSlice, uint endSlice);
+    void binSlicesInParallel();
+    void uploadLights(const Camera *camera, gfx::CommandBuffer *cmdBuffer);
+    void uploadGrid(gfx::CommandBuffer *cmdBuffer);
+
+    static constexpr uint SLICE_CLUSTER_COUNT = UBOClusterGrid::GRID_X * UBOClusterGrid::GRID_Y;
+    static constexpr uint SLICES_PER_TASK = 4;
+    // below this many lights the slices are binned on the calling thread only
+    static constexpr uint PARALLEL_LIGHT_COUNT = 16;
+    static constexpr float LIGHT_METER_SCALE = 10000.0f;
+
+    ForwardPipeline *_pipeline = nullptr;
+    gfx::Buffer *_lightsUBO = nullptr;
+    gfx::Buffer *_gridUBO = nullptr;
+
+    vector<const Light *> _lights;
+    // view space bounding spheres of the lights, radius in w
+    vector<Vec4> _lightSpheres;
+
+    // view space bounds of the clusters as structure-of-arrays, slice by slice
+    std::array<float, UBOClusterGrid::CLUSTER_COUNT> _centerX;
+    std::array<float, UBOClusterGrid::CLUSTER_COUNT> _centerY;
+    std::array<float, UBOClusterGrid::CLUSTER_COUNT> _centerZ;
+    std::array<float, UBOClusterGrid::CLUSTER_COUNT> _extentX;
+    std::array<float, UBOClusterGrid::CLUSTER_COUNT> _extentY;
+    std::array<float, UBOClusterGrid::CLUSTER_COUNT> _extentZ;
+    std::array<float, UBOClusterGrid::GRID_Z + 1> _sliceDepths;
+    Mat4 _matProj; // the projection the cluster bounds were built for
+    bool _isBoundsValid = false;
+
+    // light indices of every cluster, UBOClusterLights::MAX_LIGHTS slots per cluster
+    vector<uint8_t> _clusterLights;
+    std::array<uint, UBOClusterGrid::CLUSTER_COUNT> _clusterLightCounts;
+
+    std::array<float, UBOClusterLights::COUNT> _lightsUBOData;
+    std::array<uint, UBOClusterGrid::COUNT> _gridUBOData;
+    bool _isLightOverflowReported = false;
+    bool _isIndexOverflowReported = false;
+};
+
+} // namespace pipeline
+} // namespace cc
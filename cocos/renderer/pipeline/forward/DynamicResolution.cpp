@@ -0,0 +1,310 @@
+#include "DynamicResolution.h"
+#include "gfx/GFXBuffer.h"
+#include "gfx/GFXCommandBuffer.h"
+#include "gfx/GFXDescriptorSet.h"
+#include "gfx/GFXDescriptorSetLayout.h"
+#include "gfx/GFXDevice.h"
+#include "gfx/GFXFramebuffer.h"
+#include "gfx/GFXInputAssembler.h"
+#include "gfx/GFXPipelineLayout.h"
+#include "gfx/GFXPipelineState.h"
+#include "gfx/GFXRenderPass.h"
+#include "gfx/GFXSampler.h"
+#include "gfx/GFXShader.h"
+#include "gfx/GFXTexture.h"
+
+namespace cc {
+namespace pipeline {
+namespace {
+// A single triangle covers the screen. The scene was drawn with the conventions of the window,
+// so sampling the texture at the NDC of the window keeps it upright on every backend.
+// u_uvScale holds the part of the target covered by the scene and the last texel center inside it,
+// u_texelSize the texel size and the sharpness of the unsharp mask.
+const char *UPSCALE_VERT_GLSL4 = R"(
+precision highp float;
+layout(location = 0) in vec2 a_position;
+layout(set = 0, binding = 0) uniform UpscaleParams { vec4 u_uvScale; vec4 u_texelSize; };
+layout(location = 0) out vec2 v_uv;
+void main () {
+    v_uv = (a_position * 0.5 + 0.5) * u_uvScale.xy;
+    gl_Position = vec4(a_position, 0.0, 1.0);
+}
+)";
+const char *UPSCALE_FRAG_GLSL4 = R"(
+precision mediump float;
+layout(set = 0, binding = 0) uniform UpscaleParams { vec4 u_uvScale; vec4 u_texelSize; };
+layout(set = 0, binding = 1) uniform sampler2D u_source;
+layout(location = 0) in vec2 v_uv;
+layout(location = 0) out vec4 o_color;
+vec4 fetch (vec2 uv) { return texture(u_source, min(uv, u_uvScale.zw)); }
+void main () {
+    vec4 color = fetch(v_uv);
+    if (u_texelSize.z > 0.0) {
+        vec4 neighbours = fetch(v_uv + vec2(u_texelSize.x, 0.0)) + fetch(v_uv - vec2(u_texelSize.x, 0.0)) +
+                          fetch(v_uv + vec2(0.0, u_texelSize.y)) + fetch(v_uv - vec2(0.0, u_texelSize.y));
+        color.rgb = max(color.rgb + (color.rgb - neighbours.rgb * 0.25) * u_texelSize.z, vec3(0.0));
+    }
+    o_color = color;
+}
+)";
+const char *UPSCALE_VERT_GLSL3 = R"(
+precision highp float;
+in vec2 a_position;
+layout(std140) uniform UpscaleParams { vec4 u_uvScale; vec4 u_texelSize; };
+out vec2 v_uv;
+void main () {
+    v_uv = (a_position * 0.5 + 0.5) * u_uvScale.xy;
+    gl_Position = vec4(a_position, 0.0, 1.0);
+}
+)";
+const char *UPSCALE_FRAG_GLSL3 = R"(
+precision mediump float;
+layout(std140) uniform UpscaleParams { vec4 u_uvScale; vec4 u_texelSize; };
+uniform sampler2D u_source;
+in vec2 v_uv;
+out vec4 o_color;
+vec4 fetch (vec2 uv) { return texture(u_source, min(uv, u_uvScale.zw)); }
+void main () {
+    vec4 color = fetch(v_uv);
+    if (u_texelSize.z > 0.0) {
+        vec4 neighbours = fetch(v_uv + vec2(u_texelSize.x, 0.0)) + fetch(v_uv - vec2(u_texelSize.x, 0.0)) +
+                          fetch(v_uv + vec2(0.0, u_texelSize.y)) + fetch(v_uv - vec2(0.0, u_texelSize.y));
+        color.rgb = max(color.rgb + (color.rgb - neighbours.rgb * 0.25) * u_texelSize.z, vec3(0.0));
+    }
+    o_color = color;
+}
+)";
+const char *UPSCALE_VERT_GLSL1 = R"(
+precision highp float;
+attribute vec2 a_position;
+uniform vec4 u_uvScale;
+varying vec2 v_uv;
+void main () {
+    v_uv = (a_position * 0.5 + 0.5) * u_uvScale.xy;
+    gl_Position = vec4(a_position, 0.0, 1.0);
+}
+)";
+const char *UPSCALE_FRAG_GLSL1 = R"(
+precision mediump float;
+uniform vec4 u_uvScale;
+uniform vec4 u_texelSize;
+uniform sampler2D u_source;
+varying vec2 v_uv;
+vec4 fetch (vec2 uv) { return texture2D(u_source, min(uv, u_uvScale.zw)); }
+void main () {
+    vec4 color = fetch(v_uv);
+    if (u_texelSize.z > 0.0) {
+        vec4 neighbours = fetch(v_uv + vec2(u_texelSize.x, 0.0)) + fetch(v_uv - vec2(u_texelSize.x, 0.0)) +
+                          fetch(v_uv + vec2(0.0, u_texelSize.y)) + fetch(v_uv - vec2(0.0, u_texelSize.y));
+        color.rgb = max(color.rgb + (color.rgb - neighbours.rgb * 0.25) * u_texelSize.z, vec3(0.0));
+    }
+    gl_FragColor = color;
+}
+)";
+
+constexpr uint UPSCALE_UBO_BINDING = 0;
+constexpr uint UPSCALE_SAMPLER_BINDING = 1;
+constexpr uint UPSCALE_UBO_COUNT = 8;
+} // namespace
+
+bool DynamicResolution::initialize(gfx::Device *device) {
+    _device = device;
+
+    _renderPass = _device->createRenderPass({
+        {{
+            gfx::Format::RGBA8,
+            1,
+            gfx::LoadOp::CLEAR,
+            gfx::StoreOp::STORE,
+            gfx::TextureLayout::UNDEFINED,
+            gfx::TextureLayout::SHADER_READONLY_OPTIMAL,
+        }},
+        {
+            _device->getDepthStencilFormat(),
+            1,
+            gfx::LoadOp::CLEAR,
+            gfx::StoreOp::DISCARD,
+            gfx::LoadOp::CLEAR,
+            gfx::StoreOp::DISCARD,
+            gfx::TextureLayout::UNDEFINED,
+            gfx::TextureLayout::DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        },
+    });
+
+    if (!_renderPass || !createUpscaleResources()) {
+        destroy();
+        return false;
+    }
+    return true;
+}
+
+bool DynamicResolution::createUpscaleResources() {
+    float vertices[] = {-1.0f, -1.0f, 3.0f, -1.0f, -1.0f, 3.0f};
+    _vertexBuffer = _device->createBuffer({
+        gfx::BufferUsageBit::VERTEX | gfx::BufferUsageBit::TRANSFER_DST,
+        gfx::MemoryUsageBit::HOST | gfx::MemoryUsageBit::DEVICE,
+        sizeof(vertices),
+        2 * sizeof(float),
+    });
+    _uniformBuffer = _device->createBuffer({
+        gfx::BufferUsageBit::UNIFORM | gfx::BufferUsageBit::TRANSFER_DST,
+        gfx::MemoryUsageBit::HOST | gfx::MemoryUsageBit::DEVICE,
+        UPSCALE_UBO_COUNT * sizeof(float),
+        UPSCALE_UBO_COUNT * sizeof(float),
+    });
+    if (!_vertexBuffer || !_uniformBuffer) return false;
+    _vertexBuffer->update(vertices, 0, sizeof(vertices));
+
+    gfx::AttributeList attributes = {{"a_position", gfx::Format::RG32F}};
+    _inputAssembler = _device->createInputAssembler({attributes, {_vertexBuffer}});
+
+    gfx::SamplerInfo samplerInfo;
+    samplerInfo.addressU = gfx::Address::CLAMP;
+    samplerInfo.addressV = gfx::Address::CLAMP;
+    samplerInfo.addressW = gfx::Address::CLAMP;
+    _sampler = _device->createSampler(samplerInfo);
+
+    gfx::ShaderInfo shaderInfo;
+    shaderInfo.name = "dynamic-resolution-upscale";
+    shaderInfo.attributes = attributes;
+    shaderInfo.blocks = {{0, UPSCALE_UBO_BINDING, "UpscaleParams", {{"u_uvScale", gfx::Type::FLOAT4, 1}, {"u_texelSize", gfx::Type::FLOAT4, 1}}, 1}};
+    shaderInfo.samplers = {{0, UPSCALE_SAMPLER_BINDING, "u_source", gfx::Type::SAMPLER2D, 1}};
+    switch (_device->getGfxAPI()) {
+        case gfx::API::GLES2:
+            shaderInfo.stages = {{gfx::ShaderStageFlagBit::VERTEX, UPSCALE_VERT_GLSL1}, {gfx::ShaderStageFlagBit::FRAGMENT, UPSCALE_FRAG_GLSL1}};
+            break;
+        case gfx::API::GLES3:
+            shaderInfo.stages = {{gfx::ShaderStageFlagBit::VERTEX, UPSCALE_VERT_GLSL3}, {gfx::ShaderStageFlagBit::FRAGMENT, UPSCALE_FRAG_GLSL3}};
+            break;
+        default:
+            shaderInfo.stages = {{gfx::ShaderStageFlagBit::VERTEX, UPSCALE_VERT_GLSL4}, {gfx::ShaderStageFlagBit::FRAGMENT, UPSCALE_FRAG_GLSL4}};
+            break;
+    }
+    _shader = _device->createShader(shaderInfo);
+
+    _descriptorSetLayout = _device->createDescriptorSetLayout({{
+        {UPSCALE_UBO_BINDING, gfx::DescriptorType::UNIFORM_BUFFER, 1, gfx::ShaderStageFlagBit::VERTEX | gfx::ShaderStageFlagBit::FRAGMENT},
+        {UPSCALE_SAMPLER_BINDING, gfx::DescriptorType::SAMPLER, 1, gfx::ShaderStageFlagBit::FRAGMENT},
+    }});
+    if (!_inputAssembler || !_sampler || !_shader || !_descriptorSetLayout) return false;
+
+    _descriptorSet = _device->createDescriptorSet({_descriptorSetLayout});
+    _pipelineLayout = _device->createPipelineLayout({{_descriptorSetLayout}});
+    if (!_descriptorSet || !_pipelineLayout) return false;
+
+    _descriptorSet->bindBuffer(UPSCALE_UBO_BINDING, _uniformBuffer);
+    _descriptorSet->bindSampler(UPSCALE_SAMPLER_BINDING, _sampler);
+    return true;
+}
+
+void DynamicResolution::destroy() {
+    destroyFramebuffer();
+    for (auto &pair : _pipelineStates) {
+        CC_SAFE_DESTROY(pair.second);
+    }
+    _pipelineStates.clear();
+    CC_SAFE_DESTROY(_descriptorSet);
+    CC_SAFE_DESTROY(_pipelineLayout);
+    CC_SAFE_DESTROY(_descriptorSetLayout);
+    CC_SAFE_DESTROY(_shader);
+    CC_SAFE_DESTROY(_sampler);
+    CC_SAFE_DESTROY(_inputAssembler);
+    CC_SAFE_DESTROY(_vertexBuffer);
+    CC_SAFE_DESTROY(_uniformBuffer);
+    CC_SAFE_DESTROY(_renderPass);
+    _device = nullptr;
+}
+
+void DynamicResolution::destroyFramebuffer() {
+    CC_SAFE_DESTROY(_framebuffer);
+    CC_SAFE_DESTROY(_colorTexture);
+    CC_SAFE_DESTROY(_depthStencilTexture);
+    _width = _height = 0;
+}
+
+gfx::Rect DynamicResolution::resize(uint width, uint height, float scale, float maxScale) {
+    const auto targetWidth = std::max(static_cast<uint>(std::ceil(width * maxScale)), 1u);
+    const auto targetHeight = std::max(static_cast<uint>(std::ceil(height * maxScale)), 1u);
+
+    if (targetWidth != _width || targetHeight != _height) {
+        destroyFramebuffer();
+        _colorTexture = _device->createTexture({
+            gfx::TextureType::TEX2D,
+            gfx::TextureUsageBit::COLOR_ATTACHMENT | gfx::TextureUsageBit::SAMPLED,
+            gfx::Format::RGBA8,
+            targetWidth,
+            targetHeight,
+        });
+        _depthStencilTexture = _device->createTexture({
+            gfx::TextureType::TEX2D,
+            gfx::TextureUsageBit::DEPTH_STENCIL_ATTACHMENT,
+            _device->getDepthStencilFormat(),
+            targetWidth,
+            targetHeight,
+        });
+        _framebuffer = _device->createFramebuffer({
+            _renderPass,
+            {_colorTexture},
+            _depthStencilTexture,
+            {}, //colorMipmapLevels
+        });
+        _width = targetWidth;
+        _height = targetHeight;
+
+        _descriptorSet->bindTexture(UPSCALE_SAMPLER_BINDING, _colorTexture);
+        _descriptorSet->update();
+    }
+
+    _area.x = _area.y = 0;
+    _area.width = std::min(std::max(static_cast<uint>(width * scale + 0.5f), 1u), _width);
+    _area.height = std::min(std::max(static_cast<uint>(height * scale + 0.5f), 1u), _height);
+    return _area;
+}
+
+void DynamicResolution::update(float sharpness) {
+    if (!_width || !_height) return;
+
+    float params[UPSCALE_UBO_COUNT] = {
+        static_cast<float>(_area.width) / _width,
+        static_cast<float>(_area.height) / _height,
+        // bilinear taps past the last texel center would blend in what the scene didn't draw
+        (_area.width - 0.5f) / _width,
+        (_area.height - 0.5f) / _height,
+        1.0f / _width,
+        1.0f / _height,
+        sharpness,
+        0.0f,
+    };
+    _uniformBuffer->update(params, 0, sizeof(params));
+}
+
+void DynamicResolution::recordUpscale(gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff) {
+    if (!_framebuffer) return;
+
+    auto *pso = getOrCreatePipelineState(renderPass);
+    if (!pso) return;
+    cmdBuff->bindPipelineState(pso);
+    cmdBuff->bindDescriptorSet(0, _descriptorSet);
+    cmdBuff->bindInputAssembler(_inputAssembler);
+    cmdBuff->draw(_inputAssembler);
+}
+
+gfx::PipelineState *DynamicResolution::getOrCreatePipelineState(gfx::RenderPass *renderPass) {
+    auto &pso = _pipelineStates[renderPass];
+    if (pso) return pso;
+
+    gfx::PipelineStateInfo info;
+    info.shader = _shader;
+    info.pipelineLayout = _pipelineLayout;
+    info.renderPass = renderPass;
+    info.inputState = {_inputAssembler->getAttributes()};
+    info.rasterizerState.cullMode = gfx::CullMode::NONE;
+    info.depthStencilState.depthTest = 0;
+    info.depthStencilState.depthWrite = 0;
+    info.blendState.targets.assign(std::max(renderPass->getColorAttachments().size(), size_t(1)), gfx::BlendTarget());
+    pso = _device->createPipelineState(info);
+    return pso;
+}
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "../Define.h"
+
+namespace cc {
+
+namespace gfx {
+class Buffer;
+class CommandBuffer;
+class DescriptorSet;
+class DescriptorSetLayout;
+class Framebuffer;
+class InputAssembler;
+class PipelineLayout;
+class PipelineState;
+class RenderPass;
+class Sampler;
+class Shader;
+class Texture;
+} // namespace gfx
+
+namespace pipeline {
+
+// Offscreen target a camera's scene is drawn into below native resolution, and the fullscreen pass
+// upscaling it into the window. The target is sized for the largest scale and the scene only covers
+// a corner of it, so that changing the scale doesn't reallocate anything.
+class CC_DLL DynamicResolution : public Object {
+public:
+    bool initialize(gfx::Device *device);
+    void destroy();
+
+    // Recreates the target when the native area or the largest scale changed, returns the scaled area.
+    gfx::Rect resize(uint width, uint height, float scale, float maxScale);
+    // Uploads the parameters of the upscale, outside of the render pass drawing it.
+    // A sharpness of 0 is a plain bilinear blit.
+    void update(float sharpness);
+    // Binds its own descriptor set at set 0, rebind the pipeline's global set for the draws after it.
+    void recordUpscale(gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff);
+
+    CC_INLINE gfx::RenderPass *getRenderPass() const { return _renderPass; }
+    CC_INLINE gfx::Framebuffer *getFramebuffer() const { return _framebuffer; }
+
+private:
+    bool createUpscaleResources();
+    void destroyFramebuffer();
+    gfx::PipelineState *getOrCreatePipelineState(gfx::RenderPass *renderPass);
+
+    gfx::Device *_device = nullptr;
+    gfx::RenderPass *_renderPass = nullptr;
+    gfx::Framebuffer *_framebuffer = nullptr;
+    gfx::Texture *_colorTexture = nullptr;
+    gfx::Texture *_depthStencilTexture = nullptr;
+    uint _width = 0;
+    uint _height = 0;
+    gfx::Rect _area;
+
+    gfx::Buffer *_vertexBuffer = nullptr;
+    gfx::Buffer *_uniformBuffer = nullptr;
+    gfx::InputAssembler *_inputAssembler = nullptr;
+    gfx::Sampler *_sampler = nullptr;
+    gfx::Shader *_shader = nullptr;
+    gfx::DescriptorSetLayout *_descriptorSetLayout = nullptr;
+    gfx::DescriptorSet *_descriptorSet = nullptr;
+    gfx::PipelineLayout *_pipelineLayout = nullptr;
+    std::unordered_map<gfx::RenderPass *, gfx::PipelineState *> _pipelineStates;
+};
+
+} // namespace pipeline
+} // namespace cc
@@ -2,6 +2,19 @@
 #include "../shadow/ShadowFlow.h"
 #include "ForwardFlow.h"
 #include "SceneCulling.h"
+#include "../PipelineStateManager.h"
+#include "../ShaderVariantCollector.h"
+#include "../RenderStage.h"
+#include "../StaticBatchedBuffer.h"
+#include "../helper/GPUTimer.h"
+#include "../helper/ModelBVH.h"
+#include "../helper/ModelCullingData.h"
+#include "../helper/TextureStreamer.h"
+#include "base/FrameStats.h"
+#include "base/Profiler.h"
+#include "base/ThreadPool.h"
+#include "base/memory/FrameAlloc.h"
+#include "base/memory/MemTracker.h"
 #include "gfx/GFXBuffer.h"
 #include "gfx/GFXCommandBuffer.h"
 #include "gfx/GFXDescriptorSet.h"
@@ -25,6 +38,15 @@ namespace {
     dst[offset + 1] = src.y;      \
     dst[offset + 2] = src.z;      \
     dst[offset + 3] = src.w;
+
+constexpr float MIN_DYNAMIC_RESOLUTION_SCALE = 0.25f;
+constexpr float MAX_DYNAMIC_RESOLUTION_STEP = 0.05f;
+constexpr float DYNAMIC_RESOLUTION_HEADROOM = 1.1f;
+
+// by PerformanceGovernor::Level, the PCF filters are HARD, SOFT and SOFT_2X
+constexpr float PERFORMANCE_SCALES[] = {1.0f, 0.85f, 0.7f, 0.5f};
+constexpr uint PERFORMANCE_CASCADE_LIMITS[] = {UINT32_MAX, 2, 1, 1};
+constexpr uint PERFORMANCE_PCF_LIMITS[] = {UINT32_MAX, 1, 0, 0};
 } // namespace
 
 gfx::RenderPass *ForwardPipeline::getOrCreateRenderPass(gfx::ClearFlags clearFlags) {
@@ -80,6 +102,351 @@ void ForwardPipeline::setShadows(uint shadows) {
     _shadows = GET_SHADOWS(shadows);
 }
 
+void ForwardPipeline::createWorkerThreadPool() {
+    if (_workerThreadPool) return;
+    // the render thread takes a share of the work itself, so leave one core to it
+    const auto workerCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    // the workers compute parts of the frame, on the cores and in the performance hint session of the CPU lane
+    _workerThreadPool = ThreadPool::newFixedThreadPool(workerCount, ThreadLane::CPU);
+}
+
+void ForwardPipeline::setParallelCulling(bool enabled) {
+    _isParallelCulling = enabled;
+    if (enabled) createWorkerThreadPool();
+}
+
+void ForwardPipeline::setParallelRecording(bool enabled) {
+    _isParallelRecording = enabled;
+    if (enabled) createWorkerThreadPool();
+}
+
+void ForwardPipeline::setShadowMapCache(bool enabled) {
+    if (enabled && !_device->hasFeature(gfx::Feature::DEPTH_STENCIL_COPY)) {
+        CC_LOG_WARNING("Shadow map cache is not supported on this device, depth stencil textures can't be copied.");
+        enabled = false;
+    }
+    _isShadowMapCache = enabled;
+}
+
+void ForwardPipeline::setShadowCascadeCount(uint count) {
+    if (count < 1 || count > UBOShadow::MAX_CASCADES) {
+        CC_LOG_WARNING("Shadow cascade count %u is out of range, clamped to [1, %u].", count, UBOShadow::MAX_CASCADES);
+    }
+    _shadowCascadeCount = std::min(std::max(count, 1u), UBOShadow::MAX_CASCADES);
+}
+
+void ForwardPipeline::setClusteredLighting(bool enabled) {
+    _isClusteredLighting = enabled;
+    _macros.setValue("CC_CLUSTERED_LIGHTING", enabled);
+    if (enabled) createWorkerThreadPool();
+}
+
+void ForwardPipeline::setOcclusionCulling(uint camera, bool enabled) {
+    const auto *cameraView = GET_CAMERA(camera);
+    auto iter = _occlusionCullings.find(cameraView);
+    if (!enabled) {
+        if (iter != _occlusionCullings.end()) {
+            CC_SAFE_DELETE(iter->second);
+            _occlusionCullings.erase(iter);
+        }
+        return;
+    }
+
+    if (iter == _occlusionCullings.end()) {
+        _occlusionCullings.emplace(cameraView, CC_NEW(OcclusionCulling));
+    }
+    createWorkerThreadPool();
+}
+
+void ForwardPipeline::setOcclusionBufferSize(uint camera, uint width, uint height) {
+    auto *occlusionCulling = getOcclusionCulling(GET_CAMERA(camera));
+    if (!occlusionCulling) {
+        CC_LOG_WARNING("Occlusion culling is not enabled for the camera, its buffer size is ignored.");
+        return;
+    }
+    occlusionCulling->resize(width, height);
+}
+
+void ForwardPipeline::setCameraUpdatePolicy(uint camera, uint policy, uint interval) {
+    const auto updatePolicy = static_cast<CameraUpdatePolicy>(policy);
+    if (updatePolicy == CameraUpdatePolicy::EVERY_FRAME) {
+        _cameraSchedules.erase(camera);
+        return;
+    }
+
+    if (GET_CAMERA(camera)->getWindow()->hasOnScreenAttachments) {
+        CC_LOG_WARNING("The camera draws on screen, it is rendered every frame.");
+    }
+
+    auto &schedule = _cameraSchedules[camera];
+    schedule.policy = updatePolicy;
+    schedule.interval = std::max(interval, 1u);
+    schedule.isRequested = true;
+    schedule.phase = 0;
+    if (updatePolicy == CameraUpdatePolicy::TIME_SLICED) {
+        // the next free turn among the cameras slicing the same interval
+        uint slicedCount = 0;
+        for (const auto &pair : _cameraSchedules) {
+            const auto &other = pair.second;
+            if (pair.first != camera && other.policy == CameraUpdatePolicy::TIME_SLICED && other.interval == schedule.interval) ++slicedCount;
+        }
+        schedule.phase = slicedCount % schedule.interval;
+    }
+}
+
+void ForwardPipeline::requestCameraUpdate(uint camera) {
+    auto iter = _cameraSchedules.find(camera);
+    if (iter != _cameraSchedules.end()) iter->second.isRequested = true;
+}
+
+bool ForwardPipeline::isCameraScheduled(uint camera, uint frame) {
+    auto iter = _cameraSchedules.find(camera);
+    if (iter == _cameraSchedules.end()) return true;
+
+    // its window may have moved on screen since the policy was set
+    if (GET_CAMERA(camera)->getWindow()->hasOnScreenAttachments) return true;
+
+    auto &schedule = iter->second;
+    // a camera renders once as soon as its policy is set, the targets start with its content
+    const bool isRequested = schedule.isRequested;
+    schedule.isRequested = false;
+    switch (schedule.policy) {
+        case CameraUpdatePolicy::INTERVAL:
+        case CameraUpdatePolicy::TIME_SLICED: return isRequested || frame % schedule.interval == schedule.phase;
+        case CameraUpdatePolicy::ON_DEMAND: return isRequested;
+        default: return true;
+    }
+}
+
+void ForwardPipeline::setDepthPrepassMode(uint camera, uint mode) {
+    const auto *cameraView = GET_CAMERA(camera);
+    const auto prepassMode = static_cast<DepthPrepassMode>(mode);
+    if (prepassMode == DepthPrepassMode::OFF) {
+        _depthPrepassStates.erase(cameraView);
+        return;
+    }
+
+    auto &state = _depthPrepassStates[cameraView];
+    state.mode = prepassMode;
+    state.isActive = prepassMode == DepthPrepassMode::ON || state.overdraw > _depthPrepassOverdrawThreshold;
+}
+
+float ForwardPipeline::getCameraOverdraw(uint camera) const {
+    const auto iter = _depthPrepassStates.find(GET_CAMERA(camera));
+    return iter != _depthPrepassStates.end() ? iter->second.overdraw : 0.0f;
+}
+
+bool ForwardPipeline::updateDepthPrepass(const Camera *camera, float overdraw) {
+    auto iter = _depthPrepassStates.find(camera);
+    if (iter == _depthPrepassStates.end()) return false;
+
+    auto &state = iter->second;
+    state.overdraw = overdraw;
+    if (state.mode == DepthPrepassMode::AUTO) {
+        // the margin keeps scenes hovering around the threshold from toggling every frame
+        const float threshold = state.isActive ? _depthPrepassOverdrawThreshold * 0.8f : _depthPrepassOverdrawThreshold;
+        state.isActive = overdraw > threshold;
+    }
+    return state.isActive;
+}
+
+OcclusionCulling *ForwardPipeline::getOcclusionCulling(const Camera *camera) const {
+    const auto iter = _occlusionCullings.find(camera);
+    return iter != _occlusionCullings.end() ? iter->second : nullptr;
+}
+
+void ForwardPipeline::setOccluder(uint model, const vector<float> &positions, const vector<uint> &indices) {
+    if (positions.empty()) {
+        _occluders.erase(model);
+        return;
+    }
+
+    const size_t vertexCount = positions.size() / 3;
+    if (positions.size() % 3 || indices.size() % 3 ||
+        std::any_of(indices.begin(), indices.end(), [vertexCount](uint index) { return index >= vertexCount; })) {
+        CC_LOG_WARNING("Occluder mesh needs 3 floats per position and 3 in-range indices per triangle, it is ignored.");
+        return;
+    }
+    auto &mesh = _occluders[model];
+    mesh.positions = positions;
+    mesh.indices = indices;
+}
+
+void ForwardPipeline::setLODGroup(uint model, const vector<float> &screenSizes, const vector<uint> &subMeshes, const vector<uint> &inputAssemblers) {
+    auto iter = _lodGroups.find(model);
+    if (iter != _lodGroups.end()) {
+        // the sub-models go back to the handles of the first level
+        auto &group = iter->second;
+        for (size_t i = 0; i < group.subModels.size(); ++i) {
+            auto *subModel = GET_SUBMODEL(group.subModels[i]);
+            subModel->subMeshID = group.subMeshes[i];
+            subModel->inputAssemblerID = group.inputAssemblers[i];
+        }
+        _lodGroups.erase(iter);
+    }
+    if (screenSizes.empty()) return;
+
+    const auto subModelID = GET_MODEL(model)->getSubModelID();
+    const uint subModelCount = subModelID ? subModelID[0] : 0;
+    const size_t handleCount = subModelCount * screenSizes.size();
+    if (!subModelCount || subMeshes.size() != handleCount || inputAssemblers.size() != handleCount ||
+        !std::is_sorted(screenSizes.rbegin(), screenSizes.rend())) {
+        CC_LOG_WARNING("LOD group needs descending screen sizes and a sub-mesh and input assembler per sub-model and level, it is ignored.");
+        return;
+    }
+    auto &group = _lodGroups[model];
+    group.screenSizes = screenSizes;
+    group.subModels.assign(subModelID + 1, subModelID + 1 + subModelCount);
+    group.subMeshes = subMeshes;
+    group.inputAssemblers = inputAssemblers;
+}
+
+void ForwardPipeline::setDynamicResolution(bool enabled) {
+    if (enabled) {
+        setGPUTimingEnabled(true);
+        if (!isGPUTimingEnabled()) {
+            CC_LOG_WARNING("Dynamic resolution needs GPU timing, it is disabled.");
+            enabled = false;
+        }
+    }
+    _isDynamicResolution = enabled;
+    _dynamicResolutionScale = _dynamicResolutionMaxScale;
+    _dynamicResolutionSettleFrames = 0;
+}
+
+void ForwardPipeline::setDynamicResolutionScaleRange(float minScale, float maxScale) {
+    _dynamicResolutionMinScale = std::min(std::max(minScale, MIN_DYNAMIC_RESOLUTION_SCALE), 1.0f);
+    _dynamicResolutionMaxScale = std::min(std::max(maxScale, _dynamicResolutionMinScale), 1.0f);
+    _dynamicResolutionScale = std::min(std::max(_dynamicResolutionScale, _dynamicResolutionMinScale), _dynamicResolutionMaxScale);
+}
+
+bool ForwardPipeline::isDynamicResolutionCamera(const Camera *camera) const {
+    if ((!_isDynamicResolution && _performanceScale >= 1.0f) || _isParallelRecording) return false;
+    // the UI stays at native resolution, and cameras drawing over others would lose what is below them
+    return !(camera->visibility & static_cast<uint>(LayerList::UI_2D)) &&
+           (static_cast<gfx::ClearFlags>(camera->clearFlag) & gfx::ClearFlagBit::COLOR) &&
+           camera->getWindow()->hasOnScreenAttachments;
+}
+
+void ForwardPipeline::updateDynamicResolution() {
+    if (!_isDynamicResolution || !_gpuTimer) return;
+    // the measurements lag frames behind, the last change has to show up in them before the next one
+    if (_dynamicResolutionSettleFrames) {
+        --_dynamicResolutionSettleFrames;
+        return;
+    }
+
+    float gpuTime = 0.0f;
+    for (const auto flow : _flows) {
+        for (const auto stage : flow->getStages()) {
+            gpuTime += stage->getGPUTime();
+        }
+    }
+    if (gpuTime <= 0.0f) return;
+
+    // below the target the scale only grows with some headroom left, so that it doesn't oscillate around it
+    const float ratio = _dynamicResolutionTargetTime / gpuTime;
+    if (ratio >= 1.0f && ratio < DYNAMIC_RESOLUTION_HEADROOM) return;
+
+    // the time of the scene grows with the pixel count, the square of the scale
+    float scale = _dynamicResolutionScale * std::sqrt(ratio);
+    scale = std::min(std::max(scale, _dynamicResolutionScale - MAX_DYNAMIC_RESOLUTION_STEP), _dynamicResolutionScale + MAX_DYNAMIC_RESOLUTION_STEP);
+    scale = std::min(std::max(scale, _dynamicResolutionMinScale), std::max(_dynamicResolutionMaxScale * _performanceScale, _dynamicResolutionMinScale));
+    if (scale != _dynamicResolutionScale) {
+        _dynamicResolutionScale = scale;
+        _dynamicResolutionSettleFrames = GPUTimer::POOL_COUNT;
+    }
+}
+
+void ForwardPipeline::updatePerformanceLevel() {
+    auto *app = Application::getInstance();
+    const auto level = _isPerformanceScaling && app ? static_cast<uint>(app->getPerformanceGovernor()->getLevel()) : 0;
+    _performanceScale = PERFORMANCE_SCALES[level];
+    _performanceCascadeLimit = PERFORMANCE_CASCADE_LIMITS[level];
+    _performancePCFLimit = PERFORMANCE_PCF_LIMITS[level];
+
+    if (_isDynamicResolution) {
+        // the scale follows the GPU time below the lowered ceiling
+        _dynamicResolutionScale = std::min(_dynamicResolutionScale, std::max(_dynamicResolutionMaxScale * _performanceScale, _dynamicResolutionMinScale));
+    } else {
+        _dynamicResolutionScale = std::min(_performanceScale, _dynamicResolutionMaxScale);
+    }
+}
+
+void ForwardPipeline::buildStaticBatches(const vector<uint> &models, const vector<float> &lightingMapUVParams) {
+    if (!_staticBatchedBuffer) _staticBatchedBuffer = CC_NEW(StaticBatchedBuffer);
+
+    vector<const ModelView *> modelViews;
+    modelViews.reserve(models.size());
+    for (auto model : models) {
+        modelViews.push_back(GET_MODEL(model));
+    }
+    _staticBatchedBuffer->build(modelViews, lightingMapUVParams, getPhaseID("default"));
+}
+
+void ForwardPipeline::clearStaticBatches() {
+    CC_SAFE_DESTROY(_staticBatchedBuffer);
+}
+
+void ForwardPipeline::setTextureStreaming(bool enabled) {
+    if (enabled == isTextureStreaming()) return;
+    if (enabled) {
+        _textureStreamer = CC_NEW(TextureStreamer);
+        if (!_textureStreamer->initialize(_device)) {
+            CC_LOG_WARNING("Texture streaming failed to start, it is disabled.");
+            CC_SAFE_DESTROY(_textureStreamer);
+            return;
+        }
+        _textureStreamer->setBudget(_textureStreamingBudget);
+    } else {
+        CC_SAFE_DESTROY(_textureStreamer);
+    }
+}
+
+void ForwardPipeline::setTextureStreamingBudget(uint bytes) {
+    _textureStreamingBudget = bytes;
+    if (_textureStreamer) _textureStreamer->setBudget(bytes);
+}
+
+uint ForwardPipeline::getTextureStreamingResidentSize() const {
+    return _textureStreamer ? _textureStreamer->getResidentSize() : 0;
+}
+
+bool ForwardPipeline::addStreamingTexture(gfx::Texture *texture, uint width, uint height, const vector<String> &levelPaths) {
+    return _textureStreamer && _textureStreamer->addTexture(texture, width, height, levelPaths);
+}
+
+void ForwardPipeline::removeStreamingTexture(gfx::Texture *texture) {
+    if (_textureStreamer) _textureStreamer->removeTexture(texture);
+}
+
+ModelBVH *ForwardPipeline::getModelBVH(const Scene *scene) {
+    auto &bvh = _modelBVHs[scene];
+    if (!bvh) bvh = CC_NEW(ModelBVH);
+    return bvh;
+}
+
+ModelCullingData *ForwardPipeline::getModelCullingData(const Scene *scene) {
+    auto &cullingData = _modelCullingDatas[scene];
+    if (!cullingData) cullingData = CC_NEW(ModelCullingData);
+    return cullingData;
+}
+
+void ForwardPipeline::destroyScene(uint scene) {
+    const auto *sceneView = GET_SCENE(scene);
+    auto bvhIter = _modelBVHs.find(sceneView);
+    if (bvhIter != _modelBVHs.end()) {
+        CC_SAFE_DELETE(bvhIter->second);
+        _modelBVHs.erase(bvhIter);
+    }
+    auto cullingDataIter = _modelCullingDatas.find(sceneView);
+    if (cullingDataIter != _modelCullingDatas.end()) {
+        CC_SAFE_DELETE(cullingDataIter->second);
+        _modelCullingDatas.erase(cullingDataIter);
+    }
+    _cullingSceneHandles.erase(sceneView);
+}
+
 void ForwardPipeline::destroyShadowFrameBuffers() {
     for (auto &pair : _shadowFrameBufferMap) {
         pair.second->destroy();
@@ -120,15 +487,34 @@ bool ForwardPipeline::activate() {
 }
 
 void ForwardPipeline::render(const vector<uint> &cameras) {
+    CC_PROFILE_ZONE("ForwardPipeline::render");
+    CC_MEM_MODULE_SCOPE(RENDERER);
+    PipelineStateManager::processPrewarmQueue();
+    if (_textureStreamer) _textureStreamer->update();
+
     _commandBuffers[0]->begin();
+    if (_gpuTimer) _gpuTimer->beginFrame(_commandBuffers[0]);
+    updatePerformanceLevel();
+    updateDynamicResolution();
+
+    const uint frame = Application::getInstance()->getTotalFrames();
+    _scheduledCameras.clear();
+    for (const auto cameraId : cameras) {
+        if (isCameraScheduled(cameraId, frame)) _scheduledCameras.emplace_back(cameraId);
+    }
+
+    if (_isMultiViewCulling) multiViewCulling(this, _scheduledCameras);
     for (const auto flow : _flows) {
-        for (const auto cameraId : cameras) {
+        for (const auto cameraId : _scheduledCameras) {
             Camera *camera = GET_CAMERA(cameraId);
             flow->render(camera);
         }
     }
     _commandBuffers[0]->end();
     _device->getQueue()->submit(_commandBuffers);
+    FrameStats::endFrame();
+    FrameAllocator::endFrame();
+    se::BufferPool::clearAllDirty();
 }
 
 void ForwardPipeline::updateCameraUBO(Camera *camera) {
@@ -144,8 +530,9 @@ void ForwardPipeline::updateCameraUBO(Camera *camera) {
     const auto shadingWidth = std::floor(_device->getWidth());
     const auto shadingHeight = std::floor(_device->getHeight());
     
-    uboCameraView[UBOCamera::SCREEN_SCALE_OFFSET] = camera->width / shadingWidth * _shadingScale;
-    uboCameraView[UBOCamera::SCREEN_SCALE_OFFSET + 1] = camera->height / shadingHeight * _shadingScale;
+    const auto shadingScale = isDynamicResolutionCamera(camera) ? _shadingScale * _dynamicResolutionScale : _shadingScale;
+    uboCameraView[UBOCamera::SCREEN_SCALE_OFFSET] = camera->width / shadingWidth * shadingScale;
+    uboCameraView[UBOCamera::SCREEN_SCALE_OFFSET + 1] = camera->height / shadingHeight * shadingScale;
     uboCameraView[UBOCamera::SCREEN_SCALE_OFFSET + 2] = 1.0 / uboCameraView[UBOCamera::SCREEN_SCALE_OFFSET];
     uboCameraView[UBOCamera::SCREEN_SCALE_OFFSET + 3] = 1.0 / uboCameraView[UBOCamera::SCREEN_SCALE_OFFSET + 1];
     
@@ -265,7 +652,7 @@ void ForwardPipeline::updateShadowUBO(Camera *camera) {
             Mat4::createOrthographicOffCenter(-x, x, -y, y, shadowInfo->nearValue, farClamp, device->getClipSpaceMinZ(), projectionSinY, &matShadowViewProj);
 
             matShadowViewProj.multiply(matShadowView);
-            float shadowInfos[4] = {shadowInfo->size.x, shadowInfo->size.y, (float)shadowInfo->pcfType, shadowInfo->bias};
+            float shadowInfos[4] = {shadowInfo->size.x, shadowInfo->size.y, (float)getShadowPCFType(), shadowInfo->bias};
             memcpy(_shadowUBO.data() + UBOShadow::MAT_LIGHT_VIEW_PROJ_OFFSET, matShadowViewProj.m, sizeof(matShadowViewProj));
             memcpy(_shadowUBO.data() + UBOShadow::SHADOW_INFO_OFFSET, &shadowInfos, sizeof(shadowInfos));
         } else if (mainLight && shadowInfo->getShadowType() == ShadowType::PLANAR) {
@@ -389,6 +776,50 @@ void ForwardPipeline::destroy() {
 
     _shadowFrameBufferMap.clear();
 
+    CC_SAFE_DELETE(_workerThreadPool);
+    PipelineStateManager::destroyPrewarmQueue();
+    // prewarmed shaders no pipeline state asked for
+    gfx::Device::getInstance()->releasePrewarmedShaders();
+    gfx::Device::getInstance()->releaseSharedDescriptorSets();
+    _cullingChunkResults.clear();
+    _isParallelCulling = false;
+    _isParallelRecording = false;
+    _isShadowMapCache = false;
+    _shadowCascadeCount = 1;
+    _isClusteredLighting = false;
+
+    for (auto &pair : _modelBVHs) {
+        CC_SAFE_DELETE(pair.second);
+    }
+    _modelBVHs.clear();
+    _isSpatialIndex = false;
+
+    for (auto &pair : _modelCullingDatas) {
+        CC_SAFE_DELETE(pair.second);
+    }
+    _modelCullingDatas.clear();
+    _isPackedCulling = false;
+    _cameraCullingResults.clear();
+    _cullingSceneHandles.clear();
+    _isMultiViewCulling = false;
+    _cameraSchedules.clear();
+    _scheduledCameras.clear();
+    _depthPrepassStates.clear();
+
+    for (auto &pair : _occlusionCullings) {
+        CC_SAFE_DELETE(pair.second);
+    }
+    _occlusionCullings.clear();
+    _occluders.clear();
+    _isOcclusionQueries = false;
+    _lodGroups.clear();
+    _lodHysteresis = 0.1f;
+    _isDynamicResolution = false;
+    _dynamicResolutionScale = 1.0f;
+    clearStaticBatches();
+    _isRadixSort = false;
+    CC_SAFE_DESTROY(_textureStreamer);
+
     RenderPipeline::destroy();
 }
 
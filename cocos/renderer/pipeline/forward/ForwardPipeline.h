@@ -4,8 +4,12 @@
 
 #include "../RenderPipeline.h"
 #include "../helper/SharedMemory.h"
+#include "OcclusionCulling.h"
+#include "SceneCulling.h"
 
 namespace cc {
+class ThreadPool;
+
 namespace pipeline {
 struct UBOGlobal;
 struct UBOCamera;
@@ -16,7 +20,27 @@ struct Skybox;
 struct Shadows;
 struct Sphere;
 struct Camera;
+struct Scene;
 class Framebuffer;
+class ModelBVH;
+class ModelCullingData;
+class StaticBatchedBuffer;
+class TextureStreamer;
+
+// How often a camera is rendered, for cameras drawing into render textures that can show an older frame.
+enum class CameraUpdatePolicy : uint {
+    EVERY_FRAME,
+    INTERVAL,    // every interval frames
+    TIME_SLICED, // every interval frames, the cameras sharing an interval take turns instead of rendering together
+    ON_DEMAND,   // on the frame after requestCameraUpdate()
+};
+
+// When a camera lays down the depth of its opaque queue before shading it.
+enum class DepthPrepassMode : uint {
+    OFF,
+    ON,
+    AUTO, // while the overdraw estimated from the opaque queue is above the threshold
+};
 
 class CC_DLL ForwardPipeline : public RenderPipeline {
 public:
@@ -59,6 +83,155 @@ public:
     CC_INLINE Shadows *getShadows() const { return _shadows; }
     CC_INLINE Sphere *getSphere() const { return _sphere; }
     CC_INLINE std::array<float, UBOShadow::COUNT> getShadowUBO() const { return _shadowUBO; }
+    // The PCF filter of the shadows within the limit of the performance level.
+    CC_INLINE uint getShadowPCFType() const { return std::min(_shadows->pcfType, _performancePCFLimit); }
+
+    // Splits sceneCulling() into chunks processed by a worker thread pool.
+    void setParallelCulling(bool enabled);
+    CC_INLINE bool isParallelCulling() const { return _isParallelCulling; }
+    CC_INLINE vector<RenderObjectList> &getCullingChunkResults() { return _cullingChunkResults; }
+
+    // Records the forward stage queues into secondary command buffers on the worker
+    // thread pool, only takes effect on backends with native secondary command buffers.
+    void setParallelRecording(bool enabled);
+    CC_INLINE bool isParallelRecording() const { return _isParallelRecording; }
+
+    CC_INLINE ThreadPool *getWorkerThreadPool() const { return _workerThreadPool; }
+
+    // Sorts the forward render queues by packed 64-bit keys with a radix sort.
+    CC_INLINE void setRadixSort(bool enabled) { _isRadixSort = enabled; }
+    CC_INLINE bool isRadixSort() const { return _isRadixSort; }
+
+    // Culls scene cameras through a per-scene ModelBVH instead of a linear walk over all models.
+    CC_INLINE void setSpatialIndex(bool enabled) { _isSpatialIndex = enabled; }
+    CC_INLINE bool isSpatialIndex() const { return _isSpatialIndex; }
+    ModelBVH *getModelBVH(const Scene *scene);
+
+    // Culls and collects shadow casters over a per-scene ModelCullingData, which the script side keeps current by
+    // flagging the model, node and AABB entries it writes in their BufferPool.
+    CC_INLINE void setPackedCulling(bool enabled) { _isPackedCulling = enabled; }
+    CC_INLINE bool isPackedCulling() const { return _isPackedCulling; }
+    ModelCullingData *getModelCullingData(const Scene *scene);
+
+    // Releases the per-scene index and culling data, called by the script side when it destroys the scene, the
+    // address of its Scene view is handed out again to the next scene of the pool.
+    void destroyScene(uint scene);
+
+    // Culls all cameras of a frame at once before the flows run, see multiViewCulling(). Cameras with occlusion
+    // culling, and all of them while the spatial index, LOD groups or texture streaming are on, are culled alone.
+    CC_INLINE void setMultiViewCulling(bool enabled) { _isMultiViewCulling = enabled; }
+    CC_INLINE bool isMultiViewCulling() const { return _isMultiViewCulling; }
+    CC_INLINE std::unordered_map<const Camera *, CameraCullingResult> &getCameraCullingResults() { return _cameraCullingResults; }
+    CC_INLINE std::unordered_map<const Scene *, UintList> &getCullingSceneHandles() { return _cullingSceneHandles; }
+
+    // Renders static shadow casters once into a persistent shadow map per light, which is copied under
+    // the dynamic casters every frame. Needs Feature::DEPTH_STENCIL_COPY to composite them.
+    void setShadowMapCache(bool enabled);
+    CC_INLINE bool isShadowMapCache() const { return _isShadowMapCache; }
+
+    // Splits the main directional light's shadow map into up to UBOShadow::MAX_CASCADES tiles covering
+    // consecutive slices of the camera frustum up to the cascade distance, 1 keeps a single shadow map.
+    // A distance of 0 spreads the cascades over the whole camera frustum.
+    void setShadowCascadeCount(uint count);
+    // within the limit of the performance level
+    CC_INLINE uint getShadowCascadeCount() const { return std::min(_shadowCascadeCount, _performanceCascadeLimit); }
+    CC_INLINE void setShadowCascadeDistance(float distance) { _shadowCascadeDistance = std::max(distance, 0.0f); }
+    CC_INLINE float getShadowCascadeDistance() const { return _shadowCascadeDistance; }
+
+    // Bins the sphere and spot lights into a froxel grid the forward pass shades them from, replacing the
+    // additive light passes. Exposed to effects as CC_CLUSTERED_LIGHTING, set it before they are compiled.
+    void setClusteredLighting(bool enabled);
+    CC_INLINE bool isClusteredLighting() const { return _isClusteredLighting; }
+    CC_INLINE UintList &getVisibleModelHandles() { return _visibleModelHandles; }
+
+    // Rejects models hidden behind the occluders of a camera, tested against a depth buffer rasterized on the CPU.
+    // A larger buffer culls closer to the silhouettes at the cost of rasterization time.
+    void setOcclusionCulling(uint camera, bool enabled);
+    void setOcclusionBufferSize(uint camera, uint width, uint height);
+    OcclusionCulling *getOcclusionCulling(const Camera *camera) const;
+
+    // Cameras skipped in a frame are neither culled nor recorded, their render textures keep the last frame they
+    // were rendered. Cameras start in CameraUpdatePolicy::EVERY_FRAME, and the others render on the frame after the
+    // call. Swapchain contents are undefined after presenting, cameras drawing on screen render every frame.
+    void setCameraUpdatePolicy(uint camera, uint policy, uint interval);
+    void requestCameraUpdate(uint camera);
+
+    // Draws the opaque queue of the camera depth-only first, then shades it with an EQUAL depth test so every
+    // covered pixel runs the fragment shader once, for scenes with heavy shaders and overdraw. Cameras start in
+    // DepthPrepassMode::OFF. The overdraw is the summed screen area of the opaque draws over the viewport, estimated
+    // from their bounds each frame; AUTO switches the pre-pass off again below 80% of the threshold.
+    void setDepthPrepassMode(uint camera, uint mode);
+    CC_INLINE void setDepthPrepassOverdrawThreshold(float threshold) { _depthPrepassOverdrawThreshold = std::max(threshold, 1.0f); }
+    CC_INLINE float getDepthPrepassOverdrawThreshold() const { return _depthPrepassOverdrawThreshold; }
+    float getCameraOverdraw(uint camera) const;
+    CC_INLINE bool isDepthPrepassCamera(const Camera *camera) const { return _depthPrepassStates.count(camera) != 0; }
+    // Records the overdraw the forward stage measured, returns whether the camera draws the pre-pass this frame.
+    bool updateDepthPrepass(const Camera *camera, float overdraw);
+    // Rasterizes the low poly mesh in place of the model, empty positions remove the occluder.
+    void setOccluder(uint model, const vector<float> &positions, const vector<uint> &indices);
+    CC_INLINE const std::unordered_map<uint, OccluderMesh> &getOccluders() const { return _occluders; }
+
+    // Skips the opaque draws of models GPU occlusion queries found hidden in an earlier frame, boxes standing
+    // in for them are queried until they show up again. Models with a smaller bounds radius are not queried,
+    // results are dropped once the camera moved farther than the reprojection distance from where they were measured.
+    CC_INLINE void setOcclusionQueries(bool enabled) { _isOcclusionQueries = enabled; }
+    CC_INLINE bool isOcclusionQueries() const { return _isOcclusionQueries; }
+    CC_INLINE void setOcclusionQueryMinRadius(float radius) { _occlusionQueryMinRadius = std::max(radius, 0.0f); }
+    CC_INLINE float getOcclusionQueryMinRadius() const { return _occlusionQueryMinRadius; }
+    CC_INLINE void setOcclusionQueryReprojectionDistance(float distance) { _occlusionQueryReprojectionDistance = std::max(distance, 0.0f); }
+    CC_INLINE float getOcclusionQueryReprojectionDistance() const { return _occlusionQueryReprojectionDistance; }
+
+    // Swaps the sub-meshes of a model's sub-models natively during culling by the screen size of its world bounds.
+    // Sub-meshes and input assemblers hold one handle per sub-model for each screen size, empty screen sizes remove
+    // the group and restore the first level. The hysteresis is the fraction a screen size has to pass a threshold by.
+    void setLODGroup(uint model, const vector<float> &screenSizes, const vector<uint> &subMeshes, const vector<uint> &inputAssemblers);
+    CC_INLINE std::unordered_map<uint, LODGroup> &getLODGroups() { return _lodGroups; }
+    CC_INLINE void setLODHysteresis(float hysteresis) { _lodHysteresis = std::min(std::max(hysteresis, 0.0f), 0.5f); }
+    CC_INLINE float getLODHysteresis() const { return _lodHysteresis; }
+
+    // Draws the scene of cameras clearing the color of an on-screen window into a scaled offscreen target, which is
+    // upscaled into the window before the UI is drawn at native resolution. The scale follows the GPU time of the
+    // stages towards the target time in milliseconds, within the scale range. Enabling it enables GPU timing, it
+    // doesn't apply while recording in parallel. A sharpness above 0 sharpens the upscaled image.
+    void setDynamicResolution(bool enabled);
+    CC_INLINE bool isDynamicResolution() const { return _isDynamicResolution; }
+    CC_INLINE void setDynamicResolutionTargetTime(float time) { _dynamicResolutionTargetTime = std::max(time, 1.0f); }
+    CC_INLINE float getDynamicResolutionTargetTime() const { return _dynamicResolutionTargetTime; }
+    void setDynamicResolutionScaleRange(float minScale, float maxScale);
+    CC_INLINE float getDynamicResolutionMinScale() const { return _dynamicResolutionMinScale; }
+    CC_INLINE float getDynamicResolutionMaxScale() const { return _dynamicResolutionMaxScale; }
+    CC_INLINE void setDynamicResolutionSharpness(float sharpness) { _dynamicResolutionSharpness = std::min(std::max(sharpness, 0.0f), 1.0f); }
+    CC_INLINE float getDynamicResolutionSharpness() const { return _dynamicResolutionSharpness; }
+    CC_INLINE float getDynamicResolutionScale() const { return _dynamicResolutionScale; }
+    bool isDynamicResolutionCamera(const Camera *camera) const;
+
+    // Follows the level of the PerformanceGovernor of the application: from FAIR on the shadows use fewer cascades
+    // and softer filtering, and the scene resolution is scaled down on top of dynamic resolution, or at a fixed
+    // scale without it.
+    CC_INLINE void setPerformanceScaling(bool enabled) { _isPerformanceScaling = enabled; }
+    CC_INLINE bool isPerformanceScaling() const { return _isPerformanceScaling; }
+
+    // Merges the static models of a loaded scene into batches sharing a pass and lightmap, replacing any previous
+    // ones. Lightmap UV params are 4 floats per model, clear the batches before the models are destroyed.
+    void buildStaticBatches(const vector<uint> &models, const vector<float> &lightingMapUVParams);
+    void clearStaticBatches();
+    CC_INLINE StaticBatchedBuffer *getStaticBatchedBuffer() const { return _staticBatchedBuffer; }
+
+    // Streams the mip chains of the added textures by the screen size of the models drawing them, keeping the
+    // resident chains within the budget in bytes. Disabling it leaves the textures with their current chains.
+    void setTextureStreaming(bool enabled);
+    CC_INLINE bool isTextureStreaming() const { return _textureStreamer != nullptr; }
+    void setTextureStreamingBudget(uint bytes);
+    CC_INLINE uint getTextureStreamingBudget() const { return _textureStreamingBudget; }
+    uint getTextureStreamingResidentSize() const;
+    // The full chain has one image file per level, the texture is shrunk to the tail of it right away.
+    bool addStreamingTexture(gfx::Texture *texture, uint width, uint height, const vector<String> &levelPaths);
+    void removeStreamingTexture(gfx::Texture *texture);
+    CC_INLINE TextureStreamer *getTextureStreamer() const { return _textureStreamer; }
+
+    // Culling fills these in place, clearing keeps the capacity of previous frames.
+    CC_INLINE RenderObjectList &getRenderObjects() { return _renderObjects; }
+    CC_INLINE RenderObjectList &getShadowObjects() { return _shadowObjects; }
 
     void setRenderObjects(const RenderObjectList &ro) { _renderObjects = std::move(ro); }
     void setShadowObjects(const RenderObjectList &ro) { _shadowObjects = std::move(ro); }
@@ -66,6 +239,9 @@ public:
 private:
     bool activeRenderer();
     void updateUBO(Camera *);
+    void createWorkerThreadPool();
+    void updateDynamicResolution();
+    void updatePerformanceLevel();
 
 private:
     const Fog *_fog = nullptr;
@@ -90,6 +266,74 @@ private:
     float _fpScale = 1.0f / 1024.0f;
 
     std::unordered_map<const Light *, gfx::Framebuffer *> _shadowFrameBufferMap;
+
+    ThreadPool *_workerThreadPool = nullptr;
+    bool _isParallelCulling = false;
+    vector<RenderObjectList> _cullingChunkResults;
+    bool _isParallelRecording = false;
+    bool _isRadixSort = false;
+
+    bool _isSpatialIndex = false;
+    std::unordered_map<const Scene *, ModelBVH *> _modelBVHs;
+    UintList _visibleModelHandles;
+
+    bool _isPackedCulling = false;
+    std::unordered_map<const Scene *, ModelCullingData *> _modelCullingDatas;
+
+    bool _isMultiViewCulling = false;
+    std::unordered_map<const Camera *, CameraCullingResult> _cameraCullingResults;
+    std::unordered_map<const Scene *, UintList> _cullingSceneHandles; // scene handle arrays of the last multi-view walk
+
+    bool _isShadowMapCache = false;
+    uint _shadowCascadeCount = 1;
+    float _shadowCascadeDistance = 0.0f;
+    bool _isClusteredLighting = false;
+
+    struct CameraSchedule {
+        CameraUpdatePolicy policy = CameraUpdatePolicy::EVERY_FRAME;
+        uint interval = 1;
+        uint phase = 0;
+        bool isRequested = true;
+    };
+    bool isCameraScheduled(uint camera, uint frame);
+    std::unordered_map<uint, CameraSchedule> _cameraSchedules;
+    vector<uint> _scheduledCameras;
+
+    struct DepthPrepassState {
+        DepthPrepassMode mode = DepthPrepassMode::OFF;
+        float overdraw = 0.0f;
+        bool isActive = false;
+    };
+    std::unordered_map<const Camera *, DepthPrepassState> _depthPrepassStates;
+    float _depthPrepassOverdrawThreshold = 2.5f;
+
+    std::unordered_map<const Camera *, OcclusionCulling *> _occlusionCullings;
+    std::unordered_map<uint, OccluderMesh> _occluders;
+
+    bool _isOcclusionQueries = false;
+    float _occlusionQueryMinRadius = 1.0f;
+    float _occlusionQueryReprojectionDistance = 0.5f;
+
+    StaticBatchedBuffer *_staticBatchedBuffer = nullptr;
+
+    TextureStreamer *_textureStreamer = nullptr;
+    uint _textureStreamingBudget = 256 * 1024 * 1024;
+
+    std::unordered_map<uint, LODGroup> _lodGroups;
+    float _lodHysteresis = 0.1f;
+
+    bool _isDynamicResolution = false;
+    float _dynamicResolutionTargetTime = 16.0f;
+    float _dynamicResolutionMinScale = 0.5f;
+    float _dynamicResolutionMaxScale = 1.0f;
+    float _dynamicResolutionSharpness = 0.2f;
+    float _dynamicResolutionScale = 1.0f;
+    uint _dynamicResolutionSettleFrames = 0;
+
+    bool _isPerformanceScaling = true;
+    float _performanceScale = 1.0f;
+    uint _performanceCascadeLimit = UINT32_MAX;
+    uint _performancePCFLimit = UINT32_MAX;
 };
 
 } // namespace pipeline
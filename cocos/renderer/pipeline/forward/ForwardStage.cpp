@@ -6,17 +6,30 @@
 #include "../RenderBatchedQueue.h"
 #include "../RenderInstancedQueue.h"
 #include "../RenderQueue.h"
+#include "../StaticBatchedBuffer.h"
+#include "../helper/GPUOcclusionQueries.h"
 #include "../helper/SharedMemory.h"
+#include "ClusterLightCulling.h"
+#include "DynamicResolution.h"
 #include "ForwardPipeline.h"
 #include "gfx/GFXCommandBuffer.h"
 #include "gfx/GFXDevice.h"
 #include "gfx/GFXFramebuffer.h"
 #include "gfx/GFXQueue.h"
 #include "UIPhase.h"
+#include "base/Profiler.h"
+#include "base/ThreadPool.h"
+#include "platform/Application.h"
+
+#include <condition_variable>
+#include <mutex>
 
 namespace cc {
 namespace pipeline {
 namespace {
+// opaque, instanced, dynamic and static batches, additive lights, planar shadows, transparent and UI
+constexpr uint FORWARD_QUEUE_COUNT = 7;
+
 void SRGBToLinear(gfx::Color &out, const gfx::Color &gamma) {
     out.x = gamma.x * gamma.x;
     out.y = gamma.y * gamma.y;
@@ -28,6 +41,29 @@ void LinearToSRGB(gfx::Color &out, const gfx::Color &linear) {
     out.y = std::sqrt(linear.y);
     out.z = std::sqrt(linear.z);
 }
+
+// Summed screen area of the draws over the viewport, from the spheres around their world bounds. Draws whose
+// sphere reaches the camera cover the whole viewport, those without bounds are not counted.
+float estimateOverdraw(const Camera *camera, const RenderPassList &renderPasses) {
+    const float *proj = camera->matProj.m;
+    const bool isPerspective = proj[11] != 0.0f;
+    // area in NDC of a unit sphere at unit depth, the viewport spans 4
+    const float unitArea = MATH_PIOVER2 * 2.0f * std::fabs(proj[0] * proj[5]);
+    float area = 0.0f;
+    for (const auto &renderPass : renderPasses) {
+        const auto *model = renderPass.model;
+        if (!model->worldBoundsID) continue;
+        const float radiusSq = model->getWorldBounds()->halfExtents.lengthSquared();
+        if (!isPerspective) {
+            area += std::min(unitArea * radiusSq, 4.0f);
+        } else if (renderPass.depth * renderPass.depth <= radiusSq || renderPass.depth <= 0.0f) {
+            area += 4.0f;
+        } else {
+            area += std::min(unitArea * radiusSq / (renderPass.depth * renderPass.depth), 4.0f);
+        }
+    }
+    return area / 4.0f;
+}
 } // namespace
 
 RenderStageInfo ForwardStage::_initInfo = {
@@ -73,7 +109,7 @@ void ForwardStage::activate(RenderPipeline *pipeline, RenderFlow *flow) {
                 break;
         }
 
-        RenderQueueCreateInfo info = {descriptor.isTransparent, phase, sortFunc};
+        RenderQueueCreateInfo info = {descriptor.isTransparent, phase, sortFunc, descriptor.sortMode};
         _renderQueues.emplace_back(CC_NEW(RenderQueue(std::move(info))));
     }
 
@@ -83,15 +119,36 @@ void ForwardStage::activate(RenderPipeline *pipeline, RenderFlow *flow) {
 }
 
 void ForwardStage::destroy() {
+    for (auto &cmdBuffs : _secondaryCmdBuffs) {
+        for (auto cmdBuff : cmdBuffs) {
+            cmdBuff->destroy();
+            CC_DELETE(cmdBuff);
+        }
+    }
+    _secondaryCmdBuffs.clear();
+
+    for (auto &pair : _occlusionQueries) {
+        CC_SAFE_DESTROY(pair.second);
+    }
+    _occlusionQueries.clear();
+    _currentOcclusionQueries = nullptr;
+
+    for (auto &pair : _dynamicResolutions) {
+        CC_SAFE_DESTROY(pair.second);
+    }
+    _dynamicResolutions.clear();
+
     CC_SAFE_DELETE(_batchedQueue);
     CC_SAFE_DELETE(_instancedQueue);
     CC_SAFE_DELETE(_additiveLightQueue);
+    CC_SAFE_DELETE(_clusterLightCulling);
     CC_SAFE_DELETE(_planarShadowQueue);
     CC_SAFE_DELETE(_uiPhase);
     RenderStage::destroy();
 }
 
 void ForwardStage::render(Camera *camera) {
+    CC_PROFILE_ZONE("ForwardStage::render");
     _instancedQueue->clear();
     _batchedQueue->clear();
     auto pipeline = static_cast<ForwardPipeline *>(_pipeline);
@@ -99,7 +156,10 @@ void ForwardStage::render(Camera *camera) {
 
     for (auto queue : _renderQueues) {
         queue->clear();
+        queue->setRadixSort(pipeline->isRadixSort());
     }
+    auto staticBatchedBuffer = pipeline->getStaticBatchedBuffer();
+    if (staticBatchedBuffer) staticBatchedBuffer->clear();
 
     uint m = 0, p = 0;
     size_t k = 0;
@@ -114,6 +174,7 @@ void ForwardStage::render(Camera *camera) {
                 const PassView *pass = subModel->getPassView(p);
 
                 if (pass->phase != _phaseID) continue;
+                if (staticBatchedBuffer && staticBatchedBuffer->merge(subModelID[m], p)) continue;
                 if (pass->getBatchingScheme() == BatchingSchemes::INSTANCING) {
                     auto instancedBuffer = InstancedBuffer::get(subModel->passID[p]);
                     instancedBuffer->merge(model, subModel, p);
@@ -134,11 +195,21 @@ void ForwardStage::render(Camera *camera) {
         queue->sort();
     }
 
+    _isDepthPrepass = false;
+    if (pipeline->isDepthPrepassCamera(camera)) {
+        _isDepthPrepass = pipeline->updateDepthPrepass(camera, estimateOverdraw(camera, _renderQueues[0]->getRenderPasses()));
+    }
+
     auto cmdBuff = pipeline->getCommandBuffers()[0];
 
     _instancedQueue->uploadBuffers(cmdBuff);
     _batchedQueue->uploadBuffers(cmdBuff);
-    _additiveLightQueue->gatherLightPasses(camera, cmdBuff);
+    if (pipeline->isClusteredLighting()) {
+        if (!_clusterLightCulling) _clusterLightCulling = CC_NEW(ClusterLightCulling(pipeline));
+        _clusterLightCulling->update(camera, cmdBuff);
+    } else {
+        _additiveLightQueue->gatherLightPasses(camera, cmdBuff);
+    }
     _planarShadowQueue->gatherShadowPasses(camera, cmdBuff);
 
     // render area is not oriented
@@ -170,19 +241,241 @@ void ForwardStage::render(Camera *camera) {
 
     auto renderPass = colorTextures.size() && colorTextures[0] ? framebuffer->getRenderPass() : pipeline->getOrCreateRenderPass(static_cast<gfx::ClearFlagBit>(camera->clearFlag));
 
+    // GLES and Metal flatten secondaries back into the primary, there is nothing to gain
+    bool isParallelRecording = pipeline->isParallelRecording() && _device->getGfxAPI() == gfx::API::VULKAN;
+    // the queues are recorded here if an object the recording threads look up can't be resolved
+    if (isParallelRecording) isParallelRecording = resolveObjects(camera);
+
+    // secondary command buffers don't inherit the queries of the render pass
+    _currentOcclusionQueries = nullptr;
+    if (pipeline->isOcclusionQueries() && !isParallelRecording) {
+        _currentOcclusionQueries = getOrCreateOcclusionQueries(camera);
+        if (_currentOcclusionQueries) _currentOcclusionQueries->beginFrame(camera, renderObjects, cmdBuff);
+    }
+
+    if (isParallelRecording) {
+        recordQueuesInParallel(camera, renderPass, framebuffer);
+        const auto &secondaryCmdBuffs = _secondaryCmdBuffs[_usedSecondaryCmdBuffSets - 1];
+        cmdBuff->beginRenderPass(renderPass, framebuffer, _renderArea, _clearColors, camera->clearDepth, camera->clearStencil, secondaryCmdBuffs);
+        cmdBuff->execute(secondaryCmdBuffs, FORWARD_QUEUE_COUNT);
+        cmdBuff->endRenderPass();
+        return;
+    }
+
+    auto *dynamicResolution = pipeline->isDynamicResolutionCamera(camera) ? getOrCreateDynamicResolution(camera) : nullptr;
+    if (dynamicResolution) {
+        const auto sceneArea = dynamicResolution->resize(_renderArea.width, _renderArea.height, pipeline->getDynamicResolutionScale(), pipeline->getDynamicResolutionMaxScale());
+        dynamicResolution->update(pipeline->getDynamicResolutionSharpness());
+
+        auto *sceneRenderPass = dynamicResolution->getRenderPass();
+        cmdBuff->beginRenderPass(sceneRenderPass, dynamicResolution->getFramebuffer(), sceneArea, _clearColors, camera->clearDepth, camera->clearStencil);
+        cmdBuff->bindDescriptorSet(GLOBAL_SET, _pipeline->getDescriptorSet());
+        for (uint i = 0; i < FORWARD_QUEUE_COUNT - 1; ++i) {
+            recordQueue(i, camera, sceneRenderPass, cmdBuff);
+        }
+        cmdBuff->endRenderPass();
+
+        // the UI is drawn over the upscaled scene at native resolution
+        cmdBuff->beginRenderPass(renderPass, framebuffer, _renderArea, _clearColors, camera->clearDepth, camera->clearStencil);
+        dynamicResolution->recordUpscale(renderPass, cmdBuff);
+        cmdBuff->bindDescriptorSet(GLOBAL_SET, _pipeline->getDescriptorSet());
+        recordQueue(FORWARD_QUEUE_COUNT - 1, camera, renderPass, cmdBuff);
+        cmdBuff->endRenderPass();
+        return;
+    }
+
     cmdBuff->beginRenderPass(renderPass, framebuffer, _renderArea, _clearColors, camera->clearDepth, camera->clearStencil);
     cmdBuff->bindDescriptorSet(GLOBAL_SET, _pipeline->getDescriptorSet());
 
-    _renderQueues[0]->recordCommandBuffer(_device, renderPass, cmdBuff);
-    _instancedQueue->recordCommandBuffer(_device, renderPass, cmdBuff);
-    _batchedQueue->recordCommandBuffer(_device, renderPass, cmdBuff);
-    _additiveLightQueue->recordCommandBuffer(_device, renderPass, cmdBuff);
-    _planarShadowQueue->recordCommandBuffer(_device, renderPass, cmdBuff);
-    _renderQueues[1]->recordCommandBuffer(_device, renderPass, cmdBuff);
-    _uiPhase->render(camera, renderPass);
-    
+    for (uint i = 0; i < FORWARD_QUEUE_COUNT; ++i) {
+        recordQueue(i, camera, renderPass, cmdBuff);
+    }
+
     cmdBuff->endRenderPass();
 }
 
+void ForwardStage::recordQueue(uint queueIndex, Camera *camera, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff) {
+    switch (queueIndex) {
+        case 0:
+            if (_isDepthPrepass) {
+                _renderQueues[0]->recordCommandBuffer(_device, renderPass, cmdBuff, nullptr, 0, DepthPassVariant::DEPTH_ONLY);
+                _renderQueues[0]->recordCommandBuffer(_device, renderPass, cmdBuff, _currentOcclusionQueries, 0, DepthPassVariant::DEPTH_EQUAL);
+            } else {
+                _renderQueues[0]->recordCommandBuffer(_device, renderPass, cmdBuff, _currentOcclusionQueries);
+            }
+            break;
+        case 1: _instancedQueue->recordCommandBuffer(_device, renderPass, cmdBuff); break;
+        case 2: {
+            _batchedQueue->recordCommandBuffer(_device, renderPass, cmdBuff);
+            auto staticBatchedBuffer = static_cast<ForwardPipeline *>(_pipeline)->getStaticBatchedBuffer();
+            if (staticBatchedBuffer) staticBatchedBuffer->recordCommandBuffer(_device, renderPass, cmdBuff);
+        } break;
+        case 3:
+            // clustered lights are shaded by the base passes
+            if (!static_cast<ForwardPipeline *>(_pipeline)->isClusteredLighting()) {
+                _additiveLightQueue->recordCommandBuffer(_device, renderPass, cmdBuff);
+            }
+            break;
+        case 4: _planarShadowQueue->recordCommandBuffer(_device, renderPass, cmdBuff); break;
+        case 5: _renderQueues[1]->recordCommandBuffer(_device, renderPass, cmdBuff); break;
+        case 6: _uiPhase->render(camera, renderPass, cmdBuff); break;
+        default: break;
+    }
+}
+
+// The recording threads can't enter the script engine, the shaders, input assemblers, descriptor sets and
+// pipeline layouts of the objects the queues draw are resolved here. Entries resolved for an earlier camera
+// of the frame are not looked up again.
+bool ForwardStage::resolveObjects(const Camera *camera) {
+    const auto frame = Application::getInstance()->getTotalFrames();
+    if (frame != _lastResolvingFrame) {
+        _lastResolvingFrame = frame;
+        se::ObjectPool::clearResolved();
+    }
+
+    bool isResolved = true;
+    const auto resolve = [&isResolved](se::PoolType type, uint id) {
+        auto *pool = se::ObjectPool::getPool(type);
+        if (!pool || !pool->resolve(id)) isResolved = false;
+    };
+    const auto resolvePass = [&resolve](const PassView *pass) {
+        resolve(se::PoolType::DESCRIPTOR_SETS, pass->descriptorSetID);
+        resolve(se::PoolType::PIPELINE_LAYOUT, pass->pipelineLayoutID);
+    };
+    const auto resolveSubModel = [&](const SubModelView *subModel) {
+        resolve(se::PoolType::INPUT_ASSEMBLER, subModel->inputAssemblerID);
+        resolve(se::PoolType::DESCRIPTOR_SETS, subModel->descriptorSetID);
+        for (uint p = 0; p < subModel->passCount; ++p) {
+            resolve(se::PoolType::SHADER, subModel->shaderID[p]);
+            resolvePass(subModel->getPassView(p));
+        }
+    };
+
+    auto *pipeline = static_cast<ForwardPipeline *>(_pipeline);
+    for (const auto &ro : pipeline->getRenderObjects()) {
+        const auto *subModelID = ro.model->getSubModelID();
+        for (uint m = 1; m <= subModelID[0]; ++m) {
+            resolveSubModel(ro.model->getSubModelView(subModelID[m]));
+        }
+    }
+
+    const auto *staticBatchedBuffer = pipeline->getStaticBatchedBuffer();
+    if (staticBatchedBuffer) {
+        for (const auto &batch : staticBatchedBuffer->getBatches()) {
+            if (batch.pass) resolvePass(batch.pass);
+        }
+    }
+
+    const auto *shadowInfo = pipeline->getShadows();
+    if (shadowInfo->enabled && shadowInfo->getShadowType() == ShadowType::PLANAR) {
+        resolve(se::PoolType::SHADER, shadowInfo->shader);
+        if (shadowInfo->instancingShader) resolve(se::PoolType::SHADER, shadowInfo->instancingShader);
+        if (shadowInfo->batchingShader) resolve(se::PoolType::SHADER, shadowInfo->batchingShader);
+        resolvePass(shadowInfo->getPlanarShadowPass());
+        resolvePass(shadowInfo->getInstancePass());
+        for (const auto *subModel : _planarShadowQueue->getPendingSubModels()) resolveSubModel(subModel);
+    }
+
+    const auto *batches = camera->getScene()->getUIBatches();
+    for (uint i = 1; i <= batches[0]; ++i) {
+        const auto *batch = GET_UI_BATCH(batches[i]);
+        resolve(se::PoolType::INPUT_ASSEMBLER, batch->inputAssemblerID);
+        resolve(se::PoolType::DESCRIPTOR_SETS, batch->descriptorSetID);
+        for (uint p = 0; p < batch->passCount; ++p) {
+            resolve(se::PoolType::SHADER, batch->shaderID[p]);
+            resolvePass(batch->getPassView(p));
+        }
+    }
+    return isResolved;
+}
+
+void ForwardStage::recordQueuesInParallel(Camera *camera, gfx::RenderPass *renderPass, gfx::Framebuffer *framebuffer) {
+    const auto frame = Application::getInstance()->getTotalFrames();
+    if (frame != _lastRecordingFrame) {
+        _lastRecordingFrame = frame;
+        _usedSecondaryCmdBuffSets = 0;
+    }
+
+    if (_usedSecondaryCmdBuffSets == _secondaryCmdBuffs.size()) {
+        gfx::CommandBufferList cmdBuffs(FORWARD_QUEUE_COUNT);
+        for (auto &cmdBuff : cmdBuffs) {
+            cmdBuff = _device->createCommandBuffer({_device->getQueue(), gfx::CommandBufferType::SECONDARY});
+        }
+        _secondaryCmdBuffs.emplace_back(std::move(cmdBuffs));
+    }
+    const auto &cmdBuffs = _secondaryCmdBuffs[_usedSecondaryCmdBuffSets++];
+
+    const gfx::Viewport viewport = {_renderArea.x, _renderArea.y, _renderArea.width, _renderArea.height, 0.0f, 1.0f};
+    auto record = [&](uint queueIndex) {
+        auto cmdBuff = cmdBuffs[queueIndex];
+        cmdBuff->begin(renderPass, 0, framebuffer);
+        cmdBuff->setViewport(viewport);
+        cmdBuff->setScissor(_renderArea);
+        cmdBuff->bindDescriptorSet(GLOBAL_SET, _pipeline->getDescriptorSet());
+        recordQueue(queueIndex, camera, renderPass, cmdBuff);
+        cmdBuff->end();
+    };
+
+    // the workers only see the objects resolved by resolveObjects()
+    se::ObjectPool::setScriptLocked(true);
+
+    auto threadPool = static_cast<ForwardPipeline *>(_pipeline)->getWorkerThreadPool();
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint pending = FORWARD_QUEUE_COUNT - 1;
+
+    for (uint i = 1; i < FORWARD_QUEUE_COUNT; ++i) {
+        threadPool->pushTask([&, i](int /*threadId*/) {
+            record(i);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pending == 0) cv.notify_one();
+        });
+    }
+
+    // the opaque queue is usually the largest, the calling thread records it instead of idling
+    record(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&pending]() { return pending == 0; });
+
+    se::ObjectPool::setScriptLocked(false);
+}
+
+GPUOcclusionQueries *ForwardStage::getOrCreateOcclusionQueries(const Camera *camera) {
+    auto &occlusionQueries = _occlusionQueries[camera];
+    if (!occlusionQueries) {
+        occlusionQueries = CC_NEW(GPUOcclusionQueries);
+        if (!occlusionQueries->initialize(_device)) {
+            CC_LOG_WARNING("GPU occlusion queries are not supported on this device.");
+            static_cast<ForwardPipeline *>(_pipeline)->setOcclusionQueries(false);
+            CC_SAFE_DELETE(occlusionQueries);
+            _occlusionQueries.erase(camera);
+            return nullptr;
+        }
+    }
+
+    const auto *pipeline = static_cast<ForwardPipeline *>(_pipeline);
+    occlusionQueries->setMinRadius(pipeline->getOcclusionQueryMinRadius());
+    occlusionQueries->setReprojectionDistance(pipeline->getOcclusionQueryReprojectionDistance());
+    return occlusionQueries;
+}
+
+DynamicResolution *ForwardStage::getOrCreateDynamicResolution(const Camera *camera) {
+    auto &dynamicResolution = _dynamicResolutions[camera];
+    if (!dynamicResolution) {
+        dynamicResolution = CC_NEW(DynamicResolution);
+        if (!dynamicResolution->initialize(_device)) {
+            CC_LOG_WARNING("Dynamic resolution is not supported on this device.");
+            static_cast<ForwardPipeline *>(_pipeline)->setDynamicResolution(false);
+            static_cast<ForwardPipeline *>(_pipeline)->setPerformanceScaling(false);
+            CC_SAFE_DELETE(dynamicResolution);
+            _dynamicResolutions.erase(camera);
+            return nullptr;
+        }
+    }
+    return dynamicResolution;
+}
+
 } // namespace pipeline
 } // namespace cc
@@ -9,6 +9,9 @@ class RenderFlow;
 class RenderBatchedQueue;
 class RenderInstancedQueue;
 class RenderAdditiveLightQueue;
+class ClusterLightCulling;
+class DynamicResolution;
+class GPUOcclusionQueries;
 class PlanarShadowQueue;
 class ForwardPipeline;
 class UIPhase;
@@ -27,15 +30,37 @@ public:
     virtual void render(Camera *camera) override;
 
 private:
+    void recordQueue(uint queueIndex, Camera *camera, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff);
+    bool resolveObjects(const Camera *camera);
+    void recordQueuesInParallel(Camera *camera, gfx::RenderPass *renderPass, gfx::Framebuffer *framebuffer);
+    GPUOcclusionQueries *getOrCreateOcclusionQueries(const Camera *camera);
+    DynamicResolution *getOrCreateDynamicResolution(const Camera *camera);
+
     static RenderStageInfo _initInfo;
     ForwardPipeline *_forwrdPipeline = nullptr;
     PlanarShadowQueue *_planarShadowQueue = nullptr;
     RenderBatchedQueue *_batchedQueue = nullptr;
     RenderInstancedQueue *_instancedQueue = nullptr;
     RenderAdditiveLightQueue *_additiveLightQueue = nullptr;
+    ClusterLightCulling *_clusterLightCulling = nullptr;
     UIPhase *_uiPhase = nullptr;
     gfx::Rect _renderArea;
     uint _phaseID = 0;
+    bool _isDepthPrepass = false; // for the camera being rendered
+
+    // results of the queries only apply to the camera that issued them
+    std::unordered_map<const Camera *, GPUOcclusionQueries *> _occlusionQueries;
+    GPUOcclusionQueries *_currentOcclusionQueries = nullptr;
+
+    // offscreen targets of the cameras drawn below native resolution
+    std::unordered_map<const Camera *, DynamicResolution *> _dynamicResolutions;
+
+    // one set of secondary command buffers per camera rendered in the current frame,
+    // a set can not be recorded again before the primary command buffer is submitted
+    vector<gfx::CommandBufferList> _secondaryCmdBuffs;
+    uint _usedSecondaryCmdBuffSets = 0;
+    uint _lastRecordingFrame = 0xffffffff;
+    uint _lastResolvingFrame = 0xffffffff;
 };
 
 } // namespace pipeline
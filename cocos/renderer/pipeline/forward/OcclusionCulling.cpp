@@ -0,0 +1,188 @@
+#include <cfloat>
+#include <condition_variable>
+#include <mutex>
+
+#include "OcclusionCulling.h"
+
+#include "ForwardPipeline.h"
+#include "base/ThreadPool.h"
+#include "math/MathUtil.h"
+
+namespace cc {
+namespace pipeline {
+
+void OcclusionCulling::resize(uint width, uint height) {
+    _width = std::max(width, 1u);
+    _height = std::max(height, 1u);
+}
+
+void OcclusionCulling::rasterize(ForwardPipeline *pipeline, const Camera *camera) {
+    _matViewProj = camera->matViewProj;
+    _triangles.clear();
+    _depths.resize(_width * _height);
+
+    const auto visibility = camera->visibility;
+    const auto *frustum = camera->getFrustum();
+    Mat4 matWorldViewProj;
+    for (const auto &pair : pipeline->getOccluders()) {
+        const auto *model = GET_MODEL(pair.first);
+        if (!model->enabled) continue;
+
+        const auto *node = model->getNode();
+        if (!(model->nodeID && ((visibility & node->layer) == node->layer)) && !(visibility & model->visFlags)) continue;
+        if (model->worldBoundsID && !aabb_frustum(model->getWorldBounds(), frustum)) continue;
+
+        const auto *transform = model->transformID ? model->getTransform() : node;
+        if (!transform) continue;
+        Mat4::multiply(_matViewProj, transform->worldMatrix, &matWorldViewProj);
+        setupTriangles(pair.second, matWorldViewProj);
+    }
+
+    if (_triangles.empty()) return;
+
+    if (pipeline->getWorkerThreadPool() && _height > BAND_HEIGHT) {
+        rasterizeBandsInParallel(pipeline);
+    } else {
+        rasterizeBand(0, _height);
+    }
+}
+
+void OcclusionCulling::setupTriangles(const OccluderMesh &mesh, const Mat4 &matWorldViewProj) {
+    const auto &positions = mesh.positions;
+    const size_t vertexCount = positions.size() / 3;
+    _clipPositions.resize(vertexCount);
+    matWorldViewProj.transformPoints(reinterpret_cast<const Vec3 *>(positions.data()), _clipPositions.data(), vertexCount);
+
+    const float halfWidth = _width * 0.5f;
+    const float halfHeight = _height * 0.5f;
+    const auto &indices = mesh.indices;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        float x[3], y[3];
+        float depth = -FLT_MAX;
+        bool isBehind = false;
+        for (uint v = 0; v < 3; v++) {
+            const auto &clip = _clipPositions[indices[i + v]];
+            // triangles crossing the camera plane are dropped, which only loses occlusion
+            if (clip.w < MIN_CLIP_W) {
+                isBehind = true;
+                break;
+            }
+            const float invW = 1.0f / clip.w;
+            x[v] = (clip.x * invW + 1.0f) * halfWidth;
+            y[v] = (clip.y * invW + 1.0f) * halfHeight;
+            depth = std::max(depth, clip.z * invW);
+        }
+        if (isBehind) continue;
+
+        // wind counter clockwise so that all edge functions are positive inside
+        const float area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+        if (std::abs(area) < FLT_EPSILON) continue;
+        if (area < 0.0f) {
+            std::swap(x[1], x[2]);
+            std::swap(y[1], y[2]);
+        }
+
+        // pixels are covered when their center is inside
+        Triangle triangle;
+        triangle.minX = std::max((int)std::ceil(std::min({x[0], x[1], x[2]}) - 0.5f), 0);
+        triangle.maxX = std::min((int)std::floor(std::max({x[0], x[1], x[2]}) - 0.5f), (int)_width - 1);
+        triangle.minY = std::max((int)std::ceil(std::min({y[0], y[1], y[2]}) - 0.5f), 0);
+        triangle.maxY = std::min((int)std::floor(std::max({y[0], y[1], y[2]}) - 0.5f), (int)_height - 1);
+        if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY) continue;
+
+        for (uint e = 0; e < 3; e++) {
+            const uint next = (e + 1) % 3;
+            triangle.a[e] = y[e] - y[next];
+            triangle.b[e] = x[next] - x[e];
+            triangle.c[e] = -triangle.a[e] * x[e] - triangle.b[e] * y[e];
+        }
+        triangle.depth = depth;
+        _triangles.emplace_back(triangle);
+    }
+}
+
+void OcclusionCulling::rasterizeBand(uint beginRow, uint endRow) {
+    std::fill(_depths.begin() + beginRow * _width, _depths.begin() + endRow * _width, FLT_MAX);
+
+    for (const auto &triangle : _triangles) {
+        const int minY = std::max(triangle.minY, (int)beginRow);
+        const int maxY = std::min(triangle.maxY, (int)endRow - 1);
+        const float px = triangle.minX + 0.5f;
+        const uint count = triangle.maxX - triangle.minX + 1;
+        for (int y = minY; y <= maxY; y++) {
+            const float py = y + 0.5f;
+            MathUtil::rasterizeDepthSpan(_depths.data() + y * _width + triangle.minX, count,
+                                         triangle.a[0] * px + triangle.b[0] * py + triangle.c[0],
+                                         triangle.a[1] * px + triangle.b[1] * py + triangle.c[1],
+                                         triangle.a[2] * px + triangle.b[2] * py + triangle.c[2],
+                                         triangle.a[0], triangle.a[1], triangle.a[2], triangle.depth);
+        }
+    }
+}
+
+void OcclusionCulling::rasterizeBandsInParallel(ForwardPipeline *pipeline) {
+    auto threadPool = pipeline->getWorkerThreadPool();
+    const uint bandCount = (_height + BAND_HEIGHT - 1) / BAND_HEIGHT;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint pending = bandCount - 1;
+
+    // bands own disjoint rows, so no synchronization is needed while writing depths
+    for (uint band = 1; band < bandCount; ++band) {
+        threadPool->pushTask([&, band](int /*threadId*/) {
+            rasterizeBand(band * BAND_HEIGHT, std::min((band + 1) * BAND_HEIGHT, _height));
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pending == 0) cv.notify_one();
+        });
+    }
+
+    // the calling thread takes the first band instead of idling
+    rasterizeBand(0, std::min(BAND_HEIGHT, _height));
+
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&pending]() { return pending == 0; });
+}
+
+bool OcclusionCulling::isOccluded(const AABB *bounds) const {
+    if (_triangles.empty()) return false;
+
+    const float halfWidth = _width * 0.5f;
+    const float halfHeight = _height * 0.5f;
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    float depth = FLT_MAX;
+    Vec4 clip;
+    for (uint i = 0; i < 8; i++) {
+        const Vec3 corner(bounds->center.x + (i & 1 ? bounds->halfExtents.x : -bounds->halfExtents.x),
+                          bounds->center.y + (i & 2 ? bounds->halfExtents.y : -bounds->halfExtents.y),
+                          bounds->center.z + (i & 4 ? bounds->halfExtents.z : -bounds->halfExtents.z));
+        _matViewProj.transformVector(Vec4(corner.x, corner.y, corner.z, 1.0f), &clip);
+        // bounds reaching behind the camera surround it
+        if (clip.w < MIN_CLIP_W) return false;
+
+        const float invW = 1.0f / clip.w;
+        const float x = (clip.x * invW + 1.0f) * halfWidth;
+        const float y = (clip.y * invW + 1.0f) * halfHeight;
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+        depth = std::min(depth, clip.z * invW);
+    }
+
+    // every pixel the projected bounds touch has to be covered by something nearer
+    const int x0 = std::max((int)std::floor(minX), 0);
+    const int x1 = std::min((int)std::floor(maxX), (int)_width - 1);
+    const int y0 = std::max((int)std::floor(minY), 0);
+    const int y1 = std::min((int)std::floor(maxY), (int)_height - 1);
+    if (x0 > x1 || y0 > y1) return false;
+
+    for (int y = y0; y <= y1; y++) {
+        if (!MathUtil::isDepthSpanOccluded(_depths.data() + y * _width + x0, x1 - x0 + 1, depth)) return false;
+    }
+    return true;
+}
+
+} // namespace pipeline
+} // namespace cc
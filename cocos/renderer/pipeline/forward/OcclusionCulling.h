@@ -0,0 +1,66 @@
+#pragma once
+
+#include "../Define.h"
+#include "../helper/SharedMemory.h"
+#include "math/Mat4.h"
+
+namespace cc {
+namespace pipeline {
+class ForwardPipeline;
+
+// Low poly triangle mesh standing in for a model while rasterizing occluders,
+// positions are in the local space of the model's transform.
+struct CC_DLL OccluderMesh {
+    vector<float> positions; // xyz per vertex
+    vector<uint> indices;    // 3 per triangle
+};
+
+// Rasterizes the occluder meshes visible to a camera into a low resolution buffer of NDC depths and
+// rejects models whose world bounds lie completely behind it. Occluders write the farthest depth of
+// each triangle and occludees compare against the nearest depth of their bounds, which keeps the
+// test conservative without interpolating depth. The rows are split into bands rasterized on the
+// worker thread pool, the spans of a row are filled with SIMD.
+class CC_DLL OcclusionCulling : public Object {
+public:
+    static constexpr uint DEFAULT_WIDTH = 256;
+    static constexpr uint DEFAULT_HEIGHT = 128;
+
+    void resize(uint width, uint height);
+    void rasterize(ForwardPipeline *pipeline, const Camera *camera);
+    // Only valid after rasterize, safe to call from the culling worker threads.
+    bool isOccluded(const AABB *bounds) const;
+
+    CC_INLINE uint getWidth() const { return _width; }
+    CC_INLINE uint getHeight() const { return _height; }
+
+private:
+    struct Triangle {
+        // edge functions a * x + b * y + c, not negative inside
+        float a[3];
+        float b[3];
+        float c[3];
+        float depth = 0.0f;
+        int minX = 0;
+        int maxX = 0;
+        int minY = 0;
+        int maxY = 0;
+    };
+
+    void setupTriangles(const OccluderMesh &mesh, const Mat4 &matWorldViewProj);
+    void rasterizeBand(uint beginRow, uint endRow);
+    void rasterizeBandsInParallel(ForwardPipeline *pipeline);
+
+    static constexpr uint BAND_HEIGHT = 16;
+    // clip space w below which vertices count as behind the camera
+    static constexpr float MIN_CLIP_W = 1e-5f;
+
+    uint _width = DEFAULT_WIDTH;
+    uint _height = DEFAULT_HEIGHT;
+    vector<float> _depths;
+    vector<Triangle> _triangles;
+    vector<Vec4> _clipPositions;
+    Mat4 _matViewProj;
+};
+
+} // namespace pipeline
+} // namespace cc
@@ -1,10 +1,19 @@
 #include <vector>
 #include <array>
+#include <cfloat>
+#include <condition_variable>
+#include <mutex>
 
 #include "SceneCulling.h"
 #include "../Define.h"
 #include "../helper/SharedMemory.h"
+#include "../helper/ModelBVH.h"
+#include "../helper/ModelCullingData.h"
+#include "../helper/TextureStreamer.h"
 #include "ForwardPipeline.h"
+#include "OcclusionCulling.h"
+#include "base/FrameStats.h"
+#include "base/ThreadPool.h"
 #include "gfx/GFXBuffer.h"
 #include "gfx/GFXDescriptorSet.h"
 #include "math/Quaternion.h"
@@ -15,6 +24,20 @@ namespace pipeline {
 bool castBoundsInitialized = false;
 AABB castWorldBounds;
 
+namespace {
+// Models are culled in chunks of this size when parallel culling is enabled,
+// small scenes are culled serially since dispatching costs more than it saves.
+constexpr uint PARALLEL_CULLING_CHUNK_SIZE = 512;
+
+// The skybox goes after the models at the greatest depth, so the opaque queue draws it last among passes of its
+// priority and its far plane fragments fail the early depth test wherever geometry already covers them.
+void addSkybox(const Skybox *skyBox, const Camera *camera, RenderObjectList &renderObjects) {
+    if (skyBox->enabled && skyBox->modelID && (camera->clearFlag & SKYBOX_FLAG)) {
+        renderObjects.push_back({FLT_MAX, skyBox->getModel()});
+    }
+}
+} // namespace
+
 RenderObject genRenderObject(const ModelView *model, const Camera *camera) {
     float depth = 0;
     if (model->nodeID) {
@@ -155,9 +178,9 @@ void updateDirLight(Shadows *shadows, const Light *light, std::array<float, UBOS
     memcpy(shadowUBO.data() + UBOShadow::MAT_LIGHT_PLANE_PROJ_OFFSET, matLight.m, sizeof(matLight));
 }
 
- void lightCollecting(Camera *camera, std::vector<const Light *>& validLights) {
+void lightCollecting(Camera *camera, std::vector<const Light *> &validLights) {
     validLights.clear();
-    auto *sphere = CC_NEW(Sphere);
+    Sphere sphere;
     const auto scene = camera->getScene();
     const Light *mainLight = nullptr;
     if (scene->mainLightID) mainLight = scene->getMainLight();
@@ -167,14 +190,12 @@ void updateDirLight(Shadows *shadows, const Light *light, std::array<float, UBOS
     const auto count = spotLightArrayID ? spotLightArrayID[0] : 0;
     for (uint32_t i = 1; i <= count; ++i) {
         const auto *spotLight = scene->getSpotLight(spotLightArrayID[i]);
-        sphere->center.set(spotLight->position);
-        sphere->radius = spotLight->range;
-        if (sphere->interset(*camera->getFrustum())) {
+        sphere.center.set(spotLight->position);
+        sphere.radius = spotLight->range;
+        if (sphere.interset(*camera->getFrustum())) {
             validLights.emplace_back(spotLight);
         }
     }
-
-    CC_SAFE_DELETE(sphere);
 }
 
 void shadowCollecting(ForwardPipeline *pipeline, Camera *camera) {
@@ -182,7 +203,25 @@ void shadowCollecting(ForwardPipeline *pipeline, Camera *camera) {
 
     castBoundsInitialized = false;
 
-    RenderObjectList shadowObjects;
+    auto &shadowObjects = pipeline->getShadowObjects();
+    shadowObjects.clear();
+
+    if (pipeline->isPackedCulling()) {
+        auto *cullingData = pipeline->getModelCullingData(scene);
+        cullingData->update(scene, Application::getInstance()->getTotalFrames());
+        const auto visibility = camera->visibility;
+        for (const auto &packed : cullingData->getModels()) {
+            if (!(packed.flags & PackedModel::CAST_SHADOW) || !(packed.flags & PackedModel::HAS_BOUNDS) || !packed.isVisible(visibility)) continue;
+            if (!castBoundsInitialized) {
+                castWorldBounds = packed.worldBounds;
+                castBoundsInitialized = true;
+            }
+            castWorldBounds.merge(packed.worldBounds);
+            shadowObjects.emplace_back(genRenderObject(GET_MODEL(packed.handle), camera));
+        }
+        pipeline->getSphere()->define(castWorldBounds);
+        return;
+    }
 
     const auto models = scene->getModels();
     const auto modelCount = models[0];
@@ -209,32 +248,107 @@ void shadowCollecting(ForwardPipeline *pipeline, Camera *camera) {
     }
 
     pipeline->getSphere()->define(castWorldBounds);
+}
 
-    pipeline->setShadowObjects(shadowObjects);
+namespace {
+struct CullingContext {
+    const Camera *camera = nullptr;
+    const OcclusionCulling *occlusion = nullptr;
+    // nullptr when no model has a LOD group, entries are only looked up so workers can share it
+    std::unordered_map<uint, LODGroup> *lodGroups = nullptr;
+    float lodHysteresis = 0.0f;
+    // nullptr when no texture is streamed
+    TextureStreamer *textureStreamer = nullptr;
+};
+
+struct CullingCandidate {
+    const ModelView *model = nullptr;
+    uint handle = 0;
+    int boundsIndex = -1; // index into the AABBBatch, -1 for models without world bounds
+};
+
+// Fraction of the screen height covered by the bounding sphere of the world bounds.
+float getScreenSize(const Camera *camera, const AABB *bounds, float depth) {
+    const auto &matProj = camera->matProj;
+    const float scale = matProj.m[11] ? matProj.m[5] / std::max(depth, 1e-3f) : matProj.m[5];
+    return std::min(bounds->halfExtents.length() * scale, 1.0f);
 }
 
-void sceneCulling(ForwardPipeline *pipeline, Camera *camera) {
-    const auto shadows = pipeline->getShadows();
-    const auto skyBox = pipeline->getSkybox();
-    const auto scene = camera->getScene();
+// Moves away from the current level only once the screen size passes the threshold by the hysteresis,
+// so models resting close to one don't switch meshes every frame.
+uint selectLODLevel(const LODGroup &group, float screenSize, float hysteresis) {
+    const auto &screenSizes = group.screenSizes;
+    const uint levelCount = static_cast<uint>(screenSizes.size());
+    uint level = std::min(group.level, levelCount);
+    while (level < levelCount && screenSize < screenSizes[level] * (1.0f - hysteresis)) ++level;
+    while (level > 0 && screenSize >= screenSizes[level - 1] * (1.0f + hysteresis)) --level;
+    return level;
+}
 
-    const Light *mainLight = nullptr;
-    if (scene->mainLightID) mainLight = scene->getMainLight();
-    RenderObjectList renderObjects;
+// Returns false when the model is culled below the last level.
+bool updateLODGroup(const CullingContext &context, const CullingCandidate &candidate, float depth) {
+    auto iter = context.lodGroups->find(candidate.handle);
+    if (iter == context.lodGroups->end() || !candidate.model->worldBoundsID) return true;
+
+    auto &group = iter->second;
+    const float screenSize = getScreenSize(context.camera, candidate.model->getWorldBounds(), depth);
+    const uint level = selectLODLevel(group, screenSize, context.lodHysteresis);
+    const uint levelCount = static_cast<uint>(group.screenSizes.size());
+    if (level != group.level && level < levelCount) {
+        const size_t subModelCount = group.subModels.size();
+        const size_t first = level * subModelCount;
+        for (size_t i = 0; i < subModelCount; ++i) {
+            auto *subModel = GET_SUBMODEL(group.subModels[i]);
+            subModel->subMeshID = group.subMeshes[first + i];
+            subModel->inputAssemblerID = group.inputAssemblers[first + i];
+        }
+    }
+    // culled models keep the handles of the last level they were drawn with
+    if (level < levelCount || group.level == UINT_MAX) group.level = level;
+    return level < levelCount;
+}
 
-    if (skyBox->enabled && skyBox->modelID && (camera->clearFlag & SKYBOX_FLAG)) {
-        renderObjects.emplace_back(genRenderObject(skyBox->getModel(), camera));
+void flushCullingCandidates(const CullingContext &context, AABBBatch &batch, CullingCandidate *candidates, uint &candidateCount, RenderObjectList &renderObjects) {
+    const auto *camera = context.camera;
+    const auto *occlusion = context.occlusion;
+    uint8_t visible[AABBBatch::CAPACITY];
+    if (batch.count) aabb_frustum_batch(batch, camera->getFrustum(), visible);
+
+    const auto objectCount = renderObjects.size();
+    for (uint i = 0; i < candidateCount; i++) {
+        const auto &candidate = candidates[i];
+        if (candidate.boundsIndex >= 0 && !visible[candidate.boundsIndex]) continue;
+        // occlusion is tested after the frustum, it is the more expensive one
+        if (occlusion && candidate.model->worldBoundsID && occlusion->isOccluded(candidate.model->getWorldBounds())) continue;
+        const auto renderObject = genRenderObject(candidate.model, camera);
+        if (context.lodGroups && !updateLODGroup(context, candidate, renderObject.depth)) continue;
+        if (context.textureStreamer && candidate.model->worldBoundsID) {
+            const float screenSize = getScreenSize(camera, candidate.model->getWorldBounds(), renderObject.depth);
+            context.textureStreamer->requestModel(candidate.model, screenSize * camera->height);
+        }
+        renderObjects.emplace_back(renderObject);
     }
+    CC_FRAME_STAT_ADD(CULLED_MODELS, candidateCount - (renderObjects.size() - objectCount));
 
-    const auto models = scene->getModels();
-    const auto modelCount = models[0];
-    for (size_t i = 1; i <= modelCount; i++) {
+    batch.clear();
+    candidateCount = 0;
+}
+
+void cullModels(const Scene *scene, const CullingContext &context, const uint *models, uint begin, uint end, bool testBounds, RenderObjectList &renderObjects) {
+    const auto *camera = context.camera;
+    const auto visibility = camera->visibility;
+    const auto vis = visibility & static_cast<uint>(LayerList::UI_2D);
+
+    // frustum tests are deferred and run a whole batch of world bounds at once
+    AABBBatch batch;
+    CullingCandidate candidates[AABBBatch::CAPACITY];
+    uint candidateCount = 0;
+
+    for (uint i = begin; i < end; i++) {
         const auto model = scene->getModelView(models[i]);
 
         // filter model by view visibility
         if (model->enabled) {
-            const auto visibility = camera->visibility;
-            const auto vis = visibility & static_cast<uint>(LayerList::UI_2D);
             const auto node = model->getNode();
             if (vis) {
                 if ((model->nodeID && (visibility == node->layer)) ||
@@ -245,18 +359,296 @@ void sceneCulling(ForwardPipeline *pipeline, Camera *camera) {
                 if ((model->nodeID && ((visibility & node->layer) == node->layer)) ||
                     (visibility & model->visFlags)) {
 
-                    // frustum culling
-                    if ((model->worldBoundsID) && !aabb_frustum(model->getWorldBounds(), camera->getFrustum())) {
-                        continue;
+                    auto &candidate = candidates[candidateCount++];
+                    candidate.model = model;
+                    candidate.handle = models[i];
+                    candidate.boundsIndex = -1;
+                    if (testBounds && model->worldBoundsID) {
+                        candidate.boundsIndex = static_cast<int>(batch.count);
+                        batch.add(model->getWorldBounds());
                     }
 
-                    renderObjects.emplace_back(genRenderObject(model, camera));
+                    if (candidateCount == AABBBatch::CAPACITY) {
+                        flushCullingCandidates(context, batch, candidates, candidateCount, renderObjects);
+                    }
                 }
             }
         }
     }
 
-    pipeline->setRenderObjects(renderObjects);
+    if (candidateCount) {
+        flushCullingCandidates(context, batch, candidates, candidateCount, renderObjects);
+    }
+}
+
+// cullModels() over the packed entries [begin, end), only the models left for the frustum test are looked up
+void cullPackedModels(const CullingContext &context, const PackedModel *models, uint begin, uint end, RenderObjectList &renderObjects) {
+    const auto *camera = context.camera;
+    const auto visibility = camera->visibility;
+    const auto vis = visibility & static_cast<uint>(LayerList::UI_2D);
+
+    AABBBatch batch;
+    CullingCandidate candidates[AABBBatch::CAPACITY];
+    uint candidateCount = 0;
+
+    for (uint i = begin; i < end; i++) {
+        const auto &packed = models[i];
+        if (!(packed.flags & PackedModel::ENABLED)) continue;
+
+        if (vis) {
+            if (((packed.flags & PackedModel::HAS_NODE) && visibility == packed.layer) || visibility == packed.visFlags) {
+                renderObjects.emplace_back(genRenderObject(GET_MODEL(packed.handle), camera));
+            }
+        } else if (packed.isVisible(visibility)) {
+            auto &candidate = candidates[candidateCount++];
+            candidate.model = GET_MODEL(packed.handle);
+            candidate.handle = packed.handle;
+            candidate.boundsIndex = -1;
+            if (packed.flags & PackedModel::HAS_BOUNDS) {
+                candidate.boundsIndex = static_cast<int>(batch.count);
+                batch.add(&packed.worldBounds);
+            }
+
+            if (candidateCount == AABBBatch::CAPACITY) {
+                flushCullingCandidates(context, batch, candidates, candidateCount, renderObjects);
+            }
+        }
+    }
+
+    if (candidateCount) {
+        flushCullingCandidates(context, batch, candidates, candidateCount, renderObjects);
+    }
+}
+
+// packedModels replaces the handles when packed culling is on, its entry i is the model of handle i + 1
+void parallelCullModels(ForwardPipeline *pipeline, const Scene *scene, const CullingContext &context, const uint *models, const PackedModel *packedModels, uint modelCount, RenderObjectList &renderObjects) {
+    auto threadPool = pipeline->getWorkerThreadPool();
+    const uint chunkCount = (modelCount + PARALLEL_CULLING_CHUNK_SIZE - 1) / PARALLEL_CULLING_CHUNK_SIZE;
+    auto &chunkResults = pipeline->getCullingChunkResults();
+    if (chunkResults.size() < chunkCount) chunkResults.resize(chunkCount);
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint pending = chunkCount - 1;
+
+    // model handles start from index 1, the first element is the count
+    for (uint chunk = 1; chunk < chunkCount; ++chunk) {
+        const uint begin = 1 + chunk * PARALLEL_CULLING_CHUNK_SIZE;
+        const uint end = std::min(begin + PARALLEL_CULLING_CHUNK_SIZE, modelCount + 1);
+        threadPool->pushTask([&, chunk, begin, end](int /*threadId*/) {
+            auto &result = chunkResults[chunk];
+            result.clear();
+            if (packedModels) {
+                cullPackedModels(context, packedModels, begin - 1, end - 1, result);
+            } else {
+                cullModels(scene, context, models, begin, end, true, result);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pending == 0) cv.notify_one();
+        });
+    }
+
+    // the calling thread takes the first chunk instead of idling
+    chunkResults[0].clear();
+    const uint firstEnd = std::min(1 + PARALLEL_CULLING_CHUNK_SIZE, modelCount + 1);
+    if (packedModels) {
+        cullPackedModels(context, packedModels, 0, firstEnd - 1, chunkResults[0]);
+    } else {
+        cullModels(scene, context, models, 1, firstEnd, true, chunkResults[0]);
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&pending]() { return pending == 0; });
+    }
+
+    // merge in chunk order so the result is identical to serial culling
+    for (uint chunk = 0; chunk < chunkCount; ++chunk) {
+        const auto &result = chunkResults[chunk];
+        renderObjects.insert(renderObjects.end(), result.begin(), result.end());
+    }
+}
+} // namespace
+
+void sceneCulling(ForwardPipeline *pipeline, Camera *camera) {
+    const auto shadows = pipeline->getShadows();
+    const auto skyBox = pipeline->getSkybox();
+    const auto scene = camera->getScene();
+
+    const Light *mainLight = nullptr;
+    if (scene->mainLightID) mainLight = scene->getMainLight();
+    auto &renderObjects = pipeline->getRenderObjects();
+    renderObjects.clear();
+
+    if (pipeline->isMultiViewCulling()) {
+        const auto &results = pipeline->getCameraCullingResults();
+        const auto iter = results.find(camera);
+        if (iter != results.end() && iter->second.frame == Application::getInstance()->getTotalFrames()) {
+            renderObjects = iter->second.renderObjects;
+            CC_FRAME_STAT_ADD(VISIBLE_MODELS, renderObjects.size());
+            return;
+        }
+    }
+
+    const auto models = scene->getModels();
+    const auto modelCount = models[0];
+    const bool isUICamera = camera->visibility & static_cast<uint>(LayerList::UI_2D);
+    auto *occlusion = isUICamera ? nullptr : pipeline->getOcclusionCulling(camera);
+    if (occlusion) occlusion->rasterize(pipeline, camera);
+
+    CullingContext context;
+    context.camera = camera;
+    context.occlusion = occlusion;
+    auto &lodGroups = pipeline->getLODGroups();
+    if (!lodGroups.empty() && !isUICamera) context.lodGroups = &lodGroups;
+    context.lodHysteresis = pipeline->getLODHysteresis();
+    auto *textureStreamer = pipeline->getTextureStreamer();
+    if (textureStreamer && !textureStreamer->isEmpty() && !isUICamera) context.textureStreamer = textureStreamer;
+    if (pipeline->isSpatialIndex() && !isUICamera) {
+        // the index rejects whole subtrees, the remaining models are already frustum tested
+        auto bvh = pipeline->getModelBVH(scene);
+        bvh->update(scene, Application::getInstance()->getTotalFrames());
+        auto &visibleHandles = pipeline->getVisibleModelHandles();
+        visibleHandles.clear();
+        bvh->query(camera->getFrustum(), visibleHandles);
+        CC_FRAME_STAT_ADD(CULLED_MODELS, modelCount - std::min(static_cast<uint>(visibleHandles.size()), modelCount));
+        cullModels(scene, context, visibleHandles.data(), 0, static_cast<uint>(visibleHandles.size()), false, renderObjects);
+    } else {
+        const PackedModel *packedModels = nullptr;
+        if (pipeline->isPackedCulling()) {
+            auto *cullingData = pipeline->getModelCullingData(scene);
+            cullingData->update(scene, Application::getInstance()->getTotalFrames());
+            packedModels = cullingData->getModels().data();
+        }
+        if (pipeline->isParallelCulling() && modelCount > PARALLEL_CULLING_CHUNK_SIZE) {
+            parallelCullModels(pipeline, scene, context, models, packedModels, modelCount, renderObjects);
+        } else if (packedModels) {
+            cullPackedModels(context, packedModels, 0, modelCount, renderObjects);
+        } else {
+            cullModels(scene, context, models, 1, modelCount + 1, true, renderObjects);
+        }
+    }
+    addSkybox(skyBox, camera, renderObjects);
+    CC_FRAME_STAT_ADD(VISIBLE_MODELS, renderObjects.size());
+}
+
+void multiViewCulling(ForwardPipeline *pipeline, const vector<uint> &cameras) {
+    auto &results = pipeline->getCameraCullingResults();
+    const auto *textureStreamer = pipeline->getTextureStreamer();
+    // these update per camera state as they cull, which a shared walk can't order
+    if (pipeline->isSpatialIndex() || !pipeline->getLODGroups().empty() || (textureStreamer && !textureStreamer->isEmpty())) {
+        results.clear();
+        return;
+    }
+
+    const uint frame = Application::getInstance()->getTotalFrames();
+    const auto *skyBox = pipeline->getSkybox();
+    // unchanged results are only known with the script side flagging its writes
+    const bool canReuse = pipeline->isPackedCulling() && !se::BufferPool::getPool(se::PoolType::MODEL)->hasDirty() &&
+                          !se::BufferPool::getPool(se::PoolType::NODE)->hasDirty() && !se::BufferPool::getPool(se::PoolType::AABB)->hasDirty();
+
+    // cameras of one scene share a walk, up to 32 to the bit mask
+    std::unordered_map<const Scene *, vector<Camera *>> sceneCameras;
+    std::unordered_map<const Camera *, CameraCullingResult> usedResults;
+    for (const auto cameraID : cameras) {
+        auto *camera = GET_CAMERA(cameraID);
+        if (pipeline->getOcclusionCulling(camera)) continue;
+        const auto *scene = camera->getScene();
+        auto iter = results.find(camera);
+        CameraCullingResult result;
+        if (iter != results.end()) result = std::move(iter->second);
+
+        const auto models = scene->getModels();
+        const auto &sceneHandles = pipeline->getCullingSceneHandles()[scene];
+        const bool isSceneUnchanged = canReuse && sceneHandles.size() == models[0] + 1 &&
+                                      !memcmp(sceneHandles.data(), models, sizeof(uint) * (models[0] + 1));
+        const bool isViewUnchanged = result.scene == scene && result.visibility == camera->visibility &&
+                                     result.clearFlag == camera->clearFlag && result.position == camera->position &&
+                                     !memcmp(result.matViewProj.m, camera->matViewProj.m, sizeof(camera->matViewProj.m));
+        if (isSceneUnchanged && isViewUnchanged && result.frame != UINT_MAX) {
+            result.frame = frame;
+        } else {
+            result.scene = scene;
+            result.matViewProj = camera->matViewProj;
+            result.position = camera->position;
+            result.visibility = camera->visibility;
+            result.clearFlag = camera->clearFlag;
+            result.frame = UINT_MAX; // culled below
+            result.renderObjects.clear();
+            sceneCameras[scene].emplace_back(camera);
+        }
+        usedResults.emplace(camera, std::move(result));
+    }
+
+    const PackedModel *packedModels = nullptr;
+    for (auto &pair : sceneCameras) {
+        const auto *scene = pair.first;
+        const auto models = scene->getModels();
+        const auto modelCount = models[0];
+        pipeline->getCullingSceneHandles()[scene].assign(models, models + modelCount + 1);
+        if (pipeline->isPackedCulling()) {
+            auto *cullingData = pipeline->getModelCullingData(scene);
+            cullingData->update(scene, frame);
+            packedModels = cullingData->getModels().data();
+        }
+
+        const auto &sceneCameraList = pair.second;
+        for (size_t first = 0; first < sceneCameraList.size(); first += 32) {
+            const uint cameraCount = static_cast<uint>(std::min<size_t>(32, sceneCameraList.size() - first));
+            Camera *const *views = &sceneCameraList[first];
+            CameraCullingResult *viewResults[32];
+            uint uiMask = 0;
+            for (uint c = 0; c < cameraCount; ++c) {
+                viewResults[c] = &usedResults[views[c]];
+                if (views[c]->visibility & static_cast<uint>(LayerList::UI_2D)) uiMask |= 1u << c;
+            }
+
+            PackedModel packed;
+            for (uint i = 0; i < modelCount; ++i) {
+                if (packedModels) {
+                    packed = packedModels[i];
+                } else {
+                    const auto *model = scene->getModelView(models[i + 1]);
+                    packed.handle = models[i + 1];
+                    packed.flags = model->enabled ? PackedModel::ENABLED : 0;
+                    if (!packed.flags) continue;
+                    packed.visFlags = model->visFlags;
+                    packed.layer = model->nodeID ? model->getNode()->layer : 0;
+                    if (model->nodeID) packed.flags |= PackedModel::HAS_NODE;
+                    if (model->worldBoundsID) {
+                        packed.flags |= PackedModel::HAS_BOUNDS;
+                        packed.worldBounds = *model->getWorldBounds();
+                    }
+                }
+                if (!(packed.flags & PackedModel::ENABLED)) continue;
+
+                // bit c is set for the views the model is drawn in
+                uint visibleMask = 0;
+                for (uint c = 0; c < cameraCount; ++c) {
+                    const auto visibility = views[c]->visibility;
+                    if (uiMask & (1u << c)) {
+                        if (((packed.flags & PackedModel::HAS_NODE) && visibility == packed.layer) || visibility == packed.visFlags) visibleMask |= 1u << c;
+                    } else if (packed.isVisible(visibility)) {
+                        if (!(packed.flags & PackedModel::HAS_BOUNDS) || aabb_frustum(&packed.worldBounds, views[c]->getFrustum())) visibleMask |= 1u << c;
+                    }
+                }
+                if (!visibleMask) continue;
+
+                const auto *model = GET_MODEL(packed.handle);
+                for (uint c = 0; c < cameraCount; ++c) {
+                    if (visibleMask & (1u << c)) viewResults[c]->renderObjects.emplace_back(genRenderObject(model, views[c]));
+                }
+            }
+            for (uint c = 0; c < cameraCount; ++c) {
+                addSkybox(skyBox, views[c], viewResults[c]->renderObjects);
+                viewResults[c]->frame = frame;
+            }
+        }
+    }
+
+    // cameras gone from the frame drop their results
+    results = std::move(usedResults);
 }
 
 } // namespace pipeline
@@ -1,5 +1,7 @@
 #pragma once
 #include "pipeline/Define.h"
+#include "math/Mat4.h"
+#include "math/Vec3.h"
 
 namespace cc {
 class Mat4;
@@ -10,17 +12,44 @@ namespace pipeline {
 struct RenderObject;
 struct Model;
 struct Camera;
+struct Scene;
 class ForwardPipeline;
 struct Sphere;
 struct Light;
 struct Sphere;
 struct Shadows;
 
+// Sub-mesh and input assembler handles for every sub-model of a model per level of detail, level-major.
+// Screen sizes are the fraction of the screen height the world bounds have to cover for a level to be
+// drawn, in descending order, the model is culled below the last one.
+struct CC_DLL LODGroup {
+    vector<float> screenSizes;
+    vector<uint> subModels;
+    vector<uint> subMeshes;
+    vector<uint> inputAssemblers;
+    uint level = UINT_MAX; // level the sub-models hold the handles of, UINT_MAX before the first selection
+};
+
+// Render objects multiViewCulling() found for a camera, with what it was culled against to tell when they can be
+// reused. sceneCulling() takes them as they are in the frame they were found.
+struct CC_DLL CameraCullingResult {
+    RenderObjectList renderObjects;
+    const Scene *scene = nullptr;
+    cc::Mat4 matViewProj;
+    cc::Vec3 position;
+    uint visibility = 0;
+    uint clearFlag = 0;
+    uint frame = UINT_MAX;
+};
+
 RenderObject genRenderObject(Model *, const Camera *);
 
 void lightCollecting(Camera *, std::vector<const Light *>&);
 void shadowCollecting(ForwardPipeline *, Camera *);
 void sceneCulling(ForwardPipeline *, Camera *);
+// Culls the cameras of a frame in one walk over the models of each scene, the cameras the models are visible to
+// kept as a bit mask. With packed culling on, cameras whose view and scene didn't change keep last frame's result.
+void multiViewCulling(ForwardPipeline *, const vector<uint> &cameras);
 void updateDirLight(Shadows *shadows, const Light *light, std::array<float, UBOShadow::COUNT>&);
 void getShadowWorldMatrix(const Sphere *sphere, const cc::Vec4 &rotation, const cc::Vec3 &dir, cc::Mat4 &shadowWorldMat, cc::Vec3 &out);
 } // namespace pipeline
@@ -2,6 +2,7 @@
 #include "ForwardPipeline.h"
 #include "pipeline/PipelineStateManager.h"
 #include "gfx/GFXCommandBuffer.h"
+#include "gfx/GFXInputAssembler.h"
 
 namespace cc {
 namespace pipeline {
@@ -11,41 +12,80 @@ void UIPhase::activate(RenderPipeline *pipeline){
     _phaseID = getPhaseID("default");
 };
 
-void UIPhase::render(Camera *camera, gfx::RenderPass *renderPass){
-    auto pipeline = static_cast<ForwardPipeline *>(_pipeline);
-    auto cmdBuff = pipeline->getCommandBuffers()[0];
+namespace {
+bool isBatchVisible(const Camera *camera, const UIBatch *batch) {
+    if (camera->visibility & static_cast<uint>(LayerList::UI_2D)) {
+        return camera->visibility == batch->visFlags;
+    }
+    return camera->visibility & batch->visFlags;
+}
 
+// Batches sharing the state of the previous one whose indices directly follow its range are drawn with it.
+bool canMergeBatches(const UIBatch *batch, const gfx::InputAssembler *ia, const UIBatch *next) {
+    if (next->passCount != 1 || next->passID[0] != batch->passID[0] || next->shaderID[0] != batch->shaderID[0] ||
+        next->descriptorSetID != batch->descriptorSetID) {
+        return false;
+    }
+    const auto *nextIA = next->getInputAssembler();
+    return ia->getIndexBuffer() && !ia->getIndirectBuffer() && !nextIA->getIndirectBuffer() &&
+           nextIA->getIndexBuffer() == ia->getIndexBuffer() && nextIA->getVertexBuffers() == ia->getVertexBuffers() &&
+           nextIA->getVertexOffset() == ia->getVertexOffset() && nextIA->getFirstIndex() == ia->getFirstIndex() + ia->getIndexCount();
+}
+} // namespace
+
+void UIPhase::render(Camera *camera, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff, uint subpass){
     auto batches = camera->getScene()->getUIBatches();
-    const auto vis = camera->visibility & static_cast<uint>(LayerList::UI_2D);
     const int batchCount = batches[0];
+    gfx::PipelineState *lastPSO = nullptr;
+    gfx::DescriptorSet *lastMaterialSet = nullptr;
+    gfx::DescriptorSet *lastLocalSet = nullptr;
+    gfx::InputAssembler *lastIA = nullptr;
     // Notice: The batches[0] is batchCount
     for (int i = 1; i <= batchCount; ++i) {
         const auto batch = GET_UI_BATCH(batches[i]);
-        bool visible = false;
-        if (vis) {
-            if (camera->visibility == batch->visFlags) {
-                visible = true;
-            }
-        } else {
-            if (camera->visibility & batch->visFlags) {
-                visible = true;
+        if (!isBatchVisible(camera, batch)) continue;
+
+        const int count = batch->passCount;
+        const auto inputAssembler = batch->getInputAssembler();
+        const auto ds = batch->getDescriptorSet();
+
+        // the index range of single pass batches grows over the compatible ones following them
+        const uint indexCount = inputAssembler->getIndexCount();
+        uint mergedIndexCount = indexCount;
+        if (count == 1) {
+            for (; i < batchCount; ++i) {
+                const auto next = GET_UI_BATCH(batches[i + 1]);
+                if (!isBatchVisible(camera, next) || !canMergeBatches(batch, inputAssembler, next)) break;
+                mergedIndexCount += next->getInputAssembler()->getIndexCount();
+                inputAssembler->setIndexCount(mergedIndexCount);
             }
         }
 
-        if (!visible) continue;
-        const int count = batch->passCount;
         for (int j = 0; j < count; j++) {
             const auto pass = batch->getPassView(j);
             const auto shader = batch->getShader(j);
-            const auto inputAssembler = batch->getInputAssembler();
-            const auto ds = batch->getDescriptorSet();
-            auto *pso = PipelineStateManager::getOrCreatePipelineState(pass, shader, inputAssembler, renderPass);
-            cmdBuff->bindPipelineState(pso);
-            cmdBuff->bindDescriptorSet(MATERIAL_SET, pass->getDescriptorSet());
-            cmdBuff->bindDescriptorSet(LOCAL_SET, ds);
-            cmdBuff->bindInputAssembler(inputAssembler);
+            auto *pso = PipelineStateManager::getOrCreatePipelineState(pass, shader, inputAssembler, renderPass, subpass);
+            if (!pso) continue;
+            if (pso != lastPSO) {
+                cmdBuff->bindPipelineState(pso);
+                lastPSO = pso;
+            }
+            if (pass->getDescriptorSet() != lastMaterialSet) {
+                cmdBuff->bindDescriptorSet(MATERIAL_SET, pass->getDescriptorSet());
+                lastMaterialSet = pass->getDescriptorSet();
+            }
+            if (ds != lastLocalSet) {
+                cmdBuff->bindDescriptorSet(LOCAL_SET, ds);
+                lastLocalSet = ds;
+            }
+            if (inputAssembler != lastIA) {
+                cmdBuff->bindInputAssembler(inputAssembler);
+                lastIA = inputAssembler;
+            }
             cmdBuff->draw(inputAssembler);
         }
+        // backends read the draw range while recording, the batch keeps its own one
+        if (mergedIndexCount != indexCount) inputAssembler->setIndexCount(indexCount);
     }
 }
 
@@ -8,7 +8,7 @@ class CC_DLL UIPhase {
 public:
     UIPhase () = default;
     void activate(RenderPipeline* pipeline);
-    void render(Camera *camera, gfx::RenderPass* renderPass);
+    void render(Camera *camera, gfx::RenderPass* renderPass, gfx::CommandBuffer *cmdBuff, uint subpass = 0);
 protected:
     RenderPipeline *_pipeline = nullptr;
     uint _phaseID = 0;
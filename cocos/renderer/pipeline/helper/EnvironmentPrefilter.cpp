@@ -0,0 +1,420 @@
+#include "EnvironmentPrefilter.h"
+#include "base/Log.h"
+#include "base/ThreadPool.h"
+#include "gfx/GFXDevice.h"
+#include "gfx/GFXTexture.h"
+#include "platform/FileUtils.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cc {
+namespace pipeline {
+namespace {
+constexpr uint CACHE_MAGIC = 0x564e4543; // 'CENV'
+constexpr uint CACHE_VERSION = 1;
+constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+constexpr float PI = 3.14159265358979f;
+
+struct CacheFileHeader {
+    uint magic = CACHE_MAGIC;
+    uint version = CACHE_VERSION;
+    uint64_t hash = 0;
+    uint size = 0;
+    uint levelCount = 0;
+    float sh[EnvironmentPrefilter::SH_FLOAT_COUNT] = {0.f};
+};
+
+struct Vec3 {
+    float x, y, z;
+};
+
+// FNV-1a, the hashes name files and have to stay the same across runs
+uint64_t hashBytes(uint64_t hash, const void *data, size_t size) {
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+std::string getCachePath(uint64_t hash) {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(hash));
+    return FileUtils::getInstance()->getWritablePath() + "environment_cache/" + name;
+}
+
+uint getLevelCount(uint size) {
+    uint count = 1;
+    while (size > 1) {
+        size >>= 1;
+        ++count;
+    }
+    return count;
+}
+
+// builtin shaders decode rgb * 2^(a * 255 - 128)
+void decode(const uint8_t *texel, bool isRGBE, float *rgb) {
+    if (isRGBE) {
+        const float scale = std::ldexp(1.f / 255.f, static_cast<int>(texel[3]) - 128);
+        for (uint c = 0; c < 3; ++c) rgb[c] = texel[c] * scale;
+    } else {
+        for (uint c = 0; c < 3; ++c) rgb[c] = std::pow(texel[c] / 255.f, 2.2f);
+    }
+}
+
+void encode(const float *rgb, bool isRGBE, uint8_t *texel) {
+    if (isRGBE) {
+        const float maxComponent = std::max({rgb[0], rgb[1], rgb[2]});
+        if (maxComponent < 1e-32f) {
+            texel[0] = texel[1] = texel[2] = texel[3] = 0;
+            return;
+        }
+        int exponent = 0;
+        std::frexp(maxComponent, &exponent);
+        exponent = std::min(std::max(exponent, -128), 127);
+        const float scale = std::ldexp(255.f, -exponent);
+        for (uint c = 0; c < 3; ++c) texel[c] = static_cast<uint8_t>(std::min(rgb[c] * scale + 0.5f, 255.f));
+        texel[3] = static_cast<uint8_t>(exponent + 128);
+    } else {
+        for (uint c = 0; c < 3; ++c) texel[c] = static_cast<uint8_t>(std::min(std::pow(std::max(rgb[c], 0.f), 1.f / 2.2f) * 255.f + 0.5f, 255.f));
+        texel[3] = 255;
+    }
+}
+
+Vec3 normalize(const Vec3 &v) {
+    const float length = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+    return {v.x / length, v.y / length, v.z / length};
+}
+
+// GL cube map conventions, s and t in [-1, 1] from the left and the top of the face
+Vec3 getDirection(uint face, float s, float t) {
+    switch (face) {
+        case 0: return {1.f, -t, -s};
+        case 1: return {-1.f, -t, s};
+        case 2: return {s, 1.f, t};
+        case 3: return {s, -1.f, -t};
+        case 4: return {s, -t, 1.f};
+        default: return {-s, -t, -1.f};
+    }
+}
+
+const float *sample(const vector<float> &level, uint size, const Vec3 &dir) {
+    const float ax = std::fabs(dir.x), ay = std::fabs(dir.y), az = std::fabs(dir.z);
+    uint face;
+    float s, t;
+    if (ax >= ay && ax >= az) {
+        face = dir.x > 0.f ? 0 : 1;
+        s = (dir.x > 0.f ? -dir.z : dir.z) / ax;
+        t = -dir.y / ax;
+    } else if (ay >= az) {
+        face = dir.y > 0.f ? 2 : 3;
+        s = dir.x / ay;
+        t = (dir.y > 0.f ? dir.z : -dir.z) / ay;
+    } else {
+        face = dir.z > 0.f ? 4 : 5;
+        s = (dir.z > 0.f ? dir.x : -dir.x) / az;
+        t = -dir.y / az;
+    }
+    const uint x = std::min(static_cast<uint>((s * 0.5f + 0.5f) * size), size - 1);
+    const uint y = std::min(static_cast<uint>((t * 0.5f + 0.5f) * size), size - 1);
+    return &level[((face * size + y) * size + x) * 3];
+}
+
+void projectSH(const vector<float> &texels, uint size, float *sh) {
+    std::fill(sh, sh + EnvironmentPrefilter::SH_FLOAT_COUNT, 0.f);
+    float weightSum = 0.f;
+    for (uint face = 0; face < 6; ++face) {
+        for (uint y = 0; y < size; ++y) {
+            const float t = (y + 0.5f) * 2.f / size - 1.f;
+            for (uint x = 0; x < size; ++x) {
+                const float s = (x + 0.5f) * 2.f / size - 1.f;
+                const float tmp = 1.f + s * s + t * t;
+                const float weight = 4.f / (size * size * tmp * std::sqrt(tmp));
+                const Vec3 n = normalize(getDirection(face, s, t));
+                const float basis[9] = {
+                    0.282095f,
+                    0.488603f * n.y,
+                    0.488603f * n.z,
+                    0.488603f * n.x,
+                    1.092548f * n.x * n.y,
+                    1.092548f * n.y * n.z,
+                    0.315392f * (3.f * n.z * n.z - 1.f),
+                    1.092548f * n.x * n.z,
+                    0.546274f * (n.x * n.x - n.y * n.y),
+                };
+                const float *rgb = &texels[((face * size + y) * size + x) * 3];
+                for (uint i = 0; i < 9; ++i) {
+                    for (uint c = 0; c < 3; ++c) sh[i * 3 + c] += rgb[c] * basis[i] * weight;
+                }
+                weightSum += weight;
+            }
+        }
+    }
+    // normalize the solid angles to 4 pi, then convolve with the clamped cosine
+    const float bands[9] = {PI, 2.f * PI / 3.f, 2.f * PI / 3.f, 2.f * PI / 3.f, PI / 4.f, PI / 4.f, PI / 4.f, PI / 4.f, PI / 4.f};
+    for (uint i = 0; i < 9; ++i) {
+        for (uint c = 0; c < 3; ++c) sh[i * 3 + c] *= 4.f * PI / weightSum * bands[i];
+    }
+}
+
+vector<float> downsample(const vector<float> &texels, uint size) {
+    const uint half = std::max(size >> 1, 1u);
+    vector<float> result(6 * half * half * 3);
+    for (uint face = 0; face < 6; ++face) {
+        for (uint y = 0; y < half; ++y) {
+            for (uint x = 0; x < half; ++x) {
+                float *dst = &result[((face * half + y) * half + x) * 3];
+                for (uint c = 0; c < 3; ++c) {
+                    const auto at = [&](uint sx, uint sy) { return texels[((face * size + std::min(sy, size - 1)) * size + std::min(sx, size - 1)) * 3 + c]; };
+                    dst[c] = (at(x * 2, y * 2) + at(x * 2 + 1, y * 2) + at(x * 2, y * 2 + 1) + at(x * 2 + 1, y * 2 + 1)) * 0.25f;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+// radical inverse of i for the second Hammersley coordinate
+float radicalInverse(uint bits) {
+    bits = (bits << 16u) | (bits >> 16u);
+    bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+    bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+    bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+    bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+    return static_cast<float>(bits) * 2.3283064365386963e-10f;
+}
+
+// the lobe of level i is sampled from source level i - 1, prefiltered close enough to the lobe to keep the
+// sample count low without aliasing
+void convolveGGX(const vector<float> &source, uint sourceSize, uint size, float roughness, vector<float> &result) {
+    const float a = roughness * roughness;
+    result.assign(6 * size * size * 3, 0.f);
+    for (uint face = 0; face < 6; ++face) {
+        for (uint y = 0; y < size; ++y) {
+            const float t = (y + 0.5f) * 2.f / size - 1.f;
+            for (uint x = 0; x < size; ++x) {
+                const float s = (x + 0.5f) * 2.f / size - 1.f;
+                const Vec3 n = normalize(getDirection(face, s, t));
+                const Vec3 up = std::fabs(n.z) < 0.999f ? Vec3{0.f, 0.f, 1.f} : Vec3{1.f, 0.f, 0.f};
+                const Vec3 tangentX = normalize({up.y * n.z - up.z * n.y, up.z * n.x - up.x * n.z, up.x * n.y - up.y * n.x});
+                const Vec3 tangentY = {n.y * tangentX.z - n.z * tangentX.y, n.z * tangentX.x - n.x * tangentX.z, n.x * tangentX.y - n.y * tangentX.x};
+
+                float *dst = &result[((face * size + y) * size + x) * 3];
+                float weightSum = 0.f;
+                for (uint i = 0; i < EnvironmentPrefilter::SAMPLE_COUNT; ++i) {
+                    const float phi = 2.f * PI * i / EnvironmentPrefilter::SAMPLE_COUNT;
+                    const float xi = radicalInverse(i);
+                    const float cosTheta = std::sqrt((1.f - xi) / (1.f + (a * a - 1.f) * xi));
+                    const float sinTheta = std::sqrt(1.f - cosTheta * cosTheta);
+                    const float hx = sinTheta * std::cos(phi), hy = sinTheta * std::sin(phi);
+                    const Vec3 h = {tangentX.x * hx + tangentY.x * hy + n.x * cosTheta,
+                                    tangentX.y * hx + tangentY.y * hy + n.y * cosTheta,
+                                    tangentX.z * hx + tangentY.z * hy + n.z * cosTheta};
+                    // N = V = R
+                    const float vDotH = n.x * h.x + n.y * h.y + n.z * h.z;
+                    const Vec3 l = {2.f * vDotH * h.x - n.x, 2.f * vDotH * h.y - n.y, 2.f * vDotH * h.z - n.z};
+                    const float nDotL = n.x * l.x + n.y * l.y + n.z * l.z;
+                    if (nDotL <= 0.f) continue;
+                    const float *rgb = sample(source, sourceSize, l);
+                    for (uint c = 0; c < 3; ++c) dst[c] += rgb[c] * nDotL;
+                    weightSum += nDotL;
+                }
+                if (weightSum > 0.f) {
+                    for (uint c = 0; c < 3; ++c) dst[c] /= weightSum;
+                }
+            }
+        }
+    }
+}
+
+uint64_t getJobHash(const vector<uint8_t> &faces, uint size, bool isRGBE) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    hash = hashBytes(hash, &CACHE_VERSION, sizeof(CACHE_VERSION));
+    hash = hashBytes(hash, &size, sizeof(size));
+    hash = hashBytes(hash, &isRGBE, sizeof(isRGBE));
+    return hashBytes(hash, faces.data(), faces.size());
+}
+
+uint getLevelBytes(uint size, uint level) {
+    const uint levelSize = std::max(size >> level, 1u);
+    return 6 * levelSize * levelSize * 4;
+}
+} // namespace
+
+EnvironmentPrefilter *EnvironmentPrefilter::_instance = nullptr;
+
+EnvironmentPrefilter *EnvironmentPrefilter::getInstance() {
+    if (!_instance) _instance = CC_NEW(EnvironmentPrefilter);
+    return _instance;
+}
+
+void EnvironmentPrefilter::destroyInstance() {
+    CC_SAFE_DELETE(_instance);
+}
+
+EnvironmentPrefilter::EnvironmentPrefilter() {
+    _threadPool = ThreadPool::newSingleThreadPool();
+}
+
+EnvironmentPrefilter::~EnvironmentPrefilter() {
+    // waits for the job running
+    CC_SAFE_DELETE(_threadPool);
+    for (auto *job : _jobs) CC_DELETE(job);
+    _jobs.clear();
+}
+
+void EnvironmentPrefilter::prefilter(gfx::Texture *texture, const uint8_t *faces, uint size, bool isRGBE) {
+    if (!texture || !faces || !size) return;
+    cancel(texture);
+
+    auto *job = CC_NEW(Job);
+    job->texture = texture;
+    job->size = size;
+    job->isRGBE = isRGBE;
+    job->faces.assign(faces, faces + 6 * size * size * 4);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _jobs.push_back(job);
+    }
+    _threadPool->pushTask([this, job](int /*threadId*/) {
+        run(job);
+        std::lock_guard<std::mutex> lock(_mutex);
+        job->isFinished = true;
+    });
+}
+
+void EnvironmentPrefilter::cancel(gfx::Texture *texture) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto *job : _jobs) {
+        if (job->texture == texture) job->isCancelled = true;
+    }
+    _irradiance.erase(texture);
+}
+
+void EnvironmentPrefilter::update() {
+    vector<Job *> finishedJobs;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        const auto it = std::stable_partition(_jobs.begin(), _jobs.end(), [](const Job *job) { return !job->isFinished; });
+        finishedJobs.assign(it, _jobs.end());
+        _jobs.erase(it, _jobs.end());
+    }
+
+    for (auto *job : finishedJobs) {
+        if (!job->isCancelled && !job->levels.empty()) {
+            const uint levelCount = std::min(static_cast<uint>(job->levels.size()), job->texture->getLevelCount());
+            gfx::BufferDataList buffers;
+            gfx::BufferTextureCopyList regions(levelCount);
+            for (uint i = 0; i < levelCount; ++i) {
+                const uint levelSize = std::max(job->size >> i, 1u);
+                for (uint face = 0; face < 6; ++face) buffers.push_back(job->levels[i].data() + face * levelSize * levelSize * 4);
+                auto &region = regions[i];
+                region.texExtent.width = levelSize;
+                region.texExtent.height = levelSize;
+                region.texSubres.mipLevel = i;
+                region.texSubres.baseArrayLayer = 0;
+                region.texSubres.layerCount = 6;
+            }
+            gfx::Device::getInstance()->copyBuffersToTexture(buffers, job->texture, regions);
+
+            auto &sh = _irradiance[job->texture];
+            std::copy(job->sh, job->sh + SH_FLOAT_COUNT, sh.begin());
+        }
+        CC_DELETE(job);
+    }
+}
+
+const float *EnvironmentPrefilter::getIrradianceSH(gfx::Texture *texture) const {
+    const auto it = _irradiance.find(texture);
+    return it != _irradiance.end() ? it->second.data() : nullptr;
+}
+
+void EnvironmentPrefilter::run(Job *job) {
+    const uint size = job->size;
+    const uint levelCount = getLevelCount(size);
+    const uint64_t hash = getJobHash(job->faces, size, job->isRGBE);
+    auto *fileUtils = FileUtils::getInstance();
+    const std::string path = getCachePath(hash);
+
+    if (fileUtils->isFileExist(path)) {
+        const Data data = fileUtils->getDataFromFile(path);
+        CacheFileHeader header;
+        size_t expectedSize = sizeof(header);
+        for (uint i = 0; i < levelCount; ++i) expectedSize += getLevelBytes(size, i);
+        if (static_cast<size_t>(data.getSize()) == expectedSize) {
+            memcpy(&header, data.getBytes(), sizeof(header));
+        }
+        if (header.magic == CACHE_MAGIC && header.version == CACHE_VERSION && header.hash == hash &&
+            header.size == size && header.levelCount == levelCount) {
+            std::copy(header.sh, header.sh + SH_FLOAT_COUNT, job->sh);
+            const uint8_t *bytes = data.getBytes() + sizeof(header);
+            job->levels.resize(levelCount);
+            for (uint i = 0; i < levelCount; ++i) {
+                const uint levelBytes = getLevelBytes(size, i);
+                job->levels[i].assign(bytes, bytes + levelBytes);
+                bytes += levelBytes;
+            }
+            job->faces.clear();
+            return;
+        }
+        fileUtils->removeFile(path);
+    }
+
+    vector<float> source(6 * size * size * 3);
+    for (uint i = 0; i < 6 * size * size; ++i) decode(&job->faces[i * 4], job->isRGBE, &source[i * 3]);
+    projectSH(source, size, job->sh);
+
+    job->levels.resize(levelCount);
+    job->levels[0] = std::move(job->faces);
+    vector<float> chainLevel = std::move(source);
+    vector<float> convolved;
+    uint chainSize = size;
+    for (uint i = 1; i < levelCount; ++i) {
+        // the cancelled ones stop at the next level
+        if (job->isCancelled) return;
+        const uint levelSize = std::max(size >> i, 1u);
+        const float roughness = static_cast<float>(i) / (levelCount - 1);
+        convolveGGX(chainLevel, chainSize, levelSize, roughness, convolved);
+
+        auto &level = job->levels[i];
+        level.resize(getLevelBytes(size, i));
+        for (uint t = 0; t < 6 * levelSize * levelSize; ++t) encode(&convolved[t * 3], job->isRGBE, &level[t * 4]);
+
+        chainLevel = downsample(chainLevel, chainSize);
+        chainSize = levelSize;
+    }
+
+    CacheFileHeader header;
+    header.hash = hash;
+    header.size = size;
+    header.levelCount = levelCount;
+    std::copy(job->sh, job->sh + SH_FLOAT_COUNT, header.sh);
+    size_t fileSize = sizeof(header);
+    for (const auto &level : job->levels) fileSize += level.size();
+
+    // released by Data through free()
+    auto *buffer = static_cast<uint8_t *>(malloc(fileSize));
+    memcpy(buffer, &header, sizeof(header));
+    uint8_t *bytes = buffer + sizeof(header);
+    for (const auto &level : job->levels) {
+        memcpy(bytes, level.data(), level.size());
+        bytes += level.size();
+    }
+    Data data;
+    data.fastSet(buffer, static_cast<ssize_t>(fileSize));
+
+    const std::string directory = fileUtils->getWritablePath() + "environment_cache/";
+    if (!fileUtils->isDirectoryExist(directory)) fileUtils->createDirectory(directory);
+    // written aside first, a launch killed halfway leaves no truncated cache behind
+    const std::string tempPath = path + ".tmp";
+    if (!fileUtils->writeDataToFile(data, tempPath) || !fileUtils->renameFile(tempPath, path)) {
+        CC_LOG_WARNING("EnvironmentPrefilter: failed to write the cache %s.", path.c_str());
+        fileUtils->removeFile(tempPath);
+    }
+}
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "../Define.h"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+namespace cc {
+class ThreadPool;
+
+namespace gfx {
+class Texture;
+} // namespace gfx
+
+namespace pipeline {
+
+// Prefilters environment cube maps on a worker thread: the diffuse irradiance as L2 spherical harmonics, and a
+// specular mip chain whose level i is the environment convolved with the GGX lobe of roughness i / (levels - 1),
+// the roughness the builtin shaders pick their level of cc_environment by. Results are cached in the writable
+// path keyed on the hash of the faces, later launches load them instead of filtering again.
+//
+// The faces are RGBA8 in +X, -X, +Y, -Y, +Z, -Z order, RGBE encoded when the skybox is, and the levels are
+// written back in the same encoding. The irradiance is E(n) = sum(sh[i] * Y_i(n)), 9 RGB coefficients in the
+// order of the real basis Y00, Y1-1, Y10, Y11, Y2-2, Y2-1, Y20, Y21, Y22; divide by pi for a Lambertian surface.
+class CC_DLL EnvironmentPrefilter final : public Object {
+public:
+    static constexpr uint SH_FLOAT_COUNT = 27;
+    // GGX samples a texel of the chain is convolved with
+    static constexpr uint SAMPLE_COUNT = 64;
+
+    static EnvironmentPrefilter *getInstance();
+    static void destroyInstance();
+
+    EnvironmentPrefilter();
+    ~EnvironmentPrefilter();
+
+    // Filters faces, 6 * size * size texels, into the mip chain of the cube texture, which has to stay alive until
+    // the result is uploaded or the texture is cancelled. A texture filtered again drops the pending result.
+    void prefilter(gfx::Texture *texture, const uint8_t *faces, uint size, bool isRGBE);
+    void cancel(gfx::Texture *texture);
+    // Uploads the chains filtered since the last update, once a frame.
+    void update();
+
+    // nullptr until the texture is uploaded.
+    const float *getIrradianceSH(gfx::Texture *texture) const;
+
+private:
+    struct Job {
+        gfx::Texture *texture = nullptr;
+        std::atomic<bool> isCancelled{false}; // read by the worker between levels
+        bool isFinished = false;
+        uint size = 0;
+        bool isRGBE = false;
+        vector<uint8_t> faces;
+        float sh[SH_FLOAT_COUNT] = {0.f};
+        vector<vector<uint8_t>> levels; // 6 faces each
+    };
+
+    static void run(Job *job);
+
+    ThreadPool *_threadPool = nullptr;
+    std::mutex _mutex;
+    vector<Job *> _jobs;
+    std::unordered_map<gfx::Texture *, std::array<float, SH_FLOAT_COUNT>> _irradiance;
+
+    static EnvironmentPrefilter *_instance;
+};
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "core/CoreStd.h"
+
+namespace cc {
+namespace pipeline {
+
+// Open-addressing hash map with linear probing over a single slot array, for hot lookups on integral keys.
+// Entries can't be erased and references returned are invalidated when an insertion grows the table.
+template <typename K, typename V>
+class FlatHashMap final {
+public:
+    static constexpr size_t MIN_CAPACITY = 16;
+
+    V *find(K key) {
+        if (_slots.empty()) return nullptr;
+        for (size_t i = getSlotIndex(key);; i = (i + 1) & _mask) {
+            auto &slot = _slots[i];
+            if (!slot.occupied) return nullptr;
+            if (slot.key == key) return &slot.value;
+        }
+    }
+
+    // Inserts a value-initialized entry if the key is not present.
+    V &operator[](K key) {
+        // keep the load factor under 3/4 so that probe sequences stay short
+        if ((_size + 1) * 4 > _slots.size() * 3) rehash(std::max(MIN_CAPACITY, _slots.size() * 2));
+
+        for (size_t i = getSlotIndex(key);; i = (i + 1) & _mask) {
+            auto &slot = _slots[i];
+            if (!slot.occupied) {
+                slot.key = key;
+                slot.value = V();
+                slot.occupied = true;
+                ++_size;
+                return slot.value;
+            }
+            if (slot.key == key) return slot.value;
+        }
+    }
+
+    void clear() {
+        _slots.clear();
+        _size = 0;
+        _mask = 0;
+    }
+
+    CC_INLINE size_t size() const { return _size; }
+
+private:
+    struct Slot {
+        K key = 0;
+        V value = V();
+        bool occupied = false;
+    };
+
+    // keys are often sequential handles or xor-combined hashes, scramble them with the murmur3 finalizer
+    CC_INLINE size_t getSlotIndex(K key) const {
+        auto h = static_cast<uint64_t>(key);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return static_cast<size_t>(h) & _mask;
+    }
+
+    void rehash(size_t capacity) {
+        vector<Slot> slots(capacity);
+        _slots.swap(slots);
+        _mask = capacity - 1;
+        for (auto &slot : slots) {
+            if (!slot.occupied) continue;
+            size_t i = getSlotIndex(slot.key);
+            while (_slots[i].occupied) i = (i + 1) & _mask;
+            _slots[i] = std::move(slot);
+        }
+    }
+
+    vector<Slot> _slots;
+    size_t _size = 0;
+    size_t _mask = 0;
+};
+
+} // namespace pipeline
+} // namespace cc
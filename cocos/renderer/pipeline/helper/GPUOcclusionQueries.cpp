@@ -0,0 +1,303 @@
+#include "GPUOcclusionQueries.h"
+#include "gfx/GFXBuffer.h"
+#include "gfx/GFXCommandBuffer.h"
+#include "gfx/GFXDevice.h"
+#include "gfx/GFXInputAssembler.h"
+#include "gfx/GFXPipelineLayout.h"
+#include "gfx/GFXPipelineState.h"
+#include "gfx/GFXQueryPool.h"
+#include "gfx/GFXRenderPass.h"
+#include "gfx/GFXShader.h"
+
+namespace cc {
+namespace pipeline {
+namespace {
+// the proxies arrive in clip space, so the shaders only pass them through
+const char *PROXY_VERT_GLSL4 = R"(
+precision highp float;
+layout(location = 0) in vec4 a_position;
+void main () { gl_Position = a_position; }
+)";
+const char *PROXY_FRAG_GLSL4 = R"(
+precision mediump float;
+layout(location = 0) out vec4 o_color;
+void main () { o_color = vec4(1.0); }
+)";
+const char *PROXY_VERT_GLSL3 = R"(
+precision highp float;
+in vec4 a_position;
+void main () { gl_Position = a_position; }
+)";
+const char *PROXY_FRAG_GLSL3 = R"(
+precision mediump float;
+out vec4 o_color;
+void main () { o_color = vec4(1.0); }
+)";
+const char *PROXY_VERT_GLSL1 = R"(
+precision highp float;
+attribute vec4 a_position;
+void main () { gl_Position = a_position; }
+)";
+const char *PROXY_FRAG_GLSL1 = R"(
+precision mediump float;
+void main () { gl_FragColor = vec4(1.0); }
+)";
+
+constexpr uint PROXY_INDEX_COUNT = 36;
+// corners are numbered by their x, y and z bits
+constexpr uint16_t PROXY_INDICES[PROXY_INDEX_COUNT] = {
+    0, 2, 6, 0, 6, 4, // -x
+    1, 3, 7, 1, 7, 5, // +x
+    0, 1, 5, 0, 5, 4, // -y
+    2, 3, 7, 2, 7, 6, // +y
+    0, 1, 3, 0, 3, 2, // -z
+    4, 5, 7, 4, 7, 6, // +z
+};
+} // namespace
+
+bool GPUOcclusionQueries::initialize(gfx::Device *device) {
+    _device = device;
+    for (auto &frame : _frames) {
+        frame.queryPool = device->createQueryPool({gfx::QueryType::OCCLUSION, MAX_QUERIES});
+        if (!frame.queryPool) {
+            destroy();
+            return false;
+        }
+    }
+    if (!createProxyResources()) {
+        destroy();
+        return false;
+    }
+    _results.resize(MAX_QUERIES);
+    return true;
+}
+
+bool GPUOcclusionQueries::createProxyResources() {
+    _proxyVertexBuffer = _device->createBuffer({
+        gfx::BufferUsageBit::VERTEX | gfx::BufferUsageBit::TRANSFER_DST,
+        gfx::MemoryUsageBit::HOST | gfx::MemoryUsageBit::DEVICE,
+        MAX_PROXIES * 8 * sizeof(Vec4),
+        sizeof(Vec4),
+    });
+
+    vector<uint16_t> indices(MAX_PROXIES * PROXY_INDEX_COUNT);
+    for (uint i = 0; i < MAX_PROXIES; i++) {
+        for (uint j = 0; j < PROXY_INDEX_COUNT; j++) {
+            indices[i * PROXY_INDEX_COUNT + j] = static_cast<uint16_t>(i * 8 + PROXY_INDICES[j]);
+        }
+    }
+    _proxyIndexBuffer = _device->createBuffer({
+        gfx::BufferUsageBit::INDEX | gfx::BufferUsageBit::TRANSFER_DST,
+        gfx::MemoryUsageBit::HOST | gfx::MemoryUsageBit::DEVICE,
+        static_cast<uint>(indices.size() * sizeof(uint16_t)),
+        sizeof(uint16_t),
+    });
+    if (!_proxyVertexBuffer || !_proxyIndexBuffer) return false;
+    _proxyIndexBuffer->update(indices.data(), 0, _proxyIndexBuffer->getSize());
+
+    gfx::AttributeList attributes = {{"a_position", gfx::Format::RGBA32F}};
+    _proxyInputAssembler = _device->createInputAssembler({attributes, {_proxyVertexBuffer}, _proxyIndexBuffer});
+    if (!_proxyInputAssembler) return false;
+
+    gfx::ShaderInfo shaderInfo;
+    shaderInfo.name = "occlusion-proxy";
+    shaderInfo.attributes = attributes;
+    switch (_device->getGfxAPI()) {
+        case gfx::API::GLES2:
+            shaderInfo.stages = {{gfx::ShaderStageFlagBit::VERTEX, PROXY_VERT_GLSL1}, {gfx::ShaderStageFlagBit::FRAGMENT, PROXY_FRAG_GLSL1}};
+            break;
+        case gfx::API::GLES3:
+            shaderInfo.stages = {{gfx::ShaderStageFlagBit::VERTEX, PROXY_VERT_GLSL3}, {gfx::ShaderStageFlagBit::FRAGMENT, PROXY_FRAG_GLSL3}};
+            break;
+        default:
+            shaderInfo.stages = {{gfx::ShaderStageFlagBit::VERTEX, PROXY_VERT_GLSL4}, {gfx::ShaderStageFlagBit::FRAGMENT, PROXY_FRAG_GLSL4}};
+            break;
+    }
+    _proxyShader = _device->createShader(shaderInfo);
+    _proxyPipelineLayout = _device->createPipelineLayout({});
+    return _proxyShader && _proxyPipelineLayout;
+}
+
+void GPUOcclusionQueries::destroy() {
+    for (auto &frame : _frames) {
+        CC_SAFE_DESTROY(frame.queryPool);
+        frame.entries.clear();
+        frame.isPending = false;
+    }
+    for (auto &pair : _proxyPipelineStates) {
+        CC_SAFE_DESTROY(pair.second);
+    }
+    _proxyPipelineStates.clear();
+    CC_SAFE_DESTROY(_proxyInputAssembler);
+    CC_SAFE_DESTROY(_proxyVertexBuffer);
+    CC_SAFE_DESTROY(_proxyIndexBuffer);
+    CC_SAFE_DESTROY(_proxyShader);
+    CC_SAFE_DESTROY(_proxyPipelineLayout);
+    _modelStates.clear();
+    _proxyModels.clear();
+    _isQuerying = false;
+    _device = nullptr;
+}
+
+void GPUOcclusionQueries::beginFrame(const Camera *camera, const RenderObjectList &renderObjects, gfx::CommandBuffer *cmdBuff) {
+    // older frames first, their results are overridden by the newer ones
+    for (uint i = 1; i <= POOL_COUNT; i++) {
+        auto &frame = _frames[(_frameIndex + i) % POOL_COUNT];
+        if (frame.isPending) resolve(frame);
+    }
+
+    ++_frameIndex;
+    _eye = camera->position;
+    _proxyModels.clear();
+    _proxyVertices.clear();
+
+    // a pool still waiting for its results can't be reset, this frame goes without queries
+    auto &frame = _frames[_frameIndex % POOL_COUNT];
+    _isQuerying = !frame.isPending;
+    if (!_isQuerying) return;
+
+    frame.entries.clear();
+    frame.eye = _eye;
+    frame.index = _frameIndex;
+    cmdBuff->resetQueryPool(frame.queryPool);
+
+    Vec4 clip;
+    for (const auto &ro : renderObjects) {
+        const auto *model = ro.model;
+        if (!isOccluded(model)) continue;
+        if (_proxyModels.size() == MAX_PROXIES) break;
+
+        const auto *bounds = model->getWorldBounds();
+        const auto first = _proxyVertices.size();
+        bool isCrossingNear = false;
+        for (uint i = 0; i < 8; i++) {
+            const Vec3 corner(bounds->center.x + (i & 1 ? bounds->halfExtents.x : -bounds->halfExtents.x),
+                              bounds->center.y + (i & 2 ? bounds->halfExtents.y : -bounds->halfExtents.y),
+                              bounds->center.z + (i & 4 ? bounds->halfExtents.z : -bounds->halfExtents.z));
+            camera->matViewProj.transformVector(Vec4(corner.x, corner.y, corner.z, 1.0f), &clip);
+            if (clip.w <= 0.0f) isCrossingNear = true;
+            _proxyVertices.emplace_back(clip);
+        }
+
+        // the camera got close enough to be inside, the model has to be drawn right away
+        if (isCrossingNear) {
+            _proxyVertices.resize(first);
+            _modelStates[model].isOccluded = false;
+            continue;
+        }
+        _proxyModels.emplace_back(model);
+    }
+
+    if (!_proxyVertices.empty()) {
+        cmdBuff->updateBuffer(_proxyVertexBuffer, _proxyVertices.data(), static_cast<uint>(_proxyVertices.size() * sizeof(Vec4)));
+    }
+}
+
+bool GPUOcclusionQueries::isTracked(const ModelView *model) const {
+    if (!model->worldBoundsID) return false;
+    return model->getWorldBounds()->halfExtents.lengthSquared() >= _minRadius * _minRadius;
+}
+
+bool GPUOcclusionQueries::isOccluded(const ModelView *model) const {
+    const auto iter = _modelStates.find(model);
+    if (iter == _modelStates.end()) return false;
+
+    const auto &state = iter->second;
+    if (!state.isOccluded || _frameIndex - state.resultFrame > MAX_RESULT_AGE) return false;
+    if (state.eye.distanceSquared(_eye) > _reprojectionDistance * _reprojectionDistance) return false;
+
+    // bounds which changed since may have moved out from behind the occluders
+    const auto *bounds = model->worldBoundsID ? model->getWorldBounds() : nullptr;
+    return bounds && bounds->center == state.center && bounds->halfExtents == state.halfExtents;
+}
+
+uint GPUOcclusionQueries::addQuery(const ModelView *model, gfx::CommandBuffer *cmdBuff) {
+    auto &frame = _frames[_frameIndex % POOL_COUNT];
+    if (frame.entries.size() == MAX_QUERIES) return UINT_MAX;
+
+    const auto *bounds = model->getWorldBounds();
+    const auto query = static_cast<uint>(frame.entries.size());
+    frame.entries.push_back({model, bounds->center, bounds->halfExtents});
+    frame.isPending = true;
+    cmdBuff->beginQuery(frame.queryPool, query);
+    return query;
+}
+
+uint GPUOcclusionQueries::beginQuery(const ModelView *model, gfx::CommandBuffer *cmdBuff) {
+    if (!_isQuerying || !isTracked(model)) return UINT_MAX;
+    return addQuery(model, cmdBuff);
+}
+
+void GPUOcclusionQueries::endQuery(uint query, gfx::CommandBuffer *cmdBuff) {
+    cmdBuff->endQuery(_frames[_frameIndex % POOL_COUNT].queryPool, query);
+}
+
+void GPUOcclusionQueries::recordProxies(gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff) {
+    if (!_isQuerying || _proxyModels.empty()) return;
+
+    auto *pso = getOrCreateProxyPipelineState(renderPass);
+    if (!pso) return;
+    cmdBuff->bindPipelineState(pso);
+    cmdBuff->bindInputAssembler(_proxyInputAssembler);
+
+    _proxyInputAssembler->setIndexCount(PROXY_INDEX_COUNT);
+    for (uint i = 0; i < _proxyModels.size(); i++) {
+        const auto query = addQuery(_proxyModels[i], cmdBuff);
+        if (query == UINT_MAX) break;
+
+        _proxyInputAssembler->setFirstIndex(i * PROXY_INDEX_COUNT);
+        cmdBuff->draw(_proxyInputAssembler);
+        endQuery(query, cmdBuff);
+    }
+}
+
+gfx::PipelineState *GPUOcclusionQueries::getOrCreateProxyPipelineState(gfx::RenderPass *renderPass) {
+    auto &pso = _proxyPipelineStates[renderPass];
+    if (pso) return pso;
+
+    gfx::PipelineStateInfo info;
+    info.shader = _proxyShader;
+    info.pipelineLayout = _proxyPipelineLayout;
+    info.renderPass = renderPass;
+    info.inputState = {_proxyInputAssembler->getAttributes()};
+    // the eye may sit between the faces, and proxies must not hide each other
+    info.rasterizerState.cullMode = gfx::CullMode::NONE;
+    info.depthStencilState.depthWrite = 0;
+    info.depthStencilState.depthFunc = gfx::ComparisonFunc::LESS_EQUAL;
+    gfx::BlendTarget target;
+    target.blendColorMask = gfx::ColorMask::NONE;
+    info.blendState.targets.assign(std::max(renderPass->getColorAttachments().size(), size_t(1)), target);
+    pso = _device->createPipelineState(info);
+    return pso;
+}
+
+void GPUOcclusionQueries::resolve(Frame &frame) {
+    const auto count = static_cast<uint>(frame.entries.size());
+    if (count && !frame.queryPool->getResults(0, count, _results.data())) return;
+
+    // a model is visible as soon as any of its draws passed
+    for (uint i = 0; i < count; i++) {
+        const auto &entry = frame.entries[i];
+        auto &state = _modelStates[entry.model];
+        if (state.resultFrame > frame.index) continue;
+        if (state.resultFrame < frame.index) {
+            state.resultFrame = frame.index;
+            state.isOccluded = true;
+            state.center = entry.center;
+            state.halfExtents = entry.halfExtents;
+            state.eye = frame.eye;
+        }
+        if (_results[i]) state.isOccluded = false;
+    }
+    frame.isPending = false;
+
+    // forget models which were not queried for a while
+    if (_modelStates.size() > MAX_QUERIES * 2) {
+        for (auto iter = _modelStates.begin(); iter != _modelStates.end();) {
+            iter = _frameIndex - iter->second.resultFrame > MAX_RESULT_AGE ? _modelStates.erase(iter) : std::next(iter);
+        }
+    }
+}
+
+} // namespace pipeline
+} // namespace cc
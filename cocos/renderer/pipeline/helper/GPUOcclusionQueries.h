@@ -0,0 +1,104 @@
+#pragma once
+
+#include "../Define.h"
+#include "SharedMemory.h"
+
+namespace cc {
+
+namespace gfx {
+class Buffer;
+class CommandBuffer;
+class InputAssembler;
+class PipelineLayout;
+class PipelineState;
+class QueryPool;
+class RenderPass;
+class Shader;
+} // namespace gfx
+
+namespace pipeline {
+
+// Skips the opaque draws of large models which GPU occlusion queries found hidden in an earlier frame.
+// Visible models are queried with their own draws, hidden ones with a bounding box proxy drawn after
+// the opaque queue, so that they come back once their proxy passes the depth test. Results are read
+// frames later without waiting on the GPU. What opaque geometry hides depends on the eye position but
+// not on the view direction, so a result is reused while the camera stays within the reprojection
+// distance of where it was measured and the model's world bounds are unchanged.
+class CC_DLL GPUOcclusionQueries : public Object {
+public:
+    static constexpr uint POOL_COUNT = 4;
+    static constexpr uint MAX_QUERIES = 1024;
+    static constexpr uint MAX_PROXIES = 512;
+
+    bool initialize(gfx::Device *device);
+    void destroy();
+
+    // Collects finished results and uploads the proxies, outside of the render pass recording the queries.
+    void beginFrame(const Camera *camera, const RenderObjectList &renderObjects, gfx::CommandBuffer *cmdBuff);
+    bool isOccluded(const ModelView *model) const;
+    // Returns the query to wrap the next draw of the model in, UINT_MAX for models that aren't tracked.
+    uint beginQuery(const ModelView *model, gfx::CommandBuffer *cmdBuff);
+    void endQuery(uint query, gfx::CommandBuffer *cmdBuff);
+    // Needs the depth of the opaque draws, it binds no descriptor sets and has to follow a pass draw.
+    void recordProxies(gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff);
+
+    // Models whose world bounds have a smaller radius are always drawn.
+    CC_INLINE void setMinRadius(float radius) { _minRadius = radius; }
+    CC_INLINE void setReprojectionDistance(float distance) { _reprojectionDistance = distance; }
+
+private:
+    struct QueryEntry {
+        const ModelView *model = nullptr;
+        Vec3 center;
+        Vec3 halfExtents;
+    };
+
+    struct Frame {
+        gfx::QueryPool *queryPool = nullptr;
+        vector<QueryEntry> entries;
+        Vec3 eye;
+        uint index = 0;
+        bool isPending = false;
+    };
+
+    struct ModelState {
+        // bounds and eye position the result was measured with
+        Vec3 center;
+        Vec3 halfExtents;
+        Vec3 eye;
+        uint resultFrame = 0;
+        bool isOccluded = false;
+    };
+
+    bool isTracked(const ModelView *model) const;
+    uint addQuery(const ModelView *model, gfx::CommandBuffer *cmdBuff);
+    void resolve(Frame &frame);
+    bool createProxyResources();
+    gfx::PipelineState *getOrCreateProxyPipelineState(gfx::RenderPass *renderPass);
+
+    // results older than this many frames of the camera are not trusted anymore
+    static constexpr uint MAX_RESULT_AGE = POOL_COUNT * 2;
+
+    gfx::Device *_device = nullptr;
+    Frame _frames[POOL_COUNT];
+    uint _frameIndex = 0;
+    bool _isQuerying = false;
+    Vec3 _eye;
+    std::unordered_map<const ModelView *, ModelState> _modelStates;
+    vector<uint64_t> _results;
+
+    float _minRadius = 1.0f;
+    float _reprojectionDistance = 0.5f;
+
+    vector<const ModelView *> _proxyModels;
+    vector<Vec4> _proxyVertices; // clip space corners, 8 per proxy
+    gfx::Buffer *_proxyVertexBuffer = nullptr;
+    gfx::Buffer *_proxyIndexBuffer = nullptr;
+    gfx::InputAssembler *_proxyInputAssembler = nullptr;
+    gfx::Shader *_proxyShader = nullptr;
+    gfx::PipelineLayout *_proxyPipelineLayout = nullptr;
+    std::unordered_map<gfx::RenderPass *, gfx::PipelineState *> _proxyPipelineStates;
+};
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,76 @@
+#include "GPUTimer.h"
+#include "../RenderStage.h"
+#include "gfx/GFXCommandBuffer.h"
+#include "gfx/GFXDevice.h"
+#include "gfx/GFXQueryPool.h"
+
+namespace cc {
+namespace pipeline {
+
+bool GPUTimer::initialize(gfx::Device *device) {
+    if (!device->hasFeature(gfx::Feature::TIMESTAMP_QUERY)) return false;
+
+    for (auto &frame : _frames) {
+        frame.queryPool = device->createQueryPool({gfx::QueryType::TIMESTAMP, MAX_TIMESTAMPS});
+        if (!frame.queryPool) {
+            destroy();
+            return false;
+        }
+    }
+    _timestamps.resize(MAX_TIMESTAMPS);
+    return true;
+}
+
+void GPUTimer::destroy() {
+    for (auto &frame : _frames) {
+        CC_SAFE_DESTROY(frame.queryPool);
+        frame.stages.clear();
+        frame.isPending = false;
+    }
+    _cmdBuff = nullptr;
+}
+
+void GPUTimer::beginFrame(gfx::CommandBuffer *cmdBuff) {
+    for (auto &frame : _frames) {
+        if (frame.isPending) resolve(frame);
+    }
+
+    // a frame still unresolved when its pool comes around again is dropped
+    _frameIndex = (_frameIndex + 1) % POOL_COUNT;
+    Frame &frame = _frames[_frameIndex];
+    frame.stages.clear();
+    frame.isPending = false;
+
+    _cmdBuff = cmdBuff;
+    _cmdBuff->resetQueryPool(frame.queryPool);
+    _cmdBuff->writeTimestamp(frame.queryPool, 0);
+}
+
+void GPUTimer::endStage(RenderStage *stage) {
+    Frame &frame = _frames[_frameIndex];
+    uint query = static_cast<uint>(frame.stages.size()) + 1;
+    if (query >= MAX_TIMESTAMPS) return;
+
+    _cmdBuff->writeTimestamp(frame.queryPool, query);
+    frame.stages.push_back(stage);
+    frame.isPending = true;
+}
+
+void GPUTimer::resolve(Frame &frame) {
+    uint count = static_cast<uint>(frame.stages.size()) + 1;
+    if (!frame.queryPool->getResults(0, count, _timestamps.data())) return;
+
+    // a stage rendered for several cameras accumulates all of its passes
+    for (const auto stage : frame.stages) {
+        stage->setGPUTime(0.0f);
+    }
+    for (uint i = 0; i < frame.stages.size(); ++i) {
+        uint64_t elapsed = _timestamps[i + 1] > _timestamps[i] ? _timestamps[i + 1] - _timestamps[i] : 0;
+        RenderStage *stage = frame.stages[i];
+        stage->setGPUTime(stage->getGPUTime() + elapsed * 1e-6f);
+    }
+    frame.isPending = false;
+}
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "../Define.h"
+
+namespace cc {
+
+namespace gfx {
+class CommandBuffer;
+class QueryPool;
+} // namespace gfx
+
+namespace pipeline {
+
+class RenderStage;
+
+// Measures the GPU time spent in every render stage with timestamp queries.
+// Each frame writes its own query pool, results are collected frames later
+// without waiting on the GPU and handed to RenderStage::setGPUTime.
+class CC_DLL GPUTimer : public Object {
+public:
+    static constexpr uint POOL_COUNT = 4;
+    static constexpr uint MAX_TIMESTAMPS = 64;
+
+    bool initialize(gfx::Device *device);
+    void destroy();
+
+    // Timestamps are written into cmdBuff until the next frame, outside of any render pass.
+    void beginFrame(gfx::CommandBuffer *cmdBuff);
+    void endStage(RenderStage *stage);
+
+private:
+    struct Frame {
+        gfx::QueryPool *queryPool = nullptr;
+        vector<RenderStage *> stages; // stage measured between timestamps i and i + 1
+        bool isPending = false;
+    };
+
+    void resolve(Frame &frame);
+
+    gfx::CommandBuffer *_cmdBuff = nullptr;
+    Frame _frames[POOL_COUNT];
+    uint _frameIndex = 0;
+    vector<uint64_t> _timestamps;
+};
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,432 @@
+#include "GlyphAtlas.h"
+
+#include "base/Data.h"
+#include "base/JobSystem.h"
+#include "base/Log.h"
+#include "base/UTF8.h"
+#include "gfx/GFXDevice.h"
+#include "gfx/GFXTexture.h"
+#include "platform/CanvasRenderingContext2D.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace cc {
+namespace pipeline {
+namespace {
+constexpr uint TEXEL_SIZE = 4;
+// transparent texels around a glyph, so that filtering doesn't bleed its neighbours in
+constexpr uint PADDING = 1;
+// the cell of a font is this many em wide and high, glyphs reaching further are cut off
+constexpr float CELL_WIDTH_EM = 2.f;
+constexpr float CELL_HEIGHT_EM = 1.4f;
+// room beyond the advance for italic overhangs
+constexpr float OVERHANG_EM = 0.25f;
+// a glyph goes on a shelf at most this much higher than itself
+constexpr float SHELF_SLACK = 1.25f;
+constexpr float DEFAULT_FONT_SIZE = 10.f;
+
+constexpr float SDF_INF = 1e20f;
+// new fields computed on the calling thread, more go to the workers
+constexpr uint PARALLEL_SDF_COUNT = 2;
+
+// the px size of a CSS font, "italic bold 24px Arial" is 24, and where it is written
+float parseFontSize(const String &font, size_t *start = nullptr, size_t *end = nullptr) {
+    for (size_t pos = font.find("px"); pos != String::npos; pos = font.find("px", pos + 2)) {
+        size_t begin = pos;
+        while (begin > 0 && (isdigit(static_cast<unsigned char>(font[begin - 1])) || font[begin - 1] == '.')) --begin;
+        if (begin == pos) continue;
+        const float size = strtof(font.c_str() + begin, nullptr);
+        if (size <= 0.f) continue;
+        if (start) *start = begin;
+        if (end) *end = pos + 2;
+        return size;
+    }
+    return DEFAULT_FONT_SIZE;
+}
+
+// squared euclidean distance transform of one row or column in place, Felzenszwalb and Huttenlocher;
+// f, v and z are scratch of the length, z one longer
+void transform1D(float *grid, uint n, uint stride, float *f, uint16_t *v, float *z) {
+    f[0] = grid[0];
+    v[0] = 0;
+    z[0] = -SDF_INF;
+    z[1] = SDF_INF;
+    for (int q = 1, k = 0; q < static_cast<int>(n); ++q) {
+        f[q] = grid[q * stride];
+        const float q2 = static_cast<float>(q * q);
+        float s = 0.f;
+        do {
+            const int r = v[k];
+            s = (f[q] - f[r] + q2 - static_cast<float>(r * r)) / static_cast<float>(2 * (q - r));
+        } while (s <= z[k] && --k > -1);
+        ++k;
+        v[k] = static_cast<uint16_t>(q);
+        z[k] = s;
+        z[k + 1] = SDF_INF;
+    }
+    for (uint q = 0, k = 0; q < n; ++q) {
+        while (z[k + 1] < static_cast<float>(q)) ++k;
+        const uint r = v[k];
+        const float qr = static_cast<float>(q) - static_cast<float>(r);
+        grid[q * stride] = f[r] + qr * qr;
+    }
+}
+
+void transform2D(float *grid, uint width, uint height, float *d, uint16_t *v, float *z) {
+    for (uint x = 0; x < width; ++x) transform1D(grid + x, height, width, d, v, z);
+    for (uint y = 0; y < height; ++y) transform1D(grid + y * width, width, 1, d, v, z);
+}
+} // namespace
+
+constexpr uint GlyphAtlas::PAGE_SIZE;
+constexpr uint GlyphAtlas::MAX_PAGE_COUNT;
+constexpr uint GlyphAtlas::QUAD_FLOAT_COUNT;
+constexpr uint GlyphAtlas::SDF_SIZE;
+constexpr uint GlyphAtlas::SDF_SPREAD;
+GlyphAtlas *GlyphAtlas::_instance = nullptr;
+
+GlyphAtlas *GlyphAtlas::getInstance() {
+    if (!_instance) _instance = CC_NEW(GlyphAtlas);
+    return _instance;
+}
+
+void GlyphAtlas::destroyInstance() {
+    CC_SAFE_DELETE(_instance);
+}
+
+GlyphAtlas::GlyphAtlas() = default;
+
+GlyphAtlas::~GlyphAtlas() {
+    clear();
+    delete _canvas;
+}
+
+float GlyphAtlas::layout(const String &font, const String &text, vector<float> &quads) {
+    return layout(font, false, text, quads);
+}
+
+float GlyphAtlas::layoutSDF(const String &font, const String &text, vector<float> &quads) {
+    return layout(font, true, text, quads);
+}
+
+float GlyphAtlas::layout(const String &font, bool isSDF, const String &text, vector<float> &quads) {
+    // the fields of all sizes come from the font at SDF_SIZE
+    String canvasFont = font;
+    float scale = 1.f;
+    if (isSDF) {
+        size_t start = String::npos;
+        size_t end = String::npos;
+        scale = parseFontSize(font, &start, &end) / static_cast<float>(SDF_SIZE);
+        const String size = std::to_string(SDF_SIZE) + "px";
+        canvasFont = start == String::npos ? size + " " + font : font.substr(0, start) + size + font.substr(end);
+    }
+
+    std::u32string codes;
+    if (!StringUtils::UTF8ToUTF32(text, codes)) {
+        CC_LOG_WARNING("GlyphAtlas: the text is no valid UTF-8.");
+        return 0.f;
+    }
+
+    const size_t quadStart = quads.size();
+    const float uvScale = 1.f / static_cast<float>(PAGE_SIZE);
+    float penX = 0.f;
+    // once more when the pages filled up and started over, the quads so far point at the old ones
+    for (uint attempt = 0; attempt < 2; ++attempt) {
+        quads.resize(quadStart);
+        penX = 0.f;
+        Font &fontData = getFont(canvasFont, isSDF);
+        bool isComplete = true;
+        for (const char32_t code : codes) {
+            if (code < 0x20) continue; // control characters take no room on a single line
+
+            const Glyph *glyph = getGlyph(canvasFont, fontData, code);
+            if (!glyph) {
+                isComplete = false;
+                break;
+            }
+            if (!glyph->isEmpty) {
+                quads.push_back(penX - static_cast<float>(fontData.padding) * scale);
+                quads.push_back(static_cast<float>(glyph->height) * 0.5f * scale);
+                quads.push_back(static_cast<float>(glyph->width) * scale);
+                quads.push_back(static_cast<float>(glyph->height) * scale);
+                quads.push_back(static_cast<float>(glyph->x) * uvScale);
+                quads.push_back(static_cast<float>(glyph->y) * uvScale);
+                quads.push_back(static_cast<float>(glyph->x + glyph->width) * uvScale);
+                quads.push_back(static_cast<float>(glyph->y + glyph->height) * uvScale);
+                quads.push_back(static_cast<float>(glyph->page));
+            }
+            penX += glyph->advance * scale;
+        }
+        if (isComplete) break;
+    }
+    return penX;
+}
+
+GlyphAtlas::Font &GlyphAtlas::getFont(const String &font, bool isSDF) {
+    auto &fonts = isSDF ? _sdfFonts : _fonts;
+    auto it = fonts.find(font);
+    if (it != fonts.end()) return it->second;
+
+    Font &data = fonts[font];
+    data.size = parseFontSize(font);
+    data.isSDF = isSDF;
+    data.padding = isSDF ? SDF_SPREAD : PADDING;
+    data.cellWidth = static_cast<uint>(std::ceil(data.size * CELL_WIDTH_EM)) + 2 * data.padding;
+    data.cellHeight = static_cast<uint>(std::ceil(data.size * CELL_HEIGHT_EM)) + 2 * data.padding;
+    data.cellWidth = std::min(data.cellWidth, PAGE_SIZE);
+    data.cellHeight = std::min(data.cellHeight, PAGE_SIZE);
+    return data;
+}
+
+// nullptr when the atlas started over, the font is gone then
+const GlyphAtlas::Glyph *GlyphAtlas::getGlyph(const String &fontName, Font &font, char32_t code) {
+    auto it = font.glyphs.find(code);
+    if (it != font.glyphs.end()) return &it->second;
+
+    const uint generation = _generation;
+    Glyph glyph;
+    if (!rasterize(fontName, font, code, glyph)) {
+        if (_generation != generation) return nullptr;
+        glyph.isEmpty = true; // not drawable here, it only advances
+    }
+    return &font.glyphs.emplace(code, glyph).first->second;
+}
+
+bool GlyphAtlas::rasterize(const String &fontName, Font &font, char32_t code, Glyph &glyph) {
+    if (!_canvas) {
+        _canvas = new CanvasRenderingContext2D(static_cast<float>(font.cellWidth), static_cast<float>(font.cellHeight));
+        _canvas->setCanvasBufferUpdatedCallback([this](const Data &data) {
+            _canvasPixels.assign(data.getBytes(), data.getBytes() + data.getSize());
+        });
+        _canvas->set_textAlign("left");
+        _canvas->set_textBaseline("middle");
+        _canvas->set_fillStyle("#ffffff");
+    }
+    if (_canvasFont != fontName) {
+        _canvas->set_font(fontName);
+        _canvasFont = fontName;
+    }
+    // a new size recreates the buffer, the fonts of a size share it
+    _canvas->set_width(static_cast<float>(font.cellWidth));
+    _canvas->set_height(static_cast<float>(font.cellHeight));
+
+    String character;
+    if (!StringUtils::UTF32ToUTF8(std::u32string(1, code), character)) return false;
+    glyph.advance = _canvas->measureText(character).width;
+
+    _canvas->clearRect(0.f, 0.f, static_cast<float>(font.cellWidth), static_cast<float>(font.cellHeight));
+    _canvasPixels.clear();
+    _canvas->fillText(character, static_cast<float>(font.padding), static_cast<float>(font.cellHeight) * 0.5f);
+    const size_t stride = font.cellWidth * TEXEL_SIZE;
+    if (_canvasPixels.size() < stride * font.cellHeight) return false;
+    const uint8_t *pixels = _canvasPixels.data();
+
+    const uint width = std::min(font.cellWidth, static_cast<uint>(std::ceil(glyph.advance + font.size * OVERHANG_EM)) + 2 * font.padding);
+    const uint height = font.cellHeight;
+    bool isEmpty = true;
+    for (uint y = 0; y < height && isEmpty; ++y) {
+        const uint8_t *row = pixels + y * stride;
+        for (uint x = 0; x < width; ++x) {
+            if (row[x * TEXEL_SIZE + 3]) {
+                isEmpty = false;
+                break;
+            }
+        }
+    }
+    if (isEmpty) {
+        glyph.isEmpty = true;
+        return true;
+    }
+
+    if (!allocate(width, height, font.isSDF, glyph)) return false;
+
+    Upload upload;
+    upload.page = glyph.page;
+    upload.x = glyph.x;
+    upload.y = glyph.y;
+    upload.width = width;
+    upload.height = height;
+    upload.offset = _uploadPixels.size();
+    if (font.isSDF) {
+        // the field is computed by update() from the coverage, the spread around the glyph is transparent
+        upload.isSDF = true;
+        upload.coverageOffset = _sdfCoverage.size();
+        _sdfCoverage.resize(upload.coverageOffset + width * height);
+        _uploadPixels.resize(upload.offset + width * height);
+        uint8_t *coverage = _sdfCoverage.data() + upload.coverageOffset;
+        for (uint y = 0; y < height; ++y) {
+            for (uint x = 0; x < width; ++x) {
+                const bool isSpread = x < font.padding || x >= width - font.padding || y < font.padding || y >= height - font.padding;
+                coverage[y * width + x] = isSpread ? 0 : pixels[y * stride + x * TEXEL_SIZE + 3];
+            }
+        }
+        _uploads.push_back(upload);
+        return true;
+    }
+    _uploadPixels.resize(upload.offset + width * height * TEXEL_SIZE);
+    uint8_t *dst = _uploadPixels.data() + upload.offset;
+    for (uint y = 0; y < height; ++y) {
+        uint8_t *row = dst + y * width * TEXEL_SIZE;
+        // the padding has to stay transparent whatever the glyph left in the cell
+        if (y < PADDING || y >= height - PADDING) {
+            memset(row, 0, width * TEXEL_SIZE);
+            continue;
+        }
+        memcpy(row, pixels + y * stride, width * TEXEL_SIZE);
+        memset(row, 0, PADDING * TEXEL_SIZE);
+        memset(row + (width - PADDING) * TEXEL_SIZE, 0, PADDING * TEXEL_SIZE);
+    }
+    _uploads.push_back(upload);
+    return true;
+}
+
+bool GlyphAtlas::allocate(uint width, uint height, bool isSDF, Glyph &glyph) {
+    for (uint i = 0; i <= _pages.size(); ++i) {
+        if (i == _pages.size()) {
+            if (_pages.size() == MAX_PAGE_COUNT) break;
+            Page page;
+            page.isSDF = isSDF;
+            page.texture = gfx::Device::getInstance()->createTexture({
+                gfx::TextureType::TEX2D,
+                gfx::TextureUsageBit::SAMPLED | gfx::TextureUsageBit::TRANSFER_DST,
+                isSDF ? gfx::Format::R8 : gfx::Format::RGBA8,
+                PAGE_SIZE,
+                PAGE_SIZE,
+            });
+            _pages.push_back(page);
+        }
+
+        Page &page = _pages[i];
+        if (page.isSDF != isSDF) continue;
+        Shelf *shelf = nullptr;
+        for (auto &candidate : page.shelves) {
+            if (candidate.height >= height && candidate.height <= height * SHELF_SLACK && candidate.x + width <= PAGE_SIZE) {
+                shelf = &candidate;
+                break;
+            }
+        }
+        if (!shelf && page.shelfEnd + height <= PAGE_SIZE) {
+            page.shelves.push_back({page.shelfEnd, height, 0});
+            page.shelfEnd += height;
+            shelf = &page.shelves.back();
+        }
+        if (!shelf) continue;
+
+        glyph.page = static_cast<uint8_t>(i);
+        glyph.x = static_cast<uint16_t>(shelf->x);
+        glyph.y = static_cast<uint16_t>(shelf->y);
+        glyph.width = static_cast<uint16_t>(width);
+        glyph.height = static_cast<uint16_t>(height);
+        shelf->x += width;
+        return true;
+    }
+
+    CC_LOG_INFO("GlyphAtlas: %u pages are full, starting over.", MAX_PAGE_COUNT);
+    clear();
+    return false;
+}
+
+void GlyphAtlas::computeSDF(const uint8_t *coverage, uint width, uint height, uint8_t *field) {
+    const uint count = width * height;
+    const uint length = std::max(width, height);
+    vector<float> outer(count);
+    vector<float> inner(count);
+    vector<float> d(length);
+    vector<float> z(length + 1);
+    vector<uint16_t> v(length);
+
+    // partly covered texels start at their distance from the edge within the texel
+    for (uint i = 0; i < count; ++i) {
+        const float a = static_cast<float>(coverage[i]) / 255.f;
+        if (a >= 1.f) {
+            outer[i] = 0.f;
+            inner[i] = SDF_INF;
+        } else if (a <= 0.f) {
+            outer[i] = SDF_INF;
+            inner[i] = 0.f;
+        } else {
+            const float o = std::max(0.f, 0.5f - a);
+            const float n = std::max(0.f, a - 0.5f);
+            outer[i] = o * o;
+            inner[i] = n * n;
+        }
+    }
+    transform2D(outer.data(), width, height, d.data(), v.data(), z.data());
+    transform2D(inner.data(), width, height, d.data(), v.data(), z.data());
+
+    for (uint i = 0; i < count; ++i) {
+        const float distance = std::sqrt(outer[i]) - std::sqrt(inner[i]);
+        const float value = 0.5f - distance / static_cast<float>(2 * SDF_SPREAD);
+        field[i] = static_cast<uint8_t>(std::min(std::max(value, 0.f), 1.f) * 255.f + 0.5f);
+    }
+}
+
+void GlyphAtlas::update() {
+    if (_uploads.empty()) return;
+
+    // the fields of the new glyphs write disjoint ranges of _uploadPixels
+    vector<const Upload *> fields;
+    for (const auto &upload : _uploads) {
+        if (upload.isSDF) fields.push_back(&upload);
+    }
+    const auto compute = [this, &fields](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            const Upload &upload = *fields[i];
+            computeSDF(_sdfCoverage.data() + upload.coverageOffset, upload.width, upload.height, _uploadPixels.data() + upload.offset);
+        }
+    };
+    if (fields.size() <= PARALLEL_SDF_COUNT) {
+        compute(0, static_cast<uint32_t>(fields.size()));
+    } else {
+        auto *jobSystem = JobSystem::getInstance();
+        jobSystem->wait(jobSystem->parallelFor(static_cast<uint32_t>(fields.size()), 1, compute));
+    }
+    _sdfCoverage.clear();
+
+    vector<const uint8_t *> buffers;
+    vector<gfx::BufferTextureCopy> regions;
+    for (uint page = 0; page < _pages.size(); ++page) {
+        buffers.clear();
+        regions.clear();
+        for (const auto &upload : _uploads) {
+            if (upload.page != page) continue;
+            gfx::BufferTextureCopy region;
+            region.texOffset.x = static_cast<int>(upload.x);
+            region.texOffset.y = static_cast<int>(upload.y);
+            region.texExtent.width = upload.width;
+            region.texExtent.height = upload.height;
+            regions.push_back(region);
+            buffers.push_back(_uploadPixels.data() + upload.offset);
+        }
+        if (!regions.empty() && _pages[page].texture) {
+            gfx::Device::getInstance()->copyBuffersToTexture(buffers.data(), _pages[page].texture, regions.data(), static_cast<uint>(regions.size()));
+        }
+    }
+    _uploads.clear();
+    _uploadPixels.clear();
+}
+
+gfx::Texture *GlyphAtlas::getPageTexture(uint index) const {
+    return index < _pages.size() ? _pages[index].texture : nullptr;
+}
+
+void GlyphAtlas::clear() {
+    for (auto &page : _pages) {
+        CC_SAFE_DESTROY(page.texture);
+    }
+    _pages.clear();
+    _fonts.clear();
+    _sdfFonts.clear();
+    _uploads.clear();
+    _uploadPixels.clear();
+    _sdfCoverage.clear();
+    ++_generation;
+}
+
+} // namespace pipeline
+} // namespace cc
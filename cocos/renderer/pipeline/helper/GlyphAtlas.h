@@ -0,0 +1,127 @@
+#pragma once
+
+#include "../Define.h"
+
+#include <unordered_map>
+
+namespace cc {
+class CanvasRenderingContext2D;
+
+namespace gfx {
+class Texture;
+} // namespace gfx
+
+namespace pipeline {
+
+// Caches the glyphs of the label fonts in shared RGBA8 atlas pages, so that a text change only lays quads out
+// instead of rasterizing the whole string through CanvasRenderingContext2D and uploading a texture of its own.
+// Missing glyphs are rasterized white, one at a time, through a canvas of the platform; update() uploads the ones
+// rasterized since the last frame into their pages. Once the pages are full the atlas starts over, labels
+// lay themselves out again when getGeneration() changed.
+//
+// layoutSDF() serves every size of a font from signed distance fields of its glyphs at SDF_SIZE, on R8 pages of
+// their own. update() computes the fields of the new glyphs on the workers of JobSystem. The material samples
+// the red channel as the distance, 0.5 on the glyph edge and 0 or 1 SDF_SPREAD texels out or in, so
+//     alpha = smoothstep(0.5 - w, 0.5 + w, d), w = 0.5 / (SDF_SPREAD * size / SDF_SIZE)
+// antialiases a glyph drawn size px large; moving the edge below 0.5 makes outlines and glows.
+class CC_DLL GlyphAtlas final : public Object {
+public:
+    static constexpr uint PAGE_SIZE = 1024;
+    static constexpr uint MAX_PAGE_COUNT = 4;
+    // floats a quad of layout() is made of
+    static constexpr uint QUAD_FLOAT_COUNT = 9;
+    // px size the fields are generated at, and texels they reach beyond the edge of a glyph
+    static constexpr uint SDF_SIZE = 48;
+    static constexpr uint SDF_SPREAD = 6;
+
+    static GlyphAtlas *getInstance();
+    static void destroyInstance();
+
+    GlyphAtlas();
+    ~GlyphAtlas();
+
+    // Appends a quad for every glyph of the UTF-8 text in the CSS font, as "bold 24px Arial" of the canvas:
+    // x and y of its top left corner from the pen start on the middle of the line, width, height, u0, v0, u1, v1
+    // in the page and the page index. Returns the advance of the whole text, the text is a single line.
+    float layout(const String &font, const String &text, vector<float> &quads);
+    // As layout(), with the quads of the distance fields scaled to the size of the font.
+    float layoutSDF(const String &font, const String &text, vector<float> &quads);
+
+    // Uploads the glyphs rasterized since the last update, once a frame before the labels are drawn.
+    void update();
+
+    CC_INLINE uint getPageCount() const { return static_cast<uint>(_pages.size()); }
+    // The texture of a page, valid until the generation changes.
+    gfx::Texture *getPageTexture(uint index) const;
+    CC_INLINE uint getGeneration() const { return _generation; }
+
+    // Drops every glyph and starts over with the next generation.
+    void clear();
+
+private:
+    struct Glyph {
+        float advance = 0.f;
+        uint16_t x = 0;
+        uint16_t y = 0;
+        uint16_t width = 0;
+        uint16_t height = 0;
+        uint8_t page = 0;
+        bool isEmpty = false; // nothing to draw, such as a space
+    };
+
+    struct Shelf {
+        uint y = 0;
+        uint height = 0;
+        uint x = 0;
+    };
+
+    struct Page {
+        gfx::Texture *texture = nullptr;
+        bool isSDF = false;
+        vector<Shelf> shelves;
+        uint shelfEnd = 0;
+    };
+
+    struct Upload {
+        uint page = 0;
+        uint x = 0;
+        uint y = 0;
+        uint width = 0;
+        uint height = 0;
+        size_t offset = 0;         // into _uploadPixels
+        size_t coverageOffset = 0; // into _sdfCoverage, for the fields computed by update()
+        bool isSDF = false;
+    };
+
+    struct Font {
+        float size = 0.f;
+        bool isSDF = false;
+        uint padding = 0;
+        uint cellWidth = 0;
+        uint cellHeight = 0;
+        std::unordered_map<char32_t, Glyph> glyphs;
+    };
+
+    float layout(const String &font, bool isSDF, const String &text, vector<float> &quads);
+    Font &getFont(const String &font, bool isSDF);
+    static void computeSDF(const uint8_t *coverage, uint width, uint height, uint8_t *field);
+    const Glyph *getGlyph(const String &fontName, Font &font, char32_t code);
+    bool rasterize(const String &fontName, Font &font, char32_t code, Glyph &glyph);
+    bool allocate(uint width, uint height, bool isSDF, Glyph &glyph);
+
+    std::unordered_map<String, Font> _fonts;
+    std::unordered_map<String, Font> _sdfFonts;
+    vector<Page> _pages;
+    vector<Upload> _uploads;
+    vector<uint8_t> _uploadPixels;
+    vector<uint8_t> _sdfCoverage;
+    CanvasRenderingContext2D *_canvas = nullptr;
+    vector<uint8_t> _canvasPixels; // of the last drawing, the canvas hands them over as a temporary on some platforms
+    String _canvasFont;
+    uint _generation = 0;
+
+    static GlyphAtlas *_instance;
+};
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,227 @@
+#include "ModelBVH.h"
+
+#include <algorithm>
+
+namespace cc {
+namespace pipeline {
+namespace {
+constexpr uint MAX_TRAVERSAL_DEPTH = 64;
+
+CC_INLINE void getBoundary(const AABB *aabb, cc::Vec3 &minPos, cc::Vec3 &maxPos) {
+    minPos = aabb->center - aabb->halfExtents;
+    maxPos = aabb->center + aabb->halfExtents;
+}
+
+CC_INLINE void toAABB(const cc::Vec3 &minPos, const cc::Vec3 &maxPos, AABB &out) {
+    out.center = (minPos + maxPos) * 0.5f;
+    out.halfExtents = (maxPos - minPos) * 0.5f;
+}
+} // namespace
+
+void ModelBVH::update(const Scene *scene, uint frame) {
+    if (frame == _lastUpdateFrame) return;
+    // the transform change flags only hold the moves since the previous frame
+    const bool isConsecutive = frame == _lastUpdateFrame + 1;
+    _lastUpdateFrame = frame;
+
+    if (!isConsecutive || needsRebuild(scene) || !refit(scene)) {
+        build(scene);
+    }
+}
+
+bool ModelBVH::needsRebuild(const Scene *scene) const {
+    const auto models = scene->getModels();
+    const auto modelCount = models[0];
+    if (_sceneHandles.size() != modelCount + 1) return true;
+
+    return memcmp(_sceneHandles.data(), models, sizeof(uint) * (modelCount + 1)) != 0;
+}
+
+void ModelBVH::build(const Scene *scene) {
+    const auto models = scene->getModels();
+    const auto modelCount = models[0];
+    _sceneHandles.assign(models, models + modelCount + 1);
+
+    _nodes.clear();
+    _buildEntries.clear();
+    _unboundedHandles.clear();
+    for (uint i = 1; i <= modelCount; ++i) {
+        const auto model = scene->getModelView(models[i]);
+        if (!model->worldBoundsID) {
+            _unboundedHandles.emplace_back(models[i]);
+            continue;
+        }
+
+        BuildEntry entry;
+        const auto bounds = model->getWorldBounds();
+        getBoundary(bounds, entry.minPos, entry.maxPos);
+        entry.center = bounds->center;
+        entry.handle = models[i];
+        _buildEntries.emplace_back(entry);
+    }
+
+    const auto boundedCount = static_cast<uint>(_buildEntries.size());
+    _leafOfModel.resize(boundedCount);
+    if (boundedCount) {
+        _nodes.reserve(2 * (boundedCount / LEAF_SIZE + 1));
+        _nodes.emplace_back();
+        buildNode(0, 0, boundedCount);
+    }
+
+    _modelHandles.resize(boundedCount);
+    for (uint i = 0; i < boundedCount; ++i) {
+        _modelHandles[i] = _buildEntries[i].handle;
+    }
+}
+
+void ModelBVH::buildNode(uint nodeIndex, uint first, uint count) {
+    _nodes[nodeIndex].first = first;
+    _nodes[nodeIndex].count = count;
+
+    if (count <= LEAF_SIZE) {
+        auto &node = _nodes[nodeIndex];
+        node.minPos = _buildEntries[first].minPos;
+        node.maxPos = _buildEntries[first].maxPos;
+        for (uint i = first; i < first + count; ++i) {
+            cc::Vec3::min(node.minPos, _buildEntries[i].minPos, &node.minPos);
+            cc::Vec3::max(node.maxPos, _buildEntries[i].maxPos, &node.maxPos);
+            _leafOfModel[i] = nodeIndex;
+        }
+        return;
+    }
+
+    // split at the median centroid along the longest axis
+    cc::Vec3 minCenter = _buildEntries[first].center;
+    cc::Vec3 maxCenter = minCenter;
+    for (uint i = first + 1; i < first + count; ++i) {
+        cc::Vec3::min(minCenter, _buildEntries[i].center, &minCenter);
+        cc::Vec3::max(maxCenter, _buildEntries[i].center, &maxCenter);
+    }
+    const cc::Vec3 extent = maxCenter - minCenter;
+    auto compare = [](uint axisIndex) {
+        return [axisIndex](const BuildEntry &a, const BuildEntry &b) {
+            return (&a.center.x)[axisIndex] < (&b.center.x)[axisIndex];
+        };
+    };
+    uint axisIndex = 0;
+    if (extent.y > extent.x && extent.y >= extent.z) axisIndex = 1;
+    else if (extent.z > extent.x && extent.z > extent.y) axisIndex = 2;
+
+    const uint half = count / 2;
+    auto begin = _buildEntries.begin() + first;
+    std::nth_element(begin, begin + half, begin + count, compare(axisIndex));
+
+    const auto left = static_cast<uint>(_nodes.size());
+    _nodes.emplace_back();
+    _nodes.emplace_back();
+    _nodes[nodeIndex].left = left;
+    _nodes[left].parent = nodeIndex;
+    _nodes[left + 1].parent = nodeIndex;
+
+    buildNode(left, first, half);
+    buildNode(left + 1, first + half, count - half);
+    refitInner(nodeIndex);
+}
+
+bool ModelBVH::refit(const Scene *scene) {
+    _dirtyLeaves.clear();
+    for (const auto handle : _unboundedHandles) {
+        if (scene->getModelView(handle)->worldBoundsID) return false;
+    }
+
+    const auto boundedCount = static_cast<uint>(_modelHandles.size());
+    for (uint i = 0; i < boundedCount; ++i) {
+        const auto model = scene->getModelView(_modelHandles[i]);
+        if (!model->worldBoundsID) return false;
+        if (!model->transformID || !model->getTransform()->flagsChanged) continue;
+
+        auto &leaf = _nodes[_leafOfModel[i]];
+        if (!leaf.dirty) {
+            leaf.dirty = true;
+            _dirtyLeaves.emplace_back(_leafOfModel[i]);
+        }
+    }
+
+    for (const auto leafIndex : _dirtyLeaves) {
+        refitLeaf(scene, leafIndex);
+        _nodes[leafIndex].dirty = false;
+
+        // walk up until the root, every dirty leaf refreshes its own path
+        auto nodeIndex = leafIndex;
+        while (nodeIndex != 0) {
+            nodeIndex = _nodes[nodeIndex].parent;
+            refitInner(nodeIndex);
+        }
+    }
+
+    return true;
+}
+
+void ModelBVH::refitLeaf(const Scene *scene, uint nodeIndex) {
+    auto &node = _nodes[nodeIndex];
+    getBoundary(scene->getModelView(_modelHandles[node.first])->getWorldBounds(), node.minPos, node.maxPos);
+
+    cc::Vec3 minPos, maxPos;
+    for (uint i = node.first + 1; i < node.first + node.count; ++i) {
+        getBoundary(scene->getModelView(_modelHandles[i])->getWorldBounds(), minPos, maxPos);
+        cc::Vec3::min(node.minPos, minPos, &node.minPos);
+        cc::Vec3::max(node.maxPos, maxPos, &node.maxPos);
+    }
+}
+
+void ModelBVH::refitInner(uint nodeIndex) {
+    auto &node = _nodes[nodeIndex];
+    const auto &left = _nodes[node.left];
+    const auto &right = _nodes[node.left + 1];
+    cc::Vec3::min(left.minPos, right.minPos, &node.minPos);
+    cc::Vec3::max(left.maxPos, right.maxPos, &node.maxPos);
+}
+
+void ModelBVH::appendRange(const BVHNode &node, UintList &modelHandles) const {
+    modelHandles.insert(modelHandles.end(), _modelHandles.begin() + node.first, _modelHandles.begin() + node.first + node.count);
+}
+
+void ModelBVH::query(const Frustum *frustum, UintList &modelHandles) const {
+    modelHandles.insert(modelHandles.end(), _unboundedHandles.begin(), _unboundedHandles.end());
+    if (_nodes.empty()) return;
+
+    uint stack[MAX_TRAVERSAL_DEPTH];
+    uint stackSize = 0;
+    stack[stackSize++] = 0;
+
+    AABB aabb;
+    while (stackSize) {
+        const auto &node = _nodes[stack[--stackSize]];
+        toAABB(node.minPos, node.maxPos, aabb);
+
+        bool outside = false, intersect = false;
+        for (const auto &plane : frustum->planes) {
+            const auto result = aabb_plane(&aabb, &plane);
+            if (result == -1) {
+                outside = true;
+                break;
+            }
+            if (result == 1) intersect = true;
+        }
+
+        if (outside) continue;
+        if (!intersect) {
+            // the whole subtree is inside the frustum
+            appendRange(node, modelHandles);
+        } else if (!node.left) {
+            for (uint i = node.first; i < node.first + node.count; ++i) {
+                const auto model = GET_MODEL(_modelHandles[i]);
+                if (aabb_frustum(model->getWorldBounds(), frustum)) {
+                    modelHandles.emplace_back(_modelHandles[i]);
+                }
+            }
+        } else {
+            CCASSERT(stackSize + 2 <= MAX_TRAVERSAL_DEPTH, "ModelBVH: traversal stack overflow");
+            stack[stackSize++] = node.left;
+            stack[stackSize++] = node.left + 1;
+        }
+    }
+}
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "../Define.h"
+#include "SharedMemory.h"
+
+namespace cc {
+namespace pipeline {
+
+// Bounding volume hierarchy over the models of a scene, keyed on ModelView::worldBoundsID.
+// The tree is rebuilt when the scene's model set changes or it was not updated in
+// the previous frame, and only refit along the paths of models whose transform
+// has flagsChanged set.
+class CC_DLL ModelBVH final : public Object {
+public:
+    static constexpr uint LEAF_SIZE = 8;
+
+    // Rebuilds or refits the tree, at most once per frame.
+    void update(const Scene *scene, uint frame);
+    // Collects handles of models whose bounds are not outside the frustum,
+    // models without world bounds are always collected.
+    void query(const Frustum *frustum, UintList &modelHandles) const;
+
+    CC_INLINE uint getModelCount() const { return static_cast<uint>(_modelHandles.size() + _unboundedHandles.size()); }
+
+private:
+    struct BVHNode {
+        cc::Vec3 minPos;
+        cc::Vec3 maxPos;
+        uint parent = 0;
+        uint left = 0;  // right child is left + 1, leaves have no children
+        uint first = 0; // range into _modelHandles covered by this subtree
+        uint count = 0;
+        bool dirty = false;
+    };
+
+    struct BuildEntry {
+        cc::Vec3 center;
+        cc::Vec3 minPos;
+        cc::Vec3 maxPos;
+        uint handle = 0;
+    };
+
+    bool needsRebuild(const Scene *scene) const;
+    void build(const Scene *scene);
+    void buildNode(uint nodeIndex, uint first, uint count);
+    bool refit(const Scene *scene);
+    void refitLeaf(const Scene *scene, uint nodeIndex);
+    void refitInner(uint nodeIndex);
+    void appendRange(const BVHNode &node, UintList &modelHandles) const;
+
+    vector<BVHNode> _nodes;
+    UintList _modelHandles;     // bounded models in leaf order
+    UintList _leafOfModel;      // leaf node index for every entry of _modelHandles
+    UintList _unboundedHandles; // models without world bounds
+    UintList _sceneHandles;     // copy of the scene handle array to detect changes
+    vector<BuildEntry> _buildEntries;
+    UintList _dirtyLeaves;
+    uint _lastUpdateFrame = 0xffffffff;
+};
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,60 @@
+#include "ModelCullingData.h"
+
+namespace cc {
+namespace pipeline {
+
+void ModelCullingData::update(const Scene *scene, uint frame) {
+    if (frame == _lastUpdateFrame) return;
+    // the dirty bits only hold the writes since the previous frame, those of the frames the scene was not culled
+    // in are gone
+    const bool isConsecutive = frame == _lastUpdateFrame + 1;
+    _lastUpdateFrame = frame;
+
+    const auto models = scene->getModels();
+    const auto modelCount = models[0];
+    if (!isConsecutive || _sceneHandles.size() != modelCount + 1 || memcmp(_sceneHandles.data(), models, sizeof(uint) * (modelCount + 1))) {
+        _sceneHandles.assign(models, models + modelCount + 1);
+        _models.resize(modelCount);
+        _sources.resize(modelCount);
+        for (uint i = 0; i < modelCount; ++i) {
+            _models[i].handle = models[i + 1];
+            pack(i);
+        }
+        return;
+    }
+
+    const auto *modelPool = se::BufferPool::getPool(se::PoolType::MODEL);
+    const auto *nodePool = se::BufferPool::getPool(se::PoolType::NODE);
+    const auto *aabbPool = se::BufferPool::getPool(se::PoolType::AABB);
+    for (uint i = 0; i < modelCount; ++i) {
+        const auto &source = _sources[i];
+        // the dirty bits are dense, checking them stays clear of the pools themselves
+        if (modelPool->isDirty(_models[i].handle) ||
+            (source.nodeID && nodePool->isDirty(source.nodeID)) ||
+            (source.worldBoundsID && aabbPool->isDirty(source.worldBoundsID))) {
+            pack(i);
+        }
+    }
+}
+
+void ModelCullingData::pack(uint index) {
+    auto &packed = _models[index];
+    auto &source = _sources[index];
+    const auto *model = GET_MODEL(packed.handle);
+    source.nodeID = model->nodeID;
+    source.worldBoundsID = model->worldBoundsID;
+
+    packed.visFlags = model->visFlags;
+    packed.layer = model->nodeID ? model->getNode()->layer : 0;
+    packed.flags = 0;
+    if (model->enabled) packed.flags |= PackedModel::ENABLED;
+    if (model->nodeID) packed.flags |= PackedModel::HAS_NODE;
+    if (model->castShadow) packed.flags |= PackedModel::CAST_SHADOW;
+    if (model->worldBoundsID) {
+        packed.flags |= PackedModel::HAS_BOUNDS;
+        packed.worldBounds = *model->getWorldBounds();
+    }
+}
+
+} // namespace pipeline
+} // namespace cc
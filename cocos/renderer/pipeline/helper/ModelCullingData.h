@@ -0,0 +1,53 @@
+#pragma once
+
+#include "../Define.h"
+#include "SharedMemory.h"
+
+namespace cc {
+namespace pipeline {
+
+// What culling reads of a model, packed so the culling loops walk one array instead of the model, node and AABB
+// pools. Entries follow the order of the scene handle array.
+struct CC_DLL PackedModel {
+    static constexpr uint ENABLED = 1 << 0;
+    static constexpr uint HAS_NODE = 1 << 1;
+    static constexpr uint HAS_BOUNDS = 1 << 2;
+    static constexpr uint CAST_SHADOW = 1 << 3;
+
+    uint32_t handle = 0;
+    uint32_t visFlags = 0;
+    uint32_t layer = 0;
+    uint32_t flags = 0;
+    AABB worldBounds;
+
+    CC_INLINE bool isVisible(uint visibility) const {
+        return (flags & ENABLED) && (((flags & HAS_NODE) && (visibility & layer) == layer) || (visibility & visFlags));
+    }
+};
+
+// Packed culling data of the models of a scene. Repacked whole when the scene's model set changes or it was not
+// updated in the previous frame, otherwise only the entries whose model, node or world bounds the script side
+// flagged dirty in their BufferPool are read again.
+class CC_DLL ModelCullingData final : public Object {
+public:
+    // Repacks the changed entries, at most once per frame.
+    void update(const Scene *scene, uint frame);
+
+    CC_INLINE const vector<PackedModel> &getModels() const { return _models; }
+
+private:
+    struct Source {
+        uint32_t nodeID = 0;
+        uint32_t worldBoundsID = 0;
+    };
+
+    void pack(uint index);
+
+    vector<PackedModel> _models;
+    vector<Source> _sources;
+    UintList _sceneHandles; // copy of the scene handle array to detect changes
+    uint _lastUpdateFrame = 0xffffffff;
+};
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,116 @@
+#include "MorphSystem.h"
+
+#include "base/Log.h"
+#include "gfx/GFXBuffer.h"
+#include "gfx/GFXDescriptorSet.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cc {
+namespace pipeline {
+namespace {
+constexpr float WEIGHT_EPSILON = 1e-6f;
+constexpr uint WEIGHTS_OFFSET = UBOMorph::OFFSET_OF_WEIGHTS / sizeof(float);
+constexpr uint TEXTURE_INFO_OFFSET = UBOMorph::OFFSET_OF_DISPLACEMENT_TEXTURE_WIDTH / sizeof(float);
+constexpr uint TARGETS_OFFSET = UBOMorph::OFFSET_OF_TARGETS / sizeof(float);
+} // namespace
+
+MorphSystem *MorphSystem::_instance = nullptr;
+
+MorphSystem *MorphSystem::getInstance() {
+    if (!_instance) _instance = CC_NEW(MorphSystem);
+    return _instance;
+}
+
+void MorphSystem::destroyInstance() {
+    CC_SAFE_DELETE(_instance);
+}
+
+void MorphSystem::addModel(uint handle) {
+    const auto it = std::find_if(_models.begin(), _models.end(), [handle](const Target &target) { return target.handle == handle; });
+    if (it != _models.end()) return;
+    Target target;
+    target.handle = handle;
+    _models.push_back(std::move(target));
+}
+
+void MorphSystem::removeModel(uint handle) {
+    const auto it = std::find_if(_models.begin(), _models.end(), [handle](const Target &target) { return target.handle == handle; });
+    if (it != _models.end()) _models.erase(it);
+}
+
+void MorphSystem::update() {
+    for (auto &target : _models) update(target);
+}
+
+void MorphSystem::update(Target &target) {
+    const MorphView *view = GET_MORPH(target.handle);
+    const SubModelView *subModel = view ? view->getSubModel() : nullptr;
+    gfx::DescriptorSet *descriptorSet = subModel ? subModel->getDescriptorSet() : nullptr;
+    gfx::Buffer *buffer = descriptorSet ? descriptorSet->getBuffer(UBOMorph::BINDING) : nullptr;
+    if (!buffer) return;
+
+    uint weightSize = 0;
+    uint rangeSize = 0;
+    const float *weights = view->getWeights(&weightSize);
+    const auto *ranges = reinterpret_cast<const MorphTargetRange *>(view->getRanges(&rangeSize));
+    if (!weights || !ranges) return;
+    const uint targetCount = std::min({view->targetCount, weightSize / static_cast<uint>(sizeof(float)),
+                                       rangeSize / static_cast<uint>(sizeof(MorphTargetRange))});
+
+    _data.assign(UBOMorph::SIZE / sizeof(float), 0.f);
+    uint activeCount = 0;
+    for (uint i = 0; i < targetCount; ++i) {
+        if (std::fabs(weights[i]) < WEIGHT_EPSILON || !ranges[i].vertexCount) continue;
+        if (activeCount == UBOMorph::MAX_MORPH_TARGET_COUNT) {
+            CC_LOG_WARNING("MorphSystem: more than %u active targets, the others are dropped", UBOMorph::MAX_MORPH_TARGET_COUNT);
+            break;
+        }
+        _data[WEIGHTS_OFFSET + activeCount] = weights[i];
+        float *range = &_data[TARGETS_OFFSET + activeCount * 4];
+        range[0] = static_cast<float>(ranges[i].texelOffset);
+        range[1] = static_cast<float>(ranges[i].firstVertex);
+        range[2] = static_cast<float>(ranges[i].vertexCount);
+        range[3] = static_cast<float>(i);
+        ++activeCount;
+    }
+    _data[TEXTURE_INFO_OFFSET] = static_cast<float>(view->textureWidth);
+    _data[TEXTURE_INFO_OFFSET + 1] = static_cast<float>(view->textureHeight);
+    _data[TEXTURE_INFO_OFFSET + 2] = static_cast<float>(view->vertexCount);
+    _data[TEXTURE_INFO_OFFSET + 3] = static_cast<float>(activeCount);
+
+    // only the targets in use are written, and nothing while the weights hold still
+    const size_t floatCount = TARGETS_OFFSET + activeCount * 4;
+    if (target.data.size() == floatCount && std::equal(_data.begin(), _data.begin() + floatCount, target.data.begin())) return;
+    target.data.assign(_data.begin(), _data.begin() + floatCount);
+    buffer->update(_data.data(), 0, std::min(buffer->getSize(), static_cast<uint>(floatCount * sizeof(float))));
+}
+
+uint MorphSystem::packSparseDeltas(const float *deltas, uint targetCount, uint vertexCount, vector<float> &texels, MorphTargetRange *ranges) {
+    texels.clear();
+    for (uint t = 0; t < targetCount; ++t) {
+        const float *target = deltas + static_cast<size_t>(t) * vertexCount * 3;
+        uint first = vertexCount;
+        uint last = 0;
+        for (uint v = 0; v < vertexCount; ++v) {
+            const float *delta = target + v * 3;
+            if (delta[0] == 0.f && delta[1] == 0.f && delta[2] == 0.f) continue;
+            first = std::min(first, v);
+            last = v;
+        }
+
+        MorphTargetRange &range = ranges[t];
+        range.texelOffset = static_cast<uint32_t>(texels.size() / 4);
+        range.firstVertex = first < vertexCount ? first : 0;
+        range.vertexCount = first < vertexCount ? last - first + 1 : 0;
+        for (uint v = range.firstVertex; v < range.firstVertex + range.vertexCount; ++v) {
+            const float *delta = target + v * 3;
+            texels.insert(texels.end(), {delta[0], delta[1], delta[2], 0.f});
+        }
+    }
+    return static_cast<uint>(texels.size() / 4);
+}
+
+} // namespace pipeline
+} // namespace cc
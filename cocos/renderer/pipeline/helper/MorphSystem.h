@@ -0,0 +1,56 @@
+#pragma once
+
+#include "../Define.h"
+#include "SharedMemory.h"
+
+namespace cc {
+namespace pipeline {
+
+// Vertices of a target in its displacement textures: the deltas of vertices [firstVertex, firstVertex + vertexCount)
+// start from texelOffset, one RGBA32F texel each. The vertices a target doesn't move keep no texel.
+struct CC_DLL MorphTargetRange {
+    uint32_t texelOffset = 0;
+    uint32_t firstVertex = 0;
+    uint32_t vertexCount = 0;
+    uint32_t padding = 0;
+};
+
+// Morph weights of the sub-models JS adds with their MorphView handle.
+// update() drops the targets of zero weight and writes the others into UBOMorph, compacted: weight i and
+// cc_displacementTargets[i] = (texelOffset, firstVertex, vertexCount, target) belong to the i-th active target, and
+// cc_displacementTextureInfo.w holds their count. The vertex shader loops over the active targets only and fetches
+// a delta where its vertex is in the range, the cost follows the targets in use instead of the targets of the mesh.
+class CC_DLL MorphSystem final : public Object {
+public:
+    static MorphSystem *getInstance();
+    static void destroyInstance();
+
+    void addModel(uint handle);
+    void removeModel(uint handle);
+
+    // Runs once the animations of the frame wrote the weights.
+    void update();
+
+    CC_INLINE uint getModelCount() const { return static_cast<uint>(_models.size()); }
+
+    // Packs the displacements of the targets, 3 floats a vertex and vertexCount vertices a target, into the RGBA32F
+    // texels of the vertices between the first and the last one each target moves. ranges takes targetCount entries,
+    // returns the texel count.
+    static uint packSparseDeltas(const float *deltas, uint targetCount, uint vertexCount, vector<float> &texels, MorphTargetRange *ranges);
+
+private:
+    struct Target {
+        uint handle = 0;
+        vector<float> data; // UBOMorph last uploaded
+    };
+
+    void update(Target &target);
+
+    vector<Target> _models;
+    vector<float> _data;
+
+    static MorphSystem *_instance;
+};
+
+} // namespace pipeline
+} // namespace cc
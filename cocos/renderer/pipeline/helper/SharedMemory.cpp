@@ -5,26 +5,26 @@
 namespace cc {
 namespace pipeline {
 
-const se::PoolType ModelView::type = se::PoolType::MODEL;
-const se::PoolType SubModelView::type = se::PoolType::SUB_MODEL;
-const se::PoolType PassView::type = se::PoolType::PASS;
-const se::PoolType Camera::type = se::PoolType::CAMERA;
-const se::PoolType AABB::type = se::PoolType::AABB;
-const se::PoolType Frustum::type = se::PoolType::FRUSTUM;
-const se::PoolType Scene::type = se::PoolType::SCENE;
-const se::PoolType Light::type = se::PoolType::LIGHT;
-const se::PoolType Ambient::type = se::PoolType::AMBIENT;
-const se::PoolType Fog::type = se::PoolType::FOG;
-const se::PoolType Skybox::type = se::PoolType::SKYBOX;
-const se::PoolType InstancedAttributeView::type = se::PoolType::INSTANCED_ATTRIBUTE;
-const se::PoolType FlatBufferView::type = se::PoolType::FLAT_BUFFER;
-const se::PoolType RenderingSubMesh::type = se::PoolType::SUB_MESH;
-const se::PoolType Node::type = se::PoolType::NODE;
-const se::PoolType Root::type = se::PoolType::ROOT;
-const se::PoolType RenderWindow::type = se::PoolType::RENDER_WINDOW;
-const se::PoolType Shadows::type = se::PoolType::SHADOW;
-const se::PoolType Sphere::type = se::PoolType::SPHERE;
-const se::PoolType UIBatch::type = se::PoolType::UI_BATCH;
+constexpr se::PoolType ModelView::type;
+constexpr se::PoolType SubModelView::type;
+constexpr se::PoolType PassView::type;
+constexpr se::PoolType Camera::type;
+constexpr se::PoolType AABB::type;
+constexpr se::PoolType Frustum::type;
+constexpr se::PoolType Scene::type;
+constexpr se::PoolType Light::type;
+constexpr se::PoolType Ambient::type;
+constexpr se::PoolType Fog::type;
+constexpr se::PoolType Skybox::type;
+constexpr se::PoolType InstancedAttributeView::type;
+constexpr se::PoolType FlatBufferView::type;
+constexpr se::PoolType RenderingSubMesh::type;
+constexpr se::PoolType Node::type;
+constexpr se::PoolType Root::type;
+constexpr se::PoolType RenderWindow::type;
+constexpr se::PoolType Shadows::type;
+constexpr se::PoolType Sphere::type;
+constexpr se::PoolType UIBatch::type;
 
 void AABB::getBoundary(cc::Vec3 &minPos, cc::Vec3 &maxPos) const {
     minPos = center - halfExtents;
@@ -168,6 +168,21 @@ bool aabb_frustum(const AABB *aabb, const Frustum *frustum) {
     return 1;
 }
 
+void aabb_frustum_batch(const AABBBatch &batch, const Frustum *frustum, uint8_t *results) {
+    float planes[PLANE_LENGTH * 4];
+    for (uint i = 0; i < PLANE_LENGTH; i++) {
+        const auto &plane = frustum->planes[i];
+        planes[i * 4] = plane.normal.x;
+        planes[i * 4 + 1] = plane.normal.y;
+        planes[i * 4 + 2] = plane.normal.z;
+        planes[i * 4 + 3] = plane.distance;
+    }
+
+    MathUtil::cullAABBs(batch.centerX, batch.centerY, batch.centerZ,
+                        batch.extentX, batch.extentY, batch.extentZ,
+                        batch.count, planes, PLANE_LENGTH, results);
+}
+
 gfx::BlendState *getBlendStateImpl(uint index) {
     static gfx::BlendState blendState;
     auto buffer = SharedMemory::getBuffer<uint32_t>(se::PoolType::BLEND_STATE, index);
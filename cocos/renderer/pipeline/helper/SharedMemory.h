@@ -43,6 +43,8 @@ extern gfx::BlendState *getBlendStateImpl(uint index);
 #define GET_BLEND_TARGET(index)        SharedMemory::getBuffer<gfx::BlendTarget>(se::PoolType::BLEND_TARGET, index)
 #define GET_BLEND_STATE(index)         getBlendStateImpl(index)
 #define GET_UI_BATCH(index)              SharedMemory::getBuffer<UIBatch>(index)
+#define GET_SKINNING(index)            SharedMemory::getBuffer<SkinningView>(index)
+#define GET_MORPH(index)               SharedMemory::getBuffer<MorphView>(index)
 
 //Get object pool data
 #define GET_DESCRIPTOR_SET(index)  SharedMemory::getObject<gfx::DescriptorSet, se::PoolType::DESCRIPTOR_SETS>(index)
@@ -61,6 +63,7 @@ extern gfx::BlendState *getBlendStateImpl(uint index);
 #define GET_LIGHT_ARRAY(index)               SharedMemory::getHandleArray(se::PoolType::LIGHT_ARRAY, index)
 #define GET_BLEND_TARGET_ARRAY(index)        SharedMemory::getHandleArray(se::PoolType::BLEND_TARGET_ARRAY, index)
 #define GET_UI_BATCH_ARRAY(index)        SharedMemory::getHandleArray(se::PoolType::UI_BATCH_ARRAY, index)
+#define GET_NODE_ARRAY(index)                SharedMemory::getHandleArray(se::PoolType::NODE_ARRAY, index)
 
 // Get raw buffer or gfx object.
 #define GET_RAW_BUFFER(index, size) SharedMemory::getRawBuffer<uint8_t>(se::PoolType::RAW_BUFFER, index, size)
@@ -72,35 +75,19 @@ class CC_DLL SharedMemory : public Object {
 public:
     template <typename T>
     static T *getBuffer(uint index) {
-        const auto &bufferMap = se::BufferPool::getPoolMap();
-        if (bufferMap.count(T::type) != 0) {
-            const se::BufferPool *bufferPool = bufferMap.at(T::type);
-            return bufferPool->getTypedObject<T>(index);
-        } else {
-            return nullptr;
-        }
+        return getBuffer<T>(T::type, index);
     }
 
     template <typename T>
     static T *getBuffer(se::PoolType poolType, uint index) {
-        const auto &bufferMap = se::BufferPool::getPoolMap();
-        if (bufferMap.count(poolType) != 0) {
-            const se::BufferPool *bufferPool = bufferMap.at(poolType);
-            return bufferPool->getTypedObject<T>(index);
-        } else {
-            return nullptr;
-        }
+        const se::BufferPool *bufferPool = se::BufferPool::getPool(poolType);
+        return bufferPool ? bufferPool->getTypedObject<T>(index) : nullptr;
     }
 
     template <typename T, se::PoolType p>
     static T *getObject(uint index) {
-        const auto &poolMap = se::ObjectPool::getPoolMap();
-        if (poolMap.count(p) != 0) {
-            const se::ObjectPool *objectPool = poolMap.at(p);
-            return objectPool->getTypedObject<T>(index);
-        } else {
-            return nullptr;
-        }
+        const se::ObjectPool *objectPool = se::ObjectPool::getPool(p);
+        return objectPool ? objectPool->getTypedObject<T>(index) : nullptr;
     }
 
     static uint32_t *getHandleArray(se::PoolType type, uint index) {
@@ -126,7 +113,7 @@ struct CC_DLL Node {
     cc::Vec4 worldRotation;
     cc::Mat4 worldMatrix;
 
-    const static se::PoolType type;
+    static constexpr se::PoolType type = se::PoolType::NODE;
 };
 
 struct CC_DLL AABB {
@@ -136,7 +123,7 @@ struct CC_DLL AABB {
     void getBoundary(cc::Vec3 &minPos, cc::Vec3 &maxPos) const;
     void merge(const AABB &aabb);
 
-    const static se::PoolType type;
+    static constexpr se::PoolType type = se::PoolType::AABB;
 };
 bool aabb_aabb(const AABB *, const AABB *);
 
@@ -150,10 +137,39 @@ struct CC_DLL Frustum {
     cc::Vec3 vertices[8];
     Plane planes[PLANE_LENGTH];
 
-    const static se::PoolType type;
+    static constexpr se::PoolType type = se::PoolType::FRUSTUM;
 };
+// returns -1 if the aabb is outside the plane, 0 if it is completely inside and 1 if they intersect
+int aabb_plane(const AABB *, const Plane *);
 bool aabb_frustum(const AABB *, const Frustum *);
 
+// Structure-of-arrays copy of world bounds, tested against a frustum in one batch.
+struct CC_DLL AABBBatch {
+    static constexpr uint CAPACITY = 64;
+
+    alignas(16) float centerX[CAPACITY];
+    alignas(16) float centerY[CAPACITY];
+    alignas(16) float centerZ[CAPACITY];
+    alignas(16) float extentX[CAPACITY];
+    alignas(16) float extentY[CAPACITY];
+    alignas(16) float extentZ[CAPACITY];
+    uint count = 0;
+
+    CC_INLINE bool full() const { return count == CAPACITY; }
+    CC_INLINE void clear() { count = 0; }
+    CC_INLINE void add(const AABB *aabb) {
+        centerX[count] = aabb->center.x;
+        centerY[count] = aabb->center.y;
+        centerZ[count] = aabb->center.z;
+        extentX[count] = aabb->halfExtents.x;
+        extentY[count] = aabb->halfExtents.y;
+        extentZ[count] = aabb->halfExtents.z;
+        ++count;
+    }
+};
+// results[i] is non-zero for every box of the batch that is not completely outside the frustum
+void aabb_frustum_batch(const AABBBatch &, const Frustum *, uint8_t *results);
+
 enum class LightType {
     DIRECTIONAL,
     SPHERE,
@@ -181,7 +197,7 @@ struct CC_DLL Light {
     CC_INLINE const AABB *getAABB() const { return GET_AABB(aabbID); }
     CC_INLINE const Frustum *getFrustum() const { return GET_FRUSTUM(frustumID); }
 
-    const static se::PoolType type;
+    static constexpr se::PoolType type = se::PoolType::LIGHT;
 };
 
 struct CC_DLL FlatBufferView {
@@ -191,7 +207,7 @@ struct CC_DLL FlatBufferView {
 
     CC_INLINE uint8_t *getBuffer(uint *size) const { return GET_RAW_BUFFER(bufferID, size); }
 
-    const static se::PoolType type;
+    static constexpr se::PoolType type = se::PoolType::FLAT_BUFFER;
 };
 
 struct CC_DLL InstancedAttributeView {
@@ -202,7 +218,7 @@ struct CC_DLL InstancedAttributeView {
 
     CC_INLINE const uint8_t *getBuffer(uint *size) const { return GET_RAW_BUFFER(bufferID, size); }
 
-    const static se::PoolType type;
+    static constexpr se::PoolType type = se::PoolType::INSTANCED_ATTRIBUTE;
 };
 
 struct CC_DLL RenderingSubMesh {
@@ -211,7 +227,7 @@ struct CC_DLL RenderingSubMesh {
     CC_INLINE const uint *getFlatBufferArrayID() const { return GET_FLAT_BUFFER_ARRAY(flatBuffersID); }
     CC_INLINE const FlatBufferView *getFlatBuffer(uint idx) const { return GET_FLAT_BUFFER(idx); }
 
-    const static se::PoolType type;
+    static constexpr se::PoolType type = se::PoolType::SUB_MESH;
 };
 
 enum class CC_DLL BatchingSchemes {
@@ -242,7 +258,7 @@ struct CC_DLL PassView {
     CC_INLINE gfx::DescriptorSet *getDescriptorSet() const { return GET_DESCRIPTOR_SET(descriptorSetID); }
     CC_INLINE gfx::PipelineLayout *getPipelineLayout() const { return GET_PIPELINE_LAYOUT(pipelineLayoutID); }
 
-    const static se::PoolType type;
+    static constexpr se::PoolType type = se::PoolType::PASS;
 };
 
 struct CC_DLL SubModelView {
@@ -260,7 +276,7 @@ struct CC_DLL SubModelView {
     CC_INLINE gfx::InputAssembler *getInputAssembler() const { return GET_IA(inputAssemblerID); }
     CC_INLINE const RenderingSubMesh *getSubMesh() const { return GET_RENDER_SUBMESH(subMeshID); }
 
-    const static se::PoolType type;
+    static constexpr se::PoolType type = se::PoolType::SUB_MODEL;
 };
 
 struct CC_DLL ModelView {
@@ -274,6 +290,7 @@ struct CC_DLL ModelView {
     uint32_t subModelsID = 0;       // array pool id
     uint32_t instancedBufferID = 0; // raw buffer id
     uint32_t instancedAttrsID = 0;  // array pool id
+    uint32_t instanceCount = 0;     // instances packed in the instanced buffer, 0 takes the whole buffer as one
 
     CC_INLINE const AABB *getWorldBounds() const { return GET_AABB(worldBoundsID); }
     CC_INLINE const Node *getNode() const { return GET_NODE(nodeID); }
@@ -283,7 +300,7 @@ struct CC_DLL ModelView {
     CC_INLINE const uint8_t *getInstancedBuffer(uint *size) const { return GET_RAW_BUFFER(instancedBufferID, size); }
     CC_INLINE const uint *getInstancedAttributeID() const { return GET_ATTRIBUTE_ARRAY(instancedAttrsID); }
     CC_INLINE gfx::Attribute *getInstancedAttribute(uint idx) const { return GET_ATTRIBUTE(idx); }
-    const static se::PoolType type;
+    static constexpr se::PoolType type = se::PoolType::MODEL;
 };
 
 struct CC_DLL UIBatch {
@@ -299,7 +316,46 @@ struct CC_DLL UIBatch {
     CC_INLINE gfx::DescriptorSet *getDescriptorSet() const { return GET_DESCRIPTOR_SET(descriptorSetID); }
     CC_INLINE gfx::InputAssembler *getInputAssembler() const { return GET_IA(inputAssemblerID); }
     
-    const static se::PoolType type;
+    static constexpr se::PoolType type = se::PoolType::UI_BATCH;
+};
+
+// Joints of a skinned model computed by the native SkinningSystem.
+struct CC_DLL SkinningView {
+    uint32_t mode = 0;          // SkinningMode
+    uint32_t modelID = 0;       // the descriptor sets of its sub-models receive the joints
+    uint32_t rootID = 0;        // node, the joints are uploaded relative to it
+    uint32_t jointsID = 0;      // array pool id, node of every joint
+    uint32_t bindPosesID = 0;   // raw buffer id, inverse bind matrix of every joint
+    uint32_t textureOffset = 0; // first texel of the joints in the joint texture
+    uint32_t frameCount = 0;    // frames of the baked animation
+    float frameRate = 0.f;
+    float time = 0.f; // baked animation time in seconds, advanced by the SkinningSystem
+    float speed = 1.f;
+
+    CC_INLINE const ModelView *getModel() const { return GET_MODEL(modelID); }
+    CC_INLINE const Node *getRoot() const { return GET_NODE(rootID); }
+    CC_INLINE const uint *getJoints() const { return GET_NODE_ARRAY(jointsID); }
+    CC_INLINE const uint8_t *getBindPoses(uint *size) const { return GET_RAW_BUFFER(bindPosesID, size); }
+
+    static constexpr se::PoolType type = se::PoolType::SKINNING;
+};
+
+// Morph targets of a sub-model evaluated from sparse displacement textures, the native MorphSystem uploads the
+// targets of non-zero weight into the UBOMorph of its descriptor set.
+struct CC_DLL MorphView {
+    uint32_t subModelID = 0;
+    uint32_t targetCount = 0;
+    uint32_t weightsID = 0; // raw buffer id, weight of every target, written by JS
+    uint32_t rangesID = 0;  // raw buffer id, MorphTargetRange of every target
+    uint32_t textureWidth = 0;
+    uint32_t textureHeight = 0;
+    uint32_t vertexCount = 0;
+
+    CC_INLINE const SubModelView *getSubModel() const { return GET_SUBMODEL(subModelID); }
+    CC_INLINE const float *getWeights(uint *size) const { return reinterpret_cast<const float *>(GET_RAW_BUFFER(weightsID, size)); }
+    CC_INLINE const uint8_t *getRanges(uint *size) const { return GET_RAW_BUFFER(rangesID, size); }
+
+    static constexpr se::PoolType type = se::PoolType::MORPH;
 };
 
 struct CC_DLL Scene {
@@ -318,7 +374,7 @@ struct CC_DLL Scene {
     CC_INLINE const ModelView *getModelView(uint idx) const { return GET_MODEL(idx); }
     CC_INLINE const uint *getUIBatches() const {return GET_UI_BATCH_ARRAY(uiBatches);}
 
-    const static se::PoolType type;
+    static constexpr se::PoolType type = se::PoolType::SCENE;
 };
 
 struct CC_DLL RenderWindow {
@@ -328,7 +384,7 @@ struct CC_DLL RenderWindow {
 
     CC_INLINE gfx::Framebuffer *getFramebuffer() const { return GET_FRAMEBUFFER(framebufferID); }
 
-    const static se::PoolType type;
+    static constexpr se::PoolType type = se::PoolType::RENDER_WINDOW;
 };
 
 struct CC_DLL Camera {
@@ -361,7 +417,7 @@ struct CC_DLL Camera {
     CC_INLINE const Frustum *getFrustum() const { return GET_FRUSTUM(frustumID); }
     CC_INLINE const RenderWindow *getWindow() const { return GET_WINDOW(windowID); }
     
-    const static se::PoolType type;
+    static constexpr se::PoolType type = se::PoolType::CAMERA;
 };
 
 struct CC_DLL Ambient {
@@ -370,7 +426,7 @@ struct CC_DLL Ambient {
     cc::Vec4 skyColor;
     cc::Vec4 groundAlbedo;
 
-    const static se::PoolType type;
+    static constexpr se::PoolType type = se::PoolType::AMBIENT;
 };
 
 struct CC_DLL Fog {
@@ -384,7 +440,7 @@ struct CC_DLL Fog {
     float fogRange = 0;
     cc::Vec4 fogColor;
 
-    const static se::PoolType type;
+    static constexpr se::PoolType type = se::PoolType::FOG;
 };
 
 struct CC_DLL Sphere {
@@ -399,7 +455,7 @@ struct CC_DLL Sphere {
     bool interset(const Frustum &frustum) const;
     int interset(const Plane &plane) const;
 
-    const static se::PoolType type;
+    static constexpr se::PoolType type = se::PoolType::SPHERE;
 };
 bool sphere_frustum(const Sphere *sphere, const Frustum *frustum);
 
@@ -429,13 +485,18 @@ struct CC_DLL Shadows {
     cc::Vec2 size;
     cc::Vec3 normal;
     cc::Mat4 matLight;
+    // planar shader variants of the sub-models drawn with instancing and batching, 0 draws them one by one
+    uint32_t instancingShader = 0;
+    uint32_t batchingShader = 0;
 
     CC_INLINE ShadowType getShadowType() const { return static_cast<ShadowType>(shadowType); }
     CC_INLINE PassView *getPlanarShadowPass() const { return GET_PASS(planarPass); }
     CC_INLINE PassView *getInstancePass() const { return GET_PASS(instancePass); }
     CC_INLINE gfx::Shader *getPlanarShader() const { return GET_SHADER(shader); }
+    CC_INLINE gfx::Shader *getPlanarInstancingShader() const { return instancingShader ? GET_SHADER(instancingShader) : nullptr; }
+    CC_INLINE gfx::Shader *getPlanarBatchingShader() const { return batchingShader ? GET_SHADER(batchingShader) : nullptr; }
 
-    const static se::PoolType type;
+    static constexpr se::PoolType type = se::PoolType::SHADOW;
 };
 
 struct CC_DLL Skybox {
@@ -446,14 +507,14 @@ struct CC_DLL Skybox {
 
     CC_INLINE const ModelView *getModel() const { return GET_MODEL(modelID); }
 
-    const static se::PoolType type;
+    static constexpr se::PoolType type = se::PoolType::SKYBOX;
 };
 
 struct CC_DLL Root {
     float cumulativeTime = 0;
     float frameTime = 0;
 
-    const static se::PoolType type;
+    static constexpr se::PoolType type = se::PoolType::ROOT;
 };
 
 } //namespace pipeline
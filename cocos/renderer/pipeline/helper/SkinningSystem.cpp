@@ -0,0 +1,272 @@
+#include "SkinningSystem.h"
+
+#include "base/JobSystem.h"
+#include "base/Log.h"
+#include "gfx/GFXBuffer.h"
+#include "gfx/GFXDescriptorSet.h"
+#include "gfx/GFXDevice.h"
+#include "gfx/GFXTexture.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cc {
+namespace pipeline {
+namespace {
+constexpr uint PARALLEL_MODEL_COUNT = 8; // fewer models are computed on the calling thread
+constexpr uint JOB_GRAIN_SIZE = 4;
+constexpr uint TEXELS_PER_JOINT = 3;
+constexpr uint TEXEL_SIZE = sizeof(float) * 4;
+constexpr uint INVALID_FRAME = 0xffffffff;
+
+CC_INLINE SkinningMode getMode(const SkinningView *view) { return static_cast<SkinningMode>(view->mode); }
+
+// advances the looping time of a baked animation, returns the frame it is at
+uint advanceFrame(SkinningView *view, float dt) {
+    if (!view->frameCount || view->frameRate <= 0.f) return 0;
+    const float duration = static_cast<float>(view->frameCount) / view->frameRate;
+    float time = std::fmod(view->time + dt * view->speed, duration);
+    if (time < 0.f) time += duration;
+    view->time = time;
+    return std::min(static_cast<uint>(time * view->frameRate), view->frameCount - 1);
+}
+} // namespace
+
+constexpr uint SkinningSystem::JOINT_FLOAT_COUNT;
+SkinningSystem *SkinningSystem::_instance = nullptr;
+
+SkinningSystem *SkinningSystem::getInstance() {
+    if (!_instance) _instance = CC_NEW(SkinningSystem);
+    return _instance;
+}
+
+void SkinningSystem::destroyInstance() {
+    CC_SAFE_DELETE(_instance);
+}
+
+void SkinningSystem::addModel(uint handle) {
+    const auto it = std::find_if(_models.begin(), _models.end(), [handle](const Target &target) { return target.handle == handle; });
+    if (it != _models.end()) return;
+    Target target;
+    target.handle = handle;
+    target.frame = INVALID_FRAME;
+    _models.push_back(target);
+}
+
+void SkinningSystem::removeModel(uint handle) {
+    const auto it = std::find_if(_models.begin(), _models.end(), [handle](const Target &target) { return target.handle == handle; });
+    if (it != _models.end()) _models.erase(it);
+}
+
+void SkinningSystem::packJoint(const Mat4 &joint, float *out) {
+    const float *m = joint.m;
+    out[0] = m[0];
+    out[1] = m[1];
+    out[2] = m[2];
+    out[3] = m[12];
+    out[4] = m[4];
+    out[5] = m[5];
+    out[6] = m[6];
+    out[7] = m[13];
+    out[8] = m[8];
+    out[9] = m[9];
+    out[10] = m[10];
+    out[11] = m[14];
+}
+
+void SkinningSystem::update(float dt) {
+    uint jointFloatCount = 0;
+    for (auto &target : _models) {
+        target.jointCount = 0;
+        target.isDirty = false;
+        SkinningView *view = GET_SKINNING(target.handle);
+        if (!view || !view->getModel()) continue;
+
+        if (getMode(view) == SkinningMode::BAKED) {
+            const uint frame = advanceFrame(view, dt);
+            target.isDirty = frame != target.frame;
+            target.frame = frame;
+            continue;
+        }
+        if (!prepare(view, target)) continue;
+        target.isDirty = true;
+        target.dataOffset = jointFloatCount;
+        jointFloatCount += target.jointCount * JOINT_FLOAT_COUNT;
+    }
+    if (_jointData.size() < jointFloatCount) _jointData.resize(jointFloatCount);
+
+    // models only read the nodes and write their own range of _jointData
+    const uint modelCount = static_cast<uint>(_models.size());
+    if (modelCount < PARALLEL_MODEL_COUNT) {
+        for (const auto &target : _models) computeJoints(target);
+    } else {
+        auto *jobSystem = JobSystem::getInstance();
+        jobSystem->wait(jobSystem->parallelFor(modelCount, JOB_GRAIN_SIZE, [this](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) computeJoints(_models[i]);
+        }));
+    }
+
+    // the device is only called from this thread
+    for (const auto &target : _models) {
+        if (target.isDirty) upload(target);
+    }
+}
+
+bool SkinningSystem::prepare(const SkinningView *view, Target &target) {
+    const uint *joints = view->getJoints();
+    uint bindPoseSize = 0;
+    const uint8_t *bindPoses = view->getBindPoses(&bindPoseSize);
+    if (!joints || !bindPoses) return false;
+
+    uint jointCount = std::min(joints[0], bindPoseSize / static_cast<uint>(sizeof(Mat4)));
+    if (getMode(view) == SkinningMode::UNIFORM && jointCount > JOINT_UNIFORM_CAPACITY) {
+        CC_LOG_WARNING("SkinningSystem: %u joints exceed the uniform capacity of %u, use texture skinning", jointCount, JOINT_UNIFORM_CAPACITY);
+        jointCount = JOINT_UNIFORM_CAPACITY;
+    }
+    target.jointCount = jointCount;
+    return jointCount > 0;
+}
+
+// The joints are gathered into batches and multiplied with the SIMD batch routines.
+void SkinningSystem::computeJoints(const Target &target) {
+    if (!target.jointCount) return;
+    const SkinningView *view = GET_SKINNING(target.handle);
+    const uint *joints = view->getJoints() + 1;
+    uint bindPoseSize = 0;
+    const auto *bindPoses = reinterpret_cast<const Mat4 *>(view->getBindPoses(&bindPoseSize));
+    const Node *root = view->getRoot();
+
+    Mat4 rootInverses[BATCH_SIZE];
+    Mat4 matrices[BATCH_SIZE];
+    const Mat4 rootInverse = root ? root->worldMatrix.getInversed() : Mat4::IDENTITY;
+    std::fill(rootInverses, rootInverses + std::min(target.jointCount, BATCH_SIZE), rootInverse);
+
+    float *out = _jointData.data() + target.dataOffset;
+    for (uint first = 0; first < target.jointCount; first += BATCH_SIZE) {
+        const uint count = std::min(BATCH_SIZE, target.jointCount - first);
+        for (uint i = 0; i < count; ++i) {
+            const Node *joint = GET_NODE(joints[first + i]);
+            matrices[i] = joint ? joint->worldMatrix : Mat4::IDENTITY;
+        }
+        Mat4::multiply(matrices, bindPoses + first, matrices, count);
+        Mat4::multiply(rootInverses, matrices, matrices, count);
+        for (uint i = 0; i < count; ++i, out += JOINT_FLOAT_COUNT) packJoint(matrices[i], out);
+    }
+}
+
+void SkinningSystem::upload(const Target &target) {
+    const SkinningView *view = GET_SKINNING(target.handle);
+    const ModelView *model = view->getModel();
+    const uint *subModels = model->getSubModelID();
+    if (!subModels) return;
+
+    const SkinningMode mode = getMode(view);
+    float *data = _jointData.data() + target.dataOffset;
+    float animInfo[UBOSkinningAnimation::COUNT] = {static_cast<float>(target.frame)};
+
+    // sub-models usually share the joints of their model, every buffer or texture is written once
+    gfx::Buffer *lastBuffer = nullptr;
+    gfx::Texture *lastTexture = nullptr;
+    for (uint i = 1; i <= subModels[0]; ++i) {
+        const SubModelView *subModel = model->getSubModelView(subModels[i]);
+        gfx::DescriptorSet *descriptorSet = subModel ? subModel->getDescriptorSet() : nullptr;
+        if (!descriptorSet) continue;
+
+        switch (mode) {
+            case SkinningMode::UNIFORM: {
+                gfx::Buffer *buffer = descriptorSet->getBuffer(UBOSkinning::BINDING);
+                if (!buffer || buffer == lastBuffer) break;
+                buffer->update(data, 0, std::min(buffer->getSize(), target.jointCount * JOINT_FLOAT_COUNT * static_cast<uint>(sizeof(float))));
+                lastBuffer = buffer;
+                break;
+            }
+            case SkinningMode::TEXTURE: {
+                gfx::Texture *texture = descriptorSet->getTexture(JOINT_TEXTURE::BINDING);
+                if (!texture || texture == lastTexture) break;
+                uploadToTexture(texture, view->textureOffset, data, target.jointCount * TEXELS_PER_JOINT);
+                lastTexture = texture;
+                break;
+            }
+            case SkinningMode::BAKED: {
+                gfx::Buffer *buffer = descriptorSet->getBuffer(UBOSkinningAnimation::BINDING);
+                if (!buffer || buffer == lastBuffer) break;
+                buffer->update(animInfo, 0, UBOSkinningAnimation::SIZE);
+                lastBuffer = buffer;
+                break;
+            }
+        }
+    }
+    if (mode == SkinningMode::BAKED) uploadInstancedAnimInfo(view, target);
+}
+
+// The instanced attributes of a model are packed in their order, the InstancedBuffer takes the new frame from there
+// once it merges the model. Packed instances carry an animation info each, JS writes theirs.
+void SkinningSystem::uploadInstancedAnimInfo(const SkinningView *view, const Target &target) {
+    const ModelView *model = view->getModel();
+    const uint *attributes = model->getInstancedAttributeID();
+    if (!attributes || model->instanceCount) return;
+
+    uint offset = 0;
+    for (uint i = 1; i <= attributes[0]; ++i) {
+        const gfx::Attribute *attribute = model->getInstancedAttribute(attributes[i]);
+        if (attribute->name != UBOSkinningAnimation::INSTANCED_ATTRIBUTE_NAME) {
+            offset += gfx::GFX_FORMAT_INFOS[static_cast<uint>(attribute->format)].size;
+            continue;
+        }
+
+        uint size = 0;
+        uint8_t *data = GET_RAW_BUFFER(model->instancedBufferID, &size);
+        const uint *joints = view->getJoints();
+        const float animInfo[4] = {static_cast<float>(target.frame), static_cast<float>(joints ? joints[0] : 0),
+                                   static_cast<float>(view->textureOffset), 0.f};
+        if (data && attribute->format == gfx::Format::RGBA32F && offset + sizeof(animInfo) <= size) {
+            memcpy(data + offset, animInfo, sizeof(animInfo));
+        }
+        return;
+    }
+}
+
+// The texels of a model may wrap around rows, a partial first row, the full rows and a partial last row
+// are copied as separate regions.
+void SkinningSystem::uploadToTexture(gfx::Texture *texture, uint texelOffset, const float *data, uint texelCount) {
+    const uint width = texture->getWidth();
+    if (texture->getFormat() != gfx::Format::RGBA32F || !width || texelOffset + texelCount > width * texture->getHeight()) {
+        CC_LOG_WARNING("SkinningSystem: joint texture is not RGBA32F or too small for texel %u", texelOffset + texelCount);
+        return;
+    }
+
+    const uint8_t *buffers[3];
+    gfx::BufferTextureCopy regions[3];
+    uint regionCount = 0;
+    const auto *bytes = reinterpret_cast<const uint8_t *>(data);
+    const auto addRegion = [&](uint texel, uint regionWidth, uint regionHeight) {
+        buffers[regionCount] = bytes;
+        gfx::BufferTextureCopy &region = regions[regionCount++];
+        region.texOffset.x = static_cast<int>(texel % width);
+        region.texOffset.y = static_cast<int>(texel / width);
+        region.texExtent.width = regionWidth;
+        region.texExtent.height = regionHeight;
+        bytes += regionWidth * regionHeight * TEXEL_SIZE;
+    };
+
+    uint texel = texelOffset;
+    uint remaining = texelCount;
+    if (texel % width) {
+        const uint count = std::min(remaining, width - texel % width);
+        addRegion(texel, count, 1);
+        texel += count;
+        remaining -= count;
+    }
+    if (remaining >= width) {
+        const uint rows = remaining / width;
+        addRegion(texel, width, rows);
+        texel += rows * width;
+        remaining -= rows * width;
+    }
+    if (remaining) addRegion(texel, remaining, 1);
+
+    gfx::Device::getInstance()->copyBuffersToTexture(buffers, texture, regions, regionCount);
+}
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "../Define.h"
+#include "SharedMemory.h"
+#include "math/Mat4.h"
+
+namespace cc {
+namespace gfx {
+class Buffer;
+class Texture;
+} // namespace gfx
+
+namespace pipeline {
+
+enum class SkinningMode : uint {
+    UNIFORM, // joints into the UBOSkinning of the sub-models, at most JOINT_UNIFORM_CAPACITY joints
+    TEXTURE, // joints into the joint texture of the sub-models from SkinningView::textureOffset on
+    BAKED,   // frames baked into the joint texture by JS, only the frame is written into UBOSkinningAnimation,
+             // and into the a_jointAnimInfo instanced attribute for the models sharing their joint texture to be
+             // drawn as instances of one InstancedBuffer
+};
+
+// Joint matrices of the skinned models JS adds with their SkinningView handle.
+// update() computes inverse(root) * joint * bindPose of every joint, models split into jobs of the JobSystem,
+// and uploads them in the layout of the cc-skinning shader chunk, 3 vec4 per joint. A joint texture is RGBA32F,
+// 3 texels per joint. Baked models only advance their time and upload the frame when it changes.
+class CC_DLL SkinningSystem final : public Object {
+public:
+    static constexpr uint JOINT_FLOAT_COUNT = 12;
+
+    static SkinningSystem *getInstance();
+    static void destroyInstance();
+
+    void addModel(uint handle);
+    void removeModel(uint handle);
+
+    // Runs after the world transforms of the frame are written, on the thread which created the JobSystem.
+    void update(float dt);
+
+    CC_INLINE uint getModelCount() const { return static_cast<uint>(_models.size()); }
+
+    // The joint of the uniform and texture layouts.
+    static void packJoint(const Mat4 &joint, float *out);
+
+private:
+    static constexpr uint BATCH_SIZE = 64;
+
+    struct Target {
+        uint handle = 0;
+        uint jointCount = 0;
+        uint dataOffset = 0; // first float into _jointData
+        uint frame = 0;      // baked frame last uploaded
+        bool isDirty = false;
+    };
+
+    bool prepare(const SkinningView *view, Target &target);
+    void computeJoints(const Target &target);
+    void upload(const Target &target);
+    void uploadInstancedAnimInfo(const SkinningView *view, const Target &target);
+    void uploadToTexture(gfx::Texture *texture, uint texelOffset, const float *data, uint texelCount);
+
+    vector<Target> _models;
+    vector<float> _jointData;
+
+    static SkinningSystem *_instance;
+};
+
+} // namespace pipeline
+} // namespace cc
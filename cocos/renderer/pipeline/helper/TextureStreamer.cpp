@@ -0,0 +1,288 @@
+#include "TextureStreamer.h"
+#include "SharedMemory.h"
+#include "base/Log.h"
+#include "base/MemoryPressure.h"
+#include "base/ThreadPool.h"
+#include "gfx/GFXDescriptorSet.h"
+#include "gfx/GFXDevice.h"
+#include "gfx/GFXTexture.h"
+#include "platform/Image.h"
+
+#include <algorithm>
+
+namespace cc {
+namespace pipeline {
+
+bool TextureStreamer::initialize(gfx::Device *device) {
+    _device = device;
+    _loadThreadPool = ThreadPool::newSingleThreadPool();
+    // visible textures keep the levels they are drawn with, those out of sight fall back to their tails
+    _memoryPressureHandlerID = MemoryPressure::addHandler("TextureStreamer", MemoryPressureLevel::LOW, [this](MemoryPressureLevel level) {
+        evict(level == MemoryPressureLevel::CRITICAL ? _committedSize : _committedSize / 2);
+    });
+    return _loadThreadPool != nullptr;
+}
+
+void TextureStreamer::destroy() {
+    MemoryPressure::removeHandler(_memoryPressureHandlerID);
+    _memoryPressureHandlerID = 0;
+
+    // waits for the running load
+    CC_SAFE_DELETE(_loadThreadPool);
+    for (auto *load : _finishedLoads) CC_DELETE(load);
+    _finishedLoads.clear();
+    for (auto *load : _uploadQueue) CC_DELETE(load);
+    _uploadQueue.clear();
+    _pendingLoads = 0;
+
+    for (auto &pair : _textures) pair.second->texture = nullptr;
+    _textures.clear();
+    _residentSize = 0;
+    _committedSize = 0;
+    _device = nullptr;
+}
+
+uint TextureStreamer::getLevelSize(const StreamedTexture &texture, uint level) const {
+    return gfx::FormatSize(texture.format, std::max(texture.width >> level, 1u), std::max(texture.height >> level, 1u), 1);
+}
+
+uint TextureStreamer::getChainSize(const StreamedTexture &texture, uint level) const {
+    uint size = 0;
+    for (uint i = level; i < texture.levelCount; ++i) size += getLevelSize(texture, i);
+    return size;
+}
+
+bool TextureStreamer::addTexture(gfx::Texture *texture, uint width, uint height, uint levelCount, const LevelLoader &loader) {
+    if (!texture || texture->isTextureView() || texture->getType() != gfx::TextureType::TEX2D || !width || !height || !loader) {
+        CC_LOG_ERROR("TextureStreamer: only 2D textures of a non-zero size can be streamed.");
+        return false;
+    }
+    removeTexture(texture);
+
+    auto streamed = std::make_shared<StreamedTexture>();
+    streamed->texture = texture;
+    streamed->format = texture->getFormat();
+    streamed->width = width;
+    streamed->height = height;
+    const uint size = std::max(width, height);
+    uint fullLevelCount = 1;
+    while (size >> fullLevelCount) ++fullLevelCount;
+    streamed->levelCount = std::min(std::max(levelCount, 1u), fullLevelCount);
+    while (streamed->tailLevel + 1 < streamed->levelCount && (size >> streamed->tailLevel) > TAIL_SIZE) ++streamed->tailLevel;
+    streamed->loader = loader;
+
+    // the tail is small enough to be loaded on the spot, so the texture is complete from the first frame on
+    vector<vector<uint8_t>> levels;
+    if (!loadLevels(*streamed, streamed->tailLevel, levels)) return false;
+    upload(*streamed, streamed->tailLevel, levels);
+    streamed->residentLevel = streamed->targetLevel = streamed->wantedLevel = streamed->tailLevel;
+    streamed->lastSeenFrame = _frame;
+
+    const uint chainSize = getChainSize(*streamed, streamed->tailLevel);
+    _residentSize += chainSize;
+    _committedSize += chainSize;
+    _textures[texture] = streamed;
+    return true;
+}
+
+bool TextureStreamer::addTexture(gfx::Texture *texture, uint width, uint height, const vector<String> &levelPaths) {
+    const auto format = texture ? texture->getFormat() : gfx::Format::UNKNOWN;
+    const auto loader = [levelPaths, format](uint level, vector<uint8_t> &data) {
+        auto *image = new Image();
+        bool isLoaded = image->initWithImageFile(levelPaths[level]);
+        if (isLoaded && image->getRenderFormat() != format) {
+            CC_LOG_ERROR("TextureStreamer: %s doesn't match the format of its texture.", levelPaths[level].c_str());
+            isLoaded = false;
+        }
+        if (isLoaded) data.assign(image->getData(), image->getData() + image->getDataLen());
+        image->release();
+        return isLoaded;
+    };
+    return addTexture(texture, width, height, static_cast<uint>(levelPaths.size()), loader);
+}
+
+void TextureStreamer::removeTexture(gfx::Texture *texture) {
+    auto iter = _textures.find(texture);
+    if (iter == _textures.end()) return;
+
+    auto &streamed = *iter->second;
+    _residentSize -= getChainSize(streamed, streamed.residentLevel);
+    _committedSize -= getChainSize(streamed, streamed.targetLevel);
+    streamed.texture = nullptr;
+    _textures.erase(iter);
+}
+
+void TextureStreamer::requestModel(const ModelView *model, float pixels) {
+    const auto *subModelID = model->getSubModelID();
+    const uint subModelCount = subModelID[0];
+    for (uint i = 1; i <= subModelCount; ++i) {
+        const auto *subModel = model->getSubModelView(subModelID[i]);
+        for (uint j = 0; j < subModel->passCount; ++j) {
+            const auto *descriptorSet = subModel->getPassView(j)->getDescriptorSet();
+            if (!descriptorSet) continue;
+
+            for (const auto *texture : descriptorSet->getTextures()) {
+                auto iter = _textures.find(texture);
+                if (iter == _textures.end()) continue;
+
+                // the smallest level still covering the size
+                auto &streamed = *iter->second;
+                const uint size = std::max(streamed.width, streamed.height);
+                uint level = 0;
+                while (level + 1 < streamed.levelCount && static_cast<float>(size >> (level + 1)) >= pixels) ++level;
+
+                uint requested = streamed.requestedLevel.load(std::memory_order_relaxed);
+                while (level < requested && !streamed.requestedLevel.compare_exchange_weak(requested, level, std::memory_order_relaxed)) {
+                }
+            }
+        }
+    }
+}
+
+bool TextureStreamer::loadLevels(const StreamedTexture &texture, uint level, vector<vector<uint8_t>> &levels) const {
+    levels.resize(texture.levelCount - level);
+    for (uint i = level; i < texture.levelCount; ++i) {
+        auto &data = levels[i - level];
+        if (!texture.loader(i, data)) {
+            CC_LOG_ERROR("TextureStreamer: level %u failed to load.", i);
+            return false;
+        }
+        const uint size = getLevelSize(texture, i);
+        if (data.size() < size) {
+            CC_LOG_ERROR("TextureStreamer: level %u has %u bytes, %u expected.", i, static_cast<uint>(data.size()), size);
+            return false;
+        }
+    }
+    return true;
+}
+
+void TextureStreamer::upload(StreamedTexture &texture, uint level, const vector<vector<uint8_t>> &levels) {
+    const uint count = texture.levelCount - level;
+    texture.texture->resize(std::max(texture.width >> level, 1u), std::max(texture.height >> level, 1u), count);
+
+    gfx::BufferDataList buffers(count);
+    gfx::BufferTextureCopyList regions(count);
+    for (uint i = 0; i < count; ++i) {
+        buffers[i] = levels[i].data();
+        auto &region = regions[i];
+        region.texExtent.width = std::max(texture.width >> (level + i), 1u);
+        region.texExtent.height = std::max(texture.height >> (level + i), 1u);
+        region.texSubres.mipLevel = i;
+    }
+    _device->copyBuffersToTexture(buffers, texture.texture, regions);
+}
+
+void TextureStreamer::startLoad(const std::shared_ptr<StreamedTexture> &texture, uint level) {
+    _committedSize = _committedSize - getChainSize(*texture, texture->targetLevel) + getChainSize(*texture, level);
+    texture->targetLevel = level;
+    ++_pendingLoads;
+
+    auto *load = CC_NEW(Load);
+    load->texture = texture;
+    load->level = level;
+    // the loader and the size of the chain never change, the worker reads nothing else
+    _loadThreadPool->pushTask([this, load](int /*threadId*/) {
+        load->isLoaded = loadLevels(*load->texture, load->level, load->levels);
+        std::lock_guard<std::mutex> lock(_loadMutex);
+        _finishedLoads.push_back(load);
+    });
+}
+
+void TextureStreamer::uploadFinishedLoads() {
+    {
+        std::lock_guard<std::mutex> lock(_loadMutex);
+        _uploadQueue.insert(_uploadQueue.end(), _finishedLoads.begin(), _finishedLoads.end());
+        _finishedLoads.clear();
+    }
+
+    uint uploadedSize = 0;
+    size_t uploadCount = 0;
+    for (; uploadCount < _uploadQueue.size(); ++uploadCount) {
+        auto *load = _uploadQueue[uploadCount];
+        auto &texture = *load->texture;
+        if (texture.texture && load->isLoaded) {
+            const uint size = getChainSize(texture, load->level);
+            if (uploadedSize && uploadedSize + size > _uploadBudget) break;
+            uploadedSize += size;
+
+            upload(texture, load->level, load->levels);
+            _residentSize = _residentSize - getChainSize(texture, texture.residentLevel) + size;
+            texture.residentLevel = load->level;
+        } else if (texture.texture) {
+            // levels which failed to load are not requested again
+            _committedSize = _committedSize - getChainSize(texture, texture.targetLevel) + getChainSize(texture, texture.residentLevel);
+            if (load->level < texture.residentLevel) texture.minLevel = load->level + 1;
+            texture.wantedLevel = std::max(texture.wantedLevel, texture.minLevel);
+            texture.targetLevel = texture.residentLevel;
+        }
+        --_pendingLoads;
+        CC_DELETE(load);
+    }
+    _uploadQueue.erase(_uploadQueue.begin(), _uploadQueue.begin() + uploadCount);
+}
+
+void TextureStreamer::evict(uint size) {
+    // textures seen in the last frame only give up the levels they have beyond the requested one
+    auto &candidates = _evictionCandidates;
+    candidates.clear();
+    for (const auto &pair : _textures) {
+        const auto &texture = *pair.second;
+        const uint lowestLevel = texture.lastSeenFrame == _frame ? texture.wantedLevel : texture.tailLevel;
+        if (texture.targetLevel == texture.residentLevel && texture.residentLevel < lowestLevel) candidates.push_back(pair.second);
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const std::shared_ptr<StreamedTexture> &a, const std::shared_ptr<StreamedTexture> &b) {
+        return a->lastSeenFrame < b->lastSeenFrame;
+    });
+
+    uint evictedSize = 0;
+    for (const auto &texture : candidates) {
+        if (evictedSize >= size) break;
+        const uint lowestLevel = texture->lastSeenFrame == _frame ? texture->wantedLevel : texture->tailLevel;
+        const uint residentSize = getChainSize(*texture, texture->residentLevel);
+        uint level = texture->residentLevel + 1;
+        while (level < lowestLevel && evictedSize + residentSize - getChainSize(*texture, level) < size) ++level;
+        evictedSize += residentSize - getChainSize(*texture, level);
+        startLoad(texture, level);
+    }
+    candidates.clear();
+}
+
+void TextureStreamer::update() {
+    ++_frame;
+    uploadFinishedLoads();
+
+    auto &candidates = _growthCandidates;
+    candidates.clear();
+    for (const auto &pair : _textures) {
+        auto &texture = *pair.second;
+        const uint requested = texture.requestedLevel.exchange(UINT_MAX, std::memory_order_relaxed);
+        if (requested != UINT_MAX) {
+            texture.wantedLevel = std::max(requested, texture.minLevel);
+            texture.lastSeenFrame = _frame;
+        }
+        // textures out of sight keep their chain until the budget evicts it
+        if (texture.lastSeenFrame == _frame && texture.wantedLevel < texture.residentLevel) candidates.push_back(pair.second);
+    }
+
+    // the textures missing the most levels grow first
+    std::sort(candidates.begin(), candidates.end(), [](const std::shared_ptr<StreamedTexture> &a, const std::shared_ptr<StreamedTexture> &b) {
+        return a->residentLevel - a->wantedLevel > b->residentLevel - b->wantedLevel;
+    });
+    for (const auto &texture : candidates) {
+        if (_pendingLoads >= MAX_PENDING_LOADS) break;
+        if (texture->targetLevel != texture->residentLevel) continue;
+
+        const uint residentSize = getChainSize(*texture, texture->residentLevel);
+        const uint wantedSize = getChainSize(*texture, texture->wantedLevel);
+        if (_committedSize + wantedSize - residentSize > _budget) evict(_committedSize + wantedSize - residentSize - _budget);
+
+        // grows as far as the budget allows
+        uint level = texture->wantedLevel;
+        while (level < texture->residentLevel && _committedSize + getChainSize(*texture, level) - residentSize > _budget) ++level;
+        if (level < texture->residentLevel) startLoad(texture, level);
+    }
+    candidates.clear();
+}
+
+} // namespace pipeline
+} // namespace cc
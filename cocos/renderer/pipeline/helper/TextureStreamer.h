@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "../Define.h"
+
+namespace cc {
+class ThreadPool;
+
+namespace gfx {
+class Texture;
+} // namespace gfx
+
+namespace pipeline {
+
+struct ModelView;
+
+// Keeps the mip chains of registered 2D textures resident from the level their largest on-screen size needs.
+// A texture starts with the tail of its chain and grows as culling requests it, the missing levels are loaded
+// on a worker thread and the texture is reallocated with the new chain once all of them arrived. When the chains
+// exceed the memory budget, the textures seen least recently drop their top levels first.
+class CC_DLL TextureStreamer : public Object {
+public:
+    // Decodes one level of the full chain, 0 being the largest, into tightly packed data of the texture's format.
+    // Runs on the worker thread.
+    using LevelLoader = std::function<bool(uint level, vector<uint8_t> &data)>;
+
+    // levels at most this large make up the tail, which is loaded right away and never evicted
+    static constexpr uint TAIL_SIZE = 64;
+    static constexpr uint MAX_PENDING_LOADS = 4;
+
+    bool initialize(gfx::Device *device);
+    void destroy();
+
+    // Streams a chain of the given full size into the texture, which is reallocated with the tail right away.
+    // The texture may be created with any size of its format, it has to stay alive until it is removed.
+    bool addTexture(gfx::Texture *texture, uint width, uint height, uint levelCount, const LevelLoader &loader);
+    // Loads the chain from one image file per level, each half the size of the previous one.
+    bool addTexture(gfx::Texture *texture, uint width, uint height, const vector<String> &levelPaths);
+    // Leaves the texture with its current chain.
+    void removeTexture(gfx::Texture *texture);
+    CC_INLINE bool isEmpty() const { return _textures.empty(); }
+
+    // Requests the streamed textures of a model's passes at the size in pixels the model covers on screen.
+    // Thread safe against other requests, culling workers call it concurrently.
+    void requestModel(const ModelView *model, float pixels);
+    // Uploads finished loads and starts new ones from the requests since the last update, once a frame.
+    void update();
+
+    CC_INLINE void setBudget(uint bytes) { _budget = bytes; }
+    CC_INLINE uint getBudget() const { return _budget; }
+    CC_INLINE uint getResidentSize() const { return _residentSize; }
+    // Bytes uploaded in one frame at most, a single larger chain is still uploaded in a frame of its own.
+    CC_INLINE void setUploadBudget(uint bytes) { _uploadBudget = bytes; }
+    CC_INLINE uint getUploadBudget() const { return _uploadBudget; }
+
+private:
+    struct StreamedTexture {
+        gfx::Texture *texture = nullptr; // nullptr once removed, its pending load is dropped
+        gfx::Format format = gfx::Format::UNKNOWN;
+        uint width = 0;
+        uint height = 0;
+        uint levelCount = 0;
+        uint tailLevel = 0;
+        uint minLevel = 0;              // raised past levels which failed to load
+        uint residentLevel = 0;         // top level of the chain in the texture
+        uint targetLevel = 0;           // top level of the chain being loaded, the resident one when idle
+        uint wantedLevel = 0;           // smallest level last requested
+        std::atomic<uint> requestedLevel{UINT_MAX}; // smallest level requested since the last update
+        uint lastSeenFrame = 0;
+        LevelLoader loader;
+    };
+
+    struct Load {
+        std::shared_ptr<StreamedTexture> texture;
+        uint level = 0;
+        vector<vector<uint8_t>> levels;
+        bool isLoaded = false;
+    };
+
+    uint getLevelSize(const StreamedTexture &texture, uint level) const;
+    uint getChainSize(const StreamedTexture &texture, uint level) const;
+    bool loadLevels(const StreamedTexture &texture, uint level, vector<vector<uint8_t>> &levels) const;
+    void upload(StreamedTexture &texture, uint level, const vector<vector<uint8_t>> &levels);
+    void startLoad(const std::shared_ptr<StreamedTexture> &texture, uint level);
+    void uploadFinishedLoads();
+    void evict(uint size);
+
+    gfx::Device *_device = nullptr;
+    ThreadPool *_loadThreadPool = nullptr;
+    std::unordered_map<const gfx::Texture *, std::shared_ptr<StreamedTexture>> _textures;
+
+    std::mutex _loadMutex;
+    vector<Load *> _finishedLoads;
+    vector<Load *> _uploadQueue;
+    uint _pendingLoads = 0;
+    vector<std::shared_ptr<StreamedTexture>> _growthCandidates;
+    vector<std::shared_ptr<StreamedTexture>> _evictionCandidates;
+
+    uint _frame = 0;
+    uint _budget = 256 * 1024 * 1024;
+    uint _uploadBudget = 8 * 1024 * 1024;
+    uint _residentSize = 0;
+    uint _committedSize = 0; // resident size once every pending load is uploaded
+    uint32_t _memoryPressureHandlerID = 0;
+};
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,215 @@
+#include "TransformSystem.h"
+
+#include "base/JobSystem.h"
+#include "base/Log.h"
+
+#include <algorithm>
+
+namespace cc {
+namespace pipeline {
+namespace {
+constexpr uint STREAM_STRIDES[] = {
+    sizeof(float) * 3,
+    sizeof(float) * 4,
+    sizeof(float) * 3,
+    sizeof(uint32_t),
+    sizeof(uint32_t),
+    sizeof(uint32_t),
+};
+static_assert(sizeof(STREAM_STRIDES) / sizeof(STREAM_STRIDES[0]) == static_cast<uint>(TransformStream::COUNT), "a transform stream has no stride");
+
+constexpr uint PARALLEL_LEVEL_SIZE = 1024; // smaller levels are swept on the calling thread
+constexpr uint JOB_GRAIN_SIZE = 256;
+constexpr uint UNVISITED = 0xffffffff;
+constexpr uint IN_PATH = 0xfffffffe;
+constexpr uint TRANSFORM_POSITION = static_cast<uint>(TransformBit::POSITION);
+
+// scale of the world matrix along the axes of the world rotation, the diagonal of inverse(rotation) * world
+CC_INLINE void getWorldScale(const Mat4 &world, const Quaternion &rotation, Vec3 &scale) {
+    Mat4 axes;
+    Mat4::createRotation(rotation, &axes);
+    scale.x = axes.m[0] * world.m[0] + axes.m[1] * world.m[1] + axes.m[2] * world.m[2];
+    scale.y = axes.m[4] * world.m[4] + axes.m[5] * world.m[5] + axes.m[6] * world.m[6];
+    scale.z = axes.m[8] * world.m[8] + axes.m[9] * world.m[9] + axes.m[10] * world.m[10];
+}
+} // namespace
+
+constexpr uint TransformSystem::INVALID_TRANSFORM;
+constexpr uint TransformSystem::MAX_DEPTH;
+TransformSystem *TransformSystem::_instance = nullptr;
+
+TransformSystem *TransformSystem::getInstance() {
+    if (!_instance) _instance = CC_NEW(TransformSystem);
+    return _instance;
+}
+
+void TransformSystem::destroyInstance() {
+    CC_SAFE_DELETE(_instance);
+}
+
+void TransformSystem::update() {
+    if (!fetchStreams()) return;
+    if (_isHierarchyChanged) {
+        rebuildLevels();
+        _isHierarchyChanged = false;
+    }
+
+    // a level only reads the world transforms of the levels before it
+    const uint levelCount = getLevelCount();
+    for (uint level = 0; level < levelCount; ++level) {
+        const uint first = _levelOffsets[level];
+        const uint count = _levelOffsets[level + 1] - first;
+        if (count < PARALLEL_LEVEL_SIZE) {
+            updateRange(first, first + count);
+            continue;
+        }
+        auto *jobSystem = JobSystem::getInstance();
+        jobSystem->wait(jobSystem->parallelFor(count, JOB_GRAIN_SIZE, [this, first](uint32_t begin, uint32_t end) {
+            updateRange(first + begin, first + end);
+        }));
+    }
+}
+
+bool TransformSystem::fetchStreams() {
+    uint count = UNVISITED;
+    for (uint i = 0; i < static_cast<uint>(TransformStream::COUNT); ++i) {
+        uint size = 0;
+        _streams[i] = se::BufferAllocator::getBuffer<uint8_t>(se::PoolType::TRANSFORM, i, &size);
+        if (!_streams[i]) {
+            _count = 0;
+            return false;
+        }
+        count = std::min(count, size / STREAM_STRIDES[i]);
+    }
+
+    // the streams grew or shrank, slots may have been taken or released
+    if (count != _count) {
+        _count = count;
+        _isHierarchyChanged = true;
+    }
+    return true;
+}
+
+void TransformSystem::rebuildLevels() {
+    const auto *parents = getStream<uint32_t>(TransformStream::PARENT);
+    const auto *nodes = getStream<uint32_t>(TransformStream::NODE);
+    const auto isUsed = [&](uint slot) { return slot < _count && nodes[slot] != INVALID_TRANSFORM; };
+
+    // depth of every used slot, walking up to the first ancestor whose depth is known
+    UintList depths(_count, UNVISITED);
+    _parents.assign(_count, INVALID_TRANSFORM);
+    uint levelCount = 0;
+    bool isTruncated = false;
+    for (uint slot = 0; slot < _count; ++slot) {
+        if (!isUsed(slot) || depths[slot] != UNVISITED) continue;
+
+        _path.clear();
+        uint current = slot;
+        uint depth = 0;
+        while (true) {
+            _path.push_back(current);
+            depths[current] = IN_PATH;
+            const uint parent = parents[current];
+            if (!isUsed(parent)) break;
+            if (depths[parent] == IN_PATH || _path.size() >= MAX_DEPTH) {
+                isTruncated = true;
+                break;
+            }
+            _parents[current] = parent;
+            if (depths[parent] != UNVISITED) {
+                depth = depths[parent] + 1;
+                break;
+            }
+            current = parent;
+        }
+        for (auto it = _path.rbegin(); it != _path.rend(); ++it, ++depth) depths[*it] = depth;
+        levelCount = std::max(levelCount, depth);
+    }
+    if (isTruncated) {
+        CC_LOG_WARNING("TransformSystem: hierarchy deeper than %u levels or cyclic, the exceeding slots are updated as roots", MAX_DEPTH);
+    }
+
+    // counting sort of the slots by depth
+    _levelOffsets.assign(levelCount + 1, 0);
+    for (uint slot = 0; slot < _count; ++slot) {
+        if (depths[slot] != UNVISITED) ++_levelOffsets[depths[slot] + 1];
+    }
+    for (uint level = 1; level <= levelCount; ++level) _levelOffsets[level] += _levelOffsets[level - 1];
+    _order.resize(_levelOffsets[levelCount]);
+    UintList cursors(_levelOffsets.begin(), _levelOffsets.end() - 1);
+    for (uint slot = 0; slot < _count; ++slot) {
+        if (depths[slot] != UNVISITED) _order[cursors[depths[slot]]++] = slot;
+    }
+
+    // every world transform is written once after a rebuild
+    auto *dirty = getStream<uint32_t>(TransformStream::DIRTY);
+    for (const auto slot : _order) dirty[slot] |= static_cast<uint>(TransformBit::TRS);
+    _worldChanged.assign(_count, 0);
+}
+
+// Children are gathered into batches, their world matrices and rotations are multiplied with the SIMD batch routines.
+void TransformSystem::updateRange(uint first, uint last) {
+    const auto *positions = getStream<Vec3>(TransformStream::POSITION);
+    const auto *rotations = getStream<Quaternion>(TransformStream::ROTATION);
+    const auto *scales = getStream<Vec3>(TransformStream::SCALE);
+    const auto *nodes = getStream<uint32_t>(TransformStream::NODE);
+    auto *dirty = getStream<uint32_t>(TransformStream::DIRTY);
+
+    Mat4 parentMatrices[BATCH_SIZE];
+    Mat4 localMatrices[BATCH_SIZE];
+    Quaternion parentRotations[BATCH_SIZE];
+    Quaternion localRotations[BATCH_SIZE];
+    uint slots[BATCH_SIZE];
+    uint batchCount = 0;
+
+    const auto flush = [&]() {
+        Mat4::multiply(parentMatrices, localMatrices, localMatrices, batchCount);
+        Quaternion::multiply(parentRotations, localRotations, localRotations, batchCount);
+        for (uint i = 0; i < batchCount; ++i) {
+            const Mat4 &world = localMatrices[i];
+            const Quaternion &rotation = localRotations[i];
+            Node *node = GET_NODE(nodes[slots[i]]);
+            node->worldMatrix = world;
+            node->worldPosition.set(world.m[12], world.m[13], world.m[14]);
+            node->worldRotation.set(rotation.x, rotation.y, rotation.z, rotation.w);
+            getWorldScale(world, rotation, node->worldScale);
+            node->flagsChanged |= _worldChanged[slots[i]];
+        }
+        batchCount = 0;
+    };
+
+    for (uint i = first; i < last; ++i) {
+        const uint slot = _order[i];
+        const uint parent = _parents[slot];
+        uint changed = dirty[slot];
+        // a child moves with any change of its parent
+        if (parent != INVALID_TRANSFORM && _worldChanged[parent]) changed |= _worldChanged[parent] | TRANSFORM_POSITION;
+        _worldChanged[slot] = changed;
+        if (!changed) continue;
+        dirty[slot] = 0;
+
+        if (parent == INVALID_TRANSFORM) {
+            Node *node = GET_NODE(nodes[slot]);
+            const Quaternion &rotation = rotations[slot];
+            Mat4::fromRTS(rotation, positions[slot], scales[slot], &node->worldMatrix);
+            node->worldPosition = positions[slot];
+            node->worldRotation.set(rotation.x, rotation.y, rotation.z, rotation.w);
+            node->worldScale = scales[slot];
+            node->flagsChanged |= changed;
+            continue;
+        }
+
+        const Node *parentNode = GET_NODE(nodes[parent]);
+        const Vec4 &parentRotation = parentNode->worldRotation;
+        parentMatrices[batchCount] = parentNode->worldMatrix;
+        parentRotations[batchCount].set(parentRotation.x, parentRotation.y, parentRotation.z, parentRotation.w);
+        Mat4::fromRTS(rotations[slot], positions[slot], scales[slot], &localMatrices[batchCount]);
+        localRotations[batchCount] = rotations[slot];
+        slots[batchCount] = slot;
+        if (++batchCount == BATCH_SIZE) flush();
+    }
+    if (batchCount) flush();
+}
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "../Define.h"
+#include "SharedMemory.h"
+#include "math/Mat4.h"
+#include "math/Quaternion.h"
+
+namespace cc {
+namespace pipeline {
+
+// Same bits as TransformBit of the engine.
+enum class TransformBit : uint {
+    NONE = 0,
+    POSITION = 1 << 0,
+    ROTATION = 1 << 1,
+    SCALE = 1 << 2,
+    TRS = POSITION | ROTATION | SCALE,
+};
+
+// The streams are array buffers of a BufferAllocator of PoolType::TRANSFORM, allocated at the index of
+// the stream, with one slot per transform, the smallest stream decides the transform count.
+enum class TransformStream : uint {
+    POSITION, // local position, 3 floats
+    ROTATION, // local rotation, 4 floats
+    SCALE,    // local scale, 3 floats
+    PARENT,   // uint32, slot of the parent, INVALID_TRANSFORM for roots
+    NODE,     // uint32, handle of the Node receiving the world transform, INVALID_TRANSFORM for unused slots
+    DIRTY,    // uint32, TransformBit of the local values written since the last update
+    COUNT,
+};
+
+// World transforms of a hierarchy whose local TRS JS writes into structure-of-arrays streams.
+// update() sweeps the hierarchy one depth level at a time, parents before children, large levels split
+// into jobs of the JobSystem, and writes the world transform of every changed slot into its Node,
+// OR-ing the changed bits into Node::flagsChanged. The depth order is only rebuilt after
+// markHierarchyChanged, a parent written without it is not seen.
+class CC_DLL TransformSystem final : public Object {
+public:
+    static constexpr uint INVALID_TRANSFORM = 0xffffffff;
+    static constexpr uint MAX_DEPTH = 256; // deeper slots, or slots in a cycle, become roots
+
+    static TransformSystem *getInstance();
+    static void destroyInstance();
+
+    // Parents were changed or slots were taken or released since the last update.
+    CC_INLINE void markHierarchyChanged() { _isHierarchyChanged = true; }
+
+    // Runs on the thread which created the JobSystem, JS writes no stream meanwhile.
+    void update();
+
+    CC_INLINE uint getTransformCount() const { return _count; }
+    CC_INLINE uint getLevelCount() const { return _levelOffsets.empty() ? 0 : static_cast<uint>(_levelOffsets.size() - 1); }
+
+private:
+    static constexpr uint BATCH_SIZE = 64;
+
+    template <typename T>
+    CC_INLINE T *getStream(TransformStream stream) const { return reinterpret_cast<T *>(_streams[static_cast<uint>(stream)]); }
+
+    bool fetchStreams();
+    void rebuildLevels();
+    void updateRange(uint first, uint last);
+
+    uint8_t *_streams[static_cast<uint>(TransformStream::COUNT)] = {nullptr};
+    uint _count = 0;
+    bool _isHierarchyChanged = true;
+
+    UintList _parents;      // parents of the last rebuild, INVALID_TRANSFORM for roots
+    UintList _order;        // slots by depth
+    UintList _levelOffsets; // range of every depth into _order
+    UintList _worldChanged; // TransformBit of the world transforms of this update
+    UintList _path;
+
+    static TransformSystem *_instance;
+};
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,425 @@
+#include "TweenSystem.h"
+#include "TransformSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Mat4.h undefines __SSE__, __SSE2__ stands for it on x86
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define TWEEN_USE_NEON
+#elif defined(__SSE__) || defined(__SSE2__)
+    #include <xmmintrin.h>
+    #define TWEEN_USE_SSE
+#endif
+
+namespace cc {
+namespace pipeline {
+namespace {
+constexpr float MIN_DURATION = 1e-6F;
+constexpr float BACK_OVERSHOOT = 1.70158F;
+constexpr float PI = 3.14159265F;
+constexpr uint TRANSFORM_PROPERTY_COUNT = 3;
+constexpr uint PROPERTY_COMPONENTS[] = {3, 4, 3, 4};
+static_assert(sizeof(PROPERTY_COMPONENTS) / sizeof(PROPERTY_COMPONENTS[0]) == static_cast<uint>(TweenProperty::COUNT), "a tween property has no component count");
+constexpr TransformBit PROPERTY_BITS[] = {TransformBit::POSITION, TransformBit::ROTATION, TransformBit::SCALE};
+
+enum class Curve : uint {
+    LINEAR,
+    QUAD,
+    CUBIC,
+    QUART,
+    QUINT,
+    BACK,
+    SINE,
+    EXPO,
+    BOUNCE,
+    ELASTIC,
+};
+constexpr Curve LAST_SIMD_CURVE = Curve::BACK;
+
+enum class Mode : uint {
+    IN,
+    OUT,
+    IN_OUT,
+};
+
+CC_INLINE Curve getCurve(TweenEasing easing) {
+    return easing == TweenEasing::LINEAR ? Curve::LINEAR : static_cast<Curve>((static_cast<uint>(easing) - 1) / 3 + 1);
+}
+
+CC_INLINE Mode getMode(TweenEasing easing) {
+    return easing == TweenEasing::LINEAR ? Mode::IN : static_cast<Mode>((static_cast<uint>(easing) - 1) % 3);
+}
+
+CC_INLINE uint roundUp4(uint count) { return (count + 3) & ~3U; }
+
+// four lanes of floats, the arrays are padded to whole lanes
+#if defined(TWEEN_USE_NEON)
+typedef float32x4_t F4;
+CC_INLINE F4 f4Load(const float *p) { return vld1q_f32(p); }
+CC_INLINE void f4Store(float *p, F4 v) { vst1q_f32(p, v); }
+CC_INLINE F4 f4Set(float v) { return vdupq_n_f32(v); }
+CC_INLINE F4 f4Add(F4 a, F4 b) { return vaddq_f32(a, b); }
+CC_INLINE F4 f4Sub(F4 a, F4 b) { return vsubq_f32(a, b); }
+CC_INLINE F4 f4Mul(F4 a, F4 b) { return vmulq_f32(a, b); }
+CC_INLINE F4 f4MulAdd(F4 a, F4 b, F4 c) { return vmlaq_f32(a, b, c); } // a + b * c
+CC_INLINE F4 f4Min(F4 a, F4 b) { return vminq_f32(a, b); }
+CC_INLINE F4 f4Max(F4 a, F4 b) { return vmaxq_f32(a, b); }
+CC_INLINE F4 f4SelectLess(F4 a, F4 b, F4 x, F4 y) { return vbslq_f32(vcltq_f32(a, b), x, y); } // a < b ? x : y
+#elif defined(TWEEN_USE_SSE)
+typedef __m128 F4;
+CC_INLINE F4 f4Load(const float *p) { return _mm_loadu_ps(p); }
+CC_INLINE void f4Store(float *p, F4 v) { _mm_storeu_ps(p, v); }
+CC_INLINE F4 f4Set(float v) { return _mm_set1_ps(v); }
+CC_INLINE F4 f4Add(F4 a, F4 b) { return _mm_add_ps(a, b); }
+CC_INLINE F4 f4Sub(F4 a, F4 b) { return _mm_sub_ps(a, b); }
+CC_INLINE F4 f4Mul(F4 a, F4 b) { return _mm_mul_ps(a, b); }
+CC_INLINE F4 f4MulAdd(F4 a, F4 b, F4 c) { return _mm_add_ps(a, _mm_mul_ps(b, c)); }
+CC_INLINE F4 f4Min(F4 a, F4 b) { return _mm_min_ps(a, b); }
+CC_INLINE F4 f4Max(F4 a, F4 b) { return _mm_max_ps(a, b); }
+CC_INLINE F4 f4SelectLess(F4 a, F4 b, F4 x, F4 y) {
+    const __m128 mask = _mm_cmplt_ps(a, b);
+    return _mm_or_ps(_mm_and_ps(mask, x), _mm_andnot_ps(mask, y));
+}
+#else
+struct F4 {
+    float v[4];
+};
+CC_INLINE F4 f4Load(const float *p) { return {{p[0], p[1], p[2], p[3]}}; }
+CC_INLINE void f4Store(float *p, const F4 &a) { memcpy(p, a.v, sizeof(a.v)); }
+CC_INLINE F4 f4Set(float v) { return {{v, v, v, v}}; }
+CC_INLINE F4 f4Add(const F4 &a, const F4 &b) { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+CC_INLINE F4 f4Sub(const F4 &a, const F4 &b) { return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}}; }
+CC_INLINE F4 f4Mul(const F4 &a, const F4 &b) { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+CC_INLINE F4 f4MulAdd(const F4 &a, const F4 &b, const F4 &c) { return f4Add(a, f4Mul(b, c)); }
+CC_INLINE F4 f4Min(const F4 &a, const F4 &b) { return {{std::min(a.v[0], b.v[0]), std::min(a.v[1], b.v[1]), std::min(a.v[2], b.v[2]), std::min(a.v[3], b.v[3])}}; }
+CC_INLINE F4 f4Max(const F4 &a, const F4 &b) { return {{std::max(a.v[0], b.v[0]), std::max(a.v[1], b.v[1]), std::max(a.v[2], b.v[2]), std::max(a.v[3], b.v[3])}}; }
+CC_INLINE F4 f4SelectLess(const F4 &a, const F4 &b, const F4 &x, const F4 &y) {
+    return {{a.v[0] < b.v[0] ? x.v[0] : y.v[0], a.v[1] < b.v[1] ? x.v[1] : y.v[1], a.v[2] < b.v[2] ? x.v[2] : y.v[2], a.v[3] < b.v[3] ? x.v[3] : y.v[3]}};
+}
+#endif
+
+// The curves ease in, f(0) = 0 and f(1) = 1, out and in-out are derived from them.
+F4 easeIn4(Curve curve, const F4 &t) {
+    switch (curve) {
+        case Curve::QUAD: return f4Mul(t, t);
+        case Curve::CUBIC: return f4Mul(f4Mul(t, t), t);
+        case Curve::QUART: {
+            const F4 t2 = f4Mul(t, t);
+            return f4Mul(t2, t2);
+        }
+        case Curve::QUINT: {
+            const F4 t2 = f4Mul(t, t);
+            return f4Mul(f4Mul(t2, t2), t);
+        }
+        case Curve::BACK: return f4Mul(f4Mul(t, t), f4Sub(f4Mul(t, f4Set(BACK_OVERSHOOT + 1.F)), f4Set(BACK_OVERSHOOT)));
+        default: return t;
+    }
+}
+
+float bounceOut(float t) {
+    if (t < 1.F / 2.75F) return 7.5625F * t * t;
+    if (t < 2.F / 2.75F) {
+        t -= 1.5F / 2.75F;
+        return 7.5625F * t * t + 0.75F;
+    }
+    if (t < 2.5F / 2.75F) {
+        t -= 2.25F / 2.75F;
+        return 7.5625F * t * t + 0.9375F;
+    }
+    t -= 2.625F / 2.75F;
+    return 7.5625F * t * t + 0.984375F;
+}
+
+float easeIn(Curve curve, float t) {
+    switch (curve) {
+        case Curve::SINE: return 1.F - std::cos(t * PI * 0.5F);
+        case Curve::EXPO: return t <= 0.F ? 0.F : std::pow(2.F, 10.F * (t - 1.F));
+        case Curve::BOUNCE: return 1.F - bounceOut(1.F - t);
+        case Curve::ELASTIC:
+            if (t <= 0.F || t >= 1.F) return t;
+            return -std::pow(2.F, 10.F * (t - 1.F)) * std::sin((t - 1.1F) * 2.F * PI / 0.4F);
+        default: return t; // the curves eased in SIMD don't come here
+    }
+}
+
+// progress[i] becomes the eased t of the lanes [0, count), count a multiple of 4
+void ease(TweenEasing easing, float *progress, uint count) {
+    const Curve curve = getCurve(easing);
+    const Mode mode = getMode(easing);
+    if (curve == Curve::LINEAR) return;
+
+    if (curve <= LAST_SIMD_CURVE) {
+        const F4 one = f4Set(1.F);
+        const F4 half = f4Set(0.5F);
+        const F4 two = f4Set(2.F);
+        for (uint i = 0; i < count; i += 4) {
+            const F4 t = f4Load(progress + i);
+            F4 eased;
+            if (mode == Mode::IN) {
+                eased = easeIn4(curve, t);
+            } else if (mode == Mode::OUT) {
+                eased = f4Sub(one, easeIn4(curve, f4Sub(one, t)));
+            } else {
+                const F4 in = f4Mul(easeIn4(curve, f4Mul(t, two)), half);
+                const F4 out = f4Sub(one, f4Mul(easeIn4(curve, f4Sub(two, f4Mul(t, two))), half));
+                eased = f4SelectLess(t, half, in, out);
+            }
+            f4Store(progress + i, eased);
+        }
+        return;
+    }
+
+    for (uint i = 0; i < count; ++i) {
+        const float t = progress[i];
+        if (mode == Mode::IN) {
+            progress[i] = easeIn(curve, t);
+        } else if (mode == Mode::OUT) {
+            progress[i] = 1.F - easeIn(curve, 1.F - t);
+        } else {
+            progress[i] = t < 0.5F ? easeIn(curve, t * 2.F) * 0.5F : 1.F - easeIn(curve, 2.F - t * 2.F) * 0.5F;
+        }
+    }
+}
+} // namespace
+
+constexpr uint TweenSystem::REPEAT_FOREVER;
+constexpr uint TweenSystem::COMPONENT_COUNT;
+TweenSystem *TweenSystem::_instance = nullptr;
+
+TweenSystem *TweenSystem::getInstance() {
+    if (!_instance) _instance = CC_NEW(TweenSystem);
+    return _instance;
+}
+
+void TweenSystem::destroyInstance() {
+    CC_SAFE_DELETE(_instance);
+}
+
+bool TweenSystem::fetchStreams() {
+    const TransformStream transformStreams[] = {TransformStream::POSITION, TransformStream::ROTATION, TransformStream::SCALE};
+    const uint strides[] = {sizeof(float) * 3, sizeof(float) * 4, sizeof(float) * 3};
+    _transformCount = TransformSystem::INVALID_TRANSFORM;
+    for (uint i = 0; i < TRANSFORM_PROPERTY_COUNT; ++i) {
+        uint size = 0;
+        _transformStreams[i] = se::BufferAllocator::getBuffer<float>(se::PoolType::TRANSFORM, static_cast<uint>(transformStreams[i]), &size);
+        _transformCount = std::min(_transformCount, _transformStreams[i] ? size / strides[i] : 0);
+    }
+    uint size = 0;
+    _dirty = se::BufferAllocator::getBuffer<uint32_t>(se::PoolType::TRANSFORM, static_cast<uint>(TransformStream::DIRTY), &size);
+    _transformCount = _dirty ? std::min(_transformCount, static_cast<uint>(size / sizeof(uint32_t))) : 0;
+
+    _values = se::BufferAllocator::getBuffer<float>(se::PoolType::TWEEN, static_cast<uint>(TweenStream::VALUE), &size);
+    _valueCount = _values ? size / (sizeof(float) * COMPONENT_COUNT) : 0;
+    return _transformCount || _valueCount;
+}
+
+bool TweenSystem::readCurrent(uint property, uint target, float *value) const {
+    if (property == static_cast<uint>(TweenProperty::VALUE)) {
+        if (target >= _valueCount) return false;
+        memcpy(value, _values + target * COMPONENT_COUNT, sizeof(float) * COMPONENT_COUNT);
+        return true;
+    }
+    if (target >= _transformCount) return false;
+    const uint components = PROPERTY_COMPONENTS[property];
+    memcpy(value, _transformStreams[property] + target * components, sizeof(float) * components);
+    return true;
+}
+
+void TweenSystem::write(uint property, uint target, const float *value) {
+    if (property == static_cast<uint>(TweenProperty::VALUE)) {
+        if (target < _valueCount) memcpy(_values + target * COMPONENT_COUNT, value, sizeof(float) * COMPONENT_COUNT);
+        return;
+    }
+    if (target >= _transformCount) return;
+
+    float *out = _transformStreams[property] + target * PROPERTY_COMPONENTS[property];
+    if (property == static_cast<uint>(TweenProperty::ROTATION)) {
+        const float length2 = value[0] * value[0] + value[1] * value[1] + value[2] * value[2] + value[3] * value[3];
+        const float scale = length2 > 0.F ? 1.F / std::sqrt(length2) : 0.F;
+        for (uint i = 0; i < 4; ++i) out[i] = value[i] * scale;
+    } else {
+        memcpy(out, value, sizeof(float) * 3);
+    }
+    _dirty[target] |= static_cast<uint32_t>(PROPERTY_BITS[property]);
+}
+
+uint TweenSystem::spawn(uint count) {
+    uint size = 0;
+    const auto *tweens = se::BufferAllocator::getBuffer<TweenSpawn>(se::PoolType::TWEEN, static_cast<uint>(TweenStream::SPAWN), &size);
+    if (!tweens) return 0;
+    count = std::min(count, static_cast<uint>(size / sizeof(TweenSpawn)));
+    fetchStreams();
+
+    uint added = 0;
+    for (uint i = 0; i < count; ++i) {
+        const TweenSpawn &tween = tweens[i];
+        if (tween.property >= static_cast<uint>(TweenProperty::COUNT) || tween.easing >= static_cast<uint>(TweenEasing::COUNT)) continue;
+        stop(tween.id);
+        add(tween);
+        ++added;
+    }
+    return added;
+}
+
+void TweenSystem::add(const TweenSpawn &tween) {
+    float from[COMPONENT_COUNT];
+    float to[COMPONENT_COUNT];
+    memcpy(from, tween.from, sizeof(from));
+    memcpy(to, tween.to, sizeof(to));
+    if (tween.flags & static_cast<uint>(TweenFlag::FROM_CURRENT)) readCurrent(tween.property, tween.target, from);
+    if (tween.property == static_cast<uint>(TweenProperty::ROTATION)) {
+        // the shorter arc, q and -q are the same rotation
+        if (from[0] * to[0] + from[1] * to[1] + from[2] * to[2] + from[3] * to[3] < 0.F) {
+            for (float &component : to) component = -component;
+        }
+    } else if (tween.property != static_cast<uint>(TweenProperty::VALUE)) {
+        from[3] = to[3] = 0.F;
+    }
+
+    const uint groupIndex = tween.easing;
+    Group &group = _groups[groupIndex];
+    const uint index = group.count;
+    resize(group, index + 1);
+    group.ids[index] = tween.id;
+    group.targets[index] = tween.target;
+    group.properties[index] = tween.property;
+    group.repeats[index] = tween.repeat;
+    group.flags[index] = tween.flags;
+    group.elapsed[index] = -std::max(tween.delay, 0.F);
+    group.durations[index] = std::max(tween.duration, MIN_DURATION);
+    group.invDurations[index] = 1.F / group.durations[index];
+    for (uint c = 0; c < COMPONENT_COUNT; ++c) {
+        group.from[c][index] = from[c];
+        group.delta[c][index] = to[c] - from[c];
+    }
+    _locations[tween.id] = {groupIndex, index};
+}
+
+void TweenSystem::resize(Group &group, uint count) {
+    group.count = count;
+    const uint lanes = roundUp4(count);
+    if (group.ids.size() == lanes) return;
+    group.ids.resize(lanes);
+    group.targets.resize(lanes);
+    group.properties.resize(lanes);
+    group.repeats.resize(lanes);
+    group.flags.resize(lanes);
+    group.elapsed.resize(lanes);
+    group.durations.resize(lanes, 1.F);
+    group.invDurations.resize(lanes, 1.F);
+    for (uint c = 0; c < COMPONENT_COUNT; ++c) {
+        group.from[c].resize(lanes);
+        group.delta[c].resize(lanes);
+        group.values[c].resize(lanes);
+    }
+    group.progress.resize(lanes);
+}
+
+// the last tween takes the place of the removed one
+void TweenSystem::remove(Group &group, uint index) {
+    _locations.erase(group.ids[index]);
+    const uint last = group.count - 1;
+    if (index != last) {
+        group.ids[index] = group.ids[last];
+        group.targets[index] = group.targets[last];
+        group.properties[index] = group.properties[last];
+        group.repeats[index] = group.repeats[last];
+        group.flags[index] = group.flags[last];
+        group.elapsed[index] = group.elapsed[last];
+        group.durations[index] = group.durations[last];
+        group.invDurations[index] = group.invDurations[last];
+        for (uint c = 0; c < COMPONENT_COUNT; ++c) {
+            group.from[c][index] = group.from[c][last];
+            group.delta[c][index] = group.delta[c][last];
+        }
+        _locations[group.ids[index]].index = index;
+    }
+    resize(group, last);
+}
+
+void TweenSystem::stop(uint id) {
+    const auto iter = _locations.find(id);
+    if (iter == _locations.end()) return;
+    remove(_groups[iter->second.group], iter->second.index);
+}
+
+void TweenSystem::stopAll() {
+    for (Group &group : _groups) resize(group, 0);
+    _locations.clear();
+    _completed.clear();
+}
+
+uint TweenSystem::update(float dt) {
+    fetchStreams();
+    for (uint i = 0; i < static_cast<uint>(TweenEasing::COUNT); ++i) {
+        if (_groups[i].count) evaluate(static_cast<TweenEasing>(i), _groups[i], dt);
+    }
+
+    uint size = 0;
+    auto *completed = se::BufferAllocator::getBuffer<uint32_t>(se::PoolType::TWEEN, static_cast<uint>(TweenStream::COMPLETED), &size);
+    if (!completed || _completed.empty()) return 0;
+    const uint count = std::min(static_cast<uint>(_completed.size()), static_cast<uint>(size / sizeof(uint32_t)));
+    std::copy(_completed.begin(), _completed.begin() + count, completed);
+    _completed.erase(_completed.begin(), _completed.begin() + count);
+    return count;
+}
+
+void TweenSystem::evaluate(TweenEasing easing, Group &group, float dt) {
+    const uint lanes = roundUp4(group.count);
+
+    // the progress of four tweens at a time, clamped to [0, 1]
+    const F4 step = f4Set(dt);
+    const F4 zero = f4Set(0.F);
+    const F4 one = f4Set(1.F);
+    for (uint i = 0; i < lanes; i += 4) {
+        const F4 elapsed = f4Add(f4Load(&group.elapsed[i]), step);
+        f4Store(&group.elapsed[i], elapsed);
+        f4Store(&group.progress[i], f4Min(f4Max(f4Mul(elapsed, f4Load(&group.invDurations[i])), zero), one));
+    }
+
+    ease(easing, group.progress.data(), lanes);
+
+    for (uint c = 0; c < COMPONENT_COUNT; ++c) {
+        const float *from = group.from[c].data();
+        const float *delta = group.delta[c].data();
+        float *values = group.values[c].data();
+        for (uint i = 0; i < lanes; i += 4) {
+            f4Store(values + i, f4MulAdd(f4Load(from + i), f4Load(delta + i), f4Load(&group.progress[i])));
+        }
+    }
+
+    // the targets are scattered, written one tween at a time
+    _finished.clear();
+    for (uint i = 0; i < group.count; ++i) {
+        float &elapsed = group.elapsed[i];
+        if (elapsed < 0.F) continue;
+        const float value[COMPONENT_COUNT] = {group.values[0][i], group.values[1][i], group.values[2][i], group.values[3][i]};
+        write(group.properties[i], group.targets[i], value);
+        if (elapsed < group.durations[i]) continue;
+
+        if (group.repeats[i] == 0) {
+            _finished.push_back(i);
+            continue;
+        }
+        if (group.repeats[i] != REPEAT_FOREVER) --group.repeats[i];
+        elapsed = std::min(elapsed - group.durations[i], group.durations[i]);
+        if (group.flags[i] & static_cast<uint>(TweenFlag::YOYO)) {
+            for (uint c = 0; c < COMPONENT_COUNT; ++c) {
+                group.from[c][i] += group.delta[c][i];
+                group.delta[c][i] = -group.delta[c][i];
+            }
+        }
+    }
+
+    // backwards, a removal only moves a tween from behind the ones left to remove
+    for (auto iter = _finished.rbegin(); iter != _finished.rend(); ++iter) {
+        _completed.push_back(group.ids[*iter]);
+        remove(group, *iter);
+    }
+}
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "../Define.h"
+#include "SharedMemory.h"
+
+#include <unordered_map>
+
+namespace cc {
+namespace pipeline {
+
+enum class TweenProperty : uint {
+    POSITION, // local position of a TransformSystem slot, 3 floats
+    ROTATION, // local rotation of a TransformSystem slot, 4 floats, normalized lerp along the shorter arc
+    SCALE,    // local scale of a TransformSystem slot, 3 floats
+    VALUE,    // 4 floats of the VALUE stream, opacity, colors or anything else JS copies out itself
+    COUNT,
+};
+
+// A curve eases in, out, or in over the first half and out over the second.
+enum class TweenEasing : uint {
+    LINEAR,
+    QUAD_IN,
+    QUAD_OUT,
+    QUAD_IN_OUT,
+    CUBIC_IN,
+    CUBIC_OUT,
+    CUBIC_IN_OUT,
+    QUART_IN,
+    QUART_OUT,
+    QUART_IN_OUT,
+    QUINT_IN,
+    QUINT_OUT,
+    QUINT_IN_OUT,
+    BACK_IN,
+    BACK_OUT,
+    BACK_IN_OUT,
+    SINE_IN,
+    SINE_OUT,
+    SINE_IN_OUT,
+    EXPO_IN,
+    EXPO_OUT,
+    EXPO_IN_OUT,
+    BOUNCE_IN,
+    BOUNCE_OUT,
+    BOUNCE_IN_OUT,
+    ELASTIC_IN,
+    ELASTIC_OUT,
+    ELASTIC_IN_OUT,
+    COUNT,
+};
+
+enum class TweenFlag : uint {
+    NONE = 0,
+    YOYO = 1 << 0,         // a repeat plays backwards from where the last one stopped
+    FROM_CURRENT = 1 << 1, // starts from the value the target holds when spawned instead of from
+};
+
+// A tween JS writes into the SPAWN stream, 64 bytes viewed as uint32 and float.
+struct TweenSpawn {
+    uint32_t id;     // chosen by JS, reported back when completed, a live tween of the same id is replaced
+    uint32_t target; // TransformSystem slot, or the index of 4 floats into the VALUE stream
+    uint32_t property;
+    uint32_t easing;
+    uint32_t repeat; // times played again after the first, TweenSystem::REPEAT_FOREVER never completes
+    uint32_t flags;  // TweenFlag
+    float duration;  // seconds
+    float delay;     // seconds before the target is first written
+    float from[4];
+    float to[4];
+};
+static_assert(sizeof(TweenSpawn) == 64, "the layout of TweenSpawn is shared with JS");
+
+// The streams are array buffers of a BufferAllocator of PoolType::TWEEN, allocated at the index of the stream.
+enum class TweenStream : uint {
+    SPAWN,     // TweenSpawn, read by spawn()
+    COMPLETED, // uint32, ids of the tweens completed by update(), the ids not fitting are reported by the next one
+    VALUE,     // 4 floats a VALUE target
+    COUNT,
+};
+
+// Tweens evaluated natively in bulk, writing straight into the local TRS streams of TransformSystem and
+// setting their DIRTY bits, so a tween costs no JS call and no binding call per frame.
+// The tweens are grouped by easing and stored as structure-of-arrays, update() advances the time, eases
+// and interpolates four tweens at a time where SSE or NEON is available, then scatters the values into the
+// targets. The curves made of products (linear to quint, back) are eased in SIMD, the others per lane.
+// JS calls update() before TransformSystem.update(), then reads the completed ids once for the frame.
+class CC_DLL TweenSystem final : public Object {
+public:
+    static constexpr uint REPEAT_FOREVER = 0xffffffff;
+
+    static TweenSystem *getInstance();
+    static void destroyInstance();
+
+    // Adds the first count tweens of the SPAWN stream, returns the number added, invalid ones are skipped.
+    uint spawn(uint count);
+    // Stopped tweens leave their targets as they are and are not reported as completed.
+    void stop(uint id);
+    void stopAll();
+
+    // Returns the number of ids written into the COMPLETED stream.
+    uint update(float dt);
+
+    CC_INLINE uint getTweenCount() const { return static_cast<uint>(_locations.size()); }
+
+private:
+    static constexpr uint COMPONENT_COUNT = 4;
+
+    // the tweens of one easing, padded to a multiple of 4 lanes
+    struct Group {
+        uint count = 0;
+        UintList ids;
+        UintList targets;
+        UintList properties;
+        UintList repeats;
+        UintList flags;
+        vector<float> elapsed; // negative while delayed
+        vector<float> durations;
+        vector<float> invDurations;
+        vector<float> from[COMPONENT_COUNT];
+        vector<float> delta[COMPONENT_COUNT];
+        vector<float> values[COMPONENT_COUNT]; // of this update
+        vector<float> progress;                // eased, of this update
+    };
+
+    struct Location {
+        uint group = 0;
+        uint index = 0;
+    };
+
+    bool fetchStreams();
+    bool readCurrent(uint property, uint target, float *value) const;
+    void write(uint property, uint target, const float *value);
+    void add(const TweenSpawn &tween);
+    void remove(Group &group, uint index);
+    void resize(Group &group, uint count);
+    void evaluate(TweenEasing easing, Group &group, float dt);
+
+    Group _groups[static_cast<uint>(TweenEasing::COUNT)];
+    std::unordered_map<uint, Location> _locations;
+    UintList _completed; // not reported yet
+    UintList _finished;  // lanes of the group at hand finished this update
+
+    float *_transformStreams[3] = {nullptr}; // POSITION, ROTATION, SCALE
+    uint32_t *_dirty = nullptr;
+    uint _transformCount = 0;
+    float *_values = nullptr;
+    uint _valueCount = 0;
+
+    static TweenSystem *_instance;
+};
+
+} // namespace pipeline
+} // namespace cc
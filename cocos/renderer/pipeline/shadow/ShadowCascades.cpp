@@ -0,0 +1,156 @@
+#include "ShadowCascades.h"
+
+#include "../forward/ForwardPipeline.h"
+#include "gfx/GFXDevice.h"
+
+namespace cc {
+namespace pipeline {
+
+void ShadowCascades::update(ForwardPipeline *pipeline, const Camera *camera, const Light *light, bool isForced) {
+    const auto *shadowInfo = pipeline->getShadows();
+    const auto *frustum = camera->getFrustum();
+    const uint count = std::min(std::max(pipeline->getShadowCascadeCount(), 1u), UBOShadow::MAX_CASCADES);
+    const float distance = pipeline->getShadowCascadeDistance();
+    const auto &lightRotation = light->getNode()->worldRotation;
+
+    isForced = isForced || count != _count || distance != _distance || shadowInfo->size != _mapSize ||
+               camera != _camera || lightRotation != _lightRotation;
+    _count = count;
+    _distance = distance;
+    _mapSize = shadowInfo->size;
+    _camera = camera;
+    _lightRotation = lightRotation;
+    ++_frameIndex;
+
+    // vertices 0-3 lie on the far plane and 4-7 on the near plane of the camera frustum
+    const Vec3 *nearCorners = frustum->vertices + 4;
+    const Vec3 *farCorners = frustum->vertices;
+    Vec3 nearCenter, farCenter;
+    for (uint i = 0; i < 4; i++) {
+        nearCenter += nearCorners[i];
+        farCenter += farCorners[i];
+    }
+    const float cameraNear = std::max((nearCenter * 0.25f - camera->position).dot(camera->forward), 0.001f);
+    const float cameraFar = std::max((farCenter * 0.25f - camera->position).dot(camera->forward), cameraNear + 0.001f);
+    const float maxDistance = distance > cameraNear ? std::min(distance, cameraFar) : cameraFar;
+
+    const uint tileWidth = count > 1 ? (uint)_mapSize.x / 2 : (uint)_mapSize.x;
+    const uint tileHeight = count > 1 ? (uint)_mapSize.y / 2 : (uint)_mapSize.y;
+    float splitNear = cameraNear;
+    for (uint i = 0; i < count; i++) {
+        auto &cascade = _cascades[i];
+        const float ratio = (float)(i + 1) / count;
+        const float logSplit = cameraNear * std::pow(maxDistance / cameraNear, ratio);
+        const float uniformSplit = cameraNear + (maxDistance - cameraNear) * ratio;
+        const float splitFar = SPLIT_LAMBDA * logSplit + (1.0f - SPLIT_LAMBDA) * uniformSplit;
+
+        const uint interval = i < 2 ? 1 : 1 << (i - 1);
+        cascade.needsUpdate = isForced || (_frameIndex + i) % interval == 0;
+        if (cascade.needsUpdate) {
+            cascade.renderArea = {(int)((i % 2) * tileWidth), (int)((i / 2) * tileHeight), tileWidth, tileHeight};
+            cascade.splitFar = splitFar;
+            fitCascade(pipeline, nearCorners, farCorners,
+                       (splitNear - cameraNear) / (cameraFar - cameraNear),
+                       (splitFar - cameraNear) / (cameraFar - cameraNear), cascade);
+        }
+        splitNear = splitFar;
+    }
+}
+
+void ShadowCascades::fitCascade(ForwardPipeline *pipeline, const Vec3 *nearCorners, const Vec3 *farCorners,
+                                float nearT, float farT, ShadowCascade &cascade) const {
+    auto *device = gfx::Device::getInstance();
+    const auto *sphere = pipeline->getSphere();
+
+    // bounding sphere of the slice, keeps the projection size constant while the camera rotates
+    Vec3 corners[8];
+    Vec3 center;
+    for (uint i = 0; i < 4; i++) {
+        const Vec3 ray = farCorners[i] - nearCorners[i];
+        corners[i] = nearCorners[i] + ray * nearT;
+        corners[i + 4] = nearCorners[i] + ray * farT;
+        center += corners[i] + corners[i + 4];
+    }
+    center *= 0.125f;
+    float radius = 0.0f;
+    for (const auto &corner : corners) {
+        radius = std::max(radius, corner.distance(center));
+    }
+    radius = std::ceil(radius * 16.0f) / 16.0f;
+
+    Mat4 matRotation;
+    Mat4::fromRT(_lightRotation, Vec3::ZERO, &matRotation);
+    const Vec3 right(matRotation.m[0], matRotation.m[1], matRotation.m[2]);
+    const Vec3 up(matRotation.m[4], matRotation.m[5], matRotation.m[6]);
+    const Vec3 back(matRotation.m[8], matRotation.m[9], matRotation.m[10]);
+
+    // snap the center to whole texels in light space so that the shadow edges don't shimmer
+    const float texelX = 2.0f * radius / cascade.renderArea.width;
+    const float texelY = 2.0f * radius / cascade.renderArea.height;
+    const float x = std::floor(center.dot(right) / texelX) * texelX;
+    const float y = std::floor(center.dot(up) / texelY) * texelY;
+    center = right * x + up * y + back * center.dot(back);
+
+    // casters between the light and the slice still have to land in the depth range
+    const float casterDistance = (sphere->center - center).dot(back) + sphere->radius;
+    const float behind = std::min(std::max(radius, casterDistance), SHADOW_CAMERA_MAX_FAR);
+    const Vec3 eye = center + back * behind;
+    const float farClamp = behind + radius;
+
+    Mat4 matShadowCamera;
+    Mat4::fromRT(_lightRotation, eye, &matShadowCamera);
+    const auto projectionSinY = device->getScreenSpaceSignY() * device->getUVSpaceSignY();
+    Mat4::createOrthographicOffCenter(-radius, radius, -radius, radius, 0.0f, farClamp, device->getClipSpaceMinZ(), projectionSinY, &cascade.matLightViewProj);
+    cascade.matLightViewProj.multiply(matShadowCamera.getInversed());
+
+    // clip space of the whole shadow map to the clip space of the tile
+    const auto &area = cascade.renderArea;
+    Mat4 matTile;
+    matTile.m[0] = (float)area.width / _mapSize.x;
+    matTile.m[5] = (float)area.height / _mapSize.y;
+    matTile.m[12] = (2.0f * area.x + area.width) / _mapSize.x - 1.0f;
+    matTile.m[13] = (2.0f * area.y + area.height) / _mapSize.y - 1.0f;
+    Mat4::multiply(matTile, cascade.matLightViewProj, &cascade.matSampleViewProj);
+
+    // inward facing planes of the light space box
+    const Vec3 forward = -back;
+    auto *planes = cascade.frustum.planes;
+    planes[0] = {right, right.dot(eye) - radius};
+    planes[1] = {-right, -right.dot(eye) - radius};
+    planes[2] = {up, up.dot(eye) - radius};
+    planes[3] = {-up, -up.dot(eye) - radius};
+    planes[4] = {forward, forward.dot(eye)};
+    planes[5] = {back, back.dot(eye) - farClamp};
+
+    cascade.casters.clear();
+    for (const auto &ro : pipeline->getShadowObjects()) {
+        const auto *bounds = ro.model->getWorldBounds();
+        if (bounds && aabb_frustum(bounds, &cascade.frustum)) {
+            cascade.casters.emplace_back(ro);
+        }
+    }
+}
+
+void ShadowCascades::fillShadowUBO(std::array<float, UBOShadow::COUNT> &shadowUBO) const {
+    float splits[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (uint i = 0; i < _count; i++) {
+        memcpy(shadowUBO.data() + UBOShadow::MAT_CASCADE_VIEW_PROJ_OFFSET + 16 * i, _cascades[i].matSampleViewProj.m, sizeof(Mat4));
+        splits[i] = _cascades[i].splitFar;
+    }
+    memcpy(shadowUBO.data() + UBOShadow::MAT_LIGHT_VIEW_PROJ_OFFSET, _cascades[0].matSampleViewProj.m, sizeof(Mat4));
+    memcpy(shadowUBO.data() + UBOShadow::CASCADE_SPLITS_OFFSET, splits, sizeof(splits));
+
+    float cascadeInfos[4] = {(float)_count, 0.0f, 0.0f, 0.0f};
+    memcpy(shadowUBO.data() + UBOShadow::CASCADE_INFO_OFFSET, cascadeInfos, sizeof(cascadeInfos));
+}
+
+void ShadowCascades::clear() {
+    for (auto &cascade : _cascades) {
+        cascade.casters.clear();
+    }
+    _count = 0;
+    _camera = nullptr;
+}
+
+} // namespace pipeline
+} // namespace cc
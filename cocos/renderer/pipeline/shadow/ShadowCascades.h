@@ -0,0 +1,56 @@
+#pragma once
+#include <array>
+
+#include "../Define.h"
+#include "../helper/SharedMemory.h"
+#include "math/Mat4.h"
+
+namespace cc {
+namespace pipeline {
+class ForwardPipeline;
+
+// A slice of the camera frustum covered by one tile of the main light's shadow map.
+struct CC_DLL ShadowCascade {
+    // renders the casters into the tile
+    Mat4 matLightViewProj;
+    // matLightViewProj remapped into the tile, which receivers sample with
+    Mat4 matSampleViewProj;
+    // light space box the casters are culled against
+    Frustum frustum;
+    gfx::Rect renderArea;
+    // view space distance the cascade ends at
+    float splitFar = 0.0f;
+    RenderObjectList casters;
+    bool needsUpdate = true;
+};
+
+// Fits an orthographic light projection to consecutive slices of the camera frustum and packs
+// them into a 2x2 atlas over the shadow map. The first two cascades are refreshed every frame,
+// the farther ones every 2^(i-1) frames, staggered so that they don't update at the same time.
+class CC_DLL ShadowCascades : public Object {
+public:
+    void update(ForwardPipeline *pipeline, const Camera *camera, const Light *light, bool isForced);
+    // Writes the sampling matrices and splits of all cascades, cascade 0 also goes to cc_matLightViewProj.
+    void fillShadowUBO(std::array<float, UBOShadow::COUNT> &shadowUBO) const;
+    void clear();
+
+    CC_INLINE uint getCount() const { return _count; }
+    CC_INLINE const ShadowCascade &getCascade(uint idx) const { return _cascades[idx]; }
+
+private:
+    void fitCascade(ForwardPipeline *pipeline, const Vec3 *nearCorners, const Vec3 *farCorners,
+                    float nearT, float farT, ShadowCascade &cascade) const;
+
+    static constexpr float SPLIT_LAMBDA = 0.75f; // blend between logarithmic and uniform splits
+
+    std::array<ShadowCascade, UBOShadow::MAX_CASCADES> _cascades;
+    uint _count = 0;
+    float _distance = 0.0f;
+    Vec2 _mapSize;
+    Vec4 _lightRotation;
+    const Camera *_camera = nullptr;
+    uint _frameIndex = 0;
+};
+
+} // namespace pipeline
+} // namespace cc
@@ -3,6 +3,7 @@
 
 #include "../Define.h"
 #include "../forward/ForwardPipeline.h"
+#include "../helper/GPUTimer.h"
 #include "../helper/SharedMemory.h"
 #include "ShadowStage.h"
 #include "gfx/GFXDescriptorSet.h"
@@ -41,12 +42,28 @@ void ShadowFlow::activate(RenderPipeline *pipeline) {
 
 void ShadowFlow::render(Camera *camera) {
     auto *pipeline = static_cast<ForwardPipeline *>(_pipeline);
-    const auto *shadowInfo = pipeline->getShadows();
+    auto *shadowInfo = pipeline->getShadows();
     if (!shadowInfo->enabled || shadowInfo->getShadowType() != ShadowType::SHADOWMAP) return;
 
     lightCollecting(camera, _validLights);
     shadowCollecting(pipeline, camera);
 
+    const bool isCached = pipeline->isShadowMapCache();
+    if (isCached) {
+        classifyCasters(pipeline->getShadowObjects());
+    } else if (!_shadowMapCaches.empty()) {
+        destroyShadowMapCaches();
+    }
+
+    // cascades replace the single shadow map of the main directional light
+    const auto *scene = camera->getScene();
+    const Light *cascadedLight = nullptr;
+    if (pipeline->getShadowCascadeCount() > 1 && scene->mainLightID) {
+        cascadedLight = scene->getMainLight();
+    }
+    if (!cascadedLight) _shadowCascades.clear();
+
+    GPUTimer *gpuTimer = pipeline->getGPUTimer();
     const auto &shadowFramebufferMap = pipeline->getShadowFramebufferMap();
     for (const auto *light : _validLights) {
         if (!shadowFramebufferMap.count(light)) {
@@ -56,13 +73,32 @@ void ShadowFlow::render(Camera *camera) {
         auto *shadowFrameBuffer = shadowFramebufferMap.at(light);
         if (shadowInfo->shadowMapDirty) {
             resizeShadowMap(light, (uint)shadowInfo->size.x, (uint)shadowInfo->size.y);
+            // recreated at the new size below
+            if (_shadowMapCaches.count(light)) {
+                destroyShadowMapCache(_shadowMapCaches[light]);
+                _shadowMapCaches.erase(light);
+            }
+        }
+        const bool isCascaded = light == cascadedLight;
+        if (isCascaded) {
+            _shadowCascades.update(pipeline, camera, light, shadowInfo->shadowMapDirty);
         }
+        auto *cache = isCached && !isCascaded ? &getOrCreateShadowMapCache(light) : nullptr;
         for (auto *_stage : _stages) {
             auto *shadowStage = static_cast<ShadowStage *>(_stage);
             shadowStage->setUseData(light, shadowFrameBuffer);
+            if (isCascaded) {
+                shadowStage->setCascadeData(&_shadowCascades, getOrCreateCascadeRenderPass());
+            } else if (cache) {
+                shadowStage->setCacheData(cache, _compositeRenderPass, &_staticCasters, &_dynamicCasters, _staticCasterHash);
+            }
             shadowStage->render(camera);
+            if (gpuTimer) gpuTimer->endStage(shadowStage);
         }
     }
+
+    // nothing else consumes the flag in shadow map mode, the caches have seen it now
+    if (isCached) shadowInfo->dirty = false;
 }
 
 void ShadowFlow::resizeShadowMap(const Light *light, const uint width, const uint height) const {
@@ -124,10 +160,11 @@ void ShadowFlow::initShadowFrameBuffer(ForwardPipeline *pipeline, const Light *l
         });
     }
 
+    // the shadow map cache is copied into the shadow maps
     vector<gfx::Texture *> renderTargets;
     renderTargets.emplace_back(device->createTexture({
         gfx::TextureType::TEX2D,
-        gfx::TextureUsageBit::COLOR_ATTACHMENT | gfx::TextureUsageBit::SAMPLED,
+        gfx::TextureUsageBit::COLOR_ATTACHMENT | gfx::TextureUsageBit::SAMPLED | gfx::TextureUsageBit::TRANSFER_DST,
         gfx::Format::RGBA8,
         width,
         height,
@@ -135,7 +172,7 @@ void ShadowFlow::initShadowFrameBuffer(ForwardPipeline *pipeline, const Light *l
 
     gfx::Texture *depth = device->createTexture({
         gfx::TextureType::TEX2D,
-        gfx::TextureUsageBit::DEPTH_STENCIL_ATTACHMENT,
+        gfx::TextureUsageBit::DEPTH_STENCIL_ATTACHMENT | gfx::TextureUsageBit::TRANSFER_DST,
         device->getDepthStencilFormat(),
         width,
         height,
@@ -151,13 +188,185 @@ void ShadowFlow::initShadowFrameBuffer(ForwardPipeline *pipeline, const Light *l
     pipeline->setShadowFramebuffer(light, framebuffer);
 }
 
+void ShadowFlow::classifyCasters(const RenderObjectList &shadowObjects) {
+    ++_frameIndex;
+    _staticCasters.clear();
+    _dynamicCasters.clear();
+    size_t hash = 0;
+
+    for (const auto &ro : shadowObjects) {
+        const auto *model = ro.model;
+        const auto *bounds = model->getWorldBounds();
+        const auto *transform = model->transformID ? model->getTransform() : model->getNode();
+        auto &state = _casterStates[model];
+
+        // skinned models keep their transform while animating, but not their world bounds
+        const bool isMoved = !state.lastFrame || (transform && transform->flagsChanged) ||
+                             state.center != bounds->center || state.halfExtents != bounds->halfExtents;
+        state.stableFrames = isMoved ? 0 : std::min(state.stableFrames + 1, STATIC_CASTER_FRAMES);
+        state.center = bounds->center;
+        state.halfExtents = bounds->halfExtents;
+        state.lastFrame = _frameIndex;
+
+        if (state.stableFrames < STATIC_CASTER_FRAMES) {
+            _dynamicCasters.emplace_back(ro);
+            continue;
+        }
+        _staticCasters.emplace_back(ro);
+        hash ^= std::hash<const ModelView *>{}(model) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+    _staticCasterHash = hash;
+
+    // forget casters which left the scene
+    if (_casterStates.size() > shadowObjects.size() * 2) {
+        for (auto iter = _casterStates.begin(); iter != _casterStates.end();) {
+            iter = iter->second.lastFrame == _frameIndex ? std::next(iter) : _casterStates.erase(iter);
+        }
+    }
+}
+
+ShadowMapCache &ShadowFlow::getOrCreateShadowMapCache(const Light *light) {
+    auto &cache = _shadowMapCaches[light];
+    if (cache.framebuffer) return cache;
+
+    auto device = gfx::Device::getInstance();
+    const auto shadowMapSize = static_cast<ForwardPipeline *>(_pipeline)->getShadows()->size;
+    const auto width = (uint)shadowMapSize.x;
+    const auto height = (uint)shadowMapSize.y;
+
+    if (!_cacheRenderPass) {
+        // the cache keeps its depth around to test the dynamic casters against, which the composite pass loads
+        _cacheRenderPass = device->createRenderPass({
+            {{
+                gfx::Format::RGBA8,
+                1,
+                gfx::LoadOp::CLEAR,
+                gfx::StoreOp::STORE,
+                gfx::TextureLayout::UNDEFINED,
+                gfx::TextureLayout::COLOR_ATTACHMENT_OPTIMAL,
+            }},
+            {
+                device->getDepthStencilFormat(),
+                1,
+                gfx::LoadOp::CLEAR,
+                gfx::StoreOp::STORE,
+                gfx::LoadOp::CLEAR,
+                gfx::StoreOp::DISCARD,
+                gfx::TextureLayout::UNDEFINED,
+                gfx::TextureLayout::DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            },
+        });
+        _compositeRenderPass = device->createRenderPass({
+            {{
+                gfx::Format::RGBA8,
+                1,
+                gfx::LoadOp::LOAD,
+                gfx::StoreOp::STORE,
+                gfx::TextureLayout::SHADER_READONLY_OPTIMAL,
+                gfx::TextureLayout::SHADER_READONLY_OPTIMAL,
+            }},
+            {
+                device->getDepthStencilFormat(),
+                1,
+                gfx::LoadOp::LOAD,
+                gfx::StoreOp::DISCARD,
+                gfx::LoadOp::LOAD,
+                gfx::StoreOp::DISCARD,
+                gfx::TextureLayout::DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                gfx::TextureLayout::DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            },
+        });
+    }
+
+    vector<gfx::Texture *> renderTargets;
+    renderTargets.emplace_back(device->createTexture({
+        gfx::TextureType::TEX2D,
+        gfx::TextureUsageBit::COLOR_ATTACHMENT | gfx::TextureUsageBit::TRANSFER_SRC,
+        gfx::Format::RGBA8,
+        width,
+        height,
+    }));
+
+    gfx::Texture *depth = device->createTexture({
+        gfx::TextureType::TEX2D,
+        gfx::TextureUsageBit::DEPTH_STENCIL_ATTACHMENT | gfx::TextureUsageBit::TRANSFER_SRC,
+        device->getDepthStencilFormat(),
+        width,
+        height,
+    });
+
+    cache.framebuffer = device->createFramebuffer({
+        _cacheRenderPass,
+        renderTargets,
+        depth,
+        {}, //colorMipmapLevels
+    });
+    cache.isValid = false;
+
+    return cache;
+}
+
+gfx::RenderPass *ShadowFlow::getOrCreateCascadeRenderPass() {
+    if (_cascadeRenderPass) return _cascadeRenderPass;
+
+    // keeps the tiles of the cascades which aren't rendered this frame
+    auto device = gfx::Device::getInstance();
+    _cascadeRenderPass = device->createRenderPass({
+        {{
+            gfx::Format::RGBA8,
+            1,
+            gfx::LoadOp::CLEAR,
+            gfx::StoreOp::STORE,
+            gfx::TextureLayout::SHADER_READONLY_OPTIMAL,
+            gfx::TextureLayout::SHADER_READONLY_OPTIMAL,
+        }},
+        {
+            device->getDepthStencilFormat(),
+            1,
+            gfx::LoadOp::CLEAR,
+            gfx::StoreOp::DISCARD,
+            gfx::LoadOp::CLEAR,
+            gfx::StoreOp::DISCARD,
+            gfx::TextureLayout::UNDEFINED,
+            gfx::TextureLayout::DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        },
+    });
+    return _cascadeRenderPass;
+}
+
+void ShadowFlow::destroyShadowMapCache(ShadowMapCache &cache) const {
+    if (!cache.framebuffer) return;
+
+    for (auto *renderTarget : cache.framebuffer->getColorTextures()) {
+        CC_SAFE_DESTROY(renderTarget);
+    }
+    auto *depth = cache.framebuffer->getDepthStencilTexture();
+    CC_SAFE_DESTROY(depth);
+    CC_SAFE_DESTROY(cache.framebuffer);
+}
+
+void ShadowFlow::destroyShadowMapCaches() {
+    for (auto &pair : _shadowMapCaches) {
+        destroyShadowMapCache(pair.second);
+    }
+    _shadowMapCaches.clear();
+    _casterStates.clear();
+    _staticCasters.clear();
+    _dynamicCasters.clear();
+}
+
 void ShadowFlow::destroy() {
     static_cast<ForwardPipeline *>(_pipeline)->destroyShadowFrameBuffers();
+    destroyShadowMapCaches();
 
     if (_renderPass) {
         _renderPass->destroy();
         _renderPass = nullptr;
     }
+    CC_SAFE_DESTROY(_cacheRenderPass);
+    CC_SAFE_DESTROY(_compositeRenderPass);
+    CC_SAFE_DESTROY(_cascadeRenderPass);
+    _shadowCascades.clear();
 
     _validLights.clear();
 
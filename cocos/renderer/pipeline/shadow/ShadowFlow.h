@@ -1,9 +1,13 @@
 #pragma once
 #include "../RenderFlow.h"
+#include "ShadowCascades.h"
+#include "ShadowStage.h"
+#include "math/Vec3.h"
 namespace cc {
 namespace pipeline {
 class ForwardPipeline;
 struct Light;
+struct ModelView;
 
 class CC_DLL ShadowFlow : public RenderFlow {
 public:
@@ -25,12 +29,39 @@ private:
 
     void initShadowFrameBuffer(ForwardPipeline *pipeline, const Light *light);
 
+    // Casters whose transform and world bounds stayed unchanged for STATIC_CASTER_FRAMES are cached as static.
+    void classifyCasters(const RenderObjectList &shadowObjects);
+    ShadowMapCache &getOrCreateShadowMapCache(const Light *light);
+    void destroyShadowMapCache(ShadowMapCache &cache) const;
+    void destroyShadowMapCaches();
+    gfx::RenderPass *getOrCreateCascadeRenderPass();
+
 private:
     static RenderFlowInfo _initInfo;
+    static constexpr uint STATIC_CASTER_FRAMES = 30;
+
+    struct CasterState {
+        Vec3 center;
+        Vec3 halfExtents;
+        uint stableFrames = 0;
+        uint lastFrame = 0;
+    };
 
     gfx::RenderPass *_renderPass = nullptr;
+    gfx::RenderPass *_cacheRenderPass = nullptr;
+    gfx::RenderPass *_compositeRenderPass = nullptr;
+    gfx::RenderPass *_cascadeRenderPass = nullptr;
 
     vector<const Light *> _validLights;
+
+    std::unordered_map<const Light *, ShadowMapCache> _shadowMapCaches;
+    std::unordered_map<const ModelView *, CasterState> _casterStates;
+    RenderObjectList _staticCasters;
+    RenderObjectList _dynamicCasters;
+    size_t _staticCasterHash = 0;
+    uint _frameIndex = 0;
+
+    ShadowCascades _shadowCascades;
 };
 } // namespace pipeline
 } // namespace cc
@@ -3,6 +3,8 @@
 #include "../ShadowMapBatchedQueue.h"
 #include "../forward/ForwardPipeline.h"
 #include "../helper/SharedMemory.h"
+#include "ShadowCascades.h"
+#include "base/Profiler.h"
 #include "gfx/GFXCommandBuffer.h"
 #include "gfx/GFXDescriptorSet.h"
 #include "gfx/GFXFramebuffer.h"
@@ -39,6 +41,7 @@ void ShadowStage::activate(RenderPipeline *pipeline, RenderFlow *flow) {
 }
 
 void ShadowStage::render(Camera *camera) {
+    CC_PROFILE_ZONE("ShadowStage::render");
     const auto pipeline = static_cast<ForwardPipeline *>(_pipeline);
     const auto shadowInfo = pipeline->getShadows();
 
@@ -46,6 +49,16 @@ void ShadowStage::render(Camera *camera) {
         return;
     }
 
+    if (_cascades) {
+        renderCascades(camera);
+        return;
+    }
+
+    if (_cache) {
+        renderCached(camera);
+        return;
+    }
+
     auto cmdBuffer = pipeline->getCommandBuffers()[0];
 
     _additiveShadowQueue->gatherLightPasses(_light, cmdBuffer);
@@ -67,6 +80,88 @@ void ShadowStage::render(Camera *camera) {
     cmdBuffer->endRenderPass();
 }
 
+void ShadowStage::renderCached(Camera *camera) {
+    const auto pipeline = static_cast<ForwardPipeline *>(_pipeline);
+    const auto shadowInfo = pipeline->getShadows();
+    auto cmdBuffer = pipeline->getCommandBuffers()[0];
+
+    const auto shadowMapSize = shadowInfo->size;
+    _renderArea.x = (int)(camera->viewportX * shadowMapSize.x);
+    _renderArea.y = (int)(camera->viewportY * shadowMapSize.y);
+    _renderArea.width = (uint)(camera->viewportWidth * shadowMapSize.x * pipeline->getShadingScale());
+    _renderArea.height = (uint)(camera->viewportHeight * shadowMapSize.y * pipeline->getShadingScale());
+    _clearColors[0] = {1.0f, 1.0f, 1.0f, 1.0f};
+
+    const auto &matLightViewProj = _additiveShadowQueue->updateUBOs(_light, cmdBuffer);
+
+    // the light view projection changes with the light node, the shadow settings and auto adapted caster bounds
+    const auto &cachedArea = _cache->renderArea;
+    const bool isCacheValid = _cache->isValid && !shadowInfo->dirty && !_light->getNode()->flagsChanged &&
+                              _cache->staticCasterHash == _staticCasterHash &&
+                              !memcmp(_cache->matLightViewProj.m, matLightViewProj.m, sizeof(matLightViewProj.m)) &&
+                              cachedArea.x == _renderArea.x && cachedArea.y == _renderArea.y &&
+                              cachedArea.width == _renderArea.width && cachedArea.height == _renderArea.height;
+
+    if (!isCacheValid) {
+        auto *renderPass = _cache->framebuffer->getRenderPass();
+        _additiveShadowQueue->gatherCasters(_light, *_staticCasters, cmdBuffer);
+        cmdBuffer->beginRenderPass(renderPass, _cache->framebuffer, _renderArea,
+                                   _clearColors, camera->clearDepth, camera->clearStencil);
+        cmdBuffer->bindDescriptorSet(GLOBAL_SET, pipeline->getDescriptorSet());
+        _additiveShadowQueue->recordCommandBuffer(_device, renderPass, cmdBuffer);
+        cmdBuffer->endRenderPass();
+
+        _cache->matLightViewProj = matLightViewProj;
+        _cache->renderArea = _renderArea;
+        _cache->staticCasterHash = _staticCasterHash;
+        _cache->isValid = true;
+        _cache->isCopied = false;
+    }
+
+    // the shadow map still holds the unchanged cache when nothing dynamic was drawn into it last time
+    if (_cache->isCopied && _dynamicCasters->empty()) return;
+
+    const auto &cacheTextures = _cache->framebuffer->getColorTextures();
+    const auto &shadowTextures = _framebuffer->getColorTextures();
+    gfx::TextureCopy region;
+    region.extent = {shadowTextures[0]->getWidth(), shadowTextures[0]->getHeight(), 1};
+    cmdBuffer->copyTexture(cacheTextures[0], shadowTextures[0], &region, 1);
+    cmdBuffer->copyTexture(_cache->framebuffer->getDepthStencilTexture(), _framebuffer->getDepthStencilTexture(), &region, 1);
+    _cache->isCopied = _dynamicCasters->empty();
+    if (_cache->isCopied) return;
+
+    _additiveShadowQueue->gatherCasters(_light, *_dynamicCasters, cmdBuffer);
+    cmdBuffer->beginRenderPass(_compositeRenderPass, _framebuffer, _renderArea,
+                               _clearColors, camera->clearDepth, camera->clearStencil);
+    cmdBuffer->bindDescriptorSet(GLOBAL_SET, pipeline->getDescriptorSet());
+    _additiveShadowQueue->recordCommandBuffer(_device, _compositeRenderPass, cmdBuffer);
+    cmdBuffer->endRenderPass();
+}
+
+void ShadowStage::renderCascades(Camera *camera) {
+    const auto pipeline = static_cast<ForwardPipeline *>(_pipeline);
+    auto cmdBuffer = pipeline->getCommandBuffers()[0];
+    _clearColors[0] = {1.0f, 1.0f, 1.0f, 1.0f};
+
+    // the render area clears nothing but the tile of the cascade
+    for (uint i = 0; i < _cascades->getCount(); i++) {
+        const auto &cascade = _cascades->getCascade(i);
+        if (!cascade.needsUpdate) continue;
+
+        _additiveShadowQueue->updateUBOs(cascade.matLightViewProj, cmdBuffer);
+        _additiveShadowQueue->gatherCasters(_light, cascade.casters, cmdBuffer);
+        cmdBuffer->beginRenderPass(_cascadeRenderPass, _framebuffer, cascade.renderArea,
+                                   _clearColors, camera->clearDepth, camera->clearStencil);
+        cmdBuffer->bindDescriptorSet(GLOBAL_SET, pipeline->getDescriptorSet());
+        _additiveShadowQueue->recordCommandBuffer(_device, _cascadeRenderPass, cmdBuffer);
+        cmdBuffer->endRenderPass();
+    }
+
+    auto shadowUBO = pipeline->getShadowUBO();
+    _cascades->fillShadowUBO(shadowUBO);
+    cmdBuffer->updateBuffer(pipeline->getDescriptorSet()->getBuffer(UBOShadow::BINDING), shadowUBO.data(), UBOShadow::SIZE);
+}
+
 void ShadowStage::destroy() {	
     CC_SAFE_DESTROY(_additiveShadowQueue);
 
@@ -1,10 +1,23 @@
 #pragma once
 #include "../RenderStage.h"
+#include "math/Mat4.h"
 
 namespace cc {
 namespace pipeline {
 class RenderQueue;
 class ShadowMapBatchedQueue;
+class ShadowCascades;
+
+// Persistent shadow map of a light holding its static casters only.
+struct CC_DLL ShadowMapCache {
+    gfx::Framebuffer *framebuffer = nullptr;
+    Mat4 matLightViewProj;
+    gfx::Rect renderArea;
+    size_t staticCasterHash = 0;
+    bool isValid = false;
+    // whether the light's shadow map currently holds nothing but a copy of the cache
+    bool isCopied = false;
+};
 
 class CC_DLL ShadowStage : public RenderStage {
 public:
@@ -22,15 +35,43 @@ public:
     CC_INLINE void setUseData(const Light *light, gfx::Framebuffer *framebuffer) {
         _light = light;
         _framebuffer = framebuffer;
+        _cache = nullptr;
+        _cascades = nullptr;
     };
+    // Draws the dynamic casters over a copy of the cache, which is only re-rendered from the static casters once invalidated.
+    CC_INLINE void setCacheData(ShadowMapCache *cache, gfx::RenderPass *compositeRenderPass, const RenderObjectList *staticCasters,
+                                const RenderObjectList *dynamicCasters, size_t staticCasterHash) {
+        _cache = cache;
+        _compositeRenderPass = compositeRenderPass;
+        _staticCasters = staticCasters;
+        _dynamicCasters = dynamicCasters;
+        _staticCasterHash = staticCasterHash;
+    }
+    // Draws the cascades due this frame into their tiles of the shadow map, the others are kept from earlier frames.
+    CC_INLINE void setCascadeData(const ShadowCascades *cascades, gfx::RenderPass *cascadeRenderPass) {
+        _cascades = cascades;
+        _cascadeRenderPass = cascadeRenderPass;
+    }
 
 private:
+    void renderCached(Camera *camera);
+    void renderCascades(Camera *camera);
+
     static RenderStageInfo _initInfo;
 
     gfx::Rect _renderArea;
     const Light *_light = nullptr;
     gfx::Framebuffer *_framebuffer = nullptr;
 
+    ShadowMapCache *_cache = nullptr;
+    gfx::RenderPass *_compositeRenderPass = nullptr;
+    const RenderObjectList *_staticCasters = nullptr;
+    const RenderObjectList *_dynamicCasters = nullptr;
+    size_t _staticCasterHash = 0;
+
+    const ShadowCascades *_cascades = nullptr;
+    gfx::RenderPass *_cascadeRenderPass = nullptr;
+
     ShadowMapBatchedQueue *_additiveShadowQueue = nullptr;
 };
 
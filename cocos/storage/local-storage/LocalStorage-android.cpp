@@ -30,7 +30,7 @@
  Works on cocos2d-iphone and cocos2d-x.
  */
 
-#include "storage/local-storage/LocalStorage.h"
+#include "storage/local-storage/LocalStorageBackend.h"
 #include "base/Macros.h"
 
 #if (CC_PLATFORM == CC_PLATFORM_ANDROID)
@@ -39,6 +39,7 @@
 #include <stdlib.h>
 #include <assert.h>
 #include "jni.h"
+#include "base/UTF8.h"
 #include "platform/android/jni/JniHelper.h"
 
 #ifndef JCLS_LOCALSTORAGE
@@ -46,7 +47,6 @@
 #endif
 
 using namespace cc;
-static int _initialized = 0;
 
 static void splitFilename (std::string& str)
 {
@@ -58,40 +58,27 @@ static void splitFilename (std::string& str)
     }
 }
 
-void localStorageInit( const std::string& fullpath)
-{
-    if (fullpath.empty())
-        return;
-
-    if( ! _initialized )
-    {
-        std::string strDBFilename = fullpath;
-        splitFilename(strDBFilename);
-        if (JniHelper::callStaticBooleanMethod(JCLS_LOCALSTORAGE, "init", strDBFilename, "data")) {
-            _initialized = 1;
-        }
-    }
-}
+namespace {
 
-void localStorageFree()
+class LocalStorageAndroid : public LocalStorageBackend
 {
-    if (_initialized) {
-        JniHelper::callStaticVoidMethod(JCLS_LOCALSTORAGE, "destroy");
-        _initialized = 0;
-    }
-}
+public:
+    ~LocalStorageAndroid() override;
 
-/** sets an item in the LS */
-void localStorageSetItem( const std::string& key, const std::string& value)
+    bool getItem(const std::string &key, std::string *outItem) override;
+    void write(const std::vector<LocalStorageWrite> &writes) override;
+    void clear() override;
+    void getKey(int index, std::string *outKey) override;
+    int getLength() override;
+};
+
+LocalStorageAndroid::~LocalStorageAndroid()
 {
-    assert( _initialized );
-    JniHelper::callStaticVoidMethod(JCLS_LOCALSTORAGE, "setItem", key, value);
+    JniHelper::callStaticVoidMethod(JCLS_LOCALSTORAGE, "destroy");
 }
 
-/** gets an item from the LS */
-bool localStorageGetItem( const std::string& key, std::string *outItem )
+bool LocalStorageAndroid::getItem(const std::string &key, std::string *outItem)
 {
-    assert( _initialized );
     JniMethodInfo t;
 
     if (JniHelper::getStaticMethodInfo(t, JCLS_LOCALSTORAGE, "getItem", "(Ljava/lang/String;)Ljava/lang/String;"))
@@ -120,32 +107,63 @@ bool localStorageGetItem( const std::string& key, std::string *outItem )
     }
 }
 
-/** removes an item from the LS */
-void localStorageRemoveItem( const std::string& key )
+void LocalStorageAndroid::write(const std::vector<LocalStorageWrite> &writes)
 {
-    assert( _initialized );
-    JniHelper::callStaticVoidMethod(JCLS_LOCALSTORAGE, "removeItem", key);
+    JniMethodInfo t;
+
+    if (JniHelper::getStaticMethodInfo(t, JCLS_LOCALSTORAGE, "setItems", "([Ljava/lang/String;[Ljava/lang/String;)V"))
+    {
+        // a null value removes the key
+        jclass stringClass = t.env->FindClass("java/lang/String");
+        jobjectArray jkeys = t.env->NewObjectArray(static_cast<jsize>(writes.size()), stringClass, nullptr);
+        jobjectArray jvalues = t.env->NewObjectArray(static_cast<jsize>(writes.size()), stringClass, nullptr);
+        for (size_t i = 0; i < writes.size(); ++i)
+        {
+            jstring jkey = StringUtils::newStringUTFJNI(t.env, writes[i].key);
+            t.env->SetObjectArrayElement(jkeys, static_cast<jsize>(i), jkey);
+            t.env->DeleteLocalRef(jkey);
+            if (!writes[i].removed)
+            {
+                jstring jvalue = StringUtils::newStringUTFJNI(t.env, writes[i].value);
+                t.env->SetObjectArrayElement(jvalues, static_cast<jsize>(i), jvalue);
+                t.env->DeleteLocalRef(jvalue);
+            }
+        }
+        t.env->CallStaticVoidMethod(t.classID, t.methodID, jkeys, jvalues);
+        t.env->DeleteLocalRef(jvalues);
+        t.env->DeleteLocalRef(jkeys);
+        t.env->DeleteLocalRef(stringClass);
+        t.env->DeleteLocalRef(t.classID);
+    }
 }
 
-/** removes all items from the LS */
-void localStorageClear()
+void LocalStorageAndroid::clear()
 {
-    assert( _initialized );
     JniHelper::callStaticVoidMethod(JCLS_LOCALSTORAGE, "clear");
 }
 
-/** gets an key from the JS. */
-void localStorageGetKey( const int nIndex, std::string *outKey )
+void LocalStorageAndroid::getKey(int index, std::string *outKey)
 {
-    assert( _initialized );
-    outKey->assign(JniHelper::callStaticStringMethod(JCLS_LOCALSTORAGE,"getKey",nIndex));
+    outKey->assign(JniHelper::callStaticStringMethod(JCLS_LOCALSTORAGE, "getKey", index));
 }
 
-/** gets all items count in the JS. */
-void localStorageGetLength( int& outLength )
+int LocalStorageAndroid::getLength()
 {
-    assert( _initialized );
-    outLength = JniHelper::callStaticIntMethod(JCLS_LOCALSTORAGE,"getLength");
+    return JniHelper::callStaticIntMethod(JCLS_LOCALSTORAGE, "getLength");
+}
+
+} // namespace
+
+LocalStorageBackend *LocalStorageBackend::createDefault(const std::string &fullpath)
+{
+    if (fullpath.empty())
+        return nullptr;
+
+    std::string strDBFilename = fullpath;
+    splitFilename(strDBFilename);
+    if (!JniHelper::callStaticBooleanMethod(JCLS_LOCALSTORAGE, "init", strDBFilename, "data"))
+        return nullptr;
+    return new LocalStorageAndroid();
 }
 
 #endif // #if (CC_PLATFORM == CC_PLATFORM_ANDROID)
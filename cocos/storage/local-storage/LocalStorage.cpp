@@ -29,118 +29,356 @@
  Works on cocos2d-iphone and cocos2d-x.
  */
 
+
 #include "storage/local-storage/LocalStorage.h"
+#include "storage/local-storage/LocalStorageBackend.h"
+#include "storage/local-storage/LocalStorageLog.h"
 #include "base/Macros.h"
+#include "base/ThreadConfig.h"
+#include "bindings/event/CustomEventTypes.h"
+#include "bindings/event/EventDispatcher.h"
 
-#if (CC_PLATFORM != CC_PLATFORM_ANDROID)
-
-#include <stdio.h>
-#include <stdlib.h>
 #include <assert.h>
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#if (CC_PLATFORM != CC_PLATFORM_ANDROID)
 #if (CC_PLATFORM == CC_PLATFORM_WINDOWS)
 #include <sqlite3/sqlite3.h>
 #else
 #include <sqlite3.h>
 #endif
+#endif
 
-static int _initialized = 0;
-static sqlite3 *_db;
-static sqlite3_stmt *_stmt_select;
-static sqlite3_stmt *_stmt_remove;
-static sqlite3_stmt *_stmt_update;
-static sqlite3_stmt *_stmt_clear;
-static sqlite3_stmt *_stmt_key;
-static sqlite3_stmt *_stmt_count;
+using namespace cc;
 
-static void localStorageCreateTable()
-{
-    const char *sql_createtable = "CREATE TABLE IF NOT EXISTS data(key TEXT PRIMARY KEY,value TEXT);";
-    sqlite3_stmt *stmt;
-    int ok = sqlite3_prepare_v2(_db, sql_createtable, -1, &stmt, nullptr);
-    ok |= sqlite3_step(stmt);
-    ok |= sqlite3_finalize(stmt);
+// Writes are applied in batches by a background thread, this lets a burst of them gather into one transaction
+#define FLUSH_DELAY std::chrono::milliseconds(500)
 
-    if( ok != SQLITE_OK && ok != SQLITE_DONE)
-        printf("Error in CREATE TABLE\n");
-}
+namespace {
 
-void localStorageInit( const std::string& fullpath/* = "" */)
+struct CachedItem
 {
-    if (!_initialized) {
+    std::string value;
+    bool exists;
+    // The order of the last write, a batch replaces the keys in the order of the calls so that key(n) keeps it
+    uint64_t writeIndex;
+};
+
+bool _initialized = false;
+LocalStorageBackend *_backend = nullptr;
+uint64_t _writeCount = 0;
+bool _quit = false;
+// not destroyed at exit if the storage isn't freed, a joinable thread would terminate the application
+std::thread *_flushThread = nullptr;
+uint32_t _pauseListenerID = 0;
+
+// Serializes the backend, a flush holds it from the moment it takes the pending writes until they are written
+std::mutex _backendMutex;
+// Guards the cache, the pending writes and _quit
+std::mutex _cacheMutex;
+std::condition_variable _flushCondition;
+// The current value of every key read or written since the last clear, whether it's in the backend yet or not
+std::unordered_map<std::string, CachedItem> _cache;
+// The keys whose value in the cache isn't in the backend yet
+std::unordered_set<std::string> _dirtyKeys;
+
+void flush()
+{
+    std::lock_guard<std::mutex> backendLock(_backendMutex);
+    std::vector<LocalStorageWrite> writes;
+    {
+        std::lock_guard<std::mutex> lock(_cacheMutex);
+        std::vector<std::pair<uint64_t, const std::string *>> order;
+        order.reserve(_dirtyKeys.size());
+        for (const auto &key : _dirtyKeys)
+            order.emplace_back(_cache[key].writeIndex, &key);
+        std::sort(order.begin(), order.end());
+
+        writes.reserve(order.size());
+        for (const auto &entry : order)
+        {
+            const CachedItem &item = _cache[*entry.second];
+            writes.push_back({*entry.second, item.value, !item.exists});
+        }
+        _dirtyKeys.clear();
+    }
+    if (!writes.empty())
+        _backend->write(writes);
+}
 
-        int ret = 0;
+void flushLoop()
+{
+    ThreadConfig::applyToCurrentThread(ThreadLane::IO);
+    std::unique_lock<std::mutex> lock(_cacheMutex);
+    while (!_quit)
+    {
+        _flushCondition.wait(lock, []() { return _quit || !_dirtyKeys.empty(); });
+        if (_quit)
+            break;
+        _flushCondition.wait_for(lock, FLUSH_DELAY, []() { return _quit; });
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
 
-        if (fullpath.empty())
-            ret = sqlite3_open(":memory:", &_db);
-        else
-            ret = sqlite3_open(fullpath.c_str(), &_db);
+void setCachedItem(const std::string &key, const std::string &value, bool exists)
+{
+    bool wasClean;
+    {
+        std::lock_guard<std::mutex> lock(_cacheMutex);
+        CachedItem &item = _cache[key];
+        item.value = value;
+        item.exists = exists;
+        item.writeIndex = ++_writeCount;
+        wasClean = _dirtyKeys.empty();
+        _dirtyKeys.insert(key);
+    }
+    if (wasClean)
+        _flushCondition.notify_one();
+}
 
-        localStorageCreateTable();
+} // namespace
 
-        // SELECT
-        const char *sql_select = "SELECT value FROM data WHERE key=?;";
-        ret |= sqlite3_prepare_v2(_db, sql_select, -1, &_stmt_select, nullptr);
+void localStorageInit( const std::string& fullpath/* = "" */, LocalStorageEngine engine/* = LocalStorageEngine::DEFAULT */)
+{
+    if (_initialized)
+        return;
 
-        // REPLACE
-        const char *sql_update = "REPLACE INTO data (key, value) VALUES (?,?);";
-        ret |= sqlite3_prepare_v2(_db, sql_update, -1, &_stmt_update, nullptr);
+    if (engine == LocalStorageEngine::LOG && !fullpath.empty())
+        _backend = LocalStorageLog::create(fullpath);
+    else
+        _backend = LocalStorageBackend::createDefault(fullpath);
+
+    if (_backend) {
+        _initialized = true;
+        _quit = false;
+        _flushThread = new std::thread(flushLoop);
+        // the application may be killed once it's in the background
+        _pauseListenerID = EventDispatcher::addCustomEventListener(EVENT_COME_TO_BACKGROUND, [](const CustomEvent &) {
+            localStorageFlush();
+        });
+    }
+}
 
-        // DELETE
-        const char *sql_remove = "DELETE FROM data WHERE key=?;";
-        ret |= sqlite3_prepare_v2(_db, sql_remove, -1, &_stmt_remove, nullptr);
-        
-        // Clear
-        const char *sql_clear = "DELETE FROM data;";
-        ret |= sqlite3_prepare_v2(_db, sql_clear, -1, &_stmt_clear, nullptr);
+void localStorageFree()
+{
+    if (_initialized) {
+        EventDispatcher::removeCustomEventListener(EVENT_COME_TO_BACKGROUND, _pauseListenerID);
+        _pauseListenerID = 0;
+        {
+            std::lock_guard<std::mutex> lock(_cacheMutex);
+            _quit = true;
+        }
+        _flushCondition.notify_one();
+        _flushThread->join();
+        delete _flushThread;
+        _flushThread = nullptr;
+
+        flush();
+        delete _backend;
+        _backend = nullptr;
+        _cache.clear();
+        _initialized = false;
+    }
+}
 
-        // key
-        const char *sql_key = "SELECT key FROM data ORDER BY ROWID ASC;";
-        ret |= sqlite3_prepare_v2(_db, sql_key, -1, &_stmt_key, nullptr);
+void localStorageFlush()
+{
+    assert( _initialized );
+    flush();
+}
 
-        //count
-        const char *sql_count = "SELECT COUNT(*) FROM data;";
-        ret |= sqlite3_prepare_v2(_db, sql_count, -1, &_stmt_count, nullptr);
+/** sets an item in the LS */
+void localStorageSetItem( const std::string& key, const std::string& value)
+{
+    assert( _initialized );
+    setCachedItem(key, value, true);
+}
 
-        if( ret != SQLITE_OK ) {
-            printf("Error initializing DB\n");
-            // report error
+/** gets an item from the LS */
+bool localStorageGetItem( const std::string& key, std::string *outItem )
+{
+    assert( _initialized );
+    {
+        std::lock_guard<std::mutex> lock(_cacheMutex);
+        auto it = _cache.find(key);
+        if (it != _cache.end())
+        {
+            if (it->second.exists)
+                outItem->assign(it->second.value);
+            return it->second.exists;
         }
-        _initialized = 1;
     }
+
+    // a key missing in the cache has no pending write, the backend has its value
+    CachedItem item;
+    item.writeIndex = 0;
+    {
+        std::lock_guard<std::mutex> backendLock(_backendMutex);
+        item.exists = _backend->getItem(key, &item.value);
+    }
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    const CachedItem &cached = _cache.emplace(key, item).first->second;
+    if (cached.exists)
+        outItem->assign(cached.value);
+    return cached.exists;
 }
 
-void localStorageFree()
+/** removes an item from the LS */
+void localStorageRemoveItem( const std::string& key )
 {
-    if (_initialized) {
-        sqlite3_finalize(_stmt_select);
-        sqlite3_finalize(_stmt_remove);
-        sqlite3_finalize(_stmt_update);
+    assert( _initialized );
+    setCachedItem(key, "", false);
+}
 
-        sqlite3_close(_db);
+/** removes all items from the LS */
+void localStorageClear()
+{
+    assert( _initialized );
+    std::lock_guard<std::mutex> backendLock(_backendMutex);
+    {
+        std::lock_guard<std::mutex> lock(_cacheMutex);
+        _cache.clear();
+        _dirtyKeys.clear();
+    }
+    _backend->clear();
+}
 
-        _initialized = 0;
+/** gets an key from the JS. */
+void localStorageGetKey( const int nIndex, std::string *outKey )
+{
+    assert( _initialized );
+    if (nIndex < 0)
+    {
+        printf("Error in input localStorage index Less than zero\n");
+        return;
     }
+    // the keys are listed by the backend
+    flush();
+    std::lock_guard<std::mutex> backendLock(_backendMutex);
+    _backend->getKey(nIndex, outKey);
 }
 
-/** sets an item in the LS */
-void localStorageSetItem( const std::string& key, const std::string& value)
+/** gets all items count in the JS. */
+void localStorageGetLength( int& outLength )
 {
     assert( _initialized );
-    int ok = sqlite3_bind_text(_stmt_update, 1, key.c_str(), -1, SQLITE_TRANSIENT);
-    ok |= sqlite3_bind_text(_stmt_update, 2, value.c_str(), -1, SQLITE_TRANSIENT);
+    flush();
+    std::lock_guard<std::mutex> backendLock(_backendMutex);
+    outLength = _backend->getLength();
+}
 
-    ok |= sqlite3_step(_stmt_update);
+#if (CC_PLATFORM != CC_PLATFORM_ANDROID)
 
-    ok |= sqlite3_reset(_stmt_update);
+namespace {
+
+class LocalStorageSqlite : public LocalStorageBackend
+{
+public:
+    bool open(const std::string &fullpath);
+    ~LocalStorageSqlite() override;
+
+    bool getItem(const std::string &key, std::string *outItem) override;
+    void write(const std::vector<LocalStorageWrite> &writes) override;
+    void clear() override;
+    void getKey(int index, std::string *outKey) override;
+    int getLength() override;
+
+private:
+    void createTable();
+
+    sqlite3 *_db = nullptr;
+    sqlite3_stmt *_stmt_select = nullptr;
+    sqlite3_stmt *_stmt_remove = nullptr;
+    sqlite3_stmt *_stmt_update = nullptr;
+    sqlite3_stmt *_stmt_clear = nullptr;
+    sqlite3_stmt *_stmt_key = nullptr;
+    sqlite3_stmt *_stmt_count = nullptr;
+};
+
+void LocalStorageSqlite::createTable()
+{
+    const char *sql_createtable = "CREATE TABLE IF NOT EXISTS data(key TEXT PRIMARY KEY,value TEXT);";
+    sqlite3_stmt *stmt;
+    int ok = sqlite3_prepare_v2(_db, sql_createtable, -1, &stmt, nullptr);
+    ok |= sqlite3_step(stmt);
+    ok |= sqlite3_finalize(stmt);
 
     if( ok != SQLITE_OK && ok != SQLITE_DONE)
-        printf("Error in localStorage.setItem()\n");
+        printf("Error in CREATE TABLE\n");
 }
 
-/** gets an item from the LS */
-bool localStorageGetItem( const std::string& key, std::string *outItem )
+bool LocalStorageSqlite::open(const std::string &fullpath)
+{
+    int ret = 0;
+
+    if (fullpath.empty())
+        ret = sqlite3_open(":memory:", &_db);
+    else
+        ret = sqlite3_open(fullpath.c_str(), &_db);
+
+    // the writes append to the log instead of rewriting the pages with a journal, one sync per checkpoint
+    if (!fullpath.empty())
+    {
+        ret |= sqlite3_exec(_db, "PRAGMA journal_mode=WAL;", nullptr, nullptr, nullptr);
+        ret |= sqlite3_exec(_db, "PRAGMA synchronous=NORMAL;", nullptr, nullptr, nullptr);
+    }
+
+    createTable();
+
+    // SELECT
+    const char *sql_select = "SELECT value FROM data WHERE key=?;";
+    ret |= sqlite3_prepare_v2(_db, sql_select, -1, &_stmt_select, nullptr);
+
+    // REPLACE
+    const char *sql_update = "REPLACE INTO data (key, value) VALUES (?,?);";
+    ret |= sqlite3_prepare_v2(_db, sql_update, -1, &_stmt_update, nullptr);
+
+    // DELETE
+    const char *sql_remove = "DELETE FROM data WHERE key=?;";
+    ret |= sqlite3_prepare_v2(_db, sql_remove, -1, &_stmt_remove, nullptr);
+
+    // Clear
+    const char *sql_clear = "DELETE FROM data;";
+    ret |= sqlite3_prepare_v2(_db, sql_clear, -1, &_stmt_clear, nullptr);
+
+    // key
+    const char *sql_key = "SELECT key FROM data ORDER BY ROWID ASC;";
+    ret |= sqlite3_prepare_v2(_db, sql_key, -1, &_stmt_key, nullptr);
+
+    //count
+    const char *sql_count = "SELECT COUNT(*) FROM data;";
+    ret |= sqlite3_prepare_v2(_db, sql_count, -1, &_stmt_count, nullptr);
+
+    if( ret != SQLITE_OK ) {
+        printf("Error initializing DB\n");
+        // report error
+    }
+    return true;
+}
+
+LocalStorageSqlite::~LocalStorageSqlite()
+{
+    sqlite3_finalize(_stmt_select);
+    sqlite3_finalize(_stmt_remove);
+    sqlite3_finalize(_stmt_update);
+    sqlite3_finalize(_stmt_clear);
+    sqlite3_finalize(_stmt_key);
+    sqlite3_finalize(_stmt_count);
+
+    sqlite3_close(_db);
+}
+
+bool LocalStorageSqlite::getItem(const std::string &key, std::string *outItem)
 {
-    assert( _initialized );
     int ok = sqlite3_reset(_stmt_select);
 
     ok |= sqlite3_bind_text(_stmt_select, 1, key.c_str(), -1, SQLITE_TRANSIENT);
@@ -163,24 +401,29 @@ bool localStorageGetItem( const std::string& key, std::string *outItem )
     }
 }
 
-/** removes an item from the LS */
-void localStorageRemoveItem( const std::string& key )
+void LocalStorageSqlite::write(const std::vector<LocalStorageWrite> &writes)
 {
-    assert( _initialized );
-    int ok = sqlite3_bind_text(_stmt_remove, 1, key.c_str(), -1, SQLITE_TRANSIENT);
-
-    ok |= sqlite3_step(_stmt_remove);
-
-    ok |= sqlite3_reset(_stmt_remove);
+    bool failed = SQLITE_OK != sqlite3_exec(_db, "BEGIN;", nullptr, nullptr, nullptr);
+    for (const auto &write : writes)
+    {
+        sqlite3_stmt *stmt = write.removed ? _stmt_remove : _stmt_update;
+        // the strings outlive the statement
+        int ok = sqlite3_bind_text(stmt, 1, write.key.c_str(), -1, SQLITE_STATIC);
+        if (!write.removed)
+            ok |= sqlite3_bind_text(stmt, 2, write.value.c_str(), -1, SQLITE_STATIC);
+        if (ok != SQLITE_OK || sqlite3_step(stmt) != SQLITE_DONE)
+            failed = true;
+        sqlite3_reset(stmt);
+    }
+    if (SQLITE_OK != sqlite3_exec(_db, "COMMIT;", nullptr, nullptr, nullptr))
+        failed = true;
 
-    if( ok != SQLITE_OK && ok != SQLITE_DONE)
-        printf("Error in localStorage.removeItem()\n");
+    if (failed)
+        printf("Error in localStorage.setItem() or localStorage.removeItem()\n");
 }
 
-/** removes all items from the LS */
-void localStorageClear()
+void LocalStorageSqlite::clear()
 {
-    assert( _initialized );
     int ok = sqlite3_step(_stmt_clear);
 
     ok |= sqlite3_reset(_stmt_clear);
@@ -189,15 +432,8 @@ void localStorageClear()
         printf("Error in localStorage.clear()\n");
 }
 
-/** gets an key from the JS. */
-void localStorageGetKey( const int nIndex, std::string *outKey )
+void LocalStorageSqlite::getKey(int index, std::string *outKey)
 {
-    assert( _initialized );
-    if (nIndex < 0)
-    {
-        printf("Error in input localStorage index Less than zero\n");
-        return;
-    }
     int ok = sqlite3_reset(_stmt_key);
 
     ok |= sqlite3_step(_stmt_key);
@@ -206,7 +442,7 @@ void localStorageGetKey( const int nIndex, std::string *outKey )
     const unsigned char *text = nullptr;
     while (ok == SQLITE_ROW)
     {
-        if (nCount == nIndex)
+        if (nCount == index)
         {
             text = sqlite3_column_text(_stmt_key, 0);
             break;
@@ -230,10 +466,8 @@ void localStorageGetKey( const int nIndex, std::string *outKey )
     }
 }
 
-/** gets all items count in the JS. */
-void localStorageGetLength( int& outLength )
+int LocalStorageSqlite::getLength()
 {
-    assert( _initialized );
     int ok = sqlite3_reset(_stmt_count);
 
     ok |= sqlite3_step(_stmt_count);
@@ -241,12 +475,22 @@ void localStorageGetLength( int& outLength )
     if ( ok != SQLITE_OK && ok != SQLITE_DONE && ok != SQLITE_ROW )
     {
         printf("Error in localStorage.length\n");
-        outLength = 0;
+        return 0;
     }
-    else
+    return sqlite3_column_int(_stmt_count, 0);
+}
+
+} // namespace
+
+LocalStorageBackend *LocalStorageBackend::createDefault(const std::string &fullpath)
+{
+    auto *backend = new LocalStorageSqlite();
+    if (!backend->open(fullpath))
     {
-        outLength = sqlite3_column_int(_stmt_count, 0);
+        delete backend;
+        return nullptr;
     }
+    return backend;
 }
 
 #endif // #if (CC_PLATFORM != CC_PLATFORM_ANDROID)
@@ -37,12 +37,26 @@ THE SOFTWARE.
 
 /** Local Storage support for the JS Bindings.*/
 
-/** Initializes the database. If path is null, it will create an in-memory DB. */
-void CC_DLL localStorageInit( const std::string& fullpath = "");
+/** The storage of the items. */
+enum class LocalStorageEngine
+{
+    /** sqlite, opened by CocosLocalStorage on Android. */
+    DEFAULT,
+    /** An append-only log mapped in memory with an index of its keys, see cc::LocalStorageLog. Needs a path. */
+    LOG
+};
+
+/** Initializes the database. If path is null, it will create an in-memory DB.
+ * The items are cached, the writes are applied in batches by a background thread and when the application goes to the background.
+ */
+void CC_DLL localStorageInit( const std::string& fullpath = "", LocalStorageEngine engine = LocalStorageEngine::DEFAULT);
 
 /** Frees the allocated resources. */
 void CC_DLL localStorageFree();
 
+/** Writes the pending items to the database before returning. */
+void CC_DLL localStorageFlush();
+
 /** Sets an item in the JS. */
 void CC_DLL localStorageSetItem( const std::string& key, const std::string& value);
 
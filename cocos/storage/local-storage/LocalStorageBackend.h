@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace cc {
+
+struct LocalStorageWrite {
+    std::string key;
+    std::string value;
+    bool removed;
+};
+
+// The storage behind the caches of LocalStorage.cpp. The methods are called one at a time,
+// from the cocos thread or from the thread which flushes the writes.
+class LocalStorageBackend {
+public:
+    // sqlite on most platforms and CocosLocalStorage on Android, nullptr if it can't be opened
+    static LocalStorageBackend *createDefault(const std::string &fullpath);
+
+    virtual ~LocalStorageBackend() = default;
+
+    virtual bool getItem(const std::string &key, std::string *outItem) = 0;
+    // Applies the writes in one transaction.
+    virtual void write(const std::vector<LocalStorageWrite> &writes) = 0;
+    virtual void clear() = 0;
+
+    // The keys are ordered by their last write.
+    virtual void getKey(int index, std::string *outKey) = 0;
+    virtual int getLength() = 0;
+};
+
+} // namespace cc
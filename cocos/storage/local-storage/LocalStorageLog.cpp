@@ -0,0 +1,402 @@
+#include "storage/local-storage/LocalStorageLog.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#if CC_PLATFORM == CC_PLATFORM_WINDOWS
+    #include "platform/FileUtils.h"
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace cc {
+namespace {
+const char LOG_MAGIC[4] = {'C', 'C', 'K', 'V'};
+const uint32_t LOG_VERSION = 1;
+const size_t HEADER_SIZE = 16;
+const size_t END_OFFSET = 8;
+const size_t RECORD_HEADER_SIZE = 12;
+const uint32_t REMOVED_LENGTH = 0xFFFFFFFF;
+const size_t LOG_PAGE_SIZE = 4096;
+const size_t MIN_CAPACITY = 16 * 1024;
+// a small log isn't compacted, overwritten records cost less than rewriting the file
+const size_t COMPACT_MIN_SIZE = 64 * 1024;
+
+// the platforms are little endian
+uint32_t read32(const unsigned char *p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+void write32(unsigned char *p, uint32_t value) { memcpy(p, &value, sizeof(value)); }
+
+uint64_t read64(const unsigned char *p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+void write64(unsigned char *p, uint64_t value) { memcpy(p, &value, sizeof(value)); }
+
+uint64_t recordSize(uint64_t keyLength, uint32_t valueLength) {
+    return RECORD_HEADER_SIZE + keyLength + (valueLength == REMOVED_LENGTH ? 0 : valueLength);
+}
+
+// the lengths, the key and the value
+uint32_t recordCrc(const unsigned char *record, size_t size) {
+    uLong crc = crc32(0L, record, 8);
+    crc = crc32(crc, record + RECORD_HEADER_SIZE, static_cast<uInt>(size - RECORD_HEADER_SIZE));
+    return static_cast<uint32_t>(crc);
+}
+
+size_t roundCapacity(size_t size) {
+    return std::max(MIN_CAPACITY, (size + LOG_PAGE_SIZE - 1) / LOG_PAGE_SIZE * LOG_PAGE_SIZE);
+}
+} // namespace
+
+LocalStorageLog *LocalStorageLog::create(const std::string &fullpath) {
+    auto *log = new (std::nothrow) LocalStorageLog();
+    if (log && !log->open(fullpath)) {
+        delete log;
+        return nullptr;
+    }
+    return log;
+}
+
+LocalStorageLog::~LocalStorageLog() {
+    close();
+}
+
+#if CC_PLATFORM == CC_PLATFORM_WINDOWS
+
+bool LocalStorageLog::open(const std::string &fullpath) {
+    _path = fullpath;
+    const std::string path = FileUtils::getInstance()->getSuitableFOpen(fullpath);
+    _file = fopen(path.c_str(), "r+b");
+    if (!_file) {
+        _file = fopen(path.c_str(), "w+b");
+    }
+    if (!_file) {
+        printf("Error opening localStorage %s\n", fullpath.c_str());
+        return false;
+    }
+    fseek(_file, 0, SEEK_END);
+    const long fileSize = ftell(_file);
+    _capacity = roundCapacity(fileSize > 0 ? static_cast<size_t>(fileSize) : 0);
+    _data = static_cast<unsigned char *>(calloc(_capacity, 1));
+    if (!_data) {
+        close();
+        return false;
+    }
+    fseek(_file, 0, SEEK_SET);
+    if (fileSize > 0 && fread(_data, 1, fileSize, _file) != static_cast<size_t>(fileSize)) {
+        memset(_data, 0, _capacity);
+    }
+    load();
+    return true;
+}
+
+void LocalStorageLog::close() {
+    if (_file) {
+        fclose(_file);
+        _file = nullptr;
+    }
+    free(_data);
+    _data = nullptr;
+    _capacity = 0;
+}
+
+bool LocalStorageLog::reserve(size_t size) {
+    if (size <= _capacity) {
+        return true;
+    }
+    const size_t capacity = roundCapacity(std::max(size, _capacity * 2));
+    auto *data = static_cast<unsigned char *>(realloc(_data, capacity));
+    if (!data) {
+        return false;
+    }
+    memset(data + _capacity, 0, capacity - _capacity);
+    _data = data;
+    _capacity = capacity;
+    return true;
+}
+
+bool LocalStorageLog::store(size_t offset, size_t length) {
+    return 0 == fseek(_file, static_cast<long>(offset), SEEK_SET) && length == fwrite(_data + offset, 1, length, _file);
+}
+
+void LocalStorageLog::commit() {
+    write64(_data + END_OFFSET, _size);
+    store(END_OFFSET, sizeof(uint64_t));
+    fflush(_file);
+}
+
+#else
+
+bool LocalStorageLog::open(const std::string &fullpath) {
+    _path = fullpath;
+    _fd = ::open(fullpath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    struct stat st;
+    if (_fd < 0 || 0 != fstat(_fd, &st)) {
+        printf("Error opening localStorage %s\n", fullpath.c_str());
+        close();
+        return false;
+    }
+    _capacity = roundCapacity(static_cast<size_t>(st.st_size));
+    if (static_cast<size_t>(st.st_size) < _capacity && 0 != ftruncate(_fd, static_cast<off_t>(_capacity))) {
+        close();
+        return false;
+    }
+    void *data = mmap(nullptr, _capacity, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    if (data == MAP_FAILED) {
+        printf("Error mapping localStorage %s\n", fullpath.c_str());
+        close();
+        return false;
+    }
+    _data = static_cast<unsigned char *>(data);
+    load();
+    return true;
+}
+
+void LocalStorageLog::close() {
+    if (_data) {
+        munmap(_data, _capacity);
+        _data = nullptr;
+    }
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+    _capacity = 0;
+}
+
+bool LocalStorageLog::reserve(size_t size) {
+    if (size <= _capacity) {
+        return true;
+    }
+    const size_t capacity = roundCapacity(std::max(size, _capacity * 2));
+    if (0 != ftruncate(_fd, static_cast<off_t>(capacity))) {
+        return false;
+    }
+    munmap(_data, _capacity);
+    void *data = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    if (data == MAP_FAILED) {
+        // the file kept the records, the old size can still be mapped
+        data = mmap(nullptr, _capacity, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+        _data = data == MAP_FAILED ? nullptr : static_cast<unsigned char *>(data);
+        return false;
+    }
+    _data = static_cast<unsigned char *>(data);
+    _capacity = capacity;
+    return true;
+}
+
+bool LocalStorageLog::store(size_t /*offset*/, size_t /*length*/) {
+    return true;
+}
+
+void LocalStorageLog::commit() {
+    write64(_data + END_OFFSET, _size);
+    // hands the pages to the kernel without waiting for the disk, a crash of the process keeps them
+    msync(_data, _capacity, MS_ASYNC);
+}
+
+#endif
+
+void LocalStorageLog::load() {
+    _index.clear();
+    _liveSize = 0;
+    _orderDirty = true;
+
+    size_t end = 0;
+    if (0 == memcmp(_data, LOG_MAGIC, sizeof(LOG_MAGIC)) && LOG_VERSION == read32(_data + sizeof(LOG_MAGIC))) {
+        end = static_cast<size_t>(std::min(read64(_data + END_OFFSET), static_cast<uint64_t>(_capacity)));
+    }
+    if (end < HEADER_SIZE) {
+        memset(_data, 0, HEADER_SIZE);
+        memcpy(_data, LOG_MAGIC, sizeof(LOG_MAGIC));
+        write32(_data + sizeof(LOG_MAGIC), LOG_VERSION);
+        store(0, HEADER_SIZE);
+        _size = HEADER_SIZE;
+        commit();
+        return;
+    }
+
+    size_t offset = HEADER_SIZE;
+    while (end - offset >= RECORD_HEADER_SIZE) {
+        const unsigned char *record = _data + offset;
+        const uint32_t keyLength = read32(record);
+        const uint32_t valueLength = read32(record + 4);
+        const uint64_t size = recordSize(keyLength, valueLength);
+        if (size > end - offset || read32(record + 8) != recordCrc(record, static_cast<size_t>(size))) {
+            break;
+        }
+        indexRecord(std::string(reinterpret_cast<const char *>(record + RECORD_HEADER_SIZE), keyLength), offset, valueLength);
+        offset += static_cast<size_t>(size);
+    }
+    _size = offset;
+    if (_size != end) {
+        printf("localStorage dropped %zu bytes of broken records\n", end - _size);
+        commit();
+    }
+}
+
+void LocalStorageLog::indexRecord(const std::string &key, size_t offset, uint32_t valueLength) {
+    auto it = _index.find(key);
+    if (it != _index.end()) {
+        _liveSize -= static_cast<size_t>(recordSize(key.size(), it->second.valueLength));
+        if (valueLength == REMOVED_LENGTH) {
+            _index.erase(it);
+        } else {
+            it->second = {offset, valueLength};
+        }
+    } else if (valueLength != REMOVED_LENGTH) {
+        _index.emplace(key, Entry{offset, valueLength});
+    }
+    if (valueLength != REMOVED_LENGTH) {
+        _liveSize += static_cast<size_t>(recordSize(key.size(), valueLength));
+    }
+}
+
+size_t LocalStorageLog::append(size_t offset, const LocalStorageWrite &write) {
+    const auto keyLength = static_cast<uint32_t>(write.key.size());
+    const uint32_t valueLength = write.removed ? REMOVED_LENGTH : static_cast<uint32_t>(write.value.size());
+    const auto size = static_cast<size_t>(recordSize(keyLength, valueLength));
+    unsigned char *record = _data + offset;
+    write32(record, keyLength);
+    write32(record + 4, valueLength);
+    memcpy(record + RECORD_HEADER_SIZE, write.key.data(), keyLength);
+    if (!write.removed) {
+        memcpy(record + RECORD_HEADER_SIZE + keyLength, write.value.data(), write.value.size());
+    }
+    write32(record + 8, recordCrc(record, size));
+    indexRecord(write.key, offset, valueLength);
+    return size;
+}
+
+bool LocalStorageLog::getItem(const std::string &key, std::string *outItem) {
+    auto it = _index.find(key);
+    if (it == _index.end()) {
+        return false;
+    }
+    outItem->assign(reinterpret_cast<const char *>(_data + it->second.offset + RECORD_HEADER_SIZE + key.size()), it->second.valueLength);
+    return true;
+}
+
+void LocalStorageLog::write(const std::vector<LocalStorageWrite> &writes) {
+    size_t end = _size;
+    for (const auto &write : writes) {
+        end += static_cast<size_t>(recordSize(write.key.size(), write.removed ? REMOVED_LENGTH : static_cast<uint32_t>(write.value.size())));
+    }
+    if (!_data || !reserve(end)) {
+        printf("Error in localStorage.setItem() or localStorage.removeItem()\n");
+        return;
+    }
+
+    size_t offset = _size;
+    for (const auto &write : writes) {
+        offset += append(offset, write);
+    }
+    if (!store(_size, end - _size)) {
+        printf("Error in localStorage.setItem() or localStorage.removeItem()\n");
+    }
+    _size = end;
+    commit();
+    _orderDirty = true;
+
+    if (_size > COMPACT_MIN_SIZE && _size - HEADER_SIZE > 2 * _liveSize) {
+        compact();
+    }
+}
+
+void LocalStorageLog::clear() {
+    if (!_data) {
+        return;
+    }
+    _index.clear();
+    _liveSize = 0;
+    _orderDirty = true;
+    _size = HEADER_SIZE;
+    commit();
+    // shrinks the file
+    compact();
+}
+
+void LocalStorageLog::sortKeys() {
+    if (!_orderDirty) {
+        return;
+    }
+    _order.clear();
+    _order.reserve(_index.size());
+    for (const auto &it : _index) {
+        _order.emplace_back(it.second.offset, &it.first);
+    }
+    std::sort(_order.begin(), _order.end());
+    _orderDirty = false;
+}
+
+void LocalStorageLog::getKey(int index, std::string *outKey) {
+    sortKeys();
+    if (index >= 0 && static_cast<size_t>(index) < _order.size()) {
+        *outKey = *_order[index].second;
+    }
+}
+
+int LocalStorageLog::getLength() {
+    return static_cast<int>(_index.size());
+}
+
+void LocalStorageLog::compact() {
+    sortKeys();
+    const std::string tempPath = _path + ".compact";
+#if CC_PLATFORM == CC_PLATFORM_WINDOWS
+    FILE *fp = fopen(FileUtils::getInstance()->getSuitableFOpen(tempPath).c_str(), "wb");
+#else
+    FILE *fp = fopen(tempPath.c_str(), "wb");
+#endif
+    if (!fp) {
+        return;
+    }
+    unsigned char header[HEADER_SIZE] = {0};
+    memcpy(header, LOG_MAGIC, sizeof(LOG_MAGIC));
+    write32(header + sizeof(LOG_MAGIC), LOG_VERSION);
+    write64(header + END_OFFSET, HEADER_SIZE + _liveSize);
+    bool ok = sizeof(header) == fwrite(header, 1, sizeof(header), fp);
+    for (size_t i = 0; ok && i < _order.size(); ++i) {
+        const Entry &entry = _index[*_order[i].second];
+        const auto size = static_cast<size_t>(recordSize(_order[i].second->size(), entry.valueLength));
+        ok = size == fwrite(_data + entry.offset, 1, size, fp);
+    }
+#if CC_PLATFORM != CC_PLATFORM_WINDOWS
+    // the records are on the disk before the rename replaces the log
+    ok = ok && 0 == fflush(fp) && 0 == fsync(fileno(fp));
+#endif
+    ok = 0 == fclose(fp) && ok;
+
+    if (ok) {
+        close();
+#if CC_PLATFORM == CC_PLATFORM_WINDOWS
+        ok = FileUtils::getInstance()->renameFile(tempPath, _path);
+#else
+        ok = 0 == rename(tempPath.c_str(), _path.c_str());
+#endif
+        if (!open(_path)) {
+            _index.clear();
+            _liveSize = 0;
+            _size = 0;
+            _orderDirty = true;
+        }
+    }
+    if (!ok) {
+        remove(tempPath.c_str());
+    }
+}
+
+} // namespace cc
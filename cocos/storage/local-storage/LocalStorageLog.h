@@ -0,0 +1,79 @@
+#pragma once
+
+#include "base/Macros.h"
+#include "storage/local-storage/LocalStorageBackend.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <unordered_map>
+#include <utility>
+
+namespace cc {
+
+// A localStorage backend on an append-only log in a memory mapped file, like MMKV. Each key is indexed to its last
+// record in the mapping, so a read is a lookup and a write is an append. The log is rewritten with only the last
+// records once most of it holds overwritten values.
+//
+// The file starts with "CCKV", the version (uint32) and the end of the committed records (uint64). The end is
+// updated after the records of a write, a write interrupted by a crash is dropped on the next open. A record is
+//   key length (uint32), value length (uint32, REMOVED_LENGTH for a removal), crc32 of the rest, key, value
+// Windows reads the file in memory and writes the records through it instead of mapping it.
+class LocalStorageLog : public LocalStorageBackend {
+public:
+    // nullptr if the file can't be opened
+    static LocalStorageLog *create(const std::string &fullpath);
+
+    ~LocalStorageLog() override;
+
+    bool getItem(const std::string &key, std::string *outItem) override;
+    void write(const std::vector<LocalStorageWrite> &writes) override;
+    void clear() override;
+
+    void getKey(int index, std::string *outKey) override;
+    int getLength() override;
+
+private:
+    struct Entry {
+        size_t offset; // of the record
+        uint32_t valueLength;
+    };
+
+    LocalStorageLog() = default;
+
+    bool open(const std::string &fullpath);
+    void close();
+    // Rebuilds the index from the records, the records after the first broken one are dropped.
+    void load();
+    // Grows the file to hold size bytes.
+    bool reserve(size_t size);
+    // Writes [offset, offset + length) of the buffer to the file, the mapping needs nothing.
+    bool store(size_t offset, size_t length);
+    // Writes the end of the records to the header.
+    void commit();
+    // Writes the record at offset, returns its size.
+    size_t append(size_t offset, const LocalStorageWrite &write);
+    void indexRecord(const std::string &key, size_t offset, uint32_t valueLength);
+    void sortKeys();
+    // Rewrites the file with the records of the index.
+    void compact();
+
+    std::string _path;
+#if CC_PLATFORM == CC_PLATFORM_WINDOWS
+    FILE *_file = nullptr;
+#else
+    int _fd = -1;
+#endif
+    unsigned char *_data = nullptr;
+    size_t _capacity = 0;
+    // the end of the committed records
+    size_t _size = 0;
+    // the bytes of the records in the index
+    size_t _liveSize = 0;
+    std::unordered_map<std::string, Entry> _index;
+    // the keys by the offset of their records, for getKey()
+    std::vector<std::pair<size_t, const std::string *>> _order;
+    bool _orderDirty = true;
+};
+
+} // namespace cc
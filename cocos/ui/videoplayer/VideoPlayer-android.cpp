@@ -28,11 +28,13 @@
 #include <unordered_map>
 #include <stdlib.h>
 #include <jni.h>
+#include <mutex>
 #include <string>
 #include "platform/Application.h"
 #include "platform/android/jni/JniHelper.h"
 #include "platform/FileUtils.h"
 #include "../../platform/Application.h"
+#include "renderer/core/Core.h"
 
 //-----------------------------------------------------------------------------------------------------------
 
@@ -41,6 +43,7 @@ static const std::string videoHelperClassName = "com/cocos/lib/CocosVideoHelper"
 using namespace cc;
 
 static void executeVideoCallback(int index,int event);
+static void executeVideoFrame(int index, const uint8_t *pixels, int width, int height, int rowStride);
 
 #define QUIT_FULLSCREEN 1000
 
@@ -48,6 +51,13 @@ extern "C" {
     void Java_com_cocos_lib_CocosVideoHelper_nativeExecuteVideoCallback(JNIEnv * env, jobject obj, jint index, jint event) {
         executeVideoCallback(index,event);
     }
+
+    void Java_com_cocos_lib_CocosVideoHelper_nativeOnVideoFrame(JNIEnv * env, jclass clazz, jint index, jobject buffer, jint width, jint height, jint rowStride) {
+        auto *pixels = static_cast<const uint8_t *>(env->GetDirectBufferAddress(buffer));
+        if (pixels) {
+            executeVideoFrame(index, pixels, width, height, rowStride);
+        }
+    }
 }
 
 int createVideoWidgetJNI()
@@ -66,6 +76,8 @@ int createVideoWidgetJNI()
 //-----------------------------------------------------------------------------------------------------------
 
 static std::unordered_map<int, VideoPlayer*> s_allVideoPlayers;
+// frames arrive on a java thread, so a player must not go away while one is being copied
+static std::mutex s_allVideoPlayersMutex;
 
 VideoPlayer::VideoPlayer()
 : _videoPlayerIndex(-1)
@@ -74,6 +86,7 @@ VideoPlayer::VideoPlayer()
 , _keepAspectRatioEnabled(false)
 {
     _videoPlayerIndex = createVideoWidgetJNI();
+    std::lock_guard<std::mutex> lock(s_allVideoPlayersMutex);
     s_allVideoPlayers[_videoPlayerIndex] = this;
 
 #if CC_VIDEOPLAYER_DEBUG_DRAW
@@ -84,8 +97,15 @@ VideoPlayer::VideoPlayer()
 
 VideoPlayer::~VideoPlayer()
 {
-    s_allVideoPlayers.erase(_videoPlayerIndex);
+    {
+        std::lock_guard<std::mutex> lock(s_allVideoPlayersMutex);
+        s_allVideoPlayers.erase(_videoPlayerIndex);
+    }
     JniHelper::callStaticVoidMethod(videoHelperClassName, "removeVideoWidget", _videoPlayerIndex);
+
+    if (_renderToTextureEnabled)
+        setFrameUpdatesEnabled(false);
+    CC_SAFE_DESTROY(_frameTexture);
 }
 
 void VideoPlayer::setURL(const std::string& videoUrl)
@@ -219,6 +239,33 @@ void executeVideoCallback(int index,int event)
     }
 }
 
+void executeVideoFrame(int index, const uint8_t *pixels, int width, int height, int rowStride)
+{
+    std::lock_guard<std::mutex> lock(s_allVideoPlayersMutex);
+    auto it = s_allVideoPlayers.find(index);
+    if (it != s_allVideoPlayers.end())
+    {
+        it->second->onFrame(pixels, width, height, rowStride, gfx::Format::RGBA8);
+    }
+}
+
+void VideoPlayer::setRenderToTextureEnabled(bool enabled)
+{
+    if (_renderToTextureEnabled == enabled)
+        return;
+
+    _renderToTextureEnabled = enabled;
+    JniHelper::callStaticVoidMethod(videoHelperClassName, "setRenderToTextureEnabled", _videoPlayerIndex, enabled);
+    setFrameUpdatesEnabled(enabled);
+    if (!enabled)
+        CC_SAFE_DESTROY(_frameTexture);
+}
+
+void VideoPlayer::pullFrame()
+{
+    // frames are pushed from java through onFrame
+}
+
 float VideoPlayer::currentTime() const
 {
     return JniHelper::callStaticFloatMethod(videoHelperClassName, "getCurrentTime", _videoPlayerIndex);
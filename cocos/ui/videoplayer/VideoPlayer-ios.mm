@@ -35,6 +35,7 @@ using namespace cc;
 #import <CoreMedia/CMTime.h>
 #include "platform/Application.h"
 #include "platform/FileUtils.h"
+#include "renderer/core/Core.h"
 
 @interface UIVideoViewWrapperIos : NSObject
 
@@ -64,6 +65,8 @@ typedef NS_ENUM(NSInteger, PlayerbackState) {
 - (void) showPlaybackControls:(BOOL) value;
 - (BOOL) isFullScreenEnabled;
 - (void) cleanup;
+- (void) setRenderToTexture:(BOOL) enabled;
+- (void) copyFrame;
 -(id) init:(void*) videoPlayer;
 
 -(void) videoFinished:(NSNotification*) notification;
@@ -81,12 +84,16 @@ typedef NS_ENUM(NSInteger, PlayerbackState) {
     CGRect _restoreRect;
     PlayerbackState _state;
     VideoPlayer* _videoPlayer;
+    BOOL _renderToTexture;
+    AVPlayerItemVideoOutput* _videoOutput;
 }
 
 -(id)init:(void*)videoPlayer
 {
     if (self = [super init]) {
         _keepRatioEnabled = FALSE;
+        _renderToTexture = FALSE;
+        _videoOutput = nil;
         _left = _top = _width = _height = 0;
 
         [self initPlayerController];
@@ -150,6 +157,47 @@ typedef NS_ENUM(NSInteger, PlayerbackState) {
         self.playerController.player = [[[AVPlayer alloc] initWithURL:[NSURL fileURLWithPath:@(videoUrl.c_str())]] autorelease];
 
     [self registerPlayerEventListener];
+    if (_renderToTexture)
+        [self attachVideoOutput];
+}
+
+-(void) setRenderToTexture:(BOOL)enabled
+{
+    if (_renderToTexture == enabled)
+        return;
+
+    _renderToTexture = enabled;
+    if (enabled) {
+        [self.playerController.view removeFromSuperview];
+        [self attachVideoOutput];
+    } else {
+        [self detachVideoOutput];
+        if (self.playerController.player.status == AVPlayerStatusReadyToPlay)
+            [self addPlayerControllerSubView];
+    }
+}
+
+-(void) copyFrame
+{
+    if (!_videoOutput)
+        return;
+
+    CMTime time = [_videoOutput itemTimeForHostTime:CACurrentMediaTime()];
+    if (![_videoOutput hasNewPixelBufferForItemTime:time])
+        return;
+
+    CVPixelBufferRef pixelBuffer = [_videoOutput copyPixelBufferForItemTime:time itemTimeForDisplay:nil];
+    if (!pixelBuffer)
+        return;
+
+    CVPixelBufferLockBaseAddress(pixelBuffer, kCVPixelBufferLock_ReadOnly);
+    _videoPlayer->onFrame(static_cast<const uint8_t*>(CVPixelBufferGetBaseAddress(pixelBuffer)),
+                          static_cast<uint32_t>(CVPixelBufferGetWidth(pixelBuffer)),
+                          static_cast<uint32_t>(CVPixelBufferGetHeight(pixelBuffer)),
+                          static_cast<uint32_t>(CVPixelBufferGetBytesPerRow(pixelBuffer)),
+                          gfx::Format::BGRA8);
+    CVPixelBufferUnlockBaseAddress(pixelBuffer, kCVPixelBufferLock_ReadOnly);
+    CVPixelBufferRelease(pixelBuffer);
 }
 
 -(void) seekTo:(float)sec
@@ -230,11 +278,33 @@ typedef NS_ENUM(NSInteger, PlayerbackState) {
 -(void) cleanup
 {
     [self stop];
+    [self detachVideoOutput];
     [self removePlayerEventListener];
     [self.playerController.view removeFromSuperview];
     [self.playerController release];
 }
 
+-(void) attachVideoOutput
+{
+    auto item = self.playerController.player.currentItem;
+    if (!item || _videoOutput)
+        return;
+
+    NSDictionary* attributes = @{(id)kCVPixelBufferPixelFormatTypeKey : @(kCVPixelFormatType_32BGRA)};
+    _videoOutput = [[AVPlayerItemVideoOutput alloc] initWithPixelBufferAttributes:attributes];
+    [item addOutput:_videoOutput];
+}
+
+-(void) detachVideoOutput
+{
+    if (!_videoOutput)
+        return;
+
+    [self.playerController.player.currentItem removeOutput:_videoOutput];
+    [_videoOutput release];
+    _videoOutput = nil;
+}
+
 -(void) removePlayerEventListener {
     if (self.playerController.player)
     {
@@ -292,6 +362,10 @@ typedef NS_ENUM(NSInteger, PlayerbackState) {
 }
 
 -(void)addPlayerControllerSubView {
+    // the frames go to a texture instead
+    if (_renderToTexture)
+        return;
+
     auto eaglview = UIApplication.sharedApplication.delegate.window.rootViewController.view;
     [eaglview addSubview:self.playerController.view];
 }
@@ -319,6 +393,27 @@ VideoPlayer::~VideoPlayer()
     {
         [((UIVideoViewWrapperIos*)_videoView) dealloc];
     }
+
+    if (_renderToTextureEnabled)
+        setFrameUpdatesEnabled(false);
+    CC_SAFE_DESTROY(_frameTexture);
+}
+
+void VideoPlayer::setRenderToTextureEnabled(bool enabled)
+{
+    if (_renderToTextureEnabled == enabled)
+        return;
+
+    _renderToTextureEnabled = enabled;
+    [((UIVideoViewWrapperIos*)_videoView) setRenderToTexture:enabled];
+    setFrameUpdatesEnabled(enabled);
+    if (!enabled)
+        CC_SAFE_DESTROY(_frameTexture);
+}
+
+void VideoPlayer::pullFrame()
+{
+    [((UIVideoViewWrapperIos*)_videoView) copyFrame];
 }
 
 void VideoPlayer::setURL(const std::string& videoUrl)
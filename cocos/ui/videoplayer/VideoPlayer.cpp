@@ -0,0 +1,102 @@
+/****************************************************************************
+ Copyright (c) 2020 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "VideoPlayer.h"
+
+#include "base/Scheduler.h"
+#include "platform/Application.h"
+#include "renderer/core/Core.h"
+#include <cstring>
+
+namespace cc {
+
+static const std::string FRAME_UPDATE_KEY = "VideoPlayer::updateFrameTexture";
+
+void VideoPlayer::onFrame(const uint8_t *pixels, uint32_t width, uint32_t height, uint32_t rowStride, gfx::Format format)
+{
+    const uint32_t rowBytes = width * 4;
+    std::lock_guard<std::mutex> lock(_frameMutex);
+    _pendingFrame.resize(static_cast<size_t>(rowBytes) * height);
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        memcpy(_pendingFrame.data() + static_cast<size_t>(y) * rowBytes, pixels + static_cast<size_t>(y) * rowStride, rowBytes);
+    }
+    _pendingWidth = width;
+    _pendingHeight = height;
+    _pendingFormat = format;
+    _hasPendingFrame = true;
+}
+
+void VideoPlayer::setFrameUpdatesEnabled(bool enabled)
+{
+    auto *application = Application::getInstance();
+    if (!application || !application->getScheduler())
+        return;
+
+    if (enabled)
+    {
+        application->getScheduler()->schedule([this](float) { updateFrameTexture(); }, this, 0, false, FRAME_UPDATE_KEY);
+    }
+    else
+    {
+        application->getScheduler()->unschedule(FRAME_UPDATE_KEY, this);
+    }
+}
+
+void VideoPlayer::updateFrameTexture()
+{
+    pullFrame();
+
+    std::lock_guard<std::mutex> lock(_frameMutex);
+    if (!_hasPendingFrame)
+        return;
+    _hasPendingFrame = false;
+
+    auto *device = gfx::Device::getInstance();
+    if (!device)
+        return;
+
+    if (_frameTexture && (_frameTexture->getWidth() != _pendingWidth || _frameTexture->getHeight() != _pendingHeight || _frameTexture->getFormat() != _pendingFormat))
+    {
+        CC_SAFE_DESTROY(_frameTexture);
+    }
+    if (!_frameTexture)
+    {
+        _frameTexture = device->createTexture({
+            gfx::TextureType::TEX2D,
+            gfx::TextureUsageBit::SAMPLED | gfx::TextureUsageBit::TRANSFER_DST,
+            _pendingFormat,
+            _pendingWidth,
+            _pendingHeight,
+        });
+    }
+
+    gfx::BufferTextureCopy region;
+    region.texExtent.width = _pendingWidth;
+    region.texExtent.height = _pendingHeight;
+    const uint8_t *buffer = _pendingFrame.data();
+    device->copyBuffersToTexture(&buffer, _frameTexture, &region, 1);
+}
+
+} // namespace cc
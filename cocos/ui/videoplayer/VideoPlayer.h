@@ -26,9 +26,12 @@
 
 #include "base/Macros.h"
 #include "base/Ref.h"
+#include <cstdint>
 #include <functional>
 #include <string>
 #include <map>
+#include <mutex>
+#include <vector>
 
 #ifndef OBJC_CLASS
 #ifdef __OBJC__
@@ -40,6 +43,11 @@
 
 namespace cc {
 
+namespace gfx {
+enum class Format;
+class Texture;
+} // namespace gfx
+
 /**
  * @class VideoPlayer
  * @brief Displays a video file.
@@ -150,11 +158,36 @@ class VideoPlayer : public Ref
      * Set the rect of VideoPlayer.
      */
     virtual void setFrame(float x, float y, float width, float height);
-    
+
+    /**
+     * Renders the video into a texture instead of a native view above the game, so it is drawn like any
+     * other texture and layered with the rest of the UI. Set before setURL, setFrame doesn't apply then.
+     */
+    void setRenderToTextureEnabled(bool enabled);
+    bool isRenderToTextureEnabled() const { return _renderToTextureEnabled; }
+
+    /**
+     * The texture the frames are rendered into, null until the first frame arrived.
+     * It is created again when the size of the video changes.
+     */
+    gfx::Texture *getFrameTexture() const { return _frameTexture; }
+
+    /**
+     * Receives a decoded frame from any thread, it is uploaded on the next frame of the game.
+     * Only the newest frame is kept, frames arriving faster than the game renders are dropped.
+     */
+    void onFrame(const uint8_t *pixels, uint32_t width, uint32_t height, uint32_t rowStride, gfx::Format format);
+
   protected:
 
     virtual ~VideoPlayer();
 
+    // scheduled on the cocos thread while rendering to a texture
+    void updateFrameTexture();
+    void setFrameUpdatesEnabled(bool enabled);
+    // platform part, fetches a frame on the cocos thread when the platform doesn't push them
+    void pullFrame();
+
   protected:
 
     enum class Source
@@ -175,6 +208,15 @@ class VideoPlayer : public Ref
     std::map<std::string, ccVideoPlayerCallback> _eventCallback;
 
     void *_videoView;
+
+    bool _renderToTextureEnabled = false;
+    gfx::Texture *_frameTexture = nullptr;
+    std::mutex _frameMutex;
+    std::vector<uint8_t> _pendingFrame; // tightly packed rows
+    uint32_t _pendingWidth = 0;
+    uint32_t _pendingHeight = 0;
+    gfx::Format _pendingFormat;
+    bool _hasPendingFrame = false;
 };
 
 }
@@ -24,11 +24,24 @@
  THE SOFTWARE.
  ****************************************************************************/
 #include "AssetsManagerEx.h"
+#include "BinaryPatch.h"
+#include "base/StreamHash.h"
+#include "base/ThreadConfig.h"
 #include "base/UTF8.h"
 #include "AsyncTaskPool.h"
 
 #include <stdio.h>
 #include <errno.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <memory>
+#include <thread>
+
+#if (CC_PLATFORM != CC_PLATFORM_WINDOWS)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 #ifdef MINIZIP_FROM_SYSTEM
 #include <minizip/unzip.h>
@@ -43,13 +56,16 @@ NS_CC_EXT_BEGIN
 #define TEMP_PACKAGE_SUFFIX     "_temp"
 #define MANIFEST_FILENAME       "project.manifest"
 
-#define BUFFER_SIZE    8192
+#define BUFFER_SIZE    (64 * 1024)
 #define MAX_FILENAME   512
 
 #define DEFAULT_CONNECTION_TIMEOUT 45
+#define DEFAULT_CHUNKS_PER_TASK 4
 
 #define SAVE_POINT_INTERVAL 0.1
 
+#define PATCH_FILE_SUFFIX ".patch"
+
 const std::string AssetsManagerEx::VERSION_ID = "@version";
 const std::string AssetsManagerEx::MANIFEST_ID = "@manifest";
 
@@ -77,7 +93,9 @@ void AssetsManagerEx::init(const std::string& manifestUrl, const std::string& st
     {
         static_cast<uint32_t>(_maxConcurrentTask),
         DEFAULT_CONNECTION_TIMEOUT,
-        ".tmp"
+        ".tmp",
+        DEFAULT_CHUNKS_PER_TASK,
+        0
     };
     _downloader = std::shared_ptr<network::Downloader>(new network::Downloader(hints));
     _downloader->onTaskError = std::bind(&AssetsManagerEx::onError, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4);
@@ -90,7 +108,7 @@ void AssetsManagerEx::init(const std::string& manifestUrl, const std::string& st
     };
     _downloader->onFileTaskSuccess = [this](const network::DownloadTask& task)
     {
-        this->onSuccess(task.requestURL, task.storagePath, task.identifier);
+        this->onSuccess(task.requestURL, task.storagePath, task.identifier, task.getHash());
     };
     setStoragePath(storagePath);
     _tempVersionPath = _tempStoragePath + VERSION_FILENAME;
@@ -436,7 +454,107 @@ void AssetsManagerEx::adjustPath(std::string &path)
     }
 }
 
-bool AssetsManagerEx::decompress(const std::string &zip)
+namespace {
+
+struct ZipEntry
+{
+    std::string name;
+    std::string fullPath;
+    unz_file_pos pos;
+    uLong size;
+};
+
+// Reserves the blocks of the file before it's written, a failure only loses the optimization
+void preallocateFile(FILE *fp, uLong size)
+{
+    if (size == 0)
+    {
+        return;
+    }
+#if (CC_PLATFORM == CC_PLATFORM_ANDROID) && __ANDROID_API__ >= 21
+    posix_fallocate(fileno(fp), 0, static_cast<off_t>(size));
+#elif (CC_PLATFORM == CC_PLATFORM_MAC_IOS || CC_PLATFORM == CC_PLATFORM_MAC_OSX)
+    fstore_t store = {F_ALLOCATEALL, F_PEOFPOSMODE, 0, static_cast<off_t>(size), 0};
+    fcntl(fileno(fp), F_PREALLOCATE, &store);
+#else
+    (void)fp;
+#endif
+}
+
+// Extracts the entries claimed from next until there's none left or one of the workers failed
+void extractZipEntries(const std::string &zip, const std::vector<ZipEntry> &entries, std::atomic<size_t> *next, std::atomic<bool> *failed,
+                       const std::function<void(const ZipEntry &entry)> &onExtracted)
+{
+    // minizip handles can't be shared, each worker reads through its own
+    unzFile zipfile = unzOpen(FileUtils::getInstance()->getSuitableFOpen(zip).c_str());
+    if (!zipfile)
+    {
+        CC_LOG_DEBUG("AssetsManagerEx : can not open downloaded zip file %s\n", zip.c_str());
+        failed->store(true);
+        return;
+    }
+    std::unique_ptr<char[]> readBuffer(new (std::nothrow) char[BUFFER_SIZE]);
+    std::unique_ptr<char[]> writeBuffer(new (std::nothrow) char[BUFFER_SIZE]);
+    if (!readBuffer || !writeBuffer)
+    {
+        failed->store(true);
+    }
+
+    for (size_t i = next->fetch_add(1); i < entries.size() && !failed->load(); i = next->fetch_add(1))
+    {
+        const ZipEntry &entry = entries[i];
+        unz_file_pos pos = entry.pos;
+        if (unzGoToFilePos(zipfile, &pos) != UNZ_OK || unzOpenCurrentFile(zipfile) != UNZ_OK)
+        {
+            CC_LOG_DEBUG("AssetsManagerEx : can not extract file %s\n", entry.name.c_str());
+            failed->store(true);
+            break;
+        }
+
+        // Create a file to store current file.
+        FILE *out = fopen(FileUtils::getInstance()->getSuitableFOpen(entry.fullPath).c_str(), "wb");
+        if (!out)
+        {
+            CC_LOG_DEBUG("AssetsManagerEx : can not create decompress destination file %s (errno: %d)\n", entry.fullPath.c_str(), errno);
+            unzCloseCurrentFile(zipfile);
+            failed->store(true);
+            break;
+        }
+        setvbuf(out, writeBuffer.get(), _IOFBF, BUFFER_SIZE);
+        preallocateFile(out, entry.size);
+
+        // Write current file content to destinate file.
+        int error = UNZ_OK;
+        bool written = true;
+        do
+        {
+            error = unzReadCurrentFile(zipfile, readBuffer.get(), BUFFER_SIZE);
+            if (error < 0)
+            {
+                CC_LOG_DEBUG("AssetsManagerEx : can not read zip file %s, error code is %d\n", entry.name.c_str(), error);
+            }
+            else if (error > 0)
+            {
+                written = 1 == fwrite(readBuffer.get(), error, 1, out);
+            }
+        } while (error > 0 && written);
+
+        written = 0 == fclose(out) && written;
+        if (unzCloseCurrentFile(zipfile) != UNZ_OK || error < 0 || !written)
+        {
+            CC_LOG_DEBUG("AssetsManagerEx : can not decompress file %s\n", entry.fullPath.c_str());
+            failed->store(true);
+            break;
+        }
+        onExtracted(entry);
+    }
+
+    unzClose(zipfile);
+}
+
+} // namespace
+
+bool AssetsManagerEx::decompress(const std::string &zip, const std::string &customId)
 {
     // Find root path for zip file
     size_t pos = zip.find_last_of("/\\");
@@ -464,9 +582,9 @@ bool AssetsManagerEx::decompress(const std::string &zip)
         return false;
     }
 
-    // Buffer to hold data read from the zip file
-    char readBuffer[BUFFER_SIZE];
-    // Loop to extract all files.
+    // List the files and create all directories in advance, the files are then extracted in parallel
+    std::vector<ZipEntry> entries;
+    entries.reserve(global_info.number_entry);
     uLong i;
     for (i = 0; i < global_info.number_entry; ++i)
     {
@@ -504,7 +622,6 @@ bool AssetsManagerEx::decompress(const std::string &zip)
         }
         else
         {
-            // Create all directories in advance to avoid issue
             std::string dir = basename(fullPath);
             if (!_fileUtils->isDirectoryExist(dir)) {
                 if (!_fileUtils->createDirectory(dir)) {
@@ -514,50 +631,19 @@ bool AssetsManagerEx::decompress(const std::string &zip)
                     return false;
                 }
             }
-            // Entry is a file, so extract it.
-            // Open current file.
-            if (unzOpenCurrentFile(zipfile) != UNZ_OK)
-            {
-                CC_LOG_DEBUG("AssetsManagerEx : can not extract file %s\n", fileName);
-                unzClose(zipfile);
-                return false;
-            }
-
-            // Create a file to store current file.
-            FILE *out = fopen(FileUtils::getInstance()->getSuitableFOpen(fullPath).c_str(), "wb");
-            if (!out)
+            ZipEntry entry;
+            entry.name = fileName;
+            entry.fullPath = fullPath;
+            entry.size = fileInfo.uncompressed_size;
+            if (unzGetFilePos(zipfile, &entry.pos) != UNZ_OK)
             {
-                CC_LOG_DEBUG("AssetsManagerEx : can not create decompress destination file %s (errno: %d)\n", fullPath.c_str(), errno);
-                unzCloseCurrentFile(zipfile);
+                CC_LOG_DEBUG("AssetsManagerEx : can not locate file %s\n", fileName);
                 unzClose(zipfile);
                 return false;
             }
-
-            // Write current file content to destinate file.
-            int error = UNZ_OK;
-            do
-            {
-                error = unzReadCurrentFile(zipfile, readBuffer, BUFFER_SIZE);
-                if (error < 0)
-                {
-                    CC_LOG_DEBUG("AssetsManagerEx : can not read zip file %s, error code is %d\n", fileName, error);
-                    fclose(out);
-                    unzCloseCurrentFile(zipfile);
-                    unzClose(zipfile);
-                    return false;
-                }
-
-                if (error > 0)
-                {
-                    fwrite(readBuffer, error, 1, out);
-                }
-            } while(error > 0);
-
-            fclose(out);
+            entries.push_back(entry);
         }
 
-        unzCloseCurrentFile(zipfile);
-
         // Goto next entry listed in the zip file.
         if ((i+1) < global_info.number_entry)
         {
@@ -569,9 +655,34 @@ bool AssetsManagerEx::decompress(const std::string &zip)
             }
         }
     }
-
     unzClose(zipfile);
-    return true;
+
+    // Report each file in the cocos thread, the events keep their order before the one of the finished package
+    const std::function<void(const ZipEntry &entry)> onExtracted = [this, customId](const ZipEntry &entry) {
+        std::string name = entry.name;
+        Application::getInstance()->getScheduler()->performFunctionInCocosThread([this, customId, name]() {
+            dispatchUpdateEvent(EventAssetsManagerEx::EventCode::DECOMPRESS_PROGRESSION, customId, name);
+        });
+    };
+
+    // The files are independent, the threads of the IO lane extract them along with this one
+    std::atomic<size_t> next(0);
+    std::atomic<bool> failed(false);
+    const size_t threadCount = std::min<size_t>(entries.size(), ThreadConfig::getThreadCount(ThreadLane::IO));
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threadCount; ++t)
+    {
+        workers.emplace_back([&]() {
+            ThreadConfig::applyToCurrentThread(ThreadLane::IO);
+            extractZipEntries(zip, entries, &next, &failed, onExtracted);
+        });
+    }
+    extractZipEntries(zip, entries, &next, &failed, onExtracted);
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    return !failed.load();
 }
 
 void AssetsManagerEx::decompressDownloadedZip(const std::string &customId, const std::string &storagePath)
@@ -606,7 +717,7 @@ void AssetsManagerEx::decompressDownloadedZip(const std::string &customId, const
     };
     AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER, decompressFinished, (void*)asyncData, [this, asyncData]() {
         // Decompress all compressed files
-        if (decompress(asyncData->zipFile))
+        if (decompress(asyncData->zipFile, asyncData->customId))
         {
             asyncData->succeed = true;
         }
@@ -614,6 +725,125 @@ void AssetsManagerEx::decompressDownloadedZip(const std::string &customId, const
     });
 }
 
+void AssetsManagerEx::preparePatches()
+{
+    const auto &remoteAssets = _remoteManifest->getAssets();
+    const auto &localAssets = _localManifest->getAssets();
+    const std::string &packageUrl = _remoteManifest->getPackageUrl();
+    for (auto &iter : _downloadUnits)
+    {
+        DownloadUnit &unit = iter.second;
+        auto remoteIt = remoteAssets.find(iter.first);
+        auto localIt = localAssets.find(iter.first);
+        if (!unit.patchUrl.empty() || remoteIt == remoteAssets.end() || localIt == localAssets.end() || remoteIt->second.compressed || localIt->second.md5.empty())
+        {
+            continue;
+        }
+        auto patchIt = remoteIt->second.patches.find(localIt->second.md5);
+        if (patchIt == remoteIt->second.patches.end())
+        {
+            continue;
+        }
+
+        // The local version was downloaded by a previous update or shipped with the package
+        std::string basePath = _localManifest->getManifestRoot() + localIt->second.path;
+        if (!_fileUtils->isFileExist(basePath))
+        {
+            basePath = _fileUtils->fullPathForFilename(localIt->second.path);
+        }
+        if (basePath.empty())
+        {
+            continue;
+        }
+        unit.patchUrl = packageUrl + patchIt->second.path;
+        unit.patchBasePath = basePath;
+        unit.size = patchIt->second.size;
+    }
+}
+
+void AssetsManagerEx::applyDownloadedPatch(const std::string &customId)
+{
+    struct AsyncData
+    {
+        std::string customId;
+        std::string srcUrl;
+        std::string patchFile;
+        std::string basePath;
+        std::string storagePath;
+        std::string hashAlgorithm;
+        std::string hash;
+        bool succeed;
+    };
+
+    const DownloadUnit &unit = _downloadUnits[customId];
+    AsyncData* asyncData = new AsyncData;
+    asyncData->customId = customId;
+    asyncData->srcUrl = unit.patchUrl;
+    asyncData->patchFile = unit.storagePath + PATCH_FILE_SUFFIX;
+    asyncData->basePath = unit.patchBasePath;
+    asyncData->storagePath = unit.storagePath;
+    asyncData->hashAlgorithm = getDownloadHashAlgorithm();
+    asyncData->succeed = false;
+
+    std::function<void(void*)> patchFinished = [this](void* param) {
+        auto dataInner = reinterpret_cast<AsyncData*>(param);
+        _fileUtils->removeFile(dataInner->patchFile);
+        if (dataInner->succeed)
+        {
+            // Verified like a downloaded file
+            onSuccess(dataInner->srcUrl, dataInner->storagePath, dataInner->customId, dataInner->hash);
+        }
+        else if (!fallbackToFullDownload(dataInner->customId))
+        {
+            fileError(dataInner->customId, "Unable to apply patch " + dataInner->patchFile);
+        }
+        delete dataInner;
+    };
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER, patchFinished, (void*)asyncData, [this, asyncData]() {
+        Data base = _fileUtils->getDataFromFile(asyncData->basePath);
+        std::unique_ptr<StreamHash> hash(StreamHash::create(asyncData->hashAlgorithm));
+        asyncData->succeed = BinaryPatch::apply(base.getBytes(), base.getSize(), asyncData->patchFile, asyncData->storagePath, hash.get());
+        if (asyncData->succeed && hash)
+        {
+            asyncData->hash = hash->hexDigest();
+        }
+    });
+}
+
+bool AssetsManagerEx::fallbackToFullDownload(const std::string &customId)
+{
+    auto unitIt = _downloadUnits.find(customId);
+    if (unitIt == _downloadUnits.end() || unitIt->second.patchUrl.empty())
+    {
+        return false;
+    }
+    DownloadUnit &unit = unitIt->second;
+    CC_LOG_DEBUG("AssetsManagerEx : Fail to patch %s, download the whole file\n", customId.c_str());
+    _fileUtils->removeFile(unit.storagePath + PATCH_FILE_SUFFIX);
+    _fileUtils->removeFile(unit.storagePath);
+    unit.patchUrl.clear();
+    unit.patchBasePath.clear();
+
+    // The total size counts the whole file instead of the patch
+    auto &assets = _remoteManifest->getAssets();
+    auto assetIt = assets.find(customId);
+    if (unit.size > 0 && assetIt != assets.end())
+    {
+        _totalSize += assetIt->second.size - unit.size;
+        unit.size = assetIt->second.size;
+    }
+    // The unit keeps its download slot
+    _downloader->createDownloadFileTask(unit.srcUrl, unit.storagePath, unit.customId, getDownloadHashAlgorithm());
+    return true;
+}
+
+std::string AssetsManagerEx::getDownloadHashAlgorithm() const
+{
+    // An algorithm the downloader doesn't know leaves the verification to _verifyCallback
+    const std::string &hashAlgorithm = _remoteManifest->getHashAlgorithm();
+    return StreamHash::isSupported(hashAlgorithm) ? hashAlgorithm : "";
+}
+
 void AssetsManagerEx::dispatchUpdateEvent(EventAssetsManagerEx::EventCode code, const std::string &assetId/* = ""*/, const std::string &message/* = ""*/, int curle_code/* = CURLE_OK*/, int curlm_code/* = CURLM_OK*/)
 {
     switch (code)
@@ -632,6 +862,8 @@ void AssetsManagerEx::dispatchUpdateEvent(EventAssetsManagerEx::EventCode code,
             break;
         case EventAssetsManagerEx::EventCode::ASSET_UPDATED:
             break;
+        case EventAssetsManagerEx::EventCode::DECOMPRESS_PROGRESSION:
+            break;
         case EventAssetsManagerEx::EventCode::NEW_VERSION_FOUND:
             if (_updateEntry == UpdateEntry::CHECK_UPDATE)
             {
@@ -1181,7 +1413,7 @@ void AssetsManagerEx::onError(const network::DownloadTask& task,
         dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ERROR_DOWNLOAD_MANIFEST, task.identifier, errorStr, errorCode, errorCodeInternal);
         _updateState = State::FAIL_TO_UPDATE;
     }
-    else
+    else if (!fallbackToFullDownload(task.identifier))
     {
         fileError(task.identifier, errorStr, errorCode, errorCodeInternal);
     }
@@ -1243,7 +1475,7 @@ void AssetsManagerEx::onProgress(double total, double downloaded, const std::str
     }
 }
 
-void AssetsManagerEx::onSuccess(const std::string &/*srcUrl*/, const std::string &storagePath, const std::string &customId)
+void AssetsManagerEx::onSuccess(const std::string &/*srcUrl*/, const std::string &storagePath, const std::string &customId, const std::string &hash)
 {
     if (customId == VERSION_ID)
     {
@@ -1257,13 +1489,27 @@ void AssetsManagerEx::onSuccess(const std::string &/*srcUrl*/, const std::string
     }
     else
     {
+        auto unitIt = _downloadUnits.find(customId);
+        if (unitIt != _downloadUnits.end() && storagePath == unitIt->second.storagePath + PATCH_FILE_SUFFIX)
+        {
+            applyDownloadedPatch(customId);
+            return;
+        }
+
         bool ok = true;
         auto &assets = _remoteManifest->getAssets();
         auto assetIt = assets.find(customId);
         if (assetIt != assets.end())
         {
             Manifest::Asset asset = assetIt->second;
-            if (_verifyCallback != nullptr)
+            if (!hash.empty() && !asset.md5.empty())
+            {
+                // hashed by the downloader while it was written, the file isn't read again
+                ok = hash.size() == asset.md5.size() && std::equal(hash.begin(), hash.end(), asset.md5.begin(), [](char a, char b) {
+                    return a == std::tolower(static_cast<unsigned char>(b));
+                });
+            }
+            else if (_verifyCallback != nullptr)
             {
                 ok = _verifyCallback(storagePath, asset);
             }
@@ -1281,7 +1527,7 @@ void AssetsManagerEx::onSuccess(const std::string &/*srcUrl*/, const std::string
                 fileSuccess(customId, storagePath);
             }
         }
-        else
+        else if (!fallbackToFullDownload(customId))
         {
             fileError(customId, "Asset file verification failed after downloaded");
         }
@@ -1296,6 +1542,7 @@ void AssetsManagerEx::destroyDownloadedVersion()
 
 void AssetsManagerEx::batchDownload()
 {
+    preparePatches();
     _queue.clear();
     for(auto iter : _downloadUnits)
     {
@@ -1325,6 +1572,7 @@ void AssetsManagerEx::queueDowload()
         return;
     }
 
+    std::string hashAlgorithm = getDownloadHashAlgorithm();
     while (_currConcurrentTask < _maxConcurrentTask && _queue.size() > 0)
     {
         std::string key = _queue.back();
@@ -1333,7 +1581,14 @@ void AssetsManagerEx::queueDowload()
         _currConcurrentTask++;
         DownloadUnit& unit = _downloadUnits[key];
         _fileUtils->createDirectory(basename(unit.storagePath));
-        _downloader->createDownloadFileTask(unit.srcUrl, unit.storagePath, unit.customId);
+        if (unit.patchUrl.empty())
+        {
+            _downloader->createDownloadFileTask(unit.srcUrl, unit.storagePath, unit.customId, hashAlgorithm);
+        }
+        else
+        {
+            _downloader->createDownloadFileTask(unit.patchUrl, unit.storagePath + PATCH_FILE_SUFFIX, unit.customId);
+        }
 
         _tempManifest->setAssetDownloadState(key, Manifest::DownloadState::DOWNLOADING);
     }
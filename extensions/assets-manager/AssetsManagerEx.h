@@ -188,6 +188,7 @@ public:
     void setVersionCompareHandle(const VersionCompareHandle& handle) {_versionCompareHandle = handle;};
     
     /** @brief Set the verification function for checking whether downloaded asset is correct, e.g. using md5 verification
+     * It's not called for the assets the downloader hashed with the hashAlgorithm of the manifest.
      * @param callback  The verify callback function
      */
     void setVerifyCallback(const VerifyCallback& callback) {_verifyCallback = callback;};
@@ -221,8 +222,16 @@ protected:
     void parseManifest();
     void startUpdate();
     void updateSucceed();
-    bool decompress(const std::string &filename);
+    // The files of the package are extracted in parallel, DECOMPRESS_PROGRESSION is dispatched for each one
+    bool decompress(const std::string &filename, const std::string &customId);
     void decompressDownloadedZip(const std::string &customId, const std::string &storagePath);
+    // The units with a patch from their local version download it instead of the whole file
+    void preparePatches();
+    void applyDownloadedPatch(const std::string &customId);
+    // Returns false if the unit wasn't patching
+    bool fallbackToFullDownload(const std::string &customId);
+    // The hash algorithm of the remote manifest if the downloader knows it
+    std::string getDownloadHashAlgorithm() const;
     
     /** @brief Update a list of assets under the current AssetsManagerEx context
      */
@@ -272,11 +281,12 @@ protected:
      the success event will then be send to user's listener registed in addUpdateEventListener
      @param srcUrl      The url of this asset
      @param customId    The key of this asset
+     @param hash        The digest the downloader computed with the hash algorithm of the manifest, empty if it didn't
      @warning AssetsManagerEx internal use only
      * @js NA
      * @lua NA
      */
-    virtual void onSuccess(const std::string &srcUrl, const std::string &storagePath, const std::string &customId);
+    virtual void onSuccess(const std::string &srcUrl, const std::string &storagePath, const std::string &customId, const std::string &hash);
     
 private:
     void batchDownload();
@@ -28,6 +28,7 @@ THE SOFTWARE.
 
 #include "platform/Application.h"
 #include "base/Scheduler.h"
+#include "base/ThreadPool.h"
 #include <vector>
 #include <queue>
 #include <memory>
@@ -87,7 +88,7 @@ public:
     /**
      * Enqueue a asynchronous task.
      *
-     * @param type task type is io task, network task or others, each type of task has a thread to deal with it.
+     * @param type task type is io task, network task or others, the tasks of a type run in order.
      * @param callback callback when the task is finished. The callback is called in the main thread instead of task thread.
      * @param callbackParam parameter used by the callback.
      * @param f task can be lambda function.
@@ -98,7 +99,7 @@ public:
 
 protected:
 
-    // thread tasks internally used
+    // tasks of one type, they run one after the other on the threads of the default ThreadPool
     class ThreadTasks {
         struct AsyncTaskCallBack
         {
@@ -108,45 +109,21 @@ protected:
     public:
         ThreadTasks()
         : _stop(false)
+        , _isDraining(false)
         {
-            _thread = std::thread(
-                                  [this]
-                                  {
-                                      for(;;)
-                                      {
-                                          std::function<void()> task;
-                                          AsyncTaskCallBack callback;
-                                          {
-                                              std::unique_lock<std::mutex> lock(this->_queueMutex);
-                                              this->_condition.wait(lock,
-                                                                    [this]{ return this->_stop || !this->_tasks.empty(); });
-                                              if(this->_stop && this->_tasks.empty())
-                                                  return;
-                                              task = std::move(this->_tasks.front());
-                                              callback = std::move(this->_taskCallBacks.front());
-                                              this->_tasks.pop();
-                                              this->_taskCallBacks.pop();
-                                          }
-
-                                          task();
-                                          Application::getInstance()->getScheduler()->performFunctionInCocosThread([&, callback]{ callback.callback(callback.callbackParam); });
-                                      }
-                                  }
-                                  );
         }
         ~ThreadTasks()
         {
-            {
-                std::unique_lock<std::mutex> lock(_queueMutex);
-                _stop = true;
+            std::unique_lock<std::mutex> lock(_queueMutex);
+            _stop = true;
 
-                while(_tasks.size())
-                    _tasks.pop();
-                while (_taskCallBacks.size())
-                    _taskCallBacks.pop();
-            }
-            _condition.notify_all();
-            _thread.join();
+            while(_tasks.size())
+                _tasks.pop();
+            while (_taskCallBacks.size())
+                _taskCallBacks.pop();
+
+            // the task running on the pool still refers to this
+            _condition.wait(lock, [this]{ return !this->_isDraining; });
         }
         void clear()
         {
@@ -160,6 +137,7 @@ protected:
         void enqueue(const TaskCallBack& callback, void* callbackParam, F&& f)
         {
             auto task = f;//std::bind(std::forward<F>(f), std::forward<Args>(args)...);
+            bool needsDrain = false;
 
             {
                 std::unique_lock<std::mutex> lock(_queueMutex);
@@ -176,13 +154,40 @@ protected:
                 taskCallBack.callbackParam = callbackParam;
                 _tasks.emplace([task](){ task(); });
                 _taskCallBacks.emplace(taskCallBack);
+
+                needsDrain = !_isDraining;
+                _isDraining = true;
             }
-            _condition.notify_one();
+
+            if (needsDrain)
+                ThreadPool::getDefaultThreadPool()->pushTask([this](int /*threadId*/){ drain(); }, ThreadPool::TaskType::IO);
         }
     private:
+        void drain()
+        {
+            for(;;)
+            {
+                std::function<void()> task;
+                AsyncTaskCallBack callback;
+                {
+                    std::unique_lock<std::mutex> lock(_queueMutex);
+                    if(_tasks.empty())
+                    {
+                        _isDraining = false;
+                        _condition.notify_all();
+                        return;
+                    }
+                    task = std::move(_tasks.front());
+                    callback = std::move(_taskCallBacks.front());
+                    _tasks.pop();
+                    _taskCallBacks.pop();
+                }
+
+                task();
+                Application::getInstance()->getScheduler()->performFunctionInCocosThread([&, callback]{ callback.callback(callback.callbackParam); });
+            }
+        }
 
-        // need to keep track of thread so we can join them
-        std::thread _thread;
         // the task queue
         std::queue< std::function<void()> > _tasks;
         std::queue<AsyncTaskCallBack>            _taskCallBacks;
@@ -191,6 +196,7 @@ protected:
         std::mutex _queueMutex;
         std::condition_variable _condition;
         bool _stop;
+        bool _isDraining; // a task of the pool is running the queue
     };
 
     //tasks
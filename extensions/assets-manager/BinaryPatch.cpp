@@ -0,0 +1,205 @@
+#include "BinaryPatch.h"
+
+#include "base/StreamHash.h"
+#include "platform/FileUtils.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <new>
+
+#define PATCH_MAGIC         "ENDSLEY/BSDIFF43"
+#define PATCH_MAGIC_SIZE    16
+#define PATCH_READ_SIZE     (16 * 1024)
+#define PATCH_WRITE_SIZE    (64 * 1024)
+
+NS_CC_EXT_BEGIN
+
+namespace {
+
+int64_t readOffset(const unsigned char *buf)
+{
+    int64_t value = buf[7] & 0x7f;
+    for (int i = 6; i >= 0; --i)
+    {
+        value = value * 256 + buf[i];
+    }
+    return (buf[7] & 0x80) ? -value : value;
+}
+
+// inflates the patch stream from the file in pieces of PATCH_READ_SIZE
+class PatchReader
+{
+public:
+    explicit PatchReader(FILE *fp) : _fp(fp)
+    {
+        memset(&_stream, 0, sizeof(_stream));
+        // a zlib or a gzip header
+        _inited = Z_OK == inflateInit2(&_stream, 15 + 32);
+    }
+
+    ~PatchReader()
+    {
+        if (_inited)
+        {
+            inflateEnd(&_stream);
+        }
+    }
+
+    bool read(unsigned char *dst, size_t len)
+    {
+        if (!_inited)
+        {
+            return false;
+        }
+        _stream.next_out = dst;
+        _stream.avail_out = static_cast<uInt>(len);
+        while (_stream.avail_out)
+        {
+            if (0 == _stream.avail_in)
+            {
+                _stream.avail_in = static_cast<uInt>(fread(_input, 1, sizeof(_input), _fp));
+                _stream.next_in = _input;
+                if (0 == _stream.avail_in)
+                {
+                    return false;
+                }
+            }
+            int ret = inflate(&_stream, Z_NO_FLUSH);
+            if (Z_STREAM_END == ret && _stream.avail_out)
+            {
+                return false;
+            }
+            if (Z_OK != ret && Z_STREAM_END != ret)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    FILE *_fp;
+    z_stream _stream;
+    bool _inited;
+    unsigned char _input[PATCH_READ_SIZE];
+};
+
+} // namespace
+
+bool BinaryPatch::apply(const unsigned char *oldData, size_t oldSize, const std::string &patchPath, const std::string &dstPath, StreamHash *hash)
+{
+    auto fileUtils = FileUtils::getInstance();
+    FILE *patchFile = fopen(fileUtils->getSuitableFOpen(patchPath).c_str(), "rb");
+    if (!patchFile)
+    {
+        return false;
+    }
+    FILE *dstFile = fopen(fileUtils->getSuitableFOpen(dstPath).c_str(), "wb");
+    if (!dstFile)
+    {
+        fclose(patchFile);
+        return false;
+    }
+
+    bool ok = false;
+    do
+    {
+        unsigned char header[PATCH_MAGIC_SIZE + 8];
+        if (sizeof(header) != fread(header, 1, sizeof(header), patchFile) || 0 != memcmp(header, PATCH_MAGIC, PATCH_MAGIC_SIZE))
+        {
+            break;
+        }
+        const int64_t newSize = readOffset(header + PATCH_MAGIC_SIZE);
+        if (newSize < 0)
+        {
+            break;
+        }
+
+        std::unique_ptr<PatchReader> reader(new (std::nothrow) PatchReader(patchFile));
+        std::unique_ptr<unsigned char[]> buf(new (std::nothrow) unsigned char[PATCH_WRITE_SIZE]);
+        if (!reader || !buf)
+        {
+            break;
+        }
+        const int64_t oldLength = static_cast<int64_t>(oldSize);
+        int64_t oldPos = 0;
+        int64_t newPos = 0;
+        bool failed = false;
+        while (newPos < newSize && !failed)
+        {
+            unsigned char control[24];
+            if (!reader->read(control, sizeof(control)))
+            {
+                failed = true;
+                break;
+            }
+            const int64_t diffLength = readOffset(control);
+            const int64_t extraLength = readOffset(control + 8);
+            const int64_t seek = readOffset(control + 16);
+            if (diffLength < 0 || extraLength < 0 || diffLength > newSize - newPos || extraLength > newSize - newPos - diffLength)
+            {
+                failed = true;
+                break;
+            }
+
+            // the diff bytes are added to the old bytes, the bytes outside of the old file count as 0
+            for (int64_t done = 0; done < diffLength && !failed;)
+            {
+                const size_t len = static_cast<size_t>(std::min(diffLength - done, static_cast<int64_t>(PATCH_WRITE_SIZE)));
+                if (!reader->read(buf.get(), len))
+                {
+                    failed = true;
+                    break;
+                }
+                for (size_t i = 0; i < len; ++i)
+                {
+                    const int64_t pos = oldPos + done + static_cast<int64_t>(i);
+                    if (pos >= 0 && pos < oldLength)
+                    {
+                        buf[i] += oldData[pos];
+                    }
+                }
+                failed = len != fwrite(buf.get(), 1, len, dstFile);
+                if (hash && !failed)
+                {
+                    hash->update(buf.get(), len);
+                }
+                done += len;
+            }
+            newPos += diffLength;
+            oldPos += diffLength;
+
+            for (int64_t done = 0; done < extraLength && !failed;)
+            {
+                const size_t len = static_cast<size_t>(std::min(extraLength - done, static_cast<int64_t>(PATCH_WRITE_SIZE)));
+                failed = !reader->read(buf.get(), len) || len != fwrite(buf.get(), 1, len, dstFile);
+                if (hash && !failed)
+                {
+                    hash->update(buf.get(), len);
+                }
+                done += len;
+            }
+            newPos += extraLength;
+            oldPos += seek;
+        }
+        ok = !failed;
+    } while (0);
+
+    fclose(patchFile);
+    if (0 != fclose(dstFile))
+    {
+        ok = false;
+    }
+    if (!ok)
+    {
+        fileUtils->removeFile(dstPath);
+    }
+    return ok;
+}
+
+NS_CC_EXT_END
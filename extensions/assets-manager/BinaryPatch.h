@@ -0,0 +1,33 @@
+#pragma once
+
+#include "extensions/ExtensionMacros.h"
+#include "extensions/ExtensionExport.h"
+
+#include <string>
+
+namespace cc {
+class StreamHash;
+}
+
+NS_CC_EXT_BEGIN
+
+/**
+ * Applies a binary delta of the bsdiff algorithm to the previous version of a file.
+ * A patch has the layout of ENDSLEY/BSDIFF43, with the stream compressed by zlib (or gzip) instead of bzip2:
+ *   "ENDSLEY/BSDIFF43"      16 bytes
+ *   size of the new file     8 bytes
+ *   compressed stream        control triples x, y, z of 8 bytes, each followed by x bytes added to the old file
+ *                            from the current position and y bytes copied as they are, then the old position moves by z
+ * The integers are little endian with the sign in the highest bit, as bsdiff writes them.
+ * The patch and the new file are streamed, the old file is read in memory.
+ */
+class CC_EX_DLL BinaryPatch
+{
+public:
+    /** @brief Writes the new file to dstPath, false if the patch is malformed or a file can't be read or written.
+     * @param hash  Updated with the new file when it's not nullptr
+     */
+    static bool apply(const unsigned char *oldData, size_t oldSize, const std::string &patchPath, const std::string &dstPath, StreamHash *hash);
+};
+
+NS_CC_EXT_END
@@ -51,7 +51,9 @@ public:
         ERROR_UPDATING,
         UPDATE_FINISHED,
         UPDATE_FAILED,
-        ERROR_DECOMPRESS
+        ERROR_DECOMPRESS,
+        //! A file of a compressed asset has been extracted, the message is its path in the package
+        DECOMPRESS_PROGRESSION
     };
     
     inline EventCode getEventCode() const { return _code; };
@@ -28,7 +28,10 @@
 #include "json/prettywriter.h"
 #include "json/stringbuffer.h"
 #include "base/Log.h"
+#include "base/StreamHash.h"
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <stdio.h>
 
@@ -42,6 +45,7 @@
 #define KEY_ASSETS              "assets"
 #define KEY_COMPRESSED_FILES    "compressedFiles"
 #define KEY_SEARCH_PATHS        "searchPaths"
+#define KEY_HASH_ALGORITHM      "hashAlgorithm"
 
 #define KEY_PATH                "path"
 #define KEY_MD5                 "md5"
@@ -50,9 +54,196 @@
 #define KEY_SIZE                "size"
 #define KEY_COMPRESSED_FILE     "compressedFile"
 #define KEY_DOWNLOAD_STATE      "downloadState"
+#define KEY_PATCHES             "patches"
+
+// The binary manifest, the integers are little endian and the sections start at multiples of 8:
+//   BinaryHeader
+//   BinaryGroup[groups.count]              in the order of the groups
+//   BinaryString[searchPaths.count]
+//   BinaryAsset[assets.count]              sorted by keyHash, the XXH64 of the key with seed 0, then by key
+//   BinaryPatchEntry[patches.count]        the patches of an asset are consecutive
+//   char[strings.count]                    the string table, each distinct string is stored once
+#define BINARY_MANIFEST_MAGIC       "CCMF"
+#define BINARY_MANIFEST_MAGIC_SIZE  4
+#define BINARY_MANIFEST_VERSION     1
+#define BINARY_FLAG_UPDATING        1
 
 NS_CC_EXT_BEGIN
 
+namespace {
+
+struct BinaryString
+{
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct BinarySection
+{
+    uint32_t offset;
+    uint32_t count;
+};
+
+struct BinaryHeader
+{
+    char magic[BINARY_MANIFEST_MAGIC_SIZE];
+    uint32_t formatVersion;
+    uint32_t flags;
+    uint32_t reserved;
+    BinaryString version;
+    BinaryString packageUrl;
+    BinaryString remoteManifestUrl;
+    BinaryString remoteVersionUrl;
+    BinaryString engineVersion;
+    BinaryString hashAlgorithm;
+    BinarySection groups;
+    BinarySection searchPaths;
+    BinarySection assets;
+    BinarySection patches;
+    //! count is the size in bytes
+    BinarySection strings;
+};
+
+struct BinaryGroup
+{
+    BinaryString name;
+    BinaryString version;
+};
+
+struct BinaryAsset
+{
+    uint64_t keyHash;
+    BinaryString key;
+    BinaryString path;
+    BinaryString md5;
+    uint32_t size;
+    int32_t downloadState;
+    uint32_t compressed;
+    uint32_t firstPatch;
+    uint32_t patchCount;
+    uint32_t reserved;
+};
+
+struct BinaryPatchEntry
+{
+    BinaryString baseMd5;
+    BinaryString path;
+    uint32_t size;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(BinaryHeader) == 104 && sizeof(BinaryAsset) == 56 && sizeof(BinaryPatchEntry) == 24, "The binary manifest layout has no padding");
+
+uint64_t hashKey(const std::string &key)
+{
+    XXH64Hash hash;
+    hash.update(key.data(), key.size());
+    return hash.digest();
+}
+
+// Reads the items by copy, the file may have been read in memory without alignment instead of mapped
+class BinaryReader
+{
+public:
+    BinaryReader(const unsigned char *bytes, size_t size)
+    : _bytes(bytes)
+    , _size(size)
+    , _strings(nullptr)
+    , _stringsSize(0)
+    {
+    }
+
+    bool hasSection(const BinarySection &section, size_t itemSize) const
+    {
+        return section.offset <= _size && section.count <= (_size - section.offset) / itemSize;
+    }
+
+    template <typename T>
+    T at(const BinarySection &section, uint32_t index) const
+    {
+        T item;
+        memcpy(&item, _bytes + section.offset + static_cast<size_t>(index) * sizeof(T), sizeof(T));
+        return item;
+    }
+
+    void setStrings(const BinarySection &strings)
+    {
+        _strings = reinterpret_cast<const char *>(_bytes) + strings.offset;
+        _stringsSize = strings.count;
+    }
+
+    bool read(const BinaryString &str, std::string *out) const
+    {
+        if (str.offset > _stringsSize || str.length > _stringsSize - str.offset)
+        {
+            return false;
+        }
+        out->assign(_strings + str.offset, str.length);
+        return true;
+    }
+
+private:
+    const unsigned char *_bytes;
+    size_t _size;
+    const char *_strings;
+    uint32_t _stringsSize;
+};
+
+class BinaryWriter
+{
+public:
+    BinaryWriter()
+    : _data(sizeof(BinaryHeader), '\0')
+    {
+    }
+
+    BinaryString addString(const std::string &str)
+    {
+        auto it = _offsets.find(str);
+        if (it != _offsets.end())
+        {
+            return {it->second, static_cast<uint32_t>(str.size())};
+        }
+        const uint32_t offset = static_cast<uint32_t>(_strings.size());
+        _strings.append(str);
+        _offsets.emplace(str, offset);
+        return {offset, static_cast<uint32_t>(str.size())};
+    }
+
+    template <typename T>
+    BinarySection addSection(const std::vector<T> &items)
+    {
+        align();
+        BinarySection section = {static_cast<uint32_t>(_data.size()), static_cast<uint32_t>(items.size())};
+        if (!items.empty())
+        {
+            _data.append(reinterpret_cast<const char *>(items.data()), items.size() * sizeof(T));
+        }
+        return section;
+    }
+
+    const std::string &finish(BinaryHeader *header)
+    {
+        align();
+        header->strings = {static_cast<uint32_t>(_data.size()), static_cast<uint32_t>(_strings.size())};
+        _data.append(_strings);
+        memcpy(&_data[0], header, sizeof(BinaryHeader));
+        return _data;
+    }
+
+private:
+    void align()
+    {
+        _data.resize((_data.size() + 7) & ~static_cast<size_t>(7), '\0');
+    }
+
+    std::string _data;
+    std::string _strings;
+    std::unordered_map<std::string, uint32_t> _offsets;
+};
+
+} // namespace
+
 static int cmpVersion(const std::string& v1, const std::string& v2)
 {
     int i;
@@ -78,6 +269,7 @@ Manifest::Manifest(const std::string& manifestUrl/* = ""*/)
 : _versionLoaded(false)
 , _loaded(false)
 , _updating(false)
+, _binary(false)
 , _manifestRoot("")
 , _remoteManifestUrl("")
 , _remoteVersionUrl("")
@@ -94,6 +286,7 @@ Manifest::Manifest(const std::string& content, const std::string& manifestRoot)
 : _versionLoaded(false)
 , _loaded(false)
 , _updating(false)
+, _binary(false)
 , _manifestRoot("")
 , _remoteManifestUrl("")
 , _remoteVersionUrl("")
@@ -147,8 +340,139 @@ void Manifest::loadJsonFromString(const std::string& content)
     }
 }
 
+bool Manifest::loadBinaryFile(const std::string& url, bool versionOnly)
+{
+    if (!_fileUtils->isFileExist(url))
+    {
+        return false;
+    }
+    MappedFile file = _fileUtils->mapFile(url);
+    if (file.getSize() < BINARY_MANIFEST_MAGIC_SIZE || 0 != memcmp(file.getBytes(), BINARY_MANIFEST_MAGIC, BINARY_MANIFEST_MAGIC_SIZE))
+    {
+        return false;
+    }
+    
+    clear();
+    _json.SetNull();
+    if (!loadBinary(file.getBytes(), static_cast<size_t>(file.getSize()), versionOnly))
+    {
+        CC_LOG_DEBUG("Fail to parse binary manifest: %s\n", url.c_str());
+    }
+    return true;
+}
+
+bool Manifest::loadBinary(const unsigned char *bytes, size_t size, bool versionOnly)
+{
+    BinaryHeader header;
+    if (size < sizeof(header))
+    {
+        return false;
+    }
+    memcpy(&header, bytes, sizeof(header));
+    BinaryReader reader(bytes, size);
+    if (0 != memcmp(header.magic, BINARY_MANIFEST_MAGIC, BINARY_MANIFEST_MAGIC_SIZE) || header.formatVersion != BINARY_MANIFEST_VERSION
+        || !reader.hasSection(header.strings, 1) || !reader.hasSection(header.groups, sizeof(BinaryGroup))
+        || !reader.hasSection(header.searchPaths, sizeof(BinaryString)) || !reader.hasSection(header.assets, sizeof(BinaryAsset))
+        || !reader.hasSection(header.patches, sizeof(BinaryPatchEntry)))
+    {
+        return false;
+    }
+    reader.setStrings(header.strings);
+    
+    bool ok = reader.read(header.version, &_version)
+        && reader.read(header.remoteManifestUrl, &_remoteManifestUrl)
+        && reader.read(header.remoteVersionUrl, &_remoteVersionUrl)
+        && reader.read(header.engineVersion, &_engineVer);
+    for (uint32_t i = 0; ok && i < header.groups.count; ++i)
+    {
+        const BinaryGroup item = reader.at<BinaryGroup>(header.groups, i);
+        std::string group, version;
+        ok = reader.read(item.name, &group) && reader.read(item.version, &version);
+        _groups.push_back(group);
+        _groupVer.emplace(group, version);
+    }
+    _updating = (header.flags & BINARY_FLAG_UPDATING) != 0;
+    _versionLoaded = true;
+    
+    if (ok && !versionOnly)
+    {
+        // Marked before the assets, so that clear() removes the ones read when the file is malformed
+        _loaded = true;
+        ok = reader.read(header.packageUrl, &_packageUrl) && reader.read(header.hashAlgorithm, &_hashAlgorithm);
+        for (uint32_t i = 0; ok && i < header.searchPaths.count; ++i)
+        {
+            std::string path;
+            ok = reader.read(reader.at<BinaryString>(header.searchPaths, i), &path);
+            _searchPaths.push_back(path);
+        }
+        
+        bool sorted = true;
+        _assets.reserve(header.assets.count);
+        _assetIndex.reserve(header.assets.count);
+        for (uint32_t i = 0; ok && i < header.assets.count; ++i)
+        {
+            const BinaryAsset item = reader.at<BinaryAsset>(header.assets, i);
+            std::string key;
+            Asset asset;
+            ok = reader.read(item.key, &key) && reader.read(item.path, &asset.path) && reader.read(item.md5, &asset.md5)
+                && item.firstPatch <= header.patches.count && item.patchCount <= header.patches.count - item.firstPatch;
+            asset.size = item.size;
+            asset.downloadState = item.downloadState;
+            asset.compressed = item.compressed != 0;
+            for (uint32_t j = 0; ok && j < item.patchCount; ++j)
+            {
+                const BinaryPatchEntry patchItem = reader.at<BinaryPatchEntry>(header.patches, item.firstPatch + j);
+                std::string baseMd5;
+                ManifestPatch patch;
+                ok = reader.read(patchItem.baseMd5, &baseMd5) && reader.read(patchItem.path, &patch.path);
+                patch.size = patchItem.size;
+                asset.patches.emplace(baseMd5, patch);
+            }
+            if (!ok)
+            {
+                break;
+            }
+            
+            auto result = _assets.emplace(std::move(key), std::move(asset));
+            if (result.second)
+            {
+                AssetIndexEntry entry = {item.keyHash, &result.first->first, &result.first->second};
+                sorted = sorted && (_assetIndex.empty() || _assetIndex.back() < entry);
+                _assetIndex.push_back(entry);
+            }
+        }
+        if (ok && !sorted)
+        {
+            std::sort(_assetIndex.begin(), _assetIndex.end());
+        }
+        _binary = true;
+    }
+    
+    if (!ok)
+    {
+        clear();
+    }
+    return ok;
+}
+
+void Manifest::buildAssetIndex()
+{
+    _assetIndex.clear();
+    _assetIndex.reserve(_assets.size());
+    for (auto it = _assets.cbegin(); it != _assets.cend(); ++it)
+    {
+        _assetIndex.push_back({hashKey(it->first), &it->first, &it->second});
+    }
+    std::sort(_assetIndex.begin(), _assetIndex.end());
+}
+
 void Manifest::parseVersion(const std::string& versionUrl)
 {
+    if (loadBinaryFile(versionUrl, true))
+    {
+        return;
+    }
+    
     loadJson(versionUrl);
     
     if (_json.IsObject())
@@ -159,6 +483,20 @@ void Manifest::parseVersion(const std::string& versionUrl)
 
 void Manifest::parseFile(const std::string& manifestUrl)
 {
+    if (loadBinaryFile(manifestUrl, false))
+    {
+        if (_loaded)
+        {
+            // Register the local manifest root
+            size_t found = manifestUrl.find_last_of("/\\");
+            if (found != std::string::npos)
+            {
+                _manifestRoot = manifestUrl.substr(0, found+1);
+            }
+        }
+        return;
+    }
+    
     loadJson(manifestUrl);
 	
     if (!_json.HasParseError() && _json.IsObject())
@@ -196,7 +534,11 @@ bool Manifest::isLoaded() const
 
 void Manifest::setUpdating(bool updating)
 {
-    if (_loaded && _json.IsObject())
+    if (_loaded && _binary)
+    {
+        _updating = updating;
+    }
+    else if (_loaded && _json.IsObject())
     {
         if (_json.HasMember(KEY_UPDATING) && _json[KEY_UPDATING].IsBool())
         {
@@ -275,50 +617,39 @@ bool Manifest::versionGreater(const Manifest *b, const std::function<int(const s
 std::unordered_map<std::string, Manifest::AssetDiff> Manifest::genDiff(const Manifest *b) const
 {
     std::unordered_map<std::string, AssetDiff> diff_map;
-    const std::unordered_map<std::string, Asset> &bAssets = b->getAssets();
+    const std::vector<AssetIndexEntry> &indexA = _assetIndex;
+    const std::vector<AssetIndexEntry> &indexB = b->_assetIndex;
     
-    std::string key;
-    Asset valueA;
-    Asset valueB;
+    const auto addDiff = [&diff_map](const AssetIndexEntry &entry, DiffType type) {
+        AssetDiff diff;
+        diff.asset = *entry.asset;
+        diff.type = type;
+        diff_map.emplace(*entry.key, diff);
+    };
     
-    std::unordered_map<std::string, Asset>::const_iterator valueIt, it;
-    for (it = _assets.begin(); it != _assets.end(); ++it)
+    // Both indexes are sorted the same way, a key missing on one side is met before the next common key
+    size_t i = 0, j = 0;
+    while (i < indexA.size() || j < indexB.size())
     {
-        key = it->first;
-        valueA = it->second;
-        
-        // Deleted
-        valueIt = bAssets.find(key);
-        if (valueIt == bAssets.cend()) {
-            AssetDiff diff;
-            diff.asset = valueA;
-            diff.type = DiffType::DELETED;
-            diff_map.emplace(key, diff);
-            continue;
+        if (j == indexB.size() || (i < indexA.size() && indexA[i] < indexB[j]))
+        {
+            // Deleted
+            addDiff(indexA[i++], DiffType::DELETED);
         }
-        
-        // Modified
-        valueB = valueIt->second;
-        if (valueA.md5 != valueB.md5) {
-            AssetDiff diff;
-            diff.asset = valueB;
-            diff.type = DiffType::MODIFIED;
-            diff_map.emplace(key, diff);
+        else if (i == indexA.size() || indexB[j] < indexA[i])
+        {
+            // Added
+            addDiff(indexB[j++], DiffType::ADDED);
         }
-    }
-    
-    for (it = bAssets.begin(); it != bAssets.end(); ++it)
-    {
-        key = it->first;
-        valueB = it->second;
-        
-        // Added
-        valueIt = _assets.find(key);
-        if (valueIt == _assets.cend()) {
-            AssetDiff diff;
-            diff.asset = valueB;
-            diff.type = DiffType::ADDED;
-            diff_map.emplace(key, diff);
+        else
+        {
+            // Modified
+            if (indexA[i].asset->md5 != indexB[j].asset->md5)
+            {
+                addDiff(indexB[j], DiffType::MODIFIED);
+            }
+            ++i;
+            ++j;
         }
     }
     
@@ -392,6 +723,11 @@ const std::string& Manifest::getPackageUrl() const
     return _packageUrl;
 }
 
+const std::string& Manifest::getHashAlgorithm() const
+{
+    return _hashAlgorithm;
+}
+
 const std::string& Manifest::getManifestFileUrl() const
 {
     return _remoteManifestUrl;
@@ -478,7 +814,10 @@ void Manifest::clear()
     if (_loaded)
     {
         _assets.clear();
+        _assetIndex.clear();
         _searchPaths.clear();
+        _hashAlgorithm = "";
+        _binary = false;
         _loaded = false;
     }
 }
@@ -517,6 +856,22 @@ Manifest::Asset Manifest::parseAsset(const std::string &path, const rapidjson::V
     }
     else asset.downloadState = DownloadState::UNMARKED;
     
+    if ( json.HasMember(KEY_PATCHES) && json[KEY_PATCHES].IsObject() )
+    {
+        const rapidjson::Value& patches = json[KEY_PATCHES];
+        for (rapidjson::Value::ConstMemberIterator itr = patches.MemberBegin(); itr != patches.MemberEnd(); ++itr)
+        {
+            const rapidjson::Value& entry = itr->value;
+            if (entry.IsObject() && entry.HasMember(KEY_PATH) && entry[KEY_PATH].IsString())
+            {
+                ManifestPatch patch;
+                patch.path = entry[KEY_PATH].GetString();
+                patch.size = entry.HasMember(KEY_SIZE) && entry[KEY_SIZE].IsInt() ? entry[KEY_SIZE].GetInt() : 0;
+                asset.patches.emplace(itr->name.GetString(), patch);
+            }
+        }
+    }
+    
     return asset;
 }
 
@@ -590,12 +945,19 @@ void Manifest::loadManifest(const rapidjson::Document &json)
         }
     }
     
+    // Retrieve the algorithm of the asset md5 values
+    if ( json.HasMember(KEY_HASH_ALGORITHM) && json[KEY_HASH_ALGORITHM].IsString() )
+    {
+        _hashAlgorithm = json[KEY_HASH_ALGORITHM].GetString();
+    }
+    
     // Retrieve all assets
     if ( json.HasMember(KEY_ASSETS) )
     {
         const rapidjson::Value& assets = json[KEY_ASSETS];
         if (assets.IsObject())
         {
+            _assets.reserve(_assets.size() + assets.MemberCount());
             for (rapidjson::Value::ConstMemberIterator itr = assets.MemberBegin(); itr != assets.MemberEnd(); ++itr)
             {
                 std::string key = itr->name.GetString();
@@ -620,11 +982,19 @@ void Manifest::loadManifest(const rapidjson::Document &json)
         }
     }
     
+    buildAssetIndex();
+    _binary = false;
     _loaded = true;
 }
 
 void Manifest::saveToFile(const std::string &filepath)
 {
+    if (_binary)
+    {
+        saveToBinaryFile(filepath);
+        return;
+    }
+    
     rapidjson::StringBuffer buffer;
     rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
     _json.Accept(writer);
@@ -635,4 +1005,72 @@ void Manifest::saveToFile(const std::string &filepath)
         output << buffer.GetString() << std::endl;
 }
 
+bool Manifest::saveToBinaryFile(const std::string &filepath) const
+{
+    BinaryWriter writer;
+    BinaryHeader header = {};
+    memcpy(header.magic, BINARY_MANIFEST_MAGIC, BINARY_MANIFEST_MAGIC_SIZE);
+    header.formatVersion = BINARY_MANIFEST_VERSION;
+    header.flags = _updating ? BINARY_FLAG_UPDATING : 0;
+    header.version = writer.addString(_version);
+    header.packageUrl = writer.addString(_packageUrl);
+    header.remoteManifestUrl = writer.addString(_remoteManifestUrl);
+    header.remoteVersionUrl = writer.addString(_remoteVersionUrl);
+    header.engineVersion = writer.addString(_engineVer);
+    header.hashAlgorithm = writer.addString(_hashAlgorithm);
+    
+    std::vector<BinaryGroup> groups;
+    groups.reserve(_groups.size());
+    for (const auto &group : _groups)
+    {
+        auto it = _groupVer.find(group);
+        groups.push_back({writer.addString(group), writer.addString(it != _groupVer.end() ? it->second : "0")});
+    }
+    
+    std::vector<BinaryString> searchPaths;
+    searchPaths.reserve(_searchPaths.size());
+    for (const auto &path : _searchPaths)
+    {
+        searchPaths.push_back(writer.addString(path));
+    }
+    
+    std::vector<BinaryAsset> assets;
+    std::vector<BinaryPatchEntry> patches;
+    assets.reserve(_assetIndex.size());
+    for (const auto &entry : _assetIndex)
+    {
+        const Asset &asset = *entry.asset;
+        BinaryAsset item = {};
+        item.keyHash = entry.hash;
+        item.key = writer.addString(*entry.key);
+        item.path = writer.addString(asset.path);
+        item.md5 = writer.addString(asset.md5);
+        item.size = static_cast<uint32_t>(asset.size);
+        item.downloadState = asset.downloadState;
+        item.compressed = asset.compressed ? 1 : 0;
+        item.firstPatch = static_cast<uint32_t>(patches.size());
+        item.patchCount = static_cast<uint32_t>(asset.patches.size());
+        for (const auto &patch : asset.patches)
+        {
+            BinaryPatchEntry patchItem = {};
+            patchItem.baseMd5 = writer.addString(patch.first);
+            patchItem.path = writer.addString(patch.second.path);
+            patchItem.size = static_cast<uint32_t>(patch.second.size);
+            patches.push_back(patchItem);
+        }
+        assets.push_back(item);
+    }
+    
+    header.groups = writer.addSection(groups);
+    header.searchPaths = writer.addSection(searchPaths);
+    header.assets = writer.addSection(assets);
+    header.patches = writer.addSection(patches);
+    const std::string &data = writer.finish(&header);
+    
+    std::ofstream output(FileUtils::getInstance()->getSuitableFOpen(filepath), std::ofstream::out | std::ofstream::binary);
+    output.write(data.data(), data.size());
+    output.close();
+    return !output.fail();
+}
+
 NS_CC_EXT_END
@@ -27,6 +27,7 @@
 #ifndef __Manifest__
 #define __Manifest__
 
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -47,6 +48,15 @@ struct DownloadUnit
     std::string storagePath;
     std::string customId;
     float       size;
+    //! [Optional] A binary delta downloaded instead of srcUrl and applied to patchBasePath
+    std::string patchUrl;
+    std::string patchBasePath;
+};
+
+//! A binary delta of an asset from one of its previous versions, see BinaryPatch
+struct ManifestPatch {
+    std::string path;
+    float size;
 };
 
 struct ManifestAsset {
@@ -55,6 +65,8 @@ struct ManifestAsset {
     bool compressed;
     float size;
     int downloadState;
+    //! [Optional] The patches by the md5 of the version they apply to
+    std::unordered_map<std::string, ManifestPatch> patches;
 };
 
 typedef std::unordered_map<std::string, DownloadUnit> DownloadUnits;
@@ -100,6 +112,11 @@ public:
      */
     const std::string& getPackageUrl() const;
     
+    /** @brief Gets the algorithm the md5 values of the assets are computed with, "md5" or "xxh64" [Optional]
+     * The downloaded assets are hashed while they are written and compared with their md5 values when it's set.
+     */
+    const std::string& getHashAlgorithm() const;
+    
     /** @brief Gets remote manifest file url.
      */
     const std::string& getManifestFileUrl() const;
@@ -152,6 +169,17 @@ public:
      */
     void setUpdating(bool updating);
     
+    /** @brief Check whether the manifest was loaded from the binary format
+     */
+    bool isBinary() const { return _binary; };
+    
+    /** @brief Save the manifest in the binary format, which is loaded by mapping the file instead of parsing json.
+     * The files are recognized by their content, so a binary manifest can keep the name project.manifest.
+     * @param filepath Path of the file to write
+     * @return Whether the file has been written
+     */
+    bool saveToBinaryFile(const std::string &filepath) const;
+    
 protected:
     
     /** @brief Load the json file into local json object
@@ -164,6 +192,19 @@ protected:
      */
     void loadJsonFromString(const std::string& content);
     
+    /** @brief Load the file into this manifest if it is in the binary format
+     * @param url           Url of the file
+     * @param versionOnly   Only loads the version informations
+     * @return Whether the file is a binary manifest, even if it fails to be loaded
+     */
+    bool loadBinaryFile(const std::string& url, bool versionOnly);
+    
+    bool loadBinary(const unsigned char *bytes, size_t size, bool versionOnly);
+    
+    /** @brief Sort the assets by the hash of their keys for genDiff
+     */
+    void buildAssetIndex();
+    
     /** @brief Parse the version file information into this manifest
      * @param versionUrl Url of the local version file
      */
@@ -190,6 +231,7 @@ protected:
     bool versionGreater(const Manifest *b, const std::function<int(const std::string& versionA, const std::string& versionB)>& handle) const;
     
     /** @brief Generate difference between this Manifest and another.
+     * The assets of both manifests are sorted by the hash of their keys, so they are compared in a single pass.
      * @param b   The other manifest
      */
     std::unordered_map<std::string, AssetDiff> genDiff(const Manifest *b) const;
@@ -242,6 +284,15 @@ protected:
     
 private:
     
+    struct AssetIndexEntry
+    {
+        uint64_t hash;
+        const std::string *key;
+        const Asset *asset;
+        
+        bool operator<(const AssetIndexEntry &other) const { return hash != other.hash ? hash < other.hash : *key < *other.key; }
+    };
+    
     //! Indicate whether the version informations have been fully loaded
     bool _versionLoaded;
     
@@ -251,6 +302,9 @@ private:
     //! Indicate whether the manifest is updating and can be resumed in the future
     bool _updating;
     
+    //! Indicate whether the manifest was loaded from the binary format, it is saved in the same format
+    bool _binary;
+    
     //! Reference to the global file utils
     FileUtils *_fileUtils;
     
@@ -260,6 +314,9 @@ private:
     //! The remote package url
     std::string _packageUrl;
     
+    //! The algorithm of the asset md5 values [Optional]
+    std::string _hashAlgorithm;
+    
     //! The remote path of manifest file
     std::string _remoteManifestUrl;
     
@@ -281,6 +338,9 @@ private:
     //! Full assets list
     std::unordered_map<std::string, Asset> _assets;
     
+    //! The assets sorted by the XXH64 of their keys, then by their keys
+    std::vector<AssetIndexEntry> _assetIndex;
+    
     //! All search paths
     std::vector<std::string> _searchPaths;
     
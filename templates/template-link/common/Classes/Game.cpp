@@ -30,11 +30,29 @@
 #include "cocos/bindings/jswrapper/SeApi.h"
 #include "cocos/bindings/event/EventDispatcher.h"
 #include "cocos/bindings/manual/jsb_classtype.h"
+#include "cocos/base/Startup.h"
+#include "cocos/platform/FileUtils.h"
+#if USE_AUDIO
+#include "cocos/audio/include/AudioEngine.h"
+#endif
 
 Game::Game(int width, int height) : cc::Application(width, height) {}
 
 bool Game::init()
 {
+    // Work which doesn't touch the script engine runs on worker threads while V8 starts on this one.
+    cc::FileUtils::getInstance();
+    cc::Startup::runAsync("SearchPathIndex", []() {
+        cc::FileUtils::getInstance()->buildSearchPathIndexes();
+    });
+#if USE_AUDIO
+    cc::Startup::runAsync("AudioEngine", []() {
+        cc::AudioEngine::initImpl();
+    });
+#endif
+    // Packs are mapped and indexed the same way, they have to be mounted before the first file is read:
+    // cc::Startup::runAsync("AssetPacks", []() { cc::FileUtils::getInstance()->mountPack("assets.pack"); });
+
     cc::Application::init();
     
     se::ScriptEngine *se = se::ScriptEngine::getInstance();
@@ -54,6 +72,11 @@ bool Game::init()
     
     jsb_register_all_modules();
     
+    // scripts read files and may start audio from here on
+    cc::Startup::waitAll();
+    
+    // decoded on worker threads while the engine starts
+    jsb_prefetch_scripts({"jsb-adapter/jsb-builtin.js", "main.js"});
     se->start();
     
     se::AutoHandleScope hs;
@@ -26,6 +26,7 @@
 #include "AppDelegate.h"
 #import "ViewController.h"
 #include "platform/ios/View.h"
+#include "cocos/base/MemoryPressure.h"
 #include "cocos/bindings/event/EventDispatcher.h"
 
 #include "Game.h"
@@ -114,6 +115,13 @@ Game* game = nullptr;
 #pragma mark Memory management
 
 - (void)applicationDidReceiveMemoryWarning:(UIApplication *)application {
+    // iOS has a single kind of warning, a second one soon after the first means releasing caches wasn't enough
+    static CFTimeInterval lastWarningTime = 0;
+    const CFTimeInterval now = CACurrentMediaTime();
+    const bool isRepeated = lastWarningTime > 0 && now - lastWarningTime < 10.0;
+    lastWarningTime = now;
+
+    cc::MemoryPressure::notify(isRepeated ? cc::MemoryPressureLevel::CRITICAL : cc::MemoryPressureLevel::LOW);
     cc::EventDispatcher::dispatchMemoryWarningEvent();
 }
 
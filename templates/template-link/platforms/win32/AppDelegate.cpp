@@ -114,16 +114,6 @@ void AppDelegage::start()
     const DWORD _16ms = 16;
 
     // Main message loop:
-    LARGE_INTEGER nFreq;
-    LARGE_INTEGER nLast;
-    LARGE_INTEGER nNow;
-
-    LONGLONG actualInterval = 0LL; // actual frame internal
-    LONGLONG desiredInterval = 0LL; // desired frame internal, 1 / fps
-    LONG waitMS = 0L;
-
-    QueryPerformanceCounter(&nLast);
-    QueryPerformanceFrequency(&nFreq);
     se::ScriptEngine* se = se::ScriptEngine::getInstance();
 
    
@@ -131,8 +121,6 @@ void AppDelegage::start()
 
     while (!_quit)
     {
-        desiredInterval = (LONGLONG)(1.0 / _game->getPreferredFramesPerSecond() * nFreq.QuadPart);
-        
         resume = false;
         pause = false;
         while (_view->pollEvent(&_quit, &resume, &pause)) {}
@@ -140,25 +128,9 @@ void AppDelegage::start()
         if(pause) _game->onPause();
         if(resume) _game->onResume();
 
-        QueryPerformanceCounter(&nNow);
-        actualInterval = nNow.QuadPart - nLast.QuadPart;
-        if (actualInterval >= desiredInterval)
-        {
-            nLast.QuadPart = nNow.QuadPart;
-            _game->tick();
-            _view->swapbuffer();
-        }
-        else
-        {
-            // The precision of timer on Windows is set to highest (1ms) by 'timeBeginPeriod' from above code,
-            // but it's still not precise enough. For example, if the precision of timer is 1ms,
-            // Sleep(3) may make a sleep of 2ms or 4ms. Therefore, we subtract 1ms here to make Sleep time shorter.
-            // If 'waitMS' is equal or less than 1ms, don't sleep and run into next loop to
-            // boost CPU to next frame accurately.
-            waitMS = (desiredInterval - actualInterval) * 1000LL / nFreq.QuadPart - 1L;
-            if (waitMS > 1L)
-                Sleep(waitMS);
-        }
+        // tick() waits for the refresh of the display the frame starts on
+        _game->tick();
+        _view->swapbuffer();
     }
 
 
@@ -0,0 +1,100 @@
+#!/usr/bin/env python
+# Packs a directory into an asset pack read by cc::AssetPack, see cocos/platform/AssetPack.h for the layout.
+#
+# usage: asset_pack.py <directory> <output> [--store ext1,ext2]
+# Files are named by their path relative to the directory with '/' separators. Files whose extension is
+# stored or which don't shrink are kept uncompressed so they can be mapped in place, the rest is zlib compressed.
+
+import argparse
+import os
+import struct
+import zlib
+
+VERSION = 1
+HEADER = struct.Struct('<4sIIIQQQ')
+ENTRY = struct.Struct('<QQIIIHH')
+NONE, ZLIB = 0, 1
+# already compressed formats, inflating them would cost more than it saves
+DEFAULT_STORED = 'png,jpg,jpeg,webp,pvr,pkm,astc,ktx,ktx2,basis,mp3,ogg,m4a,wav'
+
+
+def fnv1a(name):
+    value = 0xcbf29ce484222325
+    for byte in bytearray(name):
+        value = ((value ^ byte) * 0x100000001b3) & 0xffffffffffffffff
+    return value
+
+
+def align(offset, alignment):
+    return (offset + alignment - 1) & ~(alignment - 1)
+
+
+def collect(root):
+    files = []
+    for folder, _, names in os.walk(root):
+        for name in names:
+            path = os.path.join(folder, name)
+            files.append((os.path.relpath(path, root).replace(os.sep, '/').encode('utf-8'), path))
+    return sorted(files)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Packs a directory into an asset pack.')
+    parser.add_argument('directory')
+    parser.add_argument('output')
+    parser.add_argument('--store', default=DEFAULT_STORED, help='extensions kept uncompressed')
+    args = parser.parse_args()
+    stored = set('.' + ext.strip().lower() for ext in args.store.split(',') if ext.strip())
+
+    files = collect(args.directory)
+    bucket_count = 1
+    while bucket_count < len(files):
+        bucket_count <<= 1
+    mask = bucket_count - 1
+
+    entries = []
+    for name, path in files:
+        with open(path, 'rb') as f:
+            data = f.read()
+        compression, payload = NONE, data
+        if os.path.splitext(path)[1].lower() not in stored and data:
+            deflated = zlib.compress(data, 9)
+            if len(deflated) < len(data):
+                compression, payload = ZLIB, deflated
+        entries.append([fnv1a(name), name, compression, payload, len(data)])
+    entries.sort(key=lambda entry: (entry[0] & mask, entry[1]))
+
+    buckets = [0] * (bucket_count + 1)
+    for entry in entries:
+        buckets[(entry[0] & mask) + 1] += 1
+    for i in range(bucket_count):
+        buckets[i + 1] += buckets[i]
+
+    buckets_offset = HEADER.size
+    entries_offset = align(buckets_offset + 4 * len(buckets), 8)
+    names_offset = entries_offset + ENTRY.size * len(entries)
+    names = b''.join(entry[1] for entry in entries)
+    # stored data is 16 byte aligned so it can be used in place
+    offset = align(names_offset + len(names), 16)
+
+    with open(args.output, 'wb') as out:
+        out.write(HEADER.pack(b'CCPK', VERSION, len(entries), bucket_count, buckets_offset, entries_offset, names_offset))
+        out.write(struct.pack('<%dI' % len(buckets), *buckets))
+        out.write(b'\0' * (entries_offset - out.tell()))
+        name_offset = 0
+        data_offsets = []
+        for value, name, compression, payload, size in entries:
+            data_offsets.append(offset)
+            out.write(ENTRY.pack(value, offset, len(payload), size, name_offset, len(name), compression))
+            name_offset += len(name)
+            offset = align(offset + len(payload), 16)
+        out.write(names)
+        for data_offset, entry in zip(data_offsets, entries):
+            out.write(b'\0' * (data_offset - out.tell()))
+            out.write(entry[3])
+
+    print('%d files packed into %s' % (len(entries), args.output))
+
+
+if __name__ == '__main__':
+    main()
@@ -804,6 +804,53 @@ class NativeFunction(object):
 
         self.min_args = index if found_default_arg else len(self.arguments)
 
+    # the scalar types V8 fast API calls take as they are, mapped to the types of the fast variant
+    FAST_CALL_TYPES = {
+        "bool": "bool",
+        "int": "int32_t",
+        "int32_t": "int32_t",
+        "unsigned int": "uint32_t",
+        "uint32_t": "uint32_t",
+        "uint": "uint32_t",
+        "float": "float",
+        "double": "double",
+    }
+
+    @property
+    def fast_call_arg_types(self):
+        # only plain instance functions returning nothing get a fast variant, the others are bound to the slow callback
+        if self.static or self.is_constructor or self.is_overloaded or not self.arguments:
+            return None
+        if self.ret_type.name != "void" or self.min_args != len(self.arguments):
+            return None
+        gen = self.current_class.generator if self.current_class else None
+        if gen is None or not gen.should_bind_fast_call(self.current_class.class_name):
+            return None
+        if self.current_class.is_getter_method(self.func_name) or self.current_class.is_setter_method(self.func_name):
+            return None
+        types = []
+        for arg in self.arguments:
+            if arg.is_pointer or arg.is_reference or arg.is_enum:
+                return None
+            fast_type = NativeFunction.FAST_CALL_TYPES.get(arg.to_string(gen))
+            if fast_type is None:
+                return None
+            types.append(fast_type)
+        return types
+
+    @property
+    def buffer_result_type(self):
+        # instance functions without arguments returning a listed struct also get a binding writing it into a typed array
+        if self.static or self.is_constructor or self.is_overloaded or self.arguments:
+            return None
+        gen = self.current_class.generator if self.current_class else None
+        if gen is None or self.ret_type.is_pointer:
+            return None
+        struct_name = self.ret_type.namespaced_class_name.split("::")[-1]
+        if struct_name not in gen.structs_returned_in_buffer:
+            return None
+        return struct_name
+
     def get_comment(self, comment):
         replaceStr = comment
 
@@ -888,6 +935,9 @@ class NativeOverloadedFunction(object):
         self.min_args = 100
         self.is_constructor = False
         self.is_overloaded = True
+        # overloads are told apart by the slow callback
+        self.fast_call_arg_types = None
+        self.buffer_result_type = None
         self.is_ctor = False
         self.current_class = None
         for m in func_array:
@@ -1358,6 +1408,8 @@ class Generator(object):
         self.headers = opts['headers'].split(' ')
         self.classes = opts['classes']
         self.classes_need_extend = opts['classes_need_extend']
+        self.classes_with_fast_calls = opts['classes_with_fast_calls']
+        self.structs_returned_in_buffer = [name for name in opts['structs_returned_in_buffer'] if name]
         self.classes_have_no_parents = opts['classes_have_no_parents'].split(' ')
         self.base_classes_to_skip = opts['base_classes_to_skip'].split(' ')
         self.abstract_classes = opts['abstract_classes'].split(' ')
@@ -1625,6 +1677,15 @@ class Generator(object):
                 return True
         return False
 
+    def should_bind_fast_call(self, class_name):
+        """
+        returns True if the simple functions of the class get V8 fast API call variants
+        """
+        for key in self.classes_with_fast_calls:
+            if key and re.match("^" + key + "$", class_name):
+                return True
+        return False
+
     def sorted_classes(self):
         '''
         sorted classes in order of inheritance
@@ -1950,6 +2011,8 @@ def main():
                 'replace_headers': config.get(s, 'replace_headers') if config.has_option(s, 'replace_headers') else None,
                 'classes': config.get(s, 'classes').split(' '),
                 'classes_need_extend': config.get(s, 'classes_need_extend').split(' ') if config.has_option(s, 'classes_need_extend') else [],
+                'classes_with_fast_calls': config.get(s, 'classes_with_fast_calls').split(' ') if config.has_option(s, 'classes_with_fast_calls') else [],
+                'structs_returned_in_buffer': config.get(s, 'structs_returned_in_buffer').split(' ') if config.has_option(s, 'structs_returned_in_buffer') else [],
                 'clang_args': (config.get(s, 'extra_arguments', 0, dict(userconfig.items('DEFAULT'))) or "").split(" "),
                 'target': os.path.join(workingdir, "targets", t),
                 'outdir': outdir,
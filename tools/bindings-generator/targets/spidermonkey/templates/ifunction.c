@@ -89,3 +89,39 @@ SE_BIND_PROP_SET(${signature_name})
 #else
 SE_BIND_FUNC(${signature_name})
 #end if
+#if $buffer_result_type
+
+static bool ${signature_name}_toBuffer(se::State& s)
+{
+    ${namespaced_class_name}* cobj = SE_THIS_OBJECT<${namespaced_class_name}>(s);
+    SE_PRECONDITION2(cobj, false, "${signature_name}_toBuffer : Invalid Native Object");
+    CC_UNUSED bool ok = nativevalue_to_buffer(cobj->${func_name}(), s.args(), 0);
+    SE_PRECONDITION2(ok, false, "${signature_name}_toBuffer : Error processing arguments");
+    return true;
+}
+SE_BIND_FUNC(${signature_name}_toBuffer)
+#end if
+#if $fast_call_arg_types
+    #set $count = 0
+    #set fast_params = []
+    #set fast_args = []
+    #for $fast_type in $fast_call_arg_types
+        #set fast_params += [$fast_type + " arg" + str(count)]
+        #set fast_args += ["arg" + str(count)]
+        #set $count = $count + 1
+    #end for
+    #set $fast_param_list = ", ".join($fast_params)
+    #set $fast_arg_list = ", ".join($fast_args)
+\#if SE_ENABLE_FAST_API_CALLS
+static void ${signature_name}_fast(v8::Local<v8::Object> receiver, ${fast_param_list}, v8::FastApiCallbackOptions& options)
+{
+    auto* cobj = se::internal::getFastCallPrivate<${namespaced_class_name}>(receiver);
+    if (!cobj) {
+        options.fallback = true;
+        return;
+    }
+    cobj->${func_name}(${fast_arg_list});
+}
+SE_BIND_FAST_FUNC(${signature_name}_fast)
+\#endif
+#end if
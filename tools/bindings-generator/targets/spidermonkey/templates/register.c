@@ -102,12 +102,26 @@ bool js_register_${generator.prefix}_${current_class.class_name}(se::Object* obj
     #set tmp_getter = "nullptr" if m["getter"] is None else "_SE(" + m["getter"].signature_name + ")"
     #set tmp_setter = "nullptr" if m["setter"] is None else "_SE(" + m["setter"].signature_name + ")"
     cls->defineProperty("${m.name}", ${tmp_getter}, ${tmp_setter});
+    #if m["getter"] is not None and m["getter"].buffer_result_type
+    cls->defineFunction("${m['getter'].func_name}ToBuffer", _SE(${m["getter"].signature_name}_toBuffer));
+    #end if
 #end for
 #for m in methods
     #if not $current_class.skip_bind_function(m)
     #set fn = m['impl']
+    #if $fn.fast_call_arg_types
+\#if SE_ENABLE_FAST_API_CALLS
+    cls->defineFunction("${m['name']}", _SE(${fn.signature_name}), _SE_FAST(${fn.signature_name}_fast));
+\#else
+    cls->defineFunction("${m['name']}", _SE(${fn.signature_name}));
+\#endif
+    #else
     cls->defineFunction("${m['name']}", _SE(${fn.signature_name}));
     #end if
+    #if $fn.buffer_result_type
+    cls->defineFunction("${m['name']}ToBuffer", _SE(${fn.signature_name}_toBuffer));
+    #end if
+    #end if
 #end for
 #if $generator.in_listed_extend_classed($current_class.class_name) and $has_constructor
     cls->defineFunction("ctor", _SE(js_${generator.prefix}_${current_class.class_name}_ctor));
@@ -0,0 +1,154 @@
+#!/usr/bin/env python
+#coding=utf-8
+#
+# ./compile-shaders.py VARIANTS [VARIANTS ...] -o OUTPUT_DIR
+#
+# Compiles the shader variants saved by pipeline::ShaderVariantCollector::save()
+# to SPIR-V ahead of time, so that the Vulkan and Metal backends skip glslang at
+# runtime. Copy OUTPUT_DIR into the assets of the build as precompiled-shaders/,
+# gfx::Device::loadPrecompiledShader() looks the blobs up there.
+#
+# Requires glslangValidator, from the Vulkan SDK or the glslang releases.
+#
+
+from __future__ import print_function
+
+import argparse
+import os
+import struct
+import subprocess
+import sys
+import tempfile
+
+VARIANT_FILE_MAGIC = 0x43435356 # 'CCSV'
+VARIANT_FILE_VERSION = 1
+
+# gfx::ShaderStageFlagBit to the stage names of glslangValidator
+STAGES = {0x1: 'vert', 0x2: 'tesc', 0x4: 'tese', 0x8: 'geom', 0x10: 'frag', 0x20: 'comp'}
+
+# the version line each backend puts in front of the sources, see CCVKCmdFuncCreateShader() and
+# mu::compileGLSLShader2Msl(); Vulkan 1.0 SPIR-V is accepted by every device
+BACKENDS = {
+    'vk': b'#version 450\n',
+    'mtl': b'#version 310 es\n',
+}
+
+
+class Reader(object):
+    def __init__(self, data):
+        self._data = data
+        self._offset = 0
+
+    def read_uint(self):
+        if self._offset + 4 > len(self._data):
+            raise ValueError('the file is cut short')
+        value, = struct.unpack_from('<I', self._data, self._offset)
+        self._offset += 4
+        return value
+
+    def read_string(self):
+        size = self.read_uint()
+        if self._offset + size > len(self._data):
+            raise ValueError('the file is cut short')
+        value = self._data[self._offset:self._offset + size]
+        self._offset += size
+        return value
+
+
+def read_variants(path):
+    """Returns the name and the (stage, source) list of the variants in the file, as written by writeShaderInfo()."""
+    with open(path, 'rb') as f:
+        reader = Reader(f.read())
+    if reader.read_uint() != VARIANT_FILE_MAGIC or reader.read_uint() != VARIANT_FILE_VERSION:
+        raise ValueError('%s holds no shader variants of version %d' % (path, VARIANT_FILE_VERSION))
+
+    variants = []
+    for _ in range(reader.read_uint()):
+        name = reader.read_string().decode('utf-8', 'replace')
+        stages = [(reader.read_uint(), reader.read_string()) for _ in range(reader.read_uint())]
+        for _ in range(reader.read_uint()): # attributes
+            reader.read_string()
+            for _ in range(5):
+                reader.read_uint()
+        for _ in range(reader.read_uint()): # blocks
+            reader.read_uint()
+            reader.read_uint()
+            reader.read_string()
+            for _ in range(reader.read_uint()):
+                reader.read_string()
+                reader.read_uint()
+                reader.read_uint()
+            reader.read_uint()
+        for _ in range(reader.read_uint()): # samplers
+            reader.read_uint()
+            reader.read_uint()
+            reader.read_string()
+            reader.read_uint()
+            reader.read_uint()
+        variants.append((name, stages))
+    return variants
+
+
+def hash_stage(stage, source):
+    """FNV-1a of the stage and the source, as hashShaderStage() in GFXDevice.cpp."""
+    value = 14695981039346656037
+    for byte in bytearray(struct.pack('<I', stage) + source):
+        value = ((value ^ byte) * 1099511628211) & 0xffffffffffffffff
+    return value
+
+
+def compile_stage(glslang, prefix, stage, source, output):
+    handle, path = tempfile.mkstemp(suffix='.' + STAGES[stage])
+    try:
+        with os.fdopen(handle, 'wb') as f:
+            f.write(prefix + source)
+        command = [glslang, '-V', '--target-env', 'vulkan1.0', '-S', STAGES[stage], '-o', output, path]
+        process = subprocess.Popen(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+        log = process.communicate()[0]
+        if process.returncode != 0:
+            print(log.decode('utf-8', 'replace'), file=sys.stderr)
+            return False
+        return True
+    finally:
+        os.remove(path)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compiles recorded shader variants to SPIR-V ahead of time.')
+    parser.add_argument('variants', nargs='+', help='files saved by ShaderVariantCollector::save()')
+    parser.add_argument('-o', '--output', required=True, help='directory to write the blobs to')
+    parser.add_argument('--backends', default='vk,mtl', help='comma separated, out of %s' % ', '.join(sorted(BACKENDS)))
+    parser.add_argument('--glslang', default='glslangValidator', help='path to glslangValidator')
+    args = parser.parse_args()
+
+    backends = [backend for backend in args.backends.split(',') if backend]
+    for backend in backends:
+        if backend not in BACKENDS:
+            parser.error('unknown backend %s' % backend)
+        if not os.path.isdir(os.path.join(args.output, backend)):
+            os.makedirs(os.path.join(args.output, backend))
+
+    # variants recorded on several devices share most of their stages
+    stages = {}
+    for path in args.variants:
+        for name, variant_stages in read_variants(path):
+            for stage, source in variant_stages:
+                if stage not in STAGES:
+                    print('%s: skipping a stage of unknown type %d' % (name, stage), file=sys.stderr)
+                    continue
+                stages.setdefault((stage, source), name)
+
+    failed = 0
+    for (stage, source), name in sorted(stages.items(), key=lambda item: item[1]):
+        file_name = '%016x.spv' % hash_stage(stage, source)
+        for backend in backends:
+            if not compile_stage(args.glslang, BACKENDS[backend], stage, source, os.path.join(args.output, backend, file_name)):
+                print('%s: failed to compile the %s stage for %s' % (name, STAGES[stage], backend), file=sys.stderr)
+                failed += 1
+
+    print('compiled %d stages for %s, %d failed' % (len(stages), ', '.join(backends), failed))
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
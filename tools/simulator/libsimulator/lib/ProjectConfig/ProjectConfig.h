@@ -61,6 +61,7 @@ using namespace std;
 
 #define kProjectConfigConsolePort   6010
 #define kProjectConfigUploadPort    6020
+#define kProjectConfigTelemetryPort 6030
 #define kProjectConfigDebugPort     5086
 
 class CC_LIBSIM_DLL ProjectConfig
@@ -116,6 +116,10 @@ void ConfigParser::readConfig(const string &filepath)
     {
         setUploadPort(objectInitView["uploadPort"].GetUint());
     }
+    if (objectInitView.HasMember("telemetryPort"))
+    {
+        setTelemetryPort(objectInitView["telemetryPort"].GetUint());
+    }
     if (objectInitView.HasMember("isWindowTop") && objectInitView["isWindowTop"].IsBool())
     {
         _isWindowTop= objectInitView["isWindowTop"].GetBool();
@@ -131,6 +135,7 @@ _isLandscape(true),
 _isWindowTop(false),
 _consolePort(kProjectConfigConsolePort),
 _uploadPort(kProjectConfigUploadPort),
+_telemetryPort(kProjectConfigTelemetryPort),
 _debugPort(kProjectConfigDebugger),
 _viewName("simulator"),
 _entryfile(""),
@@ -188,6 +193,13 @@ void ConfigParser::setUploadPort(int port)
         _uploadPort = port;
     }
 }
+void ConfigParser::setTelemetryPort(int port)
+{
+    if (port > 0)
+    {
+        _telemetryPort = port;
+    }
+}
 void ConfigParser::setDebugPort(int port)
 {
     if (port > 0)
@@ -203,6 +215,10 @@ int ConfigParser::getUploadPort()
 {
     return _uploadPort;
 }
+int ConfigParser::getTelemetryPort()
+{
+    return _telemetryPort;
+}
 int ConfigParser::getDebugPort()
 {
     return _debugPort;
@@ -55,8 +55,10 @@ public:
     const SimulatorScreenSize getScreenSize(int index);
     void setConsolePort(int port);
     void setUploadPort(int port);
+    void setTelemetryPort(int port);
     int getConsolePort();
     int getUploadPort();
+    int getTelemetryPort();
     int getDebugPort();
     bool isLanscape();
     bool isWindowTop();
@@ -80,6 +82,7 @@ private:
     bool _isWaitForConnect;
     int _consolePort;
     int _uploadPort;
+    int _telemetryPort;
     int _debugPort;
     string _bindAddress;
     
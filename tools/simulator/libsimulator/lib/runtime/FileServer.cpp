@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "Runtime.h"
 #include "zlib.h"
 #include "ConfigParser.h"
+#include "xxhash/xxhash.h"
 
 // header files for directory operation
 #ifdef _WIN32
@@ -36,6 +37,8 @@ THE SOFTWARE.
 #include <sys/stat.h>
 #endif
 
+#include <algorithm>
+
 #if CC_PLATFORM == CC_PLATFORM_ANDROID
     #ifndef bzero
         #define bzero(a, b) memset(a, 0, b);
@@ -47,6 +50,55 @@ THE SOFTWARE.
 
 #define PROTO_START "RuntimeSend:"
 
+// smallest block of delta sync, larger files get larger blocks
+#define MIN_DELTA_BLOCK_SIZE 65536
+
+namespace
+{
+    uint64_t blockHash(const char *data, size_t size)
+    {
+        // the hash the runtime already links, two seeds for a 64 bits result
+        return ((uint64_t)XXH32(data, (int)size, 0) << 32) | XXH32(data, (int)size, 0x9e3779b1);
+    }
+
+    bool readFile(const std::string &path, std::string &content)
+    {
+        content.clear();
+        FILE *fp = fopen(path.c_str(), "rb");
+        if (!fp)
+        {
+            return false;
+        }
+        fseek(fp, 0, SEEK_END);
+        long size = ftell(fp);
+        fseek(fp, 0, SEEK_SET);
+        content.resize(size > 0 ? size : 0);
+        bool isRead = content.empty() || fread(&content[0], 1, content.size(), fp) == content.size();
+        fclose(fp);
+        return isRead;
+    }
+
+    bool replaceFile(const std::string &from, const std::string &to)
+    {
+#ifdef _WIN32
+        return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+        return rename(from.c_str(), to.c_str()) == 0;
+#endif
+    }
+
+    bool readUint32(const std::string &data, size_t &offset, uint32_t &value)
+    {
+        if (offset + sizeof(value) > data.size())
+        {
+            return false;
+        }
+        memcpy(&value, data.data() + offset, sizeof(value));
+        offset += sizeof(value);
+        return true;
+    }
+}
+
 FileServer* FileServer::s_sharedFileServer = nullptr;
 FileServer* FileServer::getShareInstance()
 {
@@ -324,7 +376,15 @@ void FileServer::loopReceiveFile()
 
         RecvBufStruct recvDataBuf;
         recvDataBuf.fd = fd;
+        recvDataBuf.protoNum = protonum.uint16_type;
         recvDataBuf.fileProto.ParseFromString(protoBuf);
+        if (PROTONUM::BLOCKHASHPROTO == recvDataBuf.protoNum)
+        {
+            _recvBufListMutex.lock();
+            _recvBufList.push_back(recvDataBuf);
+            _recvBufListMutex.unlock();
+            continue;
+        }
         if (1 == recvDataBuf.fileProto.package_seq())
         {
             _recvErrorFile = "";
@@ -414,11 +474,49 @@ void FileServer::loopWriteFile()
         std::string filename = recvDataBuf.fileProto.file_name();
         std::string fullfilename = _writePath;
         fullfilename += filename;
+        if (PROTONUM::BLOCKHASHPROTO == recvDataBuf.protoNum)
+        {
+            // queued behind the writes received before, so these are the hashes of the latest version
+            addBlockHashResponse(recvDataBuf.fd, filename, fullfilename);
+            continue;
+        }
         _fileNameMutex.lock();
         _strFileName = filename;
         _fileNameMutex.unlock();
         //cc::log("WriteFile:: fullfilename = %s",filename.c_str());
         createDir(fullfilename.substr(0, fullfilename.find_last_of("/")).c_str());
+
+        if (PROTONUM::DELTAPROTO == recvDataBuf.protoNum)
+        {
+            std::string content;
+            if (!applyDelta(fullfilename, recvDataBuf.contentBuf, content))
+            {
+                addResponse(recvDataBuf.fd, filename, runtime::FileSendComplete::RESULTTYPE::FileSendComplete_RESULTTYPE_FWRITE_ERROR, -1);
+                continue;
+            }
+
+            // written aside and moved over the old file, the game never loads half of it
+            std::string tempfilename = fullfilename + ".tmp";
+            FILE *fp = fopen(tempfilename.c_str(), "wb");
+            if (nullptr == fp)
+            {
+                addResponse(recvDataBuf.fd, filename, runtime::FileSendComplete::RESULTTYPE::FileSendComplete_RESULTTYPE_FOPEN_ERROR, errno);
+                continue;
+            }
+            bool isWritten = content.empty() || fwrite(content.c_str(), sizeof(char), content.size(), fp) == content.size();
+            int err = errno;
+            fclose(fp);
+            if (!isWritten || !replaceFile(tempfilename, fullfilename))
+            {
+                remove(tempfilename.c_str());
+                addResponse(recvDataBuf.fd, filename, runtime::FileSendComplete::RESULTTYPE::FileSendComplete_RESULTTYPE_FWRITE_ERROR, isWritten ? errno : err);
+                continue;
+            }
+
+            addResFileInfo(filename.c_str(), recvDataBuf.fileProto.modified_time());
+            addResponse(recvDataBuf.fd, filename, runtime::FileSendComplete::RESULTTYPE::FileSendComplete_RESULTTYPE_SUCCESS, 0);
+            continue;
+        }
         
         FILE *fp= nullptr;
         if (1 == recvDataBuf.fileProto.package_seq())
@@ -478,6 +576,7 @@ void FileServer::addResponse(int fd, std::string filename, int errortype, int er
 
     ResponseStruct responseBuf;
     responseBuf.fd = fd;
+    responseBuf.protoNum = PROTONUM::FILESENDCOMPLETE;
     responseBuf.fileResponseProto.set_file_name(filename.c_str());
     responseBuf.fileResponseProto.set_result((::runtime::FileSendComplete_RESULTTYPE)errortype);
     responseBuf.fileResponseProto.set_error_num(errornum);
@@ -488,6 +587,90 @@ void FileServer::addResponse(int fd, std::string filename, int errortype, int er
     _responseBufListMutex.unlock();
 }
 
+void FileServer::addBlockHashResponse(int fd, const std::string &filename, const std::string &fullfilename)
+{
+    std::string content;
+    readFile(fullfilename, content);
+
+    // name, block size, count and the hashes have to fit the 16 bits length of the header
+    uint16_t nameLength = (uint16_t)std::min<size_t>(filename.size(), 1024);
+    size_t maxBlocks = (0xffff - sizeof(uint16_t) - nameLength - 2 * sizeof(uint32_t)) / sizeof(uint64_t);
+    uint32_t blockSize = MIN_DELTA_BLOCK_SIZE;
+    while ((content.size() + blockSize - 1) / blockSize > maxBlocks)
+    {
+        blockSize *= 2;
+    }
+    uint32_t blockCount = (uint32_t)((content.size() + blockSize - 1) / blockSize);
+
+    ResponseStruct responseBuf;
+    responseBuf.fd = fd;
+    responseBuf.protoNum = PROTONUM::BLOCKHASHRESULT;
+    std::string &payload = responseBuf.payload;
+    payload.reserve(sizeof(nameLength) + nameLength + 2 * sizeof(uint32_t) + blockCount * sizeof(uint64_t));
+    payload.append((const char*)&nameLength, sizeof(nameLength));
+    payload.append(filename.c_str(), nameLength);
+    payload.append((const char*)&blockSize, sizeof(blockSize));
+    payload.append((const char*)&blockCount, sizeof(blockCount));
+    for (uint32_t i = 0; i < blockCount; ++i)
+    {
+        size_t offset = (size_t)i * blockSize;
+        uint64_t hash = blockHash(content.c_str() + offset, std::min<size_t>(blockSize, content.size() - offset));
+        payload.append((const char*)&hash, sizeof(hash));
+    }
+
+    _responseBufListMutex.lock();
+    _responseBufList.push_back(responseBuf);
+    _responseBufListMutex.unlock();
+}
+
+bool FileServer::applyDelta(const std::string &fullfilename, const std::string &delta, std::string &content)
+{
+    std::string oldContent;
+    readFile(fullfilename, oldContent);
+
+    size_t offset = 0;
+    uint32_t blockSize = 0;
+    if (!readUint32(delta, offset, blockSize) || blockSize == 0)
+    {
+        return false;
+    }
+
+    content.clear();
+    while (offset < delta.size())
+    {
+        char op = delta[offset++];
+        uint32_t first = 0, count = 0;
+        if (op == 'C')
+        {
+            if (!readUint32(delta, offset, first) || !readUint32(delta, offset, count))
+            {
+                return false;
+            }
+            uint64_t begin = (uint64_t)first * blockSize;
+            uint64_t end = std::min<uint64_t>(begin + (uint64_t)count * blockSize, oldContent.size());
+            if (begin >= end)
+            {
+                return false;
+            }
+            content.append(oldContent, (size_t)begin, (size_t)(end - begin));
+        }
+        else if (op == 'D')
+        {
+            if (!readUint32(delta, offset, count) || offset + count > delta.size())
+            {
+                return false;
+            }
+            content.append(delta, offset, count);
+            offset += count;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 void FileServer::loopResponse()
 {
 	_responseRunning = true;
@@ -506,6 +689,12 @@ void FileServer::loopResponse()
         ResponseStruct responseBuf = _responseBufList.front();
         _responseBufList.pop_front();
         _responseBufListMutex.unlock();
+        if (PROTONUM::FILESENDCOMPLETE != responseBuf.protoNum)
+        {
+            sendResponse(responseBuf.fd, responseBuf.protoNum, responseBuf.payload);
+            continue;
+        }
+
         //send response
         std::string responseString;
         runtime::FileSendComplete  fileSendProtoComplete;
@@ -513,27 +702,31 @@ void FileServer::loopResponse()
         fileSendProtoComplete.set_result(responseBuf.fileResponseProto.result());
         fileSendProtoComplete.set_error_num(responseBuf.fileResponseProto.error_num());
         fileSendProtoComplete.SerializeToString(&responseString);
-        char dataBuf[1024] = {0};
-        struct ResponseHeaderStruct
-        {
-            char startFlag[13]; // needs to store PROTO_START, which is 12+NULL long
-            unsigned short protoNum;
-            unsigned short protoBufLen;
-        };
-        ResponseHeaderStruct responseHeader;
-        strcpy(responseHeader.startFlag, PROTO_START);
-        responseHeader.protoNum = PROTONUM::FILESENDCOMPLETE;
-        responseHeader.protoBufLen = (unsigned short) responseString.size();
-        memcpy(dataBuf, &responseHeader, sizeof(responseHeader));
-        memcpy(dataBuf + sizeof(responseHeader), responseString.c_str(), responseString.size());
-        
-        sendBuf(responseBuf.fd, dataBuf, sizeof(responseHeader) + responseString.size());
+        sendResponse(responseBuf.fd, PROTONUM::FILESENDCOMPLETE, responseString);
         CC_LOG_DEBUG("responseFile:%s,result:%d", fileSendProtoComplete.file_name().c_str(), fileSendProtoComplete.result());
     }
 
 	_responseRunning = false;
 }
 
+void FileServer::sendResponse(int fd, int protoNum, const std::string &payload)
+{
+    struct ResponseHeaderStruct
+    {
+        char startFlag[13]; // needs to store PROTO_START, which is 12+NULL long
+        unsigned short protoNum;
+        unsigned short protoBufLen;
+    };
+    ResponseHeaderStruct responseHeader;
+    strcpy(responseHeader.startFlag, PROTO_START);
+    responseHeader.protoNum = (unsigned short) protoNum;
+    responseHeader.protoBufLen = (unsigned short) payload.size();
+
+    std::string dataBuf((const char*)&responseHeader, sizeof(responseHeader));
+    dataBuf += payload;
+    sendBuf(fd, dataBuf.c_str(), dataBuf.size());
+}
+
 bool createDir(const char *sPathName)
 {
     char   DirName[256]={0};
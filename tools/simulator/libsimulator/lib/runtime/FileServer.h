@@ -88,12 +88,31 @@ private:
     void loopWriteFile();
     void loopResponse();
     void addResponse(int fd, std::string filename,int errortype,int errornum);
+    void addBlockHashResponse(int fd, const std::string &filename, const std::string &fullfilename);
+    bool applyDelta(const std::string &fullfilename, const std::string &delta, std::string &content);
+    void sendResponse(int fd, int protoNum, const std::string &payload);
+
+    /*
+     Delta sync: the IDE sends BLOCKHASHPROTO, a FileSendProtos with only file_name set, and gets BLOCKHASHRESULT:
+       uint16 name length, name, uint32 block size, uint32 block count, uint64 hash of each block of the file
+     on the device (no blocks when it is missing). A block hash is XXH32 of seed 0 in the high word and XXH32 of
+     seed 0x9e3779b1 in the low one, the block size grows with the file so the result fits a header.
+     It then sends DELTAPROTO, a single package FileSendProtos whose content, once uncompressed, is the uint32
+     block size of the hashes followed by a list of
+       'C', uint32 first block, uint32 block count     copies blocks of the file on the device
+       'D', uint32 length, bytes                       new data
+     The new file replaces the old one only once complete. FWRITE_ERROR with error_num -1 means the delta did
+     not match the file on the device, the IDE sends the whole file instead. Integers are little endian.
+    */
     enum PROTONUM
     {
         FILEPROTO = 1,
         FILESENDCOMPLETE = 2,
         DIRPROTO = 3,
-        DIRSENDCOMPLETE = 4
+        DIRSENDCOMPLETE = 4,
+        BLOCKHASHPROTO = 5,
+        BLOCKHASHRESULT = 6,
+        DELTAPROTO = 7
     };
     
     struct RecvBufStruct
@@ -101,12 +120,15 @@ private:
         runtime::FileSendProtos fileProto;
         std::string contentBuf;
         int fd;
+        int protoNum;
     };
     
     struct ResponseStruct
     {
         runtime::FileSendComplete fileResponseProto;
         int fd;
+        int protoNum;
+        std::string payload; // sent as is unless protoNum is FILESENDCOMPLETE
     };
     
     // file descriptor: socket, console, etc.
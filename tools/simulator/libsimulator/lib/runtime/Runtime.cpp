@@ -26,6 +26,7 @@ THE SOFTWARE.
 
 #include "Runtime.h"
 #include "FileServer.h"
+#include "TelemetryServer.h"
 #include "cocos2d.h"
 #include "ConfigParser.h"
 #include "RuntimeProtocol.h"
@@ -245,6 +246,9 @@ void RuntimeEngine::start()
     }
 
     setupRuntime();
+
+    // counters and timings for a viewer on the desktop, see TelemetryServer.h
+    TelemetryServer::getShareInstance()->listenOnTCP(ConfigParser::getInstance()->getTelemetryPort());
     //startScript("jsb-adapter/jsb-builtin.js");
     //startScript("");
 }
@@ -261,6 +265,7 @@ void RuntimeEngine::end()
         CC_SAFE_DELETE(it->second);
     }
     FileServer::getShareInstance()->stop();
+    TelemetryServer::purge();
     ConfigParser::purge();
     FileServer::purge();
 }
@@ -0,0 +1,445 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "TelemetryServer.h"
+#include "FileServer.h"
+#include "Runtime.h"
+#include "ConfigParser.h"
+#include "json/document.h"
+#include "json/stringbuffer.h"
+#include "json/writer.h"
+
+#include "base/FrameStats.h"
+#include "base/Profiler.h"
+#include "base/Scheduler.h"
+#include "base/memory/MemTracker.h"
+#include "platform/Application.h"
+#include "renderer/pipeline/RenderFlow.h"
+#include "renderer/pipeline/RenderPipeline.h"
+#include "renderer/pipeline/RenderStage.h"
+
+#include <algorithm>
+
+#if (CC_PLATFORM == CC_PLATFORM_WINDOWS)
+#define closeSocket(fd) closesocket(fd)
+#else
+#include <sys/select.h>
+#define closeSocket(fd) close(fd)
+#endif
+
+#ifdef MSG_NOSIGNAL
+#define SEND_FLAGS MSG_NOSIGNAL
+#else
+#define SEND_FLAGS 0
+#endif
+
+// select timeout of the receive thread, how long stop() may wait for it
+#define RECEIVE_TIMEOUT_US 100000
+
+TelemetryServer* TelemetryServer::s_sharedTelemetryServer = nullptr;
+TelemetryServer* TelemetryServer::getShareInstance()
+{
+    if (s_sharedTelemetryServer == nullptr)
+    {
+        s_sharedTelemetryServer = new TelemetryServer;
+    }
+    return s_sharedTelemetryServer;
+}
+
+void TelemetryServer::purge()
+{
+    CC_SAFE_DELETE(s_sharedTelemetryServer);
+}
+
+TelemetryServer::TelemetryServer() :
+_listenfd(-1),
+_clientfd(-1),
+_endThread(false),
+_droppedPackets(0),
+_interval(1),
+_captureFrames(0),
+_isMemoryRequested(false),
+_gpuTimingRequest(-1),
+_frame(0),
+_captureFramesLeft(0)
+{
+}
+
+TelemetryServer::~TelemetryServer()
+{
+    stop();
+}
+
+bool TelemetryServer::listenOnTCP(int port)
+{
+    int listenfd = -1, n;
+    const int on = 1;
+    struct addrinfo hints, *res, *ressave;
+    char serv[30];
+
+    snprintf(serv, sizeof(serv)-1, "%d", port);
+    serv[sizeof(serv)-1] = 0;
+
+    bzero(&hints, sizeof(struct addrinfo));
+    hints.ai_flags = AI_PASSIVE;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+
+#if (CC_PLATFORM == CC_PLATFORM_WINDOWS)
+    WSADATA wsaData;
+    n = WSAStartup(MAKEWORD(2, 2),&wsaData);
+#endif
+
+    if ((n = getaddrinfo(NULL, serv, &hints, &res)) != 0)
+    {
+        fprintf(stderr, "net_listen error for %s: %s", serv, gai_strerror(n));
+        return false;
+    }
+
+    ressave = res;
+    do {
+        listenfd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+        if (listenfd < 0)
+            continue;
+
+        setsockopt(listenfd, SOL_SOCKET, SO_REUSEADDR, (const char*)&on, sizeof(on));
+
+        auto address = ConfigParser::getInstance()->getBindAddress();
+        if (address.length() > 0 && res->ai_family == AF_INET)
+        {
+            struct sockaddr_in *sin = (struct sockaddr_in*) res->ai_addr;
+            inet_pton(res->ai_family, address.c_str(), (void*)&sin->sin_addr);
+        }
+
+        if (::bind(listenfd, res->ai_addr, res->ai_addrlen) == 0)
+            break;
+
+        closeSocket(listenfd);
+    } while ((res = res->ai_next) != NULL);
+
+    if (res == NULL)
+    {
+        perror("net_listen:");
+        freeaddrinfo(ressave);
+        return false;
+    }
+    freeaddrinfo(ressave);
+
+    listen(listenfd, 1);
+    CC_LOG_DEBUG("Telemetry: listening on port %d", port);
+
+    _listenfd = listenfd;
+    _endThread = false;
+    _receiveThread = std::thread(std::bind(&TelemetryServer::loopReceive, this));
+    _sendThread = std::thread(std::bind(&TelemetryServer::loopSend, this));
+
+    cc::Application::getInstance()->getScheduler()->schedule(std::bind(&TelemetryServer::onFrame, this, std::placeholders::_1),
+                                                              this, 0, false, "telemetry");
+    return true;
+}
+
+void TelemetryServer::stop()
+{
+    if (_listenfd < 0)
+    {
+        return;
+    }
+
+    auto scheduler = cc::Application::getInstance()->getScheduler();
+    if (scheduler)
+    {
+        scheduler->unschedule("telemetry", this);
+    }
+
+    _endThread = true;
+    _packetListCondition.notify_all();
+    if (_receiveThread.joinable())
+    {
+        _receiveThread.join();
+    }
+    if (_sendThread.joinable())
+    {
+        _sendThread.join();
+    }
+
+    closeClient();
+    closeSocket(_listenfd);
+    _listenfd = -1;
+}
+
+void TelemetryServer::closeClient()
+{
+    int fd = _clientfd.exchange(-1);
+    if (fd >= 0)
+    {
+        closeSocket(fd);
+    }
+}
+
+void TelemetryServer::loopReceive()
+{
+    std::string request;
+    char buf[1024];
+
+    while (!_endThread)
+    {
+        // one viewer at a time, wait for the next once it disconnects
+        int fd = _clientfd;
+        int waitfd = fd >= 0 ? fd : _listenfd;
+
+        fd_set readfds;
+        FD_ZERO(&readfds);
+        FD_SET(waitfd, &readfds);
+        struct timeval timeout = {0, RECEIVE_TIMEOUT_US};
+        if (select(waitfd + 1, &readfds, NULL, NULL, &timeout) <= 0)
+        {
+            continue;
+        }
+
+        if (fd < 0)
+        {
+            struct sockaddr client;
+            socklen_t client_len = sizeof(client);
+            int newfd = accept(_listenfd, &client, &client_len);
+            if (newfd >= 0)
+            {
+#ifdef SO_NOSIGPIPE
+                const int on = 1;
+                setsockopt(newfd, SOL_SOCKET, SO_NOSIGPIPE, (const char*)&on, sizeof(on));
+#endif
+                request.clear();
+                _interval = 1;
+                _clientfd = newfd;
+            }
+            continue;
+        }
+
+        int recvlen = recv(fd, buf, sizeof(buf), 0);
+        if (recvlen <= 0)
+        {
+            // disconnected, or the send thread shut the socket down after a failed send
+            closeClient();
+            continue;
+        }
+
+        request.append(buf, recvlen);
+        size_t pos;
+        while ((pos = request.find('\n')) != std::string::npos)
+        {
+            onRequest(request.substr(0, pos));
+            request.erase(0, pos + 1);
+        }
+    }
+}
+
+void TelemetryServer::onRequest(const std::string &request)
+{
+    rapidjson::Document dArgParse;
+    dArgParse.Parse<0>(request.c_str());
+    if (dArgParse.HasParseError() || !dArgParse.IsObject() || !dArgParse.HasMember("cmd") || !dArgParse["cmd"].IsString())
+    {
+        return;
+    }
+
+    std::string strcmd = dArgParse["cmd"].GetString();
+    if (strcmd == "interval")
+    {
+        if (dArgParse.HasMember("frames") && dArgParse["frames"].IsUint())
+        {
+            _interval = std::max(dArgParse["frames"].GetUint(), 1u);
+        }
+    }
+    else if (strcmd == "capture")
+    {
+        if (dArgParse.HasMember("frames") && dArgParse["frames"].IsUint())
+        {
+            _captureFrames = dArgParse["frames"].GetUint();
+        }
+    }
+    else if (strcmd == "memory")
+    {
+        _isMemoryRequested = true;
+    }
+    else if (strcmd == "gputiming")
+    {
+        if (dArgParse.HasMember("enable") && dArgParse["enable"].IsBool())
+        {
+            _gpuTimingRequest = dArgParse["enable"].GetBool() ? 1 : 0;
+        }
+    }
+}
+
+void TelemetryServer::loopSend()
+{
+    while (true)
+    {
+        std::string packet;
+        {
+            std::unique_lock<std::mutex> lock(_packetListMutex);
+            _packetListCondition.wait(lock, [this]() { return _endThread || !_packetList.empty(); });
+            if (_endThread)
+            {
+                return;
+            }
+            packet = std::move(_packetList.front());
+            _packetList.pop_front();
+        }
+
+        int fd = _clientfd;
+        if (fd < 0)
+        {
+            continue;
+        }
+
+        size_t sent = 0;
+        while (sent < packet.size() && !_endThread)
+        {
+            int sendlen = send(fd, packet.c_str() + sent, packet.size() - sent, SEND_FLAGS);
+            if (sendlen <= 0)
+            {
+                // let the receive thread close it, it is the one waiting on the socket
+                shutdown(fd, 2);
+                break;
+            }
+            sent += sendlen;
+        }
+    }
+}
+
+void TelemetryServer::addPacket(const std::string &cmd, const std::string &body)
+{
+    std::string msgContent = "{\"cmd\":\"" + cmd + "\",\"body\":" + body + "}";
+    char msgLength[64] = {0x1, 0};
+    snprintf(msgLength + 1, sizeof(msgLength) - 1, "%lu:", (unsigned long)msgContent.size());
+
+    std::lock_guard<std::mutex> lock(_packetListMutex);
+    if (_packetList.size() >= MAX_PENDING_PACKETS)
+    {
+        _packetList.pop_front();
+        ++_droppedPackets;
+    }
+    _packetList.push_back(msgLength + msgContent);
+    _packetListCondition.notify_one();
+}
+
+void TelemetryServer::onFrame(float dt)
+{
+    if (_clientfd < 0)
+    {
+        if (_captureFramesLeft > 0)
+        {
+            cc::Profiler::endCapture();
+            _captureFramesLeft = 0;
+        }
+        return;
+    }
+
+    auto pipeline = cc::pipeline::RenderPipeline::getInstance();
+    int gpuTiming = _gpuTimingRequest.exchange(-1);
+    if (gpuTiming >= 0 && pipeline)
+    {
+        pipeline->setGPUTimingEnabled(gpuTiming == 1);
+    }
+
+    // a capture spans the frames requested, the trace goes out when the last one ends
+    if (_captureFramesLeft == 0)
+    {
+        unsigned int frames = _captureFrames.exchange(0);
+        if (frames > 0)
+        {
+            cc::Profiler::beginCapture();
+            _captureFramesLeft = frames;
+        }
+    }
+    else if (--_captureFramesLeft == 0)
+    {
+        cc::Profiler::endCapture();
+        addPacket("trace", cc::Profiler::getChromeTrace());
+    }
+
+    if (_isMemoryRequested.exchange(false))
+    {
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+#if CC_USE_MEMORY_SAMPLING
+        std::string report = cc::MemSampler::getReport();
+        writer.String(report.c_str(), static_cast<rapidjson::SizeType>(report.size()));
+#else
+        writer.Null();
+#endif
+        addPacket("memory", buffer.GetString());
+    }
+
+    if (++_frame % _interval != 0)
+    {
+        return;
+    }
+
+    unsigned int droppedPackets;
+    {
+        std::lock_guard<std::mutex> lock(_packetListMutex);
+        droppedPackets = _droppedPackets;
+        _droppedPackets = 0;
+    }
+
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    writer.StartObject();
+    writer.Key("frame");
+    writer.Uint(_frame);
+    writer.Key("dt");
+    writer.Double(dt * 1000.0);
+    writer.Key("dropped");
+    writer.Uint(droppedPackets);
+
+    writer.Key("counters");
+    writer.StartObject();
+    for (uint8_t i = 0; i < static_cast<uint8_t>(cc::FrameStat::COUNT); ++i)
+    {
+        auto stat = static_cast<cc::FrameStat>(i);
+        writer.Key(cc::FrameStats::getName(stat));
+        writer.Uint(cc::FrameStats::get(stat));
+    }
+    writer.EndObject();
+
+    // milliseconds per stage, from the timestamps resolved a few frames late
+    if (pipeline && pipeline->isGPUTimingEnabled())
+    {
+        writer.Key("gpu");
+        writer.StartObject();
+        for (const auto flow : pipeline->getFlows())
+        {
+            for (const auto stage : flow->getStages())
+            {
+                std::string name = flow->getName() + "/" + stage->getName();
+                writer.Key(name.c_str(), static_cast<rapidjson::SizeType>(name.size()));
+                writer.Double(stage->getGPUTime());
+            }
+        }
+        writer.EndObject();
+    }
+    writer.EndObject();
+
+    addPacket("telemetry", buffer.GetString());
+}
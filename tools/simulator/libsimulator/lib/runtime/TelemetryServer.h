@@ -0,0 +1,95 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef  _TELEMETRY_SERVER__H_
+#define  _TELEMETRY_SERVER__H_
+
+#include "SimulatorExport.h"
+#include <string>
+#include <list>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+/*
+ Streams the frame counters, GPU stage times and memory accounting of the running game to one connected viewer,
+ in the framing of the console replies: 0x1, the decimal length of the JSON and ':', then the JSON.
+
+ Every frame (or every "interval" frames) sends {"cmd":"telemetry","body":{"frame","dt","counters","gpu"}}.
+ The viewer sends newline terminated JSON requests:
+   {"cmd":"interval","frames":N}   one packet every N frames
+   {"cmd":"capture","frames":N}    records the CPU zones of the next N frames, replies {"cmd":"trace","body":<Chrome trace>}
+   {"cmd":"memory"}                replies {"cmd":"memory","body":"<report>"}, builds with CC_USE_MEMORY_SAMPLING only
+   {"cmd":"gputiming","enable":B}  toggles the GPU timestamps of the pipeline
+
+ Packets are built on the cocos thread and sent from a thread of their own. A viewer which falls behind loses the
+ oldest packets instead of stalling the frame, the number dropped goes out with the next telemetry packet.
+*/
+class CC_LIBSIM_DLL TelemetryServer
+{
+    static TelemetryServer *s_sharedTelemetryServer;
+public:
+    static TelemetryServer* getShareInstance();
+    static void purge();
+
+    bool listenOnTCP(int port);
+    void stop();
+
+protected:
+    TelemetryServer();
+    ~TelemetryServer();
+
+private:
+    static const size_t MAX_PENDING_PACKETS = 64;
+
+    void loopReceive();
+    void loopSend();
+    void onFrame(float dt);
+    void onRequest(const std::string &request);
+    void addPacket(const std::string &cmd, const std::string &body);
+    void closeClient();
+
+    int _listenfd;
+    std::atomic<int> _clientfd;
+    std::thread _receiveThread;
+    std::thread _sendThread;
+    std::atomic<bool> _endThread;
+
+    std::list<std::string> _packetList;
+    std::mutex _packetListMutex;
+    std::condition_variable _packetListCondition;
+    unsigned int _droppedPackets;
+
+    // written by the receive thread, read on the cocos thread
+    std::atomic<unsigned int> _interval;
+    std::atomic<unsigned int> _captureFrames;
+    std::atomic<bool> _isMemoryRequested;
+    std::atomic<int> _gpuTimingRequest; // -1 unchanged, 0 disable, 1 enable
+
+    unsigned int _frame;
+    unsigned int _captureFramesLeft;
+};
+
+#endif // _TELEMETRY_SERVER__H_